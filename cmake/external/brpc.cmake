@@ -48,6 +48,11 @@ set(prefix_path
     "${THIRD_PARTY_PATH}/install/gflags|${THIRD_PARTY_PATH}/install/leveldb|${THIRD_PARTY_PATH}/install/snappy|${THIRD_PARTY_PATH}/install/gtest|${THIRD_PARTY_PATH}/install/protobuf|${THIRD_PARTY_PATH}/install/zlib|${THIRD_PARTY_PATH}/install/glog"
 )
 
+set(BRPC_RDMA_ARGS "")
+if(WITH_BRPC_RDMA)
+  set(BRPC_RDMA_ARGS -DWITH_RDMA=ON)
+endif()
+
 # If minimal .a is need, you can set  WITH_DEBUG_SYMBOLS=OFF
 ExternalProject_Add(
   extern_brpc
@@ -67,6 +72,7 @@ ExternalProject_Add(
              -DWITH_GLOG=ON
              -DBUILD_BRPC_TOOLS=ON
              -DBUILD_SHARED_LIBS=ON
+             ${BRPC_RDMA_ARGS}
              ${EXTERNAL_OPTIONAL_ARGS}
   LIST_SEPARATOR |
   CMAKE_CACHE_ARGS
@@ -91,6 +97,9 @@ set_property(TARGET brpc PROPERTY IMPORTED_LOCATION ${BRPC_LIBRARIES})
 add_dependencies(brpc extern_brpc)
 
 add_definitions(-DBRPC_WITH_GLOG)
+if(WITH_BRPC_RDMA)
+  add_definitions(-DBRPC_WITH_RDMA=1)
+endif()
 
 list(APPEND external_project_dependencies brpc)
 
@@ -106,3 +115,7 @@ set(EXTERNAL_BRPC_DEPS
 if(NOT WITH_GFLAGS)
   set(EXTERNAL_BRPC_DEPS ${EXTERNAL_BRPC_DEPS} gflags)
 endif()
+
+if(WITH_BRPC_RDMA)
+  set(EXTERNAL_BRPC_DEPS ${EXTERNAL_BRPC_DEPS} ibverbs)
+endif()
@@ -12,7 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
-if(NOT (WITH_CUSPARSELT AND WITH_TENSORRT))
+if(NOT (WITH_CUSPARSELT AND WITH_GPU))
   return()
 endif()
 
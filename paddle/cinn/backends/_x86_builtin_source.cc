@@ -394,6 +394,38 @@ inline __m512d cinn_avx512_mul(const __m512d& a, const __m512d& b) {
 }
 // @}
 
+//! sub
+// @{
+inline __m256 cinn_avx256_sub(const __m256& a, const __m256& b) {
+  return _mm256_sub_ps(a, b);
+}
+inline __m256d cinn_avx256_sub(const __m256d& a, const __m256d& b) {
+  return _mm256_sub_pd(a, b);
+}
+inline __m512 cinn_avx512_sub(const __m512& a, const __m512& b) {
+  return _mm512_sub_ps(a, b);
+}
+inline __m512d cinn_avx512_sub(const __m512d& a, const __m512d& b) {
+  return _mm512_sub_pd(a, b);
+}
+// @}
+
+//! div
+// @{
+inline __m256 cinn_avx256_div(const __m256& a, const __m256& b) {
+  return _mm256_div_ps(a, b);
+}
+inline __m256d cinn_avx256_div(const __m256d& a, const __m256d& b) {
+  return _mm256_div_pd(a, b);
+}
+inline __m512 cinn_avx512_div(const __m512& a, const __m512& b) {
+  return _mm512_div_ps(a, b);
+}
+inline __m512d cinn_avx512_div(const __m512d& a, const __m512d& b) {
+  return _mm512_div_pd(a, b);
+}
+// @}
+
 //! fma
 // @{
 inline __m128 cinn_avx128_fma(const __m128& a,
@@ -141,7 +141,7 @@ void CodeGenCX86::Visit(const ir::intrinsics::BuiltinIntrin *op) {
         PrintVecInputArgument(&op->args[i]);
         str_ += ", ";
       }
-      IrPrinter::Visit(op->args.back());
+      PrintVecInputArgument(&op->args.back());
     }
     str_ += ")";
   } else if (SupportsAVX256() && bits == 256) {
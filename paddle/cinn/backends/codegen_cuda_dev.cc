@@ -28,6 +28,9 @@ using cinn::common::float16;
 using cinn::common::half4;
 using cinn::common::half8;
 using cinn::common::float8;
+using cinn::common::bfloat162;
+using cinn::common::bfloat164;
+using cinn::common::bfloat168;
 
 #include "cinn_cuda_runtime_source.cuh"
 )";
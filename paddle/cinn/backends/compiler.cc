@@ -25,6 +25,7 @@
 #include "paddle/cinn/backends/codegen_cuda_dev.h"
 #include "paddle/cinn/backends/codegen_cuda_host.h"
 #include "paddle/cinn/backends/codegen_device_util.h"
+#include "paddle/cinn/backends/nvrtc/compilation_disk_cache.h"
 #include "paddle/cinn/backends/nvrtc/nvrtc_util.h"
 #include "paddle/cinn/runtime/cuda/cuda_module.h"
 #include "paddle/cinn/runtime/cuda/cuda_util.h"
@@ -315,19 +316,36 @@ void Compiler::RegisterCudaModuleSymbol() {
 #ifdef CINN_WITH_CUDA
   nvrtc::Compiler compiler;
   std::string source_code = CodeGenCudaDev::GetSourceHeader() + device_fn_code_;
-  auto ptx = compiler(source_code);
-  CHECK(!ptx.empty()) << "Compile PTX failed from source code:\n"
-                      << source_code;
+  // nvcc returns the path of the cubin rather than the code, which is not
+  // cached.
+  auto& disk_cache = nvrtc::CompilationDiskCache::Instance();
+  const bool use_disk_cache =
+      disk_cache.Enabled() && !runtime::CanUseNvccCompiler();
+  const uint64_t cache_key =
+      use_disk_cache ? disk_cache.Key(source_code, compiler.compile_to_cubin())
+                     : 0;
+  std::string ptx;
+  if (!use_disk_cache || !disk_cache.Load(cache_key, &ptx)) {
+    ptx = compiler(source_code);
+    CHECK(!ptx.empty()) << "Compile PTX failed from source code:\n"
+                        << source_code;
+    if (use_disk_cache) {
+      disk_cache.Store(cache_key, ptx);
+    }
+  }
+  using runtime::cuda::CUDAKernel;
   using runtime::cuda::CUDAModule;
-  cuda_module_.reset(new CUDAModule(ptx,
-                                    compiler.compile_to_cubin()
-                                        ? CUDAModule::Kind::CUBIN
-                                        : CUDAModule::Kind::PTX));
+  cuda_module_ = CUDAModule::GetOrCreate(ptx,
+                                         compiler.compile_to_cubin()
+                                             ? CUDAModule::Kind::CUBIN
+                                             : CUDAModule::Kind::PTX);
 
+  // The kernels are resolved lazily on each device at their first launch.
   RuntimeSymbols symbols;
   for (const auto& kernel_fn_name : device_fn_name_) {
-    auto fn_kernel = cuda_module_->GetFunction(kernel_fn_name);
-    CHECK(fn_kernel) << "Fail to get CUfunction kernel_fn_name";
+    cuda_kernels_.emplace_back(
+        std::make_unique<CUDAKernel>(cuda_module_, kernel_fn_name));
+    auto* fn_kernel = cuda_kernels_.back().get();
     fn_ptr_.push_back(reinterpret_cast<void*>(fn_kernel));
     symbols.RegisterVar(kernel_fn_name + "_ptr_",
                         reinterpret_cast<void*>(fn_kernel));
@@ -152,7 +152,8 @@ class Compiler final {
   std::vector<std::string> device_fn_name_;
   std::string device_fn_code_;
 #ifdef CINN_WITH_CUDA
-  std::unique_ptr<runtime::cuda::CUDAModule> cuda_module_;
+  std::shared_ptr<runtime::cuda::CUDAModule> cuda_module_;
+  std::vector<std::unique_ptr<runtime::cuda::CUDAKernel>> cuda_kernels_;
 #endif
 };
 
@@ -0,0 +1,268 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/backends/nvrtc/compilation_disk_cache.h"
+
+#include <cuda.h>
+#include <cuda_runtime.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <nvrtc.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "paddle/cinn/backends/nvrtc/header_generator.h"
+#include "paddle/cinn/common/context.h"
+#include "paddle/cinn/utils/string.h"
+#include "paddle/common/flags.h"
+
+PD_DECLARE_string(cinn_compilation_cache_dir);
+PD_DECLARE_string(cinn_compilation_cache_readonly_dirs);
+PD_DECLARE_bool(cinn_nvrtc_cubin_with_fmad);
+
+namespace cinn {
+namespace backends {
+namespace nvrtc {
+
+namespace {
+
+// Bump it when the layout of an entry or the key changes.
+constexpr uint32_t kFormatVersion = 1;
+constexpr char kMagic[8] = "CINNBIN";
+
+struct EntryHeader {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t reserved;
+  uint64_t key;
+  uint64_t size;
+  uint64_t checksum;
+};
+
+// FNV-1a, which is stable across the hosts and the builds unlike std::hash.
+uint64_t Fnv1a(const char* data,
+               size_t size,
+               uint64_t seed = 14695981039346656037ULL) {
+  uint64_t hash = seed;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+uint64_t Fnv1a(const std::string& data,
+               uint64_t seed = 14695981039346656037ULL) {
+  return Fnv1a(data.data(), data.size(), seed);
+}
+
+// The hash of the headers that the CUDA source includes, which are a part of
+// the build rather than the source.
+uint64_t RuntimeHeadersHash() {
+  static const uint64_t hash = [] {
+    uint64_t hash = Fnv1a(std::string());
+    const auto& header_gen = JitSafeHeaderGenerator::GetInstance();
+    for (size_t i = 0; i < header_gen.size(); ++i) {
+      hash = Fnv1a(std::string(header_gen.include_names()[i]), hash);
+      hash = Fnv1a(std::string(header_gen.headers()[i]), hash);
+    }
+    const auto& dirs = common::Context::Global().runtime_include_dir();
+    for (const auto& dir : dirs) {
+      DIR* dir_ptr = opendir(dir.c_str());
+      if (dir_ptr == nullptr) {
+        continue;
+      }
+      std::vector<std::string> names;
+      while (auto* entry = readdir(dir_ptr)) {
+        if (entry->d_name[0] != '.') {
+          names.emplace_back(entry->d_name);
+        }
+      }
+      closedir(dir_ptr);
+      std::sort(names.begin(), names.end());
+      for (const auto& name : names) {
+        std::ifstream file(dir + "/" + name, std::ios::binary);
+        if (!file.is_open()) {
+          continue;
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        hash = Fnv1a(name, hash);
+        hash = Fnv1a(content.str(), hash);
+      }
+    }
+    return hash;
+  }();
+  return hash;
+}
+
+bool MakeDirectories(const std::string& dirname) {
+  struct stat st;
+  std::string path;
+  for (size_t i = 0; i < dirname.size(); ++i) {
+    path.push_back(dirname[i]);
+    if (!(dirname[i] == '/' || i + 1 == dirname.size())) {
+      continue;
+    }
+    if (stat(path.c_str(), &st) == 0) {
+      if (!S_ISDIR(st.st_mode)) {
+        return false;
+      }
+    } else if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+CompilationDiskCache& CompilationDiskCache::Instance() {
+  static CompilationDiskCache instance(
+      FLAGS_cinn_compilation_cache_dir,
+      FLAGS_cinn_compilation_cache_readonly_dirs.empty()
+          ? std::vector<std::string>()
+          : utils::Split(FLAGS_cinn_compilation_cache_readonly_dirs, ","));
+  return instance;
+}
+
+CompilationDiskCache::CompilationDiskCache(
+    const std::string& cache_dir, const std::vector<std::string>& readonly_dirs)
+    : cache_dir_(cache_dir), readonly_dirs_(readonly_dirs) {
+  if (!cache_dir_.empty() && !MakeDirectories(cache_dir_)) {
+    LOG(WARNING) << "Failed to make the compilation cache directory "
+                 << cache_dir_ << ", the compiled code will not be stored.";
+    cache_dir_.clear();
+  }
+}
+
+uint64_t CompilationDiskCache::Key(const std::string& code,
+                                   bool compile_to_cubin) const {
+  int major = 0, minor = 0;
+  cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
+  cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, 0);
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  nvrtcVersion(&nvrtc_major, &nvrtc_minor);
+
+  std::ostringstream options;
+  options << "format=" << kFormatVersion << ";arch=" << major << minor
+          << ";cubin=" << compile_to_cubin
+          << ";fmad=" << FLAGS_cinn_nvrtc_cubin_with_fmad
+          << ";cuda=" << CUDA_VERSION << ";nvrtc=" << nvrtc_major << "."
+          << nvrtc_minor << ";headers=" << RuntimeHeadersHash();
+  return Fnv1a(code, Fnv1a(options.str()));
+}
+
+std::string CompilationDiskCache::EntryPath(const std::string& dir,
+                                            uint64_t key) const {
+  char name[32];
+  std::snprintf(name,
+                sizeof(name),
+                "%016llx.cinnbin",
+                static_cast<unsigned long long>(key));  // NOLINT
+  return dir + "/" + name;
+}
+
+bool CompilationDiskCache::Load(uint64_t key, std::string* data) const {
+  std::vector<std::string> dirs;
+  if (!cache_dir_.empty()) {
+    dirs.push_back(cache_dir_);
+  }
+  dirs.insert(dirs.end(), readonly_dirs_.begin(), readonly_dirs_.end());
+
+  for (const auto& dir : dirs) {
+    const std::string path = EntryPath(dir, key);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      continue;
+    }
+    bool valid = false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 &&
+        static_cast<size_t>(st.st_size) >= sizeof(EntryHeader)) {
+      void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        const auto* header = static_cast<const EntryHeader*>(addr);
+        const char* payload =
+            static_cast<const char*>(addr) + sizeof(EntryHeader);
+        valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+                header->format_version == kFormatVersion &&
+                header->key == key &&
+                header->size == st.st_size - sizeof(EntryHeader) &&
+                Fnv1a(payload, header->size) == header->checksum;
+        if (valid) {
+          data->assign(payload, header->size);
+        }
+        munmap(addr, st.st_size);
+      }
+    }
+    close(fd);
+    if (valid) {
+      VLOG(4) << "Load the compiled code from " << path;
+      return true;
+    }
+    LOG(WARNING) << "Skip the invalid compilation cache entry " << path;
+  }
+  return false;
+}
+
+void CompilationDiskCache::Store(uint64_t key, const std::string& data) const {
+  if (cache_dir_.empty()) {
+    return;
+  }
+  EntryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.format_version = kFormatVersion;
+  header.key = key;
+  header.size = data.size();
+  header.checksum = Fnv1a(data);
+
+  static std::atomic<uint64_t> tmp_id{0};
+  const std::string path = EntryPath(cache_dir_, key);
+  const std::string tmp_path = path + ".tmp." + std::to_string(getpid()) +
+                               "." + std::to_string(tmp_id++);
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(data.data(), data.size());
+    if (!file.good()) {
+      LOG(WARNING) << "Failed to write the compilation cache entry "
+                   << tmp_path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to rename the compilation cache entry to " << path;
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  VLOG(4) << "Store the compiled code to " << path;
+}
+
+}  // namespace nvrtc
+}  // namespace backends
+}  // namespace cinn
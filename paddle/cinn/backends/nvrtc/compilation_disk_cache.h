@@ -0,0 +1,87 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#ifdef CINN_WITH_CUDA
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace backends {
+namespace nvrtc {
+
+/**
+ * A disk cache of the device code compiled by NVRTC, which saves the
+ * compilation of the same fusion groups in the later jobs. An entry is keyed
+ * by the hash of the CUDA source, the compile options, the device arch, the
+ * CUDA and NVRTC versions and the CINN runtime headers. The entries are
+ * written to the cache directory, and read from it and from the read only
+ * directories, e.g. a directory shared by the hosts of a cluster.
+ */
+class CompilationDiskCache {
+ public:
+  /**
+   * The cache of FLAGS_cinn_compilation_cache_dir and
+   * FLAGS_cinn_compilation_cache_readonly_dirs.
+   */
+  static CompilationDiskCache& Instance();
+
+  CompilationDiskCache(const std::string& cache_dir,
+                       const std::vector<std::string>& readonly_dirs);
+
+  bool Enabled() const {
+    return !cache_dir_.empty() || !readonly_dirs_.empty();
+  }
+
+  /**
+   * Get the key of the device code compiled from the source code.
+   * @param code The CUDA source code.
+   * @param compile_to_cubin Whether the code is compiled into cubin or PTX.
+   * @return The key of the entry.
+   */
+  uint64_t Key(const std::string& code, bool compile_to_cubin) const;
+
+  /**
+   * Load the device code of the key from the cache directory and then from
+   * the read only directories. An entry is memory mapped and validated by its
+   * header and checksum, the invalid ones are skipped.
+   * @param key The key of the entry.
+   * @param data The loaded PTX or CUBIN.
+   * @return Whether a valid entry is found.
+   */
+  bool Load(uint64_t key, std::string* data) const;
+
+  /**
+   * Store the device code of the key into the cache directory. The entry is
+   * written to a temporary file and renamed, so the other processes never
+   * read a partial entry.
+   * @param key The key of the entry.
+   * @param data The compiled PTX or CUBIN.
+   */
+  void Store(uint64_t key, const std::string& data) const;
+
+ private:
+  std::string EntryPath(const std::string& dir, uint64_t key) const;
+
+  std::string cache_dir_;
+  std::vector<std::string> readonly_dirs_;
+};
+
+}  // namespace nvrtc
+}  // namespace backends
+}  // namespace cinn
+
+#endif  // CINN_WITH_CUDA
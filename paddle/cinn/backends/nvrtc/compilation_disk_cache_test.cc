@@ -0,0 +1,91 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/backends/nvrtc/compilation_disk_cache.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include "paddle/cinn/backends/nvrtc/nvrtc_util.h"
+
+namespace cinn {
+namespace backends {
+namespace nvrtc {
+
+static std::string MakeTempDir() {
+  char path[] = "/tmp/cinn_compilation_cache_XXXXXX";
+  return mkdtemp(path);
+}
+
+TEST(CompilationDiskCache, store_and_load) {
+  std::string dir = MakeTempDir();
+  CompilationDiskCache cache(dir, {});
+  ASSERT_TRUE(cache.Enabled());
+
+  std::string source_code = R"ROC(
+extern "C" __global__
+void scale(float a, float *x, size_t n)
+{
+  size_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+  if (tid < n) {
+    x[tid] *= a;
+  }
+}
+)ROC";
+  Compiler compiler;
+  uint64_t key = cache.Key(source_code, compiler.compile_to_cubin());
+  ASSERT_EQ(key, cache.Key(source_code, compiler.compile_to_cubin()));
+  ASSERT_NE(key, cache.Key(source_code + " ", compiler.compile_to_cubin()));
+
+  std::string data;
+  ASSERT_FALSE(cache.Load(key, &data));
+  std::string ptx = compiler(source_code);
+  cache.Store(key, ptx);
+  ASSERT_TRUE(cache.Load(key, &data));
+  ASSERT_EQ(data, ptx);
+
+  // A read only cache, e.g. shared by the other hosts, loads the entry too.
+  CompilationDiskCache readonly_cache("", {"/nonexistent", dir});
+  data.clear();
+  ASSERT_TRUE(readonly_cache.Load(key, &data));
+  ASSERT_EQ(data, ptx);
+}
+
+TEST(CompilationDiskCache, skip_corrupted_entry) {
+  std::string dir = MakeTempDir();
+  CompilationDiskCache cache(dir, {});
+  const uint64_t key = 0x1234;
+  cache.Store(key, std::string(1024, 'x'));
+
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.cinnbin", 0x1234ULL);
+  {
+    std::fstream file(dir + name,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('y');
+  }
+  std::string data;
+  ASSERT_FALSE(cache.Load(key, &data));
+
+  // A truncated entry is skipped as well.
+  ASSERT_EQ(truncate((dir + name).c_str(), 16), 0);
+  ASSERT_FALSE(cache.Load(key, &data));
+}
+
+}  // namespace nvrtc
+}  // namespace backends
+}  // namespace cinn
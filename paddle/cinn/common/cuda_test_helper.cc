@@ -52,18 +52,21 @@ void CudaModuleTester::Compile(const ir::Module& m,
   else
     ptx = compiler(rewrite_cuda_code);
 
-  cuda_module_ =
-      new runtime::cuda::CUDAModule(ptx, runtime::cuda::CUDAModule::Kind::PTX);
+  auto module = std::make_shared<runtime::cuda::CUDAModule>(
+      ptx, runtime::cuda::CUDAModule::Kind::PTX);
+  cuda_module_ = new std::shared_ptr<runtime::cuda::CUDAModule>(module);
 
+  // The addresses of the handles are registered, so they must not move.
+  kernel_handles_.reserve(device_module.functions().size());
   for (auto& fn : device_module.functions()) {
     std::string kernel_fn_name = fn->name;
-    auto fn_kernel = reinterpret_cast<runtime::cuda::CUDAModule*>(cuda_module_)
-                         ->GetFunction(0, kernel_fn_name);
+    auto fn_kernel = module->GetFunction(0, kernel_fn_name);
     PADDLE_ENFORCE_EQ(
         fn_kernel,
         true,
         phi::errors::InvalidArgument("%s should not be null", kernel_fn_name));
-    kernel_handles_.push_back(fn_kernel);
+    kernel_handles_.push_back(
+        new runtime::cuda::CUDAKernel(module, kernel_fn_name));
 
     backends::GlobalSymbolRegistry::Global().RegisterFn(
         kernel_fn_name + "_ptr_",
@@ -103,13 +106,18 @@ void CudaModuleTester::operator()(const std::string& fn_name,
 }
 
 void* CudaModuleTester::LookupKernel(const std::string& name) {
-  return reinterpret_cast<runtime::cuda::CUDAModule*>(cuda_module_)
+  return (*reinterpret_cast<std::shared_ptr<runtime::cuda::CUDAModule>*>(
+              cuda_module_))
       ->GetFunction(0, name);
 }
 
 CudaModuleTester::~CudaModuleTester() {
+  for (void* kernel_handle : kernel_handles_) {
+    delete reinterpret_cast<runtime::cuda::CUDAKernel*>(kernel_handle);
+  }
   if (cuda_module_) {
-    delete reinterpret_cast<runtime::cuda::CUDAModule*>(cuda_module_);
+    delete reinterpret_cast<std::shared_ptr<runtime::cuda::CUDAModule>*>(
+        cuda_module_);
   }
 }
 
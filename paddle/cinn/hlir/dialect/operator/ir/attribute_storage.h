@@ -134,7 +134,17 @@ struct CINNKernelInfoAttributeStorage : public pir::AttributeStorage {
   }
 
   bool operator==(const ParamKey& key) const {
-    return data_.fn_ptr == key.fn_ptr;
+    if (data_.fn_ptr != key.fn_ptr ||
+        data_.specialized_kernels.size() != key.specialized_kernels.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < key.specialized_kernels.size(); ++i) {
+      if (data_.specialized_kernels[i].fn_ptr !=
+          key.specialized_kernels[i].fn_ptr) {
+        return false;
+      }
+    }
+    return true;
   }
 
   const ParamKey& GetAsKey() const { return data_; }
@@ -14,6 +14,9 @@
 
 #include "paddle/cinn/hlir/dialect/operator/transforms/lowering_pass/utils.h"
 
+#include <optional>
+#include <unordered_set>
+
 #include "paddle/cinn/adt/generate_map_expr.h"
 #include "paddle/cinn/hlir/dialect/operator/ir/attribute_storage.h"
 #include "paddle/cinn/hlir/dialect/operator/ir/generate_shape_util.h"
@@ -23,12 +26,18 @@
 #include "paddle/cinn/hlir/dialect/runtime/ir/jit_kernel_op.h"
 #include "paddle/cinn/hlir/dialect/runtime/ir/runtime_dialect.h"
 #include "paddle/cinn/hlir/framework/pir/compilation_cache.h"
+#include "paddle/cinn/hlir/framework/pir/fusion_info.h"
+#include "paddle/cinn/hlir/framework/pir/shape_bucket_profile.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 #include "paddle/cinn/runtime/flags.h"
+#include "paddle/cinn/utils/string.h"
+#include "paddle/pir/include/dialect/shape/utils/dim_expr_util.h"
 
 PD_DECLARE_bool(cinn_enable_map_expr);
 PD_DECLARE_bool(enable_cinn_compile_cache);
+PD_DECLARE_int32(cinn_shape_bucket_max_num);
+PD_DECLARE_double(cinn_shape_bucket_min_ratio);
 
 namespace cinn::dialect::ir::details {
 
@@ -36,6 +45,8 @@ using cinn::hlir::framework::CompilationCache;
 using cinn::hlir::framework::PirCompiler;
 using cinn::hlir::framework::pir::CINNKernelInfo;
 using cinn::hlir::framework::pir::CompatibleInfo;
+using cinn::hlir::framework::pir::GroupFingerprint;
+using cinn::hlir::framework::pir::ShapeBucketProfile;
 
 std::vector<pir::Value> GetBlockOutsideInput(
     const std::vector<pir::Operation*>& op_list) {
@@ -60,6 +71,152 @@ std::vector<pir::Value> GetBlockOutsideInput(
   return vec_res;
 }
 
+namespace {
+
+// Get the symbolic dims of the group inputs, i.e. the kernel args, which bind
+// the symbols of the group.
+std::vector<CINNKernelInfo::ArgDimIdx> GetShapeBucketDims(
+    const OpLoweringGroupPtr& group, std::vector<symbol::DimExpr>* symbols) {
+  std::vector<CINNKernelInfo::ArgDimIdx> bucket_dims;
+  std::unordered_set<std::string> visited;
+  const auto& inputs = GetBlockOutsideInput(group->ops());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (!group->HasShapeOrDataExprs(inputs[i])) continue;
+    const auto& shape_or_data = group->GetShapeOrDataExprs(inputs[i]);
+    if (!shape_or_data.isa<symbol::TensorShapeOrDataDimExprs>()) continue;
+    const auto& shape = shape_or_data.shape();
+    for (size_t j = 0; j < shape.size(); ++j) {
+      if (!shape[j].isa<std::string>()) continue;
+      const auto& symbol_name = shape[j].dyn_cast<std::string>();
+      if (visited.insert(symbol_name).second) {
+        bucket_dims.push_back({static_cast<int>(i), static_cast<int>(j)});
+        symbols->push_back(shape[j]);
+      }
+    }
+  }
+  return bucket_dims;
+}
+
+// Clone the group with the symbols substituted by the values of the shape
+// bucket, or nullopt if the shapes of the group are not all static then.
+std::optional<OpLoweringGroupPtr> SpecializeGroup(
+    const OpLoweringGroupPtr& group,
+    const std::vector<symbol::DimExpr>& symbols,
+    const std::vector<int64_t>& dim_values) {
+  std::unordered_map<symbol::DimExpr, symbol::DimExpr> substitution;
+  for (size_t i = 0; i < symbols.size(); ++i) {
+    substitution[symbols[i]] = symbol::DimExpr(dim_values[i]);
+  }
+  bool is_static = true;
+  const auto Substitute = [&](const std::vector<symbol::DimExpr>& dim_exprs) {
+    std::vector<symbol::DimExpr> result;
+    for (const auto& dim_expr : dim_exprs) {
+      result.push_back(symbol::SimplifyDimExpr(
+          symbol::SubstituteDimExpr(dim_expr, substitution)));
+      is_static = is_static && result.back().isa<int64_t>();
+    }
+    return result;
+  };
+
+  auto new_group = group->Clone("bucket_" + cinn::utils::Join(dim_values, "_"));
+  const auto SpecializeValue = [&](const pir::Value& value) {
+    if (!value || !group->HasShapeOrDataExprs(value) ||
+        new_group->HasShapeOrDataExprs(value)) {
+      return;
+    }
+    const auto& shape_or_data = group->GetShapeOrDataExprs(value);
+    if (!shape_or_data.isa<symbol::TensorShapeOrDataDimExprs>()) {
+      is_static = false;
+      return;
+    }
+    const auto& tensor_shape_or_data =
+        shape_or_data.dyn_cast<symbol::TensorShapeOrDataDimExprs>();
+    const auto& shape = Substitute(tensor_shape_or_data.shape());
+    if (tensor_shape_or_data.data()) {
+      const auto& data = Substitute(tensor_shape_or_data.data().value());
+      new_group->SetShapeOrDataExprs(
+          value,
+          symbol::ShapeOrDataDimExprs{
+              symbol::TensorShapeOrDataDimExprs(shape, data)});
+    } else {
+      new_group->SetShapeOrDataExprs(
+          value,
+          symbol::ShapeOrDataDimExprs{
+              symbol::TensorShapeOrDataDimExprs(shape)});
+    }
+  };
+  for (auto* op : group->ops()) {
+    for (const auto& value : op->operands_source()) SpecializeValue(value);
+    for (const auto& value : op->results()) SpecializeValue(value);
+  }
+  const auto& loop_ranges_expr = Substitute(group->loop_ranges_expr());
+  if (!is_static) {
+    return std::nullopt;
+  }
+
+  std::vector<int64_t> loop_ranges;
+  for (const auto& dim_expr : loop_ranges_expr) {
+    loop_ranges.push_back(dim_expr.dyn_cast<int64_t>());
+  }
+  new_group->set_loop_ranges_expr(loop_ranges_expr);
+  if (!loop_ranges.empty()) {
+    new_group->set_loop_ranges(loop_ranges);
+  }
+  new_group->set_op_pattern_kind(group->op_pattern_kind());
+  new_group->set_shape_bucket(dim_values);
+  return new_group;
+}
+
+}  // namespace
+
+void AttachShapeBucketKernels(const OpLoweringGroupPtr& group,
+                              CINNKernelInfo* kernel_info) {
+  const auto& profile = ShapeBucketProfile::Instance();
+  if (!profile.Enabled() || kernel_info->int_args_map.empty()) {
+    return;
+  }
+  std::vector<symbol::DimExpr> symbols;
+  kernel_info->bucket_dims = GetShapeBucketDims(group, &symbols);
+  if (kernel_info->bucket_dims.empty()) {
+    return;
+  }
+  kernel_info->bucket_key = GroupFingerprint(*group);
+
+  std::vector<OpLoweringGroupPtr> bucket_groups;
+  for (const auto& dim_values :
+       profile.HotBuckets(kernel_info->bucket_key,
+                          FLAGS_cinn_shape_bucket_max_num,
+                          FLAGS_cinn_shape_bucket_min_ratio)) {
+    if (dim_values.size() != symbols.size()) continue;
+    const auto& bucket_group = SpecializeGroup(group, symbols, dim_values);
+    if (bucket_group.has_value()) {
+      bucket_groups.push_back(bucket_group.value());
+    }
+  }
+  if (bucket_groups.empty()) {
+    return;
+  }
+
+  // The specialized kernels are only a faster path, so the group falls back
+  // to the generic kernel if they fail to compile.
+  try {
+    PirCompiler pir_compiler(cinn::common::DefaultDeviceTarget());
+    const auto& bucket_kernel_infos = pir_compiler.Build(bucket_groups);
+    for (size_t i = 0; i < bucket_groups.size(); ++i) {
+      kernel_info->specialized_kernels.push_back(
+          {bucket_groups[i]->shape_bucket(),
+           bucket_kernel_infos[i].fn_ptr,
+           bucket_kernel_infos[i].int_args_map});
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to specialize " << group->FuncName()
+                 << " for the shape buckets: " << e.what();
+    kernel_info->specialized_kernels.clear();
+  }
+  VLOG(4) << "Specialize " << kernel_info->specialized_kernels.size()
+          << " shape buckets for " << group->FuncName();
+}
+
 std::unordered_map<std::string, ::pir::Attribute> GetJitKernelAttr(
     const OpLoweringGroupPtr& group) {
   const auto& CreateKernelInfo = [&]() -> CINNKernelInfo {
@@ -87,10 +244,12 @@ std::unordered_map<std::string, ::pir::Attribute> GetJitKernelAttr(
       return CreateFromNewCompile();
     }
   };
+  CINNKernelInfo kernel_info = CreateKernelInfo();
+  AttachShapeBucketKernels(group, &kernel_info);
   std::unordered_map<std::string, ::pir::Attribute> attrs{
       {cinn::dialect::JitKernelOp::kAttrName,
        cinn::dialect::CINNKernelInfoAttribute::get(pir::IrContext::Instance(),
-                                                   CreateKernelInfo())}};
+                                                   kernel_info)}};
   return attrs;
 }
 
@@ -22,6 +22,12 @@ using OpLoweringGroupPtr = std::shared_ptr<OpLoweringGroup>;
 std::vector<pir::Value> GetBlockOutsideInput(
     const std::vector<pir::Operation*>& op_list);
 
+// Compile the kernels specialized for the hot shape buckets of the dynamic
+// shape group in FLAGS_cinn_shape_bucket_profile into the kernel info.
+void AttachShapeBucketKernels(
+    const OpLoweringGroupPtr& group,
+    cinn::hlir::framework::pir::CINNKernelInfo* kernel_info);
+
 std::unordered_map<std::string, ::pir::Attribute> GetJitKernelAttr(
     const OpLoweringGroupPtr& group);
 
@@ -39,6 +39,7 @@ class GroupCompilationContext {
   void SetLoweredFuncs(BucketLoweredFuncsWrapper&& funcs);
   void PrepareModuleBuilder();
   std::string PrintPredicate2Funcs() const;
+  const pir::OpLoweringGroupPtr& group() const { return group_; }
 
  private:
   friend class CompilationTask;
@@ -66,12 +67,12 @@ class CompilationTask {
 
   std::shared_ptr<pir::CompilationResult> operator()();
   void Lowering();
+  std::shared_ptr<pir::CompilationResult> CodegenAndJit();
   std::shared_ptr<pir::CompilationResult> CompileBroadcastModules(
       std::vector<GroupCompilationContext>* leaf_group_contexts,
       const std::unordered_map<int, ir::Var>& symbolic_shape_var_index);
 
  private:
-  std::shared_ptr<pir::CompilationResult> CodegenAndJit();
   std::shared_ptr<pir::CompilationResult> BuildPirCINNKernelInfo(
       const ir::Module& module, const ir::Module& CX86module);
 
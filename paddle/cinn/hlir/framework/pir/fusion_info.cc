@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "paddle/cinn/hlir/framework/pir/fusion_info.h"
+
+#include <sstream>
+
 #include "paddle/common/enforce.h"
 #include "paddle/common/flags.h"
 #include "paddle/pir/include/core/ir_printer.h"
@@ -166,7 +169,8 @@ void FusionInfo::ParseInputDimExprs(const OpLoweringGroup& group) {
   // NOTE(Aurelius84): [Why try get DimExpr from Group firstly? ]
   // In case of BroadcastTree, we will clone many Groups containing same ops.
   // But its input valus is defining outside and will have same DimExprs in
-  // global ShapeAnalysis, which leading hash conflict unexpected.
+  // global ShapeAnalysis, which leading hash conflict unexpected. So are the
+  // Groups specialized for the shape buckets.
   const auto TryGetDimExprsFromGroup = [&](const ::pir::Value& value) -> bool {
     if (!group.HasShapeOrDataExprs(value)) return false;
     input_dim_exprs_.push_back(group.GetShapeOrDataExprs(value));
@@ -183,7 +187,7 @@ void FusionInfo::ParseInputDimExprs(const OpLoweringGroup& group) {
   };
 
   for (const auto& value : group.GetInputOpValues()) {
-    if (group.IsBroadcastLeaf()) {
+    if (group.IsBroadcastLeaf() || !group.shape_bucket().empty()) {
       TryGetDimExprsFromGroup(value);
     } else {
       TryeGetDimExprsFromGlobal(value);
@@ -231,4 +235,23 @@ std::vector<const ::pir::Operation*> TopologySort(
   return ops;
 }
 
+std::string GroupFingerprint(const OpLoweringGroup& group) {
+  std::stringstream ss;
+  ::pir::IrPrinter printer(ss);
+  const auto PrintValue = [&](const ::pir::Value& value) {
+    if (!value || !value.type()) return;
+    printer.PrintType(value.type());
+  };
+  for (auto* op : group.ops()) {
+    ss << op->name() << "(";
+    for (const auto& value : op->operands_source()) PrintValue(value);
+    ss << ")->(";
+    for (const auto& value : op->results()) PrintValue(value);
+    ss << ");";
+  }
+  std::stringstream fingerprint;
+  fingerprint << std::hex << std::hash<std::string>()(ss.str());
+  return fingerprint.str();
+}
+
 }  // namespace cinn::hlir::framework::pir
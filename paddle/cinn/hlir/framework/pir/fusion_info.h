@@ -137,6 +137,12 @@ inline void hash_combine(std::size_t &seed,  // NOLINT
 std::vector<const ::pir::Operation *> TopologySort(
     const OpLoweringGroup &group);
 
+// The fingerprint of the ops and the types of the group, which is stable
+// across the runs of the same build unlike FusionInfo, whose hash is of the
+// addresses of the types and the attributes. The symbol names are left out,
+// since they depend on the order in which the programs are analyzed.
+std::string GroupFingerprint(const OpLoweringGroup &group);
+
 }  // namespace cinn::hlir::framework::pir
 
 namespace std {
@@ -0,0 +1,294 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/hlir/framework/pir/group_schedule_tuner.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "paddle/cinn/hlir/framework/pir/compilation_task.h"
+#include "paddle/cinn/hlir/framework/pir/fusion_info.h"
+#include "paddle/cinn/hlir/framework/pir/utils.h"
+#include "paddle/cinn/ir/group_schedule/config/group_tuning_database.h"
+#include "paddle/cinn/runtime/cinn_runtime.h"
+#include "paddle/common/flags.h"
+#include "paddle/pir/include/core/builtin_type.h"
+
+#ifdef CINN_WITH_CUDA
+#include <cuda_runtime.h>
+
+#include "paddle/cinn/backends/cuda_util.h"
+#endif
+
+PD_DECLARE_bool(cinn_group_tuning);
+PD_DECLARE_int32(cinn_group_tuning_repeat);
+
+namespace cinn::hlir::framework::pir {
+
+#ifdef CINN_WITH_CUDA
+namespace {
+
+using TileConfig = ir::ScheduleConfig::TileConfig;
+using TuningRecord = ir::GroupTuningDatabase::Record;
+using DeviceBuffer = std::unique_ptr<void, cudaError_t (*)(void*)>;
+
+std::string TuningKey(const Target& target, const OpLoweringGroup& group) {
+  std::string device_name = target.device_name_str();
+  std::replace(device_name.begin(), device_name.end(), ' ', '_');
+  return target.arch_str() + "_" + device_name + "_" + GroupFingerprint(group);
+}
+
+// The largest byte size of the values of the group, or nullopt if any of them
+// has a dynamic shape.
+std::optional<int64_t> MaxValueBytes(const OpLoweringGroup& group) {
+  int64_t max_bytes = 0;
+  bool is_static = true;
+  const auto VisitValue = [&](const ::pir::Value& value) {
+    if (!value || !value.type()) return;
+    auto type = value.type().dyn_cast<::pir::DenseTensorType>();
+    if (!type) {
+      is_static = false;
+      return;
+    }
+    int64_t numel = 1;
+    for (int i = 0; i < type.dims().size(); ++i) {
+      if (type.dims()[i] < 0) {
+        is_static = false;
+        return;
+      }
+      numel *= type.dims()[i];
+    }
+    max_bytes = std::max<int64_t>(
+        max_bytes,
+        numel * CompatibleInfo::ConvertIRType(type.dtype()).bytes());
+  };
+  for (auto* op : group.ops()) {
+    for (const auto& value : op->operands_source()) VisitValue(value);
+    for (const auto& value : op->results()) VisitValue(value);
+  }
+  if (!is_static) {
+    return std::nullopt;
+  }
+  return max_bytes;
+}
+
+bool IsSameTileConfig(const TileConfig& lhs, const TileConfig& rhs) {
+  return lhs.warp_num == rhs.warp_num &&
+         lhs.tree_reduce_num == rhs.tree_reduce_num &&
+         lhs.spatial_inner_num == rhs.spatial_inner_num &&
+         lhs.reduce_method.index() == rhs.reduce_method.index();
+}
+
+// The candidates are of the same families as the configs of the schedule
+// config rules in group_tile_config.cc, with the default config first.
+std::vector<TileConfig> TileConfigCandidates(
+    const ir::ScheduleConfig& default_config) {
+  const int64_t reduce_numel = default_config.base_info->reduce_numel;
+  const int64_t spatial_numel = default_config.base_info->spatial_numel;
+  std::vector<TileConfig> candidates{default_config.tile_config};
+  const auto AddCandidate = [&](const TileConfig& config) {
+    for (const auto& candidate : candidates) {
+      if (IsSameTileConfig(candidate, config)) return;
+    }
+    candidates.push_back(config);
+  };
+
+  constexpr int64_t kWarpNums[] = {1, 2, 4, 8, 16, 32};
+  if (reduce_numel == 1) {
+    for (int64_t warp_num : kWarpNums) {
+      for (int64_t spatial_inner_num : {1, 2, 4, 8}) {
+        if (warp_num * 32 * spatial_inner_num > spatial_numel * 2) break;
+        AddCandidate(
+            {warp_num, 1, spatial_inner_num, ir::NoneReduceMethod()});
+      }
+    }
+    return candidates;
+  }
+  if (spatial_numel == 1 || reduce_numel > 256) {
+    for (int64_t warp_num : kWarpNums) {
+      if (warp_num * 32 > reduce_numel) break;
+      AddCandidate({warp_num, warp_num * 32, 1, ir::BlockReduceMethod()});
+    }
+  } else {
+    for (int64_t warp_num : {4, 8, 16}) {
+      for (int64_t spatial_inner_num : {1, 2, 4, 8}) {
+        if (spatial_inner_num > spatial_numel) break;
+        AddCandidate(
+            {warp_num, 32, spatial_inner_num, ir::WarpReduceMethod()});
+      }
+    }
+  }
+  return candidates;
+}
+
+OpLoweringGroupPtr CloneWithTileConfig(const OpLoweringGroupPtr& group,
+                                       const TileConfig& tile_config,
+                                       size_t index) {
+  auto new_group = group->Clone("tuning_" + std::to_string(index));
+  new_group->set_op_pattern_kind(group->op_pattern_kind());
+  new_group->set_loop_ranges_expr(group->loop_ranges_expr());
+  const auto CopyShapeOrData = [&](const ::pir::Value& value) {
+    if (value && group->HasShapeOrDataExprs(value)) {
+      new_group->SetShapeOrDataExprs(value, group->GetShapeOrDataExprs(value));
+    }
+  };
+  for (auto* op : group->ops()) {
+    for (const auto& value : op->operands_source()) CopyShapeOrData(value);
+    for (const auto& value : op->results()) CopyShapeOrData(value);
+  }
+  new_group->set_tile_config(tile_config);
+  return new_group;
+}
+
+// Measure the average time of the kernel in milliseconds. The measurements
+// of the groups compiled in parallel are serialized so as not to disturb
+// each other.
+float MeasureKernel(const CINNKernelInfo& kernel_info,
+                    const std::vector<DeviceBuffer>& buffers) {
+  std::vector<cinn_buffer_t> cinn_buffers(buffers.size());
+  std::vector<cinn_pod_value_t> args;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    cinn_buffers[i].memory = static_cast<uint8_t*>(buffers[i].get());
+    args.emplace_back(&cinn_buffers[i]);
+  }
+  using HostFunc = void (*)(void*, int32_t, void*);
+  const auto Run = [&] {
+    reinterpret_cast<HostFunc>(kernel_info.fn_ptr)(
+        static_cast<void*>(args.data()), args.size(), nullptr);
+  };
+
+  static std::mutex measure_mutex;
+  std::lock_guard<std::mutex> lock(measure_mutex);
+  constexpr int kWarmupNum = 3;
+  for (int i = 0; i < kWarmupNum; ++i) Run();
+  CUDA_CALL(cudaDeviceSynchronize());
+
+  const int repeat = std::max(FLAGS_cinn_group_tuning_repeat, 1);
+  cudaEvent_t start, stop;
+  CUDA_CALL(cudaEventCreate(&start));
+  CUDA_CALL(cudaEventCreate(&stop));
+  cudaEventRecord(start, nullptr);
+  for (int i = 0; i < repeat; ++i) Run();
+  cudaEventRecord(stop, nullptr);
+  cudaEventSynchronize(stop);
+  float time = 0;
+  const cudaError_t status = cudaEventElapsedTime(&time, start, stop);
+  cudaEventDestroy(start);
+  cudaEventDestroy(stop);
+  CUDA_CALL(status);
+  CUDA_CALL(cudaGetLastError());
+  return time / repeat;
+}
+
+std::optional<TuningRecord> Tune(const Target& target,
+                                 const OpLoweringGroupPtr& group,
+                                 const ir::ScheduleConfig& default_config,
+                                 int64_t max_bytes) {
+  // Every kernel arg is bound to a zeroed buffer of the largest value, which
+  // is enough to time the kernel regardless of its data.
+  const size_t arg_num =
+      group->GetInputOpValues().size() + group->output_values().size();
+  std::vector<DeviceBuffer> buffers;
+  for (size_t i = 0; i < arg_num; ++i) {
+    void* ptr = nullptr;
+    CUDA_CALL(cudaMalloc(&ptr, std::max<int64_t>(max_bytes, 1)));
+    buffers.emplace_back(ptr, cudaFree);
+    CUDA_CALL(cudaMemset(ptr, 0, std::max<int64_t>(max_bytes, 1)));
+  }
+
+  std::optional<TuningRecord> best;
+  const auto& candidates = TileConfigCandidates(default_config);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    const auto& config = candidates[i];
+    try {
+      // The context refers to the group, which must outlive it.
+      const auto candidate = CloneWithTileConfig(group, config, i);
+      GroupCompilationContext context(target, candidate);
+      CompilationTask task(&context);
+      task.Lowering();
+      const auto& result = task.CodegenAndJit();
+      const auto& kernel_info = result->GetKernelInfo();
+      if (!kernel_info.int_args_map.empty()) {
+        continue;
+      }
+      const float time = MeasureKernel(kernel_info, buffers);
+      VLOG(4) << "Tile config candidate " << i << " of " << group->FuncName()
+              << " {warp_num: " << config.warp_num
+              << ", tree_reduce_num: " << config.tree_reduce_num
+              << ", spatial_inner_num: " << config.spatial_inner_num
+              << ", reduce_method: " << config.reduce_method.index()
+              << "}: " << time << " ms";
+      if (!best.has_value() || time < best->time) {
+        best = TuningRecord{config, time};
+      }
+    } catch (const std::exception& e) {
+      VLOG(4) << "Skip tile config candidate " << i << " of "
+              << group->FuncName() << ": " << e.what();
+    }
+  }
+  return best;
+}
+
+}  // namespace
+#endif
+
+void ApplyTunedTileConfig(const Target& target,
+                          const OpLoweringGroupPtr& group) {
+#ifdef CINN_WITH_CUDA
+  auto& database = ir::GroupTuningDatabase::Instance();
+  if (!database.Enabled() || group->tile_config().has_value() ||
+      group->loop_ranges().empty() ||
+      !std::holds_alternative<common::NVGPUArch>(target.arch.variant())) {
+    return;
+  }
+  const auto& max_bytes = MaxValueBytes(*group);
+  if (!max_bytes.has_value()) {
+    return;
+  }
+
+  const std::string key = TuningKey(target, *group);
+  auto record = database.Lookup(key);
+  if (!record.has_value() && FLAGS_cinn_group_tuning) {
+    auto group_info = std::make_shared<GroupInfo>();
+    group_info->data_space = group->loop_ranges();
+    group_info->reduce_axis = group->reduce_axis();
+    const auto& config_map = ir::BuildScheduleConfig(group_info, target);
+    if (config_map.size() != 1) {
+      return;
+    }
+    try {
+      record = Tune(
+          target, group, config_map.begin()->second, max_bytes.value());
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to tune the tile config of " << group->FuncName()
+                   << ": " << e.what();
+    }
+    if (record.has_value()) {
+      database.Update(key, record.value());
+    }
+  }
+  if (record.has_value()) {
+    VLOG(4) << "Apply the tile config tuned for " << group->FuncName()
+            << " with the kernel time of " << record->time << " ms";
+    group->set_tile_config(record->tile_config);
+  }
+#endif
+}
+
+}  // namespace cinn::hlir::framework::pir
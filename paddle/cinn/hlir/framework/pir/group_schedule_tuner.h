@@ -0,0 +1,34 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/hlir/framework/pir/op_lowering_impl.h"
+
+namespace cinn::hlir::framework::pir {
+
+/**
+ * Set the tile config of a static shape group to the one stored in the group
+ * tuning database (see FLAGS_cinn_group_tuning_database). If the group is
+ * missing and FLAGS_cinn_group_tuning is set, the candidate configs are
+ * compiled and measured on device first, and the fastest one is stored.
+ *
+ * The dynamic shape groups and the non-GPU targets are left to the schedule
+ * config rules.
+ */
+void ApplyTunedTileConfig(const Target& target,
+                          const OpLoweringGroupPtr& group);
+
+}  // namespace cinn::hlir::framework::pir
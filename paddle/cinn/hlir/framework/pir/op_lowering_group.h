@@ -14,6 +14,7 @@
 
 #pragma once
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -22,6 +23,7 @@
 #include "paddle/cinn/common/context.h"
 #include "paddle/cinn/hlir/framework/op.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
+#include "paddle/cinn/ir/group_schedule/config/group_tile_config.h"
 #include "paddle/cinn/operator_fusion/fusion_tracker/tracker.h"
 #include "paddle/common/enforce.h"
 #include "paddle/pir/include/core/builtin_type_interfaces.h"
@@ -81,6 +83,13 @@ class OpLoweringGroup {
     }
   }
 
+  // The values of the symbolic input dims which the group is specialized
+  // for, empty if the group is not a shape bucket specialization.
+  const std::vector<int64_t>& shape_bucket() const { return shape_bucket_; }
+  void set_shape_bucket(const std::vector<int64_t>& shape_bucket) {
+    shape_bucket_ = shape_bucket;
+  }
+
   bool IsBroadcastLeaf() const { return is_broadcast_leaf_; }
   void SetIsBroadcastLeaf(bool is_broadcast_leaf) {
     is_broadcast_leaf_ = is_broadcast_leaf;
@@ -184,6 +193,16 @@ class OpLoweringGroup {
     return this->int_args_map_;
   }
 
+  // The tile config tuned for the group, which overrides the ones of the
+  // schedule config rules.
+  const std::optional<ir::ScheduleConfig::TileConfig>& tile_config() const {
+    return this->tile_config_;
+  }
+
+  void set_tile_config(const ir::ScheduleConfig::TileConfig& tile_config) {
+    this->tile_config_ = tile_config;
+  }
+
  private:
   using alignment_schedule_info_t = std::unordered_map<
       ::pir::Operation*,
@@ -225,6 +244,7 @@ class OpLoweringGroup {
   // refactoring logic of OpLoweringGroup.
   bool is_broadcast_leaf_{false};
   std::vector<BroadcastCond> broadcast_conditions_;
+  std::vector<int64_t> shape_bucket_;
 
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
@@ -235,6 +255,7 @@ class OpLoweringGroup {
   std::vector<int64_t> reduce_axis_;
   std::vector<int64_t> loop_ranges_;
   std::vector<symbol::DimExpr> loop_ranges_expr_;
+  std::optional<ir::ScheduleConfig::TileConfig> tile_config_;
 
   std::shared_ptr<adt::MapExprCtx> map_expr_ctx_;
   std::unordered_map<::pir::Value, symbol::ShapeOrDataDimExprs>
@@ -97,6 +97,7 @@ std::shared_ptr<GroupInfo> OpLowererImpl::GetGroupInfo(
   group_info->data_space = fusion_group_info.loop_ranges;
   group_info->loop_strides = fusion_group_info.loop_strides;
   group_info->reduce_axis = fusion_group_info.reduce_axis;
+  group_info->tile_config = group->tile_config();
   group_info->reduce_var_names =
       std::set<std::string>(fusion_group_info.reduce_var_name.begin(),
                             fusion_group_info.reduce_var_name.end());
@@ -113,6 +114,7 @@ std::shared_ptr<GroupInfo> OpLowererImpl::GetGroupInfo(
   std::shared_ptr<GroupInfo> group_info = std::make_shared<GroupInfo>();
   group_info->data_space = group->loop_ranges();
   group_info->reduce_axis = group->reduce_axis();
+  group_info->tile_config = group->tile_config();
   for (auto op : group->ops()) {
     if (CompatibleInfo::OpKind(*op) == OpPatternKind::kReduction) {
       group_info->reduce_var_names.insert(ValueName(op->result(0)));
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "paddle/cinn/common/target.h"
@@ -55,6 +56,7 @@ struct GroupInfo {
   std::set<std::string> shared_var_names;
   std::set<std::string> direct_output_var_names;
   std::vector<std::string> broadcast_output_names;
+  std::optional<ir::ScheduleConfig::TileConfig> tile_config;
 };
 
 class OpLowererImpl : public OpLowererImplBase<OpLoweringGroupPtr> {
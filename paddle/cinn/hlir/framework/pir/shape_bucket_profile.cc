@@ -0,0 +1,130 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/hlir/framework/pir/shape_bucket_profile.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "paddle/cinn/utils/string.h"
+#include "paddle/common/flags.h"
+
+PD_DECLARE_string(cinn_shape_bucket_profile);
+
+namespace cinn::hlir::framework::pir {
+
+ShapeBucketProfile& ShapeBucketProfile::Instance() {
+  static ShapeBucketProfile instance(FLAGS_cinn_shape_bucket_profile);
+  return instance;
+}
+
+ShapeBucketProfile::ShapeBucketProfile(const std::string& path)
+    : path_(path) {
+  Load();
+}
+
+ShapeBucketProfile::~ShapeBucketProfile() { Save(); }
+
+void ShapeBucketProfile::Record(const std::string& key,
+                                const std::vector<int64_t>& dim_values) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++counts_[key][dim_values];
+}
+
+std::vector<std::vector<int64_t>> ShapeBucketProfile::HotBuckets(
+    const std::string& key, size_t max_num, double min_ratio) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = counts_.find(key);
+  if (iter == counts_.end()) {
+    return {};
+  }
+  int64_t total = 0;
+  std::vector<std::pair<int64_t, std::vector<int64_t>>> buckets;
+  for (const auto& [dim_values, count] : iter->second) {
+    total += count;
+    buckets.emplace_back(count, dim_values);
+  }
+  std::stable_sort(
+      buckets.begin(), buckets.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+      });
+
+  std::vector<std::vector<int64_t>> hot_buckets;
+  for (const auto& [count, dim_values] : buckets) {
+    if (hot_buckets.size() >= max_num || count < min_ratio * total) {
+      break;
+    }
+    hot_buckets.push_back(dim_values);
+  }
+  return hot_buckets;
+}
+
+void ShapeBucketProfile::Load() {
+  if (path_.empty()) {
+    return;
+  }
+  std::ifstream file(path_);
+  if (!file.is_open()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    std::string key, values;
+    int64_t count = 0;
+    if (!(ss >> key >> count)) {
+      continue;
+    }
+    std::vector<int64_t> dim_values;
+    if (ss >> values) {
+      for (const auto& value : utils::Split(values, ",")) {
+        dim_values.push_back(std::stoll(value));
+      }
+    }
+    counts_[key][dim_values] += count;
+  }
+  VLOG(4) << "Load the shape bucket profile of " << counts_.size()
+          << " groups from " << path_;
+}
+
+void ShapeBucketProfile::Save() const {
+  if (path_.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    for (const auto& [key, buckets] : counts_) {
+      for (const auto& [dim_values, count] : buckets) {
+        file << key << " " << count << " "
+             << utils::Join(dim_values, ",") << "\n";
+      }
+    }
+    if (!file.good()) {
+      LOG(WARNING) << "Failed to write the shape bucket profile " << tmp_path;
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    LOG(WARNING) << "Failed to save the shape bucket profile to " << path_;
+  }
+}
+
+}  // namespace cinn::hlir::framework::pir
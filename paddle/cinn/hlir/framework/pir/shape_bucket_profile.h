@@ -0,0 +1,74 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cinn::hlir::framework::pir {
+
+/**
+ * The profile of the shape buckets of the dynamic shape groups, i.e. how many
+ * times each binding of the symbolic input dims of a group is observed at
+ * runtime. The hot buckets are specialized into static kernels when the group
+ * is lowered again, e.g. by the next run of a serving job, which reads the
+ * profile saved to FLAGS_cinn_shape_bucket_profile.
+ *
+ * The profile is saved as the text lines of "<key> <count> <v0>,<v1>,...".
+ */
+class ShapeBucketProfile {
+ public:
+  /**
+   * The profile of FLAGS_cinn_shape_bucket_profile, which is loaded when it is
+   * first used and saved at exit.
+   */
+  static ShapeBucketProfile& Instance();
+
+  explicit ShapeBucketProfile(const std::string& path);
+  ~ShapeBucketProfile();
+
+  bool Enabled() const { return !path_.empty(); }
+
+  /**
+   * Record a call of the group with the values of its symbolic input dims.
+   */
+  void Record(const std::string& key, const std::vector<int64_t>& dim_values);
+
+  /**
+   * Get the hot buckets of the group in the descending order of their counts,
+   * each of which takes at least min_ratio of the calls of the group.
+   * @param key The key of the group.
+   * @param max_num The maximum number of the buckets.
+   * @param min_ratio The minimum ratio of the calls of a bucket.
+   */
+  std::vector<std::vector<int64_t>> HotBuckets(const std::string& key,
+                                               size_t max_num,
+                                               double min_ratio) const;
+
+  void Load();
+  void Save() const;
+
+ private:
+  std::string path_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::map<std::vector<int64_t>, int64_t>>
+      counts_;
+};
+
+}  // namespace cinn::hlir::framework::pir
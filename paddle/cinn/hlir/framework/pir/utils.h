@@ -13,9 +13,11 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "paddle/cinn/common/context.h"
 #include "paddle/cinn/common/type.h"
 #include "paddle/cinn/hlir/framework/op.h"
@@ -52,6 +54,25 @@ struct CINNKernelInfo {
   //     3: {1, 2}
   //   }
   std::map<int, ArgDimIdx> int_args_map;
+
+  // The kernels specialized for the hot shape buckets of a dynamic shape
+  // group, i.e. the observed values of its symbolic input dims, which are
+  // looked up before falling back to the generic kernel.
+  // Examples:
+  //   a func like: foo(tensor A, tensor B, int S0)
+  //   S0 = A.shape[1]
+  //   bucket_key is "3f2a...", bucket_dims is [{0, 1}] and
+  //   specialized_kernels is [{{128}, fn_128, {}}, {{256}, fn_256, {}}]
+  struct SpecializedKernel {
+    std::vector<int64_t> dim_values;
+    void* fn_ptr;
+    std::map<int, ArgDimIdx> int_args_map;
+  };
+  // The key of the group in the shape bucket profile, empty if the group
+  // doesn't need profiling.
+  std::string bucket_key;
+  std::vector<ArgDimIdx> bucket_dims;
+  std::vector<SpecializedKernel> specialized_kernels;
 };
 
 struct CompatibleInfo {
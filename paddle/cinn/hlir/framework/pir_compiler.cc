@@ -15,14 +15,22 @@
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 #include "paddle/cinn/ir/group_schedule/config/schedule_config_manager.h"
 
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#include "paddle/cinn/hlir/framework/pir/group_schedule_tuner.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
 #include "paddle/cinn/runtime/arch_device.h"
 #include "paddle/cinn/utils/multi_threading.h"
+#include "paddle/cinn/utils/timer.h"
 #include "paddle/common/enforce.h"
 #include "paddle/common/flags.h"
 
 PD_DECLARE_bool(enable_cinn_compile_cache);
 PD_DECLARE_int64(cinn_compile_thread_num);
+PD_DECLARE_bool(cinn_compile_time_report);
 
 namespace cinn::hlir::framework {
 class CompilationContextMapper {
@@ -54,14 +62,66 @@ class CompilationContextMapper {
   bool is_finalized_{false};
 };
 
+// The thread budget is FLAGS_cinn_compile_thread_num, or the hardware
+// concurrency by default, and never more threads than the tasks.
 static size_t GetThreadNum(size_t task_size) {
-  size_t thread_size = task_size;
   if (!FLAGS_enable_cinn_compile_cache) {
-    thread_size = 1;
-  } else if (FLAGS_cinn_compile_thread_num > 0) {
+    return 1;
+  }
+  size_t thread_size = std::max(std::thread::hardware_concurrency(), 1U);
+  if (FLAGS_cinn_compile_thread_num > 0) {
     thread_size = FLAGS_cinn_compile_thread_num;
   }
-  return thread_size;
+  return std::max<size_t>(std::min(thread_size, task_size), 1);
+}
+
+// The compile time of a group in milliseconds.
+struct GroupCompileTime {
+  float lowering{0};
+  float backend{0};
+  float jit{0};
+
+  float Total() const { return lowering + backend + jit; }
+};
+
+static void ReportCompileTime(const std::vector<GroupCompileTime>& times,
+                              const std::vector<std::string>& func_names,
+                              size_t group_size,
+                              size_t thread_size,
+                              float wall_time) {
+  if (!FLAGS_cinn_compile_time_report && !VLOG_IS_ON(4)) {
+    return;
+  }
+  GroupCompileTime sum;
+  for (const auto& time : times) {
+    sum.lowering += time.lowering;
+    sum.backend += time.backend;
+    sum.jit += time.jit;
+  }
+  std::vector<size_t> order(times.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return times[lhs].Total() > times[rhs].Total();
+  });
+
+  std::stringstream ss;
+  ss << "CINN compiled " << times.size() << " groups (" << group_size
+     << " given, " << group_size - times.size()
+     << " deduplicated or cached) with " << thread_size << " threads in "
+     << wall_time << " ms, lowering: " << sum.lowering
+     << " ms, backend: " << sum.backend << " ms, jit: " << sum.jit << " ms.";
+  constexpr size_t kSlowestNum = 5;
+  for (size_t i = 0; i < std::min(order.size(), kSlowestNum); ++i) {
+    const auto& time = times[order[i]];
+    ss << "\n  " << func_names[order[i]] << ": " << time.Total()
+       << " ms (lowering: " << time.lowering << ", backend: " << time.backend
+       << ", jit: " << time.jit << ")";
+  }
+  if (FLAGS_cinn_compile_time_report) {
+    LOG(INFO) << ss.str();
+  } else {
+    VLOG(4) << ss.str();
+  }
 }
 
 std::vector<pir::CINNKernelInfo> PirCompiler::Build(
@@ -76,20 +136,51 @@ std::vector<pir::CINNKernelInfo> PirCompiler::Build(
           << groups.size() << " and compiles with " << thread_size;
   cinn::ir::InitScheduleConfig();
   if (task_size > 0) {
+    std::vector<GroupCompileTime> compile_times(task_size);
+    std::vector<std::string> func_names(task_size);
+    utils::Timer wall_timer;
+    wall_timer.Start();
     // See
     // https://developer.nvidia.com/blog/cuda-pro-tip-always-set-current-device-avoid-multithreading-bugs/
     // for details.
     const auto device_id = runtime::GetArchDevice(target_);
     auto worker_fn = [&](int index) {
       runtime::SetArchDevice(target_, device_id);
+      // Each thread runs the lowering, the backend compilation (including
+      // NVRTC) and the JIT of a group, so the stages of the different groups
+      // overlap with each other.
+      utils::Timer timer;
       CompilationTask task(&group_compilation_contexts[index]);
-      compilation_results[index] = task();
+      timer.Start();
+      pir::ApplyTunedTileConfig(target_,
+                                group_compilation_contexts[index].group());
+      task.Lowering();
+      compile_times[index].lowering = timer.Stop();
+      timer.Start();
+      compilation_results[index] = task.CodegenAndJit();
+      compile_times[index].backend = timer.Stop();
+      timer.Start();
       // Triggering llvm compilation in thread
       compilation_results[index]->GetKernelInfo();
+      compile_times[index].jit = timer.Stop();
+      func_names[index] = compilation_results[index]->GetHostFuncName();
     };
+    // The threads claim the groups one at a time, the largest groups first,
+    // so that a long group is not left to a single thread at the end.
+    std::vector<int> order(task_size);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+      return group_compilation_contexts[lhs].group()->ops().size() >
+             group_compilation_contexts[rhs].group()->ops().size();
+    });
     utils::parallel_run(worker_fn,
-                        utils::SequenceDispatcher(0, task_size),
+                        utils::IndexListDispatcher(std::move(order)),
                         /*thread_num=*/thread_size);
+    ReportCompileTime(compile_times,
+                      func_names,
+                      groups.size(),
+                      thread_size,
+                      wall_timer.Stop());
   }
   VLOG(5) << "Finished compiling " << task_size << " Cinn Kernel info.";
   ctx_mapper.SetFinalize(true);
@@ -0,0 +1,138 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/ir/group_schedule/config/group_tuning_database.h"
+
+#include <glog/logging.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "paddle/common/flags.h"
+
+PD_DECLARE_string(cinn_group_tuning_database);
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+std::optional<ReduceMethod> ReduceMethodFromIndex(int index) {
+  switch (index) {
+    case 0:
+      return NoneReduceMethod();
+    case 1:
+      return WarpReduceMethod();
+    case 2:
+      return BlockReduceMethod();
+    case 3:
+      return DiscreteReduceMethod();
+    default:
+      return std::nullopt;
+  }
+}
+
+}  // namespace
+
+GroupTuningDatabase& GroupTuningDatabase::Instance() {
+  static GroupTuningDatabase instance(FLAGS_cinn_group_tuning_database);
+  return instance;
+}
+
+GroupTuningDatabase::GroupTuningDatabase(const std::string& path)
+    : path_(path) {
+  Load();
+}
+
+GroupTuningDatabase::~GroupTuningDatabase() { Save(); }
+
+std::optional<GroupTuningDatabase::Record> GroupTuningDatabase::Lookup(
+    const std::string& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = records_.find(key);
+  if (iter == records_.end()) {
+    return std::nullopt;
+  }
+  return iter->second;
+}
+
+void GroupTuningDatabase::Update(const std::string& key,
+                                 const Record& record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = records_.find(key);
+  if (iter == records_.end() || record.time < iter->second.time) {
+    records_[key] = record;
+  }
+}
+
+void GroupTuningDatabase::Load() {
+  if (path_.empty()) {
+    return;
+  }
+  std::ifstream file(path_);
+  if (!file.is_open()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    Record record;
+    int reduce_method = 0;
+    if (!(ss >> key >> record.tile_config.warp_num >>
+          record.tile_config.tree_reduce_num >>
+          record.tile_config.spatial_inner_num >> reduce_method >>
+          record.time)) {
+      continue;
+    }
+    const auto& method = ReduceMethodFromIndex(reduce_method);
+    if (!method.has_value()) {
+      continue;
+    }
+    record.tile_config.reduce_method = method.value();
+    records_[key] = record;
+  }
+  VLOG(4) << "Load the tile configs of " << records_.size()
+          << " groups from " << path_;
+}
+
+void GroupTuningDatabase::Save() const {
+  if (path_.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    for (const auto& [key, record] : records_) {
+      const auto& config = record.tile_config;
+      file << key << " " << config.warp_num << " " << config.tree_reduce_num
+           << " " << config.spatial_inner_num << " "
+           << config.reduce_method.index() << " " << record.time << "\n";
+    }
+    if (!file.good()) {
+      LOG(WARNING) << "Failed to write the group tuning database "
+                   << tmp_path;
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    LOG(WARNING) << "Failed to save the group tuning database to " << path_;
+  }
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,74 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "paddle/cinn/ir/group_schedule/config/group_tile_config.h"
+
+namespace cinn {
+namespace ir {
+
+/**
+ * The database of the tile configs tuned for the static shape groups, keyed
+ * by the target and the fingerprint of the group, which is loaded from and
+ * saved to FLAGS_cinn_group_tuning_database, so that the configs measured by
+ * one run are applied by the later runs.
+ *
+ * The database is saved as the text lines of
+ * "<key> <warp_num> <tree_reduce_num> <spatial_inner_num> <reduce_method>
+ * <time>", where reduce_method is the index of the ReduceMethod variant and
+ * time is the measured kernel time in milliseconds.
+ */
+class GroupTuningDatabase {
+ public:
+  struct Record {
+    ScheduleConfig::TileConfig tile_config;
+    float time;
+  };
+
+  /**
+   * The database of FLAGS_cinn_group_tuning_database, which is loaded when it
+   * is first used and saved at exit.
+   */
+  static GroupTuningDatabase& Instance();
+
+  explicit GroupTuningDatabase(const std::string& path);
+  ~GroupTuningDatabase();
+
+  bool Enabled() const { return !path_.empty(); }
+
+  std::optional<Record> Lookup(const std::string& key) const;
+
+  /**
+   * Record the tile config of the group, which replaces the stored one only
+   * if it is faster.
+   */
+  void Update(const std::string& key, const Record& record);
+
+  void Load();
+  void Save() const;
+
+ private:
+  std::string path_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Record> records_;
+};
+
+}  // namespace ir
+}  // namespace cinn
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "paddle/cinn/ir/group_schedule/config/schedule_config_manager.h"
+#include "paddle/cinn/hlir/framework/pir/op_lowering_impl.h"
 #include "paddle/cinn/ir/group_schedule/config/file_database.h"
 
 PD_DECLARE_string(tile_config_policy);
@@ -42,6 +43,15 @@ ScheduleConfigMap ScheduleConfigManager::ExtractConfigs(
     return CombineBaseInfoAndConfig(tile_config_map, base_info);
   };
 
+  if (group_info->tile_config.has_value()) {
+    // The tile config tuned for the group overrides all of its buckets.
+    ScheduleConfigMap config_map = BuildScheduleConfig(group_info, target);
+    for (auto& [bucket_info, config] : config_map) {
+      config.tile_config = group_info->tile_config.value();
+    }
+    return config_map;
+  }
+
   if (policy_ == "default" || tile_config_data_.count(policy_) == 0) {
     return BuildScheduleConfig(group_info, target);
   } else if (policy_ == "hybrid") {
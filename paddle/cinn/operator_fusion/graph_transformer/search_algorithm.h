@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
 #include <queue>
 #include "paddle/cinn/operator_fusion/pattern_graph.h"
 
@@ -23,6 +24,7 @@ struct EdgePattern {};
 struct GraphPattern {};     // not implemented.
 struct NodePairPattern {};  // not implemented.
 struct ReverseTopoNodePairPattern {};
+struct LoopFrameworkNodePairPattern {};
 
 template <typename Kind, typename GraphMatcher, typename GraphOperation>
 struct SearchAlgorithm {};
@@ -135,6 +137,51 @@ struct SearchAlgorithm<ReverseTopoNodePairPattern,
   }
 };
 
+// Only the nodes of the same squeezed loop framework can be fused
+// horizontally, so the nodes are bucketed by it and each node is merged into
+// the first matched node of its bucket in topo order. Unlike NodePairPattern,
+// which rescans all node pairs after every merge, this takes a single pass and
+// stays cheap for the wide graphs with many independent small patterns.
+template <typename GraphMatcher, typename GraphOperation>
+struct SearchAlgorithm<LoopFrameworkNodePairPattern,
+                       GraphMatcher,
+                       GraphOperation> {
+  PatternGraph* graph_;
+
+  explicit SearchAlgorithm(PatternGraph* graph) {
+    VLOG(4) << "Create LoopFrameworkNodePairPattern algorithm.";
+    graph_ = graph;
+  }
+
+  std::string LoopFrameworkKey(const PatternNodePtr& node) {
+    return utils::Join(
+        SqueezeLoopFramework(GetLoopFramework(node->stmt_pattern())), ",");
+  }
+
+  void operator()() {
+    std::map<std::string, std::vector<PatternNodePtr>> buckets;
+    for (const auto& node : graph_->SortByTopoOrder()) {
+      if (GetPatternName(node->stmt_pattern()) == UnsupportPattern::name()) {
+        continue;
+      }
+      auto& bucket = buckets[LoopFrameworkKey(node)];
+      bool merged = false;
+      for (auto& target : bucket) {
+        if (GraphMatcher()(*graph_, target, node)) {
+          VLOG(4) << "Find Matched Node Pair: (" << target << ", " << node
+                  << ")";
+          target = GraphOperation()(graph_, target, node);
+          merged = true;
+          break;
+        }
+      }
+      if (!merged) {
+        bucket.push_back(node);
+      }
+    }
+  }
+};
+
 template <typename Kind, typename GraphMatcher, typename GraphOperation>
 void GraphTransformer(PatternGraph* graph) {
   VLOG(4) << "Start GraphTransformer...";
@@ -157,7 +157,7 @@ void PatternGraph::HorizontalFusion() {
                       StmtPatternGraphMatcher<AnchorPattern>>,
                    LiftToHorizontalFusionPatternOperation>(this);
 
-  GraphTransformer<NodePairPattern,
+  GraphTransformer<LoopFrameworkNodePairPattern,
                    And<HorizontalFusionConstrain,
                        InputOutputMaximumConstrain,
                        HorizontalCheckMiddleOutputVar>,  // Avoid two many
@@ -13,24 +13,32 @@
 // limitations under the License.
 
 #include "paddle/cinn/operator_fusion/policy/general_topo_policy.h"
+
+#include <unordered_set>
+
 #include "paddle/cinn/operator_fusion/pattern.h"
 
 namespace cinn::fusion {
 
+// The visited nodes are skipped, otherwise the search is exponential in the
+// number of diamonds of the graph.
 bool IsDownstreamNode(const PatternNodePtr& start,
-                      const PatternNodePtr& target) {
+                      const PatternNodePtr& target,
+                      std::unordered_set<PatternNodePtr>* visited) {
   if (start == target) return true;
+  if (!visited->insert(start).second) return false;
   for (const auto& down_node : start->downstream()) {
-    if (IsDownstreamNode(down_node, target)) return true;
+    if (IsDownstreamNode(down_node, target, visited)) return true;
   }
   return false;
 }
 
 bool IsIndirectDownstreamNode(const PatternNodePtr& start,
                               const PatternNodePtr& target) {
+  std::unordered_set<PatternNodePtr> visited;
   for (const auto& node : start->downstream()) {
     if (node == target) continue;
-    if (IsDownstreamNode(node, target)) return true;
+    if (IsDownstreamNode(node, target, &visited)) return true;
   }
   return false;
 }
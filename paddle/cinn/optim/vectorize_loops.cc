@@ -131,16 +131,6 @@ class TensorVectorizeTeller : public ir::IRMutator<const Expr *> {
       return x->As<_Var_>() && x->As<_Var_>()->name == iter_var_->name;
     };
 
-    // the size of the last dim should be divisible by factor
-    Expr last_size = tensor->shape.back();
-    if (tensor->shape.empty() || !tensor->shape.back().As<IntImm>() ||
-        tensor->shape.back().as_int32() % factor_ != 0) {
-      VLOG(5) << "Size of the last dim of tensor:" << tensor->name
-              << " can't be divisible by factor:" << factor_
-              << ", shape:" << utils::Join(tensor->shape, ",");
-      return false;
-    }
-
     // the iter val must appear in the last index
     if (indices.empty() ||
         ir::ir_utils::CollectIRNodes(indices.back(), find_matched_var_fn)
@@ -165,6 +155,27 @@ class TensorVectorizeTeller : public ir::IRMutator<const Expr *> {
     Expr first_idx = ir::ir_utils::IRCopy(indices.back());
     cinn::ir::ir_utils::IrReplaceVarBroadcast(
         &first_idx, Expr(iter_var_), Expr(0));
+
+    // the vectors should be aligned, i.e. the size of the last dim should be
+    // divisible by factor, or the tensor is 1-D and the first index of the
+    // vector is a multiple of factor, e.g. an odd sized tensor whose tail is
+    // peeled off the vectorized loop
+    if (tensor->shape.empty()) {
+      return false;
+    }
+    const bool rows_aligned = tensor->shape.back().As<IntImm>() &&
+                              tensor->shape.back().as_int32() % factor_ == 0;
+    const bool index_aligned =
+        tensor->shape.size() == 1 &&
+        cinn::common::is_zero(cinn::common::AutoSimplify(
+            Mod::Make(first_idx, make_const(first_idx.type(), factor_))));
+    if (!rows_aligned && !index_aligned) {
+      VLOG(5) << "Size of the last dim of tensor:" << tensor->name
+              << " can't be divisible by factor:" << factor_
+              << ", shape:" << utils::Join(tensor->shape, ",")
+              << ", first index:" << first_idx;
+      return false;
+    }
     const auto &interval = var_intervals_->at(iter_var_->name);
     for (int i = 1; i < interval.r; ++i) {
       Expr next_idx = ir::ir_utils::IRCopy(indices.back());
@@ -766,6 +777,9 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     }
     // the extent the forloops marked as Vectorized should be int constant
     if (forloop->is_vectorized()) {
+      if (PeelTail(node, expr)) {
+        return;
+      }
       Context::info_rgt().Get<int>("vectorized_forloop_count")++;
 
       PADDLE_ENFORCE_GT(
@@ -904,6 +918,52 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     var_intervals.erase(loop_var_name);
   }
 
+  //! Peel the tail of a vectorized forloop whose constant extent is not a
+  //! multiple of the factor into a serial forloop, so that the rest of it can
+  //! still be vectorized, e.g.
+  //!   for (i, 0, 5123) vectorized(4) {...}
+  //! becomes
+  //!   for (i, 0, 5120) vectorized(4) {...}
+  //!   for (i_tail, 0, 3) {...[i -> i_tail + 5120]}
+  //! @return Whether the forloop is peeled.
+  bool PeelTail(For *forloop, Expr *expr) {
+    Expr for_extent = cinn::common::AutoSimplify(forloop->extent);
+    Simplify(&for_extent);
+    auto *extent_int = for_extent.As<IntImm>();
+    const int factor = forloop->vectorize_info().factor;
+    if (!is_zero(forloop->min) || !extent_int || factor <= 1 ||
+        extent_int->value <= factor || extent_int->value % factor == 0) {
+      return false;
+    }
+    const int64_t main_extent =
+        extent_int->value - extent_int->value % factor;
+    const Type extent_type = for_extent.type();
+
+    Var tail_var(cinn::common::UniqName(forloop->loop_var->name + "_tail"));
+    Expr tail_body =
+        ir::ir_utils::IRCopy(forloop->body, /* copy_buffer_node = */ false);
+    cinn::ir::ir_utils::IrReplaceVarBroadcast(
+        &tail_body,
+        forloop->loop_var,
+        Expr(tail_var) + make_const(extent_type, main_extent));
+    Expr tail_loop =
+        For::Make(tail_var,
+                  make_const(extent_type, 0),
+                  make_const(extent_type, extent_int->value % factor),
+                  ForType::Serial,
+                  forloop->device_api,
+                  tail_body);
+    VLOG(5) << "Peel the tail of the vectorized forloop: " << tail_loop;
+
+    forloop->extent = make_const(extent_type, main_extent);
+    Expr main_loop = *expr;
+    var_intervals.erase(forloop->loop_var->name);
+    Visit(forloop, &main_loop);
+    IRMutator<>::Visit(&tail_loop, &tail_loop);
+    *expr = Block::Make({main_loop, tail_loop});
+    return true;
+  }
+
   //! unroll the forloop if its' extent is min type by solving the condition
   //! extent
   //! @return The new forloop.
@@ -0,0 +1,75 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/optim/vectorize_loops.h"
+
+#include <gtest/gtest.h>
+
+#include "paddle/cinn/cinn.h"
+#include "paddle/cinn/ir/ir.h"
+#include "paddle/cinn/ir/ir_printer.h"
+#include "paddle/cinn/ir/op/ir_operators.h"
+
+namespace cinn {
+namespace optim {
+
+// for (i, 0, extent) vectorized(factor) { B[i] = A[i] + 1 }
+Expr MakeVectorizedLoop(int extent, int factor) {
+  Placeholder<float> A("A", {Expr(extent)});
+  Placeholder<float> B("B", {Expr(extent)});
+  Var i("i");
+  Expr body = ir::Block::Make({ir::Store::Make(
+      ir::Tensor(B),
+      ir::Load::Make(ir::Tensor(A), {Expr(i)}) + Expr(1.f),
+      {Expr(i)})});
+  return ir::For::Make(i,
+                       Expr(0),
+                       Expr(extent),
+                       ir::ForType::Vectorized,
+                       ir::DeviceAPI::UNK,
+                       body,
+                       ir::VectorizeInfo(0, factor));
+}
+
+TEST(VectorizeLoops, PeelTail) {
+  Context::Global().ResetNameId();
+  Expr loop = MakeVectorizedLoop(10, 4);
+  VectorizeLoops(&loop, cinn::common::DefaultHostTarget());
+  VLOG(6) << "After VectorizeLoops: " << loop;
+
+  auto* block = loop.As<ir::Block>();
+  ASSERT_NE(block, nullptr);
+  ASSERT_EQ(block->stmts.size(), 2UL);
+  auto* main_loop = block->stmts[0].As<ir::For>();
+  ASSERT_NE(main_loop, nullptr);
+  EXPECT_EQ(main_loop->extent.as_int32(), 2);
+  auto* tail_loop = block->stmts[1].As<ir::For>();
+  ASSERT_NE(tail_loop, nullptr);
+  EXPECT_FALSE(tail_loop->is_vectorized());
+  EXPECT_EQ(tail_loop->extent.as_int32(), 2);
+}
+
+TEST(VectorizeLoops, NoTail) {
+  Context::Global().ResetNameId();
+  Expr loop = MakeVectorizedLoop(16, 4);
+  VectorizeLoops(&loop, cinn::common::DefaultHostTarget());
+  VLOG(6) << "After VectorizeLoops: " << loop;
+
+  auto* main_loop = loop.As<ir::For>();
+  ASSERT_NE(main_loop, nullptr);
+  EXPECT_EQ(main_loop->extent.as_int32(), 4);
+}
+
+}  // namespace optim
+}  // namespace cinn
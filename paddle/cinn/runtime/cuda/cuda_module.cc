@@ -19,8 +19,12 @@
 #include <glog/logging.h>
 #include <glog/raw_logging.h>
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "paddle/cinn/backends/cuda_util.h"
@@ -99,8 +103,81 @@ CUfunction CUDAModule::GetFunction(int device_id,
   VLOG(5) << "GetFunction : " << func_name << " with device_id : " << device_id;
   cinn::utils::RecordEvent record_run("cuLaunchKernel",
                                       cinn::utils::EventType::kOrdinary);
-  if (!module_per_card_[device_id]) {
-    std::lock_guard<std::mutex> lock(mutex_);
+  CUfunction func;
+  CUDA_DRIVER_CALL(
+      cuModuleGetFunction(&func, LoadModule(device_id), func_name.c_str()));
+  return func;
+}
+
+CUdeviceptr CUDAModule::GetGlobal(int device_id,
+                                  const std::string& name,
+                                  size_t nbytes) {
+  size_t _nbytes;
+  CUdeviceptr global;
+  CUDA_DRIVER_CALL(cuModuleGetGlobal(
+      &global, &_nbytes, LoadModule(device_id), name.c_str()));
+  return global;
+}
+
+std::shared_ptr<CUDAModule> CUDAModule::GetOrCreate(const std::string& data,
+                                                    Kind kind) {
+  // nvcc returns the path of the cubin rather than the code, whose content
+  // may change, so such modules are never shared.
+  if (runtime::CanUseNvccCompiler()) {
+    return std::make_shared<CUDAModule>(data, kind);
+  }
+  static std::mutex mutex;
+  static std::unordered_multimap<size_t, std::weak_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mutex);
+  const size_t hash = std::hash<std::string>()(data);
+  auto [begin, end] = modules.equal_range(hash);
+  for (auto iter = begin; iter != end;) {
+    auto module = iter->second.lock();
+    if (!module) {
+      iter = modules.erase(iter);
+      continue;
+    }
+    if (module->kind_ == kind && module->data_ == data) {
+      VLOG(3) << "Share the loaded CUDAModule " << module.get();
+      return module;
+    }
+    ++iter;
+  }
+  auto module = std::make_shared<CUDAModule>(data, kind);
+  modules.emplace(hash, module);
+  return module;
+}
+
+CUmodule CUDAModule::LoadModule(int device_id) {
+  PADDLE_ENFORCE_LT(device_id,
+                    kCUDAMaxCards,
+                    ::common::errors::OutOfRange(
+                        "The device id %d exceeds the max number of cards %d.",
+                        device_id,
+                        kCUDAMaxCards));
+  CUmodule module = module_per_card_[device_id].load();
+  if (module) {
+    return module;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  module = module_per_card_[device_id].load();
+  if (module) {
+    return module;
+  }
+
+  // The module is loaded into the context of the device, which is made
+  // current for the loading.
+  int current_device_id;
+  CUDA_CALL(cudaGetDevice(&current_device_id));
+  if (current_device_id != device_id) {
+    CUDA_CALL(cudaSetDevice(device_id));
+  }
+  size_t free_before = 0, free_after = 0, total = 0;
+  CUDA_CALL(cudaMemGetInfo(&free_before, &total));
+
+  if (runtime::CanUseNvccCompiler()) {
+    CUDA_DRIVER_CALL(cuModuleLoad(&module, data_.c_str()));
+  } else {
     // Compilation with parameters
     const size_t jit_num_options = 5;
     std::vector<CUjit_option> jit_options(jit_num_options);
@@ -129,48 +206,36 @@ CUfunction CUDAModule::GetFunction(int device_id,
     jit_options[4] = CU_JIT_GENERATE_LINE_INFO;
     jit_opt_vals[4] = reinterpret_cast<void*>(value);
 
-    if (runtime::CanUseNvccCompiler()) {
-      CUDA_DRIVER_CALL(
-          cuModuleLoad(&module_per_card_[device_id], data_.c_str()));
-    } else {
-      CUDA_DRIVER_CALL(cuModuleLoadDataEx(&module_per_card_[device_id],
-                                          data_.c_str(),
-                                          jit_num_options,
-                                          jit_options.data(),
-                                          jit_opt_vals.data()));
-    }
+    CUDA_DRIVER_CALL(cuModuleLoadDataEx(&module,
+                                        data_.c_str(),
+                                        jit_num_options,
+                                        jit_options.data(),
+                                        jit_opt_vals.data()));
   }
 
-  CUfunction func;
-  CUDA_DRIVER_CALL(cuModuleGetFunction(
-      &func, module_per_card_[device_id], func_name.c_str()));
-  return func;
-}
-
-CUdeviceptr CUDAModule::GetGlobal(int device_id,
-                                  const std::string& name,
-                                  size_t nbytes) {
-  if (!module_per_card_[device_id]) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (runtime::CanUseNvccCompiler()) {
-      CUDA_DRIVER_CALL(
-          cuModuleLoad(&module_per_card_[device_id], data_.c_str()));
-    } else {
-      CUDA_DRIVER_CALL(
-          cuModuleLoadData(&module_per_card_[device_id], data_.c_str()));
-    }
+  CUDA_CALL(cudaMemGetInfo(&free_after, &total));
+  if (current_device_id != device_id) {
+    CUDA_CALL(cudaSetDevice(current_device_id));
   }
+  module_per_card_[device_id].store(module);
 
-  size_t _nbytes;
-  CUdeviceptr global;
-  CUDA_DRIVER_CALL(cuModuleGetGlobal(
-      &global, &_nbytes, module_per_card_[device_id], name.c_str()));
-  return global;
+  // Under CUDA_MODULE_LOADING=LAZY the kernels are loaded at their first
+  // launch, so the memory used by the loading is mostly deferred.
+  static std::array<std::atomic<int64_t>, kCUDAMaxCards> module_num{};
+  static std::array<std::atomic<int64_t>, kCUDAMaxCards> module_bytes{};
+  const int64_t used_bytes =
+      free_before > free_after ? free_before - free_after : 0;
+  VLOG(3) << "Load CUDAModule " << this << " onto device " << device_id
+          << " with " << data_.size() << " bytes of image and " << used_bytes
+          << " bytes of device memory, " << ++module_num[device_id]
+          << " modules use " << (module_bytes[device_id] += used_bytes)
+          << " bytes of device memory in total";
+  return module;
 }
 
 CUDAModule::~CUDAModule() {
   for (int i = 0; i < module_per_card_.size(); i++) {
-    auto* module = module_per_card_[i];
+    auto* module = module_per_card_[i].load();
     if (module) {
       CUDA_CALL(cudaSetDevice(i));
       CUDA_DRIVER_CALL(cuModuleUnload(module));
@@ -178,6 +243,27 @@ CUDAModule::~CUDAModule() {
   }
 }
 
+CUDAKernel::CUDAKernel(const std::shared_ptr<CUDAModule>& module,
+                       const std::string& func_name)
+    : module_(module), func_name_(func_name) {}
+
+CUfunction CUDAKernel::GetFunction() {
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  PADDLE_ENFORCE_LT(device_id,
+                    kCUDAMaxCards,
+                    ::common::errors::OutOfRange(
+                        "The device id %d exceeds the max number of cards %d.",
+                        device_id,
+                        kCUDAMaxCards));
+  CUfunction function = function_per_card_[device_id].load();
+  if (!function) {
+    function = module_->GetFunction(device_id, func_name_);
+    function_per_card_[device_id].store(function);
+  }
+  return function;
+}
+
 }  // namespace cuda
 }  // namespace runtime
 }  // namespace cinn
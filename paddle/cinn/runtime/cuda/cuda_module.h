@@ -18,6 +18,9 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <vector>
@@ -42,6 +45,11 @@ class CUDAModule {
 
   CUDAModule(const std::string& data, Kind kind);
 
+  //! Get the module of the data, which is shared by all the callers with the
+  //! identical PTX or CUBIN so that it is loaded only once on each device.
+  static std::shared_ptr<CUDAModule> GetOrCreate(const std::string& data,
+                                                 Kind kind);
+
   void LaunchKernel(int device_id,
                     const std::string& func_name,
                     dim3 gridDim,
@@ -62,12 +70,15 @@ class CUDAModule {
   ~CUDAModule();
 
  private:
+  //! Load the module onto the device at the first use there.
+  CUmodule LoadModule(int device_id);
+
   //! The input data.
   std::string data_;
   //! Kind of the input.
   Kind kind_;
   //! To make parallel, we prepare one module for each card.
-  std::vector<CUmodule> module_per_card_{kCUDAMaxCards, nullptr};
+  std::array<std::atomic<CUmodule>, kCUDAMaxCards> module_per_card_{};
   std::string cuda_source_;
   std::mutex mutex_;
 
@@ -76,6 +87,26 @@ class CUDAModule {
   int num_devices_{0};
 };
 
+/**
+ * A kernel of a CUDAModule, which is the handle passed to
+ * cinn_call_cuda_kernel by the host code. The module is loaded onto a device
+ * and the function is resolved at the first launch on that device, so the
+ * kernels never launched on a device cost it no context memory.
+ */
+class CUDAKernel {
+ public:
+  CUDAKernel(const std::shared_ptr<CUDAModule>& module,
+             const std::string& func_name);
+
+  //! Get the function on the current device.
+  CUfunction GetFunction();
+
+ private:
+  std::shared_ptr<CUDAModule> module_;
+  std::string func_name_;
+  std::array<std::atomic<CUfunction>, kCUDAMaxCards> function_per_card_{};
+};
+
 }  // namespace cuda
 }  // namespace runtime
 }  // namespace cinn
@@ -52,6 +52,35 @@ void saxpy(float a, float *x, float *y, float *out, size_t n)
   ASSERT_TRUE(func);
 }
 
+TEST(CUDAModule, shared) {
+  backends::nvrtc::Compiler compiler;
+
+  std::string source_code = R"ROC(
+extern "C" __global__
+void scale(float a, float *x, float *out, size_t n)
+{
+  size_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+  if (tid < n) {
+    out[tid] = a * x[tid];
+  }
+}
+)ROC";
+
+  auto ptx = compiler(source_code);
+  PADDLE_ENFORCE_NE(
+      ptx.empty(), true, ::common::errors::NotFound("ptx is empty!"));
+
+  // The identical PTX is loaded only once.
+  auto module = CUDAModule::GetOrCreate(ptx, CUDAModule::Kind::PTX);
+  auto other_module = CUDAModule::GetOrCreate(ptx, CUDAModule::Kind::PTX);
+  ASSERT_EQ(module, other_module);
+
+  CUDAKernel kernel(module, "scale");
+  auto func = kernel.GetFunction();
+  ASSERT_TRUE(func);
+  ASSERT_EQ(func, kernel.GetFunction());
+}
+
 TEST(CUDAModule, float16) {
   using cinn::common::float16;
   using runtime::cuda::util::Vector;
@@ -33,6 +33,7 @@
 #include "paddle/cinn/backends/extern_func_jit_register.h"
 #include "paddle/cinn/common/target.h"
 #include "paddle/cinn/runtime/cuda/cublas_util.h"
+#include "paddle/cinn/runtime/cuda/cuda_module.h"
 #include "paddle/cinn/runtime/flags.h"
 #include "paddle/cinn/utils/profiler.h"
 #include "paddle/cinn/utils/timer.h"
@@ -100,6 +101,7 @@ void cinn_call_cuda_kernel(void *kernel_fn,
           << ", shared_memory_bytes=" << shared_memory_bytes
           << ", stream=" << stream << ", kernel_fn=" << kernel_fn;
 
+  CUfunction function = static_cast<CUDAKernel *>(kernel_fn)->GetFunction();
   std::vector<void *> kernel_args;
   {
     cinn::utils::RecordEvent record_run("prepare_args",
@@ -119,7 +121,7 @@ void cinn_call_cuda_kernel(void *kernel_fn,
   {
     cinn::utils::RecordEvent record_run("cuLaunchKernel",
                                         cinn::utils::EventType::kInstruction);
-    CUDA_DRIVER_CALL(cuLaunchKernel(static_cast<CUfunction>(kernel_fn),
+    CUDA_DRIVER_CALL(cuLaunchKernel(function,
                                     grid_x,
                                     grid_y,
                                     grid_z,
@@ -95,7 +95,7 @@ void infer_shape_set_value(int row, int col, int64_t value, int64_t** v);
 /**
  * Call a CUDA compiled kernel.
  *
- * @param kernel_fn the compiled PTX kernel.
+ * @param kernel_fn the CUDAKernel handle of the compiled kernel.
  * @param args an array of cinn_pod_value_ts(consists of scalars and buffers).
  */
 void cinn_call_cuda_kernel(void* kernel_fn,
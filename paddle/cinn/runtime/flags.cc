@@ -94,6 +94,40 @@ PD_DEFINE_bool(cinn_bucket_compile,
                BoolFromEnv("FLAGS_cinn_bucket_compile", true),
                "Whether to enable bucket compile for dynamic shape.");
 
+PD_DEFINE_string(cinn_shape_bucket_profile,
+                 StringFromEnv("FLAGS_cinn_shape_bucket_profile", ""),
+                 "The file to record the observed shapes of the dynamic shape "
+                 "groups into, whose hot shape buckets are specialized into "
+                 "static kernels when the groups are compiled again. Empty "
+                 "means disabled.");
+
+PD_DEFINE_int32(cinn_shape_bucket_max_num,
+                Int32FromEnv("FLAGS_cinn_shape_bucket_max_num", 4),
+                "The maximum number of the shape buckets specialized for a "
+                "dynamic shape group.");
+
+PD_DEFINE_double(cinn_shape_bucket_min_ratio,
+                 DoubleFromEnv("FLAGS_cinn_shape_bucket_min_ratio", 0.05),
+                 "The minimum ratio of the calls of a dynamic shape group "
+                 "that a shape bucket takes to be specialized.");
+
+PD_DEFINE_string(cinn_group_tuning_database,
+                 StringFromEnv("FLAGS_cinn_group_tuning_database", ""),
+                 "The file of the tile configs tuned for the static shape "
+                 "groups, which are applied when the groups are compiled. "
+                 "Empty means disabled.");
+
+PD_DEFINE_bool(cinn_group_tuning,
+               BoolFromEnv("FLAGS_cinn_group_tuning", false),
+               "Whether to tune the tile configs of the static shape groups "
+               "missing in FLAGS_cinn_group_tuning_database by measuring "
+               "the candidate kernels on device.");
+
+PD_DEFINE_int32(cinn_group_tuning_repeat,
+                Int32FromEnv("FLAGS_cinn_group_tuning_repeat", 20),
+                "The number of the runs to measure a candidate kernel in the "
+                "group tuning.");
+
 PD_DEFINE_bool(group_schedule_tiling_first,
                BoolFromEnv("FLAGS_group_schedule_tiling_first", true),
                "Whether to enable new group scheduler tiling first strategy.");
@@ -173,6 +207,19 @@ PD_DEFINE_bool(
     "technique which contract fp multiplication and addition/subtraction into "
     "multiply-add operation. It may result in different fp precision.");
 
+PD_DEFINE_string(
+    cinn_compilation_cache_dir,
+    StringFromEnv("FLAGS_cinn_compilation_cache_dir", ""),
+    "The directory where the device code compiled by nvrtc is stored and "
+    "loaded, which saves the compilation of the later jobs. Disabled if it is "
+    "empty.");
+
+PD_DEFINE_string(
+    cinn_compilation_cache_readonly_dirs,
+    StringFromEnv("FLAGS_cinn_compilation_cache_readonly_dirs", ""),
+    "The comma separated directories where the compiled device code is only "
+    "loaded from, e.g. a cache directory shared by the other hosts.");
+
 // FLAGS for performance analysis and accuracy debug
 PD_DEFINE_bool(cinn_sync_run,
                BoolFromEnv("FLAGS_cinn_sync_run", false),
@@ -45,6 +45,19 @@ int SequenceDispatcher::Next() const {
   return idx;
 }
 
+IndexListDispatcher::IndexListDispatcher(std::vector<int> indices)
+    : indices_(std::move(indices)), pos_(0) {}
+
+int IndexListDispatcher::Next() const {
+  int pos = -1;
+  if (pos_ >= static_cast<int>(indices_.size()) ||
+      (pos = pos_.fetch_add(1)) >= static_cast<int>(indices_.size())) {
+    return -1;
+  }
+
+  return indices_[pos];
+}
+
 void parallel_run(const WorkerFuncType& fn,
                   JobDispatcher&& dispatcher,
                   int num_threads) {
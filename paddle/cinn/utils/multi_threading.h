@@ -15,6 +15,7 @@
 #pragma once
 #include <atomic>
 #include <functional>
+#include <vector>
 
 namespace cinn {
 namespace utils {
@@ -51,6 +52,21 @@ class SequenceDispatcher : public JobDispatcher {
   mutable std::atomic<int> index_;
 };
 
+// This dispatcher pops the indices in the given order, e.g. the costly jobs
+// first, so that the threads are less likely to wait for a long job picked up
+// at the end.
+class IndexListDispatcher : public JobDispatcher {
+ public:
+  explicit IndexListDispatcher(std::vector<int> indices);
+
+  int Next() const override;
+
+ private:
+  std::vector<int> indices_;
+  // position of the next index, using atomic to ensure thread-safe
+  mutable std::atomic<int> pos_;
+};
+
 /**
  * \brief A general function to run a batch of jobs in parallel
  * \param fn A instance of WorkerFuncType, which defines how to complete a
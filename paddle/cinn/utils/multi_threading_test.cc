@@ -34,6 +34,16 @@ TEST(JobDispatcher, SequenceDispatcher) {
   ASSERT_EQ(-1, dispatcher->Next());
 }
 
+TEST(JobDispatcher, IndexListDispatcher) {
+  std::unique_ptr<JobDispatcher> dispatcher =
+      std::make_unique<IndexListDispatcher>(std::vector<int>{2, 0, 1});
+  ASSERT_EQ(2, dispatcher->Next());
+  ASSERT_EQ(0, dispatcher->Next());
+  ASSERT_EQ(1, dispatcher->Next());
+  // check reach the end
+  ASSERT_EQ(-1, dispatcher->Next());
+}
+
 TEST(parallel_run, Basic) {
   std::vector<int> results(100, -1);
   auto worker_fn = [&results](int index) {
@@ -58,6 +68,19 @@ TEST(parallel_run, Basic) {
       ASSERT_EQ(results[i], -1);
     }
   }
+
+  // check every index in the list is processed exactly once
+  std::vector<int> counts(100, 0);
+  std::vector<int> indices(100);
+  for (int i = 0; i < 100; ++i) {
+    indices[i] = 99 - i;
+  }
+  parallel_run([&counts](int index) { ++counts[index]; },
+               IndexListDispatcher(indices),
+               4);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(counts[i], 1);
+  }
 }
 
 }  // namespace utils
@@ -102,6 +102,23 @@ PHI_DEFINE_EXPORTED_int32(
     0,
     "Setting the check and print level when FLAGS_check_nan_inf is set.");
 
+/**
+ * Operator related FLAG
+ * Name: FLAGS_check_nan_inf_async
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Used with FLAGS_check_nan_inf and FLAGS_check_nan_inf_level=0 in
+ * PirInterpreter. The gpu outputs of every instruction are reduced on device
+ * into a per-stream flag which is read back once per step without
+ * synchronizing, and the error names the first instruction in program order
+ * whose output holds NAN/INF. It is raised at the beginning of the next run.
+ */
+PHI_DEFINE_EXPORTED_bool(check_nan_inf_async,
+                         false,
+                         "Check NAN/INF of gpu outputs on device and read "
+                         "the result back once per step.");
+
 /**
  * Operator related FLAG
  * Name: FLAGS_check_nan_inf
@@ -374,6 +391,37 @@ PHI_DEFINE_EXPORTED_bool(
 PHI_DEFINE_EXPORTED_int32(communicator_send_queue_size,
                           20,
                           "queue size to recv gradient before send");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_geo_sparse_push_encoding
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_geo_sparse_push_encoding=1 sends the geo sparse deltas of
+ * the communicator as fp16.
+ * Note: 0 sends fp32, 1 sends fp16, 2 sends fp16 and drops the elements
+ *       below FLAGS_geo_sparse_push_threshold.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    geo_sparse_push_encoding,
+    0,
+    "encoding of geo sparse deltas: 0 fp32, 1 fp16, "
+    "2 fp16 with values below geo_sparse_push_threshold dropped");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_geo_sparse_push_threshold
+ * Since Version: 3.0.0
+ * Value Range: double, default=0
+ * Example: FLAGS_geo_sparse_push_threshold=1e-4 keeps the geo sparse delta
+ * elements smaller than 1e-4 in the local residual instead of sending them.
+ * Note: Only used when FLAGS_geo_sparse_push_encoding=2.
+ */
+PHI_DEFINE_EXPORTED_double(geo_sparse_push_threshold,
+                           0,
+                           "magnitude below which a geo sparse delta element "
+                           "is kept back in the local residual instead of "
+                           "being sent");
 #endif
 
 /**
@@ -432,6 +480,24 @@ PHI_DEFINE_EXPORTED_bool(
     "Fast eager deletion mode. If enabled, memory would release "
     "immediately without waiting GPU kernel ends.");
 
+/**
+ * Memory related FLAG
+ * Name: FLAGS_new_executor_gc_batch_size
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: Only works for the event garbage collector of the new executor
+ *       with eager deletion (FLAGS_eager_delete_tensor_gb=0). If 0, an event
+ *       is recorded for every freed allocation. Otherwise, the allocations
+ *       freed on a stream are released together behind one pooled event every
+ *       this many instructions, 1 means once per instruction.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    new_executor_gc_batch_size,
+    0,
+    "Number of instructions whose garbages on a stream share one event in "
+    "the event garbage collector of the new executor, 0 means no batching.");
+
 /**
  * Memory related FLAG
  * Name: FLAGS_memory_fraction_of_eager_deletion
@@ -458,6 +524,113 @@ PHI_DEFINE_EXPORTED_double(
     "only the FLAGS_memory_fraction_of_eager_deletion of the largest "
     "variables would be deleted.");
 
+/**
+ * Memory related FLAG
+ * Name: FLAGS_eager_activation_offload_min_size
+ * Since Version: 3.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_eager_activation_offload_min_size=1048576 offloads saved
+ *          activations of at least 1MB.
+ * Note: In dygraph mode, the gpu buffers of at least this many bytes saved
+ *       for backward by non-leaf tensors are copied to pinned host memory on
+ *       a copy stream and released, and copied back during backward.
+ *       0 disables the offload.
+ */
+PHI_DEFINE_EXPORTED_int64(
+    eager_activation_offload_min_size,
+    0,
+    "The minimum size in bytes of a saved activation offloaded to pinned host "
+    "memory in dygraph mode, 0 disables the offload.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_eager_activation_offload_prefetch_num
+ * Since Version: 3.0
+ * Value Range: int32, default=2
+ * Example:
+ * Note: The number of offloaded activations copied back ahead of the one the
+ *       backward pass currently needs, in reverse order of offloading.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    eager_activation_offload_prefetch_num,
+    2,
+    "The number of offloaded activations prefetched ahead during backward.");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_eager_backward_num_threads
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_backward_num_threads=4 runs the ready grad nodes of a
+ *          backward pass from 4 host threads.
+ * Note: In dygraph mode, the independent grad nodes of backward are run from
+ *       this many host threads, so the kernels of a branch are launched while
+ *       the others do their host side work. 0 or 1 runs them from the calling
+ *       thread. paddle.grad, create_graph and the force sequential nodes
+ *       always run from the calling thread.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    eager_backward_num_threads,
+    0,
+    "The number of host threads running the grad nodes of a dygraph backward "
+    "pass, 0 or 1 runs them from the calling thread.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_eager_grad_node_pool_size
+ * Since Version: 3.0
+ * Value Range: int32, default=4096
+ * Example: FLAGS_eager_grad_node_pool_size=0 gives the memory of every
+ *          destroyed grad node back to the heap.
+ * Note: In dygraph mode, the memory of the destroyed grad nodes is kept in
+ *       thread local free lists of size classes and reused by the grad nodes
+ *       of the next step. This is the most blocks a thread keeps in a size
+ *       class.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    eager_grad_node_pool_size,
+    4096,
+    "The most memory blocks of the destroyed grad nodes a thread keeps in a "
+    "size class for reuse, 0 disables the pool.");
+
+/**
+ * AMP related FLAG
+ * Name: FLAGS_eager_amp_cast_cache
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_eager_amp_cast_cache=true casts a parameter used by several
+ *          ops of a step only once.
+ * Note: In dygraph mode, the AMP casts of the persistable leaf tensors are
+ *       cached by the thread and reused until the tensor is modified inplace,
+ *       e.g. by the optimizer, or a backward pass runs. The casts of a step
+ *       share a cast grad node, so the backward casts them back only once.
+ *       Without a backward pass, e.g. in evaluation, the casts are kept until
+ *       the parameters are updated.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    eager_amp_cast_cache,
+    false,
+    "Whether to reuse the AMP casts of the parameters within a dygraph step.");
+
+/**
+ * Operator related FLAG
+ * Name: FLAGS_dygraph_prepared_op_cache_size
+ * Since Version: 3.0
+ * Value Range: int32, default=4096
+ * Example: FLAGS_dygraph_prepared_op_cache_size=0 chooses the kernel of every
+ *          traced legacy op from scratch.
+ * Note: In dygraph mode, the kernel chosen for a legacy op is cached by the
+ *       thread, keyed by the op type, the place, the attributes and the
+ *       types, dtypes, layouts, places and emptiness of the inputs and
+ *       outputs, and reused by the later ops of the same key. This is the
+ *       most kernel choices a thread caches before the cache is cleared.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    dygraph_prepared_op_cache_size,
+    4096,
+    "The most kernel choices of the dygraph legacy ops a thread caches, 0 "
+    "disables the cache.");
+
 /**
  * Allocator related FLAG
  * Name: FLAGS_allocator_strategy
@@ -483,6 +656,22 @@ PHI_DEFINE_EXPORTED_string(
     "on the same GPU card but may lead to more memory fragmentation "
     "(i.e., maximum batch size of models may be smaller).");
 
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_alloc_trace_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_alloc_trace_file=/tmp/alloc.trace
+ * Note: If not empty, every allocation and free made through the allocator
+ *       facade is appended to this file with its size, place, stream and
+ *       time, so the trace can be replayed offline against the allocator
+ *       strategies by paddle/phi/tools/allocator_replay.
+ */
+PHI_DEFINE_EXPORTED_string(alloc_trace_file,
+                           "",
+                           "The file the allocations and frees are traced "
+                           "to, empty to disable the trace.");
+
 /**
  * Memory related FLAG
  * Name: FLAGS_fraction_of_cpu_memory_to_use
@@ -682,6 +871,22 @@ PHI_DEFINE_EXPORTED_bool(
  */
 PHI_DEFINE_EXPORTED_bool(use_mkldnn, false, "Use MKLDNN to run");
 
+/**
+ * MKLDNN related FLAG
+ * Name: onednn_primitive_cache_capacity
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_onednn_primitive_cache_capacity=1024 shares the oneDNN
+ * primitive descriptors and primitives of the last 1024 keys across the
+ * threads.
+ * Note: 0 disables the shared cache, each thread then creates and caches
+ * its own primitives.
+ */
+PHI_DEFINE_EXPORTED_int32(onednn_primitive_cache_capacity,
+                          0,
+                          "The capacity of the oneDNN primitive cache shared "
+                          "by the threads, 0 to disable it.");
+
 /**
  * Debug related FLAG
  * Name: FLAGS_call_stack_level
@@ -879,6 +1084,22 @@ PHI_DEFINE_EXPORTED_bool(graph_load_in_parallel,
                          "It controls whether load graph node and edge with "
                          "multi threads parallelly.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_use_alias_sampler
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_graph_use_alias_sampler=true makes load_edges build an alias
+ * table for the neighbors of each node of a weighted graph, so the neighbors
+ * are sampled by their weights with O(1) draws.
+ * Note: By default the neighbors are sampled uniformly even when the edges
+ *       are weighted.
+ */
+PHI_DEFINE_EXPORTED_bool(graph_use_alias_sampler,
+                         false,
+                         "sample the neighbors of weighted graphs by their "
+                         "weights with alias tables");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_enable_neighbor_list_use_uva
@@ -1063,6 +1284,18 @@ PHI_DEFINE_EXPORTED_int64(
     cinn_compile_thread_num,
     -1,
     "It controls how many thread numbers applying compilation cache.");
+/*
+ * CINN related FLAG
+ * Name: FLAGS_cinn_compile_time_report
+ * Since Version: 3.0 Beta
+ * Value Range: bool, default=false
+ * Example: FLAGS_cinn_compile_time_report=true would log the time of the
+ * lowering, the backend compilation and the JIT of the fusion groups.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    cinn_compile_time_report,
+    false,
+    "It controls whether to log the compile time breakdown of CINN.");
 /*
  * CINN related FLAG
  * Name: FLAGS_enable_interpretercore_launch_cinn
@@ -1118,6 +1351,160 @@ PHI_DEFINE_EXPORTED_bool(new_executor_use_cuda_graph,
                          false,
                          "Use CUDA Graph in new executor");
 
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_counter_based_rng
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_counter_based_rng=true would let the random
+ * ops run by the PirInterpreter take the counter based seed of their
+ * position in the program and of a base the run reserves from the
+ * generator once, instead of advancing the offset of the generator under
+ * its lock for each op, so the random numbers do not depend on the order
+ * the ops run in, e.g. on multiple streams. The seed of the generator still
+ * selects the random numbers.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_counter_based_rng,
+                         false,
+                         "Give the random ops of the PirInterpreter the "
+                         "counter based seeds of their positions");
+
+/*
+ * XPU related FLAG
+ * Name: FLAGS_new_executor_xpu_multi_stream
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_xpu_multi_stream=true would let the
+ * PirInterpreter run the XPU programs on multiple streams as on GPU, i.e. the
+ * memcpy_h2d and memcpy_d2h ops, such as those of feed and fetch, on the
+ * H2D and D2H streams and the ops with execution_stream on their own
+ * streams, synchronized by the XPU events. Each stream has its stream safe
+ * allocator.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_xpu_multi_stream,
+                         false,
+                         "Run the XPU programs on multiple streams in the "
+                         "PirInterpreter");
+
+/*
+ * CUDA Graph related FLAG
+ * Name: FLAGS_pir_interpreter_auto_cuda_graph
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_pir_interpreter_auto_cuda_graph=true would let PirInterpreter
+ * capture the instruction list of a block into a CUDA Graph per input shapes
+ * after warm-up and replay it for later runs in trace mode. Blocks with
+ * control flow, host or synchronous kernels, or multiple streams are run as
+ * usual. Note that the fetched tensors alias the outputs of the graph and are
+ * overwritten by the next replay.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_interpreter_auto_cuda_graph,
+                         false,
+                         "Capture and replay CUDA Graph in PirInterpreter");
+
+/*
+ * CUDA Graph related FLAG
+ * Name: FLAGS_pir_interpreter_cuda_graph_warmup_steps
+ * Since Version: 3.0.0
+ * Value Range: int32, default=2
+ * Example: FLAGS_pir_interpreter_cuda_graph_warmup_steps=2 would run the
+ * first 2 iterations of every input shapes without CUDA Graph, so that lazy
+ * initialization and autotune happen before capturing.
+ */
+PHI_DEFINE_EXPORTED_int32(pir_interpreter_cuda_graph_warmup_steps,
+                          2,
+                          "Warm-up steps before capturing CUDA Graph in "
+                          "PirInterpreter");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_pir_interpreter_plan_cache_dir
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_pir_interpreter_plan_cache_dir="/tmp/plans" would save the
+ * dependency graph and the events PirInterpreter builds for a program into
+ * the directory, keyed by a hash of its instructions, and load them in
+ * later processes whose instructions match exactly instead of recomputing.
+ */
+PHI_DEFINE_EXPORTED_string(pir_interpreter_plan_cache_dir,
+                           "",
+                           "Directory of persisted PirInterpreter plans");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_pir_interpreter_incremental_plan
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_pir_interpreter_incremental_plan=true would let
+ * PirInterpreter keep the dependencies of the recently built instruction
+ * lists in memory, and only build the ones of the instructions after the
+ * longest prefix it shares with them, e.g. for a program with a new fetch.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_interpreter_incremental_plan,
+                         false,
+                         "Reuse the dependencies of the instructions shared "
+                         "with a recently built PirInterpreter");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_pir_interpreter_static_memory_plan
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_pir_interpreter_static_memory_plan=true would let
+ * PirInterpreter in trace mode place the static shape intermediate tensors of
+ * phi kernels into one arena at offsets planned from their lifetimes, so that
+ * the later runs allocate none of them. Blocks with control flow or multiple
+ * streams are run as usual.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_interpreter_static_memory_plan,
+                         false,
+                         "Plan the intermediate tensors of PirInterpreter "
+                         "into one arena");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_pir_interpreter_reuse_infer_meta
+ * Since Version: 3.0.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_pir_interpreter_reuse_infer_meta=false would let the phi
+ * kernel instructions of PirInterpreter run InferMeta in every run, instead
+ * of skipping it while the metas of their inputs and outputs are the same as
+ * the last time it ran.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_interpreter_reuse_infer_meta,
+                         true,
+                         "Skip the InferMeta of the instructions whose "
+                         "input metas are unchanged");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_pir_interpreter_cost_sample_interval
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_pir_interpreter_cost_sample_interval=100 would let every
+ * PirInterpreter sample the host and device cost of its instructions in one
+ * of every 100 runs, into histograms per op which can be read by
+ * paddle.base.core.get_instruction_cost_stats or dumped in the Prometheus
+ * text format. 0 disables the sampling.
+ */
+PHI_DEFINE_EXPORTED_int32(pir_interpreter_cost_sample_interval,
+                          0,
+                          "Sample the instruction costs of PirInterpreter "
+                          "in one of every N runs");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_numa_aware
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_numa_aware=true would map the steal partitions
+ * of the host task queue to NUMA nodes and pin its threads to the cpus of
+ * their node.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_numa_aware,
+                         false,
+                         "Make the host workqueue of new executor NUMA aware");
+
 /*
  * CUDA Graph / Allocator related FLAG
  * Name: FLAGS_use_cuda_malloc_async_allocator
@@ -1130,6 +1517,22 @@ PHI_DEFINE_EXPORTED_bool(use_cuda_malloc_async_allocator,
                          false,
                          "Enable CUDAMallocAsyncAllocator");
 
+/*
+ * Allocator related FLAG
+ * Name: FLAGS_stream_safe_cuda_allocator_ordered_reuse
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_stream_safe_cuda_allocator_ordered_reuse=true would let
+ * StreamSafeCUDAAllocator hand a freed allocation that is still used by other
+ * streams to the next allocation of a similar size on its stream, by making
+ * the stream wait for the events of the other streams instead of polling them
+ * on host. It trades some overlap between streams for lower peak memory.
+ */
+PHI_DEFINE_EXPORTED_bool(stream_safe_cuda_allocator_ordered_reuse,
+                         false,
+                         "Reuse allocations freed before other streams "
+                         "finish using them by stream waits");
+
 /*
  * CUDAMallocAsyncAllocator related FLAG
  * Name: FLAGS_cuda_malloc_async_pool_memory_throttle_ratio
@@ -1186,12 +1589,25 @@ PD_DEFINE_int32(record_pool_max_size,
 PD_DEFINE_int32(slotpool_thread_num,
                 1,
                 "SlotRecordDataset slot pool thread num");
+PD_DEFINE_bool(slotpool_numa_local,  // NOLINT
+               false,
+               "keep a slot record pool per NUMA node, and spread the threads "
+               "loading a dataset over the nodes, default false");
 PD_DEFINE_bool(enable_slotpool_wait_release,  // NOLINT
                false,
                "enable slotrecord object wait release, default false");
 PD_DEFINE_bool(enable_slotrecord_reset_shrink,  // NOLINT
                false,
                "enable slotrecord object reset shrink memory, default false");
+PD_DEFINE_bool(enable_slotrecord_compress,  // NOLINT
+               false,
+               "keep the feasigns of the slotrecord objects in memory varint "
+               "coded, and decode them while building batches, "
+               "default false");
+PD_DEFINE_bool(enable_slotrecord_float_fp16,  // NOLINT
+               false,
+               "keep the float feasigns of the compressed slotrecord objects "
+               "as fp16, default false");
 PD_DEFINE_bool(enable_ins_parser_file,  // NOLINT
                false,
                "enable parser ins file, default false");
@@ -1219,6 +1635,11 @@ PHI_DEFINE_EXPORTED_uint64(
     gpugraph_merge_grads_segment_size,
     128,
     "segment size with segment gradient merge, default 128");
+PHI_DEFINE_EXPORTED_bool(
+    gpugraph_enable_fused_merge_update,
+    false,
+    "merge the gradients of a key and update its value in one kernel while "
+    "push sparse with enable_sparse_inner_gather, default false");
 PHI_DEFINE_EXPORTED_uint64(gpugraph_slot_feasign_max_num,
                            5,
                            "max feasign number in one slot, default 5");
@@ -1226,6 +1647,17 @@ PHI_DEFINE_EXPORTED_int32(
     gpugraph_dedup_pull_push_mode,
     0,
     "enable dedup keys while pull push sparse, default 0");
+PHI_DEFINE_EXPORTED_double(
+    gpups_hbm_value_ratio,
+    1.0,
+    "fraction of a device's pass feature values kept in HBM, ordered by "
+    "show; the rest live in pinned host memory mapped into the device, "
+    "default 1.0 keeps all values in HBM");
+PHI_DEFINE_EXPORTED_bool(
+    gpups_pipeline_prepare_task,
+    false,
+    "run MergePull and the per device partition of the next pass on the "
+    "build thread while the current pass trains, default false");
 PHI_DEFINE_EXPORTED_bool(gpugraph_load_node_list_into_hbm,
                          true,
                          "enable load_node_list_into_hbm, default true");
@@ -1285,6 +1717,112 @@ PHI_DEFINE_EXPORTED_bool(benchmark_nccl,
                          "enable nccl debug mode to synchronize nccl comm");
 #endif
 
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: nccl_coalesce_flatten_size
+ * Since Version: 3.0.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_nccl_coalesce_flatten_size=1048576 copies the tensors of at
+ * most 1MB of a coalesced all_reduce or broadcast into one buffer per data
+ * type, which is communicated by a single NCCL call.
+ * Note: 0 disables the flattening, every tensor gets its own NCCL call in the
+ * group.
+ */
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+PHI_DEFINE_EXPORTED_int64(
+    nccl_coalesce_flatten_size,
+    0,
+    "The max bytes of a tensor flattened into a shared buffer by the "
+    "coalesced collectives of ProcessGroupNCCL, 0 to disable.");
+#endif
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_allreduce_algorithm
+ * Since Version: 3.0.0
+ * Value Range: string, {default, auto, ring, halving_doubling, tree},
+ * default=auto
+ * Example: FLAGS_gloo_allreduce_algorithm=ring runs every all_reduce of gloo
+ * with the ring algorithm.
+ * Note: default keeps the algorithm of gloo. auto uses the tree below
+ * FLAGS_gloo_allreduce_tree_threshold bytes, halving-doubling below
+ * FLAGS_gloo_allreduce_ring_threshold bytes on a power of two ranks, and ring
+ * otherwise. halving-doubling falls back to ring on other numbers of ranks.
+ */
+PHI_DEFINE_EXPORTED_string(gloo_allreduce_algorithm,
+                           "auto",
+                           "The all_reduce algorithm of gloo, one of default, "
+                           "auto, ring, halving_doubling and tree.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_allreduce_tree_threshold
+ * Since Version: 3.0.0
+ * Value Range: int64, default=65536
+ * Note: The messages of fewer bytes are reduced by the tree when
+ * FLAGS_gloo_allreduce_algorithm is auto, where the latency dominates.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_allreduce_tree_threshold,
+                          64 << 10,
+                          "The bytes below which the auto all_reduce of gloo "
+                          "uses the tree algorithm.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_allreduce_ring_threshold
+ * Since Version: 3.0.0
+ * Value Range: int64, default=4194304
+ * Note: The messages of at least so many bytes are reduced by the ring when
+ * FLAGS_gloo_allreduce_algorithm is auto, where the bandwidth dominates.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_allreduce_ring_threshold,
+                          4 << 20,
+                          "The bytes from which the auto all_reduce of gloo "
+                          "uses the ring algorithm.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_allreduce_num_threads
+ * Since Version: 3.0.0
+ * Value Range: int32, [1, 64], default=1
+ * Example: FLAGS_gloo_allreduce_num_threads=4 splits a large all_reduce into
+ * 4 chunks reduced by 4 threads at the same time.
+ * Note: A chunk has at least 1MB, and the default algorithm of gloo is never
+ * split.
+ */
+PHI_DEFINE_EXPORTED_int32(gloo_allreduce_num_threads,
+                          1,
+                          "The number of threads a large all_reduce of gloo "
+                          "is split across.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_allreduce_bf16_compress
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Note: Sends the float32 tensors of a sum all_reduce of gloo as bfloat16,
+ * halving the bytes on the wire. The partial sums are rounded to bfloat16
+ * too, so the result loses precision as the number of ranks grows.
+ */
+PHI_DEFINE_EXPORTED_bool(gloo_allreduce_bf16_compress,
+                         false,
+                         "Whether to compress the float32 sum all_reduce of "
+                         "gloo to bfloat16 on the wire.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_allreduce_bucket_size
+ * Since Version: 3.0.0
+ * Value Range: int64, default=33554432
+ * Note: The tensors of an all_reduce of a list are copied into buckets of at
+ * most so many bytes per data type, each reduced by a single gloo call.
+ * A larger tensor gets its own call.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_allreduce_bucket_size,
+                          32 << 20,
+                          "The max bytes of a bucket of the all_reduce of a "
+                          "list of tensors of ProcessGroupGloo.");
+
 PHI_DEFINE_EXPORTED_bool(
     benchmark,
     false,
@@ -1302,6 +1840,20 @@ PHI_DEFINE_EXPORTED_bool(
  */
 PHI_DEFINE_EXPORTED_bool(use_autotune, false, "Whether enable autotune.");
 
+/**
+ * Autotune related FLAG
+ * Name: FLAGS_autotune_cache_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_autotune_cache_file=/path/to/autotune.cache
+ * Note: If not empty, the tuned algorithms are loaded from this file when
+ * autotune starts, and written back to it when the tuning range finishes,
+ * so that they can be reused across process restarts.
+ */
+PHI_DEFINE_EXPORTED_string(autotune_cache_file,
+                           "",
+                           "The file to load and save the autotune cache.");
+
 /**
  * CINN training related FLAG
  * Name: FLAGS_disable_dyshape_in_train
@@ -1431,6 +1983,77 @@ PHI_DEFINE_EXPORTED_bool(trt_ibuilder_cache,
                          false,
                          "Add a persistent ibuilder.");
 
+/**
+ * TensorRT related FLAG
+ * Name: trt_context_memory_pool_size
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_trt_context_memory_pool_size=2
+ * Note: If > 0, the execution contexts of the TensorRT engines sharing the
+ * context memory lease it from a process wide pool of at most so many blocks
+ * per device while they run, instead of holding a block per predictor. A run
+ * waits for a free block if all the blocks are leased.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    trt_context_memory_pool_size,
+    0,
+    "The max number of the blocks of the TensorRT context memory leased to "
+    "the running execution contexts per device, 0 to hold a block per "
+    "predictor.");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_device_worker_cache_runtime_context
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_device_worker_cache_runtime_context=true lets the ops of the
+ *          Hogwild and Downpour workers resolve their variables once.
+ * Note: If True, the kernel ops of the HogwildWorker and the workers derived
+ *       from it keep the variables of their inputs and outputs resolved in
+ *       the thread scope in a cached RuntimeContext, instead of looking them
+ *       up by name through the scopes for every batch. The cache is rebuilt
+ *       if an op runs in another scope or transforms its inputs into a
+ *       transfer scope.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    device_worker_cache_runtime_context,
+    false,
+    "Whether the ops of the device workers cache their RuntimeContext.");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_downpour_max_push_staleness
+ * Since Version: 3.0
+ * Value Range: int32, default=-1
+ * Example: FLAGS_downpour_max_push_staleness=2 lets a DownpourWorker train a
+ *          batch while the gradients of the 2 batches before it are pushed.
+ * Note: The pushes of a batch are waited for before the batch that many
+ *       batches after it is trained, and all of them at the end of the pass.
+ *       A negative value leaves the asynchronous pushes unbounded.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    downpour_max_push_staleness,
+    -1,
+    "The max number of batches whose gradient pushes are in flight in a "
+    "DownpourWorker, negative for unbounded.");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_pull_dense_delta_copy
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_pull_dense_delta_copy=true lets the PullDenseWorker copy
+ *          only the changed blocks of the pulled dense params to the devices.
+ * Note: The pulled values are compared in blocks of 16384 floats with the
+ *       ones last copied to the thread scopes of the devices, so the
+ *       device copies must not be modified by the workers.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    pull_dense_delta_copy,
+    false,
+    "Whether the PullDenseWorker only copies the changed blocks of the "
+    "pulled dense params to the devices.");
+
 /**
  * mmap_allocator related FLAG
  * Name: use_shm_cache
@@ -1444,6 +2067,23 @@ PHI_DEFINE_EXPORTED_bool(use_shm_cache,
                          false,
                          "Use shm cache in mmap_allocator.");
 
+/**
+ * mmap_allocator related FLAG
+ * Name: pin_shm_cache
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_use_shm_cache=1 FLAGS_pin_shm_cache=1 copies the batches of
+ *          the DataLoader workers to the GPU straight from shared memory.
+ * Note: Only works with use_shm_cache. If True, the main process page-locks
+ * the cached shm files it reads the batches of the workers from, once per
+ * file, so the buffered reader copies them to the GPU asynchronously
+ * without staging them in pinned memory, and hands them out as pinned
+ * tensors without a copy.
+ */
+PHI_DEFINE_EXPORTED_bool(pin_shm_cache,
+                         false,
+                         "Page-lock the shm cache read by the main process.");
+
 /**
  * mmap_allocator related FLAG
  * Name: dataloader_use_file_descriptor
@@ -1457,6 +2097,20 @@ PHI_DEFINE_EXPORTED_bool(dataloader_use_file_descriptor,
                          false,
                          "Use file descriptor in mmap_allocator.");
 
+/**
+ * load_combine related FLAG
+ * Name: FLAGS_load_combine_use_mmap
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_load_combine_use_mmap=true
+ * Note: If True, load_combine memory-maps the combined params file instead of
+ * reading it through std::ifstream, and GPU parameters are copied out of the
+ * mapping through pinned staging buffers.
+ */
+PHI_DEFINE_EXPORTED_bool(load_combine_use_mmap,
+                         false,
+                         "Memory-map the params file in load_combine.");
+
 /**
  * Tensor operants related FLAG
  * Name: tensor_operants_mode
@@ -1557,6 +2211,37 @@ PHI_DEFINE_EXPORTED_string(
     ir_inplace_kernel_blacklist,
     "",
     "It controls the ir inplace kernel subset do not use.");
+
+/**
+ * Batch the constant folding of PIR
+ * Name: pir_constant_folding_batch_size
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_pir_constant_folding_batch_size=1024 would let
+ * constant_folding_pass fold up to 1024 independent ops in one program.
+ * Note: If 0, the ops are folded one by one, each with its own program and
+ * interpreter.
+ */
+PHI_DEFINE_EXPORTED_int32(pir_constant_folding_batch_size,
+                          0,
+                          "The max number of ops folded together by "
+                          "constant_folding_pass, 0 to fold them one by one.");
+
+/**
+ * Fuse the pattern rewrite passes of PIR
+ * Name: pir_fuse_pattern_rewrite_passes
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_pir_fuse_pattern_rewrite_passes=true would let the inference
+ * pass pipeline run the consecutive drr fuse passes in one traversal of the
+ * program, instead of one traversal per pass.
+ * Note: The patterns of a root op are tried in the order of their benefits,
+ * which may differ from running the passes one after another.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_fuse_pattern_rewrite_passes,
+                         false,
+                         "Whether to run the consecutive pattern rewrite "
+                         "passes in one traversal.");
 /**
  * Specify the directory of saving PIR subgraph from @to_static
  * Name: pir_subgraph_saving_dir
@@ -1585,6 +2270,21 @@ PHI_DEFINE_EXPORTED_int64(host_trace_level,
                           "RecordEvent will works "
                           "if host_trace_level >= level.");
 
+/**
+ * Profiler related FLAG
+ * Name: host_event_recorder_max_blocks
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_host_event_recorder_max_blocks=8 keeps at most 8 blocks of
+ * 16MB of host events for each thread and event type.
+ * Note: Once the blocks are full, the oldest one is overwritten, so a
+ * profiler kept running only reports the latest events. 0 means unbounded.
+ */
+PHI_DEFINE_EXPORTED_int32(host_event_recorder_max_blocks,
+                          0,
+                          "The max number of the event blocks of a thread "
+                          "kept by the host event recorder, 0 is unbounded.");
+
 PHI_DEFINE_EXPORTED_int32(
     multiple_of_cupti_buffer_size,
     1,
@@ -1649,11 +2349,108 @@ PHI_DEFINE_EXPORTED_bool(enable_async_trace,
 
 PHI_DEFINE_EXPORTED_int32(async_trace_count, 5, "collective async trace count");
 
+/**
+ * Distributed related FLAG
+ * Name: comm_trace_timing_interval
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_comm_trace_timing_interval=100 measures the device time of
+ * every 100th collective traced by FLAGS_enable_async_trace, the latency
+ * histograms are available by ProcessGroupNCCL.comm_latency_histograms.
+ * Note: 0 disables the timing, the events of the other collectives are
+ * recorded without timing.
+ */
+PHI_DEFINE_EXPORTED_int32(comm_trace_timing_interval,
+                          0,
+                          "The interval of the traced collectives whose "
+                          "device time is measured, 0 to disable.");
+
+/**
+ * Distributed related FLAG
+ * Name: tcp_store_relay_port
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_tcp_store_relay_port=6171 makes the first rank of each node
+ * run a relay of the global TCPStore on port 6171, the other ranks of the node
+ * talk to the master through it.
+ * Note: 0 connects every rank to the master directly. The relay merges the
+ * waits, adds and gets of the ranks of a node, which shortens the rendezvous
+ * of jobs with thousands of ranks.
+ */
+PHI_DEFINE_EXPORTED_int32(tcp_store_relay_port,
+                          0,
+                          "The port of the per node relay of the global "
+                          "TCPStore, 0 to disable.");
+
+/**
+ * Distributed related FLAG
+ * Name: fleet_executor_shm_transport
+ * Since Version: 3.0.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_fleet_executor_shm_transport=false sends all the messages of
+ * the fleet executor between ranks through brpc.
+ * Note: The ranks on the same host are told by the ip of their addresses, the
+ * messages between them go through a ring buffer in shared memory.
+ */
+PHI_DEFINE_EXPORTED_bool(fleet_executor_shm_transport,
+                         true,
+                         "Whether the message bus of the fleet executor talks "
+                         "to the ranks on the same host through shared "
+                         "memory.");
+
+/**
+ * Distributed related FLAG
+ * Name: pipeline_utilization_report_interval
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_pipeline_utilization_report_interval=100 logs the share of
+ * the time each pipeline stage spends in forward, backward, weight gradient,
+ * update and waiting on send/recv every 100 batches.
+ * Note: The device is synchronized after each op to time it, which slows the
+ * training down, 0 to disable.
+ */
+PHI_DEFINE_EXPORTED_int32(pipeline_utilization_report_interval,
+                          0,
+                          "The number of batches between the utilization "
+                          "reports of the pipeline stages, 0 to disable.");
+
 PHI_DEFINE_EXPORTED_bool(
     use_auto_growth_pinned_allocator,
     false,
     "Whether to use the auto_growth CUDA pinned allocator.");
 
+/**
+ * Allocator related FLAG
+ * Name: use_size_class_pinned_allocator
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_use_size_class_pinned_allocator=true
+ * Note: Round the CUDA pinned allocations up to power of two size classes and
+ *       cache the freed blocks per class and per thread, so that the data
+ *       loading threads rarely call cudaHostAlloc/cudaFreeHost, which
+ *       serialize the device. Takes precedence over
+ *       FLAGS_use_auto_growth_pinned_allocator.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    use_size_class_pinned_allocator,
+    false,
+    "Whether to use the size class caching CUDA pinned allocator.");
+
+/**
+ * Allocator related FLAG
+ * Name: size_class_pinned_allocator_cache_limit_mb
+ * Since Version: 3.0.0
+ * Value Range: uint64, default=1024
+ * Example: FLAGS_size_class_pinned_allocator_cache_limit_mb=512
+ * Note: The most pinned memory in MB the size class pinned allocator keeps
+ *       cached. Freed blocks beyond it and larger requests go to
+ *       cudaFreeHost/cudaHostAlloc directly.
+ */
+PHI_DEFINE_EXPORTED_uint64(
+    size_class_pinned_allocator_cache_limit_mb,
+    1024,
+    "The cache limit in MB of the size class CUDA pinned allocator.");
+
 PHI_DEFINE_EXPORTED_bool(
     sync_after_alloc,
     false,
@@ -1805,6 +2602,56 @@ PHI_DEFINE_EXPORTED_string(cublaslt_device_best_config,
                            "Whether to load search configs file generated by "
                            "offline in cublaslt gemm.");
 
+/**
+ * The cublaslt algo cache file written by the global search and replayed at
+ * runtime
+ * Name: cublaslt_algo_cache_file
+ * Since Version: 3.0.0
+ * Value Range: string, default="", a file path
+ * Example: FLAGS_cublaslt_algo_cache_file=/path/to/algo_cache
+ * Note: If set, the algos found by the global search of cublaslt gemm
+ *       (FLAGS_enable_blaslt_global_search) are written to this file in
+ *       batches and at exit, and the algos in this file are used by cublaslt
+ *       gemm without any search even if the global search is disabled. The
+ *       file is only used on the cuda version and the device architecture it
+ *       was tuned on. If empty, ./cublaslt_algo_caches_from_paddle is used by
+ *       the global search only.
+ */
+PHI_DEFINE_EXPORTED_string(cublaslt_algo_cache_file,
+                           "",
+                           "The cublaslt algo cache file written by the global "
+                           "search and replayed by cublaslt gemm.");
+
+/**
+ * The max number of cached cuFFT plans of a device
+ * Name: cufft_plan_cache_max_size
+ * Since Version: 3.0.0
+ * Value Range: int64, default=-1
+ * Example: FLAGS_cufft_plan_cache_max_size=256
+ * Note: The least recently used plans are destroyed once the cache is full.
+ *       -1 means the default size, 4096 (1023 before CUDA 10).
+ */
+PHI_DEFINE_EXPORTED_int64(cufft_plan_cache_max_size,
+                          -1,
+                          "The max number of cached cuFFT plans of a device, "
+                          "-1 means the default size.");
+
+/**
+ * Whether the cuFFT plans are reused across batch sizes
+ * Name: cufft_reuse_batched_plan
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_cufft_reuse_batched_plan=true
+ * Note: If True, a batch of fft is split into chunks whose sizes are powers
+ *       of two, so a signal size needs at most log2(max batch) + 1 plans for
+ *       all the batch sizes, at the cost of a launch per chunk. It helps the
+ *       models whose batch sizes vary a lot.
+ */
+PHI_DEFINE_EXPORTED_bool(cufft_reuse_batched_plan,
+                         false,
+                         "Whether to split the fft batch into chunks of powers "
+                         "of two to reuse the cuFFT plans.");
+
 /**
  * Wether to use xqa optim in block_multihead_attention kernel (GQA)
  * Name: use_xqa_optim
@@ -1818,6 +2665,57 @@ PHI_DEFINE_EXPORTED_bool(
     false,
     "Enable xqa optim in block_multihead_attention kernel (GQA).");
 
+/**
+ * Whether masked_multihead_attention splits the cached sequence of a head
+ * across thread blocks (flash decoding)
+ * Name: mmha_split_seq
+ * Since Version: 3.0.0
+ * Value Range: int32, default=-1
+ * Example:
+ * Note: -1 splits it when the batch and the heads can not fill the device or
+ * the sequence is too long for a block, 0 never splits it, 1 always splits it.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    mmha_split_seq,
+    -1,
+    "Whether masked_multihead_attention splits the cached sequence across "
+    "thread blocks, -1 for choosing it by the shapes, 0 for no, 1 for yes.");
+
+/**
+ * Whether the topk of GPU uses the multi-pass radix select, which splits a row
+ * across thread blocks
+ * Name: topk_radix_select
+ * Since Version: 3.0.0
+ * Value Range: int32, default=-1
+ * Example:
+ * Note: -1 uses it for the long rows with a large k or few rows, 0 never uses
+ * it, 1 always uses it for the last axis.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    topk_radix_select,
+    -1,
+    "Whether topk uses the multi-pass radix select on GPU, -1 for choosing it "
+    "by the shapes, 0 for no, 1 for yes.");
+
+/**
+ * Whether the GPU reduce finishes the reduction split across thread blocks in
+ * a single launch
+ * Name: reduce_single_launch
+ * Since Version: 3.0.0
+ * Value Range: int32, default=-1
+ * Example: FLAGS_reduce_single_launch=1
+ * Note: If a reduction is split across thread blocks, the last block of each
+ * column done, found by an atomic counter, reduces the partial results instead
+ * of a second kernel. -1 uses it when there are few outputs, 0 never uses it,
+ * 1 always uses it. With FLAGS_use_autotune, the faster one is cached.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    reduce_single_launch,
+    -1,
+    "Whether the GPU reduce reduces the partial results of the thread blocks "
+    "in the last block done instead of a second kernel, -1 for choosing it by "
+    "the shapes, 0 for no, 1 for yes.");
+
 PHI_DEFINE_EXPORTED_string(
     mkl_dir,  // NOLINT
     "",
@@ -1892,3 +2790,146 @@ PHI_DEFINE_EXPORTED_bool(
     pinned_memory_as_cpu_backend,
     false,
     "Whether use CPU backend, when tensor is pinned_memory.");
+
+/**
+ * IO related FLAG
+ * Name: FLAGS_hdfs_native_read
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_hdfs_native_read=true reads hdfs: files through libhdfs in
+ * process instead of a `hadoop fs -cat` pipe
+ * Note: falls back to the pipe when libhdfs cannot be loaded or connected,
+ * and for .gz files, converters or a customized download command.
+ */
+PHI_DEFINE_EXPORTED_bool(hdfs_native_read,
+                         false,
+                         "read hdfs files in process through libhdfs");
+PHI_DEFINE_EXPORTED_string(hdfs_native_lib,
+                           "libhdfs.so",
+                           "libhdfs shared library used by hdfs_native_read");
+PHI_DEFINE_EXPORTED_int32(hdfs_native_read_threads,
+                          4,
+                          "number of chunks read ahead in parallel by "
+                          "hdfs_native_read");
+
+/**
+ * Dataset related FLAG
+ * Name: FLAGS_data_feed_lock_free_queue
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_data_feed_lock_free_queue=true keeps the instances the
+ * reader thread of a QueueDataset feed parses in a lock free ring
+ * Note: The ring has the queue size of the feed rounded up to a power of 2.
+ */
+PHI_DEFINE_EXPORTED_bool(data_feed_lock_free_queue,
+                         false,
+                         "keep the queue of the data feeds in a lock free "
+                         "ring");
+
+/**
+ * Dataset related FLAG
+ * Name: FLAGS_global_shuffle_chunk_mb
+ * Since Version: 3.0.0
+ * Value Range: int32, default=8
+ * Example: FLAGS_global_shuffle_chunk_mb=16 sends the records a trainer
+ * receives in global shuffle as messages of about 16MB
+ * Note: FLAGS_global_shuffle_max_inflight_mb bounds the bytes of shuffle
+ * messages not yet acked, shared by all the shuffle threads.
+ */
+PHI_DEFINE_EXPORTED_int32(global_shuffle_chunk_mb,
+                          8,
+                          "message size in MB of dataset global shuffle");
+PHI_DEFINE_EXPORTED_int32(global_shuffle_max_inflight_mb,
+                          256,
+                          "max MB of global shuffle messages in flight");
+
+/**
+ * Dataset related FLAG
+ * Name: FLAGS_queue_dataset_shuffle_window
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_queue_dataset_shuffle_window=100000 makes each QueueDataset
+ * feed draw its instances at random from a window of the next 100000 read
+ * Note: The instances are streamed, so the passes need not fit in memory,
+ * and 0 or 1 keeps the file order.
+ */
+PHI_DEFINE_EXPORTED_int32(queue_dataset_shuffle_window,
+                          0,
+                          "the number of instances a QueueDataset feed "
+                          "shuffles within");
+
+/**
+ * Dataset related FLAG
+ * Name: FLAGS_queue_dataset_prefetch_file
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_queue_dataset_prefetch_file=true makes the reader thread of
+ * a QueueDataset feed open its next file, starting its pipe command, before
+ * parsing the current one
+ */
+PHI_DEFINE_EXPORTED_bool(queue_dataset_prefetch_file,
+                         false,
+                         "open the next file of a QueueDataset feed while "
+                         "parsing the current one");
+
+/**
+ * Data transform related FLAG
+ * Name: FLAGS_transformed_data_cache_size
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_transformed_data_cache_size=256 keeps the last 256 inputs
+ * the APIs transformed to the layout, dtype or place of their kernels, with
+ * the results, so an input transformed in every step, e.g. a parameter, is
+ * transformed once while it is not modified.
+ * Note: The inputs shall be modified only by the inplace APIs, which bump
+ * their versions, and 0 disables the cache.
+ */
+PHI_DEFINE_EXPORTED_int32(transformed_data_cache_size,
+                          0,
+                          "the number of the transformed inputs of the APIs "
+                          "cached with their results");
+
+/**
+ * Eager API related FLAG
+ * Name: FLAGS_eager_infer_meta_cache
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_eager_infer_meta_cache=true makes each API reuse the output
+ * metas of its last call if the metas of the inputs and the attributes are
+ * the same, skipping the InferMeta in the stable-shape training loops.
+ * Note: The APIs with inplace outputs, vector inputs or outputs, and the
+ * stride kernels always run the InferMeta.
+ */
+PHI_DEFINE_EXPORTED_bool(eager_infer_meta_cache,
+                         false,
+                         "reuse the output metas of the last call of an API "
+                         "for the same input metas and attributes");
+
+/**
+ * Auto parallel related FLAG
+ * Name: FLAGS_dist_api_spmd_cache
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_dist_api_spmd_cache=true makes each dist API reuse the
+ * SpmdInfo of its last call if the global shapes and dist attrs of the
+ * inputs and the attributes are the same, and pass the inputs to the kernel
+ * without the reshard checks if none of them needed a reshard then.
+ */
+PHI_DEFINE_EXPORTED_bool(dist_api_spmd_cache,
+                         false,
+                         "reuse the SpmdInfo of the last call of a dist API "
+                         "for the same input dist metas and attributes");
+
+/**
+ * Inference related FLAG
+ * Name: FLAGS_inference_program_cache_capacity
+ * Since Version: 3.0.0
+ * Value Range: int32, default=8
+ * Example: FLAGS_inference_program_cache_capacity=8 keeps the parsed programs
+ * of the last 8 models loaded by the predictors, so another predictor of the
+ * same model copies the program instead of parsing the model file again.
+ * Note: 0 disables the cache.
+ */
+PHI_DEFINE_EXPORTED_int32(inference_program_cache_capacity,
+                          8,
+                          "the number of parsed inference programs to keep");
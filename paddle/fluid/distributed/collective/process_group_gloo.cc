@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <map>
 
 #ifdef _WIN32
 #include <gloo/common/win.h>
@@ -26,11 +29,14 @@
 
 #include <gloo/reduce.h>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/collective/common.h"
 #include "paddle/fluid/distributed/collective/process_group_gloo.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 
+COMMON_DECLARE_int64(gloo_allreduce_bucket_size);
+
 namespace paddle::distributed {
 
 #ifdef _WIN32
@@ -344,8 +350,64 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
 
   void _do_allreduce(std::vector<phi::DenseTensor>& ins,     // NOLINT
                      std::vector<phi::DenseTensor>& outs) {  // NOLINT
-    _comm_context->AllReduce(
-        &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+    if (ins.size() == 1) {
+      _comm_context->AllReduce(
+          &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+      return;
+    }
+    // the buckets run one after another, so they share the tag
+    for (auto& bucket : BucketTensors(ins)) {
+      if (bucket.size() == 1) {
+        _comm_context->AllReduce(&(outs[bucket[0]]),
+                                 ins[bucket[0]],
+                                 static_cast<int>(_reduce_op),
+                                 _tag);
+        continue;
+      }
+      int64_t numel = 0;
+      for (auto i : bucket) {
+        numel += ins[i].numel();
+      }
+      phi::DenseTensor buffer;
+      buffer.Resize({numel});
+      auto* dst = static_cast<uint8_t*>(
+          buffer.mutable_data(phi::CPUPlace(), ins[bucket[0]].dtype()));
+      for (auto i : bucket) {
+        size_t bytes = ins[i].numel() * phi::SizeOf(ins[i].dtype());
+        std::memcpy(dst, ins[i].data(), bytes);
+        dst += bytes;
+      }
+      _comm_context->AllReduce(
+          &buffer, buffer, static_cast<int>(_reduce_op), _tag);
+      const auto* src = static_cast<const uint8_t*>(buffer.data());
+      for (auto i : bucket) {
+        size_t bytes = outs[i].numel() * phi::SizeOf(outs[i].dtype());
+        std::memcpy(outs[i].data(), src, bytes);
+        src += bytes;
+      }
+    }
+  }
+
+  // Groups the tensors into buckets of at most
+  // FLAGS_gloo_allreduce_bucket_size bytes per data type, in order.
+  static std::vector<std::vector<size_t>> BucketTensors(
+      const std::vector<phi::DenseTensor>& tensors) {
+    std::vector<std::vector<size_t>> buckets;
+    std::map<phi::DataType, size_t> open_bucket;
+    std::map<phi::DataType, size_t> open_bytes;
+    const size_t limit = std::max<int64_t>(FLAGS_gloo_allreduce_bucket_size, 0);
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      const auto dtype = tensors[i].dtype();
+      size_t bytes = tensors[i].numel() * phi::SizeOf(dtype);
+      if (!open_bucket.count(dtype) || open_bytes[dtype] + bytes > limit) {
+        open_bucket[dtype] = buckets.size();
+        open_bytes[dtype] = 0;
+        buckets.emplace_back();
+      }
+      buckets[open_bucket[dtype]].push_back(i);
+      open_bytes[dtype] += bytes;
+    }
+    return buckets;
   }
 };
 
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/collective/process_group_nccl.h"
+
+#include <map>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/collective/common.h"
 #include "paddle/fluid/platform/cuda_device_guard.h"
@@ -36,6 +39,7 @@ COMMON_DECLARE_bool(nccl_blocking_wait);
 COMMON_DECLARE_bool(use_stream_safe_cuda_allocator);
 COMMON_DECLARE_bool(use_cuda_malloc_async_allocator);
 COMMON_DECLARE_bool(enable_async_trace);
+COMMON_DECLARE_int64(nccl_coalesce_flatten_size);
 
 // set this flag to `true` and recompile to enable dynamic checks
 constexpr bool FLAGS_enable_nccl_dynamic_check = false;
@@ -50,6 +54,115 @@ using phi::distributed::NCCLRedTypeToString;
 using phi::distributed::SerializeNCCLUniqueId;
 using phi::distributed::ToNCCLRedType;
 
+namespace {
+
+// Small tensors of one data type, copied into a flat buffer that is
+// communicated by a single NCCL call.
+struct FlatTensors {
+  std::vector<size_t> indices;
+  phi::DenseTensor buffer;
+};
+
+size_t TensorBytes(const phi::DenseTensor& tensor) {
+  return tensor.numel() * phi::SizeOf(tensor.dtype());
+}
+
+// Groups the tensors of at most FLAGS_nccl_coalesce_flatten_size bytes by
+// data type, a lone tensor is not worth the copies.
+std::vector<FlatTensors> GroupSmallTensors(
+    const std::vector<phi::DenseTensor>& tensors) {
+  std::vector<FlatTensors> groups;
+  if (FLAGS_nccl_coalesce_flatten_size <= 0) {
+    return groups;
+  }
+  std::map<phi::DataType, std::vector<size_t>> indices_by_dtype;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    size_t bytes = TensorBytes(tensors[i]);
+    if (bytes > 0 &&
+        bytes <= static_cast<size_t>(FLAGS_nccl_coalesce_flatten_size)) {
+      indices_by_dtype[tensors[i].dtype()].push_back(i);
+    }
+  }
+  for (auto& item : indices_by_dtype) {
+    if (item.second.size() > 1) {
+      groups.push_back({std::move(item.second), phi::DenseTensor()});
+    }
+  }
+  return groups;
+}
+
+// Allocates the buffer of `group` for `stream`, and copies the tensors into
+// it if `copy_in`.
+void FlattenTensors(const std::vector<phi::DenseTensor>& tensors,
+                    bool copy_in,
+                    gpuStream_t stream,
+                    FlatTensors* group) {
+  const auto& first = tensors[group->indices.front()];
+  int64_t numel = 0;
+  for (auto i : group->indices) {
+    numel += tensors[i].numel();
+  }
+  auto holder = phi::memory_utils::AllocShared(
+      first.place(),
+      numel * phi::SizeOf(first.dtype()),
+      phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+  group->buffer = phi::DenseTensor(
+      holder, phi::DenseTensorMeta(first.dtype(), phi::make_ddim({numel})));
+  if (!copy_in) {
+    return;
+  }
+  auto* dst = static_cast<uint8_t*>(holder->ptr());
+  for (auto i : group->indices) {
+    size_t bytes = TensorBytes(tensors[i]);
+    phi::memory_utils::Copy(
+        first.place(), dst, first.place(), tensors[i].data(), bytes, stream);
+    dst += bytes;
+  }
+}
+
+void UnflattenTensors(const FlatTensors& group,
+                      const std::vector<phi::DenseTensor*>& out_tensors,
+                      gpuStream_t stream) {
+  const auto* src = static_cast<const uint8_t*>(group.buffer.data());
+  for (auto i : group.indices) {
+    auto* out_tensor = out_tensors[i];
+    size_t bytes = TensorBytes(*out_tensor);
+    phi::memory_utils::Copy(out_tensor->place(),
+                            out_tensor->data(),
+                            group.buffer.place(),
+                            src,
+                            bytes,
+                            stream);
+    src += bytes;
+  }
+}
+
+// The buffers are freed once the copies out of them are queued. Without a
+// stream safe allocator they may be reused by the calc stream right away, so
+// the comm stream is synchronized first.
+void ReleaseFlatTensors(std::vector<FlatTensors>* groups,
+                        gpuStream_t stream,
+                        bool use_calc_stream) {
+  if (!groups->empty() && !use_calc_stream &&
+      !FLAGS_use_stream_safe_cuda_allocator &&
+      !FLAGS_use_cuda_malloc_async_allocator) {
+    phi::backends::gpu::GpuStreamSync(stream);
+  }
+  groups->clear();
+}
+
+std::vector<const phi::DenseTensor*> TensorPtrs(
+    const std::vector<phi::DenseTensor>& tensors) {
+  std::vector<const phi::DenseTensor*> ptrs;
+  ptrs.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    ptrs.push_back(&tensor);
+  }
+  return ptrs;
+}
+
+}  // namespace
+
 uint64_t ProcessGroupNCCL::s_group_call_counter = 0;
 
 ProcessGroupNCCL::NCCLTask::NCCLTask(const Place& place,
@@ -401,6 +514,179 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Broadcast(
       use_calc_stream);
 }
 
+void ProcessGroupNCCL::CheckCoalescedTensors(
+    const std::vector<phi::DenseTensor*>& out_tensors,
+    const std::vector<phi::DenseTensor>& in_tensors) {
+  PADDLE_ENFORCE_EQ(
+      out_tensors.size(),
+      in_tensors.size(),
+      common::errors::InvalidArgument(
+          "The number of output tensors [%d] of a coalesced collective does "
+          "not match the number of input tensors [%d].",
+          out_tensors.size(),
+          in_tensors.size()));
+  // the pending collectives of StartCoalescing are matched to their tasks
+  // one by one
+  PADDLE_ENFORCE_EQ(is_coalescing_,
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "Coalesced collectives can not be issued between "
+                        "StartCoalescing and EndCoalescing."));
+  for (size_t i = 0; i < out_tensors.size(); ++i) {
+    PADDLE_ENFORCE_NOT_NULL(
+        out_tensors[i],
+        common::errors::InvalidArgument(
+            "The output tensor %d of a coalesced collective is NULL.", i));
+    CheckTensorContiguous(*out_tensors[i]);
+  }
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllGatherCoalesced(
+    const std::vector<phi::DenseTensor*>& out_tensors,
+    const std::vector<phi::DenseTensor>& in_tensors,
+    bool sync_op,
+    bool use_calc_stream) {
+  CheckCoalescedTensors(out_tensors, in_tensors);
+  for (size_t i = 0; i < in_tensors.size(); ++i) {
+    phi::distributed::CommStaticCheck::GatherLikeShape(*out_tensors[i],
+                                                       in_tensors[i],
+                                                       /*dst_rank*/ rank_,
+                                                       /*cur_rank*/ rank_,
+                                                       size_);
+  }
+
+  // The gathered tensors are laid out rank by rank, so they are not
+  // flattened.
+  return Collective(
+      [&](phi::distributed::NCCLCommContext* comm_context, gpuStream_t stream) {
+        VLOG(3) << "[ncclAllGather] coalesced "
+                << "count of tensors: " << in_tensors.size()
+                << ", ncclcomm: " << comm_context->GetNcclComm()
+                << ", stream: " << stream << ", rank_in_group: " << rank_
+                << ", nranks: " << size_ << ", sync_op: " << sync_op
+                << ", use_calc_stream: " << use_calc_stream << ", "
+                << GetGroupMessage();
+        GroupStart();
+        for (size_t i = 0; i < in_tensors.size(); ++i) {
+          comm_context->AllGather(out_tensors[i], in_tensors[i], stream);
+        }
+        GroupEnd();
+      },
+      TensorPtrs(in_tensors),
+      CommType::ALLGATHER,
+      sync_op,
+      use_calc_stream);
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduceCoalesced(
+    const std::vector<phi::DenseTensor*>& out_tensors,
+    const std::vector<phi::DenseTensor>& in_tensors,
+    const AllreduceOptions& opts,
+    bool sync_op,
+    bool use_calc_stream) {
+  CheckCoalescedTensors(out_tensors, in_tensors);
+
+  return Collective(
+      [&](phi::distributed::NCCLCommContext* comm_context, gpuStream_t stream) {
+        auto groups = GroupSmallTensors(in_tensors);
+        std::vector<bool> flattened(in_tensors.size(), false);
+        for (auto& group : groups) {
+          FlattenTensors(in_tensors, /*copy_in*/ true, stream, &group);
+          for (auto i : group.indices) {
+            flattened[i] = true;
+          }
+        }
+        VLOG(3) << "[ncclAllReduce] coalesced "
+                << "count of tensors: " << in_tensors.size()
+                << ", flattened groups: " << groups.size() << ", redop: "
+                << NCCLRedTypeToString(ToNCCLRedType(opts.reduce_op))
+                << ", ncclcomm: " << comm_context->GetNcclComm()
+                << ", stream: " << stream << ", rank_in_group: " << rank_
+                << ", nranks: " << size_ << ", sync_op: " << sync_op
+                << ", use_calc_stream: " << use_calc_stream << ", "
+                << GetGroupMessage();
+
+        GroupStart();
+        for (size_t i = 0; i < in_tensors.size(); ++i) {
+          if (!flattened[i]) {
+            comm_context->AllReduce(out_tensors[i],
+                                    in_tensors[i],
+                                    ToNCCLRedType(opts.reduce_op),
+                                    stream);
+          }
+        }
+        for (auto& group : groups) {
+          comm_context->AllReduce(&group.buffer,
+                                  group.buffer,
+                                  ToNCCLRedType(opts.reduce_op),
+                                  stream);
+        }
+        GroupEnd();
+
+        for (const auto& group : groups) {
+          UnflattenTensors(group, out_tensors, stream);
+        }
+        ReleaseFlatTensors(&groups, stream, use_calc_stream);
+      },
+      TensorPtrs(in_tensors),
+      CommType::ALLREDUCE,
+      sync_op,
+      use_calc_stream);
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::BroadcastCoalesced(
+    const std::vector<phi::DenseTensor*>& out_tensors,
+    const std::vector<phi::DenseTensor>& in_tensors,
+    const BroadcastOptions& opts,
+    bool sync_op,
+    bool use_calc_stream) {
+  CheckCoalescedTensors(out_tensors, in_tensors);
+
+  return Collective(
+      [&](phi::distributed::NCCLCommContext* comm_context, gpuStream_t stream) {
+        int root = opts.source_rank + opts.source_root;
+        auto groups = GroupSmallTensors(in_tensors);
+        std::vector<bool> flattened(in_tensors.size(), false);
+        for (auto& group : groups) {
+          // only the data of the root is sent
+          FlattenTensors(in_tensors, /*copy_in*/ rank_ == root, stream, &group);
+          for (auto i : group.indices) {
+            flattened[i] = true;
+          }
+        }
+        VLOG(3) << "[ncclBroadcast] coalesced "
+                << "count of tensors: " << in_tensors.size()
+                << ", flattened groups: " << groups.size()
+                << ", root: " << root
+                << ", ncclcomm: " << comm_context->GetNcclComm()
+                << ", stream: " << stream << ", rank_in_group: " << rank_
+                << ", nranks: " << size_ << ", sync_op: " << sync_op
+                << ", use_calc_stream: " << use_calc_stream << ", "
+                << GetGroupMessage();
+
+        GroupStart();
+        for (size_t i = 0; i < in_tensors.size(); ++i) {
+          if (!flattened[i]) {
+            comm_context->Broadcast(
+                out_tensors[i], in_tensors[i], root, stream);
+          }
+        }
+        for (auto& group : groups) {
+          comm_context->Broadcast(&group.buffer, group.buffer, root, stream);
+        }
+        GroupEnd();
+
+        for (const auto& group : groups) {
+          UnflattenTensors(group, out_tensors, stream);
+        }
+        ReleaseFlatTensors(&groups, stream, use_calc_stream);
+      },
+      TensorPtrs(in_tensors),
+      CommType::BROADCAST,
+      sync_op,
+      use_calc_stream);
+}
+
 std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Reduce(
     phi::DenseTensor* out_tensor,
     const phi::DenseTensor& in_tensor,
@@ -822,10 +1108,38 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
     CommType comm_type,
     bool sync_op,
     bool use_calc_stream) {
-  CheckTensorContiguous(tensor);
+  return Collective(fn,
+                    std::vector<const phi::DenseTensor*>{&tensor},
+                    comm_type,
+                    sync_op,
+                    use_calc_stream);
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
+    std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t)> fn,
+    const std::vector<const phi::DenseTensor*>& tensors,
+    CommType comm_type,
+    bool sync_op,
+    bool use_calc_stream) {
+  PADDLE_ENFORCE_EQ(
+      tensors.empty(),
+      false,
+      common::errors::InvalidArgument("No tensor to communicate is given."));
+  const auto& place = tensors.front()->place();
+  int64_t numel = 0;
+  for (const auto* tensor : tensors) {
+    CheckTensorContiguous(*tensor);
+    PADDLE_ENFORCE_EQ(tensor->place(),
+                      place,
+                      common::errors::InvalidArgument(
+                          "The tensors communicated together must be on the "
+                          "same place, but got %s and %s.",
+                          tensor->place(),
+                          place));
+    numel += tensor->numel();
+  }
 
   comm_seq_++;
-  const auto& place = tensor.place();
   const auto& key = GetKeyFromPlace(place);
 
   platform::CUDADeviceGuard cuda_guard(place);
@@ -862,7 +1176,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
                                                          size_,
                                                          gid_,
                                                          comm_seq_,
-                                                         tensor.numel(),
+                                                         numel,
                                                          sync_op,
                                                          use_calc_stream,
                                                          nccl_comm,
@@ -880,16 +1194,20 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
 
   if (!use_calc_stream) {
     if (!is_coalescing_) {
-      if (FLAGS_use_stream_safe_cuda_allocator ||
-          FLAGS_use_cuda_malloc_async_allocator) {
-        memory::RecordStream(tensor.Holder(), nccl_stream);
+      for (const auto* tensor : tensors) {
+        if (FLAGS_use_stream_safe_cuda_allocator ||
+            FLAGS_use_cuda_malloc_async_allocator) {
+          memory::RecordStream(tensor->Holder(), nccl_stream);
+        }
+        allocation_stream_pairs_.emplace_back(tensor->Holder(), nccl_stream);
       }
       task->UpdateWaitChain(*comm_ctx);
-      allocation_stream_pairs_.emplace_back(tensor.Holder(), nccl_stream);
     } else {
-      colaescing_tensors_.emplace_back(
-          std::make_shared<phi::DenseTensor>(tensor));
-      colaescing_place_keys_.push_back(key);
+      for (const auto* tensor : tensors) {
+        colaescing_tensors_.emplace_back(
+            std::make_shared<phi::DenseTensor>(*tensor));
+        colaescing_place_keys_.push_back(key);
+      }
     }
   }
 
@@ -970,27 +1288,26 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
   auto nccl_comm = comm_ctx->nccl_comm();
   auto nccl_stream = use_calc_stream ? calc_ctx->stream() : comm_ctx->stream();
 
-  std::string group_key = place_to_group_key_.at(key);
-  auto comm_task =
-      std::make_shared<phi::distributed::NCCLCommTask>(place,
-                                                       group_key,
-                                                       p2p_rank,
-                                                       p2p_nrank,
-                                                       gid_,
-                                                       p2p_comm_seq_[key],
-                                                       tensor.numel(),
-                                                       sync_op,
-                                                       use_calc_stream,
-                                                       nccl_comm,
-                                                       nccl_stream,
-                                                       comm_type,
-                                                       pg_timeout_);
-
   auto nccl_comm_ctx = this->GetCommContext(&store_key);
 
   if (!FLAGS_enable_async_trace) {
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
   } else {
+    std::string group_key = place_to_group_key_.at(key);
+    auto comm_task =
+        std::make_shared<phi::distributed::NCCLCommTask>(place,
+                                                         group_key,
+                                                         p2p_rank,
+                                                         p2p_nrank,
+                                                         gid_,
+                                                         p2p_comm_seq_[key],
+                                                         tensor.numel(),
+                                                         sync_op,
+                                                         use_calc_stream,
+                                                         nccl_comm,
+                                                         nccl_stream,
+                                                         comm_type,
+                                                         pg_timeout_);
     comm_task->StartRecord();
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
     comm_task->EndRecord();
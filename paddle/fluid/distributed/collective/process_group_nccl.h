@@ -173,6 +173,26 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
                                            bool sync_op,
                                            bool use_calc_stream) override;
 
+  std::shared_ptr<ProcessGroup::Task> AllGatherCoalesced(
+      const std::vector<phi::DenseTensor*>& out_tensors,
+      const std::vector<phi::DenseTensor>& in_tensors,
+      bool sync_op,
+      bool use_calc_stream) override;
+
+  std::shared_ptr<ProcessGroup::Task> AllReduceCoalesced(
+      const std::vector<phi::DenseTensor*>& out_tensors,
+      const std::vector<phi::DenseTensor>& in_tensors,
+      const AllreduceOptions& opts,
+      bool sync_op,
+      bool use_calc_stream) override;
+
+  std::shared_ptr<ProcessGroup::Task> BroadcastCoalesced(
+      const std::vector<phi::DenseTensor*>& out_tensors,
+      const std::vector<phi::DenseTensor>& in_tensors,
+      const BroadcastOptions& opts,
+      bool sync_op,
+      bool use_calc_stream) override;
+
   static void GroupStart();
 
   static void GroupEnd();
@@ -208,6 +228,17 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
       bool sync_op,
       bool use_calc_stream);
 
+  // All the tensors must be on the same place, they are tracked by one task.
+  std::shared_ptr<ProcessGroup::Task> Collective(
+      std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t)> fn,
+      const std::vector<const phi::DenseTensor*>& tensors,
+      CommType comm_type,
+      bool sync_op,
+      bool use_calc_stream);
+
+  void CheckCoalescedTensors(const std::vector<phi::DenseTensor*>& out_tensors,
+                             const std::vector<phi::DenseTensor>& in_tensors);
+
   std::shared_ptr<ProcessGroup::Task> Point2Point(
       std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t, int)>
           fn,
@@ -13,10 +13,16 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/collective/reducer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
 #include "paddle/common/flags.h"
 #include "paddle/phi/api/lib/data_transform.h"
 #include "paddle/phi/backends/device_guard.h"
 #include "paddle/phi/backends/device_manager.h"
+#include "paddle/phi/core/tensor_utils.h"
 
 PD_DECLARE_bool(use_stream_safe_cuda_allocator);
 COMMON_DECLARE_string(allocator_strategy);
@@ -29,6 +35,9 @@ static bool IsStreamSafeAllocator() {
           FLAGS_use_stream_safe_cuda_allocator);
 }
 
+// All ranks must draw the same initial PowerSGD Q matrix.
+static constexpr int kPowerSGDSeed = 2022;
+
 static Backend TransToBackend(phi::Place place) {
   static const std::map<phi::AllocationType, Backend> type_backend = {
       {phi::AllocationType::GPU, Backend::GPU},
@@ -211,6 +220,10 @@ struct ConcatTensorsForAllReduce<phi::CustomContext, T> {
     auto *device = phi::DeviceManager::GetDeviceWithPlace(context.GetPlace());
     phi::stream::Stream stream(context.GetPlace(), context.stream());
 
+    // the device to device copies are batched into a single call
+    std::vector<void *> dsts;
+    std::vector<const void *> srcs;
+    std::vector<size_t> sizes;
     size_t offset = 0;
     for (const auto &tensor : dense_tensors_) {
       const uint8_t *in_data =
@@ -219,10 +232,14 @@ struct ConcatTensorsForAllReduce<phi::CustomContext, T> {
       if (tensor.place().GetType() == phi::AllocationType::CPU) {
         device->MemoryCopyH2D(out_data + offset, in_data, sz, &stream);
       } else {
-        device->MemoryCopyD2D(out_data + offset, in_data, sz, &stream);
+        dsts.push_back(out_data + offset);
+        srcs.push_back(in_data);
+        sizes.push_back(sz);
       }
       offset += sz;
     }
+    device->MemoryCopyD2DBatch(
+        dsts.data(), srcs.data(), sizes.data(), dsts.size(), &stream);
   }
 };
 
@@ -238,6 +255,9 @@ struct SplitTensorsForAllReduce<phi::CustomContext, T> {
     auto *device = phi::DeviceManager::GetDeviceWithPlace(context.GetPlace());
     phi::stream::Stream stream(context.GetPlace(), context.stream());
 
+    std::vector<void *> dsts;
+    std::vector<const void *> srcs;
+    std::vector<size_t> sizes;
     size_t offset = 0;
     for (auto &tensor : *p_dense_tensors) {
       uint8_t *out_data = reinterpret_cast<uint8_t *>(tensor.data<T>());
@@ -245,10 +265,14 @@ struct SplitTensorsForAllReduce<phi::CustomContext, T> {
       if (tensor.place().GetType() == phi::AllocationType::CPU) {
         device->MemoryCopyD2H(out_data, in_data + offset, sz, &stream);
       } else {
-        device->MemoryCopyD2D(out_data, in_data + offset, sz, &stream);
+        dsts.push_back(out_data);
+        srcs.push_back(in_data + offset);
+        sizes.push_back(sz);
       }
       offset += sz;
     }
+    device->MemoryCopyD2DBatch(
+        dsts.data(), srcs.data(), sizes.data(), dsts.size(), &stream);
   }
 };
 #endif
@@ -375,6 +399,11 @@ void SplitTensorsWithType<phi::XPUContext>(
 #endif
 
 void EagerGroup::ConcatTensors(const phi::Place &place) {
+  if (bucket_view_contents_.initialized()) {
+    // the grads are already in the bucket
+    dense_contents_ = bucket_view_contents_;
+    return;
+  }
   dense_contents_ =
       paddle::experimental::empty(IntArray({all_length_}), dtype_, place);
 
@@ -424,6 +453,21 @@ void EagerGroup::ConcatTensors(const phi::Place &place) {
 }
 
 void EagerGroup::SplitTensors(const phi::DeviceContext &context) {
+  if (bucket_view_contents_.initialized()) {
+    // only a decompressed bucket is a separate tensor to copy back
+    if (dense_contents_.impl() != bucket_view_contents_.impl()) {
+      phi::Copy(
+          context,
+          *std::dynamic_pointer_cast<phi::DenseTensor>(dense_contents_.impl()),
+          context.GetPlace(),
+          false,
+          std::dynamic_pointer_cast<phi::DenseTensor>(
+              bucket_view_contents_.impl())
+              .get());
+      dense_contents_ = bucket_view_contents_;
+    }
+    return;
+  }
   auto place = context.GetPlace();
   if (phi::is_gpu_place(place)) {
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
@@ -769,7 +813,11 @@ void EagerReducer::AddDistHook(size_t var_index) {
     auto *autograd_meta = tensors_[var_index].get_autograd_meta();
     auto &grad_tensor = static_cast<egr::AutogradMeta *>(autograd_meta)->Grad();
 
-    if (HasGrad(var_index)) {
+    if (grad_as_bucket_view_ && !group.is_sparse_) {
+      if (HasGrad(var_index)) {
+        BindGradToBucketView(var_index, /*copy_grad=*/true);
+      }
+    } else if (HasGrad(var_index)) {
       auto grad_dense_tensor =
           *(std::dynamic_pointer_cast<phi::DenseTensor>(grad_tensor.impl()));
       group_tensor.ShareDataWith(grad_dense_tensor);
@@ -839,7 +887,18 @@ void EagerReducer::MarkVarReady(const size_t var_index,
 
   auto &group = groups_[group_index];
 
-  if (!group.is_sparse_) {
+  if (!group.is_sparse_ && grad_as_bucket_view_) {
+    // the view is already the grad unless the grad has been replaced
+    if (HasGrad(var_index)) {
+      BindGradToBucketView(var_index, /*copy_grad=*/true);
+    } else {
+      VLOG(3) << "Tensor[" << tensors_[var_index].name()
+              << "] doesn't have grad";
+      auto *dev_ctx = phi::DeviceContextPool::Instance().Get(inner_place_);
+      phi::funcs::set_constant(
+          *dev_ctx, &group.dense_tensors_[inside_group_index], 0.0f);
+    }
+  } else if (!group.is_sparse_) {
     auto &group_tensor = group.dense_tensors_[inside_group_index];
     const auto length = group.length_[inside_group_index];
     if (is_used_var) {
@@ -1049,6 +1108,12 @@ void EagerReducer::ProcessUnusedDenseVars() {
           GetGradNodeFromTensor(&tensors_[var_index]))
           ->SetFakeEmpty(false);
 
+      if (grad_as_bucket_view_) {
+        // the view holds the allreduced grad, the local one is stale
+        BindGradToBucketView(var_index, /*copy_grad=*/false);
+        continue;
+      }
+
       Tensor grad_value(std::make_shared<phi::DenseTensor>(src_tensor));
 
       auto dest_var_base = tensors_[var_index];
@@ -1065,11 +1130,22 @@ void EagerReducer::FinalizeBackward() {
   for (auto &group : groups_) {
     if (!group.is_sparse_) {
       group.task->Synchronize();
-      if (!IsStreamSafeAllocator()) {
+      if (group.comm_indices_task_) {
+        group.comm_indices_task_->Synchronize();
+      }
+      if (group.comm_hook_pending_) {
+        // Decompression runs on the calculation stream, so the split of a
+        // compressed group always happens after the task is synchronized.
+        auto *default_ctx =
+            phi::DeviceContextPool::Instance().Get(inner_place_);
+        DecompressGroup(&group);
+        group.SplitTensors(*default_ctx);
+      } else if (!IsStreamSafeAllocator()) {
         auto *default_ctx =
             phi::DeviceContextPool::Instance().Get(inner_place_);
         group.SplitTensors(*default_ctx);
       }
+      UpdateCommStats(&group);
     }
   }
 
@@ -1090,6 +1166,7 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
   opts.reduce_op = ReduceOp::SUM;
 
   VLOG(3) << "group [" << curr_group_index << "] start fused_allreduce.";
+  group->comm_start_ = std::chrono::steady_clock::now();
 
   // concat tensors
   group->ConcatTensors(inner_place_);
@@ -1098,6 +1175,11 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
   paddle::experimental::scale_(
       group->dense_contents_, 1.0 / nranks_, 0.0, false);  // NOLINT
 
+  // compress and communicate, the split is done in FinalizeBackward
+  if (CompressedAllReduceSchedule(group, curr_group_index)) {
+    return;
+  }
+
   // all_reduce
   std::vector<Tensor> reduce_tensors = {group->dense_contents_};
   std::vector<phi::DenseTensor> in_out;
@@ -1106,6 +1188,8 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
     in_out.push_back(*std::dynamic_pointer_cast<phi::DenseTensor>(t.impl()));
   }
   group->task = process_group_->AllReduce(in_out, in_out, opts);
+  group->comm_stats_.last_bytes =
+      group->all_length_ * static_cast<int64_t>(phi::SizeOf(group->dtype_));
 
   auto *context = process_group_->GetDeviceContext(inner_place_);
 
@@ -1119,6 +1203,320 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
   }
 }
 
+void EagerReducer::SetCommHook(const CommHookOptions &options) {
+  PADDLE_ENFORCE_EQ(grad_need_hooks_,
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "The communication hook can not be changed during "
+                        "the backward pass."));
+  PADDLE_ENFORCE_GT(options.power_sgd_rank,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The rank of PowerSGD must be greater than 0, but "
+                        "received %d.",
+                        options.power_sgd_rank));
+  PADDLE_ENFORCE_EQ(
+      options.topk_ratio > 0.0 && options.topk_ratio <= 1.0,
+      true,
+      common::errors::InvalidArgument(
+          "The ratio of top-k compression must be in (0, 1], but received %f.",
+          options.topk_ratio));
+
+  comm_hook_ = options;
+  // the error feedback of the previous hook does not apply to the new one
+  for (auto &group : groups_) {
+    group.comm_hook_pending_ = false;
+    group.comm_contents_.reset();
+    group.comm_indices_.reset();
+    group.comm_indices_task_.reset();
+    group.error_feedback_.reset();
+    group.power_sgd_p_.reset();
+    group.power_sgd_q_.reset();
+  }
+  VLOG(3) << "Set communication hook " << static_cast<int>(options.type)
+          << ", power_sgd_rank: " << options.power_sgd_rank
+          << ", topk_ratio: " << options.topk_ratio;
+}
+
+void EagerReducer::SetGradAsBucketView(bool enable) {
+  PADDLE_ENFORCE_EQ(grad_need_hooks_,
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "The bucket view mode can not be changed during the "
+                        "backward pass."));
+  grad_as_bucket_view_ = enable;
+  for (auto &group : groups_) {
+    if (group.is_sparse_) {
+      continue;
+    }
+    // the grads bound before keep their views, which are released with them
+    group.bucket_view_contents_.reset();
+    if (!enable) {
+      for (size_t i = 0; i < group.tensor_indices_.size(); ++i) {
+        group.dense_tensors_[i] = phi::DenseTensor();
+        std::static_pointer_cast<egr::GradNodeAccumulation>(
+            GetGradNodeFromTensor(&tensors_[group.tensor_indices_[i]]))
+            ->SetKeepGradBuffer(false);
+      }
+      continue;
+    }
+    group.bucket_view_contents_ = paddle::experimental::zeros(
+        IntArray({group.all_length_}), group.dtype_, inner_place_);
+    auto &contents = *std::dynamic_pointer_cast<phi::DenseTensor>(
+        group.bucket_view_contents_.impl());
+    int64_t offset = 0;
+    // the grads are bound when they are ready, so a parameter keeps no grad
+    // until its first backward
+    for (size_t i = 0; i < group.tensor_indices_.size(); ++i) {
+      group.dense_tensors_[i] =
+          contents.Slice(offset, offset + group.length_[i]);
+      offset += group.length_[i];
+    }
+  }
+  VLOG(3) << "Set grad as bucket view: " << enable;
+}
+
+// Point the grad of the parameter to its view of the bucket. With copy_grad,
+// the values of a grad that is not the view are copied into the view first.
+void EagerReducer::BindGradToBucketView(size_t var_index, bool copy_grad) {
+  const auto &var_locator = variable_locators_[var_index];
+  auto &group = groups_[var_locator.group_index];
+  const auto &view = group.dense_tensors_[var_locator.inside_group_index];
+  auto &tensor = tensors_[var_index];
+  auto *grad_tensor = egr::EagerUtils::mutable_grad(tensor);
+
+  phi::DenseTensor *grad_dense = nullptr;
+  if (grad_tensor->initialized() && grad_tensor->is_dense_tensor()) {
+    grad_dense = static_cast<phi::DenseTensor *>(grad_tensor->impl().get());
+    if (grad_dense->Holder() == view.Holder() &&
+        grad_dense->offset() == view.offset()) {
+      return;
+    }
+    PADDLE_ENFORCE_EQ(
+        grad_dense->dtype(),
+        group.dtype_,
+        common::errors::PreconditionNotMet(
+            "The grad of Tensor %s has dtype %s, which differs from the "
+            "dtype %s of its bucket, so it can not be a view of the bucket.",
+            tensor.name(),
+            grad_dense->dtype(),
+            group.dtype_));
+  }
+
+  auto bound = std::make_shared<phi::DenseTensor>(view);
+  if (copy_grad && grad_dense != nullptr) {
+    auto *dev_ctx = phi::DeviceContextPool::Instance().Get(inner_place_);
+    phi::Copy(*dev_ctx, *grad_dense, inner_place_, false, bound.get());
+  }
+  bound->Resize(tensor.dims());
+  grad_tensor->set_impl(bound);
+  std::static_pointer_cast<egr::GradNodeAccumulation>(
+      GetGradNodeFromTensor(&tensor))
+      ->SetKeepGradBuffer(true);
+}
+
+std::vector<EagerGroupCommStats> EagerReducer::GetCommStats() const {
+  std::vector<EagerGroupCommStats> stats;
+  stats.reserve(groups_.size());
+  for (auto &group : groups_) {
+    stats.push_back(group.comm_stats_);
+  }
+  return stats;
+}
+
+void EagerReducer::UpdateCommStats(EagerGroup *group) {
+  auto &stats = group->comm_stats_;
+  auto elapsed = std::chrono::steady_clock::now() - group->comm_start_;
+  stats.last_time_us =
+      std::chrono::duration<double, std::micro>(elapsed).count();
+  stats.total_time_us += stats.last_time_us;
+  stats.total_bytes += stats.last_bytes;
+  ++stats.steps;
+  VLOG(4) << "group with " << group->all_length_ << " elements sent "
+          << stats.last_bytes << " bytes in " << stats.last_time_us << " us";
+}
+
+std::shared_ptr<ProcessGroup::Task> EagerReducer::AllReduceTensor(
+    Tensor *in_out) {
+  distributed::AllreduceOptions opts;
+  opts.reduce_op = ReduceOp::SUM;
+  std::vector<phi::DenseTensor> in_out_tensors = {
+      *std::dynamic_pointer_cast<phi::DenseTensor>(in_out->impl())};
+  return process_group_->AllReduce(in_out_tensors, in_out_tensors, opts);
+}
+
+void EagerReducer::AllReduceOnCalcStream(Tensor *in_out) {
+  if (phi::is_cpu_place(inner_place_)) {
+    // the collectives on cpu are done when they return
+    AllReduceTensor(in_out)->Synchronize();
+    return;
+  }
+  distributed::AllreduceOptions opts;
+  opts.reduce_op = ReduceOp::SUM;
+  auto dense = std::dynamic_pointer_cast<phi::DenseTensor>(in_out->impl());
+  process_group_->AllReduce(dense.get(),
+                            *dense,
+                            opts,
+                            /*sync_op=*/true,
+                            /*use_calc_stream=*/true);
+}
+
+std::shared_ptr<ProcessGroup::Task> EagerReducer::AllGatherTensor(
+    const Tensor &in, Tensor *out) {
+  *out = paddle::experimental::empty(IntArray({in.numel() * nranks_}),
+                                     in.dtype(),
+                                     inner_place_);
+  std::vector<phi::DenseTensor> in_tensors = {
+      *std::dynamic_pointer_cast<phi::DenseTensor>(in.impl())};
+  std::vector<phi::DenseTensor> out_tensors = {
+      *std::dynamic_pointer_cast<phi::DenseTensor>(out->impl())};
+  return process_group_->AllGather(in_tensors, out_tensors);
+}
+
+bool EagerReducer::CompressedAllReduceSchedule(EagerGroup *group,
+                                               const int curr_group_index) {
+  const auto type = comm_hook_.type;
+  if (type == CommHookType::kNone) {
+    return false;
+  }
+  // Low precision buckets are sent as they are, casting them gains nothing
+  // and the low-rank and top-k approximations lose too much precision.
+  if (group->dtype_ != DataType::FLOAT32 &&
+      group->dtype_ != DataType::FLOAT64) {
+    VLOG(3) << "group [" << curr_group_index << "] with dtype "
+            << group->dtype_ << " skips the communication hook.";
+    return false;
+  }
+
+  VLOG(3) << "group [" << curr_group_index << "] start compressed allreduce"
+          << " with hook " << static_cast<int>(type);
+
+  const int64_t elem_size = static_cast<int64_t>(phi::SizeOf(group->dtype_));
+  const int64_t numel = group->all_length_;
+  auto &dense = group->dense_contents_;
+  switch (type) {
+    case CommHookType::kFP16:
+    case CommHookType::kBF16: {
+      const auto comm_dtype = type == CommHookType::kFP16 ? DataType::FLOAT16
+                                                          : DataType::BFLOAT16;
+      group->comm_contents_ = paddle::experimental::cast(dense, comm_dtype);
+      group->task = AllReduceTensor(&group->comm_contents_);
+      group->comm_stats_.last_bytes =
+          numel * static_cast<int64_t>(phi::SizeOf(comm_dtype));
+      break;
+    }
+    case CommHookType::kTopK: {
+      Tensor corrected =
+          group->error_feedback_.initialized()
+              ? paddle::experimental::add(dense, group->error_feedback_)
+              : dense;
+      const int64_t k = std::min(
+          numel,
+          std::max(static_cast<int64_t>(1),
+                   static_cast<int64_t>(numel * comm_hook_.topk_ratio)));
+      Tensor indices = std::get<1>(paddle::experimental::topk(
+          paddle::experimental::abs(corrected), k, 0, true, false));
+      Tensor values = paddle::experimental::gather(corrected, indices, 0);
+      // keep the elements that are not sent for the next step
+      group->error_feedback_ = paddle::experimental::scatter(
+          corrected, indices, paddle::experimental::zeros_like(values), true);
+
+      group->comm_indices_task_ =
+          AllGatherTensor(indices, &group->comm_indices_);
+      group->task = AllGatherTensor(values, &group->comm_contents_);
+      group->comm_stats_.last_bytes =
+          k * (elem_size + static_cast<int64_t>(phi::SizeOf(indices.dtype())));
+      break;
+    }
+    case CommHookType::kPowerSGD: {
+      // The bucket is viewed as a nearly square matrix M and approximated by
+      // P * Q^T, where P = orth(allreduce(M * Q)) and Q = allreduce(M^T * P).
+      const int64_t cols = static_cast<int64_t>(
+          std::ceil(std::sqrt(static_cast<double>(numel))));
+      const int64_t rows = (numel + cols - 1) / cols;
+      const int64_t rank =
+          std::min(comm_hook_.power_sgd_rank, std::min(rows, cols));
+      Tensor matrix = dense;
+      if (rows * cols != numel) {
+        matrix = paddle::experimental::pad(
+            dense, {0, static_cast<int>(rows * cols - numel)}, 0);
+      }
+      matrix = paddle::experimental::reshape(matrix, IntArray({rows, cols}));
+      if (group->error_feedback_.initialized()) {
+        matrix = paddle::experimental::add(matrix, group->error_feedback_);
+      }
+      if (!group->power_sgd_q_.initialized()) {
+        group->power_sgd_q_ = paddle::experimental::gaussian(
+            IntArray({cols, rank}),
+            0.0,
+            1.0,
+            kPowerSGDSeed,
+            group->dtype_,
+            inner_place_);
+      }
+
+      Tensor p = paddle::experimental::matmul(matrix, group->power_sgd_q_);
+      // P is reduced on the calculation stream, so that the QR below is
+      // ordered after it without blocking the host.
+      AllReduceOnCalcStream(&p);
+      group->power_sgd_p_ = std::get<0>(paddle::experimental::qr(p, "reduced"));
+      Tensor q = paddle::experimental::matmul(
+          matrix, group->power_sgd_p_, true, false);
+      // The error is what the local P * Q^T misses of the local bucket, it
+      // is taken before Q is reduced in place.
+      group->error_feedback_ = paddle::experimental::subtract(
+          matrix,
+          paddle::experimental::matmul(group->power_sgd_p_, q, false, true));
+      group->power_sgd_q_ = q;
+      group->task = AllReduceTensor(&group->power_sgd_q_);
+      group->comm_stats_.last_bytes = (rows + cols) * rank * elem_size;
+      break;
+    }
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Communication hook %d is not supported.", static_cast<int>(type)));
+  }
+  group->comm_hook_pending_ = true;
+  return true;
+}
+
+void EagerReducer::DecompressGroup(EagerGroup *group) {
+  const int64_t numel = group->all_length_;
+  switch (comm_hook_.type) {
+    case CommHookType::kFP16:
+    case CommHookType::kBF16:
+      group->dense_contents_ =
+          paddle::experimental::cast(group->comm_contents_, group->dtype_);
+      break;
+    case CommHookType::kTopK: {
+      // indices picked by several ranks are accumulated
+      Tensor zeros = paddle::experimental::full(
+          IntArray({numel}), 0, group->dtype_, inner_place_);
+      group->dense_contents_ = paddle::experimental::index_add(
+          zeros, group->comm_indices_, group->comm_contents_, 0);
+      break;
+    }
+    case CommHookType::kPowerSGD: {
+      Tensor approx = paddle::experimental::matmul(
+          group->power_sgd_p_, group->power_sgd_q_, false, true);
+      Tensor flat =
+          paddle::experimental::reshape(approx, IntArray({approx.numel()}));
+      if (flat.numel() != numel) {
+        flat = paddle::experimental::slice(
+            flat, {0}, IntArray({0}), IntArray({numel}), {1}, {});
+      }
+      group->dense_contents_ = flat;
+      break;
+    }
+    default:
+      break;
+  }
+  group->comm_contents_.reset();
+  group->comm_indices_.reset();
+  group->comm_indices_task_.reset();
+  group->comm_hook_pending_ = false;
+}
+
 void EagerReducer::AllReduceSparse(EagerGroup *group,
                                    const int curr_group_index) {
   // div nranks
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <vector>
 
@@ -44,6 +45,37 @@ std::vector<std::vector<size_t>> Eager_AssignGroupBySize(
     const std::vector<size_t> &group_size_limits,
     const std::vector<int64_t> &tensor_indices = {});
 
+// Communication hooks applied to a fused dense bucket before it is sent.
+// kNone keeps the full precision allreduce.
+enum class CommHookType {
+  kNone = 0,
+  // cast the bucket to float16/bfloat16 for the allreduce
+  kFP16,
+  kBF16,
+  // rank-r PowerSGD approximation of the bucket with error feedback
+  kPowerSGD,
+  // all-gather the top-k elements of the bucket with error feedback
+  kTopK,
+};
+
+struct CommHookOptions {
+  CommHookType type = CommHookType::kNone;
+  // rank of the low-rank approximation used by kPowerSGD
+  int64_t power_sgd_rank = 2;
+  // fraction of the bucket elements sent by kTopK
+  double topk_ratio = 0.01;
+};
+
+struct EagerGroupCommStats {
+  int64_t steps = 0;
+  // bytes this rank put on the wire for the bucket
+  int64_t last_bytes = 0;
+  int64_t total_bytes = 0;
+  // time from the bucket being ready to it being reduced and split
+  double last_time_us = 0.0;
+  double total_time_us = 0.0;
+};
+
 class EagerGroup {
  public:
   Tensor dense_contents_;
@@ -69,6 +101,23 @@ class EagerGroup {
   // help to sync
   std::shared_ptr<ProcessGroup::Task> task;
 
+  // state of the communication hook, see CommHookType
+  bool comm_hook_pending_ = false;
+  Tensor comm_contents_;
+  Tensor comm_indices_;
+  // the all-gather of comm_indices_, waited with task
+  std::shared_ptr<ProcessGroup::Task> comm_indices_task_;
+  Tensor error_feedback_;
+  Tensor power_sgd_p_;
+  Tensor power_sgd_q_;
+
+  EagerGroupCommStats comm_stats_;
+  std::chrono::steady_clock::time_point comm_start_;
+
+  // the flat buffer of the group in the bucket view mode, which the dense
+  // grads of the group and dense_tensors_ are views of
+  Tensor bucket_view_contents_;
+
   // context is used to select the stream for concat
   void ConcatTensors(const phi::Place &);
 
@@ -113,7 +162,26 @@ class EagerReducer {
   void ProcessUnusedDenseVars();
   bool HasGrad(size_t var_index);
 
+  void SetCommHook(const CommHookOptions &options);
+  std::vector<EagerGroupCommStats> GetCommStats() const;
+
+  // Make the dense grads of the parameters views of the flat buffers of
+  // their groups, so the buffers are allreduced in place, without the
+  // concat before and the split after. A grad becomes a view once it is
+  // ready in a backward pass.
+  void SetGradAsBucketView(bool enable);
+
  private:
+  bool CompressedAllReduceSchedule(EagerGroup *group,
+                                   const int curr_group_index);
+  void DecompressGroup(EagerGroup *group);
+  void UpdateCommStats(EagerGroup *group);
+  void BindGradToBucketView(size_t var_index, bool copy_grad);
+  std::shared_ptr<ProcessGroup::Task> AllGatherTensor(const Tensor &in,
+                                                      Tensor *out);
+  std::shared_ptr<ProcessGroup::Task> AllReduceTensor(Tensor *in_out);
+  void AllReduceOnCalcStream(Tensor *in_out);
+
   std::vector<Tensor> tensors_;
   std::vector<std::vector<size_t>> group_indices_;
   std::vector<bool> is_sparse_gradient_;
@@ -139,6 +207,9 @@ class EagerReducer {
   bool find_unused_vars_once_{true};
   bool groups_need_finalize_{false};
   Tensor global_used_vars_;
+
+  CommHookOptions comm_hook_;
+  bool grad_as_bucket_view_{false};
 };
 
 }  //  namespace distributed
@@ -85,13 +85,20 @@ class FsWriteChannel {
 
   int open(std::shared_ptr<FILE> fp, const FsChannelConfig& config UNUSED) {
     _file = fp;
-
-    // the buffer has set in fs.cc
-    // if (_buffer_size != 0) {
-    //    _buffer = std::shared_ptr<char>(new char[_buffer_size]);
-
-    //    CHECK(0 == setvbuf(&*_file, _buffer.get(), _IOFBF, _buffer_size));
-    //}
+    // fs.cc sets a buffer only for some file systems, e.g. not for the local
+    // one, a large one makes the writes sequential and fewer
+    if (_file != nullptr && _buffer_size != 0) {
+      char* buffer = new char[_buffer_size];
+      if (setvbuf(_file.get(), buffer, _IOFBF, _buffer_size) != 0) {
+        delete[] buffer;
+        return 0;
+      }
+      // the buffer is freed after the file is closed
+      _file = {fp.get(), [fp, buffer](FILE*) mutable {  // NOLINT
+                 fp = nullptr;
+                 delete[] buffer;
+               }};
+    }
     return 0;
   }
 
@@ -130,7 +137,6 @@ class FsWriteChannel {
   uint32_t _buffer_size;
   FsChannelConfig _config;
   std::shared_ptr<FILE> _file;
-  std::shared_ptr<char> _buffer;
 };
 
 class AfsClient {
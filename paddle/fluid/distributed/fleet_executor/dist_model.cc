@@ -16,7 +16,9 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <chrono>  // NOLINT
+#include <cstring>
 
 #include "paddle/fluid/distributed/fleet_executor/fleet_executor.h"
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
@@ -184,6 +186,12 @@ bool DistModel::Init() {
             "Scope must be provided to dist model inference if "
             "program desc has been provided."));
   }
+  PADDLE_ENFORCE_GE(config_.num_micro_batches,
+                    1,
+                    common::errors::InvalidArgument(
+                        "The num_micro_batches of dist model inference "
+                        "should be at least 1, but got %d.",
+                        config_.num_micro_batches));
   if (!PreparePlace()) {
     return false;
   }
@@ -480,6 +488,7 @@ bool DistModel::PrepareFleetExe() {
   // With auto cut, there is no concept of pp, no need to add dependency.
   task_node_->SetType("Compute");
   task_node_->Init();
+  task_node_->SetMaxRunTimes(config_.num_micro_batches);
   executor_desc_ = FleetExecutorDesc();
   executor_desc_.set_cur_rank(config_.local_rank);
   std::unordered_map<int64_t, int64_t> id_to_rank;
@@ -494,14 +503,27 @@ bool DistModel::PrepareFleetExe() {
     }
     id_to_rank.insert({i, i});
   }
+  if (config_.num_micro_batches > 1) {
+    // Each micro-batch runs in its own scope with its own feed and fetch
+    // lists, the parameters are shared from the root scope.
+    micro_scopes_.resize(config_.num_micro_batches);
+    micro_feed_tensors_.resize(config_.num_micro_batches);
+    for (auto *&micro_scope : micro_scopes_) {
+      micro_scope = &scope_->NewScope();
+      micro_scope->Var("feed")->GetMutable<framework::FeedList>();
+      micro_scope->Var("fetch")->GetMutable<framework::FetchList>();
+    }
+  }
   fleet_exe = std::make_unique<FleetExecutor>(executor_desc_);
   fleet_exe->Init(carrier_id_,
                   *(program_.get()),
                   scope_.get(),
                   place_,
-                  1,
+                  config_.num_micro_batches,
                   {task_node_.get()},
-                  id_to_rank);
+                  id_to_rank,
+                  {},
+                  micro_scopes_);
   return true;
 }
 
@@ -560,17 +582,18 @@ bool DistModel::PrepareFeedAndFetch() {
 }
 
 bool DistModel::FeedData(const std::vector<DistModelTensor> &input_data,
-                         framework::Scope *scope) {
+                         framework::Scope *scope,
+                         std::vector<phi::DenseTensor> *feed_tensors) {
   VLOG(3) << "DistModel is feeding data.";
   if (input_data.size() != feeds_.size()) {
     LOG(ERROR) << "Should provide " << feeds_.size() << " feeds, but got "
                << input_data.size() << " data.";
     return false;
   }
-  feed_tensors_.resize(feeds_.size());
+  feed_tensors->resize(feeds_.size());
   for (size_t i = 0; i < input_data.size(); ++i) {
     // feed each data separately
-    phi::DenseTensor *input_tensor = &(feed_tensors_[i]);
+    phi::DenseTensor *input_tensor = &(feed_tensors->at(i));
     if (!LoadDataFromDistModelTensor(input_data[i], input_tensor, place_)) {
       LOG(ERROR) << "Fail to load data from tensor " << input_data[i].name;
       return false;
@@ -641,6 +664,95 @@ bool DistModel::FetchResults(std::vector<DistModelTensor> *output_data,
   return true;
 }
 
+bool DistModel::FeedMicroBatches(
+    const std::vector<DistModelTensor> &input_data) {
+  VLOG(3) << "DistModel is feeding " << config_.num_micro_batches
+          << " micro-batches.";
+  const int64_t num = config_.num_micro_batches;
+  std::vector<std::vector<DistModelTensor>> micro_inputs(
+      num, std::vector<DistModelTensor>(input_data.size()));
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    const DistModelTensor &input = input_data[i];
+    if (input.shape.empty() || input.shape[0] % num != 0 ||
+        !input.lod.empty()) {
+      LOG(ERROR) << "DistModel splits the inputs into " << num
+                 << " micro-batches along the first dim, but the input ["
+                 << input.name << "] can not be split evenly.";
+      return false;
+    }
+    // The micro-batches are views of the input, not copies.
+    const size_t micro_length = input.data.length() / num;
+    for (int64_t j = 0; j < num; ++j) {
+      DistModelTensor &micro = micro_inputs[j][i];
+      micro.name = input.name;
+      micro.dtype = input.dtype;
+      micro.shape = input.shape;
+      micro.shape[0] /= static_cast<int>(num);
+      micro.data.Reset(
+          static_cast<char *>(input.data.data()) + j * micro_length,
+          micro_length);
+    }
+  }
+  // The micro-batches are copied from the (pageable) host memory of the
+  // inputs before the carrier starts.
+  for (int64_t j = 0; j < num; ++j) {
+    if (!FeedData(micro_inputs[j], micro_scopes_[j], &micro_feed_tensors_[j])) {
+      LOG(ERROR) << "DistModel fails to feed micro-batch " << j;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DistModel::FetchMicroBatches(std::vector<DistModelTensor> *output_data) {
+  VLOG(3) << "DistModel is fetching results of " << config_.num_micro_batches
+          << " micro-batches.";
+  std::vector<std::vector<DistModelTensor>> micro_outputs(
+      config_.num_micro_batches);
+  for (size_t j = 0; j < micro_outputs.size(); ++j) {
+    if (!FetchResults(&micro_outputs[j], micro_scopes_[j])) {
+      LOG(ERROR) << "DistModel fails to fetch micro-batch " << j;
+      return false;
+    }
+  }
+  // Concat the results of the micro-batches along the first dim.
+  output_data->resize(fetches_.size());
+  for (size_t i = 0; i < fetches_.size(); ++i) {
+    const DistModelTensor &first = micro_outputs[0][i];
+    int rows = 0;
+    size_t length = 0;
+    for (const auto &micro_output : micro_outputs) {
+      const DistModelTensor &result = micro_output[i];
+      if (result.shape.empty() || result.shape.size() != first.shape.size() ||
+          !std::equal(result.shape.begin() + 1,
+                      result.shape.end(),
+                      first.shape.begin() + 1) ||
+          !result.lod.empty()) {
+        LOG(ERROR) << "DistModel can not concat the results of the "
+                      "micro-batches for fetch var ["
+                   << first.name << "].";
+        return false;
+      }
+      rows += result.shape[0];
+      length += result.data.length();
+    }
+    auto output = &(output_data->at(i));
+    output->name = first.name;
+    output->dtype = first.dtype;
+    output->shape = first.shape;
+    output->shape[0] = rows;
+    output->lod.clear();
+    output->data.Resize(length);
+    char *dst = static_cast<char *>(output->data.data());
+    for (const auto &micro_output : micro_outputs) {
+      const DistModelTensor &result = micro_output[i];
+      memcpy(dst, result.data.data(), result.data.length());
+      dst += result.data.length();
+    }
+  }
+  return true;
+}
+
 template <typename T>
 bool DistModel::FetchResult(const phi::DenseTensor &fetch,
                             DistModelTensor *output_data) {
@@ -668,7 +780,10 @@ bool DistModel::Run(const std::vector<DistModelTensor> &input_data,
   double fleet_exe_elapse = 0;
   double fetch_elapse = 0;
 
-  if (!FeedData(input_data, scope_.get())) {
+  bool fed = config_.num_micro_batches > 1
+                 ? FeedMicroBatches(input_data)
+                 : FeedData(input_data, scope_.get(), &feed_tensors_);
+  if (!fed) {
     LOG(ERROR) << "DistModel failed at feeding data.";
     return false;
   }
@@ -688,7 +803,10 @@ bool DistModel::Run(const std::vector<DistModelTensor> &input_data,
     VLOG(3) << "Finish FleetExe running.";
   }
 
-  if (!FetchResults(output_data, scope_.get())) {
+  bool fetched = config_.num_micro_batches > 1
+                     ? FetchMicroBatches(output_data)
+                     : FetchResults(output_data, scope_.get());
+  if (!fetched) {
     LOG(ERROR) << "DistModel failed at fetching result.";
     return false;
   }
@@ -50,6 +50,9 @@ struct DistModelConfig {
   int64_t nranks{1};
   int64_t local_rank{0};
   bool enable_timer{false};
+  // The inputs are split along the first dim into micro-batches, which the
+  // compute task node of the rank runs one after another in one run.
+  int64_t num_micro_batches{1};
   std::map<int64_t, std::vector<int64_t>> ring_id_to_ranks_{};
   std::map<int64_t, std::vector<int64_t>> rank_to_ring_ids_{};
 };
@@ -80,14 +83,19 @@ class DistModel {
                     framework::BlockDesc* block,
                     int ring_id);
   bool FeedData(const std::vector<DistModelTensor>& input_data,
-                framework::Scope* scope);
+                framework::Scope* scope,
+                std::vector<phi::DenseTensor>* feed_tensors);
   bool FetchResults(std::vector<DistModelTensor>* output_data,
                     framework::Scope* scope);
+  bool FeedMicroBatches(const std::vector<DistModelTensor>& input_data);
+  bool FetchMicroBatches(std::vector<DistModelTensor>* output_data);
   template <typename T>
   bool FetchResult(const phi::DenseTensor& fetch, DistModelTensor* output_data);
 
   std::string carrier_id_;
   std::vector<phi::DenseTensor> feed_tensors_;
+  std::vector<framework::Scope*> micro_scopes_;
+  std::vector<std::vector<phi::DenseTensor>> micro_feed_tensors_;
   std::vector<framework::OpDesc*> feeds_;
   std::map<std::string, int64_t> feed_names_;
   std::map<int64_t, std::string> idx_to_feeds_;
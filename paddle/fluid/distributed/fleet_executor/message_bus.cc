@@ -19,12 +19,41 @@
 #include <set>
 #include <thread>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/fleet_executor/carrier.h"
 #include "paddle/fluid/distributed/fleet_executor/global.h"
 #include "paddle/fluid/platform/gen_comm_id_helper.h"
 
+COMMON_DECLARE_bool(fleet_executor_shm_transport);
+
 namespace paddle::distributed {
 
+#if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+namespace {
+
+// larger messages, e.g. the ones carrying variables, are split
+constexpr size_t kShmInboxCapacity = 4 << 20;
+// polls of an empty inbox before the reader starts to sleep
+constexpr int kShmSpinCount = 1000;
+
+std::string GetHost(const std::string& addr) {
+  return addr.substr(0, addr.rfind(':'));
+}
+
+// the address is unique among the ranks running on one host
+std::string GetShmInboxName(const std::string& addr) {
+  std::string name = "/paddle_fleet_executor_" + addr;
+  for (size_t i = 1; i < name.size(); ++i) {
+    if (name[i] == ':' || name[i] == '.' || name[i] == '/') {
+      name[i] = '_';
+    }
+  }
+  return name;
+}
+
+}  // namespace
+#endif
+
 void MessageBus::Init(
     int64_t rank,
     const std::unordered_map<int64_t, std::string>& rank_to_addr,
@@ -66,6 +95,9 @@ void MessageBus::Init(
 #endif
 
   ListenPort();
+#if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+  ListenShm();
+#endif
 }
 
 bool MessageBus::IsInit() const { return is_init_; }
@@ -73,6 +105,10 @@ bool MessageBus::IsInit() const { return is_init_; }
 MessageBus::~MessageBus() {
   VLOG(3) << "Message bus releases resource.";
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+  if (shm_thread_.joinable()) {
+    shm_stop_ = true;
+    shm_thread_.join();
+  }
   server_.Stop(1000);
   server_.Join();
 #endif
@@ -94,6 +130,10 @@ bool MessageBus::Send(int64_t dst_rank,
       common::errors::PreconditionNotMet(
           "Using message bus since it has not been initialized."));
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+  if (same_host_ranks_.count(dst_rank) > 0 &&
+      SendIntraHost(dst_rank, interceptor_message)) {
+    return true;
+  }
   int retry_time = 0;  // message bus will retry sending for 10 times
   while (retry_time < 10) {
     ++retry_time;
@@ -207,6 +247,105 @@ void MessageBus::ListenPort() {
 }
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+void MessageBus::ListenShm() {
+  if (addr_.empty() || !FLAGS_fleet_executor_shm_transport) {
+    return;
+  }
+  const std::string host = GetHost(addr_);
+  for (const auto& item : rank_to_addr_) {
+    if (item.first != rank_ && GetHost(item.second) == host) {
+      same_host_ranks_.insert(item.first);
+    }
+  }
+  if (same_host_ranks_.empty()) {
+    return;
+  }
+  shm_inbox_ =
+      ShmRingBuffer::Create(GetShmInboxName(addr_), kShmInboxCapacity);
+  shm_thread_ = std::thread([this] { HandleShmMessages(); });
+  LOG(INFO) << "Message bus talks to " << same_host_ranks_.size()
+            << " ranks on the same host through shared memory.";
+}
+
+void MessageBus::HandleShmMessages() {
+  std::string data;
+  int idle = 0;
+  while (!shm_stop_) {
+    if (!shm_inbox_->Pop(&data)) {
+      if (++idle < kShmSpinCount) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+      continue;
+    }
+    idle = 0;
+    InterceptorMessage interceptor_message;
+    if (!interceptor_message.ParseFromString(data)) {
+      LOG(ERROR) << "Message bus: failed to parse a message of "
+                 << data.size() << " bytes from the shared memory.";
+      continue;
+    }
+    VLOG(3) << "Message bus receives a message from "
+            << interceptor_message.src_id() << " to "
+            << interceptor_message.dst_id() << " through shared memory.";
+    try {
+      if (interceptor_message.ctrl_message()) {
+        IncreaseBarrierCount();
+      } else {
+        DispatchMsgToCarrier(interceptor_message);
+      }
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Message bus: failed to dispatch a message from the "
+                    "shared memory: "
+                 << e.what();
+    }
+  }
+}
+
+bool MessageBus::SendIntraHost(int64_t dst_rank,
+                               const InterceptorMessage& interceptor_message) {
+  ShmRingBuffer* outbox = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(shm_mutex_);
+    auto& ring = shm_outboxes_[dst_rank];
+    if (ring == nullptr) {
+      ring = ShmRingBuffer::Open(GetShmInboxName(GetAddr(dst_rank)));
+      if (ring == nullptr) {
+        VLOG(3) << "The shared memory inbox of rank " << dst_rank
+                << " is not created yet.";
+        return false;
+      }
+    }
+    outbox = ring.get();
+  }
+  std::string data;
+  interceptor_message.SerializeToString(&data);
+  // once the messages go through shared memory, they keep doing so to stay
+  // in order
+  constexpr int kMaxPushRetries = 30;
+  for (int retry = 0; !outbox->Push(data, /*timeout_ms=*/10000); ++retry) {
+    PADDLE_ENFORCE_EQ(
+        outbox->ReaderAlive(),
+        true,
+        common::errors::Unavailable(
+            "Message bus: rank %d owning the shared memory inbox %s is gone.",
+            dst_rank,
+            outbox->name()));
+    PADDLE_ENFORCE_LT(
+        retry,
+        kMaxPushRetries,
+        common::errors::ResourceExhausted(
+            "Message bus: the shared memory inbox of rank %d is full for "
+            "%d seconds.",
+            dst_rank,
+            (kMaxPushRetries + 1) * 10));
+    LOG(WARNING) << "Message bus: the shared memory inbox of rank "
+                 << dst_rank << " is full for 10 seconds.";
+  }
+  return true;
+}
+
 bool MessageBus::SendInterRank(int64_t dst_rank,
                                const InterceptorMessage& interceptor_message) {
   const auto& dst_addr = GetAddr(dst_rank);
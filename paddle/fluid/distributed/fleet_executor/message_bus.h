@@ -14,16 +14,20 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
 #include "brpc/channel.h"
 #include "brpc/server.h"
 #include "paddle/fluid/distributed/fleet_executor/message_service.h"
+#include "paddle/fluid/distributed/fleet_executor/shm_ring_buffer.h"
 #endif
 
 #include "paddle/common/errors.h"
@@ -67,6 +71,17 @@ class MessageBus final {
   // send the message inter rank (dst is different rank with src)
   bool SendInterRank(int64_t dst_rank,
                      const InterceptorMessage& interceptor_message);
+
+  // Creates the shared memory inbox of this rank if other ranks run on the
+  // same host, and starts the thread reading it.
+  void ListenShm();
+
+  // send the message to a rank on the same host through its shared memory
+  // inbox, returns false if the inbox is not created yet
+  bool SendIntraHost(int64_t dst_rank,
+                     const InterceptorMessage& interceptor_message);
+
+  void HandleShmMessages();
 #endif
 
   bool is_init_{false};
@@ -83,6 +98,15 @@ class MessageBus final {
   MessageServiceImpl message_service_;
   // brpc server
   brpc::Server server_;
+
+  // the ranks on the same host as this one, talked to through shared memory
+  std::unordered_set<int64_t> same_host_ranks_;
+  std::unique_ptr<ShmRingBuffer> shm_inbox_;
+  std::thread shm_thread_;
+  std::atomic<bool> shm_stop_{false};
+  // the inboxes of the ranks on the same host
+  std::mutex shm_mutex_;
+  std::unordered_map<int64_t, std::unique_ptr<ShmRingBuffer>> shm_outboxes_;
 #endif
 
   // for barrier
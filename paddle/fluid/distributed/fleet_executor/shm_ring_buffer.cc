@@ -0,0 +1,301 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if !defined(_WIN32)
+
+#include "paddle/fluid/distributed/fleet_executor/shm_ring_buffer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/common/errors.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+constexpr uint64_t kShmRingMagic = 0x70646c5f72696e67;  // "pdl_ring"
+
+// the size of the fragment, the top bit tells if more fragments follow
+using FragmentHeader = uint32_t;
+constexpr FragmentHeader kMoreFragments = FragmentHeader{1} << 31;
+// set on the first fragment written after a writer died in the middle of a
+// message, the reader drops the fragments of that message
+constexpr FragmentHeader kDropPending = FragmentHeader{1} << 30;
+constexpr FragmentHeader kFragmentSizeMask = kDropPending - 1;
+
+// the spins between the checks of the process holding the lock
+constexpr int kSpinsPerCheck = 1024;
+
+bool ProcessAlive(pid_t pid) { return kill(pid, 0) == 0 || errno != ESRCH; }
+
+}  // namespace
+
+struct ShmRingBuffer::Header {
+  // set last by the creator, the ring is usable once it is seen
+  std::atomic<uint64_t> magic;
+  uint64_t capacity;
+  // the reader, the ring left by a dead one is not opened
+  pid_t pid;
+  // the writer holding the lock, 0 if none
+  std::atomic<pid_t> lock;
+  // whether a writer died in the middle of a message, under the lock
+  bool broken;
+  // positions keep growing, they are taken modulo the capacity
+  alignas(64) std::atomic<uint64_t> head;
+  alignas(64) std::atomic<uint64_t> tail;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<pid_t>::is_always_lock_free,
+              "The atomics shared between processes must be lock free.");
+
+std::unique_ptr<ShmRingBuffer> ShmRingBuffer::Create(const std::string& name,
+                                                     size_t capacity) {
+  PADDLE_ENFORCE_GE(capacity,
+                    64,
+                    common::errors::InvalidArgument(
+                        "The capacity of the shared memory ring must be at "
+                        "least 64 bytes, but got %d.",
+                        capacity));
+  PADDLE_ENFORCE_LE(capacity / 4,
+                    kFragmentSizeMask,
+                    common::errors::InvalidArgument(
+                        "The capacity of the shared memory ring must be at "
+                        "most 4 GiB, but got %d.",
+                        capacity));
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  PADDLE_ENFORCE_NE(fd,
+                    -1,
+                    common::errors::Unavailable(
+                        "Failed to create the shared memory %s: %s.",
+                        name,
+                        std::strerror(errno)));
+  size_t size = sizeof(Header) + capacity;
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    int err = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    PADDLE_THROW(common::errors::Unavailable(
+        "Failed to resize the shared memory %s: %s.",
+        name,
+        std::strerror(err)));
+  }
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    int err = errno;
+    shm_unlink(name.c_str());
+    PADDLE_THROW(common::errors::Unavailable(
+        "Failed to map the shared memory %s: %s.", name, std::strerror(err)));
+  }
+  auto* header = new (addr) Header();
+  header->capacity = capacity;
+  header->pid = getpid();
+  header->lock.store(0);
+  header->broken = false;
+  header->head.store(0);
+  header->tail.store(0);
+  header->magic.store(kShmRingMagic, std::memory_order_release);
+  return std::unique_ptr<ShmRingBuffer>(
+      new ShmRingBuffer(name, addr, size, /*owner=*/true));
+}
+
+std::unique_ptr<ShmRingBuffer> ShmRingBuffer::Open(const std::string& name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd == -1) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) <= sizeof(Header)) {
+    // not resized by the creator yet
+    close(fd);
+    return nullptr;
+  }
+  size_t size = st.st_size;
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return nullptr;
+  }
+  auto* header = static_cast<Header*>(addr);
+  if (header->magic.load(std::memory_order_acquire) != kShmRingMagic ||
+      sizeof(Header) + header->capacity != size ||
+      !ProcessAlive(header->pid)) {
+    munmap(addr, size);
+    return nullptr;
+  }
+  return std::unique_ptr<ShmRingBuffer>(
+      new ShmRingBuffer(name, addr, size, /*owner=*/false));
+}
+
+ShmRingBuffer::ShmRingBuffer(std::string name,
+                             void* addr,
+                             size_t size,
+                             bool owner)
+    : name_(std::move(name)),
+      addr_(addr),
+      size_(size),
+      owner_(owner),
+      header_(static_cast<Header*>(addr)),
+      data_(static_cast<char*>(addr) + sizeof(Header)) {}
+
+ShmRingBuffer::~ShmRingBuffer() {
+  munmap(addr_, size_);
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+void ShmRingBuffer::CopyIn(size_t pos, const char* src, size_t len) {
+  size_t capacity = header_->capacity;
+  size_t offset = pos % capacity;
+  size_t first = std::min(len, capacity - offset);
+  std::memcpy(data_ + offset, src, first);
+  std::memcpy(data_, src + first, len - first);
+}
+
+void ShmRingBuffer::CopyOut(size_t pos, char* dst, size_t len) const {
+  size_t capacity = header_->capacity;
+  size_t offset = pos % capacity;
+  size_t first = std::min(len, capacity - offset);
+  std::memcpy(dst, data_ + offset, first);
+  std::memcpy(dst + first, data_, len - first);
+}
+
+bool ShmRingBuffer::ReaderAlive() const { return ProcessAlive(header_->pid); }
+
+bool ShmRingBuffer::Lock(std::chrono::steady_clock::time_point deadline) {
+  pid_t self = getpid();
+  pid_t owner = 0;
+  for (int spins = 1; !header_->lock.compare_exchange_weak(
+           owner, self, std::memory_order_acquire);
+       ++spins) {
+    if (owner != 0 && spins % kSpinsPerCheck == 0 && !ProcessAlive(owner) &&
+        header_->lock.compare_exchange_strong(
+            owner, self, std::memory_order_acquire)) {
+      // the fragments it has written are dropped by the reader
+      LOG(WARNING) << "Process " << owner << " died holding the lock of "
+                   << name_ << ", taking it over.";
+      header_->broken = true;
+      return true;
+    }
+    owner = 0;
+    if (std::chrono::steady_clock::now() > deadline) {
+      VLOG(3) << "Timeout to lock " << name_;
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+bool ShmRingBuffer::Push(const std::string& data, int64_t timeout_ms) {
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  if (!Lock(deadline)) {
+    return false;
+  }
+
+  // A message larger than a fragment is split, the lock is held until the
+  // last fragment is written so that the fragments stay together.
+  size_t max_fragment_size = header_->capacity / 4 - sizeof(FragmentHeader);
+  size_t offset = 0;
+  do {
+    size_t fragment_size = std::min(data.size() - offset, max_fragment_size);
+    size_t len = sizeof(FragmentHeader) + fragment_size;
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    for (int spins = 1;
+         header_->capacity -
+             (head - header_->tail.load(std::memory_order_acquire)) <
+         len;
+         ++spins) {
+      // the first fragment gives up in time, the others have to follow it
+      // unless the reader is gone
+      if ((offset == 0 && std::chrono::steady_clock::now() > deadline) ||
+          (spins % kSpinsPerCheck == 0 && !ReaderAlive())) {
+        header_->lock.store(0, std::memory_order_release);
+        VLOG(3) << "Failed to push " << data.size() << " bytes to "
+                << name_;
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    FragmentHeader fragment = static_cast<FragmentHeader>(fragment_size);
+    if (offset + fragment_size < data.size()) {
+      fragment |= kMoreFragments;
+    }
+    if (offset == 0 && header_->broken) {
+      fragment |= kDropPending;
+      header_->broken = false;
+    }
+    CopyIn(head, reinterpret_cast<const char*>(&fragment), sizeof(fragment));
+    CopyIn(head + sizeof(fragment), data.data() + offset, fragment_size);
+    header_->head.store(head + len, std::memory_order_release);
+    offset += fragment_size;
+  } while (offset < data.size());
+  header_->lock.store(0, std::memory_order_release);
+  return true;
+}
+
+bool ShmRingBuffer::Pop(std::string* data) {
+  while (true) {
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    if (head == tail) {
+      // the rest of a message may still be written
+      return false;
+    }
+    FragmentHeader fragment = 0;
+    CopyOut(tail, reinterpret_cast<char*>(&fragment), sizeof(fragment));
+    if ((fragment & kDropPending) != 0) {
+      LOG(WARNING) << "Drop the " << pending_.size()
+                   << " bytes left by a dead writer of " << name_;
+      pending_.clear();
+    }
+    size_t fragment_size = fragment & kFragmentSizeMask;
+    size_t offset = pending_.size();
+    pending_.resize(offset + fragment_size);
+    CopyOut(tail + sizeof(fragment), &pending_[offset], fragment_size);
+    header_->tail.store(tail + sizeof(fragment) + fragment_size,
+                        std::memory_order_release);
+    if ((fragment & kMoreFragments) == 0) {
+      data->swap(pending_);
+      pending_.clear();
+      return true;
+    }
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
+
+#endif
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if !defined(_WIN32)
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "paddle/common/macros.h"
+
+namespace paddle {
+namespace distributed {
+
+// A ring buffer of length prefixed messages in POSIX shared memory, written
+// by any process of the host and read by the one that created it. The
+// writers are serialized by a spin lock in the shared memory, the reader
+// needs no lock. The lock held by a dead writer is taken over by the next
+// one, and the part of a message it has written is dropped by the reader.
+class ShmRingBuffer final {
+ public:
+  // Creates the ring named `name`, replacing the one left by a previous job
+  // of the same name. The ring is unlinked when the returned object is gone.
+  static std::unique_ptr<ShmRingBuffer> Create(const std::string& name,
+                                               size_t capacity);
+
+  // Opens the ring named `name`, returns nullptr if it is not created yet.
+  static std::unique_ptr<ShmRingBuffer> Open(const std::string& name);
+
+  ~ShmRingBuffer();
+
+  // Appends `data` to the ring, waits up to `timeout_ms` for the other
+  // writers and the reader to make room. Returns false if it times out. A
+  // message too large for the ring is written in fragments, once the first
+  // one is written the others wait as long as the reader is alive.
+  bool Push(const std::string& data, int64_t timeout_ms);
+
+  // Takes the oldest message of the ring, returns false if there is no
+  // complete one.
+  bool Pop(std::string* data);
+
+  // Whether the process that created the ring is still alive.
+  bool ReaderAlive() const;
+
+  const std::string& name() const { return name_; }
+
+ private:
+  struct Header;
+
+  ShmRingBuffer(std::string name, void* addr, size_t size, bool owner);
+
+  bool Lock(std::chrono::steady_clock::time_point deadline);
+
+  void CopyIn(size_t pos, const char* src, size_t len);
+  void CopyOut(size_t pos, char* dst, size_t len) const;
+
+  DISABLE_COPY_AND_ASSIGN(ShmRingBuffer);
+
+  std::string name_;
+  void* addr_;
+  size_t size_;
+  bool owner_;
+  Header* header_;
+  char* data_;
+  // the fragments of the message being read
+  std::string pending_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
+
+#endif
@@ -99,6 +99,7 @@ class TaskNode final {
   void SetReplyUpPerSteps(int64_t value);
   void SetSendDownPerSteps(int64_t value);
   void SetType(const std::string& type) { type_ = type; }
+  void SetMaxRunTimes(int64_t value) { max_run_times_ = value; }
   void SetUnusedVars(
       const std::unordered_map<const OperatorBase*, std::vector<std::string>>&
           unused_vars) {
@@ -0,0 +1,155 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/fleet_executor/shm_ring_buffer.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+static std::string RingName(const std::string& test) {
+  return "/pd_shm_ring_test_" + test + "_" + std::to_string(getpid());
+}
+
+static std::string MakeMessage(size_t size, char seed) {
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<char>(seed + i % 61);
+  }
+  return data;
+}
+
+// Pops until a message is complete, the writer may still be writing it.
+static std::string PopMessage(ShmRingBuffer* ring) {
+  std::string data;
+  while (!ring->Pop(&data)) {
+    std::this_thread::yield();
+  }
+  return data;
+}
+
+TEST(ShmRingBuffer, wraparound) {
+  auto ring = ShmRingBuffer::Create(RingName("wraparound"), 64);
+  ASSERT_NE(ring, nullptr);
+  auto writer = ShmRingBuffer::Open(ring->name());
+  ASSERT_NE(writer, nullptr);
+  std::string data;
+  EXPECT_FALSE(ring->Pop(&data));
+  // the lengths do not divide the capacity, so the messages and their
+  // headers are split at the end of the ring
+  for (int i = 0; i < 100; ++i) {
+    std::string message = MakeMessage(i % 13, static_cast<char>('a' + i % 7));
+    ASSERT_TRUE(writer->Push(message, 1000));
+    ASSERT_TRUE(ring->Pop(&data));
+    EXPECT_EQ(data, message);
+  }
+  EXPECT_FALSE(ring->Pop(&data));
+
+  // a full ring times out
+  ASSERT_TRUE(writer->Push(MakeMessage(12, 'x'), 0));
+  ASSERT_TRUE(writer->Push(MakeMessage(12, 'y'), 0));
+  ASSERT_TRUE(writer->Push(MakeMessage(12, 'z'), 0));
+  ASSERT_TRUE(writer->Push(MakeMessage(12, 'w'), 0));
+  EXPECT_FALSE(writer->Push(MakeMessage(12, 'v'), 0));
+  for (char seed : {'x', 'y', 'z', 'w'}) {
+    ASSERT_TRUE(ring->Pop(&data));
+    EXPECT_EQ(data, MakeMessage(12, seed));
+  }
+}
+
+TEST(ShmRingBuffer, fragmentation) {
+  auto ring = ShmRingBuffer::Create(RingName("fragmentation"), 256);
+  ASSERT_NE(ring, nullptr);
+  auto writer = ShmRingBuffer::Open(ring->name());
+  ASSERT_NE(writer, nullptr);
+  // several times the capacity, written while the fragments are read
+  std::string large = MakeMessage(2000, 'a');
+  std::string small = MakeMessage(10, 'b');
+  std::thread thread([&] {
+    EXPECT_TRUE(writer->Push(large, 1000));
+    EXPECT_TRUE(writer->Push(small, 1000));
+  });
+  EXPECT_EQ(PopMessage(ring.get()), large);
+  EXPECT_EQ(PopMessage(ring.get()), small);
+  thread.join();
+}
+
+TEST(ShmRingBuffer, open_ring_of_dead_process) {
+  std::string name = RingName("dead_reader");
+  pid_t child = fork();
+  ASSERT_NE(child, -1);
+  if (child == 0) {
+    // leaves the ring behind
+    auto ring = ShmRingBuffer::Create(name, 64);
+    _exit(ring == nullptr ? 1 : 0);
+  }
+  int status = 0;
+  ASSERT_EQ(waitpid(child, &status, 0), child);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_EQ(ShmRingBuffer::Open(name), nullptr);
+  shm_unlink(name.c_str());
+  EXPECT_EQ(ShmRingBuffer::Open(name), nullptr);
+
+  // a new job of the same name replaces it
+  auto ring = ShmRingBuffer::Create(name, 64);
+  ASSERT_NE(ring, nullptr);
+  auto writer = ShmRingBuffer::Open(name);
+  ASSERT_NE(writer, nullptr);
+  EXPECT_TRUE(writer->ReaderAlive());
+}
+
+TEST(ShmRingBuffer, writer_dies_holding_lock) {
+  auto ring = ShmRingBuffer::Create(RingName("dead_writer"), 256);
+  ASSERT_NE(ring, nullptr);
+  pid_t child = fork();
+  ASSERT_NE(child, -1);
+  if (child == 0) {
+    // fills the ring with the first fragments and waits for room holding
+    // the lock
+    auto writer = ShmRingBuffer::Open(ring->name());
+    if (writer != nullptr) {
+      writer->Push(MakeMessage(2000, 'a'), 1000);
+    }
+    _exit(0);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  kill(child, SIGKILL);
+  int status = 0;
+  ASSERT_EQ(waitpid(child, &status, 0), child);
+  ASSERT_TRUE(WIFSIGNALED(status));
+
+  auto writer = ShmRingBuffer::Open(ring->name());
+  ASSERT_NE(writer, nullptr);
+  std::string message = MakeMessage(100, 'b');
+  std::thread thread([&] { EXPECT_TRUE(writer->Push(message, 10000)); });
+  // the fragments of the dead writer are dropped
+  EXPECT_EQ(PopMessage(ring.get()), message);
+  thread.join();
+  std::string data;
+  EXPECT_FALSE(ring->Pop(&data));
+}
+
+}  // namespace distributed
+}  // namespace paddle
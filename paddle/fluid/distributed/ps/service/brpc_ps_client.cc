@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -82,6 +84,31 @@ PD_DEFINE_int32(pserver_sparse_table_shard_num,
                 1000,
                 "sparse table shard for save & load");
 
+PD_DEFINE_int32(pserver_hot_key_cache_size,
+                0,
+                "the max number of the hottest keys of a sparse table whose "
+                "pulled rows a client caches, 0 to disable the cache");
+
+PD_DEFINE_int32(pserver_hot_key_refresh_pulls,
+                8,
+                "the number of pulls after which a client picks the hot "
+                "keys again and refreshes their cached rows");
+
+PD_DEFINE_int32(pserver_sparse_cache_capacity,
+                0,
+                "the max number of the pulled rows of a sparse table a "
+                "client caches, 0 to disable the cache");
+
+PD_DEFINE_int32(pserver_sparse_cache_staleness,
+                4,
+                "the number of pulls of a sparse table by a client after "
+                "which a cached row is pulled again");
+
+// One in every so many keys of a pull is counted to find the hot keys.
+static constexpr size_t kHotKeySampleStride = 8;
+// The hit rate of a row cache is logged every so many pulls.
+static constexpr uint64_t kRowCacheLogPulls = 1000;
+
 inline size_t get_sparse_shard(uint32_t shard_num,
                                uint32_t server_num,
                                uint64_t key) {
@@ -91,6 +118,130 @@ inline size_t get_sparse_shard(uint32_t shard_num,
   return (key % shard_num) / local_shard_num;
 }
 
+bool SparseHotKeyCache::Lookup(const uint64_t *keys,
+                               size_t num,
+                               float **values,
+                               std::vector<bool> *cached,
+                               std::vector<uint64_t> *hot_keys) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (size_t i = 0; i < num; i += kHotKeySampleStride) {
+    ++_sampled_counts[keys[i]];
+  }
+  if (++_pull_num % _refresh_pulls == 0) {
+    std::vector<std::pair<uint32_t, uint64_t>> counts;
+    counts.reserve(_sampled_counts.size());
+    for (auto &item : _sampled_counts) {
+      // a key sampled once is not told apart from the cold ones
+      if (item.second > 1) {
+        counts.emplace_back(item.second, item.first);
+      }
+    }
+    if (counts.size() > _capacity) {
+      std::nth_element(counts.begin(),
+                       counts.begin() + _capacity,
+                       counts.end(),
+                       std::greater<std::pair<uint32_t, uint64_t>>());
+      counts.resize(_capacity);
+    }
+    hot_keys->clear();
+    for (auto &count : counts) {
+      hot_keys->push_back(count.second);
+    }
+    std::sort(hot_keys->begin(), hot_keys->end());
+    _sampled_counts.clear();
+    return true;
+  }
+  cached->assign(num, false);
+  if (_rows.empty()) {
+    return false;
+  }
+  for (size_t i = 0; i < num; ++i) {
+    auto it = _rows.find(keys[i]);
+    if (it != _rows.end()) {
+      memcpy(values[i], it->second.data(), _value_size);
+      (*cached)[i] = true;
+    }
+  }
+  return false;
+}
+
+void SparseHotKeyCache::Refresh(
+    const std::vector<std::pair<uint64_t, float *>> &rows) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _rows.clear();
+  for (auto &row : rows) {
+    const char *data = reinterpret_cast<const char *>(row.second);
+    _rows.emplace(row.first, std::vector<char>(data, data + _value_size));
+  }
+}
+
+size_t SparseHotKeyCache::Size() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _rows.size();
+}
+
+uint64_t SparseRowCache::Lookup(const uint64_t *keys,
+                                size_t num,
+                                float **values,
+                                std::vector<bool> *cached) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  const uint64_t pull_num = ++_pull_num;
+  if (cached->empty()) {
+    cached->assign(num, false);
+  }
+  for (size_t i = 0; i < num; ++i) {
+    if ((*cached)[i]) {
+      continue;
+    }
+    ++_lookup_num;
+    auto it = _rows.find(keys[i]);
+    if (it != _rows.end() && pull_num - it->second.pull_num <= _staleness) {
+      memcpy(values[i], it->second.data.data(), _value_size);
+      (*cached)[i] = true;
+      ++_hit_num;
+    }
+  }
+  return pull_num;
+}
+
+void SparseRowCache::Insert(
+    const std::vector<std::pair<uint64_t, float *>> &rows, uint64_t pull_num) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_rows.size() + rows.size() > _capacity) {
+    // drop the stale rows first, and all of them if it is not enough
+    for (auto it = _rows.begin(); it != _rows.end();) {
+      if (_pull_num - it->second.pull_num > _staleness) {
+        it = _rows.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (_rows.size() + rows.size() > _capacity) {
+      _rows.clear();
+    }
+  }
+  for (auto &row : rows) {
+    if (_rows.size() >= _capacity) {
+      break;
+    }
+    auto &cached = _rows[row.first];
+    // a row got by a later pull may be cached already
+    if (cached.data.empty() || cached.pull_num < pull_num) {
+      const char *data = reinterpret_cast<const char *>(row.second);
+      cached.pull_num = pull_num;
+      cached.data.assign(data, data + _value_size);
+    }
+  }
+}
+
+double SparseRowCache::HitRate() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  double rate = _lookup_num == 0 ? 0.0 : 1.0 * _hit_num / _lookup_num;
+  _lookup_num = 0;
+  _hit_num = 0;
+  return rate;
+}
+
 void DownpourPsClientService::service(
     ::google::protobuf::RpcController *controller,
     const PsRequestMessage *request,
@@ -299,6 +450,9 @@ int32_t BrpcPsClient::Initialize() {
   options.connection_type = "pooled";
   options.connect_timeout_ms = FLAGS_pserver_connect_timeout_ms;
   options.max_retry = 3;
+  if (EnableRdmaTransport(&options)) {
+    VLOG(0) << "BrpcPsClient connects to servers over rdma";
+  }
 
   std::ostringstream os;
   std::string server_ip_port;
@@ -345,6 +499,18 @@ int32_t BrpcPsClient::Initialize() {
       _push_sparse_task_queue_map[table_id] =
           ::paddle::framework::MakeChannel<SparseAsyncTask *>();
       _push_sparse_merge_count_map[table_id] = 0;
+      if (FLAGS_pserver_sparse_cache_capacity > 0) {
+        _row_caches[table_id] = std::make_unique<SparseRowCache>(
+            FLAGS_pserver_sparse_cache_capacity,
+            FLAGS_pserver_sparse_cache_staleness,
+            GetTableAccessor(table_id)->GetAccessorInfo().select_size);
+      }
+      if (FLAGS_pserver_hot_key_cache_size > 0) {
+        _hot_key_caches[table_id] = std::make_unique<SparseHotKeyCache>(
+            FLAGS_pserver_hot_key_cache_size,
+            FLAGS_pserver_hot_key_refresh_pulls,
+            GetTableAccessor(table_id)->GetAccessorInfo().select_size);
+      }
     }
   }
 
@@ -1160,7 +1326,46 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
     }
   }
 
+  // the cached hot rows are not pulled, and a refreshing pull caches the
+  // rows of the new hot keys once it gets them
+  SparseHotKeyCache *hot_key_cache = nullptr;
+  auto hot_key_it = _hot_key_caches.find(table_id);
+  if (hot_key_it != _hot_key_caches.end()) {
+    hot_key_cache = hot_key_it->second.get();
+  }
+  std::vector<bool> cached;
+  bool refresh = false;
+  auto hot_rows =
+      std::make_shared<std::vector<std::pair<uint64_t, float *>>>();
+  if (hot_key_cache != nullptr) {
+    std::vector<uint64_t> hot_keys;
+    refresh =
+        hot_key_cache->Lookup(keys, num, select_values, &cached, &hot_keys);
+    if (refresh) {
+      for (size_t i = 0; i < num; ++i) {
+        if (std::binary_search(hot_keys.begin(), hot_keys.end(), keys[i])) {
+          hot_rows->push_back({keys[i], select_values[i]});
+        }
+      }
+    }
+  }
+
+  SparseRowCache *row_cache = nullptr;
+  uint64_t pull_num = 0;
+  auto row_cache_it = _row_caches.find(table_id);
+  if (row_cache_it != _row_caches.end()) {
+    row_cache = row_cache_it->second.get();
+    pull_num = row_cache->Lookup(keys, num, select_values, &cached);
+    if (pull_num % kRowCacheLogPulls == 0) {
+      VLOG(1) << "sparse row cache of table " << table_id
+              << " hit rate: " << row_cache->HitRate();
+    }
+  }
+
   for (size_t i = 0; i < num; ++i) {
+    if (!cached.empty() && cached[i]) {
+      continue;
+    }
     size_t shard_id = get_sparse_shard(shard_num, request_call_num, keys[i]);
     shard_sorted_kvs->at(shard_id).push_back({keys[i], select_values[i]});
   }
@@ -1170,7 +1375,14 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
   size_t value_size = accessor->GetAccessorInfo().select_size;
 
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num,
+      [shard_sorted_kvs,
+       value_size,
+       hot_key_cache,
+       refresh,
+       hot_rows,
+       row_cache,
+       pull_num](void *done) {
         int ret = 0;
         auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
@@ -1203,6 +1415,18 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
             }
           }
         }
+        if (ret == 0 && row_cache != nullptr) {
+          for (auto &request_kvs : *shard_sorted_kvs) {
+            row_cache->Insert(request_kvs, pull_num);
+          }
+        }
+        if (refresh) {
+          // a failed pull drops the cached rows, which would be too old
+          if (ret != 0) {
+            hot_rows->clear();
+          }
+          hot_key_cache->Refresh(*hot_rows);
+        }
         closure->set_promise_value(ret);
       });
   closure->add_timer(timer);
@@ -1440,6 +1664,45 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
   return fut;
 }
 
+std::future<int32_t> BrpcPsClient::PushSparseRawGradientEncoded(
+    size_t table_id,
+    const uint64_t *keys,
+    float **update_values,
+    uint32_t num,
+    void *done,
+    int pserver_idx,
+    SparsePushEncoding encoding,
+    float threshold) {
+  auto *accessor = GetTableAccessor(table_id);
+  uint32_t dim = accessor->GetAccessorInfo().update_size / sizeof(float);
+  uint32_t encoding_id = static_cast<uint32_t>(encoding);
+  DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+  auto promise = std::make_shared<std::promise<int32_t>>();
+  closure->add_promise(promise);
+  std::future<int> fut = promise->get_future();
+
+  auto *push_request = closure->request(0);
+  push_request->set_cmd_id(PS_PUSH_SPARSE_TABLE_ENCODED);
+  push_request->set_table_id(table_id);
+  push_request->set_client_id(_client_id);
+  push_request->add_params((char *)&num, sizeof(uint32_t));          // NOLINT
+  push_request->add_params((char *)&encoding_id, sizeof(uint32_t));  // NOLINT
+  push_request->add_params((char *)&dim, sizeof(uint32_t));          // NOLINT
+  EncodeSparsePush(encoding,
+                   threshold,
+                   keys,
+                   update_values,
+                   num,
+                   dim,
+                   push_request->mutable_data());
+  PsService_Stub rpc_stub(GetSparseChannel(pserver_idx));
+  closure->cntl(0)->set_request_compress_type(
+      (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
+  rpc_stub.service(
+      closure->cntl(0), closure->request(0), closure->response(0), closure);
+  return fut;
+}
+
 int32_t BrpcPsClient::RecvAndSaveTable(const uint64_t table_id,
                                        const std::string &path) {
   // get var information
@@ -16,8 +16,12 @@
 
 #include <ThreadPool.h>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "brpc/channel.h"
@@ -193,6 +197,79 @@ struct SparseTaskPool {
   std::mutex _mutex;
 };
 
+// The rows of the hottest keys of a sparse table pulled by a client, kept as
+// read replicas so that their pulls skip the servers holding them, which
+// the skewed keys would saturate. The keys of a sample of each pull are
+// counted, and every refresh_pulls pulls the most counted ones become the
+// cached keys, whose rows are refilled by that pull. So a cached row is at
+// most refresh_pulls pulls older than the one on its server, which merges
+// the pushes of the key as before.
+class SparseHotKeyCache {
+ public:
+  SparseHotKeyCache(size_t capacity, uint32_t refresh_pulls, size_t value_size)
+      : _capacity(capacity),
+        _refresh_pulls(std::max<uint32_t>(refresh_pulls, 1)),
+        _value_size(value_size) {}
+
+  // Copy the cached rows of the keys to the values and mark them in cached.
+  // Return true instead if the pull refreshes the cache, with the keys to
+  // cache sorted in hot_keys.
+  bool Lookup(const uint64_t *keys,
+              size_t num,
+              float **values,
+              std::vector<bool> *cached,
+              std::vector<uint64_t> *hot_keys);
+  // Replace the cached rows with the rows pulled by a refreshing pull.
+  void Refresh(const std::vector<std::pair<uint64_t, float *>> &rows);
+  size_t Size();
+
+ private:
+  std::mutex _mutex;
+  size_t _capacity;
+  uint32_t _refresh_pulls;
+  size_t _value_size;
+  uint64_t _pull_num = 0;
+  std::unordered_map<uint64_t, uint32_t> _sampled_counts;
+  std::unordered_map<uint64_t, std::vector<char>> _rows;
+};
+
+// The rows of a sparse table recently pulled by a client, served again
+// until they are staleness pulls of the table old, for the ids repeated
+// across consecutive batches. The gradients of the cached keys are still
+// pushed, and merged by key before they are sent like the others.
+class SparseRowCache {
+ public:
+  SparseRowCache(size_t capacity, uint32_t staleness, size_t value_size)
+      : _capacity(capacity), _staleness(staleness), _value_size(value_size) {}
+
+  // Copy the fresh cached rows of the keys not yet cached to the values and
+  // mark them in cached, and return the number of the pull.
+  uint64_t Lookup(const uint64_t *keys,
+                  size_t num,
+                  float **values,
+                  std::vector<bool> *cached);
+  // Cache the rows got by the pull numbered pull_num.
+  void Insert(const std::vector<std::pair<uint64_t, float *>> &rows,
+              uint64_t pull_num);
+  // The fraction of the keys looked up since the last call served by the
+  // cache.
+  double HitRate();
+
+ private:
+  struct Row {
+    uint64_t pull_num;
+    std::vector<char> data;
+  };
+  std::mutex _mutex;
+  size_t _capacity;
+  uint32_t _staleness;
+  size_t _value_size;
+  uint64_t _pull_num = 0;
+  uint64_t _lookup_num = 0;
+  uint64_t _hit_num = 0;
+  std::unordered_map<uint64_t, Row> _rows;
+};
+
 template <class T>
 struct array_deleter {
   void operator()(T *&x) const { delete[] x; }  // NOLINT
@@ -385,6 +462,11 @@ class BrpcPsClient : public PSClient {
       ValueAccessor *accessor);
 
   SparseTaskPool _sparse_task_pool;
+  // the hot rows of the sparse tables, set by pserver_hot_key_cache_size
+  std::unordered_map<uint32_t, std::unique_ptr<SparseHotKeyCache>>
+      _hot_key_caches;
+  // the recently pulled rows, set by pserver_sparse_cache_capacity
+  std::unordered_map<uint32_t, std::unique_ptr<SparseRowCache>> _row_caches;
 
   std::vector<std::shared_ptr<brpc::Channel>>
       _client_channels;  // client2client
@@ -410,6 +492,16 @@ class BrpcPsClient : public PSClient {
                                                     void *done,
                                                     int pserver_idx) override;
 
+  std::future<int32_t> PushSparseRawGradientEncoded(
+      size_t table_id,
+      const uint64_t *keys,
+      float **update_values,
+      uint32_t num,
+      void *done,
+      int pserver_idx,
+      SparsePushEncoding encoding,
+      float threshold) override;
+
   std::future<int32_t> PushSparseParam(size_t table_id,
                                        const uint64_t *keys,
                                        const float **update_values,
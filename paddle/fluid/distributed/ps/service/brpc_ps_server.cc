@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/distributed/ps/service/brpc_ps_server.h"
 
+#include <cstdlib>
 #include <thread>  // NOLINT
 
 #include "butil/object_pool.h"
@@ -40,6 +41,9 @@ PD_DEFINE_string(pserver_connection_type_s2s,
 
 namespace paddle::distributed {
 
+// pull responses at least this large skip the copy into the attachment
+constexpr size_t kPullSparseZeroCopyBytes = 64 << 10;
+
 int32_t BrpcPsServer::Initialize() {
   auto &service_config = _config.downpour_server_param().service_param();
   if (!service_config.has_service_class()) {
@@ -79,6 +83,9 @@ uint64_t BrpcPsServer::Start(const std::string &ip, uint32_t port) {
   int num_threads = std::thread::hardware_concurrency();
   auto trainers = _environment->GetTrainers();
   options.num_threads = trainers > num_threads ? trainers : num_threads;
+  if (EnableRdmaTransport(&options)) {
+    VLOG(0) << "BrpcPsServer serves over rdma";
+  }
 
   if (_server.Start(ip_port.c_str(), &options) != 0) {
     VLOG(0) << "BrpcPsServer start failed, ip_port= " << ip_port
@@ -196,6 +203,8 @@ int32_t BrpcPsService::Initialize() {
   _service_handler_map[PS_PUSH_DENSE_TABLE] = &BrpcPsService::PushDense;
   _service_handler_map[PS_PULL_SPARSE_TABLE] = &BrpcPsService::PullSparse;
   _service_handler_map[PS_PUSH_SPARSE_TABLE] = &BrpcPsService::PushSparse;
+  _service_handler_map[PS_PUSH_SPARSE_TABLE_ENCODED] =
+      &BrpcPsService::PushSparseEncoded;
   _service_handler_map[PS_SAVE_ONE_TABLE] = &BrpcPsService::SaveOneTable;
   _service_handler_map[PS_SAVE_ALL_TABLE] = &BrpcPsService::SaveAllTable;
   _service_handler_map[PS_SHRINK_TABLE] = &BrpcPsService::ShrinkTable;
@@ -538,11 +547,23 @@ int32_t BrpcPsService::PullSparse(Table *table,
 
   value.DeserializeFromBytes(const_cast<void *>(data));
 
-  auto res_data = butil::get_object<std::vector<float>>();
-  res_data->resize(num * dim);
   TableContext table_context;
   table_context.value_type = Sparse;
   table_context.pull_context.pull_value = value;
+  size_t res_size = static_cast<size_t>(num) * dim * sizeof(float);
+  // Large responses are pulled straight into a buffer handed over to the
+  // attachment instead of being copied into it. Over rdma the copy is kept:
+  // it lands in brpc's registered blocks which the NIC reads directly.
+  if (res_size >= kPullSparseZeroCopyBytes && !UseRdmaTransport()) {
+    auto *res_data = static_cast<float *>(malloc(res_size));
+    table_context.pull_context.values = res_data;
+    table->Pull(table_context);
+    cntl->response_attachment().append_user_data(res_data, res_size, free);
+    return 0;
+  }
+
+  auto res_data = butil::get_object<std::vector<float>>();
+  res_data->resize(num * dim);
   table_context.pull_context.values = res_data->data();
   table->Pull(table_context);
   // table->PullSparse(res_data->data(), value);
@@ -596,6 +617,63 @@ int32_t BrpcPsService::PushSparse(Table *table,
   return 0;
 }
 
+int32_t BrpcPsService::PushSparseEncoded(Table *table,
+                                         const PsRequestMessage &request,
+                                         PsResponseMessage &response,
+                                         brpc::Controller *cntl) {
+  phi::RecordEvent record_event("PsService->PushSparseEncoded",
+                                platform::TracerEventType::Communication,
+                                1);
+  CHECK_TABLE_EXIST(table, request, response)
+  auto &push_data = request.data();
+  if (push_data.empty()) {
+    return 0;
+  }
+  if (request.params_size() < 3) {
+    set_response_code(response,
+                      -1,
+                      "PsRequestMessage.params is required at "
+                      "least 3 for num, encoding and dim of sparse_key");
+    return 0;
+  }
+  CostTimer timer("pserver_server_push_sparse_encoded");
+  const uint32_t num =
+      *(reinterpret_cast<const uint32_t *>(request.params(0).c_str()));
+  const uint32_t encoding =
+      *(reinterpret_cast<const uint32_t *>(request.params(1).c_str()));
+  const uint32_t dim =
+      *(reinterpret_cast<const uint32_t *>(request.params(2).c_str()));
+  if (!SparsePushEncoding_IsValid(static_cast<int>(encoding))) {
+    set_response_code(response, -1, "unknown sparse push encoding");
+    return 0;
+  }
+  if (dim * sizeof(float) !=
+      table->GetValueAccessor()->GetAccessorInfo().update_size) {
+    set_response_code(response, -1, "sparse push dim mismatch");
+    return 0;
+  }
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  if (!DecodeSparsePush(static_cast<SparsePushEncoding>(encoding),
+                        push_data,
+                        num,
+                        dim,
+                        &keys,
+                        &values)) {
+    set_response_code(response, -1, "decode encoded sparse push failed");
+    return 0;
+  }
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.push_context.keys = keys.data();
+  table_context.push_context.values = values.data();
+  table_context.num = num;
+  if (table->Push(table_context) != 0) {
+    set_response_code(response, -1, "PushSparseEncoded error");
+  }
+  return 0;
+}
+
 int32_t BrpcPsService::PrintTableStat(Table *table,
                                       const PsRequestMessage &request,
                                       PsResponseMessage &response,
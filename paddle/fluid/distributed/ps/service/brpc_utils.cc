@@ -17,8 +17,17 @@ limitations under the License. */
 #include <arpa/inet.h>
 #include <netdb.h>
 
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#ifdef PADDLE_WITH_BRPC_RDMA
+#include "brpc/rdma/rdma_helper.h"
+#endif
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/float16.h"
 
 namespace paddle::framework {
 class Variable;
@@ -30,6 +39,11 @@ class DenseTensor;
 
 namespace paddle::distributed {
 
+PD_DEFINE_bool(pserver_use_rdma,
+               false,
+               "use brpc rdma transport between ps client and server, "
+               "requires paddle built with WITH_BRPC_RDMA");
+
 framework::proto::VarType::Type VarMessageToVarType(
     VariableMessage::Type type) {
   switch (type) {
@@ -340,4 +354,205 @@ std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port) {
   return int_ip_port;
 }
 
+bool UseRdmaTransport() {
+  if (!FLAGS_pserver_use_rdma) {
+    return false;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  static std::once_flag init_flag;
+  std::call_once(init_flag, [] { brpc::rdma::GlobalRdmaInitializeOrDie(); });
+  if (brpc::rdma::IsRdmaAvailable()) {
+    return true;
+  }
+  LOG_FIRST_N(WARNING, 1) << "pserver_use_rdma is set but no rdma device is "
+                             "available, fall back to tcp";
+#else
+  LOG_FIRST_N(WARNING, 1) << "pserver_use_rdma is set but paddle is not "
+                             "built with WITH_BRPC_RDMA, fall back to tcp";
+#endif
+  return false;
+}
+
+bool EnableRdmaTransport(brpc::ChannelOptions* options) {
+  if (!UseRdmaTransport()) {
+    return false;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  options->use_rdma = true;
+#endif
+  return true;
+}
+
+bool EnableRdmaTransport(brpc::ServerOptions* options) {
+  if (!UseRdmaTransport()) {
+    return false;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  options->use_rdma = true;
+#endif
+  return true;
+}
+
+static void PutVarint64(uint64_t v, std::string* out) {
+  while (v >= 0x80) {
+    out->push_back(static_cast<char>(v | 0x80));
+    v >>= 7;
+  }
+  out->push_back(static_cast<char>(v));
+}
+
+static bool GetVarint64(const char** p, const char* end, uint64_t* v) {
+  *v = 0;
+  for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+    uint64_t byte = static_cast<unsigned char>(*((*p)++));
+    *v |= (byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void PutFloat16(float* v, std::string* out) {
+  phi::dtype::float16 h(*v);
+  *v = static_cast<float>(h);
+  out->append(reinterpret_cast<const char*>(&h.x), sizeof(h.x));
+}
+
+static bool GetFloat16(const char** p, const char* end, float* v) {
+  phi::dtype::float16 h;
+  if (end - *p < static_cast<ptrdiff_t>(sizeof(h.x))) {
+    return false;
+  }
+  memcpy(&h.x, *p, sizeof(h.x));
+  *p += sizeof(h.x);
+  *v = static_cast<float>(h);
+  return true;
+}
+
+void EncodeSparsePush(SparsePushEncoding encoding,
+                      float threshold,
+                      const uint64_t* keys,
+                      float** values,
+                      size_t num,
+                      size_t dim,
+                      std::string* out) {
+  /*
+  Push Content:
+  |---varint key deltas---|---values of every key---|
+  FP32: dim floats, FP16: dim halfs,
+  THRESHOLD_FP16: varint nnz, nnz * {varint index delta, half}
+  */
+  out->clear();
+  out->reserve(num * (sizeof(uint64_t) + dim * sizeof(float)));
+  uint64_t last_key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    PADDLE_ENFORCE_EQ(i == 0 || keys[i] > last_key,
+                      true,
+                      common::errors::InvalidArgument(
+                          "Keys of an encoded sparse push must be sorted and "
+                          "unique, but key %d follows key %d.",
+                          keys[i],
+                          last_key));
+    PutVarint64(keys[i] - last_key, out);
+    last_key = keys[i];
+  }
+
+  for (size_t i = 0; i < num; ++i) {
+    float* value = values[i];
+    switch (encoding) {
+      case SPARSE_PUSH_FP32:
+        out->append(reinterpret_cast<const char*>(value), dim * sizeof(float));
+        break;
+      case SPARSE_PUSH_FP16:
+        for (size_t j = 0; j < dim; ++j) {
+          PutFloat16(value + j, out);
+        }
+        break;
+      case SPARSE_PUSH_THRESHOLD_FP16: {
+        uint64_t nnz = 0;
+        for (size_t j = 0; j < dim; ++j) {
+          nnz += std::fabs(value[j]) >= threshold ? 1 : 0;
+        }
+        PutVarint64(nnz, out);
+        size_t last_idx = 0;
+        for (size_t j = 0; j < dim; ++j) {
+          if (std::fabs(value[j]) >= threshold) {
+            PutVarint64(j - last_idx, out);
+            PutFloat16(value + j, out);
+            last_idx = j;
+          } else {
+            value[j] = 0;
+          }
+        }
+        break;
+      }
+      default:
+        PADDLE_THROW(common::errors::InvalidArgument(
+            "Unsupported sparse push encoding %d.", encoding));
+    }
+  }
+}
+
+bool DecodeSparsePush(SparsePushEncoding encoding,
+                      const std::string& data,
+                      size_t num,
+                      size_t dim,
+                      std::vector<uint64_t>* keys,
+                      std::vector<float>* values) {
+  const char* p = data.data();
+  const char* end = data.data() + data.size();
+  keys->resize(num);
+  values->assign(num * dim, 0);
+  uint64_t key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t delta;
+    if (!GetVarint64(&p, end, &delta)) {
+      return false;
+    }
+    key += delta;
+    (*keys)[i] = key;
+  }
+
+  for (size_t i = 0; i < num; ++i) {
+    float* value = values->data() + i * dim;
+    switch (encoding) {
+      case SPARSE_PUSH_FP32:
+        if (end - p < static_cast<ptrdiff_t>(dim * sizeof(float))) {
+          return false;
+        }
+        memcpy(value, p, dim * sizeof(float));
+        p += dim * sizeof(float);
+        break;
+      case SPARSE_PUSH_FP16:
+        for (size_t j = 0; j < dim; ++j) {
+          if (!GetFloat16(&p, end, value + j)) {
+            return false;
+          }
+        }
+        break;
+      case SPARSE_PUSH_THRESHOLD_FP16: {
+        uint64_t nnz, idx = 0;
+        if (!GetVarint64(&p, end, &nnz) || nnz > dim) {
+          return false;
+        }
+        for (uint64_t j = 0; j < nnz; ++j) {
+          uint64_t idx_delta;
+          if (!GetVarint64(&p, end, &idx_delta)) {
+            return false;
+          }
+          idx += idx_delta;
+          if (idx >= dim || !GetFloat16(&p, end, value + idx)) {
+            return false;
+          }
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return p == end;
+}
+
 }  // namespace paddle::distributed
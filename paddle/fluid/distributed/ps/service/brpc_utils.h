@@ -21,6 +21,7 @@ limitations under the License. */
 #include <vector>
 
 #include "brpc/channel.h"
+#include "brpc/server.h"
 #include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/lod_tensor.h"
@@ -94,5 +95,33 @@ void DeserializeSelectedRows(framework::Variable* var,
 
 std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port);
 
+// Whether ps traffic goes over brpc RDMA, see --pserver_use_rdma.
+bool UseRdmaTransport();
+
+// Switch the options to the brpc RDMA transport when Paddle is built
+// WITH_BRPC_RDMA, --pserver_use_rdma is set and an RDMA device is usable.
+// Returns whether RDMA was enabled; otherwise the options stay on TCP.
+bool EnableRdmaTransport(brpc::ChannelOptions* options);
+bool EnableRdmaTransport(brpc::ServerOptions* options);
+
+// Encode num sorted keys and their values of dim floats for
+// PS_PUSH_SPARSE_TABLE_ENCODED. values are overwritten with what the server
+// decodes, so the caller can keep the part that was not sent as residual.
+void EncodeSparsePush(SparsePushEncoding encoding,
+                      float threshold,
+                      const uint64_t* keys,
+                      float** values,
+                      size_t num,
+                      size_t dim,
+                      std::string* out);
+
+// Return false if data is not a valid encoding of num keys.
+bool DecodeSparsePush(SparsePushEncoding encoding,
+                      const std::string& data,
+                      size_t num,
+                      size_t dim,
+                      std::vector<uint64_t>* keys,
+                      std::vector<float>* values);
+
 }  // namespace distributed
 }  // namespace paddle
@@ -26,6 +26,9 @@ limitations under the License. */
 #define LEARNING_RATE_DECAY_COUNTER "@LR_DECAY_COUNTER@"
 #define STEP_COUNTER "@PS_STEP_COUNTER@"
 
+COMMON_DECLARE_int32(geo_sparse_push_encoding);
+COMMON_DECLARE_double(geo_sparse_push_threshold);
+
 namespace paddle {
 namespace distributed {
 
@@ -1120,6 +1123,20 @@ void GeoCommunicator::Send(
   VLOG(2) << "run send op finish. use time " << (after_send - before_send);
 }
 
+// Returns FLAGS_geo_sparse_push_encoding, rejecting the unknown encodings
+// before anything is pushed with them.
+static SparsePushEncoding GeoSparsePushEncoding() {
+  PADDLE_ENFORCE_EQ(
+      SparsePushEncoding_IsValid(FLAGS_geo_sparse_push_encoding),
+      true,
+      common::errors::InvalidArgument(
+          "FLAGS_geo_sparse_push_encoding should be 0 (fp32), 1 (fp16) or 2 "
+          "(fp16 with the values below FLAGS_geo_sparse_push_threshold "
+          "dropped), but received %d.",
+          FLAGS_geo_sparse_push_encoding));
+  return static_cast<SparsePushEncoding>(FLAGS_geo_sparse_push_encoding);
+}
+
 void GeoCommunicator::InitImpl(const RpcCtxMap &send_varname_to_ctx,
                                const RecvCtxMap &recv_varname_to_ctx,
                                Scope *recv_scope) {
@@ -1127,6 +1144,7 @@ void GeoCommunicator::InitImpl(const RpcCtxMap &send_varname_to_ctx,
   recv_varname_to_ctx_ = std::move(
       recv_varname_to_ctx);  // dense_map - key: table_id, value: params
   recv_scope_ = std::move(recv_scope);
+  GeoSparsePushEncoding();
 
   for (auto it = send_varname_to_ctx_.begin();
        it != send_varname_to_ctx_.end();) {
@@ -1370,6 +1388,8 @@ std::vector<int64_t> GeoCommunicator::MergeSparseIds(
   }
   std::vector<int64_t> res;
   res.assign(sparse_ids.begin(), sparse_ids.end());
+  // sorted ids let the encoded push delta-code its keys
+  std::sort(res.begin(), res.end());
   return res;
 }
 
@@ -1425,10 +1445,6 @@ void GeoCommunicator::SendSparse(const std::string &varname,
               t_old->data<float>() + sparse_ids[j] * dims1,
               t_value + j * dims1);
     blas.SCAL(dims1, coefficient, t_value + j * dims1);
-    blas.VADD(dims1,
-              t_old->data<float>() + sparse_ids[j] * dims1,
-              t_value + j * dims1,
-              t_old->data<float>() + sparse_ids[j] * dims1);
     push_g_vec.push_back(t_value + j * dims1);
 
     VLOG(5) << "DEBUG GeoCommunicator::SendSparse send sparse key "
@@ -1436,24 +1452,50 @@ void GeoCommunicator::SendSparse(const std::string &varname,
             << " value[-1] " << push_g_vec[j][dims1 - 1];
   }
 
+  const auto encoding = GeoSparsePushEncoding();
+  const auto cmd_id = encoding == SPARSE_PUSH_FP32
+                          ? PS_PUSH_SPARSE_TABLE
+                          : PS_PUSH_SPARSE_TABLE_ENCODED;
   ++_async_call_num;
-  DownpourBrpcClosure *closure = new DownpourBrpcClosure(1, [this](void *done) {
-    int ret = 0;
-    auto *closure = (DownpourBrpcClosure *)done;  // NOLINT
-    if (closure->check_response(0, PS_PUSH_SPARSE_TABLE) != 0) {
-      ret = -1;
-    }
-    closure->set_promise_value(ret);
-    --_async_call_num;
-  });
-  auto status = _worker_ptr->PushSparseRawGradientPartial(
-      table_id,
-      (const uint64_t *)sparse_ids.data(),
-      (const float **)push_g_vec.data(),
-      sparse_ids.size(),
-      closure,
-      ep_idx);
+  DownpourBrpcClosure *closure =
+      new DownpourBrpcClosure(1, [this, cmd_id](void *done) {
+        int ret = 0;
+        auto *closure = (DownpourBrpcClosure *)done;  // NOLINT
+        if (closure->check_response(0, cmd_id) != 0) {
+          ret = -1;
+        }
+        closure->set_promise_value(ret);
+        --_async_call_num;
+      });
+  std::future<int32_t> status;
+  if (encoding == SPARSE_PUSH_FP32) {
+    status = _worker_ptr->PushSparseRawGradientPartial(
+        table_id,
+        (const uint64_t *)sparse_ids.data(),
+        (const float **)push_g_vec.data(),
+        sparse_ids.size(),
+        closure,
+        ep_idx);
+  } else {
+    // push_g_vec is rewritten to what the server decodes, so only that part
+    // is folded into old and the dropped remainder stays in latest - old
+    status = _worker_ptr->PushSparseRawGradientEncoded(
+        table_id,
+        (const uint64_t *)sparse_ids.data(),
+        push_g_vec.data(),
+        sparse_ids.size(),
+        closure,
+        ep_idx,
+        encoding,
+        static_cast<float>(FLAGS_geo_sparse_push_threshold));
+  }
   status.wait();
+  for (auto j = 0; j < static_cast<int>(sparse_ids.size()); ++j) {
+    blas.VADD(dims1,
+              t_old->data<float>() + sparse_ids[j] * dims1,
+              push_g_vec[j],
+              t_old->data<float>() + sparse_ids[j] * dims1);
+  }
 
   VLOG(1) << "Finish Send Sparse " << varname
           << ", ids.size = " << sparse_ids.size() << ", table_id: " << table_id;
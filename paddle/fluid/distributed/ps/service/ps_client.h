@@ -280,6 +280,27 @@ class PSClient {
       void *done,
       int pserver_idx) = 0;
 
+  // Same as PushSparseRawGradientPartial, but the keys (sorted, unique) and
+  // values travel in a compact encoding. On return update_values hold what
+  // the server will decode, so callers can keep the quantization residual.
+  virtual std::future<int32_t> PushSparseRawGradientEncoded(
+      size_t table_id,
+      const uint64_t *keys,
+      float **update_values,
+      uint32_t num,
+      void *done,
+      int pserver_idx,
+      SparsePushEncoding encoding UNUSED,
+      float threshold UNUSED) {
+    return PushSparseRawGradientPartial(
+        table_id,
+        keys,
+        const_cast<const float **>(update_values),
+        num,
+        done,
+        pserver_idx);
+  }
+
   virtual std::future<int32_t> PushSparseParam(size_t table_id,
                                                const uint64_t *keys,
                                                const float **update_values,
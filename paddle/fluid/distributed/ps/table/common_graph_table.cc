@@ -37,6 +37,7 @@
 #include "paddle/utils/string/string_helper.h"
 
 COMMON_DECLARE_bool(graph_load_in_parallel);
+COMMON_DECLARE_bool(graph_use_alias_sampler);
 COMMON_DECLARE_bool(graph_get_neighbor_id);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_uint64(gpugraph_slot_feasign_max_num);
@@ -2627,8 +2628,11 @@ int32_t GraphTable::load_edges(const std::string &path,
     // this optimization is only performed in load_edges function.
     VLOG(0) << "run in gpugraph mode!";
   } else {
-    std::string sample_type = "random";
-    VLOG(0) << "build sampler ... ";
+    // weighted edges get an alias table only if asked for, as it samples
+    // differently and takes more memory than the uniform sampler
+    std::string sample_type =
+        is_weighted_ && FLAGS_graph_use_alias_sampler ? "alias" : "random";
+    VLOG(0) << "build " << sample_type << " sampler ... ";
     for (auto &shard : edge_shards[idx]) {
       auto bucket = shard->get_bucket();
       for (auto item : bucket) {
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/distributed/ps/table/ctr_accessor.h"
 
+#include <algorithm>
+
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -246,35 +248,49 @@ int32_t CtrCommonAccessor::Merge(float** update_values,
 int32_t CtrCommonAccessor::Update(float** update_values,
                                   const float** push_values,
                                   size_t num) {
-  for (size_t value_item = 0; value_item < num; ++value_item) {
-    float* update_value = update_values[value_item];
-    const float* push_value = push_values[value_item];
-    float push_show = push_value[CtrCommonPushValue::ShowIndex()];
-    float push_click = push_value[CtrCommonPushValue::ClickIndex()];
-    float slot = push_value[CtrCommonPushValue::SlotIndex()];
-    update_value[common_feature_value.ShowIndex()] += push_show;
-    update_value[common_feature_value.ClickIndex()] += push_click;
-    update_value[common_feature_value.SlotIndex()] = slot;
-    update_value[common_feature_value.DeltaScoreIndex()] +=
-        (push_show - push_click) * _config.ctr_accessor_param().nonclk_coeff() +
-        push_click * _config.ctr_accessor_param().click_coeff();
-    update_value[common_feature_value.UnseenDaysIndex()] = 0;
-    // TODO(zhaocaibei123): add configure show_scale
-    if (!_show_scale) {
-      push_show = 1;
+  // the sgd rules update the embeddings of a batch of values with one call
+  constexpr size_t kBatchSize = 64;
+  float* embed_w[kBatchSize];
+  float* embed_g2sum[kBatchSize];
+  const float* embed_g[kBatchSize];
+  float* embedx_w[kBatchSize];
+  float* embedx_g2sum[kBatchSize];
+  const float* embedx_g[kBatchSize];
+  float push_shows[kBatchSize];
+  for (size_t begin = 0; begin < num; begin += kBatchSize) {
+    const size_t batch_size = std::min(kBatchSize, num - begin);
+    for (size_t i = 0; i < batch_size; ++i) {
+      float* update_value = update_values[begin + i];
+      const float* push_value = push_values[begin + i];
+      float push_show = push_value[CtrCommonPushValue::ShowIndex()];
+      float push_click = push_value[CtrCommonPushValue::ClickIndex()];
+      float slot = push_value[CtrCommonPushValue::SlotIndex()];
+      update_value[common_feature_value.ShowIndex()] += push_show;
+      update_value[common_feature_value.ClickIndex()] += push_click;
+      update_value[common_feature_value.SlotIndex()] = slot;
+      update_value[common_feature_value.DeltaScoreIndex()] +=
+          (push_show - push_click) *
+              _config.ctr_accessor_param().nonclk_coeff() +
+          push_click * _config.ctr_accessor_param().click_coeff();
+      update_value[common_feature_value.UnseenDaysIndex()] = 0;
+      // TODO(zhaocaibei123): add configure show_scale
+      if (!_show_scale) {
+        push_show = 1;
+      }
+      VLOG(3) << "accessor show scale:" << _show_scale
+              << ", push_show:" << push_show;
+      embed_w[i] = update_value + common_feature_value.EmbedWIndex();
+      embed_g2sum[i] = update_value + common_feature_value.EmbedG2SumIndex();
+      embed_g[i] = push_value + CtrCommonPushValue::EmbedGIndex();
+      embedx_w[i] = update_value + common_feature_value.EmbedxWIndex();
+      embedx_g2sum[i] = update_value + common_feature_value.EmbedxG2SumIndex();
+      embedx_g[i] = push_value + CtrCommonPushValue::EmbedxGIndex();
+      push_shows[i] = push_show;
     }
-    VLOG(3) << "accessor show scale:" << _show_scale
-            << ", push_show:" << push_show;
-    _embed_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedWIndex(),
-        update_value + common_feature_value.EmbedG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedGIndex(),
-        push_show);
-    _embedx_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedxWIndex(),
-        update_value + common_feature_value.EmbedxG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedxGIndex(),
-        push_show);
+    _embed_sgd_rule->UpdateValues(
+        embed_w, embed_g2sum, embed_g, push_shows, batch_size);
+    _embedx_sgd_rule->UpdateValues(
+        embedx_w, embedx_g2sum, embedx_g, push_shows, batch_size);
   }
   return 0;
 }
@@ -0,0 +1,189 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/ctr_quant_accessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle::distributed {
+
+int CtrQuantAccessor::Initialize() {
+  const auto& quant_type = _config.ctr_accessor_param().embedx_quant_type();
+  PADDLE_ENFORCE_EQ(
+      quant_type == "fp16" || quant_type == "int8",
+      true,
+      common::errors::InvalidArgument(
+          "The embedx_quant_type of CtrQuantAccessor must be fp16 or int8, "
+          "but received %s.",
+          quant_type));
+  quant_feature_value.int8 = (quant_type == "int8");
+  return CtrCommonAccessor::Initialize();
+}
+
+void CtrQuantAccessor::InitAccessorInfo() {
+  quant_feature_value.embed_sgd_dim = common_feature_value.embed_sgd_dim;
+  quant_feature_value.embedx_dim = common_feature_value.embedx_dim;
+  quant_feature_value.embedx_sgd_dim = common_feature_value.embedx_sgd_dim;
+
+  _accessor_info.dim = quant_feature_value.Dim();
+  _accessor_info.size = quant_feature_value.Size();
+
+  auto embedx_dim = _config.embedx_dim();
+  _accessor_info.select_dim = 3 + embedx_dim;
+  _accessor_info.select_size = _accessor_info.select_dim * sizeof(float);
+  _accessor_info.update_dim = 4 + embedx_dim;
+  _accessor_info.update_size = _accessor_info.update_dim * sizeof(float);
+  _accessor_info.mf_size =
+      (quant_feature_value.Dim() - quant_feature_value.MFIndex()) *
+      sizeof(float);
+}
+
+bool CtrQuantAccessor::HasMF(int size) {
+  return size > quant_feature_value.MFIndex();
+}
+
+float* CtrQuantAccessor::CommonBuffer() {
+  thread_local std::vector<float> buffer;
+  buffer.resize(common_feature_value.Dim());
+  return buffer.data();
+}
+
+void CtrQuantAccessor::Dequantize(const float* value, float* common_value) {
+  auto& qv = quant_feature_value;
+  memcpy(common_value, value, qv.MFIndex() * sizeof(float));
+
+  float* embedx_w = common_value + common_feature_value.EmbedxWIndex();
+  if (qv.int8) {
+    float scale = value[qv.EmbedxScaleIndex()];
+    auto* w = reinterpret_cast<const int8_t*>(value + qv.EmbedxWIndex());
+    for (int i = 0; i < qv.embedx_dim; ++i) {
+      embedx_w[i] = w[i] * scale;
+    }
+  } else {
+    auto* w =
+        reinterpret_cast<const phi::dtype::float16*>(value + qv.EmbedxWIndex());
+    for (int i = 0; i < qv.embedx_dim; ++i) {
+      embedx_w[i] = static_cast<float>(w[i]);
+    }
+  }
+
+  float* embedx_g2sum = common_value + common_feature_value.EmbedxG2SumIndex();
+  auto* g2sum = reinterpret_cast<const phi::dtype::bfloat16*>(
+      value + qv.EmbedxG2SumIndex());
+  for (int i = 0; i < qv.embedx_sgd_dim; ++i) {
+    embedx_g2sum[i] = static_cast<float>(g2sum[i]);
+  }
+}
+
+void CtrQuantAccessor::Quantize(const float* common_value,
+                                float* value,
+                                bool stochastic) {
+  auto& qv = quant_feature_value;
+  memcpy(value, common_value, qv.MFIndex() * sizeof(float));
+  // the padding of the packed fields must not hold stale bits
+  memset(value + qv.MFIndex(), 0, (qv.Dim() - qv.MFIndex()) * sizeof(float));
+
+  const float* embedx_w = common_value + common_feature_value.EmbedxWIndex();
+  if (qv.int8) {
+    float max_abs = 0;
+    for (int i = 0; i < qv.embedx_dim; ++i) {
+      max_abs = std::max(max_abs, std::fabs(embedx_w[i]));
+    }
+    float scale = max_abs / 127.0f;
+    value[qv.EmbedxScaleIndex()] = scale;
+    auto* w = reinterpret_cast<int8_t*>(value + qv.EmbedxWIndex());
+    for (int i = 0; i < qv.embedx_dim && scale > 0; ++i) {
+      // stochastic rounding keeps small sgd updates unbiased
+      float q = embedx_w[i] / scale;
+      q = stochastic ? std::floor(q + local_uniform_real_distribution<float>()(
+                                          local_random_engine()))
+                     : std::round(q);
+      w[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, q)));
+    }
+  } else {
+    auto* w = reinterpret_cast<phi::dtype::float16*>(value + qv.EmbedxWIndex());
+    for (int i = 0; i < qv.embedx_dim; ++i) {
+      w[i] = static_cast<phi::dtype::float16>(embedx_w[i]);
+    }
+  }
+
+  const float* embedx_g2sum =
+      common_value + common_feature_value.EmbedxG2SumIndex();
+  auto* g2sum =
+      reinterpret_cast<phi::dtype::bfloat16*>(value + qv.EmbedxG2SumIndex());
+  for (int i = 0; i < qv.embedx_sgd_dim; ++i) {
+    g2sum[i] = static_cast<phi::dtype::bfloat16>(embedx_g2sum[i]);
+  }
+}
+
+int32_t CtrQuantAccessor::Create(float** values, size_t num) {
+  float* common_value = CommonBuffer();
+  for (size_t value_item = 0; value_item < num; ++value_item) {
+    CtrCommonAccessor::Create(&common_value, 1);
+    Quantize(common_value, values[value_item], false);
+  }
+  return 0;
+}
+
+// from CtrQuantFeatureValue to CtrCommonPullValue
+int32_t CtrQuantAccessor::Select(float** select_values,
+                                 const float** values,
+                                 size_t num) {
+  float* common_value = CommonBuffer();
+  for (size_t value_item = 0; value_item < num; ++value_item) {
+    Dequantize(values[value_item], common_value);
+    CtrCommonAccessor::Select(select_values + value_item,
+                              const_cast<const float**>(&common_value),
+                              1);
+  }
+  return 0;
+}
+
+// from CtrCommonPushValue to CtrQuantFeatureValue
+int32_t CtrQuantAccessor::Update(float** update_values,
+                                 const float** push_values,
+                                 size_t num) {
+  float* common_value = CommonBuffer();
+  for (size_t value_item = 0; value_item < num; ++value_item) {
+    Dequantize(update_values[value_item], common_value);
+    CtrCommonAccessor::Update(&common_value, push_values + value_item, 1);
+    Quantize(common_value, update_values[value_item], true);
+  }
+  return 0;
+}
+
+std::string CtrQuantAccessor::ParseToString(const float* v, int param) {
+  float* common_value = CommonBuffer();
+  Dequantize(v, common_value);
+  // saved models keep the CtrCommonAccessor text format
+  int common_param = HasMF(param) ? common_feature_value.Dim() : param;
+  return CtrCommonAccessor::ParseToString(common_value, common_param);
+}
+
+int CtrQuantAccessor::ParseFromString(const std::string& str, float* value) {
+  float* common_value = CommonBuffer();
+  auto ret = CtrCommonAccessor::ParseFromString(str, common_value);
+  Quantize(common_value, value, false);
+  return ret > common_feature_value.EmbedxWIndex() ? quant_feature_value.Dim()
+                                                   : ret;
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/table/ctr_accessor.h"
+
+namespace paddle {
+namespace distributed {
+
+// CtrCommonAccessor with a compact embedx storage. embedx_w is kept as fp16
+// or as int8 with a per-row scale, and embedx_g2sum is kept as bf16. The
+// values are dequantized to the CtrCommonAccessor layout for Select, Update
+// and ParseToString, so the pull and push values do not change.
+class CtrQuantAccessor : public CtrCommonAccessor {
+ public:
+  struct CtrQuantFeatureValue {
+    /*
+       float slot;
+       float unseen_days;
+       float delta_score;
+       float show;
+       float click;
+       float embed_w;
+       std::vector<float> embed_g2sum;
+       float embedx_scale;                  // int8 only
+       std::vector<int8/fp16> embedx_w;     // packed into floats
+       std::vector<bf16> embedx_g2sum;      // packed into floats
+       */
+
+    int MFIndex() { return 6 + embed_sgd_dim; }
+    int EmbedxScaleIndex() { return MFIndex(); }
+    int EmbedxWIndex() { return MFIndex() + (int8 ? 1 : 0); }
+    int EmbedxWDim() {
+      return int8 ? (embedx_dim + 3) / 4 : (embedx_dim + 1) / 2;
+    }
+    int EmbedxG2SumIndex() { return EmbedxWIndex() + EmbedxWDim(); }
+    int EmbedxG2SumDim() { return (embedx_sgd_dim + 1) / 2; }
+    int Dim() { return EmbedxG2SumIndex() + EmbedxG2SumDim(); }
+    int Size() { return Dim() * sizeof(float); }
+
+    int embed_sgd_dim;
+    int embedx_dim;
+    int embedx_sgd_dim;
+    bool int8 = false;
+  };
+
+  CtrQuantAccessor() {}
+  virtual ~CtrQuantAccessor() {}
+  int Initialize() override;
+  void InitAccessorInfo() override;
+  bool HasMF(int size) override;
+  int32_t Create(float** value, size_t num) override;
+  int32_t Select(float** select_values,
+                 const float** values,
+                 size_t num) override;
+  int32_t Update(float** values,
+                 const float** update_values,
+                 size_t num) override;
+  std::string ParseToString(const float* value, int param) override;
+  int32_t ParseFromString(const std::string& str, float* v) override;
+
+  // convert between the quantized layout and the CtrCommonAccessor layout
+  void Dequantize(const float* value, float* common_value);
+  void Quantize(const float* common_value, float* value, bool stochastic);
+
+ public:  // public for unit test
+  CtrQuantFeatureValue quant_feature_value;
+
+ private:
+  float* CommonBuffer();
+};
+}  // namespace distributed
+}  // namespace paddle
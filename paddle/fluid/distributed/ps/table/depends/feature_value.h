@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <mutex>  // NOLINT
 #include <vector>
 
 #include <mct/hash-map.hpp>
@@ -102,11 +103,18 @@ struct alignas(64) SparseTableShard {
   }
   size_t bucket_count() { return CTR_SPARSE_SHARD_BUCKET_NUM; }
   size_t bucket_size(size_t bucket) { return _buckets[bucket].size(); }
+  // Buckets are independent hash maps, different buckets of one shard can be
+  // accessed by different threads as long as the value allocator, which is
+  // shared by all buckets, is guarded.
+  void set_concurrent_buckets(bool concurrent) {
+    _concurrent_buckets = concurrent;
+  }
+  size_t bucket_of(const KEY& key) { return compute_bucket(_hasher(key)); }
   void clear() {
     for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
       map_type& data = _buckets[bucket];
       for (auto it = data.begin(); it != data.end(); ++it) {
-        _alloc.release((VALUE*)(void*)it->second);  // NOLINT
+        release((VALUE*)(void*)it->second);  // NOLINT
       }
       data.clear();
     }
@@ -150,13 +158,13 @@ struct alignas(64) SparseTableShard {
     auto res = _buckets[bucket].insert_with_hash({key, NULL}, hash);
 
     if (res.second) {
-      res.first->second = _alloc.acquire(std::forward<ARGS>(args)...);
+      res.first->second = acquire(std::forward<ARGS>(args)...);
     }
 
     return {{res.first, bucket, _buckets}, res.second};
   }
   iterator erase(iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release((VALUE*)(void*)it.it->second);  // NOLINT
     size_t bucket = it.bucket;
     auto it2 = _buckets[bucket].erase(it.it);
     while (it2 == _buckets[bucket].end() &&
@@ -166,15 +174,15 @@ struct alignas(64) SparseTableShard {
     return {it2, bucket, _buckets};
   }
   void quick_erase(iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release((VALUE*)(void*)it.it->second);  // NOLINT
     _buckets[it.bucket].quick_erase(it.it);
   }
   local_iterator erase(size_t bucket, local_iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release((VALUE*)(void*)it.it->second);  // NOLINT
     return {_buckets[bucket].erase(it.it)};
   }
   void quick_erase(size_t bucket, local_iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release((VALUE*)(void*)it.it->second);  // NOLINT
     _buckets[bucket].quick_erase(it.it);
   }
   size_t erase(const KEY& key) {
@@ -194,8 +202,27 @@ struct alignas(64) SparseTableShard {
   }
 
  private:
+  template <class... ARGS>
+  VALUE* acquire(ARGS&&... args) {
+    if (_concurrent_buckets) {
+      std::lock_guard<std::mutex> lock(_alloc_mutex);
+      return _alloc.acquire(std::forward<ARGS>(args)...);
+    }
+    return _alloc.acquire(std::forward<ARGS>(args)...);
+  }
+  void release(VALUE* value) {
+    if (_concurrent_buckets) {
+      std::lock_guard<std::mutex> lock(_alloc_mutex);
+      _alloc.release(value);
+      return;
+    }
+    _alloc.release(value);
+  }
+
   map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
   ChunkAllocator<VALUE> _alloc;
+  std::mutex _alloc_mutex;
+  bool _concurrent_buckets = false;
   std::hash<KEY> _hasher;
 };
 
@@ -215,6 +215,18 @@ class RocksDBHandler {
     return 0;
   }
 
+  int del_data_batch(int id, const rocksdb::Slice* keys, size_t num_keys) {
+    rocksdb::WriteOptions options;
+    options.disableWAL = true;
+    rocksdb::WriteBatch batch;
+    for (size_t i = 0; i < num_keys; i++) {
+      batch.Delete(keys[i]);
+    }
+    rocksdb::Status s = _dbs[id]->Write(options, &batch);
+    assert(s.ok());
+    return 0;
+  }
+
   int flush(int id) {
     rocksdb::Status s = _dbs[id]->Flush(rocksdb::FlushOptions());
     assert(s.ok());
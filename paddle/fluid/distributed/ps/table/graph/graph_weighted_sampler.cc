@@ -14,9 +14,13 @@
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
 #include "paddle/phi/core/generator.h"
 namespace paddle::distributed {
@@ -165,4 +169,130 @@ int WeightedSampler::sample(
   subtract_count_map[this]++;
   return return_idx;
 }
+void AliasSampler::build(GraphEdgeBlob *edges) {
+  this->edges = edges;
+  int n = edges->size();
+  prob_.assign(n, 1.0);
+  alias_.resize(n);
+  for (int i = 0; i < n; i++) {
+    alias_[i] = i;
+  }
+  double total = 0;
+  for (int i = 0; i < n; i++) {
+    total += static_cast<float>(edges->get_weight(i));
+  }
+  if (n == 0 || total <= 0) {
+    return;
+  }
+
+  std::vector<int> small, large;
+  small.reserve(n);
+  large.reserve(n);
+  std::vector<double> scaled(n);
+  int positive = 0;
+  for (int i = 0; i < n; i++) {
+    scaled[i] = static_cast<float>(edges->get_weight(i)) * n / total;
+    if (scaled[i] > 0) {
+      positive = i;
+    }
+    if (scaled[i] < 1.0) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+  while (!small.empty() && !large.empty()) {
+    int s = small.back(), l = large.back();
+    small.pop_back();
+    prob_[s] = scaled[s];
+    alias_[s] = l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // the remaining columns are full up to rounding errors, except the edges
+  // of zero weight, which are never drawn
+  for (int i : small) {
+    if (scaled[i] > 0) {
+      prob_[i] = 1.0;
+    } else {
+      prob_[i] = 0;
+      alias_[i] = positive;
+    }
+  }
+  for (int i : large) {
+    prob_[i] = 1.0;
+  }
+}
+
+int AliasSampler::draw(std::mt19937_64 *rng) {
+  std::uniform_int_distribution<int> column(0, prob_.size() - 1);
+  std::uniform_real_distribution<float> coin(0, 1.0);
+  int i = column(*rng);
+  return coin(*rng) < prob_[i] ? i : alias_[i];
+}
+
+void AliasSampler::sample_rest(int k,
+                               std::mt19937_64 *rng,
+                               std::vector<int> *sample_result) {
+  // Efraimidis-Spirakis keys over the edges that are not sampled yet, which
+  // continues the sequential weighted sampling exactly.
+  int n = edges->size();
+  std::vector<char> picked(n, 0);
+  for (int x : *sample_result) {
+    picked[x] = 1;
+  }
+  std::uniform_real_distribution<double> distrib(0, 1.0);
+  std::vector<std::pair<double, int>> keys;
+  keys.reserve(n - sample_result->size());
+  for (int i = 0; i < n; i++) {
+    if (picked[i]) continue;
+    double weight = static_cast<float>(edges->get_weight(i));
+    double key = weight > 0 ? std::log(distrib(*rng)) / weight
+                            : -std::numeric_limits<double>::infinity();
+    keys.emplace_back(key, i);
+  }
+  k = std::min<int>(k, keys.size());
+  std::partial_sort(keys.begin(),
+                    keys.begin() + k,
+                    keys.end(),
+                    [](const std::pair<double, int> &a,
+                       const std::pair<double, int> &b) {
+                      return a.first > b.first;
+                    });
+  for (int i = 0; i < k; i++) {
+    sample_result->push_back(keys[i].second);
+  }
+}
+
+std::vector<int> AliasSampler::sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  int n = prob_.size();
+  std::vector<int> sample_result;
+  if (k >= n) {
+    k = n;
+    sample_result.reserve(k);
+    for (int i = 0; i < k; i++) {
+      sample_result.push_back(i);
+    }
+    return sample_result;
+  }
+  sample_result.reserve(k);
+  // Rejection is cheap while k is small against the degree, give up after a
+  // bounded number of draws and finish with a full pass over the edges.
+  int max_draws = 4 * k + 16;
+  while (static_cast<int>(sample_result.size()) < k && max_draws-- > 0) {
+    int idx = draw(rng.get());
+    if (std::find(sample_result.begin(), sample_result.end(), idx) ==
+        sample_result.end()) {
+      sample_result.push_back(idx);
+    }
+  }
+  if (static_cast<int>(sample_result.size()) < k) {
+    sample_rest(k - sample_result.size(), rng.get(), &sample_result);
+  }
+  return sample_result;
+}
 }  // namespace paddle::distributed
@@ -62,5 +62,26 @@ class WeightedSampler : public Sampler {
       std::unordered_map<WeightedSampler *, int> &subtract_count_map,  // NOLINT
       float &subtract);                                                // NOLINT
 };
+
+// Weighted sampling without replacement backed by a Vose alias table.
+// The table is built once and every draw is O(1); duplicated draws are
+// rejected, which keeps the distribution of sequential weighted sampling.
+class AliasSampler : public Sampler {
+ public:
+  virtual ~AliasSampler() {}
+  virtual void build(GraphEdgeBlob *edges);
+  virtual std::vector<int> sample_k(int k,
+                                    const std::shared_ptr<std::mt19937_64> rng);
+  GraphEdgeBlob *edges = nullptr;
+
+ private:
+  int draw(std::mt19937_64 *rng);
+  void sample_rest(int k,
+                   std::mt19937_64 *rng,
+                   std::vector<int> *sample_result);
+
+  std::vector<float> prob_;
+  std::vector<int> alias_;
+};
 }  // namespace distributed
 }  // namespace paddle
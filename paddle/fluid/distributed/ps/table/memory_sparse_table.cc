@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <omp.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <sstream>
 
 #include "glog/logging.h"
@@ -38,9 +41,55 @@ PD_DEFINE_bool(pserver_enable_create_feasign_randomly,
 PD_DEFINE_int32(pserver_table_save_max_retry,
                 3,
                 "pserver_table_save_max_retry");
+PD_DEFINE_int32(pserver_table_save_thread_num,
+                20,
+                "the max number of threads saving the shards of a sparse "
+                "table");
+PD_DEFINE_int32(pserver_table_load_thread_num,
+                15,
+                "the max number of threads loading the shards of a sparse "
+                "table");
+PD_DEFINE_string(pserver_table_save_compressor,
+                 "gzip",
+                 "the compressor of the sparse tables saved with "
+                 "compress_in_save, gzip or zstd");
 
 namespace paddle::distributed {
 
+// The number of rows of a push task updated by one call of the accessor.
+static constexpr size_t kPushUpdateBatchSize = 64;
+
+int MemorySparseTable::SaveThreadNum(int shard_num) {
+#ifdef PADDLE_WITH_HETERPS
+  return shard_num;
+#else
+  return std::max(1, std::min(shard_num, FLAGS_pserver_table_save_thread_num));
+#endif
+}
+
+int MemorySparseTable::LoadThreadNum(int shard_num) {
+#ifdef PADDLE_WITH_HETERPS
+  return shard_num;
+#else
+  return std::max(1, std::min(shard_num, FLAGS_pserver_table_load_thread_num));
+#endif
+}
+
+const char *MemorySparseTable::CompressSuffix() {
+  return FLAGS_pserver_table_save_compressor == "zstd" ? ".zst" : ".gz";
+}
+
+void MemorySparseTable::LogThroughput(const std::string &what,
+                                      uint64_t feasign_num,
+                                      uint64_t bytes,
+                                      double seconds) {
+  double mb = bytes / 1024.0 / 1024.0;
+  LOG(INFO) << what << " " << feasign_num << " feasigns, " << mb << " MB in "
+            << seconds << " s, "
+            << (seconds > 0 ? mb / seconds : 0) << " MB/s, "
+            << (seconds > 0 ? feasign_num / seconds : 0) << " feasigns/s";
+}
+
 int32_t MemorySparseTable::Initialize() {
   auto &profiler = CostProfiler::instance();
   profiler.register_profiler("pserver_sparse_update_all");
@@ -70,13 +119,42 @@ int32_t MemorySparseTable::InitializeValue() {
   _task_pool_size = _sparse_table_shard_num;
 #endif
   _use_gpu_graph = _config.use_gpu_graph();
+  _bucket_group_num = std::max<int>(
+      1,
+      std::min<int>(_config.bucket_group_num(), CTR_SPARSE_SHARD_BUCKET_NUM));
+  if (_bucket_group_num > 1 && !_support_bucket_groups) {
+    LOG(WARNING) << "bucket_group_num " << _bucket_group_num
+                 << " is not supported by this table, use 1";
+    _bucket_group_num = 1;
+  }
+  // each bucket group of a shard is served by its own task pool
+  _task_pool_size *= _bucket_group_num;
   VLOG(1) << "memory sparse table _avg_local_shard_num: "
           << _avg_local_shard_num
           << " _real_local_shard_num: " << _real_local_shard_num
           << " _task_pool_size:" << _task_pool_size
+          << " _bucket_group_num:" << _bucket_group_num
           << " _use_gpu_graph:" << _use_gpu_graph;
 
   _local_shards.reset(new shard_type[_real_local_shard_num]);
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    _local_shards[i].set_concurrent_buckets(_bucket_group_num > 1);
+  }
+
+  _enable_incremental_save = _config.enable_incremental_save();
+  if (_enable_incremental_save) {
+    _pushed_keys.resize(_real_local_shard_num * _bucket_group_num);
+    _shrunk_keys.resize(_real_local_shard_num);
+    _decayed_shards.assign(_real_local_shard_num, 0);
+  }
+  _admit_count = static_cast<int>(_config.admit_count());
+  if (_admit_count > 1) {
+    _admit_sketches.resize(_real_local_shard_num * _bucket_group_num);
+    for (auto &sketch : _admit_sketches) {
+      sketch.Resize(_config.admit_sketch_width());
+    }
+  }
+  _incremental_shrink = _config.incremental_shrink();
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -101,6 +179,9 @@ int32_t MemorySparseTable::InitializeValue() {
               << _m_avg_local_shard_num << "|" << _m_real_local_shard_num
               << "]";
     _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      _local_shards_new[i].set_concurrent_buckets(_bucket_group_num > 1);
+    }
   }
   return 0;
 }
@@ -116,6 +197,16 @@ int32_t MemorySparseTable::Load(const std::string &path,
   }
 
   int load_param = atoi(param.c_str());
+  // an incremental save has a file of the shrunk keys for each shard
+  std::vector<std::string> delete_file_list;
+  if (load_param == 6) {
+    auto it = std::stable_partition(
+        file_list.begin(), file_list.end(), [](const std::string &file) {
+          return file.find(".delete") == std::string::npos;
+        });
+    delete_file_list.assign(it, file_list.end());
+    file_list.erase(it, file_list.end());
+  }
   size_t expect_shard_num = _sparse_table_shard_num;
   if (file_list.size() != expect_shard_num) {
     LOG(WARNING) << "MemorySparseTable file_size:" << file_list.size()
@@ -137,14 +228,19 @@ int32_t MemorySparseTable::Load(const std::string &path,
     return 0;
   }
 
+  // the keys shrunk before the rows were saved, a key pushed again after
+  // it was shrunk is deleted and then loaded
+  if (load_param == 6 && LoadDeletedKeys(delete_file_list, load_param) != 0) {
+    return -1;
+  }
+
   size_t feature_value_size =
       _value_accessor->GetAccessorInfo().size / sizeof(float);
+  std::atomic<uint64_t> feasign_size_all{0};
+  std::atomic<uint64_t> bytes_all{0};
+  auto start = std::chrono::steady_clock::now();
 
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 15 ? _real_local_shard_num : 15;
-#endif
+  int thread_num = LoadThreadNum(_real_local_shard_num);
 
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
@@ -167,6 +263,8 @@ int32_t MemorySparseTable::Load(const std::string &path,
       auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
       char *end = nullptr;
       auto &shard = _local_shards[i];
+      uint64_t feasign_size = 0;
+      uint64_t bytes = 0;
       try {
         while (read_channel->read_line(line_data) == 0 &&
                line_data.size() > 1) {
@@ -176,8 +274,12 @@ int32_t MemorySparseTable::Load(const std::string &path,
           int parse_size =
               _value_accessor->ParseFromString(++end, value.data());
           value.resize(parse_size);
+          ++feasign_size;
+          bytes += line_data.size() + 1;
         }
         read_channel->close();
+        feasign_size_all += feasign_size;
+        bytes_all += bytes;
         if (err_no == -1) {
           ++retry_num;
           is_read_failed = true;
@@ -200,6 +302,12 @@ int32_t MemorySparseTable::Load(const std::string &path,
   LOG(INFO) << "MemorySparseTable load success, path from "
             << file_list[file_start_idx] << " to "
             << file_list[file_start_idx + _real_local_shard_num - 1];
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  LogThroughput("MemorySparseTable loaded",
+                feasign_size_all,
+                bytes_all,
+                elapsed.count());
   return 0;
 }
 
@@ -303,6 +411,61 @@ int32_t MemorySparseTable::LoadPatch(const std::vector<std::string> &file_list,
   return 0;
 }
 
+int32_t MemorySparseTable::LoadDeletedKeys(
+    const std::vector<std::string> &file_list, int load_param) {
+  size_t expect_shard_num = _sparse_table_shard_num;
+  if (file_list.size() != expect_shard_num) {
+    LOG(WARNING) << "MemorySparseTable delete file_size:" << file_list.size()
+                 << " not equal to expect_shard_num:" << expect_shard_num;
+    return -1;
+  }
+  size_t file_start_idx = _shard_idx * _avg_local_shard_num;
+  std::atomic<uint64_t> delete_size_all{0};
+
+  int thread_num = LoadThreadNum(_real_local_shard_num);
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    FsChannelConfig channel_config = {};
+    channel_config.path = file_list[file_start_idx + i];
+    channel_config.converter = _value_accessor->Converter(load_param).converter;
+    channel_config.deconverter =
+        _value_accessor->Converter(load_param).deconverter;
+    // deleting a key twice does nothing, a failed read is just read again
+    bool is_read_failed = false;
+    int retry_num = 0;
+    int err_no = 0;
+    auto &shard = _local_shards[i];
+    do {
+      is_read_failed = false;
+      err_no = 0;
+      std::string line_data;
+      uint64_t delete_size = 0;
+      auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
+      while (read_channel->read_line(line_data) == 0 && !line_data.empty()) {
+        delete_size += shard.erase(std::strtoul(line_data.data(), nullptr, 10));
+      }
+      read_channel->close();
+      if (err_no == -1) {
+        ++retry_num;
+        is_read_failed = true;
+        LOG(ERROR) << "MemorySparseTable load deleted keys failed, retry it! "
+                   << "path:" << channel_config.path
+                   << " , retry_num=" << retry_num;
+      } else {
+        delete_size_all += delete_size;
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable load failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_read_failed);
+  }
+  LOG(INFO) << "MemorySparseTable deleted " << delete_size_all
+            << " shrunk keys";
+  return 0;
+}
+
 void MemorySparseTable::Revert() {
   for (int i = 0; i < _real_local_shard_num; ++i) {
     _local_shards_new[i].clear();
@@ -337,11 +500,19 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
     _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      _local_shards_new[i].set_concurrent_buckets(_bucket_group_num > 1);
+    }
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
   }
 
+  // incremental model
+  if (save_param == 6) {
+    return SaveIncremental(dirname, save_param);
+  }
+
   // cache model
   int64_t tk_size = LocalSize() * _config.sparse_table_cache_rate();
   TopkCalculator tk(_real_local_shard_num, tk_size);
@@ -350,24 +521,23 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   _afs_client.remove(::paddle::string::format_string(
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
   std::atomic<uint32_t> feasign_size_all{0};
+  std::atomic<uint64_t> bytes_all{0};
+  auto start = std::chrono::steady_clock::now();
 
   size_t file_start_idx = _avg_local_shard_num * _shard_idx;
 
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
-#endif
+  int thread_num = SaveThreadNum(_real_local_shard_num);
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
     FsChannelConfig channel_config = {};
     if (_config.compress_in_save() && (save_param == 0 || save_param == 3)) {
       channel_config.path =
-          ::paddle::string::format_string("%s/part-%03d-%05d.gz",
+          ::paddle::string::format_string("%s/part-%03d-%05d%s",
                                           table_path.c_str(),
                                           _shard_idx,
-                                          file_start_idx + i);
+                                          file_start_idx + i,
+                                          CompressSuffix());
     } else {
       channel_config.path = ::paddle::string::format_string("%s/part-%03d-%05d",
                                                             table_path.c_str(),
@@ -379,6 +549,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
         _value_accessor->Converter(save_param).deconverter;
     bool is_write_failed = false;
     int feasign_size = 0;
+    uint64_t bytes = 0;
     int retry_num = 0;
     int err_no = 0;
     auto &shard = _local_shards[i];
@@ -393,6 +564,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
     do {
       err_no = 0;
       feasign_size = 0;
+      bytes = 0;
       is_write_failed = false;
       auto write_channel =
           _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
@@ -407,8 +579,9 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
         if (_value_accessor->Save(it.value().data(), save_param)) {
           std::string format_value = _value_accessor->ParseToString(
               it.value().data(), it.value().size());
-          if (0 != write_channel->write_line(::paddle::string::format_string(
-                       "%lu %s", it.key(), format_value.c_str()))) {
+          std::string line = ::paddle::string::format_string(
+              "%lu %s", it.key(), format_value.c_str());
+          if (0 != write_channel->write_line(line)) {
             ++retry_num;
             is_write_failed = true;
             LOG(ERROR)
@@ -417,6 +590,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
             break;
           }
           ++feasign_size;
+          bytes += line.size() + 1;
         }
       }
       write_channel->close();
@@ -436,6 +610,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
       }
     } while (is_write_failed);
     feasign_size_all += feasign_size;
+    bytes_all += bytes;
     if (!_use_gpu_graph) {
       for (auto it = shard.begin(); it != shard.end(); ++it) {
         _value_accessor->UpdateStatAfterSave(it.value().data(), save_param);
@@ -449,10 +624,187 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
               << channel_config.path << " feasign_size: " << feasign_size;
   }
   _local_show_threshold = tk.top();
+  // the next incremental save is relative to this checkpoint
+  if (_enable_incremental_save && save_param == 0) {
+    for (auto &log : _pushed_keys) {
+      log.Clear();
+    }
+    for (auto &log : _shrunk_keys) {
+      log.Clear();
+    }
+    std::fill(_decayed_shards.begin(), _decayed_shards.end(), 0);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  LogThroughput("MemorySparseTable saved",
+                feasign_size_all,
+                bytes_all,
+                elapsed.count());
   // int32 may overflow need to change return value
   return 0;
 }
 
+int32_t MemorySparseTable::SaveIncremental(const std::string &dirname,
+                                           int save_param) {
+  if (!_enable_incremental_save) {
+    LOG(ERROR) << "MemorySparseTable save param 6 needs the table to be "
+                  "configured with enable_incremental_save";
+    return -1;
+  }
+  std::string table_path = TableDir(dirname);
+  _afs_client.remove(::paddle::string::format_string(
+      "%s/part-%03d-*", table_path.c_str(), _shard_idx));
+  std::atomic<uint64_t> feasign_size_all{0};
+  std::atomic<uint64_t> delete_size_all{0};
+  std::atomic<uint64_t> bytes_all{0};
+  auto start = std::chrono::steady_clock::now();
+
+  // Writes the keys of `logs` to `channel_config`, with their values when
+  // `shard` is given, or all the rows of `shard` when `logs` is null. A key
+  // shrunk after it was pushed is not in the shard any more, it is only in
+  // the delete file.
+  auto write_keys = [this](const FsChannelConfig &channel_config,
+                           const std::vector<KeyLog *> *logs,
+                           shard_type *shard,
+                           uint64_t *feasign_size,
+                           uint64_t *bytes) {
+    bool is_write_failed = false;
+    int retry_num = 0;
+    do {
+      int err_no = 0;
+      *feasign_size = 0;
+      *bytes = 0;
+      is_write_failed = false;
+      auto write_channel =
+          _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      auto write_line = [&](const std::string &line) {
+        if (0 != write_channel->write_line(line)) {
+          ++retry_num;
+          is_write_failed = true;
+          LOG(ERROR) << "MemorySparseTable save incremental failed, retry "
+                        "it! path:"
+                     << channel_config.path << " , retry_num=" << retry_num;
+          return;
+        }
+        ++*feasign_size;
+        *bytes += line.size() + 1;
+      };
+      auto write_row = [&](uint64_t key, const FixedFeatureValue &value) {
+        std::string format_value =
+            _value_accessor->ParseToString(value.data(), value.size());
+        write_line(::paddle::string::format_string(
+            "%lu %s", key, format_value.c_str()));
+      };
+      if (logs == nullptr) {
+        for (auto it = shard->begin(); it != shard->end() && !is_write_failed;
+             ++it) {
+          write_row(it.key(), it.value());
+        }
+      }
+      for (size_t i = 0; logs != nullptr && i < logs->size(); ++i) {
+        for (uint64_t key : (*logs)[i]->keys) {
+          if (is_write_failed) {
+            break;
+          }
+          if (shard == nullptr) {
+            write_line(std::to_string(key));
+            continue;
+          }
+          auto it = shard->find(key);
+          if (it != shard->end()) {
+            write_row(key, it.value());
+          }
+        }
+      }
+      write_channel->close();
+      if (err_no == -1) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable save incremental failed after write, "
+                      "retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
+      if (is_write_failed) {
+        _afs_client.remove(channel_config.path);
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable save incremental failed reach max "
+                      "limit!";
+        exit(-1);
+      }
+    } while (is_write_failed);
+  };
+
+  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  const char *suffix = _config.compress_in_save() ? CompressSuffix() : "";
+
+  int thread_num = SaveThreadNum(_real_local_shard_num);
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    std::vector<KeyLog *> pushed_logs;
+    for (int j = 0; j < _bucket_group_num; ++j) {
+      auto &log = _pushed_keys[i * _bucket_group_num + j];
+      log.Compact();
+      pushed_logs.push_back(&log);
+    }
+    auto &shard = _local_shards[i];
+    KeyLog &shrunk_log = _shrunk_keys[i];
+    shrunk_log.Compact();
+
+    FsChannelConfig channel_config = {};
+    channel_config.converter = _value_accessor->Converter(save_param).converter;
+    channel_config.deconverter =
+        _value_accessor->Converter(save_param).deconverter;
+    uint64_t feasign_size = 0;
+    uint64_t delete_size = 0;
+    uint64_t bytes = 0;
+    uint64_t delete_bytes = 0;
+    channel_config.path =
+        ::paddle::string::format_string("%s/part-%03d-%05d%s",
+                                        table_path.c_str(),
+                                        _shard_idx,
+                                        file_start_idx + i,
+                                        suffix);
+    // the rows of a shard decayed by a shrink all changed
+    write_keys(channel_config,
+               _decayed_shards[i] ? nullptr : &pushed_logs,
+               &shard,
+               &feasign_size,
+               &bytes);
+    channel_config.path =
+        ::paddle::string::format_string("%s/part-%03d-%05d.delete%s",
+                                        table_path.c_str(),
+                                        _shard_idx,
+                                        file_start_idx + i,
+                                        suffix);
+    std::vector<KeyLog *> shrunk_logs = {&shrunk_log};
+    write_keys(
+        channel_config, &shrunk_logs, nullptr, &delete_size, &delete_bytes);
+
+    for (auto *log : pushed_logs) {
+      log->Clear();
+    }
+    shrunk_log.Clear();
+    _decayed_shards[i] = 0;
+    feasign_size_all += feasign_size;
+    delete_size_all += delete_size;
+    bytes_all += bytes + delete_bytes;
+    VLOG(1) << "MemorySparseTable save incremental success, path: "
+            << channel_config.path << " feasign_size: " << feasign_size
+            << " delete_size: " << delete_size;
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  LOG(INFO) << "MemorySparseTable saved " << delete_size_all
+            << " deleted keys incrementally";
+  LogThroughput("MemorySparseTable saved incrementally",
+                feasign_size_all,
+                bytes_all,
+                elapsed.count());
+  return 0;
+}
+
 #if defined(PADDLE_WITH_HETERPS) && defined(PADDLE_WITH_PSCORE)
 int32_t MemorySparseTable::Save_v2(const std::string &dirname,
                                    const std::string &param) {
@@ -489,11 +841,7 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
 
   size_t file_start_idx = _avg_local_shard_num * _shard_idx;
 
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
-#endif
+  int thread_num = SaveThreadNum(_real_local_shard_num);
   omp_set_num_threads(thread_num);
 
 #pragma omp parallel for schedule(dynamic)
@@ -915,25 +1263,33 @@ int64_t MemorySparseTable::LocalSize() {
 }
 
 int64_t MemorySparseTable::LocalMFSize() {
-  std::vector<int64_t> size_arr(_real_local_shard_num, 0);
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  // counted per bucket group, so that it runs on the same task pools as the
+  // pulls and pushes of the groups
+  const int task_num = _real_local_shard_num * _bucket_group_num;
+  std::vector<int64_t> size_arr(task_num, 0);
+  std::vector<std::future<int>> tasks(task_num);
   int64_t ret_size = 0;
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] =
-        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
-            [this, shard_id, &size_arr]() -> int {
-              auto &local_shard = _local_shards[shard_id];
-              for (auto it = local_shard.begin(); it != local_shard.end();
-                   ++it) {
-                if (_value_accessor->HasMF(it.value().size())) {
-                  size_arr[shard_id] += 1;
-                }
+  for (int task_id = 0; task_id < task_num; ++task_id) {
+    tasks[task_id] = _shards_task_pool[task_id % _task_pool_size]->enqueue(
+        [this, task_id, &size_arr]() -> int {
+          auto &local_shard = _local_shards[task_id / _bucket_group_num];
+          size_t bucket_begin = 0;
+          size_t bucket_end = 0;
+          GroupBuckets(task_id % _bucket_group_num, &bucket_begin, &bucket_end);
+          for (size_t bucket = bucket_begin; bucket < bucket_end; ++bucket) {
+            for (auto it = local_shard.begin(bucket);
+                 it != local_shard.end(bucket);
+                 ++it) {
+              if (_value_accessor->HasMF(it.value().size())) {
+                size_arr[task_id] += 1;
               }
-              return 0;
-            });
+            }
+          }
+          return 0;
+        });
   }
-  for (int i = 0; i < _real_local_shard_num; ++i) {
-    tasks[i].wait();
+  for (auto &task : tasks) {
+    task.wait();
   }
   for (auto x : size_arr) {
     ret_size += x;
@@ -976,7 +1332,8 @@ int32_t MemorySparseTable::Push(TableContext &context) {
 int32_t MemorySparseTable::PullSparse(float *pull_values,
                                       const PullSparseValue &pull_value) {
   CostTimer timer("pserver_sparse_select_all");
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  const int task_num = _real_local_shard_num * _bucket_group_num;
+  std::vector<std::future<int>> tasks(task_num);
 
   const size_t value_size =
       _value_accessor->GetAccessorInfo().size / sizeof(float);
@@ -986,29 +1343,29 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
       _value_accessor->GetAccessorInfo().select_size / sizeof(float);
   // std::atomic<uint32_t> missed_keys{0};
 
-  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
-      _real_local_shard_num);
+  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(task_num);
   size_t num = pull_value.numel_;
   for (size_t i = 0; i < num; ++i) {
     int shard_id = (pull_value.feasigns_[i] % _sparse_table_shard_num) %
                    _avg_local_shard_num;
-    task_keys[shard_id].push_back({pull_value.feasigns_[i], i});
+    task_keys[TaskIndex(shard_id, pull_value.feasigns_[i])].push_back(
+        {pull_value.feasigns_[i], i});
   }
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] =
-        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+  for (int task_id = 0; task_id < task_num; ++task_id) {
+    tasks[task_id] =
+        _shards_task_pool[task_id % _shards_task_pool.size()]->enqueue(
             [this,
-             shard_id,
+             task_id,
              &task_keys,
              value_size,
              pull_values,
              mf_value_size,
              select_value_size]() -> int {
-              auto &local_shard = _local_shards[shard_id];
+              auto &local_shard = _local_shards[task_id / _bucket_group_num];
               float data_buffer[value_size];  // NOLINT
               float *data_buffer_ptr = data_buffer;
 
-              auto &keys = task_keys[shard_id];
+              auto &keys = task_keys[task_id];
               for (auto &item : keys) {
                 uint64_t key = item.first;
                 auto itr = local_shard.find(key);
@@ -1024,6 +1381,9 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
                     _value_accessor->Create(&data_buffer_ptr, 1);
                     memcpy(
                         data_ptr, data_buffer_ptr, data_size * sizeof(float));
+                    if (_enable_incremental_save) {
+                      _pushed_keys[task_id].Add(key);
+                    }
                   }
                 } else {
                   data_size = itr.value().size();
@@ -1060,25 +1420,25 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
   size_t mf_value_size =
       _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
 
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
-  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
-      _real_local_shard_num);
+  const int task_num = _real_local_shard_num * _bucket_group_num;
+  std::vector<std::future<int>> tasks(task_num);
+  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(task_num);
   for (size_t i = 0; i < num; ++i) {
     int shard_id = (keys[i] % _sparse_table_shard_num) % _avg_local_shard_num;
-    task_keys[shard_id].push_back({keys[i], i});
+    task_keys[TaskIndex(shard_id, keys[i])].push_back({keys[i], i});
   }
   // std::atomic<uint32_t> missed_keys{0};
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] =
-        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+  for (int task_id = 0; task_id < task_num; ++task_id) {
+    tasks[task_id] =
+        _shards_task_pool[task_id % _task_pool_size]->enqueue(
             [this,
-             shard_id,
+             task_id,
              &task_keys,
              pull_values,
              value_size,
              mf_value_size]() -> int {
-              auto &keys = task_keys[shard_id];
-              auto &local_shard = _local_shards[shard_id];
+              auto &keys = task_keys[task_id];
+              auto &local_shard = _local_shards[task_id / _bucket_group_num];
               float data_buffer[value_size];  // NOLINT
               float *data_buffer_ptr = data_buffer;
               for (auto &item : keys) {
@@ -1094,6 +1454,11 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
                   _value_accessor->Create(&data_buffer_ptr, 1);
                   memcpy(data_ptr, data_buffer_ptr, data_size * sizeof(float));
                   ret = &feature_value;
+                  // the row is updated through the pointer, it is logged
+                  // as pushed
+                  if (_enable_incremental_save) {
+                    _pushed_keys[task_id].Add(key);
+                  }
                 } else {
                   ret = itr.value_ptr();
                 }
@@ -1113,12 +1478,12 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                                       const float *values,
                                       size_t num) {
   CostTimer timer("pserver_sparse_update_all");
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
-  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
-      _real_local_shard_num);
+  const int task_num = _real_local_shard_num * _bucket_group_num;
+  std::vector<std::future<int>> tasks(task_num);
+  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(task_num);
   for (size_t i = 0; i < num; ++i) {
     int shard_id = (keys[i] % _sparse_table_shard_num) % _avg_local_shard_num;
-    task_keys[shard_id].push_back({keys[i], i});
+    task_keys[TaskIndex(shard_id, keys[i])].push_back({keys[i], i});
   }
 
   const size_t value_col =
@@ -1128,20 +1493,36 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
   size_t update_value_col =
       _value_accessor->GetAccessorInfo().update_size / sizeof(float);
 
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
+  for (int task_id = 0; task_id < task_num; ++task_id) {
+    tasks[task_id] = _shards_task_pool[task_id % _task_pool_size]->enqueue(
         [this,
-         shard_id,
+         task_id,
          value_col,
          mf_value_col,
          update_value_col,
          values,
          &task_keys]() -> int {
-          auto &keys = task_keys[shard_id];
+          const int shard_id = task_id / _bucket_group_num;
+          auto &keys = task_keys[task_id];
           auto &local_shard = _local_shards[shard_id];
           auto &local_shard_new = _local_shards_new[shard_id];
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
+          // the rows extended to the full size are updated in place in
+          // batches, one at a time if they are copied to the revert shard
+          const size_t batch_size =
+              _config.enable_revert() ? 1 : kPushUpdateBatchSize;
+          std::vector<float *> batch_values;
+          std::vector<const float *> batch_updates;
+          auto flush = [&]() {
+            if (!batch_values.empty()) {
+              _value_accessor->Update(batch_values.data(),
+                                      batch_updates.data(),
+                                      batch_values.size());
+              batch_values.clear();
+              batch_updates.clear();
+            }
+          };
           for (auto &item : keys) {
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
@@ -1153,6 +1534,9 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                   !_value_accessor->CreateValue(1, update_data)) {
                 continue;
               }
+              if (!AdmitKey(task_id, key)) {
+                continue;
+              }
               auto value_size = value_col - mf_value_col;
               auto &feature_value = local_shard[key];
               feature_value.resize(value_size);
@@ -1168,7 +1552,11 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             size_t value_size = feature_value.size();
 
             if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
+              batch_values.push_back(value_data);
+              batch_updates.push_back(update_data);
+              if (batch_values.size() >= batch_size) {
+                flush();
+              }
             } else {
               // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
               memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
@@ -1181,6 +1569,9 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
               }
               memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
             }
+            if (_enable_incremental_save) {
+              _pushed_keys[task_id].Add(key);
+            }
             if (_config.enable_revert()) {
               FixedFeatureValue *feature_value_new = &(local_shard_new[key]);
               auto new_size = feature_value.size();
@@ -1190,6 +1581,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                      new_size * sizeof(float));
             }
           }
+          flush();
           return 0;
         });
   }
@@ -1203,25 +1595,36 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
 int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                                       const float **values,
                                       size_t num) {
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
-  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
-      _real_local_shard_num);
+  const int task_num = _real_local_shard_num * _bucket_group_num;
+  std::vector<std::future<int>> tasks(task_num);
+  std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(task_num);
   for (size_t i = 0; i < num; ++i) {
     int shard_id = (keys[i] % _sparse_table_shard_num) % _avg_local_shard_num;
-    task_keys[shard_id].push_back({keys[i], i});
+    task_keys[TaskIndex(shard_id, keys[i])].push_back({keys[i], i});
   }
 
   size_t value_col = _value_accessor->GetAccessorInfo().size / sizeof(float);
   size_t mf_value_col =
       _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
 
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
-        [this, shard_id, value_col, mf_value_col, values, &task_keys]() -> int {
-          auto &keys = task_keys[shard_id];
-          auto &local_shard = _local_shards[shard_id];
+  for (int task_id = 0; task_id < task_num; ++task_id) {
+    tasks[task_id] = _shards_task_pool[task_id % _task_pool_size]->enqueue(
+        [this, task_id, value_col, mf_value_col, values, &task_keys]() -> int {
+          auto &keys = task_keys[task_id];
+          auto &local_shard = _local_shards[task_id / _bucket_group_num];
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
+          std::vector<float *> batch_values;
+          std::vector<const float *> batch_updates;
+          auto flush = [&]() {
+            if (!batch_values.empty()) {
+              _value_accessor->Update(batch_values.data(),
+                                      batch_updates.data(),
+                                      batch_values.size());
+              batch_values.clear();
+              batch_updates.clear();
+            }
+          };
           for (auto &item : keys) {
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
@@ -1232,6 +1635,9 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                   !_value_accessor->CreateValue(1, update_data)) {
                 continue;
               }
+              if (!AdmitKey(task_id, key)) {
+                continue;
+              }
               auto value_size = value_col - mf_value_col;
               auto &feature_value = local_shard[key];
               feature_value.resize(value_size);
@@ -1245,7 +1651,11 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             float *value_data = feature_value.data();
             size_t value_size = feature_value.size();
             if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
+              batch_values.push_back(value_data);
+              batch_updates.push_back(update_data);
+              if (batch_values.size() >= kPushUpdateBatchSize) {
+                flush();
+              }
             } else {
               // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
               memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
@@ -1257,7 +1667,11 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
               }
               memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
             }
+            if (_enable_incremental_save) {
+              _pushed_keys[task_id].Add(key);
+            }
           }
+          flush();
           return 0;
         });
   }
@@ -1271,6 +1685,9 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
 int32_t MemorySparseTable::Flush() { return 0; }
 
 int32_t MemorySparseTable::Shrink(const std::string &param) {
+  if (_incremental_shrink) {
+    return IncrementalShrink();
+  }
   VLOG(0) << "MemorySparseTable::Shrink";
   std::atomic<uint32_t> shrink_size_all{0};
   int thread_num = _real_local_shard_num;
@@ -1282,12 +1699,24 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     auto &shard = _local_shards[shard_id];
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accessor->Shrink(it.value().data())) {
+        if (_enable_incremental_save) {
+          _shrunk_keys[shard_id].Add(it.key());
+        }
         it = shard.erase(it);
         ++feasign_size;
       } else {
         ++it;
       }
     }
+    if (_admit_count > 1) {
+      for (int group = 0; group < _bucket_group_num; ++group) {
+        _admit_sketches[shard_id * _bucket_group_num + group].Halve();
+      }
+    }
+    // the accessor decays the rows it keeps in place
+    if (_enable_incremental_save) {
+      _decayed_shards[shard_id] = 1;
+    }
     shrink_size_all += feasign_size;
   }
   VLOG(0) << "MemorySparseTable::Shrink success, shrink size:"
@@ -1295,6 +1724,65 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
   return 0;
 }
 
+int32_t MemorySparseTable::IncrementalShrink() {
+  VLOG(0) << "MemorySparseTable::IncrementalShrink";
+  const int task_num = _real_local_shard_num * _bucket_group_num;
+  const int bucket_num = static_cast<int>(CTR_SPARSE_SHARD_BUCKET_NUM);
+  const int round_num =
+      (bucket_num + _bucket_group_num - 1) / _bucket_group_num;
+  // the keys shrunk by each task in a round, logged after the round since
+  // the tasks of a shard share its log
+  std::vector<std::vector<uint64_t>> shrunk_keys(task_num);
+  uint64_t shrink_size_all = 0;
+  for (int round = 0; round < round_num; ++round) {
+    std::vector<std::future<int>> tasks;
+    for (int task_id = 0; task_id < task_num; ++task_id) {
+      size_t group_begin = 0;
+      size_t group_end = 0;
+      GroupBuckets(task_id % _bucket_group_num, &group_begin, &group_end);
+      const size_t bucket = group_begin + round;
+      if (bucket >= group_end) {
+        continue;
+      }
+      tasks.push_back(
+          _shards_task_pool[task_id % _task_pool_size]->enqueue(
+              [this, task_id, bucket, round, &shrunk_keys]() -> int {
+                auto &shard = _local_shards[task_id / _bucket_group_num];
+                auto &keys = shrunk_keys[task_id];
+                for (auto it = shard.begin(bucket); it != shard.end(bucket);) {
+                  if (_value_accessor->Shrink(it.value().data())) {
+                    keys.push_back(it.key());
+                    it = shard.erase(bucket, it);
+                  } else {
+                    ++it;
+                  }
+                }
+                if (_admit_count > 1 && round == 0) {
+                  _admit_sketches[task_id].Halve();
+                }
+                return 0;
+              }));
+    }
+    for (auto &task : tasks) {
+      task.wait();
+    }
+    for (int task_id = 0; task_id < task_num; ++task_id) {
+      auto &keys = shrunk_keys[task_id];
+      shrink_size_all += keys.size();
+      if (_enable_incremental_save) {
+        for (auto key : keys) {
+          _shrunk_keys[task_id / _bucket_group_num].Add(key);
+        }
+        _decayed_shards[task_id / _bucket_group_num] = 1;
+      }
+      keys.clear();
+    }
+  }
+  VLOG(0) << "MemorySparseTable::IncrementalShrink success, shrink size:"
+          << shrink_size_all;
+  return 0;
+}
+
 void MemorySparseTable::Clear() { VLOG(0) << "clear coming soon"; }
 
 }  // namespace paddle::distributed
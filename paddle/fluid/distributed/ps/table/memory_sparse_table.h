@@ -18,6 +18,8 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
@@ -118,8 +120,124 @@ class MemorySparseTable : public Table {
   virtual int32_t SavePatch(const std::string& path, int save_param);
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
+  // save param 6, writes the keys pushed or created by a pull since the last
+  // incremental save and the keys shrunk since then, and starts tracking
+  // them anew. A shard shrunk since then is written whole, since the shrink
+  // decays all its rows.
+  virtual int32_t SaveIncremental(const std::string& path, int save_param);
+  // load param 6, erases the shrunk keys saved with the rows
+  virtual int32_t LoadDeletedKeys(const std::vector<std::string>& file_list,
+                                  int load_param);
+
+  // The number of threads saving and loading the local shards, and the
+  // suffix of the files saved with compress_in_save, set by the flags.
+  static int SaveThreadNum(int shard_num);
+  static int LoadThreadNum(int shard_num);
+  static const char* CompressSuffix();
+  static void LogThroughput(const std::string& what,
+                            uint64_t feasign_num,
+                            uint64_t bytes,
+                            double seconds);
+
+  // With bucket_group_num > 1, the buckets of a shard are split into groups
+  // and each (shard, group) is pulled and pushed by a fixed task pool, so
+  // that a hot shard is no longer served by a single thread.
+  size_t TaskIndex(int shard_id, uint64_t key) {
+    if (_bucket_group_num == 1) {
+      return shard_id;
+    }
+    size_t bucket = _local_shards[shard_id].bucket_of(key);
+    return shard_id * _bucket_group_num +
+           bucket * _bucket_group_num / CTR_SPARSE_SHARD_BUCKET_NUM;
+  }
+
+  // The buckets [*begin, *end) of a shard mapped to `group` by TaskIndex.
+  void GroupBuckets(int group, size_t *begin, size_t *end) const {
+    const size_t bucket_num = CTR_SPARSE_SHARD_BUCKET_NUM;
+    const size_t group_num = _bucket_group_num;
+    *begin = (group * bucket_num + group_num - 1) / group_num;
+    *end = ((group + 1) * bucket_num + group_num - 1) / group_num;
+  }
+
+  // The keys changed since the last incremental save, appended and
+  // deduplicated each time the log doubles, so that a key takes about 8
+  // bytes however often it is pushed.
+  struct KeyLog {
+    void Add(uint64_t key) {
+      keys.push_back(key);
+      if (keys.size() >= 2 * unique_size + 1024) {
+        Compact();
+      }
+    }
+    void Compact() {
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      unique_size = keys.size();
+    }
+    void Clear() {
+      std::vector<uint64_t>().swap(keys);
+      unique_size = 0;
+    }
+    std::vector<uint64_t> keys;
+    size_t unique_size = 0;
+  };
+
+  // The push counts of the keys not yet admitted, estimated by a count-min
+  // sketch with conservative update, which only overestimates them.
+  struct CountMinSketch {
+    static constexpr int kDepth = 4;
+    void Resize(size_t sketch_width) {
+      width = std::max<size_t>(sketch_width, 1);
+      counters.assign(kDepth * width, 0);
+    }
+    // count a push of key and return its estimated count
+    uint32_t Add(uint64_t key) {
+      size_t index[kDepth];
+      uint16_t count = std::numeric_limits<uint16_t>::max();
+      for (int row = 0; row < kDepth; ++row) {
+        index[row] = Index(key, row);
+        count = std::min(count, counters[index[row]]);
+      }
+      if (count == std::numeric_limits<uint16_t>::max()) {
+        return count;
+      }
+      for (int row = 0; row < kDepth; ++row) {
+        if (counters[index[row]] == count) {
+          ++counters[index[row]];
+        }
+      }
+      return count + 1;
+    }
+    // age the counts, so that a key has to be pushed recently to be admitted
+    void Halve() {
+      for (auto &counter : counters) {
+        counter >>= 1;
+      }
+    }
+    size_t Index(uint64_t key, int row) const {
+      uint64_t hash = key + 0x9e3779b97f4a7c15ULL * (row + 1);
+      hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+      hash ^= hash >> 31;
+      return row * width + hash % width;
+    }
+    size_t width = 1;
+    std::vector<uint16_t> counters;
+  };
+
+  // Whether the row of the new key may be created by the push of a task.
+  bool AdmitKey(int task_id, uint64_t key) {
+    return _admit_count <= 1 || _admit_sketches[task_id].Add(key) >=
+                                    static_cast<uint32_t>(_admit_count);
+  }
+
+  // Shrink the buckets of each shard one at a time on the task pools.
+  int32_t IncrementalShrink();
 
   int _task_pool_size = 24;
+  int _bucket_group_num = 1;
+  // Tables that run whole-shard tasks keep one bucket group per shard.
+  bool _support_bucket_groups = true;
   int _avg_local_shard_num;
   int _real_local_shard_num;
   int _sparse_table_shard_num;
@@ -137,6 +255,20 @@ class MemorySparseTable : public Table {
   std::unique_ptr<shard_type[]> _local_shards_patch_model;
   std::thread _save_patch_model_thread;
   bool _use_gpu_graph = false;
+
+  // for incremental save, the keys pushed by each task and the keys shrunk
+  // from each local shard, the tasks of a shard are merged on save
+  bool _enable_incremental_save = false;
+  std::vector<KeyLog> _pushed_keys;
+  std::vector<KeyLog> _shrunk_keys;
+  // the local shards shrunk since the last save, one byte each since they
+  // are set by concurrent tasks
+  std::vector<uint8_t> _decayed_shards;
+
+  // for feature admission, a sketch of each task
+  int _admit_count = 0;
+  std::vector<CountMinSketch> _admit_sketches;
+  bool _incremental_shrink = false;
 };
 
 }  // namespace distributed
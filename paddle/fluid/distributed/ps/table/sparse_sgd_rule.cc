@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/distributed/ps/table/sparse_sgd_rule.h"
 
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
 #include "glog/logging.h"
 
 #include "paddle/common/flags.h"
@@ -22,6 +26,19 @@ PD_DEFINE_bool(enable_show_scale_gradient, true, "enable show scale gradient");
 
 namespace paddle::distributed {
 
+#ifdef __AVX__
+// The weights are updated in double like the scalar code, four lanes at a
+// time, and bounded like BoundValue after they are rounded to float, where
+// a NaN becomes the min bound.
+static inline void StoreBounded(float *w,
+                                __m256d value,
+                                __m128 min_bound,
+                                __m128 max_bound) {
+  __m128 bounded = _mm_max_ps(_mm256_cvtpd_ps(value), min_bound);
+  _mm_storeu_ps(w, _mm_min_ps(bounded, max_bound));
+}
+#endif
+
 void SparseNaiveSGDRule::LoadConfig(const SparseCommonSGDRuleParameter &param,
                                     size_t emb_dim) {
   _embedding_dim = emb_dim;
@@ -105,6 +122,53 @@ void SparseAdaGradSGDRule::UpdateValueWork(float *w,
   g2sum += add_g2sum / _embedding_dim;
 }
 
+void SparseAdaGradSGDRule::UpdateValuesWork(float **w,
+                                            float **sgd,
+                                            const float **grads,
+                                            const float *scales,
+                                            size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    float *value = w[k];
+    const float *grad = grads[k];
+    const float scale = scales[k];
+    float &g2sum = sgd[k][G2SumIndex()];
+    const double ratio = sqrt(_initial_g2sum / (_initial_g2sum + g2sum));
+    double add_g2sum = 0;
+    size_t i = 0;
+#ifdef __AVX__
+    const __m256d lr = _mm256_set1_pd(learning_rate_);
+    const __m256d ratios = _mm256_set1_pd(ratio);
+    const __m128 scales4 = _mm_set1_ps(scale);
+    const __m128 min_bound = _mm_set1_ps(_min_bound);
+    const __m128 max_bound = _mm_set1_ps(_max_bound);
+    for (; i + 4 <= _embedding_dim; i += 4) {
+      __m256d scaled_grad =
+          _mm256_cvtps_pd(_mm_div_ps(_mm_loadu_ps(grad + i), scales4));
+      __m256d step =
+          _mm256_mul_pd(_mm256_mul_pd(lr, scaled_grad), ratios);
+      StoreBounded(value + i,
+                   _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(value + i)),
+                                 step),
+                   min_bound,
+                   max_bound);
+      // summed in order, so g2sum is the same as the scalar one
+      double squares[4];
+      _mm256_storeu_pd(squares, _mm256_mul_pd(scaled_grad, scaled_grad));
+      for (double square : squares) {
+        add_g2sum += square;
+      }
+    }
+#endif
+    for (; i < _embedding_dim; i++) {
+      double scaled_grad = grad[i] / scale;
+      value[i] -= learning_rate_ * scaled_grad * ratio;
+      BoundValue(value[i]);
+      add_g2sum += scaled_grad * scaled_grad;
+    }
+    g2sum += add_g2sum / _embedding_dim;
+  }
+}
+
 void SparseAdaGradSGDRule::InitValueWork(float *value,
                                          float *sgd,
                                          bool zero_init) {
@@ -226,6 +290,61 @@ void SparseAdamSGDRule::UpdateValueWork(float *w,
   (*beta2_pow) *= _beta2_decay_rate;
 }
 
+void SparseAdamSGDRule::UpdateValuesWork(float **w,
+                                         float **sgd,
+                                         const float **grads,
+                                         const float *scales,
+                                         size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    float *value = w[k];
+    const float *g = grads[k];
+    float *gsum = sgd[k] + GSumIndex();
+    float *g2sum = sgd[k] + G2SumIndex();
+    float *beta1_pow = sgd[k] + Beta1PowIndex();
+    float *beta2_pow = sgd[k] + Beta2PowIndex();
+    float lr = learning_rate_;
+    lr *= sqrt(1 - *beta2_pow) / (1 - *beta1_pow);
+    size_t i = 0;
+#ifdef __AVX__
+    // the scalar update is all in float, so eight lanes are updated at a time
+    const __m256 beta1 = _mm256_set1_ps(_beta1_decay_rate);
+    const __m256 beta1_rest = _mm256_set1_ps(1 - _beta1_decay_rate);
+    const __m256 beta2 = _mm256_set1_ps(_beta2_decay_rate);
+    const __m256 beta2_rest = _mm256_set1_ps(1 - _beta2_decay_rate);
+    const __m256 lrs = _mm256_set1_ps(lr);
+    const __m256 epsilon = _mm256_set1_ps(_ada_epsilon);
+    const __m256 min_bound = _mm256_set1_ps(_min_bound);
+    const __m256 max_bound = _mm256_set1_ps(_max_bound);
+    for (; i + 8 <= _embedding_dim; i += 8) {
+      __m256 grad = _mm256_loadu_ps(g + i);
+      __m256 new_gsum =
+          _mm256_add_ps(_mm256_mul_ps(beta1, _mm256_loadu_ps(gsum + i)),
+                        _mm256_mul_ps(beta1_rest, grad));
+      __m256 new_g2sum =
+          _mm256_add_ps(_mm256_mul_ps(beta2, _mm256_loadu_ps(g2sum + i)),
+                        _mm256_mul_ps(_mm256_mul_ps(beta2_rest, grad), grad));
+      _mm256_storeu_ps(gsum + i, new_gsum);
+      _mm256_storeu_ps(g2sum + i, new_g2sum);
+      __m256 denom = _mm256_add_ps(_mm256_sqrt_ps(new_g2sum), epsilon);
+      __m256 new_value =
+          _mm256_sub_ps(_mm256_loadu_ps(value + i),
+                        _mm256_mul_ps(lrs, _mm256_div_ps(new_gsum, denom)));
+      new_value = _mm256_max_ps(new_value, min_bound);
+      _mm256_storeu_ps(value + i, _mm256_min_ps(new_value, max_bound));
+    }
+#endif
+    for (; i < _embedding_dim; i++) {
+      gsum[i] = _beta1_decay_rate * gsum[i] + (1 - _beta1_decay_rate) * g[i];
+      g2sum[i] =
+          _beta2_decay_rate * g2sum[i] + (1 - _beta2_decay_rate) * g[i] * g[i];
+      value[i] = value[i] - lr * (gsum[i] / (sqrt(g2sum[i]) + _ada_epsilon));
+      BoundValue(value[i]);
+    }
+    (*beta1_pow) *= _beta1_decay_rate;
+    (*beta2_pow) *= _beta2_decay_rate;
+  }
+}
+
 void SparseAdamSGDRule::InitValueWork(float *value,
                                       float *sgd,
                                       bool zero_init) {
@@ -309,6 +428,77 @@ void SparseSharedAdamSGDRule::UpdateValueWork(float *w,
   (*beta2_pow) *= _beta2_decay_rate;
 }
 
+void SparseSharedAdamSGDRule::UpdateValuesWork(float **w,
+                                               float **sgd,
+                                               const float **grads,
+                                               const float *scales,
+                                               size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    float *value = w[k];
+    const float *g = grads[k];
+    float *gsum = sgd[k] + GSumIndex();
+    float *g2sum = sgd[k] + G2SumIndex();
+    float *beta1_pow = sgd[k] + Beta1PowIndex();
+    float *beta2_pow = sgd[k] + Beta2PowIndex();
+    float lr = learning_rate_;
+    lr *= sqrt(1 - *beta2_pow) / (1 - *beta1_pow);
+    const float gsum_ = *gsum;
+    const float g2sum_ = *g2sum;
+    double sum_gsum = 0.0;
+    double sum_g2sum = 0.0;
+    size_t i = 0;
+#ifdef __AVX__
+    const __m128 decayed_gsum = _mm_set1_ps(_beta1_decay_rate * gsum_);
+    const __m128 beta1_rest = _mm_set1_ps(1 - _beta1_decay_rate);
+    const __m128 decayed_g2sum = _mm_set1_ps(_beta2_decay_rate * g2sum_);
+    const __m128 beta2_rest = _mm_set1_ps(1 - _beta2_decay_rate);
+    const __m256d lrs = _mm256_set1_pd(lr);
+    const __m256d epsilon = _mm256_set1_pd(_ada_epsilon);
+    const __m128 min_bound = _mm_set1_ps(_min_bound);
+    const __m128 max_bound = _mm_set1_ps(_max_bound);
+    for (; i + 4 <= _embedding_dim; i += 4) {
+      __m128 grad = _mm_loadu_ps(g + i);
+      __m128 new_gsum =
+          _mm_add_ps(decayed_gsum, _mm_mul_ps(beta1_rest, grad));
+      __m128 new_g2sum = _mm_add_ps(
+          decayed_g2sum, _mm_mul_ps(_mm_mul_ps(beta2_rest, grad), grad));
+      __m256d denom = _mm256_add_pd(
+          _mm256_sqrt_pd(_mm256_cvtps_pd(new_g2sum)), epsilon);
+      __m256d step =
+          _mm256_mul_pd(lrs, _mm256_div_pd(_mm256_cvtps_pd(new_gsum), denom));
+      StoreBounded(value + i,
+                   _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(value + i)),
+                                 step),
+                   min_bound,
+                   max_bound);
+      // summed in order, so the shared moments are the same as the scalar
+      float gsums[4];
+      float g2sums[4];
+      _mm_storeu_ps(gsums, new_gsum);
+      _mm_storeu_ps(g2sums, new_g2sum);
+      for (int lane = 0; lane < 4; ++lane) {
+        sum_gsum += gsums[lane];
+        sum_g2sum += g2sums[lane];
+      }
+    }
+#endif
+    for (; i < _embedding_dim; i++) {
+      double new_gsum =
+          _beta1_decay_rate * gsum_ + (1 - _beta1_decay_rate) * g[i];
+      double new_g2sum =
+          _beta2_decay_rate * g2sum_ + (1 - _beta2_decay_rate) * g[i] * g[i];
+      value[i] = value[i] - lr * (new_gsum / (sqrt(new_g2sum) + _ada_epsilon));
+      BoundValue(value[i]);
+      sum_gsum += new_gsum;
+      sum_g2sum += new_g2sum;
+    }
+    (*gsum) = sum_gsum / _embedding_dim;
+    (*g2sum) = sum_g2sum / _embedding_dim;
+    (*beta1_pow) *= _beta1_decay_rate;
+    (*beta2_pow) *= _beta2_decay_rate;
+  }
+}
+
 void SparseSharedAdamSGDRule::InitValueWork(float *value,
                                             float *sgd,
                                             bool zero_init) {
@@ -51,6 +51,25 @@ class SparseValueSGDRule {
                    float scale = 1) {
     UpdateValueWork(w, sgd, push_value, scale);
   }
+  // Update the values of num keys with one call, the same as num calls of
+  // UpdateValue. The rules overriding UpdateValuesWork vectorize the update
+  // of the embedding of a key.
+  virtual void UpdateValuesWork(float** w,
+                                float** sgd,
+                                const float** push_values,
+                                const float* scales,
+                                size_t num) {
+    for (size_t i = 0; i < num; ++i) {
+      UpdateValueWork(w[i], sgd[i], push_values[i], scales[i]);
+    }
+  }
+  void UpdateValues(float** w,
+                    float** sgd,
+                    const float** push_values,
+                    const float* scales,
+                    size_t num) {
+    UpdateValuesWork(w, sgd, push_values, scales, num);
+  }
   template <class T>
   void BoundValue(T& w) {  // NOLINT
     if (!(w >= _min_bound)) {
@@ -97,6 +116,11 @@ class SparseAdaGradSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValuesWork(float** w,
+                                float** sgd,
+                                const float** push_values,
+                                const float* scales,
+                                size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 1; }
   size_t G2SumIndex() { return 0; }
@@ -151,6 +175,11 @@ class SparseAdamSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValuesWork(float** w,
+                                float** sgd,
+                                const float** push_values,
+                                const float* scales,
+                                size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim * 2 + 2; }
   size_t GSumIndex() { return 0; }
@@ -173,6 +202,11 @@ class SparseSharedAdamSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValuesWork(float** w,
+                                float** sgd,
+                                const float** push_values,
+                                const float* scales,
+                                size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 4; }
   size_t GSumIndex() { return 0; }
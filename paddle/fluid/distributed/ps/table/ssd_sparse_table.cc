@@ -14,6 +14,9 @@
 
 #include "paddle/fluid/distributed/ps/table/ssd_sparse_table.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/common/local_random.h"
@@ -25,6 +28,10 @@ PD_DECLARE_bool(pserver_create_value_when_push);
 PD_DECLARE_bool(pserver_enable_create_feasign_randomly);
 PD_DEFINE_bool(pserver_open_strict_check, false, "pserver_open_strict_check");
 PD_DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
+PD_DEFINE_int32(pserver_ssd_table_save_writer_num,
+                1,
+                "the number of threads writing the files of each shard when "
+                "saving the ssd sparse table in binary");
 PHI_DEFINE_EXPORTED_string(rocksdb_path,
                            "database",
                            "path of sparse table rocksdb file");
@@ -109,44 +116,31 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                 auto& local_shard = _local_shards[shard_id];
                 float data_buffer[value_size];  // NOLINT
                 float* data_buffer_ptr = data_buffer;
+                // fetch all keys missed in memory from rocksdb at once
+                std::vector<uint64_t> ssd_keys;
+                for (auto& item : keys) {
+                  if (local_shard.find(item.first) == local_shard.end()) {
+                    ssd_keys.push_back(item.first);
+                  }
+                }
+                LoadFromSSD(shard_id, &ssd_keys);
                 for (size_t i = 0; i < keys.size(); ++i) {
                   uint64_t key = keys[i].first;
                   auto itr = local_shard.find(key);
                   size_t data_size = value_size - mf_value_size;
                   if (itr == local_shard.end()) {
-                    // pull rocksdb
-                    std::string tmp_string("");
-                    if (_db->get(shard_id,
-                                 reinterpret_cast<char*>(&key),
-                                 sizeof(uint64_t),
-                                 tmp_string) > 0) {
-                      ++missed_keys;
-                      if (FLAGS_pserver_create_value_when_push) {
-                        memset(data_buffer, 0, sizeof(float) * data_size);
-                      } else {
-                        auto& feature_value = local_shard[key];
-                        feature_value.resize(data_size);
-                        float* data_ptr =
-                            const_cast<float*>(feature_value.data());
-                        _value_accessor->Create(&data_buffer_ptr, 1);
-                        memcpy(data_ptr,
-                               data_buffer_ptr,
-                               data_size * sizeof(float));
-                      }
+                    // missed both in memory and rocksdb
+                    ++missed_keys;
+                    if (FLAGS_pserver_create_value_when_push) {
+                      memset(data_buffer, 0, sizeof(float) * data_size);
                     } else {
-                      data_size = tmp_string.size() / sizeof(float);
-                      memcpy(data_buffer_ptr,
-                             ::paddle::string::str_to_float(tmp_string),
-                             data_size * sizeof(float));
-                      // from rocksdb to mem
                       auto& feature_value = local_shard[key];
                       feature_value.resize(data_size);
-                      memcpy(const_cast<float*>(feature_value.data()),
-                             data_buffer_ptr,
-                             data_size * sizeof(float));
-                      _db->del_data(shard_id,
-                                    reinterpret_cast<char*>(&key),
-                                    sizeof(uint64_t));
+                      float* data_ptr =
+                          const_cast<float*>(feature_value.data());
+                      _value_accessor->Create(&data_buffer_ptr, 1);
+                      memcpy(
+                          data_ptr, data_buffer_ptr, data_size * sizeof(float));
                     }
                   } else {
                     data_size = itr.value().size();
@@ -178,6 +172,55 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
   return 0;
 }
 
+void SSDSparseTable::LoadFromSSD(int shard_id, std::vector<uint64_t>* keys) {
+  if (keys->empty()) {
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  // MultiGet requires the keys sorted by the comparator of the db
+  std::sort(keys->begin(), keys->end());
+  keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+  size_t num_keys = keys->size();
+  std::vector<rocksdb::Slice> batch_keys;
+  batch_keys.reserve(num_keys);
+  for (auto& key : *keys) {
+    batch_keys.emplace_back(reinterpret_cast<const char*>(&key),
+                            sizeof(uint64_t));
+  }
+  std::vector<rocksdb::PinnableSlice> batch_values(num_keys);
+  std::vector<rocksdb::Status> status(num_keys);
+  _db->multi_get(shard_id,
+                 num_keys,
+                 batch_keys.data(),
+                 batch_values.data(),
+                 status.data());
+
+  auto& local_shard = _local_shards[shard_id];
+  std::vector<rocksdb::Slice> found_keys;
+  for (size_t i = 0; i < num_keys; ++i) {
+    if (!status[i].ok()) {
+      continue;
+    }
+    // from rocksdb to mem
+    size_t data_size = batch_values[i].size() / sizeof(float);
+    auto& feature_value = local_shard[(*keys)[i]];
+    feature_value.resize(data_size);
+    memcpy(const_cast<float*>(feature_value.data()),
+           ::paddle::string::str_to_float(batch_values[i].data()),
+           data_size * sizeof(float));
+    found_keys.push_back(batch_keys[i]);
+  }
+  if (!found_keys.empty()) {
+    _db->del_data_batch(shard_id, found_keys.data(), found_keys.size());
+  }
+
+  _ssd_hit_count += found_keys.size();
+  _ssd_miss_count += num_keys - found_keys.size();
+  _ssd_read_time_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+}
+
 int32_t SSDSparseTable::PullSparsePtr(int shard_id,
                                       char** pull_values,
                                       const uint64_t* pull_keys,
@@ -558,19 +601,36 @@ int32_t SSDSparseTable::UpdateTable() {
   int count = 0;
   for (int i = 0; i < _real_local_shard_num; ++i) {
     auto& shard = _local_shards[i];
-    // from mem to ssd
-    for (auto it = shard.begin(); it != shard.end();) {
-      if (_value_accessor->SaveSSD(it.value().data())) {
-        _db->put(i,
-                 reinterpret_cast<const char*>(&it.key()),
-                 sizeof(uint64_t),
-                 reinterpret_cast<const char*>(it.value().data()),
-                 it.value().size() * sizeof(float));
-        count++;
-        it = shard.erase(it);
-      } else {
-        ++it;
+    // from mem to ssd, the values are written in batches for each bucket
+    // and erased after the whole bucket is written
+    for (size_t bucket = 0; bucket < shard.bucket_count(); ++bucket) {
+      std::vector<std::pair<uint64_t, FixedFeatureValue*>> evict_keys;
+      std::vector<std::pair<char*, int>> ssd_keys;
+      std::vector<std::pair<char*, int>> ssd_values;
+      for (auto it = shard.begin(bucket); it != shard.end(bucket); ++it) {
+        if (_value_accessor->SaveSSD(it.value().data())) {
+          evict_keys.emplace_back(it.key(), &it.value());
+        }
+      }
+      for (size_t begin = 0; begin < evict_keys.size();
+           begin += FLAGS_pserver_load_batch_size) {
+        size_t end = std::min(evict_keys.size(),
+                              begin + FLAGS_pserver_load_batch_size);
+        ssd_keys.clear();
+        ssd_values.clear();
+        for (size_t k = begin; k < end; ++k) {
+          FixedFeatureValue* value = evict_keys[k].second;
+          ssd_keys.emplace_back(reinterpret_cast<char*>(&evict_keys[k].first),
+                                sizeof(uint64_t));
+          ssd_values.emplace_back(reinterpret_cast<char*>(value->data()),
+                                  value->size() * sizeof(float));
+        }
+        _db->put_batch(i, ssd_keys, ssd_values, end - begin);
       }
+      for (auto& item : evict_keys) {
+        shard.erase(item.first);
+      }
+      count += evict_keys.size();
     }
     _db->flush(i);
   }
@@ -664,11 +724,7 @@ int32_t SSDSparseTable::SaveWithString(const std::string& path,
   std::string table_path = TableDir(path);
   _afs_client.remove(::paddle::string::format_string(
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
-#endif
+  int thread_num = SaveThreadNum(_real_local_shard_num);
 
   // std::atomic<uint32_t> feasign_size;
   std::atomic<uint32_t> feasign_size_all{0};
@@ -838,11 +894,7 @@ int32_t SSDSparseTable::SaveWithStringMultiOutput(const std::string& path,
   std::string table_path = TableDir(path);
   _afs_client.remove(::paddle::string::format_string(
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
-#endif
+  int thread_num = SaveThreadNum(_real_local_shard_num);
 
   std::atomic<uint32_t> feasign_size_all{0};
   std::vector<::paddle::framework::Channel<std::shared_ptr<MemRegion>>>
@@ -1129,11 +1181,7 @@ int32_t SSDSparseTable::SaveWithStringMultiOutput_v2(const std::string& path,
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
   _afs_client.remove(paddle::string::format_string(
       "%s/slot_feature/part-%03d-*", table_path.c_str(), _shard_idx));
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
-#endif
+  int thread_num = SaveThreadNum(_real_local_shard_num);
 
   std::atomic<uint32_t> feasign_size_all{0};
   std::atomic<uint32_t> feasign_size_all_for_slot_feature{0};
@@ -1580,13 +1628,14 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
   std::string table_path = TableDir(path);
   _afs_client.remove(paddle::string::format_string(
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
-#endif
+  int thread_num = SaveThreadNum(_real_local_shard_num);
 
   std::atomic<uint32_t> feasign_size_all{0};
+  std::atomic<uint64_t> bytes_all{0};
+  auto start = std::chrono::steady_clock::now();
+  // The regions of a shard go to the writer of their file, so that the split
+  // files of a shard are written in parallel.
+  int writer_num = std::max(1, FLAGS_pserver_ssd_table_save_writer_num);
   std::vector<::paddle::framework::Channel<std::shared_ptr<MemRegion>>>
       busy_channel;
   std::vector<::paddle::framework::Channel<std::shared_ptr<MemRegion>>>
@@ -1594,24 +1643,31 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
   std::vector<std::thread> threads;
 
   for (int i = 0; i < _real_local_shard_num; i++) {
-    busy_channel.push_back(
-        ::paddle::framework::MakeChannel<std::shared_ptr<MemRegion>>());
+    for (int j = 0; j < writer_num; j++) {
+      busy_channel.push_back(
+          ::paddle::framework::MakeChannel<std::shared_ptr<MemRegion>>());
+    }
     free_channel.push_back(
         ::paddle::framework::MakeChannel<std::shared_ptr<MemRegion>>());
   }
-  threads.resize(_real_local_shard_num);
+  threads.resize(_real_local_shard_num * writer_num);
+  auto put_busy = [&busy_channel, writer_num](
+                      int shard, const std::shared_ptr<MemRegion>& region) {
+    busy_channel[shard * writer_num + region->_file_idx % writer_num]->Put(
+        region);
+  };
 
   auto save_func = [this,
                     &save_param,
                     &table_path,
                     &file_start_idx,
                     &free_channel,
-                    &busy_channel](int file_num) {
+                    &busy_channel,
+                    &bytes_all,
+                    writer_num](int writer_idx) {
     int err_no = 0;
-    int shard_num = file_num;
+    int shard_num = writer_idx / writer_num;
     int part_num = 0;
-    shard_num = file_num;
-    part_num = 0;
     FsChannelConfig channel_config;
     channel_config.converter = _value_accessor->Converter(save_param).converter;
     channel_config.deconverter =
@@ -1625,12 +1681,13 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
                            int part_num,
                            int split_num) {
       if (compress && (save_param == 0 || save_param == 3)) {
-        return paddle::string::format_string("%s/part-%03d-%05d-%03d-%03d.gz",
+        return paddle::string::format_string("%s/part-%03d-%05d-%03d-%03d%s",
                                              table_path,
                                              node_num,
                                              shard_num,
                                              part_num,
-                                             split_num);
+                                             split_num,
+                                             CompressSuffix());
       } else {
         return paddle::string::format_string("%s/part-%03d-%05d-%03d-%03d",
                                              table_path,
@@ -1645,7 +1702,7 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
     int last_file_idx = -1;
     std::shared_ptr<FsWriteChannel> write_channel = nullptr;
     if (save_param != 1 && save_param != 2) {
-      while (busy_channel[shard_num]->Get(region)) {
+      while (busy_channel[writer_idx]->Get(region)) {
         if (region->_file_idx != last_file_idx) {
           filename = get_filename(_config.compress_in_save(),
                                   save_param,
@@ -1666,11 +1723,12 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
           PADDLE_THROW(common::errors::Fatal(ss.str()));
           CHECK(false);
         }
+        bytes_all += region->_cur;
         region->reset();
         free_channel[shard_num]->Put(region);
       }
     } else {
-      while (busy_channel[shard_num]->Get(region)) {
+      while (busy_channel[writer_idx]->Get(region)) {
         if (region->_file_idx != last_file_idx) {
           filename = get_filename(_config.compress_in_save(),
                                   save_param,
@@ -1701,13 +1759,15 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
           int dim = len / sizeof(float);
 
           std::string format_value = _value_accessor->ParseToString(value, dim);
-          if (0 != write_channel->write_line(paddle::string::format_string(
-                       "%lu %s", k, format_value.c_str()))) {
+          std::string line =
+              paddle::string::format_string("%lu %s", k, format_value.c_str());
+          if (0 != write_channel->write_line(line)) {
             std::stringstream ss;
             ss << "SSDSparseTable save failed, retry it! path:"
                << channel_config.path;
             PADDLE_THROW(common::errors::Fatal(ss.str()));
           }
+          bytes_all += line.size() + 1;
           remain -= len;
           cursor += len;
         }
@@ -1726,8 +1786,10 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
   for (size_t i = 0; i < static_cast<size_t>(_real_local_shard_num); ++i) {
     std::shared_ptr<MemRegion> region = nullptr;
     std::vector<std::shared_ptr<MemRegion>> regions;
-    free_channel[i]->Put(std::make_shared<MemRegion>());
-    free_channel[i]->Put(std::make_shared<MemRegion>());
+    // one region is filled while the others are written
+    for (int j = 0; j <= writer_num; ++j) {
+      free_channel[i]->Put(std::make_shared<MemRegion>());
+    }
     free_channel[i]->Get(region);
     int feasign_size = 0;
     auto& shard = _local_shards[i];
@@ -1744,7 +1806,7 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
                          sizeof(uint32_t);
           int region_idx = i;
           if (!region->buff_remain(len)) {
-            busy_channel[region_idx]->Put(region);
+            put_busy(region_idx, region);
             free_channel[region_idx]->Get(region);
             region->_file_idx = 0;
           }
@@ -1768,7 +1830,7 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
     if (save_param != 1) {
       int file_idx = 1;
       int switch_cnt = 0;
-      busy_channel[i]->Put(region);
+      put_busy(i, region);
       free_channel[i]->Get(region);
       region->_file_idx = file_idx;
       auto* it = _db->get_iterator(i);
@@ -1784,7 +1846,7 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
           uint64_t key = *(
               reinterpret_cast<uint64_t*>(const_cast<char*>(it->key().data())));
           if (!region->buff_remain(len)) {
-            busy_channel[region_idx]->Put(region);
+            put_busy(region_idx, region);
             free_channel[region_idx]->Get(region);
             switch_cnt += 1;
             if (switch_cnt % 1024 == 0) {
@@ -1811,7 +1873,7 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
       delete it;
     }
     if (region->_cur) {
-      busy_channel[i]->Put(region);
+      put_busy(i, region);
     }
     feasign_size_all += feasign_size;
     for (auto it = shard.begin(); it != shard.end(); ++it) {
@@ -1824,9 +1886,11 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
   for (size_t i = 0; i < threads.size(); i++) {
     threads[i].join();
   }
-  for (size_t i = 0; i < busy_channel.size(); i++) {
-    busy_channel[i].reset();
-    free_channel[i].reset();
+  for (auto& channel : busy_channel) {
+    channel.reset();
+  }
+  for (auto& channel : free_channel) {
+    channel.reset();
   }
 
   busy_channel.clear();
@@ -1847,6 +1911,12 @@ int32_t SSDSparseTable::SaveWithBinary(const std::string& path,
                                            _shard_idx)
           << " from " << file_start_idx << " to "
           << file_start_idx + _real_local_shard_num - 1;
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  LogThroughput("SSDSparseTable saved in binary",
+                feasign_size_all,
+                bytes_all,
+                elapsed.count());
   if (_config.enable_sparse_table_cache()) {
     _local_show_threshold = tk.top();
     VLOG(0) << "local cache threshold: " << _local_show_threshold;
@@ -1882,11 +1952,7 @@ int32_t SSDSparseTable::SaveWithBinary_v2(const std::string& path,
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
   _afs_client.remove(paddle::string::format_string(
       "%s/slot_feature/part-%03d-*", table_path.c_str(), _shard_idx));
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
-#endif
+  int thread_num = SaveThreadNum(_real_local_shard_num);
 
   std::atomic<uint32_t> feasign_size_all{0};
   std::atomic<uint32_t> feasign_size_all_for_slot_feature{0};
@@ -2566,11 +2632,7 @@ int32_t SSDSparseTable::LoadWithString(
   size_t mf_value_size =
       _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
 
-#ifdef PADDLE_WITH_HETERPS
-  int thread_num = _real_local_shard_num;
-#else
-  int thread_num = _real_local_shard_num < 15 ? _real_local_shard_num : 15;
-#endif
+  int thread_num = LoadThreadNum(_real_local_shard_num);
 
   for (int i = 0; i < _real_local_shard_num; i++) {
     _fs_channel.push_back(::paddle::framework::MakeChannel<std::string>(30000));
@@ -2722,6 +2784,9 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
       "%s/part-%03d*", path.c_str(), _shard_idx));
   // #pragma omp parallel for schedule(dynamic)
   std::vector<std::future<int>> tasks;
+  std::atomic<uint64_t> feasign_size_all{0};
+  std::atomic<uint64_t> bytes_all{0};
+  auto start = std::chrono::steady_clock::now();
 
   for (int shard_idx = 0; shard_idx < _real_local_shard_num; shard_idx++) {
     // FsChannelConfig channel_config;
@@ -2744,7 +2809,9 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
                                         shard_idx,
                                         filename,
                                         file_split_idx,
-                                        param]() -> int {
+                                        param,
+                                        &feasign_size_all,
+                                        &bytes_all]() -> int {
         // &channel_config]() -> int {
         FsChannelConfig channel_config;
         channel_config.converter = _value_accessor->Converter(param).converter;
@@ -2820,6 +2887,7 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
           if (ret <= 0) {
             break;
           }
+          bytes_all += ret;
           cursor = buf;
           convert_cursor = convert_buf;
           ret += remain;
@@ -2905,6 +2973,7 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
         }
         free(buf);
         free(convert_buf);
+        feasign_size_all += mem_count + ssd_count;
         // read_channel->close();
         // VLOG(0) << "[last_k: " << last_k << "][remain: " << remain
         //         << "][shard_idx: " << shard_idx
@@ -2933,6 +3002,12 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
       }
     }
   }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  LogThroughput("SSDSparseTable loaded in binary",
+                feasign_size_all,
+                bytes_all,
+                elapsed.count());
   uint64_t ssd_key_num = 0;
   _db->get_estimate_key_num(ssd_key_num);
   _cache_tk_size =
@@ -2942,6 +3017,11 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
 
 std::pair<int64_t, int64_t> SSDSparseTable::PrintTableStat() {
   int64_t feasign_size = LocalSize();
+  uint64_t ssd_reads = _ssd_hit_count + _ssd_miss_count;
+  LOG(INFO) << "SSDSparseTable>> ssd read keys: " << ssd_reads
+            << " ssd hit keys: " << _ssd_hit_count
+            << " ssd miss keys: " << _ssd_miss_count << " ssd read avg time: "
+            << (ssd_reads == 0 ? 0 : _ssd_read_time_us / ssd_reads) << "us";
   return {feasign_size, -1};
 }
 
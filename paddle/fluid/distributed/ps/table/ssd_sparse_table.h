@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <vector>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/table/depends/rocksdb_warpper.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
@@ -59,7 +62,8 @@ class MemRegion {
 class SSDSparseTable : public MemorySparseTable {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
-  SSDSparseTable() {}
+  // the rocksdb pulls and pushes of a shard run as whole-shard tasks
+  SSDSparseTable() { _support_bucket_groups = false; }
   virtual ~SSDSparseTable() {}
 
   int32_t Initialize() override;
@@ -131,12 +135,20 @@ class SSDSparseTable : public MemorySparseTable {
   void SetDayId(int day_id) override;
 
  private:
+  // Move the values of keys from rocksdb into the memory shard with one
+  // batched MultiGet. Keys not found in rocksdb are left untouched.
+  void LoadFromSSD(int shard_id, std::vector<uint64_t>* keys);
+
   RocksDBHandler* _db;
   int64_t _cache_tk_size;
   double _local_show_threshold{0.0};
   std::vector<paddle::framework::Channel<std::string>> _fs_channel;
   std::mutex _table_mutex;
   int _day_id = 0;
+  // statistics of the keys read from rocksdb
+  std::atomic<uint64_t> _ssd_hit_count{0};
+  std::atomic<uint64_t> _ssd_miss_count{0};
+  std::atomic<uint64_t> _ssd_read_time_us{0};
 };
 
 }  // namespace distributed
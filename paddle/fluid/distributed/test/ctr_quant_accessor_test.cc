@@ -0,0 +1,139 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/ctr_quant_accessor.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/common/registerer.h"
+#include "paddle/fluid/distributed/ps/table/sparse_sgd_rule.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle::distributed {
+REGISTER_PSCORE_CLASS(SparseValueSGDRule, SparseAdaGradSGDRule);
+REGISTER_PSCORE_CLASS(SparseValueSGDRule, StdAdaGradSGDRule);
+
+TableAccessorParameter gen_quant_param(const std::string& quant_type) {
+  TableAccessorParameter param;
+  param.set_accessor_class("CtrQuantAccessor");
+  param.set_fea_dim(11);
+  param.set_embedx_dim(8);
+  param.set_embedx_threshold(0);
+  param.mutable_ctr_accessor_param()->set_nonclk_coeff(0.2);
+  param.mutable_ctr_accessor_param()->set_click_coeff(1);
+  param.mutable_ctr_accessor_param()->set_base_threshold(0.5);
+  param.mutable_ctr_accessor_param()->set_delta_threshold(0.2);
+  param.mutable_ctr_accessor_param()->set_delta_keep_days(16);
+  param.mutable_ctr_accessor_param()->set_show_click_decay_rate(0.99);
+  param.mutable_ctr_accessor_param()->set_embedx_quant_type(quant_type);
+
+  param.mutable_embed_sgd_param()->set_name("SparseAdaGradSGDRule");
+  auto* adagrad_param = param.mutable_embed_sgd_param()->mutable_adagrad();
+  adagrad_param->set_learning_rate(0.1);
+  adagrad_param->set_initial_range(0.3);
+  adagrad_param->set_initial_g2sum(3.0);
+  adagrad_param->add_weight_bounds(-10.0);
+  adagrad_param->add_weight_bounds(10.0);
+
+  param.mutable_embedx_sgd_param()->set_name("StdAdaGradSGDRule");
+  auto* embedx_param = param.mutable_embedx_sgd_param()->mutable_adagrad();
+  embedx_param->set_learning_rate(0.1);
+  embedx_param->set_initial_range(0.3);
+  embedx_param->set_initial_g2sum(3.0);
+  embedx_param->add_weight_bounds(-10.0);
+  embedx_param->add_weight_bounds(10.0);
+
+  return param;
+}
+
+void TestQuantUpdate(const std::string& quant_type, float tolerance) {
+  TableAccessorParameter parameter = gen_quant_param(quant_type);
+  CtrQuantAccessor* acc = new CtrQuantAccessor();
+  ASSERT_EQ(acc->Configure(parameter), 0);
+  ASSERT_EQ(acc->Initialize(), 0);
+
+  // slot, unseen_days, delta_score, show, click, embed_w, embed_g2sum
+  // stay fp32, embedx_w and the 8 embedx_g2sum are packed
+  auto& qv = acc->quant_feature_value;
+  int embedx_w_dim = quant_type == "int8" ? 1 + 2 : 4;
+  ASSERT_EQ(acc->GetAccessorInfo().dim, 7 + embedx_w_dim + 4);
+  ASSERT_EQ(acc->GetAccessorInfo().mf_size,
+            (embedx_w_dim + 4) * sizeof(float));
+  ASSERT_LT(acc->GetAccessorInfo().dim, acc->common_feature_value.Dim());
+  ASSERT_TRUE(acc->HasMF(qv.Dim()));
+  ASSERT_FALSE(acc->HasMF(qv.MFIndex()));
+
+  std::vector<float> value(qv.Dim());
+  float* value_ptr = value.data();
+  ASSERT_EQ(acc->Create(&value_ptr, 1), 0);
+
+  std::vector<float> common_value(acc->common_feature_value.Dim());
+  acc->Dequantize(value.data(), common_value.data());
+  float* embedx_w =
+      common_value.data() + acc->common_feature_value.EmbedxWIndex();
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_LE(std::fabs(embedx_w[i]), 0.3 + tolerance);
+  }
+
+  // update through the quantized layout and through fp32
+  std::vector<float> push_value = {
+      1.0, 10.0, 2.0, 0.3, 0.2, -0.1, 0.4, 0.5, -0.6, 0.7, 0.8, -0.9};
+  const float* push_ptr = push_value.data();
+  std::vector<float> expected = common_value;
+  float* expected_ptr = expected.data();
+  acc->CtrCommonAccessor::Update(&expected_ptr, &push_ptr, 1);
+  ASSERT_EQ(acc->Update(&value_ptr, &push_ptr, 1), 0);
+
+  acc->Dequantize(value.data(), common_value.data());
+  for (int i = 0; i < acc->common_feature_value.EmbedxWIndex(); ++i) {
+    ASSERT_FLOAT_EQ(common_value[i], expected[i]);
+  }
+  for (int i = acc->common_feature_value.EmbedxWIndex();
+       i < acc->common_feature_value.Dim();
+       ++i) {
+    ASSERT_NEAR(common_value[i],
+                expected[i],
+                tolerance * (1 + std::fabs(expected[i])));
+  }
+
+  // pull values are dequantized
+  std::vector<float> select_value(acc->GetAccessorInfo().select_dim);
+  float* select_ptr = select_value.data();
+  const float* const_value_ptr = value.data();
+  ASSERT_EQ(acc->Select(&select_ptr, &const_value_ptr, 1), 0);
+  ASSERT_FLOAT_EQ(select_value[0], common_value[3]);
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_FLOAT_EQ(select_value[3 + i], embedx_w[i]);
+  }
+
+  // the text format is the one of CtrCommonAccessor
+  std::string str = acc->ParseToString(value.data(), qv.Dim());
+  std::vector<float> parsed(qv.Dim());
+  ASSERT_EQ(acc->ParseFromString(str, parsed.data()), qv.Dim());
+  std::vector<float> parsed_common(acc->common_feature_value.Dim());
+  acc->Dequantize(parsed.data(), parsed_common.data());
+  for (size_t i = 0; i < parsed_common.size(); ++i) {
+    ASSERT_NEAR(parsed_common[i],
+                common_value[i],
+                tolerance * (1 + std::fabs(common_value[i])));
+  }
+  delete acc;
+}
+
+TEST(ctr_quant_accessor_test, test_fp16) { TestQuantUpdate("fp16", 1e-2); }
+
+TEST(ctr_quant_accessor_test, test_int8) { TestQuantUpdate("int8", 1e-2); }
+
+}  // namespace paddle::distributed
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
 
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -45,4 +46,43 @@ TEST(BENCHMARK, LargeScaleKV) {
   ASSERT_FLOAT_EQ(value_data[3], 0.3);
 }
 
+TEST(BENCHMARK, ConcurrentBuckets) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  shard.set_concurrent_buckets(true);
+
+  // every thread owns a disjoint range of buckets
+  const int thread_num = 4;
+  const int key_num_per_bucket = 100;
+  const size_t bucket_num = shard.bucket_count();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&shard, t, bucket_num, key_num_per_bucket]() {
+      for (size_t bucket = t * bucket_num / thread_num;
+           bucket < (t + 1) * bucket_num / thread_num;
+           ++bucket) {
+        for (int i = 0; i < key_num_per_bucket; ++i) {
+          uint64_t key =
+              (static_cast<uint64_t>(bucket)
+               << (64 - CTR_SPARSE_SHARD_BUCKET_NUM_BITS)) +
+              i;
+          ASSERT_EQ(shard.bucket_of(key), bucket);
+          auto& feature_value = shard[key];
+          feature_value.resize(1);
+          feature_value.data()[0] = static_cast<float>(i);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(shard.size(), bucket_num * key_num_per_bucket);
+  for (size_t bucket = 0; bucket < bucket_num; ++bucket) {
+    ASSERT_EQ(shard.bucket_size(bucket),
+              static_cast<size_t>(key_num_per_bucket));
+  }
+}
+
 }  // namespace paddle::distributed
@@ -0,0 +1,111 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_edge.h"
+
+namespace paddle {
+namespace distributed {
+
+void AddEdges(const std::vector<float>& weights, GraphEdgeBlob* edges) {
+  for (size_t i = 0; i < weights.size(); ++i) {
+    edges->add_edge(static_cast<int64_t>(i), weights[i]);
+  }
+}
+
+TEST(AliasSampler, Distribution) {
+  std::vector<float> weights = {1, 2, 3, 4};
+  WeightedGraphEdgeBlob edges;
+  AddEdges(weights, &edges);
+  AliasSampler sampler;
+  sampler.build(&edges);
+
+  auto rng = std::make_shared<std::mt19937_64>(2024);
+  constexpr int kDraws = 100000;
+  std::vector<int> counts(weights.size(), 0);
+  for (int i = 0; i < kDraws; ++i) {
+    auto result = sampler.sample_k(1, rng);
+    ASSERT_EQ(result.size(), 1UL);
+    ++counts[result[0]];
+  }
+  for (size_t i = 0; i < weights.size(); ++i) {
+    EXPECT_NEAR(static_cast<double>(counts[i]) / kDraws, weights[i] / 10, 0.01);
+  }
+
+  // the samples of k > 1 are distinct
+  for (int i = 0; i < 1000; ++i) {
+    auto result = sampler.sample_k(3, rng);
+    ASSERT_EQ(result.size(), 3UL);
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(std::unique(result.begin(), result.end()), result.end());
+  }
+}
+
+TEST(AliasSampler, ZeroWeights) {
+  WeightedGraphEdgeBlob edges;
+  AddEdges({0, 1, 0, 2, 0}, &edges);
+  AliasSampler sampler;
+  sampler.build(&edges);
+
+  auto rng = std::make_shared<std::mt19937_64>(2024);
+  for (int i = 0; i < 10000; ++i) {
+    auto result = sampler.sample_k(1, rng);
+    ASSERT_EQ(result.size(), 1UL);
+    EXPECT_TRUE(result[0] == 1 || result[0] == 3);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    auto result = sampler.sample_k(2, rng);
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, std::vector<int>({1, 3}));
+  }
+
+  // all zero weights are sampled uniformly
+  WeightedGraphEdgeBlob zero_edges;
+  AddEdges({0, 0, 0}, &zero_edges);
+  AliasSampler zero_sampler;
+  zero_sampler.build(&zero_edges);
+  std::vector<int> counts(3, 0);
+  for (int i = 0; i < 3000; ++i) {
+    ++counts[zero_sampler.sample_k(1, rng)[0]];
+  }
+  for (int count : counts) {
+    EXPECT_GT(count, 0);
+  }
+}
+
+TEST(AliasSampler, SingleEdge) {
+  WeightedGraphEdgeBlob edges;
+  AddEdges({0.5}, &edges);
+  AliasSampler sampler;
+  sampler.build(&edges);
+
+  auto rng = std::make_shared<std::mt19937_64>(2024);
+  EXPECT_EQ(sampler.sample_k(1, rng), std::vector<int>({0}));
+  EXPECT_EQ(sampler.sample_k(3, rng), std::vector<int>({0}));
+
+  WeightedGraphEdgeBlob no_edges;
+  AliasSampler empty_sampler;
+  empty_sampler.build(&no_edges);
+  EXPECT_TRUE(empty_sampler.sample_k(2, rng).empty());
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -24,6 +24,7 @@ limitations under the License. */
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/fluid/framework/io/fs.h"
 
 namespace paddle {
 namespace distributed {
@@ -152,5 +153,234 @@ TEST(MemorySparseTable, SGD) {
   }
 }
 
+TEST(MemorySparseTable, IncrementalSave) {
+  int emb_dim = 8;
+  std::string dirname = "memory_sparse_table_incremental_test";
+  paddle::framework::fs_remove(dirname);
+
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+  table_config.set_compress_in_save(false);
+  table_config.set_enable_incremental_save(true);
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(8);
+  accessor_config->set_embedx_threshold(5);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    sgd_param->mutable_naive()->set_learning_rate(0.1);
+    sgd_param->mutable_naive()->set_initial_range(0.3);
+    sgd_param->mutable_naive()->add_weight_bounds(-10.0);
+    sgd_param->mutable_naive()->add_weight_bounds(10.0);
+  }
+  FsClientParameter fs_config;
+
+  auto push = [emb_dim](Table *table, const std::vector<uint64_t> &keys) {
+    std::vector<float> values(keys.size() * (emb_dim + 4), 0.1);
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = values.data();
+    table_context.num = keys.size();
+    table->Push(table_context);
+  };
+
+  auto pull = [emb_dim](Table *table, std::vector<uint64_t> keys) {
+    std::vector<uint32_t> frequencies(keys.size(), 1);
+    std::vector<float> values(keys.size() * (emb_dim + 3));
+    auto pull_value = PullSparseValue(keys, frequencies, emb_dim);
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.pull_context.pull_value = pull_value;
+    table_context.pull_context.values = values.data();
+    table->Pull(table_context);
+  };
+
+  MemorySparseTable table;
+  table.SetShard(0, 1);
+  ASSERT_EQ(table.Initialize(table_config, fs_config), 0);
+  push(&table, {0, 1, 2, 3, 4});
+  ASSERT_EQ(table.Save(dirname + "/base", "0"), 0);
+  // only the keys pushed or created by a pull after the checkpoint are
+  // saved incrementally
+  push(&table, {3, 4, 5, 13});
+  pull(&table, {4, 20});
+  ASSERT_EQ(table.Save(dirname + "/delta", "6"), 0);
+  ASSERT_EQ(table.Save(dirname + "/empty", "6"), 0);
+
+  MemorySparseTable delta;
+  delta.SetShard(0, 1);
+  ASSERT_EQ(delta.Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(delta.Load(dirname + "/delta", "6"), 0);
+  EXPECT_EQ(delta.LocalSize(), 5);
+  ASSERT_EQ(delta.Load(dirname + "/empty", "6"), 0);
+  EXPECT_EQ(delta.LocalSize(), 5);
+
+  MemorySparseTable restored;
+  restored.SetShard(0, 1);
+  ASSERT_EQ(restored.Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(restored.Load(dirname + "/base", "0"), 0);
+  ASSERT_EQ(restored.Load(dirname + "/delta", "6"), 0);
+  EXPECT_EQ(restored.LocalSize(), table.LocalSize());
+
+  // a shrink decays the rows it keeps, the next delta has all of them
+  ASSERT_EQ(table.Shrink(""), 0);
+  ASSERT_EQ(table.Save(dirname + "/shrunk", "6"), 0);
+  MemorySparseTable shrunk;
+  shrunk.SetShard(0, 1);
+  ASSERT_EQ(shrunk.Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(shrunk.Load(dirname + "/shrunk", "6"), 0);
+  EXPECT_EQ(shrunk.LocalSize(), table.LocalSize());
+  ASSERT_EQ(restored.Load(dirname + "/shrunk", "6"), 0);
+  EXPECT_EQ(restored.LocalSize(), table.LocalSize());
+  // and the one after it only the changed rows again
+  ASSERT_EQ(table.Save(dirname + "/after_shrunk", "6"), 0);
+  MemorySparseTable after_shrunk;
+  after_shrunk.SetShard(0, 1);
+  ASSERT_EQ(after_shrunk.Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(after_shrunk.Load(dirname + "/after_shrunk", "6"), 0);
+  EXPECT_EQ(after_shrunk.LocalSize(), 0);
+  paddle::framework::fs_remove(dirname);
+}
+
+TEST(MemorySparseTable, AdmitAndIncrementalShrink) {
+  int emb_dim = 8;
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+  table_config.set_bucket_group_num(4);
+  table_config.set_admit_count(3);
+  table_config.set_incremental_shrink(true);
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(8);
+  accessor_config->set_embedx_threshold(5);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    sgd_param->mutable_naive()->set_learning_rate(0.1);
+    sgd_param->mutable_naive()->set_initial_range(0.3);
+    sgd_param->mutable_naive()->add_weight_bounds(-10.0);
+    sgd_param->mutable_naive()->add_weight_bounds(10.0);
+  }
+  FsClientParameter fs_config;
+
+  auto push = [emb_dim](Table *table,
+                        const std::vector<uint64_t> &keys,
+                        float value) {
+    std::vector<float> values(keys.size() * (emb_dim + 4), value);
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = values.data();
+    table_context.num = keys.size();
+    table->Push(table_context);
+  };
+
+  MemorySparseTable table;
+  table.SetShard(0, 1);
+  ASSERT_EQ(table.Initialize(table_config, fs_config), 0);
+  std::vector<uint64_t> keys;
+  for (uint64_t key = 0; key < 100; ++key) {
+    keys.push_back(key * 7919);
+  }
+  // the rows are created by the third push of the keys
+  push(&table, keys, 0.1);
+  push(&table, keys, 0.1);
+  EXPECT_EQ(table.LocalSize(), 0);
+  push(&table, keys, 0.1);
+  EXPECT_EQ(table.LocalSize(), 100);
+
+  // only the keys clicked enough survive the shrink, in every bucket group
+  push(&table, {keys[0], keys[1], keys[50]}, 1.0);
+  ASSERT_EQ(table.Shrink(""), 0);
+  EXPECT_EQ(table.LocalSize(), 3);
+  // the counts of the shrunk keys are aged by the shrink
+  push(&table, {keys[2]}, 0.1);
+  EXPECT_EQ(table.LocalSize(), 3);
+}
+
+TEST(MemorySparseTable, BucketGroupsPullPtrAndPush) {
+  int emb_dim = 8;
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(2);
+  table_config.set_bucket_group_num(4);
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(8);
+  accessor_config->set_embedx_threshold(5);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    sgd_param->mutable_naive()->set_learning_rate(0.1);
+    sgd_param->mutable_naive()->set_initial_range(0.3);
+    sgd_param->mutable_naive()->add_weight_bounds(-10.0);
+    sgd_param->mutable_naive()->add_weight_bounds(10.0);
+  }
+  FsClientParameter fs_config;
+
+  MemorySparseTable table;
+  table.SetShard(0, 1);
+  ASSERT_EQ(table.Initialize(table_config, fs_config), 0);
+
+  // the pulls create the even keys and the pushes the odd ones, while both
+  // update the rows of the same buckets
+  const int key_num = 4096;
+  std::vector<uint64_t> pull_keys;
+  std::vector<uint64_t> push_keys;
+  for (uint64_t key = 0; key < key_num; ++key) {
+    pull_keys.push_back(key * 2);
+    push_keys.push_back(key * 2 + 1);
+  }
+  std::vector<float> push_values(push_keys.size() * (emb_dim + 4), 0.1);
+  std::vector<char *> pull_ptrs(pull_keys.size(), nullptr);
+
+  std::thread pull_thread([&] {
+    for (int step = 0; step < 20; ++step) {
+      TableContext table_context;
+      table_context.value_type = Sparse;
+      table_context.use_ptr = true;
+      table_context.pull_context.keys = pull_keys.data();
+      table_context.pull_context.ptr_values = pull_ptrs.data();
+      table_context.num = pull_keys.size();
+      table.Pull(table_context);
+    }
+  });
+  std::thread push_thread([&] {
+    for (int step = 0; step < 20; ++step) {
+      TableContext table_context;
+      table_context.value_type = Sparse;
+      table_context.push_context.keys = push_keys.data();
+      table_context.push_context.values = push_values.data();
+      table_context.num = push_keys.size();
+      table.Push(table_context);
+    }
+  });
+  pull_thread.join();
+  push_thread.join();
+
+  EXPECT_EQ(table.LocalSize(), 2 * key_num);
+  for (auto *ptr : pull_ptrs) {
+    ASSERT_NE(ptr, nullptr);
+  }
+  // the rows pulled last are the rows kept by the table
+  std::vector<char *> ptrs(pull_keys.size(), nullptr);
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.use_ptr = true;
+  table_context.pull_context.keys = pull_keys.data();
+  table_context.pull_context.ptr_values = ptrs.data();
+  table_context.num = pull_keys.size();
+  table.Pull(table_context);
+  EXPECT_EQ(ptrs, pull_ptrs);
+  EXPECT_EQ(table.LocalSize(), 2 * key_num);
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(SparseHotKeyCache, CacheHotRows) {
+  const size_t dim = 2;
+  SparseHotKeyCache cache(2, 4, dim * sizeof(float));
+  // key 7 and key 9 are sampled in every pull, the others once
+  std::vector<std::vector<uint64_t>> pulls;
+  for (uint64_t pull = 0; pull < 4; ++pull) {
+    std::vector<uint64_t> keys(16, 100 + pull);
+    keys[0] = 7;
+    keys[8] = 9;
+    pulls.push_back(keys);
+  }
+  std::vector<float> values(16 * dim);
+  std::vector<float *> value_ptrs(16);
+  for (size_t i = 0; i < 16; ++i) {
+    value_ptrs[i] = values.data() + i * dim;
+  }
+
+  std::vector<bool> cached;
+  std::vector<uint64_t> hot_keys;
+  for (int pull = 0; pull < 3; ++pull) {
+    EXPECT_FALSE(cache.Lookup(
+        pulls[pull].data(), 16, value_ptrs.data(), &cached, &hot_keys));
+    EXPECT_EQ(cached, std::vector<bool>(16, false));
+  }
+  // the fourth pull refreshes the cache with the rows of the hot keys
+  ASSERT_TRUE(cache.Lookup(
+      pulls[3].data(), 16, value_ptrs.data(), &cached, &hot_keys));
+  EXPECT_EQ(hot_keys, (std::vector<uint64_t>{7, 9}));
+  std::vector<float> row7 = {1, 2};
+  std::vector<float> row9 = {3, 4};
+  cache.Refresh({{7, row7.data()}, {9, row9.data()}});
+  EXPECT_EQ(cache.Size(), 2UL);
+
+  std::vector<uint64_t> keys = {9, 5, 7};
+  EXPECT_FALSE(
+      cache.Lookup(keys.data(), 3, value_ptrs.data(), &cached, &hot_keys));
+  EXPECT_EQ(cached, (std::vector<bool>{true, false, true}));
+  EXPECT_EQ(values[0], 3);
+  EXPECT_EQ(values[1], 4);
+  EXPECT_EQ(values[4], 1);
+  EXPECT_EQ(values[5], 2);
+
+  // a failed refresh leaves the cache empty
+  cache.Refresh({});
+  EXPECT_EQ(cache.Size(), 0UL);
+}
+
+TEST(SparseRowCache, ServeRecentRows) {
+  const size_t dim = 2;
+  SparseRowCache cache(2, 1, dim * sizeof(float));
+  std::vector<float> values(3 * dim);
+  std::vector<float *> value_ptrs = {
+      values.data(), values.data() + dim, values.data() + 2 * dim};
+  std::vector<uint64_t> keys = {7, 9, 5};
+
+  std::vector<bool> cached;
+  uint64_t pull_num = cache.Lookup(keys.data(), 3, value_ptrs.data(), &cached);
+  EXPECT_EQ(cached, std::vector<bool>(3, false));
+  std::vector<float> row7 = {1, 2};
+  std::vector<float> row9 = {3, 4};
+  cache.Insert({{7, row7.data()}, {9, row9.data()}}, pull_num);
+
+  // the next pull is served by the rows of the last one
+  cached.clear();
+  cache.Lookup(keys.data(), 3, value_ptrs.data(), &cached);
+  EXPECT_EQ(cached, (std::vector<bool>{true, true, false}));
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[3], 4);
+  EXPECT_DOUBLE_EQ(cache.HitRate(), 2.0 / 6.0);
+
+  // the rows are too old for the pull after it
+  cached.clear();
+  cache.Lookup(keys.data(), 3, value_ptrs.data(), &cached);
+  EXPECT_EQ(cached, std::vector<bool>(3, false));
+  EXPECT_DOUBLE_EQ(cache.HitRate(), 0.0);
+}
+
+}  // namespace distributed
+}  // namespace paddle
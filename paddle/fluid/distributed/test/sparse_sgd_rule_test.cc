@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
@@ -205,5 +206,71 @@ TEST(downpour_sparse_adam_test, test_init_and_update) {
     ASSERT_FLOAT_EQ(value[i], label[i]) << "i is " << i;
   }
 }
+
+// UpdateValues of a batch of keys matches UpdateValue of each key bit by bit
+template <typename Rule>
+void CheckBatchedUpdate(size_t embed_dim) {
+  SparseCommonSGDRuleParameter param;
+  auto* adagrad_param = param.mutable_adagrad();
+  adagrad_param->set_learning_rate(0.1);
+  adagrad_param->set_initial_g2sum(3.0);
+  adagrad_param->set_initial_range(0.3);
+  adagrad_param->add_weight_bounds(-0.5);
+  adagrad_param->add_weight_bounds(0.5);
+  auto* adam_param = param.mutable_adam();
+  adam_param->set_learning_rate(0.1);
+  adam_param->set_initial_range(0.3);
+  adam_param->set_beta1_decay_rate(0.9);
+  adam_param->set_beta2_decay_rate(0.999);
+  adam_param->set_ada_epsilon(1e-08);
+  adam_param->add_weight_bounds(-0.5);
+  adam_param->add_weight_bounds(0.5);
+  Rule rule;
+  rule.LoadConfig(param, embed_dim);
+
+  const size_t key_num = 5;
+  const size_t value_dim = embed_dim + rule.Dim();
+  std::vector<float> values(key_num * value_dim);
+  std::vector<float> grads(key_num * embed_dim);
+  std::vector<float> scales(key_num);
+  for (size_t k = 0; k < key_num; ++k) {
+    rule.InitValue(&values[k * value_dim],
+                   &values[k * value_dim + embed_dim],
+                   false);
+    scales[k] = static_cast<float>(k + 1);
+  }
+  for (size_t i = 0; i < grads.size(); ++i) {
+    grads[i] = std::sin(static_cast<float>(i)) * 20;
+  }
+  std::vector<float> batched = values;
+  std::vector<float*> w(key_num);
+  std::vector<float*> sgd(key_num);
+  std::vector<const float*> grad_ptrs(key_num);
+  for (int step = 0; step < 3; ++step) {
+    for (size_t k = 0; k < key_num; ++k) {
+      rule.UpdateValue(&values[k * value_dim],
+                       &values[k * value_dim + embed_dim],
+                       &grads[k * embed_dim],
+                       scales[k]);
+      w[k] = &batched[k * value_dim];
+      sgd[k] = &batched[k * value_dim + embed_dim];
+      grad_ptrs[k] = &grads[k * embed_dim];
+    }
+    rule.UpdateValues(
+        w.data(), sgd.data(), grad_ptrs.data(), scales.data(), key_num);
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], batched[i]) << "i is " << i;
+  }
+}
+
+TEST(sparse_sgd_rule_test, batched_update) {
+  for (size_t embed_dim : {1, 8, 11}) {
+    CheckBatchedUpdate<SparseAdaGradSGDRule>(embed_dim);
+    CheckBatchedUpdate<SparseAdamSGDRule>(embed_dim);
+    CheckBatchedUpdate<SparseSharedAdamSGDRule>(embed_dim);
+  }
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -25,13 +25,35 @@
 #include "paddle/phi/api/all.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
+#include "paddle/phi/core/tensor_utils.h"
 
 namespace egr {
 
+// Whether t can be copied into the memory of the dense tensor.
+static bool CanCopyIntoBuffer(const paddle::Tensor& tensor,
+                              const paddle::Tensor& t) {
+  return tensor.is_dense_tensor() && tensor.initialized() &&
+         t.is_dense_tensor() && tensor.dtype() == t.dtype() &&
+         tensor.numel() == t.numel() && tensor.place() == t.place();
+}
+
 static void CopyOrAddTensor(paddle::Tensor* tensor,
                             const paddle::Tensor& t,
-                            bool is_fake_empty) {
-  if (is_fake_empty) {
+                            bool is_fake_empty,
+                            bool keep_grad_buffer) {
+  if (is_fake_empty && keep_grad_buffer && CanCopyIntoBuffer(*tensor, t)) {
+    VLOG(3) << "Copy Tensor ptr: " << t.impl()
+            << " into Tensor ptr: " << tensor->impl();
+    auto* dense_tensor = static_cast<phi::DenseTensor*>(tensor->impl().get());
+    const auto dims = dense_tensor->dims();
+    auto* dev_ctx = phi::DeviceContextPool::Instance().Get(tensor->place());
+    phi::Copy(*dev_ctx,
+              *static_cast<phi::DenseTensor*>(t.impl().get()),
+              tensor->place(),
+              false,
+              dense_tensor);
+    dense_tensor->Resize(dims);
+  } else if (is_fake_empty) {
     VLOG(3) << "Move Tensor ptr: " << t.impl();
     *tensor = t;
   } else {
@@ -180,7 +202,8 @@ GradNodeAccumulation::operator()(
     auto grad = weak_grad_.lock();
     if (grad_out.defined() &&
         (grad_out.is_dist_tensor() || grad_out.initialized())) {
-      CopyOrAddTensor(grad.get(), grad_out, is_fake_empty_);
+      CopyOrAddTensor(
+          grad.get(), grad_out, is_fake_empty_, keep_grad_buffer_);
     }
     // else { do nothing since there is no valid value in grad out tensor }
     is_fake_empty_ = false;
@@ -67,9 +67,17 @@ class TEST_API GradNodeAccumulation : public GradNodeBase {
 
   void SetFakeEmpty(bool is_fake_empty) { is_fake_empty_ = is_fake_empty; }
 
+  // Write the first grad after a clear into the memory of the cleared grad
+  // rather than taking over the incoming grad, so a grad that is a view of a
+  // larger buffer stays one.
+  void SetKeepGradBuffer(bool keep_grad_buffer) {
+    keep_grad_buffer_ = keep_grad_buffer;
+  }
+
  private:
   // TODO(Jiabin): remove this when we make our clear gradient really cleared;
   bool is_fake_empty_ = {false};
+  bool keep_grad_buffer_ = {false};
   std::weak_ptr<paddle::Tensor> weak_grad_;
   std::vector<std::shared_ptr<VoidHook>> reduce_hooks_;
   std::function<paddle::Tensor(const paddle::Tensor&)> retain_grad_hook_;
@@ -0,0 +1,330 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/activation_offload.h"
+
+#include <deque>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/eager/utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
+#endif
+
+COMMON_DECLARE_int64(eager_activation_offload_min_size);
+COMMON_DECLARE_int32(eager_activation_offload_prefetch_num);
+
+namespace egr {
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+
+namespace {
+
+void RecordEvent(gpuEvent_t event, gpuStream_t stream) {
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+#endif
+}
+
+void StreamWaitEvent(gpuStream_t stream, gpuEvent_t event) {
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(stream, event, 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream, event, 0));
+#endif
+}
+
+bool QueryEvent(gpuEvent_t event) {
+#ifdef PADDLE_WITH_HIP
+  return hipEventQuery(event) == hipSuccess;
+#else
+  return cudaEventQuery(event) == cudaSuccess;
+#endif
+}
+
+void SyncEvent(gpuEvent_t event) {
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event));
+#endif
+}
+
+}  // namespace
+
+// All members are guarded by the mutex of the SavedTensorOffloader.
+class OffloadedTensor {
+ public:
+  OffloadedTensor(std::shared_ptr<phi::Allocation> holder,
+                  gpuStream_t compute_stream,
+                  gpuStream_t copy_stream)
+      : place_(holder->place().GetDeviceId()),
+        size_(holder->size()),
+        compute_stream_(compute_stream),
+        copy_stream_(copy_stream),
+        device_(std::move(holder)) {
+    ready_ = paddle::platform::CudaEventResourcePool::Instance().New(
+        place_.device);
+    done_ = paddle::platform::CudaEventResourcePool::Instance().New(
+        place_.device);
+    host_ = paddle::memory::AllocShared(phi::GPUPinnedPlace(), size_);
+    RecordEvent(ready_.get(), compute_stream_);
+    StreamWaitEvent(copy_stream_, ready_.get());
+    paddle::memory::Copy(phi::GPUPinnedPlace(),
+                         host_->ptr(),
+                         place_,
+                         device_->ptr(),
+                         size_,
+                         copy_stream_);
+    RecordEvent(done_.get(), copy_stream_);
+    offloading_ = true;
+  }
+
+  ~OffloadedTensor();
+
+  // Drops the source buffer when the copy to host is done, returns false if
+  // it is still in flight.
+  bool TryFinishOffload() {
+    if (!offloading_) {
+      return true;
+    }
+    if (!QueryEvent(done_.get())) {
+      return false;
+    }
+    device_.reset();
+    offloading_ = false;
+    return true;
+  }
+
+  void Prefetch() {
+    if (device_) {
+      // not released yet, or prefetched already
+      return;
+    }
+    device_ = paddle::memory::AllocShared(
+        place_,
+        size_,
+        phi::Stream(reinterpret_cast<phi::StreamId>(compute_stream_)));
+    // the buffer may be reused from kernels queued on the compute stream
+    RecordEvent(ready_.get(), compute_stream_);
+    StreamWaitEvent(copy_stream_, ready_.get());
+    paddle::memory::Copy(place_,
+                         device_->ptr(),
+                         phi::GPUPinnedPlace(),
+                         host_->ptr(),
+                         size_,
+                         copy_stream_);
+    RecordEvent(done_.get(), copy_stream_);
+    reloading_ = true;
+  }
+
+  std::shared_ptr<phi::Allocation> Reload() {
+    Prefetch();
+    if (reloading_) {
+      StreamWaitEvent(compute_stream_, done_.get());
+      reloading_ = false;
+    }
+    return device_;
+  }
+
+ private:
+  friend class SavedTensorOffloader;
+
+  phi::GPUPlace place_;
+  size_t size_;
+  gpuStream_t compute_stream_;
+  gpuStream_t copy_stream_;
+  // the source buffer while offloading_, the reloaded buffer after Prefetch
+  std::shared_ptr<phi::Allocation> device_;
+  std::shared_ptr<phi::Allocation> host_;
+  std::shared_ptr<paddle::platform::CudaEventObject> ready_;
+  std::shared_ptr<paddle::platform::CudaEventObject> done_;
+  bool offloading_{false};
+  bool reloading_{false};
+  // position in SavedTensorOffloader::offloaded_
+  std::list<OffloadedTensor*>::iterator pos_;
+};
+
+class SavedTensorOffloader {
+ public:
+  static SavedTensorOffloader& Instance() {
+    // never destroyed, saved tensors may outlive static destruction
+    static auto* instance = new SavedTensorOffloader();
+    return *instance;
+  }
+
+  std::shared_ptr<OffloadedTensor> Offload(
+      const std::shared_ptr<phi::Allocation>& holder) {
+    std::vector<std::shared_ptr<OffloadedTensor>> finished;
+    std::lock_guard<std::mutex> guard(mutex_);
+    FinishOffloads(&finished);
+    // views of one buffer saved together share the host copy
+    auto iter = by_holder_.find(holder.get());
+    if (iter != by_holder_.end()) {
+      if (auto offloaded = iter->second.lock()) {
+        return offloaded;
+      }
+    }
+
+    int device = holder->place().GetDeviceId();
+    auto& copy_stream = copy_streams_[device];
+    if (!copy_stream) {
+      copy_stream =
+          paddle::platform::CudaStreamResourcePool::Instance().New(device);
+    }
+    auto* dev_ctx = static_cast<phi::GPUContext*>(
+        phi::DeviceContextPool::Instance().Get(holder->place()));
+    auto offloaded = std::make_shared<OffloadedTensor>(
+        holder, dev_ctx->stream(), copy_stream.get());
+    offloaded->pos_ = offloaded_.insert(offloaded_.end(), offloaded.get());
+    by_holder_[holder.get()] = offloaded;
+    in_flight_.push_back(offloaded);
+    VLOG(6) << "Offload saved tensor of " << holder->size() << " bytes on "
+            << holder->place();
+    return offloaded;
+  }
+
+  std::shared_ptr<phi::Allocation> Reload(OffloadedTensor* offloaded) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto holder = offloaded->Reload();
+    // backward visits the nodes roughly in reverse order of the forward pass
+    auto pos = offloaded->pos_;
+    for (int i = 0; i < FLAGS_eager_activation_offload_prefetch_num &&
+                    pos != offloaded_.begin();
+         ++i) {
+      (*--pos)->Prefetch();
+    }
+    return holder;
+  }
+
+  void PrefetchLatest() {
+    std::vector<std::shared_ptr<OffloadedTensor>> finished;
+    std::lock_guard<std::mutex> guard(mutex_);
+    FinishOffloads(&finished);
+    auto pos = offloaded_.end();
+    for (int i = 0; i < FLAGS_eager_activation_offload_prefetch_num &&
+                    pos != offloaded_.begin();
+         ++i) {
+      (*--pos)->Prefetch();
+    }
+  }
+
+  void Remove(OffloadedTensor* offloaded) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (offloaded->offloading_) {
+      by_holder_.erase(offloaded->device_.get());
+    }
+    offloaded_.erase(offloaded->pos_);
+  }
+
+ private:
+  SavedTensorOffloader() = default;
+
+  // The copies finish in order on the copy stream. The entries are handed to
+  // `finished` so the last references go away after the mutex is released.
+  void FinishOffloads(std::vector<std::shared_ptr<OffloadedTensor>>* finished) {
+    while (!in_flight_.empty()) {
+      auto offloaded = in_flight_.front().lock();
+      if (offloaded) {
+        const phi::Allocation* source = offloaded->device_.get();
+        if (!offloaded->TryFinishOffload()) {
+          break;
+        }
+        // the address may be reused by a new allocation from now on
+        by_holder_.erase(source);
+        finished->push_back(std::move(offloaded));
+      }
+      in_flight_.pop_front();
+    }
+  }
+
+  std::mutex mutex_;
+  // in offload order
+  std::list<OffloadedTensor*> offloaded_;
+  std::deque<std::weak_ptr<OffloadedTensor>> in_flight_;
+  std::unordered_map<const phi::Allocation*, std::weak_ptr<OffloadedTensor>>
+      by_holder_;
+  std::unordered_map<int, std::shared_ptr<paddle::platform::CudaStreamObject>>
+      copy_streams_;
+};
+
+OffloadedTensor::~OffloadedTensor() {
+  SavedTensorOffloader::Instance().Remove(this);
+  // neither buffer may be released while a copy still uses it
+  SyncEvent(done_.get());
+}
+
+std::shared_ptr<OffloadedTensor> OffloadSavedTensor(
+    const paddle::Tensor& tensor) {
+  if (FLAGS_eager_activation_offload_min_size <= 0 || !tensor.initialized() ||
+      !tensor.is_dense_tensor() || !phi::is_gpu_place(tensor.place())) {
+    return nullptr;
+  }
+  // leaves such as parameters stay alive anyway, nothing would be freed
+  if (EagerUtils::IsLeafTensor(tensor)) {
+    return nullptr;
+  }
+  const auto& holder =
+      static_cast<phi::DenseTensor*>(tensor.impl().get())->Holder();
+  if (!holder || holder->ptr() == nullptr ||
+      holder->size() <
+          static_cast<size_t>(FLAGS_eager_activation_offload_min_size)) {
+    return nullptr;
+  }
+  return SavedTensorOffloader::Instance().Offload(holder);
+}
+
+std::shared_ptr<phi::Allocation> ReloadSavedTensor(
+    OffloadedTensor* offloaded) {
+  return SavedTensorOffloader::Instance().Reload(offloaded);
+}
+
+void PrefetchSavedTensors() {
+  if (FLAGS_eager_activation_offload_min_size > 0) {
+    SavedTensorOffloader::Instance().PrefetchLatest();
+  }
+}
+
+#else
+
+class OffloadedTensor {};
+
+std::shared_ptr<OffloadedTensor> OffloadSavedTensor(
+    const paddle::Tensor& tensor) {
+  return nullptr;
+}
+
+std::shared_ptr<phi::Allocation> ReloadSavedTensor(
+    OffloadedTensor* offloaded) {
+  PADDLE_THROW(common::errors::Unavailable(
+      "Saved tensors are only offloaded on gpu."));
+}
+
+void PrefetchSavedTensors() {}
+
+#endif
+
+}  // namespace egr
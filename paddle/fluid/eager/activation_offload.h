@@ -0,0 +1,45 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/core/allocator.h"
+#include "paddle/utils/test_macros.h"
+
+namespace egr {
+
+// A buffer saved for backward that lives in pinned host memory, see
+// OffloadSavedTensor.
+class OffloadedTensor;
+
+// Starts copying the gpu buffer of `tensor` to pinned host memory on a copy
+// stream when FLAGS_eager_activation_offload_min_size selects it, returns
+// nullptr otherwise. The gpu buffer is dropped once the copy is done, so it is
+// freed as soon as no one else holds the tensor.
+TEST_API std::shared_ptr<OffloadedTensor> OffloadSavedTensor(
+    const paddle::Tensor& tensor);
+
+// Returns the gpu buffer of `offloaded`, the compute stream waits for the copy
+// back. Starts prefetching the FLAGS_eager_activation_offload_prefetch_num
+// tensors offloaded before it, which backward needs next.
+TEST_API std::shared_ptr<phi::Allocation> ReloadSavedTensor(
+    OffloadedTensor* offloaded);
+
+// Prefetches the most recently offloaded tensors, called when backward starts.
+TEST_API void PrefetchSavedTensors();
+
+}  // namespace egr
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "paddle/fluid/eager/amp_cast_cache.h"
 #include "paddle/fluid/eager/api/generated/fluid_generated/dygraph_forward_api.h"
 #include "paddle/fluid/eager/api/manual/fluid_manual/dygraph_forward_api.h"
 #include "paddle/fluid/framework/convert_utils.h"
@@ -51,7 +52,10 @@ inline std::vector<paddle::Tensor> AmpAutoCasts(
       paddle::framework::AttributeMap cast_attrs = {
           {"in_dtype", paddle::framework::TransToProtoVarType(input.dtype())},
           {"out_dtype", paddle::framework::TransToProtoVarType(dst_dtype)}};
-      inputs_casted.emplace_back(cast_dygraph_function(input, cast_attrs));
+      inputs_casted.emplace_back(AmpCastCache::GetOrCast(
+          input, dst_dtype, true, [&]() {
+            return cast_dygraph_function(input, cast_attrs);
+          }));
     } else {
       inputs_casted.emplace_back(input);
     }
@@ -98,7 +102,9 @@ inline paddle::Tensor AmpAutoCast(const std::string& input_name,
     paddle::framework::AttributeMap cast_attrs = {
         {"in_dtype", paddle::framework::TransToProtoVarType(input.dtype())},
         {"out_dtype", paddle::framework::TransToProtoVarType(dst_dtype)}};
-    return cast_dygraph_function(input, cast_attrs);
+    return AmpCastCache::GetOrCast(input, dst_dtype, true, [&]() {
+      return cast_dygraph_function(input, cast_attrs);
+    });
   }
   return input;
 }
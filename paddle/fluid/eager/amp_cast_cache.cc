@@ -0,0 +1,143 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/amp_cast_cache.h"
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/eager/api/utils/global_utils.h"
+#include "paddle/fluid/eager/autograd_meta.h"
+#include "paddle/fluid/eager/utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+COMMON_DECLARE_bool(eager_amp_cast_cache);
+
+namespace egr {
+
+namespace {
+
+struct CachedCast {
+  // not owned, so the cache never keeps a parameter alive, and a new tensor
+  // reusing the address of a destroyed one is told apart
+  std::weak_ptr<phi::TensorBase> source;
+  const void* source_holder;
+  uint32_t source_version;
+  paddle::Tensor cast;
+  uint32_t cast_version;
+};
+
+using CastKey = std::tuple<const phi::TensorBase*, phi::DataType, bool>;
+
+struct CastCacheState {
+  std::map<CastKey, CachedCast> casts;
+  // the size after the last sweep of the expired sources
+  size_t swept_size = 0;
+};
+
+CastCacheState& ThreadCastCache() {
+  thread_local CastCacheState state;
+  return state;
+}
+
+const void* HolderOf(const paddle::Tensor& tensor) {
+  return static_cast<const phi::DenseTensor*>(tensor.impl().get())
+      ->Holder()
+      .get();
+}
+
+bool IsCacheable(const paddle::Tensor& tensor) {
+  if (!tensor.is_dense_tensor() || !tensor.initialized()) {
+    return false;
+  }
+  auto* meta = EagerUtils::nullable_autograd_meta(tensor);
+  return meta != nullptr && meta->Persistable() &&
+         EagerUtils::IsLeafTensor(tensor);
+}
+
+bool IsValid(const CachedCast& cached, const paddle::Tensor& tensor) {
+  auto source = cached.source.lock();
+  if (source == nullptr || source != tensor.impl()) {
+    return false;
+  }
+  paddle::Tensor cast = cached.cast;
+  return cached.source_holder == HolderOf(tensor) &&
+         cached.source_version ==
+             paddle::Tensor(tensor).current_inplace_version() &&
+         cached.cast_version == cast.current_inplace_version();
+}
+
+void SweepExpired(CastCacheState* state) {
+  for (auto it = state->casts.begin(); it != state->casts.end();) {
+    if (it->second.source.expired()) {
+      it = state->casts.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  state->swept_size = state->casts.size();
+}
+
+}  // namespace
+
+paddle::Tensor AmpCastCache::GetOrCast(
+    const paddle::Tensor& tensor,
+    phi::DataType dst_dtype,
+    bool trace_backward,
+    const std::function<paddle::Tensor()>& cast) {
+  if (!FLAGS_eager_amp_cast_cache || !IsCacheable(tensor)) {
+    return cast();
+  }
+  // a cast made without a grad node must not serve the traced uses
+  const bool traced = trace_backward && Controller::Instance().HasGrad();
+  auto& state = ThreadCastCache();
+  const CastKey key(tensor.impl().get(), dst_dtype, traced);
+  auto it = state.casts.find(key);
+  if (it != state.casts.end()) {
+    if (IsValid(it->second, tensor)) {
+      VLOG(6) << "Reuse the AMP cast of " << tensor.name() << " to "
+              << phi::DataTypeToString(dst_dtype);
+      return it->second.cast;
+    }
+    state.casts.erase(it);
+  }
+
+  paddle::Tensor result = cast();
+  if (!result.is_dense_tensor() || !result.initialized()) {
+    return result;
+  }
+  if (state.casts.size() >= 2 * state.swept_size + 64) {
+    SweepExpired(&state);
+  }
+  CachedCast cached;
+  cached.source = tensor.impl();
+  cached.source_holder = HolderOf(tensor);
+  cached.source_version = paddle::Tensor(tensor).current_inplace_version();
+  cached.cast = result;
+  cached.cast_version = result.current_inplace_version();
+  state.casts.emplace(key, std::move(cached));
+  return result;
+}
+
+void AmpCastCache::Clear() {
+  auto& state = ThreadCastCache();
+  state.casts.clear();
+  state.swept_size = 0;
+}
+
+size_t AmpCastCache::Size() { return ThreadCastCache().casts.size(); }
+
+}  // namespace egr
@@ -0,0 +1,54 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/utils/test_macros.h"
+
+namespace egr {
+
+/**
+ * AmpCastCache keeps the AMP casts of the persistable leaf tensors, i.e. the
+ * parameters, of the calling thread, so a parameter used by several ops of a
+ * step is cast once and its casts share one cast grad node.
+ *
+ * A cast is keyed by its source tensor, the destination dtype and whether it
+ * is traced for backward. It is dropped once the source or the cast is
+ * modified inplace, e.g. by the optimizer, and all of them are dropped at
+ * the end of a backward pass, which releases their grad nodes. The cache is
+ * enabled by FLAGS_eager_amp_cast_cache.
+ **/
+class AmpCastCache {
+ public:
+  // The cached cast of tensor to dst_dtype, or the result of cast, which is
+  // cached if tensor is cacheable.
+  TEST_API static paddle::Tensor GetOrCast(
+      const paddle::Tensor& tensor,
+      phi::DataType dst_dtype,
+      bool trace_backward,
+      const std::function<paddle::Tensor()>& cast);
+
+  // Drop the casts cached by the calling thread.
+  TEST_API static void Clear();
+
+  // The number of casts cached by the calling thread.
+  TEST_API static size_t Size();
+};
+
+}  // namespace egr
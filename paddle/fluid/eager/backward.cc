@@ -14,9 +14,26 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/eager/activation_offload.h"
+#include "paddle/fluid/eager/amp_cast_cache.h"
 #include "paddle/fluid/eager/general_grad.h"
 #include "paddle/phi/core/memory/stats.h"
+#include "paddle/phi/core/threadpool.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+
+COMMON_DECLARE_int32(eager_backward_num_threads);
 
 namespace egr {
 
@@ -102,6 +119,301 @@ void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
 
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
+using GradOutputs =
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>;
+using GradTensorHolderMap =
+    std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>;
+
+// Run a ready node on its input buffer and return its grad outputs.
+static GradOutputs RunGradNode(GradNodeBase* node,
+                               GradTensorHolder* node_input_buffer,
+                               bool retain_graph,
+                               bool create_graph,
+                               bool is_general_grad) {
+  // Check input
+  EnforceGradNodeHasInput(node);
+
+  VLOG(7) << "Run Backward Kernel with GradTensorHolder.";
+
+  // This 'Global_XXXGradNode' record event is different with
+  // 'Local_XXXGradNode' event.
+  // * 'Global_XXXGradNode' will not only cover execution time of this
+  // function, but also include gradient
+  //    accumulation when the output(s) of corresponding forward OP are shared
+  //    by other OP(s), which may have extra overhead of accumulation than
+  //    'Local_XXXGradNode'.
+  // * 'Local_XXXGradNode' will only cover execution time of GradNode
+  // function.
+  // the name is only built when the event is recorded
+  std::unique_ptr<phi::RecordEvent> grad_node_record_event;
+  if (phi::RecordEvent::IsEnabled(1)) {
+    grad_node_record_event = std::make_unique<phi::RecordEvent>(
+        "Global_" + std::string((*node).name()),
+        paddle::platform::TracerEventType::Operator,
+        1);
+  }
+
+  // Run Pre Backward Node and get outputs
+  GradOutputs grad_output_tensors =
+      (*node)(node_input_buffer->Buffers(), create_graph, is_general_grad);
+
+  if (is_general_grad) {
+    GeneralGrad::Instance().SetResultForEndingNodes(grad_output_tensors, node);
+  }
+
+  // retain_grad or not
+  if (!retain_graph) {
+    VLOG(3)
+        << "retain_graph is false, need to clear the TensorWrapper of nodes.";
+    node->ClearTensorWrappers();
+  }
+  return grad_output_tensors;
+}
+
+// Sum the grad outputs of node into the input buffers of its next nodes, and
+// call on_ready with each next node whose in-degree drops to 0.
+static void PropagateGradOutputs(
+    GradNodeBase* node,
+    GradOutputs* grad_output_tensors,
+    bool create_graph,
+    GradTensorHolderMap* node_input_buffers_dict,
+    std::unordered_map<GradNodeBase*, int>* node_in_degree_map,
+    const std::function<void(GradNodeBase*)>& on_ready) {
+  // Prepare GradTensorHolder for next node
+  const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+      metas = node->OutputMeta();
+  PADDLE_ENFORCE(metas.size() == grad_output_tensors->size() || metas.empty(),
+                 common::errors::Fatal(
+                     "Number of edges should be either empty ( for leaf node "
+                     ") or the same as number of output grad tensors, but we "
+                     "got edges size is: %d, grad_output size is: %d",
+                     metas.size(),
+                     grad_output_tensors->size()));
+
+  for (size_t i = 0; i < metas.size(); i++) {
+    for (size_t j = 0; j < metas[i].size(); j++) {
+      const Edge& edge = metas[i][j].GetEdge();
+      if (!edge.IsInitialized()) {
+        continue;
+      }
+      auto edge_rank = edge.GetEdgeRankInfo();
+      // Since we make edge has as same rank as bwd outputs, we indexing them
+      // with the same rank(i, j)
+      auto next_node_shared = edge.GetMutableGradNode();
+      // Next node could be nullptr if it is leaf tensor with no
+      // AccumulationNode attached
+      // Or it could also originated from dispensable inputs
+      if (!next_node_shared || !next_node_shared.get() ||
+          (*grad_output_tensors)[i].empty()) {
+        continue;
+      }
+      VLOG(3) << "Node: " << node->name() << " addr:" << node
+              << ", Found pending node: " << next_node_shared->name()
+              << " addr: " << next_node_shared.get();
+
+      PADDLE_ENFORCE_LT(
+          j,
+          (*grad_output_tensors)[i].size(),
+          common::errors::Fatal(
+              "Rank of grad_output_tensors should be less than "
+              "grad_output_tensors[i].size(), which is: %d. This error may "
+              "indicate autoprune or autograd api error. ",
+              grad_output_tensors->size()));
+      paddle::Tensor& grad_output_tensor = (*grad_output_tensors)[i][j];
+
+      if ((!grad_output_tensor.defined() ||
+           !grad_output_tensor.initialized())) {
+        VLOG(7) << "We get grad_output_tensor with slot: " << i
+                << ", rank: " << j << " as uninitialized or undefined tensor";
+      }
+
+      VLOG(7) << "Get Edge and grad_output_tensor with slot: " << i
+              << ", rank: " << j
+              << " 's name is: " << grad_output_tensor.name();
+
+      auto* next_node = next_node_shared.get();
+      auto& next_node_input_buffer = (*node_input_buffers_dict)[next_node];
+      if (!next_node_input_buffer) {
+        VLOG(7) << "Construct GradTensorHolder for grad node: "
+                << next_node->name();
+        next_node_input_buffer =
+            std::make_unique<GradTensorHolder>(next_node->InputMeta());
+      }
+
+      VLOG(3) << "Sum or Move grad inputs for edge slot: " << edge_rank.first
+              << ", rank: " << edge_rank.second;
+
+      next_node_input_buffer->add(edge_rank.first,
+                                  edge_rank.second,
+                                  grad_output_tensor,
+                                  create_graph);
+
+      // Update queue
+      int& in_degree = (*node_in_degree_map)[next_node];
+      in_degree--;
+      VLOG(7) << next_node->name() << " ref_cnt is: " << in_degree;
+
+      PADDLE_ENFORCE(
+          in_degree >= 0,
+          common::errors::Fatal(
+              "Detected in-degree value smaller than zero. For Node: %s"
+              "Node's in-degree cannot be negative.",
+              next_node->name()));
+
+      if (in_degree == 0) {
+        on_ready(next_node);
+      }
+    }
+  }
+}
+
+// The host threads dispatching the ready nodes besides the calling thread,
+// created once per thread number and kept for the later backward passes.
+static phi::ThreadPool* GetBackwardThreadPool(int num_threads) {
+  static std::mutex mutex;
+  static std::map<int, std::unique_ptr<phi::ThreadPool>> pools;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& pool = pools[num_threads];
+  if (!pool) {
+    pool = std::make_unique<phi::ThreadPool>(num_threads - 1);
+  }
+  return pool.get();
+}
+
+// Run the nodes from num_threads host threads, each taking whichever node
+// is ready, so the kernels of independent branches are dispatched while the
+// others are still in their host side work. The calling thread runs the
+// GradNodeAccumulation nodes, so the leaf hooks and the reducer see the
+// grads of the parameters from the same thread as the sequential run.
+static void RunGradNodesInParallel(
+    const std::deque<GradNodeBase*>& startup_nodes,
+    GradTensorHolderMap* node_input_buffers_dict,
+    std::unordered_map<GradNodeBase*, int>* node_in_degree_map,
+    bool retain_graph,
+    const phi::Place& place,
+    int num_threads) {
+  // Guarded by mutex: the buffers, the in-degrees and the ready queues,
+  // while a node runs unlocked once its buffer is taken out.
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<GradNodeBase*> ready;
+  std::deque<GradNodeBase*> ready_on_caller;
+  size_t num_running = 0;
+  std::exception_ptr error;
+
+  auto on_ready = [&](GradNodeBase* node) {
+    if (dynamic_cast<egr::GradNodeAccumulation*>(node)) {
+      ready_on_caller.push_back(node);
+    } else {
+      ready.push_back(node);
+    }
+  };
+  for (GradNodeBase* node : startup_nodes) {
+    auto iter = node_in_degree_map->find(node);
+    if (iter == node_in_degree_map->end() || iter->second == 0) {
+      on_ready(node);
+    }
+  }
+
+  auto run_nodes = [&](bool is_caller) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [&] {
+        return error || !ready.empty() ||
+               (is_caller && !ready_on_caller.empty()) ||
+               (num_running == 0 && ready_on_caller.empty());
+      });
+      if (error || (ready.empty() && ready_on_caller.empty() &&
+                    num_running == 0)) {
+        break;
+      }
+      std::deque<GradNodeBase*>& from =
+          is_caller && !ready_on_caller.empty() ? ready_on_caller : ready;
+      GradNodeBase* node = from.front();
+      from.pop_front();
+      VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+      auto node_input_buffer_iter = node_input_buffers_dict->find(node);
+      if (node_input_buffer_iter == node_input_buffers_dict->end()) {
+        try {
+          PADDLE_THROW(common::errors::Fatal(
+              "Unable to find next node in the GradTensorHolder \n"
+              "Trying to run Node without configuring its "
+              "GradTensorHolder."));
+        } catch (...) {
+          error = std::current_exception();
+        }
+        break;
+      }
+      std::unique_ptr<GradTensorHolder> node_input_buffer =
+          std::move(node_input_buffer_iter->second);
+      node_input_buffers_dict->erase(node_input_buffer_iter);
+      ++num_running;
+      lock.unlock();
+
+      GradOutputs grad_output_tensors;
+      std::exception_ptr node_error;
+      try {
+        grad_output_tensors = RunGradNode(node,
+                                          node_input_buffer.get(),
+                                          retain_graph,
+                                          /*create_graph=*/false,
+                                          /*is_general_grad=*/false);
+      } catch (...) {
+        node_error = std::current_exception();
+      }
+
+      lock.lock();
+      --num_running;
+      if (node_error) {
+        error = node_error;
+      } else if (!error) {
+        try {
+          PropagateGradOutputs(node,
+                               &grad_output_tensors,
+                               /*create_graph=*/false,
+                               node_input_buffers_dict,
+                               node_in_degree_map,
+                               on_ready);
+          paddle::memory::LogDeviceMemoryStats(place,
+                                               std::string((*node).name()));
+        } catch (...) {
+          error = std::current_exception();
+        }
+      }
+      cv.notify_all();
+    }
+    cv.notify_all();
+  };
+
+  // the tracer and the grad mode are thread local, and the workers run the
+  // nodes the same way the calling thread would
+  auto tracer = egr::Controller::Instance().GetCurrentTracer();
+  const bool has_grad = egr::Controller::Instance().HasGrad();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  const int device_id = phi::backends::gpu::GetCurrentDeviceId();
+#endif
+  auto* pool = GetBackwardThreadPool(num_threads);
+  std::vector<std::future<void>> workers;
+  workers.reserve(num_threads - 1);
+  for (int i = 0; i < num_threads - 1; ++i) {
+    workers.emplace_back(pool->Run([&, tracer, has_grad] {
+      egr::Controller::Instance().SetCurrentTracer(tracer);
+      egr::Controller::Instance().SetHasGrad(has_grad);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      phi::backends::gpu::SetDeviceId(device_id);
+#endif
+      run_nodes(/*is_caller=*/false);
+    }));
+  }
+  run_nodes(/*is_caller=*/true);
+  for (auto& worker : workers) {
+    worker.wait();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 std::vector<paddle::Tensor> RunBackward(
     const std::vector<paddle::Tensor>& tensors,  // output
     const std::vector<paddle::Tensor>& grad_tensors,
@@ -243,186 +555,87 @@ std::vector<paddle::Tensor> RunBackward(
 
   VLOG(5) << "Startup_ops's size is " << queue.size();
 
-  /* --- Topological Visit --- */
-  // 1. Pop queue
-  // 2. Run node
-  //    |- Check and capture target result
-  //    |- node(grads)
-  //    |- Prepare for next node
-  // 3. Update queue
-  while (!queue.empty()) {
-    GradNodeBase* node = queue.front();
-    VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
-
-    if (queue.size() > 1 && node_in_degree_map[node] != 0) {
-      queue.pop_front();
-      continue;
-    }
-    queue.pop_front();
-
-    // Run node: This is where Hook happens
-    auto node_input_buffer_iter = node_input_buffers_dict.find(node);
-    PADDLE_ENFORCE_NE(
-        node_input_buffer_iter,
-        node_input_buffers_dict.end(),
-        common::errors::Fatal(
-            "Unable to find next node in the GradTensorHolder \n"
-            "Trying to run Node without configuring its GradTensorHolder."));
-
-    std::unique_ptr<GradTensorHolder> node_input_buffer =
-        std::move(node_input_buffer_iter->second);
-
-    // Check input
-    EnforceGradNodeHasInput(node);
-
-    VLOG(7) << "Run Backward Kernel with GradTensorHolder.";
-
-    // This 'Global_XXXGradNode' record event is different with
-    // 'Local_XXXGradNode' event.
-    // * 'Global_XXXGradNode' will not only cover execution time of this
-    // function, but also include gradient
-    //    accumulation when the output(s) of corresponding forward OP are shared
-    //    by other OP(s), which may have extra overhead of accumulation than
-    //    'Local_XXXGradNode'.
-    // * 'Local_XXXGradNode' will only cover execution time of GradNode
-    // function.
-    phi::RecordEvent grad_node_record_event(
-        "Global_" + std::string((*node).name()),
-        paddle::platform::TracerEventType::Operator,
-        1);
-
-    // Run Pre Backward Node and get outputs
-    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
-        grad_output_tensors = (*node)(
-            node_input_buffer->Buffers(), create_graph, is_general_grad);
-
-    if (!inputs.empty() && is_general_grad) {
-      GeneralGrad::Instance().SetResultForEndingNodes(grad_output_tensors,
-                                                      node);
-    }
-
-    // retain_grad or not
-    if (!retain_graph) {
-      VLOG(3)
-          << "retain_graph is false, need to clear the TensorWrapper of nodes.";
-      node->ClearTensorWrappers();
-    }
-
-    // TODO(jiabin): Should we erase it or find a more efficient way.
-    node_input_buffers_dict.erase(node_input_buffer_iter);
-
-    // Prepare GradTensorHolder for next node
-    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
-        metas = node->OutputMeta();
-    PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
-                   common::errors::Fatal(
-                       "Number of edges should be either empty ( for leaf node "
-                       ") or the same as number of output grad tensors, but we "
-                       "got edges size is: %d, grad_output size is: %d",
-                       metas.size(),
-                       grad_output_tensors.size()));
-
-    for (size_t i = 0; i < metas.size(); i++) {
-      for (size_t j = 0; j < metas[i].size(); j++) {
-        const Edge& edge = metas[i][j].GetEdge();
-        if (!edge.IsInitialized()) {
-          continue;
-        }
-        auto edge_rank = edge.GetEdgeRankInfo();
-        // Since we make edge has as same rank as bwd outputs, we indexing them
-        // with the same rank(i, j)
-        auto next_node_shared = edge.GetMutableGradNode();
-        VLOG(3) << "Node: " << node->name() << " addr:" << node
-                << ", Found pending node: " << next_node_shared->name()
-                << " addr: " << next_node_shared.get();
-        // Next node could be nullptr if it is leaf tensor with no
-        // AccumulationNode attached
-        // Or it could also originated from dispensable inputs
-        if (!next_node_shared || !next_node_shared.get() ||
-            grad_output_tensors[i].empty()) {
-          continue;
-        }
-
-        PADDLE_ENFORCE_LT(
-            j,
-            grad_output_tensors[i].size(),
-            common::errors::Fatal(
-                "Rank of grad_output_tensors should be less than "
-                "grad_output_tensors[i].size(), which is: %d. This error may "
-                "indicate autoprune or autograd api error. ",
-                grad_output_tensors.size()));
-        paddle::Tensor& grad_output_tensor = grad_output_tensors[i][j];
-
-        if ((!grad_output_tensor.defined() ||
-             !grad_output_tensor.initialized())) {
-          VLOG(7) << "We get grad_output_tensor with slot: " << i
-                  << ", rank: " << j << " as uninitialized or undefined tensor";
-        }
-
-        VLOG(7) << "Get Edge and grad_output_tensor with slot: " << i
-                << ", rank: " << j
-                << " 's name is: " << grad_output_tensor.name();
-
-        auto* next_node = next_node_shared.get();
-        if (!node_input_buffers_dict.count(next_node)) {
-          const auto& input_meta = next_node->InputMeta();
-          auto grad_tensor_holder =
-              std::make_unique<GradTensorHolder>(input_meta);
-          VLOG(7) << "Construct GradTensorHolder for grad node: "
-                  << next_node->name();
-          node_input_buffers_dict[next_node] = std::move(grad_tensor_holder);
-        }
-
-        VLOG(3) << "Sum or Move grad inputs for edge slot: " << edge_rank.first
-                << ", rank: " << edge_rank.second;
-
-        node_input_buffers_dict[next_node]->add(edge_rank.first,
-                                                edge_rank.second,
-                                                grad_output_tensor,
-                                                create_graph);
-
-        // Update queue
-        node_in_degree_map[next_node]--;
-        VLOG(7) << next_node->name()
-                << " ref_cnt is: " << node_in_degree_map[next_node];
-
-        PADDLE_ENFORCE(
-            node_in_degree_map[next_node] >= 0,
-            common::errors::Fatal(
-                "Detected in-degree value smaller than zero. For Node: %s"
-                "Node's in-degree cannot be negative.",
-                next_node->name()));
-
-        auto add_next_node_func = [&queue](GradNodeBase* next_node) {
-          if (dynamic_cast<egr::GradNodeAccumulation*>(next_node)) {
-            queue.push_front(next_node);
-          } else {
-            queue.push_back(next_node);
-          }
-        };
-        if (node_in_degree_map[next_node] == 0) {
-          if (force_sequential_nodes_set.count(next_node)) {
-            if (force_sequential_nodes_queue.front() == next_node) {
-              force_sequential_nodes_queue.pop_front();
-              add_next_node_func(next_node);
-              while (ready_force_sequential_nodes.count(
-                  force_sequential_nodes_queue.front())) {
-                ready_force_sequential_nodes.erase(
-                    force_sequential_nodes_queue.front());
-                add_next_node_func(force_sequential_nodes_queue.front());
-                force_sequential_nodes_queue.pop_front();
-              }
-            } else {
-              ready_force_sequential_nodes.insert(next_node);
-              continue;
-            }
-          } else {
-            add_next_node_func(next_node);
-          }
+  // The first nodes to run need the most recently offloaded activations
+  PrefetchSavedTensors();
+
+  if (FLAGS_eager_backward_num_threads > 1 && !is_general_grad &&
+      !create_graph && force_sequential_nodes_set.empty()) {
+    RunGradNodesInParallel(queue,
+                           &node_input_buffers_dict,
+                           &node_in_degree_map,
+                           retain_graph,
+                           place,
+                           FLAGS_eager_backward_num_threads);
+  } else {
+    /* --- Topological Visit --- */
+    // 1. Pop queue
+    // 2. Run node
+    //    |- Check and capture target result
+    //    |- node(grads)
+    //    |- Prepare for next node
+    // 3. Update queue
+    auto add_next_node_func = [&queue](GradNodeBase* next_node) {
+      if (dynamic_cast<egr::GradNodeAccumulation*>(next_node)) {
+        queue.push_front(next_node);
+      } else {
+        queue.push_back(next_node);
+      }
+    };
+    auto on_ready = [&](GradNodeBase* next_node) {
+      if (!force_sequential_nodes_set.count(next_node)) {
+        add_next_node_func(next_node);
+      } else if (force_sequential_nodes_queue.front() == next_node) {
+        force_sequential_nodes_queue.pop_front();
+        add_next_node_func(next_node);
+        while (ready_force_sequential_nodes.count(
+            force_sequential_nodes_queue.front())) {
+          ready_force_sequential_nodes.erase(
+              force_sequential_nodes_queue.front());
+          add_next_node_func(force_sequential_nodes_queue.front());
+          force_sequential_nodes_queue.pop_front();
         }
+      } else {
+        ready_force_sequential_nodes.insert(next_node);
+      }
+    };
+    while (!queue.empty()) {
+      GradNodeBase* node = queue.front();
+      VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+
+      if (queue.size() > 1 && node_in_degree_map[node] != 0) {
+        queue.pop_front();
+        continue;
       }
+      queue.pop_front();
+
+      // Run node: This is where Hook happens
+      auto node_input_buffer_iter = node_input_buffers_dict.find(node);
+      PADDLE_ENFORCE_NE(
+          node_input_buffer_iter,
+          node_input_buffers_dict.end(),
+          common::errors::Fatal(
+              "Unable to find next node in the GradTensorHolder \n"
+              "Trying to run Node without configuring its GradTensorHolder."));
+
+      std::unique_ptr<GradTensorHolder> node_input_buffer =
+          std::move(node_input_buffer_iter->second);
+      // TODO(jiabin): Should we erase it or find a more efficient way.
+      node_input_buffers_dict.erase(node_input_buffer_iter);
+
+      auto grad_output_tensors = RunGradNode(node,
+                                             node_input_buffer.get(),
+                                             retain_graph,
+                                             create_graph,
+                                             is_general_grad);
+
+      PropagateGradOutputs(node,
+                           &grad_output_tensors,
+                           create_graph,
+                           &node_input_buffers_dict,
+                           &node_in_degree_map,
+                           on_ready);
+      paddle::memory::LogDeviceMemoryStats(place, std::string((*node).name()));
     }
-    paddle::memory::LogDeviceMemoryStats(place, std::string((*node).name()));
   }
 
   VLOG(7) << "Run Backward Final hook size: "
@@ -431,6 +644,9 @@ std::vector<paddle::Tensor> RunBackward(
     (*hook)();
   }
   egr::Controller::Instance().ClearFinalBackwardHooks();
+  // a step ends with its backward pass, which may release the grad nodes of
+  // the cached casts
+  AmpCastCache::Clear();
   if (!is_general_grad) return {};
   VLOG(3) << "Finish Backward";
   return GeneralGrad::Instance().GetResults(inputs, allow_unused, create_graph);
@@ -15,9 +15,11 @@
 #pragma once
 
 #include <memory>
+#include <new>
 
 #include "paddle/fluid/eager/api/utils/global_utils.h"
 #include "paddle/fluid/eager/eager_tensor.h"
+#include "paddle/fluid/eager/grad_node_pool.h"
 #include "paddle/fluid/eager/hooks.h"
 #include "paddle/phi/api/all.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
@@ -201,6 +203,24 @@ class GradNodeBase {
   // TODO(jiabin): Should we have other constructor here?
   virtual ~GradNodeBase() { VLOG(7) << "Destruct GradNodeBase"; }
 
+  // The grad nodes created by new take their memory from GradNodePool, and
+  // the virtual destructor passes the size of the derived node to delete.
+  static void* operator new(size_t size) {
+    return GradNodePool::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    GradNodePool::Free(ptr, size);
+  }
+  // the over aligned nodes are left to the heap
+  static void* operator new(size_t size, std::align_val_t align) {
+    return ::operator new(size, align);
+  }
+  static void operator delete(void* ptr,
+                              size_t size,
+                              std::align_val_t align) {
+    ::operator delete(ptr, size, align);
+  }
+
   /**
    * operator() designed to contain the real backward execution logic, it should
    * be overridden by derived class defined for each operator. It accepts a
@@ -0,0 +1,114 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/grad_node_pool.h"
+
+#include <array>
+#include <new>
+#include <vector>
+
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_int32(eager_grad_node_pool_size);
+
+namespace egr {
+
+namespace {
+
+constexpr size_t kSizeClassBytes = 64;
+constexpr size_t kSizeClassNum = 32;
+
+// The size class of size, or kSizeClassNum if it is too large to be pooled.
+size_t SizeClass(size_t size) {
+  return size == 0 ? 0 : (size - 1) / kSizeClassBytes;
+}
+
+struct FreeLists {
+  ~FreeLists();
+  void Release();
+
+  std::array<std::vector<void*>, kSizeClassNum> lists;
+};
+
+// Cleared when the free lists of the thread are destroyed, after which the
+// nodes destroyed later by the thread exit go to the heap. A trivial type is
+// never destroyed, so it is safe to read at any time.
+thread_local bool free_lists_alive = true;
+thread_local FreeLists free_lists;
+
+FreeLists::~FreeLists() {
+  free_lists_alive = false;
+  Release();
+}
+
+void FreeLists::Release() {
+  for (auto& list : lists) {
+    for (void* ptr : list) {
+      ::operator delete(ptr);
+    }
+    list.clear();
+  }
+}
+
+}  // namespace
+
+void* GradNodePool::Allocate(size_t size) {
+  const size_t size_class = SizeClass(size);
+  if (size_class >= kSizeClassNum) {
+    return ::operator new(size);
+  }
+  if (free_lists_alive) {
+    auto& list = free_lists.lists[size_class];
+    if (!list.empty()) {
+      void* ptr = list.back();
+      list.pop_back();
+      return ptr;
+    }
+  }
+  // a block always takes its whole size class, so it fits any size of it
+  return ::operator new((size_class + 1) * kSizeClassBytes);
+}
+
+void GradNodePool::Free(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+  const size_t size_class = SizeClass(size);
+  if (size_class < kSizeClassNum && free_lists_alive) {
+    auto& list = free_lists.lists[size_class];
+    if (list.size() < static_cast<size_t>(FLAGS_eager_grad_node_pool_size)) {
+      list.push_back(ptr);
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
+size_t GradNodePool::CachedBlockNum() {
+  size_t num = 0;
+  if (free_lists_alive) {
+    for (const auto& list : free_lists.lists) {
+      num += list.size();
+    }
+  }
+  return num;
+}
+
+void GradNodePool::Release() {
+  if (free_lists_alive) {
+    free_lists.Release();
+  }
+}
+
+}  // namespace egr
@@ -0,0 +1,45 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+
+#include "paddle/utils/test_macros.h"
+
+namespace egr {
+
+/**
+ * GradNodePool keeps the memory of the destroyed grad nodes in thread local
+ * free lists of size classes, so the grad nodes created by the next forward
+ * pass reuse it instead of going to the heap. The nodes of a step are freed
+ * together once the graph is released after backward, and the next step
+ * creates nodes of the same sizes, so the lists stay short.
+ *
+ * A block freed on another thread goes to the free list of that thread, and
+ * FLAGS_eager_grad_node_pool_size bounds each list. Blocks larger than the
+ * largest size class are not pooled.
+ **/
+class GradNodePool {
+ public:
+  TEST_API static void* Allocate(size_t size);
+  TEST_API static void Free(void* ptr, size_t size);
+
+  // The number of blocks cached by the calling thread.
+  TEST_API static size_t CachedBlockNum();
+  // Give the blocks cached by the calling thread back to the heap.
+  TEST_API static void Release();
+};
+
+}  // namespace egr
@@ -25,6 +25,7 @@
  * with no grad **/
 
 #pragma once
+#include "paddle/fluid/eager/activation_offload.h"
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/grad_node_info.h"
 #include "paddle/fluid/eager/utils.h"
@@ -122,7 +123,19 @@ class TensorWrapper {
         packed_value_ = (*pack_hook)(tensor);
       } else {
 #endif
-        intermidiate_tensor_.set_impl(tensor.impl());
+        offloaded_ = OffloadSavedTensor(tensor);
+        if (offloaded_) {
+          // Only keep the meta, ReloadSavedTensor brings the data back
+          phi::DenseTensor* dense_tensor =
+              static_cast<phi::DenseTensor*>(tensor.impl().get());
+          auto offloaded_tensor = std::make_shared<phi::DenseTensor>(
+              std::make_shared<phi::Allocation>(nullptr, 0, tensor.place()),
+              dense_tensor->meta());
+          offloaded_tensor->ShareInplaceVersionCounterWith(*dense_tensor);
+          intermidiate_tensor_.set_impl(offloaded_tensor);
+        } else {
+          intermidiate_tensor_.set_impl(tensor.impl());
+        }
 #ifndef PADDLE_NO_PYTHON
       }
 #endif
@@ -185,6 +198,10 @@ class TensorWrapper {
       }
     } else {
 #endif
+      if (offloaded_) {
+        static_cast<phi::DenseTensor*>(intermidiate_tensor_.impl().get())
+            ->ResetHolder(ReloadSavedTensor(offloaded_.get()));
+      }
       check_inplace_version();
 #ifndef PADDLE_NO_PYTHON
     }
@@ -216,7 +233,10 @@ class TensorWrapper {
 
   paddle::Tensor get_intermidiate_tensor() { return intermidiate_tensor_; }
 
-  void clear() { intermidiate_tensor_.reset(); }
+  void clear() {
+    intermidiate_tensor_.reset();
+    offloaded_.reset();
+  }
 
  private:
   void check_inplace_version() {
@@ -270,6 +290,7 @@ class TensorWrapper {
   paddle::Tensor intermidiate_tensor_;
   std::weak_ptr<egr::GradNodeBase> weak_grad_node_;
   uint32_t inplace_version_snapshot_ = 0;
+  std::shared_ptr<OffloadedTensor> offloaded_;
 #ifndef PADDLE_NO_PYTHON
   std::shared_ptr<egr::PyObjectHolderBase> packed_value_;
   std::shared_ptr<egr::UnPackHookBase> unpack_hook_;
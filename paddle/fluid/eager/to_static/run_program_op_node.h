@@ -162,6 +162,27 @@ static void CheckOutputVarStatus(const paddle::framework::Variable &src_var,
   }
 }
 
+static void ShareTensorIntoVar(const Tensor &tensor,
+                               paddle::framework::Variable *var) {
+  CheckInputVarStatus(tensor);
+  // share tensor
+  auto tensor_base = tensor.impl();
+  if (phi::DenseTensor::classof(tensor_base.get())) {
+    auto *dst_tensor = var->GetMutable<phi::DenseTensor>();
+    auto t = std::dynamic_pointer_cast<phi::DenseTensor>(tensor_base);
+    *dst_tensor = *t;
+  } else if (phi::SelectedRows::classof(tensor_base.get())) {
+    auto *dst_tensor = var->GetMutable<phi::SelectedRows>();
+    auto t = std::dynamic_pointer_cast<phi::SelectedRows>(tensor_base);
+    *dst_tensor = *t;
+  } else if (paddle::framework::VariableRefArray::classof(tensor_base.get())) {
+    auto *dst_tensor = var->GetMutable<paddle::framework::VariableRefArray>();
+    auto t = std::dynamic_pointer_cast<paddle::framework::VariableRefArray>(
+        tensor_base);
+    *dst_tensor = *t;
+  }
+}
+
 static void ShareTensorsIntoScopeWithName(
     const std::vector<Tensor> &tensors,
     const std::vector<std::string> &tensor_names,
@@ -173,25 +194,7 @@ static void ShareTensorsIntoScopeWithName(
         name == paddle::framework::kEmptyVarName) {
       continue;
     }
-    auto *var = scope->Var(name);
-    CheckInputVarStatus(tensors[i]);
-    // share tensor
-    auto tensor_base = tensors[i].impl();
-    if (phi::DenseTensor::classof(tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<phi::DenseTensor>();
-      auto t = std::dynamic_pointer_cast<phi::DenseTensor>(tensor_base);
-      *dst_tensor = *t;
-    } else if (phi::SelectedRows::classof(tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<phi::SelectedRows>();
-      auto t = std::dynamic_pointer_cast<phi::SelectedRows>(tensor_base);
-      *dst_tensor = *t;
-    } else if (paddle::framework::VariableRefArray::classof(
-                   tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<paddle::framework::VariableRefArray>();
-      auto t = std::dynamic_pointer_cast<paddle::framework::VariableRefArray>(
-          tensor_base);
-      *dst_tensor = *t;
-    }
+    ShareTensorIntoVar(tensors[i], scope->Var(name));
   }
 }
 
@@ -217,6 +220,82 @@ static void ShareTensorsIntoScopeByValue(
   ShareTensorsIntoScopeWithName(tensors, names, scope);
 }
 
+static void ShareTensorFromVar(const paddle::framework::Variable &var,
+                               Tensor *tensor) {
+  CheckOutputVarStatus(var, *tensor);
+  // share tensor
+  if (var.IsType<phi::DenseTensor>()) {
+    auto &src_tensor = var.Get<phi::DenseTensor>();
+    auto *dst_tensor = const_cast<phi::DenseTensor *>(
+        dynamic_cast<const phi::DenseTensor *>(tensor->impl().get()));
+    *dst_tensor = src_tensor;
+  } else if (var.IsType<phi::SelectedRows>()) {
+    auto &src_tensor = var.Get<phi::SelectedRows>();
+    auto *dst_tensor = const_cast<phi::SelectedRows *>(
+        dynamic_cast<const phi::SelectedRows *>(tensor->impl().get()));
+    *dst_tensor = src_tensor;
+  } else if (var.IsType<paddle::framework::VariableRefArray>()) {
+    auto &src_tensor = var.Get<paddle::framework::VariableRefArray>();
+    auto *dst_tensor = const_cast<paddle::framework::VariableRefArray *>(
+        dynamic_cast<const paddle::framework::VariableRefArray *>(
+            tensor->impl().get()));
+    *dst_tensor = src_tensor;
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "The RunProgram(Grad)Op only support output "
+        "variable of type DenseTensor, SelectedRows or VariableRefArray",
+        tensor->name()));
+  }
+}
+
+// The variables of values in scope, nullptr for the values that are skipped
+// when sharing, the inputs are created and the outputs must exist.
+static std::vector<paddle::framework::Variable *> GetScopeVarsByValue(
+    const std::vector<::pir::Value> &values,
+    paddle::framework::Scope *scope,
+    bool is_input) {
+  auto names = GetNameFromValue(values);
+  std::vector<paddle::framework::Variable *> vars(values.size(), nullptr);
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto &name = names[i];
+    if (is_input) {
+      if (name != paddle::framework::kFakeVarName &&
+          name != paddle::framework::kEmptyVarName) {
+        vars[i] = scope->Var(name);
+      }
+    } else if (values[i].impl() != nullptr) {
+      vars[i] = scope->FindVar(name);
+      PADDLE_ENFORCE_NOT_NULL(
+          vars[i],
+          common::errors::NotFound("The output tensor %s is not in "
+                                   "RunProgram(Grad)Op'"
+                                   "s internal scope.",
+                                   name));
+    }
+  }
+  return vars;
+}
+
+static void ShareTensorsIntoVars(
+    const std::vector<Tensor> &tensors,
+    const std::vector<paddle::framework::Variable *> &vars) {
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (vars[i] != nullptr) {
+      ShareTensorIntoVar(tensors[i], vars[i]);
+    }
+  }
+}
+
+static void ShareTensorsFromVars(
+    const std::vector<Tensor *> &tensors,
+    const std::vector<paddle::framework::Variable *> &vars) {
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (vars[i] != nullptr) {
+      ShareTensorFromVar(*vars[i], tensors[i]);
+    }
+  }
+}
+
 static void ShareTensorsFromScopeByValue(
     const std::vector<Tensor *> &tensors,
     const std::vector<::pir::Value> &values,
@@ -238,31 +317,8 @@ static void ShareTensorsFromScopeByValue(
                                  "RunProgram(Grad)Op'"
                                  "s internal scope.",
                                  name));
-    CheckOutputVarStatus(*var, *tensors[i]);
-    // share tensor
-    if (var->IsType<phi::DenseTensor>()) {
-      auto &src_tensor = var->Get<phi::DenseTensor>();
-      auto *dst_tensor = const_cast<phi::DenseTensor *>(
-          dynamic_cast<const phi::DenseTensor *>(tensors[i]->impl().get()));
-      VLOG(2) << "actually do sharing " << name << " from scope";
-      *dst_tensor = src_tensor;
-    } else if (var->IsType<phi::SelectedRows>()) {
-      auto &src_tensor = var->Get<phi::SelectedRows>();
-      auto *dst_tensor = const_cast<phi::SelectedRows *>(
-          dynamic_cast<const phi::SelectedRows *>(tensors[i]->impl().get()));
-      *dst_tensor = src_tensor;
-    } else if (var->IsType<paddle::framework::VariableRefArray>()) {
-      auto &src_tensor = var->Get<paddle::framework::VariableRefArray>();
-      auto *dst_tensor = const_cast<paddle::framework::VariableRefArray *>(
-          dynamic_cast<const paddle::framework::VariableRefArray *>(
-              tensors[i]->impl().get()));
-      *dst_tensor = src_tensor;
-    } else {
-      PADDLE_THROW(common::errors::InvalidArgument(
-          "The RunProgram(Grad)Op only support output "
-          "variable of type DenseTensor, SelectedRows or VariableRefArray",
-          name));
-    }
+    VLOG(2) << "actually do sharing " << name << " from scope";
+    ShareTensorFromVar(*var, tensors[i]);
   }
 }
 
@@ -438,6 +494,10 @@ inline void PirRunProgramAPI(
   auto &cache = paddle::framework::InterpreterCoreInfoCache::Instance();
   std::shared_ptr<paddle::framework::InterpreterCore> interpreter_core =
       nullptr;
+  // the variables of x, params and out bound in the cache, nullptr when
+  // the interpretercore is created by this run
+  std::vector<std::vector<paddle::framework::Variable *>> *bound_vars =
+      nullptr;
   if (!cache.Has(program_id,
                  global_inner_scope,
                  place_hash_key,
@@ -512,10 +572,19 @@ inline void PirRunProgramAPI(
                                           /*is_grad=*/false,
                                           /*in_pir_mode=*/true);
     interpreter_core = cached_value.core_;
-    // Step 2. update scope for cache interpretercore
-    details::ShareTensorsIntoScopeByValue(x, input_values, global_inner_scope);
-    details::ShareTensorsIntoScopeByValue(
-        params, param_values, global_inner_scope);
+    // Step 2. update scope for cache interpretercore, the outputs are in
+    // the scope since the run creating the interpretercore
+    bound_vars = &cached_value.bound_vars_;
+    if (bound_vars->empty()) {
+      bound_vars->push_back(details::GetScopeVarsByValue(
+          input_values, global_inner_scope, /*is_input=*/true));
+      bound_vars->push_back(details::GetScopeVarsByValue(
+          param_values, global_inner_scope, /*is_input=*/true));
+      bound_vars->push_back(details::GetScopeVarsByValue(
+          output_values, global_inner_scope, /*is_input=*/false));
+    }
+    details::ShareTensorsIntoVars(x, (*bound_vars)[0]);
+    details::ShareTensorsIntoVars(params, (*bound_vars)[1]);
     // TODO(xiongkun): new ir how to build scope.
     // if (interpreter_core->GetVariableScope()->GetMutableScope() !=
     // global_inner_scope) {
@@ -539,8 +608,12 @@ inline void PirRunProgramAPI(
     phi::RecordEvent record_event(
         "fetch_and_gc", paddle::platform::TracerEventType::UserDefined, 1);
     // Get Output, and Middle Outputs
-    details::ShareTensorsFromScopeByValue(
-        out, output_values, global_inner_scope);
+    if (bound_vars != nullptr) {
+      details::ShareTensorsFromVars(out, (*bound_vars)[2]);
+    } else {
+      details::ShareTensorsFromScopeByValue(
+          out, output_values, global_inner_scope);
+    }
 
     VLOG(3) << paddle::framework::GenScopeTreeDebugInfo(out_scope_vec->front());
 
@@ -999,13 +1072,13 @@ inline void PirRunProgramGradAPI(
 
   details::Trans2ContiguousTensorsInplace(out_grad);
 
-  // share x, param, middles, output_grads, out into scope.
-  details::ShareTensorsIntoScopeByValue(
-      out_grad, output_grad_values, global_inner_scope);
-
   auto &cache = paddle::framework::InterpreterCoreInfoCache::Instance();
   std::shared_ptr<paddle::framework::InterpreterCore> interpreter_core =
       nullptr;
+  // the variables of out_grad, x_grad and params_grad bound in the cache,
+  // nullptr when the interpretercore is created by this run
+  std::vector<std::vector<paddle::framework::Variable *>> *bound_vars =
+      nullptr;
   if (!cache.Has(program_id,
                  global_inner_scope,
                  place_hash_key,
@@ -1016,6 +1089,9 @@ inline void PirRunProgramGradAPI(
         paddle::platform::TracerEventType::UserDefined,
         1);
     VLOG(2) << "No interpretercore cache, so create a new interpretercore";
+    // share x, param, middles, output_grads, out into scope.
+    details::ShareTensorsIntoScopeByValue(
+        out_grad, output_grad_values, global_inner_scope);
     // Step 1. share input_vars & parameters into scope
     auto passed_kernel_program =
         paddle::framework::ApplyIrPass(backward_program.get(), place);
@@ -1092,6 +1168,16 @@ inline void PirRunProgramGradAPI(
       // *interpreter_core.get(), *backward_global_block, global_inner_scope);
       interpreter_core->reset_scope(global_inner_scope);
     }
+    bound_vars = &cached_value.bound_vars_;
+    if (bound_vars->empty()) {
+      bound_vars->push_back(details::GetScopeVarsByValue(
+          output_grad_values, global_inner_scope, /*is_input=*/true));
+      bound_vars->push_back(details::GetScopeVarsByValue(
+          x_grad_values, global_inner_scope, /*is_input=*/false));
+      bound_vars->push_back(details::GetScopeVarsByValue(
+          p_grad_values, global_inner_scope, /*is_input=*/false));
+    }
+    details::ShareTensorsIntoVars(out_grad, (*bound_vars)[0]);
   }
 
   paddle::framework::RunFeedHooks(*backward_program, *global_inner_scope);
@@ -1109,10 +1195,15 @@ inline void PirRunProgramGradAPI(
     phi::RecordEvent record_event(
         "fetch_and_gc", paddle::platform::TracerEventType::UserDefined, 1);
     // Step 4. get outputs
-    details::ShareTensorsFromScopeByValue(
-        x_grad, x_grad_values, global_inner_scope);
-    details::ShareTensorsFromScopeByValue(
-        params_grad, p_grad_values, global_inner_scope);
+    if (bound_vars != nullptr) {
+      details::ShareTensorsFromVars(x_grad, (*bound_vars)[1]);
+      details::ShareTensorsFromVars(params_grad, (*bound_vars)[2]);
+    } else {
+      details::ShareTensorsFromScopeByValue(
+          x_grad, x_grad_values, global_inner_scope);
+      details::ShareTensorsFromScopeByValue(
+          params_grad, p_grad_values, global_inner_scope);
+    }
     VLOG(4) << "after backward gc all vars";
     global_inner_scope->SetCanReused(true);
     details::GcScope(global_inner_scope);
@@ -22,11 +22,15 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT
 #include <condition_variable>  // NOLINT
 #include <deque>
 #include <limits>
 #include <memory>
-#include <mutex>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -36,6 +40,110 @@
 namespace paddle {
 namespace framework {
 
+// A bounded lock free MPMC ring after the bounded queue of Dmitry Vyukov.
+// Every cell carries the sequence of the lap it is free or full for, so the
+// readers and the writers only contend on the cursor they advance, and a
+// block of contiguous cells is claimed by a single CAS of it.
+template <class T>
+class LockFreeRing {
+ public:
+  // capacity is rounded up to a power of 2
+  explicit LockFreeRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mask_ = size - 1;
+    cells_.reset(new Cell[size]);
+    for (size_t i = 0; i < size; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  size_t Capacity() const { return mask_ + 1; }
+
+  // the cells claimed by the writers and not yet by the readers
+  size_t Size() const {
+    size_t tail = dequeue_pos_.load(std::memory_order_acquire);
+    size_t head = enqueue_pos_.load(std::memory_order_acquire);
+    return head > tail ? head - tail : 0;
+  }
+
+  // Write up to n values from p, which are moved if p points to non-const.
+  // Returns 0 if the ring is full.
+  template <class U>
+  size_t TryWrite(size_t n, U* p) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    size_t m = Claim(&enqueue_pos_, pos, n, 0, &pos);
+    using Ref = typename std::conditional<std::is_const<U>::value,
+                                          const T&,
+                                          T&&>::type;
+    for (size_t i = 0; i < m; i++) {
+      Cell& cell = cells_[(pos + i) & mask_];
+      cell.value = static_cast<Ref>(p[i]);
+      cell.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return m;
+  }
+
+  // Read up to n values into p. Returns 0 if the ring is empty.
+  size_t TryRead(size_t n, T* p) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    size_t m = Claim(&dequeue_pos_, pos, n, 1, &pos);
+    for (size_t i = 0; i < m; i++) {
+      Cell& cell = cells_[(pos + i) & mask_];
+      p[i] = std::move(cell.value);
+      cell.sequence.store(pos + i + mask_ + 1, std::memory_order_release);
+    }
+    return m;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  // Advance cursor over up to n contiguous cells whose sequence is their
+  // position plus lag, and return their number and first position.
+  size_t Claim(std::atomic<size_t>* cursor,
+               size_t pos,
+               size_t n,
+               size_t lag,
+               size_t* first) {
+    if (n == 0) {
+      return 0;
+    }
+    while (true) {
+      size_t m = 0;
+      while (m < n && cells_[(pos + m) & mask_].sequence.load(
+                          std::memory_order_acquire) == pos + m + lag) {
+        m++;
+      }
+      if (m == 0) {
+        size_t sequence =
+            cells_[pos & mask_].sequence.load(std::memory_order_acquire);
+        // the cell is still a lap behind, i.e. the ring is full or empty
+        if (static_cast<std::ptrdiff_t>(sequence - (pos + lag)) < 0) {
+          return 0;
+        }
+        pos = cursor->load(std::memory_order_relaxed);
+        continue;
+      }
+      if (cursor->compare_exchange_weak(
+              pos, pos + m, std::memory_order_relaxed)) {
+        *first = pos;
+        return m;
+      }
+    }
+  }
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+
 template <class T>
 class ChannelObject {
  public:
@@ -46,19 +154,58 @@ class ChannelObject {
     capacity_ = (std::min)(MaxCapacity(), capacity);
   }
 
+  // empty if the channel is lock free
   const std::deque<T>& GetData() const { return data_; }
   void Clear() {
     std::unique_lock<std::mutex> lock(mutex_);
+    if (ring_ != nullptr) {
+      T val;
+      while (ring_->TryRead(1, &val) != 0) {
+      }
+      return;
+    }
     data_.clear();
     data_.shrink_to_fit();
   }
 
+  // Keep the data in a LockFreeRing of the capacity rounded up to a power of
+  // 2 instead of the deque guarded by the mutex, so the readers and writers
+  // of a bounded channel do not serialize on it, and wait for each other by
+  // spinning and then sleeping rather than on the condition variables. It
+  // must be called on an empty channel before the channel is shared, and the
+  // channel should be closed after its writers return, since the writes in
+  // flight when it is closed may not be read.
+  void EnableLockFree() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(
+        capacity_ >= 1 && capacity_ <= kMaxLockFreeCapacity,
+        true,
+        common::errors::InvalidArgument(
+            "The capacity of a lock free channel should be in [1, %d], but "
+            "got %d.",
+            kMaxLockFreeCapacity,
+            capacity_));
+    PADDLE_ENFORCE_EQ(data_.empty(),
+                      true,
+                      common::errors::PreconditionNotMet(
+                          "The channel should be empty to be lock free."));
+    if (ring_ == nullptr) {
+      ring_ = std::make_unique<LockFreeRing<T>>(capacity_);
+    }
+  }
+
+  bool IsLockFree() const { return ring_ != nullptr; }
+
   size_t Capacity() {
     return capacity_;  // atomic
   }
 
   void SetCapacity(size_t x) {  // capacity can be zero
     std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(ring_,
+                      nullptr,
+                      common::errors::PreconditionNotMet(
+                          "The capacity of a lock free channel is fixed."));
     capacity_ = std::min(MaxCapacity(), x);
     Notify();
   }
@@ -104,11 +251,17 @@ class ChannelObject {
   }
 
   size_t Size() {
+    if (ring_ != nullptr) {
+      return ring_->Size();
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     return data_.size();
   }
 
   bool Empty() {
+    if (ring_ != nullptr) {
+      return ring_->Size() == 0;
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     return EmptyUnlocked();
   }
@@ -122,6 +275,9 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      return LockFreeRead(n, p, false);
+    }
 
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = Read(n, p, lock);
@@ -141,6 +297,9 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      return LockFreeWrite(n, p);
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = Write(n, p, lock);
     Notify();
@@ -152,6 +311,9 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      return LockFreeWrite(n, p);
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = WriteMove(n, p, lock);
     Notify();
@@ -170,6 +332,12 @@ class ChannelObject {
     if (size == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      p.resize(size);
+      size_t finished = LockFreeRead(size, &p[0], true);
+      p.resize(finished);
+      return finished;
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     p.resize(size);
     size_t finished = Read(size, &p[0], lock, true);
@@ -202,20 +370,70 @@ class ChannelObject {
  private:
   size_t capacity_ = MaxCapacity();
   size_t block_size_ = 1024;
-  bool closed_ = false;
+  std::atomic<bool> closed_{false};
   std::mutex mutex_;
   // use deque to store data
   std::deque<T> data_;
+  // replaces data_ once the channel is lock free
+  std::unique_ptr<LockFreeRing<T>> ring_;
   size_t reading_count_ = 0;
   int empty_waiters_ = 0;
   int full_waiters_ = 0;
   std::condition_variable empty_cond_;
   std::condition_variable full_cond_;
 
+  static constexpr size_t kMaxLockFreeCapacity = size_t(1) << 24;
+
   static constexpr size_t MaxCapacity() {
     return (std::numeric_limits<size_t>::max)() / 2;
   }
 
+  static void Backoff(size_t* spins) {
+    if (++*spins < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  size_t LockFreeRead(size_t n, T* p, bool once) {
+    size_t finished = 0;
+    size_t spins = 0;
+    while (finished < n) {
+      size_t m = ring_->TryRead(n - finished, p + finished);
+      if (m > 0) {
+        finished += m;
+        spins = 0;
+        if (once) {
+          break;
+        }
+        continue;
+      }
+      // the claimed cells still count in Size(), so they are waited for
+      if (closed_ && ring_->Size() == 0) {
+        break;
+      }
+      Backoff(&spins);
+    }
+    return finished;
+  }
+
+  template <class U>
+  size_t LockFreeWrite(size_t n, U* p) {
+    size_t finished = 0;
+    size_t spins = 0;
+    while (finished < n && !closed_) {
+      size_t m = ring_->TryWrite(n - finished, p + finished);
+      if (m > 0) {
+        finished += m;
+        spins = 0;
+        continue;
+      }
+      Backoff(&spins);
+    }
+    return finished;
+  }
+
   void Notify() {
     if (empty_waiters_ != 0 && (!EmptyUnlocked() || closed_)) {
       empty_cond_.notify_one();
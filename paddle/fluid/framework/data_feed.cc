@@ -19,6 +19,8 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/data_feed.h"
 
+#include <algorithm>
+
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
 #ifdef _LINUX
 #include <stdio_ext.h>
@@ -28,9 +30,14 @@ limitations under the License. */
 #include "io/fs.h"
 #include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/timer.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/utils/string/fast_strto.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 COMMON_DECLARE_bool(enable_ins_parser_file);
+COMMON_DECLARE_bool(data_feed_lock_free_queue);
+COMMON_DECLARE_int32(queue_dataset_shuffle_window);
+COMMON_DECLARE_bool(queue_dataset_prefetch_file);
 namespace paddle::framework {
 
 DLManager& global_dlmanager_pool() {
@@ -38,6 +45,170 @@ DLManager& global_dlmanager_pool() {
   return manager;
 }
 
+// The coding of the packed SlotValues: the first offset and the slot
+// lengths as varints, a byte telling how the values are coded, then the
+// values.
+enum SlotValuesCoding : uint8_t {
+  kRawValues = 0,
+  kDeltaVarintValues = 1,
+  kHalfValues = 2,
+};
+
+static size_t VarintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+static void PutVarint(uint64_t value, std::vector<uint8_t>* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+static uint64_t GetVarint(const uint8_t** in) {
+  uint64_t value = 0;
+  int shift = 0;
+  while (**in & 0x80) {
+    value |= static_cast<uint64_t>(**in & 0x7f) << shift;
+    shift += 7;
+    ++(*in);
+  }
+  value |= static_cast<uint64_t>(**in) << shift;
+  ++(*in);
+  return value;
+}
+
+static uint64_t ZigzagDelta(uint64_t value, uint64_t last) {
+  int64_t delta = static_cast<int64_t>(value - last);
+  return (static_cast<uint64_t>(delta) << 1) ^
+         static_cast<uint64_t>(delta >> 63);
+}
+
+static uint64_t UnzigzagDelta(uint64_t coded, uint64_t last) {
+  return last + ((coded >> 1) ^ (~(coded & 1) + 1));
+}
+
+static void PackSlotOffsets(const std::vector<uint32_t>& offsets,
+                            std::vector<uint8_t>* out) {
+  PutVarint(offsets.size() - 1, out);
+  PutVarint(offsets[0], out);
+  for (size_t i = 1; i < offsets.size(); ++i) {
+    PutVarint(offsets[i] - offsets[i - 1], out);
+  }
+}
+
+static const uint8_t* UnpackSlotOffsets(const uint8_t* in,
+                                        std::vector<uint32_t>* offsets) {
+  size_t slot_num = GetVarint(&in);
+  offsets->resize(slot_num + 1);
+  (*offsets)[0] = static_cast<uint32_t>(GetVarint(&in));
+  for (size_t i = 1; i <= slot_num; ++i) {
+    (*offsets)[i] = (*offsets)[i - 1] + static_cast<uint32_t>(GetVarint(&in));
+  }
+  return in;
+}
+
+template <>
+void SlotValues<uint64_t>::compress(bool half UNUSED) {
+  if (is_packed() || slot_offsets.empty()) {
+    return;
+  }
+  size_t varint_size = 0;
+  uint64_t last = 0;
+  for (uint64_t value : slot_values) {
+    varint_size += VarintSize(ZigzagDelta(value, last));
+    last = value;
+  }
+  const bool delta = varint_size < slot_values.size() * sizeof(uint64_t);
+  packed.reserve(slot_offsets.size() * 2 + 1 +
+                 (delta ? varint_size
+                        : slot_values.size() * sizeof(uint64_t)));
+  PackSlotOffsets(slot_offsets, &packed);
+  if (delta) {
+    packed.push_back(kDeltaVarintValues);
+    last = 0;
+    for (uint64_t value : slot_values) {
+      PutVarint(ZigzagDelta(value, last), &packed);
+      last = value;
+    }
+  } else {
+    packed.push_back(kRawValues);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(slot_values.data());
+    packed.insert(
+        packed.end(), data, data + slot_values.size() * sizeof(uint64_t));
+  }
+  packed.shrink_to_fit();
+  packed_num = static_cast<uint32_t>(slot_values.size());
+  std::vector<uint64_t>().swap(slot_values);
+  std::vector<uint32_t>().swap(slot_offsets);
+}
+
+template <>
+void SlotValues<uint64_t>::decompress(SlotValues<uint64_t>* out) const {
+  const uint8_t* in = UnpackSlotOffsets(packed.data(), &out->slot_offsets);
+  const uint8_t coding = *in++;
+  out->slot_values.resize(packed_num);
+  if (coding == kDeltaVarintValues) {
+    uint64_t last = 0;
+    for (uint32_t i = 0; i < packed_num; ++i) {
+      last = UnzigzagDelta(GetVarint(&in), last);
+      out->slot_values[i] = last;
+    }
+  } else {
+    memcpy(out->slot_values.data(), in, packed_num * sizeof(uint64_t));
+  }
+}
+
+template <>
+void SlotValues<float>::compress(bool half) {
+  if (is_packed() || slot_offsets.empty()) {
+    return;
+  }
+  const size_t value_size = half ? sizeof(phi::dtype::float16) : sizeof(float);
+  packed.reserve(slot_offsets.size() * 2 + 1 +
+                 slot_values.size() * value_size);
+  PackSlotOffsets(slot_offsets, &packed);
+  if (half) {
+    packed.push_back(kHalfValues);
+    for (float value : slot_values) {
+      uint16_t bits = phi::dtype::float16(value).x;
+      packed.push_back(static_cast<uint8_t>(bits));
+      packed.push_back(static_cast<uint8_t>(bits >> 8));
+    }
+  } else {
+    packed.push_back(kRawValues);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(slot_values.data());
+    packed.insert(
+        packed.end(), data, data + slot_values.size() * sizeof(float));
+  }
+  packed.shrink_to_fit();
+  packed_num = static_cast<uint32_t>(slot_values.size());
+  std::vector<float>().swap(slot_values);
+  std::vector<uint32_t>().swap(slot_offsets);
+}
+
+template <>
+void SlotValues<float>::decompress(SlotValues<float>* out) const {
+  const uint8_t* in = UnpackSlotOffsets(packed.data(), &out->slot_offsets);
+  const uint8_t coding = *in++;
+  out->slot_values.resize(packed_num);
+  if (coding == kHalfValues) {
+    for (uint32_t i = 0; i < packed_num; ++i, in += 2) {
+      out->slot_values[i] =
+          static_cast<float>(phi::dtype::raw_uint16_to_float16(
+              static_cast<uint16_t>(in[0] | (in[1] << 8))));
+    }
+  } else {
+    memcpy(out->slot_values.data(), in, packed_num * sizeof(float));
+  }
+}
+
 class BufferedLineFileReader {
   typedef std::function<bool()> SampleFunc;
   static const int MAX_FILE_BUFF_SIZE = 4 * 1024 * 1024;
@@ -290,6 +461,9 @@ void PrivateQueueDataFeed<T>::SetQueueSize(int queue_size) {
   queue_size_ = queue_size;
   queue_ = paddle::framework::MakeChannel<T>();
   queue_->SetCapacity(queue_size);
+  if (FLAGS_data_feed_lock_free_queue) {
+    queue_->EnableLockFree();
+  }
 }
 
 template <typename T>
@@ -308,10 +482,7 @@ void PrivateQueueDataFeed<T>::ReadThread() {
 #ifdef _LINUX
   VLOG(4) << "entering PrivateQueueDataFeed<T>::ReadThread()";
   std::string filename;
-  while (PickOneFile(&filename)) {
-    int err_no = 0;
-    fp_ = fs_open_read(filename, &err_no, pipe_command_, true);
-    __fsetlocking(&*fp_, FSETLOCKING_BYCALLER);
+  while (OpenNextFile(&filename)) {
     T instance;
     while (ParseOneInstanceFromPipe(&instance)) {
       queue_->Put(instance);
@@ -321,6 +492,60 @@ void PrivateQueueDataFeed<T>::ReadThread() {
 #endif
 }
 
+template <typename T>
+bool PrivateQueueDataFeed<T>::OpenNextFile(std::string* filename) {
+#ifdef _LINUX
+  auto open_file = [this](std::string* name) -> std::shared_ptr<FILE> {
+    if (!PickOneFile(name)) {
+      return nullptr;
+    }
+    int err_no = 0;
+    auto fp = fs_open_read(*name, &err_no, pipe_command_, true);
+    CHECK(fp != nullptr);
+    __fsetlocking(&*fp, FSETLOCKING_BYCALLER);
+    return fp;
+  };
+  if (prefetched_fp_ != nullptr) {
+    fp_ = std::move(prefetched_fp_);
+    *filename = prefetched_file_;
+  } else {
+    fp_ = open_file(filename);
+  }
+  // the pipe command of the next file runs while this one is parsed
+  if (fp_ != nullptr && FLAGS_queue_dataset_prefetch_file) {
+    prefetched_fp_ = open_file(&prefetched_file_);
+  }
+  return fp_ != nullptr;
+#else
+  return false;
+#endif
+}
+
+template <typename T>
+bool PrivateQueueDataFeed<T>::GetInstance(T* instance) {
+  const size_t window = std::max(FLAGS_queue_dataset_shuffle_window, 0);
+  if (window <= 1 && shuffle_window_.empty()) {
+    return queue_->Get(*instance);
+  }
+  // the queue is bounded, so the reader thread waits while the window is
+  // full and never holds more than the window and the queue
+  while (shuffle_window_.size() < window) {
+    T next;
+    if (!queue_->Get(next)) {
+      break;
+    }
+    shuffle_window_.push_back(std::move(next));
+  }
+  if (shuffle_window_.empty()) {
+    return false;
+  }
+  std::uniform_int_distribution<size_t> dist(0, shuffle_window_.size() - 1);
+  std::swap(shuffle_window_[dist(shuffle_engine_)], shuffle_window_.back());
+  *instance = std::move(shuffle_window_.back());
+  shuffle_window_.pop_back();
+  return true;
+}
+
 template <typename T>
 int PrivateQueueDataFeed<T>::Next() {
 #ifdef _LINUX
@@ -329,7 +554,7 @@ int PrivateQueueDataFeed<T>::Next() {
   T ins_vec;
   while (index < default_batch_size_) {
     T instance;
-    if (!queue_->Get(instance)) {
+    if (!GetInstance(&instance)) {
       break;
     }
     AddInstanceToInsVec(&ins_vec, instance, index++);
@@ -699,11 +924,7 @@ void MultiSlotDataFeed::ReadThread() {
 #ifdef _LINUX
   VLOG(4) << "entering MultiSlotDataFeed::ReadThread()";
   std::string filename;
-  while (PickOneFile(&filename)) {
-    int err_no = 0;
-    fp_ = fs_open_read(filename, &err_no, pipe_command_, true);
-    CHECK(fp_ != nullptr);
-    __fsetlocking(&*fp_, FSETLOCKING_BYCALLER);
+  while (OpenNextFile(&filename)) {
     std::vector<MultiSlotType> instance;
     int ins_num = 0;
     while (ParseOneInstanceFromPipe(&instance)) {
@@ -866,13 +1087,14 @@ bool MultiSlotDataFeed::ParseOneInstanceFromPipe(
     int use_slots_num = use_slots_.size();
     instance->resize(use_slots_num);
     const char* str = reader.get();
-    std::string line = std::string(str);
+    const char* line = str;
+    const char* str_end = str + reader.length();
 
     char* endptr = const_cast<char*>(str);
     int pos = 0;
     for (size_t i = 0; i < use_slots_index_.size(); ++i) {
       int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
+      int num = string::fast_strtol(&str[pos], str_end, &endptr);
 
       if (num <= 0) {
         std::stringstream ss;
@@ -899,12 +1121,13 @@ bool MultiSlotDataFeed::ParseOneInstanceFromPipe(
         (*instance)[idx].Init(all_slots_type_[i]);
         if ((*instance)[idx].GetType()[0] == 'f') {  // float
           for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
+            float feasign = string::fast_strtof(endptr, str_end, &endptr);
             (*instance)[idx].AddValue(feasign);
           }
         } else if ((*instance)[idx].GetType()[0] == 'u') {  // uint64
           for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+            uint64_t feasign =
+                (uint64_t)string::fast_strtoull(endptr, str_end, &endptr);
             (*instance)[idx].AddValue(feasign);
           }
         }
@@ -1153,12 +1376,14 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
     return false;
   } else {
     const char* str = reader.get();
-    std::string line = std::string(str);
+    const char* line = str;
+    const char* str_end = str + reader.length();
     // VLOG(3) << line;
     char* endptr = const_cast<char*>(str);
     int pos = 0;
     if (parse_ins_id_) {
-      int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+      int num = static_cast<int>(
+          string::fast_strtol(&str[pos], str_end, &endptr));
       CHECK(num == 1);  // NOLINT
       pos = static_cast<int>(endptr - str + 1);
       size_t len = 0;
@@ -1170,7 +1395,8 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
       VLOG(3) << "ins_id " << instance->ins_id_;
     }
     if (parse_content_) {
-      int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+      int num = static_cast<int>(
+          string::fast_strtol(&str[pos], str_end, &endptr));
       CHECK(num == 1);  // NOLINT
       pos = static_cast<int>(endptr - str + 1);
       size_t len = 0;
@@ -1182,7 +1408,8 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
       VLOG(3) << "content " << instance->content_;
     }
     if (parse_logkey_) {
-      int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+      int num = static_cast<int>(
+          string::fast_strtol(&str[pos], str_end, &endptr));
       CHECK(num == 1);  // NOLINT
       pos = static_cast<int>(endptr - str + 1);
       size_t len = 0;
@@ -1204,7 +1431,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
     }
     for (size_t i = 0; i < use_slots_index_.size(); ++i) {
       int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
+      int num = string::fast_strtol(&str[pos], str_end, &endptr);
       PADDLE_ENFORCE_NE(
           num,
           0,
@@ -1230,14 +1457,15 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
                            str));
 
         char* uidptr = endptr;
-        uint64_t feasign = (uint64_t)strtoull(uidptr, &uidptr, 10);
+        uint64_t feasign =
+            (uint64_t)string::fast_strtoull(uidptr, str_end, &uidptr);
         instance->uid_ = feasign;
       }
 #endif
       if (idx != -1) {
         if (all_slots_type_[i][0] == 'f') {  // float
           for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
+            float feasign = string::fast_strtof(endptr, str_end, &endptr);
             // if float feasign is equal to zero, ignore it
             // except when slot is dense
             if (fabs(feasign) < 1e-6 && !use_slots_is_dense_[i]) {
@@ -1249,7 +1477,8 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
           }
         } else if (all_slots_type_[i][0] == 'u') {  // uint64
           for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+            uint64_t feasign =
+                (uint64_t)string::fast_strtoull(endptr, str_end, &endptr);
             // if uint64 feasign is equal to zero, ignore it
             // except when slot is dense
             if (feasign == 0 && !use_slots_is_dense_[i]) {
@@ -2196,6 +2425,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByFile() {
                                  int max_fetch_num,
                                  int offset) {
     if (offset > 0) {
+      CompressRecords(&record_vec[0], offset);
       input_channel_->WriteMove(offset, &record_vec[0]);
       if (max_fetch_num > 0) {
         SlotRecordPool().get(&record_vec[0], offset);
@@ -2284,6 +2514,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByLine() {
                            std::vector<SlotRecord>& vec, int num) {
       vec.resize(num);
       if (offset + num > OBJPOOL_BLOCK_SIZE) {
+        CompressRecords(&record_vec[0], offset);
         input_channel_->WriteMove(offset, &record_vec[0]);
         SlotRecordPool().get(&record_vec[0], offset);
         record_vec.resize(OBJPOOL_BLOCK_SIZE);
@@ -2313,6 +2544,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByLine() {
         return false;
       }
       if (offset >= OBJPOOL_BLOCK_SIZE) {
+        CompressRecords(&record_vec[0], offset);
         input_channel_->Write(std::move(record_vec));
         record_vec.clear();
         SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
@@ -2332,6 +2564,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByLine() {
     } while (line_reader.is_error());
 
     if (offset > 0) {
+      CompressRecords(&record_vec[0], offset);
       input_channel_->WriteMove(offset, &record_vec[0]);
       if (offset < OBJPOOL_BLOCK_SIZE) {
         SlotRecordPool().put(&record_vec[offset],
@@ -2389,6 +2622,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
               return false;
             }
             if (offset >= OBJPOOL_BLOCK_SIZE) {
+              CompressRecords(&record_vec[0], offset);
               input_channel_->Write(std::move(record_vec));
               record_vec.clear();
               SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
@@ -2399,6 +2633,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
           lines);
     } while (line_reader.is_error());
     if (offset > 0) {
+      CompressRecords(&record_vec[0], offset);
       input_channel_->WriteMove(offset, &record_vec[0]);
       if (offset < OBJPOOL_BLOCK_SIZE) {
         SlotRecordPool().put(&record_vec[offset],
@@ -2439,6 +2674,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   SlotRecord& rec = (*ins);
   // parse line
   const char* str = line.c_str();
+  const char* str_end = str + line.size();
   char* endptr = const_cast<char*>(str);
   int pos = 0;
 
@@ -2448,7 +2684,8 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   slot_uint64_feasigns.resize(uint64_use_slot_size_);
 
   if (parse_ins_id_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = static_cast<int>(
+        string::fast_strtol(&str[pos], str_end, &endptr));
     CHECK(num == 1);  // NOLINT
     pos = static_cast<int>(endptr - str + 1);
     size_t len = 0;
@@ -2459,7 +2696,8 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
     pos += static_cast<int>(len + 1);
   }
   if (parse_logkey_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = static_cast<int>(
+        string::fast_strtol(&str[pos], str_end, &endptr));
     CHECK(num == 1);  // NOLINT
     pos = static_cast<int>(endptr - str + 1);
     size_t len = 0;
@@ -2484,7 +2722,8 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   int uint64_total_slot_num = 0;
 
   for (auto& info : all_slots_info_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = static_cast<int>(
+        string::fast_strtol(&str[pos], str_end, &endptr));
     PADDLE_ENFORCE(num,
                    "The number of ids can not be zero, you need padding "
                    "it in data generator; or if there is something wrong with "
@@ -2496,7 +2735,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
         auto& slot_fea = slot_float_feasigns[info.slot_value_idx];
         slot_fea.clear();
         for (int j = 0; j < num; ++j) {
-          float feasign = strtof(endptr, &endptr);
+          float feasign = string::fast_strtof(endptr, str_end, &endptr);
           if (fabs(feasign) < 1e-6 && !used_slots_info_[info.used_idx].dense) {
             continue;
           }
@@ -2508,7 +2747,8 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
         slot_fea.clear();
         for (int j = 0; j < num; ++j) {
           uint64_t feasign =
-              static_cast<uint64_t>(strtoull(endptr, &endptr, 10));
+              static_cast<uint64_t>(
+                  string::fast_strtoull(endptr, str_end, &endptr));
           slot_fea.push_back(feasign);
           ++uint64_total_slot_num;
         }
@@ -2564,6 +2804,17 @@ void SlotRecordInMemoryDataFeed::PutToFeedVec(const SlotRecord* ins_vec,
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
   // do nothing
 #else
+  // the compressed records are decoded once for all the slots
+  std::vector<const SlotValues<uint64_t>*> uint64_feasigns(num);
+  std::vector<const SlotValues<float>*> float_feasigns(num);
+  unpacked_uint64_feasigns_.resize(num);
+  unpacked_float_feasigns_.resize(num);
+  for (int i = 0; i < num; ++i) {
+    uint64_feasigns[i] = &ins_vec[i]->slot_uint64_feasigns_.unpacked(
+        &unpacked_uint64_feasigns_[i]);
+    float_feasigns[i] = &ins_vec[i]->slot_float_feasigns_.unpacked(
+        &unpacked_float_feasigns_[i]);
+  }
   for (int j = 0; j < use_slot_size_; ++j) {
     auto& feed = feed_vec_[j];
     if (feed == nullptr) {
@@ -2583,10 +2834,9 @@ void SlotRecordInMemoryDataFeed::PutToFeedVec(const SlotRecord* ins_vec,
       batch_fea.clear();
 
       for (int i = 0; i < num; ++i) {
-        auto r = ins_vec[i];
         size_t fea_num = 0;
-        float* slot_values =
-            r->slot_float_feasigns_.get_values(info.slot_value_idx, &fea_num);
+        const float* slot_values =
+            float_feasigns[i]->get_values(info.slot_value_idx, &fea_num);
         batch_fea.resize(total_instance + fea_num);
         memcpy(
             &batch_fea[total_instance], slot_values, sizeof(float) * fea_num);
@@ -2604,10 +2854,9 @@ void SlotRecordInMemoryDataFeed::PutToFeedVec(const SlotRecord* ins_vec,
       batch_fea.clear();
 
       for (int i = 0; i < num; ++i) {
-        auto r = ins_vec[i];
         size_t fea_num = 0;
-        uint64_t* slot_values =
-            r->slot_uint64_feasigns_.get_values(info.slot_value_idx, &fea_num);
+        const uint64_t* slot_values =
+            uint64_feasigns[i]->get_values(info.slot_value_idx, &fea_num);
         if (fea_num > 0) {
           batch_fea.resize(total_instance + fea_num);
           memcpy(&batch_fea[total_instance],
@@ -2644,6 +2893,18 @@ void SlotRecordInMemoryDataFeed::PutToFeedVec(const SlotRecord* ins_vec,
 #endif
 }
 
+void SlotRecordInMemoryDataFeed::CompressRecords(SlotRecord* records,
+                                                 int num) {
+  if (!FLAGS_enable_slotrecord_compress) {
+    return;
+  }
+  for (int i = 0; i < num; ++i) {
+    records[i]->slot_uint64_feasigns_.compress(false);
+    records[i]->slot_float_feasigns_.compress(
+        FLAGS_enable_slotrecord_float_fp16);
+  }
+}
+
 void SlotRecordInMemoryDataFeed::ExpandSlotRecord(SlotRecord* rec) {
   SlotRecord& ins = (*rec);
   if (ins->slot_float_feasigns_.slot_offsets.empty()) {
@@ -3107,171 +3368,93 @@ void MiniBatchGpuPack::reset(const phi::Place& place) {
   pv_num_ = 0;
 }
 
-void MiniBatchGpuPack::pack_all_data(const SlotRecord* ins_vec, int num) {
-  int uint64_total_num = 0;
-  int float_total_num = 0;
-
-  buf_.h_uint64_lens.resize(num + 1);
-  buf_.h_uint64_lens[0] = 0;
-  buf_.h_float_lens.resize(num + 1);
-  buf_.h_float_lens[0] = 0;
-
-  for (int i = 0; i < num; ++i) {
-    auto r = ins_vec[i];
-    uint64_total_num += r->slot_uint64_feasigns_.slot_values.size();
-    buf_.h_uint64_lens[i + 1] = uint64_total_num;
-    float_total_num += r->slot_float_feasigns_.slot_values.size();
-    buf_.h_float_lens[i + 1] = float_total_num;
-  }
-
-  int uint64_cols = (used_uint64_num_ + 1);
-  buf_.h_uint64_offset.resize(uint64_cols * num);
-  buf_.h_uint64_keys.resize(uint64_total_num);
-
-  int float_cols = (used_float_num_ + 1);
-  buf_.h_float_offset.resize(float_cols * num);
-  buf_.h_float_keys.resize(float_total_num);
-
-  size_t fea_num = 0;
-  uint64_total_num = 0;
-  float_total_num = 0;
-  for (int i = 0; i < num; ++i) {
-    auto r = ins_vec[i];
-    auto& uint64_feasigns = r->slot_uint64_feasigns_;
-    fea_num = uint64_feasigns.slot_values.size();
-    if (fea_num > 0) {
-      memcpy(&buf_.h_uint64_keys[uint64_total_num],
-             uint64_feasigns.slot_values.data(),
-             fea_num * sizeof(uint64_t));
-    }
-    uint64_total_num += fea_num;
-    // copy uint64 offset
-    memcpy(&buf_.h_uint64_offset[i * uint64_cols],
-           uint64_feasigns.slot_offsets.data(),
-           sizeof(int) * uint64_cols);
-
-    auto& float_feasigns = r->slot_float_feasigns_;
-    fea_num = float_feasigns.slot_values.size();
-    memcpy(&buf_.h_float_keys[float_total_num],
-           float_feasigns.slot_values.data(),
-           fea_num * sizeof(float));
-    float_total_num += fea_num;
-
-    // copy float offset
-    memcpy(&buf_.h_float_offset[i * float_cols],
-           float_feasigns.slot_offsets.data(),
-           sizeof(int) * float_cols);
-  }
-
-  CHECK(uint64_total_num == static_cast<int>(buf_.h_uint64_lens.back()))
-      << "uint64 value length error";
-  CHECK(float_total_num == static_cast<int>(buf_.h_float_lens.back()))
-      << "float value length error";
-}
-void MiniBatchGpuPack::pack_uint64_data(const SlotRecord* ins_vec, int num) {
-  int uint64_total_num = 0;
-
-  buf_.h_float_lens.clear();
-  buf_.h_float_keys.clear();
-  buf_.h_float_offset.clear();
-
-  buf_.h_uint64_lens.resize(num + 1);
-  buf_.h_uint64_lens[0] = 0;
-
+template <typename T>
+void MiniBatchGpuPack::pack_slot_values(const SlotRecord* ins_vec,
+                                        int num,
+                                        SlotValues<T> SlotRecordObject::*field,
+                                        int used_slot_num,
+                                        HostBuffer<int>* h_lens,
+                                        HostBuffer<T>* h_keys,
+                                        HostBuffer<int>* h_offset,
+                                        CudaBuffer<int>* d_lens,
+                                        CudaBuffer<T>* d_keys,
+                                        CudaBuffer<int>* d_offset) {
+  int total_num = 0;
+  h_lens->resize(num + 1);
+  (*h_lens)[0] = 0;
   for (int i = 0; i < num; ++i) {
-    auto r = ins_vec[i];
-    uint64_total_num += r->slot_uint64_feasigns_.slot_values.size();
-    buf_.h_uint64_lens[i + 1] = uint64_total_num;
+    total_num += (ins_vec[i]->*field).value_num();
+    (*h_lens)[i + 1] = total_num;
   }
 
-  int uint64_cols = (used_uint64_num_ + 1);
-  buf_.h_uint64_offset.resize(uint64_cols * num);
-  buf_.h_uint64_keys.resize(uint64_total_num);
+  int cols = (used_slot_num + 1);
+  h_offset->resize(cols * num);
+  h_keys->resize(total_num);
 
   size_t fea_num = 0;
-  uint64_total_num = 0;
+  total_num = 0;
+  SlotValues<T> unpacked;
   for (int i = 0; i < num; ++i) {
-    auto r = ins_vec[i];
-    auto& uint64_feasigns = r->slot_uint64_feasigns_;
-    fea_num = uint64_feasigns.slot_values.size();
+    auto& feasigns = (ins_vec[i]->*field).unpacked(&unpacked);
+    fea_num = feasigns.slot_values.size();
     if (fea_num > 0) {
-      memcpy(&buf_.h_uint64_keys[uint64_total_num],
-             uint64_feasigns.slot_values.data(),
-             fea_num * sizeof(uint64_t));
+      memcpy(&(*h_keys)[total_num],
+             feasigns.slot_values.data(),
+             fea_num * sizeof(T));
     }
-    uint64_total_num += fea_num;
-    // copy uint64 offset
-    memcpy(&buf_.h_uint64_offset[i * uint64_cols],
-           uint64_feasigns.slot_offsets.data(),
-           sizeof(int) * uint64_cols);
+    total_num += fea_num;
+    // copy offset
+    memcpy(&(*h_offset)[i * cols],
+           feasigns.slot_offsets.data(),
+           sizeof(int) * cols);
   }
-  CHECK(uint64_total_num == static_cast<int>(buf_.h_uint64_lens.back()))
-      << "uint64 value length error";
-}
-void MiniBatchGpuPack::pack_float_data(const SlotRecord* ins_vec, int num) {
-  int float_total_num = 0;
-
-  buf_.h_uint64_lens.clear();
-  buf_.h_uint64_offset.clear();
-  buf_.h_uint64_keys.clear();
-
-  buf_.h_float_lens.resize(num + 1);
-  buf_.h_float_lens[0] = 0;
-
-  for (int i = 0; i < num; ++i) {
-    auto r = ins_vec[i];
-    float_total_num += r->slot_float_feasigns_.slot_values.size();
-    buf_.h_float_lens[i + 1] = float_total_num;
-  }
-
-  int float_cols = (used_float_num_ + 1);
-  buf_.h_float_offset.resize(float_cols * num);
-  buf_.h_float_keys.resize(float_total_num);
+  CHECK(total_num == static_cast<int>(h_lens->back()))
+      << "slot value length error";
 
-  size_t fea_num = 0;
-  float_total_num = 0;
-  for (int i = 0; i < num; ++i) {
-    auto r = ins_vec[i];
-    auto& float_feasigns = r->slot_float_feasigns_;
-    fea_num = float_feasigns.slot_values.size();
-    memcpy(&buf_.h_float_keys[float_total_num],
-           float_feasigns.slot_values.data(),
-           fea_num * sizeof(float));
-    float_total_num += fea_num;
-
-    // copy float offset
-    memcpy(&buf_.h_float_offset[i * float_cols],
-           float_feasigns.slot_offsets.data(),
-           sizeof(int) * float_cols);
-  }
-  CHECK(float_total_num == static_cast<int>(buf_.h_float_lens.back()))
-      << "float value length error";
+  // the copies are asynchronous, so the next column can be packed on host
+  // while this one is being transferred
+  copy_host2device(d_lens, *h_lens);
+  copy_host2device(d_keys, *h_keys);
+  copy_host2device(d_offset, *h_offset);
 }
 
 void MiniBatchGpuPack::pack_instance(const SlotRecord* ins_vec, int num) {
   ins_num_ = num;
   batch_ins_ = ins_vec;
   CHECK(used_uint64_num_ > 0 || used_float_num_ > 0);
-  // uint64 and float
-  if (used_uint64_num_ > 0 && used_float_num_ > 0) {
-    pack_all_data(ins_vec, num);
-  } else if (used_uint64_num_ > 0) {  // uint64
-    pack_uint64_data(ins_vec, num);
-  } else {  // only float
-    pack_float_data(ins_vec, num);
-  }
-  // to gpu
-  transfer_to_gpu();
-}
-
-void MiniBatchGpuPack::transfer_to_gpu() {
-  copy_host2device(&value_.d_uint64_lens, buf_.h_uint64_lens);
-  copy_host2device(&value_.d_uint64_keys, buf_.h_uint64_keys);
-  copy_host2device(&value_.d_uint64_offset, buf_.h_uint64_offset);
-
-  copy_host2device(&value_.d_float_lens, buf_.h_float_lens);
-  copy_host2device(&value_.d_float_keys, buf_.h_float_keys);
-  copy_host2device(&value_.d_float_offset, buf_.h_float_offset);
+  if (used_uint64_num_ > 0) {
+    pack_slot_values(ins_vec,
+                     num,
+                     &SlotRecordObject::slot_uint64_feasigns_,
+                     used_uint64_num_,
+                     &buf_.h_uint64_lens,
+                     &buf_.h_uint64_keys,
+                     &buf_.h_uint64_offset,
+                     &value_.d_uint64_lens,
+                     &value_.d_uint64_keys,
+                     &value_.d_uint64_offset);
+  } else {
+    buf_.h_uint64_lens.clear();
+    buf_.h_uint64_offset.clear();
+    buf_.h_uint64_keys.clear();
+  }
+  if (used_float_num_ > 0) {
+    pack_slot_values(ins_vec,
+                     num,
+                     &SlotRecordObject::slot_float_feasigns_,
+                     used_float_num_,
+                     &buf_.h_float_lens,
+                     &buf_.h_float_keys,
+                     &buf_.h_float_offset,
+                     &value_.d_float_lens,
+                     &value_.d_float_keys,
+                     &value_.d_float_offset);
+  } else {
+    buf_.h_float_lens.clear();
+    buf_.h_float_keys.clear();
+    buf_.h_float_offset.clear();
+  }
+  // the pinned host buffers are reused by the next batch
   CUDA_CHECK(cudaStreamSynchronize(stream_));
 }
 #endif
@@ -1147,8 +1147,60 @@ int FillInsBuf(const std::shared_ptr<phi::Allocation> &d_walk,        // input
 }
 
 int GraphDataGenerator::GenerateBatch() {
-  int total_instance = conf_.batch_size;
   platform::CUDADeviceGuard guard(conf_.gpuid);
+  if (stage_events_[0] == nullptr) {
+    for (auto &event : stage_events_) {
+      CUDA_CHECK(cudaEventCreate(&event));
+    }
+  }
+  CUDA_CHECK(cudaEventRecord(stage_events_[0], train_stream_));
+  if (FillBatch() == 0) {
+    LogStageStats();
+    return 0;
+  }
+  // FillBatch synchronizes train_stream_, so the events are complete
+  float id_fill_ms = 0;
+  float feature_fill_ms = 0;
+  CUDA_CHECK(
+      cudaEventElapsedTime(&id_fill_ms, stage_events_[0], stage_events_[1]));
+  CUDA_CHECK(cudaEventElapsedTime(
+      &feature_fill_ms, stage_events_[1], stage_events_[2]));
+  id_fill_ms_ += id_fill_ms;
+  feature_fill_ms_ += feature_fill_ms;
+  ++stage_batch_num_;
+  return 1;
+}
+
+void GraphDataGenerator::LogStageStats() {
+  if (stage_events_[0] != nullptr) {
+    for (auto &event : stage_events_) {
+      CUDA_CHECK(cudaEventDestroy(event));
+      event = nullptr;
+    }
+  }
+  if (stage_batch_num_ > 0) {
+    auto per_sec = [](int64_t num, double sec) {
+      return sec > 0 ? num / sec : 0.;
+    };
+    VLOG(1) << "gpu_id: " << conf_.gpuid << ", batch_num: " << stage_batch_num_
+            << ", instance_num: " << stage_instance_num_
+            << ", walk: " << walk_sec_ << "s, sage: " << sage_sec_
+            << "s, id fill: " << id_fill_ms_ / 1000 << "s ("
+            << per_sec(stage_instance_num_, id_fill_ms_ / 1000)
+            << " ins/s), feature fill: " << feature_fill_ms_ / 1000 << "s ("
+            << per_sec(stage_instance_num_, feature_fill_ms_ / 1000)
+            << " ins/s)";
+  }
+  id_fill_ms_ = 0;
+  feature_fill_ms_ = 0;
+  stage_batch_num_ = 0;
+  stage_instance_num_ = 0;
+  walk_sec_ = 0;
+  sage_sec_ = 0;
+}
+
+int GraphDataGenerator::FillBatch() {
+  int total_instance = conf_.batch_size;
   int res = 0;
   if (!conf_.gpu_graph_training) {
     // infer
@@ -1259,6 +1311,7 @@ int GraphDataGenerator::GenerateBatch() {
     }
   }
 
+  CUDA_CHECK(cudaEventRecord(stage_events_[1], train_stream_));
   if (conf_.slot_num > 0) {
     if (!conf_.sage_mode) {
       FillGraphSlotFeature(total_instance, conf_.gpu_graph_training);
@@ -1285,6 +1338,7 @@ int GraphDataGenerator::GenerateBatch() {
     sage_batch_count_ += 1;
   }
   LoD lod{offset_};
+  stage_instance_num_ += offset_.back();
 
   if (conf_.accumulate_num >= 2) {
     offset_.clear();
@@ -1329,6 +1383,7 @@ int GraphDataGenerator::GenerateBatch() {
     }
   }
 
+  CUDA_CHECK(cudaEventRecord(stage_events_[2], train_stream_));
   cudaStreamSynchronize(train_stream_);
   if (!conf_.gpu_graph_training) return 1;
   if (!conf_.sage_mode) {
@@ -3835,8 +3890,13 @@ void GraphDataGenerator::DoWalkandSage() {
   debug_gpu_memory_info(device_id, "DoWalkandSage start");
   platform::CUDADeviceGuard guard(conf_.gpuid);
   sage_batch_num_ = 0;
+  platform::Timer walk_timer;
+  platform::Timer sage_timer;
   if (conf_.gpu_graph_training) {
+    walk_timer.Start();
     int local_train_flag = DoWalkForTrain();
+    walk_timer.Pause();
+    sage_timer.Start();
     if (!conf_.is_multi_node) {
       if (local_train_flag && conf_.sage_mode) {
         DoSageForTrain();
@@ -3855,12 +3915,19 @@ void GraphDataGenerator::DoWalkandSage() {
         }
       }
     }
+    sage_timer.Pause();
   } else {
+    walk_timer.Start();
     bool infer_flag = DoWalkForInfer();
+    walk_timer.Pause();
+    sage_timer.Start();
     if (infer_flag && conf_.sage_mode) {
       DoSageForInfer();
     }
+    sage_timer.Pause();
   }
+  walk_sec_ += walk_timer.ElapsedSec();
+  sage_sec_ += sage_timer.ElapsedSec();
 
   if (conf_.gpu_graph_training || conf_.sage_mode) {
     CopyUniqueNodes(conf_.gpuid,
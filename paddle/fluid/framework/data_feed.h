@@ -38,6 +38,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/data_feed.pb.h"
 #include "paddle/fluid/framework/fleet/fleet_wrapper.h"
 #include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
 #include "paddle/fluid/framework/reader.h"
 #include "paddle/fluid/framework/variable.h"
 #include "paddle/fluid/platform/timer.h"
@@ -52,8 +53,11 @@ limitations under the License. */
 
 COMMON_DECLARE_int32(record_pool_max_size);
 COMMON_DECLARE_int32(slotpool_thread_num);
+COMMON_DECLARE_bool(slotpool_numa_local);
 COMMON_DECLARE_bool(enable_slotpool_wait_release);
 COMMON_DECLARE_bool(enable_slotrecord_reset_shrink);
+COMMON_DECLARE_bool(enable_slotrecord_compress);
+COMMON_DECLARE_bool(enable_slotrecord_float_fp16);
 
 namespace paddle {
 namespace framework {
@@ -95,6 +99,28 @@ template <typename T>
 struct SlotValues {
   std::vector<T> slot_values;
   std::vector<uint32_t> slot_offsets;
+  // the values and offsets coded by compress, which empties them
+  std::vector<uint8_t> packed;
+  uint32_t packed_num = 0;
+
+  bool is_packed() const { return !packed.empty(); }
+  size_t value_num() const {
+    return is_packed() ? packed_num : slot_values.size();
+  }
+  // Code the values and offsets into packed, the slot lengths as varints,
+  // the uint64 values as zigzag varints of their deltas if it is smaller,
+  // and the float values as fp16 if half.
+  void compress(bool half);
+  // Decode packed into the values and offsets of out.
+  void decompress(SlotValues<T>* out) const;
+  // The values, decoded into scratch if they are packed.
+  const SlotValues<T>& unpacked(SlotValues<T>* scratch) const {
+    if (!is_packed()) {
+      return *this;
+    }
+    decompress(scratch);
+    return *scratch;
+  }
 
   void add_values(const T* values, uint32_t num) {
     if (slot_offsets.empty()) {
@@ -110,6 +136,11 @@ struct SlotValues {
     (*size) = slot_offsets[idx + 1] - offset;
     return &slot_values[offset];
   }
+  const T* get_values(int idx, size_t* size) const {
+    const uint32_t& offset = slot_offsets[idx];
+    (*size) = slot_offsets[idx + 1] - offset;
+    return slot_values.data() + offset;
+  }
   void add_slot_feasigns(const std::vector<std::vector<T>>& slot_feasigns,
                          uint32_t fea_num) {
     slot_values.reserve(fea_num);
@@ -128,12 +159,23 @@ struct SlotValues {
   void clear(bool shrink) {
     slot_offsets.clear();
     slot_values.clear();
+    packed.clear();
+    packed_num = 0;
     if (shrink) {
       slot_values.shrink_to_fit();
       slot_offsets.shrink_to_fit();
+      packed.shrink_to_fit();
     }
   }
 };
+template <>
+void SlotValues<uint64_t>::compress(bool half);
+template <>
+void SlotValues<uint64_t>::decompress(SlotValues<uint64_t>* out) const;
+template <>
+void SlotValues<float>::compress(bool half);
+template <>
+void SlotValues<float>::decompress(SlotValues<float>* out) const;
 union FeatureFeasign {
   uint64_t uint64_feasign_;
   float float_feasign_;
@@ -185,6 +227,8 @@ struct SlotRecordObject {
   std::string ins_id_;
   SlotValues<uint64_t> slot_uint64_feasigns_;
   SlotValues<float> slot_float_feasigns_;
+  // the arena of SlotObjPool the record returns to
+  int numa_node = 0;
 
   ~SlotRecordObject() { clear(true); }
   void reset(void) { clear(FLAGS_enable_slotrecord_reset_shrink); }
@@ -265,10 +309,22 @@ class SlotObjAllocator {
   std::function<void(T*)> deleter_ = nullptr;
 };
 static const int OBJPOOL_BLOCK_SIZE = 10000;
+// With FLAGS_slotpool_numa_local, the pool keeps a free list per NUMA node,
+// hands a thread the records of the node it runs on, and creates the new
+// records on it, so the records, first touched there, stay node local when
+// they are recycled.
 class SlotObjPool {
  public:
-  SlotObjPool()
-      : max_capacity_(FLAGS_record_pool_max_size), alloc_(free_slotrecord) {
+  SlotObjPool() : max_capacity_(FLAGS_record_pool_max_size) {
+    size_t arena_num = 1;
+    if (FLAGS_slotpool_numa_local) {
+      arena_num = std::max(GetNumaNodeCpus().size(), static_cast<size_t>(1));
+    }
+    for (size_t i = 0; i < arena_num; ++i) {
+      allocs_.emplace_back(
+          std::make_unique<SlotObjAllocator<SlotRecordObject>>(
+              free_slotrecord));
+    }
     ins_chan_ = MakeChannel<SlotRecord>();
     ins_chan_->SetBlockSize(OBJPOOL_BLOCK_SIZE);
     for (int i = 0; i < FLAGS_slotpool_thread_num; ++i) {
@@ -291,12 +347,14 @@ class SlotObjPool {
   }
   void get(SlotRecord* output, int n) {
     int size = 0;
+    const int node = allocs_.size() > 1 ? CurrentArena() : 0;
+    auto& alloc = *allocs_[node];
     mutex_.lock();
-    int left = static_cast<int>(alloc_.capacity());
+    int left = static_cast<int>(alloc.capacity());
     if (left > 0) {
       size = (left >= n) ? n : left;
       for (int i = 0; i < size; ++i) {
-        output[i] = alloc_.acquire();
+        output[i] = alloc.acquire();
       }
     }
     mutex_.unlock();
@@ -306,6 +364,7 @@ class SlotObjPool {
     }
     for (int i = size; i < n; ++i) {
       output[i] = make_slotrecord();
+      output[i]->numa_node = node;
     }
   }
   void put(std::vector<SlotRecord>* input) {
@@ -341,7 +400,7 @@ class SlotObjPool {
         }
         mutex_.lock();
         for (auto& t : input) {
-          alloc_.release(t);
+          allocs_[ArenaOf(t)]->release(t);
         }
         mutex_.unlock();
       }
@@ -352,7 +411,9 @@ class SlotObjPool {
     platform::Timer timeline;
     timeline.Start();
     mutex_.lock();
-    alloc_.clear();
+    for (auto& alloc : allocs_) {
+      alloc->clear();
+    }
     mutex_.unlock();
     // wait release channel data
     if (FLAGS_enable_slotpool_wait_release) {
@@ -366,17 +427,31 @@ class SlotObjPool {
   }
   size_t capacity(void) {
     mutex_.lock();
-    size_t total = alloc_.capacity();
+    size_t total = 0;
+    for (auto& alloc : allocs_) {
+      total += alloc->capacity();
+    }
     mutex_.unlock();
     return total;
   }
 
  private:
+  int CurrentArena() const {
+    int node = GetCurrentNumaNode();
+    return node < static_cast<int>(allocs_.size()) ? node : 0;
+  }
+  size_t ArenaOf(const SlotRecordObject* record) const {
+    return record->numa_node >= 0 &&
+                   record->numa_node < static_cast<int>(allocs_.size())
+               ? record->numa_node
+               : 0;
+  }
+
   size_t max_capacity_;
   Channel<SlotRecord> ins_chan_;
   std::vector<std::thread> threads_;
   std::mutex mutex_;
-  SlotObjAllocator<SlotRecordObject> alloc_;
+  std::vector<std::unique_ptr<SlotObjAllocator<SlotRecordObject>>> allocs_;
   bool disable_pool_;
   std::atomic<long> count_;  // NOLINT
 };
@@ -614,10 +689,20 @@ class MiniBatchGpuPack {
   cudaStream_t get_stream() { return stream_; }
 
  private:
-  void transfer_to_gpu(void);
-  void pack_all_data(const SlotRecord* ins_vec, int num);
-  void pack_uint64_data(const SlotRecord* ins_vec, int num);
-  void pack_float_data(const SlotRecord* ins_vec, int num);
+  // Pack one kind of slot values (uint64 or float) of the batch into pinned
+  // host buffers and start the H2D copies right away, so that packing the
+  // next kind overlaps with the transfer.
+  template <typename T>
+  void pack_slot_values(const SlotRecord* ins_vec,
+                        int num,
+                        SlotValues<T> SlotRecordObject::*field,
+                        int used_slot_num,
+                        HostBuffer<int>* h_lens,
+                        HostBuffer<T>* h_keys,
+                        HostBuffer<int>* h_offset,
+                        CudaBuffer<int>* d_lens,
+                        CudaBuffer<T>* d_keys,
+                        CudaBuffer<int>* d_offset);
 
  public:
   template <typename T>
@@ -1059,6 +1144,9 @@ class GraphDataGenerator {
   void DoSageForInfer();
   bool DoWalkForTrain();
   void DoSageForTrain();
+  // Fill the ids and the slot features of a batch, return 0 at the pass end.
+  int FillBatch();
+  void LogStageStats();
 
   // key: key id,
   // value: dest machine rank id
@@ -1139,6 +1227,17 @@ class GraphDataGenerator {
   std::vector<size_t> infer_node_end_;
   std::string infer_node_type_;
   phi::DenseTensor multi_node_sync_stat_;
+
+  // The stage counters of a pass, logged and reset at its end. The events
+  // mark the start, the id fill and the feature fill of a batch on
+  // train_stream_.
+  cudaEvent_t stage_events_[3] = {nullptr, nullptr, nullptr};
+  float id_fill_ms_ = 0;
+  float feature_fill_ms_ = 0;
+  int64_t stage_batch_num_ = 0;
+  int64_t stage_instance_num_ = 0;
+  double walk_sec_ = 0;
+  double sage_sec_ = 0;
 };
 
 class DataFeed {
@@ -1513,6 +1612,12 @@ class PrivateQueueDataFeed : public DataFeed {
                                    int index) = 0;
   // This function is used to put ins_vec to feed_vec
   virtual void PutToFeedVec(const T& ins_vec) = 0;
+  // Get the next instance from the queue, drawn at random from a window of
+  // FLAGS_queue_dataset_shuffle_window instances if it is set.
+  bool GetInstance(T* instance);
+  // Pick and open the next file as fp_, and the one after it too with
+  // FLAGS_queue_dataset_prefetch_file.
+  bool OpenNextFile(std::string* filename);
 
   // The thread for read files
   std::thread read_thread_;
@@ -1527,6 +1632,12 @@ class PrivateQueueDataFeed : public DataFeed {
   string::LineFileReader reader_;
   // The queue for store parsed data
   std::shared_ptr<paddle::framework::ChannelObject<T>> queue_;
+  // The window of the instances to shuffle
+  std::vector<T> shuffle_window_;
+  std::default_random_engine shuffle_engine_{std::random_device()()};
+  // The next file opened ahead
+  std::shared_ptr<FILE> prefetched_fp_;
+  std::string prefetched_file_;
 };
 
 template <typename T>
@@ -1974,6 +2085,9 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   void ExpandSlotRecord(SlotRecord* ins);
 
  protected:
+  // Compress the feasigns of the records loaded, by
+  // FLAGS_enable_slotrecord_compress.
+  void CompressRecords(SlotRecord* records, int num);
   bool Start() override;
   int Next() override;
   bool ParseOneInstance(SlotRecord* instance UNUSED) override { return false; }
@@ -2060,6 +2174,9 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   std::vector<UsedSlotInfo> used_slots_info_;
   size_t float_total_dims_size_ = 0;
   std::vector<int> float_total_dims_without_inductives_;
+  // the feasigns of the compressed records of a batch, decoded
+  std::vector<SlotValues<uint64_t>> unpacked_uint64_feasigns_;
+  std::vector<SlotValues<float>> unpacked_float_feasigns_;
 
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
   int pack_thread_num_{5};
@@ -14,6 +14,9 @@
 
 #include "paddle/fluid/framework/data_set.h"
 
+#include <deque>
+#include <future>
+
 #include "google/protobuf/text_format.h"
 #if (defined PADDLE_WITH_DISTRIBUTE) && (defined PADDLE_WITH_PSCORE)
 #include "paddle/fluid/distributed/index_dataset/index_sampler.h"
@@ -22,6 +25,7 @@
 #include "paddle/fluid/framework/data_feed_factory.h"
 #include "paddle/fluid/framework/fleet/fleet_wrapper.h"
 #include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
 #include "paddle/fluid/framework/threadpool.h"
 #include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/timer.h"
@@ -42,6 +46,8 @@ COMMON_DECLARE_bool(graph_get_neighbor_id);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_string(graph_edges_split_mode);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
+COMMON_DECLARE_int32(global_shuffle_chunk_mb);
+COMMON_DECLARE_int32(global_shuffle_max_inflight_mb);
 
 namespace paddle {
 namespace framework {
@@ -581,9 +587,17 @@ void DatasetImpl<T>::LoadIntoMemory() {
 #endif
   } else {
     std::vector<std::thread> load_threads;
+    // the records a thread loads are allocated on the node it runs on
+    const auto numa_nodes = FLAGS_slotpool_numa_local
+                                ? GetNumaNodeCpus()
+                                : std::vector<std::vector<int>>();
     for (int64_t i = 0; i < thread_num_; ++i) {
-      load_threads.emplace_back(&paddle::framework::DataFeed::LoadIntoMemory,
-                                readers_[i].get());
+      load_threads.emplace_back([this, i, &numa_nodes]() {
+        if (!numa_nodes.empty()) {
+          SetCurrentThreadAffinity(numa_nodes[i % numa_nodes.size()]);
+        }
+        readers_[i]->LoadIntoMemory();
+      });
     }
     for (std::thread& t : load_threads) {
       t.join();
@@ -900,41 +914,63 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
     }
   };
 
-  auto global_shuffle_func = [this, get_client_id]() {
+  if (thread_num == -1) {
+    thread_num = thread_num_;
+  }
+  // records bound for one trainer are sent in chunks of about chunk_bytes,
+  // each thread keeps at most inflight_bytes of requests on the wire
+  const size_t chunk_bytes =
+      static_cast<size_t>(std::max(FLAGS_global_shuffle_chunk_mb, 1)) << 20;
+  const size_t inflight_bytes =
+      (static_cast<size_t>(std::max(FLAGS_global_shuffle_max_inflight_mb, 1))
+       << 20) /
+      std::max(thread_num, 1);
+  std::atomic<int64_t> sent_ins_num(0);
+  std::atomic<int64_t> sent_bytes(0);
+  std::atomic<int64_t> sent_msg_num(0);
+
+  auto global_shuffle_func = [this,
+                              get_client_id,
+                              chunk_bytes,
+                              inflight_bytes,
+                              &sent_ins_num,
+                              &sent_bytes,
+                              &sent_msg_num]() {
 #ifdef PADDLE_WITH_PSCORE
     auto fleet_ptr = distributed::FleetWrapper::GetInstance();
 #else
     auto fleet_ptr = framework::FleetWrapper::GetInstance();
 #endif
     // auto fleet_ptr = framework::FleetWrapper::GetInstance();
+    std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
+    std::deque<std::pair<std::future<int32_t>, size_t>> pending;
+    size_t pending_bytes = 0;
+    auto send = [&](int i) {
+      size_t length = ars[i].Length();
+      // wait for the oldest requests until this one fits the ceiling
+      while (!pending.empty() && pending_bytes + length > inflight_bytes) {
+        pending.front().first.wait();
+        pending_bytes -= pending.front().second;
+        pending.pop_front();
+      }
+      std::string msg(ars[i].Buffer(), length);
+      ars[i].Clear();
+      pending.emplace_back(fleet_ptr->SendClientToClientMsg(0, i, msg),
+                           length);
+      pending_bytes += length;
+      sent_bytes += length;
+      ++sent_msg_num;
+    };
     std::vector<Record> data;
     while (this->input_channel_->Read(data)) {
-      std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
       for (auto& t : data) {
         auto client_id = get_client_id(t);
         ars[client_id] << t;
-      }
-      std::vector<std::future<int32_t>> total_status;
-      std::vector<int> send_index(this->trainer_num_);
-      for (int i = 0; i < this->trainer_num_; ++i) {
-        send_index[i] = i;
-      }
-      std::shuffle(
-          send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
-      for (int index = 0; index < this->trainer_num_; ++index) {
-        int i = send_index[index];
-        if (ars[i].Length() == 0) {
-          continue;
+        if (static_cast<size_t>(ars[client_id].Length()) >= chunk_bytes) {
+          send(client_id);
         }
-        std::string msg(ars[i].Buffer(), ars[i].Length());
-        auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
-        total_status.push_back(std::move(ret));
       }
-      for (auto& t : total_status) {
-        t.wait();
-      }
-      ars.clear();
-      ars.shrink_to_fit();
+      sent_ins_num += data.size();
       data.clear();
       data.shrink_to_fit();
       // currently we find bottleneck is server not able to handle large data
@@ -944,12 +980,24 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
         sleep(this->fleet_send_sleep_seconds_);
       }
     }
+    std::vector<int> send_index(this->trainer_num_);
+    for (int i = 0; i < this->trainer_num_; ++i) {
+      send_index[i] = i;
+    }
+    std::shuffle(
+        send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
+    for (int index = 0; index < this->trainer_num_; ++index) {
+      int i = send_index[index];
+      if (ars[i].Length() != 0) {
+        send(i);
+      }
+    }
+    for (auto& t : pending) {
+      t.first.wait();
+    }
   };
 
   std::vector<std::thread> global_shuffle_threads;
-  if (thread_num == -1) {
-    thread_num = thread_num_;
-  }
   VLOG(3) << "start global shuffle threads, num = " << thread_num;
   for (int i = 0; i < thread_num; ++i) {
     global_shuffle_threads.emplace_back(global_shuffle_func);
@@ -963,6 +1011,11 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
   timeline.Pause();
   VLOG(3) << "DatasetImpl<T>::GlobalShuffle() end, cost time="
           << timeline.ElapsedSec() << " seconds";
+  VLOG(1) << "MultiSlotDataset::GlobalShuffle() sent " << sent_ins_num
+          << " ins, " << sent_bytes / 1048576.0 << " MB in " << sent_msg_num
+          << " msgs, "
+          << sent_bytes / 1048576.0 / std::max(timeline.ElapsedSec(), 1e-6)
+          << " MB/s";
 }
 
 template <typename T>
@@ -18,6 +18,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/data_layout_transform.h"
 #include "paddle/fluid/framework/data_type_transform.h"
 #include "paddle/phi/api/lib/data_transform.h"
+#include "paddle/phi/kernels/funcs/data_layout_transform.h"
 
 namespace paddle {
 namespace framework {
@@ -55,8 +56,19 @@ void TransformData(const phi::KernelKey &expected_kernel_type,
     PassTensorData(&out, &in);
   }
 
+  // do layout and data type transform in one pass when both are needed
+  bool fused = false;
+  if (NeedTransformLayout(lout, lin) &&
+      NeedTransformDataType(expected_kernel_type, kernel_type_for_var) &&
+      phi::funcs::TransDataLayoutAndType(
+          in, lout, expected_kernel_type.dtype(), &out)) {
+    fused = true;
+    transformed = true;
+    PassTensorData(&out, &in);
+  }
+
   // do layout transform
-  if (NeedTransformLayout(lout, lin)) {
+  if (!fused && NeedTransformLayout(lout, lin)) {
 #ifdef PADDLE_WITH_DNNL
     if (lin == DataLayout::ONEDNN || lout == DataLayout::ONEDNN) {
       PADDLE_ENFORCE_EQ(
@@ -110,7 +122,8 @@ void TransformData(const phi::KernelKey &expected_kernel_type,
   }
 
   // do data type transform
-  if (NeedTransformDataType(expected_kernel_type, kernel_type_for_var)) {
+  if (!fused &&
+      NeedTransformDataType(expected_kernel_type, kernel_type_for_var)) {
     TransDataType(kernel_type_for_var, expected_kernel_type, in, &out);
     transformed = true;
     PassTensorData(&out, &in);
@@ -16,7 +16,12 @@ limitations under the License. */
 
 #include <array>
 #include <chrono>
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/framework/operator.h"
+
+COMMON_DECLARE_bool(device_worker_cache_runtime_context);
+
 namespace phi {
 class DenseTensor;
 }  // namespace phi
@@ -32,6 +37,28 @@ void DeviceWorker::SetDataFeed(DataFeed* data_feed) {
   device_reader_ = data_feed;
 }
 
+void DeviceWorker::EnableRuntimeContextCache(
+    const std::vector<std::unique_ptr<OperatorBase>>& ops) {
+  if (!FLAGS_device_worker_cache_runtime_context) {
+    return;
+  }
+  size_t cached_num = 0;
+  for (auto& op : ops) {
+    // the other ops, e.g. the control flow ones, look up their variables by
+    // themselves
+    if (dynamic_cast<OperatorWithKernel*>(op.get()) != nullptr) {
+      // SetAttr only replaces the attributes of the op proto, the mark is
+      // set by the framework like those of the passes
+      auto runtime_attrs = op->RuntimeAttrs();
+      runtime_attrs[kEnableCacheRuntimeContext] = true;
+      op->SetRuntimeAttributeMap(runtime_attrs);
+      ++cached_num;
+    }
+  }
+  VLOG(3) << "Cache the RuntimeContext of " << cached_num << " of "
+          << ops.size() << " ops.";
+}
+
 template <typename T>
 std::string PrintLodTensorType(phi::DenseTensor* tensor,
                                int64_t start,
@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -120,6 +121,14 @@ class PullDenseWorker {
   PullDenseWorker() : root_scope_(NULL) {}
   void Run();
   bool CheckUpdateParam(uint64_t table_id);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
+    defined(PADDLE_WITH_XPU)
+  // The [begin, end) ranges of the pulled values of a dense var to copy to
+  // the thread scopes, i.e. the blocks changed since the last copy with
+  // FLAGS_pull_dense_delta_copy, or all of them.
+  std::vector<std::pair<int64_t, int64_t>> ChangedRanges(
+      const std::string& name, const float* values, int64_t numel);
+#endif
 
  private:
 #if defined(PADDLE_WITH_PSCORE)
@@ -159,6 +168,9 @@ class PullDenseWorker {
 #endif
   std::vector<phi::Place> places_;
   std::vector<Scope*> thread_scopes_;
+  // the values of the dense vars last copied to the thread scopes
+  std::unordered_map<std::string, std::vector<float>> synced_values_;
+  static constexpr int64_t kDenseSyncBlockSize = 16384;
 };
 
 // should incorporate different type of device
@@ -225,6 +237,12 @@ class DeviceWorker {
   virtual void DumpField(const Scope& scope,
                          int dump_mode,
                          int dump_interval = 10000);
+  // Let the kernel ops resolve their input and output variables by name once
+  // per scope and hold them in a cached RuntimeContext, instead of looking
+  // them up in the scopes in every batch, see
+  // FLAGS_device_worker_cache_runtime_context.
+  void EnableRuntimeContextCache(
+      const std::vector<std::unique_ptr<OperatorBase>>& ops);
   Scope* root_scope_ = nullptr;
   Scope* thread_scope_;
   phi::Place place_;
@@ -362,6 +380,11 @@ class DownpourWorker : public HogwildWorker {
   void CopySparseTable();
   void CopyDenseTable();
   void CopyDenseVars();
+  void ResetStageTimers();
+  // Keep the pushes of the batch in flight, and wait for the ones issued
+  // more than max_staleness batches ago. A negative max_staleness keeps
+  // none of them, leaving the pushes unbounded.
+  void BoundPushStaleness(int max_staleness);
 
   DownpourWorkerParameter param_;
   // copy table
@@ -392,6 +415,14 @@ class DownpourWorker : public HogwildWorker {
   std::map<uint64_t, std::vector<std::string>> dense_grad_names_;
   float scale_datanorm_;
   std::vector<::std::future<int32_t>> push_dense_status_;
+  // the pushes of the last batches, one entry per batch
+  std::deque<std::vector<::std::future<int32_t>>> inflight_push_status_;
+  // the time of the stages of TrainFiles
+  platform::Timer read_timer_;
+  platform::Timer pull_sparse_timer_;
+  platform::Timer compute_timer_;
+  platform::Timer push_timer_;
+  platform::Timer push_wait_timer_;
   // skipped ops
   std::vector<std::string> skip_ops_;
   // just save the value in param_ for easy access
@@ -722,9 +753,26 @@ class PSGPUWorker : public HogwildWorker {
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 class SectionWorker : public DeviceWorker {
  public:
+  enum Phase { kForward, kBackward, kWeightGrad, kUpdate, kWait, kPhaseNum };
+
+  // A step of a schedule, which runs `phase` for micro-batch `micro_id`.
+  struct ScheduleStep {
+    Phase phase;
+    int micro_id;
+  };
+
   SectionWorker() {}
   ~SectionWorker() override {}
 
+  // The forward, backward and weight gradient steps ZB-H1 runs on `stage`.
+  static std::vector<ScheduleStep> ZeroBubbleSchedule(int num_microbatches,
+                                                      int num_stages,
+                                                      int stage);
+  // The ops of `backward_ops` the backward send and recv ops don't depend
+  // on, which compute only the gradients of the parameters.
+  static std::unordered_set<const OperatorBase*> FindWeightGradOps(
+      const std::vector<OperatorBase*>& backward_ops);
+
   void Initialize(const TrainerDesc& desc) override;
   void PrepareUnusedVar();
 
@@ -759,23 +807,34 @@ class SectionWorker : public DeviceWorker {
       int micro_id,
       std::unique_ptr<GarbageCollector>&,
       std::unordered_map<const OperatorBase*, std::vector<std::string>>&);
+  void RunWeightGrad(
+      int micro_id,
+      std::unique_ptr<GarbageCollector>&,
+      std::unordered_map<const OperatorBase*, std::vector<std::string>>&);
   void RunUpdate(
       std::unique_ptr<GarbageCollector>&,
       std::unordered_map<const OperatorBase*, std::vector<std::string>>&);
   void RunFThenB(std::unique_ptr<GarbageCollector>&);
   void Run1F1B(std::unique_ptr<GarbageCollector>&);
+  void RunZeroBubble(std::unique_ptr<GarbageCollector>&);
 
  protected:
+  // Moves the backward ops the backward send and recv ops don't depend on
+  // from backward_ops_ to weight_grad_ops_, and after the others in ops_.
+  void SplitBackwardOps();
+  void RunOp(OperatorBase* op, const Scope& scope, Phase phase);
+  void ReportUtilization();
+
   int section_id_;
   int thread_id_;
   int num_microbatches_;
   int num_pipeline_stages_;
   int pipeline_stage_;
-  int schedule_mode_;  // 0 for F-then-B and 1 for 1F1B
+  int schedule_mode_;  // 0 for F-then-B, 1 for 1F1B and 2 for ZB-H1
   std::vector<Scope*> microbatch_scopes_;
   const Scope* minibatch_scope_;
 
-  // skip&backward vars are only used in 1F1B
+  // skip&backward vars are only used in 1F1B and ZB-H1
   std::vector<std::string> skip_vars_;
   std::vector<std::string> backward_send_vars_;
 
@@ -783,12 +842,19 @@ class SectionWorker : public DeviceWorker {
   std::vector<OperatorBase*> forward_and_lr_ops_;
   std::vector<OperatorBase*> forward_ops_;
   std::vector<OperatorBase*> backward_ops_;
+  // only used in ZB-H1, the backward ops computing the parameter gradients
+  // alone
+  std::vector<OperatorBase*> weight_grad_ops_;
   std::vector<OperatorBase*> optimizer_ops_;
   std::shared_ptr<framework::ProgramDesc> program_;
   std::unordered_map<const OperatorBase*, std::vector<std::string>>
       unused_vars_;
   static uint64_t batch_id_;
 
+  // the time in milliseconds spent in each phase since the last report
+  double phase_time_[kPhaseNum] = {0};
+  int reported_batches_ = 0;
+
   phi::DeviceContext* dev_ctx_ = nullptr;
 };
 #endif
@@ -34,6 +34,7 @@ void DistMultiTrainer::Initialize(const TrainerDesc &trainer_desc,
   mpi_rank_ = trainer_desc.mpi_rank();
   mpi_size_ = trainer_desc.mpi_size();
   dump_file_num_ = trainer_desc.dump_file_num();
+  numa_binding_ = trainer_desc.numa_binding();
   user_define_dump_filename_ = trainer_desc.user_define_dump_filename();
   const std::vector<paddle::framework::DataFeed *> readers =
       dataset->GetReaders();
@@ -170,11 +171,15 @@ void DistMultiTrainer::Run() {
                         static_cast<int>(pool.size())));
   for (int i = 0; i < thread_num_; ++i) {
     if (!debug_) {  // NOLINT
-      wait_futures.emplace_back(
-          pool[i]->Run([this, i]() { workers_[i]->TrainFiles(); }));
+      wait_futures.emplace_back(pool[i]->Run([this, i]() {
+        BindWorkerToNumaNode(i);
+        workers_[i]->TrainFiles();
+      }));
     } else {
-      wait_futures.emplace_back(
-          pool[i]->Run([this, i]() { workers_[i]->TrainFilesWithProfiler(); }));
+      wait_futures.emplace_back(pool[i]->Run([this, i]() {
+        BindWorkerToNumaNode(i);
+        workers_[i]->TrainFilesWithProfiler();
+      }));
     }
   }
   for (auto &th : wait_futures) {
@@ -153,13 +153,20 @@ DLManagedTensor *toDLPack(const phi::DenseTensor &src) {
   }
   pdDLMTensor->tensor.dl_tensor.shape = shape;
 
-  // init stride
+  // init stride, the strided tensors are shared with their own strides
+  // instead of being made contiguous
   auto strides = new int64_t[ndim];
-  for (DimType i = 0; i < ndim; ++i) {
-    strides[i] = 1;
-  }
-  for (DimType i = ndim - 2; i >= 0; --i) {
-    strides[i] = shape[i + 1] * strides[i + 1];
+  if (src.meta().is_contiguous()) {
+    for (DimType i = 0; i < ndim; ++i) {
+      strides[i] = 1;
+    }
+    for (DimType i = ndim - 2; i >= 0; --i) {
+      strides[i] = shape[i + 1] * strides[i + 1];
+    }
+  } else {
+    for (DimType i = 0; i < ndim; ++i) {
+      strides[i] = src.strides()[i];
+    }
   }
   pdDLMTensor->tensor.dl_tensor.strides = strides;
 
@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/framework/fleet/metrics.h"
 #include "paddle/fluid/operators/isfinite_op.h"
@@ -32,6 +33,8 @@ class Variable;
 #define _LINUX
 #endif
 
+COMMON_DECLARE_int32(downpour_max_push_staleness);
+
 namespace paddle {
 namespace framework {
 void DownpourWorker::Initialize(const TrainerDesc& desc) {
@@ -806,7 +809,10 @@ void DownpourWorker::TrainFiles() {
   device_reader_->Start();
   int batch_cnt = 0;
   int cur_batch = 0;
+  ResetStageTimers();
+  read_timer_.Resume();
   while ((cur_batch = device_reader_->Next()) > 0) {
+    read_timer_.Pause();
     if (copy_table_config_.need_copy()) {
       if (batch_cnt % copy_table_config_.batch_num() == 0) {
         CopySparseTable();
@@ -815,6 +821,7 @@ void DownpourWorker::TrainFiles() {
       }
     }
     // pull sparse here
+    pull_sparse_timer_.Resume();
     for (int i = 0; i < param_.program_config(0).pull_sparse_table_id_size();
          ++i) {
       uint64_t tid = static_cast<uint64_t>(
@@ -842,9 +849,11 @@ void DownpourWorker::TrainFiles() {
         AdjustInsWeight();
       }
     }
+    pull_sparse_timer_.Pause();
     VLOG(3) << "fill sparse value for all sparse table done.";
 
     // do computation here
+    compute_timer_.Resume();
     for (auto& op : ops_) {
       bool need_skip = false;
       for (auto& skip_op : skip_ops_) {
@@ -902,6 +911,7 @@ void DownpourWorker::TrainFiles() {
 #endif
       }
     }
+    compute_timer_.Pause();
 
 #ifdef PADDLE_WITH_PSLIB
     // add data for MetricMsg
@@ -930,6 +940,7 @@ void DownpourWorker::TrainFiles() {
                             "phi::DenseTensor %s contains NAN.", var_name));
     }
 
+    push_timer_.Resume();
     if (need_to_push_sparse_) {
       // push gradients here
       for (int i = 0; i < param_.program_config(0).push_sparse_table_id_size();
@@ -1018,7 +1029,11 @@ void DownpourWorker::TrainFiles() {
       }
 
       VLOG(3) << "push dense gradient done.";
+    }
+    push_timer_.Pause();
+    BoundPushStaleness(FLAGS_downpour_max_push_staleness);
 
+    if (need_to_push_dense_) {
       // the following code should be more precise and clean
       // TODO(guru4elephant)
       int32_t tmp_push_dense_wait_times = -1;
@@ -1072,6 +1087,11 @@ void DownpourWorker::TrainFiles() {
     PrintFetchVars();
     thread_scope_->DropKids();
     ++batch_cnt;
+    read_timer_.Resume();
+  }
+  read_timer_.Pause();
+  if (FLAGS_downpour_max_push_staleness >= 0) {
+    BoundPushStaleness(0);
   }
   if (need_dump_field_ || need_dump_param_) {
     writer_.Flush();
@@ -1081,6 +1101,48 @@ void DownpourWorker::TrainFiles() {
     CopyDenseTable();
     CopyDenseVars();
   }
+  VLOG(1) << "DownpourWorker " << thread_id_ << " trained " << batch_cnt
+          << " batches, read: " << read_timer_.ElapsedSec()
+          << "s, pull sparse: " << pull_sparse_timer_.ElapsedSec()
+          << "s, compute: " << compute_timer_.ElapsedSec()
+          << "s, push: " << push_timer_.ElapsedSec()
+          << "s, wait for stale push: " << push_wait_timer_.ElapsedSec()
+          << "s";
+}
+
+void DownpourWorker::ResetStageTimers() {
+  read_timer_.Reset();
+  pull_sparse_timer_.Reset();
+  compute_timer_.Reset();
+  push_timer_.Reset();
+  push_wait_timer_.Reset();
+}
+
+void DownpourWorker::BoundPushStaleness(int max_staleness) {
+  if (max_staleness < 0) {
+    return;
+  }
+  // the dense pushes are also tracked in push_sparse_status_
+  std::vector<::std::future<int32_t>> batch_status;
+  for (auto* status : {&push_sparse_status_, &push_dense_status_}) {
+    for (auto& t : *status) {
+      if (t.valid()) {
+        batch_status.push_back(std::move(t));
+      }
+    }
+    status->clear();
+  }
+  if (!batch_status.empty()) {
+    inflight_push_status_.push_back(std::move(batch_status));
+  }
+  push_wait_timer_.Resume();
+  while (inflight_push_status_.size() > static_cast<size_t>(max_staleness)) {
+    for (auto& t : inflight_push_status_.front()) {
+      t.wait();
+    }
+    inflight_push_status_.pop_front();
+  }
+  push_wait_timer_.Pause();
 }
 
 }  // end namespace framework
@@ -64,6 +64,11 @@ class InterpreterCoreInfo {
     std::shared_ptr<InterpreterCore> core_{nullptr};
     std::set<std::string> skip_eager_delete_vars_;
     std::unique_ptr<::pir::Program> ir_prog_{nullptr};
+    // The scope variables the inputs are shared into and the outputs are
+    // shared from, one group per argument of the run, bound by name on the
+    // first cached run and reused by the later ones. nullptr for the
+    // skipped arguments.
+    std::vector<std::vector<Variable*>> bound_vars_;
   };
 
   bool IsAvailable(bool is_grad) {
@@ -106,6 +106,12 @@ class HeterContext {
   void* sub_graph_float_feas = NULL;
   uint32_t shard_num_ = 37;
   uint16_t pass_id_ = 0;
+  // seconds spent in each pass build stage, reported at BeginPass
+  double pre_build_span_ = 0;
+  double build_pull_span_ = 0;
+  double prepare_span_ = 0;
+  // MergePull and partition to devices already done by the prepare thread
+  bool prepared_ = false;
   uint64_t size() {
     uint64_t total_size = 0;
     for (auto& keys : feature_keys_) {
@@ -152,6 +158,10 @@ class HeterContext {
   }
 
   void Reset() {
+    pre_build_span_ = 0;
+    build_pull_span_ = 0;
+    prepare_span_ = 0;
+    prepared_ = false;
     if (!multi_mf_dim_) {
       for (size_t i = 0; i < feature_keys_.size(); ++i) {
         feature_keys_[i].clear();
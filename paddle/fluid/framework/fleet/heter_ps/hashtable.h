@@ -202,6 +202,22 @@ class HashTable {
               Sgd sgd,
               StreamType stream);
 
+  // Merge the d_counts[i] gradients of the unique key d_keys[i], whose
+  // indexes in d_grads start at d_index + d_offsets[i], into d_merged_grads
+  // and update its value with them, in one kernel.
+  template <typename Sgd, typename StreamType, typename GPUAccessor>
+  void merge_update(const KeyType* d_keys,
+                    const uint32_t* d_offsets,
+                    const uint32_t* d_counts,
+                    const uint32_t* d_index,
+                    const char* d_grads,
+                    char* d_merged_grads,
+                    size_t len,
+                    size_t grad_dim,
+                    Sgd sgd,
+                    StreamType stream,
+                    const GPUAccessor& gpu_accessor);
+
 #elif defined(PADDLE_WITH_XPU_KP)
   template <typename GradType, typename StreamType>
   void update(const KeyType* d_keys,
@@ -236,6 +236,61 @@ __global__ void dy_mf_update_kernel(Table* table,
   }
 }
 
+// The gradients are merged like merge_gradients_basic_kernel and
+// merge_gradients_embedx_kernel do, so the values are updated the same as
+// by a merge_gradient followed by a dy_mf_update_kernel.
+template <typename Table, typename Sgd, typename GPUAccessor>
+__global__ void dy_mf_merge_update_kernel(
+    Table* table,
+    const OptimizerConfig& optimizer_config,
+    const typename Table::key_type* const keys,
+    const uint32_t* offsets,
+    const uint32_t* counts,
+    const uint32_t* index,
+    const char* const grads,
+    char* merged_grads,
+    size_t len,
+    size_t grad_dim,
+    Sgd sgd,
+    size_t grad_value_size,
+    GPUAccessor gpu_accessor) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i >= len) {
+    return;
+  }
+  const uint32_t start = offsets[i];
+  const uint32_t num = counts[i];
+  float* merged = reinterpret_cast<float*>(merged_grads + i * grad_value_size);
+  gpu_accessor.PushValueFillBasic(
+      merged,
+      reinterpret_cast<const float*>(grads +
+                                     size_t(index[start]) * grad_value_size));
+  if (keys[i] != 0) {
+    for (uint32_t j = 1; j < num; ++j) {
+      gpu_accessor.MergePushValueBasic(
+          merged,
+          reinterpret_cast<const float*>(
+              grads + size_t(index[start + j]) * grad_value_size));
+    }
+  }
+  const size_t embedx_off = gpu_accessor.common_push_value.EmbedxGIndex();
+  for (size_t k = 0; k < grad_dim; ++k) {
+    double val = 0;
+    for (uint32_t j = 0; j < num; ++j) {
+      val += reinterpret_cast<const float*>(
+          grads + size_t(index[start + j]) * grad_value_size)[embedx_off + k];
+    }
+    merged[embedx_off + k] = val;
+  }
+
+  auto it = table->find(keys[i]);
+  if (it != table->end()) {
+    sgd.dy_mf_update_value(optimizer_config, (it.getter())->second, merged);
+  } else {
+    PADDLE_ENFORCE(false, "warning: push miss key: %lu", keys[i]);
+  }
+}
+
 template <typename Table>
 __global__ void get_keys_kernel(Table* table,
                                 typename Table::key_type* d_out,
@@ -543,6 +598,40 @@ void HashTable<KeyType, ValType>::update(const KeyType* d_keys,
       push_grad_value_size_);
 }
 
+template <typename KeyType, typename ValType>
+template <typename Sgd, typename StreamType, typename GPUAccessor>
+void HashTable<KeyType, ValType>::merge_update(
+    const KeyType* d_keys,
+    const uint32_t* d_offsets,
+    const uint32_t* d_counts,
+    const uint32_t* d_index,
+    const char* d_grads,
+    char* d_merged_grads,
+    size_t len,
+    size_t grad_dim,
+    Sgd sgd,
+    StreamType stream,
+    const GPUAccessor& gpu_accessor) {
+  if (len == 0) {
+    return;
+  }
+  const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
+  dy_mf_merge_update_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+      container_,
+      *device_optimizer_config_,
+      d_keys,
+      d_offsets,
+      d_counts,
+      d_index,
+      d_grads,
+      d_merged_grads,
+      len,
+      grad_dim,
+      sgd,
+      push_grad_value_size_,
+      gpu_accessor);
+}
+
 template class HashTable<uint64_t, float>;
 template class HashTable<uint64_t, float*>;
 template class HashTable<int64_t, int>;
@@ -732,6 +821,86 @@ template void HashTable<uint64_t, float*>::update<
                   SparseAdamSharedOptimizer<CommonFeatureValueAccessor> sgd,
                   cudaStream_t stream);
 
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdagradOptimizer<CommonFeatureValueAccessor>,
+    cudaStream_t,
+    CommonFeatureValueAccessor>(
+    const uint64_t* d_keys,
+    const uint32_t* d_offsets,
+    const uint32_t* d_counts,
+    const uint32_t* d_index,
+    const char* d_grads,
+    char* d_merged_grads,
+    size_t len,
+    size_t grad_dim,
+    SparseAdagradOptimizer<CommonFeatureValueAccessor> sgd,
+    cudaStream_t stream,
+    const CommonFeatureValueAccessor& gpu_accessor);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdagradV2Optimizer<CommonFeatureValueAccessor>,
+    cudaStream_t,
+    CommonFeatureValueAccessor>(
+    const uint64_t* d_keys,
+    const uint32_t* d_offsets,
+    const uint32_t* d_counts,
+    const uint32_t* d_index,
+    const char* d_grads,
+    char* d_merged_grads,
+    size_t len,
+    size_t grad_dim,
+    SparseAdagradV2Optimizer<CommonFeatureValueAccessor> sgd,
+    cudaStream_t stream,
+    const CommonFeatureValueAccessor& gpu_accessor);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    StdAdagradOptimizer<CommonFeatureValueAccessor>,
+    cudaStream_t,
+    CommonFeatureValueAccessor>(
+    const uint64_t* d_keys,
+    const uint32_t* d_offsets,
+    const uint32_t* d_counts,
+    const uint32_t* d_index,
+    const char* d_grads,
+    char* d_merged_grads,
+    size_t len,
+    size_t grad_dim,
+    StdAdagradOptimizer<CommonFeatureValueAccessor> sgd,
+    cudaStream_t stream,
+    const CommonFeatureValueAccessor& gpu_accessor);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdamOptimizer<CommonFeatureValueAccessor>,
+    cudaStream_t,
+    CommonFeatureValueAccessor>(
+    const uint64_t* d_keys,
+    const uint32_t* d_offsets,
+    const uint32_t* d_counts,
+    const uint32_t* d_index,
+    const char* d_grads,
+    char* d_merged_grads,
+    size_t len,
+    size_t grad_dim,
+    SparseAdamOptimizer<CommonFeatureValueAccessor> sgd,
+    cudaStream_t stream,
+    const CommonFeatureValueAccessor& gpu_accessor);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdamSharedOptimizer<CommonFeatureValueAccessor>,
+    cudaStream_t,
+    CommonFeatureValueAccessor>(
+    const uint64_t* d_keys,
+    const uint32_t* d_offsets,
+    const uint32_t* d_counts,
+    const uint32_t* d_index,
+    const char* d_grads,
+    char* d_merged_grads,
+    size_t len,
+    size_t grad_dim,
+    SparseAdamSharedOptimizer<CommonFeatureValueAccessor> sgd,
+    cudaStream_t stream,
+    const CommonFeatureValueAccessor& gpu_accessor);
+
 // template void HashTable<uint64_t,
 // paddle::framework::FeatureValue>::update<
 //    Optimizer<paddle::framework::FeatureValue,
@@ -700,6 +700,16 @@ class HeterComm {
                     const void* d_in_grads,
                     void* d_out_grads,
                     const cudaStream_t& stream);
+  // merge_grad and update_one_table in one kernel over the unique keys
+  template <typename Sgd>
+  size_t merge_update_one_table(const int& gpu_id,
+                                const size_t& len,
+                                const KeyType* d_in_keys,
+                                KeyType* d_out_keys,
+                                const void* d_in_grads,
+                                void* d_out_grads,
+                                Sgd& sgd,  // NOLINT
+                                const cudaStream_t& stream);
   size_t gather_inner_gradient_by_copy(const int& gpu_id,
                                        const size_t& push_size,
                                        KeyType* d_keys,
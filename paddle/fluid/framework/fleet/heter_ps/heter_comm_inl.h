@@ -29,8 +29,10 @@ limitations under the License. */
 
 COMMON_DECLARE_double(gpugraph_hbm_table_load_factor);
 COMMON_DECLARE_bool(gpugraph_enable_gpu_direct_access);
+COMMON_DECLARE_bool(enable_auto_detect_gpu_topo);
 COMMON_DECLARE_bool(gpugraph_enable_segment_merge_grads);
 COMMON_DECLARE_uint64(gpugraph_merge_grads_segment_size);
+COMMON_DECLARE_bool(gpugraph_enable_fused_merge_update);
 COMMON_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 COMMON_DECLARE_bool(enable_tracker_all2all);
 COMMON_DECLARE_bool(enable_all2all_use_fp16);
@@ -61,8 +63,13 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
   rdma_checker_ = GpuRDMAChecker::get(device_num_);
   topo_aware_ = rdma_checker_->topo_aware();
 #endif
+  // the cards all linked by NVLink read the tables of each other directly
+  // instead of staging the keys and values along the paths
   enable_gpu_direct_access_ =
-      (topo_aware_) ? false : FLAGS_gpugraph_enable_gpu_direct_access;
+      (topo_aware_) ? false
+                    : (FLAGS_gpugraph_enable_gpu_direct_access ||
+                       (FLAGS_enable_auto_detect_gpu_topo &&
+                        resource_->nvlink_all_connected()));
   VLOG(0) << "device_num = " << device_num_ << ", multi_node = " << multi_node_
           << ", multi_mf_dim = " << multi_mf_dim_
           << ", topo_aware = " << topo_aware_
@@ -142,8 +149,13 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
   rdma_checker_ = GpuRDMAChecker::get(device_num_);
   topo_aware_ = rdma_checker_->topo_aware();
 #endif
+  // the cards all linked by NVLink read the tables of each other directly
+  // instead of staging the keys and values along the paths
   enable_gpu_direct_access_ =
-      (topo_aware_) ? false : FLAGS_gpugraph_enable_gpu_direct_access;
+      (topo_aware_) ? false
+                    : (FLAGS_gpugraph_enable_gpu_direct_access ||
+                       (FLAGS_enable_auto_detect_gpu_topo &&
+                        resource_->nvlink_all_connected()));
   VLOG(0) << "gpu access device_num = " << device_num_
           << ", multi_node = " << multi_node_
           << ", multi_mf_dim = " << multi_mf_dim_
@@ -3564,14 +3576,28 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::push_sparse_all2all(
     VLOG(0) << "push gpu id=" << gpu_id
             << ", gather_sparse_gradient_by_all2all len=" << node_push_len;
   }
-  // all embedx merge
-  size_t uniq_len = merge_grad(gpu_id,
-                               node_push_len,
-                               my_cache.d_merged_push_keys,  // in
-                               my_cache.d_merged_keys,       // out
-                               my_cache.d_merged_push_vals,  // in
-                               my_cache.d_merged_vals,
-                               stream);  // out
+  // all embedx merge, and update along with it when fused
+  const bool fused_update = FLAGS_gpugraph_enable_fused_merge_update &&
+                            FLAGS_enable_sparse_inner_gather && multi_mf_dim_;
+  size_t uniq_len = 0;
+  if (fused_update) {
+    uniq_len = merge_update_one_table(gpu_id,
+                                      node_push_len,
+                                      my_cache.d_merged_push_keys,  // in
+                                      my_cache.d_merged_keys,       // out
+                                      my_cache.d_merged_push_vals,  // in
+                                      my_cache.d_merged_vals,       // out
+                                      sgd,
+                                      stream);
+  } else {
+    uniq_len = merge_grad(gpu_id,
+                          node_push_len,
+                          my_cache.d_merged_push_keys,  // in
+                          my_cache.d_merged_keys,       // out
+                          my_cache.d_merged_push_vals,  // in
+                          my_cache.d_merged_vals,
+                          stream);  // out
+  }
   if (FLAGS_enable_tracker_all2all) {
     // check all2ll merge grads
     heter_comm_kernel_->check_valid_values(
@@ -3583,7 +3609,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::push_sparse_all2all(
         stream,
         (gpu_id == 0));
   }
-  if (FLAGS_enable_sparse_inner_gather) {
+  if (fused_update) {
+    // updated by merge_update_one_table
+  } else if (FLAGS_enable_sparse_inner_gather) {
     // update all grad
     update_one_table(gpu_id,
                      my_cache.d_merged_keys,
@@ -3660,6 +3688,66 @@ size_t HeterComm<KeyType, ValType, GradType, GPUAccessor>::merge_grad(
 
   return merge_size;
 }
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+template <typename Sgd>
+size_t HeterComm<KeyType, ValType, GradType, GPUAccessor>::
+    merge_update_one_table(const int &gpu_id,
+                           const size_t &len,
+                           const KeyType *d_in_keys,
+                           KeyType *d_out_keys,
+                           const void *d_in_grads,
+                           void *d_out_grads,
+                           Sgd &sgd,  // NOLINT
+                           const cudaStream_t &stream) {
+  if (len == 0) {
+    return 0;
+  }
+  platform::CUDADeviceGuard guard(resource_->dev_id(gpu_id));
+  auto place = phi::GPUPlace(resource_->dev_id(gpu_id));
+  thread_local std::shared_ptr<memory::Allocation> d_fea_num_info = nullptr;
+  uint32_t *d_offset =
+      AllocCache<uint32_t>(&d_fea_num_info, place, sizeof(uint32_t) * len * 4);
+  uint32_t *d_sorted_idx = &d_offset[len];
+  uint32_t *d_restore_idx = &d_sorted_idx[len];
+  uint32_t *d_merged_cnts = &d_restore_idx[len];
+
+  thread_local std::shared_ptr<memory::Allocation> d_sort_keys_ptr = nullptr;
+  KeyType *d_sorted_keys =
+      AllocCache<KeyType>(&d_sort_keys_ptr, place, sizeof(KeyType) * len);
+
+  size_t merge_size = dedup_keys_and_fillidx(gpu_id,
+                                             len,
+                                             d_in_keys,   // input
+                                             d_out_keys,  // output
+                                             d_sorted_keys,
+                                             d_restore_idx,
+                                             d_sorted_idx,
+                                             d_offset,
+                                             d_merged_cnts,
+                                             false,
+                                             stream);
+
+  auto &table = ptr_tables_[gpu_id];
+  table->rwlock_->WRLock();
+  table->merge_update(d_out_keys,
+                      d_offset,
+                      d_merged_cnts,
+                      d_sorted_idx,
+                      reinterpret_cast<const char *>(d_in_grads),
+                      reinterpret_cast<char *>(d_out_grads),
+                      merge_size,
+                      max_mf_dim_,
+                      sgd,
+                      stream,
+                      gpu_accessor_);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+  table->rwlock_->UNLock();
+
+  return merge_size;
+}
 template <typename KeyType,
           typename ValType,
           typename GradType,
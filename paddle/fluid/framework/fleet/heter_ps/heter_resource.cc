@@ -103,6 +103,7 @@ XPUResource::~XPUResource() {
 
 void HeterPsResource::enable_p2p() {
 #if defined(PADDLE_WITH_CUDA)
+  nvlink_all_connected_ = dev_ids_.size() > 1;
   for (size_t i = 0; i < dev_ids_.size(); ++i) {
     platform::CUDADeviceGuard guard(dev_ids_[i]);
     for (size_t j = 0; j < dev_ids_.size(); ++j) {
@@ -110,6 +111,16 @@ void HeterPsResource::enable_p2p() {
         int p2p_flag;
         PADDLE_ENFORCE_GPU_SUCCESS(
             cudaDeviceCanAccessPeer(&p2p_flag, dev_ids_[i], dev_ids_[j]));
+        // the native peer atomics come with NVLink only, not with PCIe
+        int atomic_flag = 0;
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            cudaDeviceGetP2PAttribute(&atomic_flag,
+                                      cudaDevP2PAttrNativeAtomicSupported,
+                                      dev_ids_[i],
+                                      dev_ids_[j]));
+        if (p2p_flag != 1 || atomic_flag != 1) {
+          nvlink_all_connected_ = false;
+        }
         if (p2p_flag == 1) {
           cudaError_t ret = cudaDeviceEnablePeerAccess(dev_ids_[j], 0);
           if (ret != cudaSuccess && ret != cudaErrorPeerAccessAlreadyEnabled) {
@@ -122,6 +133,8 @@ void HeterPsResource::enable_p2p() {
       }
     }
   }
+  VLOG(0) << "heter ps devices all connected by nvlink: "
+          << nvlink_all_connected_;
 #endif
 }
 static std::string execute_cmd_result(const std::string &cmd) {
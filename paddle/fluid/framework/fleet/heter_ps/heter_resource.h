@@ -135,6 +135,9 @@ class HeterPsResource {
   HeterPsResource& operator=(const HeterPsResource&) = delete;
   virtual ~HeterPsResource() {}
   void enable_p2p();
+  // whether every pair of the devices is linked by NVLink, e.g. through
+  // NVSwitch, found by enable_p2p
+  bool nvlink_all_connected() { return nvlink_all_connected_; }
   int total_device();
   int get_index_by_devid(int devid);
   int dev_id(int num);
@@ -162,6 +165,8 @@ class HeterPsResource {
   int multi_mf_dim_{0};
   int max_mf_dim_{0};
 
+  bool nvlink_all_connected_ = false;
+
   // multi node
   bool multi_node_ = false;
   std::vector<std::shared_ptr<HashTable<uint64_t, uint32_t>>> keys2rank_vec_;
@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #ifdef PADDLE_WITH_HETERPS
+#include <algorithm>
 #include <iostream>
 #ifdef PADDLE_WITH_CUDA
 #include "paddle/fluid/framework/fleet/heter_ps/cudf/managed.cuh"
@@ -93,18 +94,26 @@ class HBMMemoryPool : public managed {
   size_t block_size_;
 };
 
+// Values of blocks [0, hbm_size) live in HBM, the rest in pinned host memory
+// mapped into the device address space, so kernels reach cold values over
+// PCIe through the same table pointers.
 class HBMMemoryPoolFix : public managed {
  public:
   HBMMemoryPoolFix() {
     capacity_ = 0;
     size_ = 0;
+    hbm_size_ = 0;
     block_size_ = 0;
     max_byte_capacity_ = 0;
+    max_host_byte_capacity_ = 0;
   }
 
   ~HBMMemoryPoolFix() {
     VLOG(3) << "delete hbm memory pool";
     cudaFree(mem_);
+    if (host_mem_ != NULL) {
+      cudaFreeHost(host_mem_);
+    }
   }
 
   size_t block_size() { return block_size_; }
@@ -112,32 +121,99 @@ class HBMMemoryPoolFix : public managed {
   void clear(void) { cudaMemset(mem_, 0, block_size_ * capacity_); }
 
   void reset(size_t capacity, size_t block_size) {
-    if (max_byte_capacity_ < capacity * block_size) {
+    reset(capacity, block_size, capacity);
+  }
+
+  // keep at most hbm_capacity of the capacity blocks in HBM
+  void reset(size_t capacity, size_t block_size, size_t hbm_capacity) {
+    size_t hbm_size = std::min(capacity, hbm_capacity);
+    if (max_byte_capacity_ < hbm_size * block_size) {
       if (mem_ != NULL) {
         cudaFree(mem_);
       }
-      max_byte_capacity_ = (block_size * capacity / 8 + 1) * 8;
+      max_byte_capacity_ = (block_size * hbm_size / 8 + 1) * 8;
       CUDA_CHECK(cudaMalloc(&mem_, max_byte_capacity_));
     }
+    size_t host_bytes = (capacity - hbm_size) * block_size;
+    if (max_host_byte_capacity_ < host_bytes) {
+      if (host_mem_ != NULL) {
+        cudaFreeHost(host_mem_);
+      }
+      max_host_byte_capacity_ = (host_bytes / 8 + 1) * 8;
+      CUDA_CHECK(cudaHostAlloc(
+          &host_mem_, max_host_byte_capacity_, cudaHostAllocMapped));
+      CUDA_CHECK(cudaHostGetDevicePointer(&host_dev_mem_, host_mem_, 0));
+    }
     size_ = capacity;
+    hbm_size_ = hbm_size;
     block_size_ = block_size;
     capacity_ = max_byte_capacity_ / block_size;
   }
 
   char* mem() { return mem_; }
+  // device side address of the blocks past hbm_size
+  char* host_dev_mem() { return host_dev_mem_; }
 
   size_t capacity() { return capacity_; }
   size_t size() { return size_; }
+  size_t hbm_size() { return hbm_size_; }
+
+  // copy num blocks starting at block offset from host src into the pool
+  void copy_in(size_t offset,
+               const char* src,
+               size_t num,
+               cudaStream_t stream) {
+    copy(offset, const_cast<char*>(src), num, stream, true);
+  }
+  // copy num blocks starting at block offset out of the pool to host dst
+  void copy_out(size_t offset, char* dst, size_t num, cudaStream_t stream) {
+    copy(offset, dst, num, stream, false);
+  }
+
   __forceinline__ __device__ void* mem_address(const uint32_t& idx) {
-    return &mem_[(idx)*block_size_];
+    if (idx < hbm_size_) {
+      return &mem_[(idx)*block_size_];
+    }
+    return &host_dev_mem_[(idx - hbm_size_) * block_size_];
   }
 
  private:
+  void copy(size_t offset,
+            char* buf,
+            size_t num,
+            cudaStream_t stream,
+            bool in) {
+    size_t hbm_num = offset < hbm_size_ ? std::min(num, hbm_size_ - offset) : 0;
+    if (hbm_num > 0) {
+      char* pool = mem_ + offset * block_size_;
+      CUDA_CHECK(cudaMemcpyAsync(in ? pool : buf,
+                                 in ? buf : pool,
+                                 hbm_num * block_size_,
+                                 in ? cudaMemcpyHostToDevice
+                                    : cudaMemcpyDeviceToHost,
+                                 stream));
+    }
+    if (hbm_num < num) {
+      char* pool = host_mem_ + (offset + hbm_num - hbm_size_) * block_size_;
+      char* host = buf + hbm_num * block_size_;
+      // stream ordered so it does not race kernels still using the values
+      CUDA_CHECK(cudaMemcpyAsync(in ? pool : host,
+                                 in ? host : pool,
+                                 (num - hbm_num) * block_size_,
+                                 cudaMemcpyHostToHost,
+                                 stream));
+    }
+  }
+
   char* mem_ = NULL;
+  char* host_mem_ = NULL;
+  char* host_dev_mem_ = NULL;
   size_t capacity_;
   size_t size_;
+  size_t hbm_size_;
   size_t block_size_;
   size_t max_byte_capacity_;
+  size_t max_host_byte_capacity_;
 };
 
 }  // end namespace framework
@@ -52,19 +52,17 @@ void BasicAucCalculator::add_data(const float* d_pred,
                                   const int64_t* d_label,
                                   int batch_size,
                                   const phi::Place& place) {
-  thread_local std::vector<float> h_pred;
-  thread_local std::vector<int64_t> h_label;
-  h_pred.resize(batch_size);
-  h_label.resize(batch_size);
-  memcpy(h_pred.data(), d_pred, sizeof(float) * batch_size);
-  memcpy(h_label.data(), d_label, sizeof(int64_t) * batch_size);
-  std::lock_guard<std::mutex> lock(_table_mutex);
+  // the data is read from the cpu tensors of the scope, so it is binned in
+  // place, and the lock is held only to merge the bins
+  thread_local BinnedBatch batch;
+  batch.clear();
   for (int i = 0; i < batch_size; ++i) {
-    add_unlock_data(h_pred[i], h_label[i]);
+    bin_data(d_pred[i], static_cast<int>(d_label[i]), &batch);
   }
+  merge_data(batch);
 }
 
-void BasicAucCalculator::add_unlock_data(double pred, int label) {
+int BasicAucCalculator::bin_of(double pred, int label) const {
   PADDLE_ENFORCE_GE(
       pred,
       0.0,
@@ -89,35 +87,54 @@ void BasicAucCalculator::add_unlock_data(double pred, int label) {
       _table_size,
       common::errors::PreconditionNotMet(
           "pos must be less than table_size, but its value is: %d", pos));
+  return pos;
+}
+
+void BasicAucCalculator::add_unlock_data(double pred, int label) {
+  int pos = bin_of(pred, label);
   _local_abserr += fabs(pred - label);
   _local_sqrerr += (pred - label) * (pred - label);
   _local_pred += pred;
   ++_table[label][pos];
 }
 
+void BasicAucCalculator::bin_data(double pred,
+                                  int label,
+                                  BinnedBatch* batch) const {
+  int pos = bin_of(pred, label);
+  batch->pos_[label].push_back(pos);
+  batch->abserr_ += fabs(pred - label);
+  batch->sqrerr_ += (pred - label) * (pred - label);
+  batch->pred_ += pred;
+}
+
+void BasicAucCalculator::merge_data(const BinnedBatch& batch) {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  for (int label = 0; label < 2; ++label) {
+    double* table = _table[label].data();
+    for (int pos : batch.pos_[label]) {
+      ++table[pos];
+    }
+  }
+  _local_abserr += batch.abserr_;
+  _local_sqrerr += batch.sqrerr_;
+  _local_pred += batch.pred_;
+}
+
 // add mask data
 void BasicAucCalculator::add_mask_data(const float* d_pred,
                                        const int64_t* d_label,
                                        const int64_t* d_mask,
                                        int batch_size,
                                        const phi::Place& place) {
-  thread_local std::vector<float> h_pred;
-  thread_local std::vector<int64_t> h_label;
-  thread_local std::vector<int64_t> h_mask;
-  h_pred.resize(batch_size);
-  h_label.resize(batch_size);
-  h_mask.resize(batch_size);
-
-  memcpy(h_pred.data(), d_pred, sizeof(float) * batch_size);
-  memcpy(h_label.data(), d_label, sizeof(int64_t) * batch_size);
-  memcpy(h_mask.data(), d_mask, sizeof(int64_t) * batch_size);
-
-  std::lock_guard<std::mutex> lock(_table_mutex);
+  thread_local BinnedBatch batch;
+  batch.clear();
   for (int i = 0; i < batch_size; ++i) {
-    if (h_mask[i]) {
-      add_unlock_data(h_pred[i], h_label[i]);
+    if (d_mask[i]) {
+      bin_data(d_pred[i], static_cast<int>(d_label[i]), &batch);
     }
   }
+  merge_data(batch);
 }
 
 void BasicAucCalculator::compute() {
@@ -132,24 +149,36 @@ void BasicAucCalculator::compute() {
     gloo_wrapper->Init();
   }
 
+  // the tables and the errors of all the trainers are summed in a single
+  // allreduce, whose result is shared with calculate_bucket_error
+  std::vector<double> global;
+  const double* neg_table = _table[0].data();
+  const double* pos_table = _table[1].data();
+  double global_abserr = _local_abserr;
+  double global_sqrerr = _local_sqrerr;
+  double global_pred = _local_pred;
   if (gloo_wrapper->Size() > 1) {
-    auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
-    auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
-    for (int i = _table_size - 1; i >= 0; i--) {
-      double newfp = fp + neg_table[i];
-      double newtp = tp + pos_table[i];
-      area += (newfp - fp) * (tp + newtp) / 2;
-      fp = newfp;
-      tp = newtp;
-    }
-  } else {
-    for (int i = _table_size - 1; i >= 0; i--) {
-      double newfp = fp + _table[0][i];
-      double newtp = tp + _table[1][i];
-      area += (newfp - fp) * (tp + newtp) / 2;
-      fp = newfp;
-      tp = newtp;
-    }
+    std::vector<double> local;
+    local.reserve(2 * _table_size + 3);
+    local.insert(local.end(), _table[0].begin(), _table[0].end());
+    local.insert(local.end(), _table[1].begin(), _table[1].end());
+    local.push_back(_local_abserr);
+    local.push_back(_local_sqrerr);
+    local.push_back(_local_pred);
+    global = gloo_wrapper->AllReduce(local, "sum");
+    neg_table = global.data();
+    pos_table = global.data() + _table_size;
+    global_abserr = global[2 * _table_size];
+    global_sqrerr = global[2 * _table_size + 1];
+    global_pred = global[2 * _table_size + 2];
+  }
+
+  for (int i = _table_size - 1; i >= 0; i--) {
+    double newfp = fp + neg_table[i];
+    double newtp = tp + pos_table[i];
+    area += (newfp - fp) * (tp + newtp) / 2;
+    fp = newfp;
+    tp = newtp;
   }
 
   if (fp < 1e-3 || tp < 1e-3) {
@@ -158,95 +187,50 @@ void BasicAucCalculator::compute() {
     _auc = area / (fp * tp);
   }
 
-  if (gloo_wrapper->Size() > 1) {
-    // allreduce sum
-    std::vector<double> local_abserr_vec(1, _local_abserr);
-    std::vector<double> local_sqrerr_vec(1, _local_sqrerr);
-    std::vector<double> local_pred_vec(1, _local_pred);
-    auto global_abserr_vec = gloo_wrapper->AllReduce(local_abserr_vec, "sum");
-    auto global_sqrerr_vec = gloo_wrapper->AllReduce(local_sqrerr_vec, "sum");
-    auto global_pred_vec = gloo_wrapper->AllReduce(local_pred_vec, "sum");
-    _mae = global_abserr_vec[0] / (fp + tp);
-    _rmse = sqrt(global_sqrerr_vec[0] / (fp + tp));
-    _predicted_ctr = global_pred_vec[0] / (fp + tp);
-  } else {
-    _mae = _local_abserr / (fp + tp);
-    _rmse = sqrt(_local_sqrerr / (fp + tp));
-    _predicted_ctr = _local_pred / (fp + tp);
-  }
+  _mae = global_abserr / (fp + tp);
+  _rmse = sqrt(global_sqrerr / (fp + tp));
+  _predicted_ctr = global_pred / (fp + tp);
   _actual_ctr = tp / (fp + tp);
 
   _size = fp + tp;
 
-  calculate_bucket_error();
+  calculate_bucket_error(neg_table, pos_table);
 #endif
 }
 
-void BasicAucCalculator::calculate_bucket_error() {
-#if defined(PADDLE_WITH_GLOO)
+void BasicAucCalculator::calculate_bucket_error(const double* neg_table,
+                                                const double* pos_table) {
   double last_ctr = -1;
   double impression_sum = 0;
   double ctr_sum = 0.0;
   double click_sum = 0.0;
   double error_sum = 0.0;
   double error_count = 0;
-  auto gloo_wrapper = paddle::framework::GlooWrapper::GetInstance();
-  if (gloo_wrapper->Size() > 1) {
-    auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
-    auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
-    for (int i = 0; i < _table_size; i++) {
-      double click = pos_table[i];
-      double show = neg_table[i] + pos_table[i];
-      double ctr = static_cast<double>(i) / _table_size;
-      if (fabs(ctr - last_ctr) > kMaxSpan) {
-        last_ctr = ctr;
-        impression_sum = 0.0;
-        ctr_sum = 0.0;
-        click_sum = 0.0;
-      }
-      impression_sum += show;
-      ctr_sum += ctr * show;
-      click_sum += click;
-      double adjust_ctr = ctr_sum / impression_sum;
-      double relative_error =
-          sqrt((1 - adjust_ctr) / (adjust_ctr * impression_sum));
-      if (relative_error < kRelativeErrorBound) {
-        double actual_ctr = click_sum / impression_sum;
-        double relative_ctr_error = fabs(actual_ctr / adjust_ctr - 1);
-        error_sum += relative_ctr_error * impression_sum;
-        error_count += impression_sum;
-        last_ctr = -1;
-      }
+  for (int i = 0; i < _table_size; i++) {
+    double click = pos_table[i];
+    double show = neg_table[i] + pos_table[i];
+    double ctr = static_cast<double>(i) / _table_size;
+    if (fabs(ctr - last_ctr) > kMaxSpan) {
+      last_ctr = ctr;
+      impression_sum = 0.0;
+      ctr_sum = 0.0;
+      click_sum = 0.0;
     }
-  } else {
-    double* table[2] = {&_table[0][0], &_table[1][0]};  // NOLINT
-    for (int i = 0; i < _table_size; i++) {
-      double click = table[1][i];
-      double show = table[0][i] + table[1][i];
-      double ctr = static_cast<double>(i) / _table_size;
-      if (fabs(ctr - last_ctr) > kMaxSpan) {
-        last_ctr = ctr;
-        impression_sum = 0.0;
-        ctr_sum = 0.0;
-        click_sum = 0.0;
-      }
-      impression_sum += show;
-      ctr_sum += ctr * show;
-      click_sum += click;
-      double adjust_ctr = ctr_sum / impression_sum;
-      double relative_error =
-          sqrt((1 - adjust_ctr) / (adjust_ctr * impression_sum));
-      if (relative_error < kRelativeErrorBound) {
-        double actual_ctr = click_sum / impression_sum;
-        double relative_ctr_error = fabs(actual_ctr / adjust_ctr - 1);
-        error_sum += relative_ctr_error * impression_sum;
-        error_count += impression_sum;
-        last_ctr = -1;
-      }
+    impression_sum += show;
+    ctr_sum += ctr * show;
+    click_sum += click;
+    double adjust_ctr = ctr_sum / impression_sum;
+    double relative_error =
+        sqrt((1 - adjust_ctr) / (adjust_ctr * impression_sum));
+    if (relative_error < kRelativeErrorBound) {
+      double actual_ctr = click_sum / impression_sum;
+      double relative_ctr_error = fabs(actual_ctr / adjust_ctr - 1);
+      error_sum += relative_ctr_error * impression_sum;
+      error_count += impression_sum;
+      last_ctr = -1;
     }
   }
   _bucket_error = error_count > 0 ? error_sum / error_count : 0.0;
-#endif
 }
 
 void BasicAucCalculator::reset_records() {
@@ -264,20 +248,9 @@ void BasicAucCalculator::add_uid_data(const float* d_pred,
                                       const int64_t* d_uid,
                                       int batch_size,
                                       const phi::Place& place) {
-  thread_local std::vector<float> h_pred;
-  thread_local std::vector<int64_t> h_label;
-  thread_local std::vector<uint64_t> h_uid;
-  h_pred.resize(batch_size);
-  h_label.resize(batch_size);
-  h_uid.resize(batch_size);
-
-  memcpy(h_pred.data(), d_pred, sizeof(float) * batch_size);
-  memcpy(h_label.data(), d_label, sizeof(int64_t) * batch_size);
-  memcpy(h_uid.data(), d_uid, sizeof(uint64_t) * batch_size);
-
   std::lock_guard<std::mutex> lock(_table_mutex);
   for (int i = 0; i < batch_size; ++i) {
-    add_uid_unlock_data(h_pred[i], h_label[i], static_cast<uint64_t>(h_uid[i]));
+    add_uid_unlock_data(d_pred[i], d_label[i], static_cast<uint64_t>(d_uid[i]));
   }
 }
 
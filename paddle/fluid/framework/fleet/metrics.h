@@ -59,6 +59,20 @@ class BasicAucCalculator {
     double fp_;
     double auc_;
   };
+  // the bins of a batch, made without the lock and merged with it
+  struct BinnedBatch {
+    std::vector<int> pos_[2];
+    double abserr_ = 0;
+    double sqrerr_ = 0;
+    double pred_ = 0;
+    void clear() {
+      pos_[0].clear();
+      pos_[1].clear();
+      abserr_ = 0;
+      sqrerr_ = 0;
+      pred_ = 0;
+    }
+  };
   void init(int table_size);
   void init_wuauc(int table_size);
   void reset();
@@ -66,6 +80,10 @@ class BasicAucCalculator {
   // add single data in CPU with LOCK, deprecated
   void add_unlock_data(double pred, int label);
   void add_uid_unlock_data(double pred, int label, uint64_t uid);
+  // bin single data into batch, which needs no lock
+  void bin_data(double pred, int label, BinnedBatch* batch) const;
+  // add the binned data with LOCK
+  void merge_data(const BinnedBatch& batch);
   // add batch data
   void add_data(const float* d_pred,
                 const int64_t* d_label,
@@ -103,7 +121,9 @@ class BasicAucCalculator {
   std::mutex& table_mutex(void) { return _table_mutex; }
 
  private:
-  void calculate_bucket_error();
+  int bin_of(double pred, int label) const;
+  void calculate_bucket_error(const double* neg_table,
+                              const double* pos_table);
 
  protected:
   double _local_abserr = 0;
@@ -323,17 +343,20 @@ class Metric {
                 pred_data_list[i].size()));
       }
       auto cal = GetCalculator();
-      std::lock_guard<std::mutex> lock(cal->table_mutex());
+      thread_local BasicAucCalculator::BinnedBatch batch;
+      batch.clear();
       for (size_t i = 0; i < batch_size; ++i) {
         auto cmatch_rank_it = std::find(cmatch_rank_v.begin(),
                                         cmatch_rank_v.end(),
                                         parse_cmatch_rank(cmatch_rank_data[i]));
         if (cmatch_rank_it != cmatch_rank_v.end()) {
-          cal->add_unlock_data(pred_data_list[std::distance(
-                                   cmatch_rank_v.begin(), cmatch_rank_it)][i],
-                               label_data[i]);
+          cal->bin_data(pred_data_list[std::distance(cmatch_rank_v.begin(),
+                                                     cmatch_rank_it)][i],
+                        label_data[i],
+                        &batch);
         }
       }
+      cal->merge_data(batch);
     }
 
    protected:
@@ -399,7 +422,8 @@ class Metric {
               batch_size,
               pred_data.size()));
       auto cal = GetCalculator();
-      std::lock_guard<std::mutex> lock(cal->table_mutex());
+      thread_local BasicAucCalculator::BinnedBatch batch;
+      batch.clear();
       for (size_t i = 0; i < batch_size; ++i) {
         const auto& cur_cmatch_rank = parse_cmatch_rank(cmatch_rank_data[i]);
         for (size_t j = 0; j < cmatch_rank_v.size(); ++j) {
@@ -410,11 +434,12 @@ class Metric {
             is_matched = cmatch_rank_v[j] == cur_cmatch_rank;
           }
           if (is_matched) {
-            cal->add_unlock_data(pred_data[i], label_data[i]);
+            cal->bin_data(pred_data[i], label_data[i], &batch);
             break;
           }
         }
       }
+      cal->merge_data(batch);
     }
 
    protected:
@@ -535,7 +560,8 @@ class Metric {
       }
 
       auto cal = GetCalculator();
-      std::lock_guard<std::mutex> lock(cal->table_mutex());
+      thread_local BasicAucCalculator::BinnedBatch batch;
+      batch.clear();
       for (size_t i = 0; i < batch_size; ++i) {
         const auto& cur_cmatch_rank = parse_cmatch_rank(cmatch_rank_data[i]);
         for (size_t j = 0; j < cmatch_rank_v.size(); ++j) {
@@ -549,11 +575,12 @@ class Metric {
             is_matched = cmatch_rank_v[j] == cur_cmatch_rank;
           }
           if (is_matched) {
-            cal->add_unlock_data(pred_data[i], label_data[i]);
+            cal->bin_data(pred_data[i], label_data[i], &batch);
             break;
           }
         }
       }
+      cal->merge_data(batch);
     }
 
    protected:
@@ -30,7 +30,9 @@ limitations under the License. */
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
 
 #include <algorithm>
+#include <cmath>
 #include <deque>
+#include <functional>
 #include <unordered_set>
 
 #include "paddle/fluid/framework/data_set.h"
@@ -48,6 +50,8 @@ COMMON_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
 COMMON_DECLARE_string(graph_edges_split_mode);
+COMMON_DECLARE_bool(gpups_pipeline_prepare_task);
+COMMON_DECLARE_double(gpups_hbm_value_ratio);
 
 namespace paddle {
 namespace framework {
@@ -275,12 +279,15 @@ void PSGPUWrapper::PreBuildTask(std::shared_ptr<HeterContext> gpu_task,
                                      int begin_index,
                                      int end_index,
                                      int i) {
+        SlotValues<uint64_t> unpacked;
         for (auto iter = total_data.begin() + begin_index;
              iter != total_data.begin() + end_index;
              iter++) {
           const auto& ins = *iter;
-          const auto& feasign_v = ins->slot_uint64_feasigns_.slot_values;
-          const auto& slot_offset = ins->slot_uint64_feasigns_.slot_offsets;
+          const auto& feasigns =
+              ins->slot_uint64_feasigns_.unpacked(&unpacked);
+          const auto& feasign_v = feasigns.slot_values;
+          const auto& slot_offset = feasigns.slot_offsets;
           for (size_t slot_idx = 0; slot_idx < slot_offset_vector_.size();
                slot_idx++) {
             for (size_t j = slot_offset[slot_offset_vector_[slot_idx]];
@@ -1759,6 +1766,56 @@ void PSGPUWrapper::PrepareGPUTask(std::shared_ptr<HeterContext> gpu_task) {
           << " seconds.";
 }
 
+void PSGPUWrapper::PartitionHotValues(
+    std::shared_ptr<HeterContext> gpu_task,
+    const std::vector<size_t>& hbm_value_count) {
+#ifdef PADDLE_WITH_PSCORE
+  platform::Timer timeline;
+  timeline.Start();
+  int device_num = heter_devices_.size();
+  // move the most shown values to the front, which build_ps keeps in HBM
+  auto partition_func = [this, &gpu_task, &hbm_value_count](int i, int j) {
+    auto& keys = gpu_task->device_dim_keys_[i][j];
+    auto& ptrs = gpu_task->device_dim_ptr_[i][j];
+    size_t hot_len = hbm_value_count[i * multi_mf_dim_ + j];
+    if (hot_len == 0 || hot_len >= keys.size()) {
+      return;
+    }
+    std::vector<std::pair<float, uint32_t>> order(keys.size());
+    for (size_t k = 0; k < keys.size(); ++k) {
+      order[k].first = cpu_table_accessor_->GetField(ptrs[k]->data(), "show");
+      order[k].second = static_cast<uint32_t>(k);
+    }
+    std::nth_element(order.begin(),
+                     order.begin() + hot_len,
+                     order.end(),
+                     std::greater<std::pair<float, uint32_t>>());
+    std::vector<FeatureKey> sorted_keys(keys.size());
+    std::vector<paddle::distributed::FixedFeatureValue*> sorted_ptrs(
+        ptrs.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+      sorted_keys[k] = keys[order[k].second];
+      sorted_ptrs[k] = ptrs[order[k].second];
+    }
+    keys.swap(sorted_keys);
+    ptrs.swap(sorted_ptrs);
+  };
+  std::vector<std::future<void>> task_futures;
+  for (int i = 0; i < device_num; i++) {
+    for (int j = 0; j < multi_mf_dim_; j++) {
+      task_futures.emplace_back(
+          cpu_work_pool_[i]->enqueue(partition_func, i, j));
+    }
+  }
+  for (auto& f : task_futures) {
+    f.wait();
+  }
+  timeline.Pause();
+  VLOG(1) << "passid=" << gpu_task->pass_id_
+          << ", PartitionHotValues cost " << timeline.ElapsedSec() << " s.";
+#endif
+}
+
 void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
   int device_num = heter_devices_.size();
   platform::Timer stagetime;
@@ -1857,10 +1914,27 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
         //    VLOG(0) << "end build_dynamic_mf_func tid=" << tid << ", i=" << i;
       };
 
+  // number of values of each (device, dim) pool that stay in HBM
+  std::vector<size_t> hbm_value_count(device_num * multi_mf_dim_);
+  for (int i = 0; i < device_num; i++) {
+    for (int j = 0; j < multi_mf_dim_; j++) {
+      size_t len = gpu_task->device_dim_keys_[i][j].size();
+      hbm_value_count[i * multi_mf_dim_ + j] =
+          FLAGS_gpups_hbm_value_ratio >= 1.0
+              ? len
+              : static_cast<size_t>(std::ceil(
+                    len * std::max(FLAGS_gpups_hbm_value_ratio, 0.0)));
+    }
+  }
+  if (FLAGS_gpups_hbm_value_ratio < 1.0) {
+    PartitionHotValues(gpu_task, hbm_value_count);
+  }
+
   auto build_dymf_hbm_pool = [this,
                               &gpu_task,
                               &accessor_wrapper_ptr,
-                              &feature_keys_count](int i) {
+                              &feature_keys_count,
+                              &hbm_value_count](int i) {
     platform::CUDADeviceGuard guard(resource_->dev_id(i));
 
     platform::Timer stagetime;
@@ -1880,16 +1954,31 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
       int mf_dim = this->index_dim_vec_[j];
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
-      this->hbm_pools_[i * this->multi_mf_dim_ + j]->reset(len,
-                                                           feature_value_size);
-      this->HeterPs_->build_ps(
-          i,
-          device_dim_keys.data(),
-          this->hbm_pools_[i * this->multi_mf_dim_ + j]->mem(),
-          len,
-          feature_value_size,
-          4 * 1024 * 1024,
-          2);
+      auto hbm_pool = this->hbm_pools_[i * this->multi_mf_dim_ + j];
+      hbm_pool->reset(len,
+                      feature_value_size,
+                      hbm_value_count[i * this->multi_mf_dim_ + j]);
+      size_t hbm_len = hbm_pool->hbm_size();
+      this->HeterPs_->build_ps(i,
+                               device_dim_keys.data(),
+                               hbm_pool->mem(),
+                               hbm_len,
+                               feature_value_size,
+                               4 * 1024 * 1024,
+                               2);
+      // cold values are reached through the mapped host memory
+      this->HeterPs_->build_ps(i,
+                               device_dim_keys.data() + hbm_len,
+                               hbm_pool->host_dev_mem(),
+                               len - hbm_len,
+                               feature_value_size,
+                               4 * 1024 * 1024,
+                               2);
+      if (hbm_len < len) {
+        VLOG(1) << "card: " << i << " dim: " << this->index_dim_vec_[j]
+                << " keeps " << hbm_len << " of " << len
+                << " values in hbm, the rest in host memory";
+      }
       if (device_dim_keys.size() > 0) {
         VLOG(3) << "show table: " << i
                 << " table kv size: " << device_dim_keys.size()
@@ -1936,19 +2025,16 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
     struct task_info task;
     auto stream = resource_->local_stream(i, 0);
     while (cpu_reday_channels_[i]->Get(task)) {
-      auto hbm = this->hbm_pools_[task.device_id * this->multi_mf_dim_ +
-                                  task.multi_mf_dim]
-                     ->mem();
+      auto hbm_pool = this->hbm_pools_[task.device_id * this->multi_mf_dim_ +
+                                       task.multi_mf_dim];
       int mf_dim = this->index_dim_vec_[task.multi_mf_dim];
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
-      auto hbm_start = hbm + task.offset * feature_value_size;
-      CUDA_CHECK(cudaMemcpyAsync(
-          hbm_start,
+      hbm_pool->copy_in(
+          task.offset,
           task.build_values.get() + task.start * feature_value_size,
-          (task.end - task.start) * feature_value_size,
-          cudaMemcpyHostToDevice,
-          stream));
+          task.end - task.start,
+          stream);
       total_len += (task.end - task.start);
     }
     PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
@@ -2056,6 +2142,10 @@ void PSGPUWrapper::start_build_thread() {
   running_ = true;
   VLOG(3) << "start build CPU ps thread.";
   buildpull_threads_ = std::thread([this] { build_pull_thread(); });
+  if (FLAGS_gpups_pipeline_prepare_task) {
+    VLOG(3) << "start build prepare thread.";
+    buildprepare_threads_ = std::thread([this] { build_prepare_thread(); });
+  }
 }
 
 void PSGPUWrapper::AddSparseKeys() {
@@ -2068,6 +2158,7 @@ void PSGPUWrapper::AddSparseKeys() {
   // build cpu ps data process
   PreBuildTask(gpu_task, dataset_);
   timer.Pause();
+  gpu_task->pre_build_span_ = timer.ElapsedSec();
   VLOG(1) << "passid=" << gpu_task->pass_id_
           << ", thread PreBuildTask end, cost time: " << timer.ElapsedSec()
           << " s";
@@ -2089,6 +2180,7 @@ void PSGPUWrapper::build_pull_thread() {
     // build cpu ps data process
     BuildPull(gpu_task);
     timer.Pause();
+    gpu_task->build_pull_span_ = timer.ElapsedSec();
     VLOG(0) << "passid=" << gpu_task->pass_id_
             << ", thread BuildPull end, cost time: " << timer.ElapsedSec()
             << "s";
@@ -2097,29 +2189,79 @@ void PSGPUWrapper::build_pull_thread() {
   VLOG(3) << "build cpu thread end";
 }
 
-void PSGPUWrapper::build_task() {
-  // build_task: build_pull + build_gputask
-  std::shared_ptr<HeterContext> gpu_task = nullptr;
-  // ins and pre_build end
-  if (!buildpull_ready_channel_->Get(gpu_task)) {
-    return;
-  }
+bool PSGPUWrapper::CanPipelinePrepare() {
+  // MergePull of multi node graph mode runs a gloo barrier, which must stay
+  // in step with the other ranks on the training thread
+  return !multi_node_ || !gpu_graph_mode_;
+}
 
-  VLOG(1) << "passid=" << gpu_task->pass_id_ << ", PrepareGPUTask start.";
+void PSGPUWrapper::PrepareTask(std::shared_ptr<HeterContext> gpu_task) {
   platform::Timer timer;
   timer.Start();
-  // merge pull
   MergePull(gpu_task);
   if (multi_mf_dim_) {
     divide_to_device(gpu_task);
   } else {
     PrepareGPUTask(gpu_task);
   }
+  timer.Pause();
+  gpu_task->prepare_span_ = timer.ElapsedSec();
+  gpu_task->prepared_ = true;
+}
+
+void PSGPUWrapper::build_prepare_thread() {
+  while (running_) {
+    std::shared_ptr<HeterContext> gpu_task = nullptr;
+    if (!buildpull_ready_channel_->Get(gpu_task)) {
+      continue;
+    }
+    // only host side work here, BuildGPUTask still waits for BeginPass as
+    // the HBM tables are in use by the training pass
+    if (CanPipelinePrepare()) {
+      PrepareTask(gpu_task);
+      VLOG(0) << "passid=" << gpu_task->pass_id_
+              << ", thread PrepareTask end, cost time: "
+              << gpu_task->prepare_span_ << "s";
+    }
+    buildprepare_ready_channel_->Put(gpu_task);
+  }
+  VLOG(3) << "build prepare thread end";
+}
+
+void PSGPUWrapper::build_task() {
+  // build_task: build_pull + build_gputask
+  std::shared_ptr<HeterContext> gpu_task = nullptr;
+  platform::Timer timer;
+  timer.Start();
+  // ins and pre_build end
+  auto &ready_channel = buildprepare_threads_.joinable()
+                            ? buildprepare_ready_channel_
+                            : buildpull_ready_channel_;
+  if (!ready_channel->Get(gpu_task)) {
+    return;
+  }
+  timer.Pause();
+  double wait_span = timer.ElapsedSec();
+
+  VLOG(1) << "passid=" << gpu_task->pass_id_ << ", PrepareGPUTask start.";
+  bool pipelined = gpu_task->prepared_;
+  if (!pipelined) {
+    PrepareTask(gpu_task);
+  }
+  timer.Start();
   BuildGPUTask(gpu_task);
   timer.Pause();
   VLOG(1) << "passid=" << gpu_task->pass_id_
           << ", PrepareGPUTask + BuildGPUTask end, cost time: "
-          << timer.ElapsedSec() << "s";
+          << (pipelined ? 0 : gpu_task->prepare_span_) + timer.ElapsedSec()
+          << "s";
+  VLOG(0) << "passid=" << gpu_task->pass_id_
+          << ", build stages cost time: PreBuildTask "
+          << gpu_task->pre_build_span_ << "s, BuildPull "
+          << gpu_task->build_pull_span_ << "s, PrepareTask "
+          << gpu_task->prepare_span_ << "s" << (pipelined ? " (pipelined)" : "")
+          << ", BuildGPUTask " << timer.ElapsedSec() << "s, wait for build "
+          << wait_span << "s";
 
   current_task_ = gpu_task;
 }
@@ -2274,14 +2416,9 @@ void PSGPUWrapper::HbmToSparseTable() {
         std::shared_ptr<char> build_values(
             new char[feature_value_size * real_len],
             [](char* p) { delete[] p; });
-        uint64_t offset = start * feature_value_size;
         char* test_build_values = build_values.get();
 
-        cudaMemcpyAsync(test_build_values,
-                        hbm_pool->mem() + offset,
-                        feature_value_size * real_len,
-                        cudaMemcpyDeviceToHost,
-                        stream);
+        hbm_pool->copy_out(start, test_build_values, real_len, stream);
         for (size_t k = 0; k < real_len; k = k + once_cpu_num) {
           struct task_info task;
           task.build_values = build_values;
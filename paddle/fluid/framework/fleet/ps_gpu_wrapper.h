@@ -69,6 +69,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/fleet/heter_ps/log_patch.h"
 
 COMMON_DECLARE_int32(gpugraph_storage_mode);
+COMMON_DECLARE_bool(gpups_pipeline_prepare_task);
 
 namespace paddle {
 namespace framework {
@@ -209,6 +210,8 @@ class PSGPUWrapper {
                     Dataset* dataset_for_pull);
   void BuildPull(std::shared_ptr<HeterContext> gpu_task);
   void PartitionKey(std::shared_ptr<HeterContext> gpu_task);
+  void PartitionHotValues(std::shared_ptr<HeterContext> gpu_task,
+                          const std::vector<size_t>& hbm_value_count);
   void PrepareGPUTask(std::shared_ptr<HeterContext> gpu_task);
   void LoadIntoMemory(bool is_shuffle);
   void BeginPass();
@@ -221,6 +224,9 @@ class PSGPUWrapper {
   void start_build_thread();
   void AddSparseKeys();
   void build_pull_thread();
+  void build_prepare_thread();
+  bool CanPipelinePrepare();
+  void PrepareTask(std::shared_ptr<HeterContext> gpu_task);
   void build_task();
   void DumpToMem();
   void MergePull(std::shared_ptr<HeterContext> gpu_task);
@@ -263,9 +269,13 @@ class PSGPUWrapper {
     }
     buildcpu_ready_channel_->Close();
     buildpull_ready_channel_->Close();
+    buildprepare_ready_channel_->Close();
     running_ = false;
     VLOG(3) << "begin stop buildpull_threads_";
     buildpull_threads_.join();
+    if (buildprepare_threads_.joinable()) {
+      buildprepare_threads_.join();
+    }
     s_instance_ = nullptr;
     VLOG(3) << "PSGPUWrapper Finalize Finished.";
     if (HeterPs_ != NULL) {
@@ -350,6 +360,8 @@ class PSGPUWrapper {
       buildcpu_ready_channel_->SetCapacity(3);
       buildpull_ready_channel_->Open();
       buildpull_ready_channel_->SetCapacity(1);
+      buildprepare_ready_channel_->Open();
+      buildprepare_ready_channel_->SetCapacity(1);
 
       cpu_reday_channels_.resize(dev_ids.size());
       for (size_t i = 0; i < dev_ids.size(); i++) {
@@ -1029,10 +1041,16 @@ class PSGPUWrapper {
       paddle::framework::ChannelObject<std::shared_ptr<HeterContext>>>
       buildpull_ready_channel_ =
           paddle::framework::MakeChannel<std::shared_ptr<HeterContext>>();
+  // filled by build_prepare_thread with tasks that only need BuildGPUTask
+  std::shared_ptr<
+      paddle::framework::ChannelObject<std::shared_ptr<HeterContext>>>
+      buildprepare_ready_channel_ =
+          paddle::framework::MakeChannel<std::shared_ptr<HeterContext>>();
   std::vector<std::shared_ptr<paddle::framework::ChannelObject<task_info>>>
       cpu_reday_channels_;
   std::shared_ptr<HeterContext> current_task_ = nullptr;
   std::thread buildpull_threads_;
+  std::thread buildprepare_threads_;
   bool running_ = false;
   std::vector<std::shared_ptr<::ThreadPool>> pull_thread_pool_;
   std::vector<std::shared_ptr<::ThreadPool>> hbm_thread_pool_;
@@ -837,6 +837,7 @@ void HogwildWorker::CreateThreadOperators(const ProgramDesc &program) {
               << ", span time=" << tm.ElapsedSec() << "sec";
     }
   }
+  EnableRuntimeContextCache(ops_);
   operators::PrepareSafeEagerDeletionOnConditionalOpAndConditionalGradOp(
       program, 0, ops_);
   // not need gc
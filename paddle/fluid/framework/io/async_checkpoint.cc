@@ -0,0 +1,414 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/io/async_checkpoint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <streambuf>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/enforce.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/memory_utils.h"
+#endif
+
+namespace paddle::framework {
+
+namespace {
+
+constexpr char kManifestName[] = "manifest";
+constexpr char kManifestMagic[] = "paddle_checkpoint_v1";
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+using GpuEventPtr = std::shared_ptr<std::remove_pointer<phi::gpuEvent_t>::type>;
+#endif
+
+struct Snapshot {
+  std::string name;
+  phi::DenseTensor tensor;
+  size_t bytes;
+};
+
+struct ManifestEntry {
+  std::string name;
+  int shard;
+  uint64_t offset;
+  uint64_t length;
+};
+
+std::string ShardName(int shard) {
+  return string::format_string("shard_%05d.pdtensor", shard);
+}
+
+// Writes to a FILE returned by fs_open_write and counts the bytes written.
+class FileWriteBuffer : public std::streambuf {
+ public:
+  explicit FileWriteBuffer(FILE* file) : file_(file) {}
+
+  uint64_t written() const { return written_; }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    size_t count = fwrite(s, 1, n, file_);
+    written_ += count;
+    return static_cast<std::streamsize>(count);
+  }
+
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+    char ch = traits_type::to_char_type(c);
+    return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+  }
+
+ private:
+  FILE* file_;
+  uint64_t written_ = 0;
+};
+
+std::shared_ptr<FILE> OpenWrite(const std::string& path) {
+  int err_no = 0;
+  auto file = fs_open_write(path, &err_no, "");
+  PADDLE_ENFORCE_EQ(
+      file != nullptr && err_no == 0,
+      true,
+      common::errors::Unavailable("Cannot open %s to save the checkpoint.",
+                                  path));
+  return file;
+}
+
+std::shared_ptr<FILE> OpenRead(const std::string& path) {
+  int err_no = 0;
+  auto file = fs_open_read(path, &err_no, "");
+  PADDLE_ENFORCE_EQ(
+      file != nullptr && err_no == 0,
+      true,
+      common::errors::Unavailable("Cannot open %s to load the checkpoint.",
+                                  path));
+  return file;
+}
+
+// Reads `length` bytes to `out`, or skips them if `out` is nullptr. The
+// file may be a pipe, so it is not seeked.
+void ReadBytes(FILE* file,
+               uint64_t length,
+               std::string* out,
+               const std::string& path) {
+  char buffer[1 << 16];
+  while (length > 0) {
+    size_t count = fread(
+        buffer, 1, std::min<uint64_t>(length, sizeof(buffer)), file);
+    PADDLE_ENFORCE_GT(count,
+                      0,
+                      common::errors::Unavailable(
+                          "The checkpoint file %s is truncated.", path));
+    if (out) {
+      out->append(buffer, count);
+    }
+    length -= count;
+  }
+}
+
+void WriteShard(const std::string& path,
+                const std::vector<Snapshot*>& snapshots,
+                std::vector<ManifestEntry>* entries) {
+  auto file = OpenWrite(path);
+  FileWriteBuffer buffer(file.get());
+  std::ostream os(&buffer);
+  for (auto* snapshot : snapshots) {
+    uint64_t offset = buffer.written();
+    SerializeToStream(os, snapshot->tensor);
+    PADDLE_ENFORCE_EQ(
+        os.good(),
+        true,
+        common::errors::Unavailable(
+            "Failed to write the tensor %s to %s.", snapshot->name, path));
+    entries->push_back(
+        {snapshot->name, 0, offset, buffer.written() - offset});
+    // the snapshot is not needed anymore, give the memory back early
+    snapshot->tensor.clear();
+  }
+  PADDLE_ENFORCE_EQ(
+      fflush(file.get()),
+      0,
+      common::errors::Unavailable("Failed to flush the checkpoint file %s.",
+                                  path));
+}
+
+std::vector<ManifestEntry> ReadManifest(const std::string& dirname) {
+  std::string path = dirname + "/" + kManifestName;
+  auto file = OpenRead(path);
+  std::string content;
+  char buffer[4096];
+  size_t count = 0;
+  while ((count = fread(buffer, 1, sizeof(buffer), file.get())) > 0) {
+    content.append(buffer, count);
+  }
+
+  std::istringstream is(content);
+  std::string magic;
+  is >> magic;
+  PADDLE_ENFORCE_EQ(magic,
+                    kManifestMagic,
+                    common::errors::InvalidArgument(
+                        "%s is not a manifest of checkpoint.", path));
+  std::vector<ManifestEntry> entries;
+  ManifestEntry entry;
+  // each line is "<shard> <offset> <length> <name>"
+  while (is >> entry.shard >> entry.offset >> entry.length &&
+         std::getline(is >> std::ws, entry.name)) {
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+}  // namespace
+
+AsyncCheckpointSaver::AsyncCheckpointSaver(int num_threads)
+    : pool_(new phi::ThreadPool(num_threads)) {}
+
+AsyncCheckpointSaver::~AsyncCheckpointSaver() {
+  try {
+    Wait();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to save the checkpoint: " << e.what();
+  }
+}
+
+void AsyncCheckpointSaver::Save(
+    const std::string& dirname,
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors,
+    int num_shards) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    common::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) of the "
+                        "checkpoint must be the same.",
+                        names.size(),
+                        tensors.size()));
+  PADDLE_ENFORCE_GT(num_shards,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The number of shards must be positive, but got %d.",
+                        num_shards));
+  Wait();
+
+  auto snapshots = std::make_shared<std::vector<Snapshot>>(tensors.size());
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::map<int, const phi::DeviceContext*> gpu_dev_ctxs;
+#endif
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto* tensor = tensors[i];
+    PADDLE_ENFORCE_EQ(tensor != nullptr && tensor->IsInitialized(),
+                      true,
+                      common::errors::PreconditionNotMet(
+                          "The tensor %s to save is not initialized.",
+                          names[i]));
+    auto& snapshot = (*snapshots)[i];
+    snapshot.name = names[i];
+    snapshot.bytes = tensor->numel() * phi::SizeOf(tensor->dtype());
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (phi::is_gpu_place(tensor->place())) {
+      // queued on the stream of the tensor, the training goes on meanwhile
+      const auto* dev_ctx =
+          phi::DeviceContextPool::Instance().Get(tensor->place());
+      TensorCopy(*tensor, phi::GPUPinnedPlace(), *dev_ctx, &snapshot.tensor);
+      gpu_dev_ctxs[tensor->place().GetDeviceId()] = dev_ctx;
+      continue;
+    }
+#endif
+    TensorCopySync(*tensor, phi::CPUPlace(), &snapshot.tensor);
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::vector<GpuEventPtr> events;
+  for (auto& item : gpu_dev_ctxs) {
+    auto event = phi::memory_utils::GetCudaEvent(item.first);
+    auto stream = static_cast<const phi::GPUContext*>(item.second)->stream();
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event.get(), stream));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event.get(), stream));
+#endif
+    events.push_back(std::move(event));
+  }
+#endif
+
+  // The largest tensors go first, each to the shard with the fewest bytes.
+  std::vector<size_t> order(snapshots->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return (*snapshots)[lhs].bytes > (*snapshots)[rhs].bytes;
+  });
+  num_shards = std::max<int>(
+      1, std::min<int>(num_shards, static_cast<int>(snapshots->size())));
+  std::vector<std::vector<Snapshot*>> shards(num_shards);
+  std::vector<size_t> shard_bytes(num_shards, 0);
+  for (size_t i : order) {
+    int shard = static_cast<int>(
+        std::min_element(shard_bytes.begin(), shard_bytes.end()) -
+        shard_bytes.begin());
+    shards[shard].push_back(&(*snapshots)[i]);
+    shard_bytes[shard] += (*snapshots)[i].bytes;
+  }
+
+  VLOG(3) << "Save the checkpoint of " << snapshots->size() << " tensors to "
+          << dirname << " in " << num_shards << " shards";
+  auto* pool = pool_.get();
+  pending_ = std::async(std::launch::async, [=]() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    for (auto& event : events) {
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event.get()));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event.get()));
+#endif
+    }
+#endif
+    std::vector<std::vector<ManifestEntry>> entries(shards.size());
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < shards.size(); ++i) {
+      futures.push_back(pool->Run([&, i]() {
+        WriteShard(dirname + "/" + ShardName(static_cast<int>(i)),
+                   shards[i],
+                   &entries[i]);
+      }));
+    }
+    // all the shards have to be done before the snapshots are freed
+    std::exception_ptr error;
+    for (auto& future : futures) {
+      try {
+        future.get();
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    // The manifest is written last and moved in place, a checkpoint with a
+    // manifest is complete.
+    std::string path = dirname + "/" + kManifestName;
+    {
+      auto file = OpenWrite(path + ".tmp");
+      std::ostringstream os;
+      os << kManifestMagic << "\n";
+      for (size_t i = 0; i < entries.size(); ++i) {
+        for (auto& entry : entries[i]) {
+          os << i << " " << entry.offset << " " << entry.length << " "
+             << entry.name << "\n";
+        }
+      }
+      std::string content = os.str();
+      PADDLE_ENFORCE_EQ(
+          fwrite(content.data(), 1, content.size(), file.get()) ==
+                  content.size() &&
+              fflush(file.get()) == 0,
+          true,
+          common::errors::Unavailable("Failed to write the manifest %s.",
+                                      path));
+    }
+    fs_mv(path + ".tmp", path);
+    VLOG(3) << "The checkpoint is saved to " << dirname;
+  });
+}
+
+void AsyncCheckpointSaver::Wait() {
+  if (pending_.valid()) {
+    pending_.get();
+  }
+}
+
+std::vector<std::string> ListCheckpoint(const std::string& dirname) {
+  std::vector<std::string> names;
+  for (auto& entry : ReadManifest(dirname)) {
+    names.push_back(entry.name);
+  }
+  return names;
+}
+
+void LoadCheckpoint(const std::string& dirname,
+                    const std::vector<std::string>& names,
+                    const std::vector<phi::DenseTensor*>& outs) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    outs.size(),
+                    common::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) to load "
+                        "must be the same.",
+                        names.size(),
+                        outs.size()));
+  std::unordered_map<std::string, ManifestEntry> manifest;
+  for (auto& entry : ReadManifest(dirname)) {
+    manifest[entry.name] = entry;
+  }
+
+  // the tensors to read of each shard, ordered by their offsets
+  using TensorToLoad = std::pair<const ManifestEntry*, phi::DenseTensor*>;
+  std::map<int, std::vector<TensorToLoad>> shards;
+  std::unordered_set<std::string> loaded;
+  for (size_t i = 0; i < names.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        loaded.insert(names[i]).second,
+        true,
+        common::errors::InvalidArgument(
+            "The tensor %s is loaded more than once.", names[i]));
+    auto iter = manifest.find(names[i]);
+    PADDLE_ENFORCE_NE(iter,
+                      manifest.end(),
+                      common::errors::NotFound(
+                          "The tensor %s is not in the checkpoint %s.",
+                          names[i],
+                          dirname));
+    PADDLE_ENFORCE_NOT_NULL(
+        outs[i],
+        common::errors::InvalidArgument(
+            "The tensor to load %s to cannot be NULL.", names[i]));
+    shards[iter->second.shard].emplace_back(&iter->second, outs[i]);
+  }
+
+  for (auto& shard : shards) {
+    auto& tensors = shard.second;
+    std::sort(tensors.begin(), tensors.end(), [](auto& lhs, auto& rhs) {
+      return lhs.first->offset < rhs.first->offset;
+    });
+    std::string path = dirname + "/" + ShardName(shard.first);
+    auto file = OpenRead(path);
+    uint64_t pos = 0;
+    for (auto& item : tensors) {
+      const auto* entry = item.first;
+      ReadBytes(file.get(), entry->offset - pos, nullptr, path);
+      std::string data;
+      ReadBytes(file.get(), entry->length, &data, path);
+      pos = entry->offset + entry->length;
+      std::istringstream is(data, std::ios::in | std::ios::binary);
+      DeserializeFromStream(is, item.second);
+    }
+  }
+}
+
+}  // namespace paddle::framework
@@ -0,0 +1,69 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/threadpool.h"
+
+namespace paddle {
+namespace framework {
+
+// Saves checkpoints of dense tensors in the background. A save snapshots the
+// tensors to host memory, pinned for the gpu ones, and returns once the
+// snapshots are queued. The snapshots are then written in shards by a pool
+// of threads through fs_open_write, so hdfs and afs paths work as well as
+// local ones. A manifest written after all the shards tells where each
+// tensor is, so the checkpoint can be loaded by any number of ranks, each
+// reading only the tensors it needs.
+class AsyncCheckpointSaver {
+ public:
+  explicit AsyncCheckpointSaver(int num_threads);
+
+  // Waits for the last save, its error is only logged.
+  ~AsyncCheckpointSaver();
+
+  // Snapshots `tensors` and writes them to `dirname` in `num_shards` shards
+  // in the background. The previous save is waited for first, so that only
+  // one snapshot is held. On gpu the copies are queued on the stream of the
+  // tensor, the later writes to the tensors must be queued on it too.
+  void Save(const std::string& dirname,
+            const std::vector<std::string>& names,
+            const std::vector<const phi::DenseTensor*>& tensors,
+            int num_shards);
+
+  // Waits for the last save, and throws its error if it failed.
+  void Wait();
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(AsyncCheckpointSaver);
+
+  std::unique_ptr<phi::ThreadPool> pool_;
+  std::future<void> pending_;
+};
+
+// Returns the names of the tensors of the checkpoint in `dirname`.
+std::vector<std::string> ListCheckpoint(const std::string& dirname);
+
+// Loads the tensors named `names` of the checkpoint in `dirname` to the cpu,
+// reading only the shards holding them.
+void LoadCheckpoint(const std::string& dirname,
+                    const std::vector<std::string>& names,
+                    const std::vector<phi::DenseTensor*>& outs);
+
+}  // namespace framework
+}  // namespace paddle
@@ -19,6 +19,7 @@ limitations under the License. */
 #include <memory>
 
 #include "glog/logging.h"
+#include "paddle/fluid/framework/io/hdfs_native.h"
 #include "paddle/fluid/platform/enforce.h"
 
 namespace paddle {
@@ -116,6 +117,8 @@ std::shared_ptr<FILE> localfs_open_read(std::string path,
 
   if (fs_end_with_internal(path, ".gz")) {
     fs_add_read_converter_internal(path, is_pipe, "zcat");
+  } else if (fs_end_with_internal(path, ".zst")) {
+    fs_add_read_converter_internal(path, is_pipe, "zstd -dcq");
   }
 
   fs_add_read_converter_internal(path, is_pipe, converter);
@@ -131,6 +134,8 @@ std::shared_ptr<FILE> localfs_open_write(std::string path,
 
   if (fs_end_with_internal(path, ".gz")) {
     fs_add_write_converter_internal(path, is_pipe, "gzip");
+  } else if (fs_end_with_internal(path, ".zst")) {
+    fs_add_write_converter_internal(path, is_pipe, "zstd -cq -T0");
   }
 
   fs_add_write_converter_internal(path, is_pipe, converter);
@@ -146,6 +151,8 @@ std::shared_ptr<FILE> localfs_open_append_write(std::string path,
 
   if (fs_end_with_internal(path, ".gz")) {
     fs_add_write_converter_internal(path, is_pipe, "gzip");
+  } else if (fs_end_with_internal(path, ".zst")) {
+    fs_add_write_converter_internal(path, is_pipe, "zstd -cq -T0");
   }
 
   fs_add_write_converter_internal(path, is_pipe, converter);
@@ -284,6 +291,7 @@ std::shared_ptr<FILE> hdfs_open_read(std::string path,
     path = string::format_string(
         "%s \"%s\"", download_cmd().c_str(), path.c_str());
   } else {
+    bool is_zstd = fs_end_with_internal(path, ".zst");
     if (fs_end_with_internal(path, ".gz")) {
       if (read_data) {
         path = string::format_string(
@@ -300,6 +308,9 @@ std::shared_ptr<FILE> hdfs_open_read(std::string path,
         path = string::format_string(
             "%s -cat \"%s\"", hdfs_command().c_str(), path.c_str());
       }
+      if (is_zstd) {
+        path = string::format_string("%s | zstd -dcq", path.c_str());
+      }
     }
   }
 
@@ -317,6 +328,8 @@ std::shared_ptr<FILE> hdfs_open_write(std::string path,
 
   if (fs_end_with_internal(path, ".gz\"")) {
     fs_add_write_converter_internal(path, is_pipe, "gzip");
+  } else if (fs_end_with_internal(path, ".zst\"")) {
+    fs_add_write_converter_internal(path, is_pipe, "zstd -cq -T0");
   }
 
   fs_add_write_converter_internal(path, is_pipe, converter);
@@ -405,8 +418,10 @@ void hdfs_mv(const std::string& src, const std::string& dest) {
 }
 
 int fs_select_internal(const std::string& path) {
-  if (fs_begin_with_internal(path, "hdfs:") ||
-      fs_begin_with_internal(path, "afs:")) {
+  if (fs_begin_with_internal(path, "hdfs:") && hdfs_native_read_enabled()) {
+    return 2;
+  } else if (fs_begin_with_internal(path, "hdfs:") ||
+             fs_begin_with_internal(path, "afs:")) {
     return 1;
   } else {
     return 0;
@@ -424,6 +439,23 @@ std::shared_ptr<FILE> fs_open_read(const std::string& path,
     case 1:
       return hdfs_open_read(path, err_no, converter, read_data);
 
+    case 2: {
+      // only plain files are read in process, the rest needs the pipe
+      if (download_cmd().empty() && converter.empty() &&
+          !fs_end_with_internal(path, ".gz") &&
+          !fs_end_with_internal(path, ".zst")) {
+        auto fp = hdfs_native_open_read(
+            path, read_data ? dataset_hdfs_command() : hdfs_command());
+        if (fp != nullptr) {
+          if (err_no != nullptr) {
+            *err_no = 0;
+          }
+          return fp;
+        }
+      }
+      return hdfs_open_read(path, err_no, converter, read_data);
+    }
+
     default:
       PADDLE_THROW(common::errors::Unimplemented(
           "Unsupport file system. Now only supports local file system and "
@@ -441,6 +473,7 @@ std::shared_ptr<FILE> fs_open_write(const std::string& path,
       return localfs_open_write(path, converter);
 
     case 1:
+    case 2:
       return hdfs_open_write(path, err_no, converter);
 
     default:
@@ -460,6 +493,7 @@ std::shared_ptr<FILE> fs_open_append_write(const std::string& path,
       return localfs_open_append_write(path, converter);
 
     case 1:
+    case 2:
       return hdfs_open_write(path, err_no, converter);
 
     default:
@@ -508,6 +542,7 @@ void fs_remove(const std::string& path) {
       return localfs_remove(path);
 
     case 1:
+    case 2:
       return hdfs_remove(path);
 
     default:
@@ -523,6 +558,7 @@ std::vector<std::string> fs_list(const std::string& path) {
       return localfs_list(path);
 
     case 1:
+    case 2:
       return hdfs_list(path);
 
     default:
@@ -540,6 +576,7 @@ std::string fs_tail(const std::string& path) {
       return localfs_tail(path);
 
     case 1:
+    case 2:
       return hdfs_tail(path);
 
     default:
@@ -557,6 +594,7 @@ bool fs_exists(const std::string& path) {
       return localfs_exists(path);
 
     case 1:
+    case 2:
       return hdfs_exists(path);
 
     default:
@@ -574,6 +612,7 @@ void fs_mkdir(const std::string& path) {
       return localfs_mkdir(path);
 
     case 1:
+    case 2:
       return hdfs_mkdir(path);
 
     default:
@@ -584,8 +623,10 @@ void fs_mkdir(const std::string& path) {
 }
 
 void fs_mv(const std::string& src, const std::string& dest) {
-  int s = fs_select_internal(src);
-  int d = fs_select_internal(dest);
+  // hdfs: read natively is still moved by the hadoop client, e.g. to afs:
+  auto remote_as_one = [](int fs) { return fs == 2 ? 1 : fs; };
+  int s = remote_as_one(fs_select_internal(src));
+  int d = remote_as_one(fs_select_internal(dest));
   PADDLE_ENFORCE_EQ(
       s,
       d,
@@ -0,0 +1,279 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/hdfs_native.h"
+
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(PADDLE_ARM)
+#include <dlfcn.h>
+#include <fcntl.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_bool(hdfs_native_read);
+COMMON_DECLARE_string(hdfs_native_lib);
+COMMON_DECLARE_int32(hdfs_native_read_threads);
+
+namespace paddle {
+namespace framework {
+
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(PADDLE_ARM)
+namespace {
+
+// subset of libhdfs hdfs.h, resolved with dlsym
+using hdfsFS = void*;
+using hdfsFile = void*;
+struct hdfsBuilder;
+using tSize = int32_t;
+using tOffset = int64_t;
+
+struct LibHdfs {
+  hdfsBuilder* (*NewBuilder)(void);
+  void (*BuilderSetNameNode)(hdfsBuilder*, const char*);
+  void (*BuilderSetUserName)(hdfsBuilder*, const char*);
+  hdfsFS (*BuilderConnect)(hdfsBuilder*);
+  hdfsFile (*OpenFile)(hdfsFS, const char*, int, int, int16_t, tSize);
+  tSize (*Pread)(hdfsFS, hdfsFile, tOffset, void*, tSize);
+  int (*CloseFile)(hdfsFS, hdfsFile);
+};
+
+constexpr size_t kChunkSize = 8UL << 20;
+
+const LibHdfs* load_libhdfs() {
+  static LibHdfs lib;
+  static bool loaded = [] {
+    void* handle = dlopen(FLAGS_hdfs_native_lib.c_str(), RTLD_NOW);
+    if (handle == nullptr) {
+      LOG(WARNING) << "hdfs_native_read: dlopen " << FLAGS_hdfs_native_lib
+                   << " failed: " << dlerror() << ", fall back to pipe";
+      return false;
+    }
+    bool ok = true;
+    auto sym = [&](const char* name, auto* fn) {
+      *reinterpret_cast<void**>(fn) = dlsym(handle, name);
+      ok = ok && *fn != nullptr;
+    };
+    sym("hdfsNewBuilder", &lib.NewBuilder);
+    sym("hdfsBuilderSetNameNode", &lib.BuilderSetNameNode);
+    sym("hdfsBuilderSetUserName", &lib.BuilderSetUserName);
+    sym("hdfsBuilderConnect", &lib.BuilderConnect);
+    sym("hdfsOpenFile", &lib.OpenFile);
+    sym("hdfsPread", &lib.Pread);
+    sym("hdfsCloseFile", &lib.CloseFile);
+    if (!ok) {
+      LOG(WARNING) << "hdfs_native_read: " << FLAGS_hdfs_native_lib
+                   << " misses hdfs symbols, fall back to pipe";
+    }
+    return ok;
+  }();
+  return loaded ? &lib : nullptr;
+}
+
+// value of a -D<key>=<value> or -D <key>=<value> option of the command
+std::string command_option(const std::string& command,
+                           const std::string& key) {
+  size_t pos = command.find(key + "=");
+  if (pos == std::string::npos) {
+    return "";
+  }
+  pos += key.size() + 1;
+  size_t end = command.find_first_of(" \t\"'", pos);
+  return command.substr(pos, end == std::string::npos ? end : end - pos);
+}
+
+// libhdfs connections are cached and shared, they live for the process
+hdfsFS connect(const LibHdfs* lib,
+               const std::string& path,
+               const std::string& hadoop_command) {
+  static std::mutex mutex;
+  static std::map<std::pair<std::string, std::string>, hdfsFS> connections;
+
+  std::string name_node;
+  if (path.compare(0, 7, "hdfs://") == 0) {
+    // the authority of a full uri wins over fs.default.name
+    name_node = path.substr(0, path.find('/', 7));
+  }
+  if (name_node.size() <= 7) {
+    name_node = command_option(hadoop_command, "fs.default.name");
+  }
+  if (name_node.empty()) {
+    name_node = "default";
+  }
+  std::string user = command_option(hadoop_command, "hadoop.job.ugi");
+  user = user.substr(0, user.find(','));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto key = std::make_pair(name_node, user);
+  auto it = connections.find(key);
+  if (it != connections.end()) {
+    return it->second;
+  }
+  hdfsBuilder* builder = lib->NewBuilder();
+  lib->BuilderSetNameNode(builder, name_node.c_str());
+  if (!user.empty()) {
+    lib->BuilderSetUserName(builder, user.c_str());
+  }
+  hdfsFS fs = lib->BuilderConnect(builder);
+  if (fs == nullptr) {
+    LOG(WARNING) << "hdfs_native_read: connect " << name_node
+                 << " failed, fall back to pipe";
+    return nullptr;
+  }
+  connections[key] = fs;
+  return fs;
+}
+
+// Keeps FLAGS_hdfs_native_read_threads chunks in flight. hdfsPread is
+// positional, so chunk reads do not serialize on the file offset.
+class HdfsNativeReader {
+ public:
+  HdfsNativeReader(const LibHdfs* lib, hdfsFS fs, hdfsFile file)
+      : lib_(lib), fs_(fs), file_(file) {
+    int threads = std::max(FLAGS_hdfs_native_read_threads, 1);
+    for (int i = 0; i < threads; ++i) {
+      issue_next();
+    }
+  }
+
+  ~HdfsNativeReader() {
+    for (auto& chunk : pending_) {
+      chunk.wait();
+    }
+    lib_->CloseFile(fs_, file_);
+  }
+
+  ssize_t read(char* buf, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+      if (pos_ == current_.size()) {
+        if (eof_ || pending_.empty()) {
+          break;
+        }
+        current_ = pending_.front().get();
+        pending_.pop_front();
+        pos_ = 0;
+        if (error_) {
+          return -1;
+        }
+        if (current_.size() < kChunkSize) {
+          // short chunk marks the end, later chunks are past it
+          eof_ = true;
+        } else {
+          issue_next();
+        }
+        continue;
+      }
+      size_t n = std::min(size - done, current_.size() - pos_);
+      memcpy(buf + done, current_.data() + pos_, n);
+      pos_ += n;
+      done += n;
+    }
+    return static_cast<ssize_t>(done);
+  }
+
+ private:
+  void issue_next() {
+    tOffset offset = next_offset_;
+    next_offset_ += kChunkSize;
+    pending_.push_back(std::async(std::launch::async, [this, offset] {
+      std::string chunk(kChunkSize, '\0');
+      size_t filled = 0;
+      while (filled < kChunkSize) {
+        tSize n = lib_->Pread(fs_,
+                              file_,
+                              offset + filled,
+                              &chunk[filled],
+                              static_cast<tSize>(kChunkSize - filled));
+        if (n < 0) {
+          error_ = true;
+          break;
+        }
+        if (n == 0) {
+          break;
+        }
+        filled += n;
+      }
+      chunk.resize(filled);
+      return chunk;
+    }));
+  }
+
+  const LibHdfs* lib_;
+  hdfsFS fs_;
+  hdfsFile file_;
+  tOffset next_offset_ = 0;
+  std::deque<std::future<std::string>> pending_;
+  std::string current_;
+  size_t pos_ = 0;
+  bool eof_ = false;
+  std::atomic<bool> error_{false};
+};
+
+ssize_t reader_read(void* cookie, char* buf, size_t size) {
+  return static_cast<HdfsNativeReader*>(cookie)->read(buf, size);
+}
+
+int reader_close(void* cookie) {
+  delete static_cast<HdfsNativeReader*>(cookie);
+  return 0;
+}
+
+}  // namespace
+#endif
+
+bool hdfs_native_read_enabled() { return FLAGS_hdfs_native_read; }
+
+std::shared_ptr<FILE> hdfs_native_open_read(const std::string& path,
+                                            const std::string& hadoop_command) {
+#if defined(_WIN32) || defined(__APPLE__) || defined(PADDLE_ARM)
+  return nullptr;
+#else
+  const LibHdfs* lib = load_libhdfs();
+  if (lib == nullptr) {
+    return nullptr;
+  }
+  hdfsFS fs = connect(lib, path, hadoop_command);
+  if (fs == nullptr) {
+    return nullptr;
+  }
+  hdfsFile file = lib->OpenFile(fs, path.c_str(), O_RDONLY, 0, 0, 0);
+  if (file == nullptr) {
+    LOG(WARNING) << "hdfs_native_read: open " << path
+                 << " failed, fall back to pipe";
+    return nullptr;
+  }
+  auto* reader = new HdfsNativeReader(lib, fs, file);
+  cookie_io_functions_t io = {reader_read, nullptr, nullptr, reader_close};
+  FILE* fp = fopencookie(reader, "r", io);
+  if (fp == nullptr) {
+    delete reader;
+    return nullptr;
+  }
+  VLOG(3) << "hdfs_native_read: open " << path;
+  return {fp, [](FILE* fp) { fclose(fp); }};
+#endif
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,37 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+
+namespace paddle {
+namespace framework {
+
+// Whether hdfs: reads go through libhdfs in process, see
+// FLAGS_hdfs_native_read.
+extern bool hdfs_native_read_enabled();
+
+// Open path for reading through libhdfs. The name node and user are taken
+// from the -Dfs.default.name and -Dhadoop.job.ugi options of the hadoop
+// command. Chunks are read ahead in parallel with positional reads. Returns
+// nullptr when libhdfs is unusable so callers can fall back to a pipe.
+extern std::shared_ptr<FILE> hdfs_native_open_read(
+    const std::string& path, const std::string& hadoop_command);
+
+}  // namespace framework
+}  // namespace paddle
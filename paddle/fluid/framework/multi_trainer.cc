@@ -42,6 +42,7 @@ void MultiTrainer::Initialize(const TrainerDesc& trainer_desc,
   mpi_rank_ = trainer_desc.mpi_rank();
   mpi_size_ = trainer_desc.mpi_size();
   dump_file_num_ = trainer_desc.dump_file_num();
+  numa_binding_ = trainer_desc.numa_binding();
   for (int i = 0; i < trainer_desc.downpour_param().stat_var_names_size();
        i++) {
     need_merge_var_names_.push_back(
@@ -247,11 +248,15 @@ void MultiTrainer::Run() {
                         static_cast<int>(pool.size())));
   for (int i = 0; i < thread_num_; ++i) {
     if (!debug_) {
-      wait_futures.emplace_back(
-          pool[i]->Run([this, i]() { workers_[i]->TrainFiles(); }));
+      wait_futures.emplace_back(pool[i]->Run([this, i]() {
+        BindWorkerToNumaNode(i);
+        workers_[i]->TrainFiles();
+      }));
     } else {
-      wait_futures.emplace_back(
-          pool[i]->Run([this, i]() { workers_[i]->TrainFilesWithProfiler(); }));
+      wait_futures.emplace_back(pool[i]->Run([this, i]() {
+        BindWorkerToNumaNode(i);
+        workers_[i]->TrainFilesWithProfiler();
+      }));
     }
   }
   for (auto& th : wait_futures) {
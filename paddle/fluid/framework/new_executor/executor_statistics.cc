@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/new_executor/executor_statistics.h"
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <map>
@@ -110,6 +111,8 @@ class StatisticsEngine {
 
   int StatNormalizationTime(const std::vector<std::vector<StdEvent>>& all_evts);
 
+  void StatStreamOverlap(const platform::NodeTrees& trees);
+
   bool inited_ = false;
   ExecutorType executor_type_;
   std::vector<std::string> names_;
@@ -117,6 +120,10 @@ class StatisticsEngine {
   std::vector<Priority> priorities_;
   std::vector<EventStat> statistics_;
   std::unordered_map<std::string, size_t> name2idx_;
+  // device work, summed over the streams and as their union
+  size_t stream_num_ = 0;
+  uint64_t stream_busy_sum_ = 0;
+  uint64_t stream_busy_union_ = 0;
 };
 
 int StatisticsEngine::Apply(const platform::NodeTrees& tree) {
@@ -415,6 +422,8 @@ int StatisticsEngine::Stat(const platform::NodeTrees& trees) {
     return -1;
   }
 
+  StatStreamOverlap(trees);
+
   // statistic normalization_time
   return MergeInnerthreadEvents(&all_evts) ||
          MergeInterthreadEvents(&all_evts) || StatNormalizationTime(all_evts);
@@ -532,6 +541,43 @@ int StatisticsEngine::StatNormalizationTime(
   return 0;
 }
 
+void StatisticsEngine::StatStreamOverlap(const platform::NodeTrees& trees) {
+  std::vector<std::pair<uint64_t, uint64_t>> spans;
+  std::set<uint64_t> streams;
+  for (const auto& tree : trees.GetNodeTrees()) {
+    std::queue<const platform::HostTraceEventNode*> q;
+    q.push(tree.second);
+    while (!q.empty()) {
+      auto cur_node = q.front();
+      q.pop();
+      for (const auto& child : cur_node->GetChildren()) {
+        q.push(child);
+      }
+      for (const auto* runtime : cur_node->GetRuntimeTraceEventNodes()) {
+        for (const auto* device : runtime->GetDeviceTraceEventNodes()) {
+          if (device->Type() == platform::TracerEventType::Kernel ||
+              device->Type() == platform::TracerEventType::Memcpy ||
+              device->Type() == platform::TracerEventType::Memset) {
+            spans.emplace_back(device->StartNs(), device->EndNs());
+            streams.insert(device->StreamId());
+            stream_busy_sum_ += device->EndNs() - device->StartNs();
+          }
+        }
+      }
+    }
+  }
+  stream_num_ = streams.size();
+  std::sort(spans.begin(), spans.end());
+  uint64_t end_ns = 0;
+  for (const auto& span : spans) {
+    if (span.second <= end_ns) {
+      continue;
+    }
+    stream_busy_union_ += span.second - std::max(span.first, end_ns);
+    end_ns = span.second;
+  }
+}
+
 void StatisticsEngine::Log(const std::string& filepath) {
   std::ofstream ofs;
   ofs.open(filepath, std::ofstream::out | std::ofstream::trunc);
@@ -554,6 +600,17 @@ void StatisticsEngine::Log(const std::string& filepath) {
                                    evt_stat.count,
                                    evt_stat.normalization_time);
   }
+  // overlapped time is the device work hidden by running streams in parallel
+  ofs << platform::string_format(std::string(R"JSON(
+  {
+    "statistical item" : "MultiStreamOverlap",
+    "number of streams" : %llu,
+    "device busy time(ns)" : %llu,
+    "overlapped time(ns)" : %llu
+  },)JSON"),
+                                 static_cast<uint64_t>(stream_num_),
+                                 stream_busy_union_,
+                                 stream_busy_sum_ - stream_busy_union_);
   ofs.seekp(-1, std::ios_base::end);
   ofs << "]";
   if (ofs) {
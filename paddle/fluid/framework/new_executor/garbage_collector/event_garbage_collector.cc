@@ -21,11 +21,16 @@
 #include <windows.h>
 #endif  // !_WIN32
 
+COMMON_DECLARE_int32(new_executor_gc_batch_size);
+
 namespace paddle::framework {
 
 InterpreterCoreEventGarbageCollector::InterpreterCoreEventGarbageCollector(
     const std::vector<Instruction>& vec_instruction)
-    : queue_(nullptr), gc_event_(), events_() {
+    : queue_(nullptr),
+      gc_event_(),
+      events_(),
+      batch_size_(FLAGS_new_executor_gc_batch_size) {
   WorkQueueOptions options(/*name*/ "GarbageCollector",
                            /*num_threads*/ 1,
                            /*allow_spinning*/ true,
@@ -39,7 +44,10 @@ InterpreterCoreEventGarbageCollector::InterpreterCoreEventGarbageCollector(
 
 InterpreterCoreEventGarbageCollector::InterpreterCoreEventGarbageCollector(
     const std::vector<std::unique_ptr<InstructionBase>>& vec_instruction)
-    : queue_(nullptr), gc_event_(), events_() {
+    : queue_(nullptr),
+      gc_event_(),
+      events_(),
+      batch_size_(FLAGS_new_executor_gc_batch_size) {
   WorkQueueOptions options(/*name*/ "GarbageCollector",
                            /*num_threads*/ 1,
                            /*allow_spinning*/ true,
@@ -53,6 +61,7 @@ InterpreterCoreEventGarbageCollector::InterpreterCoreEventGarbageCollector(
 
 InterpreterCoreEventGarbageCollector::
     ~InterpreterCoreEventGarbageCollector() {  // NOLINT
+  FlushAll();
   queue_.reset(nullptr);
 }
 
@@ -80,6 +89,33 @@ void InterpreterCoreEventGarbageCollector::Add(Variable* var,
   Add(var, &gc_event_.at(instr->Id()), &instr->DeviceContext());
 }
 
+void InterpreterCoreEventGarbageCollector::Flush(const Instruction& instr) {
+  if (batch_size_ > 0 && max_memory_size_ <= 1) {
+    CountInstruction(&instr.DeviceContext());
+  }
+}
+
+void InterpreterCoreEventGarbageCollector::Flush(
+    const InstructionBase* instr) {
+  if (batch_size_ > 0 && max_memory_size_ <= 1) {
+    CountInstruction(&instr->DeviceContext());
+  }
+}
+
+void InterpreterCoreEventGarbageCollector::FlushAll() {
+  std::vector<const phi::DeviceContext*> ctxs;
+  {  // lock guard
+    std::lock_guard<memory::SpinLock> guard(spinlock_);
+    for (auto& item : batches_) {
+      item.second.instr_num = 0;
+      ctxs.push_back(item.first);
+    }
+  }
+  for (auto* ctx : ctxs) {
+    FlushBatch(ctx);
+  }
+}
+
 void InterpreterCoreEventGarbageCollector::Add(Variable* var,
                                                platform::DeviceEvent* event,
                                                const phi::DeviceContext* ctx) {
@@ -155,7 +191,13 @@ void InterpreterCoreEventGarbageCollector::Add(Garbage garbage,
   }
 
   if (max_memory_size_ <= 1) {
-    Free(garbage, event, ctx);
+    if (batch_size_ > 0) {
+      // released in Flush
+      std::lock_guard<memory::SpinLock> guard(spinlock_);
+      batches_[ctx].garbages.push_back(std::move(garbage));
+    } else {
+      Free(garbage, event, ctx);
+    }
   } else {
     {  // lock guard
       std::lock_guard<memory::SpinLock> guard(spinlock_);
@@ -187,6 +229,72 @@ void InterpreterCoreEventGarbageCollector::Free(const Garbage& garbage,
   });
 }
 
+void InterpreterCoreEventGarbageCollector::CountInstruction(
+    const phi::DeviceContext* ctx) {
+  {  // lock guard
+    std::lock_guard<memory::SpinLock> guard(spinlock_);
+    // the instructions freeing nothing are counted too
+    auto& batch = batches_[ctx];
+    if (++batch.instr_num < batch_size_) {
+      return;
+    }
+    batch.instr_num = 0;
+  }
+  FlushBatch(ctx);
+}
+
+void InterpreterCoreEventGarbageCollector::FlushBatch(
+    const phi::DeviceContext* ctx) {
+  std::vector<Garbage> garbages;
+  {  // lock guard
+    std::lock_guard<memory::SpinLock> guard(spinlock_);
+    auto iter = batches_.find(ctx);
+    if (iter == batches_.end() || iter->second.garbages.empty()) {
+      return;
+    }
+    garbages.swap(iter->second.garbages);
+  }
+
+  // work on a stream completes in order, so one event recorded after the
+  // last instruction of the batch covers all of its garbages
+  platform::DeviceEvent* event = AcquireEvent(ctx);
+  event->Record(ctx);
+  event->SetFinished();  // Only for CPU Event
+  queue_->AddTask(
+      [this, ctx, event, container = std::move(garbages)]() mutable {
+        while (!event->Query()) {
+#if defined(_WIN32)
+          SleepEx(50, FALSE);
+#else
+          sched_yield();
+#endif
+          continue;
+        }
+        container.clear();
+        ReleaseEvent(ctx, event);
+      });
+}
+
+platform::DeviceEvent* InterpreterCoreEventGarbageCollector::AcquireEvent(
+    const phi::DeviceContext* ctx) {
+  std::lock_guard<memory::SpinLock> guard(event_pool_lock_);
+  auto& pool = event_pool_[ctx];
+  if (!pool.empty()) {
+    platform::DeviceEvent* event = pool.back();
+    pool.pop_back();
+    return event;
+  }
+  owned_events_.emplace_back(std::make_unique<platform::DeviceEvent>(
+      ctx->GetPlace(), platform::GenerateDeviceEventFlag()));
+  return owned_events_.back().get();
+}
+
+void InterpreterCoreEventGarbageCollector::ReleaseEvent(
+    const phi::DeviceContext* ctx, platform::DeviceEvent* event) {
+  std::lock_guard<memory::SpinLock> guard(event_pool_lock_);
+  event_pool_[ctx].push_back(event);
+}
+
 void InterpreterCoreEventGarbageCollector::FreeGarbages() {
   for (auto& vals : events_) {
     vals.second->Record(vals.first);
@@ -36,6 +36,12 @@ class InterpreterCoreEventGarbageCollector
 
   void Add(Variable* var, const InstructionBase* instruction) override;
 
+  void Flush(const Instruction& instruction) override;
+
+  void Flush(const InstructionBase* instruction) override;
+
+  void FlushAll() override;
+
  private:
   void Add(Variable* var,
            platform::DeviceEvent* event,
@@ -50,11 +56,38 @@ class InterpreterCoreEventGarbageCollector
 
   void FreeGarbages();
 
+  // garbages of the instructions on a stream waiting for one event, used
+  // when FLAGS_new_executor_gc_batch_size > 0
+  struct GarbageBatch {
+    std::vector<Garbage> garbages;
+    int instr_num{0};
+  };
+
+  // counts an instruction on ctx, releasing the batch every batch_size_ ones
+  void CountInstruction(const phi::DeviceContext* ctx);
+
+  void FlushBatch(const phi::DeviceContext* ctx);
+
+  platform::DeviceEvent* AcquireEvent(const phi::DeviceContext* ctx);
+
+  void ReleaseEvent(const phi::DeviceContext* ctx,
+                    platform::DeviceEvent* event);
+
   std::unique_ptr<WorkQueue> queue_;
   paddle::memory::SpinLock spinlock_;
   std::vector<paddle::platform::DeviceEvent> gc_event_;
   std::unordered_map<const phi::DeviceContext*, paddle::platform::DeviceEvent*>
       events_;
+
+  int batch_size_;
+  std::unordered_map<const phi::DeviceContext*, GarbageBatch> batches_;
+  // events are recycled once queried, guarded by event_pool_lock_ since they
+  // are returned by the gc thread
+  paddle::memory::SpinLock event_pool_lock_;
+  std::unordered_map<const phi::DeviceContext*,
+                     std::vector<platform::DeviceEvent*>>
+      event_pool_;
+  std::vector<std::unique_ptr<platform::DeviceEvent>> owned_events_;
 };
 }  // namespace framework
 }  // namespace paddle
@@ -40,6 +40,16 @@ class InterpreterCoreGarbageCollector {
 
   virtual void Add(Variable* var, const InstructionBase* instruction) = 0;
 
+  // Called after all the garbages of an instruction are added, collectors
+  // that batch garbages may release them here.
+  virtual void Flush(const Instruction& instruction) {}
+
+  virtual void Flush(const InstructionBase* instruction) {}
+
+  // Called at the end of a run, collectors that batch garbages release all
+  // of them here so that no memory is held across runs.
+  virtual void FlushAll() {}
+
   DISABLE_COPY_AND_ASSIGN(InterpreterCoreGarbageCollector);
 
  protected:
@@ -16,6 +16,7 @@
 
 #include "paddle/cinn/hlir/dialect/runtime/ir/jit_kernel_op.h"
 #include "paddle/cinn/hlir/dialect/runtime/ir/runtime_dialect.h"
+#include "paddle/cinn/hlir/framework/pir/shape_bucket_profile.h"
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 #include "paddle/common/errors.h"
 #include "paddle/common/performance_statistician.h"
@@ -36,6 +37,7 @@ typedef void (*infer_shape_func_ptr_g)(void*, int32_t, int64_t**);
 
 class CinnJitInstruction::FnPtrImpl {
   using CINNKernelInfo = cinn::hlir::framework::pir::CINNKernelInfo;
+  using ShapeBucketProfile = cinn::hlir::framework::pir::ShapeBucketProfile;
 
  public:
   explicit FnPtrImpl(const CINNKernelInfo& cinn_kernel_info)
@@ -47,6 +49,18 @@ class CinnJitInstruction::FnPtrImpl {
     VLOG(6) << "Start Run: " << cinn_kernel_info_.fn_name;
     func_args_.clear();
 
+    // 0. Look up the kernel specialized for the shape bucket of the call,
+    // falling back to the generic kernel.
+    void* fn_ptr = cinn_kernel_info_.fn_ptr;
+    const auto* int_args_map = &cinn_kernel_info_.int_args_map;
+    const auto* kernel =
+        is_gpu ? LookupSpecializedKernel(kernel_args) : nullptr;
+    if (kernel != nullptr) {
+      VLOG(6) << "Run the kernel specialized for the shape bucket";
+      fn_ptr = kernel->fn_ptr;
+      int_args_map = &kernel->int_args_map;
+    }
+
     // 1. Convert the phi::DenseTensor type to cinn_pod_value_t
     for (size_t i = 0; i < kernel_args.size(); ++i) {
       auto* buffer = new cinn_buffer_t();
@@ -54,7 +68,7 @@ class CinnJitInstruction::FnPtrImpl {
       func_args_.emplace_back(buffer);
     }
     // 2. Convert arg's data about shape of Tensor to cinn_pod_value_t
-    for (const auto& int_arg_mp : cinn_kernel_info_.int_args_map) {
+    for (const auto& int_arg_mp : *int_args_map) {
       func_args_.emplace_back(static_cast<int64_t>(
           kernel_args[int_arg_mp.second.arg_idx]->dims().at(
               int_arg_mp.second.dim_idx)));
@@ -84,7 +98,7 @@ class CinnJitInstruction::FnPtrImpl {
         cudaGraphExec_t instance;
         cudaStreamBeginCapture(stream, cudaStreamCaptureModeGlobal);
         for (int ikrnl = 0; ikrnl < graph_nodes_num; ikrnl++) {
-          ((lower_func_ptr_g)cinn_kernel_info_.fn_ptr)(
+          ((lower_func_ptr_g)fn_ptr)(
               static_cast<void*>(func_args_.data()), func_args_.size(), stream);
         }
         cudaStreamEndCapture(stream, &graph);
@@ -102,7 +116,7 @@ class CinnJitInstruction::FnPtrImpl {
       cudaDeviceSynchronize();
     } else {
       if (is_gpu) {
-        ((lower_func_ptr_g)cinn_kernel_info_.fn_ptr)(
+        ((lower_func_ptr_g)fn_ptr)(
             static_cast<void*>(func_args_.data()), func_args_.size(), stream);
       } else {
         ((lower_func_ptr_g)cinn_kernel_info_.CX86_fn_ptr)(
@@ -163,9 +177,33 @@ class CinnJitInstruction::FnPtrImpl {
   }
 
  private:
+  // Look up the kernel specialized for the values of the symbolic input dims,
+  // and record them into the shape bucket profile.
+  const CINNKernelInfo::SpecializedKernel* LookupSpecializedKernel(
+      const std::vector<phi::DenseTensor*>& kernel_args) {
+    const auto& bucket_dims = cinn_kernel_info_.bucket_dims;
+    if (bucket_dims.empty()) {
+      return nullptr;
+    }
+    dim_values_.resize(bucket_dims.size());
+    for (size_t i = 0; i < bucket_dims.size(); ++i) {
+      dim_values_[i] = kernel_args[bucket_dims[i].arg_idx]->dims().at(
+          bucket_dims[i].dim_idx);
+    }
+    ShapeBucketProfile::Instance().Record(cinn_kernel_info_.bucket_key,
+                                          dim_values_);
+    for (const auto& kernel : cinn_kernel_info_.specialized_kernels) {
+      if (kernel.dim_values == dim_values_) {
+        return &kernel;
+      }
+    }
+    return nullptr;
+  }
+
   CINNKernelInfo cinn_kernel_info_;
 
   std::vector<cinn_pod_value_t> func_args_;
+  std::vector<int64_t> dim_values_;
 };
 
 CinnJitInstruction::CinnJitInstruction(
@@ -34,13 +34,15 @@
 #include "paddle/fluid/framework/new_executor/pir_adaptor/pir_adaptor_util.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/pir/include/core/block_argument.h"
-#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/common/flags.h"
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/fluid/platform/collective_helper.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/distributed/nccl_comm_context.h"
 COMMON_DECLARE_bool(dynamic_static_unified_comm);
 #endif
+COMMON_DECLARE_bool(pir_interpreter_reuse_infer_meta);
+COMMON_DECLARE_bool(new_executor_xpu_multi_stream);
 
 namespace paddle::framework {
 
@@ -73,9 +75,10 @@ phi::DeviceContext* ParseDeviceContext(pir::Operation* op,
 
   phi::DeviceContext* dev_ctx = nullptr;
 
-  // only gpu need update. xpu not need, because xpu memcpy op kernel is
-  // synchronous.
-  if (phi::is_gpu_place(place) || phi::is_custom_place(place)) {
+  // only gpu need update. xpu not need unless multi-stream is enabled,
+  // because xpu memcpy op kernel is synchronous.
+  if (phi::is_gpu_place(place) || phi::is_custom_place(place) ||
+      (phi::is_xpu_place(place) && FLAGS_new_executor_xpu_multi_stream)) {
     VLOG(6) << "Parse DeviceContext for " << op_name
             << ", execution stream = " << execution_stream;
     if (execution_stream != kDefaultStream) {
@@ -529,4 +532,97 @@ void ShareVarBuffer(const Variable* src_var, Variable* dst_var) {
   return;
 }
 
+bool InferMetaCache::Meta::operator==(const Meta& other) const {
+  return present == other.present && dims == other.dims &&
+         strides == other.strides && dtype == other.dtype &&
+         layout == other.layout;
+}
+
+InferMetaCache::Meta InferMetaCache::GetMeta(
+    const phi::MetaTensor& meta_tensor) {
+  Meta meta;
+  if (!!meta_tensor) {
+    meta.present = true;
+    meta.dims = meta_tensor.dims();
+    meta.strides = meta_tensor.strides();
+    meta.dtype = meta_tensor.dtype();
+    meta.layout = meta_tensor.layout();
+  }
+  return meta;
+}
+
+void InferMetaCache::Init(const phi::InferMetaContext& infer_meta_ctx) {
+  // the outputs are only read
+  auto& ctx = const_cast<phi::InferMetaContext&>(infer_meta_ctx);
+  supported_ = FLAGS_pir_interpreter_reuse_infer_meta;
+  for (size_t i = 0; supported_ && i < ctx.AttrsSize(); ++i) {
+    const auto& attr = ctx.AttrAt(i);
+    if (paddle::holds_alternative<phi::TensorRef>(attr) ||
+        paddle::holds_alternative<std::vector<phi::TensorRef>>(attr)) {
+      supported_ = false;
+    }
+  }
+  for (size_t i = 0; supported_ && i < ctx.InputsSize(); ++i) {
+    const auto& input = ctx.InputAt(i);
+    supported_ = !input || input.is_dense();
+  }
+  for (size_t i = 0; supported_ && i < ctx.OutputsSize(); ++i) {
+    const auto* output = ctx.MutableOutputAt(i);
+    supported_ = output == nullptr || !*output || output->is_dense();
+  }
+  valid_ = false;
+}
+
+bool InferMetaCache::Hit(const phi::InferMetaContext& infer_meta_ctx,
+                         const phi::KernelContext& kernel_ctx) const {
+  if (!valid_) {
+    return false;
+  }
+  // the outputs are only read
+  auto& ctx = const_cast<phi::InferMetaContext&>(infer_meta_ctx);
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    if (!(GetMeta(ctx.InputAt(i)) == inputs_[i])) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    const auto* output = ctx.MutableOutputAt(i);
+    if (!(GetMeta(output ? *output : phi::MetaTensor()) == outputs_[i])) {
+      return false;
+    }
+  }
+  // the LoD of the outputs is shared from the inputs by InferMeta
+  for (size_t i = 0; i < kernel_ctx.InputsSize(); ++i) {
+    const auto* input = kernel_ctx.MutableIutputAt(i);
+    if (input != nullptr && phi::DenseTensor::classof(input) &&
+        !static_cast<const phi::DenseTensor*>(input)->lod().empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void InferMetaCache::SaveInputs(const phi::InferMetaContext& infer_meta_ctx) {
+  if (!supported_) {
+    return;
+  }
+  inputs_.resize(infer_meta_ctx.InputsSize());
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    inputs_[i] = GetMeta(infer_meta_ctx.InputAt(i));
+  }
+  valid_ = false;
+}
+
+void InferMetaCache::SaveOutputs(phi::InferMetaContext* infer_meta_ctx) {
+  if (!supported_) {
+    return;
+  }
+  outputs_.resize(infer_meta_ctx->OutputsSize());
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    const auto* output = infer_meta_ctx->MutableOutputAt(i);
+    outputs_[i] = GetMeta(output ? *output : phi::MetaTensor());
+  }
+  valid_ = true;
+}
+
 }  // namespace paddle::framework
@@ -22,6 +22,8 @@
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/phi/api/profiler/event.h"
+#include "paddle/phi/core/infermeta_utils.h"
+#include "paddle/phi/core/kernel_context.h"
 #include "paddle/pir/include/core/builtin_attribute.h"
 #include "paddle/pir/include/core/operation.h"
 #include "paddle/pir/include/core/value.h"
@@ -68,5 +70,41 @@ void HandleForInplaceOp(pir::Operation* op,
                         InstructionBase* instr);
 
 void ShareVarBuffer(const Variable* src_var, Variable* dst_var);
+
+// The metas of the inputs and outputs of an instruction when its InferMeta
+// last ran. InferMeta only depends on the input metas and the attributes,
+// so it is skipped while the metas are unchanged, and the outputs keep the
+// metas and the allocations of the last run. Instructions with an attribute
+// read from a tensor or a tensor which is not dense are never skipped, and
+// neither are the runs with an input carrying LoD.
+class InferMetaCache {
+ public:
+  void Init(const phi::InferMetaContext& infer_meta_ctx);
+
+  bool Hit(const phi::InferMetaContext& infer_meta_ctx,
+           const phi::KernelContext& kernel_ctx) const;
+
+  // Called before InferMeta runs, and after the kernel runs respectively.
+  void SaveInputs(const phi::InferMetaContext& infer_meta_ctx);
+  void SaveOutputs(phi::InferMetaContext* infer_meta_ctx);
+
+ private:
+  struct Meta {
+    bool present{false};
+    phi::DDim dims;
+    phi::DDim strides;
+    phi::DataType dtype{phi::DataType::UNDEFINED};
+    phi::DataLayout layout{phi::DataLayout::UNDEFINED};
+
+    bool operator==(const Meta& other) const;
+  };
+
+  static Meta GetMeta(const phi::MetaTensor& meta_tensor);
+
+  bool supported_{false};
+  bool valid_{false};
+  std::vector<Meta> inputs_;
+  std::vector<Meta> outputs_;
+};
 }  // namespace framework
 }  // namespace paddle
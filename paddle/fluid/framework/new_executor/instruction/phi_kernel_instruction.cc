@@ -125,6 +125,7 @@ PhiKernelInstruction::PhiKernelInstruction(
         paddle::small_vector<phi::MetaTensor, phi::kInputSmallVectorSize>,
         paddle::small_vector<phi::MetaTensor, phi::kInputSmallVectorSize>,
         false>(op, *value_exec_info_, yaml_info_parser, &infer_meta_context_);
+    infer_meta_cache_.Init(infer_meta_context_);
   }
   VLOG(6) << "finish process infer meta context";
 
@@ -180,10 +181,14 @@ PhiKernelInstruction::~PhiKernelInstruction() { delete phi_kernel_; }
 
 void PhiKernelInstruction::Run() {
   VLOG(6) << "Begin run op " << phi_op_name_ << " infer meta.";
-  if (infer_meta_interface_) {
+  const bool reuse_infer_meta =
+      infer_meta_interface_ == nullptr ||
+      infer_meta_cache_.Hit(infer_meta_context_, kernel_context_);
+  if (!reuse_infer_meta) {
     phi::RecordEvent record_event("PhiKernelInstruction::infermeta",
                                   platform::TracerEventType::UserDefined,
                                   1);
+    infer_meta_cache_.SaveInputs(infer_meta_context_);
     infer_meta_interface_->infer_meta_(&(infer_meta_context_));
   }
   VLOG(6) << "End run op " << phi_op_name_ << " infer meta.";
@@ -197,6 +202,10 @@ void PhiKernelInstruction::Run() {
                                   1);
     (*(phi_kernel_))(&(kernel_context_));
   }
+  if (!reuse_infer_meta) {
+    // the kernel may still reset the dims of its outputs
+    infer_meta_cache_.SaveOutputs(&infer_meta_context_);
+  }
 
   VLOG(6) << "End run op " << phi_op_name_ << " kernel.";
 }
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/instruction/instruction_util.h"
 
 namespace pir {
 class Operation;
@@ -58,6 +59,8 @@ class PhiKernelInstruction : public InstructionBase {
 
   phi::InferMetaContext infer_meta_context_;
 
+  InferMetaCache infer_meta_cache_;
+
   phi::KernelContext kernel_context_;
 
   phi::Kernel* phi_kernel_{nullptr};  // not owned
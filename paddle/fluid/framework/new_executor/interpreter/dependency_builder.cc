@@ -648,6 +648,14 @@ void PirDependencyBuilder::AddDependencyForRandomOp() {
 
 const std::map<size_t, std::set<size_t>>& PirDependencyBuilder::Build(
     std::vector<paddle::framework::InstructionBase*> instructions) {
+  return BuildWithPrefix(instructions, 0, {});
+}
+
+const std::map<size_t, std::set<size_t>>&
+PirDependencyBuilder::BuildWithPrefix(
+    std::vector<paddle::framework::InstructionBase*> instructions,
+    size_t prefix_num,
+    const std::map<size_t, std::set<size_t>>& prefix_downstream_map) {
   if (is_build_) {
     return *op_downstream_map_;
   }
@@ -661,8 +669,37 @@ const std::map<size_t, std::set<size_t>>& PirDependencyBuilder::Build(
   ops_behind_.assign(op_num_, {});
   op_happens_before_->assign(op_num_, std::vector<bool>(op_num_, false));
 
-  BuildDownstreamMap();
-  VLOG(6) << "Finish BuildDownstreamMap";
+  // the prefix dependencies point forward within the prefix, so its
+  // happens-before is filled backwards one row at a time as in BuildFrom
+  prefix_num = std::min(prefix_num, op_num_);
+  *op_downstream_map_ = prefix_downstream_map;
+  for (size_t i = prefix_num; i-- > 0;) {
+    auto iter = op_downstream_map_->find(i);
+    if (iter == op_downstream_map_->end()) {
+      continue;
+    }
+    std::vector<bool>& row = (*op_happens_before_)[i];
+    for (size_t next : iter->second) {
+      row[next] = true;
+      const std::vector<bool>& next_row = (*op_happens_before_)[next];
+      for (size_t j = next + 1; j < prefix_num; ++j) {
+        if (next_row[j]) {
+          row[j] = true;
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i < prefix_num; ++i) {
+    for (size_t j = i + 1; j < prefix_num; ++j) {
+      if ((*op_happens_before_)[i][j]) {
+        ops_before_[j].push_back(i);
+        ops_behind_[i].push_back(j);
+      }
+    }
+  }
+
+  BuildDownstreamMap(prefix_num);
+  VLOG(6) << "Finish BuildDownstreamMap from " << prefix_num;
 
   ShrinkDownstreamMap();
   VLOG(6) << "Finish ShrinkDownstreamMap";
@@ -690,7 +727,46 @@ const std::map<size_t, std::set<size_t>>& PirDependencyBuilder::Build(
   return *op_downstream_map_;
 }
 
-void PirDependencyBuilder::BuildDownstreamMap() {
+const std::map<size_t, std::set<size_t>>& PirDependencyBuilder::BuildFrom(
+    std::vector<paddle::framework::InstructionBase*> instructions,
+    const std::map<size_t, std::set<size_t>>& downstream_map) {
+  if (is_build_) {
+    return *op_downstream_map_;
+  }
+
+  std::tie(op_downstream_map_, op_happens_before_) = GetDependency();
+
+  instructions_ = instructions;
+  op_num_ = instructions_.size();
+  *op_downstream_map_ = downstream_map;
+
+  // happens-before is the transitive closure of the downstream map, whose
+  // edges always point forward, so fill it backwards one row at a time
+  op_happens_before_->assign(op_num_, std::vector<bool>(op_num_, false));
+  for (size_t i = op_num_; i-- > 0;) {
+    auto iter = op_downstream_map_->find(i);
+    if (iter == op_downstream_map_->end()) {
+      continue;
+    }
+    std::vector<bool>& row = (*op_happens_before_)[i];
+    for (size_t next : iter->second) {
+      row[next] = true;
+      const std::vector<bool>& next_row = (*op_happens_before_)[next];
+      for (size_t j = next + 1; j < op_num_; ++j) {
+        if (next_row[j]) {
+          row[j] = true;
+        }
+      }
+    }
+  }
+
+  VLOG(6) << "Finish build dependency from downstream map";
+  is_build_ = true;
+
+  return *op_downstream_map_;
+}
+
+void PirDependencyBuilder::BuildDownstreamMap(size_t start_idx) {
   auto var2min_rw_op =
       std::map<size_t, std::list<size_t>>();  // # map from variable id to read
                                               //  write op id.
@@ -758,6 +834,9 @@ void PirDependencyBuilder::BuildDownstreamMap() {
   // since there are some ops that have no downstream-op.
   for (auto& item : op2dependences) {
     size_t op = item.first;
+    if (op < start_idx) {
+      continue;
+    }
     for (auto dep_op : item.second) {
       AddDownstreamOp(dep_op, op);
     }
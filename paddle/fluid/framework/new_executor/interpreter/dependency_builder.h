@@ -120,7 +120,21 @@ class PirDependencyBuilder : public DependencyBuilder {
   const std::map<size_t, std::set<size_t>>& Build(
       std::vector<paddle::framework::InstructionBase*> instructions);
 
-  void BuildDownstreamMap();
+  // restore the result of Build from its downstream map
+  const std::map<size_t, std::set<size_t>>& BuildFrom(
+      std::vector<paddle::framework::InstructionBase*> instructions,
+      const std::map<size_t, std::set<size_t>>& downstream_map);
+
+  // same as Build, but restore the dependencies among the first prefix_num
+  // instructions from `prefix_downstream_map`, e.g. the ones built for an
+  // instruction list which only differs after them, and build the others
+  const std::map<size_t, std::set<size_t>>& BuildWithPrefix(
+      std::vector<paddle::framework::InstructionBase*> instructions,
+      size_t prefix_num,
+      const std::map<size_t, std::set<size_t>>& prefix_downstream_map);
+
+  // add the dependencies of the instructions from start_idx on
+  void BuildDownstreamMap(size_t start_idx = 0);
 
   void ShareDependencyFrom(const PirDependencyBuilder& src);
 
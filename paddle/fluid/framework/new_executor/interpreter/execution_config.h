@@ -31,6 +31,10 @@ struct ExecutionConfig {
   bool used_for_control_flow_op{false};
   bool used_for_jit{false};
   bool used_for_inference{false};
+  // Run the small cpu programs of inference with the least overhead: from the
+  // second run on, the instructions are called in a flat list without the
+  // per instruction bookkeeping, and the intermediate tensors are kept.
+  bool used_for_low_latency{false};
 
   size_t device_num_threads{0};
   size_t host_num_threads{0};
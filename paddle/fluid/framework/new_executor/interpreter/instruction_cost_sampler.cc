@@ -0,0 +1,223 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/instruction_cost_sampler.h"
+
+#include <cmath>
+#include <sstream>
+#include <tuple>
+
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/phi/core/enforce.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/cuda/cuda_graph_with_memory_pool.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/backends/gpu/gpu_types.h"
+#endif
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+void CostHistogram::Add(double us) {
+  size_t i = 0;
+  while (i + 1 < kBucketNum && us >= BucketBound(i)) {
+    ++i;
+  }
+  ++buckets[i];
+  ++count;
+  sum_us += us;
+}
+
+double CostHistogram::BucketBound(size_t i) {
+  return i + 1 < kBucketNum ? std::ldexp(1., static_cast<int>(i)) : INFINITY;
+}
+
+InstructionCostSampler& InstructionCostSampler::Instance() {
+  // leaked on purpose, since the pooled events can not be destroyed after the
+  // device runtime is unloaded at exit
+  static InstructionCostSampler* sampler = new InstructionCostSampler();
+  return *sampler;
+}
+
+void InstructionCostSampler::AddHostCost(const std::string& op_name,
+                                         double us) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  costs_[op_name].host.Add(us);
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+std::pair<gpuEvent_t, gpuEvent_t> InstructionCostSampler::AcquireEvents(
+    int device_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& events = event_pool_[device_id];
+  while (events.size() < 2) {
+    phi::backends::gpu::GPUDeviceGuard device_guard(device_id);
+    gpuEvent_t event;
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventCreateWithFlags(&event, 0));
+    events.push_back(event);
+  }
+  gpuEvent_t start = events.back();
+  events.pop_back();
+  gpuEvent_t stop = events.back();
+  events.pop_back();
+  return {start, stop};
+}
+
+void InstructionCostSampler::AddDeviceCost(const std::string& op_name,
+                                           int device_id,
+                                           gpuEvent_t start,
+                                           gpuEvent_t stop) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  pending_.push_back({op_name, device_id, start, stop});
+}
+#endif
+
+void InstructionCostSampler::Collect() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  CollectLocked();
+}
+
+void InstructionCostSampler::CollectLocked() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  size_t num_pending = 0;
+  for (size_t i = 0; i < pending_.size(); ++i) {
+    auto& pending = pending_[i];
+    const auto status = phi::gpuEventQuery(pending.stop);
+    if (status == phi::gpuErrorNotReady) {
+      if (num_pending != i) {
+        pending_[num_pending] = std::move(pending);
+      }
+      ++num_pending;
+      continue;
+    }
+    // a failed sample is dropped rather than failing the query
+    float ms = 0.f;
+#ifdef PADDLE_WITH_HIP
+    if (status == phi::gpuSuccess &&
+        hipEventElapsedTime(&ms, pending.start, pending.stop) == hipSuccess) {
+#else
+    if (status == phi::gpuSuccess &&
+        cudaEventElapsedTime(&ms, pending.start, pending.stop) == cudaSuccess) {
+#endif
+      costs_[pending.op_name].device.Add(ms * 1000.);
+    }
+    auto& events = event_pool_[pending.device_id];
+    events.push_back(pending.start);
+    events.push_back(pending.stop);
+  }
+  pending_.resize(num_pending);
+#endif
+}
+
+std::map<std::string, OpCost> InstructionCostSampler::Snapshot() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  CollectLocked();
+  return costs_;
+}
+
+std::string InstructionCostSampler::DumpPrometheus() {
+  const auto costs = Snapshot();
+  std::ostringstream os;
+  os.precision(9);
+  const auto Dump = [&](const char* kind, auto get_histogram) {
+    const std::string metric =
+        std::string("paddle_instruction_") + kind + "_seconds";
+    os << "# HELP " << metric << " The sampled " << kind
+       << " cost of the instructions.\n";
+    os << "# TYPE " << metric << " histogram\n";
+    for (const auto& [op_name, cost] : costs) {
+      const CostHistogram& histogram = get_histogram(cost);
+      if (histogram.count == 0) {
+        continue;
+      }
+      const std::string label = "op=\"" + op_name + "\"";
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < CostHistogram::kBucketNum; ++i) {
+        cumulative += histogram.buckets[i];
+        os << metric << "_bucket{" << label << ",le=\"";
+        if (i + 1 < CostHistogram::kBucketNum) {
+          os << CostHistogram::BucketBound(i) * 1e-6;
+        } else {
+          os << "+Inf";
+        }
+        os << "\"} " << cumulative << "\n";
+      }
+      os << metric << "_sum{" << label << "} " << histogram.sum_us * 1e-6
+         << "\n";
+      os << metric << "_count{" << label << "} " << histogram.count << "\n";
+    }
+  };
+  Dump("host", [](const OpCost& cost) -> const CostHistogram& {
+    return cost.host;
+  });
+  Dump("device", [](const OpCost& cost) -> const CostHistogram& {
+    return cost.device;
+  });
+  return os.str();
+}
+
+void InstructionCostSampler::Reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  CollectLocked();
+  costs_.clear();
+}
+
+InstructionCostGuard::InstructionCostGuard(const InstructionBase* instr)
+    : instr_(instr) {
+  if (instr_ == nullptr) {
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the events recorded in a capturing stream would become graph nodes
+  const phi::Place& place = instr_->DeviceContext().GetPlace();
+  if (phi::is_gpu_place(place) &&
+      !phi::backends::gpu::IsCUDAGraphCapturing()) {
+    device_id_ = place.GetDeviceId();
+    stream_ =
+        reinterpret_cast<const phi::GPUContext&>(instr_->DeviceContext())
+            .stream();
+    std::tie(start_event_, stop_event_) =
+        InstructionCostSampler::Instance().AcquireEvents(device_id_);
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventRecord(start_event_, stream_));
+  }
+#endif
+  start_ = std::chrono::steady_clock::now();
+}
+
+InstructionCostGuard::~InstructionCostGuard() {
+  if (instr_ == nullptr) {
+    return;
+  }
+  const double us = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - start_)
+                        .count();
+  auto& sampler = InstructionCostSampler::Instance();
+  sampler.AddHostCost(instr_->Name(), us);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (start_event_ != nullptr) {
+    // not enforced, since a destructor must not throw
+    if (phi::gpuEventRecord(stop_event_, stream_) == phi::gpuSuccess) {
+      sampler.AddDeviceCost(
+          instr_->Name(), device_id_, start_event_, stop_event_);
+    }
+  }
+#endif
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,131 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/utils/test_macros.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#endif
+
+namespace paddle {
+namespace framework {
+class InstructionBase;
+
+namespace interpreter {
+
+// A histogram of the costs in microseconds, the i-th bucket counts the costs
+// in [2^(i-1), 2^i) and the last one counts the rest.
+struct CostHistogram {
+  static constexpr size_t kBucketNum = 22;
+
+  uint64_t count = 0;
+  double sum_us = 0.;
+  std::array<uint64_t, kBucketNum> buckets{};
+
+  void Add(double us);
+  // the upper bound of the i-th bucket in microseconds
+  static double BucketBound(size_t i);
+};
+
+struct OpCost {
+  CostHistogram host;
+  CostHistogram device;
+};
+
+// The process wide histograms of the sampled instruction costs, keyed by the
+// op name. The host cost is the wall time to launch an instruction, and the
+// device cost is the time between a pair of events recorded on its stream
+// around it, which is read later when the events are completed, so sampling
+// never synchronizes a stream.
+class TEST_API InstructionCostSampler {
+ public:
+  static InstructionCostSampler& Instance();
+
+  void AddHostCost(const std::string& op_name, double us);
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // Take a pair of events from the pool, they are given back in Collect.
+  std::pair<gpuEvent_t, gpuEvent_t> AcquireEvents(int device_id);
+  void AddDeviceCost(const std::string& op_name,
+                     int device_id,
+                     gpuEvent_t start,
+                     gpuEvent_t stop);
+#endif
+
+  // Read the device costs of the completed event pairs.
+  void Collect();
+
+  std::map<std::string, OpCost> Snapshot();
+
+  // The histograms in the Prometheus text exposition format.
+  std::string DumpPrometheus();
+
+  void Reset();
+
+ private:
+  InstructionCostSampler() = default;
+  DISABLE_COPY_AND_ASSIGN(InstructionCostSampler);
+
+  void CollectLocked();
+
+  std::mutex mutex_;
+  std::map<std::string, OpCost> costs_;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  struct PendingEvents {
+    std::string op_name;
+    int device_id;
+    gpuEvent_t start;
+    gpuEvent_t stop;
+  };
+  std::vector<PendingEvents> pending_;
+  std::map<int, std::vector<gpuEvent_t>> event_pool_;
+#endif
+};
+
+// Sample the cost of running an instruction within its lifetime, or nothing
+// if instr is nullptr.
+class InstructionCostGuard {
+ public:
+  explicit InstructionCostGuard(const InstructionBase* instr);
+  ~InstructionCostGuard();
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(InstructionCostGuard);
+
+  const InstructionBase* instr_;
+  std::chrono::steady_clock::time_point start_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  int device_id_ = -1;
+  gpuStream_t stream_ = nullptr;
+  gpuEvent_t start_event_ = nullptr;
+  gpuEvent_t stop_event_ = nullptr;
+#endif
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
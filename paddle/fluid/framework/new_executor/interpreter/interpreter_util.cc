@@ -52,6 +52,7 @@ COMMON_DECLARE_bool(use_mkldnn);
 COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_string(static_runtime_data_save_path);
 COMMON_DECLARE_bool(save_static_runtime_data);
+COMMON_DECLARE_bool(new_executor_numa_aware);
 
 namespace paddle::framework::interpreter {
 
@@ -100,6 +101,7 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  group_options.back().numa_aware = FLAGS_new_executor_numa_aware;
   // for launch device Kernel
   group_options.emplace_back(/*name*/ "DeviceKernelLaunch",
                              /*num_threads*/ device_num_threads,
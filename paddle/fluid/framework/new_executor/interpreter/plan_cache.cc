@@ -0,0 +1,321 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/plan_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+
+COMMON_DECLARE_string(pir_interpreter_plan_cache_dir);
+PD_DECLARE_bool(new_executor_sequential_run);
+PD_DECLARE_bool(add_dependency_for_communication_op);
+
+namespace paddle::framework::interpreter {
+
+namespace {
+
+constexpr uint64_t kPlanMagic = 0x32304e414c504450ULL;  // "PDPLAN02"
+
+// FNV-1a, std::hash is not guaranteed to be stable across builds
+uint64_t Fnv1a(const void* data, size_t size, uint64_t hash) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// the bytes of the fields an instruction signature covers
+class Signature {
+ public:
+  void Add(uint64_t value) {
+    bytes_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void Add(const std::string& str) {
+    Add(str.size());
+    bytes_.append(str);
+  }
+  std::string Release() { return std::move(bytes_); }
+
+ private:
+  std::string bytes_;
+};
+
+// variable ids of `vars` sorted, each flagged by whether it is in
+// `no_need_buffer`: unordered_map order differs between processes
+std::vector<uint64_t> SortedVarIds(
+    const std::unordered_map<::pir::Value, std::vector<int>>& vars,
+    const std::unordered_set<::pir::Value>& no_need_buffer) {
+  std::vector<uint64_t> ids;
+  for (auto& item : vars) {
+    uint64_t flag = no_need_buffer.count(item.first) ? 1ULL << 63 : 0;
+    for (int id : item.second) {
+      ids.push_back(static_cast<uint32_t>(id) | flag);
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+std::string PlanPath(uint64_t key) {
+  return FLAGS_pir_interpreter_plan_cache_dir + "/" + std::to_string(key) +
+         ".plan";
+}
+
+void AddFlags(Signature* signature) {
+  signature->Add(static_cast<uint64_t>(FLAGS_new_executor_sequential_run));
+  signature->Add(
+      static_cast<uint64_t>(FLAGS_add_dependency_for_communication_op));
+}
+
+// device contexts are identified by the order they first appear in
+void AddInstruction(
+    const InstructionBase& instr,
+    std::map<const phi::DeviceContext*, uint64_t>* dev_ctx_ids,
+    Signature* signature) {
+  const std::unordered_set<::pir::Value> no_outputs;
+  signature->Add(std::string(typeid(instr).name()));
+  signature->Add(instr.Name());
+  signature->Add(static_cast<uint64_t>(instr.KernelType()));
+  const phi::DeviceContext* dev_ctx = &instr.DeviceContext();
+  auto iter = dev_ctx_ids->emplace(dev_ctx, dev_ctx_ids->size()).first;
+  signature->Add(iter->second);
+  signature->Add(static_cast<uint64_t>(dev_ctx->GetPlace().GetType()));
+  for (uint64_t id : SortedVarIds(instr.Inputs(), instr.NoNeedBuffer())) {
+    signature->Add(id);
+  }
+  signature->Add(~0ULL);
+  for (uint64_t id : SortedVarIds(instr.Outputs(), no_outputs)) {
+    signature->Add(id);
+  }
+  signature->Add(~0ULL);
+}
+
+struct CachedDependency {
+  std::vector<std::string> signatures;
+  std::map<size_t, std::set<size_t>> downstream_map;
+};
+
+constexpr size_t kMaxCachedDependencies = 16;
+
+std::mutex dependency_cache_mutex;
+// the most recently used first
+std::list<CachedDependency> dependency_cache;
+
+}  // namespace
+
+std::vector<std::string> InstructionSignatures(
+    const std::vector<std::unique_ptr<InstructionBase>>& instructions) {
+  std::vector<std::string> signatures;
+  signatures.reserve(instructions.size());
+  std::map<const phi::DeviceContext*, uint64_t> dev_ctx_ids;
+  for (auto& instr : instructions) {
+    Signature signature;
+    AddFlags(&signature);
+    AddInstruction(*instr, &dev_ctx_ids, &signature);
+    signatures.push_back(signature.Release());
+  }
+  return signatures;
+}
+
+uint64_t InterpreterPlanKey(const std::vector<std::string>& signatures) {
+  uint64_t hash = Fnv1a(&kPlanMagic, sizeof(kPlanMagic), 0xcbf29ce484222325ULL);
+  for (auto& signature : signatures) {
+    uint64_t size = signature.size();
+    hash = Fnv1a(&size, sizeof(size), hash);
+    hash = Fnv1a(signature.data(), signature.size(), hash);
+  }
+  return hash;
+}
+
+size_t FindDependencyPrefix(
+    const std::vector<std::string>& signatures,
+    std::map<size_t, std::set<size_t>>* prefix_downstream_map) {
+  std::lock_guard<std::mutex> guard(dependency_cache_mutex);
+  auto best = dependency_cache.end();
+  size_t best_num = 0;
+  for (auto iter = dependency_cache.begin(); iter != dependency_cache.end();
+       ++iter) {
+    auto mismatch = std::mismatch(signatures.begin(),
+                                  signatures.end(),
+                                  iter->signatures.begin(),
+                                  iter->signatures.end());
+    size_t num = mismatch.first - signatures.begin();
+    if (num > best_num) {
+      best = iter;
+      best_num = num;
+    }
+  }
+  prefix_downstream_map->clear();
+  if (best == dependency_cache.end()) {
+    return 0;
+  }
+  for (auto& item : best->downstream_map) {
+    if (item.first >= best_num) {
+      break;
+    }
+    for (size_t posterior : item.second) {
+      if (posterior < best_num) {
+        (*prefix_downstream_map)[item.first].insert(posterior);
+      }
+    }
+  }
+  dependency_cache.splice(dependency_cache.begin(), dependency_cache, best);
+  VLOG(4) << "Reuse the dependencies of " << best_num << " of "
+          << signatures.size() << " instructions";
+  return best_num;
+}
+
+void RememberDependency(
+    const std::vector<std::string>& signatures,
+    const std::map<size_t, std::set<size_t>>& downstream_map) {
+  std::lock_guard<std::mutex> guard(dependency_cache_mutex);
+  for (auto iter = dependency_cache.begin(); iter != dependency_cache.end();
+       ++iter) {
+    if (iter->signatures == signatures) {
+      dependency_cache.splice(dependency_cache.begin(), dependency_cache, iter);
+      return;
+    }
+  }
+  dependency_cache.push_front({signatures, downstream_map});
+  if (dependency_cache.size() > kMaxCachedDependencies) {
+    dependency_cache.pop_back();
+  }
+}
+
+bool LoadInterpreterPlan(uint64_t key,
+                         const std::vector<std::string>& signatures,
+                         InterpreterPlan* plan) {
+  std::ifstream fin(PlanPath(key), std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  auto read = [&fin]() {
+    uint64_t value = 0;
+    fin.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  };
+  const size_t instr_num = signatures.size();
+  bool matched = read() == kPlanMagic && read() == key && read() == instr_num;
+  // the key is only a hash, the plan is for the same instructions only if
+  // all their signatures match
+  std::string saved;
+  for (size_t i = 0; matched && i < instr_num; ++i) {
+    uint64_t size = read();
+    matched = fin && size == signatures[i].size();
+    if (matched) {
+      saved.resize(size);
+      fin.read(&saved[0], size);
+      matched = fin && saved == signatures[i];
+    }
+  }
+  if (!matched) {
+    LOG(WARNING) << "Ignore mismatched interpreter plan " << PlanPath(key);
+    return false;
+  }
+  plan->instr_num = instr_num;
+  plan->downstream_map.clear();
+  plan->events.clear();
+  // dependencies always point forward in the instruction list
+  for (uint64_t edge_num = read(); fin && edge_num > 0; --edge_num) {
+    uint64_t prior = read();
+    uint64_t posterior = read();
+    if (prior >= posterior || posterior >= instr_num) {
+      fin.setstate(std::ios::failbit);
+      break;
+    }
+    plan->downstream_map[prior].insert(posterior);
+  }
+  for (uint64_t event_num = read(); fin && event_num > 0; --event_num) {
+    uint64_t waiter = read();
+    uint64_t recorder = read();
+    if (waiter >= 2 * instr_num || recorder >= 2 * instr_num) {
+      fin.setstate(std::ios::failbit);
+      break;
+    }
+    plan->events.emplace_back(waiter, recorder);
+  }
+  if (!fin) {
+    LOG(WARNING) << "Ignore corrupted interpreter plan " << PlanPath(key);
+    return false;
+  }
+  VLOG(4) << "Load interpreter plan " << PlanPath(key);
+  return true;
+}
+
+void SaveInterpreterPlan(uint64_t key,
+                         const std::vector<std::string>& signatures,
+                         const InterpreterPlan& plan) {
+  uint64_t edge_num = 0;
+  for (auto& item : plan.downstream_map) {
+    edge_num += item.second.size();
+  }
+
+  // written aside and renamed, so concurrent readers never see a partial
+  // plan
+  std::string path = PlanPath(key);
+  std::string tmp_path =
+      path + ".tmp" +
+      std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  {
+    std::ofstream fout(tmp_path, std::ios::binary | std::ios::trunc);
+    auto write = [&fout](uint64_t value) {
+      fout.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    write(kPlanMagic);
+    write(key);
+    write(signatures.size());
+    for (auto& signature : signatures) {
+      write(signature.size());
+      fout.write(signature.data(), signature.size());
+    }
+    write(edge_num);
+    for (auto& item : plan.downstream_map) {
+      for (size_t posterior : item.second) {
+        write(item.first);
+        write(posterior);
+      }
+    }
+    write(plan.events.size());
+    for (auto& event : plan.events) {
+      write(event.first);
+      write(event.second);
+    }
+    if (!fout) {
+      LOG(WARNING) << "Unable to write interpreter plan " << tmp_path;
+      fout.close();
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Unable to write interpreter plan " << path;
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  VLOG(4) << "Save interpreter plan " << path;
+}
+
+}  // namespace paddle::framework::interpreter
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+class InstructionBase;
+namespace interpreter {
+
+// The analysis results of PirInterpreter::PreAnalysis that only depend on
+// the instruction list, persisted under FLAGS_pir_interpreter_plan_cache_dir
+// so that other processes running the same program skip recomputing them.
+struct InterpreterPlan {
+  size_t instr_num = 0;
+  // instr_id -> downstream instr_ids, as built by PirDependencyBuilder
+  std::map<size_t, std::set<size_t>> downstream_map;
+  // (waiter, recorder) pairs of the cross step merged instruction list,
+  // as built by PirStreamAnalyzer
+  std::vector<std::pair<size_t, size_t>> events;
+};
+
+// Signatures of the instructions one by one, of everything the plan
+// depends on: instruction types and names, kernel types, device contexts
+// (as the order they first appear), variable ids read and written and the
+// dependency flags. The dependencies among the first n instructions only
+// depend on the first n signatures, since they always point forward.
+std::vector<std::string> InstructionSignatures(
+    const std::vector<std::unique_ptr<InstructionBase>>& instructions);
+
+// Hash of the signatures, which names the plan file.
+uint64_t InterpreterPlanKey(const std::vector<std::string>& signatures);
+
+// Returns false when there is no valid plan for `key` saved with exactly
+// `signatures`, a plan of another instruction list under the same key is
+// never returned.
+bool LoadInterpreterPlan(uint64_t key,
+                         const std::vector<std::string>& signatures,
+                         InterpreterPlan* plan);
+
+// Saves the plan along with the signatures it is valid for.
+void SaveInterpreterPlan(uint64_t key,
+                         const std::vector<std::string>& signatures,
+                         const InterpreterPlan& plan);
+
+// In-process cache of the dependencies of the recently built instruction
+// lists. Returns the length of the longest prefix of `signatures` shared
+// with a cached list (0 if none), and the downstream map among it.
+size_t FindDependencyPrefix(
+    const std::vector<std::string>& signatures,
+    std::map<size_t, std::set<size_t>>* prefix_downstream_map);
+
+void RememberDependency(
+    const std::vector<std::string>& signatures,
+    const std::map<size_t, std::set<size_t>>& downstream_map);
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
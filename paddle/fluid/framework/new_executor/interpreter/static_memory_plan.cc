@@ -0,0 +1,86 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_plan.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "glog/logging.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+StaticMemoryPlan PlanStaticMemory(const std::vector<BufferLifetime>& buffers,
+                                  size_t alignment) {
+  const auto AlignedSize = [&](size_t i) {
+    return (buffers[i].size + alignment - 1) / alignment * alignment;
+  };
+  const auto Overlap = [&](size_t i, size_t j) {
+    return buffers[i].first_use <= buffers[j].last_use &&
+           buffers[j].first_use <= buffers[i].last_use;
+  };
+
+  std::vector<size_t> order(buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return buffers[lhs].size > buffers[rhs].size;
+  });
+
+  StaticMemoryPlan plan;
+  plan.offsets.resize(buffers.size());
+  // the placed buffers, sorted by offset
+  std::vector<size_t> placed;
+  for (size_t i : order) {
+    const size_t size = AlignedSize(i);
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t prev_end = 0;
+    for (size_t j : placed) {
+      if (!Overlap(i, j)) {
+        continue;
+      }
+      const size_t offset = plan.offsets[j];
+      if (offset >= prev_end) {
+        const size_t gap = offset - prev_end;
+        if (gap >= size && gap < best_gap) {
+          best_offset = prev_end;
+          best_gap = gap;
+        }
+      }
+      prev_end = std::max(prev_end, offset + AlignedSize(j));
+    }
+    if (best_offset == std::numeric_limits<size_t>::max()) {
+      best_offset = prev_end;
+    }
+
+    plan.offsets[i] = best_offset;
+    plan.arena_size = std::max(plan.arena_size, best_offset + size);
+    auto pos = std::upper_bound(
+        placed.begin(), placed.end(), best_offset, [&](size_t offset, size_t j) {
+          return offset < plan.offsets[j];
+        });
+    placed.insert(pos, i);
+  }
+
+  VLOG(4) << "Plan " << buffers.size() << " buffers in an arena of "
+          << plan.arena_size << " bytes";
+  return plan;
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,51 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// A buffer used from the first_use-th to the last_use-th (both included)
+// instruction in the execution order.
+struct BufferLifetime {
+  size_t size = 0;
+  size_t first_use = 0;
+  size_t last_use = 0;
+};
+
+struct StaticMemoryPlan {
+  size_t arena_size = 0;
+  // offsets[i] is the offset of the i-th buffer in the arena
+  std::vector<size_t> offsets;
+};
+
+// Assign every buffer an offset of `alignment` in one arena, such that the
+// buffers alive at the same time never overlap. The buffers are placed from
+// the largest to the smallest, each into the smallest gap left between the
+// placed buffers whose lifetimes overlap with it (best fit), or on top of
+// them if no gap is large enough.
+TEST_API StaticMemoryPlan
+PlanStaticMemory(const std::vector<BufferLifetime>& buffers,
+                 size_t alignment);
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
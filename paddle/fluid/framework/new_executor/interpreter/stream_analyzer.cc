@@ -14,19 +14,23 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/stream_analyzer.h"
 
+#include <algorithm>
 #include <future>
 #include <unordered_set>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/platform/device_context.h"
+#include "paddle/utils/string/string_helper.h"
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
-#include "paddle/common/flags.h"
 #include "paddle/fluid/platform/collective_helper.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/distributed/nccl_comm_context.h"
 COMMON_DECLARE_bool(dynamic_static_unified_comm);
 #endif
+COMMON_DECLARE_int32(new_executor_auto_stream_num);
+COMMON_DECLARE_bool(new_executor_xpu_multi_stream);
 
 namespace paddle::framework::interpreter {
 
@@ -182,6 +186,119 @@ void StreamAnalyzer::ConstructEvents(std::vector<Instruction>* instructions) {
   }
 }
 
+bool StreamAnalyzer::IsAutoStreamCandidate(const Instruction& instr) const {
+  // ops placed explicitly (stream attributes, memcpy and communication
+  // streams, manual events) keep their device context
+  if (!instr.OpBaseValid()) {
+    return false;
+  }
+  const OpFuncNode* op_func_node = instr.OpFunc();
+  const OperatorBase* op = instr.OpBase();
+  return instr.KernelType() == OpFuncType::kGpuAsync &&
+         &instr.DeviceContext() == op_func_node->dev_ctx_ &&
+         op_func_node->execution_stream_ == kDefaultStream &&
+         !op_func_node->force_record_event_ &&
+         op_func_node->events_to_wait_.empty() && !op->HasAttr("ring_id");
+}
+
+std::vector<int> PickAutoStreams(
+    const std::vector<std::vector<size_t>>& upstream,
+    const std::vector<bool>& candidates,
+    const std::vector<uint64_t>& costs,
+    size_t stream_num) {
+  // Walk in program order. An instruction continues the stream of an
+  // upstream instruction whose stream is not continued yet, so a chain
+  // stays on one stream and only forks and joins need events. The other
+  // branches of a fork go to the least loaded stream. Roots stay on the
+  // default stream (0).
+  const size_t instr_num = candidates.size();
+  std::vector<int> stream_of(instr_num, -1);
+  std::vector<bool> continued(instr_num, false);
+  std::vector<uint64_t> load(std::max<size_t>(stream_num, 1), 0);
+  for (size_t i = 0; i < instr_num; ++i) {
+    if (!candidates[i]) {
+      continue;
+    }
+    int stream = -1;
+    bool is_fork_branch = false;
+    for (size_t up : upstream[i]) {
+      if (stream_of[up] < 0) {
+        continue;
+      }
+      if (continued[up]) {
+        is_fork_branch = true;
+      } else if (stream < 0 || stream_of[up] == 0) {
+        // prefer to join back into the default stream
+        stream = stream_of[up];
+        if (stream == 0) {
+          break;
+        }
+      }
+    }
+    if (stream < 0) {
+      stream = is_fork_branch
+                   ? static_cast<int>(std::min_element(load.begin(),
+                                                       load.end()) -
+                                      load.begin())
+                   : 0;
+    }
+    for (size_t up : upstream[i]) {
+      if (stream_of[up] == stream) {
+        continued[up] = true;
+      }
+    }
+    stream_of[i] = stream;
+    load[stream] += std::max<uint64_t>(costs[i], 1);
+  }
+  VLOG(4) << "PickAutoStreams: load of " << load.size()
+          << " streams = " << paddle::string::join_strings(load, ',');
+  return stream_of;
+}
+
+bool StreamAnalyzer::AssignAutoStreams(
+    const std::vector<Instruction>& instructions,
+    const std::vector<uint64_t>& costs,
+    std::vector<OpFuncNode>* op_func_nodes) {
+  if (auto_streams_ == nullptr) {
+    const size_t instr_num = instructions.size();
+    DependencyBuilder dependency_builder;
+    const std::map<size_t, std::set<size_t>>& downstream_map =
+        dependency_builder.Build(instructions);
+    std::vector<std::vector<size_t>> upstream(instr_num);
+    for (auto& item : downstream_map) {
+      for (size_t next_instr_id : item.second) {
+        upstream[next_instr_id].push_back(item.first);
+      }
+    }
+    std::vector<bool> candidates(instr_num);
+    for (size_t i = 0; i < instr_num; ++i) {
+      candidates[i] = IsAutoStreamCandidate(instructions[i]);
+    }
+    const std::vector<int> stream_of = PickAutoStreams(
+        upstream,
+        candidates,
+        costs,
+        static_cast<size_t>(FLAGS_new_executor_auto_stream_num));
+
+    auto_streams_ = std::make_shared<std::vector<std::string>>(instr_num);
+    for (size_t i = 0; i < instr_num; ++i) {
+      if (stream_of[i] > 0) {
+        (*auto_streams_)[i] = "auto_stream_" + std::to_string(stream_of[i]);
+      }
+    }
+  }
+
+  bool changed = false;
+  for (size_t i = 0; i < auto_streams_->size() && i < op_func_nodes->size();
+       ++i) {
+    if (!(*auto_streams_)[i].empty()) {
+      (*op_func_nodes)[i].execution_stream_ = (*auto_streams_)[i];
+      changed = true;
+    }
+  }
+  return changed;
+}
+
 DeviceContext* StreamAnalyzer::ParseDeviceContext(
     const OpFuncNode& op_func_node) const {
   auto& op = op_func_node.operator_base_;
@@ -332,8 +449,10 @@ template <typename T>
 DownstreamRunType analyse_run_type_for_two_instructions(T* cur_instr,
                                                         T* next_instr,
                                                         const Place& place) {
-  // xpu&ipu memcpy kerenl is synchronous.
-  if (phi::is_ipu_place(place) || phi::is_xpu_place(place)) {
+  // xpu&ipu memcpy kerenl is synchronous. With multi-stream, the xpu
+  // kernels on different streams are ordered by events as on gpu.
+  if (phi::is_ipu_place(place) ||
+      (phi::is_xpu_place(place) && !FLAGS_new_executor_xpu_multi_stream)) {
     return DownstreamRunType::kDirectRun;
   }
 
@@ -672,6 +791,7 @@ StreamAnalyzer::GetEventInfo() const {
 
 void StreamAnalyzer::ShareEventInfoFrom(const StreamAnalyzer& src) {
   event_info_ = src.GetEventInfo();
+  auto_streams_ = src.auto_streams_;
   is_event_info_build_ = true;
 }
 
@@ -870,4 +990,32 @@ PirStreamAnalyzer::GetEventInfo() const {
   return event_info_;
 }
 
+std::vector<std::pair<size_t, size_t>> PirStreamAnalyzer::GetEventPairs()
+    const {
+  std::vector<std::pair<size_t, size_t>> event_pairs;
+  for (auto& context_item : *event_info_) {
+    for (auto& waiter_item : context_item.second) {
+      for (size_t recorder_instr_id : waiter_item.second) {
+        event_pairs.emplace_back(waiter_item.first, recorder_instr_id);
+      }
+    }
+  }
+  return event_pairs;
+}
+
+void PirStreamAnalyzer::SetEventPairs(
+    const std::vector<std::unique_ptr<paddle::framework::InstructionBase>>&
+        instructions,
+    const std::vector<std::pair<size_t, size_t>>& event_pairs) {
+  event_info_->clear();
+  for (auto& event_pair : event_pairs) {
+    // events are keyed by the device context of the recorder
+    size_t recorder_instr_id = event_pair.second % instructions.size();
+    (*event_info_)[&(instructions[recorder_instr_id]->DeviceContext())]
+                  [event_pair.first]
+                      .insert(event_pair.second);
+  }
+  is_event_info_build_ = true;
+}
+
 }  // namespace paddle::framework::interpreter
@@ -15,6 +15,7 @@
 #pragma once
 #include <future>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/new_executor/interpreter/dependency_builder.h"
@@ -62,6 +63,17 @@ class ContextManager {
   std::unordered_map<std::string, DeviceContextMap> ctx_pool_;
 };
 
+// Picks the streams of StreamAnalyzer::AssignAutoStreams. `upstream[i]`
+// lists the instructions that instruction i depends on, `candidates[i]`
+// tells whether it may be moved and `costs[i]` estimates its work. Returns
+// the stream in [0, stream_num) of every candidate, 0 being the default
+// stream, and -1 for the others.
+std::vector<int> PickAutoStreams(
+    const std::vector<std::vector<size_t>>& upstream,
+    const std::vector<bool>& candidates,
+    const std::vector<uint64_t>& costs,
+    size_t stream_num);
+
 class StreamAnalyzer {
  public:
   using DeviceContext = phi::DeviceContext;
@@ -76,6 +88,14 @@ class StreamAnalyzer {
 
   void ConstructEvents(std::vector<Instruction>* instructions);
 
+  // Spreads independent branches of gpu kernels in `instructions` over
+  // FLAGS_new_executor_auto_stream_num streams by setting execution_stream_
+  // of the matching `op_func_nodes`. `costs` estimates the work of each
+  // instruction. Returns whether any stream has been changed.
+  bool AssignAutoStreams(const std::vector<Instruction>& instructions,
+                         const std::vector<uint64_t>& costs,
+                         std::vector<OpFuncNode>* op_func_nodes);
+
   phi::DeviceContext* ParseDeviceContext(const OpFuncNode& op_func_node) const;
 
   platform::DeviceType GetWaiterType(const Instruction& instr) const;
@@ -111,11 +131,16 @@ class StreamAnalyzer {
       std::map<const DeviceContext*, std::map<size_t, std::set<size_t>>>*
           event_info_map) const;
 
+  bool IsAutoStreamCandidate(const Instruction& instr) const;
+
   const Place place_;
   bool is_event_info_build_{false};
   std::shared_ptr<
       std::map<const DeviceContext*, std::map<size_t, std::set<size_t>>>>
       event_info_;
+  // instr_id -> execution stream picked by AssignAutoStreams, shared with
+  // the analyzers sharing event_info_ since the events depend on it
+  std::shared_ptr<std::vector<std::string>> auto_streams_;
   std::unordered_map<std::string, std::shared_ptr<EventInter>>*
       program_force_events_to_wait_;  // not owned
 };
@@ -144,6 +169,15 @@ class PirStreamAnalyzer {
 
   void ShareEventInfoFrom(const PirStreamAnalyzer& src);
 
+  // (waiter, recorder) pairs of the cross step merged instructions, which
+  // with them restore the event info built by ConstructEvents
+  std::vector<std::pair<size_t, size_t>> GetEventPairs() const;
+
+  void SetEventPairs(
+      const std::vector<std::unique_ptr<paddle::framework::InstructionBase>>&
+          instructions,
+      const std::vector<std::pair<size_t, size_t>>& event_pairs);
+
   void SetForceEventsToWaitInfo(
       std::unordered_map<std::string, std::shared_ptr<EventInter>>*
           program_force_events_to_wait) {
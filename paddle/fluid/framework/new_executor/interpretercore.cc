@@ -34,6 +34,10 @@ PHI_DEFINE_EXPORTED_bool(new_executor_use_local_scope,
                          true,
                          "Use local_scope in new executor(especially used "
                          "in UT), can turn off for better performance");
+PHI_DEFINE_EXPORTED_int32(new_executor_auto_stream_num,
+                          0,
+                          "Number of gpu streams the new executor spreads "
+                          "independent branches over, <= 1 disables it");
 
 namespace paddle::framework {
 
@@ -14,23 +14,38 @@
 
 #include "paddle/fluid/framework/new_executor/nan_inf_utils.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/framework/details/nan_inf_utils_detail.h"
+#include "paddle/fluid/platform/device_event.h"
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
 #include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/funcs/nan_inf_flag.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
 
 namespace paddle {
 namespace framework {
 
 static std::once_flag pir_white_list_init_flag;
 
-void CheckTensorHasNanOrInf(InstructionBase* instruction,
-                            const paddle::framework::Scope* scope,
-                            ValueExecutionInfo* value_exe_info) {
+// Calls `check(api_name, tensor_name, output_index, tensor)` for the outputs
+// of `instruction` that FLAGS_check_nan_inf checks.
+template <typename Func>
+static void VisitCheckedOutputs(InstructionBase* instruction,
+                                const paddle::framework::Scope* scope,
+                                ValueExecutionInfo* value_exe_info,
+                                Func&& check) {
   std::call_once(pir_white_list_init_flag, details::InitWhiteListFormEnv);
 
   std::string dialect_name = instruction->Operation()
@@ -46,7 +61,9 @@ void CheckTensorHasNanOrInf(InstructionBase* instruction,
     return;
   }
 
+  size_t output_index = 0;
   for (auto iter : instruction->Outputs()) {
+    size_t index = output_index++;
     auto tensor_name = value_exe_info->GetVarName(iter.first);
     bool need_check = true;
     if (details::op_var_nan_inf_white_list().count(api_name) != 0) {
@@ -76,24 +93,184 @@ void CheckTensorHasNanOrInf(InstructionBase* instruction,
                  << tensor_name << " is no need.";
         break;
       }
+      check(api_name, tensor_name, index, *dense_tensor);
+    }
+  }
+}
 
-      auto& place = dense_tensor->place();
-      if (phi::is_gpu_place(place)) {
+static void CheckDenseTensor(const std::string& api_name,
+                             const std::string& tensor_name,
+                             const phi::DenseTensor& dense_tensor) {
+  auto& place = dense_tensor.place();
+  if (phi::is_gpu_place(place)) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-        paddle::framework::details::tensor_check<phi::GPUContext>(
-            api_name, tensor_name, *dense_tensor, place);
+    paddle::framework::details::tensor_check<phi::GPUContext>(
+        api_name, tensor_name, dense_tensor, place);
 #else
-        PADDLE_THROW(common::errors::PreconditionNotMet(
-            "Tensor[%s] use gpu place. PaddlePaddle must compile with GPU.",
-            tensor_name));
+    PADDLE_THROW(common::errors::PreconditionNotMet(
+        "Tensor[%s] use gpu place. PaddlePaddle must compile with GPU.",
+        tensor_name));
 #endif
-        continue;
-      }
-      paddle::framework::details::tensor_check<phi::CPUContext>(
-          api_name, tensor_name, *dense_tensor, place);
+    return;
+  }
+  paddle::framework::details::tensor_check<phi::CPUContext>(
+      api_name, tensor_name, dense_tensor, place);
+}
+
+void CheckTensorHasNanOrInf(InstructionBase* instruction,
+                            const paddle::framework::Scope* scope,
+                            ValueExecutionInfo* value_exe_info) {
+  VisitCheckedOutputs(instruction,
+                      scope,
+                      value_exe_info,
+                      [](const std::string& api_name,
+                         const std::string& tensor_name,
+                         size_t output_index,
+                         const phi::DenseTensor& dense_tensor) {
+                        CheckDenseTensor(api_name, tensor_name, dense_tensor);
+                      });
+}
+
+// codes are (instruction id << 16 | output index), smaller is earlier
+static constexpr uint64_t kNoNanInf = std::numeric_limits<uint64_t>::max();
+static constexpr int kOutputIndexBits = 16;
+
+struct AsyncNanInfChecker::StreamFlag {
+  memory::AllocationPtr device_flag;
+  memory::AllocationPtr host_flag;
+  std::unique_ptr<platform::DeviceEvent> event;
+  // marked in this step
+  bool used{false};
+  // read back by the event
+  bool pending{false};
+};
+
+AsyncNanInfChecker::AsyncNanInfChecker(
+    const std::vector<std::unique_ptr<InstructionBase>>* instructions,
+    ValueExecutionInfo* value_exe_info)
+    : instructions_(instructions), value_exe_info_(value_exe_info) {}
+
+AsyncNanInfChecker::~AsyncNanInfChecker() {
+  // the read back must finish before the pinned memory is freed
+  for (auto& item : stream_flags_) {
+    if (item.second->pending) {
+      item.second->event->Finish();
     }
   }
 }
 
+AsyncNanInfChecker::StreamFlag* AsyncNanInfChecker::GetStreamFlag(
+    const phi::DeviceContext* ctx) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& stream_flag = stream_flags_[ctx];
+  if (!stream_flag) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    stream_flag = std::make_unique<StreamFlag>();
+    stream_flag->device_flag = memory::Alloc(ctx->GetPlace(), sizeof(uint64_t));
+    stream_flag->host_flag =
+        memory::Alloc(phi::GPUPinnedPlace(), sizeof(uint64_t));
+    stream_flag->event = std::make_unique<platform::DeviceEvent>(
+        ctx->GetPlace(), platform::GenerateDeviceEventFlag());
+    phi::backends::gpu::GpuMemsetAsync(
+        stream_flag->device_flag->ptr(),
+        0xFF,
+        sizeof(uint64_t),
+        static_cast<const phi::GPUContext*>(ctx)->stream());
+#endif
+  }
+  stream_flag->used = true;
+  return stream_flag.get();
+}
+
+void AsyncNanInfChecker::BeginStep() {
+  uint64_t code = kNoNanInf;
+  for (auto& item : stream_flags_) {
+    StreamFlag* stream_flag = item.second.get();
+    if (!stream_flag->pending) {
+      continue;
+    }
+    stream_flag->event->Finish();
+    stream_flag->pending = false;
+    uint64_t* host_flag =
+        reinterpret_cast<uint64_t*>(stream_flag->host_flag->ptr());
+    code = std::min(code, *host_flag);
+  }
+  if (code == kNoNanInf) {
+    return;
+  }
+
+  size_t instr_id = code >> kOutputIndexBits;
+  size_t output_index = code & ((1ULL << kOutputIndexBits) - 1);
+  InstructionBase* instr = instructions_->at(instr_id).get();
+  std::string tensor_name;
+  for (auto iter : instr->Outputs()) {
+    if (output_index-- == 0) {
+      tensor_name = value_exe_info_->GetVarName(iter.first);
+      break;
+    }
+  }
+  PADDLE_THROW(common::errors::PreconditionNotMet(
+      "There are NAN or INF in the output %s of operator %s (instruction "
+      "%d) in the previous run, found by FLAGS_check_nan_inf_async.",
+      tensor_name,
+      instr->Name(),
+      instr_id));
+}
+
+void AsyncNanInfChecker::Check(InstructionBase* instruction,
+                               const paddle::framework::Scope* scope) {
+  VisitCheckedOutputs(
+      instruction,
+      scope,
+      value_exe_info_,
+      [&](const std::string& api_name,
+          const std::string& tensor_name,
+          size_t output_index,
+          const phi::DenseTensor& dense_tensor) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+        if (phi::is_gpu_place(dense_tensor.place()) &&
+            output_index < (1ULL << kOutputIndexBits)) {
+          const phi::DeviceContext* ctx = &instruction->DeviceContext();
+          StreamFlag* stream_flag = GetStreamFlag(ctx);
+          uint64_t code = (static_cast<uint64_t>(instruction->Id())
+                           << kOutputIndexBits) |
+                          output_index;
+          if (phi::funcs::MarkNanInfAsync(
+                  *static_cast<const phi::GPUContext*>(ctx),
+                  dense_tensor,
+                  code,
+                  reinterpret_cast<uint64_t*>(
+                      stream_flag->device_flag->ptr()))) {
+            return;
+          }
+        }
+#endif
+        CheckDenseTensor(api_name, tensor_name, dense_tensor);
+      });
+}
+
+void AsyncNanInfChecker::EndStep() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  for (auto& item : stream_flags_) {
+    StreamFlag* stream_flag = item.second.get();
+    if (!stream_flag->used) {
+      continue;
+    }
+    auto stream = static_cast<const phi::GPUContext*>(item.first)->stream();
+    memory::Copy(phi::GPUPinnedPlace(),
+                 stream_flag->host_flag->ptr(),
+                 item.first->GetPlace(),
+                 stream_flag->device_flag->ptr(),
+                 sizeof(uint64_t),
+                 stream);
+    phi::backends::gpu::GpuMemsetAsync(
+        stream_flag->device_flag->ptr(), 0xFF, sizeof(uint64_t), stream);
+    stream_flag->event->Record(item.first);
+    stream_flag->used = false;
+    stream_flag->pending = true;
+  }
+#endif
+}
+
 }  // namespace framework
 }  // namespace paddle
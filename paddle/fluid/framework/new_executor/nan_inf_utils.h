@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/fluid/framework/new_executor/pir_adaptor/pir_adaptor_util.h"
@@ -25,5 +30,41 @@ void CheckTensorHasNanOrInf(InstructionBase* instruction,
                             const paddle::framework::Scope* scope,
                             ValueExecutionInfo* value_exe_info);
 
+// Checks the gpu outputs of instructions for NAN/INF without synchronizing,
+// see FLAGS_check_nan_inf_async. Each checked output costs one reduction
+// kernel into a per-stream device flag holding the smallest (instruction id,
+// output index) code seen, the flags are read back once per step and the
+// code is only turned into names when it is set. Outputs on cpu or of other
+// dtypes are checked as CheckTensorHasNanOrInf does.
+class AsyncNanInfChecker {
+ public:
+  AsyncNanInfChecker(
+      const std::vector<std::unique_ptr<InstructionBase>>* instructions,
+      ValueExecutionInfo* value_exe_info);
+
+  ~AsyncNanInfChecker();
+
+  // Raises the NAN/INF found in the previous step, if any.
+  void BeginStep();
+
+  void Check(InstructionBase* instruction,
+             const paddle::framework::Scope* scope);
+
+  // Reads the flags of this step back asynchronously.
+  void EndStep();
+
+ private:
+  struct StreamFlag;
+
+  StreamFlag* GetStreamFlag(const phi::DeviceContext* ctx);
+
+  const std::vector<std::unique_ptr<InstructionBase>>*
+      instructions_;                     // not owned
+  ValueExecutionInfo* value_exe_info_;  // not owned
+  std::mutex mutex_;
+  std::unordered_map<const phi::DeviceContext*, std::unique_ptr<StreamFlag>>
+      stream_flags_;
+};
+
 }  // namespace framework
 }  // namespace paddle
@@ -15,20 +15,29 @@
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 
 #include <chrono>
+#include <optional>
 #include <unordered_set>
 
 #include "paddle/common/flags.h"
 
 #include "paddle/fluid/framework/details/nan_inf_utils.h"
 #include "paddle/fluid/framework/details/share_tensor_buffer_functor.h"
+#include "paddle/fluid/framework/new_executor/garbage_collector/fast_garbage_collector.h"
+#include "paddle/fluid/framework/new_executor/interpreter/instruction_cost_sampler.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
+#include "paddle/fluid/framework/new_executor/interpreter/plan_cache.h"
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_plan.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/fluid/platform/profiler/mem_tracing.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
 #include "paddle/phi/common/place.h"
+#include "paddle/phi/core/generator.h"
 #include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/memory/malloc.h"
 #include "paddle/phi/core/os_info.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
@@ -68,10 +77,12 @@
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_op.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
+#include "paddle/fluid/pir/dialect/operator/interface/op_yaml_info.h"
 #include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/manual_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/manual_pylayer_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/tensorrt_op.h"
+#include "paddle/fluid/pir/dialect/operator/utils/op_yaml_info_parser.h"
 #include "paddle/fluid/pir/dialect/operator/utils/utils.h"
 #include "paddle/pir/include/core/builtin_attribute.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
@@ -89,6 +100,21 @@ COMMON_DECLARE_bool(enable_pir_in_executor);
 COMMON_DECLARE_bool(enable_pir_in_executor_trace_run);
 COMMON_DECLARE_bool(enable_collect_shape);
 COMMON_DECLARE_int32(low_precision_op_list);
+COMMON_DECLARE_bool(pir_interpreter_auto_cuda_graph);
+COMMON_DECLARE_int32(pir_interpreter_cuda_graph_warmup_steps);
+COMMON_DECLARE_string(pir_interpreter_plan_cache_dir);
+COMMON_DECLARE_bool(pir_interpreter_incremental_plan);
+COMMON_DECLARE_int32(pir_interpreter_cost_sample_interval);
+COMMON_DECLARE_bool(pir_interpreter_static_memory_plan);
+COMMON_DECLARE_bool(check_nan_inf_async);
+COMMON_DECLARE_int32(check_nan_inf_level);
+COMMON_DECLARE_bool(new_executor_xpu_multi_stream);
+COMMON_DECLARE_bool(new_executor_counter_based_rng);
+
+// the CUDA Graphs captured and replayed with
+// FLAGS_pir_interpreter_auto_cuda_graph, see core.get_int_stats
+DEFINE_INT_STATUS(STAT_pir_interpreter_cuda_graph_captures)
+DEFINE_INT_STATUS(STAT_pir_interpreter_cuda_graph_replays)
 
 #define CREATE_INSTR(instr_name)                                   \
   vec_instruction_base_.emplace_back(std::make_unique<instr_name>( \
@@ -96,6 +122,66 @@ COMMON_DECLARE_int32(low_precision_op_list);
 
 namespace paddle::framework {
 
+// The position of the block in its program, mixed from the indices of its
+// parent ops and of the block in them, which is the same in all the
+// processes building the same program, unlike the op ids.
+static uint64_t BlockPosition(const ::pir::Block* block) {
+  uint64_t position = 0;
+  for (::pir::Operation* op = block->GetParentOp(); op != nullptr;
+       op = op->GetParentOp()) {
+    uint64_t block_index = 0;
+    for (auto& region : *op) {
+      for (auto& sub_block : region) {
+        if (&sub_block == block) break;
+        ++block_index;
+      }
+    }
+    uint64_t op_index = 0;
+    for (auto& sibling : *op->GetParent()) {
+      if (&sibling == op) break;
+      ++op_index;
+    }
+    position = (position * 1000003 + op_index) * 1000003 + block_index + 1;
+    block = op->GetParent();
+  }
+  return position;
+}
+
+// Reserves the base of the counter based random seeds of a run from the
+// generator of the place, so that the runs of all the interpreters, e.g. of
+// other programs or rebuilt ones, get keys of their own, which are still
+// reproducible from the seed of the generator. A run nested in an op, e.g.
+// of the block of a control flow op, takes the key of that op.
+static uint64_t ReserveRNGBase(const phi::Place& place) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
+    defined(PADDLE_WITH_CUSTOM_DEVICE) || defined(PADDLE_WITH_XPU)
+  phi::Generator* generator = phi::DefaultCPUGenerator().get();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(place)) {
+    generator = phi::DefaultCUDAGenerator(place.GetDeviceId()).get();
+  }
+#endif
+#ifdef PADDLE_WITH_XPU
+  if (phi::is_xpu_place(place)) {
+    generator = phi::DefaultXPUGenerator(place.GetDeviceId()).get();
+  }
+#endif
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if (phi::is_custom_place(place)) {
+    generator = phi::DefaultCustomDeviceGenerator(
+                    phi::CustomPlace(place.GetDeviceType(),
+                                     place.GetDeviceId()))
+                    .get();
+  }
+#endif
+  // (seed, offset) out of an op and (key, 0) within one
+  auto seed_offset = generator->IncrementOffset(1);
+  return seed_offset.first ^ seed_offset.second;
+#else
+  return 0;
+#endif
+}
+
 void RecordLowPrecisionOp(const InstructionBase* instr_node) {
   if (FLAGS_low_precision_op_list) {
     std::string op_name = instr_node->Name();
@@ -469,6 +555,169 @@ void PirInterpreter::CheckCUDAGraphBeforeRun(
 #endif
 }
 
+bool PirInterpreter::CanCaptureCUDAGraph() {
+  if (!phi::is_gpu_place(place_)) return false;
+  // The event GC queries events, which is not allowed while capturing, so
+  // only the fast GC can run in a graph, as for
+  // FLAGS_new_executor_use_cuda_graph.
+  if (!gc_) {
+    gc_ = CreateInterpreterCoreGarbageCollector(place_, vec_instruction_base_);
+  }
+  if (dynamic_cast<InterpreterCoreFastGarbageCollector*>(gc_.get()) ==
+          nullptr ||
+      FLAGS_sync_nccl_allreduce) {
+    VLOG(1) << "CUDA Graph needs the fast GC and "
+               "FLAGS_sync_nccl_allreduce=false, run PirInterpreter without "
+               "CUDA Graph.";
+    return false;
+  }
+  const phi::DeviceContext* default_dev_ctx =
+      phi::DeviceContextPool::Instance().Get(place_);
+  for (auto& instr : vec_instruction_base_) {
+    if (dynamic_cast<BuiltinCombineInstruction*>(instr.get()) != nullptr) {
+      continue;
+    }
+    bool is_kernel =
+        dynamic_cast<PhiKernelInstruction*>(instr.get()) != nullptr ||
+        dynamic_cast<LegacyKernelInstruction*>(instr.get()) != nullptr;
+    // Control flow and host kernels can not be replayed, and kernels on other
+    // streams are not joined into the capturing stream.
+    if (!is_kernel || instr->KernelType() != OpFuncType::kGpuAsync ||
+        &instr->DeviceContext() != default_dev_ctx) {
+      VLOG(1) << "Instruction " << instr->Name()
+              << " can not be captured by CUDA Graph, run PirInterpreter "
+                 "without CUDA Graph.";
+      return false;
+    }
+  }
+  cuda_graph_input_names_.clear();
+  for (auto& op : *ir_block_) {
+    std::string op_name = op.name();
+    if (op.attributes().count("op_name")) {
+      op_name = op.attributes()
+                    .at("op_name")
+                    .dyn_cast<pir::StrAttribute>()
+                    .AsString();
+    }
+    if (op_name == paddle::dialect::FeedOp::name() ||
+        op_name == paddle::dialect::DataOp::name()) {
+      cuda_graph_input_names_.push_back(
+          op.attributes().at("name").dyn_cast<pir::StrAttribute>().AsString());
+    }
+  }
+  return true;
+}
+
+bool PirInterpreter::CUDAGraphRunImpl() {
+  if (!FLAGS_pir_interpreter_auto_cuda_graph) return false;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // Captured by the caller, e.g. paddle.device.cuda.graphs.CUDAGraph.
+  if (platform::IsCUDAGraphCapturing()) return false;
+  if (cuda_graph_capturable_ == -1) {
+    cuda_graph_capturable_ = CanCaptureCUDAGraph() ? 1 : 0;
+  }
+  if (cuda_graph_capturable_ == 0) return false;
+
+  std::vector<phi::DenseTensor*> inputs;
+  std::vector<int64_t> key;
+  for (auto& name : cuda_graph_input_names_) {
+    auto* var = InnerScope()->FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) return false;
+    auto* tensor = var->GetMutable<phi::DenseTensor>();
+    if (!tensor->initialized() || tensor->place() != place_ ||
+        !tensor->lod().empty()) {
+      return false;
+    }
+    key.push_back(static_cast<int64_t>(tensor->dtype()));
+    key.push_back(tensor->dims().size());
+    for (int i = 0; i < tensor->dims().size(); ++i) {
+      key.push_back(tensor->dims()[i]);
+    }
+    inputs.push_back(tensor);
+  }
+
+  constexpr size_t kMaxCUDAGraphNum = 8;
+  constexpr size_t kMaxWarmupKeyNum = 64;
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      phi::DeviceContextPool::Instance().Get(place_));
+  auto iter = cuda_graphs_.find(key);
+  if (iter == cuda_graphs_.end()) {
+    if (cuda_graphs_.size() >= kMaxCUDAGraphNum) return false;
+    auto steps_iter = cuda_graph_warmup_steps_.find(key);
+    if (steps_iter == cuda_graph_warmup_steps_.end()) {
+      // With ever changing input shapes most keys are seen only a few times,
+      // start over instead of growing without bound.
+      if (cuda_graph_warmup_steps_.size() >= kMaxWarmupKeyNum) {
+        cuda_graph_warmup_steps_.clear();
+      }
+      steps_iter = cuda_graph_warmup_steps_.emplace(key, 0).first;
+    }
+    int& steps = steps_iter->second;
+    if (steps < 0 || steps++ < FLAGS_pir_interpreter_cuda_graph_warmup_steps) {
+      return false;
+    }
+    PrepareForCUDAGraphCapture();
+    // The graph reads the addresses seen during capturing, so copy the inputs
+    // into buffers owned by the graph.
+    CapturedCUDAGraph captured;
+    for (auto* tensor : inputs) {
+      phi::DenseTensor buffer;
+      framework::TensorCopy(*tensor, place_, *dev_ctx, &buffer);
+      tensor->ShareDataWith(buffer);
+      captured.inputs.push_back(buffer);
+    }
+    dev_ctx->Wait();
+    VLOG(1) << "Capture CUDA Graph of PirInterpreter with " << inputs.size()
+            << " inputs.";
+#ifdef PADDLE_WITH_HIP
+    auto capture_mode = hipStreamCaptureModeThreadLocal;
+#else
+    auto capture_mode = cudaStreamCaptureModeThreadLocal;
+#endif
+    try {
+      platform::BeginCUDAGraphCapture(
+          phi::GPUPlace(place_.GetDeviceId()), capture_mode);
+      TraceRunImpl();
+      captured.graph = platform::EndCUDAGraphCapture();
+    } catch (std::exception& e) {
+      LOG(WARNING) << "Fail to capture CUDA Graph of PirInterpreter, run the "
+                      "current input shapes without CUDA Graph: "
+                   << e.what();
+      if (platform::IsCUDAGraphCapturing()) {
+        try {
+          platform::EndCUDAGraphCapture();
+        } catch (std::exception& e) {
+          VLOG(1) << "End the failed capturing: " << e.what();
+        }
+      }
+      steps = -1;
+      return false;
+    }
+    cuda_graph_warmup_steps_.erase(key);
+    iter = cuda_graphs_.emplace(key, std::move(captured)).first;
+    STAT_ADD(STAT_pir_interpreter_cuda_graph_captures, 1);
+  } else {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      auto& buffer = iter->second.inputs[i];
+      if (inputs[i]->data() != buffer.data()) {
+        memory::Copy(place_,
+                     buffer.data(),
+                     place_,
+                     inputs[i]->data(),
+                     buffer.numel() * phi::SizeOf(buffer.dtype()),
+                     dev_ctx->stream());
+        inputs[i]->ShareDataWith(buffer);
+      }
+    }
+  }
+  iter->second.graph->Replay();
+  STAT_ADD(STAT_pir_interpreter_cuda_graph_replays, 1);
+  return true;
+#else
+  return false;
+#endif
+}
+
 void PirInterpreter::ClearLoDTensorArrayInLocalScope() {
   auto vars = local_scope_->LocalVars();
   for (auto var : vars) {
@@ -1110,9 +1359,10 @@ void PirInterpreter::RecordMemcpyD2H(InstructionBase* instr_node) {
 }
 
 void PirInterpreter::RecordStreamForGC(InstructionBase* instr) {
-#if !defined(PADDLE_WITH_CUDA) && !defined(PADDLE_WITH_HIP)
+#if !defined(PADDLE_WITH_CUDA) && !defined(PADDLE_WITH_HIP) && \
+    !defined(PADDLE_WITH_XPU)
   PADDLE_THROW(common::errors::Unimplemented(
-      "RecordStreamForGC is only implemented when compiled with GPU."));
+      "RecordStreamForGC is only implemented when compiled with GPU or XPU."));
 #else
   if (!IsInterpretercoreFastGCEnabled() ||
       instr->KernelType() != OpFuncType::kGpuAsync) {
@@ -1125,8 +1375,17 @@ void PirInterpreter::RecordStreamForGC(InstructionBase* instr) {
   phi::RecordEvent record(
       "RecordStreamForGC", platform::TracerEventType::UserDefined, 10);
 
+#ifdef PADDLE_WITH_XPU
+  // all the xpu kernels run on the same stream without multi-stream
+  if (!FLAGS_new_executor_xpu_multi_stream) {
+    return;
+  }
+  XPUStream stream =
+      static_cast<const phi::XPUContext&>(instr->DeviceContext()).stream();
+#else
   gpuStream_t stream =
       reinterpret_cast<const phi::GPUContext&>(instr->DeviceContext()).stream();
+#endif
 // TODO(lizhiyu): Only analyse the 'send_v2' for GPT pp strategy right now.
 // To support all the operators for communicating in the future.
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
@@ -1157,7 +1416,7 @@ void PirInterpreter::RecordStreamForGC(InstructionBase* instr) {
     }
 
     const phi::Place& place = allocation->place();
-    if (phi::is_gpu_place(place)) {
+    if (phi::is_gpu_place(place) || phi::is_xpu_place(place)) {
       memory::RecordStream(allocation, stream);
     } else if (phi::is_cuda_pinned_place(place)) {
       // TODO(Ruibiao): Here should do something to make sure that the tensor
@@ -1251,7 +1510,8 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
   phi::RecordEvent record(
       "CheckGC", platform::TracerEventType::UserDefined, 10);
 
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
+    defined(PADDLE_WITH_XPU)
   RecordStreamForGC(instr);
 #endif
 
@@ -1266,6 +1526,9 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
               << " is a parameter, skip gc";
       continue;
     }
+    if (static_memory_var_ids_.count(var_id)) {
+      continue;
+    }
 
     if (is_ready) {
       VLOG(6) << "Async delete variable with name : "
@@ -1278,6 +1541,7 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
     gc_->Add(var, instr);
   }
   instr->ClearEagerGCVars();
+  gc_->Flush(instr);
 }
 
 void PirInterpreter::CalculateLastLiveOps() {
@@ -1443,6 +1707,7 @@ paddle::framework::FetchList PirInterpreter::Run(
 
   SetDeviceId(place_);
   CheckCUDAGraphBeforeRun(feed_names);
+  UpdateCostSampling();
 
 #ifdef PADDLE_WITH_DNNL
   platform::AttachPointerHashToMKLDNNKey(this, place_);
@@ -1476,6 +1741,7 @@ paddle::framework::FetchList PirInterpreter::Run(
         ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
          (sync_op_num_ == 0))) {
       LOG_FIRST_N(INFO, 1) << "pir interpreter is running by trace mode ...";
+      BuildStaticMemoryPlan();
       TraceRunImpl();
     } else {
       LOG_FIRST_N(INFO, 1)
@@ -1490,7 +1756,9 @@ paddle::framework::FetchList PirInterpreter::Run(
         execution_config_.used_for_inference ||
         ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
          (sync_op_num_ == 0))) {
-      TraceRunImpl();
+      if (!CUDAGraphRunImpl()) {
+        TraceRunImpl();
+      }
     } else {
       MultiThreadRunImpl();
     }
@@ -1529,6 +1797,7 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
 
   SetDeviceId(place_);
   CheckCUDAGraphBeforeRun(feed_names);
+  UpdateCostSampling();
 
 #ifdef PADDLE_WITH_DNNL
   platform::AttachPointerHashToMKLDNNKey(this, place_);
@@ -1561,6 +1830,7 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
         ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
          (sync_op_num_ == 0))) {
       LOG_FIRST_N(INFO, 1) << "pir interpreter is running by trace mode ...";
+      BuildStaticMemoryPlan();
       TraceRunImpl();
     } else {
       LOG_FIRST_N(INFO, 1)
@@ -1571,11 +1841,16 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
     is_build_ = true;
     is_shared_results_build_ = true;
   } else {
-    if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
-        execution_config_.used_for_inference ||
-        ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
-         (sync_op_num_ == 0))) {
-      TraceRunImpl();
+    if (UseLowLatencyRun()) {
+      LowLatencyRunImpl();
+    } else if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
+               execution_config_.used_for_inference ||
+               ((execution_config_.used_for_jit ||
+                 execution_config_.used_for_cinn) &&
+                (sync_op_num_ == 0))) {
+      if (!CUDAGraphRunImpl()) {
+        TraceRunImpl();
+      }
     } else {
       MultiThreadRunImpl();
     }
@@ -1601,17 +1876,35 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
   return fetch_res;
 }
 
+bool PirInterpreter::UseAsyncNanInfChecker() const {
+  return FLAGS_check_nan_inf && FLAGS_check_nan_inf_async &&
+         FLAGS_check_nan_inf_level == 0 && phi::is_gpu_place(place_);
+}
+
 void PirInterpreter::TraceRunImpl() {
   // lazy initialization of gc, do not create gc is the program only run once
   if (!gc_) {
     gc_ = CreateInterpreterCoreGarbageCollector(place_, vec_instruction_base_);
   }
+  if (FLAGS_new_executor_counter_based_rng) {
+    rng_block_position_ = BlockPosition(ir_block_);
+    rng_base_ = ReserveRNGBase(place_);
+  }
+  if (async_nan_inf_checker_) {
+    async_nan_inf_checker_->BeginStep();
+  } else if (UseAsyncNanInfChecker()) {
+    async_nan_inf_checker_ = std::make_unique<AsyncNanInfChecker>(
+        &vec_instruction_base_, value_exe_info_.get());
+  }
 
   interpreter::ResetAtomicGuard guard(&deps_, &refs_);
   VLOG(4) << "Tracing Instruction List";
 
   TraceRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done TraceRunInstructionList";
+  if (async_nan_inf_checker_) {
+    async_nan_inf_checker_->EndStep();
+  }
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
   if (phi::is_custom_place(place_)) {
     phi::DeviceContextPool::Instance().Get(place_)->Wait();
@@ -1619,11 +1912,73 @@ void PirInterpreter::TraceRunImpl() {
 #endif
 }
 
+bool PirInterpreter::UseLowLatencyRun() {
+  if (!execution_config_.used_for_low_latency || !low_latency_supported_ ||
+      !phi::is_cpu_place(place_)) {
+    return false;
+  }
+  // the debugging and profiling features hook into RunInstructionBase
+  return !FLAGS_check_nan_inf && !FLAGS_benchmark &&
+         !FLAGS_enable_collect_shape && !sample_cost_ &&
+         !enable_job_schedule_profiler_ && pir_input_hookfuncs_.empty() &&
+         pir_output_hookfuncs_.empty() && !phi::RecordEvent::IsEnabled() &&
+         !platform::RecordMemEvent::IsEnabled();
+}
+
+void PirInterpreter::LowLatencyRunImpl() {
+  if (low_latency_instructions_.empty()) {
+    // the tensor arrays are cleared by GC, which is skipped here
+    for (auto* var : value_exe_info_->GetVarList()) {
+      if (var->IsType<phi::TensorArray>()) {
+        VLOG(4) << "Skip the low latency run for the tensor arrays";
+        low_latency_supported_ = false;
+        TraceRunImpl();
+        return;
+      }
+    }
+    for (auto instr_id : trace_execute_order_) {
+      auto* instr_node = vec_instruction_base_.at(instr_id).get();
+      if (!instr_node->IsArtificial()) {
+        low_latency_instructions_.push_back(instr_node);
+      }
+    }
+    VLOG(4) << "Run " << low_latency_instructions_.size()
+            << " instructions in the low latency mode";
+  }
+
+  // All the instructions run on the cpu in order, so neither the events nor
+  // the dependency counters are needed, and the intermediate tensors are
+  // kept for the next run instead of being collected.
+  for (auto* instr_node : low_latency_instructions_) {
+    try {
+      instr_node->Run();
+    } catch (platform::EnforceNotMet& ex) {
+      auto* op = instr_node->Operation();
+      framework::InsertCallStackInfo(
+          op->name(),
+          interpreter::GetInstructionCallStack(op->name(), op->attributes()),
+          &ex);
+      throw;
+    }
+    instr_node->ClearEagerGCVars();
+  }
+}
+
 void PirInterpreter::MultiThreadRunImpl() {
   // lazy initialization of gc, do not create gc is the program only run once
   if (!gc_) {
     gc_ = CreateInterpreterCoreGarbageCollector(place_, vec_instruction_base_);
   }
+  if (FLAGS_new_executor_counter_based_rng) {
+    rng_block_position_ = BlockPosition(ir_block_);
+    rng_base_ = ReserveRNGBase(place_);
+  }
+  if (async_nan_inf_checker_) {
+    async_nan_inf_checker_->BeginStep();
+  } else if (UseAsyncNanInfChecker()) {
+    async_nan_inf_checker_ = std::make_unique<AsyncNanInfChecker>(
+        &vec_instruction_base_, value_exe_info_.get());
+  }
 
   interpreter::ResetAtomicGuard guard(&deps_, &refs_);
   VLOG(4) << "Multi Thread Run Instruction List";
@@ -1631,6 +1986,9 @@ void PirInterpreter::MultiThreadRunImpl() {
   async_work_queue_ = GetWorkQueue();
   MultiThreadRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done MultiThreadRunInstructionList";
+  if (async_nan_inf_checker_) {
+    async_nan_inf_checker_->EndStep();
+  }
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
   if (phi::is_custom_place(place_)) {
     phi::DeviceContextPool::Instance().Get(place_)->Wait();
@@ -1682,6 +2040,7 @@ void PirInterpreter::TraceRunInstructionList(
       break;
     }
   }
+  gc_->FlushAll();
 
   if (UNLIKELY(exception_holder_.IsCaught())) {
     VLOG(1) << "Exception caught " << exception_holder_.Type();
@@ -1770,6 +2129,7 @@ void PirInterpreter::MultiThreadRunInstructionList(
   if (logged_times.valid()) {
     VLOG(1) << "Logged deps for " << logged_times.get() << " times";
   }
+  gc_->FlushAll();
 
   if (UNLIKELY(exception_holder_.IsCaught())) {
     VLOG(1) << "Exception caught " << exception_holder_.Type();
@@ -1853,6 +2213,16 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
 void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
   phi::RecordEvent instruction_event(
       instr_node->Name(), platform::TracerEventType::Operator, 1);
+  // the allocations of an instruction with a single output are for it
+  std::string output_name;
+  std::unique_ptr<platform::RecordMemEventTensorName> output_name_record;
+  if (UNLIKELY(platform::RecordMemEvent::IsEnabled()) &&
+      instr_node->Outputs().size() == 1) {
+    output_name =
+        value_exe_info_->GetVarName(instr_node->Outputs().begin()->first);
+    output_name_record =
+        std::make_unique<platform::RecordMemEventTensorName>(output_name);
+  }
 
   auto cur_place = instr_node->DeviceContext().GetPlace();
   SetDeviceId(cur_place);
@@ -1899,6 +2269,13 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
       {
         phi::RecordEvent record(
             "InstrRun", platform::TracerEventType::UserDefined, 10);
+        interpreter::InstructionCostGuard cost_guard(
+            sample_cost_ ? instr_node : nullptr);
+        std::optional<phi::CounterBasedRNGGuard> rng_guard;
+        if (FLAGS_new_executor_counter_based_rng) {
+          rng_guard.emplace(rng_block_position_ * 1000003 + instr_node->Id(),
+                            rng_base_);
+        }
         instr_node->Run();
       }
 
@@ -1911,7 +2288,11 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
 #endif
       }
       if (FLAGS_check_nan_inf) {
-        CheckTensorHasNanOrInf(instr_node, scope_, value_exe_info_.get());
+        if (async_nan_inf_checker_) {
+          async_nan_inf_checker_->Check(instr_node, scope_);
+        } else {
+          CheckTensorHasNanOrInf(instr_node, scope_, value_exe_info_.get());
+        }
       }
       VLOG(2) << "\ndone: " << __func__ << " OP id:" << instr_node->Id()
               << " name:" << instr_node->Name() << " type:"
@@ -1968,13 +2349,67 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
 }
 
 void PirInterpreter::PreAnalysis() {
+  // the dependencies and events only depend on the instructions, reuse the
+  // ones saved by an earlier process when they match
+  bool use_plan_cache =
+      !FLAGS_pir_interpreter_plan_cache_dir.empty() &&
+      !is_shared_results_build_ && !vec_instruction_base_.empty();
+  bool use_incremental_plan = FLAGS_pir_interpreter_incremental_plan &&
+                              !is_shared_results_build_ &&
+                              !vec_instruction_base_.empty();
+  std::vector<std::string> signatures;
+  if (use_plan_cache || use_incremental_plan) {
+    signatures = interpreter::InstructionSignatures(vec_instruction_base_);
+  }
+  uint64_t plan_key = 0;
+  interpreter::InterpreterPlan plan;
+  bool plan_loaded = false;
+  if (use_plan_cache) {
+    plan_key = interpreter::InterpreterPlanKey(signatures);
+    plan_loaded = interpreter::LoadInterpreterPlan(plan_key, signatures, &plan);
+  }
+  std::vector<paddle::framework::InstructionBase*> instructions_ptr;
+  for (auto& instr : vec_instruction_base_) {
+    instructions_ptr.push_back(instr.get());
+  }
+  if (plan_loaded) {
+    ir_dependency_builder_.BuildFrom(instructions_ptr, plan.downstream_map);
+    ir_stream_analyzer_.SetEventPairs(vec_instruction_base_, plan.events);
+  }
+
+  // or reuse the dependencies of the instructions shared with a recently
+  // built instruction list, e.g. of the same program with a new fetch
+  use_incremental_plan = use_incremental_plan && !plan_loaded;
+  if (use_incremental_plan) {
+    std::map<size_t, std::set<size_t>> prefix_downstream_map;
+    size_t prefix_num = interpreter::FindDependencyPrefix(
+        signatures, &prefix_downstream_map);
+    if (prefix_num > 0) {
+      ir_dependency_builder_.BuildWithPrefix(
+          instructions_ptr, prefix_num, prefix_downstream_map);
+    }
+  }
+
   BuildInstructionDependences();
   VLOG(4) << "Done BuildInstructionDependences";
 
+  if (use_incremental_plan) {
+    interpreter::RememberDependency(signatures,
+                                    ir_dependency_builder_.OpDownstreamMap());
+  }
+
   ir_stream_analyzer_.SetForceEventsToWaitInfo(force_events_to_wait_);
   ir_stream_analyzer_.ConstructEvents(vec_instruction_base_);
   VLOG(4) << "Done ConstructEvents";
 
+  if (use_plan_cache && !plan_loaded) {
+    plan.instr_num = vec_instruction_base_.size();
+    plan.downstream_map = ir_dependency_builder_.OpDownstreamMap();
+    plan.events = ir_stream_analyzer_.GetEventPairs();
+    interpreter::SaveInterpreterPlan(plan_key, signatures, plan);
+    VLOG(4) << "Done SaveInterpreterPlan";
+  }
+
   // add event for the input var of jit program, since there are async copied
   // from gpu_pinned place to gpu place on compute stream.
   ConstructEventForJitInput();
@@ -2025,6 +2460,179 @@ void PirInterpreter::SolvePersistableVarNames() {
   }
 }
 
+void PirInterpreter::UpdateCostSampling() {
+  const int interval = FLAGS_pir_interpreter_cost_sample_interval;
+  sample_cost_ = interval > 0 && run_step_++ % interval == 0;
+  if (sample_cost_) {
+    // read the device costs of the former sampled runs, which are completed
+    // by now in most cases
+    interpreter::InstructionCostSampler::Instance().Collect();
+  }
+}
+
+void PirInterpreter::BuildStaticMemoryPlan() {
+  if (!FLAGS_pir_interpreter_static_memory_plan || !sub_blocks_.empty() ||
+      execution_config_.used_for_control_flow_op ||
+      vec_instruction_base_.empty()) {
+    return;
+  }
+  // The planned buffers are reused across instructions without any event, so
+  // all the instructions must run on the same stream.
+  const phi::DeviceContext* dev_ctx =
+      &vec_instruction_base_.front()->DeviceContext();
+  for (auto& instr : vec_instruction_base_) {
+    if (&instr->DeviceContext() != dev_ctx) {
+      VLOG(4) << "Skip static memory plan for multiple streams";
+      return;
+    }
+  }
+
+  // Only the results of the phi kernels which neither run inplace nor return
+  // a view are planned, the vars touched by any other op are left as is.
+  std::unordered_set<int> excluded_ids;
+  const auto ExcludeValue = [&](pir::Value value) {
+    if (value && value_exe_info_->HasValue(value)) {
+      excluded_ids.insert(value_exe_info_->GetVarId(value));
+    }
+  };
+  std::unordered_set<const pir::Operation*> instr_ops;
+  for (auto& instr : vec_instruction_base_) {
+    instr_ops.insert(instr->Operation());
+  }
+  for (auto& op : *ir_block_) {
+    if (instr_ops.count(&op)) {
+      continue;
+    }
+    for (auto value : op.operands_source()) {
+      ExcludeValue(value);
+    }
+    for (auto value : op.results()) {
+      ExcludeValue(value);
+    }
+  }
+  const auto IsPlannable = [](InstructionBase* instr) {
+    if (dynamic_cast<PhiKernelInstruction*>(instr) == nullptr) {
+      return false;
+    }
+    pir::Operation* op = instr->Operation();
+    if (op->HasAttribute("is_inplace") &&
+        op->attribute<pir::BoolAttribute>("is_inplace").data()) {
+      return false;
+    }
+    const std::string op_name =
+        op->attribute<pir::StrAttribute>("op_name").AsString();
+    auto yaml_interface = pir::IrContext::Instance()
+                              ->GetRegisteredOpInfo(op_name)
+                              .GetInterfaceImpl<dialect::OpYamlInfoInterface>();
+    if (yaml_interface == nullptr) {
+      return false;
+    }
+    dialect::OpYamlInfoParser yaml_parser(yaml_interface->get_op_info_(op_name),
+                                          dialect::IsLegacyOp(op_name));
+    for (auto& name : yaml_parser.OutputNames()) {
+      if (yaml_parser.HasInplace(name) || yaml_parser.HasView(name)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::unordered_map<int, interpreter::BufferLifetime> lifetimes;
+  std::unordered_set<int> consumed_ids;
+  for (size_t pos = 0; pos < trace_execute_order_.size(); ++pos) {
+    InstructionBase* instr =
+        vec_instruction_base_[trace_execute_order_[pos]].get();
+    const bool plannable = IsPlannable(instr);
+    for (auto& kv : instr->Inputs()) {
+      for (size_t i = 0; i < kv.second.size(); ++i) {
+        const int id = kv.second[i];
+        auto it = lifetimes.find(id);
+        if (!plannable || i > 0 || it == lifetimes.end()) {
+          // the elements of a VariableRefArray, or a var defined outside
+          excluded_ids.insert(id);
+          continue;
+        }
+        it->second.last_use = pos;
+        consumed_ids.insert(id);
+      }
+    }
+    for (auto& kv : instr->Outputs()) {
+      for (size_t i = 0; i < kv.second.size(); ++i) {
+        const int id = kv.second[i];
+        if (!plannable || i > 0) {
+          excluded_ids.insert(id);
+          continue;
+        }
+        auto type = kv.first.type()
+                        .dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+        int64_t numel = 1;
+        if (type) {
+          for (int d = 0; d < type.dims().size(); ++d) {
+            numel = type.dims()[d] > 0 ? numel * type.dims()[d] : 0;
+          }
+        }
+        if (!type || numel == 0 || type.place() != place_) {
+          excluded_ids.insert(id);
+          continue;
+        }
+        auto& lifetime = lifetimes[id];
+        if (lifetime.size == 0) {
+          lifetime.first_use = pos;
+          lifetime.last_use = pos;
+        }
+        lifetime.size = std::max(
+            lifetime.size,
+            static_cast<size_t>(numel) *
+                phi::SizeOf(dialect::TransToPhiDataType(type.dtype())));
+      }
+    }
+  }
+
+  const auto IsVisible = [&](const std::string& name) {
+    return parameter_var_names_.count(name) ||
+           execution_config_.skip_gc_vars.count(name) ||
+           execution_config_.jit_input_vars.count(name) ||
+           execution_config_.force_root_scope_vars.count(name) ||
+           std::find(fetch_var_names_.begin(), fetch_var_names_.end(), name) !=
+               fetch_var_names_.end();
+  };
+  std::vector<int> var_ids;
+  std::vector<interpreter::BufferLifetime> buffers;
+  for (auto& kv : lifetimes) {
+    const int id = kv.first;
+    Variable* var = value_exe_info_->GetVarList()[id];
+    if (excluded_ids.count(id) || !consumed_ids.count(id) ||
+        !var->IsType<phi::DenseTensor>() ||
+        IsVisible(value_exe_info_->GetNameById(id))) {
+      continue;
+    }
+    var_ids.push_back(id);
+    buffers.push_back(kv.second);
+  }
+  if (buffers.empty()) {
+    return;
+  }
+
+  constexpr size_t kAlignment = 256;
+  const interpreter::StaticMemoryPlan plan =
+      interpreter::PlanStaticMemory(buffers, kAlignment);
+  static_memory_arena_ = memory::AllocShared(place_, plan.arena_size);
+  auto* base = static_cast<uint8_t*>(static_memory_arena_->ptr());
+  size_t total_size = 0;
+  for (size_t i = 0; i < var_ids.size(); ++i) {
+    auto* tensor = value_exe_info_->GetVarList()[var_ids[i]]
+                       ->GetMutable<phi::DenseTensor>();
+    // The allocation only refers to the arena, which outlives the tensors.
+    tensor->ResetHolder(std::make_shared<phi::Allocation>(
+        base + plan.offsets[i], buffers[i].size, place_));
+    static_memory_var_ids_.insert(static_cast<size_t>(var_ids[i]));
+    total_size += buffers[i].size;
+  }
+  VLOG(3) << "Plan " << var_ids.size() << " intermediate tensors of "
+          << total_size << " bytes into an arena of " << plan.arena_size
+          << " bytes";
+}
+
 Variable* PirInterpreter::DebugVar(const std::string& name) const {
   Scope* scope = HasLocalScope() ? local_scope_ : scope_;
   auto* var = scope->FindVar(name);
@@ -13,9 +13,12 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
 #include <memory>
+#include <vector>
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/interpreter_base_impl.h"
+#include "paddle/fluid/platform/cuda_graph_with_memory_pool.h"
 #include "paddle/pir/include/core/value.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -29,6 +32,7 @@ class Block;
 namespace paddle {
 namespace framework {
 class ValueExecutionInfo;
+class AsyncNanInfChecker;
 class PirInterpreter : public InterpreterBaseImpl {
   using ExecutionConfig = interpreter::ExecutionConfig;
   using InstructionSchedulingPriorityLess = std::function<bool(size_t, size_t)>;
@@ -141,6 +145,10 @@ class PirInterpreter : public InterpreterBaseImpl {
   // cuda graph
   void CheckCUDAGraphBeforeRun(const std::vector<std::string>& feed_names);
   void PrepareForCUDAGraphCapture();
+  // Replays (capturing it first if needed) the CUDA Graph of the current
+  // input shapes, returns false if the block should be run as usual.
+  bool CUDAGraphRunImpl();
+  bool CanCaptureCUDAGraph();
 
   void Build(const std::vector<std::string>& feed_names,
              std::vector<paddle::framework::OpFuncNode>* op_func_nodes,
@@ -187,6 +195,9 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   std::unique_ptr<InterpreterCoreGarbageCollector> gc_;
 
+  // created when FLAGS_check_nan_inf_async applies
+  std::unique_ptr<AsyncNanInfChecker> async_nan_inf_checker_;
+
   // last_live_ops_[i] contains the id of operators that last access the i-th
   // var
   std::map<size_t, std::set<size_t>> last_live_ops_;
@@ -204,6 +215,22 @@ class PirInterpreter : public InterpreterBaseImpl {
   int64_t onednn_op_num_{-1};
   std::vector<size_t> trace_execute_order_;
 
+  // used for auto CUDA Graph, -1 means not analysed yet
+  int cuda_graph_capturable_{-1};
+  std::vector<std::string> cuda_graph_input_names_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  struct CapturedCUDAGraph {
+    std::unique_ptr<platform::CUDAGraph> graph;
+    // The inputs are copied into these buffers before every replay.
+    std::vector<phi::DenseTensor> inputs;
+  };
+  // keyed by the dtypes and dims of the inputs
+  std::map<std::vector<int64_t>, CapturedCUDAGraph> cuda_graphs_;
+  // run count of each input shapes before capturing, -1 if capturing failed,
+  // holds at most 64 input shapes
+  std::map<std::vector<int64_t>, int> cuda_graph_warmup_steps_;
+#endif
+
   std::vector<PirHookFunc> pir_output_hookfuncs_;
   std::vector<PirHookFunc> pir_input_hookfuncs_;
 
@@ -224,6 +251,8 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   void BuildInstructionDependences();
 
+  bool UseAsyncNanInfChecker() const;
+
   void TraceRunImpl();
 
   void TraceRunInstructionList(
@@ -231,6 +260,12 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   void MultiThreadRunImpl();
 
+  // Whether the built instructions run by LowLatencyRunImpl, see
+  // ExecutionConfig::used_for_low_latency.
+  bool UseLowLatencyRun();
+
+  void LowLatencyRunImpl();
+
   void MultiThreadRunInstructionList(
       const std::vector<std::unique_ptr<InstructionBase>>& vec_instr);
 
@@ -251,6 +286,11 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   void SolvePersistableVarNames();
 
+  void BuildStaticMemoryPlan();
+
+  // Decide whether the instruction costs of this run are sampled.
+  void UpdateCostSampling();
+
   const interpreter::PirDependencyBuilder& GetPirDependencyBuilder() const;
 
   const interpreter::PirStreamAnalyzer& GetPirStreamAnalyzer() const;
@@ -278,6 +318,27 @@ class PirInterpreter : public InterpreterBaseImpl {
   // belongs to a parameter and cannot GC.
   std::unordered_set<std::string> parameter_var_names_;
 
+  // The arena holding the planned intermediate tensors, and their var ids
+  // which are skipped in GC.
+  std::shared_ptr<phi::Allocation> static_memory_arena_;
+  std::unordered_set<size_t> static_memory_var_ids_;
+
+  // The number of runs, and whether the instruction costs of the current run
+  // are sampled into interpreter::InstructionCostSampler.
+  uint64_t run_step_{0};
+  bool sample_cost_{false};
+
+  // The position of ir_block_ in its program and the base reserved from the
+  // generator for the current run, which key the counter based random seeds
+  // of the instructions, see FLAGS_new_executor_counter_based_rng.
+  uint64_t rng_block_position_{0};
+  uint64_t rng_base_{0};
+
+  // The instructions called in order by LowLatencyRunImpl, built on its first
+  // call, and whether the program supports it, decided at the same time.
+  std::vector<InstructionBase*> low_latency_instructions_;
+  bool low_latency_supported_{true};
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   std::unique_ptr<phi::CalculateStreamTimer> calculate_stream_timer_;
 #endif
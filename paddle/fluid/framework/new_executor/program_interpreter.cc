@@ -45,6 +45,7 @@ PHI_DECLARE_bool(enable_host_event_recorder_hook);
 PD_DECLARE_bool(log_memory_stats);
 COMMON_DECLARE_string(static_runtime_data_save_path);
 COMMON_DECLARE_bool(save_static_runtime_data);
+COMMON_DECLARE_int32(new_executor_auto_stream_num);
 namespace paddle {
 namespace framework {
 
@@ -698,10 +699,9 @@ std::tuple<double, double> ProgramInterpreter::InterpreterRunTime() {
   return std::make_tuple(start_time, end_time);
 }
 
-void ProgramInterpreter::Convert(
-    std::vector<paddle::framework::OpFuncNode>* op_func_nodes) {
-  auto& vec_meta_info = var_scope_.MutableVecMetaInfo();
-  auto nodes = *op_func_nodes;
+void ProgramInterpreter::BuildInstructions(
+    const std::vector<paddle::framework::OpFuncNode>& op_func_nodes) {
+  auto nodes = op_func_nodes;
   auto op_nums = nodes.size();
   vec_instruction_.clear();
   vec_instruction_.reserve(op_nums);
@@ -737,6 +737,34 @@ void ProgramInterpreter::Convert(
     vec_instruction_.back().UpdateRecordStreamForGcInfo();
 #endif
   }
+}
+
+void ProgramInterpreter::Convert(
+    std::vector<paddle::framework::OpFuncNode>* op_func_nodes) {
+  auto& vec_meta_info = var_scope_.MutableVecMetaInfo();
+  BuildInstructions(*op_func_nodes);
+
+  if (FLAGS_new_executor_auto_stream_num > 1 && phi::is_gpu_place(place_) &&
+      !FLAGS_new_executor_use_cuda_graph) {
+    // the outputs have been shaped by the first run (unless built
+    // statically), their sizes estimate the work of each instruction
+    std::vector<uint64_t> costs(vec_instruction_.size(), 0);
+    for (size_t i = 0; i < vec_instruction_.size(); ++i) {
+      for (auto& item : vec_instruction_[i].Outputs()) {
+        for (int var_id : item.second) {
+          auto* var = var_scope_.VarRef(var_id);
+          if (var != nullptr && var->IsType<phi::DenseTensor>() &&
+              var->Get<phi::DenseTensor>().numel() > 0) {
+            costs[i] += var->Get<phi::DenseTensor>().numel();
+          }
+        }
+      }
+    }
+    std::vector<OpFuncNode> nodes = *op_func_nodes;
+    if (stream_analyzer_.AssignAutoStreams(vec_instruction_, costs, &nodes)) {
+      BuildInstructions(nodes);
+    }
+  }
 
   BuildOperatorDependences();
 
@@ -1312,6 +1340,7 @@ void ProgramInterpreter::ExecuteInstructionList(
   if (logged_times.valid()) {
     VLOG(1) << "Logged deps for " << logged_times.get() << " times";
   }
+  gc_->FlushAll();
 
   if (UNLIKELY(exception_holder_.IsCaught())) {
     VLOG(1) << "Exception caught " << exception_holder_.Type();
@@ -1518,6 +1547,7 @@ void ProgramInterpreter::CheckGC(const Instruction& instr) {
       gc_->Add(refs_[var_id]->Var(), instr);
     }
   }
+  gc_->Flush(instr);
 }
 
 void ProgramInterpreter::Prepare(
@@ -1642,6 +1672,7 @@ void ProgramInterpreter::TraceInstructionList(
       break;
     }
   }
+  gc_->FlushAll();
 
   if (UNLIKELY(exception_holder_.IsCaught())) {
     VLOG(1) << "Exception caught " << exception_holder_.Type();
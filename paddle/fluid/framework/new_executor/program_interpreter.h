@@ -126,6 +126,8 @@ class ProgramInterpreter : public InterpreterBaseImpl {
  private:
   // build graph
   void Convert(std::vector<paddle::framework::OpFuncNode>* op_func_nodes);
+  void BuildInstructions(
+      const std::vector<paddle::framework::OpFuncNode>& op_func_nodes);
   void BuildOperatorDependences();
   void BuildAndCacheInstructionCtx(Instruction* instr_node);
   void BuildSkipShareLoDInfo();
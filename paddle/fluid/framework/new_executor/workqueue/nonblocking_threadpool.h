@@ -156,6 +156,12 @@ class ThreadPoolTempl {
 
   size_t NumThreads() const { return num_threads_; }
 
+  // Pin the thread_id-th worker to cpus.
+  bool SetThreadAffinity(int thread_id, const std::vector<int>& cpus) {
+    assert(thread_id >= 0 && thread_id < num_threads_);
+    return thread_data_[thread_id].thread->SetAffinity(cpus);
+  }
+
   int CurrentThreadId() const {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
     if (pt->pool == this) {
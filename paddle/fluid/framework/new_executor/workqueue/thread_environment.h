@@ -11,6 +11,12 @@
 
 #include <functional>
 #include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace paddle {
 namespace framework {
@@ -30,6 +36,22 @@ struct StlThreadEnvironment {
         thr_.join();
       }
     }
+    // Restrict the thread to run on cpus, returns false if unsupported.
+    bool SetAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+          CPU_SET(cpu, &cpu_set);
+        }
+      }
+      return pthread_setaffinity_np(
+                 thr_.native_handle(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+      return false;
+#endif
+    }
     ~EnvThread() {
       if (thr_.joinable()) {
         thr_.join();
@@ -6,6 +6,9 @@
 
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "paddle/fluid/framework/new_executor/workqueue/nonblocking_threadpool.h"
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -35,6 +38,35 @@ namespace {
 
 using TaskTracker = TaskTracker<EventsWaiter::EventNotifier>;
 
+// Splits the workers of pool into one steal partition per NUMA node, and pins
+// every worker to the cpus of its node.
+void PlaceOnNumaNodes(const std::string& name, NonblockingThreadPool* pool) {
+  auto nodes = GetNumaNodeCpus();
+  int num_threads = static_cast<int>(pool->NumThreads());
+  int num_nodes = std::min(static_cast<int>(nodes.size()), num_threads);
+  if (num_nodes < 2) {
+    VLOG(1) << "WorkQueue " << name << " has " << num_threads
+            << " threads on " << nodes.size()
+            << " NUMA nodes, skip NUMA aware placement.";
+    return;
+  }
+  std::vector<std::pair<unsigned, unsigned>> partitions(num_threads);
+  for (int node = 0; node < num_nodes; ++node) {
+    unsigned start = node * num_threads / num_nodes;
+    unsigned limit = (node + 1) * num_threads / num_nodes;
+    for (unsigned i = start; i < limit; ++i) {
+      partitions[i] = std::make_pair(start, limit);
+      if (!pool->SetThreadAffinity(static_cast<int>(i), nodes[node])) {
+        LOG(WARNING) << "Fail to pin thread " << i << " of WorkQueue " << name
+                     << " to NUMA node " << node;
+      }
+    }
+    VLOG(1) << "WorkQueue " << name << " threads [" << start << ", " << limit
+            << ") are placed on NUMA node " << node;
+  }
+  pool->SetStealPartitions(partitions);
+}
+
 class WorkQueueImpl : public WorkQueue {
  public:
   explicit WorkQueueImpl(const WorkQueueOptions& options) : WorkQueue(options) {
@@ -51,6 +83,9 @@ class WorkQueueImpl : public WorkQueue {
                                        static_cast<int>(options_.num_threads),
                                        options_.allow_spinning,
                                        options_.always_spinning);
+    if (options_.numa_aware) {
+      PlaceOnNumaNodes(options_.name, queue_);
+    }
   }
 
   ~WorkQueueImpl() override {
@@ -144,6 +179,9 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
                               static_cast<int>(options.num_threads),
                               options.allow_spinning,
                               options.always_spinning);
+    if (options.numa_aware) {
+      PlaceOnNumaNodes(options.name, queues_[idx]);
+    }
   }
 }
 
@@ -102,6 +102,11 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // Worker threads are split into one steal partition per NUMA node and
+  // pinned to the cpus of their node if this flag is set, so that tasks are
+  // stolen within a socket first and memory first touched by a worker is
+  // allocated on its local node.
+  bool numa_aware{false};
 };
 
 class WorkQueue {
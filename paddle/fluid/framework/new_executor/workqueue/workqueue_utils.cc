@@ -14,8 +14,15 @@
 
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
+#include <sstream>
 
 namespace paddle::framework {
 
@@ -55,4 +62,77 @@ void AlignedFree(void* mem_ptr) {
 #endif
 }
 
+std::vector<std::vector<int>> GetNumaNodeCpus() {
+  std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+  constexpr int kMaxNumaNodes = 64;
+  for (int node = 0; node < kMaxNumaNodes; ++node) {
+    std::ifstream fin("/sys/devices/system/node/node" + std::to_string(node) +
+                      "/cpulist");
+    if (!fin) continue;
+    // cpulist looks like "0-23,48-71"
+    std::vector<int> cpus;
+    std::string range;
+    while (std::getline(fin, range, ',')) {
+      int first = -1, last = -1;
+      char dash = 0;
+      std::istringstream iss(range);
+      iss >> first;
+      if (iss >> dash >> last) {
+        if (dash != '-') continue;
+      } else {
+        last = first;
+      }
+      for (int cpu = first; cpu >= 0 && cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    // Memory only nodes have no cpus.
+    if (!cpus.empty()) {
+      nodes.emplace_back(std::move(cpus));
+    }
+  }
+#endif
+  return nodes;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) ==
+         0;
+#else
+  return false;
+#endif
+}
+
+int GetCurrentNumaNode() {
+#if defined(__linux__)
+  static const std::vector<int> cpu_nodes = []() {
+    std::vector<int> cpu_nodes;
+    auto nodes = GetNumaNodeCpus();
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      for (int cpu : nodes[node]) {
+        if (static_cast<size_t>(cpu) >= cpu_nodes.size()) {
+          cpu_nodes.resize(cpu + 1, 0);
+        }
+        cpu_nodes[cpu] = static_cast<int>(node);
+      }
+    }
+    return cpu_nodes;
+  }();
+  int cpu = sched_getcpu();
+  if (cpu >= 0 && static_cast<size_t>(cpu) < cpu_nodes.size()) {
+    return cpu_nodes[cpu];
+  }
+#endif
+  return 0;
+}
+
 }  // namespace paddle::framework
@@ -21,6 +21,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/framework/new_executor/workqueue/events_waiter.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -69,6 +70,17 @@ void* AlignedMalloc(size_t size, size_t alignment);
 
 void AlignedFree(void* memory_ptr);
 
+// Returns the cpus of each online NUMA node, or an empty vector if the
+// topology is unknown.
+std::vector<std::vector<int>> GetNumaNodeCpus();
+
+// Restricts the calling thread to run on cpus, returns false if unsupported.
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus);
+
+// Returns the index in GetNumaNodeCpus() of the node of the cpu the calling
+// thread runs on, or 0 if unknown.
+int GetCurrentNumaNode();
+
 template <typename Notifier>
 class TaskTracker {
  public:
@@ -11,10 +11,14 @@ distributed under the License is distributed on an "AS IS" BASIS,
 WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
+#include <cstring>
 #include <ctime>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/device_worker.h"
 
+COMMON_DECLARE_bool(pull_dense_delta_copy);
+
 namespace phi {
 class DenseTensor;
 }  // namespace phi
@@ -126,41 +130,77 @@ void PullDenseWorker::Wait(std::vector<::std::future<int32_t>>* status_vec) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
     defined(PADDLE_WITH_XPU)
 
-  for (size_t i = 0; i < places_.size(); ++i) {
-    // for (auto& v : dense_value_names_) {
-    //  for (auto& name : v.second) {
-    for (int x = 0; x < dwp_param_.program_config(0).pull_dense_table_id_size();
-         ++x) {
-      uint64_t tid = static_cast<uint64_t>(
-          dwp_param_.program_config(0).pull_dense_table_id(x));
-      for (auto& name : dense_value_names_[tid]) {
-        Variable* pin_var = root_scope_->FindVar(name + "pin");
-        phi::DenseTensor* pin_tensor = pin_var->GetMutable<phi::DenseTensor>();
-        float* pin_w = pin_tensor->data<float>();
+  // for (auto& v : dense_value_names_) {
+  //  for (auto& name : v.second) {
+  for (int x = 0; x < dwp_param_.program_config(0).pull_dense_table_id_size();
+       ++x) {
+    uint64_t tid = static_cast<uint64_t>(
+        dwp_param_.program_config(0).pull_dense_table_id(x));
+    for (auto& name : dense_value_names_[tid]) {
+      Variable* pin_var = root_scope_->FindVar(name + "pin");
+      phi::DenseTensor* pin_tensor = pin_var->GetMutable<phi::DenseTensor>();
+      float* pin_w = pin_tensor->data<float>();
+      auto ranges = ChangedRanges(name, pin_w, pin_tensor->numel());
+      for (size_t i = 0; i < places_.size(); ++i) {
         Variable* var = thread_scopes_[i]->FindVar(name);
         phi::DenseTensor* tensor = var->GetMutable<phi::DenseTensor>();
         float* w = tensor->data<float>();
+        for (auto& range : ranges) {
+          size_t bytes = sizeof(float) * (range.second - range.first);
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-        memory::Copy(places_[i],
-                     w,
-                     phi::GPUPinnedPlace(),
-                     pin_w,
-                     sizeof(float) * tensor->numel(),
-                     copy_streams_[i]);
+          memory::Copy(places_[i],
+                       w + range.first,
+                       phi::GPUPinnedPlace(),
+                       pin_w + range.first,
+                       bytes,
+                       copy_streams_[i]);
 #endif
 #ifdef PADDLE_WITH_XPU
-        memory::Copy(places_[i],
-                     w,
-                     phi::CPUPlace(),
-                     pin_w,
-                     sizeof(float) * tensor->numel());
+          memory::Copy(places_[i],
+                       w + range.first,
+                       phi::CPUPlace(),
+                       pin_w + range.first,
+                       bytes);
 #endif
+        }
       }
     }
   }
 #endif
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
+    defined(PADDLE_WITH_XPU)
+std::vector<std::pair<int64_t, int64_t>> PullDenseWorker::ChangedRanges(
+    const std::string& name, const float* values, int64_t numel) {
+  if (!FLAGS_pull_dense_delta_copy) {
+    return {{0, numel}};
+  }
+  auto& synced = synced_values_[name];
+  if (static_cast<int64_t>(synced.size()) != numel) {
+    synced.assign(values, values + numel);
+    return {{0, numel}};
+  }
+  // merge the adjacent changed blocks into one copy
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (int64_t begin = 0; begin < numel; begin += kDenseSyncBlockSize) {
+    int64_t end = std::min(begin + kDenseSyncBlockSize, numel);
+    size_t bytes = sizeof(float) * (end - begin);
+    if (std::memcmp(values + begin, synced.data() + begin, bytes) == 0) {
+      continue;
+    }
+    std::memcpy(synced.data() + begin, values + begin, bytes);
+    if (!ranges.empty() && ranges.back().second == begin) {
+      ranges.back().second = end;
+    } else {
+      ranges.emplace_back(begin, end);
+    }
+  }
+  VLOG(3) << "Copy " << ranges.size() << " changed ranges of dense " << name;
+  return ranges;
+}
+#endif
+
 void PullDenseWorker::Stop() {
   if (running_) {
     running_ = false;
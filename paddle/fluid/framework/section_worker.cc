@@ -10,14 +10,30 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+#include <algorithm>
 #include <cfloat>
+#include <chrono>
+#include <unordered_set>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/framework/executor_gc_helper.h"
 #include "paddle/fluid/platform/device_context.h"
 
+COMMON_DECLARE_int32(pipeline_utilization_report_interval);
+
 namespace paddle::framework {
 
+namespace {
+
+bool IsP2POp(const std::string &op_type) {
+  return op_type == "send_v2" || op_type == "recv_v2" ||
+         op_type == "partial_send" || op_type == "partial_recv" ||
+         op_type == "partial_allgather";
+}
+
+}  // namespace
+
 class TrainerDesc;
 
 uint64_t SectionWorker::batch_id_(0);
@@ -57,8 +73,12 @@ void SectionWorker::Initialize(const TrainerDesc &desc) {
     }
   }
 
-  // if not 1F1B scheduler
-  if (schedule_mode_ != 1) return;
+  if (schedule_mode_ == 2) {
+    SplitBackwardOps();
+  }
+
+  // if F-then-B scheduler
+  if (schedule_mode_ == 0) return;
 
   bool is_first_stage = (pipeline_stage_ == 0);
   int BACKWARD = static_cast<int>(OpRole::kBackward);
@@ -84,6 +104,114 @@ void SectionWorker::Initialize(const TrainerDesc &desc) {
   }
 }
 
+std::unordered_set<const OperatorBase *> SectionWorker::FindWeightGradOps(
+    const std::vector<OperatorBase *> &backward_ops) {
+  // Walks the backward ops in reverse, an op is needed by the backward send
+  // ops if it writes a var they read, directly or not. The others compute
+  // only the gradients of the parameters and can be deferred. The ops with
+  // side effects, e.g. with no output or with a sub block, stay in place.
+  std::unordered_set<std::string> needed_vars;
+  std::unordered_set<const OperatorBase *> weight_grad_ops;
+  for (auto iter = backward_ops.rbegin(); iter != backward_ops.rend();
+       ++iter) {
+    auto *op = *iter;
+    bool needed = IsP2POp(op->Type()) || op->Outputs().empty() ||
+                  op->HasAttr("sub_block");
+    for (auto &output : op->Outputs()) {
+      for (auto &var_name : output.second) {
+        if (needed_vars.count(var_name)) {
+          needed = true;
+        }
+      }
+    }
+    if (!needed) {
+      weight_grad_ops.insert(op);
+      continue;
+    }
+    for (auto &input : op->Inputs()) {
+      needed_vars.insert(input.second.begin(), input.second.end());
+    }
+  }
+  return weight_grad_ops;
+}
+
+void SectionWorker::SplitBackwardOps() {
+  auto weight_grad_ops = FindWeightGradOps(backward_ops_);
+  std::vector<OperatorBase *> input_grad_ops;
+  for (auto *op : backward_ops_) {
+    if (weight_grad_ops.count(op)) {
+      weight_grad_ops_.push_back(op);
+    } else {
+      input_grad_ops.push_back(op);
+    }
+  }
+  backward_ops_.swap(input_grad_ops);
+  VLOG(3) << "Split the backward into " << backward_ops_.size()
+          << " input gradient ops and " << weight_grad_ops_.size()
+          << " weight gradient ops";
+
+  // The deferred ops are moved before the optimizer ops, so that the unused
+  // vars are collected in the order they run for a micro-batch.
+  std::vector<std::unique_ptr<OperatorBase>> ops;
+  std::vector<std::unique_ptr<OperatorBase>> deferred_ops;
+  for (auto &op : ops_) {
+    if (weight_grad_ops.count(op.get())) {
+      deferred_ops.push_back(std::move(op));
+      continue;
+    }
+    if (!deferred_ops.empty() &&
+        op->Attr<int>("op_role") == static_cast<int>(OpRole::kOptimize)) {
+      for (auto &deferred_op : deferred_ops) {
+        ops.push_back(std::move(deferred_op));
+      }
+      deferred_ops.clear();
+    }
+    ops.push_back(std::move(op));
+  }
+  for (auto &deferred_op : deferred_ops) {
+    ops.push_back(std::move(deferred_op));
+  }
+  ops_.swap(ops);
+}
+
+void SectionWorker::RunOp(OperatorBase *op, const Scope &scope, Phase phase) {
+  if (FLAGS_pipeline_utilization_report_interval <= 0) {
+    op->Run(scope, place_);
+    return;
+  }
+  // The device is synchronized around the ops so that the time of each is
+  // the time it takes on the device. A send or recv op counts as waiting.
+  auto start = std::chrono::steady_clock::now();
+  op->Run(scope, place_);
+  dev_ctx_->Wait();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  phase_time_[IsP2POp(op->Type()) ? kWait : phase] += elapsed.count();
+}
+
+void SectionWorker::ReportUtilization() {
+  if (FLAGS_pipeline_utilization_report_interval <= 0 ||
+      ++reported_batches_ < FLAGS_pipeline_utilization_report_interval) {
+    return;
+  }
+  double total = 0;
+  for (double time : phase_time_) {
+    total += time;
+  }
+  auto percent = [&](Phase phase) {
+    return total > 0 ? phase_time_[phase] * 100 / total : 0;
+  };
+  LOG(INFO) << "Pipeline stage " << pipeline_stage_ << " spent " << total
+            << " ms in the last " << reported_batches_
+            << " batches, forward: " << percent(kForward)
+            << "%, backward: " << percent(kBackward)
+            << "%, weight gradient: " << percent(kWeightGrad)
+            << "%, update: " << percent(kUpdate)
+            << "%, waiting on send/recv: " << percent(kWait) << "%";
+  std::fill(std::begin(phase_time_), std::end(phase_time_), 0);
+  reported_batches_ = 0;
+}
+
 void SectionWorker::PrepareUnusedVar() {
   VLOG(5) << "begin prepare the unused vars";
   unused_vars_ = GetUnusedVars(program_->Block(0), ops_, skip_vars_);
@@ -99,7 +227,7 @@ void SectionWorker::RunForward(
   for (auto &op : forward_tmp) {
     VLOG(3) << "Forward: running op " << op->Type() << " for micro-batch "
             << micro_id;
-    op->Run(*microbatch_scopes_[micro_id], place_);
+    RunOp(op, *microbatch_scopes_[micro_id], kForward);
     if (gc) {
       DeleteUnusedTensors(
           *microbatch_scopes_[micro_id], op, unused_vars_, gc.get());
@@ -115,7 +243,23 @@ void SectionWorker::RunBackward(
   for (auto &op : backward_ops_) {
     VLOG(3) << "Backward: running op " << op->Type() << " for micro-batch "
             << micro_id;
-    op->Run(*microbatch_scopes_[micro_id], place_);
+    RunOp(op, *microbatch_scopes_[micro_id], kBackward);
+    if (gc) {
+      DeleteUnusedTensors(
+          *microbatch_scopes_[micro_id], op, unused_vars_, gc.get());
+    }
+  }
+}
+
+void SectionWorker::RunWeightGrad(
+    int micro_id,
+    std::unique_ptr<GarbageCollector> &gc,
+    std::unordered_map<const OperatorBase *, std::vector<std::string>>
+        &unused_vars_) {
+  for (auto &op : weight_grad_ops_) {
+    VLOG(3) << "WeightGrad: running op " << op->Type() << " for micro-batch "
+            << micro_id;
+    RunOp(op, *microbatch_scopes_[micro_id], kWeightGrad);
     if (gc) {
       DeleteUnusedTensors(
           *microbatch_scopes_[micro_id], op, unused_vars_, gc.get());
@@ -129,7 +273,7 @@ void SectionWorker::RunUpdate(
         &unused_vars_) {
   for (auto &op : optimizer_ops_) {
     VLOG(3) << "Update: running op " << op->Type();
-    op->Run(*microbatch_scopes_[num_microbatches_ - 1], place_);
+    RunOp(op, *microbatch_scopes_[num_microbatches_ - 1], kUpdate);
     if (gc) {
       DeleteUnusedTensors(*microbatch_scopes_[num_microbatches_ - 1],
                           op,
@@ -220,6 +364,101 @@ void SectionWorker::Run1F1B(std::unique_ptr<GarbageCollector> &gc) {
   }
 }
 
+std::vector<SectionWorker::ScheduleStep> SectionWorker::ZeroBubbleSchedule(
+    int num_microbatches, int num_stages, int stage) {
+  // ZB-H1 runs like 1F1B but splits the backward phase into the input
+  // gradient (B) and the weight gradient (W). B is sent to the previous
+  // stage as soon as it is done while W is deferred, a stage keeps up to
+  // startup_steps Ws pending and runs them in the bubbles of the cooldown,
+  // where it waits for the gradients of the next stage.
+  int startup_steps = num_stages - stage - 1;
+  std::vector<ScheduleStep> steps;
+  steps.reserve(3 * num_microbatches);
+  int fw_step = 0;
+  int bw_step = 0;
+  int wg_step = 0;
+
+  // startup phase
+  while (fw_step < startup_steps) {
+    steps.push_back({kForward, fw_step++});
+  }
+
+  // 1f1b1w phase
+  while (fw_step < num_microbatches) {
+    steps.push_back({kForward, fw_step++});
+    steps.push_back({kBackward, bw_step++});
+    if (bw_step - wg_step > startup_steps) {
+      steps.push_back({kWeightGrad, wg_step++});
+    }
+  }
+
+  // backward phase, a pending W fills the bubble after each B
+  while (bw_step < num_microbatches) {
+    steps.push_back({kBackward, bw_step++});
+    steps.push_back({kWeightGrad, wg_step++});
+  }
+
+  while (wg_step < num_microbatches) {
+    steps.push_back({kWeightGrad, wg_step++});
+  }
+  return steps;
+}
+
+void SectionWorker::RunZeroBubble(std::unique_ptr<GarbageCollector> &gc) {
+  auto startup_steps = num_pipeline_stages_ - pipeline_stage_ - 1;
+  VLOG(3) << "startup_steps:" << startup_steps
+          << ", num_stages: " << num_pipeline_stages_
+          << ", stage:" << pipeline_stage_;
+  PADDLE_ENFORCE_GT(
+      num_microbatches_,
+      startup_steps,
+      common::errors::InvalidArgument(
+          "To use pipeline with ZB-H1 scheduler, please make sure number of "
+          "microbatches (%d) is than startup steps (%d).",
+          num_microbatches_,
+          startup_steps));
+
+  // the backward send vars of the micro-batches before this one are deleted
+  int bw_send_deleted = 0;
+  Phase last_phase = kUpdate;
+  for (const auto &step : ZeroBubbleSchedule(
+           num_microbatches_, num_pipeline_stages_, pipeline_stage_)) {
+    switch (step.phase) {
+      case kForward:
+        RunForward(step.micro_id, gc, unused_vars_);
+        break;
+      case kBackward:
+        // in the 1f1b1w phase, delete the backward send var of two steps
+        // before, the others are kept until the update
+        if (gc && last_phase == kForward && step.micro_id >= 2) {
+          DeleteUnusedTensors(*microbatch_scopes_[step.micro_id - 2],
+                              backward_send_vars_,
+                              gc.get());
+          bw_send_deleted = step.micro_id - 1;
+        }
+        RunBackward(step.micro_id, gc, unused_vars_);
+        break;
+      default:
+        RunWeightGrad(step.micro_id, gc, unused_vars_);
+        break;
+    }
+    last_phase = step.phase;
+    VLOG(2) << "micro step phase:" << step.phase
+            << ", micro_id:" << step.micro_id;
+  }
+
+  VLOG(2) << "run update";
+  RunUpdate(gc, unused_vars_);
+
+  if (gc) {
+    // delete backward send var
+    for (int i = bw_send_deleted; i < num_microbatches_; ++i) {
+      DeleteUnusedTensors(
+          *microbatch_scopes_[i], backward_send_vars_, gc.get());
+    }
+  }
+}
+
 void SectionWorker::TrainFiles() {
   VLOG(5) << "begin section_worker TrainFiles";
   VLOG(2) << "mini batch steps:" << batch_id_;
@@ -239,11 +478,14 @@ void SectionWorker::TrainFiles() {
 
   if (schedule_mode_ == 0) {  // NOLINT
     RunFThenB(gc);
+  } else if (schedule_mode_ == 2) {
+    RunZeroBubble(gc);
   } else {
     Run1F1B(gc);
   }
 
   dev_ctx_->Wait();
+  ReportUtilization();
   ++batch_id_;
 }
 
@@ -15,12 +15,15 @@ limitations under the License. */
 #include "paddle/fluid/framework/tensor_util.h"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
@@ -32,6 +35,15 @@ limitations under the License. */
 #include "dnnl_debug.h"  // NOLINT
 #endif
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+COMMON_DECLARE_bool(use_stride_kernel);
+
 namespace paddle {
 namespace framework {
 
@@ -579,6 +591,109 @@ struct DeserializedDataFunctor {
   phi::Place place_;
 };
 
+MappedFileStreamBuf::MappedFileStreamBuf(const std::string& path) {
+#if !defined(_WIN32)
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) return;
+  struct stat sb = {};
+  if (fstat(fd, &sb) == 0 && sb.st_size > 0) {
+    void* ptr = mmap(nullptr,
+                     static_cast<size_t>(sb.st_size),
+                     PROT_READ,
+                     MAP_PRIVATE,
+                     fd,
+                     0);
+    if (ptr != MAP_FAILED) {
+      base_ = static_cast<char*>(ptr);
+      size_ = static_cast<size_t>(sb.st_size);
+      // Parameters are consumed front to back exactly once.
+      madvise(base_, size_, MADV_SEQUENTIAL);
+      setg(base_, base_, base_ + size_);
+    } else {
+      VLOG(3) << "Fail to mmap " << path << ", error: " << strerror(errno);
+    }
+  }
+  close(fd);
+#endif
+}
+
+MappedFileStreamBuf::~MappedFileStreamBuf() {
+#if !defined(_WIN32)
+  if (base_ != nullptr) {
+    munmap(base_, size_);
+  }
+#endif
+}
+
+void MappedFileStreamBuf::Skip(size_t n) {
+  PADDLE_ENFORCE_LE(n,
+                    remaining(),
+                    common::errors::OutOfRange(
+                        "Skip %d bytes of the mapped file, but only %d bytes "
+                        "remain.",
+                        n,
+                        remaining()));
+  setg(eback(), gptr() + n, egptr());
+}
+
+MappedFileStreamBuf::pos_type MappedFileStreamBuf::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  off_type base = 0;
+  if (dir == std::ios_base::cur) {
+    base = gptr() - eback();
+  } else if (dir == std::ios_base::end) {
+    base = static_cast<off_type>(size_);
+  }
+  return seekpos(pos_type(base + off), which);
+}
+
+MappedFileStreamBuf::pos_type MappedFileStreamBuf::seekpos(
+    pos_type pos, std::ios_base::openmode which) {
+  off_type offset = static_cast<off_type>(pos);
+  if (!(which & std::ios_base::in) || offset < 0 ||
+      offset > static_cast<off_type>(size_)) {
+    return pos_type(off_type(-1));
+  }
+  setg(eback(), eback() + offset, egptr());
+  return pos;
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// Copies size bytes from a mapped file to device memory. Every chunk is first
+// copied into one of two pinned buffers, so that faulting in and copying the
+// next chunk on the host overlaps with the DMA of the previous one, and the
+// device copy never goes through the driver's pageable staging path.
+static void CopyMappedToDevice(const char* src,
+                               size_t size,
+                               void* dst,
+                               const phi::DeviceContext& dev_ctx) {
+  if (size == 0) return;
+  constexpr size_t kStagingChunkSize = 16UL << 20;
+  auto& gpu_ctx = static_cast<const phi::GPUContext&>(dev_ctx);
+  auto dst_place = gpu_ctx.GetPlace();
+  size_t chunk_size = std::min(size, kStagingChunkSize);
+  std::array<memory::AllocationPtr, 2> staging = {
+      memory::Alloc(phi::GPUPinnedPlace(), chunk_size),
+      memory::Alloc(phi::GPUPinnedPlace(), chunk_size)};
+  size_t chunk_id = 0;
+  for (size_t offset = 0; offset < size; offset += chunk_size, ++chunk_id) {
+    size_t num = std::min(chunk_size, size - offset);
+    char* stage = static_cast<char*>(staging[chunk_id % 2]->ptr());
+    // The copy that last used this buffer was waited on before the previous
+    // chunk was issued, so it is free to be filled again.
+    std::memcpy(stage, src + offset, num);
+    gpu_ctx.Wait();
+    memory::Copy(dst_place,
+                 static_cast<char*>(dst) + offset,
+                 phi::GPUPinnedPlace(),
+                 stage,
+                 num,
+                 gpu_ctx.stream());
+  }
+  gpu_ctx.Wait();
+}
+#endif
+
 void TensorFromStream(std::istream& is,
                       phi::DenseTensor* tensor,
                       const phi::DeviceContext& dev_ctx,
@@ -690,6 +805,23 @@ void TensorFromStream(std::istream& is,
     if (phi::is_gpu_place(dev_ctx.GetPlace()) ||
         phi::is_xpu_place(dev_ctx.GetPlace()) ||
         phi::is_custom_place(dev_ctx.GetPlace())) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      auto* mapped = dynamic_cast<MappedFileStreamBuf*>(is.rdbuf());
+      if (mapped != nullptr && phi::is_gpu_place(dev_ctx.GetPlace())) {
+        PADDLE_ENFORCE_GE(
+            mapped->remaining(),
+            size,
+            common::errors::Unavailable(
+                "The mapped file ends before the tensor data, please check "
+                "whether the model file is complete or damaged."));
+        framework::VisitDataType(
+            desc.data_type(),
+            DeserializedDataFunctor(&buf, tensor, dev_ctx.GetPlace()));
+        CopyMappedToDevice(mapped->current(), size, buf, dev_ctx);
+        mapped->Skip(size);
+        return;
+      }
+#endif
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
     defined(PADDLE_WITH_XPU) || defined(PADDLE_WITH_CUSTOM_DEVICE)
       phi::DenseTensor cpu_tensor;
@@ -833,44 +965,151 @@ void TensorFromDLPack(const ::DLTensor& dl_tensor, phi::DenseTensor* dst) {
 #endif
 }
 
-void TensorFromDLPack(const DLManagedTensor* src, phi::DenseTensor* dst) {
-  std::vector<int64_t> vec;
-  std::copy(src->dl_tensor.shape,
-            src->dl_tensor.shape + src->dl_tensor.ndim,
-            std::back_inserter(vec));
+namespace {
 
-  phi::DDim vddim = common::make_ddim(vec);
-  dst->Resize(vddim);
-  ::DLDataType type = src->dl_tensor.dtype;
+// Shares the memory of a DLManagedTensor and returns it to its producer
+// through the deleter when the last tensor holding it is released.
+class DLPackAllocation : public phi::Allocation {
+ public:
+  DLPackAllocation(DLManagedTensor* src,
+                   void* ptr,
+                   size_t size,
+                   const phi::Place& place)
+      : Allocation(ptr, size, place), src_(src) {}
 
-  auto src_ptr = static_cast<const void*>(src->dl_tensor.data);
-  auto size = common::product(vddim) * type.bits / 8;
+  ~DLPackAllocation() override {
+    if (src_->deleter) {
+      src_->deleter(src_);
+    }
+  }
 
-  if (src->dl_tensor.device.device_type == kDLCPU) {
-    phi::CPUPlace dst_place = phi::CPUPlace();
-    phi::CPUPlace src_place = phi::CPUPlace();
-    void* dst_ptr = GetDstPtrByDLDataType(type, dst, dst_place);
-    memory::Copy(dst_place, dst_ptr, src_place, src_ptr, size);
+ private:
+  DLManagedTensor* src_;
+};
+
+phi::DataType GetDataTypeByDLDataType(DLDataType type) {
+  PADDLE_ENFORCE_LE(
+      type.lanes,
+      1,
+      common::errors::Unimplemented("Vector type is not supported currently."));
+  switch (type.code) {
+    case kDLInt:
+      switch (type.bits) {
+        case 8:
+          return phi::DataType::INT8;
+        case 16:
+          return phi::DataType::INT16;
+        case 32:
+          return phi::DataType::INT32;
+        case 64:
+          return phi::DataType::INT64;
+      }
+      break;
+    case kDLUInt:
+      switch (type.bits) {
+        case 8:
+          return phi::DataType::UINT8;
+        case 16:
+          return phi::DataType::UINT16;
+        case 32:
+          return phi::DataType::UINT32;
+        case 64:
+          return phi::DataType::UINT64;
+      }
+      break;
+    case kDLFloat:
+      switch (type.bits) {
+        case 16:
+          return phi::DataType::FLOAT16;
+        case 32:
+          return phi::DataType::FLOAT32;
+        case 64:
+          return phi::DataType::FLOAT64;
+      }
+      break;
+    case kDLBfloat:
+      if (type.bits == 16) return phi::DataType::BFLOAT16;
+      break;
+    case kDLComplex:
+      if (type.bits == 64) return phi::DataType::COMPLEX64;
+      if (type.bits == 128) return phi::DataType::COMPLEX128;
+      break;
   }
+  PADDLE_THROW(common::errors::Unimplemented(
+      "DLDataType code <%d> is illegal when DLDataType.bits is <%d>.",
+      type.code,
+      type.bits));
+}
+
+phi::Place GetPlaceByDLDevice(const DLDevice& device) {
+  switch (device.device_type) {
+    case kDLCPU:
+      return phi::CPUPlace();
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-  if (src->dl_tensor.device.device_type == kDLGPU) {
-    phi::GPUPlace dst_place = phi::GPUPlace(src->dl_tensor.device.device_id);
-    phi::GPUPlace src_place = phi::GPUPlace(src->dl_tensor.device.device_id);
-    void* dst_ptr = GetDstPtrByDLDataType(type, dst, dst_place);
-    auto* ctx = phi::DeviceContextPool::Instance().GetByPlace(dst_place);
-    // Fix copy by share allocation.
-    memory::Copy(dst_place,
-                 dst_ptr,
-                 src_place,
-                 src_ptr,
-                 size,
-                 reinterpret_cast<const phi::GPUContext&>(*ctx).stream());
-  }
-#endif
-  src->deleter(const_cast<DLManagedTensor*>(src));
-#ifdef PADDLE_WITH_XPU
-  PADDLE_THROW(common::errors::Unimplemented("XPUPlace is not supported"));
+    case kDLGPU:
+      return phi::GPUPlace(device.device_id);
+    case kDLCPUPinned:
+      return phi::GPUPinnedPlace();
 #endif
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "DLDevice type <%d> is not supported.", device.device_type));
+  }
+}
+
+}  // namespace
+
+// The memory of src is shared instead of copied, with the byte_offset and
+// the strides of src kept in the meta of dst, so dst owns src from now on.
+void TensorFromDLPack(const DLManagedTensor* src, phi::DenseTensor* dst) {
+  // returns src to its producer if it can not be shared
+  std::unique_ptr<DLManagedTensor, void (*)(DLManagedTensor*)> guard(
+      const_cast<DLManagedTensor*>(src),
+      [](DLManagedTensor* t) {
+        if (t->deleter) {
+          t->deleter(t);
+        }
+      });
+  const ::DLTensor& dl_tensor = src->dl_tensor;
+  phi::Place place = GetPlaceByDLDevice(dl_tensor.device);
+  phi::DataType dtype = GetDataTypeByDLDataType(dl_tensor.dtype);
+
+  std::vector<int64_t> shape(dl_tensor.shape,
+                             dl_tensor.shape + dl_tensor.ndim);
+  phi::DenseTensorMeta meta(dtype, common::make_ddim(shape));
+  // nullptr strides are the compact ones, and the strides of the
+  // dimensions of size 1 do not matter
+  phi::DDim strides = meta.strides;
+  if (dl_tensor.strides != nullptr) {
+    for (int i = 0; i < dl_tensor.ndim; ++i) {
+      PADDLE_ENFORCE_GE(dl_tensor.strides[i],
+                        0,
+                        common::errors::Unimplemented(
+                            "Negative DLTensor strides are not supported."));
+      if (shape[i] != 1) {
+        strides[i] = dl_tensor.strides[i];
+      }
+    }
+  }
+  if (strides != meta.strides) {
+    PADDLE_ENFORCE_EQ(FLAGS_use_stride_kernel,
+                      true,
+                      common::errors::Unimplemented(
+                          "The DLTensor is not compact, which can only be "
+                          "shared with FLAGS_use_stride_kernel on."));
+    meta.strides = strides;
+  }
+  // the elements in the memory span of the tensor
+  int64_t span = common::product(meta.dims) != 0 ? 1 : 0;
+  for (int i = 0; span != 0 && i < dl_tensor.ndim; ++i) {
+    span += (shape[i] - 1) * strides[i];
+  }
+
+  void* ptr = static_cast<char*>(dl_tensor.data) + dl_tensor.byte_offset;
+  auto holder = std::make_shared<DLPackAllocation>(
+      guard.release(), ptr, span * phi::SizeOf(dtype), place);
+  dst->set_meta(meta);
+  dst->ResetHolder(holder);
 }
 
 template <typename T>
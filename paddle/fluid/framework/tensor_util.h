@@ -16,6 +16,7 @@ limitations under the License. */
 #include <algorithm>
 #include <codecvt>
 #include <locale>
+#include <streambuf>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -53,6 +54,35 @@ class PrintOptions {
   PrintOptions() {}
 };
 
+// A read-only streambuf over a memory-mapped file. Parameters deserialized
+// through it are read from the page cache without an extra user space copy,
+// and TensorFromStream copies device tensors straight out of the mapping
+// through pinned staging buffers. is_open() is false when the file can not
+// be mapped (or on Windows), callers should then fall back to std::ifstream.
+class TEST_API MappedFileStreamBuf : public std::streambuf {
+ public:
+  explicit MappedFileStreamBuf(const std::string& path);
+  ~MappedFileStreamBuf() override;
+  MappedFileStreamBuf(const MappedFileStreamBuf&) = delete;
+  MappedFileStreamBuf& operator=(const MappedFileStreamBuf&) = delete;
+
+  bool is_open() const { return base_ != nullptr; }
+  // The mapped bytes at the current get position.
+  const char* current() const { return gptr(); }
+  size_t remaining() const { return static_cast<size_t>(egptr() - gptr()); }
+  void Skip(size_t n);
+
+ protected:
+  pos_type seekoff(off_type off,
+                   std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+ private:
+  char* base_{nullptr};
+  size_t size_{0};
+};
+
 TEST_API void TensorToStream(std::ostream& os,
                              const phi::DenseTensor& tensor,
                              const phi::DeviceContext& dev_ctx);
@@ -109,7 +139,9 @@ void TensorToVector(const phi::DenseTensor& src, std::vector<T>* dst);
 
 TEST_API void TensorFromDLPack(const ::DLTensor& dl_tensor,
                                phi::DenseTensor* dst);
-void TensorFromDLPack(const DLManagedTensor* src, phi::DenseTensor* dst);
+// share the memory of src without copying, dst takes the ownership of src
+TEST_API void TensorFromDLPack(const DLManagedTensor* src,
+                               phi::DenseTensor* dst);
 
 //
 // The implementation of template functions.
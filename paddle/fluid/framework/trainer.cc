@@ -15,12 +15,30 @@ limitations under the License. */
 #include "paddle/fluid/framework/trainer.h"
 
 #include "io/fs.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
 
 namespace paddle {
 namespace framework {
 
 void TrainerBase::SetScope(Scope* root_scope) { root_scope_ = root_scope; }
 
+void TrainerBase::BindWorkerToNumaNode(int thread_id) {
+  if (!numa_binding_) {
+    return;
+  }
+  static const std::vector<std::vector<int>> nodes = GetNumaNodeCpus();
+  if (nodes.empty()) {
+    return;
+  }
+  int node = thread_id % static_cast<int>(nodes.size());
+  if (!SetCurrentThreadAffinity(nodes[node])) {
+    LOG(WARNING) << "Failed to bind worker " << thread_id << " to NUMA node "
+                 << node;
+    return;
+  }
+  VLOG(3) << "Bind worker " << thread_id << " to NUMA node " << node;
+}
+
 void TrainerBase::ParseDumpConfig(const TrainerDesc& desc) {
   dump_fields_path_ = desc.dump_fields_path();
   need_dump_field_ = false;
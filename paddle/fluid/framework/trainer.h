@@ -76,9 +76,13 @@ class TrainerBase {
   virtual std::string GetDumpPath(int tid) = 0;
   virtual void ParseDumpConfig(const TrainerDesc& trainer_desc);
   virtual void FinalizeDumpEnv();
+  // Bind the calling thread to the NUMA node of worker thread_id if
+  // numa_binding_ is set.
+  void BindWorkerToNumaNode(int thread_id);
 
   Scope* root_scope_;
   bool debug_;
+  bool numa_binding_ = false;
   Dataset* dataset_ptr_;
   TrainerDesc trainer_desc_;
 
@@ -18,6 +18,7 @@
 #if !(defined(PADDLE_NO_PYTHON) && defined(PADDLE_ON_INFERENCE))
 #include "paddle/fluid/eager/api/generated/eager_generated/forwards/dygraph_functions.h"
 #endif
+#include "paddle/fluid/eager/amp_cast_cache.h"
 #include "paddle/fluid/eager/api/utils/global_utils.h"
 #include "paddle/fluid/eager/type_defs.h"
 #include "paddle/fluid/imperative/amp_auto_cast.h"
@@ -235,11 +236,14 @@ static inline paddle::Tensor Cast(const paddle::Tensor& input,
           input, phi::DataType::UNDEFINED, dst_dtype);
     }
   } else {
-    if (trace_backward) {
-      return cast_ad_func(input, dst_dtype);
-    } else {
-      return paddle::experimental::cast(input, dst_dtype);
-    }
+    return egr::AmpCastCache::GetOrCast(
+        input, dst_dtype, trace_backward, [&]() {
+          if (trace_backward) {
+            return cast_ad_func(input, dst_dtype);
+          } else {
+            return paddle::experimental::cast(input, dst_dtype);
+          }
+        });
   }
 }
 #endif
@@ -14,6 +14,13 @@
 
 #include "paddle/fluid/imperative/prepared_operator.h"
 
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "paddle/common/hash_funcs.h"
+#include "paddle/common/macros.h"
 #include "paddle/fluid/eager/eager_tensor.h"
 #include "paddle/fluid/framework/data_type_transform.h"
 #include "paddle/fluid/framework/details/nan_inf_utils.h"
@@ -31,6 +38,7 @@
 #include "paddle/common/flags.h"
 #include "paddle/fluid/framework/library_type.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
 #include "paddle/phi/common/place.h"
@@ -38,6 +46,11 @@
 COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_bool(benchmark);
 COMMON_DECLARE_bool(run_kp_kernel);
+COMMON_DECLARE_int32(dygraph_prepared_op_cache_size);
+
+// the legacy ops prepared from a cached kernel choice, see
+// FLAGS_dygraph_prepared_op_cache_size
+DEFINE_INT_STATUS(STAT_dygraph_prepared_op_cache_hits)
 
 namespace paddle::imperative {
 
@@ -150,8 +163,266 @@ PreparedOp::PreparedOp(const framework::OperatorBase& op,
       kernel_signature_(std::move(kernel_signature)),
       phi_kernel_(phi_kernel) {}
 
+// The kernel chosen for an op by PrepareImpl, phi_kernel is nullptr if it is
+// a fluid kernel run by func.
+struct KernelChoice {
+  phi::KernelKey kernel_key;
+  framework::OperatorWithKernel::OpKernelFunc func;
+  const phi::ArgumentMappingFn* arg_map_fn;
+  const phi::KernelSignature* default_kernel_signature;
+  phi::KernelSignature kernel_signature;
+  const phi::Kernel* phi_kernel;
+  phi::DeviceContext* dev_ctx;
+};
+
+// The metas of a var the kernel choice depends on. Some ops choose another
+// kernel for an empty input, e.g. on the CPU, so the emptiness is a part of
+// the key.
+struct VarMeta {
+  int type{-1};
+  phi::DataType dtype{phi::DataType::UNDEFINED};
+  phi::DataLayout layout{phi::DataLayout::UNDEFINED};
+  phi::Place place;
+  bool empty{false};
+
+  bool operator==(const VarMeta& other) const {
+    return type == other.type && dtype == other.dtype &&
+           layout == other.layout && place == other.place &&
+           empty == other.empty;
+  }
+};
+
+struct SlotMeta {
+  std::string name;
+  std::vector<VarMeta> vars;
+};
+
 template <typename VarType>
-PreparedOp PrepareImpl(
+static VarMeta GetVarMeta(const std::shared_ptr<VarType>& var) {
+  VarMeta meta;
+  if (var == nullptr || !var->Var().IsInitialized()) {
+    return meta;
+  }
+  const auto& variable = var->Var();
+  meta.type = variable.Type();
+  const phi::DenseTensor* tensor = nullptr;
+  if (variable.IsType<phi::DenseTensor>()) {
+    tensor = &variable.Get<phi::DenseTensor>();
+  } else if (variable.IsType<phi::SelectedRows>()) {
+    tensor = &variable.Get<phi::SelectedRows>().value();
+  }
+  if (tensor != nullptr) {
+    meta.dtype = tensor->dtype();
+    meta.layout = tensor->layout();
+    meta.empty = tensor->numel() == 0;
+    if (tensor->initialized()) {
+      meta.place = tensor->place();
+    }
+  }
+  return meta;
+}
+
+template <typename VarType>
+static std::vector<SlotMeta> GetSlotMetas(const NameVarMap<VarType>& slots) {
+  std::vector<SlotMeta> metas;
+  metas.reserve(slots.size());
+  for (const auto& [name, vars] : slots) {
+    SlotMeta meta{name, {}};
+    meta.vars.reserve(vars.size());
+    for (const auto& var : vars) {
+      meta.vars.emplace_back(GetVarMeta(var));
+    }
+    metas.emplace_back(std::move(meta));
+  }
+  return metas;
+}
+
+template <typename VarType>
+static bool SameSlots(const std::vector<SlotMeta>& metas,
+                      const NameVarMap<VarType>& slots) {
+  if (metas.size() != slots.size()) {
+    return false;
+  }
+  auto meta_it = metas.begin();
+  for (const auto& [name, vars] : slots) {
+    if (meta_it->name != name || meta_it->vars.size() != vars.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < vars.size(); ++i) {
+      if (!(meta_it->vars[i] == GetVarMeta(vars[i]))) {
+        return false;
+      }
+    }
+    ++meta_it;
+  }
+  return true;
+}
+
+template <typename VarType>
+static void HashSlots(const NameVarMap<VarType>& slots, size_t* seed) {
+  for (const auto& [name, vars] : slots) {
+    HashCombine(seed, name, vars.size());
+    for (const auto& var : vars) {
+      auto meta = GetVarMeta(var);
+      HashCombine(seed,
+                  meta.type,
+                  static_cast<int>(meta.dtype),
+                  static_cast<int>(meta.layout),
+                  meta.place.HashValue(),
+                  meta.empty);
+    }
+  }
+}
+
+// Only the ops whose attributes are of these types are cached, the others
+// such as the blocks or the scalars are rare in dygraph.
+template <typename T>
+struct IsCacheableAttr
+    : std::integral_constant<bool,
+                             std::is_arithmetic<T>::value ||
+                                 std::is_same<T, std::string>::value> {};
+
+template <typename T>
+struct IsCacheableAttr<std::vector<T>> : IsCacheableAttr<T> {};
+
+// Combine the hash of attr into seed, or return false if it is not cacheable.
+static bool HashAttr(const framework::Attribute& attr, size_t* seed) {
+  return paddle::visit(
+      [seed](const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same<T, paddle::blank>::value) {
+          return true;
+        } else if constexpr (!IsCacheableAttr<T>::value) {
+          return false;
+        } else if constexpr (std::is_arithmetic<T>::value ||
+                             std::is_same<T, std::string>::value) {
+          HashCombine(seed, value);
+          return true;
+        } else {
+          HashCombine(seed, value.size());
+          for (const auto& item : value) {
+            HashCombine(seed, static_cast<typename T::value_type>(item));
+          }
+          return true;
+        }
+      },
+      attr);
+}
+
+static bool SameAttr(const framework::Attribute& lhs,
+                     const framework::Attribute& rhs) {
+  if (lhs.index() != rhs.index()) {
+    return false;
+  }
+  return paddle::visit(
+      [&rhs](const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same<T, paddle::blank>::value) {
+          return true;
+        } else if constexpr (IsCacheableAttr<T>::value) {
+          return value == paddle::get<T>(rhs);
+        } else {
+          return false;
+        }
+      },
+      lhs);
+}
+
+// Hash what the kernel choice of an op depends on, or return false if the
+// choice can not be cached.
+template <typename VarType>
+static bool HashPrepareInputs(const std::string& op_type,
+                              const phi::Place& place,
+                              const NameVarMap<VarType>& ins,
+                              const NameVarMap<VarType>& outs,
+                              const framework::AttributeMap& attrs,
+                              size_t* hash) {
+  size_t seed = 0;
+  HashCombine(&seed, op_type, place.HashValue());
+  HashSlots(ins, &seed);
+  HashSlots(outs, &seed);
+  // the attributes are unordered, so their hashes are summed
+  size_t attrs_hash = 0;
+  for (const auto& [name, attr] : attrs) {
+    size_t attr_seed = 0;
+    HashCombine(&attr_seed, name);
+    if (!HashAttr(attr, &attr_seed)) {
+      return false;
+    }
+    attrs_hash += attr_seed;
+  }
+  HashCombine(&seed, attrs_hash);
+  *hash = seed;
+  return true;
+}
+
+// A kernel choice with what it depends on, i.e. the type, the place, the
+// attributes and the input and output metas of the op. The default
+// attributes are left out, since they only depend on the op type.
+class CachedKernelChoice {
+ public:
+  template <typename VarType>
+  CachedKernelChoice(const std::string& op_type,
+                     const phi::Place& place,
+                     const NameVarMap<VarType>& ins,
+                     const NameVarMap<VarType>& outs,
+                     const framework::AttributeMap& attrs,
+                     const KernelChoice& kernel_choice)
+      : choice(kernel_choice),
+        op_type_(op_type),
+        place_(place),
+        ins_(GetSlotMetas(ins)),
+        outs_(GetSlotMetas(outs)),
+        attrs_(attrs) {
+    // the signature of a structured kernel is named by the op, which does
+    // not outlive the cache
+    if (choice.kernel_signature.name == op_type.c_str()) {
+      choice.kernel_signature.name = op_type_.c_str();
+    }
+  }
+
+  template <typename VarType>
+  bool Match(const std::string& op_type,
+             const phi::Place& place,
+             const NameVarMap<VarType>& ins,
+             const NameVarMap<VarType>& outs,
+             const framework::AttributeMap& attrs) const {
+    if (op_type_ != op_type || place_ != place ||
+        attrs_.size() != attrs.size() || !SameSlots(ins_, ins) ||
+        !SameSlots(outs_, outs)) {
+      return false;
+    }
+    for (const auto& [name, attr] : attrs) {
+      auto it = attrs_.find(name);
+      if (it == attrs_.end() || !SameAttr(it->second, attr)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  KernelChoice choice;
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(CachedKernelChoice);
+
+  std::string op_type_;
+  phi::Place place_;
+  std::vector<SlotMeta> ins_;
+  std::vector<SlotMeta> outs_;
+  framework::AttributeMap attrs_;
+};
+
+// The kernel choices of the ops traced by the calling thread, keyed by the
+// hash of HashPrepareInputs.
+static std::unordered_multimap<size_t, CachedKernelChoice>&
+ThreadKernelChoiceCache() {
+  thread_local std::unordered_multimap<size_t, CachedKernelChoice> cache;
+  return cache;
+}
+
+template <typename VarType>
+KernelChoice ChooseKernel(
     const NameVarMap<VarType>& ins,
     const NameVarMap<VarType>& outs,
     const framework::OperatorWithKernel& op,
@@ -296,14 +567,13 @@ PreparedOp PrepareImpl(
               phi::TransToPhiBackend(dev_ctx->GetPlace()))) {
         dev_ctx = pool.Get(phi::TransToPhiPlace(expected_kernel_key.backend()));
       }
-      return PreparedOp(op,
-                        empty_ctx,
-                        expected_kernel_key,
-                        arg_map_fn,
-                        default_kernel_signature,
-                        std::move(kernel_signature),
-                        phi_kernel,
-                        dev_ctx);
+      return KernelChoice{expected_kernel_key,
+                          nullptr,
+                          arg_map_fn,
+                          default_kernel_signature,
+                          std::move(kernel_signature),
+                          &phi_kernel,
+                          dev_ctx};
     } else {
       VLOG(6) << "Dynamic mode ChoosePhiKernel - kernel `" << phi_kernel_name
               << "` not found.";
@@ -353,14 +623,13 @@ PreparedOp PrepareImpl(
                 << " | kernel key: " << phi_cpu_kernel_key
                 << " | kernel: " << phi_cpu_kernel;
         auto* cpu_ctx = pool.Get(phi::CPUPlace());
-        return PreparedOp(op,
-                          empty_ctx,
-                          phi_cpu_kernel_key,
-                          arg_map_fn,
-                          default_kernel_signature,
-                          std::move(kernel_signature),
-                          phi_cpu_kernel,
-                          cpu_ctx);
+        return KernelChoice{phi_cpu_kernel_key,
+                            nullptr,
+                            arg_map_fn,
+                            default_kernel_signature,
+                            std::move(kernel_signature),
+                            &phi_cpu_kernel,
+                            cpu_ctx};
       }
     }
   }
@@ -443,14 +712,94 @@ PreparedOp PrepareImpl(
                                   dev_ctx->GetPlace())) {
     dev_ctx = pool.Get(fluid_kernel_type.place_);
   }
-  return PreparedOp(
-      op,
-      empty_ctx,
+  return KernelChoice{
       framework::TransOpKernelTypeToPhiKernelKey(fluid_kernel_type),
       kernel_iter->second,
       arg_map_fn,
       default_kernel_signature,
-      dev_ctx);
+      phi::KernelSignature(),
+      nullptr,
+      dev_ctx};
+}
+
+static PreparedOp MakePreparedOp(const framework::OperatorWithKernel& op,
+                                 const KernelChoice& choice) {
+  if (choice.phi_kernel != nullptr) {
+    return PreparedOp(op,
+                      empty_ctx,
+                      choice.kernel_key,
+                      choice.arg_map_fn,
+                      choice.default_kernel_signature,
+                      phi::KernelSignature(choice.kernel_signature),
+                      *choice.phi_kernel,
+                      choice.dev_ctx);
+  }
+  return PreparedOp(op,
+                    empty_ctx,
+                    choice.kernel_key,
+                    choice.func,
+                    choice.arg_map_fn,
+                    choice.default_kernel_signature,
+                    choice.dev_ctx);
+}
+
+template <typename VarType>
+PreparedOp PrepareImpl(
+    const NameVarMap<VarType>& ins,
+    const NameVarMap<VarType>& outs,
+    const framework::OperatorWithKernel& op,
+    const phi::Place& place,
+    const framework::AttributeMap& attrs,
+    const framework::AttributeMap& default_attrs,
+    const phi::KernelFactory& phi_kernel_factory,
+    const phi::OpUtilsMap& phi_op_utils_map,
+    const phi::DefaultKernelSignatureMap& default_phi_kernel_sig_map) {
+  bool cacheable = FLAGS_dygraph_prepared_op_cache_size > 0;
+#ifdef PADDLE_WITH_DNNL
+  // the OneDNN kernels are chosen with the attributes of op, see above
+  cacheable = cacheable && !FLAGS_use_mkldnn;
+#endif
+  size_t hash = 0;
+  if (cacheable &&
+      HashPrepareInputs(op.Type(), place, ins, outs, attrs, &hash)) {
+    auto& cache = ThreadKernelChoiceCache();
+    auto range = cache.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.Match(op.Type(), place, ins, outs, attrs)) {
+        STAT_ADD(STAT_dygraph_prepared_op_cache_hits, 1);
+        return MakePreparedOp(op, it->second.choice);
+      }
+    }
+    auto choice = ChooseKernel(ins,
+                               outs,
+                               op,
+                               place,
+                               attrs,
+                               default_attrs,
+                               phi_kernel_factory,
+                               phi_op_utils_map,
+                               default_phi_kernel_sig_map);
+    if (cache.size() >=
+        static_cast<size_t>(FLAGS_dygraph_prepared_op_cache_size)) {
+      cache.clear();
+    }
+    // constructed in place, since it keeps the name of a structured kernel
+    auto it = cache.emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple(hash),
+        std::forward_as_tuple(op.Type(), place, ins, outs, attrs, choice));
+    return MakePreparedOp(op, it->second.choice);
+  }
+  return MakePreparedOp(op,
+                        ChooseKernel(ins,
+                                     outs,
+                                     op,
+                                     place,
+                                     attrs,
+                                     default_attrs,
+                                     phi_kernel_factory,
+                                     phi_op_utils_map,
+                                     default_phi_kernel_sig_map));
 }
 
 PreparedOp PreparedOp::Prepare(const NameVarMap<VarBase>& ins,
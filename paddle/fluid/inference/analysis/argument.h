@@ -298,6 +298,21 @@ struct Argument {
   DECL_ARGUMENT_FIELD(tensorrt_optimization_level,
                       TensorRtOptimizationLevel,
                       int);
+  DECL_ARGUMENT_FIELD(tensorrt_engine_build_threads,
+                      TensorRtEngineBuildThreads,
+                      int);
+  DECL_ARGUMENT_FIELD(tensorrt_timing_cache_path,
+                      TensorRtTimingCachePath,
+                      std::string);
+  DECL_ARGUMENT_FIELD(tensorrt_int8_calibration_algorithm,
+                      TensorRtInt8CalibrationAlgorithm,
+                      int);
+  DECL_ARGUMENT_FIELD(tensorrt_int8_calibration_percentile,
+                      TensorRtInt8CalibrationPercentile,
+                      double);
+  DECL_ARGUMENT_FIELD(tensorrt_calibration_batch_queue_size,
+                      TensorRtCalibrationBatchQueueSize,
+                      int);
   DECL_ARGUMENT_FIELD(tensorrt_ops_run_float,
                       TensorRtOpsRunFloat,
                       std::unordered_set<std::string>);
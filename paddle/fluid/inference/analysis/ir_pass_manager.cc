@@ -261,6 +261,16 @@ void IRPassManager::CreatePasses(Argument *argument,
       pass->Set("trt_dla_core", new int(argument->tensorrt_dla_core()));
       pass->Set("optimization_level",
                 new int(argument->tensorrt_optimization_level()));
+      pass->Set("trt_engine_build_threads",
+                new int(argument->tensorrt_engine_build_threads()));
+      pass->Set("trt_timing_cache_path",
+                new std::string(argument->tensorrt_timing_cache_path()));
+      pass->Set("trt_calibration_algorithm",
+                new int(argument->tensorrt_int8_calibration_algorithm()));
+      pass->Set("trt_calibration_percentile",
+                new double(argument->tensorrt_int8_calibration_percentile()));
+      pass->Set("trt_calibration_batch_queue_size",
+                new int(argument->tensorrt_calibration_batch_queue_size()));
 
       // Setting the disable_trt_plugin_fp16 to true means that TRT plugin will
       // not run fp16.
@@ -15,9 +15,15 @@
 
 #include "paddle/fluid/inference/analysis/ir_passes/tensorrt_subgraph_pass.h"
 #include <fcntl.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 #include "paddle/fluid/framework/block_desc.h"
@@ -197,6 +203,7 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   // fluid.
   std::vector<std::string> repetitive_params;
   std::vector<std::string> engine_names;
+  std::vector<std::function<void()>> build_tasks;
   for (auto *node : graph->Nodes()) {
     // load optimized model may update shape_range_info_path
     auto shape_range_info_path = Get<std::string>("trt_shape_range_info_path");
@@ -205,10 +212,15 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
       node->Op()->SetAttr("shape_range_info_path", shape_range_info_path);
     }
     if (node->IsOp() && !framework::ir::Agent(node).subgraph()->empty()) {
-      engine_names.push_back(CreateTensorRTOp(
-          node, graph, graph_param_names, &repetitive_params, use_cuda_graph));
+      engine_names.push_back(CreateTensorRTOp(node,
+                                              graph,
+                                              graph_param_names,
+                                              &repetitive_params,
+                                              use_cuda_graph,
+                                              &build_tasks));
     }
   }
+  BuildEngines(build_tasks, engine_names);
 
   std::unordered_set<const Node *> nodes2remove;
   for (auto *node : graph->Nodes()) {
@@ -261,6 +273,76 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   }
 }
 
+void TensorRtSubgraphPass::BuildEngines(
+    const std::vector<std::function<void()>> &build_tasks,
+    const std::vector<std::string> &engine_names) const {
+  if (build_tasks.empty()) {
+    return;
+  }
+  const size_t num_threads =
+      std::min(build_tasks.size(),
+               static_cast<size_t>(
+                   std::max(Get<int>("trt_engine_build_threads"), 1)));
+  LOG(INFO) << "Prepare " << build_tasks.size()
+            << " TRT engines (Optimize model structure, Select OP kernel "
+               "etc) with "
+            << num_threads << " threads. This process may cost a lot of time.";
+
+  const auto start = std::chrono::steady_clock::now();
+  if (num_threads == 1) {
+    for (const auto &task : build_tasks) {
+      task();
+    }
+  } else {
+    // The networks are converted one at a time (see OpConverter::ConvertBlock)
+    // and only the builds of the engines overlap.
+    const int predictor_id =
+        tensorrt::TensorRTEngine::predictor_id_per_thread;
+    std::atomic<size_t> next_task{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads.emplace_back([&]() {
+        tensorrt::TensorRTEngine::predictor_id_per_thread = predictor_id;
+        for (size_t j = next_task++; j < build_tasks.size();
+             j = next_task++) {
+          try {
+            build_tasks[j]();
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+              error = std::current_exception();
+            }
+            next_task = build_tasks.size();
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  const double elapsed = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+  double total_build_time = 0.;
+  auto &manager =
+      inference::Singleton<inference::tensorrt::TRTEngineManager>::Global();
+  for (const auto &name : engine_names) {
+    if (manager.Has(name)) {
+      total_build_time += manager.Get(name)->build_time();
+    }
+  }
+  LOG(INFO) << "Built " << build_tasks.size() << " TRT engines in " << elapsed
+            << " s, where the engines took " << total_build_time
+            << " s to build in total.";
+}
+
 std::string GenerateEngineKey(const std::set<std::string> &engine_inputs,
                               const std::set<std::string> &engine_outputs,
                               const std::string &predictor_id,
@@ -299,7 +381,8 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
     framework::ir::Graph *graph,
     const std::vector<std::string> &graph_params,
     std::vector<std::string> *repetitive_params,
-    bool use_cuda_graph) const {
+    bool use_cuda_graph,
+    std::vector<std::function<void()>> *build_tasks) const {
   auto *op_desc = node->Op();
   auto &subgraph = *framework::ir::Agent(node).subgraph();
   PADDLE_ENFORCE_EQ(
@@ -537,6 +620,10 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   auto shape_range_info_path = Get<std::string>("trt_shape_range_info_path");
   auto trt_tuned_dynamic_shape = Get<bool>("trt_tuned_dynamic_shape");
   int max_batch_size = Get<int>("max_batch_size");
+  std::vector<std::map<std::string, std::vector<int>>> min_input_shape_buckets;
+  std::vector<std::map<std::string, std::vector<int>>> max_input_shape_buckets;
+  std::vector<std::map<std::string, std::vector<int>>>
+      optim_input_shape_buckets;
   if (trt_tuned_dynamic_shape) {
     if (!shape_range_info_path.empty()) {
       VLOG(1) << "trt dynamic_shape deserialize from " << shape_range_info_path;
@@ -565,6 +652,10 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
         close(fd);
       }
     }
+    inference::DeserializeShapeRangeBuckets(shape_range_info_path,
+                                            &min_input_shape_buckets,
+                                            &max_input_shape_buckets,
+                                            &optim_input_shape_buckets);
   }
 
   // The following procedure is used to rename all the intermediate
@@ -658,6 +749,11 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   auto gpu_device_id = Get<int>("gpu_device_id");
   auto optimization_level = Get<int>("optimization_level");
   auto use_explicit_quantization = Get<bool>("use_explicit_quantization");
+  auto timing_cache_path = Get<std::string>("trt_timing_cache_path");
+  auto calibration_algorithm = Get<int>("trt_calibration_algorithm");
+  auto calibration_percentile = Get<double>("trt_calibration_percentile");
+  auto calibration_batch_queue_size =
+      Get<int>("trt_calibration_batch_queue_size");
 
   // Set op's attrs.
   op_desc->SetType("tensorrt_engine");
@@ -711,6 +807,12 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   }
 
   op_desc->SetAttr("optimization_level", Get<int>("optimization_level"));
+  op_desc->SetAttr("timing_cache_path", timing_cache_path);
+  op_desc->SetAttr("calibration_algorithm", calibration_algorithm);
+  op_desc->SetAttr("calibration_percentile",
+                   static_cast<float>(calibration_percentile));
+  op_desc->SetAttr("calibration_batch_queue_size",
+                   calibration_batch_queue_size);
 
   // we record all inputs' shapes in attr to check if they are consistent
   // with the real inputs' shapes retrieved from scope when trt runs.
@@ -748,6 +850,12 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
                         std::to_string(static_cast<int>(precision_mode)),
                         use_cuda_graph,
                         true);
+  // The calibration tables of the other algorithms are cached apart.
+  if (calibration_algorithm !=
+      static_cast<int>(tensorrt::CalibrationAlgorithm::kEntropy2)) {
+    calibration_engine_key +=
+        "_calib" + std::to_string(calibration_algorithm);
+  }
   auto predictor_id = Get<int>("predictor_id");
 
   // Get "" when there is no cached calibration table data.
@@ -788,8 +896,10 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
 
   std::unique_ptr<tensorrt::TRTInt8Calibrator> calibrator;
   if (enable_int8 && !calibration_data.empty()) {
-    calibrator =
-        std::make_unique<tensorrt::TRTInt8Calibrator>(calibration_data);
+    calibrator = std::make_unique<tensorrt::TRTInt8Calibrator>(
+        calibration_data,
+        static_cast<tensorrt::CalibrationAlgorithm>(calibration_algorithm),
+        calibration_percentile);
     LOG(INFO) << "RUN Paddle TRT int8 calibration mode...";
   }
   // When in int8 mode and calibration_mode, the program just produce the
@@ -849,6 +959,9 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   params.min_shape_tensor = min_shape_tensor;
   params.max_shape_tensor = max_shape_tensor;
   params.optim_shape_tensor = optim_shape_tensor;
+  params.min_input_shape_buckets = min_input_shape_buckets;
+  params.max_input_shape_buckets = max_input_shape_buckets;
+  params.optim_input_shape_buckets = optim_input_shape_buckets;
   params.disable_trt_plugin_fp16 = disable_trt_plugin_fp16;
   params.precision = precision_mode;
   params.use_varseqlen = use_varseqlen;
@@ -863,6 +976,7 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   params.enable_low_precision_io = enable_low_precision_io;
   params.optimization_level = optimization_level;
   params.use_explicit_quantization = use_explicit_quantization;
+  params.timing_cache_path = timing_cache_path;
 
   tensorrt::TensorRTEngine *trt_engine =
       inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
@@ -902,34 +1016,41 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   // the following code will NOT run in following situation:
   // 1. calibration mode (generate trt int8 calibration table data)
   // 2. already load serialized trt engine info.
-  LOG(INFO) << "Prepare TRT engine (Optimize model structure, Select OP "
-               "kernel etc). This process may cost a lot of time.";
-
-  framework::BlockDesc block_desc_temp(nullptr, block_desc.Proto());
-  std::unordered_set<std::string> parameters_set(parameters.begin(),
-                                                 parameters.end());
-  inference::Singleton<inference::tensorrt::OpConverter>::Global()
-      .ConvertBlockToTRTEngine(
-          &block_desc_temp,
-          *scope,
-          std::vector<std::string>(input_names.begin(), input_names.end()),
-          parameters_set,
-          output_mapping,
-          trt_engine);
-
+  // The engine is built after all the subgraphs are visited, since the
+  // engines may be built concurrently, see BuildEngines.
+  auto block_proto_temp =
+      std::make_shared<framework::proto::BlockDesc>(*block_desc.Proto());
+  std::shared_ptr<tensorrt::TRTInt8Calibrator> shared_calibrator(
+      calibrator.release());
+  std::string engine_path;
   if (use_static_engine) {
-    nvinfer1::IHostMemory *serialized_engine_data = trt_engine->Serialize();
-    trt_engine_serialized_data =
-        std::string((const char *)serialized_engine_data->data(),
-                    serialized_engine_data->size());
-    SaveTrtEngineSerializedDataToFile(
-        GetTrtEngineSerializedPath(Get<std::string>("model_opt_cache_dir"),
-                                   engine_key),
-        trt_engine_serialized_data);
-    LOG(INFO) << "Save TRT Optimized Info to "
-              << GetTrtEngineSerializedPath(
-                     Get<std::string>("model_opt_cache_dir"), engine_key);
+    engine_path = GetTrtEngineSerializedPath(
+        Get<std::string>("model_opt_cache_dir"), engine_key);
   }
+  build_tasks->emplace_back([=]() {
+    framework::BlockDesc block_desc_temp(nullptr, block_proto_temp.get());
+    std::unordered_set<std::string> parameters_set(parameters.begin(),
+                                                   parameters.end());
+    inference::Singleton<inference::tensorrt::OpConverter>::Global()
+        .ConvertBlockToTRTEngine(
+            &block_desc_temp,
+            *scope,
+            std::vector<std::string>(input_names.begin(), input_names.end()),
+            parameters_set,
+            output_mapping,
+            trt_engine);
+    // keep the calibrator alive until the engine is built
+    (void)shared_calibrator;
+
+    if (!engine_path.empty()) {
+      nvinfer1::IHostMemory *serialized_engine_data = trt_engine->Serialize();
+      SaveTrtEngineSerializedDataToFile(
+          engine_path,
+          std::string((const char *)serialized_engine_data->data(),
+                      serialized_engine_data->size()));
+      LOG(INFO) << "Save TRT Optimized Info to " << engine_path;
+    }
+  });
 
   return engine_key + std::to_string(predictor_id);
 }
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -45,7 +46,13 @@ class TensorRtSubgraphPass : public framework::ir::FusePassBase {
                                framework::ir::Graph *graph,
                                const std::vector<std::string> &graph_params,
                                std::vector<std::string> *repetitive_params,
-                               bool use_cuda_graph) const;
+                               bool use_cuda_graph,
+                               std::vector<std::function<void()>>
+                                   *build_tasks) const;
+  // Run the tasks building the engines of the subgraphs, with at most
+  // trt_engine_build_threads threads.
+  void BuildEngines(const std::vector<std::function<void()>> &build_tasks,
+                    const std::vector<std::string> &engine_names) const;
   void CleanIntermediateOutputs(framework::ir::Node *node);
 };
 
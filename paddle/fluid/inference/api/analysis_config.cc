@@ -199,6 +199,29 @@ bool AnalysisConfig::external_stream_enabled() const {
   return use_external_stream_;
 }
 
+void AnalysisConfig::EnableGpuResourceSharing(int max_concurrent_runs) {
+  PADDLE_ENFORCE_GT(max_concurrent_runs,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The max concurrent runs sharing the gpu resources "
+                        "should be greater than 0, but got %d.",
+                        max_concurrent_runs));
+  gpu_resource_sharing_runs_ = max_concurrent_runs;
+  Update();
+}
+
+void AnalysisConfig::EnableSparse24Weights(float max_pruned_ratio) {
+  PADDLE_ENFORCE_GE(max_pruned_ratio,
+                    0.f,
+                    common::errors::InvalidArgument(
+                        "The max pruned ratio of the 2:4 sparse weights "
+                        "should not be negative, but got %f.",
+                        max_pruned_ratio));
+  use_sparse_2_4_weights_ = true;
+  sparse_2_4_max_pruned_ratio_ = max_pruned_ratio;
+  Update();
+}
+
 void AnalysisConfig::DisableGpu() {
   use_gpu_ = false;
 
@@ -466,6 +489,20 @@ void AnalysisConfig::EnableORTOptimization() {
   Update();
 }
 
+void AnalysisConfig::EnableORTTensorRT(const std::string &engine_cache_dir,
+                                       bool use_fp16) {
+#ifdef PADDLE_WITH_ONNXRUNTIME
+  use_ort_tensorrt_ = true;
+  ort_tensorrt_cache_dir_ = engine_cache_dir;
+  ort_tensorrt_fp16_ = use_fp16;
+#else
+  LOG(ERROR) << "Please compile with onnxruntime to EnableORTTensorRT()";
+  use_ort_tensorrt_ = false;
+#endif
+
+  Update();
+}
+
 AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
 #define CP_MEMBER(member__) member__ = other.member__;
 
@@ -483,8 +520,21 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(use_gpu_);
   CP_MEMBER(use_cutlass_);
   CP_MEMBER(use_external_stream_);
+  CP_MEMBER(gpu_resource_sharing_runs_);
+  CP_MEMBER(use_sparse_2_4_weights_);
+  CP_MEMBER(sparse_2_4_max_pruned_ratio_);
+  // ONNXRuntime related
+  CP_MEMBER(use_onnxruntime_);
+  CP_MEMBER(enable_ort_optimization_);
+  CP_MEMBER(use_ort_tensorrt_);
+  CP_MEMBER(ort_tensorrt_fp16_);
+  CP_MEMBER(ort_tensorrt_cache_dir_);
   CP_MEMBER(exec_stream_);
   CP_MEMBER(use_cudnn_);
+  CP_MEMBER(autotune_cache_file_);
+  CP_MEMBER(autotune_cache_writeback_);
+  CP_MEMBER(shared_weights_path_);
+  CP_MEMBER(shared_weights_publisher_);
   CP_MEMBER(gpu_device_id_);
   CP_MEMBER(memory_pool_init_size_mb_);
 
@@ -528,12 +578,19 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(trt_engine_memory_sharing_);
   CP_MEMBER(trt_engine_memory_sharing_identifier_);
   CP_MEMBER(trt_optimization_level_);
+  CP_MEMBER(trt_engine_build_threads_);
+  CP_MEMBER(trt_timing_cache_path_);
+  CP_MEMBER(trt_shape_bucket_num_);
+  CP_MEMBER(trt_int8_calibration_algorithm_);
+  CP_MEMBER(trt_int8_calibration_percentile_);
+  CP_MEMBER(trt_calibration_batch_queue_size_);
   CP_MEMBER(trt_ops_run_float_);
   CP_MEMBER(trt_exclude_var_names_);
   // OneDNN related.
   CP_MEMBER(use_mkldnn_);
   CP_MEMBER(mkldnn_enabled_op_types_);
   CP_MEMBER(mkldnn_cache_capacity_);
+  CP_MEMBER(use_mkldnn_weights_prepacking_);
   // Bfloat16 related.
   CP_MEMBER(use_mkldnn_bfloat16_);
   CP_MEMBER(bfloat16_enabled_op_types_);
@@ -602,6 +659,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(skip_load_params_);
 
   CP_MEMBER(use_new_executor_);
+  CP_MEMBER(use_low_latency_run_);
   CP_MEMBER(use_pir_);
   CP_MEMBER(custom_passes_);
   CP_MEMBER(custom_pass_only_);
@@ -729,6 +787,16 @@ void AnalysisConfig::DisableMkldnnFcPasses() {
   Update();
 }
 
+void AnalysisConfig::EnableMkldnnWeightsPrepacking() {
+#ifdef PADDLE_WITH_DNNL
+  use_mkldnn_weights_prepacking_ = true;
+#else
+  LOG(ERROR) << "Please compile with MKLDNN first to use "
+                "EnableMkldnnWeightsPrepacking";
+  use_mkldnn_weights_prepacking_ = false;
+#endif
+}
+
 void AnalysisConfig::EnableMkldnnInt8(
     const std::unordered_set<std::string> &op_list) {
 #ifdef PADDLE_WITH_DNNL
@@ -895,6 +963,60 @@ void AnalysisConfig::SetTensorRtOptimizationLevel(int level) {
   trt_optimization_level_ = level;
 }
 
+void AnalysisConfig::SetTensorRtEngineBuildThreads(int num_threads) {
+  PADDLE_ENFORCE_GE(
+      num_threads,
+      1,
+      common::errors::InvalidArgument(
+          "The number of threads in SetTensorRtEngineBuildThreads must be "
+          "at least 1, but received %d.",
+          num_threads));
+  trt_engine_build_threads_ = num_threads;
+}
+
+void AnalysisConfig::EnableTensorRtTimingCache(const std::string &path) {
+  PADDLE_ENFORCE_EQ(
+      path.empty(),
+      false,
+      common::errors::InvalidArgument(
+          "The file of the TensorRT timing cache should not be empty."));
+  trt_timing_cache_path_ = path;
+}
+
+void AnalysisConfig::SetTensorRtShapeBucketNum(int bucket_num) {
+  PADDLE_ENFORCE_GE(
+      bucket_num,
+      1,
+      common::errors::InvalidArgument(
+          "The number of shape buckets in SetTensorRtShapeBucketNum must be "
+          "at least 1, but received %d.",
+          bucket_num));
+  trt_shape_bucket_num_ = bucket_num;
+}
+
+void AnalysisConfig::SetTensorRtInt8Calibration(
+    Int8CalibrationAlgorithm algorithm,
+    double percentile,
+    int batch_queue_size) {
+  PADDLE_ENFORCE_EQ(
+      percentile > 0. && percentile <= 100.,
+      true,
+      common::errors::InvalidArgument(
+          "The percentile in SetTensorRtInt8Calibration should be in (0, "
+          "100], but received %f.",
+          percentile));
+  PADDLE_ENFORCE_GE(
+      batch_queue_size,
+      1,
+      common::errors::InvalidArgument(
+          "The batch_queue_size in SetTensorRtInt8Calibration must be at "
+          "least 1, but received %d.",
+          batch_queue_size));
+  trt_int8_calibration_algorithm_ = algorithm;
+  trt_int8_calibration_percentile_ = percentile;
+  trt_calibration_batch_queue_size_ = batch_queue_size;
+}
+
 // TODO(Superjomn) refactor this, buggy.
 void AnalysisConfig::Update() {
   auto &&info = SerializeInfoCache();
@@ -1111,6 +1233,14 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << enable_gpu_mixed_;
   ss << use_external_stream_;
   ss << exec_stream_;
+  ss << gpu_resource_sharing_runs_;
+  ss << use_sparse_2_4_weights_;
+  ss << sparse_2_4_max_pruned_ratio_;
+  ss << use_onnxruntime_;
+  ss << enable_ort_optimization_;
+  ss << use_ort_tensorrt_;
+  ss << ort_tensorrt_fp16_;
+  ss << ort_tensorrt_cache_dir_;
   ss << use_fc_padding_;
   ss << gpu_device_id_;
   ss << memory_pool_init_size_mb_;
@@ -1316,6 +1446,8 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"enable_mkldnn", use_mkldnn_ ? "true" : "false"});
   os.InsertRow(
       {"mkldnn_cache_capacity", std::to_string(mkldnn_cache_capacity_)});
+  os.InsertRow({"mkldnn_weights_prepacking",
+                use_mkldnn_weights_prepacking_ ? "true" : "false"});
   os.InsetDivider();
 
   // gpu info
@@ -1332,6 +1464,14 @@ std::string AnalysisConfig::Summary() {
         {"use_external_stream", use_external_stream_ ? "true" : "false"});
     os.InsertRow(
         {"thread_local_stream", thread_local_stream_ ? "true" : "false"});
+    if (!autotune_cache_file_.empty()) {
+      os.InsertRow({"autotune_cache_file", autotune_cache_file_});
+    }
+    if (!shared_weights_path_.empty()) {
+      os.InsertRow({"shared_weights",
+                    (shared_weights_publisher_ ? "publish to " : "map from ") +
+                        shared_weights_path_});
+    }
 
     os.InsertRow({"use_tensorrt", use_tensorrt_ ? "true" : "false"});
     if (use_tensorrt_) {
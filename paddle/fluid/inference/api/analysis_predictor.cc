@@ -17,11 +17,21 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <set>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -37,6 +47,7 @@
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/framework/transfer_scope_cache.h"
 #include "paddle/fluid/framework/var_type_traits.h"
 #include "paddle/fluid/framework/version.h"
@@ -49,7 +60,9 @@
 #include "paddle/fluid/inference/api/paddle_analysis_config.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/paddle_inference_pass.h"
+#include "paddle/fluid/inference/api/program_cache.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
+#include "paddle/fluid/inference/api/shared_weights.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/inference/utils/model_utils.h"
 #include "paddle/fluid/inference/utils/singleton.h"
@@ -65,9 +78,12 @@
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/place.h"
+#include "paddle/phi/core/memory/malloc.h"
 #include "paddle/phi/core/memory/memcpy.h"
 
 #include "paddle/phi/core/generator.h"
+#include "paddle/phi/core/scope_guard.h"
+#include "paddle/phi/kernels/autotune/cache.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
 #include "paddle/utils/string/split.h"
 
@@ -138,7 +154,9 @@
 #include "paddle/pir/include/pass/pass_registry.h"
 
 COMMON_DECLARE_bool(pir_apply_inplace_pass);
+COMMON_DECLARE_bool(pir_fuse_pattern_rewrite_passes);
 COMMON_DECLARE_bool(enable_pir_api);
+COMMON_DECLARE_double(virtual_memory_defrag_threshold);
 
 namespace paddle {
 namespace {
@@ -255,6 +273,34 @@ phi::Backend ConvertBackend(paddle_infer::PlaceType backend) {
   }
 }
 
+phi::DataType ConvertDataType(paddle_infer::DataType dtype) {
+  switch (dtype) {
+    case paddle_infer::DataType::FLOAT32:
+      return phi::DataType::FLOAT32;
+    case paddle_infer::DataType::INT64:
+      return phi::DataType::INT64;
+    case paddle_infer::DataType::INT32:
+      return phi::DataType::INT32;
+    case paddle_infer::DataType::UINT8:
+      return phi::DataType::UINT8;
+    case paddle_infer::DataType::INT8:
+      return phi::DataType::INT8;
+    case paddle_infer::DataType::FLOAT16:
+      return phi::DataType::FLOAT16;
+    case paddle_infer::DataType::BOOL:
+      return phi::DataType::BOOL;
+    case paddle_infer::DataType::FLOAT64:
+      return phi::DataType::FLOAT64;
+    case paddle_infer::DataType::BFLOAT16:
+      return phi::DataType::BFLOAT16;
+    default:
+      PADDLE_THROW(common::errors::InvalidArgument(
+          "Paddle Inference not support the data type %d.",
+          static_cast<int>(dtype)));
+      return phi::DataType::FLOAT32;
+  }
+}
+
 bool PaddleTensorToDenseTensor(const PaddleTensor &pt,
                                phi::DenseTensor *t,
                                const phi::Place &place) {
@@ -493,6 +539,18 @@ bool AnalysisPredictor::Init(
   }
   InitPlace();
 
+  if (!config_.autotune_cache_file().empty()) {
+    // The autotune cache is process level, load each file only once.
+    static std::mutex autotune_cache_mutex;
+    static std::unordered_set<std::string> loaded_autotune_cache_files;
+    std::lock_guard<std::mutex> lock(autotune_cache_mutex);
+    if (loaded_autotune_cache_files.insert(config_.autotune_cache_file())
+            .second) {
+      phi::autotune::AutoTuneCache::Instance().LoadFromFile(
+          config_.autotune_cache_file());
+    }
+  }
+
   if (!CreateExecutor()) {
     return false;
   }
@@ -552,6 +610,19 @@ bool AnalysisPredictor::Init(
   }
 #endif
 
+  // The clones share the parameters of their root predictor already.
+  if (config_.use_gpu() && !config_.shared_weights_path().empty() &&
+      !status_is_cloned_) {
+    std::vector<framework::Scope *> scopes{sub_scope_, scope_.get()};
+    phi::GPUPlace place(place_.GetDeviceId());
+    if (config_.shared_weights_publisher()) {
+      inference::PublishSharedWeights(
+          scopes, place, config_.shared_weights_path());
+    } else {
+      inference::MapSharedWeights(scopes, place, config_.shared_weights_path());
+    }
+  }
+
   TryShrinkMemory();
 
   inference::DisplayMemoryInfo(place_, "Init predictor");
@@ -863,6 +934,11 @@ void AnalysisPredictor::OptimizeInferencePirProgram() {
     }
     if (config_.use_gpu()) {
       // gpu
+      if (config_.sparse_2_4_weights_enabled()) {
+        // before the matmuls are fused with their neighbours
+        pass_pm.AddPass(
+            pir::PassRegistry::Instance().Get("sparse_2_4_linear_pass"));
+      }
       if (!config_.custom_pass_only_) {
         for (const auto &gpu_pass : kPirGpuPasses) {
           if (std::find(config_.deleted_passes_.begin(),
@@ -922,6 +998,10 @@ void AnalysisPredictor::OptimizeInferencePirProgram() {
           pass->name() == "conv2d_add_fuse_pass") {
         pass->Set("use_cutlass", new bool(config_.use_cutlass_));
       }
+      if (pass->name() == "sparse_2_4_linear_pass") {
+        pass->Set("sparse_2_4_max_pruned_ratio",
+                  new float(config_.sparse_2_4_max_pruned_ratio()));
+      }
     }
 
     if (!config_.glog_info_disabled()) {
@@ -931,6 +1011,9 @@ void AnalysisPredictor::OptimizeInferencePirProgram() {
       pass_pm.EnableIRPrinting(
           std::make_unique<pir::PassManager::IRPrinterOption>(
               ir_printing_conditions, ir_printing_conditions));
+    } else if (FLAGS_pir_fuse_pattern_rewrite_passes) {
+      // The fused passes are printed as one, so keep them apart for ir_debug.
+      pass_pm.EnablePatternRewriteFusion();
     }
 
     pass_pm.Run(pir_program_.get());
@@ -1120,7 +1203,14 @@ bool AnalysisPredictor::PreparePirProgram() {
       common::errors::Fatal("Here, pir_program must be a nullptr!"));
 
   pir_program_ = std::make_shared<pir::Program>(pir::IrContext::Instance());
+  const auto read_start = std::chrono::steady_clock::now();
   pir::ReadModule(config_.prog_file(), pir_program_.get(), 1 /*pir_version*/);
+  VLOG(3) << "Load pir program " << config_.prog_file() << " with "
+          << pir_program_->block()->size() << " ops in "
+          << std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - read_start)
+                 .count()
+          << " ms";
   if (!SaveOrLoadPirParameters(false)) {
     return false;
   }
@@ -1260,6 +1350,7 @@ bool AnalysisPredictor::PrepareExecutor() {
     framework::interpreter::ExecutionConfig execution_config;
     execution_config.create_local_scope = false;
     execution_config.used_for_inference = true;
+    execution_config.used_for_low_latency = config_.low_latency_run_enabled();
 
     auto input_names = GetInputNames();
 
@@ -1620,6 +1711,8 @@ void AnalysisPredictor::MkldnnPreSet(
   }
   phi::OneDNNContext::tls().set_cur_input_shape_cache_capacity(
       config_.mkldnn_cache_capacity_);
+  phi::OneDNNContext::tls().set_prepack_weights(
+      config_.use_mkldnn_weights_prepacking_);
 
 #endif
 }
@@ -1716,7 +1809,11 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
   // Frees unused memory allocated by the Intel® MKL Memory Allocator to
   // avoid memory leak. See:
   // https://software.intel.com/en-us/mkl-developer-reference-c-mkl-free-buffers
-  phi::dynload::MKL_Free_Buffers();
+  // The low latency run keeps the buffers for the next run, as the
+  // intermediate tensors.
+  if (!config_.low_latency_run_enabled()) {
+    phi::dynload::MKL_Free_Buffers();
+  }
 #endif
   return true;
 }
@@ -2071,6 +2168,15 @@ void AnalysisPredictor::PrepareArgument() {
         config_.trt_use_explicit_quantization_);
     argument_->SetTrtEngineMemorySharing(config_.trt_engine_memory_sharing());
     argument_->SetTensorRtOptimizationLevel(config_.trt_optimization_level_);
+    argument_->SetTensorRtEngineBuildThreads(
+        config_.trt_engine_build_threads_);
+    argument_->SetTensorRtTimingCachePath(config_.trt_timing_cache_path_);
+    argument_->SetTensorRtInt8CalibrationAlgorithm(
+        static_cast<int>(config_.trt_int8_calibration_algorithm_));
+    argument_->SetTensorRtInt8CalibrationPercentile(
+        config_.trt_int8_calibration_percentile_);
+    argument_->SetTensorRtCalibrationBatchQueueSize(
+        config_.trt_calibration_batch_queue_size_);
     argument_->SetTensorRtOpsRunFloat(config_.trt_ops_run_float_);
   }
 
@@ -2679,6 +2785,112 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetOutputTensor(
   return res;
 }
 
+bool AnalysisPredictor::BindOutput(const std::string &name,
+                                   void *data,
+                                   const std::vector<int> &shape,
+                                   paddle_infer::DataType dtype) {
+  auto output_names = GetOutputNames();
+  PADDLE_ENFORCE_NE(
+      std::find(output_names.begin(), output_names.end(), name),
+      output_names.end(),
+      common::errors::InvalidArgument("%s is not an output of the model.",
+                                      name));
+  if (data == nullptr) {
+    output_bindings_.erase(name);
+    return true;
+  }
+  phi::DenseTensorMeta meta(ConvertDataType(dtype), common::make_ddim(shape));
+  const size_t size = common::product(meta.dims) * phi::SizeOf(meta.dtype);
+  output_bindings_[name] = phi::DenseTensor(
+      std::make_shared<phi::Allocation>(data, size, place_), meta);
+  VLOG(3) << "Bind the output " << name << " to " << data << " of " << size
+          << " bytes";
+  return true;
+}
+
+bool AnalysisPredictor::SetLoraAdapter(
+    int slot, const std::map<std::string, const float *> &weights) {
+  auto &pool = phi::DeviceContextPool::Instance();
+  const auto &cpu_ctx =
+      *static_cast<phi::CPUContext *>(pool.Get(phi::CPUPlace()));
+  for (const auto &[name, data] : weights) {
+    auto *var = scope_->FindVar(name);
+    PADDLE_ENFORCE_EQ(
+        var != nullptr && var->IsType<phi::DenseTensor>() &&
+            var->Get<phi::DenseTensor>().initialized(),
+        true,
+        common::errors::NotFound("%s is not a parameter of the model.", name));
+    auto *param = var->GetMutable<phi::DenseTensor>();
+    PADDLE_ENFORCE_EQ(
+        param->dims().size() >= 2 && slot >= 0 && slot < param->dims()[0],
+        true,
+        common::errors::InvalidArgument(
+            "The parameter %s of the shape [%s] has no adapter slot %d.",
+            name,
+            param->dims(),
+            slot));
+    auto slot_dims = param->dims();
+    slot_dims[0] = 1;
+    const size_t size = common::product(slot_dims) * sizeof(float);
+    phi::DenseTensor weight(
+        std::make_shared<phi::Allocation>(
+            const_cast<float *>(data), size, phi::CPUPlace()),
+        phi::DenseTensorMeta(phi::DataType::FLOAT32, slot_dims));
+    if (param->dtype() != phi::DataType::FLOAT32) {
+      weight = phi::funcs::TransDataType(cpu_ctx, weight, param->dtype());
+    }
+    auto param_slot = param->Slice(slot, slot + 1);
+    framework::TensorCopySync(weight, param->place(), &param_slot);
+    VLOG(3) << "Write the adapter slot " << slot << " of " << name;
+  }
+  return true;
+}
+
+void AnalysisPredictor::ShareOutputBindings() {
+  auto *scope = executor_->GetScope();
+  for (auto &[name, binding] : output_bindings_) {
+    auto *tensor = scope->Var(name)->GetMutable<phi::DenseTensor>();
+    tensor->ShareDataWith(binding);
+  }
+}
+
+void AnalysisPredictor::SyncOutputBindings() {
+  auto *scope = executor_->GetScope();
+  for (auto &[name, binding] : output_bindings_) {
+    auto *tensor = scope->FindVar(name)->GetMutable<phi::DenseTensor>();
+    if (tensor->data() == binding.data()) {
+      continue;
+    }
+    PADDLE_ENFORCE_EQ(
+        tensor->dtype() == binding.dtype() &&
+            tensor->dims() == binding.dims(),
+        true,
+        common::errors::InvalidArgument(
+            "The output %s of shape [%s] does not fit the bound buffer of "
+            "shape [%s].",
+            name,
+            tensor->dims(),
+            binding.dims()));
+    VLOG(3) << "The output " << name
+            << " is not written in place, copy it into the bound buffer";
+    void *stream = nullptr;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (phi::is_gpu_place(place_)) {
+      stream = static_cast<const phi::GPUContext *>(
+                   phi::DeviceContextPool::Instance().Get(place_))
+                   ->stream();
+    }
+#endif
+    memory::Copy(place_,
+                 binding.data(),
+                 tensor->place(),
+                 tensor->data(),
+                 binding.Holder()->size(),
+                 stream);
+    tensor->ShareDataWith(binding);
+  }
+}
+
 bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   inference::DisplayMemoryInfo(place_, "before run");
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
@@ -2749,12 +2961,49 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   }
 #endif
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // lease the shared library handles for the run, they are bound to the
+  // predictor stream until given back
+  SharedGPUResource *shared_resource = nullptr;
+  if (private_context_ && config_.gpu_resource_sharing_runs() > 0 &&
+      phi::is_gpu_place(place_)) {
+    shared_resource = ResourceManager::Instance().AcquireSharedGPUResource(
+        place_, predictor_stream_, config_.gpu_resource_sharing_runs());
+    auto *gpu_context = static_cast<InferGPUContext *>(
+        device_contexts_.at(place_).get().get());
+    gpu_context->SetBlasHandle(shared_resource->blas_handle);
+    gpu_context->SetBlasTensorCoreHandle(
+        shared_resource->blas_tensor_core_handle);
+    gpu_context->SetBlasTF32Handle(
+        shared_resource->blas_tf32_tensor_core_handle);
+    gpu_context->SetBlasLtHandle(shared_resource->blaslt_handle);
+    gpu_context->SetDnnHandle(shared_resource->dnn_handle);
+    gpu_context->SetSolverHandle(shared_resource->solver_handle);
+    gpu_context->SetSparseHandle(shared_resource->sparse_handle);
+  }
+  DEFINE_PADDLE_SCOPE_GUARD([shared_resource] {
+    if (shared_resource != nullptr) {
+      ResourceManager::Instance().ReleaseSharedGPUResource(shared_resource);
+    }
+  });
+#endif
+
+  ShareOutputBindings();
   if (config_.new_executor_enabled()) {  // NOLINT
     executor_->RunInterpreterCore({}, false, switch_stream);
   } else {
     executor_->Run();
   }
+  SyncOutputBindings();
   inference::DisplayMemoryInfo(place_, "after run");
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the intermediate tensors of the run are released by now, a safe point to
+  // defragment
+  if (FLAGS_virtual_memory_defrag_threshold > 0 && phi::is_gpu_place(place_)) {
+    paddle::memory::Defragment(phi::GPUPlace(place_.GetDeviceId()),
+                               FLAGS_virtual_memory_defrag_threshold);
+  }
+#endif
 
 #ifdef PADDLE_WITH_XPU
   if (config_.use_xpu_ && infer_xpu_ctx != nullptr &&
@@ -2797,6 +3046,40 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   return true;
 }
 
+bool AnalysisPredictor::ZeroCopyRunAsync(std::function<void()> callback) {
+  if (!ZeroCopyRun()) {
+    return false;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(place_)) {
+    if (callback_manager_ == nullptr) {
+      callback_manager_ =
+          std::make_unique<platform::StreamCallbackManager<gpuStream_t>>(
+              static_cast<gpuStream_t>(GetExecStream()));
+    }
+    callback_manager_->AddCallback(std::move(callback));
+    return true;
+  }
+#endif
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if (phi::is_custom_place(place_)) {
+    phi::DeviceContextPool &pool = phi::DeviceContextPool::Instance();
+    static_cast<const phi::CustomContext *>(pool.Get(place_))
+        ->AddStreamCallback(std::move(callback));
+    return true;
+  }
+#endif
+#ifdef PADDLE_WITH_XPU
+  if (phi::is_xpu_place(place_)) {
+    paddle::platform::XPUStreamSync(
+        static_cast<paddle::xpuStream>(GetExecStream()));
+  }
+#endif
+  // the run is finished by now on the other places
+  callback();
+  return true;
+}
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 bool AnalysisPredictor::ExpRunWithExternalStream(const gpuStream_t stream) {
   if (!private_context_) {
@@ -2811,6 +3094,8 @@ bool AnalysisPredictor::ExpRunWithExternalStream(const gpuStream_t stream) {
 #else
     cudaStreamSynchronize(static_cast<gpuStream_t>(predictor_stream_));
 #endif
+    // the callbacks of the old stream are all queued by the synchronization
+    callback_manager_.reset();
     ResourceManager::Instance().GpuResourceSwitchStream(predictor_stream_,
                                                         stream);
     predictor_stream_ = stream;
@@ -3020,6 +3305,74 @@ void AnalysisPredictor::StatisticShapeRangeInfo() {
                                      min_values,
                                      max_values,
                                      opt_values);
+
+  // The k-th bucket of a tensor covers its shapes up to the k-th quantile of
+  // the numels, and its opt shape is the most frequent one of the shapes
+  // between the (k-1)-th and the k-th quantiles. The ranges of the buckets
+  // are nested, and the last bucket is the full range above.
+  const int bucket_num = config_.tensorrt_shape_bucket_num();
+  if (bucket_num <= 1) return;
+  std::vector<std::map<std::string, std::vector<int32_t>>> min_buckets(
+      bucket_num - 1);
+  std::vector<std::map<std::string, std::vector<int32_t>>> max_buckets(
+      bucket_num - 1);
+  std::vector<std::map<std::string, std::vector<int32_t>>> opt_buckets(
+      bucket_num - 1);
+  const auto Numel = [](const std::vector<int32_t> &shape) {
+    return std::accumulate(
+        shape.begin(), shape.end(), int64_t{1}, std::multiplies<int64_t>());
+  };
+  for (auto const &it : shape_info_) {
+    auto shapes = it.second;
+    std::stable_sort(shapes.begin(),
+                     shapes.end(),
+                     [&](const std::vector<int32_t> &lhs,
+                         const std::vector<int32_t> &rhs) {
+                       return Numel(lhs) < Numel(rhs);
+                     });
+    for (int k = 1; k < bucket_num; ++k) {
+      const size_t begin = shapes.size() * (k - 1) / bucket_num;
+      const size_t end = std::max(begin + 1, shapes.size() * k / bucket_num);
+      std::vector<int32_t> max_shape(shapes[0]);
+      std::vector<int32_t> opt_shape(shapes[0]);
+      for (size_t d = 0; d < shapes[0].size(); ++d) {
+        std::map<int32_t, int32_t> counter;
+        for (size_t i = 0; i < end; ++i) {
+          max_shape[d] = std::max(max_shape[d], shapes[i][d]);
+          if (i >= begin) counter[shapes[i][d]] += 1;
+        }
+        opt_shape[d] = std::max_element(counter.begin(),
+                                        counter.end(),
+                                        [](const auto &lhs, const auto &rhs) {
+                                          return lhs.second < rhs.second;
+                                        })
+                           ->first;
+      }
+      min_buckets[k - 1][it.first] = min_shapes[it.first];
+      max_buckets[k - 1][it.first] = max_shape;
+      opt_buckets[k - 1][it.first] = opt_shape;
+    }
+  }
+  // A bucket no narrower than the previous one, or than the full range, makes
+  // a redundant optimization profile.
+  size_t num_buckets = 0;
+  for (size_t k = 0; k < max_buckets.size(); ++k) {
+    if (max_buckets[k] == max_shapes ||
+        (num_buckets > 0 && max_buckets[k] == max_buckets[num_buckets - 1])) {
+      continue;
+    }
+    if (num_buckets != k) {
+      min_buckets[num_buckets] = std::move(min_buckets[k]);
+      max_buckets[num_buckets] = std::move(max_buckets[k]);
+      opt_buckets[num_buckets] = std::move(opt_buckets[k]);
+    }
+    ++num_buckets;
+  }
+  min_buckets.resize(num_buckets);
+  max_buckets.resize(num_buckets);
+  opt_buckets.resize(num_buckets);
+  inference::SerializeShapeRangeBuckets(
+      config_.shape_range_info_path(), min_buckets, max_buckets, opt_buckets);
 }
 
 bool AnalysisPredictor::LoadProgramDesc() {
@@ -3046,28 +3399,11 @@ bool AnalysisPredictor::LoadProgramDesc() {
   }
 
   // Create ProgramDesc
-  framework::proto::ProgramDesc proto;
   if (!config_.model_from_memory()) {
-    std::string pb_content;
-    // Read binary
-    std::ifstream fin(filename, std::ios::in | std::ios::binary);
-    PADDLE_ENFORCE_EQ(
-        static_cast<bool>(fin.is_open()),
-        true,
-        common::errors::NotFound(
-            "Cannot open file %s, please confirm whether the file is normal.",
-            filename));
-    fin.seekg(0, std::ios::end);
-    pb_content.resize(fin.tellg());
-    fin.seekg(0, std::ios::beg);
-    fin.read(&(pb_content.at(0)), pb_content.size());  // NOLINT
-    fin.close();
-
-    proto.ParseFromString(pb_content);
+    inference_program_ = LoadCachedProgramDesc(filename, false);
   } else {
-    proto.ParseFromString(config_.prog_file());
+    inference_program_ = LoadCachedProgramDesc(config_.prog_file(), true);
   }
-  inference_program_ = std::make_unique<framework::ProgramDesc>(proto);
   return true;
 }
 
@@ -3214,6 +3550,11 @@ bool AnalysisPredictor::SaveTrtCalibToDisk() {
 #endif
 
 AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (callback_manager_) {
+    callback_manager_->Wait();
+  }
+#endif
 #ifdef PADDLE_WITH_TENSORRT
   if (config_.tensorrt_engine_enabled() &&
       config_.tensorrt_precision_mode_ == AnalysisConfig::Precision::kInt8 &&
@@ -3249,6 +3590,11 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
   if (config_.shape_range_info_collected()) {
     StatisticShapeRangeInfo();
   }
+  if (config_.autotune_cache_writeback_ &&
+      !config_.autotune_cache_file().empty()) {
+    phi::autotune::AutoTuneCache::Instance().SaveToFile(
+        config_.autotune_cache_file());
+  }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   if (predictor_stream_ != nullptr) {
     ResourceManager::Instance().DestroyGPUResource(predictor_stream_);
@@ -3708,8 +4054,24 @@ std::map<std::string, DataType> Predictor::GetOutputTypes() {
   return predictor_->GetOutputTypes();
 }
 
+bool Predictor::BindOutput(const std::string &name,
+                           void *data,
+                           const std::vector<int> &shape,
+                           DataType dtype) {
+  return predictor_->BindOutput(name, data, shape, dtype);
+}
+
+bool Predictor::SetLoraAdapter(
+    int slot, const std::map<std::string, const float *> &weights) {
+  return predictor_->SetLoraAdapter(slot, weights);
+}
+
 bool Predictor::Run() { return predictor_->ZeroCopyRun(); }
 
+bool Predictor::RunAsync(std::function<void()> callback) {
+  return predictor_->ZeroCopyRunAsync(std::move(callback));
+}
+
 bool Predictor::Run(const std::vector<paddle::Tensor> &inputs,
                     std::vector<paddle::Tensor> *outputs) {
   return predictor_->Run(inputs, outputs);
@@ -3837,6 +4199,862 @@ Predictor *PredictorPool::Retrieve(size_t idx) {
   }
   return preds_[idx - 1].get();
 }
+
+namespace {
+template <typename Visitor>
+void VisitHostDataType(DataType dtype, Visitor &&visitor) {
+  switch (dtype) {
+    case DataType::FLOAT32:
+      visitor(float());
+      break;
+    case DataType::INT64:
+      visitor(int64_t());
+      break;
+    case DataType::INT32:
+      visitor(int32_t());
+      break;
+    case DataType::UINT8:
+      visitor(uint8_t());
+      break;
+    case DataType::INT8:
+      visitor(int8_t());
+      break;
+    case DataType::FLOAT16:
+      visitor(phi::dtype::float16());
+      break;
+    case DataType::BOOL:
+      visitor(bool());
+      break;
+    case DataType::FLOAT64:
+      visitor(double());
+      break;
+    case DataType::BFLOAT16:
+      visitor(phi::dtype::bfloat16());
+      break;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported data type (%d) in DynamicBatcher.",
+          static_cast<int>(dtype)));
+  }
+}
+
+void FeedHostTensor(Tensor *tensor,
+                    const std::vector<int> &shape,
+                    DataType dtype,
+                    const void *data) {
+  tensor->Reshape(shape);
+  VisitHostDataType(dtype, [&](auto type) {
+    using T = decltype(type);
+    tensor->CopyFromCpu(static_cast<const T *>(data));
+  });
+}
+
+void FetchHostTensor(const Tensor &tensor, void *data) {
+  VisitHostDataType(tensor.type(), [&](auto type) {
+    using T = decltype(type);
+    tensor.CopyToCpu(static_cast<T *>(data));
+  });
+}
+
+size_t HostTensorBytes(const std::vector<int> &shape, DataType dtype) {
+  size_t numel = std::accumulate(
+      shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+  return numel * GetNumBytesOfDataType(dtype);
+}
+
+// Returns the leading dim shared by all inputs, or -1 if the request can not
+// be concatenated with others.
+int RequestBatchSize(const std::vector<paddle::PaddleTensor> &inputs) {
+  if (inputs.empty()) return -1;
+  int batch_size = -1;
+  for (auto &input : inputs) {
+    if (input.shape.empty() || !input.lod.empty()) return -1;
+    if (batch_size != -1 && input.shape[0] != batch_size) return -1;
+    batch_size = input.shape[0];
+  }
+  return batch_size > 0 ? batch_size : -1;
+}
+
+bool BatchCompatible(const std::vector<paddle::PaddleTensor> &a,
+                     const std::vector<paddle::PaddleTensor> &b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].name != b[i].name || a[i].dtype != b[i].dtype ||
+        a[i].shape.size() != b[i].shape.size() ||
+        !std::equal(a[i].shape.begin() + 1,
+                    a[i].shape.end(),
+                    b[i].shape.begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+struct DynamicBatcher::Impl {
+  struct Request {
+    const std::vector<paddle::PaddleTensor> *inputs;
+    std::vector<paddle::PaddleTensor> *outputs;
+    int batch_size;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<bool> done;
+  };
+
+  void Loop();
+  void RunBatch(const std::vector<Request *> &batch, int total);
+  bool RunOne(const Request &request);
+
+  std::unique_ptr<Predictor> predictor;
+  DynamicBatchOptions options;
+
+  mutable std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Request *> queue;
+  bool stop{false};
+  DynamicBatchStats stats;
+  double total_queue_latency_us{0.};
+  std::thread worker;
+};
+
+void DynamicBatcher::Impl::Loop() {
+  while (true) {
+    std::vector<Request *> batch;
+    int total = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [this] { return stop || !queue.empty(); });
+      if (queue.empty()) return;
+      Request *head = queue.front();
+      queue.pop_front();
+      batch.push_back(head);
+      total = head->batch_size;
+      if (head->batch_size > 0) {
+        auto deadline = head->enqueue_time +
+                        std::chrono::microseconds(options.max_queue_delay_us);
+        while (true) {
+          // Requests that do not fit stay queued in order for the next batch.
+          for (auto it = queue.begin();
+               it != queue.end() && total < options.max_batch_size;) {
+            Request *req = *it;
+            if (req->batch_size > 0 &&
+                total + req->batch_size <= options.max_batch_size &&
+                BatchCompatible(*head->inputs, *req->inputs)) {
+              batch.push_back(req);
+              total += req->batch_size;
+              it = queue.erase(it);
+            } else {
+              ++it;
+            }
+          }
+          if (total >= options.max_batch_size || stop ||
+              std::chrono::steady_clock::now() >= deadline) {
+            break;
+          }
+          cv.wait_until(lock, deadline);
+        }
+      }
+      auto now = std::chrono::steady_clock::now();
+      for (auto *req : batch) {
+        double latency = std::chrono::duration<double, std::micro>(
+                             now - req->enqueue_time)
+                             .count();
+        total_queue_latency_us += latency;
+        stats.max_queue_latency_us =
+            std::max(stats.max_queue_latency_us, latency);
+      }
+      stats.num_requests += batch.size();
+      stats.num_batches += 1;
+    }
+    VLOG(4) << "DynamicBatcher runs " << batch.size()
+            << " requests with batch size " << total;
+    RunBatch(batch, total);
+  }
+}
+
+bool DynamicBatcher::Impl::RunOne(const Request &request) {
+  for (auto &input : *request.inputs) {
+    auto tensor = predictor->GetInputHandle(input.name);
+    FeedHostTensor(
+        tensor.get(), input.shape, input.dtype, input.data.data());
+    if (!input.lod.empty()) {
+      tensor->SetLoD(input.lod);
+    }
+  }
+  if (!predictor->Run()) return false;
+  auto *outputs = request.outputs;
+  outputs->clear();
+  for (auto &name : predictor->GetOutputNames()) {
+    auto tensor = predictor->GetOutputHandle(name);
+    paddle::PaddleTensor output;
+    output.name = name;
+    output.shape = tensor->shape();
+    output.dtype = tensor->type();
+    output.lod = tensor->lod();
+    output.data.Resize(HostTensorBytes(output.shape, output.dtype));
+    FetchHostTensor(*tensor, output.data.data());
+    outputs->push_back(std::move(output));
+  }
+  return true;
+}
+
+void DynamicBatcher::Impl::RunBatch(const std::vector<Request *> &batch,
+                                    int total) {
+  // The requests are answered in order, the ones not answered yet when the
+  // run throws get the exception. A request must not be touched once it is
+  // answered, its caller may have returned.
+  size_t answered = 0;
+  auto answer = [&](bool ok) { batch[answered++]->done.set_value(ok); };
+  try {
+    auto run_each = [&] {
+      for (auto *req : batch) {
+        answer(RunOne(*req));
+      }
+    };
+    if (batch.size() == 1) {
+      run_each();
+      return;
+    }
+    const auto &first = *batch.front()->inputs;
+    std::vector<char> buffer;
+    for (size_t i = 0; i < first.size(); ++i) {
+      buffer.clear();
+      for (auto *req : batch) {
+        auto &data = (*req->inputs)[i].data;
+        const char *ptr = static_cast<const char *>(data.data());
+        buffer.insert(buffer.end(), ptr, ptr + data.length());
+      }
+      auto shape = first[i].shape;
+      shape[0] = total;
+      FeedHostTensor(predictor->GetInputHandle(first[i].name).get(),
+                     shape,
+                     first[i].dtype,
+                     buffer.data());
+    }
+    if (!predictor->Run()) {
+      while (answered < batch.size()) answer(false);
+      return;
+    }
+
+    auto output_names = predictor->GetOutputNames();
+    std::vector<std::unique_ptr<Tensor>> output_tensors;
+    for (auto &name : output_names) {
+      auto tensor = predictor->GetOutputHandle(name);
+      auto shape = tensor->shape();
+      if (shape.empty() || shape[0] != total || !tensor->lod().empty()) {
+        // The outputs can not be split back along dim 0, serve the requests
+        // one by one instead.
+        VLOG(3) << "Output " << name << " of DynamicBatcher is not batched "
+                << "along dim 0, fall back to running requests one by one.";
+        run_each();
+        return;
+      }
+      output_tensors.push_back(std::move(tensor));
+    }
+    for (auto *req : batch) req->outputs->clear();
+    for (auto &tensor : output_tensors) {
+      auto shape = tensor->shape();
+      size_t bytes = HostTensorBytes(shape, tensor->type());
+      buffer.resize(bytes);
+      FetchHostTensor(*tensor, buffer.data());
+      size_t row_bytes = bytes / total;
+      size_t offset = 0;
+      for (auto *req : batch) {
+        paddle::PaddleTensor output;
+        output.name = tensor->name();
+        output.shape = shape;
+        output.shape[0] = req->batch_size;
+        output.dtype = tensor->type();
+        size_t length = row_bytes * req->batch_size;
+        output.data.Resize(length);
+        std::memcpy(output.data.data(), buffer.data() + offset, length);
+        offset += length;
+        req->outputs->push_back(std::move(output));
+      }
+    }
+    while (answered < batch.size()) answer(true);
+  } catch (...) {
+    auto error = std::current_exception();
+    while (answered < batch.size()) {
+      batch[answered++]->done.set_exception(error);
+    }
+  }
+}
+
+DynamicBatcher::DynamicBatcher(std::unique_ptr<Predictor> predictor,
+                               const DynamicBatchOptions &options)
+    : impl_(new Impl) {
+  PADDLE_ENFORCE_NOT_NULL(
+      predictor,
+      common::errors::InvalidArgument(
+          "The predictor of DynamicBatcher should not be null."));
+  PADDLE_ENFORCE_GE(options.max_batch_size,
+                    1,
+                    common::errors::InvalidArgument(
+                        "The max_batch_size of DynamicBatcher should be "
+                        "greater than 0, but it's (%d)",
+                        options.max_batch_size));
+  PADDLE_ENFORCE_GE(options.max_queue_delay_us,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The max_queue_delay_us of DynamicBatcher should not "
+                        "be negative, but it's (%d)",
+                        options.max_queue_delay_us));
+  impl_->predictor = std::move(predictor);
+  impl_->options = options;
+  impl_->worker = std::thread([this] { impl_->Loop(); });
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->stop = true;
+  }
+  impl_->cv.notify_all();
+  impl_->worker.join();
+}
+
+bool DynamicBatcher::Run(const std::vector<paddle::PaddleTensor> &inputs,
+                         std::vector<paddle::PaddleTensor> *outputs) {
+  PADDLE_ENFORCE_NOT_NULL(
+      outputs,
+      common::errors::InvalidArgument(
+          "The outputs of DynamicBatcher::Run should not be null."));
+  Impl::Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  request.batch_size = RequestBatchSize(inputs);
+  if (request.batch_size > impl_->options.max_batch_size) {
+    request.batch_size = -1;
+  }
+  auto done = request.done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    PADDLE_ENFORCE_EQ(impl_->stop,
+                      false,
+                      common::errors::PreconditionNotMet(
+                          "DynamicBatcher is being destroyed."));
+    request.enqueue_time = std::chrono::steady_clock::now();
+    impl_->queue.push_back(&request);
+  }
+  impl_->cv.notify_all();
+  return done.get();
+}
+
+DynamicBatchStats DynamicBatcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  DynamicBatchStats stats = impl_->stats;
+  if (stats.num_requests > 0) {
+    stats.avg_queue_latency_us =
+        impl_->total_queue_latency_us / stats.num_requests;
+  }
+  return stats;
+}
+
+struct GenerationScheduler::Impl {
+  struct Sequence {
+    uint64_t id;
+    // the prompt followed by the generated tokens
+    std::vector<int64_t> tokens;
+    int num_generated{0};
+    int max_new_tokens;
+    // the number of the tokens in the kv caches, 0 until it is prefilled
+    int num_cached{0};
+    int num_draft_cached{0};
+    // the tokens the draft model proposes in the current step
+    std::vector<int64_t> drafts;
+    std::vector<int> blocks;
+    TokenCallback callback;
+    bool cancelled{false};
+  };
+
+  // The tokens of a sequence a model runs in a step, after num_cached tokens.
+  struct Row {
+    Sequence *seq;
+    std::vector<int64_t> ids;
+    int num_cached;
+  };
+
+  struct Notification {
+    Sequence *seq;
+    int64_t token;
+    bool finished;
+  };
+
+  void Loop();
+  bool Schedule(std::vector<Sequence *> *batch);
+  void Preempt(std::unique_ptr<Sequence> seq);
+  void FreeBlocks(Sequence *seq, size_t num_kept = 0);
+  bool RunModel(Predictor *model,
+                const std::vector<Row> &rows,
+                bool all_tokens,
+                std::vector<std::vector<int64_t>> *outputs);
+  bool Draft(const std::vector<Sequence *> &batch);
+  bool RunStep(const std::vector<Sequence *> &batch,
+               std::vector<std::vector<int64_t>> *outputs);
+  void Finish(const std::vector<Sequence *> &batch,
+              const std::vector<std::vector<int64_t>> &outputs,
+              bool succeeded);
+
+  int NumBlocks(int num_tokens) const {
+    return (num_tokens + options.block_size - 1) / options.block_size;
+  }
+
+  // A sequence never holds more blocks than there are, or it could not be
+  // admitted again once preempted.
+  int MaxTokens() const {
+    return std::min(options.max_blocks_per_seq, options.num_blocks) *
+           options.block_size;
+  }
+
+  // The drafts of a prefilled sequence in a step, which neither pass the
+  // capacity nor propose tokens past max_new_tokens.
+  int NumDrafts(const Sequence &seq) const {
+    if (!draft_predictor || seq.num_cached == 0) return 0;
+    return std::max(
+        0,
+        std::min({options.num_speculative_tokens,
+                  MaxTokens() - static_cast<int>(seq.tokens.size()),
+                  seq.max_new_tokens - seq.num_generated - 1}));
+  }
+
+  std::unique_ptr<Predictor> predictor;
+  std::unique_ptr<Predictor> draft_predictor;
+  GenerationOptions options;
+
+  mutable std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::unique_ptr<Sequence>> waiting;
+  // in the order they are admitted, the newest is preempted first
+  std::vector<std::unique_ptr<Sequence>> running;
+  std::vector<int> free_blocks;
+  uint64_t next_id{0};
+  bool stop{false};
+  GenerationStats stats;
+  std::thread worker;
+};
+
+void GenerationScheduler::Impl::FreeBlocks(Sequence *seq, size_t num_kept) {
+  if (seq->blocks.size() <= num_kept) return;
+  free_blocks.insert(
+      free_blocks.end(), seq->blocks.begin() + num_kept, seq->blocks.end());
+  seq->blocks.resize(num_kept);
+}
+
+void GenerationScheduler::Impl::Preempt(std::unique_ptr<Sequence> seq) {
+  // The generated tokens are prefilled along with the prompt once it is
+  // admitted again.
+  FreeBlocks(seq.get());
+  seq->num_cached = 0;
+  seq->num_draft_cached = 0;
+  stats.num_preemptions += 1;
+  VLOG(3) << "GenerationScheduler preempts request " << seq->id;
+  waiting.push_front(std::move(seq));
+}
+
+// Picks the sequences of the next step, under the lock.
+bool GenerationScheduler::Impl::Schedule(std::vector<Sequence *> *batch) {
+  running.erase(std::remove_if(running.begin(),
+                               running.end(),
+                               [this](const std::unique_ptr<Sequence> &seq) {
+                                 if (seq->cancelled) FreeBlocks(seq.get());
+                                 return seq->cancelled;
+                               }),
+                running.end());
+
+  // A decode row writes its last token and its drafts, which may need new
+  // blocks.
+  bool preempted = false;
+  for (size_t i = 0; i < running.size();) {
+    Sequence *seq = running[i].get();
+    int num_tokens = static_cast<int>(seq->tokens.size()) + NumDrafts(*seq);
+    if (static_cast<int>(seq->blocks.size()) >= NumBlocks(num_tokens)) {
+      ++i;
+      continue;
+    }
+    if (!free_blocks.empty()) {
+      seq->blocks.push_back(free_blocks.back());
+      free_blocks.pop_back();
+      continue;
+    }
+    preempted = true;
+    std::unique_ptr<Sequence> victim = std::move(running.back());
+    running.pop_back();
+    Preempt(std::move(victim));
+  }
+
+  // Admits the waiting prompts in order while their blocks fit, but not
+  // right after a preemption, which would only take the blocks back.
+  int num_prefill_tokens = 0;
+  while (!preempted && !waiting.empty() &&
+         static_cast<int>(running.size()) < options.max_num_seqs) {
+    Sequence *seq = waiting.front().get();
+    int num_tokens = static_cast<int>(seq->tokens.size());
+    int num_blocks = NumBlocks(num_tokens);
+    if ((num_prefill_tokens > 0 &&
+         num_prefill_tokens + num_tokens > options.max_prefill_tokens) ||
+        num_blocks > static_cast<int>(free_blocks.size())) {
+      break;
+    }
+    seq->blocks.assign(free_blocks.end() - num_blocks, free_blocks.end());
+    free_blocks.resize(free_blocks.size() - num_blocks);
+    num_prefill_tokens += num_tokens;
+    running.push_back(std::move(waiting.front()));
+    waiting.pop_front();
+  }
+
+  for (auto &seq : running) {
+    batch->push_back(seq.get());
+  }
+  return !batch->empty();
+}
+
+// Runs a model out of the lock, only the worker touches the tokens and the
+// blocks of the running sequences. outputs[i] is the token generated after
+// the last token of rows[i], or after each of its tokens with all_tokens.
+bool GenerationScheduler::Impl::RunModel(
+    Predictor *model,
+    const std::vector<Row> &rows,
+    bool all_tokens,
+    std::vector<std::vector<int64_t>> *outputs) {
+  const int num_seqs = static_cast<int>(rows.size());
+  int max_len = 1;
+  for (auto &row : rows) {
+    max_len = std::max(max_len, static_cast<int>(row.ids.size()));
+  }
+  std::vector<int64_t> input_ids(static_cast<size_t>(num_seqs) * max_len, 0);
+  std::vector<int32_t> seq_lens_this_time(num_seqs);
+  std::vector<int32_t> seq_lens_encoder(num_seqs);
+  std::vector<int32_t> seq_lens_decoder(num_seqs);
+  std::vector<int32_t> block_tables(
+      static_cast<size_t>(num_seqs) * options.max_blocks_per_seq, -1);
+  for (int i = 0; i < num_seqs; ++i) {
+    const Row &row = rows[i];
+    std::copy(row.ids.begin(),
+              row.ids.end(),
+              input_ids.begin() + static_cast<size_t>(i) * max_len);
+    seq_lens_this_time[i] = static_cast<int32_t>(row.ids.size());
+    seq_lens_encoder[i] = (row.num_cached == 0 || row.ids.size() > 1)
+                              ? seq_lens_this_time[i]
+                              : 0;
+    seq_lens_decoder[i] = row.num_cached;
+    std::copy(row.seq->blocks.begin(),
+              row.seq->blocks.end(),
+              block_tables.begin() +
+                  static_cast<size_t>(i) * options.max_blocks_per_seq);
+  }
+
+  auto feed = [model](const std::string &name,
+                      const std::vector<int> &shape,
+                      const auto &data) {
+    auto tensor = model->GetInputHandle(name);
+    tensor->Reshape(shape);
+    tensor->CopyFromCpu(data.data());
+  };
+  feed(options.input_ids_name, {num_seqs, max_len}, input_ids);
+  feed(options.seq_lens_this_time_name, {num_seqs}, seq_lens_this_time);
+  feed(options.seq_lens_encoder_name, {num_seqs, 1}, seq_lens_encoder);
+  feed(options.seq_lens_decoder_name, {num_seqs, 1}, seq_lens_decoder);
+  feed(options.block_tables_name,
+       {num_seqs, options.max_blocks_per_seq},
+       block_tables);
+  if (!model->Run()) return false;
+
+  auto output = model->GetOutputHandle(options.next_tokens_name);
+  auto shape = output->shape();
+  int numel = std::accumulate(
+      shape.begin(), shape.end(), 1, std::multiplies<int>());
+  // A step of decode rows only, e.g. with no room left for drafts, has
+  // max_len 1, whose outputs are per token as well.
+  bool per_token = numel == num_seqs * max_len;
+  if (output->type() != DataType::INT64 ||
+      (numel != num_seqs && !per_token) || (all_tokens && !per_token)) {
+    LOG(ERROR) << "The output " << options.next_tokens_name
+               << " of GenerationScheduler should be int64 of " << num_seqs
+               << (all_tokens ? " * " + std::to_string(max_len) : "")
+               << " tokens, but got " << numel << " elements of type "
+               << static_cast<int>(output->type()) << ".";
+    return false;
+  }
+  std::vector<int64_t> next_tokens(numel);
+  output->CopyToCpu(next_tokens.data());
+  outputs->resize(num_seqs);
+  for (int i = 0; i < num_seqs; ++i) {
+    auto &out = (*outputs)[i];
+    if (!per_token) {
+      out.assign(1, next_tokens[i]);
+      continue;
+    }
+    auto begin = next_tokens.begin() + static_cast<size_t>(i) * max_len;
+    int len = seq_lens_this_time[i];
+    if (all_tokens) {
+      out.assign(begin, begin + len);
+    } else {
+      out.assign(1, begin[len - 1]);
+    }
+  }
+  return true;
+}
+
+// Proposes the drafts of the decode rows with the draft model. Its first
+// run also catches its kv caches up with the committed tokens, e.g. the
+// prompts of the prefill rows.
+bool GenerationScheduler::Impl::Draft(const std::vector<Sequence *> &batch) {
+  std::vector<Row> rows;
+  for (auto *seq : batch) {
+    seq->drafts.clear();
+    rows.push_back({seq,
+                    std::vector<int64_t>(
+                        seq->tokens.begin() + seq->num_draft_cached,
+                        seq->tokens.end()),
+                    seq->num_draft_cached});
+  }
+  std::vector<std::vector<int64_t>> outputs;
+  while (!rows.empty()) {
+    if (!RunModel(draft_predictor.get(), rows, false, &outputs)) {
+      return false;
+    }
+    std::vector<Row> next_rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+      Sequence *seq = rows[i].seq;
+      seq->num_draft_cached += static_cast<int>(rows[i].ids.size());
+      if (static_cast<int>(seq->drafts.size()) < NumDrafts(*seq)) {
+        seq->drafts.push_back(outputs[i][0]);
+      }
+      // the last draft is not run by the draft model
+      if (static_cast<int>(seq->drafts.size()) < NumDrafts(*seq)) {
+        next_rows.push_back(
+            {seq, {seq->drafts.back()}, seq->num_draft_cached});
+      }
+    }
+    rows.swap(next_rows);
+  }
+  return true;
+}
+
+bool GenerationScheduler::Impl::RunStep(
+    const std::vector<Sequence *> &batch,
+    std::vector<std::vector<int64_t>> *outputs) {
+  if (draft_predictor && !Draft(batch)) return false;
+  std::vector<Row> rows;
+  for (auto *seq : batch) {
+    Row row{seq,
+            std::vector<int64_t>(seq->tokens.begin() + seq->num_cached,
+                                 seq->tokens.end()),
+            seq->num_cached};
+    row.ids.insert(row.ids.end(), seq->drafts.begin(), seq->drafts.end());
+    rows.push_back(std::move(row));
+  }
+  return RunModel(
+      predictor.get(), rows, draft_predictor != nullptr, outputs);
+}
+
+void GenerationScheduler::Impl::Finish(
+    const std::vector<Sequence *> &batch,
+    const std::vector<std::vector<int64_t>> &outputs,
+    bool succeeded) {
+  const int max_tokens = MaxTokens();
+  std::vector<Notification> notifications;
+  std::vector<std::unique_ptr<Sequence>> finished;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.num_steps += 1;
+    for (size_t i = 0; i < batch.size(); ++i) {
+      Sequence *seq = batch[i];
+      const bool prefill = seq->num_cached == 0;
+      const int num_tokens = static_cast<int>(seq->tokens.size());
+      std::vector<int64_t> tokens{-1};
+      if (succeeded) {
+        // The drafts agreeing with the target model are accepted, followed
+        // by the target token after the last of them.
+        const auto &out = outputs[i];
+        const size_t last = out.size() - 1 - seq->drafts.size();
+        size_t accepted = 0;
+        while (accepted < seq->drafts.size() &&
+               seq->drafts[accepted] == out[last + accepted]) {
+          ++accepted;
+        }
+        tokens.assign(seq->drafts.begin(), seq->drafts.begin() + accepted);
+        tokens.push_back(out[last + accepted]);
+        stats.num_draft_tokens += seq->drafts.size();
+        stats.num_accepted_tokens += accepted;
+      }
+      if (prefill) {
+        stats.num_prefill_tokens += num_tokens;
+      } else {
+        stats.num_decode_tokens += tokens.size();
+      }
+      // rolls the kv caches back to the committed tokens
+      seq->num_cached = num_tokens + static_cast<int>(tokens.size()) - 1;
+      seq->num_draft_cached =
+          std::min(seq->num_draft_cached, seq->num_cached);
+      seq->drafts.clear();
+      if (seq->cancelled) continue;
+      for (int64_t token : tokens) {
+        seq->tokens.push_back(token);
+        seq->num_generated += 1;
+        seq->cancelled = !succeeded || token == options.end_token_id ||
+                         seq->num_generated >= seq->max_new_tokens ||
+                         static_cast<int>(seq->tokens.size()) > max_tokens;
+        notifications.push_back({seq, token, seq->cancelled});
+        if (seq->cancelled) break;
+      }
+      FreeBlocks(seq, NumBlocks(static_cast<int>(seq->tokens.size())));
+    }
+    // The finished sequences are dropped out of the lock, after the
+    // callbacks are called.
+    for (auto it = running.begin(); it != running.end();) {
+      if ((*it)->cancelled) {
+        FreeBlocks(it->get());
+        finished.push_back(std::move(*it));
+        it = running.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (auto &notification : notifications) {
+    notification.seq->callback(notification.token, notification.finished);
+  }
+}
+
+void GenerationScheduler::Impl::Loop() {
+  while (true) {
+    std::vector<Sequence *> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock,
+              [this] { return stop || !waiting.empty() || !running.empty(); });
+      if (stop) return;
+      if (!Schedule(&batch)) continue;
+    }
+    VLOG(4) << "GenerationScheduler runs a step of " << batch.size()
+            << " sequences";
+    std::vector<std::vector<int64_t>> outputs;
+    bool succeeded = false;
+    try {
+      succeeded = RunStep(batch, &outputs);
+    } catch (const std::exception &e) {
+      // The sequences of the step end as after a failed step, which frees
+      // their blocks.
+      LOG(ERROR) << "GenerationScheduler fails to run a step of "
+                 << batch.size() << " sequences: " << e.what();
+    }
+    Finish(batch, outputs, succeeded);
+  }
+}
+
+GenerationScheduler::GenerationScheduler(std::unique_ptr<Predictor> predictor,
+                                         const GenerationOptions &options)
+    : GenerationScheduler(std::move(predictor), nullptr, options) {}
+
+GenerationScheduler::GenerationScheduler(
+    std::unique_ptr<Predictor> predictor,
+    std::unique_ptr<Predictor> draft_predictor,
+    const GenerationOptions &options)
+    : impl_(new Impl) {
+  PADDLE_ENFORCE_NOT_NULL(
+      predictor,
+      common::errors::InvalidArgument(
+          "The predictor of GenerationScheduler should not be null."));
+  for (int value : {options.num_blocks,
+                    options.block_size,
+                    options.max_blocks_per_seq,
+                    options.max_num_seqs,
+                    options.max_prefill_tokens,
+                    options.num_speculative_tokens}) {
+    PADDLE_ENFORCE_GE(value,
+                      1,
+                      common::errors::InvalidArgument(
+                          "The sizes in GenerationOptions should be greater "
+                          "than 0, but got (%d)",
+                          value));
+  }
+  impl_->predictor = std::move(predictor);
+  impl_->draft_predictor = std::move(draft_predictor);
+  impl_->options = options;
+  impl_->free_blocks.resize(options.num_blocks);
+  // blocks are taken from the back, so the low ids go first
+  std::iota(impl_->free_blocks.rbegin(), impl_->free_blocks.rend(), 0);
+  impl_->worker = std::thread([this] { impl_->Loop(); });
+}
+
+GenerationScheduler::~GenerationScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->stop = true;
+  }
+  impl_->cv.notify_all();
+  impl_->worker.join();
+}
+
+uint64_t GenerationScheduler::AddRequest(const std::vector<int64_t> &prompt,
+                                         int max_new_tokens,
+                                         TokenCallback callback) {
+  const int max_tokens = impl_->MaxTokens();
+  PADDLE_ENFORCE_EQ(
+      !prompt.empty() && static_cast<int>(prompt.size()) <= max_tokens,
+      true,
+      common::errors::InvalidArgument(
+          "The prompt of GenerationScheduler should have 1 to %d tokens, but "
+          "got %d.",
+          max_tokens,
+          prompt.size()));
+  PADDLE_ENFORCE_GE(max_new_tokens,
+                    1,
+                    common::errors::InvalidArgument(
+                        "The max_new_tokens of GenerationScheduler should be "
+                        "greater than 0, but got (%d)",
+                        max_new_tokens));
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(callback),
+      true,
+      common::errors::InvalidArgument(
+          "The callback of GenerationScheduler should not be empty."));
+  auto seq = std::make_unique<Impl::Sequence>();
+  seq->tokens = prompt;
+  seq->max_new_tokens = max_new_tokens;
+  seq->callback = std::move(callback);
+  uint64_t id = 0;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    PADDLE_ENFORCE_EQ(impl_->stop,
+                      false,
+                      common::errors::PreconditionNotMet(
+                          "GenerationScheduler is being destroyed."));
+    id = impl_->next_id++;
+    seq->id = id;
+    impl_->waiting.push_back(std::move(seq));
+    impl_->stats.num_requests += 1;
+  }
+  impl_->cv.notify_all();
+  return id;
+}
+
+bool GenerationScheduler::Cancel(uint64_t request_id) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  auto &waiting = impl_->waiting;
+  for (auto it = waiting.begin(); it != waiting.end(); ++it) {
+    if ((*it)->id == request_id) {
+      waiting.erase(it);
+      return true;
+    }
+  }
+  // A running sequence is dropped by the worker before the next step.
+  for (auto &seq : impl_->running) {
+    if (seq->id == request_id && !seq->cancelled) {
+      seq->cancelled = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+GenerationStats GenerationScheduler::GetStats() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  GenerationStats stats = impl_->stats;
+  stats.num_free_blocks = impl_->free_blocks.size();
+  return stats;
+}
 }  // namespace services
 
 namespace experimental {
@@ -29,6 +29,9 @@
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
 #include "paddle/fluid/platform/device/gpu/gpu_types.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/stream_callback_manager.h"
+#endif
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/float16.h"
 #include "paddle/utils/string/printf.h"
@@ -206,6 +209,38 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   std::map<std::string, paddle_infer::DataType> GetOutputTypes() override;
 
+  ///
+  /// \brief Bind the output to an external buffer on the place of the
+  /// predictor. The buffer is shared into the output variable before each
+  /// run, so the kernels write the output into it in place, and only an
+  /// output whose holder is replaced during the run, e.g. shared from its
+  /// producer, is copied into the buffer on the device after the run.
+  ///
+  /// \param name The output name
+  /// \param data The buffer, or nullptr to unbind the output
+  /// \param shape The shape of the output written into the buffer
+  /// \param dtype The data type of the output
+  /// \return Whether the output is bound
+  ///
+  bool BindOutput(const std::string &name,
+                  void *data,
+                  const std::vector<int> &shape,
+                  paddle_infer::DataType dtype) override;
+
+  ///
+  /// \brief Write the weights of a LoRA adapter into a slot of the stacked
+  /// adapter parameters, which are shared with the clones of the predictor.
+  /// The weights are cast to the data type of the parameters, which may be
+  /// changed by the mixed precision conversion. The parameters taken into a
+  /// TensorRT engine are not updated.
+  ///
+  /// \param slot The index of the adapter in the stacked parameters
+  /// \param weights The float32 weights of the slot by the parameter name
+  /// \return Whether the adapter is written
+  ///
+  bool SetLoraAdapter(
+      int slot, const std::map<std::string, const float *> &weights) override;
+
   ///
   /// \brief Run the prediction engine
   ///
@@ -214,6 +249,16 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   bool ZeroCopyRun(bool switch_stream = false) override;
 
+  ///
+  /// \brief Run the prediction engine, and call the callback once the run is
+  /// finished on the device instead of waiting for it. On GPU the callback
+  /// is queued to the stream and run on a worker thread of the predictor.
+  ///
+  /// \param callback The callback on the completion of the run
+  /// \return Whether the run is launched successfully
+  ///
+  bool ZeroCopyRunAsync(std::function<void()> callback) override;
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // Note: Can only be used under thread_local semantics.
   bool ExpRunWithExternalStream(const gpuStream_t stream);
@@ -514,6 +559,10 @@ class AnalysisPredictor : public PaddlePredictor {
  private:
   void StatisticShapeRangeInfo();
   void HookCollectShapeRangeInfo();
+  // Share the bound buffers into the output variables.
+  void ShareOutputBindings();
+  // Copy the outputs not written into their bound buffers.
+  void SyncOutputBindings();
   void InitPlace();
   void InitDeviceContexts();
   void InitResourceManager(void *stream);
@@ -617,6 +666,8 @@ class AnalysisPredictor : public PaddlePredictor {
   std::once_flag register_output_hook_flag_;
   std::vector<OutputTensorHookFunc> output_hookfuncs_;
   std::vector<InputTensorHookFunc> input_hookfuncs_;
+  // The external buffers bound to the outputs, keyed by the output name.
+  std::map<std::string, phi::DenseTensor> output_bindings_;
   // Some status here that help to determine the status inside the predictor.
   bool status_is_cloned_{false};
 
@@ -625,6 +676,11 @@ class AnalysisPredictor : public PaddlePredictor {
 
   bool private_context_{false};
   void *predictor_stream_{nullptr};
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // Run the callbacks of the async runs once the stream reaches them.
+  std::unique_ptr<platform::StreamCallbackManager<gpuStream_t>>
+      callback_manager_;
+#endif
   std::map<phi::Place, std::shared_future<std::unique_ptr<phi::DeviceContext>>>
       device_contexts_;
 
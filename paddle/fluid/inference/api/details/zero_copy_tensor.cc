@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_layout_transform.h"
+#include "paddle/fluid/framework/dlpack_tensor.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/string_array.h"
@@ -367,6 +368,104 @@ void Tensor::ShareExternalData(const T *data,
   }
 }
 
+phi::DataType DLDataTypeConvert(const ::DLDataType &type) {
+  PADDLE_ENFORCE_EQ(
+      type.lanes,
+      1,
+      common::errors::Unimplemented("Vector type is not supported currently."));
+  if (type.code == kDLFloat) {
+    switch (type.bits) {
+      case 16:
+        return phi::DataType::FLOAT16;
+      case 32:
+        return phi::DataType::FLOAT32;
+      case 64:
+        return phi::DataType::FLOAT64;
+    }
+  } else if (type.code == kDLBfloat && type.bits == 16) {
+    return phi::DataType::BFLOAT16;
+  } else if (type.code == kDLInt) {
+    switch (type.bits) {
+      case 8:
+        return phi::DataType::INT8;
+      case 16:
+        return phi::DataType::INT16;
+      case 32:
+        return phi::DataType::INT32;
+      case 64:
+        return phi::DataType::INT64;
+    }
+  } else if (type.code == kDLUInt && type.bits == 8) {
+    return phi::DataType::UINT8;
+  }
+  PADDLE_THROW(common::errors::Unimplemented(
+      "DLDataType code <%d> is not supported when DLDataType.bits is <%d>.",
+      type.code,
+      type.bits));
+}
+
+void Tensor::ShareExternalData(DLManagedTensor *dl_tensor) {
+  PADDLE_ENFORCE_NOT_NULL(
+      dl_tensor,
+      common::errors::InvalidArgument(
+          "The DLPack tensor to share should not be null."));
+  EAGER_GET_TENSOR(phi::DenseTensor)
+  const ::DLTensor &src = dl_tensor->dl_tensor;
+  std::vector<int64_t> shape(src.shape, src.shape + src.ndim);
+  if (src.strides != nullptr) {
+    int64_t stride = 1;
+    for (int i = src.ndim - 1; i >= 0; --i) {
+      PADDLE_ENFORCE_EQ(
+          shape[i] == 1 || src.strides[i] == stride,
+          true,
+          common::errors::InvalidArgument(
+              "Only the DLPack tensor in the compact row major layout can be "
+              "shared, but the stride of the axis %d is %d.",
+              i,
+              src.strides[i]));
+      stride *= shape[i];
+    }
+  }
+
+  phi::Place place;
+  if (src.device.device_type == kDLCPU) {
+    place = phi::CPUPlace();
+  } else if (src.device.device_type == kDLGPU) {
+    place = phi::GPUPlace(src.device.device_id);
+  } else if (src.device.device_type == kDLCPUPinned) {
+    place = phi::GPUPinnedPlace();
+  } else {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "The DLPack tensor on device type <%d> can not be shared.",
+        src.device.device_type));
+  }
+
+  phi::DenseTensorMeta meta(DLDataTypeConvert(src.dtype),
+                            common::make_ddim(shape));
+  const size_t size = common::product(meta.dims) * phi::SizeOf(meta.dtype);
+  void *data = static_cast<char *>(src.data) + src.byte_offset;
+  // the data is given back to its owner once the last holder is released
+  std::shared_ptr<phi::Allocation> holder(
+      new phi::Allocation(data, size, place),
+      [dl_tensor](phi::Allocation *allocation) {
+        delete allocation;
+        if (dl_tensor->deleter != nullptr) {
+          dl_tensor->deleter(dl_tensor);
+        }
+      });
+  *tensor = phi::DenseTensor(holder, meta);
+}
+
+DLManagedTensor *Tensor::ToDLPack() const {
+  EAGER_GET_TENSOR(phi::DenseTensor)
+  PADDLE_ENFORCE_EQ(
+      tensor->initialized(),
+      true,
+      common::errors::PreconditionNotMet(
+          "The tensor [%s] has no data to export as a DLPack tensor.", name_));
+  return paddle::framework::toDLPack(*tensor);
+}
+
 void Tensor::CopyStringsFromCpu(const paddle_infer::Strings *data) {
   EAGER_GET_TENSOR(paddle::framework::Strings);
   PADDLE_ENFORCE_GE(tensor->size(),
@@ -807,9 +906,32 @@ void Tensor::ORTCopyToCpu(T *data) const {
 
   if (place_ == PlaceType::kCPU) {
     std::memcpy(static_cast<void *>(data), value.GetTensorData<void *>(), size);
+  } else if (place_ == PlaceType::kGPU) {
+#ifdef PADDLE_WITH_CUDA
+    // the output is written on the stream of the device context, which the
+    // execution providers of the predictor run on
+    phi::GPUPlace gpu_place(device_);
+    auto *dev_ctxs = reinterpret_cast<const std::map<
+        phi::Place,
+        std::shared_future<std::unique_ptr<phi::DeviceContext>>> *>(
+        device_contexts_);
+    auto *dev_ctx =
+        static_cast<phi::GPUContext *>(dev_ctxs->at(gpu_place).get().get());
+    paddle::memory::Copy(phi::CPUPlace(),
+                         static_cast<void *>(data),
+                         gpu_place,
+                         value.GetTensorData<void>(),
+                         size,
+                         dev_ctx->stream());
+    cudaStreamSynchronize(dev_ctx->stream());
+#else
+    PADDLE_THROW(common::errors::Unavailable(
+        "Can not copy the ONNXRuntime output on GPU because paddle is not "
+        "compiled with CUDA."));
+#endif
   } else {
     PADDLE_THROW(common::errors::Unavailable(
-        "CopyToCpu error.The current ONNXRuntime backend doesn't support "
+        "CopyToCpu error. The ONNXRuntime backend only supports CPU and "
         "GPU."));
   }
 }
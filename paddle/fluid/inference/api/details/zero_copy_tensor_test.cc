@@ -22,6 +22,7 @@
 #include <random>
 
 #include "paddle/fluid/framework/data_type.h"
+#include "paddle/fluid/framework/dlpack_tensor.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_tensor.h"
@@ -152,4 +153,44 @@ TEST(Tensor, FillRandomDataAndCheck) {
 #endif
 }
 
+TEST(Tensor, DLPackZeroCopy) {
+  paddle::framework::Scope scope;
+  const std::string name{"name"};
+  scope.Var(name);
+  auto tensor = CreateTensor(PlaceType::kCPU, &scope, name);
+
+  std::vector<float> data{1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+  std::vector<int64_t> shape{2, 3};
+  bool deleted = false;
+  DLManagedTensor dl_tensor{};
+  dl_tensor.dl_tensor.data = data.data();
+  dl_tensor.dl_tensor.device = {kDLCPU, 0};
+  dl_tensor.dl_tensor.ndim = 2;
+  dl_tensor.dl_tensor.dtype = {kDLFloat, 32, 1};
+  dl_tensor.dl_tensor.shape = shape.data();
+  dl_tensor.manager_ctx = &deleted;
+  dl_tensor.deleter = [](DLManagedTensor* self) {
+    *static_cast<bool*>(self->manager_ctx) = true;
+  };
+
+  tensor->ShareExternalData(&dl_tensor);
+  PlaceType place;
+  int size = 0;
+  ASSERT_EQ(tensor->data<float>(&place, &size), data.data());
+  ASSERT_EQ(size, 6);
+  ASSERT_EQ(tensor->shape(), (std::vector<int>{2, 3}));
+
+  DLManagedTensor* exported = tensor->ToDLPack();
+  ASSERT_EQ(exported->dl_tensor.data, data.data());
+  ASSERT_EQ(exported->dl_tensor.ndim, 2);
+  ASSERT_EQ(exported->dl_tensor.shape[1], 3);
+
+  // the data is given back once neither the tensor nor the export uses it
+  std::vector<float> other(6);
+  tensor->ShareExternalData<float>(other.data(), {2, 3}, PlaceType::kCPU);
+  ASSERT_FALSE(deleted);
+  exported->deleter(exported);
+  ASSERT_TRUE(deleted);
+}
+
 }  // namespace paddle_infer
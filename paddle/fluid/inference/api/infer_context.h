@@ -34,6 +34,7 @@ class InferGPUContext : public phi::GPUContext {
   using phi::GPUContext::SetBlasHandle;
   using phi::GPUContext::SetBlasTensorCoreHandle;
   using phi::GPUContext::SetBlasTF32Handle;
+  using phi::GPUContext::SetBlasLtHandle;
   using phi::GPUContext::SetDnnHandle;
   using phi::GPUContext::SetEigenDevice;
   using phi::GPUContext::SetSolverHandle;
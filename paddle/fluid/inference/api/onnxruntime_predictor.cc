@@ -37,6 +37,9 @@
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/memcpy.h"
+#ifdef PADDLE_WITH_CUDA
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#endif
 
 namespace paddle {
 
@@ -86,20 +89,78 @@ bool CheckConvertToONNX(const AnalysisConfig &config) {
   }
 }
 
-bool ONNXRuntimePredictor::InitBinding() {
-  // Now ONNXRuntime only support CPU
-  const char *device_name = config_.use_gpu() ? "Cuda" : "Cpu";
-  if (config_.use_gpu()) {
-    place_ = phi::GPUPlace(config_.gpu_device_id());
-  } else {
-    place_ = phi::CPUPlace();
+void ONNXRuntimePredictor::AppendExecutionProviders(
+    Ort::SessionOptions *session_options) {
+  place_ = phi::CPUPlace();
+  if (!config_.use_gpu()) {
+    return;
+  }
+#ifdef PADDLE_WITH_CUDA
+  const auto providers = Ort::GetAvailableProviders();
+  const auto available = [&](const std::string &provider) {
+    return std::find(providers.begin(), providers.end(), provider) !=
+           providers.end();
+  };
+  if (!available("CUDAExecutionProvider")) {
+    LOG(WARNING) << "The ONNXRuntime linked is not built with CUDA, the "
+                    "ONNXRuntime predictor falls back to CPU.";
+    return;
   }
+  place_ = phi::GPUPlace(config_.gpu_device_id());
+  // the providers run on the stream of the device context, which the inputs
+  // and outputs are copied on, so they need no synchronization in between
+  auto *dev_ctx = static_cast<phi::GPUContext *>(
+      phi::DeviceContextPool::Instance().Get(place_));
+
+  if (config_.ort_tensorrt_enabled()) {
+    if (available("TensorrtExecutionProvider")) {
+      std::string cache_dir = config_.ort_tensorrt_cache_dir();
+      if (cache_dir.empty() && !config_.model_from_memory()) {
+        cache_dir = inference::analysis::GetDirRoot(config_.prog_file());
+      }
+      OrtTensorRTProviderOptions trt_options{};
+      trt_options.device_id = place_.GetDeviceId();
+      trt_options.has_user_compute_stream = 1;
+      trt_options.user_compute_stream = dev_ctx->stream();
+      trt_options.trt_max_partition_iterations = 1000;
+      trt_options.trt_min_subgraph_size = 1;
+      trt_options.trt_max_workspace_size = 1 << 30;
+      trt_options.trt_fp16_enable = config_.ort_tensorrt_fp16_enabled();
+      // the engines built are kept in the cache dir, and are loaded instead
+      // of built again by the sessions to come
+      if (!cache_dir.empty()) {
+        inference::analysis::MakeDirIfNotExists(cache_dir);
+        trt_options.trt_engine_cache_enable = 1;
+        trt_options.trt_engine_cache_path = cache_dir.c_str();
+      }
+      session_options->AppendExecutionProvider_TensorRT(trt_options);
+      VLOG(3) << "ONNXRuntime TensorRT engine cache dir: " << cache_dir;
+    } else {
+      LOG(WARNING) << "The ONNXRuntime linked is not built with TensorRT, "
+                      "only the CUDA execution provider is used.";
+    }
+  }
+
+  OrtCUDAProviderOptions cuda_options;
+  cuda_options.device_id = place_.GetDeviceId();
+  cuda_options.has_user_compute_stream = 1;
+  cuda_options.user_compute_stream = dev_ctx->stream();
+  session_options->AppendExecutionProvider_CUDA(cuda_options);
+#else
+  LOG(WARNING) << "Paddle is not compiled with CUDA, the ONNXRuntime "
+                  "predictor falls back to CPU.";
+#endif
+}
+
+bool ONNXRuntimePredictor::InitBinding() {
+  const char *device_name = phi::is_cpu_place(place_) ? "Cpu" : "Cuda";
   scope_.reset(new paddle::framework::Scope());
 
   binding_ = std::make_shared<Ort::IoBinding>(*session_);
-  Ort::MemoryInfo memory_info(
+  memory_info_ = Ort::MemoryInfo(
       device_name, OrtDeviceAllocator, place_.GetDeviceId(), OrtMemTypeDefault);
-  Ort::Allocator allocator(*session_, memory_info);
+  // the names are allocated on the CPU whatever the place is
+  Ort::AllocatorWithDefaultOptions allocator;
 
   size_t n_inputs = session_->GetInputCount();
   framework::proto::VarType::Type proto_type =
@@ -129,11 +190,7 @@ bool ONNXRuntimePredictor::InitBinding() {
         type_info.GetTensorTypeAndShapeInfo().GetElementType();
     output_desc_.emplace_back(ONNXDesc{output_name, shape, data_type});
 
-    Ort::MemoryInfo out_memory_info(device_name,
-                                    OrtDeviceAllocator,
-                                    place_.GetDeviceId(),
-                                    OrtMemTypeDefault);
-    binding_->BindOutput(output_name, out_memory_info);
+    binding_->BindOutput(output_name, memory_info_);
 
     allocator.Free(output_name);
   }
@@ -171,6 +228,7 @@ bool ONNXRuntimePredictor::Init() {
   // session_options.SetInterOpNumThreads(config_.cpu_math_library_num_threads());
   session_options.SetIntraOpNumThreads(config_.cpu_math_library_num_threads());
   VLOG(2) << "ONNXRuntime threads " << config_.cpu_math_library_num_threads();
+  AppendExecutionProviders(&session_options);
   if (config_.profile_enabled()) {
     LOG(WARNING) << "ONNXRuntime Profiler is activated, which might affect the "
                     "performance";
@@ -308,17 +366,14 @@ std::unique_ptr<ZeroCopyTensor> ONNXRuntimePredictor::GetOutputTensor(
   return res;
 }
 
-Ort::Value ONNXRuntimePredictor::GetOrtValue(const ONNXDesc &desc,
-                                             const char *device_name) {
-  Ort::MemoryInfo memory_info(
-      device_name, OrtDeviceAllocator, place_.GetDeviceId(), OrtMemTypeDefault);
+Ort::Value ONNXRuntimePredictor::GetOrtValue(const ONNXDesc &desc) {
   auto *var = scope_->FindVar(desc.name);
   auto *tensor = var->GetMutable<phi::DenseTensor>();
   size_t size =
       tensor->numel() *
       framework::SizeOfType(framework::TransToProtoVarType(tensor->dtype()));
   std::vector<int64_t> shape = common::vectorize<int64_t>(tensor->dims());
-  return Ort::Value::CreateTensor(memory_info,
+  return Ort::Value::CreateTensor(memory_info_,
                                   static_cast<void *>(tensor->data()),
                                   size,
                                   shape.data(),
@@ -335,19 +390,17 @@ bool ONNXRuntimePredictor::Run(const std::vector<PaddleTensor> &inputs,
 
 bool ONNXRuntimePredictor::ZeroCopyRun(bool switch_stream) {
   try {
-    const char *device_name = phi::is_cpu_place(place_) ? "Cpu" : "Cuda";
+    // the inputs are bound in place of the tensors in the scope, and the
+    // outputs are allocated on the place by ORT, so nothing is copied
+    // through the host
     std::vector<Ort::Value> inputs;
     inputs.reserve(input_desc_.size());
-    for (auto desc : input_desc_) {
-      inputs.push_back(GetOrtValue(desc, device_name));
+    for (const auto &desc : input_desc_) {
+      inputs.push_back(GetOrtValue(desc));
       binding_->BindInput(desc.name.c_str(), inputs.back());
     }
-    for (auto output : output_desc_) {
-      Ort::MemoryInfo out_memory_info(device_name,
-                                      OrtDeviceAllocator,
-                                      place_.GetDeviceId(),
-                                      OrtMemTypeDefault);
-      binding_->BindOutput(output.name.c_str(), out_memory_info);
+    for (const auto &output : output_desc_) {
+      binding_->BindOutput(output.name.c_str(), memory_info_);
     }
     session_->Run({}, *(binding_.get()));
   } catch (const std::exception &e) {
@@ -361,6 +414,7 @@ bool ONNXRuntimePredictor::ZeroCopyRun(bool switch_stream) {
 std::unique_ptr<PaddlePredictor> ONNXRuntimePredictor::Clone(void *stream) {
   std::lock_guard<std::mutex> lk(clone_mutex_);
   auto *x = new ONNXRuntimePredictor(config_, env_, session_);
+  x->place_ = place_;
   x->InitBinding();
   return std::unique_ptr<PaddlePredictor>(x);
 }
@@ -116,7 +116,8 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   ~ONNXRuntimePredictor();
 
   ///
-  /// \brief Initialize ORT Binding
+  /// \brief Initialize ORT Binding, the inputs and outputs are bound on the
+  /// place of the predictor, so they stay on the device between runs.
   ///
   /// \return Whether the init function executed successfully
   ///
@@ -191,7 +192,9 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   ///
   uint64_t TryShrinkMemory() override;
   ///
-  /// \brief Clone to get the new predictor. thread safe.
+  /// \brief Clone to get the new predictor. thread safe. The clones share
+  /// the ORT session, and so the weights and the built engines of the
+  /// execution providers, with a binding of their own.
   ///
   /// \return get a new predictor
   ///
@@ -218,17 +221,24 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   ///
   /// \param[in] desc ONNXDesc(name、shape、dtype)
   ///
-  /// \param[in] device_name "cpu" or "gpu" of device
-  ///
   /// \return get a Ort::Value
   ///
-  Ort::Value GetOrtValue(const ONNXDesc &desc, const char *device_name);
+  Ort::Value GetOrtValue(const ONNXDesc &desc);
+
+  ///
+  /// \brief Append the execution providers of the config to the session
+  /// options, and decide the place of the predictor by them.
+  ///
+  /// \param[in] session_options the options of the session to create
+  ///
+  void AppendExecutionProviders(Ort::SessionOptions *session_options);
 
  private:
   // ONNXRuntime
   std::shared_ptr<Ort::Env> env_;
   std::shared_ptr<Ort::Session> session_{nullptr};
   std::shared_ptr<Ort::IoBinding> binding_;
+  Ort::MemoryInfo memory_info_{nullptr};
 
   AnalysisConfig config_;
   std::mutex clone_mutex_;
@@ -241,6 +251,7 @@ class ONNXRuntimePredictor : public PaddlePredictor {
 // the all the details can be tested.
 #if PADDLE_WITH_TESTING
   FRIEND_TEST(ONNXRuntimePredictor, onnxruntime_on);
+  FRIEND_TEST(ONNXRuntimePredictor, onnxruntime_clone);
 #endif
 };
 
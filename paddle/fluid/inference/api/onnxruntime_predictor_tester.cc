@@ -78,4 +78,41 @@ TEST(ONNXRuntimePredictor, onnxruntime_on) {
   predictor->TryShrinkMemory();
 }
 
+TEST(ONNXRuntimePredictor, onnxruntime_clone) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname + "/inference.pdmodel",
+                  FLAGS_dirname + "/inference.pdiparams");
+  config.EnableONNXRuntime();
+  config.EnableORTOptimization();
+
+  auto _predictor =
+      CreatePaddlePredictor<AnalysisConfig,
+                            paddle::PaddleEngineKind::kONNXRuntime>(config);
+  ASSERT_TRUE(_predictor);
+  auto _clone = _predictor->Clone();
+  ASSERT_TRUE(_clone);
+  auto* predictor = static_cast<ONNXRuntimePredictor*>(_predictor.get());
+  auto* clone = static_cast<ONNXRuntimePredictor*>(_clone.get());
+  // the clone shares the session with a binding of its own
+  ASSERT_EQ(predictor->session_.get(), clone->session_.get());
+  ASSERT_NE(predictor->binding_.get(), clone->binding_.get());
+
+  std::vector<float> input_data(1 * 3 * 224 * 224, 1.0);
+  std::vector<std::vector<float>> out_data(2, std::vector<float>(1000));
+  std::vector<ONNXRuntimePredictor*> predictors{predictor, clone};
+  for (size_t i = 0; i < predictors.size(); ++i) {
+    auto input_tensor =
+        predictors[i]->GetInputTensor(predictors[i]->GetInputNames()[0]);
+    input_tensor->Reshape({1, 3, 224, 224});
+    input_tensor->CopyFromCpu(input_data.data());
+    ASSERT_TRUE(predictors[i]->ZeroCopyRun());
+    auto output_tensor =
+        predictors[i]->GetOutputTensor(predictors[i]->GetOutputNames()[0]);
+    output_tensor->CopyToCpu(out_data[i].data());
+  }
+  for (size_t j = 0; j < out_data[0].size(); ++j) {
+    ASSERT_FLOAT_EQ(out_data[0][j], out_data[1][j]);
+  }
+}
+
 }  // namespace paddle
@@ -220,6 +220,16 @@ struct PD_INFER_DECL AnalysisConfig {
     kBf16,         ///< bf16
   };
 
+  ///
+  /// \brief The algorithms of the TensorRT INT8 calibration.
+  ///
+  enum class Int8CalibrationAlgorithm {
+    kEntropy2 = 0,  ///< entropy calibration 2, the default
+    kEntropy,       ///< entropy calibration
+    kMinMax,        ///< min max calibration
+    kPercentile,    ///< a percentile of the activations as the range
+  };
+
   ///
   /// \brief Set the no-combined model dir path.
   ///
@@ -461,6 +471,17 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void EnableORTOptimization();
   ///
+  /// \brief Run ONNXRuntime with its TensorRT execution provider, the
+  /// subgraphs it does not take fall back to the CUDA execution provider.
+  /// It takes effect only with EnableUseGpu.
+  ///
+  /// \param engine_cache_dir The directory to keep the built engines across
+  /// the runs of a process, default is the directory of the model.
+  /// \param use_fp16 Whether to build the engines in fp16.
+  ///
+  void EnableORTTensorRT(const std::string& engine_cache_dir = "",
+                         bool use_fp16 = false);
+  ///
   /// \brief A boolean state telling whether the GPU is turned on.
   ///
   /// \return bool Whether the GPU is turned on.
@@ -472,6 +493,60 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void Exp_EnableUseCutlass();
   ///
+  /// \brief Reuse the conv/matmul algorithms tuned in previous runs, so that
+  /// the exhaustive algorithm search is not repeated after restarts.
+  ///
+  /// \param autotune_cache_file the path of the autotune cache file.
+  /// \param writeback whether to write the tuned algorithms back to the file
+  /// when the predictor is destroyed.
+  ///
+  void SetAutoTuneCacheFile(const std::string& autotune_cache_file,
+                            bool writeback = false) {
+    autotune_cache_file_ = autotune_cache_file;
+    autotune_cache_writeback_ = writeback;
+  }
+  ///
+  /// \brief Get the path of the autotune cache file.
+  ///
+  /// \return const std::string& The path of the autotune cache file.
+  ///
+  const std::string& autotune_cache_file() const {
+    return autotune_cache_file_;
+  }
+  ///
+  /// \brief Share the gpu parameters with the predictors of other processes
+  /// on the same device through CUDA IPC, so that every extra replica only
+  /// needs the memory of its activations. The publisher writes the memory
+  /// handle of its parameters to `path` when it is initialized, the others
+  /// map the parameters found there in place of their own copies. All of
+  /// them must load the same model with the same config.
+  ///
+  /// The shared parameters are read-only by contract, and the publisher
+  /// must outlive the predictors mapping its parameters.
+  ///
+  /// \param path the file the parameters are published to.
+  /// \param publisher whether this predictor publishes its parameters.
+  ///
+  void EnableSharedWeights(const std::string& path, bool publisher) {
+    shared_weights_path_ = path;
+    shared_weights_publisher_ = publisher;
+  }
+  ///
+  /// \brief Get the file the gpu parameters are shared by.
+  ///
+  /// \return const std::string& The path, empty if they are not shared.
+  ///
+  const std::string& shared_weights_path() const {
+    return shared_weights_path_;
+  }
+  ///
+  /// \brief A boolean state telling whether this predictor publishes its
+  /// parameters.
+  ///
+  /// \return bool Whether this predictor publishes its parameters.
+  ///
+  bool shared_weights_publisher() const { return shared_weights_publisher_; }
+  ///
   ///
   /// \brief A boolean state telling whether the XPU is turned on.
   ///
@@ -502,6 +577,17 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool ort_optimization_enabled() const { return enable_ort_optimization_; }
   ///
+  /// \brief A boolean state telling whether the TensorRT execution provider
+  /// of ONNXRuntime is turned on.
+  ///
+  /// \return bool Whether the TensorRT execution provider is turned on.
+  ///
+  bool ort_tensorrt_enabled() const { return use_ort_tensorrt_; }
+  const std::string& ort_tensorrt_cache_dir() const {
+    return ort_tensorrt_cache_dir_;
+  }
+  bool ort_tensorrt_fp16_enabled() const { return ort_tensorrt_fp16_; }
+  ///
   /// \brief Get the GPU device id.
   ///
   /// \return int The GPU device id.
@@ -754,6 +840,46 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool external_stream_enabled() const;
 
+  ///
+  /// \brief Share the cuBLAS/cuDNN/cuSolver/cuSparse handles and the cuBLAS
+  /// workspaces among the predictors on the device, which otherwise create
+  /// them per stream. A predictor leases a set of them for each run and
+  /// binds it to its own stream, preferring the set it used last. It only
+  /// works for the predictors running on their own streams, see
+  /// SetExecStream.
+  ///
+  /// \param max_concurrent_runs The most sets created on a device, i.e. the
+  /// runs in flight at the same time, beyond which a run waits for a set.
+  ///
+  void EnableGpuResourceSharing(int max_concurrent_runs = 4);
+
+  ///
+  /// \brief The most sets of the shared gpu resources on a device, 0 if the
+  /// gpu resources are not shared.
+  ///
+  int gpu_resource_sharing_runs() const { return gpu_resource_sharing_runs_; }
+
+  ///
+  /// \brief Prune the float16 and bfloat16 weights of the matmuls to 2:4
+  /// structured sparsity, and run the matmuls on the sparse tensor cores of
+  /// Ampere and later GPUs through cuSPARSELt. It works with new IR, and
+  /// needs PaddlePaddle compiled with cuSPARSELt.
+  ///
+  /// \param max_pruned_ratio The accuracy check of a weight, which is kept
+  /// dense if the norm of its pruned elements exceeds max_pruned_ratio of
+  /// its norm.
+  ///
+  void EnableSparse24Weights(float max_pruned_ratio = 0.2f);
+
+  ///
+  /// \brief A boolean state telling whether the 2:4 sparse weights are used.
+  ///
+  bool sparse_2_4_weights_enabled() const { return use_sparse_2_4_weights_; }
+
+  float sparse_2_4_max_pruned_ratio() const {
+    return sparse_2_4_max_pruned_ratio_;
+  }
+
   ///
   /// \brief Collect shape info of all tensors in compute graph.
   ///
@@ -870,6 +996,82 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   int tensorrt_optimization_level() { return trt_optimization_level_; }
 
+  ///
+  /// \brief Set the number of threads building the TensorRT engines of the
+  /// subgraphs concurrently.
+  /// \param num_threads The number of threads, default 1.
+  ///
+  void SetTensorRtEngineBuildThreads(int num_threads);
+
+  ///
+  /// \brief An integer telling the number of threads building the TensorRT
+  /// engines.
+  ///
+  /// \return integer The number of threads building the TensorRT engines.
+  ///
+  int tensorrt_engine_build_threads() { return trt_engine_build_threads_; }
+
+  ///
+  /// \brief Share the timing cache among the TensorRT engines built, and
+  /// persist it in a file, which saves the time to build the engines of the
+  /// same layers later, e.g. in the next deployment. The API supports TRT
+  /// version >= 8.0, and takes no effect instead.
+  /// \param path The file of the timing cache.
+  ///
+  void EnableTensorRtTimingCache(const std::string& path);
+
+  ///
+  /// \brief A string telling the file of the TensorRT timing cache.
+  ///
+  /// \return string The file of the TensorRT timing cache, or empty if the
+  /// timing cache is not enabled.
+  ///
+  const std::string& tensorrt_timing_cache_path() const {
+    return trt_timing_cache_path_;
+  }
+
+  ///
+  /// \brief Derive the shape ranges of the given number of buckets from the
+  /// shapes collected in CollectShapeRangeInfo mode, which are saved with the
+  /// shape range info. The TensorRT engines built in tuned dynamic shape mode
+  /// then make an optimization profile for each bucket, and select the
+  /// tightest one containing the input shapes in each run. The API supports
+  /// TRT version >= 8.6, and takes no effect instead.
+  /// \param bucket_num The number of shape buckets, of which the last one is
+  /// the full shape range, default 1.
+  ///
+  void SetTensorRtShapeBucketNum(int bucket_num);
+
+  ///
+  /// \brief An integer telling the number of shape buckets derived from the
+  /// collected shapes.
+  ///
+  /// \return integer The number of shape buckets.
+  ///
+  int tensorrt_shape_bucket_num() const { return trt_shape_bucket_num_; }
+
+  ///
+  /// \brief Set how the TensorRT INT8 calibration table is generated.
+  /// \param algorithm The calibration algorithm, default kEntropy2.
+  /// \param percentile The percentile of the activations taken as the range
+  /// by kPercentile, in (0, 100].
+  /// \param batch_queue_size The max number of the calibration batches run by
+  /// Paddle ahead of the TensorRT calibration, default 1.
+  ///
+  void SetTensorRtInt8Calibration(Int8CalibrationAlgorithm algorithm,
+                                  double percentile = 99.99,
+                                  int batch_queue_size = 1);
+
+  Int8CalibrationAlgorithm tensorrt_int8_calibration_algorithm() const {
+    return trt_int8_calibration_algorithm_;
+  }
+  double tensorrt_int8_calibration_percentile() const {
+    return trt_int8_calibration_percentile_;
+  }
+  int tensorrt_calibration_batch_queue_size() const {
+    return trt_calibration_batch_queue_size_;
+  }
+
   /// \brief A boolean state telling whether to use new executor.
   ///
   /// \return bool whether to use new executor.
@@ -878,6 +1080,21 @@ struct PD_INFER_DECL AnalysisConfig {
 
   bool new_executor_enabled() const { return use_new_executor_; }
 
+  ///
+  /// \brief Run a small model on CPU with the least overhead per run. From
+  /// the second run on, the new executor calls the kernels of the program in
+  /// a flat list with their prepared contexts, skipping its per instruction
+  /// bookkeeping, and keeps the intermediate tensors between the runs. The
+  /// math library buffers are not freed after each run either. It takes
+  /// effect with the new executor on CPU, unless a debugging or profiling
+  /// feature is on.
+  ///
+  /// \param x whether to run in the low latency mode.
+  ///
+  void EnableLowLatencyRun(bool x = true) { use_low_latency_run_ = x; }
+
+  bool low_latency_run_enabled() const { return use_low_latency_run_; }
+
   /// \brief A boolean state telling whether to use new IR.
   ///
   /// \return bool whether to use new IR.
@@ -1000,6 +1217,23 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool mkldnn_fc_passes_disabled() const { return disable_mkldnn_fc_passes_; }
 
+  ///
+  /// \brief Share the weights of fc and conv2d reordered into the blocked
+  /// layouts of OneDNN, e.g. the AMX ones of bfloat16 and int8, across the
+  /// threads and the input shapes, so each of them is reordered once.
+  ///
+  void EnableMkldnnWeightsPrepacking();
+
+  ///
+  /// \brief A boolean state telling whether the OneDNN weights are
+  /// prepacked.
+  ///
+  /// \return bool Whether the OneDNN weights are prepacked.
+  ///
+  bool mkldnn_weights_prepacking_enabled() const {
+    return use_mkldnn_weights_prepacking_;
+  }
+
   ///
   /// \brief A boolean state telling whether to use the OneDNN Bfloat16.
   ///
@@ -1229,6 +1463,13 @@ struct PD_INFER_DECL AnalysisConfig {
   bool use_cudnn_{false};
   bool use_external_stream_{false};
   void* exec_stream_{nullptr};
+  int gpu_resource_sharing_runs_{0};
+  bool use_sparse_2_4_weights_{false};
+  float sparse_2_4_max_pruned_ratio_{0.2f};
+  std::string autotune_cache_file_;
+  bool autotune_cache_writeback_{false};
+  std::string shared_weights_path_;
+  bool shared_weights_publisher_{false};
 
   // CustomDevice related
   bool use_custom_device_{false};
@@ -1239,6 +1480,9 @@ struct PD_INFER_DECL AnalysisConfig {
   // ONNXRuntime related
   bool use_onnxruntime_{false};
   bool enable_ort_optimization_{false};
+  bool use_ort_tensorrt_{false};
+  bool ort_tensorrt_fp16_{false};
+  std::string ort_tensorrt_cache_dir_;
 
   // Padding related
   bool use_fc_padding_{true};
@@ -1289,6 +1533,13 @@ struct PD_INFER_DECL AnalysisConfig {
   bool trt_inspector_serialize_{false};
   bool trt_use_explicit_quantization_{false};
   int trt_optimization_level_{3};
+  int trt_engine_build_threads_{1};
+  std::string trt_timing_cache_path_;
+  int trt_shape_bucket_num_{1};
+  Int8CalibrationAlgorithm trt_int8_calibration_algorithm_{
+      Int8CalibrationAlgorithm::kEntropy2};
+  double trt_int8_calibration_percentile_{99.99};
+  int trt_calibration_batch_queue_size_{1};
 
   // In CollectShapeInfo mode, we will collect the shape information of
   // all intermediate tensors in the compute graph and calculate the
@@ -1319,6 +1570,8 @@ struct PD_INFER_DECL AnalysisConfig {
 
   bool use_new_executor_{false};
 
+  bool use_low_latency_run_{false};
+
   bool specify_input_name_{false};
 
   int cpu_math_library_num_threads_{1};
@@ -1350,6 +1603,7 @@ struct PD_INFER_DECL AnalysisConfig {
   std::unordered_set<std::string> quantize_enabled_op_types_{};
 
   bool disable_mkldnn_fc_passes_{false};
+  bool use_mkldnn_weights_prepacking_{false};
 
   // ipu related.
   bool use_ipu_{false};
@@ -298,6 +298,43 @@ class PD_INFER_DECL PaddlePredictor {
   /// \return Whether the run is successful
   virtual bool ZeroCopyRun(bool switch_stream = false) { return false; }
 
+  /// \brief Run the network with zero-copied inputs and outputs, without
+  /// waiting for the device to finish it.
+  /// Be inherited by AnalysisPredictor and only used in ZeroCopy scenarios.
+  /// \param callback Called on a worker thread once the run is finished on
+  /// the device, when the outputs may be read.
+  /// \return Whether the run is launched successfully
+  virtual bool ZeroCopyRunAsync(std::function<void()> callback) {
+    return false;
+  }
+
+  /// \brief Bind the output to an external buffer on the place of the
+  /// predictor, which the later runs write the output into.
+  /// Be inherited by AnalysisPredictor, Only used in ZeroCopy scenarios.
+  /// \param name The output tensor name.
+  /// \param data The buffer, or nullptr to unbind the output.
+  /// \param shape The shape of the output written into the buffer.
+  /// \param dtype The data type of the output.
+  /// \return Whether the output is bound.
+  virtual bool BindOutput(const std::string& name,
+                          void* data,
+                          const std::vector<int>& shape,
+                          paddle_infer::DataType dtype) {
+    return false;
+  }
+
+  /// \brief Write the weights of a LoRA adapter into a slot of the stacked
+  /// adapter parameters, which the predictor shares with its clones.
+  /// Be inherited by AnalysisPredictor.
+  /// \param slot The index of the adapter in the stacked parameters.
+  /// \param weights The float32 weights of the slot on the host, by the name
+  /// of the stacked parameter.
+  /// \return Whether the adapter is written.
+  virtual bool SetLoraAdapter(
+      int slot, const std::map<std::string, const float*>& weights) {
+    return false;
+  }
+
   ///
   /// \brief Clear the intermediate tensors of the predictor
   ///
@@ -22,6 +22,7 @@ limitations under the License. */
 #pragma once
 
 #include <cassert>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -129,6 +130,18 @@ class PD_INFER_DECL Predictor {
   ///
   bool Run();
 
+  ///
+  /// \brief Run the prediction engine without blocking the calling thread
+  /// until the device finishes, so one thread can drive many in-flight runs,
+  /// e.g. of the clones of a predictor. The outputs are overwritten by the
+  /// next run of the same predictor.
+  ///
+  /// \param[in] callback called on a worker thread once the run is finished
+  /// on the device, when the outputs may be read
+  /// \return Whether the run is launched successfully
+  ///
+  bool RunAsync(std::function<void()> callback);
+
   ///
   /// \brief Run the prediction engine (Recommended)
   ///
@@ -169,6 +182,38 @@ class PD_INFER_DECL Predictor {
   ///
   std::map<std::string, DataType> GetOutputTypes();
 
+  ///
+  /// \brief Bind the output to an external buffer on the device of the
+  /// predictor, e.g. the input buffer of a postprocess kernel. The later runs
+  /// write the output into the buffer, and the output handle reads from it.
+  ///
+  /// \param[in] name output name
+  /// \param[in] data the buffer, or nullptr to unbind the output
+  /// \param[in] shape the shape of the output written into the buffer
+  /// \param[in] dtype the data type of the output
+  /// \return Whether the output is bound
+  ///
+  bool BindOutput(const std::string& name,
+                  void* data,
+                  const std::vector<int>& shape,
+                  DataType dtype);
+
+  ///
+  /// \brief Write the weights of a LoRA adapter into a slot of the stacked
+  /// adapter parameters of the model, i.e. the lora_a and lora_b of its
+  /// fused_multi_lora_linear ops. The base weights are loaded once, and the
+  /// clones of the predictor see the adapter too, while every request picks
+  /// its adapters by the adapter_ids it feeds. A slot should not be written
+  /// while a run is using it.
+  ///
+  /// \param[in] slot the index of the adapter in the stacked parameters
+  /// \param[in] weights the float32 weights of the slot on the host, of the
+  /// shape of the parameter without its first dim, by the parameter name
+  /// \return Whether the adapter is written
+  ///
+  bool SetLoraAdapter(int slot,
+                      const std::map<std::string, const float*>& weights);
+
   ///
   /// \brief Clone to get the new predictor. thread safe.
   ///
@@ -273,6 +318,189 @@ class PD_INFER_DECL PredictorPool {
   std::shared_ptr<Predictor> main_pred_;
   std::vector<std::unique_ptr<Predictor>> preds_;
 };
+
+///
+/// \brief Options of DynamicBatcher.
+///
+struct PD_INFER_DECL DynamicBatchOptions {
+  /// The max sum of the leading dims of the requests coalesced into one run.
+  int max_batch_size{8};
+  /// How long the first request of a batch waits for more requests, in
+  /// microseconds.
+  int max_queue_delay_us{1000};
+};
+
+///
+/// \brief Queueing and batching statistics of DynamicBatcher.
+///
+struct PD_INFER_DECL DynamicBatchStats {
+  uint64_t num_requests{0};
+  uint64_t num_batches{0};
+  /// Time between a request being queued and its batch being launched.
+  double avg_queue_latency_us{0.};
+  double max_queue_latency_us{0.};
+};
+
+///
+/// \class DynamicBatcher
+///
+/// \brief DynamicBatcher is a server side front end of one Predictor. Run
+/// may be called from many threads, concurrent requests whose inputs have the
+/// same names, dtypes and trailing dims are concatenated along dim 0 within
+/// the configured time window, run by one ZeroCopyRun, and the outputs are
+/// split back along dim 0. Inputs with lod are not batched.
+///
+class PD_INFER_DECL DynamicBatcher {
+ public:
+  DynamicBatcher() = delete;
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+  /// \brief Serve requests with \param predictor, which is owned by the
+  /// batcher and must not be used elsewhere.
+  DynamicBatcher(std::unique_ptr<Predictor> predictor,
+                 const DynamicBatchOptions& options = DynamicBatchOptions());
+  ~DynamicBatcher();
+
+  /// \brief Blocks until the request is served. Inputs and outputs are host
+  /// (cpu) tensors. An exception thrown by the run of the batch is rethrown
+  /// to every request of the batch not served yet.
+  bool Run(const std::vector<paddle::PaddleTensor>& inputs,
+           std::vector<paddle::PaddleTensor>* outputs);
+
+  DynamicBatchStats GetStats() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+///
+/// \brief Options of GenerationScheduler. The names are the inputs and the
+/// output of the model the scheduler drives, see GenerationScheduler.
+///
+struct PD_INFER_DECL GenerationOptions {
+  /// The number of blocks of the paged kv caches of the model.
+  int num_blocks{1024};
+  /// The number of tokens a block of the kv caches holds.
+  int block_size{64};
+  /// The dim 1 of block_tables, which bounds the length of a sequence to
+  /// max_blocks_per_seq * block_size tokens.
+  int max_blocks_per_seq{128};
+  /// The max number of sequences in the batch of a step.
+  int max_num_seqs{64};
+  /// The max number of prompt tokens prefilled by a step. A prompt longer
+  /// than it is still admitted, alone, when nothing else is prefilled.
+  int max_prefill_tokens{4096};
+  /// The generation of a sequence stops once the token is generated.
+  int64_t end_token_id{-1};
+  /// The number of the tokens the draft model proposes for each sequence
+  /// per step, used only with a draft predictor.
+  int num_speculative_tokens{4};
+
+  std::string input_ids_name{"input_ids"};
+  std::string seq_lens_this_time_name{"seq_lens_this_time"};
+  std::string seq_lens_encoder_name{"seq_lens_encoder"};
+  std::string seq_lens_decoder_name{"seq_lens_decoder"};
+  std::string block_tables_name{"block_tables"};
+  std::string next_tokens_name{"next_tokens"};
+};
+
+///
+/// \brief Statistics of GenerationScheduler.
+///
+struct PD_INFER_DECL GenerationStats {
+  uint64_t num_requests{0};
+  uint64_t num_steps{0};
+  uint64_t num_prefill_tokens{0};
+  uint64_t num_decode_tokens{0};
+  /// Sequences whose kv blocks were taken back to let the older sequences
+  /// go on. They are prefilled again with their generated tokens later.
+  uint64_t num_preemptions{0};
+  /// The tokens proposed by the draft model and those the target model
+  /// accepted.
+  uint64_t num_draft_tokens{0};
+  uint64_t num_accepted_tokens{0};
+  /// The kv blocks not held by any sequence now.
+  uint64_t num_free_blocks{0};
+};
+
+///
+/// \class GenerationScheduler
+///
+/// \brief GenerationScheduler is a continuous batching front end of one
+/// Predictor running a decoder built on block_multihead_attention. Between
+/// two steps it drops the finished sequences and admits the waiting prompts
+/// whose kv blocks fit in the free blocks, so the prefill of new sequences
+/// runs in the same batch as the decode of the running ones.
+///
+/// The model of a step takes the rows of the sequences in the batch:
+///   input_ids: int64 [num_seqs, max_len], the tokens of each row not in the
+///     kv caches yet, padded with 0. They are the prompt of a prefill row
+///     and the last token of a decode row.
+///   seq_lens_this_time: int32 [num_seqs], the number of the tokens above
+///   seq_lens_encoder: int32 [num_seqs, 1], the same as seq_lens_this_time
+///     of a prefill row or a row of more than one token, 0 of a decode row
+///   seq_lens_decoder: int32 [num_seqs, 1], the number of the tokens already
+///     in the kv caches
+///   block_tables: int32 [num_seqs, max_blocks_per_seq], the kv blocks of the
+///     sequences, padded with -1
+/// and returns next_tokens: int64 [num_seqs] or [num_seqs, 1], the token
+/// generated after the last token of each row, or [num_seqs, max_len], the
+/// token generated after each token. The kv caches stay in the predictor
+/// across steps and are not touched by the scheduler. A step that fails or
+/// throws ends the requests of its batch with the token -1 and frees their
+/// kv blocks.
+///
+/// With a draft predictor, a step decodes speculatively. The draft model,
+/// which takes the same inputs and the same block tables with its own kv
+/// caches, proposes num_speculative_tokens tokens for each decode row one by
+/// one. The target model then verifies them in one forward over rows of the
+/// last token followed by the drafts, which attend causally to each other,
+/// and returns next_tokens of [num_seqs, max_len]. The longest prefix of the
+/// drafts the target model agrees with is accepted, followed by the target
+/// token after it. The kv cache entries of the rejected drafts are rolled
+/// back and their blocks are freed.
+///
+class PD_INFER_DECL GenerationScheduler {
+ public:
+  /// \brief Receives the generated tokens of a request one by one, with
+  /// finished true for the last one. It is called by the worker thread.
+  using TokenCallback = std::function<void(int64_t token, bool finished)>;
+
+  GenerationScheduler() = delete;
+  GenerationScheduler(const GenerationScheduler&) = delete;
+  GenerationScheduler& operator=(const GenerationScheduler&) = delete;
+
+  /// \brief Serve requests with \param predictor, which is owned by the
+  /// scheduler and must not be used elsewhere.
+  GenerationScheduler(std::unique_ptr<Predictor> predictor,
+                      const GenerationOptions& options = GenerationOptions());
+  /// \brief Serve requests with \param predictor, whose tokens are drafted by
+  /// \param draft_predictor. Both are owned by the scheduler.
+  GenerationScheduler(std::unique_ptr<Predictor> predictor,
+                      std::unique_ptr<Predictor> draft_predictor,
+                      const GenerationOptions& options = GenerationOptions());
+  /// \brief The requests not finished yet receive no more tokens.
+  ~GenerationScheduler();
+
+  /// \brief Queues a request generating at most \param max_new_tokens tokens
+  /// after \param prompt, which are streamed to \param callback. Returns the
+  /// id of the request.
+  uint64_t AddRequest(const std::vector<int64_t>& prompt,
+                      int max_new_tokens,
+                      TokenCallback callback);
+
+  /// \brief Stops a request, which receives no more tokens. Returns false if
+  /// the request has already finished.
+  bool Cancel(uint64_t request_id);
+
+  GenerationStats GetStats() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
 }  // namespace services
 
 }  // namespace paddle_infer
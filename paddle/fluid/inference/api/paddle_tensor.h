@@ -26,6 +26,8 @@
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #endif
 
+struct DLManagedTensor;
+
 namespace paddle {
 class Tensor;
 }
@@ -129,6 +131,19 @@ class PD_INFER_DECL Tensor {
                          PlaceType place,
                          DataLayout layout = DataLayout::kNCHW);
 
+  /// \brief Share the data of a DLPack tensor with tensor data, without copy.
+  /// The tensor takes the ownership of dl_tensor, whose deleter is called once
+  /// the data is no longer used by the tensor.
+  /// \param dl_tensor The DLPack tensor in the compact row major layout.
+  void ShareExternalData(DLManagedTensor* dl_tensor);
+
+  /// \brief Export the tensor data as a DLPack tensor, without copy.
+  /// It's usually used to hand the output tensor data to other frameworks.
+  /// The data is kept alive until the deleter of the DLPack tensor is called,
+  /// but a later run may write the output into it again.
+  /// \return The DLPack tensor, owned by the caller.
+  DLManagedTensor* ToDLPack() const;
+
   /// \brief Experimental interface.
   /// It's usually used to set the input tensor data with Strings data type.
   /// \param data The pointer of the data, from which the tensor will copy.
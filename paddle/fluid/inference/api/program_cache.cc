@@ -0,0 +1,149 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/program_cache.h"
+
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_int32(inference_program_cache_capacity);
+
+namespace paddle {
+namespace inference {
+
+namespace {
+
+class ProgramDescCache {
+ public:
+  static ProgramDescCache& Instance() {
+    static ProgramDescCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const framework::ProgramDesc> Get(
+      size_t hash, const std::string& pb_content) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->hash == hash && it->pb_content == pb_content) {
+        entries_.splice(entries_.begin(), entries_, it);
+        ++hits_;
+        return it->program;
+      }
+    }
+    return nullptr;
+  }
+
+  void Put(size_t hash,
+           const std::string& pb_content,
+           std::shared_ptr<const framework::ProgramDesc> program) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    entries_.push_front({hash, pb_content, std::move(program)});
+    while (static_cast<int>(entries_.size()) >
+           FLAGS_inference_program_cache_capacity) {
+      entries_.pop_back();
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    entries_.clear();
+    hits_ = 0;
+  }
+
+  int64_t hits() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return hits_;
+  }
+
+ private:
+  struct Entry {
+    size_t hash;
+    std::string pb_content;
+    std::shared_ptr<const framework::ProgramDesc> program;
+  };
+
+  std::mutex mutex_;
+  // the most recently used first
+  std::list<Entry> entries_;
+  int64_t hits_{0};
+};
+
+std::string ReadFile(const std::string& filename) {
+  std::ifstream fin(filename, std::ios::in | std::ios::binary);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fin.is_open()),
+      true,
+      common::errors::NotFound(
+          "Cannot open file %s, please confirm whether the file is normal.",
+          filename));
+  std::string pb_content;
+  fin.seekg(0, std::ios::end);
+  pb_content.resize(fin.tellg());
+  fin.seekg(0, std::ios::beg);
+  fin.read(&(pb_content.at(0)), pb_content.size());  // NOLINT
+  fin.close();
+  return pb_content;
+}
+
+std::unique_ptr<framework::ProgramDesc> ParseProgramDesc(
+    const std::string& pb_content, bool* parsed) {
+  framework::proto::ProgramDesc proto;
+  *parsed = proto.ParseFromString(pb_content);
+  return std::make_unique<framework::ProgramDesc>(proto);
+}
+
+}  // namespace
+
+std::unique_ptr<framework::ProgramDesc> LoadCachedProgramDesc(
+    const std::string& filename, bool from_memory) {
+  bool parsed = false;
+  const std::string pb_content = from_memory ? filename : ReadFile(filename);
+  if (FLAGS_inference_program_cache_capacity <= 0) {
+    return ParseProgramDesc(pb_content, &parsed);
+  }
+
+  // The programs are keyed by the hash of the serialized program and the
+  // bytes are only compared on a hash hit. A file rewritten in place gets a
+  // new key however quickly it is rewritten.
+  const size_t hash = std::hash<std::string>()(pb_content);
+  auto& cache = ProgramDescCache::Instance();
+  auto cached = cache.Get(hash, pb_content);
+  if (cached) {
+    VLOG(3) << "Reuse the cached program of "
+            << (from_memory ? "the model in memory" : filename);
+    return std::make_unique<framework::ProgramDesc>(*cached);
+  }
+
+  auto program = ParseProgramDesc(pb_content, &parsed);
+  if (parsed) {
+    cache.Put(hash,
+              pb_content,
+              std::make_shared<const framework::ProgramDesc>(*program));
+  }
+  return program;
+}
+
+void ClearProgramDescCache() { ProgramDescCache::Instance().Clear(); }
+
+int64_t ProgramDescCacheHits() { return ProgramDescCache::Instance().hits(); }
+
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,43 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "paddle/fluid/framework/program_desc.h"
+
+namespace paddle {
+namespace inference {
+
+// Loads the program of the model file `filename`, or of the serialized
+// program `filename` itself if `from_memory`. Up to
+// FLAGS_inference_program_cache_capacity parsed programs are kept, keyed by
+// the serialized program, so the predictors created for the same model parse
+// it only once.
+// The cached programs are never modified, each call returns a copy of its
+// own, which is cheaper than parsing as the attributes are already decoded.
+std::unique_ptr<framework::ProgramDesc> LoadCachedProgramDesc(
+    const std::string& filename, bool from_memory);
+
+// Drops all the cached programs and resets the hit count.
+void ClearProgramDescCache();
+
+// The number of loads served from the cache since it was last cleared.
+int64_t ProgramDescCacheHits();
+
+}  // namespace inference
+}  // namespace paddle
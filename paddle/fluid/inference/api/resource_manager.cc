@@ -14,7 +14,9 @@
 
 #include "paddle/fluid/inference/api/resource_manager.h"
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -30,6 +32,7 @@
 #include "paddle/phi/core/allocator.h"
 #include "paddle/phi/core/generator.h"
 #include "paddle/phi/core/memory/allocation/allocator_facade.h"
+#include "paddle/phi/core/memory/malloc.h"
 #include "unsupported/Eigen/CXX11/Tensor"
 
 #include "paddle/fluid/platform/enforce.h"
@@ -40,6 +43,11 @@
 #include "paddle/phi/backends/dynload/cusolver.h"
 #include "paddle/phi/backends/dynload/cusparse.h"
 #endif  // PADDLE_WITH_CUDA
+#ifdef PADDLE_WITH_HIP
+#include "paddle/phi/backends/dynload/miopen.h"
+#include "paddle/phi/backends/dynload/rocblas.h"
+#include "paddle/phi/backends/dynload/rocsparse.h"
+#endif  // PADDLE_WITH_HIP
 
 namespace paddle {
 namespace internal {
@@ -469,5 +477,156 @@ int ResourceManager::RefCount(void* stream) const {
   if (ref_count_.count(stream) == 0) return 0;
   return ref_count_.at(stream);
 }
+
+std::unique_ptr<SharedGPUResource> ResourceManager::CreateSharedGPUResource(
+    const phi::Place& place) {
+  auto resource = std::make_unique<SharedGPUResource>();
+  resource->device_id = place.GetDeviceId();
+  phi::backends::gpu::GPUDeviceGuard guard(resource->device_id);
+  // the handles are bound to the stream of the first lease
+  phi::InitBlasHandle(&resource->blas_handle, nullptr);
+  phi::InitBlasHandle(&resource->blas_tensor_core_handle, nullptr);
+  phi::InitBlasHandle(&resource->blas_tf32_tensor_core_handle, nullptr);
+#ifdef PADDLE_WITH_CUDA
+#if CUDA_VERSION >= 9000
+  PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
+      resource->blas_tensor_core_handle, CUBLAS_TENSOR_OP_MATH));
+#endif
+#if CUDA_VERSION >= 11000
+  PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
+      resource->blas_tf32_tensor_core_handle, CUBLAS_TF32_TENSOR_OP_MATH));
+#endif
+#if CUDA_VERSION >= 11040
+  // the workspace cuBLAS recommends for Hopper, and for the others
+  const size_t workspace_size =
+      phi::backends::gpu::GetGPUComputeCapability(resource->device_id) >= 90
+          ? 32 << 20
+          : 4 << 20;
+  resource->blas_workspace = memory::Alloc(place, workspace_size);
+#endif
+#endif
+  phi::InitBlasLtHandle(&resource->blaslt_handle);
+  phi::InitDnnHandle(&resource->dnn_handle, nullptr, place);
+  phi::InitSolverHandle(&resource->solver_handle, nullptr);
+  phi::InitSparseHandle(&resource->sparse_handle, nullptr);
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventCreateWithFlags(
+      &resource->released, phi::gpuEventDisableTiming));
+  VLOG(3) << "Create the shared gpu resource "
+          << shared_resources_[resource->device_id].size() << " on device "
+          << resource->device_id;
+  return resource;
+}
+
+void ResourceManager::BindSharedGPUResource(SharedGPUResource* resource,
+                                            gpuStream_t stream) {
+#ifdef PADDLE_WITH_HIP
+  for (auto handle : {resource->blas_handle,
+                      resource->blas_tensor_core_handle,
+                      resource->blas_tf32_tensor_core_handle}) {
+    if (handle != nullptr) {
+      phi::dynload::rocblas_set_stream(handle, stream);
+    }
+  }
+  if (resource->dnn_handle != nullptr) {
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::miopenSetStream(resource->dnn_handle, stream));
+  }
+  if (resource->sparse_handle != nullptr) {
+    phi::dynload::rocsparse_set_stream(resource->sparse_handle, stream);
+  }
+#else
+  for (auto handle : {resource->blas_handle,
+                      resource->blas_tensor_core_handle,
+                      resource->blas_tf32_tensor_core_handle}) {
+    if (handle == nullptr) {
+      continue;
+    }
+    // setting the stream resets the workspace to the default one of cuBLAS
+    PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetStream(handle, stream));
+#if CUDA_VERSION >= 11040
+    PADDLE_RETRY_CUDA_SUCCESS(
+        phi::dynload::cublasSetWorkspace_v2(handle,
+                                            resource->blas_workspace->ptr(),
+                                            resource->blas_workspace->size()));
+#endif
+  }
+  if (resource->dnn_handle != nullptr) {
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::cudnnSetStream(resource->dnn_handle, stream));
+  }
+  if (resource->solver_handle != nullptr) {
+    PADDLE_RETRY_CUDA_SUCCESS(
+        phi::dynload::cusolverDnSetStream(resource->solver_handle, stream));
+  }
+#if CUDA_VERSION >= 11000
+  if (resource->sparse_handle != nullptr) {
+    PADDLE_RETRY_CUDA_SUCCESS(
+        phi::dynload::cusparseSetStream(resource->sparse_handle, stream));
+  }
+#endif
+#endif
+  resource->stream = stream;
+}
+
+SharedGPUResource* ResourceManager::AcquireSharedGPUResource(
+    const phi::Place& place, void* stream, int max_num) {
+  PADDLE_ENFORCE_GT(max_num,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The number of the shared gpu resources should be "
+                        "greater than 0, but got %d.",
+                        max_num));
+  auto s = reinterpret_cast<gpuStream_t>(stream);
+  const int device_id = place.GetDeviceId();
+  SharedGPUResource* resource = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(shared_mutex_);
+    auto& resources = shared_resources_[device_id];
+    auto& idle = idle_shared_resources_[device_id];
+    shared_cv_.wait(lock, [&] {
+      return !idle.empty() || static_cast<int>(resources.size()) < max_num;
+    });
+    if (!idle.empty()) {
+      // keep the affinity to the stream, or take the last released one
+      auto it = std::find_if(idle.begin(), idle.end(), [&](auto* r) {
+        return r->stream == s;
+      });
+      if (it == idle.end()) {
+        it = std::prev(idle.end());
+      }
+      resource = *it;
+      idle.erase(it);
+    } else {
+      resources.emplace_back(CreateSharedGPUResource(place));
+      resource = resources.back().get();
+    }
+  }
+
+  if (resource->stream != s) {
+    phi::backends::gpu::GPUDeviceGuard guard(device_id);
+    if (resource->stream != nullptr) {
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(s, resource->released, 0));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(s, resource->released, 0));
+#endif
+    }
+    BindSharedGPUResource(resource, s);
+  }
+  return resource;
+}
+
+void ResourceManager::ReleaseSharedGPUResource(SharedGPUResource* resource) {
+  {
+    phi::backends::gpu::GPUDeviceGuard guard(resource->device_id);
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::gpuEventRecord(resource->released, resource->stream));
+  }
+  {
+    std::lock_guard<std::mutex> lock(shared_mutex_);
+    idle_shared_resources_[resource->device_id].push_back(resource);
+  }
+  shared_cv_.notify_one();
+}
 #endif
 }  // namespace paddle
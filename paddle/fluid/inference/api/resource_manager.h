@@ -14,10 +14,12 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/api/include/tensor.h"
@@ -31,6 +33,7 @@
 #include "paddle/phi/backends/gpu/forwards.h"
 #include "paddle/phi/backends/gpu/gpu_decls.h"
 #include "paddle/phi/backends/gpu/gpu_resources.h"
+#include "paddle/phi/core/allocator.h"
 #endif
 
 namespace paddle {
@@ -123,6 +126,27 @@ class GPUContextResource {
   phi::sparseHandle_t sparse_handle_{nullptr};
   // DnnWorkspaceHandle
 };
+
+// The library handles and the cuBLAS workspace shared by the predictors on a
+// device. A predictor leases one for a run and binds it to its own stream,
+// so the number of them is bounded by the concurrent runs instead of the
+// predictors.
+struct SharedGPUResource {
+  int device_id{0};
+  blasHandle_t blas_handle{nullptr};
+  blasHandle_t blas_tensor_core_handle{nullptr};
+  blasHandle_t blas_tf32_tensor_core_handle{nullptr};
+  blasLtHandle_t blaslt_handle{nullptr};
+  dnnHandle_t dnn_handle{nullptr};
+  phi::solverHandle_t solver_handle{nullptr};
+  phi::sparseHandle_t sparse_handle{nullptr};
+  // shared by the blas handles, which run in order on the bound stream
+  phi::Allocator::AllocationPtr blas_workspace{nullptr};
+  // the stream the handles are bound to, nullptr if never bound
+  gpuStream_t stream{nullptr};
+  // recorded on the bound stream when the resource is released
+  gpuEvent_t released{nullptr};
+};
 #endif
 
 class ResourceManager {
@@ -148,9 +172,22 @@ class ResourceManager {
   TEST_API int RefCount(void* stream) const;
   void GpuResourceSwitchStream(void* old_stream, void* new_stream);
 
+  // Lease a shared resource for a run on the stream, preferring the one last
+  // bound to it. At most max_num of them are created on a device, beyond
+  // which the lease waits for a release. The stream waits for the last run
+  // on another stream using the resource.
+  TEST_API SharedGPUResource* AcquireSharedGPUResource(const phi::Place& place,
+                                                       void* stream,
+                                                       int max_num);
+  // Give back the resource once the run is enqueued on its stream.
+  TEST_API void ReleaseSharedGPUResource(SharedGPUResource* resource);
+
  private:
   void Decrease(void* stream);
   void Increase(void* stream);
+  std::unique_ptr<SharedGPUResource> CreateSharedGPUResource(
+      const phi::Place& place);
+  void BindSharedGPUResource(SharedGPUResource* resource, gpuStream_t stream);
 
  private:
   std::mutex gpu_mutex_;
@@ -158,6 +195,13 @@ class ResourceManager {
   std::map<void* /*stream*/, std::atomic<int>> ref_count_;
   std::map<void* /*stream*/, std::unique_ptr<GPUContextResource>>
       gpu_resources_;
+
+  std::mutex shared_mutex_;
+  std::condition_variable shared_cv_;
+  std::map<int /*device*/, std::vector<std::unique_ptr<SharedGPUResource>>>
+      shared_resources_;
+  std::map<int /*device*/, std::vector<SharedGPUResource*>>
+      idle_shared_resources_;
 #endif
 
  private:
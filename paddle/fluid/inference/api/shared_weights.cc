@@ -0,0 +1,344 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/shared_weights.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/allocation/cuda_ipc_allocator.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
+#endif
+
+namespace paddle {
+namespace inference {
+
+#if !defined(_WIN32)
+
+namespace {
+
+constexpr char kSharedWeightsMagic[] = "paddle_shared_weights";
+constexpr int kSharedWeightsVersion = 1;
+
+std::string ToHex(const std::string& bytes) {
+  std::ostringstream os;
+  os << std::hex << std::setfill('0');
+  for (unsigned char c : bytes) {
+    os << std::setw(2) << static_cast<int>(c);
+  }
+  return os.str();
+}
+
+std::string FromHex(const std::string& hex) {
+  std::string bytes;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+    bytes.push_back(
+        static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+}  // namespace
+
+void WriteSharedWeightsLayout(const SharedWeightsLayout& layout,
+                              const std::string& path) {
+  // written aside and renamed, the readers never see a partial file
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream os(tmp_path);
+    PADDLE_ENFORCE_EQ(os.is_open(),
+                      true,
+                      common::errors::Unavailable(
+                          "Failed to open %s to publish the shared weights.",
+                          tmp_path));
+    os << kSharedWeightsMagic << " " << kSharedWeightsVersion << "\n";
+    os << layout.device_id << " " << layout.total_size << " "
+       << ToHex(layout.handle) << "\n";
+    for (const auto& shared : layout.tensors) {
+      os << shared.name << " " << shared.offset << " " << shared.size << " "
+         << shared.dtype << " " << shared.dims.size();
+      for (auto dim : shared.dims) {
+        os << " " << dim;
+      }
+      os << "\n";
+    }
+  }
+  PADDLE_ENFORCE_EQ(
+      std::rename(tmp_path.c_str(), path.c_str()),
+      0,
+      common::errors::Unavailable("Failed to publish the shared weights to %s.",
+                                  path));
+}
+
+bool ReadSharedWeightsLayout(const std::string& path,
+                             SharedWeightsLayout* layout) {
+  std::ifstream is(path);
+  if (!is.is_open()) {
+    return false;
+  }
+  std::string magic;
+  int version = 0;
+  is >> magic >> version;
+  PADDLE_ENFORCE_EQ(
+      magic == kSharedWeightsMagic && version == kSharedWeightsVersion,
+      true,
+      common::errors::InvalidArgument(
+          "%s is not a shared weights file of version %d.",
+          path,
+          kSharedWeightsVersion));
+  std::string handle;
+  is >> layout->device_id >> layout->total_size >> handle;
+  layout->handle = FromHex(handle);
+  layout->tensors.clear();
+  SharedWeightsLayout::Tensor shared;
+  size_t rank = 0;
+  while (is >> shared.name >> shared.offset >> shared.size >> shared.dtype >>
+         rank) {
+    shared.dims.resize(rank);
+    for (auto& dim : shared.dims) {
+      is >> dim;
+    }
+    PADDLE_ENFORCE_LE(shared.offset + shared.size,
+                      layout->total_size,
+                      common::errors::InvalidArgument(
+                          "The tensor %s in %s is out of the published buffer.",
+                          shared.name,
+                          path));
+    layout->tensors.push_back(shared);
+  }
+  return true;
+}
+
+#endif
+
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+
+namespace {
+
+// the alignment of the tensors in the published buffer
+constexpr size_t kSharedWeightsAlignment = 256;
+
+using SharedTensor = SharedWeightsLayout::Tensor;
+
+size_t TensorSize(const phi::DenseTensor& tensor) {
+  return tensor.numel() * phi::SizeOf(tensor.dtype());
+}
+
+// Calls `fn(name, tensor)` for every tensor that may be shared, the first
+// scope wins if several scopes hold a tensor of the same name.
+template <typename Fn>
+void ForEachSharableTensor(const std::vector<framework::Scope*>& scopes,
+                           const phi::GPUPlace& place,
+                           Fn&& fn) {
+  std::unordered_set<std::string> visited;
+  for (auto* scope : scopes) {
+    if (scope == nullptr) {
+      continue;
+    }
+    for (const auto& name : scope->LocalVarNames()) {
+      auto* var = scope->FindLocalVar(name);
+      if (var == nullptr || !var->IsType<phi::DenseTensor>() ||
+          !visited.insert(name).second) {
+        continue;
+      }
+      auto* tensor = var->GetMutable<phi::DenseTensor>();
+      // views and empty tensors are left alone
+      if (!tensor->IsInitialized() || tensor->numel() == 0 ||
+          tensor->place() != phi::Place(place) ||
+          !tensor->meta().is_contiguous() || tensor->meta().offset != 0) {
+        continue;
+      }
+      fn(name, tensor);
+    }
+  }
+}
+
+}  // namespace
+
+size_t PublishSharedWeights(const std::vector<framework::Scope*>& scopes,
+                            const phi::GPUPlace& place,
+                            const std::string& path) {
+  SharedWeightsLayout layout;
+  std::vector<phi::DenseTensor*> tensors;
+  size_t total_size = 0;
+  ForEachSharableTensor(
+      scopes, place, [&](const std::string& name, phi::DenseTensor* tensor) {
+        SharedTensor shared{name,
+                            total_size,
+                            TensorSize(*tensor),
+                            static_cast<int>(tensor->dtype()),
+                            common::vectorize(tensor->dims())};
+        total_size = memory::allocation::AlignedSize(
+            total_size + shared.size, kSharedWeightsAlignment);
+        tensors.push_back(tensor);
+        layout.tensors.push_back(std::move(shared));
+      });
+  if (tensors.empty()) {
+    LOG(WARNING) << "No parameters on " << place << " to share.";
+    return 0;
+  }
+
+  // A dedicated buffer, the handle of one from the allocator would expose
+  // whatever else is placed in the same chunk.
+  int device_id = place.GetDeviceId();
+  platform::CUDADeviceGuard guard(device_id);
+  void* base_ptr = nullptr;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      platform::RecordedGpuMalloc(&base_ptr, total_size, device_id));
+  std::shared_ptr<void> buffer(base_ptr, [total_size, device_id](void* ptr) {
+    platform::RecordedGpuFree(ptr, total_size, device_id);
+  });
+
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      phi::DeviceContextPool::Instance().Get(place));
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto& shared = layout.tensors[i];
+    void* dst = static_cast<char*>(base_ptr) + shared.offset;
+    memory::Copy(place,
+                 dst,
+                 place,
+                 tensors[i]->data(),
+                 shared.size,
+                 dev_ctx->stream());
+  }
+  dev_ctx->Wait();
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto& shared = layout.tensors[i];
+    void* ptr = static_cast<char*>(base_ptr) + shared.offset;
+    tensors[i]->ResetHolder(
+        std::make_shared<memory::allocation::CudaIpcAllocation>(
+            ptr, shared.size, device_id, buffer));
+  }
+  memory::Release(place);
+
+  cudaIpcMemHandle_t handle;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaIpcGetMemHandle(&handle, base_ptr));
+  layout.device_id = device_id;
+  layout.total_size = total_size;
+  layout.handle =
+      std::string(reinterpret_cast<const char*>(&handle), sizeof(handle));
+  WriteSharedWeightsLayout(layout, path);
+  LOG(INFO) << "Published " << tensors.size() << " parameters of "
+            << total_size << " bytes on " << place << " to " << path;
+  return tensors.size();
+}
+
+size_t MapSharedWeights(const std::vector<framework::Scope*>& scopes,
+                        const phi::GPUPlace& place,
+                        const std::string& path) {
+  SharedWeightsLayout layout;
+  if (!ReadSharedWeightsLayout(path, &layout)) {
+    LOG(WARNING) << "No shared weights are published to " << path
+                 << ", the parameters are not shared.";
+    return 0;
+  }
+  PADDLE_ENFORCE_EQ(layout.handle.size(),
+                    sizeof(cudaIpcMemHandle_t),
+                    common::errors::InvalidArgument(
+                        "The memory handle in %s is corrupted.", path));
+  if (layout.device_id != place.GetDeviceId()) {
+    LOG(WARNING) << "The weights in " << path << " are published on gpu "
+                 << layout.device_id << ", but the predictor runs on "
+                 << place << ", make sure both see the same devices.";
+  }
+
+  std::unordered_map<std::string, SharedTensor> published;
+  for (const auto& shared : layout.tensors) {
+    published[shared.name] = shared;
+  }
+
+  platform::CUDADeviceGuard guard(place.GetDeviceId());
+  std::shared_ptr<void> base_ptr;
+  try {
+    base_ptr = memory::allocation::GetIpcBasePtr(layout.handle);
+  } catch (const std::exception& e) {
+    // left by a publisher that is gone, the predictor keeps its own copies
+    LOG(WARNING) << "Failed to open the shared weights published to " << path
+                 << ", the parameters are not shared: " << e.what();
+    return 0;
+  }
+  size_t mapped_num = 0;
+  size_t mapped_size = 0;
+  ForEachSharableTensor(
+      scopes, place, [&](const std::string& name, phi::DenseTensor* tensor) {
+        auto iter = published.find(name);
+        if (iter == published.end()) {
+          return;
+        }
+        const auto& shared = iter->second;
+        if (shared.size != TensorSize(*tensor) ||
+            shared.dtype != static_cast<int>(tensor->dtype()) ||
+            shared.dims != common::vectorize(tensor->dims())) {
+          LOG(WARNING) << "The published parameter " << name
+                       << " differs from the one of this predictor, keep "
+                          "its own copy.";
+          return;
+        }
+        void* ptr = static_cast<char*>(base_ptr.get()) + shared.offset;
+        tensor->ResetHolder(
+            std::make_shared<memory::allocation::CudaIpcAllocation>(
+                ptr, shared.size, place.GetDeviceId(), base_ptr));
+        ++mapped_num;
+        mapped_size += shared.size;
+      });
+  // the own copies are cached by the allocator
+  memory::Release(place);
+  LOG(INFO) << "Mapped " << mapped_num << " parameters of " << mapped_size
+            << " bytes on " << place << " from " << path;
+  return mapped_num;
+}
+
+#else
+
+size_t PublishSharedWeights(const std::vector<framework::Scope*>& scopes,
+                            const phi::GPUPlace& place,
+                            const std::string& path) {
+  PADDLE_THROW(common::errors::Unavailable(
+      "Shared weights need CUDA IPC, which is not supported on this "
+      "platform."));
+}
+
+size_t MapSharedWeights(const std::vector<framework::Scope*>& scopes,
+                        const phi::GPUPlace& place,
+                        const std::string& path) {
+  PADDLE_THROW(common::errors::Unavailable(
+      "Shared weights need CUDA IPC, which is not supported on this "
+      "platform."));
+}
+
+#endif
+
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,76 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/phi/common/place.h"
+
+namespace paddle {
+namespace inference {
+
+#if !defined(_WIN32)
+
+// The layout of a published buffer, as written to the file it is published
+// to.
+struct SharedWeightsLayout {
+  struct Tensor {
+    std::string name;
+    size_t offset;
+    size_t size;
+    int dtype;
+    std::vector<int64_t> dims;
+  };
+
+  int device_id{-1};
+  size_t total_size{0};
+  // the bytes of the CUDA IPC memory handle of the buffer
+  std::string handle;
+  std::vector<Tensor> tensors;
+};
+
+// Writes `layout` to `path`, replacing the file at once.
+void WriteSharedWeightsLayout(const SharedWeightsLayout& layout,
+                              const std::string& path);
+
+// Reads the layout written to `path`, returns false if there is no such
+// file.
+bool ReadSharedWeightsLayout(const std::string& path,
+                             SharedWeightsLayout* layout);
+
+#endif
+
+// Moves the initialized dense tensors on `place` found in `scopes` into one
+// gpu buffer and writes its CUDA IPC memory handle together with the layout
+// of the tensors to `path`. The buffer is freed with the last tensor, the
+// processes mapping it must be gone by then. Returns the number of tensors
+// published.
+size_t PublishSharedWeights(const std::vector<framework::Scope*>& scopes,
+                            const phi::GPUPlace& place,
+                            const std::string& path);
+
+// Replaces the tensors in `scopes` published to `path` by another process
+// with views of the published buffer, and releases the memory of their own
+// copies. Tensors whose name, shape or data type differ keep their copy.
+// Returns the number of tensors mapped, 0 if nothing is published to `path`
+// or the published buffer can not be opened, e.g. as its publisher is gone.
+size_t MapSharedWeights(const std::vector<framework::Scope*>& scopes,
+                        const phi::GPUPlace& place,
+                        const std::string& path);
+
+}  // namespace inference
+}  // namespace paddle
@@ -138,11 +138,38 @@ __pd_give PD_Tensor* PD_PredictorGetOutputHandle(
   return pd_tensor;
 }
 
+PD_Bool PD_PredictorBindOutput(__pd_keep PD_Predictor* pd_predictor,
+                               const char* name,
+                               void* data,
+                               size_t shape_size,
+                               int32_t* shape,
+                               PD_DataType data_type) {
+  CHECK_AND_CONVERT_PD_PREDICTOR;
+  std::vector<int> shapes(shape, shape + shape_size);
+  return predictor->BindOutput(  // NOLINT
+      name,
+      data,
+      shapes,
+      paddle_infer::CvtToCxxDatatype(data_type));
+}
+
 PD_Bool PD_PredictorRun(__pd_keep PD_Predictor* pd_predictor) {
   CHECK_AND_CONVERT_PD_PREDICTOR;
   return predictor->Run();  // NOLINT
 }
 
+PD_Bool PD_PredictorRunAsync(__pd_keep PD_Predictor* pd_predictor,
+                             void (*callback)(void*),
+                             void* user_data) {
+  CHECK_AND_CONVERT_PD_PREDICTOR;
+  PADDLE_ENFORCE_NOT_NULL(
+      callback,
+      common::errors::InvalidArgument(
+          "The callback of the async run shouldn't be nullptr"));
+  return predictor->RunAsync(  // NOLINT
+      [callback, user_data] { callback(user_data); });
+}
+
 void PD_PredictorClearIntermediateTensor(__pd_keep PD_Predictor* pd_predictor) {
   CHECK_AND_CONVERT_PD_PREDICTOR;
   predictor->ClearIntermediateTensor();
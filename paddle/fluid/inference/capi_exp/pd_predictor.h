@@ -122,6 +122,26 @@ PADDLE_CAPI_EXPORT extern __pd_give PD_Tensor* PD_PredictorGetInputHandle(
 PADDLE_CAPI_EXPORT extern __pd_give PD_Tensor* PD_PredictorGetOutputHandle(
     __pd_keep PD_Predictor* pd_predictor, const char* name);
 
+///
+/// \brief Bind the output to an external buffer on the device of the
+/// predictor, which the later runs write the output into.
+///
+/// \param[in] pd_predictor predictor
+/// \param[in] name output name
+/// \param[in] data the buffer, or NULL to unbind the output
+/// \param[in] shape_size the size of shape
+/// \param[in] shape the shape of the output written into the buffer
+/// \param[in] data_type the data type of the output
+/// \return Whether the output is bound
+///
+PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorBindOutput(
+    __pd_keep PD_Predictor* pd_predictor,
+    const char* name,
+    void* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_DataType data_type);
+
 ///
 /// \brief Run the prediction engine
 ///
@@ -131,6 +151,21 @@ PADDLE_CAPI_EXPORT extern __pd_give PD_Tensor* PD_PredictorGetOutputHandle(
 PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRun(
     __pd_keep PD_Predictor* pd_predictor);
 
+///
+/// \brief Run the prediction engine without waiting for the device to
+/// finish it, so one thread can drive many in-flight runs.
+///
+/// \param[in] pd_predictor predictor
+/// \param[in] callback called with user_data on a worker thread once the run
+/// is finished on the device, when the outputs may be read
+/// \param[in] user_data the argument of the callback
+/// \return Whether the run is launched successfully
+///
+PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRunAsync(
+    __pd_keep PD_Predictor* pd_predictor,
+    void (*callback)(void*),
+    void* user_data);
+
 /// \brief Clear the intermediate tensors of the predictor
 ///
 /// \param[in] pd_predictor predictor
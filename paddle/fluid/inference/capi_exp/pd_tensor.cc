@@ -116,5 +116,14 @@ PD_DataType PD_TensorGetDataType(__pd_keep PD_Tensor* pd_tensor) {
   CHECK_AND_CONVERT_PD_TENSOR;
   return paddle_infer::CvtFromCxxDatatype(tensor->type());
 }
+void PD_TensorShareExternalDLPack(__pd_keep PD_Tensor* pd_tensor,
+                                  __pd_take DLManagedTensor* dl_tensor) {
+  CHECK_AND_CONVERT_PD_TENSOR;
+  tensor->ShareExternalData(dl_tensor);
+}
+__pd_give DLManagedTensor* PD_TensorToDLPack(__pd_keep PD_Tensor* pd_tensor) {
+  CHECK_AND_CONVERT_PD_TENSOR;
+  return tensor->ToDLPack();
+}
 
 }  // extern "C"
@@ -29,6 +29,7 @@
 typedef struct PD_Tensor PD_Tensor;
 typedef struct PD_OneDimArrayInt32 PD_OneDimArrayInt32;
 typedef struct PD_TwoDimArraySize PD_TwoDimArraySize;
+struct DLManagedTensor;
 
 #ifdef __cplusplus
 extern "C" {
@@ -281,6 +282,22 @@ PADDLE_CAPI_EXPORT extern const char* PD_TensorGetName(
 ///
 PADDLE_CAPI_EXPORT extern PD_DataType PD_TensorGetDataType(
     __pd_keep PD_Tensor* pd_tensor);
+///
+/// \brief Share the data of a DLPack tensor with the tensor, without copy.
+/// \param[in] pd_tensor tensor.
+/// \param[in] dl_tensor The DLPack tensor in the compact row major layout,
+/// whose deleter is called once the data is no longer used by the tensor.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDLPack(
+    __pd_keep PD_Tensor* pd_tensor,
+    __pd_take struct DLManagedTensor* dl_tensor);
+///
+/// \brief Export the tensor data as a DLPack tensor, without copy.
+/// \param[in] pd_tensor tensor.
+/// \return The DLPack tensor, released by calling its deleter.
+///
+PADDLE_CAPI_EXPORT extern __pd_give struct DLManagedTensor* PD_TensorToDLPack(
+    __pd_keep PD_Tensor* pd_tensor);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -15,6 +15,8 @@ limitations under the License. */
 #include "paddle/fluid/inference/tensorrt/engine.h"
 #include <NvInfer.h>
 #include <glog/logging.h>
+#include <algorithm>
+#include <chrono>
 #include <string>
 
 #include "NvInferRuntimeCommon.h"
@@ -118,7 +120,13 @@ void TensorRTEngine::Execute(int batch_size,
                              cudaStream_t stream) {
   FreshDeviceId();
   auto infer_context = context();
-  if (params_.context_memory_sharing) {
+  // The context memory leased from the pool is not held by a CUDA graph,
+  // whose nodes keep the addresses.
+  const bool lease_context_memory = params_.context_memory_sharing &&
+                                    FLAGS_trt_context_memory_pool_size > 0 &&
+                                    !startup_with_cudagraph_ &&
+                                    !cudagraph_inited_;
+  if (params_.context_memory_sharing && !lease_context_memory) {
     void *context_memory{nullptr};
     context_memory =
         inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
@@ -161,6 +169,16 @@ void TensorRTEngine::Execute(int batch_size,
     startup_with_cudagraph_ = false;
   }
 
+  if (lease_context_memory) {
+    auto &manager =
+        inference::Singleton<inference::tensorrt::TRTEngineManager>::Global();
+    auto *block =
+        manager.AcquireContextMemory(phi::GPUPlace(device_id()), stream);
+    infer_context->setDeviceMemory(block->ptr);
+    Enqueue(infer_context, buffers, batch_size, stream);
+    manager.ReleaseContextMemory(block, stream);
+    return;
+  }
   Enqueue(infer_context, buffers, batch_size, stream);
 }
 
@@ -175,7 +193,12 @@ bool TensorRTEngine::Enqueue(nvinfer1::IExecutionContext *context,
   }
 
 #if IS_TRT_VERSION_GE(8500)
-  for (size_t j = 0; j < buffers->size(); ++j) {
+  // The tensors of the other profiles are not named, which are bound by the
+  // names of the ones of the first profile.
+  const size_t num_io_tensors =
+      std::min(buffers->size(),
+               static_cast<size_t>(context->getEngine().getNbIOTensors()));
+  for (size_t j = 0; j < num_io_tensors; ++j) {
     auto name = context->getEngine().getIOTensorName(j);
     if (context->getEngine().isShapeInferenceIO(name) &&
         context->getEngine().getTensorIOMode(name) ==
@@ -200,6 +223,51 @@ bool TensorRTEngine::Enqueue(nvinfer1::IExecutionContext *context,
   return ret;
 }
 
+void TensorRTEngine::SelectShapeProfile(nvinfer1::IExecutionContext *context,
+                                        const ShapeMapType &input_shapes,
+                                        cudaStream_t stream) {
+#if IS_TRT_VERSION_GE(8600)
+  if (!with_shape_buckets()) return;
+  const auto ContainsInputShapes = [&](int profile) {
+    for (auto const &[name, shape] : input_shapes) {
+      const auto min_dims = infer_engine_->getProfileShape(
+          name.c_str(), profile, nvinfer1::OptProfileSelector::kMIN);
+      const auto max_dims = infer_engine_->getProfileShape(
+          name.c_str(), profile, nvinfer1::OptProfileSelector::kMAX);
+      // e.g. the input is not used by the engine
+      if (min_dims.nbDims != static_cast<int>(shape.size())) continue;
+      for (int d = 0; d < min_dims.nbDims; ++d) {
+        if (shape[d] < min_dims.d[d] || shape[d] > max_dims.d[d]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+  int profile = max_profile_num_ - 1;
+  for (int i = 0; i + 1 < max_profile_num_; ++i) {
+    if (ContainsInputShapes(i)) {
+      profile = i;
+      break;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto &profile_index = profile_index_[predictor_id_per_thread];
+  if (profile_index == profile) return;
+  PADDLE_ENFORCE_EQ(
+      context->setOptimizationProfileAsync(profile, stream),
+      true,
+      common::errors::External("Failed to switch the TensorRT execution "
+                               "context to the optimization profile %d.",
+                               profile));
+  VLOG(3) << "Switch the TensorRT execution context from the optimization "
+             "profile "
+          << profile_index << " to " << profile;
+  profile_index = profile;
+#endif
+}
+
 void TensorRTEngine::FreezeNetwork() {
   FreshDeviceId();
   VLOG(3) << "TRT to freeze network";
@@ -258,7 +326,8 @@ void TensorRTEngine::FreezeNetwork() {
     infer_builder_config_->setFlag(nvinfer1::BuilderFlag::kINT8);
 
     if (params_.calibrator) {
-      infer_builder_config_->setInt8Calibrator(params_.calibrator);
+      infer_builder_config_->setInt8Calibrator(
+          params_.calibrator->GetTrtCalibrator());
     } else if (!params_.use_explicit_quantization) {
       infer_builder_config_->setInt8Calibrator(nullptr);
 
@@ -317,38 +386,52 @@ void TensorRTEngine::FreezeNetwork() {
   if (with_dynamic_shape()) {
     LOG(INFO) << "Run Paddle-TRT Dynamic Shape mode.";
     for (int i = 0; i < max_profile_num_; i++) {
+      // The profiles of the shape buckets come first, and the one of the full
+      // range the last.
+      const bool is_bucket = with_shape_buckets() && i + 1 < max_profile_num_;
       for (auto &input : min_input_shape()) {
+        auto min_shape = input.second;
+        auto max_shape = max_input_shape()[input.first];
+        auto opt_shape = optim_input_shape()[input.first];
+        if (is_bucket &&
+            params_.max_input_shape_buckets[i].count(input.first) &&
+            params_.max_input_shape_buckets[i].at(input.first).size() ==
+                max_shape.size()) {
+          min_shape = params_.min_input_shape_buckets[i].at(input.first);
+          max_shape = params_.max_input_shape_buckets[i].at(input.first);
+          opt_shape = params_.optim_input_shape_buckets[i].at(input.first);
+        }
 #if IS_TRT_VERSION_LT(7100)
         // trt6/trt7011 will check all_of input > 0
-        if (!(std::all_of(input.second.begin(),
-                          input.second.end(),
+        if (!(std::all_of(min_shape.begin(),
+                          min_shape.end(),
                           [](int x) { return x > 0; }) &&
-              std::all_of(max_input_shape()[input.first].begin(),
-                          max_input_shape()[input.first].end(),
+              std::all_of(max_shape.begin(),
+                          max_shape.end(),
                           [](int x) { return x > 0; }) &&
-              std::all_of(optim_input_shape()[input.first].begin(),
-                          optim_input_shape()[input.first].end(),
+              std::all_of(opt_shape.begin(),
+                          opt_shape.end(),
                           [](int x) { return x > 0; }))) {
           continue;
         }
 #endif
         VLOG(4) << "TRT dynamic_shape set " << input.first
-                << " min: " << Vec2Str(input.second)
-                << ", max: " << Vec2Str(max_input_shape()[input.first])
-                << ", opt: " << Vec2Str(optim_input_shape()[input.first]);
+                << " of profile " << i << " min: " << Vec2Str(min_shape)
+                << ", max: " << Vec2Str(max_shape)
+                << ", opt: " << Vec2Str(opt_shape);
 
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kMIN,
-            Vec2TRT_Dims(input.second, input.first, true));
+            Vec2TRT_Dims(min_shape, input.first, true));
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kMAX,
-            Vec2TRT_Dims(max_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(max_shape, input.first, true));
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kOPT,
-            Vec2TRT_Dims(optim_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(opt_shape, input.first, true));
       }
 
       for (int input_id = 0; input_id < network()->getNbInputs(); input_id++) {
@@ -411,6 +494,29 @@ void TensorRTEngine::FreezeNetwork() {
   }
 #endif
 
+#if IS_TRT_VERSION_GE(8000)
+  // The timings of the layers measured in building the engines are shared
+  // through the timing cache, which saves most of the build time of the
+  // engines with the same layers.
+  infer_ptr<nvinfer1::ITimingCache> timing_cache;
+  auto &manager =
+      inference::Singleton<inference::tensorrt::TRTEngineManager>::Global();
+  if (!params_.timing_cache_path.empty()) {
+    const std::string data =
+        manager.LoadTimingCache(params_.timing_cache_path);
+    timing_cache.reset(
+        infer_builder_config_->createTimingCache(data.data(), data.size()));
+    PADDLE_ENFORCE_NOT_NULL(
+        timing_cache,
+        common::errors::InvalidArgument(
+            "Fail to create the TensorRT timing cache from %s, please remove "
+            "the file if it is generated by another version of TensorRT.",
+            params_.timing_cache_path));
+    infer_builder_config_->setTimingCache(*timing_cache, false);
+  }
+#endif
+
+  const auto build_start = std::chrono::steady_clock::now();
 #if IS_TRT_VERSION_LT(8000)
   infer_engine_.reset(infer_builder_->buildEngineWithConfig(
       *network(), *infer_builder_config_));
@@ -421,12 +527,34 @@ void TensorRTEngine::FreezeNetwork() {
   infer_engine_.reset(infer_runtime_->deserializeCudaEngine(
       ihost_memory_->data(), ihost_memory_->size()));
 #endif
+  build_time_ = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - build_start)
+                    .count();
+  LOG(INFO) << "Build the TensorRT engine in " << build_time_ << " s.";
 
   PADDLE_ENFORCE_NOT_NULL(
       infer_engine_,
       common::errors::Fatal("Build TensorRT cuda engine failed! Please recheck "
                             "you configurations related to paddle-TensorRT."));
 
+#if IS_TRT_VERSION_GE(8000)
+  if (timing_cache) {
+    // merged with the timings saved by the engines built meanwhile
+    manager.UpdateTimingCache(
+        params_.timing_cache_path, [&](const std::string &data) {
+          infer_ptr<nvinfer1::ITimingCache> shared_cache(
+              infer_builder_config_->createTimingCache(data.data(),
+                                                       data.size()));
+          if (shared_cache) {
+            timing_cache->combine(*shared_cache, false);
+          }
+          infer_ptr<nvinfer1::IHostMemory> merged(timing_cache->serialize());
+          return std::string(static_cast<const char *>(merged->data()),
+                             merged->size());
+        });
+  }
+#endif
+
 #if IS_TRT_VERSION_GE(10000)
   binding_num_ = infer_engine_->getNbIOTensors();
 #else
@@ -658,6 +786,10 @@ void TensorRTEngine::Deserialize(const std::string &engine_serialized_data) {
 #else
   binding_num_ = infer_engine_->getNbBindings();
 #endif
+  // The engine may be serialized with the other shape buckets.
+  if (with_shape_buckets()) {
+    max_profile_num_ = infer_engine_->getNbOptimizationProfiles();
+  }
   // for engine context memory sharing
   if (params_.context_memory_sharing) {
     inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
@@ -14,7 +14,13 @@ limitations under the License. */
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>  // NOLINT
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -40,6 +46,7 @@ limitations under the License. */
 #include "paddle/phi/core/stream.h"
 
 COMMON_DECLARE_bool(trt_ibuilder_cache);
+COMMON_DECLARE_int32(trt_context_memory_pool_size);
 
 namespace paddle {
 namespace inference {
@@ -152,6 +159,12 @@ class TensorRTEngine {
     ShapeMapType min_shape_tensor;
     ShapeMapType max_shape_tensor;
     ShapeMapType optim_shape_tensor;
+    // The narrower shape ranges of the inputs, from the tightest to the
+    // widest, each of which makes an optimization profile in front of the one
+    // of the full range above, see SelectShapeProfile.
+    std::vector<ShapeMapType> min_input_shape_buckets;
+    std::vector<ShapeMapType> max_input_shape_buckets;
+    std::vector<ShapeMapType> optim_input_shape_buckets;
 
     bool use_inspector{false};
     std::string engine_info_path{""};
@@ -170,6 +183,9 @@ class TensorRTEngine {
     bool disable_trt_plugin_fp16{false};
     int optimization_level{3};
     bool use_explicit_quantization{false};
+    // The file of the timing cache shared by the engines, which is not used
+    // if empty.
+    std::string timing_cache_path{""};
   };
 
   // Weight is model parameter.
@@ -205,6 +221,13 @@ class TensorRTEngine {
     std::call_once(trt_plugin_registered, []() {
       tensorrt::plugin::TrtPluginRegistry::Global()->RegistToTrt();
     });
+#if IS_TRT_VERSION_GE(8600)
+    if (params_.with_dynamic_shape &&
+        !params_.min_input_shape_buckets.empty()) {
+      max_profile_num_ =
+          static_cast<int>(params_.min_input_shape_buckets.size()) + 1;
+    }
+#endif
   }
 
   // Add an input and set its name, data type and dimension.
@@ -235,6 +258,9 @@ class TensorRTEngine {
   nvinfer1::IExecutionContext* context();
 
   int GetBindingsOffset() {
+    // The tensors are bound by their names, which are the same in all the
+    // profiles of the shape buckets.
+    if (with_shape_buckets()) return 0;
     return (binding_num_ / max_profile_num_) * GetProfileIndex();
   }
 
@@ -366,6 +392,19 @@ class TensorRTEngine {
   // After finishing adding ops, freeze this network and creates the execution
   // environment.
   void FreezeNetwork();
+  // Whether the optimization profile is selected by the input shapes of each
+  // run, among the ones of the shape buckets and the full range.
+  bool with_shape_buckets() const {
+    return max_profile_num_ > 1 && !params_.min_input_shape_buckets.empty();
+  }
+  // Switch the context to the first optimization profile whose range contains
+  // the input shapes, which is the tightest one since the ranges of the shape
+  // buckets are nested, or to the one of the full range if there is none.
+  void SelectShapeProfile(nvinfer1::IExecutionContext* context,
+                          const ShapeMapType& input_shapes,
+                          cudaStream_t stream);
+  // The seconds taken by the TRT builder in FreezeNetwork.
+  double build_time() const { return build_time_; }
   void Execute(int batch_size,
                std::vector<void*>* buffers,
                cudaStream_t stream = nullptr);
@@ -606,6 +645,7 @@ class TensorRTEngine {
 
 #if IS_TRT_VERSION_GE(6000)
   int binding_num_;
+  double build_time_{0.};
   infer_ptr<nvinfer1::IBuilderConfig> infer_builder_config_;
   std::vector<nvinfer1::IOptimizationProfile*> optim_profiles_;
   std::vector<std::unique_ptr<plugin::DynamicPluginTensorRT>> owned_pluginv2_;
@@ -634,6 +674,16 @@ class TRTEngineManager {
   using AllocationPtr = phi::Allocator::AllocationPtr;
 
  public:
+  // A block of the context memory in the pool, which is free for the work
+  // enqueued to any stream after the event released.
+  struct ContextMemoryBlock {
+    int device_id;
+    AllocationPtr memory;
+    size_t size{0};
+    void* ptr{nullptr};
+    cudaEvent_t released{nullptr};
+  };
+
   TRTEngineManager() {
     // createInferBuilder loads trt kernels and take a few second
     // But as long as one IBuilder lives, trt kernel will not be unloaded
@@ -725,6 +775,98 @@ class TRTEngineManager {
     }
   }
 
+  // Lease a block of the context memory of the max size from the pool of the
+  // device, which waits for a free block if there are already
+  // FLAGS_trt_context_memory_pool_size blocks leased. The work enqueued to
+  // stream after it waits for the work of the previous lease.
+  ContextMemoryBlock* AcquireContextMemory(const phi::GPUPlace& place,
+                                           cudaStream_t stream) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const int device_id = place.GetDeviceId();
+    auto& free_blocks = free_ctx_mem_blocks_[device_id];
+    auto& blocks = ctx_mem_blocks_[device_id];
+    ctx_mem_cv_.wait(lock, [&] {
+      return !free_blocks.empty() ||
+             static_cast<int>(blocks.size()) <
+                 std::max(FLAGS_trt_context_memory_pool_size, 1);
+    });
+    ContextMemoryBlock* block = nullptr;
+    if (free_blocks.empty()) {
+      blocks.emplace_back(std::make_unique<ContextMemoryBlock>());
+      block = blocks.back().get();
+      block->device_id = device_id;
+      VLOG(3) << "Create the block " << blocks.size()
+              << " of the TensorRT context memory on device " << device_id;
+    } else {
+      block = free_blocks.back();
+      free_blocks.pop_back();
+    }
+    if (block->size < max_ctx_mem_size_) {
+      // the previous lease may still use the smaller memory
+      if (block->released != nullptr) {
+        PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(block->released));
+      }
+      static auto alignment = GetAlignmentSize(place);
+      block->memory.reset(nullptr);
+      block->memory = memory::Alloc(place, max_ctx_mem_size_ + alignment);
+      block->size = max_ctx_mem_size_;
+      block->ptr = reinterpret_cast<void*>(
+          (uintptr_t(block->memory->ptr()) + alignment - 1) &
+          ~(alignment - 1));
+    } else if (block->released != nullptr) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(stream, block->released, 0));
+    }
+    return block;
+  }
+
+  // Give the block back to the pool once the work enqueued to stream is done.
+  void ReleaseContextMemory(ContextMemoryBlock* block, cudaStream_t stream) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (block->released == nullptr) {
+        PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreateWithFlags(
+            &block->released, cudaEventDisableTiming));
+      }
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(block->released, stream));
+      free_ctx_mem_blocks_[block->device_id].push_back(block);
+    }
+    ctx_mem_cv_.notify_one();
+  }
+
+  // The serialized timing cache shared by the engines built with the cache
+  // file in path, which is read from the file at the first time.
+  std::string LoadTimingCache(const std::string& path) {
+    std::lock_guard<std::mutex> lock(timing_cache_mutex_);
+    return LoadTimingCacheLocked(path);
+  }
+
+  // Replace the shared timing cache with merge(the shared timing cache), and
+  // write it back to the file, where merge runs exclusively.
+  void UpdateTimingCache(
+      const std::string& path,
+      const std::function<std::string(const std::string&)>& merge) {
+    std::lock_guard<std::mutex> lock(timing_cache_mutex_);
+    std::string merged = merge(LoadTimingCacheLocked(path));
+    std::string& timing_cache = timing_caches_[path];
+    timing_cache = std::move(merged);
+    // written to a temporary file first, so that a reader never sees a
+    // partially written cache
+    const std::string tmp_path = path + ".tmp";
+    {
+      std::ofstream fout(tmp_path, std::ios::out | std::ios::binary);
+      fout.write(timing_cache.data(),
+                 static_cast<std::streamsize>(timing_cache.size()));
+      if (!fout) {
+        LOG(WARNING) << "Fail to save the TRT timing cache to " << path;
+        return;
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      LOG(WARNING) << "Fail to save the TRT timing cache to " << path;
+    }
+  }
+
  private:
   size_t GetAlignmentSize(const phi::GPUPlace& place) {
     const auto& prop = platform::GetDeviceProperties(place.GetDeviceId());
@@ -735,11 +877,34 @@ class TRTEngineManager {
     return reinterpret_cast<void*>(uintptr_t(addr) & (~(alignment - 1)));
   }
 
+  std::string LoadTimingCacheLocked(const std::string& path) {
+    auto it = timing_caches_.find(path);
+    if (it == timing_caches_.end()) {
+      std::ifstream fin(path, std::ios::in | std::ios::binary);
+      std::string timing_cache((std::istreambuf_iterator<char>(fin)),
+                               std::istreambuf_iterator<char>());
+      VLOG(1) << "Load the TRT timing cache of " << timing_cache.size()
+              << " bytes from " << path;
+      it = timing_caches_.emplace(path, std::move(timing_cache)).first;
+    }
+    return it->second;
+  }
+
   mutable std::mutex mutex_;
   size_t max_ctx_mem_size_{0};
   std::unordered_map<PredictorID, AllocationPtr> context_memorys_;
+  // The pool of the context memory leased to the running execution contexts,
+  // keyed by the device id.
+  std::condition_variable ctx_mem_cv_;
+  std::unordered_map<int, std::vector<std::unique_ptr<ContextMemoryBlock>>>
+      ctx_mem_blocks_;
+  std::unordered_map<int, std::vector<ContextMemoryBlock*>>
+      free_ctx_mem_blocks_;
   std::unordered_map<std::string, std::unique_ptr<TensorRTEngine>> engines_;
   infer_ptr<nvinfer1::IBuilder> holder_;
+
+  std::mutex timing_cache_mutex_;
+  std::unordered_map<std::string, std::string> timing_caches_;
 };
 
 }  // namespace tensorrt
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
 
+#include <algorithm>
+
 #include "glog/logging.h"
 #include "paddle/fluid/platform/enforce.h"
 
@@ -21,6 +23,62 @@ namespace paddle {
 namespace inference {
 namespace tensorrt {
 
+namespace {
+
+// A calibrator of the algorithm of Base, which forwards to a TRTInt8Calibrator
+// holding the batches and the calibration table.
+template <typename Base>
+class TRTInt8CalibratorAdapter : public Base {
+ public:
+  explicit TRTInt8CalibratorAdapter(TRTInt8Calibrator* calibrator)
+      : calibrator_(calibrator) {}
+
+  int getBatchSize() const TRT_NOEXCEPT override {
+    return calibrator_->getBatchSize();
+  }
+
+  bool getBatch(void* bindings[],
+                const char* names[],
+                int num_bindings) TRT_NOEXCEPT override {
+    return calibrator_->getBatch(bindings, names, num_bindings);
+  }
+
+  const void* readCalibrationCache(std::size_t& length) TRT_NOEXCEPT override {
+    return calibrator_->readCalibrationCache(length);
+  }
+
+  void writeCalibrationCache(const void* ptr,
+                             std::size_t length) TRT_NOEXCEPT override {
+    calibrator_->writeCalibrationCache(ptr, length);
+  }
+
+ private:
+  TRTInt8Calibrator* calibrator_;
+};
+
+class TRTInt8PercentileCalibrator
+    : public TRTInt8CalibratorAdapter<nvinfer1::IInt8LegacyCalibrator> {
+ public:
+  TRTInt8PercentileCalibrator(TRTInt8Calibrator* calibrator, double percentile)
+      : TRTInt8CalibratorAdapter(calibrator), quantile_(percentile / 100.) {}
+
+  double getQuantile() const TRT_NOEXCEPT override { return quantile_; }
+
+  double getRegressionCutoff() const TRT_NOEXCEPT override { return 1.; }
+
+  const void* readHistogramCache(std::size_t& length) TRT_NOEXCEPT override {
+    return nullptr;
+  }
+
+  void writeHistogramCache(const void* ptr,
+                           std::size_t length) TRT_NOEXCEPT override {}
+
+ private:
+  double quantile_;
+};
+
+}  // namespace
+
 // set the batch size before constructing the thread to execute engine
 int TRTInt8Calibrator::getBatchSize() const TRT_NOEXCEPT { return batch_size_; }
 
@@ -28,38 +86,82 @@ TRTInt8Calibrator::TRTInt8Calibrator(
     const std::unordered_map<std::string, size_t>& buffers,
     int batch_size,
     std::string engine_name,
-    const phi::Place place)
+    const phi::Place place,
+    CalibrationAlgorithm algorithm,
+    double percentile,
+    int batch_queue_size)
     : batch_size_(batch_size),
-      data_buffers_(),
+      data_buffers_(std::max(batch_queue_size, 1)),
       data_tensors_(),
-      engine_name_(engine_name) {
-  VLOG(4) << "Init a new calibrator: " << engine_name_;
-  for (const auto& it : buffers) {
-    phi::DenseTensor temp_tensor;
-    std::string input_name = it.first;
-    int data_size = it.second;
-    int num_ele = data_size / sizeof(int16_t);
-    phi::DDim data_shape = common::make_ddim({num_ele});
-    temp_tensor.Resize(data_shape);
-    data_buffers_[input_name] = std::pair<void*, size_t>(
-        static_cast<void*>(temp_tensor.mutable_data<int16_t>(place)),
-        data_size);
-    data_tensors_.push_back(temp_tensor);
+      engine_name_(engine_name),
+      algorithm_(algorithm),
+      percentile_(percentile) {
+  VLOG(4) << "Init a new calibrator: " << engine_name_ << " with a queue of "
+          << data_buffers_.size() << " batches";
+  for (auto& slot : data_buffers_) {
+    for (const auto& it : buffers) {
+      phi::DenseTensor temp_tensor;
+      std::string input_name = it.first;
+      int data_size = it.second;
+      int num_ele = data_size / sizeof(int16_t);
+      phi::DDim data_shape = common::make_ddim({num_ele});
+      temp_tensor.Resize(data_shape);
+      slot[input_name] = std::pair<void*, size_t>(
+          static_cast<void*>(temp_tensor.mutable_data<int16_t>(place)),
+          data_size);
+      data_tensors_.push_back(temp_tensor);
+    }
   }
 }
 
-TRTInt8Calibrator::TRTInt8Calibrator(const std::string& calib_data)
+TRTInt8Calibrator::TRTInt8Calibrator(const std::string& calib_data,
+                                     CalibrationAlgorithm algorithm,
+                                     double percentile)
     : batch_size_(0),
-      calib_running_(false),
-      data_is_set_(false),
       done_(true),
       data_buffers_(),
       data_tensors_(),
-      calibration_table_(calib_data) {}
+      calibration_table_(calib_data),
+      algorithm_(algorithm),
+      percentile_(percentile) {}
+
+nvinfer1::IInt8Calibrator* TRTInt8Calibrator::GetTrtCalibrator() {
+  if (algorithm_ == CalibrationAlgorithm::kEntropy2) {
+    return this;
+  }
+  if (!trt_calibrator_) {
+    switch (algorithm_) {
+      case CalibrationAlgorithm::kEntropy:
+        trt_calibrator_ = std::make_unique<
+            TRTInt8CalibratorAdapter<nvinfer1::IInt8EntropyCalibrator>>(this);
+        break;
+      case CalibrationAlgorithm::kMinMax:
+        trt_calibrator_ = std::make_unique<
+            TRTInt8CalibratorAdapter<nvinfer1::IInt8MinMaxCalibrator>>(this);
+        break;
+      case CalibrationAlgorithm::kPercentile:
+        PADDLE_ENFORCE_EQ(
+            percentile_ > 0. && percentile_ <= 100.,
+            true,
+            common::errors::InvalidArgument(
+                "The percentile of the INT8 calibration should be in (0, "
+                "100], but received %f.",
+                percentile_));
+        trt_calibrator_ =
+            std::make_unique<TRTInt8PercentileCalibrator>(this, percentile_);
+        break;
+      default:
+        PADDLE_THROW(common::errors::InvalidArgument(
+            "Unknown TRT INT8 calibration algorithm %d.",
+            static_cast<int>(algorithm_)));
+    }
+  }
+  return trt_calibrator_.get();
+}
 
 void TRTInt8Calibrator::waitAndSetDone() {
   std::unique_lock<std::mutex> lk(mut_);
-  while ((calib_running_ || data_is_set_) && !done_) cond_.wait(lk);
+  while ((calib_running_ || num_ready_ > 0) && !done_) cond_.wait(lk);
   if (!done_) {
     done_ = true;
     cond_.notify_all();
@@ -73,18 +175,23 @@ bool TRTInt8Calibrator::setBatch(
   VLOG(3) << "set batch: " << engine_name_;
   std::unique_lock<std::mutex> lk(mut_);
   //  There is a producer and a consumer. The producer set the batch data and
-  //  the consumer get the batch data. The size of the data pool is one.
-  //  So, the producer has to wait for the consumer to finish processing before
-  //  they can set the data.
-  while ((calib_running_ || data_is_set_) && (!done_)) cond_.wait(lk);
+  //  the consumer get the batch data. The producer has to wait for the
+  //  consumer to give a batch back when all the buffers of the queue are
+  //  taken.
+  const int queue_size = static_cast<int>(data_buffers_.size());
+  while (num_ready_ + (calib_running_ ? 1 : 0) >= queue_size && !done_)
+    cond_.wait(lk);
   // The done_ is set to true using waitAndSetDone, When all calibration data
   // are processed.
   if (done_) return false;
 
   // Sets the batch.
+  auto& slot =
+      data_buffers_[(head_ + (calib_running_ ? 1 : 0) + num_ready_) %
+                    queue_size];
   for (const auto& it : data) {
-    auto dataptr = data_buffers_.find(it.first);
-    if (dataptr == data_buffers_.end()) {
+    auto dataptr = slot.find(it.first);
+    if (dataptr == slot.end()) {
       PADDLE_THROW(common::errors::Fatal(
           "%s input name '%s' does not match with the buffer names.",
           engine_name_,
@@ -95,7 +202,7 @@ bool TRTInt8Calibrator::setBatch(
         cudaMemcpy(d.first, it.second, d.second, cudaMemcpyDeviceToDevice));
   }
 
-  data_is_set_ = true;
+  ++num_ready_;
   cond_.notify_all();
   return true;
 }
@@ -107,17 +214,21 @@ bool TRTInt8Calibrator::getBatch(void** bindings,
   std::unique_lock<std::mutex> lk(mut_);
   // The consumer has just finished processing a data.
   // The producer can set the data again.
-  calib_running_ = false;
+  if (calib_running_) {
+    head_ = (head_ + 1) % static_cast<int>(data_buffers_.size());
+    calib_running_ = false;
+  }
   cond_.notify_all();
 
   // As long as there is data in the pool, the consumer can get it.
-  while (!data_is_set_ && !done_) cond_.wait(lk);
+  while (num_ready_ == 0 && !done_) cond_.wait(lk);
   if (done_) return false;
 
   // Gets the batch
+  const auto& slot = data_buffers_[head_];
   for (int i = 0; i < num_bindings; i++) {
-    auto it = data_buffers_.find(names[i]);
-    if (it == data_buffers_.end()) {
+    auto it = slot.find(names[i]);
+    if (it == slot.end()) {
       try {
         PADDLE_THROW(
             common::errors::Fatal("Calibration engine asked for unknown tensor "
@@ -130,7 +241,7 @@ bool TRTInt8Calibrator::getBatch(void** bindings,
     bindings[i] = it->second.first;
   }
 
-  data_is_set_ = false;
+  --num_ready_;
   calib_running_ = true;
   VLOG(4) << "get batch done: " << engine_name_;
   return true;
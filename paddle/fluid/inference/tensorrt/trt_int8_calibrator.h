@@ -35,14 +35,35 @@ namespace tensorrt {
 
 class TensorRTEngine;
 
+// The algorithms of the TRT INT8 calibration, which take the same values as
+// AnalysisConfig::Int8CalibrationAlgorithm.
+enum class CalibrationAlgorithm {
+  kEntropy2 = 0,
+  kEntropy = 1,
+  kMinMax = 2,
+  // The legacy calibrator, which takes a percentile of the activations as the
+  // range.
+  kPercentile = 3,
+};
+
 class TRTInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
  public:
+  // The calibrator keeps up to batch_queue_size batches set but not yet
+  // consumed by TRT, so that the Paddle program runs the next batches while
+  // TRT calibrates the previous one.
   TRTInt8Calibrator(const std::unordered_map<std::string, size_t>& buffers,
                     int batch_size,
                     std::string engine_name,
-                    const phi::Place place);
-
-  explicit TRTInt8Calibrator(const std::string& calibration_data);
+                    const phi::Place place,
+                    CalibrationAlgorithm algorithm =
+                        CalibrationAlgorithm::kEntropy2,
+                    double percentile = 99.99,
+                    int batch_queue_size = 1);
+
+  explicit TRTInt8Calibrator(
+      const std::string& calibration_data,
+      CalibrationAlgorithm algorithm = CalibrationAlgorithm::kEntropy2,
+      double percentile = 99.99);
   ~TRTInt8Calibrator() override;
 
   int getBatchSize() const TRT_NOEXCEPT override;
@@ -62,21 +83,34 @@ class TRTInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
     return calibration_table_;
   }
 
+  // The calibrator of the algorithm given to the TRT builder, which forwards
+  // to this one.
+  nvinfer1::IInt8Calibrator* GetTrtCalibrator();
+
  private:
   const int batch_size_;
 
-  bool calib_running_{true};
-  bool data_is_set_{false};
+  // Whether TRT is using the batch at the head of the queue, which is given
+  // back at the next getBatch.
+  bool calib_running_{false};
+  // The number of the batches set after the one used by TRT.
+  int num_ready_{0};
+  int head_{0};
   bool done_{false};
 
   std::mutex mut_;
   std::condition_variable cond_;
 
-  std::unordered_map<std::string, std::pair<void*, size_t>> data_buffers_;
+  std::vector<std::unordered_map<std::string, std::pair<void*, size_t>>>
+      data_buffers_;
   std::vector<phi::DenseTensor> data_tensors_;
 
   std::string engine_name_;
   std::string calibration_table_;
+
+  CalibrationAlgorithm algorithm_;
+  double percentile_;
+  std::unique_ptr<nvinfer1::IInt8Calibrator> trt_calibrator_;
 };
 
 class TRTCalibratorEngine {
@@ -344,5 +344,51 @@ void UpdateShapeRangeInfo(
   inference::SerializeShapeRangeInfo(path, shape_range_infos);
 }
 
+void SerializeShapeRangeBuckets(
+    const std::string &path,
+    const std::vector<std::map<std::string, std::vector<int32_t>>> &min_shape,
+    const std::vector<std::map<std::string, std::vector<int32_t>>> &max_shape,
+    const std::vector<std::map<std::string, std::vector<int32_t>>> &opt_shape) {
+  paddle::inference::proto::ShapeRangeInfos shape_range_infos;
+  DeserializeShapeRangeInfo(path, &shape_range_infos);
+  shape_range_infos.clear_shape_range_bucket();
+  for (size_t i = 0; i < min_shape.size(); ++i) {
+    auto *bucket = shape_range_infos.add_shape_range_bucket();
+    for (auto const &it : min_shape[i]) {
+      auto *info = bucket->add_shape_range_info();
+      info->set_name(it.first);
+      for (auto shape : it.second) info->add_min_shape(shape);
+      for (auto shape : max_shape[i].at(it.first)) info->add_max_shape(shape);
+      for (auto shape : opt_shape[i].at(it.first)) info->add_opt_shape(shape);
+    }
+  }
+  inference::SerializeShapeRangeInfo(path, shape_range_infos);
+}
+
+void DeserializeShapeRangeBuckets(
+    const std::string &path,
+    std::vector<std::map<std::string, std::vector<int32_t>>> *min_shape,
+    std::vector<std::map<std::string, std::vector<int32_t>>> *max_shape,
+    std::vector<std::map<std::string, std::vector<int32_t>>> *opt_shape) {
+  paddle::inference::proto::ShapeRangeInfos shape_range_infos;
+  DeserializeShapeRangeInfo(path, &shape_range_infos);
+  min_shape->clear();
+  max_shape->clear();
+  opt_shape->clear();
+  for (const auto &bucket : shape_range_infos.shape_range_bucket()) {
+    auto &min_bucket = min_shape->emplace_back();
+    auto &max_bucket = max_shape->emplace_back();
+    auto &opt_bucket = opt_shape->emplace_back();
+    for (const auto &info : bucket.shape_range_info()) {
+      min_bucket[info.name()].assign(info.min_shape().begin(),
+                                     info.min_shape().end());
+      max_bucket[info.name()].assign(info.max_shape().begin(),
+                                     info.max_shape().end());
+      opt_bucket[info.name()].assign(info.opt_shape().begin(),
+                                     info.opt_shape().end());
+    }
+  }
+}
+
 }  // namespace inference
 }  // namespace paddle
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -70,5 +71,17 @@ TEST_API void UpdateShapeRangeInfo(
     const std::map<std::string, std::vector<int32_t>>& opt_value,
     const std::vector<std::string>& names,
     const std::vector<std::string>& tensor_names);
+// The shape buckets are the narrower shape ranges of the tensors, from the
+// tightest to the widest, which are kept in the file of the shape range info.
+TEST_API void SerializeShapeRangeBuckets(
+    const std::string& path,
+    const std::vector<std::map<std::string, std::vector<int32_t>>>& min_shape,
+    const std::vector<std::map<std::string, std::vector<int32_t>>>& max_shape,
+    const std::vector<std::map<std::string, std::vector<int32_t>>>& opt_shape);
+TEST_API void DeserializeShapeRangeBuckets(
+    const std::string& path,
+    std::vector<std::map<std::string, std::vector<int32_t>>>* min_shape,
+    std::vector<std::map<std::string, std::vector<int32_t>>>* max_shape,
+    std::vector<std::map<std::string, std::vector<int32_t>>>* opt_shape);
 }  // namespace inference
 }  // namespace paddle
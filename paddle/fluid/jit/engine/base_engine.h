@@ -29,6 +29,10 @@ class BaseEngine {
 
   virtual std::vector<Tensor> operator()(const std::vector<Tensor> &inputs) = 0;
 
+  // Stage the inputs of a coming call on the place of the engine, so that
+  // their copy overlaps the calls before. Nothing is done by default.
+  virtual void Prefetch(const std::vector<DenseTensor> &inputs) {}
+
   virtual std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) = 0;
 
   virtual ~BaseEngine() {}
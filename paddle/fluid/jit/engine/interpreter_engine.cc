@@ -31,7 +31,10 @@ InterpreterEngine::InterpreterEngine(
     const std::shared_ptr<FunctionInfo> &info,
     const std::shared_ptr<VariableMap> &params_dict,
     const phi::Place &place)
-    : info_(info), params_dict_(params_dict), place_(place) {
+    : info_(info),
+      params_dict_(params_dict),
+      place_(place),
+      prefetcher_(place) {
   info_->RemoveDescFeedFetch();
   PADDLE_ENFORCE_GT(
       static_cast<int64_t>(info_->ProgramDesc().Block(0).OpSize()),
@@ -82,11 +85,15 @@ std::vector<Tensor> InterpreterEngine::operator()(
 
 std::vector<DenseTensor> InterpreterEngine::operator()(
     const std::vector<DenseTensor> &inputs) {
-  utils::ShareIntoScope(info_->InputArgNames(), inputs, &scope_);
+  // the inputs are always given on the place, so the interpreter built on
+  // the first call serves all the batch sizes and places of the inputs
+  utils::ShareIntoScope(
+      info_->InputArgNames(), prefetcher_.Take(inputs), &scope_);
 
   // the latter can be moved to python side.
   auto &feed_names = info_->InputArgNames();
   paddle::framework::FetchList outs = inner_interpreter_->Run(feed_names);
+  prefetcher_.Release();
 
   std::vector<DenseTensor> outputs;
   utils::FetchOuts(info_->OutputArgNames(), scope_, &outputs);
@@ -95,6 +102,10 @@ std::vector<DenseTensor> InterpreterEngine::operator()(
   return outputs;
 }
 
+void InterpreterEngine::Prefetch(const std::vector<DenseTensor> &inputs) {
+  prefetcher_.Prefetch(inputs);
+}
+
 const std::shared_ptr<FunctionInfo> &InterpreterEngine::Info() const {
   return info_;
 }
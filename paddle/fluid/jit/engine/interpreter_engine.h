@@ -22,6 +22,7 @@
 #include "paddle/fluid/jit/engine/base_engine.h"
 #include "paddle/fluid/jit/function_schema.h"
 #include "paddle/fluid/jit/function_utils.h"
+#include "paddle/fluid/jit/input_prefetcher.h"
 
 namespace paddle {
 
@@ -48,6 +49,8 @@ class InterpreterEngine : public BaseEngine {
   std::vector<DenseTensor> operator()(
       const std::vector<DenseTensor> &inputs) override;
 
+  void Prefetch(const std::vector<DenseTensor> &inputs) override;
+
   const std::shared_ptr<FunctionInfo> &Info() const;
 
   std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) override;
@@ -59,6 +62,7 @@ class InterpreterEngine : public BaseEngine {
   phi::Place place_;
   std::shared_ptr<framework::InterpreterCore> inner_interpreter_;
   framework::ProgramDesc converted_prog_;
+  InputPrefetcher prefetcher_;
 };
 
 }  // namespace jit
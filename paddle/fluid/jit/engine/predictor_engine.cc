@@ -29,7 +29,8 @@ PredictorEngine::PredictorEngine(
     : info_(info),
       params_dict_(params_dict),
       scope_(new framework::Scope()),
-      place_(place) {
+      place_(place),
+      prefetcher_(place) {
   utils::ShareParamsIntoScope(info_->ParamNames(), params_dict_, scope_.get());
   VLOG(6) << framework::GenScopeTreeDebugInfo(scope_.get());
 
@@ -63,7 +64,8 @@ PredictorEngine::PredictorEngine(
       scope_(scope),
       place_(place),
       predictor_(std::dynamic_pointer_cast<AnalysisPredictor, PaddlePredictor>(
-          predictor)) {}
+          predictor)),
+      prefetcher_(place) {}
 
 std::unique_ptr<BaseEngine> PredictorEngine::Clone(void *stream) {
   auto *x =
@@ -74,7 +76,10 @@ std::unique_ptr<BaseEngine> PredictorEngine::Clone(void *stream) {
 std::vector<Tensor> PredictorEngine::operator()(
     const std::vector<Tensor> &inputs) {
   std::vector<Tensor> outputs;
-  predictor_->Run(inputs, &outputs);
+  predictor_->Run(
+      utils::ToTensors(prefetcher_.Take(utils::ToDenseTensors(inputs))),
+      &outputs);
+  prefetcher_.Release();
 
   return outputs;
 }
@@ -84,5 +89,9 @@ std::vector<DenseTensor> PredictorEngine::operator()(
   return utils::ToDenseTensors(this->operator()(utils::ToTensors(inputs)));
 }
 
+void PredictorEngine::Prefetch(const std::vector<DenseTensor> &inputs) {
+  prefetcher_.Prefetch(inputs);
+}
+
 }  // namespace jit
 }  // namespace paddle
@@ -17,6 +17,7 @@
 #include "paddle/fluid/jit/engine/base_engine.h"
 #include "paddle/fluid/jit/function_schema.h"
 #include "paddle/fluid/jit/function_utils.h"
+#include "paddle/fluid/jit/input_prefetcher.h"
 
 namespace paddle {
 class AnalysisPredictor;
@@ -46,6 +47,8 @@ class PredictorEngine : public BaseEngine {
   std::vector<DenseTensor> operator()(
       const std::vector<DenseTensor> &inputs) override;
 
+  void Prefetch(const std::vector<DenseTensor> &inputs) override;
+
   std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) override;
 
  private:
@@ -54,6 +57,7 @@ class PredictorEngine : public BaseEngine {
   std::shared_ptr<framework::Scope> scope_;
   phi::Place place_;
   std::shared_ptr<AnalysisPredictor> predictor_;
+  InputPrefetcher prefetcher_;
 };
 
 }  // namespace jit
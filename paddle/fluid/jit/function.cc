@@ -47,5 +47,17 @@ std::vector<DenseTensor> Function::operator()(
   return (*engine_)(inputs);
 }
 
+void Function::Prefetch(const std::vector<Tensor>& inputs) const {
+  this->Prefetch(utils::ToDenseTensors(inputs));
+}
+
+void Function::Prefetch(const std::vector<DenseTensor>& inputs) const {
+  PADDLE_ENFORCE_EQ(IsValid(),
+                    true,
+                    common::errors::PreconditionNotMet(
+                        "Function engine ptr is nullptr, please check it."));
+  engine_->Prefetch(inputs);
+}
+
 }  // namespace jit
 }  // namespace paddle
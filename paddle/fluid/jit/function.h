@@ -35,6 +35,12 @@ class Function {
   std::vector<DenseTensor> operator()(
       const std::vector<DenseTensor>& inputs) const;
 
+  // Stage the inputs of a coming call on the place of the function, so that
+  // their copy overlaps the calls before.
+  void Prefetch(const std::vector<Tensor>& inputs) const;
+
+  void Prefetch(const std::vector<DenseTensor>& inputs) const;
+
   bool IsValid() const { return engine_ != nullptr; }
 
   ~Function() = default;
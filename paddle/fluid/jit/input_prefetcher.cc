@@ -0,0 +1,197 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/jit/input_prefetcher.h"
+
+#include <cstring>
+
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
+#include "paddle/phi/core/tensor_utils.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/backends/gpu/gpu_types.h"
+#include "paddle/phi/core/cuda_stream.h"
+#endif
+
+namespace paddle::jit {
+
+static size_t DataSize(const DenseTensor &tensor) {
+  return tensor.numel() * phi::SizeOf(tensor.dtype());
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+static phi::GPUContext *GetGPUContext(const phi::Place &place) {
+  return static_cast<phi::GPUContext *>(
+      phi::DeviceContextPool::Instance().Get(place));
+}
+#endif
+
+InputPrefetcher::InputPrefetcher(const phi::Place &place) : place_(place) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!phi::is_gpu_place(place_)) {
+    return;
+  }
+  phi::backends::gpu::GPUDeviceGuard guard(place_.GetDeviceId());
+  copy_stream_ = std::make_unique<phi::CUDAStream>(
+      place_, 0, phi::CUDAStream::StreamFlag::kStreamNonBlocking);
+  for (auto &buffer : buffers_) {
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventCreateWithFlags(
+        &buffer.copied, phi::gpuEventDisableTiming));
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::gpuEventCreateWithFlags(&released_, phi::gpuEventDisableTiming));
+  // nothing to wait for before the first call
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::gpuEventRecord(released_, copy_stream_->raw_stream()));
+#endif
+}
+
+InputPrefetcher::~InputPrefetcher() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (copy_stream_ == nullptr) {
+    return;
+  }
+  // the pinned buffers must outlive the copies from them
+  copy_stream_->Synchronize();
+  for (auto &buffer : buffers_) {
+    phi::gpuEventDestroy(buffer.copied);
+  }
+  phi::gpuEventDestroy(released_);
+#endif
+}
+
+void InputPrefetcher::Prefetch(const std::vector<DenseTensor> &inputs) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (copy_stream_ == nullptr) {
+    return;
+  }
+  auto &buffer = buffers_[next_buffer_];
+  next_buffer_ = (next_buffer_ + 1) % buffers_.size();
+  // the pinned memory of the buffer is written by the host below
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventSynchronize(buffer.copied));
+  buffer.sources.clear();
+  buffer.staged.clear();
+
+  size_t pinned_size = 0;
+  for (const auto &input : inputs) {
+    if (input.initialized() && phi::is_cpu_place(input.place())) {
+      pinned_size += DataSize(input);
+    }
+  }
+  if (pinned_size > buffer.pinned_size) {
+    buffer.pinned = paddle::memory::Alloc(phi::GPUPinnedPlace(), pinned_size);
+    buffer.pinned_size = pinned_size;
+  }
+
+  auto *dev_ctx = GetGPUContext(place_);
+  const gpuStream_t stream = copy_stream_->raw_stream();
+  // the staged inputs may take the memory freed by the calls before
+  copy_stream_->WaitEvent(released_);
+  size_t pinned_offset = 0;
+  for (const auto &input : inputs) {
+    buffer.sources.push_back(input.initialized() ? input.data() : nullptr);
+    DenseTensor staged;
+    if (!input.initialized() || phi::is_gpu_place(input.place())) {
+      staged = input;
+    } else {
+      staged.Resize(input.dims());
+      staged.set_layout(input.layout());
+      dev_ctx->Alloc(&staged, input.dtype());
+      const void *src = input.data();
+      phi::Place src_place = input.place();
+      if (phi::is_cpu_place(src_place)) {
+        // a copy from pageable memory would block the host
+        auto *pinned =
+            static_cast<uint8_t *>(buffer.pinned->ptr()) + pinned_offset;
+        std::memcpy(pinned, src, DataSize(input));
+        pinned_offset += DataSize(input);
+        src = pinned;
+        src_place = phi::GPUPinnedPlace();
+      }
+      paddle::memory::Copy(place_,
+                           staged.data(),
+                           src_place,
+                           src,
+                           DataSize(input),
+                           stream);
+    }
+    buffer.staged.push_back(staged);
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventRecord(buffer.copied, stream));
+#endif
+}
+
+std::vector<DenseTensor> InputPrefetcher::Take(
+    const std::vector<DenseTensor> &inputs) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  for (auto &buffer : buffers_) {
+    if (buffer.sources.empty() || buffer.sources.size() != inputs.size()) {
+      continue;
+    }
+    bool match = true;
+    for (size_t i = 0; i < inputs.size() && match; ++i) {
+      const void *data = inputs[i].initialized() ? inputs[i].data() : nullptr;
+      match = data == buffer.sources[i] &&
+              inputs[i].dims() == buffer.staged[i].dims();
+    }
+    if (!match) {
+      continue;
+    }
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipStreamWaitEvent(GetGPUContext(place_)->stream(), buffer.copied, 0));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(
+        GetGPUContext(place_)->stream(), buffer.copied, 0));
+#endif
+    buffer.sources.clear();
+    std::vector<DenseTensor> staged;
+    staged.swap(buffer.staged);
+    return staged;
+  }
+#endif
+  std::vector<DenseTensor> outs;
+  outs.reserve(inputs.size());
+  for (const auto &input : inputs) {
+    if (!input.initialized() || input.place() == place_) {
+      outs.push_back(input);
+      continue;
+    }
+    // copied on the stream of the device side
+    auto *dev_ctx = phi::DeviceContextPool::Instance().Get(
+        phi::is_cpu_place(place_) ? input.place() : place_);
+    DenseTensor out;
+    phi::Copy(*dev_ctx, input, place_, phi::is_cpu_place(place_), &out);
+    outs.push_back(out);
+  }
+  return outs;
+}
+
+void InputPrefetcher::Release() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (copy_stream_ == nullptr) {
+    return;
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::gpuEventRecord(released_, GetGPUContext(place_)->stream()));
+#endif
+}
+
+}  // namespace paddle::jit
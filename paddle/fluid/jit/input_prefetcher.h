@@ -0,0 +1,94 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/allocator.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#endif
+
+namespace phi {
+class CUDAStream;
+}  // namespace phi
+
+namespace paddle {
+namespace jit {
+using DenseTensor = phi::DenseTensor;
+
+// Stages the inputs of the coming calls of an engine on its place, in two
+// buffers used in turn. On GPU the host inputs are copied through pinned
+// memory on a stream of their own, and the compute stream waits for them
+// only when the call taking them starts, so the copy of the next batch
+// overlaps the running one:
+//
+//   engine.Prefetch(batch[0]);
+//   for (size_t i = 0; i < n; ++i) {
+//     if (i + 1 < n) engine.Prefetch(batch[i + 1]);
+//     outs = engine(batch[i]);
+//   }
+//
+// Every call takes its inputs on the place, so the data transfers planned by
+// the executor of the engine on its first run hold for all the calls.
+class InputPrefetcher {
+ public:
+  explicit InputPrefetcher(const phi::Place &place);
+  ~InputPrefetcher();
+
+  // Start staging the inputs of a coming call, nothing is done on CPU.
+  void Prefetch(const std::vector<DenseTensor> &inputs);
+
+  // The inputs of a call on the place: the staged copies if they were
+  // prefetched, or copies made on the compute stream if they are on another
+  // place, or themselves.
+  std::vector<DenseTensor> Take(const std::vector<DenseTensor> &inputs);
+
+  // Mark the end of the call that took the inputs on the compute stream,
+  // the copies of the later prefetches wait for it.
+  void Release();
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(InputPrefetcher);
+
+  phi::Place place_;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  struct Buffer {
+    // the data of the inputs staged, to match the call taking them
+    std::vector<const void *> sources;
+    std::vector<DenseTensor> staged;
+    // reused across the prefetches once the last copy from it completes
+    phi::Allocator::AllocationPtr pinned;
+    size_t pinned_size{0};
+    gpuEvent_t copied{nullptr};
+  };
+
+  std::array<Buffer, 2> buffers_;
+  size_t next_buffer_{0};
+  std::unique_ptr<phi::CUDAStream> copy_stream_;
+  // recorded on the compute stream by Release
+  gpuEvent_t released_{nullptr};
+#endif
+};
+
+}  // namespace jit
+}  // namespace paddle
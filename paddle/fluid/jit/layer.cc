@@ -51,6 +51,14 @@ std::vector<DenseTensor> Layer::forward(
   return func(inputs);
 }
 
+void Layer::Prefetch(const std::vector<Tensor>& inputs) {
+  this->Function("forward").Prefetch(inputs);
+}
+
+void Layer::Prefetch(const std::vector<DenseTensor>& inputs) {
+  this->Function("forward").Prefetch(inputs);
+}
+
 void Layer::to(const phi::Place& place) {}
 
 void Layer::SetEngine(const std::string& name,
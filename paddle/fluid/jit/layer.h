@@ -57,6 +57,11 @@ class Layer {
 
   std::vector<DenseTensor> forward(const std::vector<DenseTensor>& inputs);
 
+  // Stage the inputs of a coming forward, see Function::Prefetch.
+  void Prefetch(const std::vector<Tensor>& inputs);
+
+  void Prefetch(const std::vector<DenseTensor>& inputs);
+
   void to(const phi::Place& place);
 
   void SetEngine(const std::string& name,
@@ -345,9 +345,11 @@ phi::KernelKey GetUniqueExpectedKernelType(
     const framework::ExecutionContext& ctx,
     const framework::OperatorWithKernel* op_ptr) {
   (void)ctx;
-  // Return CPUPlace when Attr("is_sorted") is false. Because it means
-  // that fluid.layers.unique is called, but there is no cuda kernel.
-  if (!ctx.Attr<bool>("is_sorted")) {
+  // Return CPUPlace when Attr("is_sorted") is false except on GPU. Because it
+  // means that fluid.layers.unique is called, which is implemented by the hash
+  // table on CPU and GPU, but not on the other devices.
+  if (!ctx.Attr<bool>("is_sorted") &&
+      ctx.GetPlace().GetType() != phi::AllocationType::GPU) {
     return phi::KernelKey(
         op_ptr->OperatorWithKernel::IndicateVarDataType(ctx, "X"),
         phi::CPUPlace());
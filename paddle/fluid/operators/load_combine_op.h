@@ -18,6 +18,7 @@ limitations under the License. */
 #include <string>
 #include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
@@ -26,6 +27,8 @@ limitations under the License. */
 #include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/platform/device_context.h"
 
+COMMON_DECLARE_bool(load_combine_use_mmap);
+
 namespace paddle {
 namespace operators {
 template <typename T, typename DeviceContext>
@@ -44,6 +47,16 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "The number of variables to be loaded is %d, expect "
                           "it to be greater than 0.",
                           out_var_names.size()));
+    if (!model_from_memory && FLAGS_load_combine_use_mmap) {
+      framework::MappedFileStreamBuf mapped(filename);
+      if (mapped.is_open()) {
+        VLOG(3) << "Load combined params from mapped file " << filename;
+        std::istream fin(&mapped);
+        LoadParamsFromBuffer(ctx, place, &fin, load_as_fp16, out_var_names);
+        return;
+      }
+      VLOG(3) << "Fail to map " << filename << ", fall back to ifstream.";
+    }
     if (!model_from_memory) {
       std::ifstream fin(filename, std::ios::binary);
       PADDLE_ENFORCE_EQ(
@@ -23,9 +23,48 @@
 #include "paddle/phi/backends/device_manager.h"
 #include "paddle/phi/common/memory_utils.h"
 
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/memory/allocation/mmap_allocator.h"
+
+COMMON_DECLARE_bool(use_shm_cache);
+COMMON_DECLARE_bool(pin_shm_cache);
+#endif
+
 namespace paddle {
 namespace operators {
 namespace reader {
+
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+// Whether t is in a cached shm file of the DataLoader workers, which is
+// page-locked for the device copies, see FLAGS_pin_shm_cache.
+static bool IsPageLockedSharedMemory(const phi::DenseTensor &t) {
+  if (!FLAGS_use_shm_cache || !FLAGS_pin_shm_cache || !t.IsInitialized()) {
+    return false;
+  }
+  auto *mmap_allocation =
+      dynamic_cast<memory::allocation::RefcountedMemoryMapAllocation *>(
+          t.Holder().get());
+  if (mmap_allocation == nullptr || mmap_allocation->buffer_id() == -1) {
+    return false;
+  }
+  return memory::allocation::MemoryMapAllocationPool::Instance()
+      .RegisterHostMemory(mmap_allocation->buffer_id());
+}
+
+// A pinned view of a page-locked shm, which keeps the shm referenced, so the
+// workers do not reuse it while the view is alive.
+class PageLockedSharedMemoryAllocation : public phi::Allocation {
+ public:
+  explicit PageLockedSharedMemoryAllocation(
+      std::shared_ptr<phi::Allocation> shm)
+      : phi::Allocation(shm->ptr(), shm->size(), phi::GPUPinnedPlace()),
+        shm_(std::move(shm)) {}
+
+ private:
+  std::shared_ptr<phi::Allocation> shm_;
+};
+#endif
 BufferedReader::~BufferedReader() {
   VLOG(1) << "~BufferedReader";
   reader_->Shutdown();
@@ -157,6 +196,16 @@ void BufferedReader::ReadAsync(size_t i) {
         // If we don't set Device here, which will use CUDAPlace(0) default.
         platform::SetDeviceId(place_.device);
         for (size_t i = 0; i < cpu.size(); ++i) {
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+          if (IsPageLockedSharedMemory(cpu[i])) {
+            // the shm is already page-locked, so it is handed out as is
+            cuda[i].ShareDataWith(cpu[i]);
+            cuda[i].ResetHolder(
+                std::make_shared<PageLockedSharedMemoryAllocation>(
+                    cpu[i].Holder()));
+            continue;
+          }
+#endif
           if (cpu[i].place().GetType() == phi::AllocationType::CPU) {
             cuda[i].Resize(cpu[i].dims());
             cuda[i].set_layout(cpu[i].layout());
@@ -219,6 +268,17 @@ void BufferedReader::ReadAsync(size_t i) {
               cpu_place.GetType() == phi::AllocationType::GPU) {
             phi::memory_utils::Copy(
                 place_, gpu_ptr, cpu_place, cpu_ptr, size, stream_.get());
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+          } else if (IsPageLockedSharedMemory(cpu[i])) {
+            // copied asynchronously, cpu[i] is kept until the stream is
+            // synchronized below
+            phi::memory_utils::Copy(place_,
+                                    gpu_ptr,
+                                    phi::GPUPinnedPlace(),
+                                    cpu_ptr,
+                                    size,
+                                    stream_.get());
+#endif
           } else {
             phi::GPUPinnedPlace cuda_pinned_place;
             phi::DenseTensor cuda_pinned_tensor;
@@ -99,7 +99,27 @@ void BasicTokenizer::Tokenize(const string& text, vector<wstring>* res) const {
     }
   };
   for (auto& ch : unicode_text) {
-    if (ch == 0 || ch == 0xfffd || IsControl(ch)) {
+    // ASCII is classified without the lookups of utf8proc
+    if (ch < 0x80) {
+      if (ch == 0x7F || (ch < 0x20 && ch != L'\t' && ch != L'\n' &&
+                         ch != L'\r')) {
+        continue;
+      }
+      if (do_lower_case_ && ch >= L'A' && ch <= L'Z') {
+        ch += L'a' - L'A';
+      }
+      if ((ch >= 33 && ch <= 47) || (ch >= 58 && ch <= 64) ||
+          (ch >= 91 && ch <= 96) || (ch >= 123 && ch <= 126)) {
+        PushCacheText();
+        res->emplace_back(std::wstring{ch});
+      } else if (ch == L' ' || ch == L'\t' || ch == L'\n' || ch == L'\r') {
+        PushCacheText();
+      } else {
+        cache_text += ch;
+      }
+      continue;
+    }
+    if (ch == 0xfffd || IsControl(ch)) {
       continue;
     }
     if (do_lower_case_) {
@@ -143,25 +163,26 @@ void WordPieceTokenizer::Tokenize(const wstring& text,
 
   size_t start = 0;
   vector<int64_t> wordpiece_ids;
+  // the candidate pieces are built in one buffer, longest first
+  std::wstring sub;
+  sub.reserve(len + 2);
   while (start < len) {
     size_t end = len;
-    std::wstring cur_substr;
+    bool found = false;
     int64_t cur_substr_id = 0;
     while (start < end) {
-      std::wstring sub = text.substr(start, end - start);
-      if (start > 0) {
-        sub.insert(0, L"##");
-      }
+      sub.assign(start > 0 ? L"##" : L"");
+      sub.append(text, start, end - start);
       auto it = vocab_->find(sub);
       if (it != vocab_->end()) {
-        cur_substr = sub;
+        found = true;
         cur_substr_id = it->second;
         break;
       }
       end -= 1;
     }
 
-    if (cur_substr.empty()) {
+    if (!found) {
       token_ids->emplace_back(unk_token_id_);
       return;
     } else {
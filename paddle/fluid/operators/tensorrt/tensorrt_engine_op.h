@@ -16,6 +16,7 @@
 
 #ifdef PADDLE_WITH_CUDA
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -175,6 +176,10 @@ class TensorRTEngineOp : public framework::OperatorBase {
   std::string model_opt_cache_dir_;
   bool use_static_engine_;
   phi::DataType precision_mode_;
+  inference::tensorrt::CalibrationAlgorithm calibration_algorithm_{
+      inference::tensorrt::CalibrationAlgorithm::kEntropy2};
+  double calibration_percentile_{99.99};
+  int calibration_batch_queue_size_{1};
 
  public:
   TensorRTEngineOp(const std::string &type,
@@ -200,6 +205,17 @@ class TensorRTEngineOp : public framework::OperatorBase {
     if (use_static_engine_) {
       model_opt_cache_dir_ = Attr<std::string>("model_opt_cache_dir");
     }
+    if (HasAttr("calibration_algorithm")) {
+      calibration_algorithm_ =
+          static_cast<inference::tensorrt::CalibrationAlgorithm>(
+              Attr<int>("calibration_algorithm"));
+    }
+    if (HasAttr("calibration_percentile")) {
+      calibration_percentile_ = Attr<float>("calibration_percentile");
+    }
+    if (HasAttr("calibration_batch_queue_size")) {
+      calibration_batch_queue_size_ = Attr<int>("calibration_batch_queue_size");
+    }
 
     auto params = Attr<std::vector<std::string>>("parameters");
     for (const auto &param : params) {
@@ -216,7 +232,8 @@ class TensorRTEngineOp : public framework::OperatorBase {
 
     VLOG(4) << "calibration_mode: " << calibration_mode_;
     if (enable_int8_ && !calibration_data_.empty()) {
-      calibrator_ = std::make_unique<TRTInt8Calibrator>(calibration_data_);
+      calibrator_ = std::make_unique<TRTInt8Calibrator>(
+          calibration_data_, calibration_algorithm_, calibration_percentile_);
     }
     bool has_engine =
         inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
@@ -455,8 +472,14 @@ class TensorRTEngineOp : public framework::OperatorBase {
         auto t_shape = common::vectorize(t.dims());
         runtime_batch = t_shape[0];
       }
-      calib_res->calib_ = std::make_unique<TRTInt8Calibrator>(
-          calib_buffers, runtime_batch, calibration_engine_key_, dev_place);
+      calib_res->calib_ =
+          std::make_unique<TRTInt8Calibrator>(calib_buffers,
+                                              runtime_batch,
+                                              calibration_engine_key_,
+                                              dev_place,
+                                              calibration_algorithm_,
+                                              calibration_percentile_,
+                                              calibration_batch_queue_size_);
       calib_res->thr_.reset(new std::thread([&]() {
         TensorRTEngine::ConstructionParams params;
         params.max_batch_size = max_batch_size_;
@@ -517,6 +540,16 @@ class TensorRTEngineOp : public framework::OperatorBase {
     if (engine->with_dynamic_shape()) {
       // Initialize context and get offset by profile index
       trt_context = engine->context();
+      if (engine->with_shape_buckets()) {
+        std::map<std::string, std::vector<int>> input_shapes;
+        for (const auto &x : runtime_input_names_) {
+          auto &t =
+              inference::analysis::GetFromScope<phi::DenseTensor>(scope, x);
+          input_shapes[x.substr(0, x.find("_cast_auto_mixed.tmp_"))] =
+              common::vectorize<int>(t.dims());
+        }
+        engine->SelectShapeProfile(trt_context, input_shapes, stream);
+      }
       binding_offset = engine->GetBindingsOffset();
     }
     // Bind input tensor to TRT.
@@ -949,6 +982,9 @@ class TensorRTEngineOp : public framework::OperatorBase {
       if (HasAttr("optimization_level")) {
         params.optimization_level = Attr<int>("optimization_level");
       }
+      if (HasAttr("timing_cache_path")) {
+        params.timing_cache_path = Attr<std::string>("timing_cache_path");
+      }
       if (!shape_range_info_path_.empty()) {
         inference::DeserializeShapeRangeInfo(shape_range_info_path_,
                                              &params.min_input_shape,
@@ -957,6 +993,11 @@ class TensorRTEngineOp : public framework::OperatorBase {
                                              &params.min_shape_tensor,
                                              &params.max_shape_tensor,
                                              &params.optim_shape_tensor);
+        inference::DeserializeShapeRangeBuckets(
+            shape_range_info_path_,
+            &params.min_input_shape_buckets,
+            &params.max_input_shape_buckets,
+            &params.optim_input_shape_buckets);
       } else {
         if (HasAttr("dynamic_shape_names") &&
             HasAttr("min_input_shape_vector") &&
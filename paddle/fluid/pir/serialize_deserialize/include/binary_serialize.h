@@ -0,0 +1,60 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "paddle/fluid/pir/serialize_deserialize/include/third_party.h"
+#include "paddle/pir/include/core/dll_decl.h"
+
+namespace pir {
+/**
+ * The binary model file is a compact encoding of the same json object which
+ * is written by WriteModule, so the deserialization and the version
+ * compatibility patches work on it unchanged.
+ *
+ * Layout (little endian, every section is 8 bytes aligned):
+ *
+ *   header  : magic "PIRB", uint32 format version, then the uint64 offsets
+ *             and sizes of the sections below.
+ *   strings : uint64 offsets of every interned string followed by the
+ *             string bytes, so a string can be read in place from a mapped
+ *             file. All the keys and string values are interned.
+ *   values  : uint64 offsets of every interned type/attribute object
+ *             followed by their encodings. An interned value only refers to
+ *             the strings and the values before it.
+ *   body    : the encoding of the json object.
+ *
+ * A value is encoded as a one byte tag followed by its payload, all the
+ * integers (string/value ids, array and object sizes, json integers) are
+ * LEB128 varints.
+ */
+
+#define BINARY_MAGIC "PIRB"
+
+// The version of the binary layout above, which is independent of the
+// pir_version of the program stored in it.
+constexpr uint32_t kBinaryFormatVersion = 1;
+
+/** IsBinaryModule returns whether the buffer starts with BINARY_MAGIC. */
+bool IR_API IsBinaryModule(const char* data, size_t size);
+
+/** WriteBinaryJson encodes the json object of a model file. */
+std::string IR_API WriteBinaryJson(const Json& json);
+
+/** ReadBinaryJson decodes the json object of a binary model file. */
+Json IR_API ReadBinaryJson(const char* data, size_t size);
+
+}  // namespace pir
@@ -62,4 +62,11 @@ class PatchBuilder {
   Json patch_json;
 };
 
+/**
+ * Check that the binary model file written in `file_format_version` (see
+ * binary_serialize.h) can be decoded. The program decoded from it is then
+ * patched by PatchBuilder according to its pir_version like a json one.
+ */
+void IR_API CheckBinaryFormatVersion(const uint32_t file_format_version);
+
 }  // namespace pir
@@ -0,0 +1,390 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
+
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/schema.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/version_compat.h"
+
+namespace pir {
+namespace {
+
+enum BinaryTag : uint8_t {
+  kNull = 0,
+  kFalse = 1,
+  kTrue = 2,
+  // non negative int64 stored as is, negative x stored as -(x + 1)
+  kInteger = 3,
+  kNegativeInteger = 4,
+  kUnsigned = 5,
+  kFloat = 6,
+  kString = 7,
+  kArray = 8,
+  kObject = 9,
+  kValueRef = 10,
+};
+
+struct BinaryHeader {
+  char magic[4];
+  uint32_t format_version;
+  uint64_t string_num;
+  uint64_t string_offset;
+  uint64_t value_num;
+  uint64_t value_offset;
+  uint64_t body_offset;
+  uint64_t body_size;
+};
+static_assert(sizeof(BinaryHeader) % sizeof(uint64_t) == 0,
+              "BinaryHeader should keep the sections 8 bytes aligned.");
+
+void WriteVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// Types and attributes are written as {ID: name} or {ID: name, DATA: data},
+// see serialize_utils.h.
+bool IsTypeOrAttribute(const Json& json) {
+  if (!json.contains(ID) || !json.at(ID).is_string()) {
+    return false;
+  }
+  for (auto it = json.begin(); it != json.end(); ++it) {
+    if (it.key() != ID && it.key() != DATA) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class BinaryWriter {
+ public:
+  std::string Write(const Json& json) {
+    std::string body;
+    WriteValue(json, &body);
+
+    BinaryHeader header;
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.format_version = kBinaryFormatVersion;
+    std::string file(sizeof(BinaryHeader), '\0');
+    header.string_num = strings_.size();
+    header.string_offset = file.size();
+    AppendTable(strings_, &file);
+    header.value_num = values_.size();
+    header.value_offset = file.size();
+    AppendTable(values_, &file);
+    header.body_offset = file.size();
+    header.body_size = body.size();
+    file.append(body);
+    std::memcpy(&file[0], &header, sizeof(header));
+    VLOG(6) << "Write binary json with " << strings_.size() << " strings and "
+            << values_.size() << " types/attributes, " << file.size()
+            << " bytes in total.";
+    return file;
+  }
+
+ private:
+  static uint64_t Intern(std::string str,
+                         std::unordered_map<std::string, uint64_t>* ids,
+                         std::vector<const std::string*>* table) {
+    auto [iter, inserted] = ids->emplace(std::move(str), table->size());
+    if (inserted) {
+      table->push_back(&iter->first);
+    }
+    return iter->second;
+  }
+
+  // The table is the offsets of its entries followed by the entries.
+  static void AppendTable(const std::vector<const std::string*>& table,
+                          std::string* file) {
+    std::vector<uint64_t> offsets{0};
+    for (const auto* entry : table) {
+      offsets.push_back(offsets.back() + entry->size());
+    }
+    file->append(reinterpret_cast<const char*>(offsets.data()),
+                 offsets.size() * sizeof(uint64_t));
+    for (const auto* entry : table) {
+      file->append(*entry);
+    }
+    const size_t aligned = (file->size() + sizeof(uint64_t) - 1) /
+                           sizeof(uint64_t) * sizeof(uint64_t);
+    file->resize(aligned, '\0');
+  }
+
+  void WriteObject(const Json& json, std::string* out) {
+    out->push_back(kObject);
+    WriteVarint(json.size(), out);
+    for (auto it = json.begin(); it != json.end(); ++it) {
+      WriteVarint(Intern(it.key(), &string_ids_, &strings_), out);
+      WriteValue(it.value(), out);
+    }
+  }
+
+  void WriteValue(const Json& json, std::string* out) {
+    switch (json.type()) {
+      case Json::value_t::null:
+        out->push_back(kNull);
+        break;
+      case Json::value_t::boolean:
+        out->push_back(json.get<bool>() ? kTrue : kFalse);
+        break;
+      case Json::value_t::number_integer: {
+        const int64_t value = json.get<int64_t>();
+        if (value >= 0) {
+          out->push_back(kInteger);
+          WriteVarint(static_cast<uint64_t>(value), out);
+        } else {
+          out->push_back(kNegativeInteger);
+          WriteVarint(static_cast<uint64_t>(-(value + 1)), out);
+        }
+        break;
+      }
+      case Json::value_t::number_unsigned:
+        out->push_back(kUnsigned);
+        WriteVarint(json.get<uint64_t>(), out);
+        break;
+      case Json::value_t::number_float: {
+        const double value = json.get<double>();
+        out->push_back(kFloat);
+        out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+        break;
+      }
+      case Json::value_t::string:
+        out->push_back(kString);
+        WriteVarint(Intern(json.get<std::string>(), &string_ids_, &strings_),
+                    out);
+        break;
+      case Json::value_t::array:
+        out->push_back(kArray);
+        WriteVarint(json.size(), out);
+        for (const auto& item : json) {
+          WriteValue(item, out);
+        }
+        break;
+      case Json::value_t::object:
+        if (IsTypeOrAttribute(json)) {
+          // The nested types/attributes are interned before the outer one,
+          // so an interned value only refers to the values before it.
+          std::string encoded;
+          WriteObject(json, &encoded);
+          out->push_back(kValueRef);
+          WriteVarint(Intern(std::move(encoded), &value_ids_, &values_), out);
+        } else {
+          WriteObject(json, out);
+        }
+        break;
+      default:
+        PADDLE_THROW(common::errors::Unimplemented(
+            "Json value of type %s can't be written in binary format.",
+            json.type_name()));
+    }
+  }
+
+  std::unordered_map<std::string, uint64_t> string_ids_;
+  std::vector<const std::string*> strings_;
+  std::unordered_map<std::string, uint64_t> value_ids_;
+  std::vector<const std::string*> values_;
+};
+
+class BinaryReader {
+ public:
+  BinaryReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  Json Read() {
+    PADDLE_ENFORCE_GE(size_,
+                      sizeof(BinaryHeader),
+                      common::errors::InvalidArgument(
+                          "The binary model file is truncated."));
+    BinaryHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    PADDLE_ENFORCE_EQ(IsBinaryModule(data_, size_),
+                      true,
+                      common::errors::InvalidArgument("Invalid model file."));
+    CheckBinaryFormatVersion(header.format_version);
+
+    strings_ = ReadTable(header.string_offset, header.string_num);
+    const auto& encoded_values =
+        ReadTable(header.value_offset, header.value_num);
+    values_.reserve(encoded_values.size());
+    for (const auto& encoded : encoded_values) {
+      const char* pos = encoded.data();
+      values_.push_back(ReadValue(&pos, encoded.data() + encoded.size()));
+    }
+
+    CheckRange(header.body_offset, header.body_size);
+    const char* pos = data_ + header.body_offset;
+    return ReadValue(&pos, pos + header.body_size);
+  }
+
+ private:
+  void CheckRange(uint64_t offset, uint64_t length) const {
+    PADDLE_ENFORCE_EQ(offset <= size_ && length <= size_ - offset,
+                      true,
+                      common::errors::InvalidArgument(
+                          "The binary model file is truncated, expect %d "
+                          "bytes at offset %d but the file has %d bytes.",
+                          length,
+                          offset,
+                          size_));
+  }
+
+  static void CheckNotEnd(const char* pos, const char* end) {
+    PADDLE_ENFORCE_EQ(pos < end,
+                      true,
+                      common::errors::InvalidArgument(
+                          "Unexpected end of the binary model file."));
+  }
+
+  std::vector<std::string_view> ReadTable(uint64_t offset,
+                                          uint64_t num) const {
+    PADDLE_ENFORCE_LT(num,
+                      size_ / sizeof(uint64_t),
+                      common::errors::InvalidArgument(
+                          "Invalid table size %d in the binary model file.",
+                          num));
+    const uint64_t offsets_size = (num + 1) * sizeof(uint64_t);
+    CheckRange(offset, offsets_size);
+    std::vector<uint64_t> offsets(num + 1);
+    std::memcpy(offsets.data(), data_ + offset, offsets_size);
+    const uint64_t entries_offset = offset + offsets_size;
+    CheckRange(entries_offset, offsets.back());
+
+    std::vector<std::string_view> table;
+    table.reserve(num);
+    for (uint64_t i = 0; i < num; ++i) {
+      PADDLE_ENFORCE_LE(offsets[i],
+                        offsets[i + 1],
+                        common::errors::InvalidArgument(
+                            "Invalid table offsets in the binary model file."));
+      table.emplace_back(data_ + entries_offset + offsets[i],
+                         offsets[i + 1] - offsets[i]);
+    }
+    return table;
+  }
+
+  static uint64_t ReadVarint(const char** pos, const char* end) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      CheckNotEnd(*pos, end);
+      const uint8_t byte = static_cast<uint8_t>(*(*pos)++);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "Invalid varint in the binary model file."));
+  }
+
+  std::string ReadString(const char** pos, const char* end) const {
+    const uint64_t id = ReadVarint(pos, end);
+    PADDLE_ENFORCE_LT(id,
+                      strings_.size(),
+                      common::errors::InvalidArgument(
+                          "Invalid string id %d in the binary model file.",
+                          id));
+    return std::string(strings_[id]);
+  }
+
+  Json ReadValue(const char** pos, const char* end) const {
+    CheckNotEnd(*pos, end);
+    const uint8_t tag = static_cast<uint8_t>(*(*pos)++);
+    switch (tag) {
+      case kNull:
+        return Json();
+      case kFalse:
+        return Json(false);
+      case kTrue:
+        return Json(true);
+      case kInteger:
+        return Json(static_cast<int64_t>(ReadVarint(pos, end)));
+      case kNegativeInteger:
+        return Json(-static_cast<int64_t>(ReadVarint(pos, end)) - 1);
+      case kUnsigned:
+        return Json(ReadVarint(pos, end));
+      case kFloat: {
+        PADDLE_ENFORCE_GE(end - *pos,
+                          static_cast<int64_t>(sizeof(double)),
+                          common::errors::InvalidArgument(
+                              "Unexpected end of the binary model file."));
+        double value;
+        std::memcpy(&value, *pos, sizeof(value));
+        *pos += sizeof(value);
+        return Json(value);
+      }
+      case kString:
+        return Json(ReadString(pos, end));
+      case kArray: {
+        const uint64_t size = ReadVarint(pos, end);
+        Json json = Json::array();
+        for (uint64_t i = 0; i < size; ++i) {
+          json.push_back(ReadValue(pos, end));
+        }
+        return json;
+      }
+      case kObject: {
+        const uint64_t size = ReadVarint(pos, end);
+        Json json = Json::object();
+        for (uint64_t i = 0; i < size; ++i) {
+          std::string key = ReadString(pos, end);
+          json[std::move(key)] = ReadValue(pos, end);
+        }
+        return json;
+      }
+      case kValueRef: {
+        const uint64_t id = ReadVarint(pos, end);
+        PADDLE_ENFORCE_LT(id,
+                          values_.size(),
+                          common::errors::InvalidArgument(
+                              "Invalid type/attribute id %d in the binary "
+                              "model file.",
+                              id));
+        return values_[id];
+      }
+      default:
+        PADDLE_THROW(common::errors::InvalidArgument(
+            "Invalid tag %d in the binary model file.", tag));
+    }
+  }
+
+  const char* data_;
+  size_t size_;
+  std::vector<std::string_view> strings_;
+  std::vector<Json> values_;
+};
+
+}  // namespace
+
+bool IsBinaryModule(const char* data, size_t size) {
+  const size_t magic_size = sizeof(BINARY_MAGIC) - 1;
+  return size >= magic_size && std::memcmp(data, BINARY_MAGIC, magic_size) == 0;
+}
+
+std::string WriteBinaryJson(const Json& json) {
+  return BinaryWriter().Write(json);
+}
+
+Json ReadBinaryJson(const char* data, size_t size) {
+  return BinaryReader(data, size).Read();
+}
+
+}  // namespace pir
@@ -14,7 +14,9 @@
 
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include <stdio.h>
+#include <iterator>
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_serialize.h"
 #include "paddle/phi/common/port.h"
@@ -31,7 +33,8 @@ void WriteModule(const pir::Program& program,
                  const uint64_t& pir_version,
                  bool overwrite,
                  bool readable,
-                 bool trainable) {
+                 bool trainable,
+                 bool binary) {
   PADDLE_ENFORCE_EQ(
       FileExists(file_path) && !overwrite,
       false,
@@ -50,7 +53,9 @@ void WriteModule(const pir::Program& program,
   // write program
   total[PROGRAM] = writer.GetProgramJson(&program);
   std::string total_str;
-  if (readable) {
+  if (binary) {
+    total_str = WriteBinaryJson(total);
+  } else if (readable) {
     total_str = total.dump(4);
   } else {
     total_str = total.dump();
@@ -69,8 +74,16 @@ void WriteModule(const pir::Program& program,
 bool ReadModule(const std::string& file_path,
                 pir::Program* program,
                 const uint64_t& pir_version) {
-  std::ifstream f(file_path);
-  Json data = Json::parse(f);
+  std::ifstream f(file_path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(f),
+                    true,
+                    common::errors::Unavailable(
+                        "Cannot open %s to load the program.", file_path));
+  const std::string buffer((std::istreambuf_iterator<char>(f)),
+                           std::istreambuf_iterator<char>());
+  Json data = IsBinaryModule(buffer.data(), buffer.size())
+                  ? ReadBinaryJson(buffer.data(), buffer.size())
+                  : Json::parse(buffer);
   PatchBuilder builder(pir_version);
 
   if (data.contains(BASE_CODE) && data[BASE_CODE].contains(MAGIC) &&
@@ -11,14 +11,18 @@ limitations under the License. */
 
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <numeric>
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include "paddle/phi/common/port.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
 
+COMMON_DECLARE_bool(load_combine_use_mmap);
+
 namespace pir {
 
 const phi::DeviceContext* GetDeviceContext(
@@ -191,8 +195,23 @@ void LoadCombineFunction(const std::string& file_path,
                          std::vector<phi::DenseTensor*>* out,
                          bool load_as_fp16,
                          phi::Place place) {
-  std::ifstream fin(file_path, std::ios::binary);
-  PADDLE_ENFORCE_EQ(static_cast<bool>(fin),
+  std::unique_ptr<paddle::framework::MappedFileStreamBuf> mapped;
+  if (FLAGS_load_combine_use_mmap) {
+    mapped =
+        std::make_unique<paddle::framework::MappedFileStreamBuf>(file_path);
+    if (!mapped->is_open()) {
+      VLOG(3) << "Fail to map " << file_path << ", fall back to ifstream.";
+      mapped.reset();
+    }
+  }
+  std::ifstream file_fin;
+  if (mapped == nullptr) {
+    file_fin.open(file_path, std::ios::binary);
+  }
+  std::istream fin(mapped != nullptr
+                       ? static_cast<std::streambuf*>(mapped.get())
+                       : file_fin.rdbuf());
+  PADDLE_ENFORCE_EQ(mapped != nullptr || static_cast<bool>(file_fin),
                     true,
                     common::errors::Unavailable(
                         "Load operator fail to open file %s, please check "
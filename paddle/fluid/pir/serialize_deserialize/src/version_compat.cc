@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/pir/serialize_deserialize/include/version_compat.h"
 #include <fstream>
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/patch_util.h"
 
 namespace pir {
@@ -124,4 +126,18 @@ void PatchBuilder::ApplyAttrTypePatches(const std::string& attr_name,
     json->at(ID) = patch["NEW_NAME"];
   }
 }
+
+void CheckBinaryFormatVersion(const uint32_t file_format_version) {
+  // Every format version up to the current one can be decoded, the newer
+  // ones are written by a newer paddle.
+  PADDLE_ENFORCE_EQ(
+      file_format_version >= 1 && file_format_version <= kBinaryFormatVersion,
+      true,
+      common::errors::Unimplemented(
+          "The binary model file is written in format version %d, which is "
+          "not supported by the current format version %d. Please upgrade "
+          "paddle or save the model in json format.",
+          file_format_version,
+          kBinaryFormatVersion));
+}
 }  // namespace pir
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/pir/transforms/general/constant_folding_pass.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -30,6 +31,7 @@
 #include "paddle/fluid/pir/utils/general_functions.h"
 
 #include "paddle/common/errors.h"
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
@@ -50,6 +52,8 @@
 #include "paddle/pir/include/pattern_rewrite/pattern_match.h"
 #include "paddle/pir/include/pattern_rewrite/pattern_rewrite_driver.h"
 
+COMMON_DECLARE_int32(pir_constant_folding_batch_size);
+
 namespace {
 
 class ConstantFoldingPattern : public pir::RewritePattern {
@@ -162,8 +166,42 @@ class ConstantFoldingPattern : public pir::RewritePattern {
                pir::PatternRewriter& rewriter) const override {  // NOLINT
     VLOG(4) << "constant_folding_pass applies rewrite on [" << op->name()
             << "] op";
-    auto output_var_names = RunOp(op, rewriter);
+    auto output_var_names = RunOps({op}, rewriter).front();
+    ReplaceResults(op, output_var_names, rewriter);
+    VLOG(4) << "constant_folding_pass applied rewrite on [" << op->name()
+            << "] op";
+  }
+
+  // Execute the copies of the given ops in one program, and return the names
+  // of the output vars of each op. The ops must not depend on each other.
+  std::vector<std::vector<std::string>> RunOps(
+      const std::vector<pir::Operation*>& ops,
+      pir::PatternRewriter& rewriter) const {  // NOLINT
+    pir::Program new_program(rewriter.ir_context());
+    std::vector<std::vector<std::string>> output_var_names;
+    for (auto* op : ops) {
+      output_var_names.push_back(
+          BuildProgramFromOperation(op, &new_program, rewriter));
+    }
+
+    // execute program
+    for (const auto& names : output_var_names) {
+      exe_config_->skip_gc_vars.insert(names.begin(), names.end());
+    }
+    auto kernel_program =
+        paddle::dialect::PdOpLowerToKernelPass(&new_program, place_);
+    paddle::framework::InterpreterCore core(
+        place_, {}, kernel_program->block(), scope_, *exe_config_);
 
+    core.Run({});
+    return output_var_names;
+  }
+
+  // Replace the results of the op by the folded vars and erase it.
+  virtual void ReplaceResults(
+      pir::Operation* op,
+      const std::vector<std::string>& output_var_names,
+      pir::PatternRewriter& rewriter) const {  // NOLINT
     // ParameterOp and ConstantTensorOp should be created in the top-level block
     rewriter.SetInsertionPointToStart(
         rewriter.block()->parent_program()->block());
@@ -235,8 +273,6 @@ class ConstantFoldingPattern : public pir::RewritePattern {
       scope_->EraseVars(deleted_vars_);
       deleted_vars_.clear();
     }
-    VLOG(4) << "constant_folding_pass applied rewrite on [" << op->name()
-            << "] op";
   }
 
  private:
@@ -276,26 +312,6 @@ class ConstantFoldingPattern : public pir::RewritePattern {
   }
 
  protected:
-  std::vector<std::string> RunOp(
-      pir::Operation* op,
-      pir::PatternRewriter& rewriter) const {  // NOLINT
-    pir::Program new_program(rewriter.ir_context());
-    auto output_var_names =
-        BuildProgramFromOperation(op, &new_program, rewriter);
-
-    // execute program
-    for (const auto& output_var_name : output_var_names) {
-      exe_config_->skip_gc_vars.insert(output_var_name);
-    }
-    auto kernel_program =
-        paddle::dialect::PdOpLowerToKernelPass(&new_program, place_);
-    paddle::framework::InterpreterCore core(
-        place_, {}, kernel_program->block(), scope_, *exe_config_);
-
-    core.Run({});
-    return output_var_names;
-  }
-
   template <typename Op>
   Op BuildParameterOrConstantTensorOP(
       uint32_t index,
@@ -436,13 +452,13 @@ class ConstantFoldingPatternForTrain : public ConstantFoldingPattern {
     return true;
   }
 
-  void Rewrite(pir::Operation* op,
-               pir::PatternRewriter& rewriter) const override {  // NOLINT
+  void ReplaceResults(
+      pir::Operation* op,
+      const std::vector<std::string>& output_var_names,
+      pir::PatternRewriter& rewriter) const override {  // NOLINT
     VLOG(4) << "constant_folding_pass for train applies rewrite on ["
             << op->name() << "] op";
 
-    auto output_var_names = RunOp(op, rewriter);
-
     // ConstantTensorOp should be created in the top-level block
     rewriter.SetInsertionPointToStart(
         rewriter.block()->parent_program()->block());
@@ -497,16 +513,21 @@ class ConstantFoldingPass : public pir::Pass {
     PADDLE_ENFORCE_NOT_NULL(
         scope_, common::errors::InvalidArgument("scope can not be nullptr"));
 
-    pir::RewritePatternSet ps(context);
-
+    std::unique_ptr<ConstantFoldingPattern> pattern;
     if (Has("train_mode") && Get<bool>("train_mode")) {
-      ps.Add<ConstantFoldingPatternForTrain>(
+      pattern = std::make_unique<ConstantFoldingPatternForTrain>(
           context, &suffix_, phi::CPUPlace{}, scope_, &exe_config_);
     } else {
-      ps.Add<ConstantFoldingPattern>(
+      pattern = std::make_unique<ConstantFoldingPattern>(
           context, &suffix_, place_, scope_, &exe_config_);
     }
-    patterns_ = pir::FrozenRewritePatternSet(std::move(ps));
+    if (FLAGS_pir_constant_folding_batch_size > 0) {
+      batch_pattern_ = std::move(pattern);
+    } else {
+      pir::RewritePatternSet ps(context);
+      ps.Add(std::move(pattern));
+      patterns_ = pir::FrozenRewritePatternSet(std::move(ps));
+    }
     return true;
   }
 
@@ -518,6 +539,10 @@ class ConstantFoldingPass : public pir::Pass {
         num_ops += block.size();
       }
     }
+    if (batch_pattern_) {
+      AddStatistics(RunBatched(op), num_ops);
+      return;
+    }
     pir::GreedyRewriteConfig cfg;
     cfg.use_top_down_traversal = true;
     cfg.max_iterations = 10;
@@ -525,13 +550,63 @@ class ConstantFoldingPass : public pir::Pass {
     AddStatistics(num_rewrites, num_ops);
   }
 
+  // Fold the ops level by level. The ops matched together only take the
+  // parameters and constants as inputs, so they are independent of each other
+  // and executed in one program by one interpreter, whose thread pool runs
+  // them concurrently. Their results are the inputs of the next level.
+  int64_t RunBatched(pir::Operation* op) {
+    FoldingRewriter rewriter(op->ir_context());
+    const size_t batch_size = FLAGS_pir_constant_folding_batch_size;
+    int64_t num_rewrites = 0;
+    while (true) {
+      std::vector<pir::Operation*> matched_ops;
+      for (uint32_t i = 0; i < op->num_regions(); ++i) {
+        for (auto& block : op->region(i)) {
+          block.Walk([&](pir::Operation* inner_op) {
+            if (batch_pattern_->Match(inner_op)) {
+              matched_ops.push_back(inner_op);
+            }
+          });
+        }
+      }
+      if (matched_ops.empty()) {
+        break;
+      }
+      for (size_t begin = 0; begin < matched_ops.size(); begin += batch_size) {
+        const std::vector<pir::Operation*> batch(
+            matched_ops.begin() + begin,
+            matched_ops.begin() +
+                std::min(matched_ops.size(), begin + batch_size));
+        VLOG(4) << "constant_folding_pass folds " << batch.size()
+                << " ops in one program";
+        const auto& output_var_names = batch_pattern_->RunOps(batch, rewriter);
+        for (size_t i = 0; i < batch.size(); ++i) {
+          rewriter.set_insertion_point(batch[i]);
+          batch_pattern_->ReplaceResults(
+              batch[i], output_var_names[i], rewriter);
+        }
+        num_rewrites += batch.size();
+      }
+    }
+    return num_rewrites;
+  }
+
  private:
+  // Rewrite the program in place for RunBatched, which tracks the changes by
+  // itself instead of the greedy pattern rewrite driver.
+  class FoldingRewriter : public pir::PatternRewriter {
+   public:
+    explicit FoldingRewriter(pir::IrContext* context)
+        : pir::PatternRewriter(context) {}
+  };
+
   size_t suffix_{0};
   phi::Place place_{phi::CPUPlace{}};
   paddle::framework::Scope* scope_{nullptr};
   paddle::framework::interpreter::ExecutionConfig exe_config_{};
 
   pir::FrozenRewritePatternSet patterns_;
+  std::unique_ptr<ConstantFoldingPattern> batch_pattern_;
 };
 
 }  // namespace
@@ -22,6 +22,7 @@
 #include <memory>
 #include <ostream>
 #include <queue>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -72,6 +73,110 @@ const float INF = std::numeric_limits<float>::max();
 // large enough.
 const float THRESHOLD = INF / 2.0f;
 
+// The benefit of running an op in NHWC rather than NCHW, counted in the
+// transposes of one value, which is the unit of the edge weights below. The
+// min cut then moves an op to NHWC only if it saves more than the transposes
+// inserted around it. The ops whose kernels only support NHWC are pinned.
+float NhwcBenefit(const pir::Operation& op) {
+  static const std::unordered_map<std::string, float> kNhwcBenefit = {
+      {"pd_op.add_group_norm_silu", THRESHOLD},
+      {"pd_op.conv2d", 8.0f},
+      {"pd_op.fused_conv2d_add_act", 8.0f},
+      {"pd_op.depthwise_conv2d", 4.0f},
+      {"pd_op.batch_norm", 2.0f},
+      {"pd_op.batch_norm_", 2.0f},
+      {"pd_op.group_norm", 2.0f},
+      {"pd_op.pool2d", 2.0f},
+  };
+  auto it = kNhwcBenefit.find(op.name());
+  // the other ops preferring NHWC stay pinned to it
+  if (it == kNhwcBenefit.end()) {
+    return THRESHOLD;
+  }
+  if (it->second >= THRESHOLD) {
+    return it->second;
+  }
+
+  // the tensor cores only run NHWC in half precision, in which most of the
+  // benefit comes from
+  bool is_half = false;
+  if (op.num_operands() > 0 && op.operand_source(0)) {
+    if (auto t = op.operand_source(0)
+                     .type()
+                     .dyn_cast<paddle::dialect::DenseTensorType>()) {
+      is_half = t.dtype().isa<pir::Float16Type>() ||
+                t.dtype().isa<pir::BFloat16Type>();
+    }
+  }
+  return is_half ? it->second : it->second / 4.0f;
+}
+
+std::vector<int> TransposePerm(pir::Operation* op) {
+  std::vector<int> perm;
+  for (auto attr : op->attribute<pir::ArrayAttribute>("perm").AsVector()) {
+    perm.push_back(attr.dyn_cast<pir::Int32Attribute>().data());
+  }
+  return perm;
+}
+
+bool IsInsertedTranspose(pir::Operation* op) {
+  auto source = op->attribute<pir::StrAttribute>("source");
+  return source && source.AsString() == "transfer_layout_pass";
+}
+
+// Remove the pairs of transposes cancelling each other out, at least one of
+// which is inserted by this pass, e.g. the NHWC -> NCHW transpose inserted
+// for an op kept in NCHW which only feeds a transpose back to NHWC. Returns
+// the number of the inserted transposes removed.
+int64_t FoldTransposePairs(pir::Block* block) {
+  std::vector<pir::Operation*> transposes;
+  for (auto& op : *block) {
+    if (op.isa<paddle::dialect::TransposeOp>()) {
+      transposes.push_back(&op);
+    }
+  }
+
+  int64_t num_removed = 0;
+  for (auto* second : transposes) {
+    auto* first = second->operand_source(0).defining_op();
+    if (!first || !first->isa<paddle::dialect::TransposeOp>() ||
+        first->GetParent() != block) {
+      continue;
+    }
+    if (!IsInsertedTranspose(first) && !IsInsertedTranspose(second)) {
+      continue;
+    }
+    const auto& perm_1 = TransposePerm(first);
+    const auto& perm_2 = TransposePerm(second);
+    if (perm_1.size() != perm_2.size()) {
+      continue;
+    }
+    bool is_identity = true;
+    for (size_t i = 0; i < perm_2.size(); ++i) {
+      if (perm_2[i] < 0 || static_cast<size_t>(perm_2[i]) >= perm_1.size() ||
+          perm_1[perm_2[i]] != static_cast<int>(i)) {
+        is_identity = false;
+        break;
+      }
+    }
+    if (!is_identity) {
+      continue;
+    }
+
+    VLOG(10) << "[FoldTransposePairs] " << first << " -> " << second;
+    // the transposes are visited in order, so first is never visited again
+    // once erased, and second is the current one
+    second->result(0).ReplaceAllUsesWith(first->operand_source(0));
+    num_removed += IsInsertedTranspose(second);
+    second->Erase();
+    if (first->result(0).use_empty()) {
+      num_removed += IsInsertedTranspose(first);
+      first->Erase();
+    }
+  }
+  return num_removed;
+}
+
 template <class... Ts>
 struct overloaded : Ts... {
   using Ts::operator()...;
@@ -309,9 +414,10 @@ struct FlowGraph {
       if (prefer_layout == common::DataLayout::NHWC) {
         Node op_node(&op);
         mutable_nodes.insert(op_node);
-        AddEdge(op_node, dst_node(), THRESHOLD);
+        const float benefit = NhwcBenefit(op);
+        AddEdge(op_node, dst_node(), benefit);
         VLOG(10) << "[PreProcess] node: " << op_node
-                 << " should be set to NHWC";
+                 << " prefers NHWC with benefit " << benefit;
       }
     }
 
@@ -829,6 +935,7 @@ class TransferLayoutPass : public pir::Pass {
         value.ReplaceUsesWithIf(transpose_op.out(), replace_uses_in_cut_set);
       }
     }
+    num_of_transpose_ops -= FoldTransposePairs(program->block());
     AddStatistics(num_of_transpose_ops, num_of_layout_changed_ops);
   }
 };
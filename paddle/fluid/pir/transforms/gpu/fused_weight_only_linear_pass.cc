@@ -15,6 +15,7 @@
 #include "paddle/fluid/pir/transforms/gpu/fused_weight_only_linear_pass.h"
 
 #include <utility>
+#include <vector>
 
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
@@ -36,20 +37,41 @@ int getSMVersion() {
   return sm_version;
 }
 
+// Rows of x up to 3 run the weight-only GEMV, and the rest the mixed-input
+// tensor core GEMM. For many rows the GEMM is compute bound, and dequantizing
+// the weights in its mainloop is slower than the float16 GEMM, so the matmuls
+// with more than max_rows static rows are not fused if max_rows > 0.
+bool IsWeightOnlyRows(const std::vector<int64_t> &x_dims, int64_t max_rows) {
+  if (max_rows <= 0) return true;
+  int64_t rows = 1;
+  for (size_t i = 0; i + 1 < x_dims.size(); ++i) {
+    // The dynamic rows of decoding are always fused.
+    if (x_dims[i] < 0) return true;
+    rows *= x_dims[i];
+  }
+  return rows <= max_rows;
+}
+
 class FusedWeightOnlyLinearWithBiasPattern
     : public paddle::drr::DrrPatternBase {
  private:
   bool reverse_add_;
   std::string algo_;
   int sm_version_;
+  int group_size_;
+  int64_t max_rows_;
 
  public:
   FusedWeightOnlyLinearWithBiasPattern(bool reverse_add,
                                        std::string algo,
-                                       int sm_version)
+                                       int sm_version,
+                                       int group_size,
+                                       int64_t max_rows)
       : reverse_add_(reverse_add),
         algo_(std::move(algo)),
-        sm_version_(sm_version) {}
+        sm_version_(sm_version),
+        group_size_(group_size),
+        max_rows_(max_rows) {}
 
   std::string name() const override {
     return "FusedWeightOnlyLinearWithBiasPattern";
@@ -76,7 +98,8 @@ class FusedWeightOnlyLinearWithBiasPattern
     //
     // Constraints.
     //
-    src.AddConstraint([](const paddle::drr::MatchContext &match_ctx) -> bool {
+    src.AddConstraint([this](
+                          const paddle::drr::MatchContext &match_ctx) -> bool {
       if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
         return false;
       }
@@ -100,6 +123,7 @@ class FusedWeightOnlyLinearWithBiasPattern
 
       if (w_dims.at(0) % 64 != 0 || w_dims.at(1) % 16 != 0) return false;
       if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
+      if (!IsWeightOnlyRows(x_dims, max_rows_)) return false;
 
       return true;
     });
@@ -119,7 +143,7 @@ class FusedWeightOnlyLinearWithBiasPattern
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
       weight_quantize({&res.Tensor("w_cpu")},
                       {&res.Tensor("quanted_weight_tensor_cpu"),
                        &res.Tensor("weight_scale_tensor_cpu")});
@@ -139,7 +163,7 @@ class FusedWeightOnlyLinearWithBiasPattern
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
 
       weight_quantize({&res.Tensor("w")},
                       {&res.Tensor("quanted_weight_tensor"),
@@ -151,11 +175,12 @@ class FusedWeightOnlyLinearWithBiasPattern
                {{"weight_dtype",
                  res.StrAttr(algo_ == "weight_only_int8" ? "int8" : "int4")},
                 {"arch", res.Int32Attr(sm_version_)},
-                {"group_size", res.Int32Attr(-1)}});
+                {"group_size", res.Int32Attr(group_size_)}});
     weight_only_linear({&res.Tensor("x"),
                         &res.Tensor("quanted_weight_tensor"),
                         &res.Tensor("bias"),
-                        &res.Tensor("weight_scale_tensor")},
+                        &res.Tensor("weight_scale_tensor"),
+                        &res.InputNoneTensor()},
                        {&res.Tensor("add_out")});
   }
 };
@@ -164,10 +189,18 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
  private:
   std::string algo_;
   int sm_version_;
+  int group_size_;
+  int64_t max_rows_;
 
  public:
-  FusedWeightOnlyLinearNoBiasPattern(std::string algo, int sm_version)
-      : algo_(std::move(algo)), sm_version_(sm_version) {}
+  FusedWeightOnlyLinearNoBiasPattern(std::string algo,
+                                     int sm_version,
+                                     int group_size,
+                                     int64_t max_rows)
+      : algo_(std::move(algo)),
+        sm_version_(sm_version),
+        group_size_(group_size),
+        max_rows_(max_rows) {}
 
  public:
   std::string name() const override {
@@ -190,7 +223,8 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
     //
     // Constraints.
     //
-    src.AddConstraint([](const paddle::drr::MatchContext &match_ctx) -> bool {
+    src.AddConstraint([this](
+                          const paddle::drr::MatchContext &match_ctx) -> bool {
       if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
         return false;
       }
@@ -211,6 +245,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
         return false;
 
       if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
+      if (!IsWeightOnlyRows(x_dims, max_rows_)) return false;
 
       return true;
     });
@@ -230,7 +265,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
       weight_quantize({&res.Tensor("w_cpu")},
                       {&res.Tensor("quanted_weight_tensor_cpu"),
                        &res.Tensor("weight_scale_tensor_cpu")});
@@ -250,7 +285,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
 
       weight_quantize({&res.Tensor("w")},
                       {&res.Tensor("quanted_weight_tensor"),
@@ -261,11 +296,12 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
                {{"weight_dtype",
                  res.StrAttr(algo_ == "weight_only_int8" ? "int8" : "int4")},
                 {"arch", res.Int32Attr(sm_version_)},
-                {"group_size", res.Int32Attr(-1)}});
+                {"group_size", res.Int32Attr(group_size_)}});
     weight_only_linear({&res.Tensor("x"),
                         &res.Tensor("quanted_weight_tensor"),
                         &res.InputNoneTensor(),
-                        &res.Tensor("weight_scale_tensor")},
+                        &res.Tensor("weight_scale_tensor"),
+                        &res.InputNoneTensor()},
                        {&res.Tensor("matmul_out")});
   }
 };
@@ -287,14 +323,29 @@ class FusedWeightOnlyLinearPass : public pir::PatternRewritePass {
                           "fused_weight_only_linear_pass only support "
                           "weight_only_int8 or weight_only_int4, but get %s.",
                           algo));
+    int group_size = -1;
+    if (Has("weight_only_group_size")) {
+      group_size = Get<int>("weight_only_group_size");
+    }
+    PADDLE_ENFORCE_EQ(
+        group_size == -1 || group_size == 64 || group_size == 128,
+        true,
+        common::errors::InvalidArgument(
+            "fused_weight_only_linear_pass only support group size of -1, "
+            "64 or 128, but get %d.",
+            group_size));
+    int64_t max_rows = -1;
+    if (Has("weight_only_max_rows")) {
+      max_rows = Get<int>("weight_only_max_rows");
+    }
 
     pir::RewritePatternSet ps(context);
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearWithBiasPattern>(
-        context, true, algo, sm_version_));
+        context, true, algo, sm_version_, group_size, max_rows));
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearWithBiasPattern>(
-        context, false, algo, sm_version_));
+        context, false, algo, sm_version_, group_size, max_rows));
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearNoBiasPattern>(
-        context, algo, sm_version_));
+        context, algo, sm_version_, group_size, max_rows));
     return ps;
   }
 
@@ -0,0 +1,238 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/gpu/sparse_2_4_linear_pass.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
+#include "paddle/fluid/pir/utils/general_functions.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+int getSMVersion() {
+  int sm_version = -1;
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_CUSPARSELT)
+  sm_version = paddle::platform::GetGPUComputeCapability(
+      paddle::platform::GetCurrentDeviceId());
+#endif
+  return sm_version;
+}
+
+// Zero the 2 smallest magnitudes in every 4 consecutive elements along k of
+// the row major w[k, n] if prune is true, and return the norm of the zeroed
+// elements relative to the norm of w.
+template <typename T>
+float Prune2Of4(T *w, int64_t k, int64_t n, bool prune) {
+  double total = 0.;
+  double pruned = 0.;
+  for (int64_t j = 0; j < n; ++j) {
+    for (int64_t i = 0; i < k; i += 4) {
+      int64_t idx[4] = {i * n + j,
+                        (i + 1) * n + j,
+                        (i + 2) * n + j,
+                        (i + 3) * n + j};
+      std::sort(idx, idx + 4, [&](int64_t lhs, int64_t rhs) {
+        return std::abs(static_cast<float>(w[lhs])) <
+               std::abs(static_cast<float>(w[rhs]));
+      });
+      for (int l = 0; l < 4; ++l) {
+        const double value = static_cast<float>(w[idx[l]]);
+        total += value * value;
+        if (l < 2) {
+          pruned += value * value;
+          if (prune) {
+            w[idx[l]] = static_cast<T>(0.f);
+          }
+        }
+      }
+    }
+  }
+  return total > 0. ? static_cast<float>(std::sqrt(pruned / total)) : 0.f;
+}
+
+// Apply Prune2Of4 on the weight in the scope, which is copied to the CPU and
+// back if it is on a device.
+float PruneWeight(paddle::framework::Scope *scope,
+                  const std::string &name,
+                  bool prune) {
+  auto *var = scope->FindVar(name);
+  PADDLE_ENFORCE_NOT_NULL(
+      var,
+      common::errors::InvalidArgument("Persistable var [%s] not in scope.",
+                                      name));
+  auto *weight = var->GetMutable<phi::DenseTensor>();
+  phi::DenseTensor cpu_weight;
+  phi::DenseTensor *host_weight = weight;
+  if (!phi::is_cpu_place(weight->place())) {
+    paddle::framework::TensorCopySync(*weight, phi::CPUPlace(), &cpu_weight);
+    host_weight = &cpu_weight;
+  }
+  const int64_t k = host_weight->dims()[0];
+  const int64_t n = host_weight->dims()[1];
+  float ratio = 0.f;
+  if (host_weight->dtype() == phi::DataType::FLOAT16) {
+    ratio = Prune2Of4(host_weight->data<phi::dtype::float16>(), k, n, prune);
+  } else {
+    ratio = Prune2Of4(host_weight->data<phi::dtype::bfloat16>(), k, n, prune);
+  }
+  if (prune && host_weight != weight) {
+    paddle::framework::TensorCopySync(*host_weight, weight->place(), weight);
+  }
+  return ratio;
+}
+
+class Sparse24LinearPattern : public paddle::drr::DrrPatternBase {
+ private:
+  paddle::framework::Scope *scope_;
+  float max_pruned_ratio_;
+
+ public:
+  Sparse24LinearPattern(paddle::framework::Scope *scope,
+                        float max_pruned_ratio)
+      : scope_(scope), max_pruned_ratio_(max_pruned_ratio) {}
+
+  std::string name() const override { return "Sparse24LinearPattern"; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    //
+    // Source Pattern.
+    //
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &matmul =
+        src.Op(paddle::dialect::MatmulOp::name(),
+               {{"transpose_x", src.Attr("matmul_transpose_x")},
+                {"transpose_y", src.Attr("matmul_transpose_y")}});
+    src.Tensor("matmul_out") = matmul(src.Tensor("x"), src.Tensor("w"));
+
+    //
+    // Constraints.
+    //
+    src.AddConstraint([this](
+                          const paddle::drr::MatchContext &match_ctx) -> bool {
+      const auto &w = match_ctx.Tensor("w");
+      // the pruned weight must not reach any other op
+      if (!pir::ValueIsPersistable(w) || !w.HasOneUse()) {
+        return false;
+      }
+      bool matmul_trans_x = match_ctx.Attr<bool>("matmul_transpose_x");
+      bool matmul_trans_y = match_ctx.Attr<bool>("matmul_transpose_y");
+      if (matmul_trans_x || matmul_trans_y) return false;
+
+      auto w_dtype = pir::GetDataTypeFromValue(w);
+      if (!w_dtype.isa<pir::Float16Type>() &&
+          !w_dtype.isa<pir::BFloat16Type>()) {
+        return false;
+      }
+      auto w_dims = pir::GetShapeFromValue(w);
+      auto x_dims = pir::GetShapeFromValue(match_ctx.Tensor("x"));
+      if (!(w_dims.size() == 2 && x_dims.size() >= 2)) {
+        return false;
+      }
+      if (w_dims.at(0) % 32 != 0 || w_dims.at(1) % 32 != 0) return false;
+      if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
+
+      const float ratio =
+          PruneWeight(scope_, pir::GetParameterNameFromValue(w), false);
+      if (ratio > max_pruned_ratio_) {
+        VLOG(3) << "Keep " << pir::GetParameterNameFromValue(w)
+                << " dense, whose 2:4 pruning drops " << ratio
+                << " of its norm.";
+        return false;
+      }
+      return true;
+    });
+
+    src.AddPostProcess([this](const paddle::drr::MatchContext &match_ctx) {
+      PruneWeight(scope_,
+                  pir::GetParameterNameFromValue(match_ctx.Tensor("w")),
+                  true);
+    });
+
+    //
+    // Result Pattern.
+    //
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    const auto &compress =
+        res.Op(paddle::dialect::Sparse24WeightCompressOp::name());
+    res.Tensor("w_compressed") = compress(res.Tensor("w"));
+
+    const auto &n_attr =
+        res.ComputeAttr([](const paddle::drr::MatchContext &match_ctx) -> int {
+          return static_cast<int>(
+              pir::GetShapeFromValue(match_ctx.Tensor("w")).at(1));
+        });
+    const auto &linear =
+        res.Op(paddle::dialect::Sparse24LinearOp::name(), {{"n", n_attr}});
+    res.Tensor("matmul_out") =
+        linear(res.Tensor("x"), res.Tensor("w_compressed"));
+  }
+};
+
+class Sparse24LinearPass : public pir::PatternRewritePass {
+ public:
+  Sparse24LinearPass()
+      : pir::PatternRewritePass("sparse_2_4_linear_pass", 4),
+        sm_version_(getSMVersion()) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    PADDLE_ENFORCE_EQ(Has(pir::Pass::kParamScopeAttr),
+                      true,
+                      common::errors::InvalidArgument(
+                          "Pass initialize failed."
+                          "When using Sparse24LinearPass, scope attribute is "
+                          "required! Use Set method to set the scope "
+                          "attribute."));
+    auto *scope = &Get<paddle::framework::Scope>(pir::Pass::kParamScopeAttr);
+    float max_pruned_ratio = 0.2f;
+    if (Has("sparse_2_4_max_pruned_ratio")) {
+      max_pruned_ratio = Get<float>("sparse_2_4_max_pruned_ratio");
+    }
+
+    pir::RewritePatternSet ps(context);
+    ps.Add(paddle::drr::Create<Sparse24LinearPattern>(
+        context, scope, max_pruned_ratio));
+    return ps;
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    // the sparse tensor cores come with Ampere
+    if (sm_version_ < 80) {
+      return false;
+    }
+    return op->num_regions() > 0;
+  }
+
+ private:
+  int sm_version_;
+};
+
+}  // namespace
+
+namespace pir {
+std::unique_ptr<Pass> CreateSparse24LinearPass() {
+  return std::make_unique<Sparse24LinearPass>();
+}
+}  // namespace pir
+
+REGISTER_IR_PASS(sparse_2_4_linear_pass, Sparse24LinearPass);
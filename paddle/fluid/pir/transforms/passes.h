@@ -22,6 +22,7 @@ USE_PIR_PASS(transpose_flatten_concat_fuse_pass);
 USE_PIR_PASS(fused_gemm_epilogue_pass);
 USE_PIR_PASS(fused_dropout_add_pass);
 USE_PIR_PASS(fused_weight_only_linear_pass);
+USE_PIR_PASS(sparse_2_4_linear_pass);
 USE_PIR_PASS(fused_linear_param_grad_add_pass);
 USE_PIR_PASS(fuse_allreduce_split_to_reducescatter_pass);
 USE_PIR_PASS(inplace_pass);
@@ -15,6 +15,7 @@
 #include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
 
 #include <iostream>
+#include <memory>
 #include <regex>
 #include <string>
 #include <unordered_set>
@@ -50,6 +51,7 @@
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/kernel_factory.h"
 #include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/utils.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
 
 #ifdef PADDLE_WITH_DNNL
@@ -1002,15 +1004,141 @@ static phi::Backend GetKernelBackendByYaml(
   return kernel_backend;
 }
 
-std::unique_ptr<OpYamlInfoParser> GetOpYamlInfoParser(pir::Operation* op) {
-  OpYamlInfoInterface op_info_interface = op->dyn_cast<OpYamlInfoInterface>();
+namespace {
+
+// The attributes which only record where an op comes from, they never
+// affect its kernel key.
+const std::unordered_set<std::string> kKernelKeyIgnoredAttrs = {
+    "op_callstack", "struct_name", "op_namescope"};
+
+struct KernelKeyCacheKey {
+  pir::OpInfo op_info;
+  std::string kernel_fn_str;
+  phi::Place place;
+  // the original and the lowered types of the operands, then the result types
+  std::vector<pir::Type> types;
+  pir::AttributeMap attributes;
+
+  bool operator==(const KernelKeyCacheKey& other) const {
+    return op_info == other.op_info && kernel_fn_str == other.kernel_fn_str &&
+           place == other.place && types == other.types &&
+           attributes == other.attributes;
+  }
+};
+
+struct KernelKeyCacheKeyHash {
+  size_t operator()(const KernelKeyCacheKey& key) const {
+    size_t hash =
+        pir::detail::hash_combine(std::hash<pir::OpInfo>()(key.op_info),
+                                  std::hash<std::string>()(key.kernel_fn_str));
+    hash = pir::detail::hash_combine(hash, key.place.HashValue());
+    for (auto type : key.types) {
+      hash = pir::detail::hash_combine(hash, std::hash<pir::Type>()(type));
+    }
+    // independent of the order of the attributes
+    size_t attr_hash = 0;
+    for (auto& [name, attr] : key.attributes) {
+      attr_hash += pir::detail::hash_combine(std::hash<std::string>()(name),
+                                             std::hash<pir::Attribute>()(attr));
+    }
+    return pir::detail::hash_combine(hash, attr_hash);
+  }
+};
+
+// The yaml info parsers and the kernel keys resolved by the running
+// PdOpLowerToKernelPass on this thread. Most ops of a large program are the
+// same kinds of ops on the same types, which are only resolved once.
+struct KernelKeyCache {
+  std::unordered_map<pir::OpInfo, std::shared_ptr<OpYamlInfoParser>> parsers;
+  std::unordered_map<KernelKeyCacheKey, phi::KernelKey, KernelKeyCacheKeyHash>
+      kernel_keys;
+};
 
-  std::unique_ptr<OpYamlInfoParser> op_info_parser(nullptr);
-  if (op_info_interface) {
-    op_info_parser = std::make_unique<OpYamlInfoParser>(
-        op_info_interface.GetOpInfo(), IsLegacyOp(op->name()));
+thread_local KernelKeyCache* current_kernel_key_cache = nullptr;
+
+class KernelKeyCacheScope {
+ public:
+  KernelKeyCacheScope() : prev_cache_(current_kernel_key_cache) {
+    current_kernel_key_cache = &cache_;
   }
+  ~KernelKeyCacheScope() { current_kernel_key_cache = prev_cache_; }
+
+ private:
+  KernelKeyCache cache_;
+  KernelKeyCache* prev_cache_;
+};
+
+// Make the cache key of the kernel key of op, returns false if the kernel
+// key depends on more than the key, i.e. the place of a DataOp input.
+bool MakeKernelKeyCacheKey(
+    pir::Operation* op,
+    const phi::Place& place,
+    const std::string& kernel_fn_str,
+    const std::unordered_map<pir::Value, pir::Value>& map_value_pair,
+    KernelKeyCacheKey* key) {
+  const auto IsDataOp = [](pir::Value value) {
+    return value && value.defining_op() && value.defining_op()->isa<DataOp>();
+  };
 
+  key->op_info = op->info();
+  key->kernel_fn_str = kernel_fn_str;
+  key->place = place;
+  key->types.reserve(op->num_operands() * 2 + op->num_results());
+  for (size_t i = 0; i < op->num_operands(); ++i) {
+    auto input = op->operand_source(i);
+    if (!input) {
+      key->types.emplace_back();
+      key->types.emplace_back();
+      continue;
+    }
+    if (IsDataOp(input)) {
+      return false;
+    }
+    if (input.defining_op() && input.defining_op()->isa<pir::CombineOp>()) {
+      for (auto combine_input : input.defining_op()->operands_source()) {
+        if (IsDataOp(combine_input)) {
+          return false;
+        }
+      }
+    }
+    auto iter = map_value_pair.find(input);
+    if (iter == map_value_pair.end()) {
+      return false;
+    }
+    key->types.push_back(input.type());
+    key->types.push_back(iter->second.type());
+  }
+  for (auto result : op->results()) {
+    key->types.push_back(result.type());
+  }
+  for (auto& [name, attr] : op->attributes()) {
+    if (!kKernelKeyIgnoredAttrs.count(name)) {
+      key->attributes.emplace(name, attr);
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::shared_ptr<OpYamlInfoParser> GetOpYamlInfoParser(pir::Operation* op) {
+  OpYamlInfoInterface op_info_interface = op->dyn_cast<OpYamlInfoInterface>();
+  if (!op_info_interface) {
+    return nullptr;
+  }
+
+  auto* cache = current_kernel_key_cache;
+  if (cache != nullptr) {
+    auto iter = cache->parsers.find(op->info());
+    if (iter != cache->parsers.end()) {
+      return iter->second;
+    }
+  }
+  auto op_info_parser = std::make_shared<OpYamlInfoParser>(
+      op_info_interface.GetOpInfo(), IsLegacyOp(op->name()));
+  if (cache != nullptr) {
+    cache->parsers.emplace(op->info(), op_info_parser);
+  }
   return op_info_parser;
 }
 
@@ -1116,12 +1244,12 @@ bool SupportsCPUBF16(const std::string& kernel_name) {
 }
 #endif
 
-phi::KernelKey GetKernelKey(
+static phi::KernelKey ResolveKernelKey(
     pir::Operation* op,
     const phi::Place& place,
     const std::string& kernel_fn_str,
     const std::unordered_map<pir::Value, pir::Value>& map_value_pair,
-    OpYamlInfoParser* op_info_parser = nullptr) {
+    OpYamlInfoParser* op_info_parser) {
   if (op->isa<FeedOp>() || op->isa<FetchOp>() || op->isa<ArrayLengthOp>()) {
     // NOTE, for now feed op don't need a kernel, so the data type from Op
     // Result the next op use base program datatype
@@ -1397,6 +1525,31 @@ phi::KernelKey GetKernelKey(
   return res;
 }
 
+phi::KernelKey GetKernelKey(
+    pir::Operation* op,
+    const phi::Place& place,
+    const std::string& kernel_fn_str,
+    const std::unordered_map<pir::Value, pir::Value>& map_value_pair,
+    OpYamlInfoParser* op_info_parser = nullptr) {
+  auto* cache = current_kernel_key_cache;
+  KernelKeyCacheKey key;
+  if (cache == nullptr ||
+      !MakeKernelKeyCacheKey(op, place, kernel_fn_str, map_value_pair, &key)) {
+    return ResolveKernelKey(
+        op, place, kernel_fn_str, map_value_pair, op_info_parser);
+  }
+
+  auto iter = cache->kernel_keys.find(key);
+  if (iter != cache->kernel_keys.end()) {
+    VLOG(8) << "Reuse the kernel key of " << op->name();
+    return iter->second;
+  }
+  auto kernel_key = ResolveKernelKey(
+      op, place, kernel_fn_str, map_value_pair, op_info_parser);
+  cache->kernel_keys.emplace(std::move(key), kernel_key);
+  return kernel_key;
+}
+
 void HandleForIfOp(
     const phi::Place& place,
     pir::Operation* op_item,
@@ -3344,6 +3497,7 @@ std::unique_ptr<pir::Program> PdOpLowerToKernelPass(pir::Program* prog,
   std::unordered_map<pir::Operation*, pir::Operation*> map_op_pair;
   std::unordered_map<pir::Value, pir::Value> map_value_pair;
 
+  KernelKeyCacheScope kernel_key_cache_scope;
   ProcessBlock(
       place, block, program->block(), ctx, &map_op_pair, &map_value_pair);
 
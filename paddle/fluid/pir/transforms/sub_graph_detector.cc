@@ -183,9 +183,8 @@ struct SubGraph {
     input_ops.erase(op);
   }
 
-  int depth{0};
-  int max_depth{0};
-  int min_depth{INT_MAX};
+  // the position in SubgraphDetector::topo_order_
+  size_t topo_id{0};
   bool substitute{true};
   std::vector<pir::Operation*> ops;
   std::unordered_set<pir::Operation*> op_set;
@@ -297,18 +296,47 @@ void SubgraphDetector::BuildSubGraph() {
     }
   }
 
-  // init group depth.
+  // reverse to keep fusion group in order.
+  std::reverse(subgraph_list_.begin(), subgraph_list_.end());
+
+  BuildTopoOrder();
+}
+
+void SubgraphDetector::BuildTopoOrder() {
+  std::unordered_map<SubGraph*, size_t> pending_count;
+  std::queue<SubGraph*> queue;
   for (auto& subgraph : subgraph_list_) {
+    size_t count = subgraph->producers.size();
+    if (subgraph->producers.count(subgraph)) {
+      --count;
+    }
+    pending_count[subgraph.get()] = count;
+    if (count == 0) {
+      queue.push(subgraph.get());
+    }
+  }
+
+  topo_order_.clear();
+  while (!queue.empty()) {
+    auto* subgraph = queue.front();
+    queue.pop();
+    subgraph->topo_id = topo_order_.size();
+    topo_order_.push_back(subgraph);
     for (auto& consumer : subgraph->consumers) {
-      // update depth.
-      subgraph->depth = std::max(subgraph->depth, consumer->depth + 1);
+      if (consumer.get() != subgraph && --pending_count[consumer.get()] == 0) {
+        queue.push(consumer.get());
+      }
     }
-    subgraph->max_depth = subgraph->depth;
-    subgraph->min_depth = subgraph->depth;
   }
 
-  // reverse to keep fusion group in order.
-  std::reverse(subgraph_list_.begin(), subgraph_list_.end());
+  PADDLE_ENFORCE_EQ(
+      topo_order_.size(),
+      subgraph_list_.size(),
+      common::errors::PreconditionNotMet(
+          "The sub-graphs should be acyclic, but only %d of the %d "
+          "sub-graphs are sorted.",
+          topo_order_.size(),
+          subgraph_list_.size()));
 }
 
 // SubGraph Fusion
@@ -320,8 +348,11 @@ void SubgraphDetector::DoSubGraphFusion() {
       if (!subgraph->substitute) {
         continue;
       }
-      // do fusion
-      update |= FuseSubGraph(subgraph);
+      // fuse the consumers of the consumers in the same round, instead of
+      // one level of consumers per round over all the sub-graphs
+      while (FuseSubGraph(subgraph)) {
+        update = true;
+      }
     }
     if (!update) {
       break;
@@ -333,16 +364,12 @@ bool SubgraphDetector::FuseSubGraph(SubGraphPtr subgraph_ptr) {
   auto producer = subgraph_ptr;
   auto& consumers = producer->consumers;
   std::vector<SubGraphPtr> candidates;
+  const auto dependent_consumers = GetDependentConsumers(producer);
   for (auto& consumer : consumers) {
-    if (!consumer->substitute) {
-      continue;
-    }
-    // fast dependency check.
-    if (IsDependencySimplify(producer, consumer, consumers)) {
+    if (!consumer->substitute || consumer.get() == producer.get()) {
       continue;
     }
-    // global dependency check.
-    if (IsDependency(producer, consumer, consumers)) {
+    if (dependent_consumers.count(consumer.get())) {
       continue;
     }
 
@@ -356,16 +383,13 @@ bool SubgraphDetector::FuseSubGraph(SubGraphPtr subgraph_ptr) {
   // fuse candidate to producer
   for (auto& candidate : candidates) {
     candidate->substitute = false;
+    UpdateTopoOrder(producer.get(), candidate.get());
 
     // merge nodes
     producer->ops.insert(
         producer->ops.end(), candidate->ops.begin(), candidate->ops.end());
     producer->op_set.insert(candidate->op_set.begin(), candidate->op_set.end());
 
-    // update bound for check dependency
-    producer->max_depth = std::max(producer->max_depth, candidate->max_depth);
-    producer->min_depth = std::min(producer->min_depth, candidate->min_depth);
-
     // merge producer/consumer
     producer->producers.insert(candidate->producers.begin(),
                                candidate->producers.end());
@@ -408,62 +432,97 @@ bool SubgraphDetector::FuseSubGraph(SubGraphPtr subgraph_ptr) {
 
   return true;
 }
-// check exist dependency.
-bool SubgraphDetector::IsDependency(
-    const SubGraphPtr& producer_g,
-    const SubGraphPtr& consumer,
-    const std::unordered_set<SubGraphPtr>& consumers) {
-  std::queue<SubGraphPtr> candidates;
-  candidates.push(consumer);
-
-  std::unordered_set<SubGraphPtr> visited_set;
-  while (!candidates.empty()) {
-    auto& candidate = candidates.front();
-    candidates.pop();
-    for (auto& producer : candidate->producers) {
-      if (producer.get() == producer_g.get()) {
-        continue;
-      }
-      if (consumers.count(producer)) {
-        return true;
-      }
-      if (!visited_set.count(producer)) {
-        visited_set.insert(producer);
-        candidates.push(producer);
+
+std::unordered_set<SubGraph*> SubgraphDetector::GetDependentConsumers(
+    const SubGraphPtr& producer) {
+  // A path from a consumer to another only passes the sub-graphs before the
+  // last consumer in topological order.
+  size_t upper_topo_id = 0;
+  for (auto& consumer : producer->consumers) {
+    upper_topo_id = std::max(upper_topo_id, consumer->topo_id);
+  }
+
+  std::unordered_set<SubGraph*> reachable;
+  std::vector<SubGraph*> stack;
+  const auto Visit = [&](SubGraph* subgraph) {
+    for (auto& consumer : subgraph->consumers) {
+      if (consumer.get() != subgraph &&
+          consumer->topo_id <= upper_topo_id &&
+          reachable.insert(consumer.get()).second) {
+        stack.push_back(consumer.get());
       }
     }
+  };
+  for (auto& consumer : producer->consumers) {
+    if (consumer.get() != producer.get()) {
+      Visit(consumer.get());
+    }
+  }
+  while (!stack.empty()) {
+    auto* subgraph = stack.back();
+    stack.pop_back();
+    Visit(subgraph);
+  }
+
+  std::unordered_set<SubGraph*> dependent_consumers;
+  for (auto& consumer : producer->consumers) {
+    if (reachable.count(consumer.get())) {
+      dependent_consumers.insert(consumer.get());
+    }
   }
-  return false;
+  return dependent_consumers;
 }
-bool SubgraphDetector::IsDependencySimplify(
-    const SubGraphPtr& producer_g,
-    const SubGraphPtr& consumer,
-    const std::unordered_set<SubGraphPtr>& consumers) {
-  std::queue<SubGraphPtr> candidates;
-  candidates.push(consumer);
-  // check upper bound.
-  int check_upper_depth = producer_g->max_depth;
-  std::unordered_set<SubGraphPtr> visited_set;
-  while (!candidates.empty()) {
-    auto& candidate = candidates.front();
-    candidates.pop();
-    for (auto& producer : candidate->producers) {
-      if (producer.get() == producer_g.get()) {
-        continue;
-      }
-      if (producer->min_depth > check_upper_depth) {
-        continue;
-      }
-      if (consumers.count(producer)) {
-        return true;
-      }
-      if (!visited_set.count(producer)) {
-        visited_set.insert(producer);
-        candidates.push(producer);
+
+void SubgraphDetector::UpdateTopoOrder(SubGraph* producer,
+                                       SubGraph* consumer) {
+  const size_t begin = producer->topo_id;
+  const size_t end = consumer->topo_id;
+  PADDLE_ENFORCE_LT(begin,
+                    end,
+                    common::errors::PreconditionNotMet(
+                        "The consumer should be after the producer in "
+                        "topological order."));
+
+  // The descendants of the producer in between are not ancestors of the
+  // consumer, otherwise the consumer could not be fused. So the fused
+  // sub-graph can be placed after all the other sub-graphs in between, which
+  // include the ancestors of the consumer, and before the descendants.
+  std::unordered_set<SubGraph*> descendants;
+  std::vector<SubGraph*> stack{producer};
+  while (!stack.empty()) {
+    auto* subgraph = stack.back();
+    stack.pop_back();
+    for (auto& tmp : subgraph->consumers) {
+      if (tmp->topo_id > begin && tmp->topo_id < end &&
+          descendants.insert(tmp.get()).second) {
+        stack.push_back(tmp.get());
       }
     }
   }
-  return false;
+
+  std::vector<SubGraph*> others;
+  std::vector<SubGraph*> moved;
+  for (size_t i = begin + 1; i < end; ++i) {
+    if (topo_order_[i] != nullptr) {
+      (descendants.count(topo_order_[i]) ? moved : others)
+          .push_back(topo_order_[i]);
+    }
+  }
+  size_t pos = begin;
+  const auto Place = [&](SubGraph* subgraph) {
+    topo_order_[pos] = subgraph;
+    subgraph->topo_id = pos++;
+  };
+  for (auto* subgraph : others) {
+    Place(subgraph);
+  }
+  Place(producer);
+  for (auto* subgraph : moved) {
+    Place(subgraph);
+  }
+  for (; pos <= end; ++pos) {
+    topo_order_[pos] = nullptr;
+  }
 }
 
 std::vector<pir::Value> AnalysisOutputs(
@@ -501,54 +560,29 @@ std::vector<pir::Value> AnalysisOutputs(
 
 namespace {
 
-struct IncrementalOrder {
-  bool operator()(const pir::Operation* lhs, const pir::Operation* rhs) const {
-    PADDLE_ENFORCE_EQ(lhs->GetParent() == rhs->GetParent(),
-                      true,
-                      common::errors::PreconditionNotMet(
-                          "lhs and rhs should have same parent block."));
-    auto lhs_iter = lhs->operator Block::ConstIterator();
-    auto rhs_iter = rhs->operator Block::ConstIterator();
-    auto end_iter = lhs->GetParent()->end();
-    while (lhs_iter != end_iter) {
-      lhs_iter++;
-      if (lhs_iter == rhs_iter) return true;
-      if (lhs_iter == end_iter) return false;
-    }
-    PADDLE_ENFORCE_EQ(
-        false,
-        true,
-        common::errors::InvalidArgument("rhs is not reachable from lhs."));
-    return false;
-  }
-};
-
+// Get the ops in op_order, i.e. the ops not before the insert point, which
+// the group ops depend on.
 std::unordered_set<pir::Operation*> GetUpstreamOpsAfterPosition(
-    const pir::Operation* position_op,
+    const std::unordered_map<const pir::Operation*, size_t>& op_order,
     const pir::Block* block,
     pir::Operation* op,
     std::unordered_set<pir::Operation*>* visited_ops) {
   std::unordered_set<pir::Operation*> ops;
-  const auto& IsInBlock = [](const pir::Operation* src_op,
-                             const pir::Block* block) {
-    for (auto& item : *block) {
-      if (src_op->id() == item.id()) return true;
+  std::vector<pir::Operation*> stack{op};
+  while (!stack.empty()) {
+    auto* cur_op = stack.back();
+    stack.pop_back();
+    for (auto value : GetUsedExternalValue(*cur_op)) {
+      if (!value || !value.defining_op()) continue;
+      pir::Operation* defining_op = value.defining_op();
+      if (visited_ops->count(defining_op)) continue;
+      visited_ops->insert(defining_op);
+      if (defining_op->GetParent() != block) continue;
+      if (!op_order.count(defining_op)) continue;
+
+      ops.insert(defining_op);
+      stack.push_back(defining_op);
     }
-    return false;
-  };
-  std::vector<pir::Value> op_inputs = GetUsedExternalValue(*op);
-  for (auto value : op_inputs) {
-    if (!value || !value.defining_op()) continue;
-    pir::Operation* defining_op = value.defining_op();
-    if (visited_ops->count(defining_op)) continue;
-    visited_ops->insert(defining_op);
-    if (!IsInBlock(defining_op, block)) continue;
-    if (IncrementalOrder()(defining_op, position_op)) continue;
-
-    ops.insert(defining_op);
-    auto recursive_ops = GetUpstreamOpsAfterPosition(
-        position_op, block, defining_op, visited_ops);
-    ops.insert(recursive_ops.begin(), recursive_ops.end());
   }
   return ops;
 }
@@ -557,15 +591,31 @@ std::unordered_set<pir::Operation*> GetUpstreamOpsAfterPosition(
 void MoveUpstreamOpBeforeGroup(const GroupOpsVec& group_ops,
                                pir::Block* block,
                                pir::Operation* insert_point_op) {
+  // The upstream ops of the group ops are before the last of them, so only
+  // the positions of the ops from the insert point to it are needed.
+  std::unordered_map<const pir::Operation*, size_t> op_order;
+  auto end = ++(group_ops.back()->operator Block::ConstIterator());
+  for (auto it = insert_point_op->operator Block::ConstIterator(); it != end;
+       ++it) {
+    const size_t index = op_order.size();
+    op_order.emplace(&*it, index);
+  }
+
   const auto moved_ops = [&]() {
-    std::set<pir::Operation*, IncrementalOrder> ops_set;
+    std::unordered_set<pir::Operation*> ops_set;
     std::unordered_set<pir::Operation*> visited_ops;
     for (auto& op : group_ops) {
       auto upstream_ops =
-          GetUpstreamOpsAfterPosition(insert_point_op, block, op, &visited_ops);
+          GetUpstreamOpsAfterPosition(op_order, block, op, &visited_ops);
       ops_set.insert(upstream_ops.begin(), upstream_ops.end());
     }
-    return ops_set;
+    std::vector<pir::Operation*> ops(ops_set.begin(), ops_set.end());
+    std::sort(ops.begin(),
+              ops.end(),
+              [&op_order](pir::Operation* a, pir::Operation* b) {
+                return op_order.at(a) < op_order.at(b);
+              });
+    return ops;
   }();
 
   for (auto& op : moved_ops) {
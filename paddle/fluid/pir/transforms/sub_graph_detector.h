@@ -51,14 +51,18 @@ class SubgraphDetector {
   void DoSubGraphFusion();
 
   bool FuseSubGraph(SubGraphPtr subgraph_ptr);
-  // check exist dependency.
-  bool IsDependency(const SubGraphPtr& producer_g,
-                    const SubGraphPtr& consumer,
-                    const std::unordered_set<SubGraphPtr>& consumers);
 
-  bool IsDependencySimplify(const SubGraphPtr& producer_g,
-                            const SubGraphPtr& consumer,
-                            const std::unordered_set<SubGraphPtr>& consumers);
+  // Sort the sub-graphs topologically into topo_order_.
+  void BuildTopoOrder();
+
+  // Get the consumers of the producer which are reachable from another of its
+  // consumers, they can not be fused into it without creating a cycle.
+  std::unordered_set<SubGraph*> GetDependentConsumers(
+      const SubGraphPtr& producer);
+
+  // Keep topo_order_ topological when the consumer is fused into the
+  // producer, by only reordering the sub-graphs in between them.
+  void UpdateTopoOrder(SubGraph* producer, SubGraph* consumer);
 
  private:
   pir::Block* block_;
@@ -68,6 +72,10 @@ class SubgraphDetector {
   std::unordered_map<pir::Operation*, size_t> op2id_;
   std::vector<SubGraphPtr> subgraph_list_;
   std::unordered_map<pir::Operation*, SubGraphPtr> subgraph_map_;
+  // The sub-graphs in topological order, a fused sub-graph leaves a nullptr.
+  // All the sub-graphs reachable from a sub-graph are after it, so a
+  // dependency check only searches the sub-graphs in between.
+  std::vector<SubGraph*> topo_order_;
 };
 
 std::vector<pir::Value> AnalysisOutputs(const GroupOpsVec& group_ops);
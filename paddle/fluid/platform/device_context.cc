@@ -19,6 +19,7 @@ limitations under the License. */
 #include <set>
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/platform/device/device_wrapper.h"
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
@@ -33,6 +34,10 @@ limitations under the License. */
 #include "paddle/phi/core/memory/allocation/cuda_device_context_allocator.h"
 #endif
 
+#ifdef PADDLE_WITH_XPU
+COMMON_DECLARE_bool(new_executor_xpu_multi_stream);
+#endif
+
 namespace paddle {
 namespace platform {
 
@@ -105,7 +110,20 @@ inline std::unique_ptr<DeviceContext> CreateDeviceContext(
 #endif
   } else if (p.GetType() == phi::AllocationType::XPU) {
 #if defined(PADDLE_WITH_XPU)
-    dev_ctx->SetAllocator(instance.GetAllocator(p).get());
+    // The contexts the new executor creates for its extra streams, which
+    // own a stream each and allocate from the stream safe allocator of it.
+    if (disable_setting_default_stream_for_allocator &&
+        FLAGS_new_executor_xpu_multi_stream) {
+      auto* xpu_ctx = dynamic_cast<phi::XPUContext*>(dev_ctx);
+      PADDLE_ENFORCE_NOT_NULL(
+          xpu_ctx,
+          common::errors::InvalidArgument(
+              "Failed to dynamic_cast dev_ctx into phi::XPUContext."));
+      xpu_ctx->CreateStream();
+      dev_ctx->SetAllocator(instance.GetAllocator(p, xpu_ctx->stream()).get());
+    } else {
+      dev_ctx->SetAllocator(instance.GetAllocator(p).get());
+    }
     dev_ctx->SetGenerator(phi::DefaultXPUGenerator(p.GetDeviceId()).get());
 #endif
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
@@ -66,9 +66,9 @@ class DeviceEvent {
                           MaxDeviceTypes,
                           type_id_));
 #ifndef PADDLE_WITH_CUSTOM_DEVICE
-    // TODO(Aurelius84): only support CPU/CUDA.
-    PADDLE_ENFORCE_LT(type_id_,
-                      3,
+    // TODO(Aurelius84): only support CPU/CUDA/XPU.
+    PADDLE_ENFORCE_LE(type_id_,
+                      DeviceTypeToId(DeviceType::XPU),
                       common::errors::Unavailable(
                           "Currently DeviceEvent do not support %s", place));
 #endif
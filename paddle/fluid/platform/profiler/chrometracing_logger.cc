@@ -132,7 +132,10 @@ void ChromeTracingLogger::LogMemTraceEventNode(
       "current_allocated": %llu,
       "current_reserved": %llu,
       "peak_allocated": %llu,
-      "peak_reserved": %llu
+      "peak_reserved": %llu,
+      "stream": "%llu",
+      "op": "%s",
+      "tensor": "%s"
     }
   },
   )JSON"),
@@ -146,7 +149,10 @@ void ChromeTracingLogger::LogMemTraceEventNode(
       mem_node.CurrentAllocated(),
       mem_node.CurrentReserved(),
       mem_node.PeakAllocated(),
-      mem_node.PeakReserved());
+      mem_node.PeakReserved(),
+      mem_node.Stream(),
+      mem_node.OpName().c_str(),
+      mem_node.TensorName().c_str());
   pid_tid_set_.insert({mem_node.ProcessId(), mem_node.ThreadId()});
 }
 
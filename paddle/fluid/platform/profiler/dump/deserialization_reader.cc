@@ -263,6 +263,9 @@ MemTraceEventNode* DeserializationReader::RestoreMemTraceEventNode(
   mem_event.current_reserved = mem_event_proto.current_reserved();
   mem_event.peak_allocated = mem_event_proto.peak_allocated();
   mem_event.peak_reserved = mem_event_proto.peak_reserved();
+  mem_event.stream = mem_event_proto.stream();
+  mem_event.op_name = mem_event_proto.op_name();
+  mem_event.tensor_name = mem_event_proto.tensor_name();
   return new MemTraceEventNode(mem_event);
 }
 
@@ -153,6 +153,9 @@ void SerializationLogger::LogMemTraceEventNode(
   mem_trace_event->set_current_reserved(mem_node.CurrentReserved());
   mem_trace_event->set_peak_allocated(mem_node.PeakAllocated());
   mem_trace_event->set_peak_reserved(mem_node.PeakReserved());
+  mem_trace_event->set_stream(mem_node.Stream());
+  mem_trace_event->set_op_name(mem_node.OpName());
+  mem_trace_event->set_tensor_name(mem_node.TensorName());
   current_mem_trace_event_node_proto_->set_allocated_mem_event(mem_trace_event);
 }
 
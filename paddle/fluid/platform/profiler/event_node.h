@@ -49,6 +49,9 @@ class MemTraceEventNode {
   uint64_t CurrentReserved() const { return mem_event_.current_reserved; }
   uint64_t PeakAllocated() const { return mem_event_.peak_allocated; }
   uint64_t PeakReserved() const { return mem_event_.peak_reserved; }
+  uint64_t Stream() const { return mem_event_.stream; }
+  const std::string& OpName() const { return mem_event_.op_name; }
+  const std::string& TensorName() const { return mem_event_.tensor_name; }
 
   // member function
   void LogMe(BaseLogger* logger) { logger->LogMemTraceEventNode(*this); }
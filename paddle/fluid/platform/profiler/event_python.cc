@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/platform/profiler/dump/deserialization_reader.h"
 #include "paddle/fluid/platform/profiler/dump/serialization_logger.h"
 #include "paddle/fluid/platform/profiler/extra_info.h"
+#include "paddle/fluid/platform/profiler/peak_memory.h"
 
 namespace paddle::platform {
 
@@ -112,6 +113,9 @@ HostPythonNode* ProfilerResult::CopyTree(HostTraceEventNode* root) {
     mem_python_node->current_reserved = memnode->CurrentReserved();
     mem_python_node->peak_allocated = memnode->PeakAllocated();
     mem_python_node->peak_reserved = memnode->PeakReserved();
+    mem_python_node->stream = memnode->Stream();
+    mem_python_node->op_name = memnode->OpName();
+    mem_python_node->tensor_name = memnode->TensorName();
     host_python_node->mem_node_ptrs.push_back(mem_python_node);
   }
   // copy OperatorSupplementEventNode's information if exists
@@ -185,6 +189,13 @@ void ProfilerResult::Save(const std::string& file_name,
   return;
 }
 
+std::string ProfilerResult::GetPeakMemoryBreakdownReport(size_t top_k) {
+  if (tree_ == nullptr) {
+    return std::string();
+  }
+  return PeakMemoryBreakdownReport(GetPeakMemoryBreakdown(*tree_), top_k);
+}
+
 std::unique_ptr<ProfilerResult> LoadProfilerResult(std::string filename) {
   DeserializationReader reader(filename);
   std::unique_ptr<ProfilerResult> result = reader.Parse();
@@ -97,6 +97,12 @@ struct MemPythonNode {
   uint64_t peak_allocated;
   // peak  reserved memory
   uint64_t peak_reserved;
+  // the stream the allocation is made on, 0 if unknown
+  uint64_t stream;
+  // the innermost host event alive when the memory is allocated or freed
+  std::string op_name;
+  // the tensor the memory is allocated for, empty if unknown
+  std::string tensor_name;
 };
 
 struct HostPythonNode {
@@ -160,6 +166,9 @@ class ProfilerResult {
 
   std::shared_ptr<NodeTrees> GetNodeTrees() { return tree_; }
 
+  // The memory alive at the peak of every place, see GetPeakMemoryBreakdown.
+  std::string GetPeakMemoryBreakdownReport(size_t top_k = 20);
+
   void SetVersion(const std::string& version) { version_ = version; }
 
   void SetSpanIndx(uint32_t span_indx) { span_indx_ = span_indx; }
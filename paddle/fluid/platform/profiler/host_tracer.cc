@@ -63,6 +63,13 @@ void ProcessHostMemEvents(
       event.current_reserved = evt.current_reserved;
       event.peak_allocated = evt.peak_allocated;
       event.peak_reserved = evt.peak_reserved;
+      event.stream = evt.stream;
+      if (evt.op_name != nullptr) {
+        event.op_name = evt.op_name;
+      }
+      if (evt.tensor_name != nullptr) {
+        event.tensor_name = evt.tensor_name;
+      }
       event.process_id = host_mem_events.process_id;
       event.thread_id = tid;
       collector->AddMemEvent(std::move(event));
@@ -33,12 +33,14 @@ class RecordMemEvent {
    * @param place: Device for this memory event.
    * @param size: Memory size allocated or free.
    * @param type: Denote manipulation type for this memory event.
+   * @param stream: The stream the memory is allocated on, 0 if unknown.
    */
   explicit RecordMemEvent(
       const void* ptr,
       const Place& place,
       size_t size,
-      const TracerMemEventType type = TracerMemEventType::Allocate);
+      const TracerMemEventType type = TracerMemEventType::Allocate,
+      uint64_t stream = 0);
 
   // size_cache: In the outer map, key is device type, 'cpu'  or 'gpu', and in
   // the inner map, key is device ip.
@@ -52,5 +54,17 @@ class RecordMemEvent {
   static std::map<const char*, std::map<uint64_t, bool>> has_initialized;
 };
 
+// Attributes the memory events recorded on this thread during its lifetime to
+// the tensor `name`, which must outlive it. The events also carry the name of
+// the innermost RecordEvent, this tells which tensor of the op they are for.
+class RecordMemEventTensorName {
+ public:
+  explicit RecordMemEventTensorName(const std::string& name);
+  ~RecordMemEventTensorName();
+
+ private:
+  const std::string* parent_;
+};
+
 }  // namespace platform
 }  // namespace paddle
@@ -0,0 +1,163 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/profiler/peak_memory.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace paddle {
+namespace platform {
+
+namespace {
+
+struct MemEvent {
+  const MemTraceEventNode* node;
+  // the host event the memory event belongs to
+  const HostTraceEventNode* host;
+};
+
+std::string OpNameOf(const MemEvent& event) {
+  if (!event.node->OpName().empty()) {
+    return event.node->OpName();
+  }
+  std::string host_name = event.host->Name();
+  if (event.host->Type() == TracerEventType::UserDefined &&
+      host_name == "root node") {
+    return "Unknown";
+  }
+  return host_name;
+}
+
+PeakMemoryBreakdown Breakdown(const std::string& place,
+                              std::vector<MemEvent>* events) {
+  std::stable_sort(events->begin(),
+                   events->end(),
+                   [](const MemEvent& lhs, const MemEvent& rhs) {
+                     return lhs.node->TimeStampNs() < rhs.node->TimeStampNs();
+                   });
+  PeakMemoryBreakdown breakdown;
+  breakdown.place = place;
+  size_t peak_index = events->size();
+  for (size_t i = 0; i < events->size(); ++i) {
+    const MemTraceEventNode* node = (*events)[i].node;
+    if (node->Type() == TracerMemEventType::Allocate &&
+        (peak_index == events->size() ||
+         node->CurrentAllocated() > breakdown.peak_allocated)) {
+      peak_index = i;
+      breakdown.peak_allocated = node->CurrentAllocated();
+      breakdown.timestamp_ns = node->TimeStampNs();
+    }
+  }
+  if (peak_index == events->size()) {
+    return breakdown;
+  }
+
+  // addr -> the allocating event
+  std::unordered_map<uint64_t, const MemEvent*> alive;
+  for (size_t i = 0; i <= peak_index; ++i) {
+    const MemEvent& event = (*events)[i];
+    if (event.node->Type() == TracerMemEventType::Allocate) {
+      alive[event.node->Addr()] = &event;
+    } else {
+      alive.erase(event.node->Addr());
+    }
+  }
+
+  std::map<std::pair<std::string, std::string>, PeakMemoryBreakdown::Entry>
+      entries;
+  uint64_t traced_bytes = 0;
+  for (const auto& item : alive) {
+    const MemEvent& event = *item.second;
+    std::string op_name = OpNameOf(event);
+    auto& entry = entries[{op_name, event.node->TensorName()}];
+    entry.op_name = op_name;
+    entry.tensor_name = event.node->TensorName();
+    entry.bytes += event.node->IncreaseBytes();
+    entry.count += 1;
+    traced_bytes += event.node->IncreaseBytes();
+  }
+  for (auto& item : entries) {
+    breakdown.entries.emplace_back(std::move(item.second));
+  }
+  if (breakdown.peak_allocated > traced_bytes) {
+    PeakMemoryBreakdown::Entry entry;
+    entry.op_name = kAllocatedBeforeProfiling;
+    entry.bytes = breakdown.peak_allocated - traced_bytes;
+    breakdown.entries.emplace_back(std::move(entry));
+  }
+  std::stable_sort(breakdown.entries.begin(),
+                   breakdown.entries.end(),
+                   [](const PeakMemoryBreakdown::Entry& lhs,
+                      const PeakMemoryBreakdown::Entry& rhs) {
+                     return lhs.bytes > rhs.bytes;
+                   });
+  return breakdown;
+}
+
+}  // namespace
+
+std::vector<PeakMemoryBreakdown> GetPeakMemoryBreakdown(
+    const NodeTrees& trees) {
+  std::map<std::string, std::vector<MemEvent>> place_events;
+  for (const auto& item : trees.Traverse(true)) {
+    for (const HostTraceEventNode* host : item.second) {
+      for (const MemTraceEventNode* node : host->GetMemTraceEventNodes()) {
+        if (node->Type() == TracerMemEventType::Allocate ||
+            node->Type() == TracerMemEventType::Free) {
+          place_events[node->Place()].push_back({node, host});
+        }
+      }
+    }
+  }
+  std::vector<PeakMemoryBreakdown> breakdowns;
+  for (auto& item : place_events) {
+    breakdowns.emplace_back(Breakdown(item.first, &item.second));
+  }
+  return breakdowns;
+}
+
+std::string PeakMemoryBreakdownReport(
+    const std::vector<PeakMemoryBreakdown>& breakdowns, size_t top_k) {
+  constexpr double kMB = 1024.0 * 1024.0;
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(2);
+  for (const auto& breakdown : breakdowns) {
+    os << "Peak memory of " << breakdown.place << ": "
+       << breakdown.peak_allocated / kMB << " MB allocated at "
+       << breakdown.timestamp_ns << " ns\n";
+    os << std::setw(12) << "Size(MB)" << std::setw(8) << "Count"
+       << "  Op / Tensor\n";
+    for (size_t i = 0; i < breakdown.entries.size() && i < top_k; ++i) {
+      const auto& entry = breakdown.entries[i];
+      os << std::setw(12) << entry.bytes / kMB << std::setw(8) << entry.count
+         << "  " << entry.op_name;
+      if (!entry.tensor_name.empty()) {
+        os << " / " << entry.tensor_name;
+      }
+      os << "\n";
+    }
+    if (breakdown.entries.size() > top_k) {
+      os << "  ... " << breakdown.entries.size() - top_k << " more\n";
+    }
+  }
+  return os.str();
+}
+
+}  // namespace platform
+}  // namespace paddle
@@ -0,0 +1,56 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/platform/profiler/event_node.h"
+
+namespace paddle {
+namespace platform {
+
+// The memory alive when the allocated memory of a place peaks, grouped by the
+// op and the tensor it is allocated for.
+struct PeakMemoryBreakdown {
+  struct Entry {
+    std::string op_name;
+    std::string tensor_name;
+    uint64_t bytes = 0;
+    uint64_t count = 0;
+  };
+
+  std::string place;
+  uint64_t peak_allocated = 0;
+  uint64_t timestamp_ns = 0;
+  // in descending order of bytes, the memory allocated before the profiling
+  // started is an entry with op name kAllocatedBeforeProfiling
+  std::vector<Entry> entries;
+};
+
+constexpr char kAllocatedBeforeProfiling[] = "[before profiling]";
+
+// Replays the Allocate and Free events of `trees` per place up to the event
+// with the largest current_allocated. An allocation without op name is
+// attributed to the host event its memory event belongs to in `trees`.
+std::vector<PeakMemoryBreakdown> GetPeakMemoryBreakdown(const NodeTrees& trees);
+
+// Formats the `top_k` largest entries of every breakdown as a table.
+std::string PeakMemoryBreakdownReport(
+    const std::vector<PeakMemoryBreakdown>& breakdowns, size_t top_k = 20);
+
+}  // namespace platform
+}  // namespace paddle
@@ -26,6 +26,7 @@
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/fluid/platform/profiler/event_python.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/fluid/platform/profiler/host_tracer.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
 #include "paddle/phi/common/place.h"
 
@@ -141,3 +142,33 @@ TEST(ProfilerTest, TestHostTracerForMem) {
   auto profiler_result = profiler->Stop();
   auto nodetree = profiler_result->GetNodeTrees();
 }
+
+TEST(ProfilerTest, TestBoundedEventContainer) {
+  using paddle::platform::EventContainer;
+  // keeps the latest events once its 2 blocks are full
+  EventContainer<int64_t> container(2);
+  const int64_t num_events = int64_t{1} << 23;  // 4 blocks of 16MB
+  for (int64_t i = 0; i < num_events; ++i) {
+    container.Record(i);
+  }
+  auto events = container.Reduce();
+  ASSERT_GT(events.size(), 0u);
+  EXPECT_LT(events.size(), static_cast<size_t>(num_events) / 2);
+  EXPECT_EQ(events.back(), num_events - 1);
+  for (size_t i = 1; i < events.size(); ++i) {
+    EXPECT_EQ(events[i], events[i - 1] + 1);
+  }
+}
+
+TEST(ProfilerTest, TestRecordEventLevel) {
+  using paddle::platform::HostTraceLevel;
+  using phi::RecordEvent;
+  HostTraceLevel::GetInstance().SetLevel(HostTraceLevel::kDisabled);
+  EXPECT_FALSE(RecordEvent::IsEnabled(1));
+
+  HostTraceLevel::GetInstance().SetLevel(1);
+  EXPECT_TRUE(RecordEvent::IsEnabled(1));
+  EXPECT_FALSE(RecordEvent::IsEnabled(2));
+  HostTraceLevel::GetInstance().SetLevel(HostTraceLevel::kDisabled);
+  EXPECT_FALSE(RecordEvent::IsEnabled(1));
+}
@@ -16,6 +16,7 @@
 #include "paddle/fluid/framework/type_defs.h"
 #include "paddle/fluid/platform/profiler/chrometracing_logger.h"
 #include "paddle/fluid/platform/profiler/event_node.h"
+#include "paddle/fluid/platform/profiler/peak_memory.h"
 
 using paddle::framework::AttributeMap;
 using paddle::platform::ChromeTracingLogger;
@@ -32,6 +33,7 @@ using paddle::platform::MemTraceEventNode;
 using paddle::platform::NodeTrees;
 using paddle::platform::OperatorSupplementEvent;
 using paddle::platform::OperatorSupplementEventNode;
+using paddle::platform::PeakMemoryBreakdown;
 using paddle::platform::RuntimeTraceEvent;
 using paddle::platform::TracerEventType;
 using paddle::platform::TracerMemEventType;
@@ -388,3 +390,92 @@ TEST(NodeTreesTest, HandleTrees_case0) {
                    op_supplement_event_node_handle);
   logger.LogExtraInfo(std::unordered_map<std::string, std::string>());
 }
+
+TEST(NodeTreesTest, PeakMemoryBreakdown) {
+  std::list<HostTraceEvent> host_events;
+  std::list<RuntimeTraceEvent> runtime_events;
+  std::list<DeviceTraceEvent> device_events;
+  std::list<MemTraceEvent> mem_events;
+  std::list<OperatorSupplementEvent> op_supplement_events;
+  host_events.emplace_back(
+      std::string("op1"), TracerEventType::Operator, 11000, 20000, 10, 10);
+  host_events.emplace_back(
+      std::string("op2"), TracerEventType::Operator, 21000, 30000, 10, 10);
+  // 100 bytes are allocated before profiling
+  mem_events.emplace_back(11500,
+                          0x1000,
+                          TracerMemEventType::Allocate,
+                          10,
+                          10,
+                          50,
+                          "GPU:0",
+                          150,
+                          200,
+                          150,
+                          200);
+  mem_events.back().tensor_name = "x";
+  mem_events.emplace_back(21500,
+                          0x2000,
+                          TracerMemEventType::Allocate,
+                          10,
+                          10,
+                          30,
+                          "GPU:0",
+                          180,
+                          200,
+                          180,
+                          200);
+  mem_events.back().op_name = "matmul";
+  mem_events.back().tensor_name = "y";
+  mem_events.emplace_back(22000,
+                          0x1000,
+                          TracerMemEventType::Free,
+                          10,
+                          10,
+                          -50,
+                          "GPU:0",
+                          130,
+                          200,
+                          180,
+                          200);
+  mem_events.emplace_back(25000,
+                          0x3000,
+                          TracerMemEventType::Allocate,
+                          10,
+                          10,
+                          20,
+                          "GPU:0",
+                          150,
+                          200,
+                          180,
+                          200);
+  NodeTrees tree(host_events,
+                 runtime_events,
+                 device_events,
+                 mem_events,
+                 op_supplement_events);
+
+  std::vector<PeakMemoryBreakdown> breakdowns =
+      paddle::platform::GetPeakMemoryBreakdown(tree);
+  ASSERT_EQ(breakdowns.size(), 1u);
+  const PeakMemoryBreakdown& breakdown = breakdowns[0];
+  EXPECT_EQ(breakdown.place, "GPU:0");
+  EXPECT_EQ(breakdown.peak_allocated, 180u);
+  EXPECT_EQ(breakdown.timestamp_ns, 21500u);
+  ASSERT_EQ(breakdown.entries.size(), 3u);
+  EXPECT_EQ(breakdown.entries[0].op_name,
+            paddle::platform::kAllocatedBeforeProfiling);
+  EXPECT_EQ(breakdown.entries[0].bytes, 100u);
+  // attributed to the host event without an op name
+  EXPECT_EQ(breakdown.entries[1].op_name, "op1");
+  EXPECT_EQ(breakdown.entries[1].tensor_name, "x");
+  EXPECT_EQ(breakdown.entries[1].bytes, 50u);
+  EXPECT_EQ(breakdown.entries[2].op_name, "matmul");
+  EXPECT_EQ(breakdown.entries[2].tensor_name, "y");
+  EXPECT_EQ(breakdown.entries[2].count, 1u);
+
+  std::string report =
+      paddle::platform::PeakMemoryBreakdownReport(breakdowns, 2);
+  EXPECT_NE(report.find("op1 / x"), std::string::npos);
+  EXPECT_EQ(report.find("matmul"), std::string::npos);
+}
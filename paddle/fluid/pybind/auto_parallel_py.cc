@@ -38,11 +38,13 @@
 #include "paddle/phi/core/distributed/auto_parallel/inferspmd_utils.h"
 #include "paddle/phi/core/distributed/auto_parallel/placement_types.h"
 #include "paddle/phi/core/distributed/auto_parallel/process_mesh.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/batched_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/nd_mesh_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/p_to_r_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/p_to_s_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/r_to_p_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/r_to_s_reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_prefetcher.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_p_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_r_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_s_reshard_function.h"
@@ -757,6 +759,61 @@ void BindAutoParallel(py::module *m) {
       },
       py::return_value_policy::reference);
 
+  m->def(
+      "batched_reshard",
+      [](py::handle py_tensors,
+         const std::vector<TensorDistAttr> &dist_attrs) {
+        auto tensors = CastPyArg2VectorOfTensor(py_tensors.ptr(), 0);
+        std::vector<const phi::distributed::DistTensor *> ins;
+        for (const auto &tensor : tensors) {
+          PADDLE_ENFORCE_EQ(
+              tensor.is_dist_tensor(),
+              true,
+              common::errors::InvalidArgument(
+                  "The tensors of batched_reshard must be DistTensors."));
+          ins.emplace_back(static_cast<phi::distributed::DistTensor *>(
+              tensor.impl().get()));
+        }
+        std::vector<paddle::Tensor> outs;
+        if (ins.empty()) {
+          return outs;
+        }
+        auto *dev_ctx =
+            phi::DeviceContextPool::Instance().Get(ins[0]->place());
+        phi::distributed::BatchedReshardFunction func;
+        for (auto &out : func.Eval(dev_ctx, ins, dist_attrs)) {
+          outs.emplace_back(out);
+        }
+        return outs;
+      },
+      py::return_value_policy::reference);
+
+  m->def(
+      "reshard_prefetch",
+      [](py::handle py_tensor, const TensorDistAttr &dist_attr) {
+        auto tensor = CastPyArg2Tensor(py_tensor.ptr(), 0);
+        PADDLE_ENFORCE_EQ(
+            tensor.is_dist_tensor(),
+            true,
+            common::errors::InvalidArgument(
+                "The tensor of reshard_prefetch must be a DistTensor."));
+        phi::distributed::ReshardPrefetcher::Instance().Prefetch(
+            std::static_pointer_cast<phi::distributed::DistTensor>(
+                tensor.impl()),
+            dist_attr);
+      });
+
+  m->def("reshard_prefetch_release", [](py::handle py_tensor) {
+    auto tensor = CastPyArg2Tensor(py_tensor.ptr(), 0);
+    if (tensor.is_dist_tensor()) {
+      phi::distributed::ReshardPrefetcher::Instance().Release(
+          *static_cast<phi::distributed::DistTensor *>(tensor.impl().get()));
+    }
+  });
+
+  m->def("reshard_prefetch_clear",
+         []() { phi::distributed::ReshardPrefetcher::Instance().Clear(); });
+
   // TODO(liuzhenhai): DistributedMapper is not used for now, but
   // dist_mapper_test need the symbols touch DistributedMapper to be linked,
   // remove it later
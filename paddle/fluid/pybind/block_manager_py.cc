@@ -0,0 +1,53 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pybind/block_manager_py.h"
+
+#include "paddle/phi/kernels/funcs/block_manager.h"
+#include "pybind11/stl.h"
+
+namespace paddle::pybind {
+
+void BindBlockManager(py::module* m) {
+  using phi::funcs::BlockManager;
+  py::class_<BlockManager>(m, "BlockManager", R"DOC(
+    Allocates the blocks of the paged kv cache of block_multihead_attention,
+    sharing the cached blocks of the same prompt prefixes and the blocks of
+    the forked sequences, which are copied on write.
+  )DOC")
+      .def(py::init<int, int>(), py::arg("num_blocks"), py::arg("block_size"))
+      .def("add_sequence",
+           &BlockManager::AddSequence,
+           py::arg("seq_id"),
+           py::arg("token_ids"))
+      .def("append",
+           &BlockManager::Append,
+           py::arg("seq_id"),
+           py::arg("token_ids"))
+      .def("fork", &BlockManager::Fork, py::arg("parent"), py::arg("child"))
+      .def("free", &BlockManager::Free, py::arg("seq_id"))
+      .def("has_sequence", &BlockManager::HasSequence)
+      .def("length", &BlockManager::Length)
+      .def("cached_length", &BlockManager::CachedLength)
+      .def("block_table", &BlockManager::BlockTable)
+      .def("block_tables",
+           &BlockManager::BlockTables,
+           py::arg("seq_ids"),
+           py::arg("max_blocks_per_seq"))
+      .def("take_copies", &BlockManager::TakeCopies)
+      .def("num_free_blocks", &BlockManager::NumFreeBlocks)
+      .def_property_readonly("block_size", &BlockManager::block_size);
+}
+
+}  // namespace paddle::pybind
@@ -35,6 +35,7 @@ limitations under the License. */
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/fluid/distributed/collective/async_load.h"
 #include "paddle/fluid/distributed/collective/process_group_nccl.h"
+#include "paddle/phi/core/distributed/comm_task_manager.h"
 #endif
 
 #if defined(PADDLE_WITH_MPI)
@@ -154,6 +155,95 @@ void BindDistributed(py::module *m) {
               py::arg("sync_op"),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "all_reduce_coalesced",
+              [](distributed::ProcessGroup &self,
+                 py::handle py_tensor_list,
+                 distributed::ReduceOp op,
+                 bool sync_op) {
+                auto tensor_list =
+                    CastPyArg2VectorOfTensor(py_tensor_list.ptr(), 0);
+                std::vector<phi::DenseTensor *> out_dense_list;
+                std::vector<phi::DenseTensor> in_dense_list;
+                for (auto &tensor : tensor_list) {
+                  auto p_dense = std::dynamic_pointer_cast<phi::DenseTensor>(
+                      tensor.impl());
+                  out_dense_list.push_back(p_dense.get());
+                  in_dense_list.push_back(*p_dense);
+                }
+                distributed::AllreduceOptions opts{op};
+                return self.AllReduceCoalesced(out_dense_list,
+                                               in_dense_list,
+                                               opts,
+                                               sync_op,
+                                               /*use_calc_stream*/ false);
+              },
+              py::arg("tensors"),
+              py::arg("op"),
+              py::arg("sync_op"),
+              py::call_guard<py::gil_scoped_release>())
+
+          .def(
+              "broadcast_coalesced",
+              [](distributed::ProcessGroup &self,
+                 py::handle py_tensor_list,
+                 int src,
+                 bool sync_op) {
+                auto tensor_list =
+                    CastPyArg2VectorOfTensor(py_tensor_list.ptr(), 0);
+                std::vector<phi::DenseTensor *> out_dense_list;
+                std::vector<phi::DenseTensor> in_dense_list;
+                for (auto &tensor : tensor_list) {
+                  auto p_dense = std::dynamic_pointer_cast<phi::DenseTensor>(
+                      tensor.impl());
+                  out_dense_list.push_back(p_dense.get());
+                  in_dense_list.push_back(*p_dense);
+                }
+                distributed::BroadcastOptions opts{src};
+                return self.BroadcastCoalesced(out_dense_list,
+                                               in_dense_list,
+                                               opts,
+                                               sync_op,
+                                               /*use_calc_stream*/ false);
+              },
+              py::arg("tensors"),
+              py::arg("src"),
+              py::arg("sync_op"),
+              py::call_guard<py::gil_scoped_release>())
+
+          .def(
+              "all_gather_into_tensor_coalesced",
+              [](distributed::ProcessGroup &self,
+                 py::handle py_out_tensor_list,
+                 py::handle py_in_tensor_list,
+                 bool sync_op) {
+                auto out_tensor_list =
+                    CastPyArg2VectorOfTensor(py_out_tensor_list.ptr(), 0);
+                auto in_tensor_list =
+                    CastPyArg2VectorOfTensor(py_in_tensor_list.ptr(), 0);
+                std::vector<phi::DenseTensor *> out_dense_list;
+                for (auto &tensor : out_tensor_list) {
+                  out_dense_list.push_back(
+                      std::dynamic_pointer_cast<phi::DenseTensor>(
+                          tensor.impl())
+                          .get());
+                }
+                std::vector<phi::DenseTensor> in_dense_list;
+                for (auto &tensor : in_tensor_list) {
+                  in_dense_list.push_back(
+                      *std::dynamic_pointer_cast<phi::DenseTensor>(
+                          tensor.impl()));
+                }
+                return self.AllGatherCoalesced(out_dense_list,
+                                               in_dense_list,
+                                               sync_op,
+                                               /*use_calc_stream*/ false);
+              },
+              py::arg("out"),
+              py::arg("in"),
+              py::arg("sync_op"),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "broadcast",
               [](distributed::ProcessGroup &self,
@@ -1252,7 +1342,31 @@ void BindDistributed(py::module *m) {
                   py::arg("nccl_comm_init_option") = 0,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("group_start", distributed::ProcessGroupNCCL::GroupStart)
-      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd);
+      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd)
+      .def_static(
+          "comm_latency_histograms",
+          [](bool reset) {
+            using phi::distributed::CommTaskManager;
+            py::dict result;
+            for (const auto& item : CommTaskManager::GetLatencyHistograms()) {
+              const auto& histogram = item.second;
+              py::dict stats;
+              stats["count"] = histogram.count;
+              stats["mean_us"] = histogram.sum_us / histogram.count;
+              stats["max_us"] = histogram.max_us;
+              py::list buckets;
+              for (auto bucket : histogram.buckets) {
+                buckets.append(bucket);
+              }
+              stats["buckets"] = buckets;
+              result[py::str(item.first)] = stats;
+            }
+            if (reset) {
+              CommTaskManager::ResetLatencyHistograms();
+            }
+            return result;
+          },
+          py::arg("reset") = false);
 
   py::class_<distributed::AsyncLoad::Task,
              std::shared_ptr<distributed::AsyncLoad::Task>>(*m, "AsyncLoadTask")
@@ -1407,6 +1521,30 @@ void BindDistributed(py::module *m) {
       py::arg("tensor_indices") = std::vector<int64_t>{},
       py::call_guard<py::gil_scoped_release>());
 
+  py::enum_<distributed::CommHookType>(*m, "CommHookType")
+      .value("NONE", distributed::CommHookType::kNone)
+      .value("FP16", distributed::CommHookType::kFP16)
+      .value("BF16", distributed::CommHookType::kBF16)
+      .value("POWER_SGD", distributed::CommHookType::kPowerSGD)
+      .value("TOPK", distributed::CommHookType::kTopK);
+
+  py::class_<distributed::CommHookOptions>(*m, "CommHookOptions")
+      .def(py::init<>())
+      .def_readwrite("type", &distributed::CommHookOptions::type)
+      .def_readwrite("power_sgd_rank",
+                     &distributed::CommHookOptions::power_sgd_rank)
+      .def_readwrite("topk_ratio", &distributed::CommHookOptions::topk_ratio);
+
+  py::class_<distributed::EagerGroupCommStats>(*m, "EagerGroupCommStats")
+      .def_readonly("steps", &distributed::EagerGroupCommStats::steps)
+      .def_readonly("last_bytes", &distributed::EagerGroupCommStats::last_bytes)
+      .def_readonly("total_bytes",
+                    &distributed::EagerGroupCommStats::total_bytes)
+      .def_readonly("last_time_us",
+                    &distributed::EagerGroupCommStats::last_time_us)
+      .def_readonly("total_time_us",
+                    &distributed::EagerGroupCommStats::total_time_us);
+
   py::class_<distributed::EagerReducer,
              std::shared_ptr<distributed::EagerReducer>>(
       *m, "EagerReducer", R"DOC()DOC")
@@ -1418,7 +1556,18 @@ void BindDistributed(py::module *m) {
             self.PrepareForBackward(params);
           },
           py::arg("tensors"),
-          py::call_guard<py::gil_scoped_release>());
+          py::call_guard<py::gil_scoped_release>())
+      .def("set_comm_hook",
+           &distributed::EagerReducer::SetCommHook,
+           py::arg("options"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("get_comm_stats",
+           &distributed::EagerReducer::GetCommStats,
+           py::call_guard<py::gil_scoped_release>())
+      .def("set_grad_as_bucket_view",
+           &distributed::EagerReducer::SetGradAsBucketView,
+           py::arg("enable"),
+           py::call_guard<py::gil_scoped_release>());
 
   py::class_<distributed::ProcessGroupIdMap,
              std::shared_ptr<distributed::ProcessGroupIdMap>>(
@@ -777,6 +777,15 @@ void BindAnalysisConfig(py::module *m) {
       .value("Bfloat16", AnalysisConfig::Precision::kBf16)
       .export_values();
 
+  py::enum_<AnalysisConfig::Int8CalibrationAlgorithm>(
+      analysis_config, "Int8CalibrationAlgorithm")
+      .value("Entropy2", AnalysisConfig::Int8CalibrationAlgorithm::kEntropy2)
+      .value("Entropy", AnalysisConfig::Int8CalibrationAlgorithm::kEntropy)
+      .value("MinMax", AnalysisConfig::Int8CalibrationAlgorithm::kMinMax)
+      .value("Percentile",
+             AnalysisConfig::Int8CalibrationAlgorithm::kPercentile)
+      .export_values();
+
   analysis_config.def(py::init<>())
       .def(py::init<const AnalysisConfig &>())
       .def(py::init<const std::string &>())
@@ -809,6 +818,16 @@ void BindAnalysisConfig(py::module *m) {
              self.SetExecStream(stream.raw_stream());
            })
 #endif
+      .def("enable_gpu_resource_sharing",
+           &AnalysisConfig::EnableGpuResourceSharing,
+           py::arg("max_concurrent_runs") = 4)
+      .def("gpu_resource_sharing_runs",
+           &AnalysisConfig::gpu_resource_sharing_runs)
+      .def("enable_sparse_2_4_weights",
+           &AnalysisConfig::EnableSparse24Weights,
+           py::arg("max_pruned_ratio") = 0.2f)
+      .def("sparse_2_4_weights_enabled",
+           &AnalysisConfig::sparse_2_4_weights_enabled)
       .def("enable_xpu",
            &AnalysisConfig::EnableXpu,
            py::arg("l3_size") = 16 * 1024 * 1024,
@@ -857,6 +876,11 @@ void BindAnalysisConfig(py::module *m) {
       .def("disable_onnxruntime", &AnalysisConfig::DisableONNXRuntime)
       .def("onnxruntime_enabled", &AnalysisConfig::use_onnxruntime)
       .def("enable_ort_optimization", &AnalysisConfig::EnableORTOptimization)
+      .def("enable_ort_tensorrt",
+           &AnalysisConfig::EnableORTTensorRT,
+           py::arg("engine_cache_dir") = "",
+           py::arg("use_fp16") = false)
+      .def("ort_tensorrt_enabled", &AnalysisConfig::ort_tensorrt_enabled)
       .def("use_gpu", &AnalysisConfig::use_gpu)
       .def("use_xpu", &AnalysisConfig::use_xpu)
       .def("gpu_device_id", &AnalysisConfig::gpu_device_id)
@@ -878,6 +902,10 @@ void BindAnalysisConfig(py::module *m) {
       .def("enable_new_executor",
            &AnalysisConfig::EnableNewExecutor,
            py::arg("x") = true)
+      .def("enable_low_latency_run",
+           &AnalysisConfig::EnableLowLatencyRun,
+           py::arg("x") = true)
+      .def("low_latency_run_enabled", &AnalysisConfig::low_latency_run_enabled)
       .def("enable_new_ir", &AnalysisConfig::EnableNewIR, py::arg("x") = true)
       .def("new_ir_enabled", &AnalysisConfig::new_ir_enabled)
       .def("enable_profile", &AnalysisConfig::EnableProfile)
@@ -968,6 +996,29 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::SetTensorRtOptimizationLevel)
       .def("tensorrt_optimization_level",
            &AnalysisConfig::tensorrt_optimization_level)
+      .def("set_tensorrt_engine_build_threads",
+           &AnalysisConfig::SetTensorRtEngineBuildThreads)
+      .def("tensorrt_engine_build_threads",
+           &AnalysisConfig::tensorrt_engine_build_threads)
+      .def("enable_tensorrt_timing_cache",
+           &AnalysisConfig::EnableTensorRtTimingCache)
+      .def("tensorrt_timing_cache_path",
+           &AnalysisConfig::tensorrt_timing_cache_path)
+      .def("set_tensorrt_shape_bucket_num",
+           &AnalysisConfig::SetTensorRtShapeBucketNum)
+      .def("tensorrt_shape_bucket_num",
+           &AnalysisConfig::tensorrt_shape_bucket_num)
+      .def("set_tensorrt_int8_calibration",
+           &AnalysisConfig::SetTensorRtInt8Calibration,
+           py::arg("algorithm"),
+           py::arg("percentile") = 99.99,
+           py::arg("batch_queue_size") = 1)
+      .def("tensorrt_int8_calibration_algorithm",
+           &AnalysisConfig::tensorrt_int8_calibration_algorithm)
+      .def("tensorrt_int8_calibration_percentile",
+           &AnalysisConfig::tensorrt_int8_calibration_percentile)
+      .def("tensorrt_calibration_batch_queue_size",
+           &AnalysisConfig::tensorrt_calibration_batch_queue_size)
       .def("switch_ir_debug",
            &AnalysisConfig::SwitchIrDebug,
            py::arg("x") = true,
@@ -1012,6 +1063,10 @@ void BindAnalysisConfig(py::module *m) {
                     >>> config.enable_mkldnn()
                     >>> config.disable_mkldnn_fc_passes()
             )DOC")
+      .def("enable_mkldnn_weights_prepacking",
+           &AnalysisConfig::EnableMkldnnWeightsPrepacking)
+      .def("mkldnn_weights_prepacking_enabled",
+           &AnalysisConfig::mkldnn_weights_prepacking_enabled)
 #endif
       .def("set_mkldnn_op", &AnalysisConfig::SetMKLDNNOp)
       .def("set_model_buffer", &AnalysisConfig::SetModelBuffer)
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/pybind/io.h"
 
+#include "paddle/fluid/framework/io/async_checkpoint.h"
 #include "paddle/fluid/framework/io/save_load_tensor.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/selected_rows_utils.h"
@@ -142,6 +143,35 @@ void BindIO(pybind11::module *m) {
     return tensor_load;
   });
 
+  py::class_<paddle::framework::AsyncCheckpointSaver>(*m,
+                                                      "AsyncCheckpointSaver")
+      .def(py::init<int>(), py::arg("num_threads") = 4)
+      .def("save",
+           &paddle::framework::AsyncCheckpointSaver::Save,
+           py::arg("dirname"),
+           py::arg("names"),
+           py::arg("tensors"),
+           py::arg("num_shards") = 1,
+           py::call_guard<py::gil_scoped_release>())
+      .def("wait",
+           &paddle::framework::AsyncCheckpointSaver::Wait,
+           py::call_guard<py::gil_scoped_release>());
+
+  m->def("list_checkpoint", &paddle::framework::ListCheckpoint);
+
+  m->def(
+      "load_checkpoint",
+      [](const std::string &dirname, const std::vector<std::string> &names) {
+        std::vector<phi::DenseTensor> tensors(names.size());
+        std::vector<phi::DenseTensor *> outs;
+        for (auto &tensor : tensors) {
+          outs.push_back(&tensor);
+        }
+        paddle::framework::LoadCheckpoint(dirname, names, outs);
+        return tensors;
+      },
+      py::call_guard<py::gil_scoped_release>());
+
   m->def("save_func", &pir::SaveFunction);
 
   m->def("save_combine_func", &pir::SaveCombineFunction);
@@ -168,7 +198,8 @@ void BindIO(pybind11::module *m) {
          py::arg("pir_version"),
          py::arg("overwrite") = true,
          py::arg("readable") = false,
-         py::arg("trainable") = true);
+         py::arg("trainable") = true,
+         py::arg("binary") = false);
   m->def("deserialize_pir_program", &pir::ReadModule);
 }
 }  // namespace pybind
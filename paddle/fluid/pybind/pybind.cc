@@ -57,6 +57,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/lod_tensor_array.h"
 #include "paddle/fluid/framework/new_executor/collect_shape_manager.h"
 #include "paddle/fluid/framework/new_executor/executor_statistics.h"
+#include "paddle/fluid/framework/new_executor/interpreter/instruction_cost_sampler.h"
 #include "paddle/fluid/framework/new_executor/interpreter/job.h"
 #include "paddle/fluid/framework/new_executor/interpreter/plan.h"
 #include "paddle/fluid/framework/new_executor/standalone_executor.h"
@@ -101,6 +102,7 @@ limitations under the License. */
 #include "paddle/fluid/pybind/auto_parallel_py.h"
 #include "paddle/fluid/pybind/bind_cost_model.h"
 #include "paddle/fluid/pybind/bind_fleet_executor.h"
+#include "paddle/fluid/pybind/block_manager_py.h"
 #include "paddle/fluid/pybind/box_helper_py.h"
 #include "paddle/fluid/pybind/communication.h"
 #include "paddle/fluid/pybind/compatible.h"
@@ -1094,6 +1096,7 @@ PYBIND11_MODULE(libpaddle, m) {
   BindEagerStringTensor(&m);
   BindCudaStream(&m);
   BindXpuStream(&m);
+  BindBlockManager(&m);
   BindJit(&m);
   BindEvalFrame(&m);
   BindCustomDevicePy(&m);
@@ -1270,17 +1273,8 @@ PYBIND11_MODULE(libpaddle, m) {
             "Note that a DLPack tensor can be consumed only once."));
 
     PyCapsule_SetName(dltensor->ptr(), "used_dltensor");
-    DLTensor dl = dmt->dl_tensor;
     phi::DenseTensor tensor;
-
-    if (dl.device.device_type == kDLCPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-    if (dl.device.device_type == kDLGPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
-#endif
+    paddle::framework::TensorFromDLPack(dmt, &tensor);
     return tensor;
   });
 
@@ -2430,6 +2424,39 @@ All parameter, weight, gradient are variables in Paddle.
     }
     return stats_map;
   });
+  m.def("get_instruction_cost_stats", []() {
+    using framework::interpreter::CostHistogram;
+    const auto ToDict = [](const CostHistogram &histogram) {
+      py::dict dict;
+      dict["count"] = histogram.count;
+      dict["sum_us"] = histogram.sum_us;
+      std::vector<double> bounds;
+      for (size_t i = 0; i < CostHistogram::kBucketNum; ++i) {
+        bounds.push_back(CostHistogram::BucketBound(i));
+      }
+      dict["bucket_bounds_us"] = bounds;
+      dict["buckets"] = std::vector<uint64_t>(histogram.buckets.begin(),
+                                              histogram.buckets.end());
+      return dict;
+    };
+    py::dict stats;
+    for (const auto &[op_name, cost] :
+         framework::interpreter::InstructionCostSampler::Instance()
+             .Snapshot()) {
+      py::dict op_stats;
+      op_stats["host"] = ToDict(cost.host);
+      op_stats["device"] = ToDict(cost.device);
+      stats[py::str(op_name)] = op_stats;
+    }
+    return stats;
+  });
+  m.def("dump_instruction_cost_prometheus", []() {
+    return framework::interpreter::InstructionCostSampler::Instance()
+        .DumpPrometheus();
+  });
+  m.def("reset_instruction_cost_stats", []() {
+    framework::interpreter::InstructionCostSampler::Instance().Reset();
+  });
   m.def("device_memory_stat_current_value",
         memory::DeviceMemoryStatCurrentValue);
   m.def("device_memory_stat_peak_value", memory::DeviceMemoryStatPeakValue);
@@ -2789,6 +2816,9 @@ All parameter, weight, gradient are variables in Paddle.
            py::return_value_policy::automatic_reference)
       .def("save", &paddle::platform::ProfilerResult::Save)
       .def("get_extra_info", &paddle::platform::ProfilerResult::GetExtraInfo)
+      .def("get_peak_memory_breakdown",
+           &paddle::platform::ProfilerResult::GetPeakMemoryBreakdownReport,
+           py::arg("top_k") = 20)
       .def("get_version", &paddle::platform::ProfilerResult::GetVersion)
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
       .def("get_span_indx", &paddle::platform::ProfilerResult::GetSpanIndx)
@@ -2816,7 +2846,11 @@ All parameter, weight, gradient are variables in Paddle.
       .def_readwrite("peak_allocated",
                      &paddle::platform::MemPythonNode::peak_allocated)
       .def_readwrite("peak_reserved",
-                     &paddle::platform::MemPythonNode::peak_reserved);
+                     &paddle::platform::MemPythonNode::peak_reserved)
+      .def_readwrite("stream", &paddle::platform::MemPythonNode::stream)
+      .def_readwrite("op_name", &paddle::platform::MemPythonNode::op_name)
+      .def_readwrite("tensor_name",
+                     &paddle::platform::MemPythonNode::tensor_name);
 
   py::class_<paddle::platform::DevicePythonNode>(m, "DevicePythonNode")
       .def(py::init<>())
@@ -529,6 +529,9 @@ void SetTensorFromPyArray(phi::DenseTensor *self,
                           const P &place,
                           bool zero_copy) {
   auto array = obj.cast<py::array>();
+  // the array_t converts a non C-contiguous array to a private contiguous
+  // copy, which is shared instead of being copied once more
+  zero_copy = zero_copy || !(array.flags() & py::array::c_style);
   if (py::isinstance<py::array_t<float>>(array)) {
     SetTensorFromPyArrayT<float, P>(self, array, place, zero_copy);
   } else if (py::isinstance<py::array_t<int>>(array)) {
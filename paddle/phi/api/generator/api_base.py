@@ -582,7 +582,43 @@ PADDLE_API {self.get_return_type(inplace_flag=True)} {api_func_name}({self.get_d
 
         return kernel_select_code
 
-    def gene_infer_meta(self, kernel_output_names, code_indent) -> str:
+    def gene_infer_meta_cache_key(self, kernel_name, inplace_flag):
+        # The inputs and attributes of the infer_meta keying its memoized
+        # output metas, None if they can't be keyed or the outputs are inplace
+        kernel_dispatch = self.kernel['dispatch'][kernel_name]
+        if inplace_flag or 'std::vector<Tensor>' in self.outputs['types']:
+            return None
+        if kernel_dispatch and any(
+            tensor_type != 'dense'
+            for tensor_type in kernel_dispatch[0] + kernel_dispatch[1]
+        ):
+            return None
+        input_names = self.inputs['names']
+        attr_names = self.attrs['names']
+        infer_meta_params = (
+            self.infer_meta['param']
+            if self.infer_meta['param'] is not None
+            else input_names + attr_names
+        )
+        cache_key = []
+        for param in infer_meta_params:
+            if param in input_names:
+                input_type = self.inputs['input_info'][param]
+                if input_type == "const Tensor&":
+                    cache_key.append(f"*{PREFIX_TENSOR_NAME}{param}")
+                elif input_type == "const paddle::optional<Tensor>&":
+                    cache_key.append(f"{PREFIX_TENSOR_NAME}{param}")
+                else:
+                    return None
+            elif param in attr_names:
+                if 'paddle::optional' in self.attrs['attr_info'][param][0]:
+                    return None
+                cache_key.append(param)
+        return cache_key
+
+    def gene_infer_meta(
+        self, kernel_output_names, code_indent, cache_key=None
+    ) -> str:
         input_names = self.inputs['names']
         attr_names = self.attrs['names']
         infer_meta = self.infer_meta
@@ -692,8 +728,31 @@ PADDLE_API {self.get_return_type(inplace_flag=True)} {api_func_name}({self.get_d
                     )
 
         param_code = param_code[:-2]
-        return f"""{meta_tensor_code}
+        if cache_key is None:
+            return f"""{meta_tensor_code}
 {code_indent}  phi::{infer_meta['func']}({param_code});
+"""
+
+        cache_outs = []
+        for out_name in kernel_output_names:
+            meta_name = out_name.replace('kernel_', PREFIX_META_TENSOR_NAME)
+            if len(kernel_output_names) == 1:
+                cache_outs.append(f"&{meta_name}")
+            else:
+                cache_outs.append(f"{out_name} ? &{meta_name} : nullptr")
+        cache_outs = ", ".join(cache_outs)
+        cache_add_code = "".join(
+            f"""
+{code_indent}  infer_meta_cache.Add({key});"""
+            for key in cache_key
+        )
+        return f"""{meta_tensor_code}
+{code_indent}  static thread_local InferMetaCache infer_meta_cache;
+{code_indent}  infer_meta_cache.Begin(!kernel_result.is_stride_kernel);{cache_add_code}
+{code_indent}  if (!infer_meta_cache.Apply({{{cache_outs}}})) {{
+{code_indent}    phi::{infer_meta['func']}({param_code});
+{code_indent}    infer_meta_cache.Store({{{cache_outs}}});
+{code_indent}  }}
 """
 
     def gene_trans_flag(self, input_name):
@@ -1297,8 +1356,9 @@ PADDLE_API {self.get_return_type(inplace_flag=True)} {api_func_name}({self.get_d
 {code_indent}    }}"""
         return f"""
 {code_indent}  VLOG(6) << "{self.api} API kernel key: [" << kernel_backend << ", " << kernel_layout << ", "<< kernel_data_type << "]";
+{code_indent}  static thread_local phi::KernelSelectionCache kernel_cache;
 {code_indent}  auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
-{code_indent}      "{kernel_name}", {{kernel_backend, kernel_layout, kernel_data_type}}, true);
+{code_indent}      "{kernel_name}", {{kernel_backend, kernel_layout, kernel_data_type}}, true, &kernel_cache);
 {code_indent}  const auto& kernel = kernel_result.kernel;
 {code_indent}  if (FLAGS_low_precision_op_list) {{
 {code_indent}    phi::KernelFactory::Instance().AddToLowPrecisionKernelList("{self.api}", kernel_data_type);
@@ -1314,7 +1374,7 @@ PADDLE_API {self.get_return_type(inplace_flag=True)} {api_func_name}({self.get_d
 {code_indent}  if(phi::RecordEvent::IsEnabled()){{
 {code_indent}    infer_shape_record_event = new phi::RecordEvent(\"{self.api} infer_meta\", phi::TracerEventType::OperatorInner, 1);
 {code_indent}  }}
-{self.gene_infer_meta(kernel_output_names, code_indent)}
+{self.gene_infer_meta(kernel_output_names, code_indent, self.gene_infer_meta_cache_key(kernel_name, inplace_flag))}
 {code_indent}  if(infer_shape_record_event != nullptr){{
 {code_indent}    delete infer_shape_record_event;
 {code_indent}  }}
@@ -99,13 +99,27 @@ OPTIONAL_VECTOR_DIST_META_IN_TEMPLATE = """
         }}
     }}"""
 INFER_SPMD_TEMPLATE = """
-    auto spmd_info = phi::distributed::{}({});
+    static thread_local SpmdInfoCache spmd_cache;
+    spmd_cache.Begin();{}
+    auto spmd_entry = spmd_cache.Lookup();
+    if (!spmd_entry) {{
+      spmd_entry = spmd_cache.Store(phi::distributed::{}({}));
+    }}
+    const auto& spmd_info = spmd_entry->spmd_info;
     DebugInfoForInferSpmd("{}", spmd_info);
 """
 GENERAL_INFER_SPMD_TEMPLATE = """
-    auto spmd_info = phi::distributed::VariadicReplicatedInferSpmdDynamic({});
+    static thread_local SpmdInfoCache spmd_cache;
+    spmd_cache.Begin();{}
+    auto spmd_entry = spmd_cache.Lookup();
+    if (!spmd_entry) {{
+      spmd_entry = spmd_cache.Store(phi::distributed::VariadicReplicatedInferSpmdDynamic({}));
+    }}
+    const auto& spmd_info = spmd_entry->spmd_info;
     DebugInfoForInferSpmd("{}", spmd_info);
 """
+SPMD_CACHE_KEY_TEMPLATE = """
+    spmd_cache.Add({});"""
 UNSUPPORTED_INFER_SPMD_COMMENT_TEMPLATE = """
     // API `{}` does not support InferSpmd now
 """
@@ -305,8 +319,9 @@ INFER_GLOBAL_SHAPE_TEMPLATE = """
 # 4. Select Kernel
 KERNEL_SELECTION_TEMPLATE = """
       VLOG(6) << "{} API dist branch: kernel key: [" << kernel_backend << ", " << kernel_layout << ", "<< kernel_data_type << "]";
+      static thread_local phi::KernelSelectionCache kernel_cache;
       auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
-          "{}", {{kernel_backend, kernel_layout, kernel_data_type}});
+          "{}", {{kernel_backend, kernel_layout, kernel_data_type}}, false, &kernel_cache);
       const auto& kernel = kernel_result.kernel;
       VLOG(6) << "{} kernel: " << kernel;
       dev_ctx = GetDeviceContextByBackend(kernel_result.has_fallback_cpu ? Backend::CPU : kernel_backend);
@@ -316,7 +331,11 @@ KERNEL_SELECTION_TEMPLATE = """
 # Both Tensor, std::vector<Tensor>, paddle::optional<Tensor> and
 # paddle::optional<std::vector<Tensor>> use the same template
 INPUT_RESHARD_TEMPLATE = """
-      auto dist_input_{name} = ReshardApiInputToKernelInput(dev_ctx, {name}, spmd_info.first[{idx}], "{name}");"""
+      auto dist_input_{name} = spmd_entry->inputs_in_place ? ApiInputToKernelInput({name}) : ReshardApiInputToKernelInput(dev_ctx, {name}, spmd_info.first[{idx}], "{name}", &inputs_resharded);"""
+INPUT_RESHARD_BEGIN_TEMPLATE = """
+      bool inputs_resharded = false;"""
+INPUT_RESHARD_END_TEMPLATE = """
+      spmd_entry->inputs_in_place = !inputs_resharded;"""
 GENERAL_INPUT_RESHARD_TEMPLATE = """
       auto dist_input_{name} = ReshardApiInputToReplicatedKernelInput(dev_ctx, {name}, spmd_info.first[{idx}], "{name}");"""
 UNSUPPORTED_RESHARD_INPUT_COMMENT_TEMPLATE = """
@@ -924,6 +943,7 @@ class DistForwardAPI(ForwardAPI):
         infer_spmd_code = ""
         infer_spmd_func_code = self.infer_meta['spmd_rule']
         infer_spmd_code = INFER_SPMD_TEMPLATE.format(
+            self.generate_spmd_cache_key_code(input_args_code[:-2]),
             infer_spmd_func_code,
             input_args_code[:-2],
             self.api,
@@ -987,6 +1007,7 @@ class DistForwardAPI(ForwardAPI):
             return UNSUPPORTED_INFER_SPMD_COMMENT_TEMPLATE.format(self.api)
 
         infer_spmd_code = GENERAL_INFER_SPMD_TEMPLATE.format(
+            self.generate_spmd_cache_key_code(input_args_code[:-2]),
             input_args_code[:-2],
             self.api,
         )
@@ -995,6 +1016,30 @@ class DistForwardAPI(ForwardAPI):
 
         return input_decl_code + infer_spmd_code
 
+    def generate_spmd_cache_key_code(self, infer_spmd_args) -> str:
+        # every argument of the InferSpmd rule is a part of the key, split at
+        # the commas out of the brackets and the string literals
+        args = []
+        depth = 0
+        in_str = False
+        arg = ""
+        for c in infer_spmd_args:
+            if c == '"':
+                in_str = not in_str
+            elif not in_str and c in "([{<":
+                depth += 1
+            elif not in_str and c in ")]}>":
+                depth -= 1
+            elif not in_str and depth == 0 and c == ",":
+                args.append(arg.strip())
+                arg = ""
+                continue
+            arg += c
+        args.append(arg.strip())
+        return "".join(
+            SPMD_CACHE_KEY_TEMPLATE.format(arg) for arg in args if arg
+        )
+
     def generate_infer_spmd_code(self) -> str:
         if self.infer_meta['spmd_rule'] is not None:
             return self.generate_specialized_infer_spmd_code()
@@ -1337,6 +1382,12 @@ class DistForwardAPI(ForwardAPI):
                 else:
                     # do nothing
                     pass
+            if input_reshard_code:
+                input_reshard_code = (
+                    INPUT_RESHARD_BEGIN_TEMPLATE
+                    + input_reshard_code
+                    + INPUT_RESHARD_END_TEMPLATE
+                )
         else:
             input_reshard_code = (
                 UNSUPPORTED_RESHARD_INPUT_COMMENT_TEMPLATE.format(self.api)
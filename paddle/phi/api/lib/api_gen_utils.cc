@@ -13,11 +13,16 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "paddle/phi/api/lib/api_gen_utils.h"
+
+#include <cstring>
+
 #include "paddle/common/flags.h"
 #include "paddle/phi/core/visit_type.h"
 #include "paddle/phi/kernels/strided_copy_kernel.h"
 
 PHI_DECLARE_bool(use_stride_kernel);
+COMMON_DECLARE_bool(eager_infer_meta_cache);
+COMMON_DECLARE_bool(dist_api_spmd_cache);
 
 #include "glog/logging.h"
 
@@ -194,6 +199,156 @@ std::vector<phi::MetaTensor> MakeMetaTensor(
   return meta_tensors;
 }
 
+/* ----------------- for infer_meta cache --------------------- */
+
+void ApiCallKey::Reset(bool enable) {
+  enabled_ = enable;
+  keyable_ = true;
+  key_.clear();
+  dist_attrs_.clear();
+}
+
+bool ApiCallKey::Matches() const {
+  if (!enabled_ || !keyable_ || !stored_ || key_ != stored_key_ ||
+      dist_attrs_.size() != stored_dist_attrs_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < dist_attrs_.size(); ++i) {
+    if (*dist_attrs_[i] != stored_dist_attrs_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ApiCallKey::Keep() {
+  stored_ = enabled_ && keyable_;
+  if (!stored_) return false;
+  stored_key_.swap(key_);
+  stored_dist_attrs_.clear();
+  for (const auto* dist_attr : dist_attrs_) {
+    stored_dist_attrs_.push_back(*dist_attr);
+  }
+  return true;
+}
+
+void ApiCallKey::AddTensor(const phi::DenseTensor& x) {
+  // the LoDs the outputs share from the inputs are not stored
+  if (!x.lod().empty()) {
+    keyable_ = false;
+    return;
+  }
+  const phi::DDim& dims = x.dims();
+  key_.push_back(dims.size());
+  for (int i = 0; i < dims.size(); ++i) {
+    key_.push_back(dims[i]);
+  }
+  key_.push_back(static_cast<int64_t>(x.dtype()));
+  key_.push_back(static_cast<int64_t>(x.layout()));
+}
+
+void ApiCallKey::Add(const phi::distributed::DistMetaTensor& x) {
+  if (!enabled_) return;
+  // the absent optional inputs
+  if (!x.initialized()) {
+    key_.push_back(-1);
+    return;
+  }
+  const phi::DDim dims = x.dims();
+  key_.push_back(dims.size());
+  for (int i = 0; i < dims.size(); ++i) {
+    key_.push_back(dims[i]);
+  }
+  key_.push_back(static_cast<int64_t>(x.dtype()));
+  dist_attrs_.push_back(&x.dist_attr());
+}
+
+void ApiCallKey::AddDouble(double value) {
+  int64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  key_.push_back(bits);
+}
+
+void ApiCallKey::Add(const std::string& value) {
+  if (!enabled_) return;
+  key_.push_back(static_cast<int64_t>(value.size()));
+  for (char c : value) {
+    key_.push_back(c);
+  }
+}
+
+void ApiCallKey::Add(const phi::Place& place) {
+  if (!enabled_) return;
+  key_.push_back(static_cast<int64_t>(place.GetType()));
+  key_.push_back(place.GetDeviceId());
+}
+
+void ApiCallKey::Add(const phi::IntArray& array) {
+  if (!enabled_) return;
+  key_.push_back(array.FromTensor());
+  Add(array.GetData());
+}
+
+void ApiCallKey::Add(const phi::Scalar& scalar) {
+  if (!enabled_) return;
+  if (scalar.dtype() == phi::DataType::COMPLEX64 ||
+      scalar.dtype() == phi::DataType::COMPLEX128) {
+    keyable_ = false;
+    return;
+  }
+  key_.push_back(static_cast<int64_t>(scalar.dtype()));
+  key_.push_back(scalar.FromTensor());
+  if (scalar.dtype() == phi::DataType::INT64 ||
+      scalar.dtype() == phi::DataType::UINT64) {
+    key_.push_back(scalar.to<int64_t>());
+  } else {
+    AddDouble(scalar.to<double>());
+  }
+}
+
+void InferMetaCache::Begin(bool enable) {
+  Reset(enable && FLAGS_eager_infer_meta_cache);
+}
+
+bool InferMetaCache::Apply(std::initializer_list<phi::MetaTensor*> outs) const {
+  if (!Matches()) {
+    return false;
+  }
+  // the absent outputs, e.g. the grads not required, may differ per call
+  size_t i = 0;
+  for (phi::MetaTensor* out : outs) {
+    bool present = out != nullptr && out->initialized();
+    if (present != stored_outs_[i++].present) {
+      return false;
+    }
+  }
+  i = 0;
+  for (phi::MetaTensor* out : outs) {
+    const OutMeta& meta = stored_outs_[i++];
+    if (meta.present) {
+      out->set_dtype(meta.dtype);
+      out->set_layout(meta.layout);
+      out->set_dims(meta.dims);
+    }
+  }
+  return true;
+}
+
+void InferMetaCache::Store(std::initializer_list<phi::MetaTensor*> outs) {
+  if (!Keep()) return;
+  stored_outs_.clear();
+  for (phi::MetaTensor* out : outs) {
+    if (out != nullptr && out->initialized()) {
+      stored_outs_.push_back({true, out->dims(), out->dtype(), out->layout()});
+    } else {
+      stored_outs_.push_back({false,
+                              phi::DDim(),
+                              phi::DataType::UNDEFINED,
+                              phi::DataLayout::UNDEFINED});
+    }
+  }
+}
+
 phi::DenseTensor* SetKernelOutput(Tensor* out) {
   if (out) {
     if (out->impl() == nullptr) {
@@ -801,6 +956,20 @@ CreateKernelDistOutput(std::vector<Tensor*> out,
   return results;
 }
 
+void SpmdInfoCache::Begin() { Reset(FLAGS_dist_api_spmd_cache); }
+
+std::shared_ptr<SpmdInfoCache::Entry> SpmdInfoCache::Lookup() const {
+  return Matches() ? entry_ : nullptr;
+}
+
+std::shared_ptr<SpmdInfoCache::Entry> SpmdInfoCache::Store(
+    phi::distributed::SpmdInfo&& spmd_info) {
+  auto entry = std::make_shared<Entry>();
+  entry->spmd_info = std::move(spmd_info);
+  entry_ = Keep() ? entry : nullptr;
+  return entry;
+}
+
 void SetReplicatedDistAttrForOutput(
     phi::distributed::DistTensor* out,
     const phi::distributed::ProcessMesh& process_mesh) {
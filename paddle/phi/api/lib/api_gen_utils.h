@@ -14,8 +14,16 @@ limitations under the License. */
 
 #pragma once
 
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "paddle/phi/api/include/tensor.h"
 #include "paddle/phi/backends/all_context.h"
+#include "paddle/phi/common/int_array.h"
+#include "paddle/phi/common/scalar.h"
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
@@ -90,6 +98,115 @@ std::vector<phi::MetaTensor> MakeMetaTensor(
 std::vector<phi::MetaTensor> MakeMetaTensor(
     const std::vector<const phi::TensorBase*>& tensors);
 
+/**
+ * ApiCallKey is the key of a call of a generated API, built from the metas
+ * of its inputs and its attributes, with which the caches of a call site
+ * below find the results stored for the last key.
+ **/
+class ApiCallKey {
+ public:
+  void Add(const phi::DenseTensor& x) {
+    if (enabled_) AddTensor(x);
+  }
+  void Add(const phi::distributed::DistMetaTensor& x);
+  void Add(const std::string& value);
+  void Add(const phi::Place& place);
+  void Add(const phi::IntArray& array);
+  void Add(const phi::Scalar& scalar);
+
+  template <typename T,
+            typename = std::enable_if_t<std::is_arithmetic_v<T> ||
+                                        std::is_enum_v<T>>>
+  void Add(T value) {
+    if (!enabled_) return;
+    if constexpr (std::is_floating_point_v<T>) {
+      AddDouble(static_cast<double>(value));
+    } else {
+      key_.push_back(static_cast<int64_t>(value));
+    }
+  }
+
+  template <typename T>
+  void Add(const std::vector<T>& values) {
+    if (!enabled_) return;
+    key_.push_back(static_cast<int64_t>(values.size()));
+    for (const T& value : values) {
+      Add(value);
+    }
+  }
+
+  template <typename T>
+  void Add(const paddle::optional<T>& value) {
+    if (!enabled_) return;
+    key_.push_back(value ? 1 : 0);
+    if (value) Add(*value);
+  }
+
+ protected:
+  // Starts the key of a call, which is not built if !enable.
+  void Reset(bool enable);
+
+  // Whether the key equals the stored one.
+  bool Matches() const;
+
+  // Stores the key, returns false, dropping the stored one, if it was not
+  // built.
+  bool Keep();
+
+  bool enabled_ = false;
+
+ private:
+  void AddTensor(const phi::DenseTensor& x);
+  void AddDouble(double value);
+
+  // the key is not built if an input or attribute can't be keyed
+  bool keyable_ = false;
+  bool stored_ = false;
+  std::vector<int64_t> key_;
+  std::vector<int64_t> stored_key_;
+  // the dist attrs are compared, but copied only when they are stored
+  std::vector<const phi::distributed::TensorDistAttr*> dist_attrs_;
+  std::vector<phi::distributed::TensorDistAttr> stored_dist_attrs_;
+};
+
+/**
+ * InferMetaCache memoizes the output metas computed by the InferMeta of a
+ * call site for the last key, i.e. the metas of its inputs and its
+ * attributes, so the stable-shape training loops skip the InferMeta. The
+ * generated APIs keep one per kernel as `static thread_local` if
+ * FLAGS_eager_infer_meta_cache is set:
+ *
+ *   cache.Begin(!kernel_result.is_stride_kernel);
+ *   cache.Add(*input_x); cache.Add(axis);
+ *   if (!cache.Apply({&meta_out})) {
+ *     phi::XXXInferMeta(MakeMetaTensor(*input_x), axis, &meta_out);
+ *     cache.Store({&meta_out});
+ *   }
+ **/
+class InferMetaCache : public ApiCallKey {
+ public:
+  // Starts the key of a call, the cache is bypassed if !enable or
+  // FLAGS_eager_infer_meta_cache is not set.
+  void Begin(bool enable);
+
+  // Sets the outputs, nullptr for the absent ones, to the metas stored for
+  // the key, returns false without touching them if there are none.
+  bool Apply(std::initializer_list<phi::MetaTensor*> outs) const;
+
+  // Stores the metas of the outputs the InferMeta computed for the key.
+  void Store(std::initializer_list<phi::MetaTensor*> outs);
+
+ private:
+  struct OutMeta {
+    bool present;
+    phi::DDim dims;
+    phi::DataType dtype;
+    phi::DataLayout layout;
+  };
+
+  std::vector<OutMeta> stored_outs_;
+};
+
 /* ------------------ for output ----------------------- */
 
 phi::DenseTensor* SetKernelOutput(Tensor* out);
@@ -181,6 +298,41 @@ CreateKernelDistOutput(std::vector<Tensor*> out,
 std::shared_ptr<phi::distributed::DistTensor> CreateKernelDistOutput(
     Tensor* out, const phi::distributed::ArgDistAttr& dist_attr);
 
+/**
+ * SpmdInfoCache memoizes the SpmdInfo inferred by the InferSpmd rule of a
+ * dist API call site for the last key, i.e. the global metas and the dist
+ * attrs of its inputs and its attributes, if FLAGS_dist_api_spmd_cache is
+ * set. The entries are shared, so one stays valid while the API calls
+ * itself, e.g. in a reshard. An entry also remembers if none of the inputs
+ * needed a reshard, then they are passed to the kernel unchecked:
+ *
+ *   cache.Begin();
+ *   cache.Add(meta_dist_input_x); cache.Add(axis);
+ *   auto entry = cache.Lookup();
+ *   if (!entry) {
+ *     entry = cache.Store(phi::distributed::XXXInferSpmd(...));
+ *   }
+ **/
+class SpmdInfoCache : public ApiCallKey {
+ public:
+  struct Entry {
+    phi::distributed::SpmdInfo spmd_info;
+    // set by the API if no input was resharded for the spmd_info
+    bool inputs_in_place = false;
+  };
+
+  void Begin();
+
+  // The entry stored for the key, nullptr if there is none.
+  std::shared_ptr<Entry> Lookup() const;
+
+  // Stores the SpmdInfo inferred for the key, returns its entry.
+  std::shared_ptr<Entry> Store(phi::distributed::SpmdInfo&& spmd_info);
+
+ private:
+  std::shared_ptr<Entry> entry_;
+};
+
 // DistTensor need to set initial dist attr after the dims setted, it is
 // constructed based dims and current process mesh, before calling this
 // function, the out should hold correct dims
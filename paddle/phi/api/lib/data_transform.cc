@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/phi/api/lib/data_transform.h"
 
+#include <list>
+#include <mutex>
 #include <sstream>
 
 #include "glog/logging.h"
@@ -25,15 +27,18 @@ limitations under the License. */
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function_registry.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_prefetcher.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/core/visit_type.h"
 #include "paddle/phi/kernels/cast_kernel.h"
 #include "paddle/phi/kernels/contiguous_kernel.h"
+#include "paddle/phi/kernels/funcs/data_layout_transform.h"
 #include "paddle/phi/kernels/transfer_layout_kernel.h"
 
 PHI_DECLARE_bool(use_stride_kernel);
+COMMON_DECLARE_int32(transformed_data_cache_size);
 
 namespace paddle::experimental {
 
@@ -309,10 +314,91 @@ std::vector<phi::DenseTensor> CheckAndTrans2NewContiguousTensor(
   return out;
 }
 
-phi::DenseTensor TransformData(const phi::DenseTensor& tensor,
-                               const phi::TensorArgDef& target_args_def,
-                               const TransformFlag& transform_flag,
-                               bool is_stride_kernel) {
+/**
+ * TransformedDataCache keeps the results of TransformData by their inputs, so
+ * the inputs transformed in every step, e.g. the parameters read by the
+ * kernels of another dtype or place, are transformed once. An entry holds as
+ * long as the allocation of its input lives and its inplace version is not
+ * bumped, i.e. the inputs shall be modified only by the inplace APIs.
+ **/
+class TransformedDataCache {
+ public:
+  // nullptr if FLAGS_transformed_data_cache_size is not positive
+  static TransformedDataCache* Instance() {
+    static TransformedDataCache* cache =
+        FLAGS_transformed_data_cache_size > 0 ? new TransformedDataCache()
+                                              : nullptr;
+    return cache;
+  }
+
+  bool Get(const phi::DenseTensor& tensor,
+           const phi::TensorArgDef& target,
+           int mode,
+           phi::DenseTensor* out) {
+    std::lock_guard<std::mutex> guard(mtx_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (Match(*it, tensor, target, mode)) {
+        *out = it->out;
+        entries_.splice(entries_.begin(), entries_, it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Put(const phi::DenseTensor& tensor,
+           const phi::TensorArgDef& target,
+           int mode,
+           const phi::DenseTensor& out) {
+    std::lock_guard<std::mutex> guard(mtx_);
+    entries_.remove_if([](const Entry& entry) { return entry.x.expired(); });
+    if (entries_.size() >= static_cast<size_t>(
+                               FLAGS_transformed_data_cache_size)) {
+      entries_.pop_back();
+    }
+    entries_.push_front({tensor.Holder(),
+                         tensor.meta(),
+                         const_cast<phi::DenseTensor&>(tensor)
+                             .InplaceVersionCounter()
+                             .CurrentVersion(),
+                         target,
+                         mode,
+                         out});
+  }
+
+ private:
+  struct Entry {
+    std::weak_ptr<phi::Allocation> x;
+    phi::DenseTensorMeta x_meta;
+    uint32_t x_version;
+    phi::TensorArgDef target;
+    int mode;  // the transform flag and the stride kernel, see TransformData
+    phi::DenseTensor out;
+  };
+
+  static bool Match(const Entry& entry,
+                    const phi::DenseTensor& tensor,
+                    const phi::TensorArgDef& target,
+                    int mode) {
+    return entry.mode == mode && !entry.x.expired() &&
+           entry.x.lock() == tensor.Holder() && entry.x_meta == tensor.meta() &&
+           entry.x_version == const_cast<phi::DenseTensor&>(tensor)
+                                  .InplaceVersionCounter()
+                                  .CurrentVersion() &&
+           entry.target.backend == target.backend &&
+           entry.target.layout == target.layout &&
+           entry.target.dtype == target.dtype;
+  }
+
+  std::mutex mtx_;
+  // the most recently used first
+  std::list<Entry> entries_;
+};
+
+phi::DenseTensor TransformDataImpl(const phi::DenseTensor& tensor,
+                                   const phi::TensorArgDef& target_args_def,
+                                   const TransformFlag& transform_flag,
+                                   bool is_stride_kernel) {
   phi::DenseTensor out = tensor;
   bool trans_layout = false;
   bool trans_dtype = false;
@@ -329,11 +415,22 @@ phi::DenseTensor TransformData(const phi::DenseTensor& tensor,
     if (NeedTransform2Contiguous(false, out.meta().is_contiguous())) {
       out = Trans2Contiguous(out);
     }
-    out = TransDataLayout(out, target_args_def.layout);
+    // the layout and the dtype are transformed in one pass when both are
+    phi::DenseTensor fused;
+    if (NeedTransformDataType(
+            tensor.dtype(), target_args_def.dtype, transform_flag) &&
+        phi::funcs::TransDataLayoutAndType(
+            out, target_args_def.layout, target_args_def.dtype, &fused)) {
+      out = fused;
+      trans_dtype = true;
+    } else {
+      out = TransDataLayout(out, target_args_def.layout);
+    }
     trans_layout = true;
   }
 
-  if (NeedTransformDataType(
+  if (!trans_dtype &&
+      NeedTransformDataType(
           tensor.dtype(), target_args_def.dtype, transform_flag)) {
     if (NeedTransform2Contiguous(false, out.meta().is_contiguous())) {
       out = Trans2Contiguous(out);
@@ -359,6 +456,31 @@ phi::DenseTensor TransformData(const phi::DenseTensor& tensor,
   return out;
 }
 
+phi::DenseTensor TransformData(const phi::DenseTensor& tensor,
+                               const phi::TensorArgDef& target_args_def,
+                               const TransformFlag& transform_flag,
+                               bool is_stride_kernel) {
+  TransformedDataCache* cache = TransformedDataCache::Instance();
+  // the pinned input sharing the buffer of its result is left out
+  if (cache == nullptr ||
+      tensor.place().GetType() == AllocationType::GPUPINNED) {
+    return TransformDataImpl(
+        tensor, target_args_def, transform_flag, is_stride_kernel);
+  }
+  const int mode = transform_flag.need_trans_data_type() |
+                   transform_flag.need_trans_backend() << 1 |
+                   transform_flag.need_trans_layout() << 2 |
+                   is_stride_kernel << 3;
+  phi::DenseTensor out;
+  if (cache->Get(tensor, target_args_def, mode, &out)) {
+    return out;
+  }
+  out = TransformDataImpl(
+      tensor, target_args_def, transform_flag, is_stride_kernel);
+  cache->Put(tensor, target_args_def, mode, out);
+  return out;
+}
+
 std::shared_ptr<phi::DenseTensor> PrepareData(
     const Tensor& input,
     const phi::TensorArgDef& target_args_def,
@@ -695,7 +817,8 @@ std::shared_ptr<phi::distributed::DistTensor> ReshardApiInputToKernelInput(
     phi::DeviceContext* dev_ctx,
     const Tensor& tensor,
     const phi::distributed::ArgDistAttr& dist_attr,
-    const std::string& arg_name) {
+    const std::string& arg_name,
+    bool* resharded) {
   PADDLE_ENFORCE_EQ(
       paddle::holds_alternative<phi::distributed::TensorDistAttr>(dist_attr),
       true,
@@ -712,6 +835,15 @@ std::shared_ptr<phi::distributed::DistTensor> ReshardApiInputToKernelInput(
       auto tensor_name = (tensor.name().empty() ? "None" : tensor.name());
       VLOG(4) << "Reshard input: " << argument_name << "(" << tensor_name
               << ") " << ReshardDebugInfo(*dist_tensor, tensor_dist_attr);
+      if (resharded) *resharded = true;
+      auto& prefetcher = phi::distributed::ReshardPrefetcher::Instance();
+      if (!prefetcher.Empty()) {
+        auto prefetched =
+            prefetcher.Fetch(dev_ctx, *dist_tensor, tensor_dist_attr);
+        if (prefetched) {
+          return prefetched;
+        }
+      }
       auto* func = phi::distributed::ChooseProperReshardFunction(
           *dist_tensor, tensor_dist_attr);
       return func->Eval(dev_ctx, *dist_tensor, tensor_dist_attr);
@@ -725,7 +857,8 @@ std::vector<std::shared_ptr<phi::distributed::DistTensor>>
 ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
                              const std::vector<Tensor>& tensors,
                              const phi::distributed::ArgDistAttr& dist_attrs,
-                             const std::string& arg_name) {
+                             const std::string& arg_name,
+                             bool* resharded) {
   PADDLE_ENFORCE_EQ(
       paddle::holds_alternative<std::vector<phi::distributed::TensorDistAttr>>(
           dist_attrs),
@@ -743,7 +876,7 @@ ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
   std::vector<std::shared_ptr<phi::distributed::DistTensor>> out;
   for (size_t i = 0; i < tensors.size(); i++) {
     auto tensor_in = tensors[i].impl();
-    auto dist_attr = tensor_dist_attrs[i];
+    const auto& dist_attr = tensor_dist_attrs[i];
     if (tensor_in) {
       phi::distributed::DistTensor* dist_tensor =
           static_cast<phi::distributed::DistTensor*>(tensor_in.get());
@@ -757,6 +890,7 @@ ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
             (tensors[i].name().empty() ? "None" : tensors[i].name());
         VLOG(4) << "Reshard input: " << argument_name << "(" << tensor_name
                 << ") " << ReshardDebugInfo(*dist_tensor, dist_attr);
+        if (resharded) *resharded = true;
         auto* func = phi::distributed::ChooseProperReshardFunction(*dist_tensor,
                                                                    dist_attr);
         out.push_back(func->Eval(dev_ctx, *dist_tensor, dist_attr));
@@ -775,11 +909,13 @@ paddle::optional<std::shared_ptr<phi::distributed::DistTensor>>
 ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
                              const paddle::optional<Tensor>& tensor,
                              const phi::distributed::ArgDistAttr& dist_attr,
-                             const std::string& arg_name) {
+                             const std::string& arg_name,
+                             bool* resharded) {
   if (tensor) {
     VLOG(6) << "Optional ApiIn to Replicated KernelIn.";
     return paddle::make_optional<std::shared_ptr<phi::distributed::DistTensor>>(
-        ReshardApiInputToKernelInput(dev_ctx, *tensor, dist_attr, arg_name));
+        ReshardApiInputToKernelInput(
+            dev_ctx, *tensor, dist_attr, arg_name, resharded));
   }
   return paddle::none;
 }
@@ -789,12 +925,49 @@ ReshardApiInputToKernelInput(
     phi::DeviceContext* dev_ctx,
     const paddle::optional<std::vector<Tensor>>& tensors,
     const phi::distributed::ArgDistAttr& dist_attrs,
-    const std::string& arg_name) {
+    const std::string& arg_name,
+    bool* resharded) {
   if (tensors) {
     VLOG(6) << "Optional ApiIn to Replicated KernelIn.";
     return paddle::make_optional<
         std::vector<std::shared_ptr<phi::distributed::DistTensor>>>(
-        ReshardApiInputToKernelInput(dev_ctx, *tensors, dist_attrs, arg_name));
+        ReshardApiInputToKernelInput(
+            dev_ctx, *tensors, dist_attrs, arg_name, resharded));
+  }
+  return paddle::none;
+}
+
+std::shared_ptr<phi::distributed::DistTensor> ApiInputToKernelInput(
+    const Tensor& tensor) {
+  return std::static_pointer_cast<phi::distributed::DistTensor>(
+      tensor.impl());
+}
+
+std::vector<std::shared_ptr<phi::distributed::DistTensor>>
+ApiInputToKernelInput(const std::vector<Tensor>& tensors) {
+  std::vector<std::shared_ptr<phi::distributed::DistTensor>> out;
+  out.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    out.push_back(ApiInputToKernelInput(tensor));
+  }
+  return out;
+}
+
+paddle::optional<std::shared_ptr<phi::distributed::DistTensor>>
+ApiInputToKernelInput(const paddle::optional<Tensor>& tensor) {
+  if (tensor) {
+    return paddle::make_optional<std::shared_ptr<phi::distributed::DistTensor>>(
+        ApiInputToKernelInput(*tensor));
+  }
+  return paddle::none;
+}
+
+paddle::optional<std::vector<std::shared_ptr<phi::distributed::DistTensor>>>
+ApiInputToKernelInput(const paddle::optional<std::vector<Tensor>>& tensors) {
+  if (tensors) {
+    return paddle::make_optional<
+        std::vector<std::shared_ptr<phi::distributed::DistTensor>>>(
+        ApiInputToKernelInput(*tensors));
   }
   return paddle::none;
 }
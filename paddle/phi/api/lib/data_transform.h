@@ -188,30 +188,48 @@ inline bool NeedTransformPlace(const phi::Place& src_place,
 
 /* ------------------ for auto parallel ----------------------- */
 
+// `resharded` is set to true if the inputs are resharded
 std::shared_ptr<phi::distributed::DistTensor> ReshardApiInputToKernelInput(
     phi::DeviceContext* dev_ctx,
     const Tensor& tensor,
     const phi::distributed::ArgDistAttr& dist_attr,
-    const std::string& arg_name = "");
+    const std::string& arg_name = "",
+    bool* resharded = nullptr);
 
 std::vector<std::shared_ptr<phi::distributed::DistTensor>>
 ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
                              const std::vector<Tensor>& tensor,
                              const phi::distributed::ArgDistAttr& dist_attr,
-                             const std::string& arg_name = "");
+                             const std::string& arg_name = "",
+                             bool* resharded = nullptr);
 
 paddle::optional<std::shared_ptr<phi::distributed::DistTensor>>
 ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
                              const paddle::optional<Tensor>& tensor,
                              const phi::distributed::ArgDistAttr& dist_attr,
-                             const std::string& arg_name = "");
+                             const std::string& arg_name = "",
+                             bool* resharded = nullptr);
 
 paddle::optional<std::vector<std::shared_ptr<phi::distributed::DistTensor>>>
 ReshardApiInputToKernelInput(
     phi::DeviceContext* dev_ctx,
     const paddle::optional<std::vector<Tensor>>& tensors,
     const phi::distributed::ArgDistAttr& dist_attr,
-    const std::string& arg_name = "");
+    const std::string& arg_name = "",
+    bool* resharded = nullptr);
+
+// The kernel inputs of the API inputs known to need no reshard.
+std::shared_ptr<phi::distributed::DistTensor> ApiInputToKernelInput(
+    const Tensor& tensor);
+
+std::vector<std::shared_ptr<phi::distributed::DistTensor>>
+ApiInputToKernelInput(const std::vector<Tensor>& tensors);
+
+paddle::optional<std::shared_ptr<phi::distributed::DistTensor>>
+ApiInputToKernelInput(const paddle::optional<Tensor>& tensor);
+
+paddle::optional<std::vector<std::shared_ptr<phi::distributed::DistTensor>>>
+ApiInputToKernelInput(const paddle::optional<std::vector<Tensor>>& tensors);
 
 void SetInplaceOutputCorrectDistAttr(
     phi::DeviceContext* dev_ctx,
@@ -94,6 +94,36 @@ struct CommonMemEvent {
         current_reserved(current_reserved),
         peak_allocated(peak_allocated),
         peak_reserved(peak_reserved) {}
+  CommonMemEvent(std::function<void *(size_t)> arena_allocator,
+                 uint64_t timestamp_ns,
+                 uint64_t addr,
+                 TracerMemEventType type,
+                 int64_t increase_bytes,
+                 const Place &place,
+                 uint64_t current_allocated,
+                 uint64_t current_reserved,
+                 uint64_t peak_allocated,
+                 uint64_t peak_reserved,
+                 uint64_t stream,
+                 const std::string &op_name_str,
+                 const std::string &tensor_name_str)
+      : CommonMemEvent(timestamp_ns,
+                       addr,
+                       type,
+                       increase_bytes,
+                       place,
+                       current_allocated,
+                       current_reserved,
+                       peak_allocated,
+                       peak_reserved) {
+    this->stream = stream;
+    auto buf = static_cast<char *>(arena_allocator(op_name_str.length() + 1));
+    strncpy(buf, op_name_str.c_str(), op_name_str.length() + 1);
+    op_name = buf;
+    buf = static_cast<char *>(arena_allocator(tensor_name_str.length() + 1));
+    strncpy(buf, tensor_name_str.c_str(), tensor_name_str.length() + 1);
+    tensor_name = buf;
+  }
   uint64_t timestamp_ns;
   uint64_t addr;
   TracerMemEventType type;
@@ -103,6 +133,12 @@ struct CommonMemEvent {
   uint64_t current_reserved;
   uint64_t peak_allocated;
   uint64_t peak_reserved;
+  // the stream the allocation is made on, 0 if unknown
+  uint64_t stream = 0;
+  // the innermost RecordEvent alive when the event is recorded
+  const char *op_name = nullptr;  // not owned, designed for performance
+  // see RecordMemEventTensorName
+  const char *tensor_name = nullptr;  // not owned, designed for performance
 };
 
 struct OperatorSupplementOriginEvent {
@@ -32,6 +32,15 @@ static constexpr uint32_t kDefaultTraceLevel = 4;
 class TEST_API RecordEvent {
  public:
   static bool IsEnabled();
+
+  // Whether a RecordEvent of the level does anything. Check it before
+  // building a name that is costly to build.
+  static bool IsEnabled(uint32_t level);
+
+  // Returns the name of the innermost RecordEvent recorded by the host event
+  // recorder that is alive on the calling thread, nullptr if there is none.
+  static const char* CurrentName();
+
   /**
    * @param name If your string argument has a longer lifetime (e.g.: string
    * literal, static variables, etc) than the event, use 'const char* name'.
@@ -72,7 +81,12 @@ class TEST_API RecordEvent {
   // Sometimes it's inconvenient to use RAII
   void End();
 
-  ~RecordEvent() { End(); }
+  ~RecordEvent() {
+    // End is a no-op unless the event was started, skip the call
+    if (is_enabled_ || is_pushed_) {
+      End();
+    }
+  }
 
  private:
   void OriginalConstruct(const std::string& name,
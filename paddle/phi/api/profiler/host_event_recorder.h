@@ -14,14 +14,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <type_traits>
 #include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/common/macros.h"
 #include "paddle/phi/common/thread_data_registry.h"
 #include "paddle/phi/core/os_info.h"
 
+PHI_DECLARE_int32(host_event_recorder_max_blocks);
+
 namespace phi {
 
 template <typename HeadType, typename... RestTypes>
@@ -41,9 +45,16 @@ struct ContainsStdString<TailType>
 template <typename EventType>
 class EventContainer {
  public:
-  EventContainer() {
-    event_blocks_ = cur_event_block_ = new EventBlock;
+  // Keep at most max_event_blocks blocks of events if it is positive, in
+  // which case the oldest block is overwritten once they are all full, so
+  // only the latest events are kept.
+  explicit EventContainer(int max_event_blocks = 0)
+      : max_event_blocks_(max_event_blocks > 0 ? std::max(max_event_blocks, 2)
+                                               : 0) {
     str_blocks_ = cur_str_block_ = new StringBlock;
+    event_blocks_ = cur_event_block_ = new EventBlock;
+    cur_event_block_->first_str_block = cur_str_block_;
+    num_event_blocks_ = 1;
   }
   ~EventContainer() {
     Reduce();
@@ -72,6 +83,8 @@ class EventContainer {
   char *GetStrBufFromArena(size_t size) { return GetStringStorage(size); }
 
  private:
+  struct StringBlock;
+
   struct EventBlock {
     union InitDeferedEvent {
       InitDeferedEvent() {}
@@ -82,7 +95,7 @@ class EventContainer {
 
     static constexpr size_t kBlockSize = 1 << 24;  // 16 MB
     static constexpr size_t kAvailSize =
-        kBlockSize - sizeof(size_t) - sizeof(nullptr);
+        kBlockSize - sizeof(size_t) - 2 * sizeof(nullptr);
     static constexpr size_t kNumEvents = kAvailSize / sizeof(InitDeferedEvent);
     static constexpr size_t kPadSize =
         kAvailSize - kNumEvents * sizeof(InitDeferedEvent);
@@ -93,6 +106,9 @@ class EventContainer {
 
     size_t offset = 0;
     EventBlock *next = nullptr;
+    // the string block in use when the block was started, the strings of
+    // its events are in this block or the later ones
+    StringBlock *first_str_block = nullptr;
     InitDeferedEvent events[kNumEvents];
     char padding[kPadSize];
   };
@@ -132,6 +148,11 @@ class EventContainer {
 
   char *GetStringStorage(size_t sz);
 
+  // Free the string blocks before first_used.
+  void ReleaseStringBlocks(StringBlock *first_used);
+
+  const int max_event_blocks_;
+  int num_event_blocks_ = 0;
   EventBlock *event_blocks_ = nullptr;
   EventBlock *cur_event_block_ = nullptr;
   StringBlock *str_blocks_ = nullptr;
@@ -155,6 +176,8 @@ std::vector<EventType> EventContainer<EventType>::Reduce() {
     cur = next;
   }
   event_blocks_ = cur_event_block_ = new EventBlock;
+  cur_event_block_->first_str_block = cur_str_block_;
+  num_event_blocks_ = 1;
   return all_events;
 }
 
@@ -162,8 +185,20 @@ template <typename EventType>
 EventType *EventContainer<EventType>::GetEventStorage() {
   if (UNLIKELY(cur_event_block_->offset >=
                EventBlock::kNumEvents)) {  // another block
-    cur_event_block_->next = new EventBlock;
+    if (max_event_blocks_ > 0 && num_event_blocks_ >= max_event_blocks_) {
+      // overwrite the oldest block, and drop the strings only it refers to
+      auto *oldest = event_blocks_;
+      event_blocks_ = oldest->next;
+      oldest->offset = 0;
+      oldest->next = nullptr;
+      cur_event_block_->next = oldest;
+      ReleaseStringBlocks(event_blocks_->first_str_block);
+    } else {
+      cur_event_block_->next = new EventBlock;
+      ++num_event_blocks_;
+    }
     cur_event_block_ = cur_event_block_->next;
+    cur_event_block_->first_str_block = cur_str_block_;
   }
   auto &obj = cur_event_block_->events[cur_event_block_->offset].event;
   ++cur_event_block_->offset;
@@ -182,6 +217,15 @@ char *EventContainer<EventType>::GetStringStorage(size_t sz) {
   return storage;
 }
 
+template <typename EventType>
+void EventContainer<EventType>::ReleaseStringBlocks(StringBlock *first_used) {
+  while (str_blocks_ != first_used) {
+    auto *next = str_blocks_->next;
+    delete str_blocks_;
+    str_blocks_ = next;
+  }
+}
+
 template <typename EventType>
 struct ThreadEventSection {
   std::string thread_name;
@@ -192,7 +236,8 @@ struct ThreadEventSection {
 template <typename EventType>
 class ThreadEventRecorder {
  public:
-  ThreadEventRecorder() {
+  ThreadEventRecorder()
+      : base_evt_cntr_(FLAGS_host_event_recorder_max_blocks) {
     thread_id_ = GetCurrentThreadSysId();
     thread_name_ = GetCurrentThreadName();
   }
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
 namespace phi {
 
 class HostTraceLevel {
@@ -29,11 +32,32 @@ class HostTraceLevel {
     return trace_level_ >= static_cast<int64_t>(level);
   }
 
-  void SetLevel(int64_t trace_level) { trace_level_ = trace_level; }
+  // Whether a RecordEvent of the level does anything, i.e. it is traced or
+  // pushed to nvtx, which takes a single compare on the hot path.
+  bool NeedRecord(uint32_t level) {
+    return record_level_ >= static_cast<int64_t>(level);
+  }
+
+  void SetLevel(int64_t trace_level) {
+    trace_level_ = trace_level;
+    UpdateRecordLevel();
+  }
+
+  void SetNvprofHook(bool enabled) {
+    nvprof_hook_ = enabled;
+    UpdateRecordLevel();
+  }
 
  private:
+  void UpdateRecordLevel() {
+    record_level_ =
+        nvprof_hook_ ? std::numeric_limits<int64_t>::max() : trace_level_;
+  }
+
   // Verbose trace level, works like VLOG(level)
   int trace_level_ = kDisabled;
+  bool nvprof_hook_ = false;
+  int64_t record_level_ = kDisabled;
 };
 
 struct HostTracerOptions {
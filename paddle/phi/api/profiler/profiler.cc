@@ -14,11 +14,13 @@ limitations under the License. */
 
 #include "paddle/phi/api/profiler/profiler.h"
 
+#include <iterator>
 #include <mutex>  // NOLINT
 #include <random>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "glog/logging.h"
 
@@ -96,10 +98,37 @@ void PopEvent(const std::string &name, const EventRole role, std::string attr) {
       EventType::kPopRange, name, ProfilerHelper::g_thread_id, role, attr);
 }
 
+namespace {
+
+// The names of the RecordEvents alive on this thread, innermost last. Only
+// the events recorded by the host event recorder are pushed.
+thread_local std::vector<const char *> g_record_event_names;
+
+void PopRecordEventName(const char *name) {
+  for (auto iter = g_record_event_names.rbegin();
+       iter != g_record_event_names.rend();
+       ++iter) {
+    if (*iter == name) {
+      g_record_event_names.erase(std::next(iter).base());
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+const char *RecordEvent::CurrentName() {
+  return g_record_event_names.empty() ? nullptr : g_record_event_names.back();
+}
+
 RecordEvent::RecordEvent(const char *name,
                          const TracerEventType type,
                          uint32_t level,
                          const EventRole role) {
+  // the only check made when neither tracing nor the nvtx hook is on
+  if (LIKELY(HostTraceLevel::GetInstance().NeedRecord(level) == false)) {
+    return;
+  }
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (ProfilerHelper::g_enable_nvprof_hook) {
@@ -128,12 +157,16 @@ RecordEvent::RecordEvent(const char *name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  g_record_event_names.push_back(shallow_copy_name_);
 }
 
 RecordEvent::RecordEvent(const std::string &name,
                          const TracerEventType type,
                          uint32_t level,
                          const EventRole role) {
+  if (LIKELY(HostTraceLevel::GetInstance().NeedRecord(level) == false)) {
+    return;
+  }
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (ProfilerHelper::g_enable_nvprof_hook) {
@@ -160,6 +193,7 @@ RecordEvent::RecordEvent(const std::string &name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  g_record_event_names.push_back(name_->c_str());
 }
 
 RecordEvent::RecordEvent(const std::string &name,
@@ -167,6 +201,9 @@ RecordEvent::RecordEvent(const std::string &name,
                          const TracerEventType type,
                          uint32_t level,
                          const EventRole role) {
+  if (LIKELY(HostTraceLevel::GetInstance().NeedRecord(level) == false)) {
+    return;
+  }
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (ProfilerHelper::g_enable_nvprof_hook) {
@@ -194,6 +231,7 @@ RecordEvent::RecordEvent(const std::string &name,
   name_ = new std::string(name);
   start_ns_ = PosixInNsec();
   attr_ = new std::string(attr);
+  g_record_event_names.push_back(name_->c_str());
 }
 
 void RecordEvent::OriginalConstruct(const std::string &name,
@@ -227,9 +265,11 @@ void RecordEvent::End() {
   if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
     uint64_t end_ns = PosixInNsec();
     if (LIKELY(shallow_copy_name_ != nullptr)) {
+      PopRecordEventName(shallow_copy_name_);
       HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
           shallow_copy_name_, start_ns_, end_ns, role_, type_);
     } else if (name_ != nullptr) {
+      PopRecordEventName(name_->c_str());
       if (attr_ == nullptr) {
         HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
             *name_, start_ns_, end_ns, role_, type_);
@@ -271,6 +311,10 @@ bool RecordEvent::IsEnabled() {
          ProfilerHelper::g_state != ProfilerState::kDisabled;
 }
 
+bool RecordEvent::IsEnabled(uint32_t level) {
+  return HostTraceLevel::GetInstance().NeedRecord(level);
+}
+
 RecordOpInfoSupplement::RecordOpInfoSupplement(
     const std::string &type,
     const std::vector<std::pair<const char *, std::vector<DDim>>> &input_shapes,
@@ -329,6 +329,12 @@ struct MemTraceEvent {
   uint64_t peak_allocated;
   // current peak reserved memory
   uint64_t peak_reserved;
+  // the stream the allocation is made on, 0 if unknown
+  uint64_t stream = 0;
+  // the innermost host event alive when the memory is allocated or freed
+  std::string op_name;
+  // the tensor the memory is allocated for, empty if unknown
+  std::string tensor_name;
 };
 
 }  // namespace phi
@@ -326,6 +326,24 @@ class CustomDevice : public DeviceInterface {
     }
   }
 
+  void MemoryCopyD2DBatch(size_t dev_id,
+                          void* const* dsts,
+                          const void* const* srcs,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr) override {
+    if (stream && stream->raw_stream() &&
+        pimpl_->async_memory_copy_d2d_batch) {
+      const auto device = &devices_pool[dev_id];
+      C_Stream c_stream = reinterpret_cast<C_Stream>(stream->raw_stream());
+      PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->async_memory_copy_d2d_batch(
+          device, c_stream, dsts, srcs, sizes, count));
+    } else {
+      DeviceInterface::MemoryCopyD2DBatch(
+          dev_id, dsts, srcs, sizes, count, stream);
+    }
+  }
+
   void MemoryCopyP2P(const Place& dst_place,
                      void* dst,
                      size_t src_dev_id,
@@ -1006,6 +1024,7 @@ bool ValidCustomCustomRuntimeParams(const CustomRuntimeParams* params) {
   CHECK_INTERFACE(async_memory_copy_d2h, false);
   CHECK_INTERFACE(async_memory_copy_d2d, false);
   CHECK_INTERFACE(async_memory_copy_p2p, false);
+  CHECK_INTERFACE(async_memory_copy_d2d_batch, false);
 
   CHECK_INTERFACE(get_device_count, true);
   CHECK_INTERFACE(get_device_list, true);
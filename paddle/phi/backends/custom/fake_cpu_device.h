@@ -60,6 +60,18 @@ C_Status AsyncMemCpy(const C_Device device,
   return C_SUCCESS;
 }
 
+C_Status AsyncMemCpyBatch(const C_Device device,
+                          C_Stream stream,
+                          void *const *dsts,
+                          const void *const *srcs,
+                          const size_t *sizes,
+                          size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    memcpy(dsts[i], srcs[i], sizes[i]);
+  }
+  return C_SUCCESS;
+}
+
 C_Status Allocate(const C_Device device, void **ptr, size_t size) {
   if (global_free_memory >= size) {
     *ptr = malloc(size);
@@ -262,6 +274,7 @@ void InitFakeCPUDevice(CustomRuntimeParams *params) {
   params->interface->async_memory_copy_h2d = AsyncMemCpy;
   params->interface->async_memory_copy_d2d = AsyncMemCpy;
   params->interface->async_memory_copy_d2h = AsyncMemCpy;
+  params->interface->async_memory_copy_d2d_batch = AsyncMemCpyBatch;
   params->interface->device_memory_allocate = Allocate;
   params->interface->host_memory_allocate = Allocate;
   params->interface->unified_memory_allocate = Allocate;
@@ -158,6 +158,17 @@ void DeviceInterface::MemoryCopyP2P(const Place& dst_place,
   INTERFACE_UNIMPLEMENT;
 }
 
+void DeviceInterface::MemoryCopyD2DBatch(size_t dev_id,
+                                         void* const* dsts,
+                                         const void* const* srcs,
+                                         const size_t* sizes,
+                                         size_t count,
+                                         const stream::Stream* stream) {
+  for (size_t i = 0; i < count; ++i) {
+    MemoryCopyD2D(dev_id, dsts[i], srcs[i], sizes[i], stream);
+  }
+}
+
 void* DeviceInterface::MemoryAllocate(size_t dev_id, size_t size) {
   INTERFACE_UNIMPLEMENT;
   return nullptr;
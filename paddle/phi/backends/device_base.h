@@ -140,6 +140,15 @@ class DeviceInterface {  // Driver / Runtime
                              size_t size,
                              const stream::Stream* stream = nullptr);
 
+  // The copies of sizes[i] bytes from srcs[i] to dsts[i] for i < count, one
+  // MemoryCopyD2D each by default.
+  virtual void MemoryCopyD2DBatch(size_t dev_id,
+                                  void* const* dsts,
+                                  const void* const* srcs,
+                                  const size_t* sizes,
+                                  size_t count,
+                                  const stream::Stream* stream = nullptr);
+
   virtual void* MemoryAllocate(size_t dev_id, size_t size);
 
   virtual void MemoryDeallocate(size_t dev_id, void* ptr, size_t size);
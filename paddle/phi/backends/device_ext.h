@@ -447,7 +447,26 @@ struct C_DeviceInterface {
                                     const void* src,
                                     size_t size);
 
-  void* reserved_mem_api[8];
+  /**
+   * @brief Asynchonrize batched memory copy from device to device, i.e. the
+   * copies of sizes[i] bytes from srcs[i] to dsts[i] for i < count in a
+   * single call, optional
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void**]     dsts
+   * @param[void**]     srcs
+   * @param[size_t*]    sizes
+   * @param[size_t]     count
+   */
+  C_Status (*async_memory_copy_d2d_batch)(const C_Device device,
+                                          C_Stream stream,
+                                          void* const* dsts,
+                                          const void* const* srcs,
+                                          const size_t* sizes,
+                                          size_t count);
+
+  void* reserved_mem_api[7];
 
   //////////////
   // info api //
@@ -136,6 +136,15 @@ void Device::MemoryCopyP2P(const Place& dst_place,
   impl_->MemoryCopyP2P(dst_place, dst, dev_id_, src, size, stream);
 }
 
+void Device::MemoryCopyD2DBatch(void* const* dsts,
+                                const void* const* srcs,
+                                const size_t* sizes,
+                                size_t count,
+                                const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->MemoryCopyD2DBatch(dev_id_, dsts, srcs, sizes, count, stream);
+}
+
 void* Device::MemoryAllocate(size_t size) {
   CheckInitialized();
   return impl_->MemoryAllocate(dev_id_, size);
@@ -98,6 +98,14 @@ class Device final {
                      size_t size,
                      const stream::Stream* stream = nullptr);
 
+  // Copy sizes[i] bytes from srcs[i] to dsts[i] for i < count, in a single
+  // call if the device supports it.
+  void MemoryCopyD2DBatch(void* const* dsts,
+                          const void* const* srcs,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr);
+
   void* MemoryAllocate(size_t size);
 
   void MemoryDeallocate(void* ptr, size_t size);
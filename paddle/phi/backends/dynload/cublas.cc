@@ -33,4 +33,8 @@ CUBLAS_BLAS_ROUTINE_EACH_R3(DEFINE_WRAP);
 #ifdef CUBLAS_BLAS_ROUTINE_EACH_R4
 CUBLAS_BLAS_ROUTINE_EACH_R4(DEFINE_WRAP);
 #endif
+
+#ifdef CUBLAS_BLAS_ROUTINE_EACH_R5
+CUBLAS_BLAS_ROUTINE_EACH_R5(DEFINE_WRAP);
+#endif
 }  // namespace phi::dynload
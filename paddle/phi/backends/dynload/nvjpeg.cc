@@ -20,4 +20,8 @@ void *nvjpeg_dso_handle;
 
 NVJPEG_RAND_ROUTINE_EACH(DEFINE_WRAP);
 
+#ifdef NVJPEG_RAND_ROUTINE_EACH_R2
+NVJPEG_RAND_ROUTINE_EACH_R2(DEFINE_WRAP);
+#endif
+
 }  // namespace phi::dynload
@@ -11,6 +11,7 @@ limitations under the License. */
 #pragma once
 
 #ifdef PADDLE_WITH_CUDA
+#include <cuda.h>
 #include <nvjpeg.h>
 
 #include <mutex>  // NOLINT
@@ -39,13 +40,27 @@ extern void *nvjpeg_dso_handle;
 
 #define NVJPEG_RAND_ROUTINE_EACH(__macro) \
   __macro(nvjpegCreateSimple);            \
+  __macro(nvjpegCreateEx);                \
   __macro(nvjpegJpegStateCreate);         \
   __macro(nvjpegGetImageInfo);            \
   __macro(nvjpegJpegStateDestroy);        \
-  __macro(nvjpegDecode);
+  __macro(nvjpegDecode);                  \
+  __macro(nvjpegDecodeBatchedInitialize); \
+  __macro(nvjpegDecodeBatched);           \
+  __macro(nvjpegJpegStreamCreate);        \
+  __macro(nvjpegJpegStreamParse);         \
+  __macro(nvjpegJpegStreamDestroy);
 
 NVJPEG_RAND_ROUTINE_EACH(DECLARE_DYNAMIC_LOAD_NVJPEG_WRAP);
 
+// APIs available after CUDA 11.0, with the hardware backend
+#if CUDA_VERSION >= 11000
+#define NVJPEG_RAND_ROUTINE_EACH_R2(__macro) \
+  __macro(nvjpegDecodeBatchedSupported);
+
+NVJPEG_RAND_ROUTINE_EACH_R2(DECLARE_DYNAMIC_LOAD_NVJPEG_WRAP);
+#endif
+
 }  // namespace dynload
 }  // namespace phi
 
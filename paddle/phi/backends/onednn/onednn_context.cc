@@ -14,6 +14,8 @@
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/phi/backends/onednn/onednn_context.h"
 
+#include <algorithm>
+
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/utils/flat_hash_map.h"
@@ -22,6 +24,9 @@
 #include "paddle/phi/core/expect.h"
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_int32(onednn_primitive_cache_capacity);
 
 namespace phi {
 
@@ -88,6 +93,109 @@ OneDNNContextThreadLocals::Body& OneDNNContextThreadLocals::fetch() {
   return b;
 }
 
+OneDNNPrimitiveCache& OneDNNPrimitiveCache::Instance() {
+  static OneDNNPrimitiveCache cache(
+      std::max(FLAGS_onednn_primitive_cache_capacity, 0));
+  return cache;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Get(const std::string& key) {
+  std::shared_ptr<void> blob;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      blob = it->second->second;
+    }
+  }
+  if (blob) {
+    ++hits_;
+  } else {
+    ++misses_;
+  }
+  const uint64_t lookups = hits_.load() + misses_.load();
+  if (VLOG_IS_ON(2) && lookups % 4096 == 0) {
+    VLOG(2) << "oneDNN primitive cache: " << Size() << "/" << capacity_
+            << " blobs, hit rate " << HitRate() * 100. << "% of " << lookups
+            << " lookups";
+  }
+  return blob;
+}
+
+void OneDNNPrimitiveCache::Set(const std::string& key,
+                               std::shared_ptr<void> blob) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // another thread created it first, keep the one the others may use
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+  lru_.emplace_front(key, std::move(blob));
+  index_[key] = lru_.begin();
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+}
+
+void OneDNNPrimitiveCache::Reset(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  capacity_ = capacity;
+  lru_.clear();
+  index_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+size_t OneDNNPrimitiveCache::Size() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return lru_.size();
+}
+
+double OneDNNPrimitiveCache::HitRate() const {
+  const uint64_t hits = hits_.load();
+  const uint64_t lookups = hits + misses_.load();
+  return lookups == 0 ? 0. : static_cast<double>(hits) / lookups;
+}
+
+OneDNNPackedWeights& OneDNNPackedWeights::Instance() {
+  static OneDNNPackedWeights packed_weights;
+  return packed_weights;
+}
+
+std::shared_ptr<dnnl::memory> OneDNNPackedWeights::Get(
+    const std::string& key, const std::shared_ptr<Allocation>& holder) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = packed_.find(key);
+  if (it == packed_.end()) {
+    return nullptr;
+  }
+  if (it->second.holder.lock() != holder) {
+    packed_.erase(it);
+    return nullptr;
+  }
+  ++hits_;
+  return it->second.packed;
+}
+
+void OneDNNPackedWeights::Set(const std::string& key,
+                              const std::shared_ptr<Allocation>& holder,
+                              std::shared_ptr<dnnl::memory> packed) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  // drop the weights freed since, the packing is rare enough to sweep
+  for (auto it = packed_.begin(); it != packed_.end();) {
+    it = it->second.holder.expired() ? packed_.erase(it) : std::next(it);
+  }
+  packed_[key] = Entry{holder, std::move(packed)};
+}
+
+size_t OneDNNPackedWeights::Size() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return packed_.size();
+}
+
 struct OneDNNContext::Impl {
   Impl() : p_blobmap_() {
     p_blobmap_.reset(new BlobMap());
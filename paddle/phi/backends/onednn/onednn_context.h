@@ -14,12 +14,18 @@ limitations under the License. */
 
 #pragma once
 #ifdef PADDLE_WITH_DNNL
+#include <atomic>
+#include <list>
 #include <memory>
-#include <mutex>     // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include "dnnl.hpp"  // NOLINT
 #include "paddle/common/layout.h"
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/place.h"
+#include "paddle/phi/core/allocator.h"
 #include "paddle/phi/core/attribute.h"
 #include "paddle/utils/test_macros.h"
 
@@ -49,6 +55,9 @@ class OneDNNContextThreadLocals {
     dnnl::stream cur_stream;
     std::string key_suffix;  // Key identifying current Executor
     bool key_attach_thread_id = true;
+    // Share the weights reordered for the primitives, see
+    // OneDNNPackedWeights.
+    bool prepack_weights = false;
     void* exec_ptr_ = nullptr;
 
     Body();
@@ -66,6 +75,8 @@ class OneDNNContextThreadLocals {
     const std::string& get_key_suffix(void) const { return key_suffix; }
     void disable_tid_in_key(void) { key_attach_thread_id = false; }
     bool is_tid_used_in_key(void) const { return key_attach_thread_id; }
+    void set_prepack_weights(bool on) { prepack_weights = on; }
+    bool is_prepack_weights_on(void) const { return prepack_weights; }
     void set_curr_exec(void* exec_ptr) { exec_ptr_ = exec_ptr; }
     void* get_curr_exec(void) const { return exec_ptr_; }
   };
@@ -80,6 +91,78 @@ class OneDNNContextThreadLocals {
   TEST_API static Body& fetch();
 };
 
+// The oneDNN primitive descriptors and primitives are immutable once
+// created, so unlike the memory objects cached per thread by OneDNNContext,
+// one of each is enough for the process. OneDNNPrimitiveCache keeps them by
+// the key of the handler without the thread id, evicting the least recently
+// used ones beyond FLAGS_onednn_primitive_cache_capacity, which disables the
+// cache if 0.
+class OneDNNPrimitiveCache {
+ public:
+  TEST_API static OneDNNPrimitiveCache& Instance();
+
+  bool Enabled() const { return capacity_.load() > 0; }
+
+  // nullptr if not found
+  TEST_API std::shared_ptr<void> Get(const std::string& key);
+
+  TEST_API void Set(const std::string& key, std::shared_ptr<void> blob);
+
+  // Change the capacity, dropping the cached blobs and the counters.
+  TEST_API void Reset(size_t capacity);
+
+  TEST_API size_t Size();
+  uint64_t Hits() const { return hits_.load(); }
+  uint64_t Misses() const { return misses_.load(); }
+  TEST_API double HitRate() const;
+
+ private:
+  explicit OneDNNPrimitiveCache(size_t capacity) : capacity_(capacity) {}
+
+  using Entry = std::pair<std::string, std::shared_ptr<void>>;
+
+  std::mutex mtx_;
+  std::atomic<size_t> capacity_;
+  // the most recently used first
+  std::list<Entry> lru_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+// The weights of the inference programs reordered into the blocked layouts
+// the primitives choose, e.g. the AMX ones of bf16 and int8, once for the
+// process instead of once per thread and input shape. An entry is dropped
+// when the allocation of its weights is freed, so the weights of a later
+// tensor at the same address are never served stale.
+class OneDNNPackedWeights {
+ public:
+  TEST_API static OneDNNPackedWeights& Instance();
+
+  // nullptr if the weights in holder are not packed for the key yet
+  TEST_API std::shared_ptr<dnnl::memory> Get(
+      const std::string& key, const std::shared_ptr<Allocation>& holder);
+
+  TEST_API void Set(const std::string& key,
+                    const std::shared_ptr<Allocation>& holder,
+                    std::shared_ptr<dnnl::memory> packed);
+
+  TEST_API size_t Size();
+  uint64_t Hits() const { return hits_.load(); }
+
+ private:
+  OneDNNPackedWeights() = default;
+
+  struct Entry {
+    std::weak_ptr<Allocation> holder;
+    std::shared_ptr<dnnl::memory> packed;
+  };
+
+  std::mutex mtx_;
+  std::unordered_map<std::string, Entry> packed_;
+  std::atomic<uint64_t> hits_{0};
+};
+
 class OneDNNContext : public CPUContext {
  public:
   template <class T>
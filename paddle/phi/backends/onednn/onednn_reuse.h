@@ -136,6 +136,21 @@ static void AppendActivation(const OneDNNContext& dev_ctx,
   post_ops.append_eltwise(activation_type->second, fuse_alpha, fuse_beta);
 }
 
+// The key of the weights packed into md, with the scales they are quantized
+// by, see OneDNNPackedWeights.
+inline std::string PackedWeightsKey(const DenseTensor& weights,
+                                    const dnnl::memory::desc& md,
+                                    const std::vector<float>& scales) {
+  std::string key;
+  key.reserve(128);
+  AppendKey(&key, reinterpret_cast<uintptr_t>(weights.data()));
+  key += "-";
+  AppendKey(&key, md);
+  key += "-";
+  AppendKey(&key, scales);
+  return key;
+}
+
 template <typename T,
           typename TForward,
           typename TBackward = onednn_dummy_primitive,
@@ -157,39 +172,39 @@ class OneDNNHandlerT {
   }
 
   std::shared_ptr<TForward> AcquireForwardPrimitive() {
-    const std::string key_p = key_ + "@fwd_p";
+    const std::string key_p = "@fwd_p";
     auto forward_p =
-        std::static_pointer_cast<TForward>(dev_ctx_.GetBlob(key_p));
+        std::static_pointer_cast<TForward>(GetPrimitiveBlob(key_p));
     if (forward_p == nullptr) {
       forward_p = std::make_shared<TForward>(*fwd_pd_);
-      dev_ctx_.SetBlob(key_p, forward_p);
+      SetPrimitiveBlob(key_p, forward_p);
     }
     return forward_p;
   }
 
   std::shared_ptr<TBackward> AcquireBackwardPrimitive() {
-    const std::string key_p = key_ + "@bwd_p";
+    const std::string key_p = "@bwd_p";
     auto backward_p =
-        std::static_pointer_cast<TBackward>(dev_ctx_.GetBlob(key_p));
+        std::static_pointer_cast<TBackward>(GetPrimitiveBlob(key_p));
     if (backward_p == nullptr) {
       backward_p = std::make_shared<TBackward>(*bwd_pd_);
-      dev_ctx_.SetBlob(key_p, backward_p);
+      SetPrimitiveBlob(key_p, backward_p);
     }
     return backward_p;
   }
 
   std::shared_ptr<TBackward_params> AcquireBackwardWeightsPrimitive() {
-    const std::string key_p = key_ + "@bwd_w_p";
+    const std::string key_p = "@bwd_w_p";
     auto backward_p =
-        std::static_pointer_cast<TBackward_params>(dev_ctx_.GetBlob(key_p));
+        std::static_pointer_cast<TBackward_params>(GetPrimitiveBlob(key_p));
     if (backward_p == nullptr) {
       PADDLE_ENFORCE_NOT_NULL(
           bwd_w_pd_,
           errors::Unavailable("BWD_PD should be set when "
                               "getting BWD prim witk key: %s .",
-                              key_p));
+                              key_ + key_p));
       backward_p = std::make_shared<TBackward_params>(*bwd_w_pd_);
-      dev_ctx_.SetBlob(key_p, backward_p);
+      SetPrimitiveBlob(key_p, backward_p);
     }
     return backward_p;
   }
@@ -259,34 +274,53 @@ class OneDNNHandlerT {
   }
 
  protected:
+  // The primitive descriptors and primitives are shared by the threads
+  // through OneDNNPrimitiveCache if it is enabled, so they are kept by the
+  // key without the thread id.
+  std::shared_ptr<void> GetPrimitiveBlob(const std::string& suffix) const {
+    auto& cache = OneDNNPrimitiveCache::Instance();
+    return cache.Enabled() ? cache.Get(key_common_ + suffix)
+                           : dev_ctx_.GetBlob(key_ + suffix);
+  }
+
+  void SetPrimitiveBlob(const std::string& suffix,
+                        std::shared_ptr<void> blob) const {
+    auto& cache = OneDNNPrimitiveCache::Instance();
+    if (cache.Enabled()) {
+      cache.Set(key_common_ + suffix, std::move(blob));
+    } else {
+      dev_ctx_.SetBlob(key_ + suffix, std::move(blob));
+    }
+  }
+
   bool isCached() {
-    const std::string key_pd = key_ + "@fwd_pd";
+    const std::string key_pd = "@fwd_pd";
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob(key_pd));
 
     return (fwd_pd_ != nullptr);
   }
 
   bool isBwdCached() {
-    const std::string key_pd = key_ + "@bwd_pd";
+    const std::string key_pd = "@bwd_pd";
     bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob(key_pd));
 
     if (bwd_pd_ == nullptr) {
       return false;
     } else {
       if (std::is_same<TBackward_params, onednn_dummy_primitive>::value ==
           false) {
-        const std::string key_bw_w_pd = key_ + "@bwd_w_pd";
+        const std::string key_bw_w_pd = "@bwd_w_pd";
         bwd_w_pd_ =
             std::static_pointer_cast<typename TBackward_params::primitive_desc>(
-                dev_ctx_.GetBlob(key_bw_w_pd));
+                GetPrimitiveBlob(key_bw_w_pd));
       }
 
       // When BWD is cached then still we need to Get FWD PD
-      const std::string key_fpd = key_ + "@fwd_pd";
+      const std::string key_fpd = "@fwd_pd";
       fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
-          dev_ctx_.GetBlob(key_fpd));
+          GetPrimitiveBlob(key_fpd));
       PADDLE_ENFORCE_NOT_NULL(
           fwd_pd_,
           errors::Unavailable(
@@ -303,12 +337,12 @@ class OneDNNHandlerT {
   void AcquireForwardPrimitiveDescriptor(Arg&& first_arg, Args&&... args) {
     // This is used when we can recreate FWD PD in BWD so
     // we do not need to pass FWD to BWD
-    const std::string key_pd = key_ + "@fwd_pd";
+    const std::string key_pd = "@fwd_pd";
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob(key_pd));
     if (fwd_pd_ == nullptr) {
       CreateForwardPrimitiveDescriptor(first_arg, std::forward<Args>(args)...);
-      dev_ctx_.SetBlob(key_pd, fwd_pd_);
+      SetPrimitiveBlob(key_pd, fwd_pd_);
     }
   }
 
@@ -338,13 +372,13 @@ class OneDNNHandlerT {
         fwd_pd_,
         errors::Unavailable("Get OneDNN Forward primitive %s failed.",
                             key_ + "@fwd_pd"));
-    const std::string key_pd = key_ + "@bwd_pd";
+    const std::string key_pd = "@bwd_pd";
     bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob(key_pd));
     if (bwd_pd_ == nullptr) {
       bwd_pd_ = std::make_shared<typename TBackward::primitive_desc>(
           engine_, std::forward<Args>(args)..., *fwd_pd_);
-      dev_ctx_.SetBlob(key_pd, bwd_pd_);
+      SetPrimitiveBlob(key_pd, bwd_pd_);
     }
   }
 
@@ -356,14 +390,14 @@ class OneDNNHandlerT {
         fwd_pd_,
         errors::Unavailable("Get OneDNN Forward primitive %s failed.",
                             key_ + "@fwd_pd"));
-    const std::string key_pd = key_ + "@bwd_w_pd";
+    const std::string key_pd = "@bwd_w_pd";
     bwd_w_pd_ =
         std::static_pointer_cast<typename TBackward_params::primitive_desc>(
-            dev_ctx_.GetBlob(key_pd));
+            GetPrimitiveBlob(key_pd));
     if (bwd_w_pd_ == nullptr) {
       bwd_w_pd_ = std::make_shared<typename TBackward_params::primitive_desc>(
           engine_, std::forward<Args>(args)..., *fwd_pd_);
-      dev_ctx_.SetBlob(key_pd, bwd_w_pd_);
+      SetPrimitiveBlob(key_pd, bwd_w_pd_);
     }
   }
 
@@ -231,7 +231,7 @@ DenseTensor::DenseTensor(const LoD& lod) : DenseTensor() { meta_.lod = lod; }
 
 void DenseTensor::set_lod(const LoD& lod) { meta_.lod = lod; }
 
-LoD* DenseTensor::mutable_lod() { return &meta_.lod; }
+LoD* DenseTensor::mutable_lod() { return meta_.lod.mutable_get(); }
 
 std::pair<size_t, size_t> DenseTensor::lod_element(size_t level,
                                                    size_t elem) const {
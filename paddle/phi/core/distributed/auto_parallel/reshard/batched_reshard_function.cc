@@ -0,0 +1,334 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/batched_reshard_function.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include "glog/logging.h"
+#include "paddle/phi/api/profiler/event_tracing.h"
+#include "paddle/phi/common/int_array.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function_registry.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
+#include "paddle/phi/kernels/all_gather_kernel.h"
+#include "paddle/phi/kernels/all_reduce_kernel.h"
+#include "paddle/phi/kernels/concat_kernel.h"
+#include "paddle/phi/kernels/elementwise_divide_kernel.h"
+#include "paddle/phi/kernels/full_kernel.h"
+#include "paddle/phi/kernels/split_kernel.h"
+
+namespace phi::distributed {
+
+namespace {
+
+enum class FusedKind { kNone, kPToR, kSToR };
+
+struct FusedGroup {
+  FusedKind kind;
+  int64_t mesh_axis;
+  std::vector<size_t> indices;
+};
+
+// Returns how `in` can be resharded to `out_dist_attr` together with other
+// tensors, `key` tells the tensors that can be fused with each other.
+FusedKind GetFusedKind(const DistTensor& in,
+                       const TensorDistAttr& out_dist_attr,
+                       std::string* key,
+                       int64_t* mesh_axis) {
+  const auto& in_dist_attr = in.dist_attr();
+  const auto& process_mesh = in_dist_attr.process_mesh();
+  if (!in.initialized() || in.numel() == 0 ||
+      process_mesh != out_dist_attr.process_mesh() ||
+      !IsCurRankInMesh(process_mesh) || out_dist_attr.is_partial()) {
+    return FusedKind::kNone;
+  }
+
+  std::string prefix = process_mesh.to_string() + ";" +
+                       std::to_string(static_cast<int>(in.dtype())) + ";";
+  if (in_dist_attr.is_partial()) {
+    if (in_dist_attr.dims_mapping() != out_dist_attr.dims_mapping()) {
+      return FusedKind::kNone;
+    }
+    // sorted to have the same key for the same status
+    std::map<int64_t, ReduceType> partial_status(
+        in_dist_attr.partial_status().begin(),
+        in_dist_attr.partial_status().end());
+    *key = "p_to_r;" + prefix;
+    for (const auto& item : partial_status) {
+      *key += std::to_string(item.first) + ":" +
+              std::to_string(static_cast<int>(item.second)) + ",";
+    }
+    return FusedKind::kPToR;
+  }
+
+  auto split_axis_to_mesh_axis =
+      GetSplitAxisWithDimsMapping(in_dist_attr.dims_mapping());
+  if (split_axis_to_mesh_axis.size() != 1 || !out_dist_attr.is_replicated()) {
+    return FusedKind::kNone;
+  }
+  int split_axis = split_axis_to_mesh_axis.begin()->first;
+  *mesh_axis = split_axis_to_mesh_axis.begin()->second;
+  // the uneven shards are padded by the s_to_r function
+  if (in.dims()[split_axis] % process_mesh.dim_size(*mesh_axis) != 0) {
+    return FusedKind::kNone;
+  }
+  *key = "s_to_r;" + prefix + std::to_string(*mesh_axis);
+  return FusedKind::kSToR;
+}
+
+std::vector<int64_t> GetProcessIdsOnAxis(const ProcessMesh& process_mesh,
+                                         int64_t mesh_axis) {
+  if (process_mesh.ndim() == 1) {
+    return process_mesh.process_ids();
+  }
+  return GetSubProcessMesh(process_mesh, mesh_axis).process_ids();
+}
+
+// Concats the local values of `ins` flattened.
+void FlattenLocalValues(DeviceContext* dev_ctx,
+                        const std::vector<const DistTensor*>& ins,
+                        DenseTensor* out) {
+  std::vector<DenseTensor> flat_values;
+  flat_values.reserve(ins.size());
+  for (const auto* in : ins) {
+    flat_values.emplace_back(in->value());
+    flat_values.back().Resize({in->value().numel()});
+  }
+  std::vector<const DenseTensor*> concat_input_vec;
+  concat_input_vec.reserve(flat_values.size());
+  for (const auto& value : flat_values) {
+    concat_input_vec.emplace_back(&value);
+  }
+  RESHARD_FUNCTOR(
+      dev_ctx, Concat, ins[0]->dtype(), concat_input_vec, /*axis*/ 0, out);
+}
+
+}  // namespace
+
+bool BatchedReshardFunction::IsSuitable(const DistTensor& in,
+                                        const TensorDistAttr& out_dist_attr) {
+  return false;
+}
+
+void BatchedReshardFunction::Eval(DeviceContext* dev_ctx,
+                                  const DistTensor& in,
+                                  const TensorDistAttr& out_dist_attr,
+                                  DistTensor* out) {
+  auto* func = ChooseProperReshardFunction(in, out_dist_attr);
+  func->Eval(dev_ctx, in, out_dist_attr, out);
+}
+
+std::vector<std::shared_ptr<DistTensor>> BatchedReshardFunction::Eval(
+    DeviceContext* dev_ctx,
+    const std::vector<const DistTensor*>& ins,
+    const std::vector<TensorDistAttr>& out_dist_attrs) {
+  phi::RecordEvent reshard_record_event(
+      Name(), phi::TracerEventType::OperatorInner, 1);
+  PADDLE_ENFORCE_EQ(
+      ins.size(),
+      out_dist_attrs.size(),
+      common::errors::InvalidArgument(
+          "The number of input tensors (%d) and output dist attrs (%d) of "
+          "the batched reshard must be the same.",
+          ins.size(),
+          out_dist_attrs.size()));
+  std::vector<std::shared_ptr<DistTensor>> outs;
+  outs.reserve(ins.size());
+  for (const auto* in : ins) {
+    outs.emplace_back(std::make_shared<DistTensor>(in->dtype()));
+  }
+
+  // In the order of the first tensor of each group, all the ranks must issue
+  // the collectives in the same order.
+  std::vector<FusedGroup> groups;
+  std::unordered_map<std::string, size_t> key_to_group;
+  std::vector<size_t> unfused;
+  for (size_t i = 0; i < ins.size(); ++i) {
+    std::string key;
+    int64_t mesh_axis = -1;
+    auto kind = GetFusedKind(*ins[i], out_dist_attrs[i], &key, &mesh_axis);
+    if (kind == FusedKind::kNone) {
+      unfused.emplace_back(i);
+      continue;
+    }
+    auto iter = key_to_group.find(key);
+    if (iter == key_to_group.end()) {
+      iter = key_to_group.emplace(key, groups.size()).first;
+      groups.push_back({kind, mesh_axis, {}});
+    }
+    groups[iter->second].indices.emplace_back(i);
+  }
+
+  for (const auto& group : groups) {
+    if (group.indices.size() == 1) {
+      unfused.emplace_back(group.indices[0]);
+      continue;
+    }
+    std::vector<const DistTensor*> group_ins;
+    std::vector<const TensorDistAttr*> group_out_dist_attrs;
+    std::vector<DistTensor*> group_outs;
+    for (size_t i : group.indices) {
+      group_ins.emplace_back(ins[i]);
+      group_out_dist_attrs.emplace_back(&out_dist_attrs[i]);
+      group_outs.emplace_back(outs[i].get());
+    }
+    VLOG(3) << "Fused reshard of " << group.indices.size() << " tensors";
+    if (group.kind == FusedKind::kPToR) {
+      FusedPToR(dev_ctx, group_ins, group_out_dist_attrs, group_outs);
+    } else {
+      FusedSToR(dev_ctx,
+                group.mesh_axis,
+                group_ins,
+                group_out_dist_attrs,
+                group_outs);
+    }
+  }
+
+  std::sort(unfused.begin(), unfused.end());
+  for (size_t i : unfused) {
+    Eval(dev_ctx, *ins[i], out_dist_attrs[i], outs[i].get());
+  }
+  return outs;
+}
+
+void BatchedReshardFunction::FusedPToR(
+    DeviceContext* dev_ctx,
+    const std::vector<const DistTensor*>& ins,
+    const std::vector<const TensorDistAttr*>& out_dist_attrs,
+    const std::vector<DistTensor*>& outs) {
+  const auto& in_dist_attr = ins[0]->dist_attr();
+  const auto& process_mesh = in_dist_attr.process_mesh();
+  auto dtype = ins[0]->dtype();
+
+  DenseTensor buffer;
+  FlattenLocalValues(dev_ctx, ins, &buffer);
+
+  std::map<int64_t, ReduceType> partial_status(
+      in_dist_attr.partial_status().begin(),
+      in_dist_attr.partial_status().end());
+  for (const auto& item : partial_status) {
+    auto process_ids = GetProcessIdsOnAxis(process_mesh, item.first);
+    auto reduce_type = item.second;
+    bool reduce_mean = false;
+    if (reduce_type == ReduceType::kRedAvg) {
+      reduce_type = ReduceType::kRedSum;
+      reduce_mean = true;
+    }
+    DenseTensor reduced;
+    RESHARD_FUNCTOR_WITH_COMM(dev_ctx,
+                              AllReduce,
+                              dtype,
+                              process_ids,
+                              buffer,
+                              static_cast<int64_t>(reduce_type),
+                              &reduced);
+    if (reduce_mean) {
+      DenseTensor tensor_of_num_process;
+      IntArray shape({1});
+      RESHARD_FUNCTOR(dev_ctx,
+                      Full,
+                      dtype,
+                      shape,
+                      static_cast<int64_t>(process_ids.size()),
+                      &tensor_of_num_process);
+      RESHARD_FUNCTOR(
+          dev_ctx, Divide, dtype, reduced, tensor_of_num_process, &reduced);
+    }
+    buffer = reduced;
+  }
+
+  std::vector<int64_t> sections;
+  sections.reserve(ins.size());
+  for (const auto* in : ins) {
+    sections.emplace_back(in->value().numel());
+  }
+  std::vector<DenseTensor> split_out_vec;
+  RESHARD_FUNCTOR(dev_ctx,
+                  Split,
+                  dtype,
+                  buffer,
+                  IntArray(sections),
+                  /*split_axis*/ 0,
+                  &split_out_vec);
+  for (size_t i = 0; i < ins.size(); ++i) {
+    split_out_vec[i].Resize(ins[i]->local_dims());
+    SetValue(outs[i], split_out_vec[i]);
+    SetDistProps(outs[i], ins[i]->dims(), *out_dist_attrs[i]);
+  }
+}
+
+void BatchedReshardFunction::FusedSToR(
+    DeviceContext* dev_ctx,
+    int64_t mesh_axis,
+    const std::vector<const DistTensor*>& ins,
+    const std::vector<const TensorDistAttr*>& out_dist_attrs,
+    const std::vector<DistTensor*>& outs) {
+  const auto& process_mesh = ins[0]->dist_attr().process_mesh();
+  auto process_ids = GetProcessIdsOnAxis(process_mesh, mesh_axis);
+  int64_t num_of_process = static_cast<int64_t>(process_ids.size());
+  auto dtype = ins[0]->dtype();
+
+  DenseTensor buffer;
+  FlattenLocalValues(dev_ctx, ins, &buffer);
+  DenseTensor gathered;
+  RESHARD_FUNCTOR_WITH_COMM(dev_ctx,
+                            AllGather,
+                            dtype,
+                            process_ids,
+                            buffer,
+                            num_of_process,
+                            &gathered);
+
+  // the buffer of each rank in turn, a shard of every tensor in each
+  std::vector<int64_t> sections;
+  sections.reserve(num_of_process * ins.size());
+  for (int64_t rank = 0; rank < num_of_process; ++rank) {
+    for (const auto* in : ins) {
+      sections.emplace_back(in->value().numel());
+    }
+  }
+  std::vector<DenseTensor> split_out_vec;
+  RESHARD_FUNCTOR(dev_ctx,
+                  Split,
+                  dtype,
+                  gathered,
+                  IntArray(sections),
+                  /*split_axis*/ 0,
+                  &split_out_vec);
+
+  for (size_t i = 0; i < ins.size(); ++i) {
+    int split_axis =
+        GetSplitAxisWithDimsMapping(ins[i]->dist_attr().dims_mapping())
+            .begin()
+            ->first;
+    std::vector<const DenseTensor*> concat_input_vec;
+    concat_input_vec.reserve(num_of_process);
+    for (int64_t rank = 0; rank < num_of_process; ++rank) {
+      auto& shard = split_out_vec[rank * ins.size() + i];
+      shard.Resize(ins[i]->local_dims());
+      concat_input_vec.emplace_back(&shard);
+    }
+    DenseTensor value;
+    RESHARD_FUNCTOR(
+        dev_ctx, Concat, dtype, concat_input_vec, split_axis, &value);
+    SetValue(outs[i], value);
+    SetDistProps(outs[i], ins[i]->dims(), *out_dist_attrs[i]);
+  }
+}
+
+}  // namespace phi::distributed
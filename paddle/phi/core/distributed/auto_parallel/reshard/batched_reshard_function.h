@@ -0,0 +1,67 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function.h"
+
+namespace phi {
+namespace distributed {
+
+// Reshards many tensors at once. The tensors changed from partial to
+// replicated, or from sharded on one mesh axis to replicated, are grouped by
+// process mesh, status and dtype. Each group is flattened into one buffer and
+// resharded by a single collective, the others are resharded one by one with
+// the proper reshard function. Not registered, a single tensor has nothing to
+// fuse.
+class BatchedReshardFunction final : public ReshardFunction {
+ public:
+  BatchedReshardFunction() = default;
+  ~BatchedReshardFunction() = default;
+
+  bool IsSuitable(const DistTensor& in,
+                  const TensorDistAttr& out_dist_attr) override;
+
+  using ReshardFunction::Eval;
+
+  void Eval(DeviceContext* dev_ctx,
+            const DistTensor& in,
+            const TensorDistAttr& out_dist_attr,
+            DistTensor* out) override;
+
+  std::vector<std::shared_ptr<DistTensor>> Eval(
+      DeviceContext* dev_ctx,
+      const std::vector<const DistTensor*>& ins,
+      const std::vector<TensorDistAttr>& out_dist_attrs);
+
+  std::string Name() override { return "BatchedReshard"; }
+
+ private:
+  void FusedPToR(DeviceContext* dev_ctx,
+                 const std::vector<const DistTensor*>& ins,
+                 const std::vector<const TensorDistAttr*>& out_dist_attrs,
+                 const std::vector<DistTensor*>& outs);
+  void FusedSToR(DeviceContext* dev_ctx,
+                 int64_t mesh_axis,
+                 const std::vector<const DistTensor*>& ins,
+                 const std::vector<const TensorDistAttr*>& out_dist_attrs,
+                 const std::vector<DistTensor*>& outs);
+};
+
+}  // namespace distributed
+}  // namespace phi
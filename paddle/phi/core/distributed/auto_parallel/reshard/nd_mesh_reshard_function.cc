@@ -30,28 +30,6 @@
 namespace phi::distributed {
 
 namespace {
-ProcessMesh GetSubProcessMesh(const ProcessMesh& mesh, int64_t axis) {
-  int64_t shape_of_axis = mesh.dim_size(axis);
-  std::vector<int64_t> shape = {shape_of_axis};
-  std::vector<std::string> dim_names = {mesh.dim_names()[axis]};
-  std::vector<int64_t> coord = GetCurRankCoordInMesh(mesh);
-
-  std::vector<int64_t> process_ids;
-  for (int64_t i = 0; i < shape_of_axis; ++i) {
-    coord[axis] = i;
-    int64_t rank = 0;
-    int64_t degree = 1;
-    for (int64_t j = static_cast<int64_t>(coord.size() - 1); j >= 0; --j) {
-      rank += coord[j] * degree;
-      degree *= mesh.dim_size(j);
-    }
-    process_ids.emplace_back(mesh.process_ids()[rank]);
-  }
-
-  ProcessMesh out_mesh(shape, process_ids, dim_names);
-  return out_mesh;
-}
-
 // Given the input two dist_attr, traversing from high-dimension axis to
 // low-dimension. Find and return the first different axis which is shard status
 // between these two. For example, the input two dims_mapping are [-1, 0, -1,
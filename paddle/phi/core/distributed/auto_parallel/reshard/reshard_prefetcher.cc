@@ -0,0 +1,197 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_prefetcher.h"
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function_registry.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
+#include "paddle/phi/core/enforce.h"
+
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/distributed/nccl_comm_context.h"
+#endif
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+using GpuEventPtr = std::shared_ptr<std::remove_pointer<phi::gpuEvent_t>::type>;
+
+void RecordEvent(const GpuEventPtr& event, DeviceContext* dev_ctx) {
+  auto stream = static_cast<GPUContext*>(dev_ctx)->stream();
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event.get(), stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event.get(), stream));
+#endif
+}
+
+void WaitEvent(const GpuEventPtr& event, DeviceContext* dev_ctx) {
+  auto stream = static_cast<GPUContext*>(dev_ctx)->stream();
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(stream, event.get(), 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream, event.get(), 0));
+#endif
+}
+#endif
+
+// Compares only the attributes the reshard depends on.
+bool SameLayout(const TensorDistAttr& lhs, const TensorDistAttr& rhs) {
+  return lhs.process_mesh() == rhs.process_mesh() &&
+         lhs.dims_mapping() == rhs.dims_mapping() &&
+         lhs.partial_status() == rhs.partial_status();
+}
+
+}  // namespace
+
+ReshardPrefetcher& ReshardPrefetcher::Instance() {
+  static ReshardPrefetcher prefetcher;
+  return prefetcher;
+}
+
+void ReshardPrefetcher::Prefetch(const std::shared_ptr<DistTensor>& in,
+                                 const TensorDistAttr& out_dist_attr) {
+  PADDLE_ENFORCE_NOT_NULL(
+      in,
+      common::errors::InvalidArgument("The tensor to prefetch is NULL."));
+  if (SameLayout(in->dist_attr(), out_dist_attr)) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& prefetched = prefetched_[in.get()];
+  prefetched.in = in;
+  const auto* holder = in->value().Holder().get();
+  auto& entries = prefetched.entries;
+  for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+    if (SameLayout(iter->dist_attr, out_dist_attr)) {
+      if (iter->holder == holder) {
+        return;
+      }
+      // the value is replaced since, e.g. by the optimizer
+      ReleaseEntry(&*iter);
+      entries.erase(iter);
+      --size_;
+      break;
+    }
+  }
+
+  auto* dev_ctx = DeviceContextPool::Instance().Get(in->place());
+  Entry entry{out_dist_attr, holder, nullptr, dev_ctx, dev_ctx};
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+  if (GPUContext::classof(dev_ctx)) {
+    auto* comm_ctx = static_cast<NCCLCommContext*>(
+        CreateOrGetCommContext(*dev_ctx, in->process_mesh().process_ids()));
+    entry.comm_dev_ctx = comm_ctx->GetDevContext();
+    entry.event =
+        phi::memory_utils::GetCudaEvent(dev_ctx->GetPlace().GetDeviceId());
+    // the value may still be written on the compute stream
+    RecordEvent(entry.event, dev_ctx);
+    WaitEvent(entry.event, entry.comm_dev_ctx);
+  }
+#endif
+  VLOG(4) << "Prefetch the reshard from " << in->dist_attr() << " to "
+          << out_dist_attr;
+  auto* func = ChooseProperReshardFunction(*in, out_dist_attr);
+  entry.out = func->Eval(entry.comm_dev_ctx, *in, out_dist_attr);
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+  if (entry.event) {
+    RecordEvent(entry.event, entry.comm_dev_ctx);
+  }
+#endif
+  entries.emplace_back(std::move(entry));
+  ++size_;
+}
+
+std::shared_ptr<DistTensor> ReshardPrefetcher::Fetch(
+    DeviceContext* dev_ctx,
+    const DistTensor& in,
+    const TensorDistAttr& out_dist_attr) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = prefetched_.find(&in);
+  if (iter == prefetched_.end()) {
+    return nullptr;
+  }
+  for (auto& entry : iter->second.entries) {
+    if (!SameLayout(entry.dist_attr, out_dist_attr)) {
+      continue;
+    }
+    if (entry.holder != in.value().Holder().get()) {
+      VLOG(4) << "The prefetched reshard is out of date, the value is "
+                 "replaced since.";
+      return nullptr;
+    }
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+    if (entry.event && GPUContext::classof(dev_ctx)) {
+      WaitEvent(entry.event, dev_ctx);
+    }
+#endif
+    VLOG(4) << "Use the prefetched reshard from " << in.dist_attr() << " to "
+            << out_dist_attr;
+    return entry.out;
+  }
+  return nullptr;
+}
+
+void ReshardPrefetcher::Release(const DistTensor& in) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = prefetched_.find(&in);
+  if (iter == prefetched_.end()) {
+    return;
+  }
+  for (auto& entry : iter->second.entries) {
+    ReleaseEntry(&entry);
+  }
+  size_ -= iter->second.entries.size();
+  prefetched_.erase(iter);
+}
+
+void ReshardPrefetcher::Clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& item : prefetched_) {
+    for (auto& entry : item.second.entries) {
+      ReleaseEntry(&entry);
+    }
+  }
+  prefetched_.clear();
+  size_ = 0;
+}
+
+void ReshardPrefetcher::ReleaseEntry(Entry* entry) {
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+  // The memory of the result goes back to the pool of the communication
+  // stream, which must not reuse it before the computation using it is done.
+  if (entry->event) {
+    RecordEvent(entry->event, entry->dev_ctx);
+    WaitEvent(entry->event, entry->comm_dev_ctx);
+  }
+#endif
+  entry->out.reset();
+}
+
+}  // namespace distributed
+}  // namespace phi
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#endif
+
+namespace phi {
+class DeviceContext;
+
+namespace distributed {
+
+// Reshards tensors ahead of their use, e.g. gathers the sharded parameters of
+// the next layer while the current one computes. On gpu the reshard runs on
+// the stream of the communication context of the process mesh, the compute
+// stream only waits for it when the result is fetched. The results are kept
+// until released, so the backward pass can reuse the copies gathered for the
+// forward pass.
+class ReshardPrefetcher {
+ public:
+  static ReshardPrefetcher& Instance();
+
+  // Starts resharding `in` to `out_dist_attr`, nothing is done if it is
+  // already prefetched.
+  void Prefetch(const std::shared_ptr<DistTensor>& in,
+                const TensorDistAttr& out_dist_attr);
+
+  // Returns the prefetched result of resharding `in` to `out_dist_attr` and
+  // makes the stream of `dev_ctx` wait for it. Returns nullptr if there is
+  // none, or the value of `in` is replaced since.
+  std::shared_ptr<DistTensor> Fetch(DeviceContext* dev_ctx,
+                                    const DistTensor& in,
+                                    const TensorDistAttr& out_dist_attr);
+
+  // Drops the results prefetched for `in`. Their memory is reused for later
+  // prefetches only after the work queued on the compute stream so far.
+  void Release(const DistTensor& in);
+
+  void Clear();
+
+  bool Empty() const { return size_.load(std::memory_order_relaxed) == 0; }
+
+ private:
+  ReshardPrefetcher() = default;
+
+  struct Entry {
+    TensorDistAttr dist_attr;
+    // the value resharded, to tell if it is replaced since
+    const phi::Allocation* holder;
+    std::shared_ptr<DistTensor> out;
+    // the compute context of the value
+    DeviceContext* dev_ctx;
+    // the context the reshard runs on
+    DeviceContext* comm_dev_ctx;
+#if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && \
+    (defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL))
+    std::shared_ptr<std::remove_pointer<phi::gpuEvent_t>::type> event;
+#endif
+  };
+
+  struct Entries {
+    // keeps the key alive
+    std::shared_ptr<DistTensor> in;
+    std::vector<Entry> entries;
+  };
+
+  void ReleaseEntry(Entry* entry);
+
+  std::mutex mutex_;
+  std::unordered_map<const DistTensor*, Entries> prefetched_;
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace distributed
+}  // namespace phi
@@ -54,6 +54,11 @@ int64_t GetLocalRankInParticipate(const std::vector<int64_t>& process_ids,
 // return [2, 0]; if the current rank is 3, then will return [1, 1].
 std::vector<int64_t> GetCurRankCoordInMesh(const ProcessMesh& process_mesh);
 
+// Get the 1-D mesh along `axis` of process mesh that contains cur rank. For
+// example, the process mesh is [[0, 1], [2, 3]], if the current rank is 2,
+// then will return [2, 3] for axis 1 and [0, 2] for axis 0.
+ProcessMesh GetSubProcessMesh(const ProcessMesh& mesh, int64_t axis);
+
 // If the index i's value in dims_mapping is x ( x != -1), means the ith axis of
 // tensor need be split by xth axis of process_mesh. The function analyze the
 // input vector, return a key-value map of tensor_split_axis and
@@ -420,6 +420,40 @@ class ProcessGroup {
                                       GetBackendName()));
   }
 
+  // coalesced APIs, the collectives of all the tensor pairs are issued as one
+  // batch and tracked by a single task
+  virtual std::shared_ptr<ProcessGroup::Task> AllGatherCoalesced(
+      const std::vector<phi::DenseTensor*>& out_tensors UNUSED,
+      const std::vector<phi::DenseTensor>& in_tensors UNUSED,
+      bool sync_op UNUSED,
+      bool use_calc_stream UNUSED) {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "ProcessGroup%s does not support coalesced all_gather.",
+        GetBackendName()));
+  }
+
+  virtual std::shared_ptr<ProcessGroup::Task> AllReduceCoalesced(
+      const std::vector<phi::DenseTensor*>& out_tensors UNUSED,
+      const std::vector<phi::DenseTensor>& in_tensors UNUSED,
+      const AllreduceOptions& opts UNUSED,
+      bool sync_op UNUSED,
+      bool use_calc_stream UNUSED) {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "ProcessGroup%s does not support coalesced all_reduce.",
+        GetBackendName()));
+  }
+
+  virtual std::shared_ptr<ProcessGroup::Task> BroadcastCoalesced(
+      const std::vector<phi::DenseTensor*>& out_tensors UNUSED,
+      const std::vector<phi::DenseTensor>& in_tensors UNUSED,
+      const BroadcastOptions& opts UNUSED,
+      bool sync_op UNUSED,
+      bool use_calc_stream UNUSED) {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "ProcessGroup%s does not support coalesced broadcast.",
+        GetBackendName()));
+  }
+
   // legacy APIs
   // TODO(liyurui): This API will be moved later
   virtual std::shared_ptr<ProcessGroup::Task> AllReduce(
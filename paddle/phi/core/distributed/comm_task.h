@@ -57,12 +57,17 @@ class CommTask {
         nccl_comm_(nccl_comm),
         nccl_stream_(nccl_stream),
         comm_type_(comm_type) {
-    const char* global_rank = std::getenv("PADDLE_TRAINER_ID");
-    PADDLE_ENFORCE_NOT_NULL(
-        global_rank,
-        common::errors::NotFound(
-            "The environment variable 'PADDLE_TRAINER_ID' cannot be found."));
-    global_rank_ = std::atoi(global_rank);
+    // a task is created per collective, the environment is read only once
+    static const int global_rank = [] {
+      const char* global_rank = std::getenv("PADDLE_TRAINER_ID");
+      PADDLE_ENFORCE_NOT_NULL(
+          global_rank,
+          common::errors::NotFound(
+              "The environment variable 'PADDLE_TRAINER_ID' cannot be "
+              "found."));
+      return std::atoi(global_rank);
+    }();
+    global_rank_ = global_rank;
   }
   virtual ~CommTask() = default;
 
@@ -150,6 +155,13 @@ class CommTask {
     return;
   }
 
+  // Whether the device time of the task is measured, it is sampled by
+  // FLAGS_comm_trace_timing_interval.
+  virtual bool IsTimed() { return false; }
+  // The device time of a completed timed task in milliseconds, must be read
+  // before ClearRecord.
+  virtual float GetElapsedMillis() { return -1.0f; }
+
  protected:
   std::string backend_;
   phi::Place place_;
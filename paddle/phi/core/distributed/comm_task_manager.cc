@@ -22,9 +22,12 @@
 
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 
+#include <algorithm>
 #include <future>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <unordered_set>
 
 #include "gflags/gflags.h"
 #include "glog/logging.h"
@@ -48,6 +51,8 @@ std::atomic<bool> CommTaskManager::terminated_;
 std::mutex CommTaskManager::comm_task_list_mutex_;
 std::condition_variable CommTaskManager::comm_task_list_cv_;
 std::list<std::shared_ptr<CommTask>> CommTaskManager::comm_task_list_;
+// power of two, the tasks beyond wait in comm_task_list_
+CommTaskRing CommTaskManager::comm_task_ring_(8192);
 
 std::mutex CommTaskManager::comm_task_clear_list_mutex_;
 std::condition_variable CommTaskManager::comm_task_clear_list_cv_;
@@ -61,6 +66,73 @@ std::unordered_map<std::string, std::shared_ptr<CommTask>>
     CommTaskManager::group_last_comm_task_;
 std::chrono::time_point<std::chrono::steady_clock>
     CommTaskManager::last_update_time_ = std::chrono::steady_clock::now();
+std::mutex CommTaskManager::latency_histograms_mutex_;
+std::map<std::string, CommLatencyHistogram>
+    CommTaskManager::latency_histograms_;
+
+CommTaskRing::CommTaskRing(size_t capacity)
+    : mask_(capacity - 1), slots_(new Slot[capacity]) {
+  PADDLE_ENFORCE_EQ(capacity > 0 && (capacity & mask_) == 0,
+                    true,
+                    common::errors::InvalidArgument(
+                        "The capacity of CommTaskRing must be a power of two, "
+                        "but got %d.",
+                        capacity));
+  for (size_t i = 0; i < capacity; ++i) {
+    slots_[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool CommTaskRing::Push(std::shared_ptr<CommTask>* task) {
+  size_t pos = tail_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[pos & mask_];
+    size_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq == pos) {
+      if (tail_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        slot.task = std::move(*task);
+        slot.seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (seq < pos) {
+      // not popped yet since the last round
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool CommTaskRing::Pop(std::shared_ptr<CommTask>* task) {
+  size_t pos = head_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[pos & mask_];
+  if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+    return false;
+  }
+  *task = std::move(slot.task);
+  slot.task = nullptr;
+  head_.store(pos + 1, std::memory_order_relaxed);
+  slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+bool CommTaskRing::Empty() const {
+  return head_.load(std::memory_order_relaxed) ==
+         tail_.load(std::memory_order_relaxed);
+}
+
+void CommLatencyHistogram::Add(double micros) {
+  int bucket = 0;
+  for (double bound = 2; bound <= micros && bucket + 1 < kBucketNum;
+       bound *= 2) {
+    ++bucket;
+  }
+  ++buckets[bucket];
+  ++count;
+  sum_us += micros;
+  max_us = std::max(max_us, micros);
+}
 
 CommTaskManager::CommTaskManager() : timeout_(0) {
   terminated_.store(false);
@@ -86,11 +158,22 @@ CommTaskManager::~CommTaskManager() {
 
 void CommTaskManager::CommTaskEnqueue(std::shared_ptr<CommTask> comm_task) {
   if (!terminated_.load()) {
+    if (comm_task_ring_.Push(&comm_task)) {
+      return;
+    }
     std::lock_guard<std::mutex> lock(comm_task_list_mutex_);
+    DrainCommTaskRing();
     comm_task_list_.emplace_back(std::move(comm_task));
   }
 }
 
+void CommTaskManager::DrainCommTaskRing() {
+  std::shared_ptr<CommTask> task;
+  while (comm_task_ring_.Pop(&task)) {
+    comm_task_list_.emplace_back(std::move(task));
+  }
+}
+
 void CommTaskManager::CommTaskClearEnqueue(
     std::shared_ptr<CommTask> comm_task) {
   if (!terminated_.load()) {
@@ -113,6 +196,7 @@ void CommTaskManager::Stop() {
     comm_task_clear_loop_thread_.join();
   }
 
+  LogLatencyHistograms();
   LOG(INFO) << "CommTaskManager stopped.";
 }
 
@@ -149,6 +233,7 @@ void CommTaskManager::CommTaskLoop() {
         lock,
         std::chrono::milliseconds(loop_thread_sleep_millis),
         [&]() -> bool { return terminated_.load(); });
+    DrainCommTaskRing();
 
     if (IsTimeout() && !logged_) {
       // case 1: all group is empty, has no task
@@ -164,8 +249,16 @@ void CommTaskManager::CommTaskLoop() {
       }
       logged_ = true;
     }
+    // The tasks on a stream run in order, the ones behind a task not
+    // completed yet are neither started nor completed, no need to query
+    // their events.
+    std::unordered_set<gpuStream_t> pending_streams;
     for (auto iter = comm_task_list_.begin(); iter != comm_task_list_.end();) {
       auto task = *iter;
+      if (!task->IsTimeout() && pending_streams.count(task->nccl_stream())) {
+        ++iter;
+        continue;
+      }
       if (task->IsTimeout()) {
         if (!task->IsStarted()) {
           LOG(WARNING) << "Find timeout init but not start task:"
@@ -182,13 +275,16 @@ void CommTaskManager::CommTaskLoop() {
       } else {
         if (task->IsStarted()) {
           if (task->IsCompleted()) {
+            RecordLatency(task);
             CommTaskClearEnqueue(task);
             iter = comm_task_list_.erase(iter);
           } else {
+            pending_streams.insert(task->nccl_stream());
             ++iter;
           }
           UpdateLastCommTask(task);
         } else {
+          pending_streams.insert(task->nccl_stream());
           ++iter;
         }
       }
@@ -211,6 +307,7 @@ void CommTaskManager::CommTaskLoop() {
          iter != start_comm_task_map_.end();) {
       auto task = iter->second;
       if (task->IsCompleted()) {
+        RecordLatency(task);
         CommTaskClearEnqueue(task);
         UpdateLastCommTask(task);
         iter = start_comm_task_map_.erase(iter);
@@ -220,8 +317,8 @@ void CommTaskManager::CommTaskLoop() {
       }
     }
 
-    if (comm_task_list_.empty() && init_comm_task_map_.empty() &&
-        start_comm_task_map_.empty()) {
+    if (comm_task_list_.empty() && comm_task_ring_.Empty() &&
+        init_comm_task_map_.empty() && start_comm_task_map_.empty()) {
       done = true;
     } else {
       done = false;
@@ -230,11 +327,7 @@ void CommTaskManager::CommTaskLoop() {
 }
 
 void CommTaskManager::CommTaskClearLoop() {
-  std::future<void> future;
   while (!terminated_.load()) {
-    if (future.valid()) {
-      future.wait();
-    }
     std::unique_lock<std::mutex> lock(comm_task_clear_list_mutex_);
     comm_task_clear_list_cv_.wait_for(
         lock,
@@ -242,19 +335,52 @@ void CommTaskManager::CommTaskClearLoop() {
         [&]() -> bool { return terminated_.load(); });
 
     VLOG(3) << "comm_task_clear_list_ size: " << comm_task_clear_list_.size();
-    for (auto iter = comm_task_clear_list_.begin();
-         iter != comm_task_clear_list_.end();) {
-      auto task = *iter;
-      VLOG(3) << "start clear task: " << task->GetTraceMsg();
-      future = std::async(std::launch::async, [&]() { task->ClearRecord(); });
-      if (future.wait_for(std::chrono::seconds(30)) ==
-          std::future_status::timeout) {
-        VLOG(0) << "clear task timeout, detail: " << task->GetTraceMsg();
-        break;
+    // the events are handed back to the pool, no device call that may hang
+    for (auto& task : comm_task_clear_list_) {
+      VLOG(3) << "clear task: " << task->GetTraceMsg();
+      task->ClearRecord();
+    }
+    comm_task_clear_list_.clear();
+  }
+}
+
+void CommTaskManager::RecordLatency(const std::shared_ptr<CommTask>& task) {
+  if (!task->IsTimed()) {
+    return;
+  }
+  float elapsed_ms = task->GetElapsedMillis();
+  if (elapsed_ms < 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(latency_histograms_mutex_);
+  latency_histograms_[CommTypeToString(task->GetCommType())].Add(
+      static_cast<double>(elapsed_ms) * 1000);
+}
+
+std::map<std::string, CommLatencyHistogram>
+CommTaskManager::GetLatencyHistograms() {
+  std::lock_guard<std::mutex> guard(latency_histograms_mutex_);
+  return latency_histograms_;
+}
+
+void CommTaskManager::ResetLatencyHistograms() {
+  std::lock_guard<std::mutex> guard(latency_histograms_mutex_);
+  latency_histograms_.clear();
+}
+
+void CommTaskManager::LogLatencyHistograms() {
+  for (const auto& item : GetLatencyHistograms()) {
+    const auto& histogram = item.second;
+    std::ostringstream os;
+    os << "op:" << item.first << ",count:" << histogram.count
+       << ",mean_us:" << histogram.sum_us / histogram.count
+       << ",max_us:" << histogram.max_us << ",buckets:";
+    for (int i = 0; i < CommLatencyHistogram::kBucketNum; ++i) {
+      if (histogram.buckets[i] > 0) {
+        os << "[" << (int64_t{1} << i) << "us:" << histogram.buckets[i] << "]";
       }
-      VLOG(3) << "end clear task: " << task->GetTraceMsg();
-      iter = comm_task_clear_list_.erase(iter);
     }
+    LOG(INFO) << "Comm latency " << os.str();
   }
 }
 
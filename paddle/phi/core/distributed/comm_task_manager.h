@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <iostream>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <unordered_map>
 
@@ -34,6 +37,45 @@ enum ErrorHandlingMode { NoHandling = 0, TearDown = 1 };
 
 class Store;
 
+// A bounded multi-producer single-consumer queue of the enqueued tasks, the
+// process groups push without taking the lock the watchdog holds while it
+// scans the tasks. The slots are allocated once.
+class CommTaskRing {
+ public:
+  explicit CommTaskRing(size_t capacity);
+
+  // Moves `*task` into the ring, returns false and leaves it untouched if the
+  // ring is full.
+  bool Push(std::shared_ptr<CommTask>* task);
+  // Only called by the consumer.
+  bool Pop(std::shared_ptr<CommTask>* task);
+  bool Empty() const;
+
+ private:
+  struct Slot {
+    std::atomic<size_t> seq;
+    std::shared_ptr<CommTask> task;
+  };
+
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+// The latency of the timed collectives of one type, bucket i counts the ones
+// that took [2^i, 2^(i+1)) microseconds.
+struct CommLatencyHistogram {
+  static constexpr int kBucketNum = 32;
+
+  void Add(double micros);
+
+  int64_t count = 0;
+  double sum_us = 0;
+  double max_us = 0;
+  std::array<int64_t, kBucketNum> buckets{};
+};
+
 class CommTaskManager {
  public:
   CommTaskManager();
@@ -51,10 +93,19 @@ class CommTaskManager {
   void UpdateLastCommTask(std::shared_ptr<CommTask> comm_task);
   void SetTimeout(int64_t timeout);
 
+  // by the name of the comm type, see FLAGS_comm_trace_timing_interval
+  static std::map<std::string, CommLatencyHistogram> GetLatencyHistograms();
+  static void ResetLatencyHistograms();
+
  private:
   void CommTaskLoop();
   void CommTaskClearLoop();
   bool IsTimeout();
+  // moves the tasks pushed to the ring to comm_task_list_, the lock of the
+  // list is held
+  void DrainCommTaskRing();
+  static void RecordLatency(const std::shared_ptr<CommTask>& task);
+  static void LogLatencyHistograms();
 
   static std::thread comm_task_loop_thread_;
   static std::thread comm_task_clear_loop_thread_;
@@ -65,6 +116,7 @@ class CommTaskManager {
   static std::mutex comm_task_list_mutex_;
   static std::condition_variable comm_task_list_cv_;
   static std::list<std::shared_ptr<CommTask>> comm_task_list_;
+  static CommTaskRing comm_task_ring_;
 
   static std::mutex comm_task_clear_list_mutex_;
   static std::condition_variable comm_task_clear_list_cv_;
@@ -81,6 +133,9 @@ class CommTaskManager {
   static std::unordered_map<std::string, std::shared_ptr<CommTask>>
       group_last_comm_task_;
   static std::chrono::time_point<std::chrono::steady_clock> last_update_time_;
+
+  static std::mutex latency_histograms_mutex_;
+  static std::map<std::string, CommLatencyHistogram> latency_histograms_;
   std::chrono::milliseconds timeout_;
   bool logged_ = false;
 };
@@ -0,0 +1,305 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/gloo_allreduce.h"
+
+#include <gloo/transport/unbound_buffer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/errors.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_string(gloo_allreduce_algorithm);
+COMMON_DECLARE_int64(gloo_allreduce_tree_threshold);
+COMMON_DECLARE_int64(gloo_allreduce_ring_threshold);
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+bool IsPowerOfTwo(int n) { return n > 0 && (n & (n - 1)) == 0; }
+
+// The state of one in-place all_reduce. The partial results of the peers
+// are received into tmp and reduced into data.
+class AllReduceRunner {
+ public:
+  AllReduceRunner(gloo::Context* context,
+                  void* data,
+                  size_t count,
+                  size_t elem_size,
+                  GlooReduceFunc reduce,
+                  gloo::Slot slot)
+      : context_(context),
+        rank_(context->rank),
+        size_(context->size),
+        data_(static_cast<uint8_t*>(data)),
+        count_(count),
+        elem_size_(elem_size),
+        reduce_(reduce),
+        slot_(slot),
+        timeout_(context->getTimeout()),
+        tmp_(count * elem_size) {
+    data_buf_ = context_->createUnboundBuffer(data_, count_ * elem_size_);
+    tmp_buf_ = context_->createUnboundBuffer(tmp_.data(), tmp_.size());
+  }
+
+  void Ring();
+  void HalvingDoubling();
+  void Tree();
+
+ private:
+  // Sends the elements [send_begin, send_end) to dst while receiving the
+  // elements [recv_begin, recv_end) from src, both may be empty. The
+  // received elements are reduced into data if `reduce`, or overwrite it.
+  void Exchange(int dst,
+                size_t send_begin,
+                size_t send_end,
+                int src,
+                size_t recv_begin,
+                size_t recv_end,
+                bool reduce);
+
+  // The begin of the i-th of the n near-even segments of data.
+  size_t SegmentBegin(int i, int n) const {
+    return count_ / n * i + std::min<size_t>(i, count_ % n);
+  }
+
+  gloo::Context* context_;
+  const int rank_;
+  const int size_;
+  uint8_t* data_;
+  const size_t count_;
+  const size_t elem_size_;
+  const GlooReduceFunc reduce_;
+  const gloo::Slot slot_;
+  const std::chrono::milliseconds timeout_;
+  std::vector<uint8_t> tmp_;
+  std::unique_ptr<gloo::transport::UnboundBuffer> data_buf_;
+  std::unique_ptr<gloo::transport::UnboundBuffer> tmp_buf_;
+};
+
+void AllReduceRunner::Exchange(int dst,
+                               size_t send_begin,
+                               size_t send_end,
+                               int src,
+                               size_t recv_begin,
+                               size_t recv_end,
+                               bool reduce) {
+  const bool send = dst >= 0 && send_end > send_begin;
+  const bool recv = src >= 0 && recv_end > recv_begin;
+  const size_t recv_offset = recv_begin * elem_size_;
+  const size_t recv_bytes = (recv_end - recv_begin) * elem_size_;
+  if (send) {
+    data_buf_->send(dst,
+                    slot_,
+                    send_begin * elem_size_,
+                    (send_end - send_begin) * elem_size_);
+  }
+  if (recv) {
+    auto* buf = reduce ? tmp_buf_.get() : data_buf_.get();
+    buf->recv(src, slot_, recv_offset, recv_bytes);
+    buf->waitRecv(timeout_);
+    if (reduce) {
+      reduce_(data_ + recv_offset,
+              data_ + recv_offset,
+              tmp_.data() + recv_offset,
+              recv_end - recv_begin);
+    }
+  }
+  if (send) {
+    data_buf_->waitSend(timeout_);
+  }
+}
+
+void AllReduceRunner::Ring() {
+  const int right = (rank_ + 1) % size_;
+  const int left = (rank_ + size_ - 1) % size_;
+  // reduce-scatter: after step s the segment rank - s - 1 holds the partial
+  // result of s + 2 ranks, at the end the segment rank + 1 holds all of them
+  for (int s = 0; s < size_ - 1; ++s) {
+    const int send_seg = (rank_ - s + size_) % size_;
+    const int recv_seg = (rank_ - s - 1 + size_) % size_;
+    Exchange(right,
+             SegmentBegin(send_seg, size_),
+             SegmentBegin(send_seg + 1, size_),
+             left,
+             SegmentBegin(recv_seg, size_),
+             SegmentBegin(recv_seg + 1, size_),
+             /*reduce=*/true);
+  }
+  // all-gather: pass the reduced segments around the ring
+  for (int s = 0; s < size_ - 1; ++s) {
+    const int send_seg = (rank_ + 1 - s + size_) % size_;
+    const int recv_seg = (rank_ - s + size_) % size_;
+    Exchange(right,
+             SegmentBegin(send_seg, size_),
+             SegmentBegin(send_seg + 1, size_),
+             left,
+             SegmentBegin(recv_seg, size_),
+             SegmentBegin(recv_seg + 1, size_),
+             /*reduce=*/false);
+  }
+}
+
+void AllReduceRunner::HalvingDoubling() {
+  // reduce-scatter: each step halves the range a rank owns with the peer
+  // owning the same range, the ranks with the bit of the step set keep the
+  // upper half
+  size_t begin = 0;
+  size_t end = count_;
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (int mask = size_ / 2; mask > 0; mask >>= 1) {
+    const int peer = rank_ ^ mask;
+    const size_t mid = begin + (end - begin) / 2;
+    ranges.emplace_back(begin, end);
+    if (rank_ & mask) {
+      Exchange(peer, begin, mid, peer, mid, end, /*reduce=*/true);
+      begin = mid;
+    } else {
+      Exchange(peer, mid, end, peer, begin, mid, /*reduce=*/true);
+      end = mid;
+    }
+  }
+  // all-gather: undo the steps, each merging the range with the other half
+  // owned by the peer
+  for (int mask = 1; mask < size_; mask <<= 1) {
+    const int peer = rank_ ^ mask;
+    const auto parent = ranges.back();
+    ranges.pop_back();
+    const size_t other_begin = begin == parent.first ? end : parent.first;
+    const size_t other_end = begin == parent.first ? parent.second : begin;
+    Exchange(peer,
+             begin,
+             end,
+             peer,
+             other_begin,
+             other_end,
+             /*reduce=*/false);
+    begin = parent.first;
+    end = parent.second;
+  }
+}
+
+void AllReduceRunner::Tree() {
+  // binomial tree reduce to rank 0: a rank receives from its children at
+  // the bits below its lowest set bit, then sends to its parent
+  for (int mask = 1; mask < size_; mask <<= 1) {
+    if (rank_ & mask) {
+      Exchange(rank_ ^ mask, 0, count_, -1, 0, 0, /*reduce=*/true);
+      break;
+    }
+    if ((rank_ | mask) < size_) {
+      Exchange(-1, 0, 0, rank_ | mask, 0, count_, /*reduce=*/true);
+    }
+  }
+  // broadcast down the same tree
+  int top = 1;
+  while (top < size_) {
+    top <<= 1;
+  }
+  for (int mask = top >> 1; mask > 0; mask >>= 1) {
+    if (rank_ % (2 * mask) == 0 && rank_ + mask < size_) {
+      Exchange(rank_ + mask, 0, count_, -1, 0, 0, /*reduce=*/false);
+    } else if (rank_ % (2 * mask) == mask) {
+      Exchange(-1, 0, 0, rank_ - mask, 0, count_, /*reduce=*/false);
+    }
+  }
+}
+
+}  // namespace
+
+GlooAllReduceAlgorithm SelectGlooAllReduceAlgorithm(size_t bytes,
+                                                    int world_size) {
+  const std::string& name = FLAGS_gloo_allreduce_algorithm;
+  if (name == "default") {
+    return GlooAllReduceAlgorithm::kDefault;
+  }
+  if (name == "ring") {
+    return GlooAllReduceAlgorithm::kRing;
+  }
+  if (name == "tree") {
+    return GlooAllReduceAlgorithm::kTree;
+  }
+  if (name == "halving_doubling") {
+    return IsPowerOfTwo(world_size) ? GlooAllReduceAlgorithm::kHalvingDoubling
+                                    : GlooAllReduceAlgorithm::kRing;
+  }
+  PADDLE_ENFORCE_EQ(
+      name,
+      "auto",
+      common::errors::InvalidArgument(
+          "FLAGS_gloo_allreduce_algorithm should be one of default, auto, "
+          "ring, halving_doubling and tree, but got %s.",
+          name));
+  if (bytes < static_cast<size_t>(FLAGS_gloo_allreduce_tree_threshold)) {
+    return GlooAllReduceAlgorithm::kTree;
+  }
+  if (bytes < static_cast<size_t>(FLAGS_gloo_allreduce_ring_threshold) &&
+      IsPowerOfTwo(world_size)) {
+    return GlooAllReduceAlgorithm::kHalvingDoubling;
+  }
+  return GlooAllReduceAlgorithm::kRing;
+}
+
+void GlooAllReduceInPlace(gloo::Context* context,
+                          void* data,
+                          size_t count,
+                          size_t elem_size,
+                          GlooReduceFunc reduce,
+                          GlooAllReduceAlgorithm algorithm,
+                          uint32_t tag,
+                          uint8_t slot_offset) {
+  if (context->size == 1 || count == 0) {
+    return;
+  }
+  AllReduceRunner runner(context,
+                         data,
+                         count,
+                         elem_size,
+                         reduce,
+                         gloo::Slot::build(kAllReduceSlotPrefix, tag) +
+                             slot_offset);
+  switch (algorithm) {
+    case GlooAllReduceAlgorithm::kRing:
+      runner.Ring();
+      break;
+    case GlooAllReduceAlgorithm::kHalvingDoubling:
+      PADDLE_ENFORCE_EQ(IsPowerOfTwo(context->size),
+                        true,
+                        common::errors::InvalidArgument(
+                            "The halving-doubling all_reduce needs a power "
+                            "of two ranks, but got %d.",
+                            context->size));
+      runner.HalvingDoubling();
+      break;
+    case GlooAllReduceAlgorithm::kTree:
+      runner.Tree();
+      break;
+    default:
+      PADDLE_THROW(common::errors::InvalidArgument(
+          "GlooAllReduceInPlace does not run the default algorithm of "
+          "gloo."));
+  }
+}
+
+}  // namespace distributed
+}  // namespace phi
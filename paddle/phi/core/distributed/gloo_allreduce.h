@@ -0,0 +1,62 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gloo/context.h>
+#include <gloo/types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace phi {
+namespace distributed {
+
+enum class GlooAllReduceAlgorithm {
+  // gloo::allreduce
+  kDefault,
+  // reduce-scatter and all-gather around a ring, bandwidth optimal
+  kRing,
+  // recursive halving reduce-scatter and recursive doubling all-gather,
+  // bandwidth optimal in log(p) steps on a power of two ranks
+  kHalvingDoubling,
+  // binomial tree reduce and broadcast, latency optimal for small messages
+  kTree,
+};
+
+// Selects the algorithm by FLAGS_gloo_allreduce_algorithm and the bytes of
+// the message.
+GlooAllReduceAlgorithm SelectGlooAllReduceAlgorithm(size_t bytes,
+                                                    int world_size);
+
+using GlooReduceFunc = void (*)(void*, const void*, const void*, size_t);
+
+constexpr uint8_t kAllReduceSlotPrefix = 0x10;
+
+// Reduces the `count` elements of `elem_size` bytes at `data` in place over
+// all ranks of `context` with `reduce`, the signature of gloo::sum.
+// `algorithm` should not be kDefault. Every rank runs the same call, the
+// messages are matched on the slot built from `tag` plus `slot_offset`, so
+// calls running at the same time need different slot offsets.
+void GlooAllReduceInPlace(gloo::Context* context,
+                          void* data,
+                          size_t count,
+                          size_t elem_size,
+                          GlooReduceFunc reduce,
+                          GlooAllReduceAlgorithm algorithm,
+                          uint32_t tag,
+                          uint8_t slot_offset = 0);
+
+}  // namespace distributed
+}  // namespace phi
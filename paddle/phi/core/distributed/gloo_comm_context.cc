@@ -24,11 +24,21 @@
 #include <gloo/scatter.h>
 #include <gloo/types.h>
 
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/check/static_check.h"
 #include "paddle/phi/core/enforce.h"
 
+COMMON_DECLARE_int32(gloo_allreduce_num_threads);
+COMMON_DECLARE_bool(gloo_allreduce_bf16_compress);
+
 namespace phi {
 namespace distributed {
 
@@ -77,10 +87,124 @@ void GlooCommContext::AllGather(phi::DenseTensor* out_tensor,
   gloo::allgather(opts);
 }
 
+namespace {
+
+// A chunk of a split all_reduce has at least so many bytes.
+constexpr size_t kMinAllReduceChunkBytes = 1 << 20;
+constexpr int kMaxAllReduceThreads = 64;
+
+// Captures the reduce function SetReduceFunc selects.
+struct ReduceFuncHolder {
+  GlooReduceFunc func = nullptr;
+  void setReduceFunction(GlooReduceFunc f) { func = f; }
+};
+
+}  // namespace
+
+void GlooCommContext::AllReduceInPlace(void* data,
+                                       size_t count,
+                                       size_t elem_size,
+                                       GlooReduceFunc reduce,
+                                       GlooAllReduceAlgorithm algorithm,
+                                       uint32_t tag) {
+  const int max_threads =
+      std::min(std::max(FLAGS_gloo_allreduce_num_threads, 1),
+               kMaxAllReduceThreads);
+  const size_t num_chunks = std::max<size_t>(
+      1,
+      std::min<size_t>(max_threads,
+                       count * elem_size / kMinAllReduceChunkBytes));
+  if (num_chunks == 1) {
+    GlooAllReduceInPlace(
+        gloo_context_.get(), data, count, elem_size, reduce, algorithm, tag);
+    return;
+  }
+  std::call_once(allreduce_pool_flag_, [&] {
+    allreduce_pool_ = std::make_unique<ThreadPool>(kMaxAllReduceThreads - 1);
+  });
+  // the chunks run at the same time on the slots of their index
+  auto* bytes = static_cast<uint8_t*>(data);
+  auto chunk_begin = [=](size_t i) {
+    return count / num_chunks * i + std::min(i, count % num_chunks);
+  };
+  auto run_chunk = [=](size_t i) {
+    const size_t begin = chunk_begin(i);
+    const size_t end = chunk_begin(i + 1);
+    GlooAllReduceInPlace(gloo_context_.get(),
+                         bytes + begin * elem_size,
+                         end - begin,
+                         elem_size,
+                         reduce,
+                         algorithm,
+                         tag,
+                         static_cast<uint8_t>(i));
+  };
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < num_chunks; ++i) {
+    futures.push_back(allreduce_pool_->Run([=] { run_chunk(i); }));
+  }
+  run_chunk(0);
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+void GlooCommContext::AllReduceBF16Compressed(
+    phi::DenseTensor* out_tensor,
+    const phi::DenseTensor& in_tensor,
+    uint32_t tag) {
+  const int64_t numel = in_tensor.numel();
+  const float* in = in_tensor.data<float>();
+  float* out = out_tensor->data<float>();
+  std::vector<phi::dtype::bfloat16> wire(numel);
+  for (int64_t i = 0; i < numel; ++i) {
+    wire[i] = static_cast<phi::dtype::bfloat16>(in[i]);
+  }
+  const size_t bytes = numel * sizeof(phi::dtype::bfloat16);
+  auto algorithm = SelectGlooAllReduceAlgorithm(bytes, size_);
+  if (algorithm == GlooAllReduceAlgorithm::kDefault) {
+    algorithm = GlooAllReduceAlgorithm::kRing;
+  }
+  AllReduceInPlace(
+      wire.data(),
+      numel,
+      sizeof(phi::dtype::bfloat16),
+      static_cast<GlooReduceFunc>(&gloo::sum<phi::dtype::bfloat16>),
+      algorithm,
+      tag);
+  for (int64_t i = 0; i < numel; ++i) {
+    out[i] = static_cast<float>(wire[i]);
+  }
+}
+
 void GlooCommContext::AllReduce(phi::DenseTensor* out_tensor,
                                 const phi::DenseTensor& in_tensor,
                                 int reduce_type,
                                 uint32_t tag) {
+  const auto& dtype = in_tensor.dtype();
+  const size_t bytes = in_tensor.numel() * phi::SizeOf(dtype);
+  auto algorithm = SelectGlooAllReduceAlgorithm(bytes, size_);
+  if (algorithm != GlooAllReduceAlgorithm::kDefault &&
+      FLAGS_gloo_allreduce_bf16_compress && dtype == DataType::FLOAT32 &&
+      static_cast<ReduceType>(reduce_type) == ReduceType::kRedSum) {
+    AllReduceBF16Compressed(out_tensor, in_tensor, tag);
+    return;
+  }
+  if (algorithm != GlooAllReduceAlgorithm::kDefault) {
+    if (out_tensor->data() != in_tensor.data()) {
+      std::memcpy(out_tensor->data(), in_tensor.data(), bytes);
+    }
+    ReduceFuncHolder holder;
+    GENERATE_FUNC(dtype, SetReduceFunc, &holder, reduce_type);
+    AllReduceInPlace(out_tensor->data(),
+                     in_tensor.numel(),
+                     phi::SizeOf(dtype),
+                     holder.func,
+                     algorithm,
+                     tag);
+    return;
+  }
+
   gloo::AllreduceOptions opts(gloo_context_);
   opts.setTag(tag);
   const auto& dtype = in_tensor.dtype();
@@ -18,9 +18,12 @@
 #include <gloo/transport/tcp/device.h>
 
 #include <memory>
+#include <mutex>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/distributed/comm_context.h"
+#include "paddle/phi/core/distributed/gloo_allreduce.h"
+#include "paddle/phi/core/threadpool.h"
 
 namespace phi {
 class DenseTensor;
@@ -73,7 +76,25 @@ class GlooCommContext final : public CommContext {
  private:
   DISABLE_COPY_AND_ASSIGN(GlooCommContext);
 
+  // Reduces `count` elements at `data` in place with `algorithm`, split
+  // across FLAGS_gloo_allreduce_num_threads threads when large.
+  void AllReduceInPlace(void* data,
+                        size_t count,
+                        size_t elem_size,
+                        GlooReduceFunc reduce,
+                        GlooAllReduceAlgorithm algorithm,
+                        uint32_t tag);
+
+  // Sends the float32 sum all_reduce as bfloat16.
+  void AllReduceBF16Compressed(phi::DenseTensor* out_tensor,
+                               const phi::DenseTensor& in_tensor,
+                               uint32_t tag);
+
   std::shared_ptr<gloo::rendezvous::Context> gloo_context_;
+
+  // runs the chunks of a large all_reduce, created on the first one
+  std::unique_ptr<ThreadPool> allreduce_pool_;
+  std::once_flag allreduce_pool_flag_;
 };
 
 }  // namespace distributed
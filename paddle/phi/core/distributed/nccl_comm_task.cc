@@ -14,15 +14,72 @@
 
 #include "paddle/phi/core/distributed/nccl_comm_task.h"
 
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include "gflags/gflags.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/distributed/nccl_tools.h"
 #include "paddle/phi/core/utils/data_type.h"
 
+COMMON_DECLARE_int32(comm_trace_timing_interval);
+
 namespace phi::distributed {
 
+namespace {
+
+// The events of the finished tasks are kept for the next ones, creating and
+// destroying two events per collective costs more host time than issuing a
+// small collective.
+class NCCLEventPool {
+ public:
+  static NCCLEventPool& Instance() {
+    // never destroyed, the events may be in use during static destruction
+    static auto* pool = new NCCLEventPool();
+    return *pool;
+  }
+
+  gpuEvent_t Get(int device, bool timing) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto& events = free_events_[{device, timing}];
+      if (!events.empty()) {
+        gpuEvent_t event = events.back();
+        events.pop_back();
+        return event;
+      }
+    }
+    backends::gpu::GPUDeviceGuard guard(device);
+    gpuEvent_t event;
+#ifdef PADDLE_WITH_CUDA
+    CUDA_CHECK(cudaEventCreateWithFlags(
+        &event, timing ? cudaEventDefault : cudaEventDisableTiming));
+#else  // PADDLE_WITH_HIP
+    HIP_CHECK(hipEventCreateWithFlags(
+        &event, timing ? hipEventDefault : hipEventDisableTiming));
+#endif
+    return event;
+  }
+
+  void Put(int device, bool timing, gpuEvent_t event) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    free_events_[{device, timing}].push_back(event);
+  }
+
+ private:
+  NCCLEventPool() = default;
+
+  std::mutex mutex_;
+  std::map<std::pair<int, bool>, std::vector<gpuEvent_t>> free_events_;
+};
+
+}  // namespace
+
 NCCLCommTask::NCCLCommTask(const phi::Place& place,
                            const std::string& group_key,
                            int rank,
@@ -50,6 +107,8 @@ NCCLCommTask::NCCLCommTask(const phi::Place& place,
       timeout_(std::chrono::milliseconds(timeout)),
       sync_op_(sync_op),
       use_calc_stream_(use_calc_stream),
+      timing_(FLAGS_comm_trace_timing_interval > 0 &&
+              seq % FLAGS_comm_trace_timing_interval == 0),
       nccl_start_event_(nullptr),
       nccl_end_event_(nullptr) {
   start_trace_updated_ = false;
@@ -61,11 +120,7 @@ NCCLCommTask::NCCLCommTask(const phi::Place& place,
 void NCCLCommTask::StartRecord() {
   backends::gpu::GPUDeviceGuard guard(place_.device);
   if (!start_event_created_) {
-#ifdef PADDLE_WITH_CUDA
-    CUDA_CHECK(cudaEventCreateWithFlags(&nccl_start_event_, cuda_event_flags_));
-#else  // PADDLE_WITH_HIP
-    HIP_CHECK(hipEventCreateWithFlags(&nccl_start_event_, hip_event_flags_));
-#endif
+    nccl_start_event_ = NCCLEventPool::Instance().Get(place_.device, timing_);
     start_event_created_ = true;
   }
 #ifdef PADDLE_WITH_CUDA
@@ -77,11 +132,7 @@ void NCCLCommTask::StartRecord() {
 void NCCLCommTask::EndRecord() {
   backends::gpu::GPUDeviceGuard guard(place_.device);
   if (!end_event_created_) {
-#ifdef PADDLE_WITH_CUDA
-    CUDA_CHECK(cudaEventCreateWithFlags(&nccl_end_event_, cuda_event_flags_));
-#else  // PADDLE_WITH_HIP
-    HIP_CHECK(hipEventCreateWithFlags(&nccl_end_event_, hip_event_flags_));
-#endif
+    nccl_end_event_ = NCCLEventPool::Instance().Get(place_.device, timing_);
     end_event_created_ = true;
   }
 #ifdef PADDLE_WITH_CUDA
@@ -91,33 +142,33 @@ void NCCLCommTask::EndRecord() {
 #endif
 }
 
-#ifdef PADDLE_WITH_CUDA
+// Only the tasks completed are cleared, the events are free to reuse.
 void NCCLCommTask::ClearRecord() {
   if (start_event_created_) {
-    backends::gpu::GPUDeviceGuard guard(place_.device);
-    CUDA_CHECK(cudaEventDestroy(nccl_start_event_));
+    NCCLEventPool::Instance().Put(place_.device, timing_, nccl_start_event_);
     start_event_created_ = false;
   }
   if (end_event_created_) {
-    backends::gpu::GPUDeviceGuard guard(place_.device);
-    CUDA_CHECK(cudaEventDestroy(nccl_end_event_));
+    NCCLEventPool::Instance().Put(place_.device, timing_, nccl_end_event_);
     end_event_created_ = false;
   }
 }
-#else  // PADDLE_WITH_HIP
-void NCCLCommTask::ClearRecord() {
-  if (start_event_created_) {
-    backends::gpu::GPUDeviceGuard guard(place_.device);
-    HIP_CHECK(hipEventDestroy(nccl_start_event_));
-    start_event_created_ = false;
-  }
-  if (end_event_created_) {
-    backends::gpu::GPUDeviceGuard guard(place_.device);
-    HIP_CHECK(hipEventDestroy(nccl_end_event_));
-    end_event_created_ = false;
+
+float NCCLCommTask::GetElapsedMillis() {
+  if (!timing_ || !start_event_created_ || !end_event_created_ ||
+      !IsCompleted()) {
+    return -1.0f;
   }
-}
+  float elapsed_ms = 0.0f;
+#ifdef PADDLE_WITH_CUDA
+  CUDA_CHECK(
+      cudaEventElapsedTime(&elapsed_ms, nccl_start_event_, nccl_end_event_));
+#else  // PADDLE_WITH_HIP
+  HIP_CHECK(
+      hipEventElapsedTime(&elapsed_ms, nccl_start_event_, nccl_end_event_));
 #endif
+  return elapsed_ms;
+}
 
 bool NCCLCommTask::CudaEventQuery(gpuEvent_t event) {
 #ifdef PADDLE_WITH_CUDA
@@ -63,20 +63,19 @@ class NCCLCommTask : public CommTask {
   void EndRecord() override;
   void ClearRecord() override;
 
+  bool IsTimed() override { return timing_; }
+  float GetElapsedMillis() override;
+
   bool CudaEventQuery(gpuEvent_t event);
 
  protected:
   std::mutex mutex_;
   std::chrono::milliseconds timeout_;
 
-#ifdef PADDLE_WITH_CUDA
-  unsigned int cuda_event_flags_ = cudaEventDisableTiming;
-#else  // PADDLE_WITH_HIP
-  unsigned int hip_event_flags_ = hipEventDisableTiming;
-#endif
-
   bool sync_op_;
   bool use_calc_stream_;
+  // the events are created with timing enabled
+  bool timing_;
 
   bool start_event_created_;
   bool end_event_created_;
@@ -20,8 +20,11 @@
 // there will be symbol redefinition error on windows
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/distributed/auto_parallel/utils.h"
 
+COMMON_DECLARE_int32(tcp_store_relay_port);
+
 namespace phi {
 namespace distributed {
 using auto_parallel::str_split;
@@ -44,6 +47,11 @@ std::string GetMasterEndpoint() {
           "The environment variable 'PADDLE_MASTER' cannot be found."));
   return master_endpoint;
 }
+
+int64_t GetEnvInt(const char* name, int64_t default_value) {
+  const char* value = std::getenv(name);
+  return value == nullptr ? default_value : std::atoll(value);
+}
 }  // namespace
 
 int64_t GetCurGlobalRank() {
@@ -79,8 +87,16 @@ std::shared_ptr<Store> CreateOrGetGlobalTCPStore() {
   int64_t world_size = GetGlobalWorldSize();
   bool is_master = (cur_rank == 0);
 
-  static std::shared_ptr<TCPStore> store =
-      std::make_shared<TCPStore>(host, port, is_master, world_size);
+  // a relay only pays off if several ranks share a node
+  uint16_t relay_port = 0;
+  bool is_relay = false;
+  if (FLAGS_tcp_store_relay_port > 0 && GetEnvInt("PADDLE_LOCAL_SIZE", 1) > 1) {
+    relay_port = static_cast<uint16_t>(FLAGS_tcp_store_relay_port);
+    is_relay = (GetEnvInt("PADDLE_LOCAL_RANK", 0) == 0);
+  }
+
+  static std::shared_ptr<TCPStore> store = std::make_shared<TCPStore>(
+      host, port, is_master, world_size, 900, relay_port, is_relay);
   return store;
 }
 
@@ -14,6 +14,7 @@
 
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -120,6 +121,38 @@ void MasterDaemon::_do_check(SocketType socket) {
   }
 }
 
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto num = tcputils::receive_value<size_t>(socket);
+  std::vector<std::string> keys(num);
+  for (auto& key : keys) {
+    key = tcputils::receive_string(socket);
+  }
+  VLOG(8) << "MasterDaemon::_do_multi_get " << num << " keys "
+          << GetSockName(socket);
+
+  for (const auto& key : keys) {
+    auto iter = _store.find(key);
+    PADDLE_ENFORCE_NE(
+        iter,
+        _store.end(),
+        common::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+  }
+  for (const auto& key : keys) {
+    tcputils::send_vector<uint8_t>(socket, _store[key]);
+  }
+}
+
+void MasterDaemon::_do_multi_set(SocketType socket) {
+  auto num = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_set " << num << " keys "
+          << GetSockName(socket);
+  for (size_t i = 0; i < num; ++i) {
+    std::string key = tcputils::receive_string(socket);
+    _store[key] = tcputils::receive_vector<uint8_t>(socket);
+    _notify_waiting_sockets(key);
+  }
+}
+
 #ifndef _WIN32
 void MasterDaemon::InitControlFd() {
   PADDLE_ENFORCE_NE(
@@ -209,6 +242,12 @@ void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
         case Command::WAIT:
           _do_wait(fds[i].fd);
           break;
+        case Command::MULTI_GET:
+          _do_multi_get(fds[i].fd);
+          break;
+        case Command::MULTI_SET:
+          _do_multi_set(fds[i].fd);
+          break;
         default:
           VLOG(8) << "Unknown command: " << static_cast<int>(command)
                   << " from addr info:" << GetSockName(fds[i].fd);
@@ -319,6 +358,293 @@ std::unique_ptr<TCPServer> TCPServer::create(uint16_t port,
   return server;
 }
 
+#ifndef _WIN32
+std::unique_ptr<RelayDaemon> RelayDaemon::start(SocketType listen_socket,
+                                                const std::string& master_host,
+                                                uint16_t master_port) {
+  return std::make_unique<RelayDaemon>(listen_socket, master_host, master_port);
+}
+
+RelayDaemon::RelayDaemon(SocketType listen_socket,
+                         const std::string& master_host,
+                         uint16_t master_port)
+    : _listen_socket(listen_socket),
+      _master_host(master_host),
+      _master_port(master_port) {
+  _upstream = Upstream();
+  PADDLE_ENFORCE_NE(
+      pipe(_control_fd.data()),
+      -1,
+      common::errors::Fatal("failed to cread control pipe errno:%d", errno));
+  _background_thread = std::thread{&RelayDaemon::run, this};
+}
+
+RelayDaemon::~RelayDaemon() {  // NOLINT
+  VLOG(8) << ("begin to destruct RelayDaemon");
+  if (_control_fd[1] != -1) {
+    PADDLE_ENFORCE_NE(
+        ::write(_control_fd[1], "\0", 1),
+        -1,
+        common::errors::Fatal("failed to write control pipe errno:%d", errno));
+    ::close(_control_fd[1]);
+    _control_fd[1] = -1;
+  }
+  _background_thread.join();
+  tcputils::close_socket(_listen_socket);
+  for (SocketType socket : _sockets) {
+    tcputils::close_socket(socket);
+  }
+  for (const auto& item : _upstream_waits) {
+    tcputils::close_socket(item.first);
+  }
+  for (SocketType socket : _idle_upstreams) {
+    tcputils::close_socket(socket);
+  }
+  tcputils::close_socket(_upstream);
+  ::close(_control_fd[0]);
+}
+
+SocketType RelayDaemon::Upstream() {
+  if (!_idle_upstreams.empty()) {
+    SocketType socket = _idle_upstreams.back();
+    _idle_upstreams.pop_back();
+    return socket;
+  }
+  return tcputils::tcp_connect(
+      _master_host, std::to_string(_master_port), AF_INET);
+}
+
+void RelayDaemon::CloseSocket(SocketType socket) {
+  auto iter = std::find(_sockets.begin(), _sockets.end(), socket);
+  if (iter == _sockets.end()) {
+    return;
+  }
+  _sockets.erase(iter);
+  for (auto& item : _waiting_sockets) {
+    auto& sockets = item.second;
+    sockets.erase(std::remove(sockets.begin(), sockets.end(), socket),
+                  sockets.end());
+  }
+  // closed at the end of the round, the number must not be reused by a
+  // socket accepted or connected meanwhile
+  _closing_sockets.push_back(socket);
+}
+
+void RelayDaemon::_do_wait(SocketType socket) {
+  std::string key = tcputils::receive_string(socket);
+  VLOG(8) << "RelayDaemon::_do_wait key(" << key << ") "
+          << GetSockName(socket);
+  auto& sockets = _waiting_sockets[key];
+  sockets.emplace_back(socket);
+  if (sockets.size() > 1) {
+    return;
+  }
+  // An own connection per key, the master replies only once the key is set.
+  SocketType upstream = Upstream();
+  tcputils::send_value<Command>(upstream, Command::WAIT);
+  tcputils::send_string(upstream, key);
+  _upstream_waits[upstream] = key;
+}
+
+void RelayDaemon::FinishWait(SocketType upstream) {
+  auto reply = tcputils::receive_value<ReplyType>(upstream);
+  PADDLE_ENFORCE_EQ(
+      reply == ReplyType::STOP_WAIT,
+      true,
+      common::errors::InvalidArgument("Stop_waiting response is expected"));
+  std::string key = _upstream_waits.at(upstream);
+  _upstream_waits.erase(upstream);
+  _idle_upstreams.emplace_back(upstream);
+
+  auto iter = _waiting_sockets.find(key);
+  if (iter == _waiting_sockets.end()) {
+    return;
+  }
+  auto sockets = std::move(iter->second);
+  _waiting_sockets.erase(iter);
+  for (SocketType socket : sockets) {
+    try {
+      tcputils::send_value<ReplyType>(socket, ReplyType::STOP_WAIT);
+    } catch (const std::exception& ex) {
+      VLOG(5) << "Meet some exceptions during notify:" << ex.what();
+      CloseSocket(socket);
+    }
+  }
+}
+
+void RelayDaemon::_do_forward(Command command, SocketType socket) {
+  // The whole command is received before anything is sent to the master, a
+  // broken rank must not leave a partial command on the shared connection.
+  switch (command) {
+    case Command::CHECK: {
+      std::string key = tcputils::receive_string(socket);
+      tcputils::send_value<Command>(_upstream, command);
+      tcputils::send_string(_upstream, key);
+      auto reply = tcputils::receive_value<ReplyType>(_upstream);
+      tcputils::send_value<ReplyType>(socket, reply);
+      break;
+    }
+    case Command::SET: {
+      std::string key = tcputils::receive_string(socket);
+      auto value = tcputils::receive_vector<uint8_t>(socket);
+      tcputils::send_value<Command>(_upstream, command);
+      tcputils::send_string(_upstream, key);
+      tcputils::send_vector<uint8_t>(_upstream, value);
+      break;
+    }
+    case Command::MULTI_GET: {
+      auto num = tcputils::receive_value<size_t>(socket);
+      std::vector<std::string> keys(num);
+      for (auto& key : keys) {
+        key = tcputils::receive_string(socket);
+      }
+      tcputils::send_value<Command>(_upstream, command);
+      tcputils::send_value<size_t>(_upstream, num);
+      for (const auto& key : keys) {
+        tcputils::send_string(_upstream, key);
+      }
+      std::vector<std::vector<uint8_t>> values(num);
+      for (auto& value : values) {
+        value = tcputils::receive_vector<uint8_t>(_upstream);
+      }
+      for (const auto& value : values) {
+        tcputils::send_vector<uint8_t>(socket, value);
+      }
+      break;
+    }
+    case Command::MULTI_SET: {
+      auto num = tcputils::receive_value<size_t>(socket);
+      std::vector<std::pair<std::string, std::vector<uint8_t>>> items(num);
+      for (auto& item : items) {
+        item.first = tcputils::receive_string(socket);
+        item.second = tcputils::receive_vector<uint8_t>(socket);
+      }
+      tcputils::send_value<Command>(_upstream, command);
+      tcputils::send_value<size_t>(_upstream, num);
+      for (const auto& item : items) {
+        tcputils::send_string(_upstream, item.first);
+        tcputils::send_vector<uint8_t>(_upstream, item.second);
+      }
+      break;
+    }
+    default:
+      VLOG(8) << "Unknown command: " << static_cast<int>(command)
+              << " from addr info:" << GetSockName(socket);
+  }
+}
+
+void RelayDaemon::ProcessCommand(SocketType socket) {
+  try {
+    Command command = tcputils::receive_value<Command>(socket);
+    VLOG(7) << "RelayDaemon: recv command: " << static_cast<int>(command)
+            << ".";
+    switch (command) {
+      case Command::ADD: {
+        std::string key = tcputils::receive_string(socket);
+        auto value = tcputils::receive_value<int64_t>(socket);
+        _pending_adds[key].emplace_back(socket, value);
+        break;
+      }
+      case Command::GET:
+        _pending_gets[tcputils::receive_string(socket)].emplace_back(socket);
+        break;
+      case Command::WAIT:
+        _do_wait(socket);
+        break;
+      default:
+        _do_forward(command, socket);
+    }
+  } catch (const std::exception& ex) {
+    std::string s(ex.what());
+    if (s.find("TCP connection reset by peer") != std::string::npos) {
+      VLOG(5) << "TCP connection reset by peer";
+    } else {
+      VLOG(5) << "Meet some exceptions during run:" << ex.what();
+    }
+    CloseSocket(socket);
+  }
+}
+
+void RelayDaemon::FlushMergedCommands() {
+  for (const auto& item : _pending_adds) {
+    int64_t total = 0;
+    for (const auto& add : item.second) {
+      total += add.second;
+    }
+    tcputils::send_value<Command>(_upstream, Command::ADD);
+    tcputils::send_string(_upstream, item.first);
+    tcputils::send_value<int64_t>(_upstream, total);
+    // as if the merged adds were applied one by one in the received order
+    int64_t value = tcputils::receive_value<int64_t>(_upstream) - total;
+    for (const auto& add : item.second) {
+      value += add.second;
+      try {
+        tcputils::send_value<int64_t>(add.first, value);
+      } catch (const std::exception& ex) {
+        CloseSocket(add.first);
+      }
+    }
+  }
+  _pending_adds.clear();
+
+  for (const auto& item : _pending_gets) {
+    tcputils::send_value<Command>(_upstream, Command::GET);
+    tcputils::send_string(_upstream, item.first);
+    auto value = tcputils::receive_vector<uint8_t>(_upstream);
+    for (SocketType socket : item.second) {
+      try {
+        tcputils::send_vector<uint8_t>(socket, value);
+      } catch (const std::exception& ex) {
+        CloseSocket(socket);
+      }
+    }
+  }
+  _pending_gets.clear();
+}
+
+void RelayDaemon::run() {
+  std::vector<struct pollfd> fds;
+  while (true) {
+    fds.clear();
+    fds.push_back({.fd = _listen_socket, .events = POLLIN, .revents = 0});
+    fds.push_back(
+        {.fd = _control_fd[0], .events = POLLIN | POLLHUP, .revents = 0});
+    for (const auto& item : _upstream_waits) {
+      fds.push_back({.fd = item.first, .events = POLLIN, .revents = 0});
+    }
+    for (SocketType socket : _sockets) {
+      fds.push_back({.fd = socket, .events = POLLIN, .revents = 0});
+    }
+
+    ::poll(fds.data(), fds.size(), INFTIME);
+    if (fds[1].revents != 0) {
+      VLOG(0) << "receive shutdown event and so quit from RelayDaemon run loop";
+      break;
+    }
+    if (fds[0].revents != 0) {
+      _sockets.emplace_back(tcputils::tcp_accept(_listen_socket));
+    }
+    for (size_t i = 2; i < fds.size(); ++i) {
+      if (fds[i].revents == 0) {
+        continue;
+      }
+      if (_upstream_waits.count(fds[i].fd)) {
+        FinishWait(fds[i].fd);
+      } else if (std::find(_sockets.begin(), _sockets.end(), fds[i].fd) !=
+                 _sockets.end()) {
+        ProcessCommand(fds[i].fd);
+      }
+    }
+    FlushMergedCommands();
+
+    for (SocketType socket : _closing_sockets) {
+      tcputils::close_socket(socket);
+    }
+    _closing_sockets.clear();
+  }
+}
+#endif
+
 std::unique_ptr<TCPClient> TCPClient::connect(const std::string host,
                                               uint16_t port) {
   int socket = tcputils::tcp_connect(host, std::to_string(port), AF_INET);
@@ -333,6 +659,10 @@ void TCPClient::send_command_for_key(Command type, const std::string& key) {
   tcputils::send_string(_socket, key);
 }
 
+void TCPClient::send_string(const std::string& value) {
+  tcputils::send_string(_socket, value);
+}
+
 template <typename T>
 void TCPClient::send_value(const T& value) {
   tcputils::send_bytes<T>(_socket, &value, 1);
@@ -362,7 +692,9 @@ TCPStore::TCPStore(std::string host,
                    uint16_t port,
                    bool is_master,
                    size_t num_workers,
-                   int timeout)
+                   int timeout,
+                   uint16_t relay_port,
+                   bool is_relay)
     : Store(timeout),
       _is_master(is_master),
       _num_workers(static_cast<int>(num_workers)) {
@@ -377,7 +709,22 @@ TCPStore::TCPStore(std::string host,
     _server = detail::TCPServer::create(port, this->_num_workers, timeout);
   }
 
-  _client = detail::TCPClient::connect(host, port);
+  if (relay_port != 0) {
+#ifdef _WIN32
+    PADDLE_THROW(common::errors::Unimplemented(
+        "The relay of TCPStore is not supported on Windows."));
+#else
+    if (is_relay) {
+      _relay = detail::RelayDaemon::start(
+          tcputils::tcp_listen("", std::to_string(relay_port), AF_INET),
+          host,
+          port);
+    }
+    _client = detail::TCPClient::connect("127.0.0.1", relay_port);
+#endif
+  } else {
+    _client = detail::TCPClient::connect(host, port);
+  }
   waitWorkers();
 }
 
@@ -462,6 +809,50 @@ void TCPStore::wait(const std::string& key) {
       common::errors::InvalidArgument("Stop_waiting response is expected"));
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  VLOG(7) << "TCPStore multi_get.";
+  // the waits are pipelined, the master replies as the keys are set
+  for (const auto& key : keys) {
+    _client->send_command_for_key(Command::WAIT, _key_prefix + key);
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto reply = _client->receive_value<ReplyType>();
+    PADDLE_ENFORCE_EQ(
+        reply == ReplyType::STOP_WAIT,
+        true,
+        common::errors::InvalidArgument("Stop_waiting response is expected"));
+  }
+  _client->send_command_for_key(Command::MULTI_GET, "");
+  _client->send_value<size_t>(keys.size());
+  for (const auto& key : keys) {
+    _client->send_string(_key_prefix + key);
+  }
+  std::vector<std::vector<uint8_t>> values(keys.size());
+  for (auto& value : values) {
+    value = _client->receive_vector<uint8_t>();
+  }
+  return values;
+}
+
+void TCPStore::multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+  VLOG(7) << "TCPStore multi_set.";
+  PADDLE_ENFORCE_EQ(
+      keys.size(),
+      values.size(),
+      common::errors::InvalidArgument("The number of keys (%d) and values (%d) "
+                                      "to set must be the same.",
+                                      keys.size(),
+                                      values.size()));
+  _client->send_command_for_key(Command::MULTI_SET, "");
+  _client->send_value<size_t>(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    _client->send_string(_key_prefix + keys[i]);
+    _client->send_vector<uint8_t>(values[i]);
+  }
+}
+
 TCPStore::~TCPStore() { VLOG(7) << "TCPStore destructure"; }
 
 }  // namespace phi::distributed
@@ -29,6 +29,8 @@
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "paddle/phi/core/distributed/store/socket.h"
 #include "paddle/phi/core/distributed/store/store.h"
@@ -38,7 +40,16 @@ namespace phi {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT, READY, NOT_READY };
-enum class Command { ADD, GET, CHECK, SET, WAIT, STOP };
+enum class Command {
+  ADD,
+  GET,
+  CHECK,
+  SET,
+  WAIT,
+  STOP,
+  MULTI_GET,
+  MULTI_SET
+};
 
 namespace detail {
 
@@ -61,6 +72,8 @@ class MasterDaemon {
   void _do_get(SocketType socket);
   void _do_check(SocketType socket);
   void _do_set(SocketType socket);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_set(SocketType socket);
   void _notify_waiting_sockets(const std::string&);
   SocketType _listen_socket;
   std::vector<SocketType> _sockets;
@@ -92,6 +105,54 @@ class TCPServer {
   std::unique_ptr<MasterDaemon> _master_daemon;
 };
 
+#ifndef _WIN32
+// Serves the ranks of one node and forwards their commands to the master, so
+// the master handles a connection per node rather than one per rank. The
+// waits for the same key share one wait on the master, and the adds and gets
+// of a key received in the same round are merged into one request.
+class RelayDaemon {
+ public:
+  static std::unique_ptr<RelayDaemon> start(SocketType listen_socket,
+                                            const std::string& master_host,
+                                            uint16_t master_port);
+  RelayDaemon() = delete;
+  RelayDaemon(SocketType listen_socket,
+              const std::string& master_host,
+              uint16_t master_port);
+  ~RelayDaemon();
+
+ private:
+  void run();
+  void ProcessCommand(SocketType socket);
+  void _do_wait(SocketType socket);
+  void _do_forward(Command command, SocketType socket);
+  void FinishWait(SocketType upstream);
+  void FlushMergedCommands();
+  void CloseSocket(SocketType socket);
+  SocketType Upstream();
+
+  SocketType _listen_socket;
+  std::string _master_host;
+  uint16_t _master_port;
+  // the connection the commands other than wait are forwarded through
+  SocketType _upstream = -1;
+  std::vector<SocketType> _sockets;
+  // upstream socket -> the key it waits for on the master
+  std::unordered_map<SocketType, std::string> _upstream_waits;
+  std::vector<SocketType> _idle_upstreams;
+  // key -> list of waiting sockets
+  std::unordered_map<std::string, std::vector<SocketType>> _waiting_sockets;
+  // key -> the adds received in this round
+  std::unordered_map<std::string, std::vector<std::pair<SocketType, int64_t>>>
+      _pending_adds;
+  // key -> the sockets that get it in this round
+  std::unordered_map<std::string, std::vector<SocketType>> _pending_gets;
+  std::vector<SocketType> _closing_sockets;
+  std::thread _background_thread{};
+  std::array<int, 2> _control_fd{{-1, -1}};
+};
+#endif
+
 class TCPClient {
  public:
   explicit TCPClient(SocketType socket) : _socket{socket} {}
@@ -99,6 +160,7 @@ class TCPClient {
                                             uint16_t port);
   ~TCPClient() { tcputils::close_socket(_socket); }
   void send_command_for_key(Command type, const std::string& key);
+  void send_string(const std::string& value);
 
   template <typename T>
   void send_value(const T& value);
@@ -125,7 +187,9 @@ class TCPStore : public Store {
                     uint16_t port = kDefaultPort,
                     bool is_master = false,
                     size_t num_workers = 1,
-                    int timeout = 900);
+                    int timeout = 900,
+                    uint16_t relay_port = 0,
+                    bool is_relay = false);
 
   ~TCPStore();
 
@@ -134,10 +198,19 @@ class TCPStore : public Store {
   bool check(const std::string& key) override;
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_set(const std::vector<std::string>& keys,
+                 const std::vector<std::vector<uint8_t>>& values) override;
 
  private:
   void waitWorkers();
   std::unique_ptr<detail::TCPServer> _server;
+#ifndef _WIN32
+  // started by one rank of each node if relay_port is not 0, the ranks of
+  // the node connect to it instead of the master
+  std::unique_ptr<detail::RelayDaemon> _relay;
+#endif
   std::unique_ptr<detail::TCPClient> _client;
 
   const std::string _init_key = "init/";
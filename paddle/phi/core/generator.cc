@@ -24,6 +24,13 @@ limitations under the License. */
 #include "paddle/phi/backends/xpu/xpu_info.h"
 #include "paddle/phi/core/enforce.h"
 
+static uint64_t SplitMix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
 static uint64_t GetRandomSeed() {
   std::random_device rd;
   // double has 53 bit significant, so limit uint64 to 53 bits
@@ -177,6 +184,43 @@ std::shared_ptr<std::mt19937_64> GetCPURandomEngine(uint64_t seed) {
   }
 }
 
+namespace {
+thread_local CounterBasedRNGGuard* current_counter_based_rng_guard = nullptr;
+}  // namespace
+
+CounterBasedRNGGuard::CounterBasedRNGGuard(uint64_t position, uint64_t step)
+    : position_(position),
+      step_(step),
+      prev_(current_counter_based_rng_guard) {
+  current_counter_based_rng_guard = this;
+}
+
+CounterBasedRNGGuard::~CounterBasedRNGGuard() {
+  current_counter_based_rng_guard = prev_;
+}
+
+CounterBasedRNGGuard* CounterBasedRNGGuard::Current() {
+  return current_counter_based_rng_guard;
+}
+
+std::pair<uint64_t, uint64_t> CounterBasedRNGGuard::NextSeedOffset(
+    const Generator& generator) {
+  return generator.CounterBasedSeedOffset(position_, step_, index_++);
+}
+
+inline void Generator::update_counter_based_seed() {
+  counter_based_seed_.store(state().seed, std::memory_order_relaxed);
+}
+
+std::pair<uint64_t, uint64_t> Generator::CounterBasedSeedOffset(
+    uint64_t position, uint64_t step, uint64_t index) const {
+  uint64_t key = counter_based_seed_.load(std::memory_order_relaxed);
+  key = SplitMix64(key ^ position);
+  key = SplitMix64(key ^ step);
+  key = SplitMix64(key ^ index);
+  return std::make_pair(key, static_cast<uint64_t>(0));
+}
+
 inline void Generator::print_state_info() {
   VLOG(4) << "Generator Random state "
           << "device id: " << state().device << ", seed: " << state().seed
@@ -187,12 +231,14 @@ Generator::Generator() {
   auto seed = GetRandomSeed();
   current_index = states_.size();
   states_.emplace_back(-1, seed);
+  update_counter_based_seed();
   print_state_info();
 }
 
 Generator::Generator(uint64_t seed) {
   current_index = states_.size();
   states_.emplace_back(-1, seed);
+  update_counter_based_seed();
   print_state_info();
 }
 
@@ -200,6 +246,7 @@ Generator::Generator(uint64_t seed, int64_t device_id) {
   current_index = states_.size();
   // device id first, then seed
   states_.emplace_back(device_id, seed);
+  update_counter_based_seed();
   print_state_info();
 }
 
@@ -211,6 +258,7 @@ void Generator::SetState(const phi::Generator::GeneratorState& state) {
     states_[current_index] = state;
   else
     PADDLE_THROW(common::errors::NotFound("Generator index is not found"));
+  update_counter_based_seed();
   print_state_info();
 }
 
@@ -222,6 +270,7 @@ void Generator::SetStateIndex(uint64_t StateIndex) {
     current_index = StateIndex;
   else
     PADDLE_THROW(common::errors::NotFound("Generator index is not found"));
+  update_counter_based_seed();
 }
 
 uint64_t Generator::RegisterStateIndex(const GeneratorState& state) {
@@ -229,6 +278,7 @@ uint64_t Generator::RegisterStateIndex(const GeneratorState& state) {
   auto new_index = states_.size();
   states_.push_back(state);
   current_index = new_index;
+  update_counter_based_seed();
   return new_index;
 }
 
@@ -252,12 +302,14 @@ uint64_t Generator::Seed() {
   std::lock_guard<std::mutex> lock(mu_);
   uint64_t seed = GetRandomSeed();
   state().reset(seed);
+  update_counter_based_seed();
   return seed;
 }
 
 void Generator::SetCurrentSeed(uint64_t seed) {
   std::lock_guard<std::mutex> lock(mu_);
   state().reset(seed);
+  update_counter_based_seed();
 }
 
 std::shared_ptr<std::mt19937_64> Generator::GetCPUEngine() {
@@ -273,6 +325,9 @@ uint64_t Generator::Random64() {
 std::pair<uint64_t, uint64_t> Generator::IncrementOffset(uint64_t increment) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
     defined(PADDLE_WITH_CUSTOM_DEVICE) || defined(PADDLE_WITH_XPU)
+  if (auto* guard = CounterBasedRNGGuard::Current()) {
+    return guard->NextSeedOffset(*this);
+  }
   std::lock_guard<std::mutex> lock(mu_);
   uint64_t offset = state().offset;
   state().offset = offset + increment;
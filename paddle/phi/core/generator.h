@@ -122,9 +122,19 @@ class Generator {
   uint64_t Random64();
 
   // Increments the offset of the current generator state by a specified amount
-  // and returns the new seed and offset.
+  // and returns the new seed and offset. Within a CounterBasedRNGGuard, it
+  // returns CounterBasedSeedOffset of the guard instead.
   std::pair<uint64_t, uint64_t> IncrementOffset(uint64_t increment_offset);
 
+  // Returns the (seed, offset) of the index-th random draw of the op at
+  // position of a program in its step-th run, i.e. a Philox key of its own
+  // derived from the current seed, with the offset 0. Unlike
+  // IncrementOffset, it takes no lock and does not depend on the order the
+  // ops run in.
+  std::pair<uint64_t, uint64_t> CounterBasedSeedOffset(uint64_t position,
+                                                       uint64_t step,
+                                                       uint64_t index) const;
+
  private:
   // Accesses the current generator state by index.
   inline GeneratorState& state();
@@ -133,9 +143,39 @@ class Generator {
   // Outputs detailed information about the current generator state to the log.
   inline void print_state_info();
 
+  // Publishes the seed of the current state to CounterBasedSeedOffset, with
+  // mu_ held.
+  inline void update_counter_based_seed();
+
   size_t current_index = 0;
   std::vector<GeneratorState> states_;
   mutable std::mutex mu_;
+  std::atomic<uint64_t> counter_based_seed_{0};
+};
+
+// Switches the random ops run on this thread to the counter based (seed,
+// offset) of the op at position of a program in its step-th run, set by the
+// executor around each op. Nested guards override the outer ones.
+class CounterBasedRNGGuard {
+ public:
+  CounterBasedRNGGuard(uint64_t position, uint64_t step);
+  ~CounterBasedRNGGuard();
+
+  CounterBasedRNGGuard(const CounterBasedRNGGuard&) = delete;
+  CounterBasedRNGGuard& operator=(const CounterBasedRNGGuard&) = delete;
+
+  // The innermost guard of this thread, nullptr if none.
+  static CounterBasedRNGGuard* Current();
+
+  // The (seed, offset) of the next random draw of the op from generator.
+  std::pair<uint64_t, uint64_t> NextSeedOffset(const Generator& generator);
+
+ private:
+  uint64_t position_;
+  uint64_t step_;
+  // the random draws of the op so far
+  uint64_t index_ = 0;
+  CounterBasedRNGGuard* prev_;
 };
 
 // The DefaultCPUGenerator is used in manual_seed()
@@ -368,6 +368,40 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
   return {kernel_iter->second, false, false};
 }
 
+KernelResult KernelFactory::SelectKernelOrThrowError(
+    const std::string& kernel_name,
+    const KernelKey& kernel_key,
+    bool use_strided_kernel,
+    KernelSelectionCache* cache) const {
+  // the tag covers everything besides the kernel name that the selection
+  // depends on: the key, the flags read by it and the registry generation
+  uint64_t tag =
+      static_cast<uint64_t>(generation_.load(std::memory_order_relaxed))
+          << 32 |
+      static_cast<uint64_t>(static_cast<uint8_t>(kernel_key.backend())) |
+      static_cast<uint64_t>(static_cast<uint8_t>(kernel_key.layout())) << 8 |
+      static_cast<uint64_t>(static_cast<uint8_t>(kernel_key.dtype())) << 16 |
+      static_cast<uint64_t>(use_strided_kernel) << 24 |
+      static_cast<uint64_t>(FLAGS_use_stride_kernel) << 25 |
+      static_cast<uint64_t>(FLAGS_enable_api_kernel_fallback) << 26;
+#if defined(PADDLE_WITH_XPU_KP)
+  tag |= static_cast<uint64_t>(FLAGS_run_kp_kernel) << 27;
+#endif
+  for (auto& entry : cache->entries) {
+    if (entry.tag == tag) {
+      return {*entry.kernel, entry.has_fallback_cpu, entry.is_stride_kernel};
+    }
+  }
+  auto result =
+      SelectKernelOrThrowError(kernel_name, kernel_key, use_strided_kernel);
+  auto& entry = cache->entries[cache->next++ % KernelSelectionCache::kSize];
+  entry.tag = tag;
+  entry.kernel = &result.kernel;
+  entry.has_fallback_cpu = result.has_fallback_cpu;
+  entry.is_stride_kernel = result.is_stride_kernel;
+  return result;
+}
+
 const KernelArgsDef& KernelFactory::GetFirstKernelArgsDef(
     const std::string& kernel_name) const {
   auto iter = kernels_.find(kernel_name);
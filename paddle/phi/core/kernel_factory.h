@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <ostream>
 #include <unordered_map>
@@ -307,6 +308,27 @@ struct KernelResult {
   bool is_stride_kernel = false;
 };
 
+/**
+ * Note: Kernels selected at one call site, which always passes the same
+ *       kernel name. It has to be zero initialized (static or thread_local
+ *       storage) and must not be shared between threads. Entries are tagged
+ *       with the kernel registry generation and dropped when kernels are
+ *       registered or removed.
+ */
+struct KernelSelectionCache {
+  static constexpr int kSize = 4;
+
+  struct Entry {
+    uint64_t tag;
+    const Kernel* kernel;
+    bool has_fallback_cpu;
+    bool is_stride_kernel;
+  };
+
+  Entry entries[kSize];
+  uint32_t next;
+};
+
 /**
  * Note: Each Computation need a basic kernel map that named by kernel_name.
  *       Such as for scale op, KernelMap contains a `scale` kernel map,
@@ -317,7 +339,11 @@ class KernelFactory {
  public:
   static KernelFactory& Instance();
 
-  KernelNameMap& kernels() { return kernels_; }
+  // callers may modify the map, so cached selections are invalidated
+  KernelNameMap& kernels() {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    return kernels_;
+  }
 
   bool HasCompatiblePhiKernel(const std::string& op_type) const;
 
@@ -327,6 +353,12 @@ class KernelFactory {
                                         const KernelKey& kernel_key,
                                         bool use_strided_kernel = false) const;
 
+  // Same as above, the selections are memoized in `cache` of the call site.
+  KernelResult SelectKernelOrThrowError(const std::string& kernel_name,
+                                        const KernelKey& kernel_key,
+                                        bool use_strided_kernel,
+                                        KernelSelectionCache* cache) const;
+
   bool HasKernel(const std::string& kernel_name,
                  const KernelKey& kernel_key) const;
 
@@ -353,6 +385,10 @@ class KernelFactory {
 
   KernelNameMap kernels_;
 
+  // bumped on every mutable access to kernels_, starts from 1 so that a zero
+  // initialized KernelSelectionCache entry never matches
+  std::atomic<uint32_t> generation_{1};
+
   // Get the low precision kernel list of current module.
   std::map<const std::string, OpCount> low_precision_kernels_;
 };
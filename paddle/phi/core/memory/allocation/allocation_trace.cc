@@ -0,0 +1,108 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/allocation_trace.h"
+
+#include <cinttypes>
+#include <fstream>
+#include <sstream>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_string(alloc_trace_file);
+
+namespace paddle::memory::allocation {
+
+AllocationTracer* AllocationTracer::Instance() {
+  static AllocationTracer* tracer =
+      FLAGS_alloc_trace_file.empty()
+          ? nullptr
+          : new AllocationTracer(FLAGS_alloc_trace_file);
+  return tracer;
+}
+
+AllocationTracer::AllocationTracer(const std::string& path)
+    : file_(std::fopen(path.c_str(), "w")),
+      start_(std::chrono::steady_clock::now()) {
+  PADDLE_ENFORCE_NOT_NULL(
+      file_,
+      common::errors::Unavailable(
+          "Cannot open the allocation trace file %s.", path));
+  std::fprintf(file_, "# a|f time_ns place_type device_id stream ptr size\n");
+}
+
+void AllocationTracer::Record(bool is_alloc,
+                              const phi::Allocation& allocation,
+                              uint64_t stream) {
+  const phi::Place& place = allocation.place();
+  std::lock_guard<std::mutex> guard(mtx_);
+  // taken in the lock so the times of the file are ascending
+  const uint64_t time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - start_)
+                               .count();
+  std::fprintf(file_,
+               "%c %" PRIu64 " %d %d %" PRIu64 " %" PRIu64 " %zu\n",
+               is_alloc ? 'a' : 'f',
+               time_ns,
+               static_cast<int>(place.GetType()),
+               place.GetDeviceId(),
+               stream,
+               static_cast<uint64_t>(
+                   reinterpret_cast<uintptr_t>(allocation.ptr())),
+               allocation.size());
+}
+
+void AllocationTracer::Flush() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  std::fflush(file_);
+}
+
+std::vector<AllocationTraceEvent> AllocationTracer::Load(
+    const std::string& path) {
+  std::ifstream file(path);
+  PADDLE_ENFORCE_EQ(file.is_open(),
+                    true,
+                    common::errors::NotFound(
+                        "Cannot open the allocation trace file %s.", path));
+  std::vector<AllocationTraceEvent> events;
+  std::string line;
+  size_t line_no = 0;
+  while (std::getline(file, line)) {
+    ++line_no;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream is(line);
+    char kind = 0;
+    int place_type = 0;
+    AllocationTraceEvent event;
+    is >> kind >> event.time_ns >> place_type >> event.device_id >>
+        event.stream >> event.ptr >> event.size;
+    PADDLE_ENFORCE_EQ(
+        !is.fail() && (kind == 'a' || kind == 'f'),
+        true,
+        common::errors::InvalidArgument(
+            "Line %d of the allocation trace %s is malformed: %s",
+            line_no,
+            path,
+            line));
+    event.is_alloc = kind == 'a';
+    event.place_type = static_cast<phi::AllocationType>(place_type);
+    events.push_back(event);
+  }
+  return events;
+}
+
+}  // namespace paddle::memory::allocation
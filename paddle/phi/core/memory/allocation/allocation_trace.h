@@ -0,0 +1,75 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/allocator.h"
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// An allocation or a free of a trace, i.e. a line of the trace file:
+//   <a|f> <time_ns> <place_type> <device_id> <stream> <ptr> <size>
+struct AllocationTraceEvent {
+  bool is_alloc;
+  uint64_t time_ns;  // since the trace started
+  phi::AllocationType place_type;
+  int device_id;
+  uint64_t stream;
+  uint64_t ptr;
+  size_t size;
+};
+
+/**
+ * AllocationTracer appends the allocations and frees made through the
+ * allocator facade to FLAGS_alloc_trace_file, which is replayed offline
+ * against the allocator strategies by paddle/phi/tools/allocator_replay.
+ **/
+class AllocationTracer {
+ public:
+  // nullptr if FLAGS_alloc_trace_file is empty
+  TEST_API static AllocationTracer* Instance();
+
+  TEST_API void Record(bool is_alloc,
+                       const phi::Allocation& allocation,
+                       uint64_t stream);
+
+  // Write the buffered events to the file.
+  TEST_API void Flush();
+
+  TEST_API static std::vector<AllocationTraceEvent> Load(
+      const std::string& path);
+
+ private:
+  explicit AllocationTracer(const std::string& path);
+
+  std::mutex mtx_;
+  // never closed, the buffered events are flushed by exit
+  FILE* file_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
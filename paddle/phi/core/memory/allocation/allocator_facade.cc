@@ -27,6 +27,7 @@
 #include "paddle/phi/core/memory/allocation/cpu_allocator.h"
 #include "paddle/phi/core/memory/allocation/naive_best_fit_allocator.h"
 #include "paddle/phi/core/memory/allocation/retry_allocator.h"
+#include "paddle/phi/core/memory/allocation/size_class_caching_allocator.h"
 #include "paddle/phi/core/memory/allocation/stat_allocator.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -92,6 +93,13 @@ PHI_DEFINE_EXPORTED_bool(use_virtual_memory_auto_growth,
                          false,
                          "Use VirtualMemoryAutoGrowthBestFitAllocator.");
 
+PHI_DEFINE_EXPORTED_double(
+    virtual_memory_defrag_threshold,
+    0.0,
+    "The fragmentation of VirtualMemoryAutoGrowthBestFitAllocator, i.e. 1 - "
+    "largest free block / total free memory, above which the predictor "
+    "defragments the memory after each run. 0 disables defragmentation.");
+
 // NOTE(Ruibiao): This FLAGS is just to be compatible with
 // the old single-stream CUDA allocator. It will be removed
 // after StreamSafeCudaAllocator has been fully tested.
@@ -114,6 +122,8 @@ PHI_DEFINE_EXPORTED_bool(
 COMMON_DECLARE_string(allocator_strategy);
 COMMON_DECLARE_uint64(auto_growth_chunk_size_in_mb);
 COMMON_DECLARE_bool(use_auto_growth_pinned_allocator);
+COMMON_DECLARE_bool(use_size_class_pinned_allocator);
+COMMON_DECLARE_uint64(size_class_pinned_allocator_cache_limit_mb);
 COMMON_DECLARE_bool(use_cuda_malloc_async_allocator);
 COMMON_DECLARE_bool(auto_free_cudagraph_allocations_on_launch);
 
@@ -472,6 +482,42 @@ class AllocatorFacadePrivate {
     }
   }
 
+  uint64_t Defragment(const phi::GPUPlace& place, double min_fragmentation) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 10020
+    std::shared_lock<std::shared_timed_mutex> lock_guard(cuda_allocator_mutex_);
+    auto iter = virtual_memory_allocators_.find(place);
+    if (iter == virtual_memory_allocators_.end()) {
+      return 0;
+    }
+    std::vector<VirtualMemoryAutoGrowthBestFitAllocator*> fragmented;
+    for (auto& allocator : iter->second) {
+      FragmentationStat stat = allocator->GetFragmentationStat();
+      VLOG(4) << "Virtual memory allocator on " << place << ": reserved "
+              << stat.reserved_size << ", free " << stat.free_size
+              << " in " << stat.free_block_num << " blocks, largest "
+              << stat.largest_free_size << ", fragmentation "
+              << stat.Fragmentation();
+      if (stat.free_block_num > 1 &&
+          stat.Fragmentation() > min_fragmentation) {
+        fragmented.push_back(allocator.get());
+      }
+    }
+    if (fragmented.empty()) {
+      return 0;
+    }
+    // kernels queued before a block was freed may still access it
+    platform::CUDADeviceGuard guard(place.device);
+    platform::GpuDeviceSync();
+    uint64_t remapped_size = 0;
+    for (auto* allocator : fragmented) {
+      remapped_size += allocator->Defragment();
+    }
+    return remapped_size;
+#else
+    return 0;
+#endif
+  }
+
   void SetDefaultStream(const phi::GPUPlace& place, gpuStream_t stream) {
     if (auto allocator = std::dynamic_pointer_cast<StreamSafeCUDAAllocator>(
             GetDefaultStreamSafeCUDAAllocator(place))) {
@@ -828,7 +874,17 @@ class AllocatorFacadePrivate {
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   void InitNaiveBestFitCUDAPinnedAllocator() {
-    if (FLAGS_use_auto_growth_pinned_allocator) {
+    if (FLAGS_use_size_class_pinned_allocator) {
+      auto cache_limit = FLAGS_size_class_pinned_allocator_cache_limit_mb
+                         << 20;
+      VLOG(4) << "FLAGS_size_class_pinned_allocator_cache_limit_mb is "
+              << FLAGS_size_class_pinned_allocator_cache_limit_mb;
+      allocators_[phi::GPUPinnedPlace()] =
+          std::make_shared<SizeClassCachingAllocator>(
+              std::make_shared<CPUPinnedAllocator>(),
+              phi::backends::cpu::CUDAPinnedMinChunkSize(),
+              cache_limit);
+    } else if (FLAGS_use_auto_growth_pinned_allocator) {
       auto chunk_size = FLAGS_auto_growth_chunk_size_in_mb << 20;
       VLOG(4) << "FLAGS_auto_growth_chunk_size_in_mb is "
               << FLAGS_auto_growth_chunk_size_in_mb;
@@ -962,9 +1018,11 @@ class AllocatorFacadePrivate {
 
     if (val > 0 && FLAGS_use_virtual_memory_auto_growth) {
       auto cuda_allocator = std::make_shared<CUDAVirtualMemAllocator>(p);
-      cuda_allocators_[p][stream] =
+      auto allocator =
           std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
               cuda_allocator, platform::GpuMinChunkSize(), p);
+      virtual_memory_allocators_[p].push_back(allocator);
+      cuda_allocators_[p][stream] = allocator;
     } else {
       auto cuda_allocator = CreateCUDAAllocator(p);
       if (FLAGS_use_auto_growth_v2) {
@@ -1078,9 +1136,11 @@ class AllocatorFacadePrivate {
 
     if (val > 0 && FLAGS_use_virtual_memory_auto_growth) {
       auto cuda_allocator = std::make_shared<CUDAVirtualMemAllocator>(p);
-      allocators_[p] =
+      auto allocator =
           std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
               cuda_allocator, platform::GpuMinChunkSize(), p);
+      virtual_memory_allocators_[p].push_back(allocator);
+      allocators_[p] = allocator;
     } else {
       auto cuda_allocator = CreateCUDAAllocator(p);
       if (FLAGS_use_auto_growth_v2) {
@@ -1225,7 +1285,8 @@ class AllocatorFacadePrivate {
 
   void WrapStatAllocator(phi::GPUPlace p, gpuStream_t stream) {
     std::shared_ptr<Allocator>& allocator = cuda_allocators_[p][stream];
-    allocator = std::make_shared<StatAllocator>(allocator);
+    allocator = std::make_shared<StatAllocator>(
+        allocator, reinterpret_cast<uint64_t>(stream));
   }
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -1347,7 +1408,8 @@ class AllocatorFacadePrivate {
 
   void WrapStatAllocator(phi::XPUPlace p, XPUStream stream) {
     std::shared_ptr<Allocator>& allocator = xpu_allocators_[p][stream];
-    allocator = std::make_shared<StatAllocator>(allocator);
+    allocator = std::make_shared<StatAllocator>(
+        allocator, reinterpret_cast<uint64_t>(stream));
   }
 
 #endif
@@ -1575,6 +1637,14 @@ class AllocatorFacadePrivate {
 #if defined(PADDLE_WITH_CUDA)
   std::map<phi::Place, std::shared_ptr<CUDAMallocAsyncAllocator>>
       default_cuda_malloc_async_allocators_;
+#if CUDA_VERSION >= 10020
+  // the innermost allocators of allocators_ and cuda_allocators_ when
+  // FLAGS_use_virtual_memory_auto_growth is on, for Defragment
+  std::map<phi::Place,
+           std::vector<
+               std::shared_ptr<VirtualMemoryAutoGrowthBestFitAllocator>>>
+      virtual_memory_allocators_;
+#endif
 #endif
 
 #ifdef PADDLE_WITH_XPU
@@ -1765,6 +1835,11 @@ bool AllocatorFacade::IsCUDAMallocAsyncAllocatorUsed() {
 }
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+uint64_t AllocatorFacade::Defragment(const phi::GPUPlace& place,
+                                     double min_fragmentation) {
+  return GetPrivate()->Defragment(place, min_fragmentation);
+}
+
 uint64_t AllocatorFacade::Release(const phi::GPUPlace& place,
                                   gpuStream_t stream) {
   AllocatorFacadePrivate* m = GetPrivate();
@@ -1882,6 +1957,16 @@ const std::shared_ptr<Allocator>& AllocatorFacade::GetAllocator(
   }
   return m->GetAllocator(place, /* A non-zero num to choose allocator_ */ 1);
 }
+
+void AllocatorFacade::RecordStream(std::shared_ptr<phi::Allocation> allocation,
+                                   XPUStream stream) {
+  GetPrivate()->RecordStream(allocation, stream);
+}
+
+XPUStream AllocatorFacade::GetStream(
+    const std::shared_ptr<phi::Allocation>& allocation) const {
+  return GetPrivate()->GetStream(allocation);
+}
 #endif
 
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
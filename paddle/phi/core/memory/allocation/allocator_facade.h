@@ -84,6 +84,12 @@ class AllocatorFacade {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // TODO(zhiqiu): change gpuStream_t to phi::Stream if needed.
   uint64_t Release(const phi::GPUPlace& place, gpuStream_t stream);
+  // Defragment the virtual memory allocators of `place` whose fragmentation
+  // exceeds `min_fragmentation`, see
+  // VirtualMemoryAutoGrowthBestFitAllocator::Defragment. Synchronizes the
+  // device, call it only between runs. Returns the remapped size.
+  uint64_t Defragment(const phi::GPUPlace& place,
+                      double min_fragmentation = 0.0);
   void RecordStream(std::shared_ptr<Allocation> allocation, gpuStream_t stream);
   void EraseStream(std::shared_ptr<Allocation> allocation, gpuStream_t stream);
 
@@ -94,6 +100,8 @@ class AllocatorFacade {
 #elif defined(PADDLE_WITH_XPU)
   TEST_API const std::shared_ptr<Allocator>& GetAllocator(
       const phi::Place& place, XPUStream stream);
+  void RecordStream(std::shared_ptr<Allocation> allocation, XPUStream stream);
+  XPUStream GetStream(const std::shared_ptr<Allocation>& allocation) const;
 #endif
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
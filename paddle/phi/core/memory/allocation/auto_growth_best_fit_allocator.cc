@@ -22,6 +22,7 @@
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/phi/backends/device_manager.h"
 #include "paddle/phi/core/memory/allocation/aligned_allocator.h"
+#include "paddle/phi/core/memory/stats.h"
 
 PHI_DEFINE_EXPORTED_READONLY_bool(
     free_idle_chunk,
@@ -42,8 +43,34 @@ PHI_DEFINE_EXPORTED_READONLY_bool(
 PHI_DEFINE_EXPORTED_READONLY_bool(print_allocator_trace_info,
                                   false,
                                   "print trace memory info");
+
+PHI_DEFINE_EXPORTED_uint64(
+    auto_growth_small_block_size,
+    0,
+    "Freed blocks no larger than this many bytes are cached in per size "
+    "free lists, and reused without searching the best-fit pool under the "
+    "global lock. 0 disables the cache. This flag only works when "
+    "FLAGS_allocator_strategy=auto_growth.");
+
 namespace paddle::memory::allocation {
 
+namespace {
+// Bounds the idle memory held by one size class.
+constexpr size_t kMaxCachedBlocksPerSizeClass = 256;
+
+void UpdateCacheStats(const phi::Place &place, int64_t cached, int64_t hit) {
+  if (phi::is_cpu_place(place) || phi::is_cuda_pinned_place(place)) {
+    if (cached != 0) HOST_MEMORY_STAT_UPDATE(Cached, 0, cached);
+    if (hit != 0) HOST_MEMORY_STAT_UPDATE(CacheHit, 0, hit);
+  } else {
+    if (cached != 0) {
+      DEVICE_MEMORY_STAT_UPDATE(Cached, place.GetDeviceId(), cached);
+    }
+    if (hit != 0) DEVICE_MEMORY_STAT_UPDATE(CacheHit, place.GetDeviceId(), hit);
+  }
+}
+}  // namespace
+
 AutoGrowthBestFitAllocator::AutoGrowthBestFitAllocator(
     std::shared_ptr<Allocator> underlying_allocator,
     size_t alignment,
@@ -59,7 +86,19 @@ AutoGrowthBestFitAllocator::AutoGrowthBestFitAllocator(
   total_alloc_size_ = 0;
   total_free_times_ = 0;
   total_free_size_ = 0;
-  VLOG(4) << "chunk_size_:" << chunk_size_;
+  if (FLAGS_auto_growth_small_block_size > 0) {
+    small_block_size_ =
+        AlignedSize(FLAGS_auto_growth_small_block_size, alignment_);
+    size_classes_ = std::vector<SizeClass>(small_block_size_ / alignment_);
+  }
+  VLOG(4) << "chunk_size_:" << chunk_size_
+          << ", small_block_size_:" << small_block_size_;
+}
+
+AutoGrowthBestFitAllocator::SizeClass *AutoGrowthBestFitAllocator::GetSizeClass(
+    size_t size) {
+  if (size == 0 || size > small_block_size_) return nullptr;
+  return &size_classes_[size / alignment_ - 1];
 }
 
 phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
@@ -73,6 +112,28 @@ phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
   VLOG(10) << "Allocate " << unaligned_size << " bytes, aligned to " << size
            << ", extra size " << extra_padding_size_;
 
+  auto *size_class = GetSizeClass(size);
+  if (size_class != nullptr) {
+    BlockIt cached_it;
+    bool hit = false;
+    {
+      std::lock_guard<SpinLock> guard(size_class->spinlock_);
+      if (!size_class->blocks_.empty()) {
+        cached_it = size_class->blocks_.back();
+        size_class->blocks_.pop_back();
+        hit = true;
+      }
+    }
+    if (hit) {
+      ++cache_hit_times_;
+      UpdateCacheStats(cached_it->chunk_->allocation_->place(),
+                       -static_cast<int64_t>(size),
+                       1);
+      return new BlockAllocation(cached_it);
+    }
+    ++cache_miss_times_;
+  }
+
   std::lock_guard<SpinLock> guard(spinlock_);
   auto iter = free_blocks_.lower_bound(std::make_pair(size, nullptr));
   BlockIt block_it;
@@ -138,8 +199,38 @@ void AutoGrowthBestFitAllocator::FreeImpl(phi::Allocation *allocation) {
                           9 /*level*/);
   VLOG(10) << "Free " << allocation->size()
            << " bytes, ptr = " << allocation->ptr();
-  std::lock_guard<SpinLock> guard(spinlock_);
   auto block_it = static_cast<BlockAllocation *>(allocation)->block_it_;
+  auto *size_class = FLAGS_free_idle_chunk ? nullptr
+                                           : GetSizeClass(block_it->size_);
+  if (size_class != nullptr) {
+    bool cached = false;
+    {
+      std::lock_guard<SpinLock> guard(size_class->spinlock_);
+      if (size_class->blocks_.size() < kMaxCachedBlocksPerSizeClass) {
+        size_class->blocks_.push_back(block_it);
+        cached = true;
+      }
+    }
+    if (cached) {
+      UpdateCacheStats(allocation->place(),
+                       static_cast<int64_t>(block_it->size_),
+                       0);
+      delete allocation;
+      return;
+    }
+  }
+
+  std::lock_guard<SpinLock> guard(spinlock_);
+  FreeBlock(block_it);
+
+  delete allocation;
+
+  if (FLAGS_free_idle_chunk) {
+    FreeIdleChunks();
+  }
+}
+
+void AutoGrowthBestFitAllocator::FreeBlock(BlockIt block_it) {
   auto &blocks = block_it->chunk_->blocks_;
 
   total_free_times_ += 1;
@@ -170,11 +261,21 @@ void AutoGrowthBestFitAllocator::FreeImpl(phi::Allocation *allocation) {
 
   free_blocks_.emplace(std::make_pair(block_it->size_, block_it->ptr_),
                        block_it);
+}
 
-  delete allocation;
-
-  if (FLAGS_free_idle_chunk) {
-    FreeIdleChunks();
+void AutoGrowthBestFitAllocator::FlushSizeClasses() {
+  for (auto &size_class : size_classes_) {
+    std::vector<BlockIt> blocks;
+    {
+      std::lock_guard<SpinLock> guard(size_class.spinlock_);
+      blocks.swap(size_class.blocks_);
+    }
+    for (auto block_it : blocks) {
+      UpdateCacheStats(block_it->chunk_->allocation_->place(),
+                       -static_cast<int64_t>(block_it->size_),
+                       0);
+      FreeBlock(block_it);
+    }
   }
 }
 
@@ -182,6 +283,8 @@ uint64_t AutoGrowthBestFitAllocator::FreeIdleChunks() {
   if (!allow_free_idle_chunk_) {
     return 0;
   }
+  // Cached small blocks keep their chunks busy.
+  FlushSizeClasses();
   uint64_t bytes = 0;
   for (auto chunk_it = chunks_.begin(); chunk_it != chunks_.end();) {
     auto &blocks = chunk_it->blocks_;
@@ -221,7 +324,9 @@ void AutoGrowthBestFitAllocator::Trace() const {
           << "m alloc_times:" << total_alloc_times_
           << " free_times:" << total_free_times_
           << " free_blocks_num:" << free_blocks_.size()
-          << " curr_chunks_num:" << chunks_.size();
+          << " curr_chunks_num:" << chunks_.size()
+          << " small_block_cache_hit:" << cache_hit_times_
+          << " small_block_cache_miss:" << cache_miss_times_;
 }
 
 }  // namespace paddle::memory::allocation
@@ -14,11 +14,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/memory/allocation/spin_lock.h"
@@ -87,6 +89,23 @@ class AutoGrowthBestFitAllocator : public Allocator {
 
   using BlockIt = List<Block>::iterator;
 
+  // Freed blocks of one aligned size. They stay busy in their chunk and are
+  // handed out again without the best-fit search or the global lock.
+  struct SizeClass {
+    SpinLock spinlock_;
+    std::vector<BlockIt> blocks_;
+  };
+
+  // Returns the size class of an aligned size, or nullptr if blocks of this
+  // size are not cached.
+  SizeClass *GetSizeClass(size_t size);
+  // Returns a block to the best-fit pool, merging it with free neighbours.
+  // spinlock_ must be held.
+  void FreeBlock(BlockIt block_it);
+  // Moves all cached small blocks back to the best-fit pool. spinlock_ must
+  // be held.
+  void FlushSizeClasses();
+
   std::shared_ptr<Allocator> underlying_allocator_;
   std::map<std::pair<size_t, void *>, BlockIt> free_blocks_;
   std::list<Chunk> chunks_;
@@ -101,6 +120,13 @@ class AutoGrowthBestFitAllocator : public Allocator {
   size_t total_free_times_;
   size_t total_free_size_;
 
+  // Blocks no larger than small_block_size_ are cached in size_classes_, see
+  // FLAGS_auto_growth_small_block_size. 0 disables the cache.
+  size_t small_block_size_{0};
+  std::vector<SizeClass> size_classes_;
+  std::atomic<size_t> cache_hit_times_{0};
+  std::atomic<size_t> cache_miss_times_{0};
+
   SpinLock spinlock_;
 };
 
@@ -41,7 +41,11 @@ AutoGrowthBestFitAllocatorV2::AutoGrowthBestFitAllocatorV2(
                                  chunk_size,
                                  true,
                                  extra_padding_size),
-      place_(place) {}
+      place_(place) {
+  // AllocateImpl below does not take blocks from the small block cache.
+  small_block_size_ = 0;
+  size_classes_.clear();
+}
 
 phi::Allocation *AutoGrowthBestFitAllocatorV2::AllocateImpl(
     size_t unaligned_size) {
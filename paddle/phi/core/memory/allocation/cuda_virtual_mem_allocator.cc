@@ -132,7 +132,31 @@ void CUDAVirtualMemAllocator::FreeImpl(phi::Allocation* allocation) {
     cudaSetDevice(prev_id);
   }
 
+  // coalesce the range with its free neighbours, and give it back to the
+  // tail when it ends at the offset
+  CUdeviceptr range_ptr = iter->first;
+  size_t range_size = iter->second.second;
   virtual_2_physical_map_.erase(iter);
+  auto next = free_virtual_ranges_.lower_bound(range_ptr);
+  if (next != free_virtual_ranges_.begin()) {
+    auto pre = std::prev(next);
+    if (pre->first + pre->second == range_ptr) {
+      range_ptr = pre->first;
+      range_size += pre->second;
+      free_virtual_ranges_.erase(pre);
+    }
+  }
+  if (next != free_virtual_ranges_.end() &&
+      range_ptr + range_size == next->first) {
+    range_size += next->second;
+    free_virtual_ranges_.erase(next);
+  }
+  if (range_ptr + range_size ==
+      virtual_mem_base_ + virtual_mem_alloced_offset_) {
+    virtual_mem_alloced_offset_ = range_ptr - virtual_mem_base_;
+  } else {
+    free_virtual_ranges_.emplace(range_ptr, range_size);
+  }
 
   delete allocation;
 }
@@ -141,8 +165,26 @@ phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
   size = AlignedSize(size, granularity_);
 
   CUdeviceptr ptr = virtual_mem_base_ + virtual_mem_alloced_offset_;
+  bool from_tail = true;
 
   if (ptr + size > virtual_mem_base_ + virtual_mem_size_) {
+    // best fit from the ranges unmapped before
+    auto best = free_virtual_ranges_.end();
+    for (auto it = free_virtual_ranges_.begin();
+         it != free_virtual_ranges_.end();
+         ++it) {
+      if (it->second >= size &&
+          (best == free_virtual_ranges_.end() || it->second < best->second)) {
+        best = it;
+      }
+    }
+    if (best != free_virtual_ranges_.end()) {
+      ptr = best->first;
+      from_tail = false;
+    }
+  }
+
+  if (from_tail && ptr + size > virtual_mem_base_ + virtual_mem_size_) {
     PADDLE_THROW_BAD_ALLOC(common::errors::ResourceExhausted(
         "\n\nOut of memory error on GPU Virtual Memory %d. "
         "Cannot allocate %s memory on GPU Virtual Memory %d, %s memory has "
@@ -217,7 +259,15 @@ phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
 
   virtual_2_physical_map_.emplace(ptr, std::make_pair(handle, size));
 
-  virtual_mem_alloced_offset_ += size;
+  if (from_tail) {
+    virtual_mem_alloced_offset_ += size;
+  } else {
+    auto range = free_virtual_ranges_.find(ptr);
+    if (range->second > size) {
+      free_virtual_ranges_.emplace(ptr + size, range->second - size);
+    }
+    free_virtual_ranges_.erase(range);
+  }
 
   return new Allocation(
       reinterpret_cast<void*>(ptr), size, phi::Place(place_));  // NOLINT
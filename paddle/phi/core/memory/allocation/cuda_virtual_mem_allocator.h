@@ -55,6 +55,10 @@ class CUDAVirtualMemAllocator : public Allocator {
 
   std::map<CUdeviceptr, std::pair<CUmemGenericAllocationHandle, size_t>>
       virtual_2_physical_map_;
+
+  // unmapped ranges below virtual_mem_alloced_offset_, reused once the
+  // address space behind the offset is exhausted
+  std::map<CUdeviceptr, size_t> free_virtual_ranges_;
 };
 
 }  // namespace allocation
@@ -28,6 +28,10 @@
 #include "paddle/common/flags.h"
 #include "paddle/phi/core/enforce.h"
 
+#ifdef PADDLE_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
 COMMON_DECLARE_bool(use_shm_cache);
 
 namespace paddle {
@@ -395,6 +399,33 @@ const MemoryMapInfo &MemoryMapAllocationPool::GetById(int id) {
   return memory_map_allocations_.at(id);
 }
 
+bool MemoryMapAllocationPool::RegisterHostMemory(int id) {
+#ifdef PADDLE_WITH_CUDA
+  std::lock_guard<std::mutex> guard(mtx_);
+  auto &memory_map = memory_map_allocations_.at(id);
+  if (!memory_map.host_register_tried_) {
+    memory_map.host_register_tried_ = true;
+    auto result = cudaHostRegister(memory_map.mmap_ptr_,
+                                   memory_map.data_size_ + mmap_alignment,
+                                   cudaHostRegisterDefault);
+    if (result == cudaSuccess) {
+      memory_map.host_registered_ = true;
+      VLOG(4) << "MemoryMapAllocationPool: page-lock "
+              << memory_map.file_name_;
+    } else {
+      // e.g. beyond the limit of the page-locked memory, then the copies of
+      // this shm are staged as before
+      cudaGetLastError();
+      VLOG(3) << "MemoryMapAllocationPool: failed to page-lock "
+              << memory_map.file_name_ << ": " << cudaGetErrorString(result);
+    }
+  }
+  return memory_map.host_registered_;
+#else
+  return false;
+#endif
+}
+
 void MemoryMapAllocationPool::SetMaxPoolSize(const int &size) {
   max_pool_size_ = size;
   VLOG(4) << this << "Set max pool size is: " << max_pool_size_;
@@ -407,6 +438,11 @@ void MemoryMapAllocationPool::Clear() {
     if (rlt == 0) {
       VLOG(4) << "MemoryMapAllocationPool: clear " << mmap.file_name_;
     }
+#ifdef PADDLE_WITH_CUDA
+    if (mmap.host_registered_) {
+      cudaHostUnregister(mmap.mmap_ptr_);
+    }
+#endif
     PADDLE_ENFORCE_NE(
         munmap(mmap.mmap_ptr_, mmap.data_size_ + mmap_alignment),
         -1,
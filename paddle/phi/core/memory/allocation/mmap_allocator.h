@@ -91,6 +91,9 @@ class RefcountedMemoryMapAllocation : public MemoryMapAllocation {
   void incref();
   int decref();
   void close() override;
+  // The id of the cached shm in MemoryMapAllocationPool, or -1 if it is not
+  // cached.
+  int buffer_id() const { return buffer_id_; }
   virtual ~RefcountedMemoryMapAllocation() { close(); }
 
  protected:
@@ -188,6 +191,10 @@ class MemoryMapInfo {
   size_t data_size_ = 0;
   std::string file_name_;
   void *mmap_ptr_ = nullptr;
+  // whether the mapping is page-locked by RegisterHostMemory, which is tried
+  // once
+  bool host_registered_ = false;
+  bool host_register_tried_ = false;
 };
 
 /* Note(zhangbo):
@@ -217,6 +224,12 @@ class MemoryMapAllocationPool {
 
   const MemoryMapInfo &GetById(int id);
 
+  // Page-lock the mapping of the id-th cached shm, so the device copies read
+  // it directly instead of staging it in pinned memory. The mapping is kept
+  // for the reuse of the shm, so it is page-locked once. Return whether it is
+  // page-locked, which needs a CUDA build.
+  bool RegisterHostMemory(int id);
+
   size_t BufferSize() { return memory_map_allocations_.size(); }
 
   void Clear();
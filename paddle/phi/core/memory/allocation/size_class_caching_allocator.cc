@@ -0,0 +1,264 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/size_class_caching_allocator.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+namespace {
+
+// blocks kept per size class in the cache of a thread
+constexpr size_t kThreadCacheBlocks = 4;
+
+bool IsPowerOfTwo(size_t size) { return size != 0 && (size & (size - 1)) == 0; }
+
+size_t Log2(size_t size) {
+  size_t log = 0;
+  while (size >>= 1) {
+    ++log;
+  }
+  return log;
+}
+
+}  // namespace
+
+struct SizeClassCachingAllocator::Pool {
+  Pool(std::shared_ptr<Allocator> underlying_allocator,
+       size_t min_size,
+       size_t cache_limit,
+       size_t max_thread_cached_size)
+      : underlying_allocator(std::move(underlying_allocator)),
+        min_size(min_size),
+        cache_limit(cache_limit),
+        thread_cached_class_num(
+            max_thread_cached_size < min_size
+                ? 0
+                : Log2(max_thread_cached_size / min_size) + 1),
+        free_blocks(Log2(SIZE_MAX / min_size) + 1) {}
+
+  size_t ClassIndex(size_t class_size) const {
+    return Log2(class_size / min_size);
+  }
+
+  bool IsSizeClass(size_t size) const {
+    return size % min_size == 0 && IsPowerOfTwo(size / min_size);
+  }
+
+  // Accounts `size` more cached bytes, returns false if that exceeds the
+  // limit.
+  bool Reserve(size_t size) {
+    if (cached_size.fetch_add(size) + size > cache_limit) {
+      cached_size.fetch_sub(size);
+      return false;
+    }
+    return true;
+  }
+
+  // declared first to outlive the blocks
+  std::shared_ptr<Allocator> underlying_allocator;
+  size_t min_size;
+  size_t cache_limit;
+  size_t thread_cached_class_num;
+  std::atomic<size_t> cached_size{0};
+
+  std::mutex mtx;
+  // by class index
+  std::vector<std::vector<AllocationPtr>> free_blocks;
+};
+
+namespace {
+
+using Pool = SizeClassCachingAllocator::Pool;
+
+// The blocks a thread keeps for one pool. They are handed back to the pool
+// when the thread exits, the pool lives as long as any of its caches.
+struct ThreadCache {
+  explicit ThreadCache(std::shared_ptr<Pool> pool)
+      : pool(std::move(pool)), blocks(this->pool->thread_cached_class_num) {}
+
+  ~ThreadCache() {
+    std::lock_guard<std::mutex> guard(pool->mtx);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+      for (auto& block : blocks[i]) {
+        pool->free_blocks[i].emplace_back(std::move(block));
+      }
+    }
+  }
+
+  std::shared_ptr<Pool> pool;
+  std::vector<std::vector<AllocationPtr>> blocks;
+};
+
+// Returns nullptr if the calling thread has no cache of `pool` and `create`
+// is false.
+ThreadCache* GetThreadCache(const std::shared_ptr<Pool>& pool,
+                            bool create = true) {
+  static thread_local std::unordered_map<const Pool*,
+                                         std::unique_ptr<ThreadCache>>
+      thread_caches;
+  auto iter = thread_caches.find(pool.get());
+  if (iter != thread_caches.end()) {
+    return iter->second.get();
+  }
+  if (!create) {
+    return nullptr;
+  }
+  auto& cache = thread_caches[pool.get()];
+  cache = std::make_unique<ThreadCache>(pool);
+  return cache.get();
+}
+
+}  // namespace
+
+SizeClassCachingAllocator::SizeClassCachingAllocator(
+    std::shared_ptr<Allocator> underlying_allocator,
+    size_t min_size,
+    size_t cache_limit,
+    size_t max_thread_cached_size) {
+  PADDLE_ENFORCE_NOT_NULL(
+      underlying_allocator,
+      common::errors::InvalidArgument(
+          "Underlying allocator of SizeClassCachingAllocator is NULL"));
+  PADDLE_ENFORCE_EQ(
+      IsPowerOfTwo(min_size),
+      true,
+      common::errors::InvalidArgument(
+          "The minimum size class of SizeClassCachingAllocator must be a "
+          "power of two, but got %d.",
+          min_size));
+  pool_ = std::make_shared<Pool>(std::move(underlying_allocator),
+                                 min_size,
+                                 cache_limit,
+                                 max_thread_cached_size);
+}
+
+SizeClassCachingAllocator::~SizeClassCachingAllocator() {
+  ReleaseImpl(phi::Place());
+}
+
+size_t SizeClassCachingAllocator::CachedSize() const {
+  return pool_->cached_size.load();
+}
+
+size_t SizeClassCachingAllocator::RoundUp(size_t size) const {
+  size_t class_size = pool_->min_size;
+  while (class_size < size) {
+    // too large to be cached, there is no point to waste the memory
+    if (class_size > pool_->cache_limit / 2) {
+      return AlignedSize(size, pool_->min_size);
+    }
+    class_size <<= 1;
+  }
+  return class_size;
+}
+
+phi::Allocation* SizeClassCachingAllocator::AllocateImpl(size_t size) {
+  size_t class_size = RoundUp(size);
+  if (class_size <= pool_->cache_limit && pool_->IsSizeClass(class_size)) {
+    size_t index = pool_->ClassIndex(class_size);
+    AllocationPtr block;
+    if (index < pool_->thread_cached_class_num) {
+      auto& blocks = GetThreadCache(pool_)->blocks[index];
+      if (!blocks.empty()) {
+        block = std::move(blocks.back());
+        blocks.pop_back();
+      }
+    }
+    if (!block) {
+      std::lock_guard<std::mutex> guard(pool_->mtx);
+      auto& blocks = pool_->free_blocks[index];
+      if (!blocks.empty()) {
+        block = std::move(blocks.back());
+        blocks.pop_back();
+      }
+    }
+    if (block) {
+      pool_->cached_size.fetch_sub(class_size);
+      return block.release();
+    }
+  }
+
+  try {
+    return pool_->underlying_allocator->Allocate(class_size).release();
+  } catch (BadAlloc&) {
+    VLOG(2) << "Release the cached blocks for a request of " << class_size
+            << " bytes";
+    ReleaseImpl(phi::Place());
+    return pool_->underlying_allocator->Allocate(class_size).release();
+  }
+}
+
+void SizeClassCachingAllocator::FreeImpl(phi::Allocation* allocation) {
+  AllocationPtr block(allocation, Allocator::AllocationDeleter);
+  size_t size = block->size();
+  if (!pool_->IsSizeClass(size) || !pool_->Reserve(size)) {
+    // returned to the underlying allocator
+    return;
+  }
+  size_t index = pool_->ClassIndex(size);
+  if (index < pool_->thread_cached_class_num) {
+    auto& blocks = GetThreadCache(pool_)->blocks[index];
+    if (blocks.size() < kThreadCacheBlocks) {
+      blocks.emplace_back(std::move(block));
+      return;
+    }
+  }
+  std::lock_guard<std::mutex> guard(pool_->mtx);
+  pool_->free_blocks[index].emplace_back(std::move(block));
+}
+
+uint64_t SizeClassCachingAllocator::ReleaseImpl(const phi::Place& place) {
+  std::vector<AllocationPtr> released;
+  if (auto* thread_cache = GetThreadCache(pool_, /*create=*/false)) {
+    for (auto& blocks : thread_cache->blocks) {
+      for (auto& block : blocks) {
+        released.emplace_back(std::move(block));
+      }
+      blocks.clear();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> guard(pool_->mtx);
+    for (auto& blocks : pool_->free_blocks) {
+      for (auto& block : blocks) {
+        released.emplace_back(std::move(block));
+      }
+      blocks.clear();
+    }
+  }
+
+  uint64_t released_size = 0;
+  for (auto& block : released) {
+    released_size += block->size();
+  }
+  pool_->cached_size.fetch_sub(released_size);
+  // the underlying allocator is called out of the lock
+  released.clear();
+  VLOG(10) << "Release " << released_size << " bytes of cached blocks";
+  return released_size;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
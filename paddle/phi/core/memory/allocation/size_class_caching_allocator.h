@@ -0,0 +1,70 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "paddle/phi/core/memory/allocation/allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// SizeClassCachingAllocator rounds every request up to a power of two size
+// class and keeps the freed blocks of each class for reuse instead of
+// returning them to the underlying allocator. It is meant for allocators
+// whose calls are expensive and serialize the device, like
+// CPUPinnedAllocator, whose cudaHostAlloc/cudaFreeHost stall the data
+// loading threads.
+//
+// Blocks of the classes up to `max_thread_cached_size` are first kept in a
+// small cache of the freeing thread, which is served without taking any lock.
+// The bytes kept in all the caches never exceed `cache_limit`, blocks freed
+// beyond that and requests larger than that go to the underlying allocator
+// directly.
+class SizeClassCachingAllocator : public Allocator {
+ public:
+  SizeClassCachingAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                            size_t min_size,
+                            size_t cache_limit,
+                            size_t max_thread_cached_size = 1 << 20);
+
+  ~SizeClassCachingAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // The bytes kept in the caches of all threads.
+  size_t CachedSize() const;
+
+  // Returns the size class of a request of `size` bytes.
+  size_t RoundUp(size_t size) const;
+
+  struct Pool;
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation *allocation) override;
+  // Frees the blocks kept in the shared pool and in the cache of the calling
+  // thread. The caches of other threads are bounded and kept.
+  uint64_t ReleaseImpl(const phi::Place &place) override;
+
+ private:
+  std::shared_ptr<Pool> pool_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
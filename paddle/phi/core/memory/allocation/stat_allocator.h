@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/fluid/platform/profiler/mem_tracing.h"
+#include "paddle/phi/core/memory/allocation/allocation_trace.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/memory/stats.h"
 
@@ -24,8 +25,12 @@ namespace allocation {
 
 class StatAllocator : public Allocator {
  public:
-  explicit StatAllocator(std::shared_ptr<Allocator> underlying_allocator)
-      : underlying_allocator_(std::move(underlying_allocator)) {}
+  // `stream` is recorded in the memory events, 0 if unknown.
+  explicit StatAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                         uint64_t stream = 0)
+      : underlying_allocator_(std::move(underlying_allocator)),
+        stream_(stream),
+        tracer_(AllocationTracer::Instance()) {}
 
   bool IsAllocThreadSafe() const override { return true; }
 
@@ -42,7 +47,11 @@ class StatAllocator : public Allocator {
     platform::RecordMemEvent(allocation->ptr(),
                              allocation->place(),
                              allocation->size(),
-                             platform::TracerMemEventType::Free);
+                             platform::TracerMemEventType::Free,
+                             stream_);
+    if (UNLIKELY(tracer_ != nullptr)) {
+      tracer_->Record(false, *allocation, stream_);
+    }
     underlying_allocator_->Free(allocation);
   }
 
@@ -61,7 +70,11 @@ class StatAllocator : public Allocator {
     platform::RecordMemEvent(allocation->ptr(),
                              allocation->place(),
                              allocation->size(),
-                             platform::TracerMemEventType::Allocate);
+                             platform::TracerMemEventType::Allocate,
+                             stream_);
+    if (UNLIKELY(tracer_ != nullptr)) {
+      tracer_->Record(true, *allocation, stream_);
+    }
     return allocation.release();
   }
 
@@ -71,6 +84,8 @@ class StatAllocator : public Allocator {
 
  private:
   std::shared_ptr<Allocator> underlying_allocator_;
+  uint64_t stream_;
+  AllocationTracer* tracer_;  // nullptr unless FLAGS_alloc_trace_file is set
 };
 
 }  // namespace allocation
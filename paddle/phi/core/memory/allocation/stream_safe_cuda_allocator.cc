@@ -15,6 +15,7 @@
 #include "paddle/phi/core/memory/allocation/stream_safe_cuda_allocator.h"
 #include <thread>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 
@@ -24,6 +25,8 @@
 #include "paddle/phi/backends/gpu/rocm/hip_graph.h"
 #endif
 
+COMMON_DECLARE_bool(stream_safe_cuda_allocator_ordered_reuse);
+
 namespace paddle {
 namespace memory {
 namespace allocation {
@@ -31,14 +34,18 @@ namespace allocation {
 StreamSafeCUDAAllocation::StreamSafeCUDAAllocation(
     DecoratedAllocationPtr underlying_allocation,
     gpuStream_t owning_stream,
-    StreamSafeCUDAAllocator* allocator)
+    StreamSafeCUDAAllocator* allocator,
+    StreamMemoryStat* allocated_stat)
     : Allocation(underlying_allocation->ptr(),
                  underlying_allocation->base_ptr(),
                  underlying_allocation->size(),
                  underlying_allocation->place()),
       underlying_allocation_(std::move(underlying_allocation)),
       owning_stream_(owning_stream),
-      allocator_(allocator->shared_from_this()) {}
+      allocated_stat_(allocated_stat),
+      allocator_(allocator->shared_from_this()) {
+  allocated_stat_->Update(static_cast<int64_t>(size()));
+}
 
 void StreamSafeCUDAAllocation::RecordStream(gpuStream_t stream) {
   VLOG(8) << "Try record stream " << stream << " for address " << ptr();
@@ -120,10 +127,43 @@ bool StreamSafeCUDAAllocation::CanBeFreed() {
   return true;
 }
 
+bool StreamSafeCUDAAllocation::WaitOutstandingEvents(gpuStream_t stream) {
+  std::lock_guard<SpinLock> lock_guard(outstanding_event_map_lock_);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (UNLIKELY(phi::backends::gpu::CUDAGraph::IsThisThreadCapturing())) {
+    return false;
+  }
+#endif
+  if (!graph_capturing_stream_set_.empty()) {
+    return false;
+  }
+
+  for (auto& item : outstanding_event_map_) {
+    gpuEvent_t& event = item.second;
+    // a destroyed event is released once the device completes it, the wait
+    // enqueued before is not affected
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream, event, 0));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(stream, event, 0));
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventDestroy(event));
+#endif
+    VLOG(8) << "Stream " << stream << " waits event " << event << " for "
+            << ptr();
+  }
+  outstanding_event_map_.clear();
+  return true;
+}
+
 gpuStream_t StreamSafeCUDAAllocation::GetOwningStream() const {
   return owning_stream_;
 }
 
+StreamMemoryStat* StreamSafeCUDAAllocation::GetAllocatedStat() const {
+  return allocated_stat_;
+}
+
 void StreamSafeCUDAAllocation::RecordGraphCapturingStreams() {
   for (gpuStream_t stream : graph_capturing_stream_set_) {
     RecordStreamWithNoGraphCapturing(stream);
@@ -168,6 +208,10 @@ StreamSafeCUDAAllocator::StreamSafeCUDAAllocator(
     : underlying_allocator_(std::move(underlying_allocator)),
       place_(place),
       default_stream_(default_stream),
+      allocated_stat_(
+          GetStreamMemoryStat("Allocated", place.device, default_stream)),
+      deferred_stat_(
+          GetStreamMemoryStat("Deferred", place.device, default_stream)),
       in_cuda_graph_capturing_(in_cuda_graph_capturing) {
   if (LIKELY(!in_cuda_graph_capturing)) {
     std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
@@ -192,6 +236,8 @@ gpuStream_t StreamSafeCUDAAllocator::GetDefaultStream() const {
 
 void StreamSafeCUDAAllocator::SetDefaultStream(gpuStream_t stream) {
   default_stream_ = stream;
+  allocated_stat_ = GetStreamMemoryStat("Allocated", place_.device, stream);
+  deferred_stat_ = GetStreamMemoryStat("Deferred", place_.device, stream);
 }
 
 phi::Allocation* StreamSafeCUDAAllocator::AllocateImpl(size_t size) {
@@ -199,6 +245,13 @@ phi::Allocation* StreamSafeCUDAAllocator::AllocateImpl(size_t size) {
                           platform::TracerEventType::UserDefined,
                           9 /*level*/);
   ProcessUnfreedAllocations();
+  if (FLAGS_stream_safe_cuda_allocator_ordered_reuse &&
+      LIKELY(!in_cuda_graph_capturing_)) {
+    StreamSafeCUDAAllocation* allocation = ReuseUnfreedAllocation(size);
+    if (allocation != nullptr) {
+      return allocation;
+    }
+  }
   VLOG(8) << "Try allocate " << size << " bytes";
   AllocationPtr underlying_allocation;
   try {
@@ -219,7 +272,8 @@ phi::Allocation* StreamSafeCUDAAllocator::AllocateImpl(size_t size) {
   StreamSafeCUDAAllocation* allocation = new StreamSafeCUDAAllocation(
       static_unique_ptr_cast<Allocation>(std::move(underlying_allocation)),
       default_stream_,
-      this);
+      this,
+      allocated_stat_);
   VLOG(8) << "Thread " << std::this_thread::get_id() << " Allocate "
           << allocation->size() << " bytes at address " << allocation->ptr()
           << "  , stream: " << default_stream_;
@@ -236,9 +290,12 @@ void StreamSafeCUDAAllocator::FreeImpl(phi::Allocation* allocation) {
   VLOG(8) << "Try free allocation " << stream_safe_cuda_allocation->ptr();
   if (stream_safe_cuda_allocation->CanBeFreed()) {
     VLOG(9) << "Directly delete allocation";
-    delete stream_safe_cuda_allocation;
+    DeleteAllocation(stream_safe_cuda_allocation, /*deferred=*/false);
   } else {
     VLOG(9) << "Put into unfreed_allocation list";
+    int64_t size = static_cast<int64_t>(stream_safe_cuda_allocation->size());
+    stream_safe_cuda_allocation->GetAllocatedStat()->Update(-size);
+    deferred_stat_->Update(size);
     std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
     unfreed_allocations_.emplace_back(stream_safe_cuda_allocation);
   }
@@ -271,7 +328,7 @@ void StreamSafeCUDAAllocator::ProcessUnfreedAllocations() {
   for (auto it = unfreed_allocations_.begin();
        it != unfreed_allocations_.end();) {
     if ((*it)->CanBeFreed()) {
-      delete *it;
+      DeleteAllocation(*it, /*deferred=*/true);
       it = unfreed_allocations_.erase(it);
     } else {
       ++it;
@@ -279,6 +336,53 @@ void StreamSafeCUDAAllocator::ProcessUnfreedAllocations() {
   }
 }
 
+StreamSafeCUDAAllocation* StreamSafeCUDAAllocator::ReuseUnfreedAllocation(
+    size_t size) {
+  std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
+  if (unfreed_allocations_.empty()) {
+    return nullptr;
+  }
+
+  // best fit, and not more than twice the size so that large blocks are not
+  // pinned by small requests
+  auto best = unfreed_allocations_.end();
+  for (auto it = unfreed_allocations_.begin();
+       it != unfreed_allocations_.end();
+       ++it) {
+    size_t block_size = (*it)->size();
+    if (block_size >= size && block_size / 2 <= size &&
+        (*it)->GetOwningStream() == default_stream_ &&
+        (best == unfreed_allocations_.end() || block_size < (*best)->size())) {
+      best = it;
+    }
+  }
+  if (best == unfreed_allocations_.end() ||
+      !(*best)->WaitOutstandingEvents(default_stream_)) {
+    return nullptr;
+  }
+
+  StreamSafeCUDAAllocation* allocation = *best;
+  unfreed_allocations_.erase(best);
+  int64_t block_size = static_cast<int64_t>(allocation->size());
+  deferred_stat_->Update(-block_size);
+  allocation->GetAllocatedStat()->Update(block_size);
+  VLOG(8) << "Reuse unfreed allocation " << allocation->ptr() << " of "
+          << block_size << " bytes for " << size << " bytes on stream "
+          << default_stream_;
+  return allocation;
+}
+
+void StreamSafeCUDAAllocator::DeleteAllocation(
+    StreamSafeCUDAAllocation* allocation, bool deferred) {
+  int64_t size = static_cast<int64_t>(allocation->size());
+  if (deferred) {
+    deferred_stat_->Update(-size);
+  } else {
+    allocation->GetAllocatedStat()->Update(-size);
+  }
+  delete allocation;
+}
+
 uint64_t StreamSafeCUDAAllocator::ProcessUnfreedAllocationsAndRelease() {
   ProcessUnfreedAllocations();
   return underlying_allocator_->Release(place_);
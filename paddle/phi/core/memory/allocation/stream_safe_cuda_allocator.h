@@ -21,6 +21,7 @@
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/memory/allocation/spin_lock.h"
+#include "paddle/phi/core/memory/stats.h"
 
 #ifdef PADDLE_WITH_CUDA
 #include <cuda_runtime.h>
@@ -38,12 +39,17 @@ class StreamSafeCUDAAllocation : public Allocation {
  public:
   StreamSafeCUDAAllocation(DecoratedAllocationPtr underlying_allocation,
                            gpuStream_t owning_stream,
-                           StreamSafeCUDAAllocator *allocator);
+                           StreamSafeCUDAAllocator *allocator,
+                           StreamMemoryStat *allocated_stat);
 
   void RecordStream(gpuStream_t stream);
   void EraseStream(gpuStream_t stream);
   bool CanBeFreed();
+  // Makes `stream` wait for the other streams using the allocation instead of
+  // querying their events, returns false when it can not be done.
+  bool WaitOutstandingEvents(gpuStream_t stream);
   gpuStream_t GetOwningStream() const;
+  StreamMemoryStat *GetAllocatedStat() const;
 
  private:
   thread_local static std::once_flag once_flag_;
@@ -53,6 +59,7 @@ class StreamSafeCUDAAllocation : public Allocation {
   std::set<gpuStream_t> graph_capturing_stream_set_;
   std::map<gpuStream_t, gpuEvent_t> outstanding_event_map_;
   gpuStream_t owning_stream_;
+  StreamMemoryStat *allocated_stat_;  // not owned
   SpinLock outstanding_event_map_lock_;
   // To compatible with CUDA Graph, hold the allocator shared_ptr so that
   // Allocator will not deconstruct before Allocation
@@ -81,6 +88,8 @@ class StreamSafeCUDAAllocator
  private:
   void ProcessUnfreedAllocations();
   uint64_t ProcessUnfreedAllocationsAndRelease();
+  StreamSafeCUDAAllocation *ReuseUnfreedAllocation(size_t size);
+  void DeleteAllocation(StreamSafeCUDAAllocation *allocation, bool deferred);
 
   static std::map<phi::Place, std::vector<StreamSafeCUDAAllocator *>>
       allocator_map_;
@@ -89,6 +98,10 @@ class StreamSafeCUDAAllocator
   std::shared_ptr<Allocator> underlying_allocator_;
   phi::GPUPlace place_;
   gpuStream_t default_stream_;
+  // per stream "Allocated" stats of default_stream_ and "Deferred" bytes in
+  // unfreed_allocations_
+  StreamMemoryStat *allocated_stat_;
+  StreamMemoryStat *deferred_stat_;
   std::list<StreamSafeCUDAAllocation *> unfreed_allocations_;
   SpinLock unfreed_allocation_lock_;
 
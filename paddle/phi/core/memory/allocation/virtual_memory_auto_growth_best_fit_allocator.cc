@@ -58,6 +58,94 @@ void VirtualMemoryAutoGrowthBestFitAllocator::FreeImpl(
   delete allocation;
 }
 
+FragmentationStat
+VirtualMemoryAutoGrowthBestFitAllocator::GetFragmentationStat() {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  FragmentationStat stat;
+  for (auto &allocation : allocations_) {
+    stat.reserved_size += allocation->size();
+  }
+  for (auto &item : free_blocks_) {
+    stat.free_size += item.first.first;
+  }
+  if (!free_blocks_.empty()) {
+    stat.largest_free_size = free_blocks_.rbegin()->first.first;
+  }
+  stat.free_block_num = free_blocks_.size();
+  return stat;
+}
+
+uint64_t VirtualMemoryAutoGrowthBestFitAllocator::Defragment() {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  if (all_blocks_.size() < 2) {
+    return 0;
+  }
+
+  std::map<void *, std::list<AllocationPtr>::iterator> chunks;
+  for (auto it = allocations_.begin(); it != allocations_.end(); ++it) {
+    chunks.emplace((*it)->ptr(), it);
+  }
+  auto chunk_end = [](const std::list<AllocationPtr>::iterator &it) {
+    return reinterpret_cast<uint8_t *>((*it)->ptr()) + (*it)->size();
+  };
+  auto insert_free_block = [this](std::list<Block>::iterator pos,
+                                  uint8_t *ptr,
+                                  size_t size) {
+    auto block_it = all_blocks_.insert(pos, Block(ptr, size, true));
+    free_blocks_.emplace(std::make_pair(size, block_it->ptr_), block_it);
+  };
+
+  // the last block is left alone, if it is free the remapped memory merges
+  // into it
+  size_t released_size = 0;
+  auto last_block = std::prev(all_blocks_.end());
+  for (auto block_it = all_blocks_.begin(); block_it != last_block;) {
+    auto *begin = reinterpret_cast<uint8_t *>(block_it->ptr_);
+    auto *end = begin + block_it->size_;
+    auto chunk_it = chunks.lower_bound(block_it->ptr_);
+    if (!block_it->is_free_ || chunk_it == chunks.end() ||
+        chunk_end(chunk_it->second) > end) {
+      ++block_it;
+      continue;
+    }
+
+    free_blocks_.erase(std::make_pair(block_it->size_, block_it->ptr_));
+    uint8_t *cur = begin;
+    while (chunk_it != chunks.end() && chunk_end(chunk_it->second) <= end) {
+      auto *chunk_ptr = reinterpret_cast<uint8_t *>(chunk_it->first);
+      if (chunk_ptr > cur) {
+        insert_free_block(block_it, cur, chunk_ptr - cur);
+      }
+      cur = chunk_end(chunk_it->second);
+      released_size += (*chunk_it->second)->size();
+      allocations_.erase(chunk_it->second);
+      chunk_it = chunks.erase(chunk_it);
+    }
+    if (cur < end) {
+      insert_free_block(block_it, cur, end - cur);
+    }
+    block_it = all_blocks_.erase(block_it);
+  }
+
+  if (released_size == 0) {
+    return 0;
+  }
+  try {
+    // AlignedAllocator adds alignment_ to every request, the chunk sizes are
+    // already aligned to the granularity of the underlying allocator
+    ExtendAndMerge(released_size - alignment_);
+  } catch (BadAlloc &ex) {
+    // the memory is back to the device and the allocator simply grows again
+    // on demand
+    LOG(WARNING) << "Unable to remap " << released_size
+                 << " bytes after defragmentation on " << place_ << ": "
+                 << ex.what();
+    return 0;
+  }
+  VLOG(1) << "Defragment " << released_size << " bytes on " << place_;
+  return released_size;
+}
+
 void VirtualMemoryAutoGrowthBestFitAllocator::TryMergeBlock2Blocks(
     std::list<Block>::iterator block) {
   if (block->ptr_ == all_blocks_.front().ptr_ &&
@@ -164,7 +252,7 @@ void VirtualMemoryAutoGrowthBestFitAllocator::ExtendAndMerge(size_t size) {
                                block_it);
         } else {
           // do not merge
-          all_blocks_.emplace_back(ptr, size, true);
+          all_blocks_.emplace_front(ptr, size, true);
           free_blocks_.emplace(std::make_pair(size, ptr), all_blocks_.begin());
         }
       } else {
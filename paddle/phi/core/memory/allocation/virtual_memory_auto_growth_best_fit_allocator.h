@@ -42,6 +42,22 @@ struct BlockAllocation : public Allocation {
   std::list<Block>::iterator block_it_;
 };
 
+struct FragmentationStat {
+  size_t reserved_size{0};
+  size_t free_size{0};
+  size_t largest_free_size{0};
+  size_t free_block_num{0};
+
+  // The share of free memory that the largest possible allocation can not
+  // use: 0 when all free memory is one block, close to 1 when it is scattered
+  // over many small blocks.
+  double Fragmentation() const {
+    return free_size == 0 ? 0.0
+                          : 1.0 - static_cast<double>(largest_free_size) /
+                                      static_cast<double>(free_size);
+  }
+};
+
 /**
  * Like AutoGrowthBestFitAllocator, VirtualMemoryAutoGrowthBestFitAllocator will
  * gradually apply to GPU for video memory as the model uses more video memory.
@@ -60,6 +76,15 @@ class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
 
   bool IsAllocThreadSafe() const override { return true; }
 
+  FragmentationStat GetFragmentationStat();
+
+  // Unmaps the chunks that lie entirely in free blocks between used blocks
+  // and maps their physical memory again at the end of the address space,
+  // where it joins the trailing free block. The used blocks do not move, so
+  // this only has to run at a safe point where no kernel touches freed memory
+  // any more. Returns the remapped size.
+  uint64_t Defragment();
+
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
 
@@ -61,6 +61,11 @@ uint64_t Release(const phi::GPUPlace& place, gpuStream_t stream) {
   return allocation::AllocatorFacade::Instance().Release(place, stream);
 }
 
+uint64_t Defragment(const phi::GPUPlace& place, double min_fragmentation) {
+  return allocation::AllocatorFacade::Instance().Defragment(place,
+                                                            min_fragmentation);
+}
+
 void RecordStream(std::shared_ptr<Allocation> allocation, gpuStream_t stream) {
   return allocation::AllocatorFacade::Instance().RecordStream(allocation,
                                                               stream);
@@ -77,6 +82,17 @@ gpuStream_t GetStream(const std::shared_ptr<Allocation>& allocation) {
 
 #endif
 
+#ifdef PADDLE_WITH_XPU
+void RecordStream(std::shared_ptr<Allocation> allocation, XPUStream stream) {
+  return allocation::AllocatorFacade::Instance().RecordStream(allocation,
+                                                              stream);
+}
+
+XPUStream GetStream(const std::shared_ptr<Allocation>& allocation) {
+  return allocation::AllocatorFacade::Instance().GetStream(allocation);
+}
+#endif
+
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
 void RecordStream(std::shared_ptr<Allocation> allocation,
                   phi::stream::stream_t stream) {
@@ -21,6 +21,9 @@ limitations under the License. */
 #include "paddle/phi/core/device_context.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/stream.h"
+#ifdef PADDLE_WITH_XPU
+#include "xpu/runtime.h"
+#endif
 
 namespace paddle {
 namespace memory {
@@ -52,12 +55,20 @@ extern void* GetBasePtr(const std::shared_ptr<Allocation>& allocation);
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 extern uint64_t Release(const phi::GPUPlace& place, gpuStream_t stream);
 
+extern uint64_t Defragment(const phi::GPUPlace& place,
+                           double min_fragmentation = 0.0);
+
 void RecordStream(std::shared_ptr<Allocation> allocation, gpuStream_t stream);
 
 void EraseStream(std::shared_ptr<Allocation> allocation, gpuStream_t stream);
 
 gpuStream_t GetStream(const std::shared_ptr<Allocation>& allocation);
 #endif
+#ifdef PADDLE_WITH_XPU
+void RecordStream(std::shared_ptr<Allocation> allocation, XPUStream stream);
+
+XPUStream GetStream(const std::shared_ptr<Allocation>& allocation);
+#endif
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
 void RecordStream(std::shared_ptr<Allocation> allocation,
                   phi::stream::stream_t stream);
@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/phi/core/memory/stats.h"
 
+#include <tuple>
+
 #include "paddle/common/flags.h"
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/memory/allocation/spin_lock.h"
@@ -108,6 +110,61 @@ void HostMemoryStatUpdate(const std::string& stat_type,
   StatRegistry::GetInstance()->Update("Host" + stat_type, dev_id, increment);
 }
 
+class StreamStatRegistry {
+ public:
+  static StreamStatRegistry* GetInstance() {
+    static StreamStatRegistry instance;
+    return &instance;
+  }
+
+  StreamMemoryStat* GetStat(const std::string& stat_type,
+                            int dev_id,
+                            const void* stream) {
+    std::lock_guard<SpinLock> lock_guard(stat_map_lock_);
+    auto& stat = stat_map_[std::make_tuple(stat_type, dev_id, stream)];
+    if (!stat) {
+      stat = std::make_unique<StreamMemoryStat>();
+    }
+    return stat.get();
+  }
+
+  std::map<const void*, ThreadLocalStatBase> GetValues(
+      const std::string& stat_type, int dev_id) {
+    std::map<const void*, ThreadLocalStatBase> values;
+    std::lock_guard<SpinLock> lock_guard(stat_map_lock_);
+    for (auto& item : stat_map_) {
+      if (std::get<0>(item.first) == stat_type &&
+          std::get<1>(item.first) == dev_id) {
+        ThreadLocalStatBase& value = values[std::get<2>(item.first)];
+        value.current = item.second->GetCurrentValue();
+        value.peak = item.second->GetPeakValue();
+      }
+    }
+    return values;
+  }
+
+ private:
+  StreamStatRegistry() = default;
+
+  DISABLE_COPY_AND_ASSIGN(StreamStatRegistry);
+
+  std::map<std::tuple<std::string, int, const void*>,
+           std::unique_ptr<StreamMemoryStat>>
+      stat_map_;
+  SpinLock stat_map_lock_;
+};
+
+StreamMemoryStat* GetStreamMemoryStat(const std::string& stat_type,
+                                      int dev_id,
+                                      const void* stream) {
+  return StreamStatRegistry::GetInstance()->GetStat(stat_type, dev_id, stream);
+}
+
+std::map<const void*, ThreadLocalStatBase> StreamMemoryStatValues(
+    const std::string& stat_type, int dev_id) {
+  return StreamStatRegistry::GetInstance()->GetValues(stat_type, dev_id);
+}
+
 void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
   if (FLAGS_log_memory_stats && phi::is_gpu_place(place)) {
     VLOG(0) << "After launching op_name: " << op_name << ", "
@@ -131,6 +188,12 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
                    "Reserved", place.device)) /
                    1024 / 1024
             << " MB";
+    for (auto& item : StreamMemoryStatValues("Allocated", place.device)) {
+      VLOG(0) << "stream " << item.first << " memory_allocated: "
+              << static_cast<double>(item.second.current) / 1024 / 1024
+              << " MB, max_memory_allocated: "
+              << static_cast<double>(item.second.peak) / 1024 / 1024 << " MB";
+    }
   }
 }
 
@@ -163,9 +226,13 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
 int RegisterAllStats() {
   DEVICE_MEMORY_STAT_REGISTER(Allocated);
   DEVICE_MEMORY_STAT_REGISTER(Reserved);
+  DEVICE_MEMORY_STAT_REGISTER(Cached);
+  DEVICE_MEMORY_STAT_REGISTER(CacheHit);
 
   HOST_MEMORY_STAT_REGISTER(Allocated);
   HOST_MEMORY_STAT_REGISTER(Reserved);
+  HOST_MEMORY_STAT_REGISTER(Cached);
+  HOST_MEMORY_STAT_REGISTER(CacheHit);
   return 0;
 }
 
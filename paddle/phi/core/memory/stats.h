@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 
 #include "glog/logging.h"
@@ -228,9 +229,51 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 // To add a new STAT type, declare here and register in stats.cc
 DEVICE_MEMORY_STAT_DECLARE(Allocated);
 DEVICE_MEMORY_STAT_DECLARE(Reserved);
+// Bytes idle in the small block caches of auto growth allocators, they can
+// not be merged into larger blocks, and the number of cache hits.
+DEVICE_MEMORY_STAT_DECLARE(Cached);
+DEVICE_MEMORY_STAT_DECLARE(CacheHit);
 
 HOST_MEMORY_STAT_DECLARE(Allocated);
 HOST_MEMORY_STAT_DECLARE(Reserved);
+HOST_MEMORY_STAT_DECLARE(Cached);
+HOST_MEMORY_STAT_DECLARE(CacheHit);
+
+// Bytes of one stream, kept by StreamSafeCUDAAllocator so that the device
+// peak can be attributed to streams. "Allocated" counts the live allocations
+// made on the stream and "Deferred" the freed ones whose release waits for
+// other streams. Updates are lock free.
+class StreamMemoryStat {
+ public:
+  int64_t GetCurrentValue() const {
+    return current_.load(std::memory_order_relaxed);
+  }
+
+  int64_t GetPeakValue() const { return peak_.load(std::memory_order_relaxed); }
+
+  void Update(int64_t increment) {
+    int64_t current =
+        current_.fetch_add(increment, std::memory_order_relaxed) + increment;
+    int64_t prev_value = peak_.load(std::memory_order_relaxed);
+    while (prev_value < current &&
+           !peak_.compare_exchange_weak(prev_value, current)) {
+    }
+  }
+
+ private:
+  std::atomic<int64_t> current_{0};
+  std::atomic<int64_t> peak_{0};
+};
+
+// The stat of `stream` on device `dev_id`, created on first use and kept for
+// the process.
+StreamMemoryStat* GetStreamMemoryStat(const std::string& stat_type,
+                                      int dev_id,
+                                      const void* stream);
+
+// stream -> {current, peak} of the streams of device `dev_id`.
+std::map<const void*, ThreadLocalStatBase> StreamMemoryStatValues(
+    const std::string& stat_type, int dev_id);
 
 }  // namespace memory
 }  // namespace paddle
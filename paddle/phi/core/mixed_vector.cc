@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <algorithm>
 #include <initializer_list>
+#include <list>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <utility>
@@ -89,4 +90,58 @@ INSTANTIATE_VECTOR_FOR_TYPE(size_t)
 INSTANTIATE_VECTOR_FOR_TYPE(int)
 INSTANTIATE_VECTOR_FOR_TYPE(int64_t)
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+namespace {
+
+struct CachedOffsets {
+  phi::Place place;
+  gpuStream_t stream;
+  std::vector<size_t> offsets;
+  phi::Allocator::AllocationPtr gpu;
+};
+
+// A batch has a few LoD levels, some ops also read their absolute offsets.
+constexpr size_t kCachedOffsetsCapacity = 16;
+
+}  // namespace
+
+const size_t *CachedCUDAOffsets(const std::vector<size_t> &offsets,
+                                const phi::GPUContext &ctx) {
+  // never destroyed, the allocators may be gone at exit
+  static auto *mtx = new std::mutex();
+  // the most recently used first
+  static auto *cache = new std::list<CachedOffsets>();
+
+  const auto &place = ctx.GetPlace();
+  std::lock_guard<std::mutex> guard(*mtx);
+  for (auto it = cache->begin(); it != cache->end(); ++it) {
+    if (it->stream == ctx.stream() && it->place == place &&
+        it->offsets == offsets) {
+      cache->splice(cache->begin(), *cache, it);
+      return reinterpret_cast<const size_t *>(cache->front().gpu->ptr());
+    }
+  }
+  if (cache->size() >= kCachedOffsetsCapacity) {
+    // the kernels reading it are queued before the next user of the memory
+    // on the same stream
+    cache->pop_back();
+  }
+  const size_t bytes = offsets.size() * sizeof(size_t);
+  auto gpu = memory_utils::Alloc(place, std::max(bytes, sizeof(size_t)));
+  cache->push_front(
+      CachedOffsets{place, ctx.stream(), offsets, std::move(gpu)});
+  auto &entry = cache->front();
+  if (bytes > 0) {
+    // the host copy lives in the cache, no need to wait for the device
+    memory_utils::Copy(place,
+                       entry.gpu->ptr(),
+                       phi::CPUPlace(),
+                       entry.offsets.data(),
+                       bytes,
+                       ctx.stream());
+  }
+  return reinterpret_cast<const size_t *>(entry.gpu->ptr());
+}
+#endif
+
 };  // namespace phi
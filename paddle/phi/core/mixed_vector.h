@@ -31,6 +31,8 @@ limitations under the License. */
 
 namespace phi {
 
+class GPUContext;
+
 template <class T>
 using Vector = std::vector<T>;
 
@@ -399,4 +401,13 @@ class MixVector {
   mutable std::unique_ptr<VectorData> m_;
 };
 
+// Returns `offsets` uploaded for the kernels on the stream of `ctx`, e.g. the
+// LoD a sequence kernel reads. Unlike MixVector, which copies and waits for
+// the device on every call, the last uploads are cached by their content, so
+// the LoD shared by the sequence ops of a batch is copied once and the host
+// never waits. The pointer stays valid for the kernels queued on the stream
+// before the next few uploads.
+const size_t *CachedCUDAOffsets(const std::vector<size_t> &offsets,
+                                const phi::GPUContext &ctx);
+
 };  // namespace phi
@@ -117,6 +117,31 @@ RecordOpInfoSupplement::RecordOpInfoSupplement(
       phi::PosixInNsec(), type, input_shapes, dtypes, attrs, op_id);
 }
 
+namespace {
+
+thread_local const std::string *g_mem_event_tensor_name = nullptr;
+
+std::string CurrentOpName() {
+  const char *name = phi::RecordEvent::CurrentName();
+  return name == nullptr ? std::string() : std::string(name);
+}
+
+std::string CurrentTensorName() {
+  return g_mem_event_tensor_name == nullptr ? std::string()
+                                            : *g_mem_event_tensor_name;
+}
+
+}  // namespace
+
+RecordMemEventTensorName::RecordMemEventTensorName(const std::string &name)
+    : parent_(g_mem_event_tensor_name) {
+  g_mem_event_tensor_name = &name;
+}
+
+RecordMemEventTensorName::~RecordMemEventTensorName() {
+  g_mem_event_tensor_name = parent_;
+}
+
 bool RecordMemEvent::IsEnabled() { return FLAGS_enable_record_memory; }
 
 std::map<const char *, std::map<uint64_t, std::vector<uint64_t>>>
@@ -128,7 +153,8 @@ std::map<const char *, std::map<uint64_t, bool>>
 RecordMemEvent::RecordMemEvent(const void *ptr,
                                const phi::Place &place,
                                size_t size,
-                               const TracerMemEventType type) {
+                               const TracerMemEventType type,
+                               uint64_t stream) {
   if (phi::ProfilerHelper::g_state == ProfilerState::kDisabled &&
       FLAGS_enable_host_event_recorder_hook == false) {
     return;
@@ -220,7 +246,8 @@ RecordMemEvent::RecordMemEvent(const void *ptr,
                                                          current_allocated,
                                                          current_reserved,
                                                          peak_allocated,
-                                                         peak_reserved);
+                                                         peak_reserved,
+                                                         stream);
   } else if (type == TracerMemEventType::ReservedAllocate) {
     uint64_t current_reserved = 0;
     uint64_t peak_reserved = 0;
@@ -302,7 +329,8 @@ RecordMemEvent::RecordMemEvent(const void *ptr,
                                                          current_allocated,
                                                          current_reserved,
                                                          peak_allocated,
-                                                         peak_reserved);
+                                                         peak_reserved,
+                                                         stream);
   } else if (type == TracerMemEventType::Free) {
     uint64_t current_allocated = 0;
     uint64_t peak_allocated = 0;
@@ -384,7 +412,8 @@ RecordMemEvent::RecordMemEvent(const void *ptr,
                                                         current_allocated,
                                                         current_reserved,
                                                         peak_allocated,
-                                                        peak_reserved);
+                                                        peak_reserved,
+                                                        stream);
   } else if (type == TracerMemEventType::ReservedFree) {
     uint64_t current_reserved = 0;
     uint64_t peak_reserved = 0;
@@ -466,7 +495,8 @@ RecordMemEvent::RecordMemEvent(const void *ptr,
                                                         current_allocated,
                                                         current_reserved,
                                                         peak_allocated,
-                                                        peak_reserved);
+                                                        peak_reserved,
+                                                        stream);
   }
 }
 
@@ -493,7 +523,8 @@ void MemEventRecorder::PushMemRecord(const void *ptr,
                                      uint64_t current_allocated,
                                      uint64_t current_reserved,
                                      uint64_t peak_allocated,
-                                     uint64_t peak_reserved) {
+                                     uint64_t peak_reserved,
+                                     uint64_t stream) {
   std::lock_guard<std::mutex> guard(mtx_);
   if (FLAGS_enable_host_event_recorder_hook) {  // new MemRecord
     HostEventRecorder<CommonMemEvent>::GetInstance().RecordEvent(
@@ -505,7 +536,10 @@ void MemEventRecorder::PushMemRecord(const void *ptr,
         current_allocated,
         current_reserved,
         peak_allocated,
-        peak_reserved);
+        peak_reserved,
+        stream,
+        CurrentOpName(),
+        CurrentTensorName());
     return;
   }
   if (type == TracerMemEventType::ReservedAllocate) {
@@ -542,7 +576,8 @@ void MemEventRecorder::PopMemRecord(const void *ptr,
                                     uint64_t current_allocated,
                                     uint64_t current_reserved,
                                     uint64_t peak_allocated,
-                                    uint64_t peak_reserved) {
+                                    uint64_t peak_reserved,
+                                    uint64_t stream) {
   std::lock_guard<std::mutex> guard(mtx_);
   if (FLAGS_enable_host_event_recorder_hook) {  // new MemRecord
     HostEventRecorder<CommonMemEvent>::GetInstance().RecordEvent(
@@ -554,7 +589,10 @@ void MemEventRecorder::PopMemRecord(const void *ptr,
         current_allocated,
         current_reserved,
         peak_allocated,
-        peak_reserved);
+        peak_reserved,
+        stream,
+        CurrentOpName(),
+        CurrentTensorName());
     return;
   }
   if (type == TracerMemEventType::ReservedFree) {
@@ -832,10 +870,12 @@ int64_t ListenerId() { return profiler_lister_id; }
 void NvprofEnableRecordEvent() {
   SynchronizeAllDevice();
   phi::ProfilerHelper::g_enable_nvprof_hook = true;
+  HostTraceLevel::GetInstance().SetNvprofHook(true);
 }
 
 void NvprofDisableRecordEvent() {
   phi::ProfilerHelper::g_enable_nvprof_hook = false;
+  HostTraceLevel::GetInstance().SetNvprofHook(false);
 }
 
 void EnableHostEventRecorder() { FLAGS_enable_host_event_recorder_hook = true; }
@@ -118,7 +118,8 @@ struct MemEventRecorder {
                      uint64_t current_allocated,
                      uint64_t current_reserved,
                      uint64_t peak_allocated,
-                     uint64_t peak_reserved);
+                     uint64_t peak_reserved,
+                     uint64_t stream = 0);
   void PopMemRecord(const void* ptr,
                     const Place& place,
                     size_t size,
@@ -126,7 +127,8 @@ struct MemEventRecorder {
                     uint64_t current_allocated,
                     uint64_t current_reserved,
                     uint64_t peak_allocated,
-                    uint64_t peak_reserved);
+                    uint64_t peak_reserved,
+                    uint64_t stream = 0);
   void Flush();
   static MemEventRecorder& Instance() { return recorder; }
 
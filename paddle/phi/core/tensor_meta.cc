@@ -20,6 +20,76 @@ COMMON_DECLARE_bool(use_stride_kernel);
 
 namespace phi {
 
+SharedLoD::SharedLoD(const LoD& lod) { *this = lod; }
+
+SharedLoD::SharedLoD(LoD&& lod) { *this = std::move(lod); }
+
+SharedLoD& SharedLoD::operator=(const LoD& lod) {
+  if (lod_ && lod_.use_count() == 1) {
+    // NOTE: lod may be the LoD of this meta
+    if (lod_.get() != &lod) {
+      *lod_ = lod;
+    }
+  } else if (lod.empty()) {
+    lod_.reset();
+  } else {
+    lod_ = std::make_shared<LoD>(lod);
+  }
+  return *this;
+}
+
+SharedLoD& SharedLoD::operator=(LoD&& lod) {
+  if (lod_ && lod_.use_count() == 1) {
+    if (lod_.get() != &lod) {
+      *lod_ = std::move(lod);
+    }
+  } else if (lod.empty()) {
+    lod_.reset();
+  } else {
+    lod_ = std::make_shared<LoD>(std::move(lod));
+  }
+  return *this;
+}
+
+SharedLoD& SharedLoD::operator=(const SharedLoD& other) {
+  if (lod_ == other.lod_) {
+    return *this;
+  }
+  // the LoD of this meta alone may be referred to, it is kept
+  if (lod_ && lod_.use_count() == 1) {
+    *lod_ = other.get();
+  } else {
+    lod_ = other.lod_;
+  }
+  return *this;
+}
+
+SharedLoD& SharedLoD::operator=(SharedLoD&& other) {
+  if (lod_ == other.lod_) {
+    return *this;
+  }
+  if (lod_ && lod_.use_count() == 1) {
+    *lod_ = other.get();
+  } else {
+    lod_ = std::move(other.lod_);
+  }
+  return *this;
+}
+
+LoD* SharedLoD::mutable_get() {
+  if (!lod_) {
+    lod_ = std::make_shared<LoD>();
+  } else if (lod_.use_count() > 1) {
+    lod_ = std::make_shared<LoD>(*lod_);
+  }
+  return lod_.get();
+}
+
+const LoD& SharedLoD::Empty() noexcept {
+  static const LoD empty;
+  return empty;
+}
+
 DDim DenseTensorMeta::calc_strides(const DDim& dims) {
   if (dims.size() == -1 || product(dims) <= 0) {
     return dims;
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "paddle/common/layout.h"
@@ -43,6 +44,55 @@ namespace phi {
  */
 using LoD = std::vector<std::vector<size_t>>;
 
+/// \brief The LoD of a DenseTensorMeta, shared by the metas copied from each
+/// other until one of them modifies it, i.e. copy on write, so copying the
+/// metas of the tensors with LoD, e.g. in every InferMeta and ShareDataWith,
+/// does not allocate. The empty LoD holds no storage.
+///
+/// A LoD owned by this meta alone is assigned in place rather than released,
+/// so the LoD& of get() and the LoD* of mutable_get() stay valid when the
+/// LoD is reset or assigned, e.g. by set_lod, set_meta or ShareDataWith, as
+/// they do for a plain LoD.
+///
+/// NOTE: A LoD* of mutable_get() is only valid until the meta is copied, as
+/// the copies share the LoD it points to. A LoD& of get() taken while the
+/// LoD is shared refers to the shared LoD, which is not modified through
+/// this meta any more.
+class TEST_API SharedLoD {
+ public:
+  SharedLoD() = default;
+  SharedLoD(const LoD& lod);  // NOLINT
+  SharedLoD(LoD&& lod);       // NOLINT
+  SharedLoD(const SharedLoD& other) = default;
+  SharedLoD(SharedLoD&& other) noexcept = default;
+
+  SharedLoD& operator=(const LoD& lod);
+  SharedLoD& operator=(LoD&& lod);
+  SharedLoD& operator=(const SharedLoD& other);
+  SharedLoD& operator=(SharedLoD&& other);
+
+  const LoD& get() const noexcept { return lod_ ? *lod_ : Empty(); }
+  operator const LoD&() const noexcept { return get(); }  // NOLINT
+
+  /// \brief The LoD owned by this meta alone, copied first if shared.
+  LoD* mutable_get();
+
+  size_t size() const noexcept { return get().size(); }
+  bool empty() const noexcept { return get().empty(); }
+  const std::vector<size_t>& operator[](size_t i) const { return get()[i]; }
+  LoD::const_iterator begin() const noexcept { return get().begin(); }
+  LoD::const_iterator end() const noexcept { return get().end(); }
+
+  bool operator==(const SharedLoD& other) const {
+    return lod_ == other.lod_ || get() == other.get();
+  }
+
+ private:
+  static const LoD& Empty() noexcept;
+
+  std::shared_ptr<LoD> lod_;
+};
+
 /// \brief The meta data of dense tensor. Take the structure type
 /// and use all default operations.
 ///
@@ -80,7 +130,7 @@ struct TEST_API DenseTensorMeta {
   DDim dims;
   DataType dtype{DataType::UNDEFINED};
   DataLayout layout{DataLayout::NCHW};
-  LoD lod;
+  SharedLoD lod;
   size_t offset{0};
   DDim strides;
 };
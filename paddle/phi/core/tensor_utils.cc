@@ -23,6 +23,13 @@ limitations under the License. */
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/kernel_registry.h"
+#ifdef PADDLE_WITH_XPU
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/xpu/xpu_context.h"
+#include "paddle/phi/backends/xpu/xpu_info.h"
+
+COMMON_DECLARE_bool(new_executor_xpu_multi_stream);
+#endif
 
 namespace phi {
 
@@ -220,10 +227,34 @@ void Copy(const Context& dev_ctx,
 #ifdef PADDLE_WITH_XPU
   } else if (src_place.GetType() == AllocationType::XPU &&  // NOLINT
              dst_place.GetType() == AllocationType::CPU) {
-    memory_utils::Copy(dst_place, dst_ptr, src_place, src_ptr, size);
+    // With multi-stream, wait for the stream of dev_ctx only rather than the
+    // default stream, so the copies on the D2H stream overlap the compute.
+    auto* xpu_ctx = FLAGS_new_executor_xpu_multi_stream
+                        ? dynamic_cast<const XPUContext*>(&dev_ctx)
+                        : nullptr;
+    if (xpu_ctx != nullptr) {
+      phi::backends::xpu::MemcpySyncD2H(dst_ptr,
+                                        src_ptr,
+                                        size,
+                                        XPUPlace(src_place.GetDeviceId()),
+                                        *xpu_ctx);
+    } else {
+      memory_utils::Copy(dst_place, dst_ptr, src_place, src_ptr, size);
+    }
   } else if (src_place.GetType() == AllocationType::CPU &&
              dst_place.GetType() == AllocationType::XPU) {
-    memory_utils::Copy(dst_place, dst_ptr, src_place, src_ptr, size);
+    auto* xpu_ctx = FLAGS_new_executor_xpu_multi_stream
+                        ? dynamic_cast<const XPUContext*>(&dev_ctx)
+                        : nullptr;
+    if (xpu_ctx != nullptr) {
+      phi::backends::xpu::MemcpySyncH2D(dst_ptr,
+                                        src_ptr,
+                                        size,
+                                        XPUPlace(dst_place.GetDeviceId()),
+                                        *xpu_ctx);
+    } else {
+      memory_utils::Copy(dst_place, dst_ptr, src_place, src_ptr, size);
+    }
   } else if (src_place.GetType() == AllocationType::XPU &&
              dst_place.GetType() == AllocationType::XPU) {
     if (src_ptr == dst_ptr) {
@@ -359,6 +359,48 @@ void FusedDropoutAddGradInferMeta(const MetaTensor& seed_offset,
   }
 }
 
+void FusedMoeGradInferMeta(const MetaTensor& x,
+                           const MetaTensor& gate_weight,
+                           const MetaTensor& ffn1_weight,
+                           const MetaTensor& ffn1_bias,
+                           const MetaTensor& ffn2_weight,
+                           const MetaTensor& ffn2_bias,
+                           const MetaTensor& out_grad,
+                           const std::string& quant_method,
+                           int moe_topk,
+                           MetaTensor* x_grad,
+                           MetaTensor* gate_weight_grad,
+                           MetaTensor* ffn1_weight_grad,
+                           MetaTensor* ffn1_bias_grad,
+                           MetaTensor* ffn2_weight_grad,
+                           MetaTensor* ffn2_bias_grad) {
+  PADDLE_ENFORCE_EQ(
+      quant_method,
+      "None",
+      common::errors::Unimplemented(
+          "The grad of fused_moe only supports the unquantized weights, "
+          "but got quant_method %s.",
+          quant_method));
+  if (x_grad) {
+    x_grad->share_meta(x);
+  }
+  if (gate_weight_grad) {
+    gate_weight_grad->share_meta(gate_weight);
+  }
+  if (ffn1_weight_grad) {
+    ffn1_weight_grad->share_meta(ffn1_weight);
+  }
+  if (ffn1_bias_grad) {
+    ffn1_bias_grad->share_meta(ffn1_bias);
+  }
+  if (ffn2_weight_grad) {
+    ffn2_weight_grad->share_meta(ffn2_weight);
+  }
+  if (ffn2_bias_grad) {
+    ffn2_bias_grad->share_meta(ffn2_bias);
+  }
+}
+
 void CrossEntropyWithSoftmaxGradInferMeta(const MetaTensor& label,
                                           const MetaTensor& softmax,
                                           const MetaTensor& loss_grad,
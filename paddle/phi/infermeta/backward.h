@@ -248,6 +248,22 @@ void FusedDropoutAddGradInferMeta(const MetaTensor& seed_offset,
                                   MetaTensor* x_grad,
                                   MetaTensor* y_grad);
 
+void FusedMoeGradInferMeta(const MetaTensor& x,
+                           const MetaTensor& gate_weight,
+                           const MetaTensor& ffn1_weight,
+                           const MetaTensor& ffn1_bias,
+                           const MetaTensor& ffn2_weight,
+                           const MetaTensor& ffn2_bias,
+                           const MetaTensor& out_grad,
+                           const std::string& quant_method,
+                           int moe_topk,
+                           MetaTensor* x_grad,
+                           MetaTensor* gate_weight_grad,
+                           MetaTensor* ffn1_weight_grad,
+                           MetaTensor* ffn1_bias_grad,
+                           MetaTensor* ffn2_weight_grad,
+                           MetaTensor* ffn2_bias_grad);
+
 void FusedRopeGradInferMeta(const MetaTensor& sin,
                             const MetaTensor& cos,
                             const MetaTensor& position_ids,
@@ -1195,6 +1195,79 @@ void FusedAttentionGradInferMeta(const MetaTensor& out_grad,
   }
 }
 
+void FusedBeamSearchStepInferMeta(const MetaTensor& logits,
+                                  const MetaTensor& beam_scores,
+                                  const MetaTensor& finished,
+                                  int beam_size,
+                                  int end_id,
+                                  MetaTensor* next_ids,
+                                  MetaTensor* next_scores,
+                                  MetaTensor* parent_idx,
+                                  MetaTensor* next_finished) {
+  const auto& logits_dims = logits.dims();
+  PADDLE_ENFORCE_EQ(
+      logits_dims.size(),
+      2,
+      common::errors::InvalidArgument(
+          "The logits of fused_beam_search_step should be of shape "
+          "[batch_size * beam_size, vocab_size], but received %s.",
+          logits_dims));
+  PADDLE_ENFORCE_GT(beam_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The beam_size should be positive, but received %d.",
+                        beam_size));
+  const int64_t rows = logits_dims[0];
+  if (rows > 0) {
+    PADDLE_ENFORCE_EQ(
+        rows % beam_size,
+        0,
+        common::errors::InvalidArgument(
+            "The rows of the logits (%d) should be a multiple of the "
+            "beam_size (%d).",
+            rows,
+            beam_size));
+  }
+  if (logits_dims[1] > 0) {
+    PADDLE_ENFORCE_GE(
+        logits_dims[1],
+        beam_size,
+        common::errors::InvalidArgument(
+            "The vocab_size (%d) should not be less than the beam_size (%d).",
+            logits_dims[1],
+            beam_size));
+  }
+  for (const MetaTensor* state : {&beam_scores, &finished}) {
+    PADDLE_ENFORCE_EQ(
+        state->dims().size() == 1 && state->dims()[0] == rows,
+        true,
+        common::errors::InvalidArgument(
+            "The beam_scores and finished of fused_beam_search_step should "
+            "be of shape [%d], but received %s.",
+            rows,
+            state->dims()));
+  }
+  PADDLE_ENFORCE_EQ(beam_scores.dtype(),
+                    phi::DataType::FLOAT32,
+                    common::errors::InvalidArgument(
+                        "The beam_scores should be float32, but received %s.",
+                        beam_scores.dtype()));
+  PADDLE_ENFORCE_EQ(finished.dtype(),
+                    phi::DataType::BOOL,
+                    common::errors::InvalidArgument(
+                        "The finished should be bool, but received %s.",
+                        finished.dtype()));
+
+  next_ids->set_dims({rows});
+  next_ids->set_dtype(phi::DataType::INT64);
+  next_scores->set_dims({rows});
+  next_scores->set_dtype(phi::DataType::FLOAT32);
+  parent_idx->set_dims({rows});
+  parent_idx->set_dtype(phi::DataType::INT32);
+  next_finished->set_dims({rows});
+  next_finished->set_dtype(phi::DataType::BOOL);
+}
+
 void FusedBiasDropoutResidualLnInferMeta(
     const MetaTensor& x,
     const MetaTensor& residual,
@@ -4717,6 +4790,8 @@ void FP8OutHalfGemmFusedInferMeta(
     const MetaTensor& x,
     const MetaTensor& y,
     const MetaTensor& bias,
+    const MetaTensor& x_scale_inv,
+    const MetaTensor& y_scale_inv,
     const bool trans_x,
     const bool trans_y,
     const float scale,  // only support per-tensor quantization
@@ -4795,6 +4870,414 @@ void FP8OutHalfGemmFusedInferMeta(
   }
 }
 
+void FusedFP8CastTransposeInferMeta(const MetaTensor& x,
+                                    const MetaTensor& scale,
+                                    const MetaTensor& amax_history,
+                                    const std::string& out_dtype,
+                                    bool transpose,
+                                    MetaTensor* out,
+                                    MetaTensor* out_t,
+                                    MetaTensor* amax_history_out) {
+  const auto& x_dims = x.dims();
+  PADDLE_ENFORCE_GE(x_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The rank of Input(x) of fused_fp8_cast_transpose "
+                        "must be at least 2, but got %d.",
+                        x_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      scale.dims().size() == 1 && scale.dims()[0] == 1,
+      true,
+      common::errors::InvalidArgument(
+          "Input(scale) of fused_fp8_cast_transpose must be of shape [1]."));
+  PADDLE_ENFORCE_EQ(amax_history.dims().size(),
+                    1,
+                    common::errors::InvalidArgument(
+                        "Input(amax_history) of fused_fp8_cast_transpose "
+                        "must be a 1D Tensor."));
+  phi::DataType out_type;
+  if (out_dtype == "float8_e4m3fn") {
+    out_type = phi::DataType::FLOAT8_E4M3FN;
+  } else if (out_dtype == "float8_e5m2") {
+    out_type = phi::DataType::FLOAT8_E5M2;
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "fused_fp8_cast_transpose only support float8_e4m3fn and "
+        "float8_e5m2 output, but got %s.",
+        out_dtype));
+  }
+
+  out->set_dims(x_dims);
+  out->set_dtype(out_type);
+  out->set_layout(x.layout());
+  if (transpose && out_t) {
+    const int64_t cols = x_dims[x_dims.size() - 1];
+    const int64_t rows = cols > 0 ? common::product(x_dims) / cols : 0;
+    out_t->set_dims(common::make_ddim({cols, rows}));
+    out_t->set_dtype(out_type);
+    out_t->set_layout(x.layout());
+  }
+  amax_history_out->set_dims(amax_history.dims());
+  amax_history_out->set_dtype(amax_history.dtype());
+}
+
+void FP8AmaxAndScaleUpdateInferMeta(const MetaTensor& amax_history,
+                                    const MetaTensor& scale,
+                                    float fp8_max,
+                                    float margin,
+                                    const std::string& amax_compute_algo,
+                                    MetaTensor* amax_history_out,
+                                    MetaTensor* scale_out,
+                                    MetaTensor* scale_inv_out) {
+  PADDLE_ENFORCE_EQ(amax_history.dims().size(),
+                    1,
+                    common::errors::InvalidArgument(
+                        "Input(amax_history) of fp8_amax_and_scale_update "
+                        "must be a 1D Tensor."));
+  PADDLE_ENFORCE_GT(fp8_max,
+                    0.f,
+                    common::errors::InvalidArgument(
+                        "fp8_max of fp8_amax_and_scale_update must be "
+                        "positive, but got %f.",
+                        fp8_max));
+  amax_history_out->set_dims(amax_history.dims());
+  amax_history_out->set_dtype(amax_history.dtype());
+  scale_out->set_dims(scale.dims());
+  scale_out->set_dtype(scale.dtype());
+  scale_inv_out->set_dims(scale.dims());
+  scale_inv_out->set_dtype(scale.dtype());
+}
+
+void FusedElementwiseChainInferMeta(const std::vector<const MetaTensor*>& x,
+                                    const std::vector<std::string>& ops,
+                                    const std::vector<float>& scales,
+                                    MetaTensor* out) {
+  PADDLE_ENFORCE_GE(
+      static_cast<int>(x.size()),
+      1,
+      common::errors::InvalidArgument(
+          "The fused_elementwise_chain needs at least one input."));
+  PADDLE_ENFORCE_LE(
+      static_cast<int>(x.size()),
+      4,
+      common::errors::InvalidArgument(
+          "The fused_elementwise_chain supports at most 4 inputs, but "
+          "received %d.",
+          x.size()));
+  PADDLE_ENFORCE_LE(
+      static_cast<int>(ops.size()),
+      16,
+      common::errors::InvalidArgument(
+          "The fused_elementwise_chain supports at most 16 ops, but "
+          "received %d.",
+          ops.size()));
+  size_t binary_num = 0;
+  size_t scale_num = 0;
+  for (const auto& op : ops) {
+    if (op == "add" || op == "subtract" || op == "multiply" ||
+        op == "divide" || op == "maximum" || op == "minimum") {
+      ++binary_num;
+    } else if (op == "scale") {
+      ++scale_num;
+    } else {
+      PADDLE_ENFORCE_EQ(
+          op == "relu" || op == "gelu" || op == "silu" || op == "sigmoid" ||
+              op == "tanh",
+          true,
+          common::errors::InvalidArgument(
+              "The op %s is not supported by fused_elementwise_chain.", op));
+    }
+  }
+  PADDLE_ENFORCE_EQ(binary_num + 1,
+                    x.size(),
+                    common::errors::InvalidArgument(
+                        "Each binary op of fused_elementwise_chain takes the "
+                        "next input, so the number of the inputs (%d) should "
+                        "be the number of the binary ops (%d) plus 1.",
+                        x.size(),
+                        binary_num));
+  PADDLE_ENFORCE_EQ(scale_num,
+                    scales.size(),
+                    common::errors::InvalidArgument(
+                        "Each scale op of fused_elementwise_chain takes the "
+                        "next value of scales, but there are %d scale ops "
+                        "and %d scales.",
+                        scale_num,
+                        scales.size()));
+
+  DDim out_dims = x[0]->dims();
+  for (size_t i = 1; i < x.size(); ++i) {
+    PADDLE_ENFORCE_EQ(x[i]->dtype(),
+                      x[0]->dtype(),
+                      common::errors::InvalidArgument(
+                          "The inputs of fused_elementwise_chain should have "
+                          "the same data type."));
+    out_dims = BroadCastInferShape(out_dims, x[i]->dims(), -1);
+  }
+  out->set_dims(out_dims);
+  out->set_dtype(x[0]->dtype());
+  out->set_layout(x[0]->layout());
+}
+
+void FusedMultiLoraLinearInferMeta(const MetaTensor& x,
+                                   const MetaTensor& lora_a,
+                                   const MetaTensor& lora_b,
+                                   const MetaTensor& seg_offsets,
+                                   const MetaTensor& adapter_ids,
+                                   const MetaTensor& base_out,
+                                   float scaling,
+                                   MetaTensor* out) {
+  const auto& x_dims = x.dims();
+  const auto& a_dims = lora_a.dims();
+  const auto& b_dims = lora_b.dims();
+  PADDLE_ENFORCE_GE(x_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input x of fused_multi_lora_linear should be at "
+                        "least 2-D, but received %d-D.",
+                        x_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      a_dims.size() == 3 && b_dims.size() == 3,
+      true,
+      common::errors::InvalidArgument(
+          "The lora_a and lora_b of fused_multi_lora_linear should be 3-D, "
+          "[adapter_num, rank, in_features] and [adapter_num, rank, "
+          "out_features], but received %d-D and %d-D.",
+          a_dims.size(),
+          b_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      a_dims[2],
+      x_dims[x_dims.size() - 1],
+      common::errors::InvalidArgument(
+          "The last dim of lora_a (%d) should be the last dim of x (%d).",
+          a_dims[2],
+          x_dims[x_dims.size() - 1]));
+  PADDLE_ENFORCE_EQ(
+      a_dims[0] == b_dims[0] && a_dims[1] == b_dims[1],
+      true,
+      common::errors::InvalidArgument(
+          "The lora_a and lora_b of fused_multi_lora_linear should have the "
+          "same adapter_num and rank, but received [%d, %d] and [%d, %d].",
+          a_dims[0],
+          a_dims[1],
+          b_dims[0],
+          b_dims[1]));
+  PADDLE_ENFORCE_EQ(
+      seg_offsets.numel() < 0 || adapter_ids.numel() < 0 ||
+          seg_offsets.numel() == adapter_ids.numel() + 1,
+      true,
+      common::errors::InvalidArgument(
+          "The seg_offsets of fused_multi_lora_linear should have one more "
+          "element than adapter_ids, but received %d and %d.",
+          seg_offsets.numel(),
+          adapter_ids.numel()));
+
+  DDim out_dims = x_dims;
+  out_dims[out_dims.size() - 1] = b_dims[2];
+  if (base_out) {
+    PADDLE_ENFORCE_EQ(base_out.dims(),
+                      out_dims,
+                      common::errors::InvalidArgument(
+                          "The base_out of fused_multi_lora_linear should be "
+                          "of the shape [%s], but received [%s].",
+                          out_dims,
+                          base_out.dims()));
+  }
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
+void FusedQkvRopeCacheInferMeta(const MetaTensor& qkv,
+                                const MetaTensor& key_cache,
+                                const MetaTensor& value_cache,
+                                const MetaTensor& position_ids,
+                                const MetaTensor& block_tables,
+                                const MetaTensor& qkv_bias,
+                                const MetaTensor& sin,
+                                const MetaTensor& cos,
+                                const MetaTensor& cache_k_quant_scales,
+                                const MetaTensor& cache_v_quant_scales,
+                                int q_num_head,
+                                int kv_num_head,
+                                bool use_neox_rotary_style,
+                                float rotary_emb_base,
+                                int quant_round_type,
+                                float quant_max_bound,
+                                float quant_min_bound,
+                                MetaTensor* q_out,
+                                MetaTensor* key_cache_out,
+                                MetaTensor* value_cache_out) {
+  const auto& qkv_dims = qkv.dims();
+  PADDLE_ENFORCE_EQ(
+      qkv_dims.size(),
+      2,
+      common::errors::InvalidArgument(
+          "The qkv of fused_qkv_rope_cache should be of shape [batch_size, "
+          "(q_num_head + 2 * kv_num_head) * head_dim], but received %s.",
+          qkv_dims));
+  PADDLE_ENFORCE_EQ(
+      q_num_head > 0 && kv_num_head > 0 && q_num_head % kv_num_head == 0,
+      true,
+      common::errors::InvalidArgument(
+          "The q_num_head (%d) should be a positive multiple of the "
+          "kv_num_head (%d).",
+          q_num_head,
+          kv_num_head));
+  const int64_t num_head = q_num_head + 2 * kv_num_head;
+  PADDLE_ENFORCE_EQ(qkv_dims[1] % num_head,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The last dim of the qkv (%d) should be a multiple of "
+                        "q_num_head + 2 * kv_num_head (%d).",
+                        qkv_dims[1],
+                        num_head));
+  const int64_t head_dim = qkv_dims[1] / num_head;
+  PADDLE_ENFORCE_EQ(
+      head_dim % 2,
+      0,
+      common::errors::InvalidArgument(
+          "The head_dim of fused_qkv_rope_cache should be even, but "
+          "received %d.",
+          head_dim));
+
+  const auto& cache_dims = key_cache.dims();
+  PADDLE_ENFORCE_EQ(
+      cache_dims.size() == 4 && cache_dims[1] == kv_num_head &&
+          cache_dims[3] == head_dim && value_cache.dims() == cache_dims,
+      true,
+      common::errors::InvalidArgument(
+          "The key_cache and value_cache should be of shape [max_block_num, "
+          "%d, block_size, %d], but received %s and %s.",
+          kv_num_head,
+          head_dim,
+          cache_dims,
+          value_cache.dims()));
+  PADDLE_ENFORCE_EQ(
+      position_ids.dims().size() == 1 &&
+          position_ids.dims()[0] == qkv_dims[0] &&
+          block_tables.dims().size() == 2 &&
+          block_tables.dims()[0] == qkv_dims[0],
+      true,
+      common::errors::InvalidArgument(
+          "The position_ids should be of shape [%d] and the block_tables of "
+          "shape [%d, max_blocks_per_seq], but received %s and %s.",
+          qkv_dims[0],
+          qkv_dims[0],
+          position_ids.dims(),
+          block_tables.dims()));
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(sin),
+      static_cast<bool>(cos),
+      common::errors::InvalidArgument(
+          "The sin and cos of fused_qkv_rope_cache should be both given or "
+          "both absent."));
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(cache_k_quant_scales),
+      static_cast<bool>(cache_v_quant_scales),
+      common::errors::InvalidArgument(
+          "The cache_k_quant_scales and cache_v_quant_scales should be both "
+          "given or both absent."));
+
+  q_out->set_dims({qkv_dims[0], q_num_head, head_dim});
+  q_out->set_dtype(qkv.dtype());
+  key_cache_out->share_meta(key_cache);
+  value_cache_out->share_meta(value_cache);
+}
+
+void SpeculateVerifyInferMeta(const MetaTensor& draft_tokens,
+                              const MetaTensor& target_tokens,
+                              const MetaTensor& draft_parents,
+                              MetaTensor* accept_tokens,
+                              MetaTensor* accept_num,
+                              MetaTensor* accept_index) {
+  const auto& draft_dims = draft_tokens.dims();
+  PADDLE_ENFORCE_EQ(
+      draft_dims.size(),
+      2,
+      common::errors::InvalidArgument(
+          "The draft_tokens of speculate_verify should be of shape "
+          "[batch_size, num_draft], but received %s.",
+          draft_dims));
+  const int64_t batch_size = draft_dims[0];
+  const int64_t num_draft = draft_dims[1];
+  PADDLE_ENFORCE_EQ(
+      target_tokens.dims().size() == 2 &&
+          target_tokens.dims()[0] == batch_size &&
+          target_tokens.dims()[1] == num_draft + 1,
+      true,
+      common::errors::InvalidArgument(
+          "The target_tokens of speculate_verify should be of shape [%d, %d], "
+          "but received %s.",
+          batch_size,
+          num_draft + 1,
+          target_tokens.dims()));
+  PADDLE_ENFORCE_EQ(
+      target_tokens.dtype(),
+      draft_tokens.dtype(),
+      common::errors::InvalidArgument(
+          "The target_tokens and draft_tokens of speculate_verify should have "
+          "the same dtype."));
+  PADDLE_ENFORCE_EQ(
+      draft_parents.dims() == draft_dims &&
+          draft_parents.dtype() == DataType::INT32,
+      true,
+      common::errors::InvalidArgument(
+          "The draft_parents of speculate_verify should be int32 of shape "
+          "%s, but received %s.",
+          draft_dims,
+          draft_parents.dims()));
+
+  accept_tokens->set_dims({batch_size, num_draft + 1});
+  accept_tokens->set_dtype(draft_tokens.dtype());
+  accept_num->set_dims({batch_size});
+  accept_num->set_dtype(DataType::INT32);
+  accept_index->set_dims({batch_size, num_draft + 1});
+  accept_index->set_dtype(DataType::INT32);
+}
+
+void Sparse24LinearInferMeta(const MetaTensor& x,
+                             const MetaTensor& w,
+                             int n,
+                             MetaTensor* out) {
+  const auto& x_dims = x.dims();
+  PADDLE_ENFORCE_GE(x_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input x of sparse_2_4_linear should be at least "
+                        "2-D, but received %d-D.",
+                        x_dims.size()));
+  PADDLE_ENFORCE_EQ(w.dtype(),
+                    DataType::UINT8,
+                    common::errors::InvalidArgument(
+                        "The w of sparse_2_4_linear should be the uint8 "
+                        "output of sparse_2_4_weight_compress."));
+  PADDLE_ENFORCE_GT(
+      n,
+      0,
+      common::errors::InvalidArgument(
+          "The n of sparse_2_4_linear should be positive, but received %d.",
+          n));
+  DDim out_dims = x_dims;
+  out_dims[out_dims.size() - 1] = n;
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
+void Sparse24WeightCompressInferMeta(const MetaTensor& w, MetaTensor* out) {
+  PADDLE_ENFORCE_EQ(w.dims().size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The w of sparse_2_4_weight_compress should be 2-D, "
+                        "but received %d-D.",
+                        w.dims().size()));
+  // the size of the compressed values and metadata is only known to
+  // cuSPARSELt, and set by the kernel
+  out->set_dims(common::make_ddim({-1}));
+  out->set_dtype(DataType::UINT8);
+}
+
 void FusedEmbeddingFcLstmInferMeta(const MetaTensor& ids,
                                    const MetaTensor& embeddings,
                                    const MetaTensor& weight_h,
@@ -851,6 +851,16 @@ void FusionSeqExpandConcatFCInferMeta(const std::vector<const MetaTensor*>& x,
                                       MetaTensor* out,
                                       MetaTensor* fc_out);
 
+void FusedBeamSearchStepInferMeta(const MetaTensor& logits,
+                                  const MetaTensor& beam_scores,
+                                  const MetaTensor& finished,
+                                  int beam_size,
+                                  int end_id,
+                                  MetaTensor* next_ids,
+                                  MetaTensor* next_scores,
+                                  MetaTensor* parent_idx,
+                                  MetaTensor* next_finished);
+
 void FusedBiasDropoutResidualLnInferMeta(
     const MetaTensor& x,
     const MetaTensor& residual,
@@ -1081,6 +1091,8 @@ void FP8OutHalfGemmFusedInferMeta(
     const MetaTensor& x,
     const MetaTensor& y,
     const MetaTensor& bias,
+    const MetaTensor& x_scale_inv,
+    const MetaTensor& y_scale_inv,
     const bool trans_x,
     const bool trans_y,
     const float scale,  // only support per-tensor quantization
@@ -1088,6 +1100,73 @@ void FP8OutHalfGemmFusedInferMeta(
     const std::string& activation_type,
     MetaTensor* out);
 
+void FusedFP8CastTransposeInferMeta(const MetaTensor& x,
+                                    const MetaTensor& scale,
+                                    const MetaTensor& amax_history,
+                                    const std::string& out_dtype,
+                                    bool transpose,
+                                    MetaTensor* out,
+                                    MetaTensor* out_t,
+                                    MetaTensor* amax_history_out);
+
+void FP8AmaxAndScaleUpdateInferMeta(const MetaTensor& amax_history,
+                                    const MetaTensor& scale,
+                                    float fp8_max,
+                                    float margin,
+                                    const std::string& amax_compute_algo,
+                                    MetaTensor* amax_history_out,
+                                    MetaTensor* scale_out,
+                                    MetaTensor* scale_inv_out);
+
+void FusedElementwiseChainInferMeta(const std::vector<const MetaTensor*>& x,
+                                    const std::vector<std::string>& ops,
+                                    const std::vector<float>& scales,
+                                    MetaTensor* out);
+
+void FusedMultiLoraLinearInferMeta(const MetaTensor& x,
+                                   const MetaTensor& lora_a,
+                                   const MetaTensor& lora_b,
+                                   const MetaTensor& seg_offsets,
+                                   const MetaTensor& adapter_ids,
+                                   const MetaTensor& base_out,
+                                   float scaling,
+                                   MetaTensor* out);
+
+void FusedQkvRopeCacheInferMeta(const MetaTensor& qkv,
+                                const MetaTensor& key_cache,
+                                const MetaTensor& value_cache,
+                                const MetaTensor& position_ids,
+                                const MetaTensor& block_tables,
+                                const MetaTensor& qkv_bias,
+                                const MetaTensor& sin,
+                                const MetaTensor& cos,
+                                const MetaTensor& cache_k_quant_scales,
+                                const MetaTensor& cache_v_quant_scales,
+                                int q_num_head,
+                                int kv_num_head,
+                                bool use_neox_rotary_style,
+                                float rotary_emb_base,
+                                int quant_round_type,
+                                float quant_max_bound,
+                                float quant_min_bound,
+                                MetaTensor* q_out,
+                                MetaTensor* key_cache_out,
+                                MetaTensor* value_cache_out);
+
+void SpeculateVerifyInferMeta(const MetaTensor& draft_tokens,
+                              const MetaTensor& target_tokens,
+                              const MetaTensor& draft_parents,
+                              MetaTensor* accept_tokens,
+                              MetaTensor* accept_num,
+                              MetaTensor* accept_index);
+
+void Sparse24LinearInferMeta(const MetaTensor& x,
+                             const MetaTensor& w,
+                             int n,
+                             MetaTensor* out);
+
+void Sparse24WeightCompressInferMeta(const MetaTensor& w, MetaTensor* out);
+
 void FusedEmbeddingFcLstmInferMeta(const MetaTensor& ids,
                                    const MetaTensor& embeddings,
                                    const MetaTensor& weight_h,
@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/phi/core/utils/data_type.h"
 #include "paddle/phi/infermeta/binary.h"
 #include "paddle/phi/infermeta/nullary.h"
+#include "paddle/phi/infermeta/unary.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
 #include "paddle/phi/kernels/funcs/concat_funcs.h"
 
@@ -1683,6 +1684,14 @@ void DecayedAdagradInferMeta(const MetaTensor& param,
   moment_out->set_dtype(param.dtype());
 }
 
+void DecodeJpegBatchInferMeta(const std::vector<const MetaTensor*>& x,
+                              const std::string& mode,
+                              std::vector<MetaTensor*> out) {
+  for (size_t i = 0; i < x.size(); ++i) {
+    DecodeJpegInferMeta(*x[i], mode, out[i]);
+  }
+}
+
 inline int ConvOutputSize(
     int input_size, int filter_size, int dilation, int padding, int stride) {
   const int dkernel = dilation * (filter_size - 1) + 1;
@@ -5470,6 +5479,7 @@ void WeightOnlyLinearInferMeta(const MetaTensor& x,
                                const MetaTensor& weight,
                                const MetaTensor& bias,
                                const MetaTensor& weight_scale,
+                               const MetaTensor& weight_zero,
                                const std::string& weight_dtype,
                                const int32_t arch,
                                const int32_t group_size,
@@ -5541,6 +5551,16 @@ void WeightOnlyLinearInferMeta(const MetaTensor& x,
                                 weight_scale_dims[0],
                                 (w_dims[1] + (group_size - 1)) / group_size));
   }
+  if (weight_zero.initialized()) {
+    PADDLE_ENFORCE_EQ(
+        weight_zero.dims(),
+        weight_scale_dims,
+        errors::InvalidArgument("The input(weight_zero) must have the same "
+                                "shape as input(weight_scale). But received "
+                                "%s and %s",
+                                weight_zero.dims(),
+                                weight_scale_dims));
+  }
 
   auto out_dims = x_dims;
   out_dims[out_dims.size() - 1] = n;
@@ -5821,6 +5841,117 @@ void FusedAdamInferMeta(
   }
 }
 
+void FusedClipByGlobalNormInferMeta(
+    const std::vector<const MetaTensor*>& grads,
+    const MetaTensor& scale,
+    float clip_norm,
+    int chunk_size,
+    std::vector<MetaTensor*> grads_out,
+    MetaTensor* found_infinite,
+    MetaTensor* global_norm) {
+  PADDLE_ENFORCE_GT(clip_norm,
+                    0.0f,
+                    common::errors::InvalidArgument(
+                        "The clip_norm of fused_clip_by_global_norm should "
+                        "be greater than 0, but got %f.",
+                        clip_norm));
+  PADDLE_ENFORCE_GT(chunk_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The chunk_size should be greater than 0, but got %d.",
+                        chunk_size));
+  for (size_t i = 0; i < grads.size(); i++) {
+    grads_out[i]->set_dims(grads[i]->dims());
+    grads_out[i]->set_dtype(grads[i]->dtype());
+  }
+  found_infinite->set_dims({1});
+  found_infinite->set_dtype(DataType::BOOL);
+  global_norm->set_dims({1});
+  global_norm->set_dtype(DataType::FLOAT32);
+}
+
+void FusedLambInferMeta(
+    const std::vector<const MetaTensor*>& params,
+    const std::vector<const MetaTensor*>& grads,
+    const MetaTensor& learning_rate,
+    const std::vector<const MetaTensor*>& moments1,
+    const std::vector<const MetaTensor*>& moments2,
+    const std::vector<const MetaTensor*>& beta1_pows,
+    const std::vector<const MetaTensor*>& beta2_pows,
+    const paddle::optional<std::vector<const MetaTensor*>>& master_params,
+    const MetaTensor& skip_update,
+    float weight_decay,
+    float beta1,
+    float beta2,
+    float epsilon,
+    bool always_adapt,
+    bool multi_precision,
+    int chunk_size,
+    std::vector<MetaTensor*> params_out,
+    std::vector<MetaTensor*> moments1_out,
+    std::vector<MetaTensor*> moments2_out,
+    std::vector<MetaTensor*> beta1_pows_out,
+    std::vector<MetaTensor*> beta2_pows_out,
+    std::vector<MetaTensor*> master_params_out) {
+  PADDLE_ENFORCE_GT(chunk_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The chunk_size should be greater than 0, but got %d.",
+                        chunk_size));
+  size_t in_size = params.size();
+  for (size_t i = 0; i < in_size; i++) {
+    params_out[i]->set_dims(params[i]->dims());
+    params_out[i]->set_dtype(params[i]->dtype());
+    moments1_out[i]->set_dims(moments1[i]->dims());
+    moments1_out[i]->set_dtype(moments1[i]->dtype());
+    moments2_out[i]->set_dims(moments2[i]->dims());
+    moments2_out[i]->set_dtype(moments2[i]->dtype());
+    beta1_pows_out[i]->set_dims(beta1_pows[i]->dims());
+    beta1_pows_out[i]->set_dtype(beta1_pows[i]->dtype());
+    beta2_pows_out[i]->set_dims(beta2_pows[i]->dims());
+    beta2_pows_out[i]->set_dtype(beta2_pows[i]->dtype());
+    if (master_params && !master_params_out.empty()) {
+      master_params_out[i]->set_dims(master_params.get()[i]->dims());
+      master_params_out[i]->set_dtype(master_params.get()[i]->dtype());
+    }
+  }
+}
+
+void FusedMomentumInferMeta(
+    const std::vector<const MetaTensor*>& params,
+    const std::vector<const MetaTensor*>& grads,
+    const std::vector<const MetaTensor*>& velocitys,
+    const MetaTensor& learning_rate,
+    const paddle::optional<std::vector<const MetaTensor*>>& master_params,
+    const MetaTensor& skip_update,
+    float mu,
+    bool use_nesterov,
+    const std::string& regularization_method,
+    float regularization_coeff,
+    bool multi_precision,
+    float rescale_grad,
+    int chunk_size,
+    std::vector<MetaTensor*> params_out,
+    std::vector<MetaTensor*> velocitys_out,
+    std::vector<MetaTensor*> master_params_out) {
+  PADDLE_ENFORCE_GT(chunk_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The chunk_size should be greater than 0, but got %d.",
+                        chunk_size));
+  size_t in_size = params.size();
+  for (size_t i = 0; i < in_size; i++) {
+    params_out[i]->set_dims(params[i]->dims());
+    params_out[i]->set_dtype(params[i]->dtype());
+    velocitys_out[i]->set_dims(velocitys[i]->dims());
+    velocitys_out[i]->set_dtype(velocitys[i]->dtype());
+    if (master_params && !master_params_out.empty()) {
+      master_params_out[i]->set_dims(master_params.get()[i]->dims());
+      master_params_out[i]->set_dtype(master_params.get()[i]->dtype());
+    }
+  }
+}
+
 void FusedConvInferMeta(const MetaTensor& input,
                         const MetaTensor& filter,
                         const MetaTensor& bias,
@@ -6010,6 +6141,10 @@ void MaskedMultiheadAttentionInferMeta(const MetaTensor& x,
                                        const MetaTensor& qkv_out_scale,
                                        const MetaTensor& out_shift,
                                        const MetaTensor& out_smooth,
+                                       const MetaTensor& cache_k_quant_scales,
+                                       const MetaTensor& cache_v_quant_scales,
+                                       const MetaTensor& cache_k_dequant_scales,
+                                       const MetaTensor& cache_v_dequant_scales,
                                        int seq_len,
                                        int rotary_emb_dims,
                                        const bool use_neox_rotary_style,
@@ -6050,6 +6185,27 @@ void MaskedMultiheadAttentionInferMeta(const MetaTensor& x,
       errors::InvalidArgument("The first dim of cache_kv must be 2, but got %d",
                               cache_kv_dims[0]));
 
+  // an int8 cache_kv is quantized and dequantized by per kv head scales
+  if (cache_kv.dtype() == phi::DataType::UINT8) {
+    for (const MetaTensor* scales : {&cache_k_quant_scales,
+                                     &cache_v_quant_scales,
+                                     &cache_k_dequant_scales,
+                                     &cache_v_dequant_scales}) {
+      PADDLE_ENFORCE_EQ(
+          scales->initialized(),
+          true,
+          errors::InvalidArgument("The quant and dequant scales of the cache "
+                                  "must be given for the int8 cache_kv."));
+      PADDLE_ENFORCE_EQ(
+          scales->numel(),
+          static_cast<int64_t>(k_num_head),
+          errors::InvalidArgument("The scales of the int8 cache_kv must have "
+                                  "one per kv head (%d), but got %d.",
+                                  k_num_head,
+                                  scales->numel()));
+    }
+  }
+
   if (rotary_tensor) {
     PADDLE_ENFORCE_EQ(
         rotary_tensor.dtype(),
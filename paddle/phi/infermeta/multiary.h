@@ -350,6 +350,10 @@ void DecayedAdagradInferMeta(const MetaTensor& param,
                              MetaTensor* param_out,
                              MetaTensor* moment_out);
 
+void DecodeJpegBatchInferMeta(const std::vector<const MetaTensor*>& x,
+                              const std::string& mode,
+                              std::vector<MetaTensor*> out);
+
 void DeformableConvInferMeta(const MetaTensor& x,
                              const MetaTensor& offset,
                              const MetaTensor& filter,
@@ -1059,6 +1063,7 @@ void WeightOnlyLinearInferMeta(const MetaTensor& x,
                                const MetaTensor& weight,
                                const MetaTensor& bias,
                                const MetaTensor& weight_scale,
+                               const MetaTensor& weight_zero,
                                const std::string& weight_dtype,
                                const int32_t arch,
                                const int32_t group_size,
@@ -1140,6 +1145,57 @@ void FusedAdamInferMeta(
     std::vector<MetaTensor*> beta2_pows_out,
     std::vector<MetaTensor*> master_params_out);
 
+void FusedClipByGlobalNormInferMeta(
+    const std::vector<const MetaTensor*>& grads,
+    const MetaTensor& scale,
+    float clip_norm,
+    int chunk_size,
+    std::vector<MetaTensor*> grads_out,
+    MetaTensor* found_infinite,
+    MetaTensor* global_norm);
+
+void FusedLambInferMeta(
+    const std::vector<const MetaTensor*>& params,
+    const std::vector<const MetaTensor*>& grads,
+    const MetaTensor& learning_rate,
+    const std::vector<const MetaTensor*>& moments1,
+    const std::vector<const MetaTensor*>& moments2,
+    const std::vector<const MetaTensor*>& beta1_pows,
+    const std::vector<const MetaTensor*>& beta2_pows,
+    const paddle::optional<std::vector<const MetaTensor*>>& master_params,
+    const MetaTensor& skip_update,
+    float weight_decay,
+    float beta1,
+    float beta2,
+    float epsilon,
+    bool always_adapt,
+    bool multi_precision,
+    int chunk_size,
+    std::vector<MetaTensor*> params_out,
+    std::vector<MetaTensor*> moments1_out,
+    std::vector<MetaTensor*> moments2_out,
+    std::vector<MetaTensor*> beta1_pows_out,
+    std::vector<MetaTensor*> beta2_pows_out,
+    std::vector<MetaTensor*> master_params_out);
+
+void FusedMomentumInferMeta(
+    const std::vector<const MetaTensor*>& params,
+    const std::vector<const MetaTensor*>& grads,
+    const std::vector<const MetaTensor*>& velocitys,
+    const MetaTensor& learning_rate,
+    const paddle::optional<std::vector<const MetaTensor*>>& master_params,
+    const MetaTensor& skip_update,
+    float mu,
+    bool use_nesterov,
+    const std::string& regularization_method,
+    float regularization_coeff,
+    bool multi_precision,
+    float rescale_grad,
+    int chunk_size,
+    std::vector<MetaTensor*> params_out,
+    std::vector<MetaTensor*> velocitys_out,
+    std::vector<MetaTensor*> master_params_out);
+
 void FusedConvInferMeta(const MetaTensor& input,
                         const MetaTensor& filter,
                         const MetaTensor& bias,
@@ -1239,6 +1295,10 @@ void MaskedMultiheadAttentionInferMeta(const MetaTensor& x,
                                        const MetaTensor& qkv_out_scale,
                                        const MetaTensor& out_shift,
                                        const MetaTensor& out_smooth,
+                                       const MetaTensor& cache_k_quant_scales,
+                                       const MetaTensor& cache_v_quant_scales,
+                                       const MetaTensor& cache_k_dequant_scales,
+                                       const MetaTensor& cache_v_dequant_scales,
                                        int seq_len,
                                        int rotary_emb_dims,
                                        const bool use_neox_rotary_style,
@@ -5704,6 +5704,15 @@ void UniqueRawInferMeta(const MetaTensor& x,
                           x.dims().size()));
     out->set_dims(common::make_ddim({-1}));
     index->set_dims(x.dims());
+    index->set_dtype(dtype);
+    if (return_index) {
+      indices->set_dims(common::make_ddim({-1}));
+      indices->set_dtype(dtype);
+    }
+    if (return_counts) {
+      counts->set_dims(common::make_ddim({-1}));
+      counts->set_dtype(dtype);
+    }
     return;
   }
 
@@ -318,6 +318,8 @@ MakeGatherGemmScatterTuner(ReturnType (*func)(T, T, Args...)) {
   DEFINE_AUTOTUNER_FN(name)
 
 DEFINE_AUTOTUNER(Transpose)
+DEFINE_AUTOTUNER(Reduce)
+DEFINE_AUTOTUNER(SparseConv)
 DEFINE_AUTOTUNER_FN(Matmul)
 
 #undef DEFINE_AUTOTUNER_COMMON_OBJECT
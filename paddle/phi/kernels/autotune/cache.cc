@@ -14,9 +14,14 @@
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
+#include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include "glog/logging.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
 
 namespace phi::autotune {
 
@@ -27,6 +32,37 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
   return GenKey(x_dims, perm, rank, static_cast<int>(dtype));
 }
 
+size_t ReduceKey(const std::vector<int>& x_dims,
+                 const std::vector<int>& reduce_dims,
+                 phi::DataType dtype,
+                 bool single_launch) {
+  return GenKey(x_dims, reduce_dims, static_cast<int>(dtype), single_launch);
+}
+
+// Bump it whenever the layout of the serialized file or the meaning of the
+// cached keys changes.
+static constexpr int kAutoTuneCacheFormatVersion = 1;
+static constexpr char kAutoTuneCacheMagic[] = "paddle_autotune_cache";
+
+template <typename T>
+static void WriteVector(std::ostream& os, const std::vector<T>& vec) {
+  os << " " << vec.size();
+  for (auto& v : vec) {
+    os << " " << v;
+  }
+}
+
+template <typename T>
+static bool ReadVector(std::istream& is, std::vector<T>* vec) {
+  size_t size = 0;
+  if (!(is >> size)) return false;
+  vec->resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    if (!(is >> (*vec)[i])) return false;
+  }
+  return true;
+}
+
 std::string AlgorithmTypeString(int64_t algo_type) {
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForward)) {
     return "conv_forward";
@@ -115,4 +151,143 @@ void AutoTuneCache::UpdateStatus() {
   total_cache_misses_ = cache_misses;
 }
 
+std::string AutoTuneCache::EnvFingerprint() {
+  std::ostringstream os;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  int device_id = phi::backends::gpu::GetCurrentDeviceId();
+  os << "gpu_arch:" << phi::backends::gpu::GetGPUComputeCapability(device_id)
+     << ",driver:" << phi::backends::gpu::GetGPUDriverVersion(device_id)
+     << ",runtime:" << phi::backends::gpu::GetGPURuntimeVersion(device_id)
+     << ",dnn:" << phi::backends::gpu::DnnVersion();
+#else
+  os << "cpu";
+#endif
+  return os.str();
+}
+
+bool AutoTuneCache::SaveToFile(const std::string& path) {
+  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+  if (!ofs.is_open()) {
+    LOG(WARNING) << "Cannot open autotune cache file " << path
+                 << " for writing.";
+    return false;
+  }
+  ofs << kAutoTuneCacheMagic << " " << kAutoTuneCacheFormatVersion << "\n";
+  ofs << "env " << EnvFingerprint() << "\n";
+
+  int64_t num_entries = 0;
+  for (auto& v : auto_tune_map_) {
+    for (auto& item : v.second.Items()) {
+      ofs << "algo " << v.first << " " << item.first << " " << item.second
+          << "\n";
+      ++num_entries;
+    }
+  }
+  for (auto& item : matmul_auto_tune_map_.Items()) {
+    ofs << "matmul " << item.first << " " << item.second << "\n";
+    ++num_entries;
+  }
+  for (auto& v : conv_auto_tune_map_) {
+    for (auto& item : v.second.Items()) {
+      const ConvCacheKey& key = item.first;
+      const ConvAutoTuneResult& result = item.second;
+      ofs << "conv " << v.first << " " << result.algo << " "
+          << result.workspace_size << " " << result.exhaustive_search << " "
+          << static_cast<int>(key.dtype) << " " << key.groups << " "
+          << key.data_layout;
+      WriteVector(ofs, key.x_dims);
+      WriteVector(ofs, key.w_dims);
+      WriteVector(ofs, key.strides);
+      WriteVector(ofs, key.paddings);
+      WriteVector(ofs, key.dilations);
+      ofs << "\n";
+      ++num_entries;
+    }
+  }
+  ofs.close();
+  if (ofs.fail()) {
+    LOG(WARNING) << "Failed to write autotune cache file " << path;
+    return false;
+  }
+  VLOG(3) << "Saved " << num_entries << " autotune cache entries to " << path;
+  return true;
+}
+
+int64_t AutoTuneCache::LoadFromFile(const std::string& path) {
+  std::ifstream ifs(path);
+  if (!ifs.is_open()) {
+    VLOG(3) << "Autotune cache file " << path << " does not exist.";
+    return -1;
+  }
+
+  std::string line;
+  std::string magic;
+  int version = 0;
+  if (!std::getline(ifs, line)) return -1;
+  std::istringstream header(line);
+  header >> magic >> version;
+  if (magic != kAutoTuneCacheMagic || version != kAutoTuneCacheFormatVersion) {
+    LOG(WARNING) << "Skip autotune cache file " << path
+                 << ", which is not written in format version "
+                 << kAutoTuneCacheFormatVersion << ".";
+    return -1;
+  }
+  std::string expected_env = "env " + EnvFingerprint();
+  if (!std::getline(ifs, line) || line != expected_env) {
+    LOG(WARNING) << "Skip autotune cache file " << path
+                 << ", which is tuned on a different device environment ("
+                 << line << " vs. " << expected_env << ").";
+    return -1;
+  }
+
+  int64_t num_entries = 0;
+  while (std::getline(ifs, line)) {
+    if (line.empty()) continue;
+    std::istringstream is(line);
+    std::string kind;
+    is >> kind;
+    bool valid = false;
+    if (kind == "algo") {
+      int64_t algo_type = 0;
+      size_t key = 0;
+      int64_t algo = 0;
+      if (is >> algo_type >> key >> algo &&
+          auto_tune_map_.find(algo_type) != auto_tune_map_.end()) {
+        auto_tune_map_[algo_type].Set(key, algo);
+        valid = true;
+      }
+    } else if (kind == "matmul") {
+      size_t key = 0;
+      int64_t algo = 0;
+      if (is >> key >> algo) {
+        matmul_auto_tune_map_.Set(key, algo);
+        valid = true;
+      }
+    } else if (kind == "conv") {
+      int64_t algo_type = 0;
+      int dtype = 0;
+      ConvCacheKey key;
+      ConvAutoTuneResult result;
+      if (is >> algo_type >> result.algo >> result.workspace_size >>
+          result.exhaustive_search >> dtype >> key.groups >>
+          key.data_layout && ReadVector(is, &key.x_dims) &&
+          ReadVector(is, &key.w_dims) && ReadVector(is, &key.strides) &&
+          ReadVector(is, &key.paddings) && ReadVector(is, &key.dilations) &&
+          conv_auto_tune_map_.find(algo_type) != conv_auto_tune_map_.end()) {
+        key.dtype = static_cast<phi::DataType>(dtype);
+        conv_auto_tune_map_[algo_type].Set(key, result);
+        valid = true;
+      }
+    }
+    if (!valid) {
+      LOG(WARNING) << "Skip invalid autotune cache entry: " << line;
+      continue;
+    }
+    ++num_entries;
+  }
+  VLOG(3) << "Loaded " << num_entries << " autotune cache entries from "
+          << path;
+  return num_entries;
+}
+
 }  // namespace phi::autotune
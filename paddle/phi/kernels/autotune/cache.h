@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
 
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/autotune/cache_base.h"
@@ -39,6 +40,13 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
                     const std::vector<int32_t>& perm,
                     phi::DataType dtype);
 
+// single_launch is the choice of ReduceConfig, the cached algorithm is 0 for
+// keeping it and 1 for the other choice.
+size_t ReduceKey(const std::vector<int>& x_dims,
+                 const std::vector<int>& reduce_dims,
+                 phi::DataType dtype,
+                 bool single_launch);
+
 enum class AlgorithmType {
   kConvForward = 1,
   kConvBackwardData = 2,
@@ -49,21 +57,22 @@ enum class AlgorithmType {
   kGatherGemmScatterFP32NN = 7,
   kGatherGemmScatterFP32TN = 8,
   kGatherGemmScatterFP32NT = 9,
+  kReduce = 10,
 #if !defined(PADDLE_WITH_CUDNN_FRONTEND)
-  kAlgorithmCount = 10
+  kAlgorithmCount = 11
 #else
-  kConvForwardV8 = 10,
-  kConvBackwardDataV8 = 11,
-  kConvBackwardFilterV8 = 12,
-  kScaleBiasReluConvBNstats = 13,
-  kBNFinalize = 14,
-  kScaleBiasAddRelu = 15,
-  kDgradDreluBnBwdWeight = 16,
-  kDbnApply = 17,
-  kBnActWgrad = 18,
-  kPoolingForwardV8 = 19,
-  kPoolingBackwardV8 = 20,
-  kAlgorithmCount = 21
+  kConvForwardV8 = 11,
+  kConvBackwardDataV8 = 12,
+  kConvBackwardFilterV8 = 13,
+  kScaleBiasReluConvBNstats = 14,
+  kBNFinalize = 15,
+  kScaleBiasAddRelu = 16,
+  kDgradDreluBnBwdWeight = 17,
+  kDbnApply = 18,
+  kBnActWgrad = 19,
+  kPoolingForwardV8 = 20,
+  kPoolingBackwardV8 = 21,
+  kAlgorithmCount = 22
 #endif
 };
 
@@ -151,6 +160,21 @@ class AutoTuneCache {
 
   void UpdateStatus();
 
+  // Serialize the tuned algorithms into a versioned file, so that they can be
+  // reused across process restarts and shared between machines with the same
+  // device environment. The cuDNN v8 execution plans and the cuBLASLt
+  // descriptors are pointer based and are not serialized.
+  bool SaveToFile(const std::string& path);
+
+  // Load the algorithms saved by SaveToFile. Files written by another format
+  // version or on a different device environment (see EnvFingerprint) are
+  // skipped. Returns the number of loaded entries, -1 if the file is invalid.
+  int64_t LoadFromFile(const std::string& path);
+
+  // A string identifying the device environment the tuned results depend on,
+  // e.g. GPU arch, driver, runtime and cuDNN versions.
+  static std::string EnvFingerprint();
+
   // The number of total config cached
   int64_t Size() const { return total_size_; }
 
@@ -16,6 +16,7 @@
 
 #include <mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "paddle/common/errors.h"
@@ -153,6 +154,13 @@ class AlgorithmsCache {
 
   int64_t Size() const { return hash_.size(); }
 
+  // Returns a snapshot of all cached entries, used for serialization.
+  std::vector<std::pair<KeyT, AlgorithmT>> Items() const {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    return std::vector<std::pair<KeyT, AlgorithmT>>(hash_.begin(),
+                                                    hash_.end());
+  }
+
  protected:
   std::unordered_map<KeyT, AlgorithmT, HashT, KeyEqualT> hash_;
   std::shared_ptr<std::mutex> cache_mutex_;
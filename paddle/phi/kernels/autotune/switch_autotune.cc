@@ -18,6 +18,7 @@
 #include "paddle/common/flags.h"
 
 COMMON_DECLARE_bool(use_autotune);
+COMMON_DECLARE_string(autotune_cache_file);
 
 namespace phi {
 namespace autotune {
@@ -39,6 +40,11 @@ void AutoTuneStatus::Update() {
     return;
   }
 
+  if (!cache_file_loaded_ && !FLAGS_autotune_cache_file.empty()) {
+    cache_file_loaded_ = true;
+    AutoTuneCache::Instance().LoadFromFile(FLAGS_autotune_cache_file);
+  }
+
   // This fuction is called when each iter finished.
   if (current_steps_id_ + 1 < start_step_id_) {
     use_autotune_ = false;
@@ -55,6 +61,11 @@ void AutoTuneStatus::Update() {
             << static_cast<int>(StepHitRate() * 100) << "%";
   } else {
     use_autotune_ = false;
+    if (current_steps_id_ + 1 == stop_step_id_ &&
+        !FLAGS_autotune_cache_file.empty()) {
+      // The tuning range just finished, write the tuned results back.
+      AutoTuneCache::Instance().SaveToFile(FLAGS_autotune_cache_file);
+    }
     // Set a small tolerance to avoid performance degradation
     // due to large cache size under dynamic shape.
     // TODO(limingshu): Currently works for conv op only, this
@@ -84,10 +84,12 @@ class AutoTuneStatus {
     previous_hits_ = 0;
     previous_misses_ = 0;
     step_hit_rates_.clear();
+    cache_file_loaded_ = false;
     AutoTuneCache::Instance().Clean();
   }
 
   bool use_autotune_{false};
+  bool cache_file_loaded_{false};
   int64_t start_step_id_{1};
   int64_t stop_step_id_{10};
   int64_t current_steps_id_{-1};
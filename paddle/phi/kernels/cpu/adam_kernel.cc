@@ -19,8 +19,12 @@
 #include "glog/logging.h"
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/cpu/adam_utils.h"
 #include "paddle/phi/kernels/funcs/adam_functors.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
 
@@ -53,6 +57,8 @@ void AdamDenseKernel(const Context& dev_ctx,
                      DenseTensor* beta2_pow_out,
                      DenseTensor* master_param_outs) {
   VLOG(4) << "use_global_beta_pow:" << use_global_beta_pow;
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  CheckAdamMasterParam<T, MT>(master_param, multi_precision);
 
   bool skip_update_ = false;
   if (skip_update.is_initialized()) {
@@ -72,6 +78,13 @@ void AdamDenseKernel(const Context& dev_ctx,
     phi::Copy(dev_ctx, param, dev_ctx.GetPlace(), false, param_out);
     phi::Copy(dev_ctx, moment1, dev_ctx.GetPlace(), false, moment1_out);
     phi::Copy(dev_ctx, moment2, dev_ctx.GetPlace(), false, moment2_out);
+    if (!std::is_same<T, MT>::value) {
+      phi::Copy(dev_ctx,
+                master_param.get(),
+                dev_ctx.GetPlace(),
+                false,
+                master_param_outs);
+    }
     if (!use_global_beta_pow) {
       phi::Copy(dev_ctx, beta1_pow, beta1_pow.place(), false, beta1_pow_out);
       phi::Copy(dev_ctx, beta2_pow, beta2_pow.place(), false, beta2_pow_out);
@@ -79,9 +92,9 @@ void AdamDenseKernel(const Context& dev_ctx,
     return;
   }
 
-  T beta1_ = beta1.to<T>();
-  T beta2_ = beta2.to<T>();
-  T epsilon_ = epsilon.to<T>();
+  MT beta1_ = beta1.to<MT>();
+  MT beta2_ = beta2.to<MT>();
+  MT epsilon_ = epsilon.to<MT>();
 
   VLOG(3) << "beta1_pow.numel() : " << beta1_pow.numel();
   VLOG(3) << "beta2_pow.numel() : " << beta2_pow.numel();
@@ -101,71 +114,57 @@ void AdamDenseKernel(const Context& dev_ctx,
                               "value is:%d.",
                               beta2_pow_out->numel()));
 
-  T beta1_p = beta1_pow.data<T>()[0];
-  T beta2_p = beta2_pow.data<T>()[0];
+  MT beta1_p = beta1_pow.data<MT>()[0];
+  MT beta2_p = beta2_pow.data<MT>()[0];
 
   if (!use_global_beta_pow) {
-    dev_ctx.template Alloc<T>(beta1_pow_out)[0] = beta1_ * beta1_p;
-    dev_ctx.template Alloc<T>(beta2_pow_out)[0] = beta2_ * beta2_p;
+    dev_ctx.template Alloc<MT>(beta1_pow_out)[0] = beta1_ * beta1_p;
+    dev_ctx.template Alloc<MT>(beta2_pow_out)[0] = beta2_ * beta2_p;
   }
 
   T* param_out_ptr = dev_ctx.template Alloc<T>(param_out);
-  T* mom1_out_ptr = dev_ctx.template Alloc<T>(moment1_out);
-  T* mom2_out_ptr = dev_ctx.template Alloc<T>(moment2_out);
+  MT* mom1_out_ptr = dev_ctx.template Alloc<MT>(moment1_out);
+  MT* mom2_out_ptr = dev_ctx.template Alloc<MT>(moment2_out);
 
-  T learning_rate_ =
-      learning_rate.data<T>()[0] * (sqrt(1 - beta2_p) / (1 - beta1_p));
-  T eps = epsilon_ * sqrt(1 - beta2_p);
+  MT learning_rate_ =
+      learning_rate.data<MT>()[0] * (sqrt(1 - beta2_p) / (1 - beta1_p));
+  MT eps = epsilon_ * sqrt(1 - beta2_p);
 
   phi::jit::adam_attr_t attr(beta1_, beta2_);
-  int64_t numel = param.numel();
-
-  const T* param_ptr = param.data<T>();
-  const T* mom1_ptr = moment1.data<T>();
-  const T* mom2_ptr = moment2.data<T>();
-  const T* grad_ptr = grad.data<T>();
+  const MT* mom1_ptr = moment1.data<MT>();
+  const MT* mom2_ptr = moment2.data<MT>();
+  const MT* master_ptr = nullptr;
+  MT* master_out_ptr = nullptr;
+  if constexpr (std::is_same<T, MT>::value) {
+    master_ptr = param.data<T>();
+    master_out_ptr = param_out_ptr;
+  } else {
+    master_ptr = master_param->data<MT>();
+    master_out_ptr = dev_ctx.template Alloc<MT>(master_param_outs);
+  }
 
   auto adam =
-      phi::jit::KernelFuncs<phi::jit::AdamTuple<T>, phi::CPUPlace>::Cache().At(
+      phi::jit::KernelFuncs<phi::jit::AdamTuple<MT>, phi::CPUPlace>::Cache().At(
           attr);
 
-  static constexpr int64_t chunk_size = 512;
-
-#ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < numel / chunk_size; ++i) {
-    const int64_t offset = i * chunk_size;
-    adam(beta1_,
-         beta2_,
-         -learning_rate_,
-         eps,
-         chunk_size,
-         grad_ptr + offset,
-         mom1_ptr + offset,
-         mom2_ptr + offset,
-         param_ptr + offset,
-         mom1_out_ptr + offset,
-         mom2_out_ptr + offset,
-         param_out_ptr + offset);
-  }
-
-  if (numel % chunk_size != 0) {
-    const int64_t offset = (numel / chunk_size) * chunk_size;
-    const int64_t tail_numel = numel % chunk_size;
-    adam(beta1_,
-         beta2_,
-         -learning_rate_,
-         eps,
-         tail_numel,
-         grad_ptr + offset,
-         mom1_ptr + offset,
-         mom2_ptr + offset,
-         param_ptr + offset,
-         mom1_out_ptr + offset,
-         mom2_out_ptr + offset,
-         param_out_ptr + offset);
-  }
+  AdamChunkedUpdate<T, MT>(
+      grad,
+      master_out_ptr,
+      param_out_ptr,
+      [&](const MT* chunk_grad, int64_t offset, int64_t size) {
+        adam(beta1_,
+             beta2_,
+             -learning_rate_,
+             eps,
+             size,
+             chunk_grad,
+             mom1_ptr + offset,
+             mom2_ptr + offset,
+             master_ptr + offset,
+             mom1_out_ptr + offset,
+             mom2_out_ptr + offset,
+             master_out_ptr + offset);
+      });
 }
 
 template <typename T, typename Context>
@@ -271,7 +270,22 @@ void MergedAdamKernel(
 
 }  // namespace phi
 
-PD_REGISTER_KERNEL(adam, CPU, ALL_LAYOUT, phi::AdamDenseKernel, float, double) {
+PD_REGISTER_KERNEL(adam,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::AdamDenseKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  if (kernel_key.dtype() == phi::DataType::FLOAT16 ||
+      kernel_key.dtype() == phi::DataType::BFLOAT16) {
+    kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+    kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+    kernel->OutputAt(3).SetDataType(phi::DataType::FLOAT32);
+    kernel->OutputAt(4).SetDataType(phi::DataType::FLOAT32);
+    kernel->OutputAt(5).SetDataType(phi::DataType::FLOAT32);
+  }
 }
 
 PD_REGISTER_KERNEL(
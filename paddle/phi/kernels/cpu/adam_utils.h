@@ -0,0 +1,95 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/utils/optional.h"
+
+namespace phi {
+
+// The elements a thread updates with the jit Adam or AdamW kernel at a time.
+static constexpr int64_t kAdamChunkSize = 512;
+
+template <typename T, typename MT, typename G, typename Update>
+void AdamChunkedUpdateImpl(int64_t numel,
+                           const G* grad,
+                           const MT* master_param_out,
+                           T* param_out,
+                           const Update& update) {
+  const int64_t num_chunks = (numel + kAdamChunkSize - 1) / kAdamChunkSize;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num_chunks; ++i) {
+    const int64_t offset = i * kAdamChunkSize;
+    const int64_t size = std::min(kAdamChunkSize, numel - offset);
+    if constexpr (std::is_same<G, MT>::value) {
+      update(grad + offset, offset, size);
+    } else {
+      MT chunk_grad[kAdamChunkSize];
+      for (int64_t j = 0; j < size; ++j) {
+        chunk_grad[j] = static_cast<MT>(grad[offset + j]);
+      }
+      update(chunk_grad, offset, size);
+    }
+    if constexpr (!std::is_same<T, MT>::value) {
+      for (int64_t j = 0; j < size; ++j) {
+        param_out[offset + j] = static_cast<T>(master_param_out[offset + j]);
+      }
+    }
+  }
+}
+
+// Runs update(grad, offset, size) over the chunks of a parameter in parallel.
+// The update reads and writes the parameter in MT. For a 16-bit parameter
+// that is its fp32 master parameter, the gradient of the chunk is converted
+// to MT first unless it is a fp32 main grad, and the parameter is cast from
+// the updated master parameter.
+template <typename T, typename MT, typename Update>
+void AdamChunkedUpdate(const DenseTensor& grad,
+                       const MT* master_param_out,
+                       T* param_out,
+                       const Update& update) {
+  if constexpr (!std::is_same<T, MT>::value) {
+    if (grad.dtype() == phi::CppTypeToDataType<MT>::Type()) {
+      AdamChunkedUpdateImpl<T, MT>(
+          grad.numel(), grad.data<MT>(), master_param_out, param_out, update);
+      return;
+    }
+  }
+  AdamChunkedUpdateImpl<T, MT>(
+      grad.numel(), grad.data<T>(), master_param_out, param_out, update);
+}
+
+// A 16-bit parameter is only updated on its fp32 master parameter.
+template <typename T, typename MT>
+void CheckAdamMasterParam(const paddle::optional<DenseTensor>& master_param,
+                          bool multi_precision) {
+  if constexpr (!std::is_same<T, MT>::value) {
+    PADDLE_ENFORCE_EQ(
+        multi_precision && master_param.get_ptr() != nullptr,
+        true,
+        errors::InvalidArgument(
+            "The CPU Adam and AdamW update 16-bit parameters on their fp32 "
+            "master parameters, please set multi_precision=True."));
+  }
+}
+
+}  // namespace phi
@@ -0,0 +1,210 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/kernels/cpu/conv_util.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+namespace phi {
+
+// The implicit gemm convolution computes the output of a 2D convolution by
+// tiles of output pixels, and only expands the input of the pixels of a tile
+// (im2col) into a column buffer which stays in the L2 cache, instead of
+// expanding the whole image like the im2col + gemm path does.
+struct ConvImplicitGemmBlocking {
+  int64_t tile_bytes;  // the max bytes of the column buffer of a tile
+  int64_t vec_size;    // the tile width is a multiple of this
+};
+
+inline ConvImplicitGemmBlocking GetConvImplicitGemmBlocking(int64_t type_size) {
+  // About half of the L2 cache of the common cores of each ISA, the other half
+  // is left for the filter and the output of a tile.
+#if defined(PADDLE_WITH_ARM)
+  return {256 * 1024, 16 / type_size};
+#else
+  using phi::backends::cpu::MayIUse;
+  if (MayIUse(phi::backends::cpu::avx512f)) {
+    return {512 * 1024, 64 / type_size};
+  } else if (MayIUse(phi::backends::cpu::avx)) {
+    return {128 * 1024, 32 / type_size};
+  }
+  return {128 * 1024, 16 / type_size};
+#endif
+}
+
+// Expands the input pixels of the output pixels [begin, begin + width) of a
+// group into col, a {ic * kh * kw, width} matrix.
+template <typename T>
+void ConvIm2ColTile(const T* input,
+                    int64_t channels,
+                    int64_t in_h,
+                    int64_t in_w,
+                    int64_t kernel_h,
+                    int64_t kernel_w,
+                    int64_t out_w,
+                    const std::vector<int>& strides,
+                    const std::vector<int>& paddings,
+                    const std::vector<int>& dilations,
+                    int64_t begin,
+                    int64_t width,
+                    T* col) {
+  for (int64_t c = 0; c < channels; ++c) {
+    const T* in_c = input + c * in_h * in_w;
+    for (int64_t ki = 0; ki < kernel_h; ++ki) {
+      for (int64_t kj = 0; kj < kernel_w; ++kj) {
+        T* dst = col + ((c * kernel_h + ki) * kernel_w + kj) * width;
+        // walk the output rows covered by the tile, so that there is no
+        // division for each pixel
+        int64_t t = 0;
+        while (t < width) {
+          const int64_t p = begin + t;
+          const int64_t oh = p / out_w;
+          const int64_t ow_begin = p % out_w;
+          const int64_t run = std::min(out_w - ow_begin, width - t);
+          const int64_t ih = oh * strides[0] - paddings[0] + ki * dilations[0];
+          if (ih < 0 || ih >= in_h) {
+            std::fill(dst + t, dst + t + run, static_cast<T>(0));
+          } else {
+            const T* in_row = in_c + ih * in_w;
+            int64_t iw =
+                ow_begin * strides[1] - paddings[2] + kj * dilations[1];
+            for (int64_t r = 0; r < run; ++r, iw += strides[1]) {
+              dst[t + r] =
+                  (iw >= 0 && iw < in_w) ? in_row[iw] : static_cast<T>(0);
+            }
+          }
+          t += run;
+        }
+      }
+    }
+  }
+}
+
+// Runs the 2D convolution of NCHW input by the implicit gemm if the column
+// buffer of the im2col path does not fit the cache, returns false if it is not
+// used and the im2col path should be used instead.
+template <typename T>
+bool ConvImplicitGemm(const CPUContext& dev_ctx,
+                      const DenseTensor& input,
+                      const DenseTensor& filter,
+                      const std::vector<int>& strides,
+                      const std::vector<int>& paddings_t,
+                      const std::string& padding_algorithm,
+                      int groups,
+                      const std::vector<int>& dilations_t,
+                      const std::string& data_format,
+                      DenseTensor* output) {
+  if (input.dims().size() != 4 || data_format == "NHWC" ||
+      data_format == "NDHWC") {
+    return false;
+  }
+  std::vector<int> paddings = paddings_t;
+  std::vector<int> dilations = dilations_t;
+  const auto& in_dims = input.dims();
+  const auto& filter_dims = filter.dims();
+  DDim in_data_dims = slice_ddim(in_dims, 2, in_dims.size());
+  DDim filter_data_dims = slice_ddim(filter_dims, 2, filter_dims.size());
+  std::vector<int> ksize = common::vectorize<int>(filter_data_dims);
+  UpdatePaddingAndDilation(
+      &paddings, &dilations, padding_algorithm, in_data_dims, strides, ksize);
+
+  const std::vector<int64_t> filter_shape_vec =
+      common::vectorize(filter_dims);
+  // 1x1 convolutions without stride and padding read the input directly
+  if (!IsExpand(filter_shape_vec, strides, paddings, dilations)) {
+    return false;
+  }
+
+  const int64_t batch_size = in_dims[0];
+  const int64_t in_c = in_dims[1] / groups;
+  const int64_t in_h = in_dims[2];
+  const int64_t in_w = in_dims[3];
+  const int64_t kernel_h = filter_dims[2];
+  const int64_t kernel_w = filter_dims[3];
+  const int64_t out_c = output->dims()[1] / groups;
+  const int64_t out_h = output->dims()[2];
+  const int64_t out_w = output->dims()[3];
+  const int64_t out_size = out_h * out_w;
+  const int64_t col_rows = in_c * kernel_h * kernel_w;
+
+  const ConvImplicitGemmBlocking blocking =
+      GetConvImplicitGemmBlocking(sizeof(T));
+  const int64_t col_bytes =
+      col_rows * out_size * static_cast<int64_t>(sizeof(T));
+  if (col_bytes <= 4 * blocking.tile_bytes) {
+    return false;
+  }
+  int64_t tile_w =
+      blocking.tile_bytes / (col_rows * static_cast<int64_t>(sizeof(T)));
+  tile_w = std::max(blocking.vec_size,
+                    tile_w / blocking.vec_size * blocking.vec_size);
+  tile_w = std::min(tile_w, out_size);
+
+  T* out_data = dev_ctx.template Alloc<T>(output);
+  const T* in_data = input.data<T>();
+  const T* filter_data = filter.data<T>();
+  DenseTensor col;
+  col.Resize({col_rows, tile_w});
+  T* col_data = dev_ctx.template Alloc<T>(&col);
+
+  auto blas = phi::funcs::GetBlas<CPUContext, T>(dev_ctx);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    for (int64_t g = 0; g < groups; ++g) {
+      const T* in_slice = in_data + (i * groups + g) * in_c * in_h * in_w;
+      const T* filter_slice = filter_data + g * out_c * col_rows;
+      T* out_slice = out_data + (i * groups + g) * out_c * out_size;
+      for (int64_t begin = 0; begin < out_size; begin += tile_w) {
+        const int64_t width = std::min(tile_w, out_size - begin);
+        ConvIm2ColTile<T>(in_slice,
+                          in_c,
+                          in_h,
+                          in_w,
+                          kernel_h,
+                          kernel_w,
+                          out_w,
+                          strides,
+                          paddings,
+                          dilations,
+                          begin,
+                          width,
+                          col_data);
+        // out[:, begin:begin + width] = filter * col
+        blas.GEMM(false,
+                  false,
+                  static_cast<int>(out_c),
+                  static_cast<int>(width),
+                  static_cast<int>(col_rows),
+                  static_cast<T>(1),
+                  filter_slice,
+                  static_cast<int>(col_rows),
+                  col_data,
+                  static_cast<int>(width),
+                  static_cast<T>(0),
+                  out_slice + begin,
+                  static_cast<int>(out_size));
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace phi
@@ -16,6 +16,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/cpu/conv_implicit_gemm.h"
 #include "paddle/phi/kernels/impl/conv_kernel_impl.h"
 
 namespace phi {
@@ -31,6 +32,18 @@ void ConvKernel(const Context& dev_ctx,
                 int groups,
                 const std::string& data_format,
                 DenseTensor* out) {
+  if (ConvImplicitGemm<T>(dev_ctx,
+                          input,
+                          filter,
+                          strides,
+                          paddings,
+                          padding_algorithm,
+                          groups,
+                          dilations,
+                          data_format,
+                          out)) {
+    return;
+  }
   ConvKernelImpl<T>(dev_ctx,
                     input,
                     filter,
@@ -54,6 +67,18 @@ void DepthwiseConvKernel(const Context& dev_ctx,
                          const std::vector<int>& dilations,
                          const std::string& data_format,
                          DenseTensor* out) {
+  if (ConvImplicitGemm<T>(dev_ctx,
+                          input,
+                          filter,
+                          strides,
+                          paddings,
+                          padding_algorithm,
+                          groups,
+                          dilations,
+                          data_format,
+                          out)) {
+    return;
+  }
   ConvKernelImpl<T>(dev_ctx,
                     input,
                     filter,
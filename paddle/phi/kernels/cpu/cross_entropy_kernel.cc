@@ -15,9 +15,11 @@ limitations under the License. */
 #include "paddle/phi/kernels/cross_entropy_kernel.h"
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/funcs/axis_utils.h"
+#include "paddle/phi/kernels/funcs/cpu_vec.h"
 #include "paddle/phi/kernels/funcs/cross_entropy.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/softmax_kernel.h"
@@ -68,7 +70,55 @@ void CrossEntropy(const CPUContext& dev_ctx,
       dev_ctx, &out_2d, &x_2d, &label_2d, soft_label, ignore_index, axis_dim);
 }
 
+// Softmax and hard label cross entropy over the last axis with one online
+// softmax of each row. The loss is taken from the max and sum of the row as
+// log(sum) - clip(x[label] - max, -64) rather than from the log of the
+// softmax output, which is the same value without a second pass.
+template <typename T, typename LabelT>
+void SoftmaxWithHardLabelCrossEntropy(const DenseTensor& logits,
+                                      const DenseTensor& label,
+                                      int ignore_index,
+                                      DenseTensor* softmax,
+                                      DenseTensor* loss) {
+  const int d = static_cast<int>(logits.dims()[logits.dims().size() - 1]);
+  const int n = static_cast<int>(logits.numel() / d);
+  const T* x = logits.data<T>();
+  const LabelT* label_data = label.data<LabelT>();
+  T* y = softmax->data<T>();
+  T* loss_data = loss->data<T>();
+  std::vector<T> block_max(phi::funcs::softmax_num_blocks(d));
+  const bool use_avx = phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  for (int i = 0; i < n; ++i) {
+    T max_val, sum;
+    if (use_avx) {
+      phi::funcs::vec_softmax<T, phi::backends::cpu::avx>(
+          d, x, y, block_max.data(), &max_val, &sum);
+    } else {
+      phi::funcs::vec_softmax<T>(d, x, y, block_max.data(), &max_val, &sum);
+    }
+    const int lbl = static_cast<int>(label_data[i]);
+    if (lbl == ignore_index) {
+      loss_data[i] = 0;
+    } else {
+      PADDLE_ENFORCE_EQ(
+          lbl >= 0 && lbl < d,
+          true,
+          common::errors::OutOfRange(
+              "label value should be in [0, %d) when label value(%d) not "
+              "equal to ignore_index(%d).",
+              d,
+              lbl,
+              ignore_index));
+      loss_data[i] =
+          std::log(sum) - std::max(x[lbl] - max_val, static_cast<T>(-64));
+    }
+    x += d;
+    y += d;
+  }
+}
+
 template <typename T, typename Context>
+void CrossEntropyWithSoftmaxKernel(template <typename T, typename Context>
 void CrossEntropyWithSoftmaxKernel(const Context& dev_ctx,
                                    const DenseTensor& logits,
                                    const DenseTensor& label,
@@ -88,6 +138,23 @@ void CrossEntropyWithSoftmaxKernel(const Context& dev_ctx,
     return;
   }
 
+  const int rank = logits.dims().size();
+  if (!soft_label && rank > 0 && logits.numel() > 0 &&
+      phi::funcs::CanonicalAxis(axis, rank) == rank - 1 &&
+      label.numel() * logits.dims()[rank - 1] == logits.numel() &&
+      (label.dtype() == DataType::INT64 || label.dtype() == DataType::INT32)) {
+    dev_ctx.template Alloc<T>(softmax);
+    dev_ctx.template Alloc<T>(loss);
+    if (label.dtype() == DataType::INT64) {
+      SoftmaxWithHardLabelCrossEntropy<T, int64_t>(
+          logits, label, ignore_index, softmax, loss);
+    } else {
+      SoftmaxWithHardLabelCrossEntropy<T, int>(
+          logits, label, ignore_index, softmax, loss);
+    }
+    return;
+  }
+
   phi::SoftmaxKernel<T, Context>(dev_ctx, logits, axis, softmax);
   CrossEntropy<T>(
       dev_ctx, *softmax, label, soft_label, ignore_index, axis, loss);
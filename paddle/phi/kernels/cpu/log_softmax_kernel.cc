@@ -15,8 +15,10 @@
 #include "paddle/phi/kernels/log_softmax_kernel.h"
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/axis_utils.h"
+#include "paddle/phi/kernels/funcs/cpu_vec.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -58,6 +60,27 @@ struct LogSoftmaxFunctor {
     const int num_classes = logits.dimension(kClassDim);
     const int num_remain = num_classes / axis_dim;
 
+    if (num_remain == 1) {
+      // axis == -1, log_softmax of each row by the online softmax
+      const T* in_data = X->data<T>();
+      T* out_data = Y->data<T>();
+      std::vector<T> block_max(funcs::softmax_num_blocks(num_classes));
+      const bool use_avx =
+          phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+      for (int bs = 0; bs < batch_size; ++bs) {
+        if (use_avx) {
+          funcs::vec_log_softmax<T, phi::backends::cpu::avx>(
+              num_classes, in_data, out_data, block_max.data());
+        } else {
+          funcs::vec_log_softmax<T>(
+              num_classes, in_data, out_data, block_max.data());
+        }
+        in_data += num_classes;
+        out_data += num_classes;
+      }
+      return;
+    }
+
     Eigen::DSizes<int, 1> along_axis(kAxisDim);
     Eigen::DSizes<int, 2> batch_classes(batch_size, num_classes);
     Eigen::DSizes<int, 2> batch_by_one(batch_size, 1);
@@ -76,7 +76,13 @@ void UniqueRawKernel(const Context& context,
   if (!is_sorted) {
     phi::VisitDataType(
         dtype,
-        phi::funcs::UniqueOpFunctor<Context, T>(context, out, index, &x));
+        phi::funcs::UniqueOpFunctor<Context, T>(
+            context,
+            out,
+            index,
+            &x,
+            return_counts ? counts : nullptr,
+            return_index ? indices : nullptr));
     return;
   }
 
@@ -23,4 +23,12 @@ void DecodeJpegKernel(const Context& dev_ctx,
                       const DenseTensor& x,
                       const std::string& mode,
                       DenseTensor* out);
+
+// Decodes the images of x in a batch, on the NVJPG engines of the GPUs that
+// have them and support all the images.
+template <typename T, typename Context>
+void DecodeJpegBatchKernel(const Context& dev_ctx,
+                           const std::vector<const DenseTensor*>& x,
+                           const std::string& mode,
+                           std::vector<DenseTensor*> out);
 }  // namespace phi
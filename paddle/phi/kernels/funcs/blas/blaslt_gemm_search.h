@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #include <glog/logging.h>
+#include <fstream>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -32,6 +33,7 @@ limitations under the License. */
 #include "paddle/phi/core/allocator.h"
 
 COMMON_DECLARE_string(cublaslt_device_best_config);
+COMMON_DECLARE_string(cublaslt_algo_cache_file);
 
 namespace phi {
 namespace funcs {
@@ -50,10 +52,12 @@ struct CublasLtAlgoConfig {
   int split_k_val;
   int reduction_scheme;
   int stages;
+  size_t workspace_size;
 };
 
 struct CublasLtAlgoSelectorParam {
   float time{0.0};
+  size_t workspace_size{0};
   cublasLtMatmulAlgo_t algo;
   CublasLtAlgoConfig algo_config;
 };
@@ -103,6 +107,7 @@ class CublasLtAlgoCache {
       return;
     }
     size_t workspace_size = heuristic_result.workspaceSize;
+    param.workspace_size = workspace_size;
     auto workspace = phi::memory_utils::Alloc(
         phi::GPUPlace(phi::backends::gpu::GetCurrentDeviceId()),
         workspace_size,
@@ -175,14 +180,8 @@ class CublasLtAlgoCache {
 
     // VLOG(0) << "m n k: " << m << " " << n << " " << k;
 
-    int64_t seed = 0;
-    std::hash<int64_t> hash_fn;
-
-    HashMatmulDesc(matmul_desc, &seed, hash_fn);
-    HashMatrixLayoutDesc(a_desc, &seed, hash_fn);
-    HashMatrixLayoutDesc(b_desc, &seed, hash_fn);
-    HashMatrixLayoutDesc(bias_desc, &seed, hash_fn);
-    HashMatrixLayoutDesc(c_desc, &seed, hash_fn);
+    const int64_t seed =
+        HashDescs(matmul_desc, a_desc, b_desc, bias_desc, c_desc);
 
     {
       std::lock_guard<std::mutex> lock(cache_mutex_);
@@ -197,7 +196,6 @@ class CublasLtAlgoCache {
       std::string config_file_path = FLAGS_cublaslt_device_best_config;
       infile.open(config_file_path.c_str());
       if (infile.is_open()) {
-        size_t workspace_size;
         float time;
         char comma;
         while (!infile.eof()) {
@@ -208,7 +206,7 @@ class CublasLtAlgoCache {
               comma >> search_config.tile >> comma >>
               search_config.split_k_val >> comma >>
               search_config.reduction_scheme >> comma >> search_config.stages >>
-              comma >> workspace_size >> comma >> time;
+              comma >> search_config.workspace_size >> comma >> time;
           search_configs_.push_back(search_config);
         }
         infile.close();
@@ -267,6 +265,8 @@ class CublasLtAlgoCache {
                 sizeof(search_config.stages)));
         std::lock_guard<std::mutex> lock(cache_mutex_);
         algo_caches_[seed] = algo;
+        algo_workspaces_[seed] = search_config.workspace_size;
+        ++unsaved_num_;
         return &algo_caches_[seed];
       };
       const CublasLtAlgoConfig* pre = nullptr;
@@ -596,24 +596,62 @@ class CublasLtAlgoCache {
 
     VLOG(3) << "algo selected";
 
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      algo_caches_[seed] = params[res_id].algo;
+      algo_workspaces_[seed] = params[res_id].workspace_size;
+      ++unsaved_num_;
+    }
+    // written in batches rather than at exit only, so most of the results of
+    // an offline tuning are kept even if the process does not exit normally
+    SerializeAlgoCachesToFile(kSerializeBatchSize);
     std::lock_guard<std::mutex> lock(cache_mutex_);
-    algo_caches_[seed] = params[res_id].algo;
     return &algo_caches_[seed];
   }
 
+  // Returns the algo of the descriptors in the cache without any search, or
+  // nullptr if they are not in it. It replays the cache file of
+  // FLAGS_cublaslt_algo_cache_file.
+  cublasLtMatmulAlgo_t* LookupAlgo(cublasLtMatmulDesc_t matmul_desc,
+                                   cublasLtMatrixLayout_t a_desc,
+                                   cublasLtMatrixLayout_t b_desc,
+                                   cublasLtMatrixLayout_t bias_desc,
+                                   cublasLtMatrixLayout_t c_desc) {
+    if (!has_config_file_) {
+      return nullptr;
+    }
+    const int64_t seed =
+        HashDescs(matmul_desc, a_desc, b_desc, bias_desc, c_desc);
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto iter = algo_caches_.find(seed);
+    return iter == algo_caches_.end() ? nullptr : &iter->second;
+  }
+
+  // Whether the algos in the cache file are used without the global search.
+  bool UseCacheFile() const {
+    return !FLAGS_cublaslt_algo_cache_file.empty() && has_config_file_;
+  }
+
   ~CublasLtAlgoCache() { SerializeAlgoCachesToFile(); }
 
  private:
   std::string algo_caches_file_{"./cublaslt_algo_caches_from_paddle"};
   std::unordered_map<int64_t, cublasLtMatmulAlgo_t> algo_caches_;
+  std::unordered_map<int64_t, size_t> algo_workspaces_;
   std::vector<CublasLtAlgoConfig> search_configs_;
   int search_times_;
   static constexpr int requested_algo_count_ = 100;
   std::mutex cache_mutex_;
   bool has_config_file_;
+  // the number of algos not written to the cache file yet
+  int unsaved_num_{0};
+  static constexpr int kSerializeBatchSize = 16;
 
   explicit CublasLtAlgoCache(int search_times)
       : search_times_(search_times), has_config_file_(true) {
+    if (!FLAGS_cublaslt_algo_cache_file.empty()) {
+      algo_caches_file_ = FLAGS_cublaslt_algo_cache_file;
+    }
     // Init algo_caches_ from cache file
     std::ifstream infile;
     infile.open(algo_caches_file_);
@@ -622,53 +660,97 @@ class CublasLtAlgoCache {
       VLOG(3) << "No CublasLtAlgoCache file found";
       return;
     }
-    size_t cublaslt_version = 0, real_cublaslt_version = 0;
-    int64_t seed = 0;
-    std::array<uint64_t, 8> algo_data;
-    infile >> cublaslt_version;
-    VLOG(1) << "cublaslt_version " << cublaslt_version;
-
-    if (dynload::cublasLtGetCudartVersion() != cublaslt_version) {
+    // The first line is the cudart version and the device architecture the
+    // file is tuned on, files without the architecture are still accepted.
+    std::string line;
+    std::getline(infile, line);
+    std::istringstream header(line);
+    size_t cublaslt_version = 0;
+    int arch = -1;
+    header >> cublaslt_version >> arch;
+    VLOG(1) << "cublaslt_version " << cublaslt_version << " arch " << arch;
+
+    const size_t real_cublaslt_version = dynload::cublasLtGetCudartVersion();
+    const int real_arch = phi::backends::gpu::GetGPUComputeCapability(
+        phi::backends::gpu::GetCurrentDeviceId());
+    if (real_cublaslt_version != cublaslt_version ||
+        (arch >= 0 && arch != real_arch)) {
       LOG(INFO) << algo_caches_file_
                 << " is not compatible with current cublaslt_version "
-                << real_cublaslt_version;
+                << real_cublaslt_version << " and arch " << real_arch;
+      has_config_file_ = false;
       return;
     }
 
-    while (!infile.eof()) {
-      infile >> seed >> algo_data[0] >> algo_data[1] >> algo_data[2] >>
-          algo_data[3] >> algo_data[4] >> algo_data[5] >> algo_data[6] >>
-          algo_data[7];
-
+    int64_t seed = 0;
+    std::array<uint64_t, 8> algo_data;
+    while (std::getline(infile, line)) {
+      std::istringstream entry(line);
+      if (!(entry >> seed >> algo_data[0] >> algo_data[1] >> algo_data[2] >>
+            algo_data[3] >> algo_data[4] >> algo_data[5] >> algo_data[6] >>
+            algo_data[7])) {
+        continue;
+      }
       for (int i = 0; i < 8; ++i) {
         algo_caches_[seed].data[i] = algo_data[i];
       }
+      size_t workspace_size = 0;
+      if (entry >> workspace_size) {
+        algo_workspaces_[seed] = workspace_size;
+      }
     }
     infile.close();
+    VLOG(3) << "Loaded " << algo_caches_.size() << " algos from "
+            << algo_caches_file_;
   }
 
-  // Serialize algo_caches_ to cache file
-  void SerializeAlgoCachesToFile() {
+  // Serialize algo_caches_ to cache file if at least min_unsaved_num algos
+  // are not written to it yet
+  void SerializeAlgoCachesToFile(int min_unsaved_num = 1) {
     if (search_times_ > 0) {
       int dev;
       cudaGetDevice(&dev);
-      if (dev == 0) {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      if (dev == 0 && unsaved_num_ >= min_unsaved_num) {
         std::ofstream outfile;
         outfile.open(algo_caches_file_, std::ios::out | std::ios::trunc);
-        outfile << dynload::cublasLtGetCudartVersion() << std::endl;
+        outfile << dynload::cublasLtGetCudartVersion() << " "
+                << phi::backends::gpu::GetGPUComputeCapability(dev)
+                << std::endl;
 
         for (const auto& [seed, algo] : algo_caches_) {
           outfile << seed << " ";
           for (size_t value : algo.data) {
             outfile << value << " ";
           }
-          outfile << std::endl;
+          auto workspace_iter = algo_workspaces_.find(seed);
+          outfile << (workspace_iter == algo_workspaces_.end()
+                          ? 0
+                          : workspace_iter->second)
+                  << std::endl;
         }
         outfile.close();
+        unsaved_num_ = 0;
       }
     }
   }
 
+  int64_t HashDescs(cublasLtMatmulDesc_t matmul_desc,
+                    cublasLtMatrixLayout_t a_desc,
+                    cublasLtMatrixLayout_t b_desc,
+                    cublasLtMatrixLayout_t bias_desc,
+                    cublasLtMatrixLayout_t c_desc) {
+    int64_t seed = 0;
+    std::hash<int64_t> hash_fn;
+
+    HashMatmulDesc(matmul_desc, &seed, hash_fn);
+    HashMatrixLayoutDesc(a_desc, &seed, hash_fn);
+    HashMatrixLayoutDesc(b_desc, &seed, hash_fn);
+    HashMatrixLayoutDesc(bias_desc, &seed, hash_fn);
+    HashMatrixLayoutDesc(c_desc, &seed, hash_fn);
+    return seed;
+  }
+
   inline int64_t RoundToNextHighPowOfTwo(int64_t n, int64_t min_val) {
     n--;
     n |= (n >> 1);
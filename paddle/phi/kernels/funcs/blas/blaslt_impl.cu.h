@@ -32,6 +32,7 @@ limitations under the License. */
 
 COMMON_DECLARE_int64(cublaslt_exhaustive_search_times);
 COMMON_DECLARE_bool(enable_blaslt_global_search);
+COMMON_DECLARE_string(cublaslt_algo_cache_file);
 #endif
 
 namespace phi {
@@ -199,6 +200,8 @@ struct MatmulDescriptor {
   cublasLtMatrixLayout_t out_desc{nullptr};
   cublasLtMatmulAlgo_t* algo{nullptr};
   bool is_cached{false};
+  // The workspace the algo needs, 0 means the default one is enough.
+  size_t workspace_size{0};
   int64_t M_{-1};
   int64_t N_{-1};
   int64_t K_{-1};
@@ -216,6 +219,7 @@ struct MatmulDescriptor {
     op_desc = obj.op_desc;
     out_desc = obj.out_desc;
     is_cached = obj.is_cached;
+    workspace_size = obj.workspace_size;
   }
 
   MatmulDescriptor& operator=(const MatmulDescriptor& obj) {
@@ -225,6 +229,7 @@ struct MatmulDescriptor {
     op_desc = obj.op_desc;
     out_desc = obj.out_desc;
     is_cached = obj.is_cached;
+    workspace_size = obj.workspace_size;
 
     return *this;
   }
@@ -469,6 +474,50 @@ struct MatmulGradDescriptor : MatmulDescriptor {
   }
 };
 
+// Returns the algo of desc replayed from FLAGS_cublaslt_algo_cache_file, or
+// nullptr if the file is not used or has no algo for it.
+template <class MatmulDescT>
+cublasLtMatmulAlgo_t* LookupCacheFileAlgo(const MatmulDescT& desc) {
+  auto& algo_cache = cublaslt_internal::CublasLtAlgoCache::Instance();
+  if (!algo_cache.UseCacheFile()) {
+    return nullptr;
+  }
+  return algo_cache.LookupAlgo(desc.op_desc,
+                               desc.y_desc,
+                               desc.x_desc,
+                               desc.out_desc,
+                               desc.out_desc);
+}
+
+// Sets the algo of desc to a cached algo and the workspace size it needs.
+// Returns false if algo is nullptr or cublasLt does not support it for desc.
+template <class MatmulDescT>
+bool SetCachedAlgo(const phi::GPUContext& ctx,
+                   MatmulDescT* desc,
+                   const cublasLtMatmulAlgo_t* algo) {
+  if (algo == nullptr) {
+    return false;
+  }
+  // The algo may be tuned for other descriptors with the same hash, or by
+  // another version of cublasLt, so check it before using it.
+  cublasLtMatmulHeuristicResult_t heur_result;
+  if (dynload::cublasLtMatmulAlgoCheck(ctx.cublaslt_handle(),
+                                       desc->op_desc,
+                                       desc->y_desc,
+                                       desc->x_desc,
+                                       desc->out_desc,
+                                       desc->out_desc,
+                                       algo,
+                                       &heur_result) != CUBLAS_STATUS_SUCCESS) {
+    VLOG(3) << "The cached cublaslt algo is not supported, skip it.";
+    return false;
+  }
+  cublasLtMatmulAlgo_t* best_algo = desc->SetAlgo();
+  *best_algo = *algo;
+  desc->workspace_size = heur_result.workspaceSize;
+  return true;
+}
+
 template <typename T, typename OutT = T, class MatmulDescT = MatmulDescriptor>
 struct CublasLtBase {
  public:
@@ -496,6 +545,24 @@ struct CublasLtBase {
     // I wonder is there any smarter idea for workspace setting, currently I
     // just followed the settings from the NVIDIA colleague`s setting.
     size_t workspace_size = static_cast<size_t>(4) * 1024 * 1024;
+
+    if (planner != nullptr && !desc->is_cached &&
+        SetAlgoFromGlobalCache(ctx,
+                               desc,
+                               static_cast<void*>(&alpha),
+                               static_cast<void*>(&beta),
+                               y_ptr,
+                               x_ptr,
+                               out_ptr,
+                               CanSearchGlobal(planner))) {
+      MatmulDescT* best_desc = new MatmulDescT(*desc);
+      VLOG(6) << best_desc->GetDescResultString(
+          "[Global CublasltDescriptor] ");
+
+      auto& cache = phi::autotune::AutoTuneCache::Instance().GetMatmul();
+      cache.SetSubKey(sub_key, reinterpret_cast<void*>(best_desc));
+    }
+    workspace_size = std::max(workspace_size, desc->workspace_size);
     phi::Allocator::AllocationPtr workspace = GetWorkspace(ctx, workspace_size);
 
     if (planner != nullptr) {
@@ -540,6 +607,63 @@ struct CublasLtBase {
                                 ctx.stream()));
   }
 
+  // The global search runs the gemm in place many times, so it is skipped if
+  // the output is accumulated, and for the grad descriptors whose shapes and
+  // types are not recorded.
+  static bool CanSearchGlobal(phi::funcs::MatmulPlanner* planner) {
+    return std::is_same<MatmulDescT, MatmulDescriptor>::value &&
+           !planner->UseAddTo();
+  }
+
+  // Sets the algo of desc from the global search of CublasLtAlgoCache if
+  // FLAGS_enable_blaslt_global_search is on and searching is allowed,
+  // otherwise from the algos replayed from FLAGS_cublaslt_algo_cache_file.
+  // Returns false if there is no such algo.
+  static bool SetAlgoFromGlobalCache(const phi::GPUContext& ctx,
+                                     MatmulDescT* desc,
+                                     const void* alpha,
+                                     const void* beta,
+                                     const T* y_data,
+                                     const T* x_data,
+                                     OutT* out_data,
+                                     bool can_search) {
+    const bool global_search = FLAGS_enable_blaslt_global_search && can_search;
+    if (!global_search && FLAGS_cublaslt_algo_cache_file.empty()) {
+      return false;
+    }
+    auto& algo_cache = cublaslt_internal::CublasLtAlgoCache::Instance();
+    cublasLtMatmulAlgo_t* algo = nullptr;
+    if (global_search) {
+      OutT* bias_ptr = nullptr;
+      algo = algo_cache.CublasLtAlgoSelect(ctx.cublaslt_handle(),
+                                           desc->M_,
+                                           desc->N_,
+                                           desc->K_,
+                                           1,
+                                           y_data,
+                                           x_data,
+                                           bias_ptr,
+                                           out_data,
+                                           const_cast<void*>(alpha),
+                                           const_cast<void*>(beta),
+                                           desc->op_desc,
+                                           desc->y_desc,
+                                           desc->x_desc,
+                                           desc->out_desc,
+                                           desc->out_desc,
+                                           desc->compute_type_,
+                                           desc->scale_type_,
+                                           desc->y_type_,
+                                           desc->x_type_,
+                                           desc->out_type_,
+                                           desc->out_type_,
+                                           ctx.stream());
+    } else {
+      algo = LookupCacheFileAlgo(*desc);
+    }
+    return SetCachedAlgo(ctx, desc, algo);
+  }
+
   static void SearchBestAlgo(const phi::GPUContext& ctx,
                              const cublasLtHandle_t& lt_handle,
                              MatmulDescT* desc,
@@ -711,7 +835,18 @@ struct CublasLtBase<int8_t, int32_t, MatmulDescriptor> {
 
       auto& cache = phi::autotune::AutoTuneCache::Instance().GetMatmul();
       cache.SetSubKey(sub_key, reinterpret_cast<void*>(best_desc));
+    } else if (!desc->is_cached && !FLAGS_cublaslt_algo_cache_file.empty() &&
+               SetCachedAlgo(ctx, desc, LookupCacheFileAlgo(*desc))) {
+      MatmulDescriptor* best_desc = new MatmulDescriptor(*desc);
+      VLOG(6) << best_desc->GetDescResultString(
+          "[Global CublasltDescriptor] ");
+
+      auto& cache = phi::autotune::AutoTuneCache::Instance().GetMatmul();
+      cache.SetSubKey(sub_key, reinterpret_cast<void*>(best_desc));
+      workspace_size = std::max(workspace_size, desc->workspace_size);
+      workspace = GetWorkspace(ctx, workspace_size);
     } else {
+      workspace_size = std::max(workspace_size, desc->workspace_size);
       workspace = GetWorkspace(ctx, workspace_size);
       if (phi::autotune::AutoTuneStatus::Instance().UseAutoTune() &&
           (!desc->is_cached)) {
@@ -820,6 +955,7 @@ struct CublasLtBase<int8_t, int32_t, MatmulDescriptor> {
       cublasLtMatmulAlgo_t* best_algo = desc->SetAlgo();
       *best_algo = *algo;
       workspace_size = heurResult.workspaceSize;
+      desc->workspace_size = workspace_size;
       workspace = GetWorkspace(ctx, workspace_size);
     }
   }
@@ -0,0 +1,314 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/block_manager.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace funcs {
+
+BlockManager::BlockManager(int num_blocks, int block_size)
+    : block_size_(block_size), blocks_(num_blocks) {
+  PADDLE_ENFORCE_GT(num_blocks,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The number of blocks must be positive, but got %d.",
+                        num_blocks));
+  PADDLE_ENFORCE_GT(block_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The block size must be positive, but got %d.",
+                        block_size));
+  // the low ids are taken first
+  free_blocks_.reserve(num_blocks);
+  for (int i = num_blocks - 1; i >= 0; --i) {
+    free_blocks_.push_back(i);
+  }
+}
+
+uint64_t BlockManager::HashBlock(uint64_t parent_hash,
+                                 const int64_t* tokens,
+                                 int num_tokens) const {
+  uint64_t hash = parent_hash;
+  for (int i = 0; i < num_tokens; ++i) {
+    hash ^= std::hash<int64_t>()(tokens[i]) + 0x9e3779b97f4a7c15ULL +
+            (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+int BlockManager::FindCached(uint64_t parent_hash,
+                             const int64_t* tokens) const {
+  uint64_t hash = HashBlock(parent_hash, tokens, block_size_);
+  auto range = cached_blocks_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Block& block = blocks_[it->second];
+    // the tokens are compared too, a collision must not mix up the kv
+    if (block.parent_hash == parent_hash &&
+        std::equal(block.tokens.begin(), block.tokens.end(), tokens)) {
+      return it->second;
+    }
+  }
+  return -1;
+}
+
+int BlockManager::TakeBlock() {
+  int block_id = -1;
+  if (!free_blocks_.empty()) {
+    block_id = free_blocks_.back();
+    free_blocks_.pop_back();
+  } else {
+    PADDLE_ENFORCE_EQ(evictable_blocks_.empty(),
+                      false,
+                      common::errors::ResourceExhausted(
+                          "All the %d kv cache blocks are used.",
+                          blocks_.size()));
+    block_id = evictable_blocks_.front();
+    evictable_blocks_.pop_front();
+    Block& block = blocks_[block_id];
+    auto range = cached_blocks_.equal_range(block.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == block_id) {
+        cached_blocks_.erase(it);
+        break;
+      }
+    }
+    block = Block();
+  }
+  blocks_[block_id].ref_count = 1;
+  return block_id;
+}
+
+void BlockManager::Ref(int block_id) {
+  Block& block = blocks_[block_id];
+  if (block.ref_count == 0 && block.cached) {
+    evictable_blocks_.erase(block.evictable_pos);
+  }
+  ++block.ref_count;
+}
+
+void BlockManager::Unref(int block_id) {
+  Block& block = blocks_[block_id];
+  if (--block.ref_count > 0) {
+    return;
+  }
+  if (block.cached) {
+    block.evictable_pos =
+        evictable_blocks_.insert(evictable_blocks_.end(), block_id);
+  } else {
+    free_blocks_.push_back(block_id);
+  }
+}
+
+void BlockManager::CacheBlock(Sequence* seq, int index) {
+  // the parent hash is the one of the sequence, the block before may be
+  // uncached and hold no hash
+  uint64_t parent_hash = index == 0 ? 0 : seq->hashes[index - 1];
+  const int64_t* tokens = seq->tokens.data() + index * block_size_;
+  uint64_t hash = HashBlock(parent_hash, tokens, block_size_);
+  seq->hashes.push_back(hash);
+  int block_id = seq->blocks[index];
+  Block& block = blocks_[block_id];
+  if (block.cached) {
+    return;
+  }
+  if (FindCached(parent_hash, tokens) != -1) {
+    // the same tokens are cached by another block, which is found first, the
+    // block is then only used by the sequence
+    return;
+  }
+  block.cached = true;
+  block.parent_hash = parent_hash;
+  block.hash = hash;
+  block.tokens.assign(tokens, tokens + block_size_);
+  cached_blocks_.emplace(block.hash, block_id);
+}
+
+int BlockManager::NumNewBlocks(const Sequence& seq, int num_tokens) const {
+  int length = static_cast<int>(seq.tokens.size());
+  int num_blocks = (length + num_tokens + block_size_ - 1) / block_size_ -
+                   static_cast<int>(seq.blocks.size());
+  // a shared last block which is not full is copied before it is written
+  if (length % block_size_ != 0 && num_tokens > 0 &&
+      blocks_[seq.blocks.back()].ref_count > 1) {
+    ++num_blocks;
+  }
+  return num_blocks;
+}
+
+const BlockManager::Sequence& BlockManager::GetSequence(
+    int64_t seq_id) const {
+  auto it = seqs_.find(seq_id);
+  PADDLE_ENFORCE_NE(
+      it,
+      seqs_.end(),
+      common::errors::NotFound("The sequence %d is not found.", seq_id));
+  return it->second;
+}
+
+bool BlockManager::AddSequence(int64_t seq_id,
+                               const std::vector<int64_t>& token_ids) {
+  PADDLE_ENFORCE_EQ(
+      seqs_.count(seq_id),
+      0,
+      common::errors::AlreadyExists("The sequence %d is already added.",
+                                    seq_id));
+  PADDLE_ENFORCE_GT(token_ids.size(),
+                    0,
+                    common::errors::InvalidArgument(
+                        "The prompt of the sequence %d is empty.", seq_id));
+  int length = static_cast<int>(token_ids.size());
+  // the last token is computed to get the first output token
+  int max_cached_blocks = (length - 1) / block_size_;
+  std::vector<int> cached;
+  int num_evictable_cached = 0;
+  uint64_t parent_hash = 0;
+  for (int i = 0; i < max_cached_blocks; ++i) {
+    int block_id = FindCached(parent_hash, token_ids.data() + i * block_size_);
+    if (block_id == -1) {
+      break;
+    }
+    cached.push_back(block_id);
+    parent_hash = blocks_[block_id].hash;
+    if (blocks_[block_id].ref_count == 0) {
+      ++num_evictable_cached;
+    }
+  }
+  int num_blocks = (length + block_size_ - 1) / block_size_;
+  int num_new_blocks = num_blocks - static_cast<int>(cached.size());
+  if (num_new_blocks > NumFreeBlocks() - num_evictable_cached) {
+    return false;
+  }
+
+  Sequence& seq = seqs_[seq_id];
+  seq.tokens = token_ids;
+  seq.cached_length = static_cast<int>(cached.size()) * block_size_;
+  for (int block_id : cached) {
+    Ref(block_id);
+    seq.blocks.push_back(block_id);
+    seq.hashes.push_back(blocks_[block_id].hash);
+  }
+  while (static_cast<int>(seq.blocks.size()) < num_blocks) {
+    seq.blocks.push_back(TakeBlock());
+  }
+  for (int i = static_cast<int>(cached.size()); i < length / block_size_;
+       ++i) {
+    CacheBlock(&seq, i);
+  }
+  return true;
+}
+
+bool BlockManager::Append(int64_t seq_id,
+                          const std::vector<int64_t>& token_ids) {
+  auto it = seqs_.find(seq_id);
+  PADDLE_ENFORCE_NE(
+      it,
+      seqs_.end(),
+      common::errors::NotFound("The sequence %d is not found.", seq_id));
+  Sequence& seq = it->second;
+  if (NumNewBlocks(seq, static_cast<int>(token_ids.size())) >
+      NumFreeBlocks()) {
+    return false;
+  }
+  int length = static_cast<int>(seq.tokens.size());
+  if (length % block_size_ != 0 && !token_ids.empty() &&
+      blocks_[seq.blocks.back()].ref_count > 1) {
+    int src = seq.blocks.back();
+    int dst = TakeBlock();
+    copies_.emplace_back(src, dst);
+    Unref(src);
+    seq.blocks.back() = dst;
+  }
+  seq.tokens.insert(seq.tokens.end(), token_ids.begin(), token_ids.end());
+  int new_length = static_cast<int>(seq.tokens.size());
+  while (static_cast<int>(seq.blocks.size()) * block_size_ < new_length) {
+    seq.blocks.push_back(TakeBlock());
+  }
+  for (int i = length / block_size_; i < new_length / block_size_; ++i) {
+    CacheBlock(&seq, i);
+  }
+  return true;
+}
+
+void BlockManager::Fork(int64_t parent, int64_t child) {
+  PADDLE_ENFORCE_EQ(
+      seqs_.count(child),
+      0,
+      common::errors::AlreadyExists("The sequence %d is already added.",
+                                    child));
+  Sequence seq = GetSequence(parent);
+  for (int block_id : seq.blocks) {
+    Ref(block_id);
+  }
+  seqs_.emplace(child, std::move(seq));
+}
+
+void BlockManager::Free(int64_t seq_id) {
+  auto it = seqs_.find(seq_id);
+  PADDLE_ENFORCE_NE(
+      it,
+      seqs_.end(),
+      common::errors::NotFound("The sequence %d is not found.", seq_id));
+  // the last blocks are unused first, so that they are evicted first
+  for (auto block = it->second.blocks.rbegin();
+       block != it->second.blocks.rend();
+       ++block) {
+    Unref(*block);
+  }
+  seqs_.erase(it);
+}
+
+int BlockManager::Length(int64_t seq_id) const {
+  return static_cast<int>(GetSequence(seq_id).tokens.size());
+}
+
+int BlockManager::CachedLength(int64_t seq_id) const {
+  return GetSequence(seq_id).cached_length;
+}
+
+const std::vector<int>& BlockManager::BlockTable(int64_t seq_id) const {
+  return GetSequence(seq_id).blocks;
+}
+
+std::vector<int> BlockManager::BlockTables(const std::vector<int64_t>& seq_ids,
+                                           int max_blocks_per_seq) const {
+  std::vector<int> tables(seq_ids.size() * max_blocks_per_seq, -1);
+  for (size_t i = 0; i < seq_ids.size(); ++i) {
+    const auto& blocks = BlockTable(seq_ids[i]);
+    PADDLE_ENFORCE_LE(
+        blocks.size(),
+        max_blocks_per_seq,
+        common::errors::InvalidArgument(
+            "The sequence %d has %d blocks, more than max_blocks_per_seq %d.",
+            seq_ids[i],
+            blocks.size(),
+            max_blocks_per_seq));
+    std::copy(
+        blocks.begin(), blocks.end(), tables.begin() + i * max_blocks_per_seq);
+  }
+  return tables;
+}
+
+std::vector<std::pair<int, int>> BlockManager::TakeCopies() {
+  std::vector<std::pair<int, int>> copies;
+  copies.swap(copies_);
+  return copies;
+}
+
+}  // namespace funcs
+}  // namespace phi
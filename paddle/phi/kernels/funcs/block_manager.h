@@ -0,0 +1,132 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace phi {
+namespace funcs {
+
+// Allocates the blocks of the paged kv cache of block_multihead_attention.
+// The blocks are reference counted so that sequences share them:
+//  - A full block is addressed by the hash of its tokens and of the blocks
+//    before it, a new prompt starting with the same tokens, e.g. a system
+//    prompt, reuses the cached blocks instead of taking new ones. A cached
+//    block no longer used stays cached until its memory is needed.
+//  - A forked sequence, e.g. for beam search or sampling several outputs,
+//    shares all the blocks of its parent. Its shared last block is copied
+//    on write, the copies are taken by TakeCopies and have to be applied to
+//    the key and value caches before the next step writes them.
+// The block tables are laid out as block_attn.h reads them. A prompt still
+// computed as a whole writes the same kv to its shared blocks again, so the
+// kernels need no change. CachedLength tells how much of it is cached, e.g.
+// to pass the shared prefix computed once as pre_key_cache instead.
+class BlockManager {
+ public:
+  BlockManager(int num_blocks, int block_size);
+
+  // Adds the sequence `seq_id` with the prompt `token_ids`, sharing the
+  // cached blocks of its longest cached prefix. Returns false, and adds
+  // nothing, if there are not enough free blocks.
+  bool AddSequence(int64_t seq_id, const std::vector<int64_t>& token_ids);
+
+  // Appends the generated `token_ids` to `seq_id`, taking new blocks as
+  // needed. Returns false, and appends nothing, if there are not enough free
+  // blocks.
+  bool Append(int64_t seq_id, const std::vector<int64_t>& token_ids);
+
+  // Adds `child` as a copy of `parent`, sharing all its blocks.
+  void Fork(int64_t parent, int64_t child);
+
+  // Removes `seq_id`, its full blocks stay cached for the later prompts.
+  void Free(int64_t seq_id);
+
+  bool HasSequence(int64_t seq_id) const { return seqs_.count(seq_id) > 0; }
+
+  // The number of tokens of `seq_id`.
+  int Length(int64_t seq_id) const;
+
+  // The number of the first prompt tokens of `seq_id` whose kv was cached
+  // when it was added, a multiple of the block size less than the prompt
+  // length, so that the last token is always computed.
+  int CachedLength(int64_t seq_id) const;
+
+  const std::vector<int>& BlockTable(int64_t seq_id) const;
+
+  // The block tables of `seq_ids`, [seq_ids.size(), max_blocks_per_seq] in
+  // row major, padded with -1.
+  std::vector<int> BlockTables(const std::vector<int64_t>& seq_ids,
+                               int max_blocks_per_seq) const;
+
+  // Takes the (src, dst) blocks copied on write since the last call.
+  std::vector<std::pair<int, int>> TakeCopies();
+
+  // The number of blocks which can be taken, including the cached ones no
+  // longer used.
+  int NumFreeBlocks() const {
+    return static_cast<int>(free_blocks_.size() + evictable_blocks_.size());
+  }
+
+  int block_size() const { return block_size_; }
+
+ private:
+  struct Block {
+    int ref_count = 0;
+    // set once the block is full and cached
+    bool cached = false;
+    uint64_t hash = 0;
+    uint64_t parent_hash = 0;
+    std::vector<int64_t> tokens;
+    std::list<int>::iterator evictable_pos;
+  };
+
+  struct Sequence {
+    std::vector<int> blocks;
+    std::vector<int64_t> tokens;
+    // the chained hash of each full block, kept even when the block is not
+    // cached because another block holds the same tokens
+    std::vector<uint64_t> hashes;
+    int cached_length = 0;
+  };
+
+  uint64_t HashBlock(uint64_t parent_hash,
+                     const int64_t* tokens,
+                     int num_tokens) const;
+  // Returns the cached block holding `tokens` after `parent_hash`, or -1.
+  int FindCached(uint64_t parent_hash, const int64_t* tokens) const;
+  int TakeBlock();
+  void Ref(int block_id);
+  void Unref(int block_id);
+  // Caches the full block `index` of `seq` for the later prompts.
+  void CacheBlock(Sequence* seq, int index);
+  int NumNewBlocks(const Sequence& seq, int num_tokens) const;
+  const Sequence& GetSequence(int64_t seq_id) const;
+
+  int block_size_;
+  std::vector<Block> blocks_;
+  std::vector<int> free_blocks_;
+  // the cached blocks no longer used, the least recently used first
+  std::list<int> evictable_blocks_;
+  std::unordered_multimap<uint64_t, int> cached_blocks_;
+  std::unordered_map<int64_t, Sequence> seqs_;
+  std::vector<std::pair<int, int>> copies_;
+};
+
+}  // namespace funcs
+}  // namespace phi
@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/concat_and_split_functor.h"
 
+#include <cstring>
+
 #include "glog/logging.h"
 
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
@@ -146,6 +148,8 @@ struct PADDLE_ALIGN(256) PointerAndColWrapper {
   PointerWrapper<T, Size> ins_ptr_wrapper;
 };
 
+// Packs the input pointers and the column offsets into one buffer, so that
+// they are uploaded by a single allocation and copy.
 template <typename T, typename IndexT>
 struct PointerToPointerAndCol {
  public:
@@ -155,23 +159,33 @@ struct PointerToPointerAndCol {
                          const IndexT inputs_col_num,
                          const T** pre_alloced_host_ptr,
                          IndexT* inputs_col,
-                         phi::Allocator::AllocationPtr* dev_ins_ptr,
-                         phi::Allocator::AllocationPtr* dev_col_ptr) {
-    *dev_col_ptr = phi::memory_utils::Alloc(
+                         phi::Allocator::AllocationPtr* dev_ins_ptr) {
+    auto in_num = ins.size();
+    for (auto i = 0; i < in_num; ++i) {
+      pre_alloced_host_ptr[i] = ins[i].data<T>();
+    }
+    // The pointers come first, which keeps the offsets aligned.
+    size_t ptr_bytes = in_num * sizeof(T*);
+    size_t col_bytes = inputs_col_num * sizeof(IndexT);
+    std::vector<uint8_t> packed(ptr_bytes + col_bytes);
+    std::memcpy(packed.data(), pre_alloced_host_ptr, ptr_bytes);
+    std::memcpy(packed.data() + ptr_bytes, inputs_col, col_bytes);
+
+    *dev_ins_ptr = phi::memory_utils::Alloc(
         ctx.GetPlace(),
-        inputs_col_num * sizeof(IndexT),
+        packed.size(),
         phi::Stream(reinterpret_cast<phi::StreamId>(ctx.stream())));
     auto* restored = phi::backends::gpu::RestoreHostMemIfCapturingCUDAGraph(
-        inputs_col, inputs_col_num);
+        packed.data(), packed.size());
     memory_utils::Copy(ctx.GetPlace(),
-                       (*dev_col_ptr)->ptr(),
+                       (*dev_ins_ptr)->ptr(),
                        phi::CPUPlace(),
                        restored,
-                       inputs_col_num * sizeof(IndexT),
+                       packed.size(),
                        ctx.stream());
-    col_length = static_cast<IndexT*>((*dev_col_ptr)->ptr());
-    ins_ptr_wrapper =
-        PointerToPointer<T>(ctx, ins, pre_alloced_host_ptr, dev_ins_ptr);
+    auto* dev_data = static_cast<uint8_t*>((*dev_ins_ptr)->ptr());
+    ins_ptr_wrapper.ins_addr = reinterpret_cast<void**>(dev_data);
+    col_length = reinterpret_cast<IndexT*>(dev_data + ptr_bytes);
   }
 
   __device__ inline const void* operator[](int i) const {
@@ -192,6 +206,27 @@ struct alignas(MovSize) Packed {
   };
 };
 
+// Returns the segment that col belongs to, i.e. the last one whose offset is
+// not greater than col. The offsets are ascending with offsets[0] = 0 and
+// offsets[num_segments] > col, and the binary search keeps the lookup cheap
+// for the hundreds of inputs of the feature concatenation.
+template <typename IndexT, typename OffsetsT>
+__device__ __forceinline__ IndexT FindSegment(const OffsetsT& offsets,
+                                              const IndexT num_segments,
+                                              const IndexT col) {
+  IndexT low = 0;
+  IndexT high = num_segments;
+  while (high - low > 1) {
+    IndexT mid = (low + high) >> 1;
+    if (offsets[mid] <= col) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
 template <typename IndexT, int MovSize, typename PointerAndColWrapperT>
 __global__ void ConcatTensorWithDifferentShape(
     const PointerAndColWrapperT ins_datas,
@@ -201,20 +236,13 @@ __global__ void ConcatTensorWithDifferentShape(
     void* output) {
   Packed<MovSize>* dst = reinterpret_cast<Packed<MovSize>*>(output);
 
-  IndexT curr_segment = 0;
-  IndexT curr_offset = ins_datas.col_length[0];
-
   CUDA_KERNEL_LOOP_TYPE(tid_x, output_cols, IndexT) {
-    IndexT curr_col_offset = ins_datas.col_length[curr_segment + 1];
-
-    while (curr_col_offset <= tid_x) {
-      curr_offset = curr_col_offset;
-      ++curr_segment;
-      curr_col_offset = ins_datas.col_length[curr_segment + 1];
-    }
-
+    IndexT curr_segment = FindSegment<IndexT>(
+        ins_datas.col_length, static_cast<IndexT>(col_size - 1), tid_x);
+    IndexT curr_offset = ins_datas.col_length[curr_segment];
     IndexT local_col = tid_x - curr_offset;
-    IndexT segment_width = curr_col_offset - curr_offset;
+    IndexT segment_width =
+        ins_datas.col_length[curr_segment + 1] - curr_offset;
 
     const Packed<MovSize>* input_ptr =
         reinterpret_cast<const Packed<MovSize>*>(ins_datas[curr_segment]);
@@ -286,14 +314,12 @@ void DispatchConcatWithDifferentShapeKernelLimitNum(
             ptr_col_array, inputs_col_num, out_row, out_col, output->data()));
     default: {
       phi::Allocator::AllocationPtr dev_ins_ptr{nullptr};
-      phi::Allocator::AllocationPtr dev_col_ptr{nullptr};
       PointerToPointerAndCol<T, IndexT> ptr_col_array(ctx,
                                                       ins,
                                                       inputs_col_num,
                                                       inputs_data,
                                                       inputs_col,
-                                                      &dev_ins_ptr,
-                                                      &dev_col_ptr);
+                                                      &dev_ins_ptr);
       ConcatTensorWithDifferentShape<IndexT, MovSize, decltype(ptr_col_array)>
           <<<grid_dims, block_dims, 0, ctx.stream()>>>(
               ptr_col_array, inputs_col_num, out_row, out_col, output->data());
@@ -646,54 +672,62 @@ struct PointerAndColArray
   }
 };
 
-template <typename T, typename IndexT, typename DataArrayT>
+template <typename T, typename IndexT, int MovSize, typename DataArrayT>
 __global__ void SplitTensorWithSameShape(const T* input_data,
                                          const IndexT out_row,
                                          const IndexT cumulative_col,
                                          const IndexT fixed_out_col,
                                          DataArrayT data_array) {
+  const Packed<MovSize>* src =
+      reinterpret_cast<const Packed<MovSize>*>(input_data);
   CUDA_KERNEL_LOOP_TYPE(tid_x, cumulative_col, IndexT) {
     IndexT split = tid_x / fixed_out_col;
     IndexT in_offset = tid_x - split * fixed_out_col;
-    T* output_ptr = data_array.data[split];
+    Packed<MovSize>* output_ptr =
+        reinterpret_cast<Packed<MovSize>*>(data_array.data[split]);
     if (output_ptr != nullptr) {
       IndexT tid_y = blockIdx.y * blockDim.y + threadIdx.y;
       for (; tid_y < out_row; tid_y += blockDim.y * gridDim.y)
         output_ptr[tid_y * fixed_out_col + in_offset] =
-            input_data[tid_y * cumulative_col + tid_x];
+            src[tid_y * cumulative_col + tid_x];
     }
   }
 }
 
-template <typename T, typename IndexT, typename DataArrayT, typename ValArrayT>
+template <typename T,
+          typename IndexT,
+          int MovSize,
+          typename DataArrayT,
+          typename ValArrayT>
 __global__ void SplitTensorWithDifferentShape(const T* input_data,
                                               const IndexT out_row,
                                               const IndexT cumulative_col,
+                                              const IndexT num_segments,
                                               DataArrayT data_array,
                                               ValArrayT col_array) {
-  IndexT curr_segment = 0;
-  IndexT curr_offset = col_array.data[0];
+  const Packed<MovSize>* src =
+      reinterpret_cast<const Packed<MovSize>*>(input_data);
   CUDA_KERNEL_LOOP_TYPE(tid_x, cumulative_col, IndexT) {
-    IndexT curr_col_offset = col_array.data[curr_segment + 1];
-    while (curr_col_offset <= tid_x) {
-      curr_offset = curr_col_offset;
-      ++curr_segment;
-      curr_col_offset = col_array.data[curr_segment + 1];
-    }
-
+    IndexT curr_segment =
+        FindSegment<IndexT>(col_array.data, num_segments, tid_x);
+    IndexT curr_offset = col_array.data[curr_segment];
     IndexT local_col = tid_x - curr_offset;
-    IndexT segment_width = curr_col_offset - curr_offset;
-    T* output_ptr = data_array.data[curr_segment];
+    IndexT segment_width = col_array.data[curr_segment + 1] - curr_offset;
+    Packed<MovSize>* output_ptr =
+        reinterpret_cast<Packed<MovSize>*>(data_array.data[curr_segment]);
     if (output_ptr != nullptr) {
       IndexT tid_y = blockIdx.y * blockDim.y + threadIdx.y;
       for (; tid_y < out_row; tid_y += blockDim.y * gridDim.y)
         output_ptr[tid_y * segment_width + local_col] =
-            input_data[tid_y * cumulative_col + tid_x];
+            src[tid_y * cumulative_col + tid_x];
     }
   }
 }
 
-template <typename T, typename IndexT, funcs::SegmentedArraySize Size>
+template <typename T,
+          typename IndexT,
+          int MovSize,
+          funcs::SegmentedArraySize Size>
 void SplitFunctionDispatchWithSameShape(const phi::GPUContext& ctx,
                                         const IndexT out_col,
                                         const IndexT out_row,
@@ -711,12 +745,15 @@ void SplitFunctionDispatchWithSameShape(const phi::GPUContext& ctx,
       /*need_alloc=*/false,
       /*use_cuda_graph=*/true,
       pre_alloc_host_buf);
-  SplitTensorWithSameShape<T, IndexT, decltype(setter.array)>
+  SplitTensorWithSameShape<T, IndexT, MovSize, decltype(setter.array)>
       <<<grid_dims, block_dims, 0, ctx.stream()>>>(
           input_data, out_row, cumulative_col, out_col, setter.array);
 }
 
-template <typename T, typename IndexT, funcs::SegmentedArraySize Size>
+template <typename T,
+          typename IndexT,
+          int MovSize,
+          funcs::SegmentedArraySize Size>
 void SplitFunctionDispatchWithDifferentShape(
     const phi::GPUContext& ctx,
     const int out_col_num,
@@ -734,10 +771,59 @@ void SplitFunctionDispatchWithDifferentShape(
 
   SplitTensorWithDifferentShape<T,
                                 IndexT,
+                                MovSize,
                                 decltype(setter.array),
                                 decltype(setter.val_array)>
       <<<grid_dims, block_dims, 0, ctx.stream()>>>(
-          input_data, out_row, cumulative_col, setter.array, setter.val_array);
+          input_data,
+          out_row,
+          cumulative_col,
+          static_cast<IndexT>(out_col_num - 1),
+          setter.array,
+          setter.val_array);
+}
+
+template <typename T, typename IndexT, int MovSize>
+void SplitFunctorDispatchWithMovSize(const phi::GPUContext& ctx,
+                                     const IndexT out_col,
+                                     const IndexT out_row,
+                                     const IndexT cumulative_col,
+                                     const T* input_data,
+                                     std::vector<phi::DenseTensor*>* outs,
+                                     IndexT* outs_cols,
+                                     bool has_same_shape) {
+  int out_num = outs->size();
+  int out_cols_num = out_num + 1;
+  int limit_num = has_same_shape ? out_num : out_cols_num;
+  T** outs_data = nullptr;
+  if (has_same_shape) {
+    switch (funcs::CalcArraySize(limit_num)) {
+      SEGMENTED_ARRAY_KERNEL_HELPER(
+          SplitFunctionDispatchWithSameShape<T, IndexT, MovSize, kArraySize>(
+              ctx,
+              out_col,
+              out_row,
+              cumulative_col,
+              input_data,
+              outs,
+              outs_data));
+    }
+  } else {
+    switch (funcs::CalcArraySize(limit_num)) {
+      SEGMENTED_ARRAY_KERNEL_HELPER(
+          SplitFunctionDispatchWithDifferentShape<T,
+                                                  IndexT,
+                                                  MovSize,
+                                                  kArraySize>(ctx,
+                                                              out_cols_num,
+                                                              out_row,
+                                                              cumulative_col,
+                                                              input_data,
+                                                              outs,
+                                                              outs_cols,
+                                                              outs_data));
+    }
+  }
 }
 
 template <typename T, typename IndexT>
@@ -761,44 +847,94 @@ void SplitFunctorDispatchWithIndexType(
   int out_cols_num = out_num + 1;
   std::vector<IndexT> outputs_cols_vec(out_cols_num, 0);
   IndexT* outs_cols = outputs_cols_vec.data();
-  T** outs_data = nullptr;
 
   outs_cols[0] = 0;
   for (int i = 0; i < out_num; ++i) {
     IndexT t_col = ref_ins.at(i)->numel() / out_row;
     if (has_same_shape) {
-      has_same_shape &= (t_col == cumulative_col);
+      has_same_shape &= (t_col == out_col);
     }
     cumulative_col += t_col;
     outs_cols[i + 1] = cumulative_col;
   }
-  int limit_num = has_same_shape ? out_num : out_cols_num;
-  if (has_same_shape) {
-    switch (funcs::CalcArraySize(limit_num)) {
-      SEGMENTED_ARRAY_KERNEL_HELPER(
-          SplitFunctionDispatchWithSameShape<T, IndexT, kArraySize>(
-              ctx,
-              out_col,
-              out_row,
-              cumulative_col,
-              input.data<T>(),
-              outs,
-              outs_data));
+
+  // Moves the widest packed type, up to 16 bytes, that every column width
+  // and every address is aligned to, just like the concat.
+  IndexT vec_size = 16 / sizeof(T);
+  auto is_aligned = [&](const void* ptr, IndexT size) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % (size * sizeof(T)) == 0;
+  };
+  for (; vec_size > 1; vec_size /= 2) {
+    bool aligned = is_aligned(input.data(), vec_size);
+    for (int i = 0; aligned && i < out_num; ++i) {
+      aligned = (outs_cols[i + 1] - outs_cols[i]) % vec_size == 0;
+      auto* out = outs->at(i);
+      if (aligned && out != nullptr && out->numel() > 0) {
+        aligned = is_aligned(out->data(), vec_size);
+      }
     }
-  } else {
-    switch (funcs::CalcArraySize(limit_num)) {
-      SEGMENTED_ARRAY_KERNEL_HELPER(
-          SplitFunctionDispatchWithDifferentShape<T, IndexT, kArraySize>(
-              ctx,
-              out_cols_num,
-              out_row,
-              cumulative_col,
-              input.data<T>(),
-              outs,
-              outs_cols,
-              outs_data));
+    if (aligned) {
+      break;
     }
   }
+  for (int i = 0; i < out_cols_num; ++i) {
+    outs_cols[i] /= vec_size;
+  }
+  out_col /= vec_size;
+  cumulative_col /= vec_size;
+
+  const T* input_data = input.data<T>();
+  switch (vec_size * sizeof(T)) {
+    case 16:
+      SplitFunctorDispatchWithMovSize<T, IndexT, 16>(ctx,
+                                                     out_col,
+                                                     out_row,
+                                                     cumulative_col,
+                                                     input_data,
+                                                     outs,
+                                                     outs_cols,
+                                                     has_same_shape);
+      break;
+    case 8:
+      SplitFunctorDispatchWithMovSize<T, IndexT, 8>(ctx,
+                                                    out_col,
+                                                    out_row,
+                                                    cumulative_col,
+                                                    input_data,
+                                                    outs,
+                                                    outs_cols,
+                                                    has_same_shape);
+      break;
+    case 4:
+      SplitFunctorDispatchWithMovSize<T, IndexT, 4>(ctx,
+                                                    out_col,
+                                                    out_row,
+                                                    cumulative_col,
+                                                    input_data,
+                                                    outs,
+                                                    outs_cols,
+                                                    has_same_shape);
+      break;
+    case 2:
+      SplitFunctorDispatchWithMovSize<T, IndexT, 2>(ctx,
+                                                    out_col,
+                                                    out_row,
+                                                    cumulative_col,
+                                                    input_data,
+                                                    outs,
+                                                    outs_cols,
+                                                    has_same_shape);
+      break;
+    default:
+      SplitFunctorDispatchWithMovSize<T, IndexT, 1>(ctx,
+                                                    out_col,
+                                                    out_row,
+                                                    cumulative_col,
+                                                    input_data,
+                                                    outs,
+                                                    outs_cols,
+                                                    has_same_shape);
+  }
 }
 
 template <typename T>
@@ -13,8 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <algorithm>
 #include <cmath>
 #include <functional>
+#include <limits>
 #include <string>
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
@@ -184,6 +186,44 @@ inline void vec_sum<float, backends::cpu::avx>(const size_t n,
 #endif
 }
 
+template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
+inline void vec_max(const size_t n, const T* x, T* m) {
+  m[0] = x[0];
+  for (size_t i = 1; i < n; ++i) {
+    m[0] = x[i] > m[0] ? x[i] : m[0];
+  }
+}
+
+template <>
+inline void vec_max<float, backends::cpu::avx>(const size_t n,
+                                               const float* x,
+                                               float* m) {
+#ifdef __AVX__
+  constexpr unsigned int block = YMM_FLOAT_BLOCK;
+  if (n < block) {
+    vec_max<float, backends::cpu::isa_any>(n, x, m);
+    return;
+  }
+
+  unsigned int i = block, end = n & ~(block - 1);
+  __m256 tmp = _mm256_loadu_ps(x);
+  for (; i < end; i += block) {
+    tmp = _mm256_max_ps(tmp, _mm256_loadu_ps(x + i));
+  }
+  __m128 hmax = _mm_max_ps(_mm256_castps256_ps128(tmp),
+                           _mm256_extractf128_ps(tmp, 1));
+  hmax = _mm_max_ps(hmax, _mm_movehl_ps(hmax, hmax));
+  hmax = _mm_max_ss(hmax, _mm_shuffle_ps(hmax, hmax, 0x1));
+  m[0] = _mm_cvtss_f32(hmax);
+
+  for (; i < n; i++) {
+    m[0] = x[i] > m[0] ? x[i] : m[0];
+  }
+#else
+  vec_max<float, backends::cpu::isa_any>(n, x, m);
+#endif
+}
+
 template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
 inline void vec_mul(const size_t n, const T* x, const T* y, T* z) {
   for (size_t i = 0; i < n; ++i) {
@@ -635,6 +675,72 @@ inline void vec_relu<float, backends::cpu::avx512f>(const int n,
   vec_relu<float, backends::cpu::avx2>(n, x, y);
 }
 
+// The width of the blocks of the online softmax, 16KB of float which stays
+// in L1 from the exp of a block to its sum.
+constexpr int kSoftmaxBlockSize = 4096;
+
+inline int softmax_num_blocks(const int n) {
+  return (n + kSoftmaxBlockSize - 1) / kSoftmaxBlockSize;
+}
+
+// Online softmax of a row in cache sized blocks. x is read only once: every
+// block b gets y = exp(x - block_max[b]) while the running max and sum of the
+// row are rescaled by the new block max, so exp is taken once per element.
+// block_max holds softmax_num_blocks(n) elements. As the former multi-pass
+// softmax, x - max is clipped at -64.
+template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
+inline void vec_softmax_blocks(
+    const int n, const T* x, T* y, T* block_max, T* max, T* sum) {
+  T row_max = -std::numeric_limits<T>::infinity();
+  T row_sum = 0;
+  for (int b = 0, i = 0; i < n; ++b, i += kSoftmaxBlockSize) {
+    const int len = std::min(kSoftmaxBlockSize, n - i);
+    T cur_max, cur_sum;
+    vec_max<T, isa>(len, x + i, &cur_max);
+    block_max[b] = cur_max;
+    if (cur_max == -std::numeric_limits<T>::infinity()) {
+      // a fully masked block adds nothing to the sum
+      std::fill(y + i, y + i + len, static_cast<T>(0));
+      continue;
+    }
+    vec_add_bias<T, isa>(len, -cur_max, x + i, y + i);
+    vec_clip<T, isa>(len, static_cast<T>(-64), y + i, y + i);
+    vec_exp<T>(len, y + i, y + i);
+    vec_sum<T, isa>(len, y + i, &cur_sum);
+    if (cur_max > row_max) {
+      row_sum = row_sum * std::exp(row_max - cur_max) + cur_sum;
+      row_max = cur_max;
+    } else {
+      row_sum += cur_sum * std::exp(cur_max - row_max);
+    }
+  }
+  *max = row_max;
+  *sum = row_sum;
+}
+
+// y = softmax(x) of a row, the max and sum of the row are returned to reuse
+// them, e.g. for the log-sum-exp of cross entropy.
+template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
+inline void vec_softmax(
+    const int n, const T* x, T* y, T* block_max, T* max, T* sum) {
+  vec_softmax_blocks<T, isa>(n, x, y, block_max, max, sum);
+  for (int b = 0, i = 0; i < n; ++b, i += kSoftmaxBlockSize) {
+    const int len = std::min(kSoftmaxBlockSize, n - i);
+    const T scale = std::exp(block_max[b] - *max) / *sum;
+    vec_scal<T, isa>(len, scale, y + i, y + i);
+  }
+}
+
+// y = log_softmax(x) of a row, y = clip(x - max, -64) - log(sum).
+template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
+inline void vec_log_softmax(const int n, const T* x, T* y, T* block_max) {
+  T max, sum;
+  vec_softmax_blocks<T, isa>(n, x, y, block_max, &max, &sum);
+  vec_add_bias<T, isa>(n, -max, x, y);
+  vec_clip<T, isa>(n, static_cast<T>(-64), y, y);
+  vec_add_bias<T, isa>(n, -std::log(sum), y, y);
+}
+
 // TODO(TJ): optimize double of sigmoid, tanh and relu if necessary
 
 template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
@@ -14,12 +14,17 @@
 
 #include "paddle/phi/kernels/funcs/data_layout_transform.h"
 
+#include <array>
+#include <vector>
+
 #include "glog/logging.h"
 
 #include "paddle/common/layout.h"
 #include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/backends/onednn/onednn_context.h"
 #include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 
@@ -30,6 +35,105 @@
 
 namespace phi::funcs {
 
+template <typename InT, typename OutT>
+static void TransposeAndCast(const CPUContext& dev_ctx,
+                             const DenseTensor& x,
+                             const int64_t* x_strides,
+                             DenseTensor* out) {
+  const InT* x_data = x.data<InT>();
+  OutT* out_data = dev_ctx.Alloc<OutT>(out);
+  const int64_t* dims = out->dims().Get();
+  for (int64_t n = 0; n < dims[0]; ++n) {
+    for (int64_t i = 0; i < dims[1]; ++i) {
+      for (int64_t j = 0; j < dims[2]; ++j) {
+        const InT* x_row =
+            x_data + n * x_strides[0] + i * x_strides[1] + j * x_strides[2];
+        for (int64_t k = 0; k < dims[3]; ++k) {
+          *out_data++ = static_cast<OutT>(x_row[k * x_strides[3]]);
+        }
+      }
+    }
+  }
+}
+
+template <typename InT>
+static void TransposeAndCastFrom(const CPUContext& dev_ctx,
+                                 const DenseTensor& x,
+                                 const int64_t* x_strides,
+                                 DataType dst_dtype,
+                                 DenseTensor* out) {
+  switch (dst_dtype) {
+    case DataType::FLOAT32:
+      return TransposeAndCast<InT, float>(dev_ctx, x, x_strides, out);
+    case DataType::FLOAT64:
+      return TransposeAndCast<InT, double>(dev_ctx, x, x_strides, out);
+    case DataType::FLOAT16:
+      return TransposeAndCast<InT, phi::dtype::float16>(
+          dev_ctx, x, x_strides, out);
+    default:
+      return TransposeAndCast<InT, phi::dtype::bfloat16>(
+          dev_ctx, x, x_strides, out);
+  }
+}
+
+bool TransDataLayoutAndType(const DenseTensor& x,
+                            DataLayout dst_layout,
+                            DataType dst_dtype,
+                            DenseTensor* out) {
+  auto is_4d_layout = [](DataLayout layout) {
+    return layout == DataLayout::NCHW || layout == DataLayout::NHWC;
+  };
+  auto is_floating = [](DataType dtype) {
+    return dtype == DataType::FLOAT32 || dtype == DataType::FLOAT64 ||
+           dtype == DataType::FLOAT16 || dtype == DataType::BFLOAT16;
+  };
+  if (x.place().GetType() != AllocationType::CPU || x.dims().size() != 4 ||
+      !x.meta().is_contiguous() || !is_4d_layout(x.layout()) ||
+      !is_4d_layout(dst_layout) || x.layout() == dst_layout ||
+      !is_floating(x.dtype()) || !is_floating(dst_dtype) ||
+      x.dtype() == dst_dtype) {
+    return false;
+  }
+  VLOG(3) << "DataLayoutAndTypeTransform " << x.layout() << " " << x.dtype()
+          << " -> " << dst_layout << " " << dst_dtype;
+
+  const std::array<int, 4> axis = x.layout() == DataLayout::NCHW
+                                      ? std::array<int, 4>{0, 2, 3, 1}
+                                      : std::array<int, 4>{0, 3, 1, 2};
+  std::array<int64_t, 4> dst_dims;
+  std::array<int64_t, 4> x_strides;
+  for (int i = 0; i < 4; ++i) {
+    dst_dims[i] = x.dims()[axis[i]];
+    x_strides[i] = x.strides()[axis[i]];
+  }
+  out->set_meta(DenseTensorMeta(
+      dst_dtype,
+      common::make_ddim(std::vector<int64_t>(dst_dims.begin(), dst_dims.end())),
+      dst_layout));
+
+  auto* dev_ctx = static_cast<CPUContext*>(
+      DeviceContextPool::Instance().Get(x.place()));
+  switch (x.dtype()) {
+    case DataType::FLOAT32:
+      TransposeAndCastFrom<float>(
+          *dev_ctx, x, x_strides.data(), dst_dtype, out);
+      break;
+    case DataType::FLOAT64:
+      TransposeAndCastFrom<double>(
+          *dev_ctx, x, x_strides.data(), dst_dtype, out);
+      break;
+    case DataType::FLOAT16:
+      TransposeAndCastFrom<phi::dtype::float16>(
+          *dev_ctx, x, x_strides.data(), dst_dtype, out);
+      break;
+    default:
+      TransposeAndCastFrom<phi::dtype::bfloat16>(
+          *dev_ctx, x, x_strides.data(), dst_dtype, out);
+      break;
+  }
+  return true;
+}
+
 #ifdef PADDLE_WITH_DNNL
 
 void* GetDataFromTensor(const DenseTensor& tensor,
@@ -26,6 +26,16 @@
 namespace phi {
 namespace funcs {
 
+// Transposes the 4-D x between the NCHW and NHWC layouts and casts it to
+// dst_dtype in a single pass, saving the intermediate tensor of the layout
+// transform followed by the cast. Only the contiguous tensors of the
+// floating dtypes on the CPU are supported, for the others it returns false
+// and leaves out untouched.
+bool TransDataLayoutAndType(const DenseTensor& x,
+                            DataLayout dst_layout,
+                            DataType dst_dtype,
+                            DenseTensor* out);
+
 #ifdef PADDLE_WITH_DNNL
 
 using OneDNNDataType = dnnl::memory::data_type;
@@ -14,8 +14,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/kernels/funcs/exclusive_scan.h"
 
 namespace phi {
 namespace funcs {
@@ -163,5 +171,244 @@ void LaunchEmbeddingGradDeterministicKernel(const GPUContext& ctx,
   }
 }
 
+// The ids of the embedding backward can be deduplicated by a hash table on
+// GPU, so that the grads of the repeated ids are summed in the segments of
+// their unique ids, instead of by the atomics on the same rows which are
+// heavily contended when a few hot ids appear many times in a batch. It is
+// sort-free, the unique ids come in the order of the hash slots.
+constexpr int64_t kEmbeddingDedupMinIds = 4096;
+// The segmented sum is used when an unique id appears more than this number
+// of times on average.
+constexpr int64_t kEmbeddingDedupMinRepeat = 4;
+constexpr unsigned long long kEmbeddingHashEmptyKey =  // NOLINT
+    ~0ULL;                                             // NOLINT
+
+__device__ __forceinline__ int64_t EmbeddingIdHash(int64_t id, int64_t mask) {
+  uint64_t h = static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ULL;
+  h ^= h >> 32;
+  return static_cast<int64_t>(h) & mask;
+}
+
+template <typename IdT>
+__global__ void InsertIdsToHashTable(const IdT* ids,
+                                     const int64_t K,
+                                     const int64_t mask,
+                                     unsigned long long* keys,  // NOLINT
+                                     int* slots) {
+  CUDA_KERNEL_LOOP_TYPE(i, K, int64_t) {
+    auto key = static_cast<unsigned long long>(  // NOLINT
+        static_cast<int64_t>(ids[i]));
+    int64_t slot = EmbeddingIdHash(static_cast<int64_t>(ids[i]), mask);
+    while (true) {
+      auto prev = atomicCAS(keys + slot, kEmbeddingHashEmptyKey, key);
+      if (prev == kEmbeddingHashEmptyKey || prev == key) {
+        slots[i] = static_cast<int>(slot);
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+}
+
+__global__ void MarkOccupiedHashSlots(const unsigned long long* keys,  // NOLINT
+                                      const int64_t capacity,
+                                      int* flags) {
+  CUDA_KERNEL_LOOP_TYPE(i, capacity + 1, int64_t) {
+    flags[i] = i < capacity && keys[i] != kEmbeddingHashEmptyKey ? 1 : 0;
+  }
+}
+
+__global__ void GatherUniqueIds(const unsigned long long* keys,  // NOLINT
+                                const int* offsets,
+                                const int64_t capacity,
+                                int64_t* unique_ids) {
+  CUDA_KERNEL_LOOP_TYPE(i, capacity, int64_t) {
+    if (keys[i] != kEmbeddingHashEmptyKey) {
+      unique_ids[offsets[i]] = static_cast<int64_t>(keys[i]);
+    }
+  }
+}
+
+__global__ void CountIdsOfUniqueIds(const int* slots,
+                                    const int* offsets,
+                                    const int64_t K,
+                                    int* inverse,
+                                    int* counts) {
+  CUDA_KERNEL_LOOP_TYPE(i, K, int64_t) {
+    int unique_idx = offsets[slots[i]];
+    inverse[i] = unique_idx;
+    atomicAdd(counts + unique_idx, 1);
+  }
+}
+
+__global__ void ScatterIdsToSegments(const int* inverse,
+                                     const int* seg_begin,
+                                     const int64_t K,
+                                     int* cursor,
+                                     int* order) {
+  CUDA_KERNEL_LOOP_TYPE(i, K, int64_t) {
+    int unique_idx = inverse[i];
+    order[seg_begin[unique_idx] + atomicAdd(cursor + unique_idx, 1)] =
+        static_cast<int>(i);
+  }
+}
+
+__global__ void DecideEmbeddingGradSegmentedSum(const int* num_unique,
+                                                const int64_t K,
+                                                int* use_segmented_sum) {
+  *use_segmented_sum =
+      K >= kEmbeddingDedupMinRepeat * static_cast<int64_t>(*num_unique) ? 1
+                                                                         : 0;
+}
+
+// Sums the rows of output in the segment of each unique id. The sum is written
+// to the row of the unique id in table if ToDenseTable, otherwise to the
+// unique_idx-th row, which is the value of the SelectedRows grad.
+template <typename T, bool ToDenseTable>
+__global__ void EmbeddingGradSegmentedSum(T* table,
+                                          const T* output,
+                                          const int* order,
+                                          const int* seg_begin,
+                                          const int64_t* unique_ids,
+                                          const int* num_unique,
+                                          const int* use_segmented_sum,
+                                          const int64_t D) {
+  using MT = typename dtype::MPTypeTrait<T>::Type;
+  if (use_segmented_sum != nullptr && *use_segmented_sum == 0) {
+    return;
+  }
+  const int64_t unique_num = *num_unique;
+  for (int64_t idy = blockIdx.x * blockDim.y + threadIdx.y; idy < unique_num;
+       idy += static_cast<int64_t>(gridDim.x) * blockDim.y) {
+    int begin = seg_begin[idy];
+    int end = seg_begin[idy + 1];
+    T* tab = table + (ToDenseTable ? unique_ids[idy] : idy) * D;
+    for (int64_t col = threadIdx.x; col < D; col += blockDim.x) {
+      MT sum = static_cast<MT>(0);
+      for (int j = begin; j < end; ++j) {
+        sum += static_cast<MT>(output[order[j] * D + col]);
+      }
+      tab[col] = static_cast<T>(sum);
+    }
+  }
+}
+
+// The device buffers of the deduplicated ids. num_unique is on device, and
+// the others are allocated for the K ids in the worst case.
+struct EmbeddingDedupIds {
+  std::vector<phi::Allocator::AllocationPtr> holders;
+  const int* num_unique = nullptr;
+  int64_t* unique_ids = nullptr;
+  int* seg_begin = nullptr;
+  int* order = nullptr;
+};
+
+template <typename IdT>
+EmbeddingDedupIds DedupEmbeddingIds(const GPUContext& ctx,
+                                    const IdT* ids,
+                                    int64_t K) {
+  PADDLE_ENFORCE_LT(K,
+                    std::numeric_limits<int>::max() / 4,
+                    common::errors::InvalidArgument(
+                        "The number of ids to deduplicate should be less than "
+                        "%d, but received %d.",
+                        std::numeric_limits<int>::max() / 4,
+                        K));
+  auto place = ctx.GetPlace();
+  auto stream = ctx.stream();
+  EmbeddingDedupIds result;
+  auto alloc = [&](size_t bytes) {
+    result.holders.emplace_back(phi::memory_utils::Alloc(place, bytes));
+    return result.holders.back()->ptr();
+  };
+
+  // The load factor of the open addressing table is at most 0.5.
+  int64_t capacity = 1024;
+  while (capacity < 2 * K) {
+    capacity <<= 1;
+  }
+  auto* keys = reinterpret_cast<unsigned long long*>(  // NOLINT
+      alloc(capacity * sizeof(unsigned long long)));   // NOLINT
+  auto* slots = reinterpret_cast<int*>(alloc(K * sizeof(int)));
+  auto* flags = reinterpret_cast<int*>(alloc((capacity + 1) * sizeof(int)));
+  auto* offsets = reinterpret_cast<int*>(alloc((capacity + 1) * sizeof(int)));
+  auto* inverse = reinterpret_cast<int*>(alloc(K * sizeof(int)));
+  auto* counts = reinterpret_cast<int*>(alloc((K + 1) * sizeof(int)));
+  auto* cursor = reinterpret_cast<int*>(alloc(K * sizeof(int)));
+  result.unique_ids = reinterpret_cast<int64_t*>(alloc(K * sizeof(int64_t)));
+  result.seg_begin = reinterpret_cast<int*>(alloc((K + 1) * sizeof(int)));
+  result.order = reinterpret_cast<int*>(alloc(K * sizeof(int)));
+  // offsets[capacity] is the number of the occupied slots.
+  result.num_unique = offsets + capacity;
+
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipMemsetAsync(
+      keys, 0xff, capacity * sizeof(unsigned long long), stream));  // NOLINT
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(counts, 0, (K + 1) * sizeof(int), stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(cursor, 0, K * sizeof(int), stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(
+      keys, 0xff, capacity * sizeof(unsigned long long), stream));  // NOLINT
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(counts, 0, (K + 1) * sizeof(int), stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(cursor, 0, K * sizeof(int), stream));
+#endif
+
+  auto ids_config = backends::gpu::GetGpuLaunchConfig1D(ctx, K);
+  auto slots_config = backends::gpu::GetGpuLaunchConfig1D(ctx, capacity + 1);
+  InsertIdsToHashTable<IdT><<<ids_config.block_per_grid,
+                              ids_config.thread_per_block,
+                              0,
+                              stream>>>(ids, K, capacity - 1, keys, slots);
+  MarkOccupiedHashSlots<<<slots_config.block_per_grid,
+                          slots_config.thread_per_block,
+                          0,
+                          stream>>>(keys, capacity, flags);
+  CubExclusiveScan(flags, offsets, capacity + 1, 0, cub::Sum(), ctx);
+  GatherUniqueIds<<<slots_config.block_per_grid,
+                    slots_config.thread_per_block,
+                    0,
+                    stream>>>(keys, offsets, capacity, result.unique_ids);
+  // Group the ids by their unique ids with a counting sort, whose buckets
+  // are the segments of the unique ids.
+  CountIdsOfUniqueIds<<<ids_config.block_per_grid,
+                        ids_config.thread_per_block,
+                        0,
+                        stream>>>(slots, offsets, K, inverse, counts);
+  CubExclusiveScan(counts, result.seg_begin, K + 1, 0, cub::Sum(), ctx);
+  ScatterIdsToSegments<<<ids_config.block_per_grid,
+                         ids_config.thread_per_block,
+                         0,
+                         stream>>>(
+      inverse, result.seg_begin, K, cursor, result.order);
+  return result;
+}
+
+template <typename T, bool ToDenseTable>
+void LaunchEmbeddingGradSegmentedSum(const GPUContext& ctx,
+                                     const EmbeddingDedupIds& dedup_ids,
+                                     const T* d_out,
+                                     T* d_table,
+                                     int64_t D,
+                                     int64_t K,
+                                     const int* use_segmented_sum = nullptr) {
+  dim3 threads(128, 8);
+  int64_t blocks = (K + threads.y - 1) / threads.y;
+  dim3 grids(static_cast<int>(
+      std::min<int64_t>(blocks, static_cast<int64_t>(ctx.GetSMCount()) * 8)));
+  EmbeddingGradSegmentedSum<T, ToDenseTable>
+      <<<grids, threads, 0, ctx.stream()>>>(d_table,
+                                           d_out,
+                                           dedup_ids.order,
+                                           dedup_ids.seg_begin,
+                                           dedup_ids.unique_ids,
+                                           dedup_ids.num_unique,
+                                           use_segmented_sum,
+                                           D);
+}
+
 }  // namespace funcs
 }  // namespace phi
@@ -25,6 +25,8 @@
 #include "paddle/phi/kernels/scale_kernel.h"
 #include "paddle/phi/kernels/transpose_kernel.h"
 
+COMMON_DECLARE_bool(cufft_reuse_batched_plan);
+
 namespace phi {
 namespace funcs {
 namespace detail {
@@ -170,47 +172,94 @@ void exec_fft(const phi::GPUContext& ctx,
   FFTConfigKey key =
       create_fft_configkey(collapsed_input, collapsed_output, signal_ndim);
   int64_t device_id = ctx.GetPlace().GetDeviceId();
-  FFTConfig* config = nullptr;
-  std::unique_ptr<FFTConfig> config_ = nullptr;
   bool using_cache = use_cache(key.sizes_);
 
+  // The cache is locked until the plans are enqueued, since they and the
+  // workspace shared by them may be evicted by another thread.
+  FFTConfigCache* plan_cache = nullptr;
+  std::unique_lock<std::mutex> guard;
   if (using_cache) {
-    FFTConfigCache& plan_cache = get_fft_plan_cache(device_id);
-    std::unique_lock<std::mutex> guard(plan_cache.mutex, std::defer_lock);
-    guard.lock();
-    config = &(plan_cache.lookup(key));
-  } else {
-    config_ = std::make_unique<FFTConfig>(key);
-    config = config_.get();
+    plan_cache = &get_fft_plan_cache(device_id);
+    guard = std::unique_lock<std::mutex>(plan_cache->mutex);
   }
 
-  const int64_t workspace_size = static_cast<int64_t>(config->workspace_size());
-  DenseTensor workspace_tensor = Empty<uint8_t>(ctx, {workspace_size});
+  // conjugate the input or the output if the direction of the transform is
+  // not supported by cufft
+  const FFTTransformType fft_type = key.fft_type_;
+  bool plan_forward = forward;
+  if (fft_type == FFTTransformType::C2R && forward) {
+    ConjKernel<Ti, phi::GPUContext>(ctx, collapsed_input, &collapsed_input);
+    plan_forward = false;
+  } else if (fft_type == FFTTransformType::R2C && !forward) {
+    plan_forward = true;
+  }
+
+  // With FLAGS_cufft_reuse_batched_plan, the batch is split into chunks whose
+  // sizes are powers of two, so the plans are shared by all the batch sizes.
+  const bool split_batch = using_cache && FLAGS_cufft_reuse_batched_plan;
+  const int64_t in_sample_numel =
+      batch_size > 0 ? collapsed_input.numel() / batch_size : 0;
+  const int64_t out_sample_numel =
+      batch_size > 0 ? collapsed_output.numel() / batch_size : 0;
+  Ti* in_data = collapsed_input.data<Ti>();
+  To* out_data = collapsed_output.data<To>();
+  for (int64_t offset = 0; offset < batch_size;) {
+    int64_t chunk_size = batch_size - offset;
+    if (split_batch) {
+      int64_t pow2 = 1;
+      while (pow2 * 2 <= chunk_size) {
+        pow2 *= 2;
+      }
+      chunk_size = pow2;
+    }
+    FFTConfigKey chunk_key = key;
+    chunk_key.sizes_[0] = chunk_size;
+    chunk_key.input_shape_[0] = chunk_size;
+    chunk_key.output_shape_[0] = chunk_size;
+
+    FFTConfig* config = nullptr;
+    std::unique_ptr<FFTConfig> config_ = nullptr;
+    DenseTensor workspace_tensor;
+    void* workspace = nullptr;
+    if (using_cache) {
+      config = &(plan_cache->lookup(chunk_key));
+      workspace = plan_cache->workspace(
+          ctx.GetPlace(), ctx.stream(), config->workspace_size());
+    } else {
+      config_ = std::make_unique<FFTConfig>(chunk_key);
+      config = config_.get();
+      const int64_t workspace_size =
+          static_cast<int64_t>(config->workspace_size());
+      workspace_tensor = Empty<uint8_t>(ctx, {workspace_size});
+      workspace = workspace_tensor.data();
+    }
 
-  // prepare cufft for execution
+    // prepare cufft for execution
 #if defined(PADDLE_WITH_CUDA)
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::cufftSetStream(config->plan(), ctx.stream()));
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::cufftSetWorkArea(config->plan(), workspace_tensor.data()));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::cufftSetStream(config->plan(), ctx.stream()));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::cufftSetWorkArea(config->plan(), workspace));
 #elif defined(PADDLE_WITH_HIP)
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::hipfftSetStream(config->plan(), ctx.stream()));
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::hipfftSetWorkArea(config->plan(), workspace_tensor.data()));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::hipfftSetStream(config->plan(), ctx.stream()));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::hipfftSetWorkArea(config->plan(), workspace));
 #endif
 
-  // execution of fft plan
-  const FFTTransformType fft_type = config->transform_type();
-  if (fft_type == FFTTransformType::C2R && forward) {
-    ConjKernel<Ti, phi::GPUContext>(ctx, collapsed_input, &collapsed_input);
-    exec_plan(*config, collapsed_input.data(), collapsed_output.data(), false);
-  } else if (fft_type == FFTTransformType::R2C && !forward) {
-    exec_plan(*config, collapsed_input.data(), collapsed_output.data(), true);
+    // execution of fft plan
+    exec_plan(*config,
+              in_data + offset * in_sample_numel,
+              out_data + offset * out_sample_numel,
+              plan_forward);
+    offset += chunk_size;
+  }
+  if (guard.owns_lock()) {
+    guard.unlock();
+  }
+
+  if (fft_type == FFTTransformType::R2C && !forward) {
     ConjKernel<To, phi::GPUContext>(ctx, collapsed_output, &collapsed_output);
-  } else {
-    exec_plan(
-        *config, collapsed_input.data(), collapsed_output.data(), forward);
   }
 
   // resize for the collapsed output
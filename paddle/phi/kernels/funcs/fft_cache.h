@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <list>
@@ -21,12 +22,19 @@
 #include <unordered_map>
 #include <utility>
 
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/allocator.h"
+
 #if defined(PADDLE_WITH_CUDA)
 #include "paddle/phi/kernels/funcs/cufft_util.h"
 #elif defined(PADDLE_WITH_HIP)
 #include "paddle/phi/kernels/funcs/hipfft_util.h"
 #endif
 
+COMMON_DECLARE_int64(cufft_plan_cache_max_size);
+
 namespace phi {
 namespace funcs {
 namespace detail {
@@ -61,7 +69,10 @@ class FFTConfigCache {
                                   KeyEqual<FFTConfigKey>>;
   using map_kkv_iter_t = typename map_t::iterator;
 
-  FFTConfigCache() : FFTConfigCache(CUFFT_DEFAULT_CACHE_SIZE) {}
+  FFTConfigCache()
+      : FFTConfigCache(FLAGS_cufft_plan_cache_max_size >= 0
+                           ? FLAGS_cufft_plan_cache_max_size
+                           : CUFFT_DEFAULT_CACHE_SIZE) {}
 
   explicit FFTConfigCache(int64_t max_size) { _set_max_size(max_size); }
 
@@ -71,12 +82,20 @@ class FFTConfigCache {
   FFTConfigCache(FFTConfigCache&& other) noexcept
       : _usage_list(std::move(other._usage_list)),
         _cache_map(std::move(other._cache_map)),
-        _max_size(other._max_size) {}
+        _max_size(other._max_size),
+        _max_workspace_size(other._max_workspace_size),
+        _workspace(std::move(other._workspace)),
+        _workspace_size(other._workspace_size),
+        _workspace_stream(other._workspace_stream) {}
 
   FFTConfigCache& operator=(FFTConfigCache&& other) noexcept {
     _usage_list = std::move(other._usage_list);
     _cache_map = std::move(other._cache_map);
     _max_size = other._max_size;
+    _max_workspace_size = other._max_workspace_size;
+    _workspace = std::move(other._workspace);
+    _workspace_size = other._workspace_size;
+    _workspace_stream = other._workspace_stream;
     return *this;
   }
 
@@ -102,8 +121,13 @@ class FFTConfigCache {
     if (_usage_list.size() >= _max_size) {
       auto last = _usage_list.end();
       last--;
+      const bool is_largest =
+          last->second.workspace_size() >= _max_workspace_size;
       _cache_map.erase(last->first);
       _usage_list.pop_back();
+      if (is_largest) {
+        _update_max_workspace_size();
+      }
     }
 
     // construct new plan at list front, then insert into _cache_map
@@ -114,12 +138,43 @@ class FFTConfigCache {
     _cache_map.emplace(std::piecewise_construct,
                        std::forward_as_tuple(kv_it->first),
                        std::forward_as_tuple(kv_it));
+    _max_workspace_size =
+        std::max(_max_workspace_size, kv_it->second.workspace_size());
     return kv_it->second;
   }
 
+  // Returns a workspace of at least size bytes shared by all the plans of this
+  // cache, instead of a workspace for each execution. It is sized to the
+  // largest workspace of the cached plans, and shrinks when that plan is
+  // evicted. The plans on the same stream are executed in order, so they can
+  // share it; it is reallocated on the stream of another caller. The caller
+  // must hold the mutex until the plan using it is enqueued.
+  void* workspace(const phi::Place& place, gpuStream_t stream, size_t size) {
+    if (size == 0) {
+      return nullptr;
+    }
+    const size_t target_size = std::max(size, _max_workspace_size);
+    if (_workspace == nullptr || _workspace_stream != stream ||
+        _workspace_size < size || _workspace_size > target_size) {
+      // release the old one before allocating, so that the peak memory is not
+      // the sum of both
+      _workspace.reset();
+      _workspace = phi::memory_utils::Alloc(
+          place,
+          target_size,
+          phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+      _workspace_size = target_size;
+      _workspace_stream = stream;
+    }
+    return _workspace->ptr();
+  }
+
   void clear() {
     _cache_map.clear();
     _usage_list.clear();
+    _max_workspace_size = 0;
+    _workspace.reset();
+    _workspace_size = 0;
   }
 
   void resize(int64_t new_size) {
@@ -132,6 +187,7 @@ class FFTConfigCache {
         _cache_map.erase(delete_it->first);
       }
       _usage_list.erase(delete_it, _usage_list.end());
+      _update_max_workspace_size();
     }
   }
 
@@ -163,9 +219,24 @@ class FFTConfigCache {
     _max_size = static_cast<size_t>(new_size);
   }
 
+  // The plans are much more expensive to create than this scan, which only
+  // runs when the largest plan is evicted.
+  void _update_max_workspace_size() {
+    _max_workspace_size = 0;
+    for (const auto& kv : _usage_list) {
+      _max_workspace_size =
+          std::max(_max_workspace_size, kv.second.workspace_size());
+    }
+  }
+
   std::list<kv_t> _usage_list;
   map_t _cache_map;
   size_t _max_size;
+  // the largest workspace of the cached plans
+  size_t _max_workspace_size{0};
+  phi::Allocator::AllocationPtr _workspace{nullptr};
+  size_t _workspace_size{0};
+  gpuStream_t _workspace_stream{nullptr};
 };
 
 static std::vector<std::unique_ptr<FFTConfigCache>> plan_caches;
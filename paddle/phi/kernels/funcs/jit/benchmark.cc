@@ -18,6 +18,7 @@
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
 #include "paddle/phi/api/profiler/device_tracer.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
@@ -426,6 +427,60 @@ void BenchKernelLayerNorm() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelResidualLayerNorm() {
+  using T = typename KernelTuple::data_type;
+  const T epsilon = 9.99999975e-06;
+  for (int left : {1, 9, 17, 50}) {
+    for (int right : TestSizes()) {
+      int sz = left * right;
+      std::vector<T> x(sz), residual(sz), residual_out(sz), out(sz);
+      std::vector<T> mean(left), var(left), scale(right), bias(right);
+      RandomVec<T>(sz, x.data(), -2.f, 2.f);
+      RandomVec<T>(sz, residual.data(), -2.f, 2.f);
+      RandomVec<T>(right, scale.data(), -2.f, 2.f);
+      RandomVec<T>(right, bias.data(), -2.f, 2.f);
+      BenchAllImpls<KernelTuple, PlaceType>(right,
+                                            x.data(),
+                                            residual.data(),
+                                            residual_out.data(),
+                                            out.data(),
+                                            mean.data(),
+                                            var.data(),
+                                            scale.data(),
+                                            bias.data(),
+                                            left,
+                                            epsilon,
+                                            right);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelRMSNorm() {
+  using T = typename KernelTuple::data_type;
+  const T epsilon = 9.99999975e-06;
+  for (int left : {1, 9, 17, 50}) {
+    for (int right : TestSizes()) {
+      int sz = left * right;
+      std::vector<T> x(sz), residual(sz), residual_out(sz), out(sz);
+      std::vector<T> scale(right);
+      RandomVec<T>(sz, x.data(), -2.f, 2.f);
+      RandomVec<T>(sz, residual.data(), -2.f, 2.f);
+      RandomVec<T>(right, scale.data(), -2.f, 2.f);
+      BenchAllImpls<KernelTuple, PlaceType>(right,
+                                            x.data(),
+                                            residual.data(),
+                                            residual_out.data(),
+                                            out.data(),
+                                            scale.data(),
+                                            left,
+                                            epsilon,
+                                            right);
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelCRFDecoding() {
   using T = typename KernelTuple::data_type;
@@ -531,6 +586,8 @@ BENCH_FP32_CPU(GRUHtPart1);
 BENCH_FP32_CPU(GRUHtPart2);
 
 BENCH_FP32_CPU(LayerNorm);
+BENCH_FP32_CPU(ResidualLayerNorm);
+BENCH_FP32_CPU(RMSNorm);
 BENCH_FP32_CPU(CRFDecoding);
 
 BENCH_FP32_CPU(SeqPool);
@@ -551,6 +608,11 @@ int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
   LOG(INFO) << "Burning " << FLAGS_burning << " times, Repeat " << FLAGS_repeat
             << " times.";
+  // the jitcode emits zmm when avx512f is available
+  LOG(INFO) << "AVX512F: "
+            << (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)
+                    ? "on"
+                    : "off");
 
   RUN_ALL_BENCHMARK();
 }
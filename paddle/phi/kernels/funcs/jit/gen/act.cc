@@ -47,7 +47,17 @@ int ALIGN32_BEG g_tmp_mem[16] ALIGN32_END = {0};      // NOLINT
 
 void VActJitCode::genCode() {
   int offset = 0;
-  for (int i = 0; i < num_ / YMM_FLOAT_BLOCK; ++i) {
+  const bool use_zmm = phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f);
+  const int num_zmm_blocks = use_zmm ? num_ / ZMM_FLOAT_BLOCK : 0;
+  for (int i = 0; i < num_zmm_blocks; ++i) {
+    vmovups(zmm_src, ptr[param1 + offset]);
+    act_zmm(zmm_dst, zmm_src, type_);
+    vmovups(ptr[param2 + offset], zmm_dst);
+    offset += sizeof(float) * ZMM_FLOAT_BLOCK;
+  }
+  const int num_ymm_blocks =
+      (num_ - num_zmm_blocks * ZMM_FLOAT_BLOCK) / YMM_FLOAT_BLOCK;
+  for (int i = 0; i < num_ymm_blocks; ++i) {
     vmovups(ymm_src, ptr[param1 + offset]);
     act<ymm_t>(ymm_dst, ymm_src, type_);
     vmovups(ptr[param2 + offset], ymm_dst);
@@ -77,6 +87,9 @@ void VActJitCode::genCode() {
     offset += sizeof(float) * block;  // NOLINT
     rest -= block;
   }
+  if (use_zmm) {
+    vzeroupper();
+  }
   ret();
 }
 
@@ -242,6 +242,140 @@ class VActFunc : public JitCode {
     // dst.setIdx(src.getIdx());
   }
 
+  // compute EXP with zmm, only avx512f instructions are used, the compare
+  // against the rounded value is not needed since vrndscaleps floors exactly
+  void exp_zmm(zmm_t& dst,  // NOLINT
+               zmm_t& src,  // NOLINT
+               int src_idx = 27,
+               int fx_idx = 28,
+               int fy_idx = 29,
+               int z_idx = 30,
+               int tmp_idx = 31) {
+    zmm_t zmm_src = zmm_t(src_idx);
+    zmm_t zmm_fx = zmm_t(fx_idx);
+    zmm_t zmm_fy = zmm_t(fy_idx);
+    zmm_t zmm_z = zmm_t(z_idx);
+    zmm_t zmm_tmp = zmm_t(tmp_idx);
+    reg64_t reg_ptr_global = rax;
+    push(reg_ptr_global);
+    vmovaps(zmm_src, src);
+    mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_HIG]);
+    vminps(zmm_src, zmm_src, zmm_tmp);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_LOW]);
+    vmaxps(zmm_src, zmm_src, zmm_tmp);
+    // express exp(x) as exp(g + n*log(2))
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_LOG2EF]);
+    vmulps(zmm_fx, zmm_src, zmm_tmp);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_0P5]);
+    vaddps(zmm_fx, zmm_fx, zmm_tmp);
+    vrndscaleps(zmm_fx, zmm_fx, 0x01);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_C1]);
+    vmulps(zmm_fy, zmm_fx, zmm_tmp);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_C2]);
+    vmulps(zmm_z, zmm_fx, zmm_tmp);
+    vsubps(zmm_src, zmm_src, zmm_fy);
+    vsubps(zmm_src, zmm_src, zmm_z);
+    vmulps(zmm_z, zmm_src, zmm_src);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_P0]);
+    vmulps(dst, zmm_src, zmm_tmp);
+    for (size_t i = OFFSET_EXP_P1; i < OFFSET_EXP_P5;
+         i += (YMM_FLOAT_BLOCK * sizeof(float))) {
+      vbroadcastss(zmm_tmp, ptr[reg_ptr_global + i]);  // P1~P4
+      vaddps(dst, dst, zmm_tmp);
+      vmulps(dst, dst, zmm_src);
+    }
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_P5]);
+    vaddps(dst, dst, zmm_tmp);
+    vmulps(dst, dst, zmm_z);
+    vaddps(dst, dst, zmm_src);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    vaddps(dst, dst, zmm_tmp);
+    // build 2^n
+    zmm_t zmm_int = zmm_fx;
+    vcvttps2dq(zmm_int, zmm_fx);
+    mov(reg_ptr_global, reinterpret_cast<size_t>(exp_int_0x7f));
+    vpbroadcastd(zmm_tmp, ptr[reg_ptr_global]);
+    vpaddd(zmm_int, zmm_int, zmm_tmp);
+    vpslld(zmm_int, zmm_int, 23);
+    vmulps(dst, dst, zmm_int);
+    pop(reg_ptr_global);
+  }
+
+  // compute SIGMOID with zmm
+  void sigmoid_zmm(zmm_t& dst, zmm_t& src) {  // NOLINT
+    // y = 1 / (1 + e^-x)
+    zmm_t zmm_src = zmm_t(26);
+    zmm_t zmm_tmp = zmm_t(31);
+    reg64_t reg_ptr_global = rax;
+    push(reg_ptr_global);
+    mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_SIGMOID_MAX]);
+    vminps(zmm_src, src, zmm_tmp);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_SIGMOID_MIN]);
+    vmaxps(zmm_src, zmm_src, zmm_tmp);
+    vpxord(zmm_tmp, zmm_tmp, zmm_tmp);
+    vsubps(zmm_src, zmm_tmp, zmm_src);
+    exp_zmm(dst, zmm_src);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    vaddps(dst, dst, zmm_tmp);
+    vdivps(dst, zmm_tmp, dst);
+    pop(reg_ptr_global);
+  }
+
+  // compute TANH with zmm
+  void tanh_zmm(zmm_t& dst, zmm_t& src) {  // NOLINT
+    // y = 2 / (1 + e^(-2x)) - 1
+    zmm_t zmm_src = zmm_t(26);
+    zmm_t zmm_tmp = zmm_t(31);
+    reg64_t reg_ptr_global = rax;
+    push(reg_ptr_global);
+    mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_TWO]);
+    vmulps(zmm_src, src, zmm_tmp);
+    vpxord(zmm_tmp, zmm_tmp, zmm_tmp);
+    vsubps(zmm_src, zmm_tmp, zmm_src);
+    exp_zmm(dst, zmm_src);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    vaddps(dst, dst, zmm_tmp);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_TWO]);
+    vdivps(dst, zmm_tmp, dst);
+    vbroadcastss(zmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    vsubps(dst, dst, zmm_tmp);
+    pop(reg_ptr_global);
+  }
+
+  // the zmm version of act, use 26~31. vxorps and vandps on zmm need
+  // avx512dq, so only avx512f instructions are used here.
+  void act_zmm(zmm_t& dst, zmm_t& src, operand_type type) {  // NOLINT
+    zmm_t zmm_zero = zmm_t(31);
+    switch (type) {
+      case operand_type::RELU:
+        vpxord(zmm_zero, zmm_zero, zmm_zero);
+        vmaxps(dst, src, zmm_zero);
+        break;
+      case operand_type::SQUARE:
+        vmulps(dst, src, src);
+        break;
+      case operand_type::EXP:
+        exp_zmm(dst, src);
+        break;
+      case operand_type::SIGMOID:
+        sigmoid_zmm(dst, src);
+        break;
+      case operand_type::TANH:
+        tanh_zmm(dst, src);
+        break;
+      case operand_type::IDENTITY:
+        vmovaps(dst, src);
+        break;
+      default:
+        PADDLE_THROW(common::errors::Unimplemented(
+            "Do not support operand type code: %d.", type));
+        break;
+    }
+  }
+
   template <typename JMM>
   void act(JMM& dst, JMM& src, operand_type type) {  // NOLINT
     // use 11~15
@@ -327,6 +461,9 @@ class VActJitCode : public VActFunc {
 
   xmm_t xmm_dst = xmm_t(1);
   ymm_t ymm_dst = ymm_t(1);
+
+  zmm_t zmm_src = zmm_t(0);
+  zmm_t zmm_dst = zmm_t(1);
 };
 
 #define DECLARE_ACT_JITCODE(name, op_type)                                    \
@@ -24,8 +24,8 @@ namespace phi::jit::gen {
 void AdamJitCode::loadArgs() {
   static constexpr int32_t one_as_float = 0x3f800000;
   static constexpr int32_t mask_all_ones = static_cast<int32_t>(0xFFFFFFFF);
-  static constexpr int64_t mask_8_divisible =
-      static_cast<int64_t>(0xFFFFFFFFFFFFFFF8);
+  static constexpr int64_t mask_16_divisible =
+      static_cast<int64_t>(0xFFFFFFFFFFFFFFF0);
   static constexpr int64_t abi_pushes_offset = num_g_abi_regs * 8;
 
   mov(reg_mom2_out_ptr, ptr[rsp + (abi_pushes_offset + 8)]);
@@ -33,16 +33,16 @@ void AdamJitCode::loadArgs() {
   mov(eax, one_as_float);
   movd(xmm_one, eax);
 
-  vbroadcastss(ymm_one, xmm_one);                 // 1
-  vbroadcastss(ymm_beta1, xmm_beta1);             // beta1
-  vbroadcastss(ymm_beta2, xmm_beta2);             // beta2
-  vbroadcastss(ymm_lr, xmm_lr);                   // -lr
-  vbroadcastss(ymm_eps, xmm_eps);                 // eps
-  vsubps(ymm_one_sub_beta1, ymm_one, ymm_beta1);  // 1 - beta1
-  vsubps(ymm_one_sub_beta2, ymm_one, ymm_beta2);  // 1 - beta2
+  vbroadcastss(zmm_one, xmm_one);                 // 1
+  vbroadcastss(zmm_beta1, xmm_beta1);             // beta1
+  vbroadcastss(zmm_beta2, xmm_beta2);             // beta2
+  vbroadcastss(zmm_lr, xmm_lr);                   // -lr
+  vbroadcastss(zmm_eps, xmm_eps);                 // eps
+  vsubps(zmm_one_sub_beta1, zmm_one, zmm_beta1);  // 1 - beta1
+  vsubps(zmm_one_sub_beta2, zmm_one, zmm_beta2);  // 1 - beta2
 
   mov(reg_numel_without_tail, reg_numel);
-  and_(reg_numel_without_tail, mask_8_divisible);  // make it 8-divisible
+  and_(reg_numel_without_tail, mask_16_divisible);  // make it 16-divisible
 
   shl(reg_numel_without_tail, 2);  // * 4 to treat it as float offset
   shl(reg_numel, 2);
@@ -69,36 +69,36 @@ void AdamJitCode::setTailOpmask() {
 
 void AdamJitCode::mainCode() {
   // load grad
-  vmovups(ymm7 | k1, ptr[reg_grad_ptr + reg_offset]);
+  vmovups(zmm7 | k1, ptr[reg_grad_ptr + reg_offset]);
 
   // beta1 * mom1 + (1 - beta1) * g
-  vmulps(ymm8 | k1, ymm_one_sub_beta1, ymm7);
-  vfmadd231ps(ymm8 | k1, ymm_beta1, ptr[reg_mom1_ptr + reg_offset]);
+  vmulps(zmm8 | k1, zmm_one_sub_beta1, zmm7);
+  vfmadd231ps(zmm8 | k1, zmm_beta1, ptr[reg_mom1_ptr + reg_offset]);
 
   // beta2 * mom2 + (1 - beta2) * g * g
-  vmulps(ymm7 | k1, ymm7, ymm7);
-  vmulps(ymm7 | k1, ymm_one_sub_beta2, ymm7);
-  vfmadd231ps(ymm7 | k1, ymm_beta2, ptr[reg_mom2_ptr + reg_offset]);
+  vmulps(zmm7 | k1, zmm7, zmm7);
+  vmulps(zmm7 | k1, zmm_one_sub_beta2, zmm7);
+  vfmadd231ps(zmm7 | k1, zmm_beta2, ptr[reg_mom2_ptr + reg_offset]);
 
   // store mom1 and mom2
-  vmovups(ptr[reg_mom1_out_ptr + reg_offset] | k1, ymm8);
-  vmovups(ptr[reg_mom2_out_ptr + reg_offset] | k1, ymm7);
+  vmovups(ptr[reg_mom1_out_ptr + reg_offset] | k1, zmm8);
+  vmovups(ptr[reg_mom2_out_ptr + reg_offset] | k1, zmm7);
 
   // sqrt(mom2) + eps
-  vsqrtps(ymm7 | k1, ymm7);
-  vaddps(ymm7 | k1, ymm7, ymm_eps);
+  vsqrtps(zmm7 | k1, zmm7);
+  vaddps(zmm7 | k1, zmm7, zmm_eps);
 
   // p + (-lr) * (mom1 / sqrt(mom2) + eps)
-  vdivps(ymm7 | k1, ymm8, ymm7);
-  vfmadd213ps(ymm7 | k1, ymm_lr, ptr[reg_param_ptr + reg_offset]);
+  vdivps(zmm7 | k1, zmm8, zmm7);
+  vfmadd213ps(zmm7 | k1, zmm_lr, ptr[reg_param_ptr + reg_offset]);
 
   // store p
-  vmovups(ptr[reg_param_out_ptr + reg_offset] | k1, ymm7);
+  vmovups(ptr[reg_param_out_ptr + reg_offset] | k1, zmm7);
 }
 
 void AdamJitCode::genCode() {
   static constexpr int64_t main_loop_elems_size =
-      8 * sizeof(float);  // 8 floats in YMM
+      16 * sizeof(float);  // 16 floats in ZMM
   static constexpr int64_t offset_increment = main_loop_elems_size;
   preCode();
   loadArgs();
@@ -124,6 +124,7 @@ void AdamJitCode::genCode() {
   }
 
   L("end");
+  vzeroupper();
   postCode();
 }
 
@@ -58,16 +58,16 @@ class AdamWJitCode : public JitCode {
   xmm_t xmm_one_sub_beta2 = xmm_t(8);
   xmm_t xmm_one = xmm_t(9);
 
-  ymm_t ymm_beta1 = ymm_t(0);
-  ymm_t ymm_beta2 = ymm_t(1);
-  ymm_t ymm_lr = ymm_t(2);
-  ymm_t ymm_eps = ymm_t(3);
-  ymm_t ymm_old_lr = ymm_t(4);
-  ymm_t ymm_lr_ratio = ymm_t(5);
-  ymm_t ymm_coeff = ymm_t(6);
-  ymm_t ymm_one_sub_beta1 = ymm_t(7);
-  ymm_t ymm_one_sub_beta2 = ymm_t(8);
-  ymm_t ymm_one = ymm_t(9);
+  zmm_t zmm_beta1 = zmm_t(0);
+  zmm_t zmm_beta2 = zmm_t(1);
+  zmm_t zmm_lr = zmm_t(2);
+  zmm_t zmm_eps = zmm_t(3);
+  zmm_t zmm_old_lr = zmm_t(4);
+  zmm_t zmm_lr_ratio = zmm_t(5);
+  zmm_t zmm_coeff = zmm_t(6);
+  zmm_t zmm_one_sub_beta1 = zmm_t(7);
+  zmm_t zmm_one_sub_beta2 = zmm_t(8);
+  zmm_t zmm_one = zmm_t(9);
 
   reg64_t reg_mom2_out_ptr{r10};
   reg64_t reg_param_out_ptr{r11};
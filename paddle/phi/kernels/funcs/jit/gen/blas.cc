@@ -21,6 +21,10 @@
 namespace phi::jit::gen {
 
 void VXXJitCode::genCode() {
+  if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)) {
+    genCodeAVX512();
+    return;
+  }
   // do not need push stack, and do not need save avx512reg if do not use avx512
   int offset = 0;
   if (with_relu_) {
@@ -108,6 +112,60 @@ void VXXJitCode::genCode() {
   ret();
 }
 
+void VXXJitCode::genCodeAVX512() {
+  // only rax and k1 are used besides the params, both are caller-saved
+  const int num_blocks = num_ / ZMM_FLOAT_BLOCK;
+  const int rest = num_ % ZMM_FLOAT_BLOCK;
+  if (with_relu_) {
+    vpxord(zmm_zero, zmm_zero, zmm_zero);
+  }
+  if (scalar_index_ == 1) {
+    vbroadcastss(zmm_src1, ptr[param1]);
+  } else if (scalar_index_ == 2) {
+    vbroadcastss(zmm_src2, ptr[param2]);
+  }
+  if (rest > 0) {
+    mov(eax, (1 << rest) - 1);
+    kmovw(k1, eax);
+  }
+  int offset = 0;
+  for (int i = 0; i < num_blocks + (rest > 0 ? 1 : 0); ++i) {
+    const bool is_rest = i == num_blocks;
+    if (scalar_index_ != 1) {
+      if (is_rest) {
+        vmovups(zmm_src1 | k1 | T_z, ptr[param1 + offset]);
+      } else {
+        vmovups(zmm_src1, ptr[param1 + offset]);
+      }
+    }
+    if (scalar_index_ != 2) {
+      if (is_rest) {
+        vmovups(zmm_src2 | k1 | T_z, ptr[param2 + offset]);
+      } else {
+        vmovups(zmm_src2, ptr[param2 + offset]);
+      }
+    }
+    if (type_ == operand_type::MUL) {
+      vmulps(zmm_dst, zmm_src1, zmm_src2);
+    } else if (type_ == operand_type::ADD) {
+      vaddps(zmm_dst, zmm_src1, zmm_src2);
+    } else if (type_ == operand_type::SUB) {
+      vsubps(zmm_dst, zmm_src1, zmm_src2);
+    }
+    if (with_relu_) {
+      vmaxps(zmm_dst, zmm_zero, zmm_dst);
+    }
+    if (is_rest) {
+      vmovups(ptr[param3 + offset] | k1, zmm_dst);
+    } else {
+      vmovups(ptr[param3 + offset], zmm_dst);
+    }
+    offset += sizeof(float) * ZMM_FLOAT_BLOCK;
+  }
+  vzeroupper();
+  ret();
+}
+
 #define DECLARE_BLAS_CREATOR(name)                                           \
   class name##Creator : public JitCodeCreator<int> {                         \
    public:                                                                   \
@@ -23,7 +23,13 @@ namespace phi::jit::gen {
 void SeqPoolJitCode::genCode() {
   constexpr int block = YMM_FLOAT_BLOCK;
   constexpr int max_num_regs = 8;
-  const int num_block = w_ / block;
+  // with avx512f, pool the width in zmm blocks first and leave the rest of
+  // width to ymm and xmm
+  const int zmm_w =
+      phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)
+          ? w_ / ZMM_FLOAT_BLOCK * ZMM_FLOAT_BLOCK
+          : 0;
+  const int num_block = (w_ - zmm_w) / block;
   const int num_groups = num_block / max_num_regs;
   int rest_num_regs = num_block % max_num_regs;
   mov(reg32_int_h, dword[param_attr]);
@@ -40,17 +46,38 @@ void SeqPoolJitCode::genCode() {
     vdivps(xmm_t(1), xmm_t(1), xmm_t(0));
     vmovss(ptr[reg_tmp], xmm_t(1));
   }
+  const bool use_zmm = zmm_w > 0;
+  if (use_zmm) {
+    constexpr int zmm_block = ZMM_FLOAT_BLOCK;
+    constexpr int max_num_zmm_regs = 16;
+    const int num_zmm_block = w_ / zmm_block;
+    const int num_zmm_groups = num_zmm_block / max_num_zmm_regs;
+    const int rest_num_zmm_regs = num_zmm_block % max_num_zmm_regs;
+    const int zmm_group_len = max_num_zmm_regs * zmm_block * sizeof(float);
+    for (int g = 0; g < num_zmm_groups; ++g) {
+      pool_height<zmm_t>(g * zmm_group_len, zmm_block, max_num_zmm_regs);
+    }
+    if (rest_num_zmm_regs > 0) {
+      pool_height<zmm_t>(
+          num_zmm_groups * zmm_group_len, zmm_block, rest_num_zmm_regs);
+    }
+  }
   const int group_len = max_num_regs * block * sizeof(float);
+  const int ymm_offset = zmm_w * sizeof(float);
   for (int g = 0; g < num_groups; ++g) {
-    pool_height<ymm_t>(g * group_len, block, max_num_regs);
+    pool_height<ymm_t>(ymm_offset + g * group_len, block, max_num_regs);
   }
   if (rest_num_regs > 0) {
-    pool_height<ymm_t>(num_groups * group_len, block, rest_num_regs);
+    pool_height<ymm_t>(
+        ymm_offset + num_groups * group_len, block, rest_num_regs);
   }
   // part of rest_w * height
   const int rest = w_ % block;
   pool_height_of_rest_width(
       rest, static_cast<int>((w_ - rest) * sizeof(float)), max_num_regs);
+  if (use_zmm) {
+    vzeroupper();
+  }
   ret();
 }
 
@@ -54,6 +54,8 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kGRUHtPart2);
     ONE_CASE(kCRFDecoding);
     ONE_CASE(kLayerNorm);
+    ONE_CASE(kResidualLayerNorm);
+    ONE_CASE(kRMSNorm);
     ONE_CASE(kSeqPool);
     ONE_CASE(kMatMul);
     ONE_CASE(kAdam);
@@ -35,6 +35,8 @@ typedef enum {
   kLSTMC1H1,
   kLayerNorm,
   kMatMul,
+  kRMSNorm,
+  kResidualLayerNorm,
   kSeqPool,
   kVAdd,
   kVAddBias,
@@ -334,6 +336,35 @@ struct LayerNormTuple {
       T*, T*, T*, T*, const T*, const T*, int, const float, int);
 };
 
+// The residual may be nullptr, otherwise x + residual is normalized and
+// written to residual_out.
+template <typename T>
+struct ResidualLayerNormTuple {
+  static constexpr KernelType kernel_type = kResidualLayerNorm;
+  typedef T data_type;
+  typedef int attr_type;
+  typedef void (*func_type)(const T*,
+                            const T*,
+                            T*,
+                            T*,
+                            T*,
+                            T*,
+                            const T*,
+                            const T*,
+                            int,
+                            const float,
+                            int);
+};
+
+template <typename T>
+struct RMSNormTuple {
+  static constexpr KernelType kernel_type = kRMSNorm;
+  typedef T data_type;
+  typedef int attr_type;
+  typedef void (*func_type)(
+      const T*, const T*, T*, T*, const T*, int, const float, int);
+};
+
 // Just for adding to kernel pool without template
 class Kernel {
  public:
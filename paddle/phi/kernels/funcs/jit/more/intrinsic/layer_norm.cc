@@ -14,6 +14,7 @@
 
 #include "paddle/phi/kernels/funcs/jit/more/intrinsic/layer_norm.h"
 
+#include <cmath>
 #include <limits>
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
@@ -23,6 +24,183 @@ namespace phi {
 namespace jit {
 namespace more {
 namespace intrinsic {
+// Note: intrinsic code is not runtime build, the AVX512 code is only built
+// with AVX512 enabled, otherwise AVX is used.
+
+namespace {
+
+#ifdef __AVX512F__
+constexpr int kBlock = ZMM_FLOAT_BLOCK;
+using VecF = __m512;
+
+inline VecF VZero() { return _mm512_setzero_ps(); }
+inline VecF VSet1(float v) { return _mm512_set1_ps(v); }
+inline VecF VLoad(const float* p) { return _mm512_loadu_ps(p); }
+inline void VStore(float* p, VecF v) { _mm512_storeu_ps(p, v); }
+inline VecF VAdd(VecF a, VecF b) { return _mm512_add_ps(a, b); }
+inline VecF VSub(VecF a, VecF b) { return _mm512_sub_ps(a, b); }
+inline VecF VMul(VecF a, VecF b) { return _mm512_mul_ps(a, b); }
+// a * b + c
+inline VecF VFmadd(VecF a, VecF b, VecF c) { return _mm512_fmadd_ps(a, b, c); }
+inline float VReduceAdd(VecF v) { return _mm512_reduce_add_ps(v); }
+#else
+constexpr int kBlock = YMM_FLOAT_BLOCK;
+using VecF = __m256;
+
+inline VecF VZero() { return _mm256_setzero_ps(); }
+inline VecF VSet1(float v) { return _mm256_set1_ps(v); }
+inline VecF VLoad(const float* p) { return _mm256_loadu_ps(p); }
+inline void VStore(float* p, VecF v) { _mm256_storeu_ps(p, v); }
+inline VecF VAdd(VecF a, VecF b) { return _mm256_add_ps(a, b); }
+inline VecF VSub(VecF a, VecF b) { return _mm256_sub_ps(a, b); }
+inline VecF VMul(VecF a, VecF b) { return _mm256_mul_ps(a, b); }
+// a * b + c, FMA is not in AVX.
+inline VecF VFmadd(VecF a, VecF b, VecF c) {
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+}
+inline float VReduceAdd(VecF v) {
+  __m128 sum =
+      _mm_add_ps(_mm256_extractf128_ps(v, 1), _mm256_castps256_ps128(v));
+  sum = _mm_hadd_ps(sum, sum);
+  sum = _mm_hadd_ps(sum, sum);
+  return _mm_cvtss_f32(sum);
+}
+#endif
+
+// Writes h = x + residual to residual_out if residual is not nullptr, and
+// returns h.
+inline const float* AddResidual(const float* x,
+                                const float* residual,
+                                float* residual_out,
+                                int right) {
+  if (residual == nullptr) {
+    return x;
+  }
+  const int end = right - right % kBlock;
+  int j = 0;
+  for (; j < end; j += kBlock) {
+    VStore(residual_out + j, VAdd(VLoad(x + j), VLoad(residual + j)));
+  }
+  for (; j < right; ++j) {
+    residual_out[j] = x[j] + residual[j];
+  }
+  return residual_out;
+}
+
+// Computes the mean and the variance of a row in a single pass by the Welford
+// algorithm, in each lane for the full blocks, and then merges the lanes and
+// the rest elements.
+inline void WelfordMeanVar(const float* h, int right, float* mean, float* var) {
+  const int blocks = right / kBlock;
+  float count = 0.f;
+  float m = 0.f;
+  float m2 = 0.f;
+  if (blocks > 0) {
+    VecF mean_vec = VZero();
+    VecF m2_vec = VZero();
+    for (int b = 0; b < blocks; ++b) {
+      VecF x_vec = VLoad(h + b * kBlock);
+      VecF delta = VSub(x_vec, mean_vec);
+      mean_vec =
+          VFmadd(delta, VSet1(1.f / static_cast<float>(b + 1)), mean_vec);
+      m2_vec = VFmadd(delta, VSub(x_vec, mean_vec), m2_vec);
+    }
+    // All the lanes have the same count, so the mean is the mean of theirs.
+    alignas(64) float lane_means[kBlock];
+    VStore(lane_means, mean_vec);
+    m = VReduceAdd(mean_vec) / kBlock;
+    m2 = VReduceAdd(m2_vec);
+    for (int l = 0; l < kBlock; ++l) {
+      float d = lane_means[l] - m;
+      m2 += static_cast<float>(blocks) * d * d;
+    }
+    count = static_cast<float>(blocks * kBlock);
+  }
+  for (int j = blocks * kBlock; j < right; ++j) {
+    count += 1.f;
+    float delta = h[j] - m;
+    m += delta / count;
+    m2 += delta * (h[j] - m);
+  }
+  *mean = m;
+  *var = m2 / static_cast<float>(right);
+}
+
+inline float SquareSum(const float* h, int right) {
+  const int end = right - right % kBlock;
+  VecF sum_vec = VZero();
+  int j = 0;
+  for (; j < end; j += kBlock) {
+    VecF x_vec = VLoad(h + j);
+    sum_vec = VFmadd(x_vec, x_vec, sum_vec);
+  }
+  float sum = VReduceAdd(sum_vec);
+  for (; j < right; ++j) {
+    sum += h[j] * h[j];
+  }
+  return sum;
+}
+
+// out = (h - mean) * inv_std * scale + bias
+inline void Normalize(const float* h,
+                      float mean,
+                      float inv_std,
+                      const float* scale,
+                      const float* bias,
+                      int right,
+                      float* out) {
+  const int end = right - right % kBlock;
+  // (h - mean) * inv_std = h * inv_std + shift
+  const float shift = -mean * inv_std;
+  const VecF inv_std_vec = VSet1(inv_std);
+  const VecF shift_vec = VSet1(shift);
+  int j = 0;
+  for (; j < end; j += kBlock) {
+    VecF y = VFmadd(VLoad(h + j), inv_std_vec, shift_vec);
+    if (scale) y = VMul(y, VLoad(scale + j));
+    if (bias) y = VAdd(y, VLoad(bias + j));
+    VStore(out + j, y);
+  }
+  for (; j < right; ++j) {
+    float y = h[j] * inv_std + shift;
+    if (scale) y *= scale[j];
+    if (bias) y += bias[j];
+    out[j] = y;
+  }
+}
+
+}  // namespace
+
+void ResidualLayerNorm(const float* x,
+                       const float* residual,
+                       float* residual_out,
+                       float* out,
+                       float* mean,
+                       float* var,
+                       const float* scale,
+                       const float* bias,
+                       int height,
+                       const float epsilon,
+                       int right) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < height; ++i) {
+    const size_t offset = static_cast<size_t>(i) * right;
+    const float* h = AddResidual(x + offset,
+                                 residual ? residual + offset : nullptr,
+                                 residual_out + offset,
+                                 right);
+    WelfordMeanVar(h, right, mean + i, var + i);
+    Normalize(h,
+              mean[i],
+              1.f / std::sqrt(var[i] + epsilon),
+              scale,
+              bias,
+              right,
+              out + offset);
+  }
+}
 
 void LayerNorm(float* x,
                float* out,
@@ -33,156 +211,63 @@ void LayerNorm(float* x,
                int height,
                const float epsilon,
                int right) {
-  int block = YMM_FLOAT_BLOCK;
-  const int rest = right % block;
-  const int end = right - rest;
-#ifdef PADDLE_WITH_MKLML
-#pragma omp parallel
-  {
-#endif
-    __m256 sum;
-    __m256 mean_vec, var_vec;
-    __m128 hi, lo;
-    __m256 tmp = _mm256_setzero_ps();
-    size_t offset = 0;
-    size_t j = 0;
-    __m256 reverse_num_vec = _mm256_div_ps(
-        _mm256_set1_ps(1.0), _mm256_set1_ps(static_cast<float>(right)));
-    __m256 epsilon_vec = _mm256_set1_ps(epsilon);
-    int rest_mask = static_cast<int>(
-        ((-1) & (~((~0U) >> (sizeof(int) * 8 - (block - rest))))) & 0x0ff);
-    __m256i mask_vec =
-        _mm256_set_epi32(rest_mask & 0x80 ? 0xffffffff : 0,  // NOLINT
-                         rest_mask & 0x40 ? 0xffffffff : 0,  // NOLINT
-                         rest_mask & 0x20 ? 0xffffffff : 0,  // NOLINT
-                         rest_mask & 0x10 ? 0xffffffff : 0,  // NOLINT
-                         rest_mask & 0x8 ? 0xffffffff : 0,   // NOLINT
-                         rest_mask & 0x4 ? 0xffffffff : 0,   // NOLINT
-                         rest_mask & 0x2 ? 0xffffffff : 0,   // NOLINT
-                         rest_mask & 0x1 ? 0xffffffff : 0);  // NOLINT
+  ResidualLayerNorm(x,
+                    nullptr,
+                    nullptr,
+                    out,
+                    mean,
+                    var,
+                    scale,
+                    bias,
+                    height,
+                    epsilon,
+                    right);
+}
 
+void RMSNorm(const float* x,
+             const float* residual,
+             float* residual_out,
+             float* out,
+             const float* scale,
+             int height,
+             const float epsilon,
+             int right) {
 #ifdef PADDLE_WITH_MKLML
-#pragma omp for
+#pragma omp parallel for
 #endif
-    for (int i = 0; i < height; ++i) {
-      offset = i * right;
-
-      /* get mean */
-      sum = _mm256_setzero_ps();
-      for (j = offset; j < end + offset; j += block) {
-        sum = _mm256_add_ps(sum, _mm256_loadu_ps((const float*)x + j));
-      }
-      if (rest != 0) {
-        j = offset + right - block;
-        tmp = _mm256_loadu_ps((const float*)x + j);
-        tmp = _mm256_blendv_ps(_mm256_setzero_ps(),
-                               tmp,
-                               *(__m256*)&mask_vec);  // NOLINT
-        sum = _mm256_add_ps(sum, tmp);
-      }
-      hi = _mm256_extractf128_ps(sum, 1);
-      lo = _mm256_extractf128_ps(sum, 0);
-      sum = _mm256_add_ps(
-          sum,
-          _mm256_insertf128_ps(
-              _mm256_insertf128_ps(_mm256_setzero_ps(), hi, 0), lo, 1));
-      sum = _mm256_hadd_ps(sum, sum);
-      sum = _mm256_hadd_ps(sum, sum);
-      mean_vec = _mm256_mul_ps(sum, reverse_num_vec);
-      mean[i] = *reinterpret_cast<float*>(&mean_vec);
-
-      /* get variance */
-      sum = _mm256_setzero_ps();
-      for (j = offset; j < end + offset; j += block) {
-        tmp = _mm256_sub_ps(_mm256_loadu_ps((const float*)x + j), mean_vec);
-        tmp = _mm256_mul_ps(tmp, tmp);
-        sum = _mm256_add_ps(sum, tmp);
-      }
-      if (rest != 0) {
-        j = offset + right - block;
-        tmp = _mm256_sub_ps(_mm256_loadu_ps((const float*)x + j), mean_vec);
-        tmp = _mm256_mul_ps(tmp, tmp);
-        tmp = _mm256_blendv_ps(_mm256_setzero_ps(),
-                               tmp,
-                               *(__m256*)&mask_vec);  // NOLINT
-        sum = _mm256_add_ps(sum, tmp);
-      }
-      hi = _mm256_extractf128_ps(sum, 1);
-      lo = _mm256_extractf128_ps(sum, 0);
-      sum = _mm256_add_ps(
-          sum,
-          _mm256_insertf128_ps(
-              _mm256_insertf128_ps(_mm256_setzero_ps(), hi, 0), lo, 1));
-      sum = _mm256_hadd_ps(sum, sum);
-      sum = _mm256_hadd_ps(sum, sum);
-      var_vec = _mm256_mul_ps(sum, reverse_num_vec);
-      var[i] = *reinterpret_cast<float*>(&var_vec);
-
-      /* get x_norm and calculate output*/
-      for (j = offset; j < end + offset; j += block) {
-        tmp = _mm256_sub_ps(_mm256_loadu_ps((const float*)x + j), mean_vec);
-        tmp = _mm256_div_ps(
-            tmp, _mm256_sqrt_ps(_mm256_add_ps(var_vec, epsilon_vec)));
-        _mm256_storeu_ps(reinterpret_cast<float*>(out) + j, tmp);
-      }
-      if (rest != 0) {
-        j = offset + right - block;
-        tmp = _mm256_sub_ps(_mm256_loadu_ps((const float*)x + j), mean_vec);
-        tmp = _mm256_div_ps(
-            tmp, _mm256_sqrt_ps(_mm256_add_ps(var_vec, epsilon_vec)));
-        _mm256_storeu_ps(reinterpret_cast<float*>(out) + j, tmp);
-      }
-
-      if (scale) {
-        if (rest != 0) {
-          j = offset + right - block;
-          tmp = _mm256_loadu_ps((const float*)out + j);
-        }
-        for (j = offset; j < end + offset; j += block) {
-          _mm256_storeu_ps(
-              reinterpret_cast<float*>(out) + j,
-              _mm256_mul_ps(_mm256_loadu_ps((const float*)out + j),
-                            _mm256_loadu_ps((const float*)scale + j - offset)));
-        }
-        if (rest != 0) {
-          j = offset + right - block;
-          _mm256_storeu_ps(
-              reinterpret_cast<float*>(out) + j,
-              _mm256_mul_ps(tmp,
-                            _mm256_loadu_ps((const float*)scale + j - offset)));
-        }
-      }
-
-      if (bias) {
-        if (rest != 0) {
-          j = offset + right - block;
-          tmp = _mm256_loadu_ps((const float*)out + j);
-        }
-        for (j = offset; j < end + offset; j += block) {
-          _mm256_storeu_ps(
-              reinterpret_cast<float*>(out) + j,
-              _mm256_add_ps(_mm256_loadu_ps((const float*)out + j),
-                            _mm256_loadu_ps((const float*)bias + j - offset)));
-        }
-        if (rest != 0) {
-          j = offset + right - block;
-          _mm256_storeu_ps(
-              reinterpret_cast<float*>(out) + j,
-              _mm256_add_ps(tmp,
-                            _mm256_loadu_ps((const float*)bias + j - offset)));
-        }
-      }
-    }
-#ifdef PADDLE_WITH_MKLML
+  for (int i = 0; i < height; ++i) {
+    const size_t offset = static_cast<size_t>(i) * right;
+    const float* h = AddResidual(x + offset,
+                                 residual ? residual + offset : nullptr,
+                                 residual_out + offset,
+                                 right);
+    const float inv_rms =
+        1.f / std::sqrt(SquareSum(h, right) / static_cast<float>(right) +
+                        epsilon);
+    Normalize(h, 0.f, inv_rms, scale, nullptr, right, out + offset);
   }
+}
+
+#ifdef __AVX512F__
+#define NORM_KERNEL_ISA phi::backends::cpu::avx512f
+#else
+#define NORM_KERNEL_ISA phi::backends::cpu::avx
 #endif
+
+bool LayerNormKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(NORM_KERNEL_ISA);
 }
 
-bool LayerNormKernel::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
-         d >= YMM_FLOAT_BLOCK;
+bool ResidualLayerNormKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(NORM_KERNEL_ISA);
 }
 
+bool RMSNormKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(NORM_KERNEL_ISA);
+}
+
+#undef NORM_KERNEL_ISA
+
 }  // namespace intrinsic
 }  // namespace more
 }  // namespace jit
@@ -191,3 +276,7 @@ bool LayerNormKernel::CanBeUsed(const int& d) const {
 namespace intrinsic = phi::jit::more::intrinsic;
 
 REGISTER_JITKERNEL_MORE(kLayerNorm, intrinsic, intrinsic::LayerNormKernel);
+REGISTER_JITKERNEL_MORE(kResidualLayerNorm,
+                        intrinsic,
+                        intrinsic::ResidualLayerNormKernel);
+REGISTER_JITKERNEL_MORE(kRMSNorm, intrinsic, intrinsic::RMSNormKernel);
@@ -33,6 +33,27 @@ void LayerNorm(float* x,
                const float epsilon,
                int right);
 
+void ResidualLayerNorm(const float* x,
+                       const float* residual,
+                       float* residual_out,
+                       float* out,
+                       float* mean,
+                       float* var,
+                       const float* scale,
+                       const float* bias,
+                       int height,
+                       const float epsilon,
+                       int right);
+
+void RMSNorm(const float* x,
+             const float* residual,
+             float* residual_out,
+             float* out,
+             const float* scale,
+             int height,
+             const float epsilon,
+             int right);
+
 class LayerNormKernel : public KernelMore<LayerNormTuple<float>> {
  public:
   LayerNormKernel() { this->func = LayerNorm; }
@@ -41,6 +62,23 @@ class LayerNormKernel : public KernelMore<LayerNormTuple<float>> {
   const char* ImplType() const override { return "Intrinsic"; }
 };
 
+class ResidualLayerNormKernel
+    : public KernelMore<ResidualLayerNormTuple<float>> {
+ public:
+  ResidualLayerNormKernel() { this->func = ResidualLayerNorm; }
+  bool CanBeUsed(const typename ResidualLayerNormTuple<float>::attr_type&)
+      const override;
+  const char* ImplType() const override { return "Intrinsic"; }
+};
+
+class RMSNormKernel : public KernelMore<RMSNormTuple<float>> {
+ public:
+  RMSNormKernel() { this->func = RMSNorm; }
+  bool CanBeUsed(
+      const typename RMSNormTuple<float>::attr_type&) const override;
+  const char* ImplType() const override { return "Intrinsic"; }
+};
+
 }  // namespace intrinsic
 }  // namespace more
 }  // namespace jit
@@ -47,6 +47,8 @@ REGISTER_REFER_KERNEL(GRUHtPart2);
 
 REGISTER_REFER_KERNEL(CRFDecoding);
 REGISTER_REFER_KERNEL(LayerNorm);
+REGISTER_REFER_KERNEL(ResidualLayerNorm);
+REGISTER_REFER_KERNEL(RMSNorm);
 REGISTER_REFER_KERNEL(SeqPool);
 REGISTER_REFER_KERNEL(MatMul);
 REGISTER_REFER_KERNEL(EmbSeqPool);
@@ -353,6 +353,80 @@ void LayerNorm(T* x,
   }
 }
 
+// Normalizes x + residual, which is written to residual_out, if residual is
+// not nullptr.
+template <typename T>
+void ResidualLayerNorm(const T* x,
+                       const T* residual,
+                       T* residual_out,
+                       T* out,
+                       T* mean,
+                       T* var,
+                       const T* scale,
+                       const T* bias,
+                       int height,
+                       const float epsilon,
+                       int right) {
+  for (int i = 0; i < height; i++) {
+    int offset = i * right;
+    const T* h = x + offset;
+    if (residual) {
+      for (int j = 0; j < right; j++) {
+        residual_out[offset + j] = x[offset + j] + residual[offset + j];
+      }
+      h = residual_out + offset;
+    }
+    T sum = 0.0;
+    for (int j = 0; j < right; j++) {
+      sum += h[j];
+    }
+    mean[i] = sum / right;
+    sum = 0.0;
+    for (int j = 0; j < right; j++) {
+      sum += (h[j] - mean[i]) * (h[j] - mean[i]);
+    }
+    var[i] = sum / right;
+    T sqrt_var = std::sqrt(var[i] + (T)epsilon);
+    for (int j = 0; j < right; j++) {
+      T y = (h[j] - mean[i]) / sqrt_var;
+      if (scale) y *= scale[j];
+      if (bias) y += bias[j];
+      out[offset + j] = y;
+    }
+  }
+}
+
+// out = h / sqrt(mean(h * h) + epsilon) * scale, where h is x + residual,
+// which is written to residual_out, if residual is not nullptr.
+template <typename T>
+void RMSNorm(const T* x,
+             const T* residual,
+             T* residual_out,
+             T* out,
+             const T* scale,
+             int height,
+             const float epsilon,
+             int right) {
+  for (int i = 0; i < height; i++) {
+    int offset = i * right;
+    const T* h = x + offset;
+    if (residual) {
+      for (int j = 0; j < right; j++) {
+        residual_out[offset + j] = x[offset + j] + residual[offset + j];
+      }
+      h = residual_out + offset;
+    }
+    T sum = 0.0;
+    for (int j = 0; j < right; j++) {
+      sum += h[j] * h[j];
+    }
+    T inv_rms = static_cast<T>(1) / std::sqrt(sum / right + (T)epsilon);
+    for (int j = 0; j < right; j++) {
+      out[offset + j] = h[j] * inv_rms * (scale ? scale[j] : 1);
+    }
+  }
+}
+
 template <typename T>
 void SeqPool(const T* x, T* y, const seq_pool_attr_t* attr) {
   for (int w = 0; w < attr->w; ++w) {
@@ -600,6 +674,8 @@ DECLARE_REFER_KERNEL(GRUHtPart2);
 // others
 DECLARE_REFER_KERNEL(CRFDecoding);
 DECLARE_REFER_KERNEL(LayerNorm);
+DECLARE_REFER_KERNEL(ResidualLayerNorm);
+DECLARE_REFER_KERNEL(RMSNorm);
 DECLARE_REFER_KERNEL(SeqPool);
 DECLARE_REFER_KERNEL(MatMul);
 DECLARE_REFER_KERNEL(EmbSeqPool);
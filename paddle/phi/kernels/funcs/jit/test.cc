@@ -487,6 +487,114 @@ void TestKernelLayerNorm() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void TestKernelResidualLayerNorm() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const T epsilon = 9.99999975e-06;
+  for (bool with_residual : {false, true}) {
+    for (int left : {1, 9, 50}) {
+      for (int right : TestSizes()) {
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        int sz = left * right;
+        std::vector<T> x(sz), residual(sz), scale(right), bias(right);
+        std::vector<T> outref(sz), residual_outref(sz), meanref(left),
+            varref(left);
+        RandomVec<T>(sz, x.data());
+        RandomVec<T>(sz, residual.data());
+        RandomVec<T>(right, scale.data());
+        RandomVec<T>(right, bias.data());
+        const T* residual_data = with_residual ? residual.data() : nullptr;
+        ref(x.data(),
+            residual_data,
+            residual_outref.data(),
+            outref.data(),
+            meanref.data(),
+            varref.data(),
+            scale.data(),
+            bias.data(),
+            left,
+            epsilon,
+            right);
+
+        auto verifier = [&](const typename KernelTuple::func_type tgt,
+                            const typename KernelTuple::attr_type& right) {
+          EXPECT_TRUE(tgt != nullptr);
+          std::vector<T> out(sz), residual_out(sz), mean(left), var(left);
+          tgt(x.data(),
+              residual_data,
+              residual_out.data(),
+              out.data(),
+              mean.data(),
+              var.data(),
+              scale.data(),
+              bias.data(),
+              left,
+              epsilon,
+              right);
+          ExpectEQ<T>(out.data(), outref.data(), sz);
+          ExpectEQ<T>(mean.data(), meanref.data(), left);
+          ExpectEQ<T>(var.data(), varref.data(), left);
+          if (with_residual) {
+            ExpectEQ<T>(residual_out.data(), residual_outref.data(), sz);
+          }
+        };
+        TestAllImpls<KernelTuple, PlaceType>(right, verifier, right);
+      }
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelRMSNorm() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const T epsilon = 9.99999975e-06;
+  for (bool with_residual : {false, true}) {
+    for (int left : {1, 9, 50}) {
+      for (int right : TestSizes()) {
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        int sz = left * right;
+        std::vector<T> x(sz), residual(sz), scale(right), outref(sz),
+            residual_outref(sz);
+        RandomVec<T>(sz, x.data());
+        RandomVec<T>(sz, residual.data());
+        RandomVec<T>(right, scale.data());
+        const T* residual_data = with_residual ? residual.data() : nullptr;
+        ref(x.data(),
+            residual_data,
+            residual_outref.data(),
+            outref.data(),
+            scale.data(),
+            left,
+            epsilon,
+            right);
+
+        auto verifier = [&](const typename KernelTuple::func_type tgt,
+                            const typename KernelTuple::attr_type& right) {
+          EXPECT_TRUE(tgt != nullptr);
+          std::vector<T> out(sz), residual_out(sz);
+          tgt(x.data(),
+              residual_data,
+              residual_out.data(),
+              out.data(),
+              scale.data(),
+              left,
+              epsilon,
+              right);
+          ExpectEQ<T>(out.data(), outref.data(), sz);
+          if (with_residual) {
+            ExpectEQ<T>(residual_out.data(), residual_outref.data(), sz);
+          }
+        };
+        TestAllImpls<KernelTuple, PlaceType>(right, verifier, right);
+      }
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void TestKernelCRFDecoding() {
   using T = typename KernelTuple::data_type;
@@ -1463,6 +1571,8 @@ TEST_CPU_KERNEL(GRUHtPart1);
 TEST_CPU_KERNEL(GRUHtPart2);
 
 TEST_CPU_KERNEL(LayerNorm);
+TEST_CPU_KERNEL(ResidualLayerNorm);
+TEST_CPU_KERNEL(RMSNorm);
 TEST_CPU_KERNEL(CRFDecoding);
 
 TEST_CPU_KERNEL(SeqPool);
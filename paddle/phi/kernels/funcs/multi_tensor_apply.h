@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include "glog/logging.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/utils/optional.h"
 
 namespace phi {
 namespace funcs {
@@ -33,6 +36,9 @@ struct TensorAndBlockInfo {
   // int16
   uint16_t chunk_ids[MaxBlockSize];
   int start_chunk_id;
+  // The index of tensor_ids 0 in the whole input vector, for the functors
+  // which output per tensor results, such as the norms of LAMB.
+  int start_tensor_id;
 
   DEVICE void GetChunkIdAndTensorId(int *chunk_id, int *tensor_id) const {
     int block_id = blockIdx.x;
@@ -41,6 +47,10 @@ struct TensorAndBlockInfo {
                 (tmp_tensor_id == 0) * start_chunk_id;
     *tensor_id = tmp_tensor_id;
   }
+
+  DEVICE int GetGlobalTensorId(int tensor_id) const {
+    return start_tensor_id + tensor_id;
+  }
 };
 
 template <int N,
@@ -114,11 +124,15 @@ void LaunchMultiTensorApplyKernel(
 
   TensorAndBlockInfo<InputNum, MaxTensorSize, MaxBlockSize> t_info;
   t_info.start_chunk_id = 0;
+  t_info.start_tensor_id = 0;
 
   auto stream = dev_ctx.stream();
   int block_id = 0;
   int tensor_id = 0;
   for (int t = 0; t < tensors_size; t++) {
+    if (tensor_id == 0) {
+      t_info.start_tensor_id = t;
+    }
     t_info.sizes[tensor_id] = input_vector[0][t]->numel();
     t_info.grads[tensor_id] = grads[t]->data();
     for (int d = 0; d < InputNum - 1; d++) {
@@ -172,11 +186,58 @@ void LaunchMultiTensorApplyKernel(
           }
           tensor_id = 1;
           t_info.start_chunk_id = chunk + 1;
+          t_info.start_tensor_id = t;
         }
       }
     }
   }
 }
 
+// The inplace optimizers update the outputs, so the inputs are copied to them
+// only if they are not shared.
+template <typename Context>
+void CopyTensorIfDifferent(const Context &dev_ctx,
+                           const std::vector<const DenseTensor *> &src,
+                           const std::vector<DenseTensor *> &dst,
+                           bool use_src_place = false) {
+  for (size_t i = 0; i < src.size(); ++i) {
+    if (src[i] != dst[i]) {
+      VLOG(10) << "Copy Tensor " << i;
+      phi::Place place = (use_src_place ? src[i]->place() : dev_ctx.GetPlace());
+      phi::Copy<Context>(dev_ctx, *(src[i]), place, false, dst[i]);
+    }
+  }
+}
+
+template <typename T, typename TensorT>
+int GetVecSizeFromTensors(const std::vector<TensorT *> &tensors,
+                          int vec_size = 4) {
+  for (const auto *t : tensors) {
+    vec_size = std::min(vec_size, GetVectorizedSize(t->template data<T>()));
+  }
+  return vec_size;
+}
+
+// Returns the device pointer of skip_update for the functors to check, so that
+// the step is skipped without synchronizing with the host. skip_update on the
+// host is checked here directly.
+inline const bool *GetSkipUpdatePtr(
+    const paddle::optional<DenseTensor> &skip_update, bool *skip_on_host) {
+  *skip_on_host = false;
+  if (!skip_update) {
+    return nullptr;
+  }
+  PADDLE_ENFORCE_EQ(
+      skip_update->numel(),
+      1,
+      errors::InvalidArgument("Input(SkipUpdate) size must be 1, but get %d",
+                              skip_update->numel()));
+  if (skip_update->place().GetType() == AllocationType::CPU) {
+    *skip_on_host = skip_update->data<bool>()[0];
+    return nullptr;
+  }
+  return skip_update->data<bool>();
+}
+
 }  // namespace funcs
 }  // namespace phi
@@ -0,0 +1,92 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/nan_inf_flag.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace phi {
+namespace funcs {
+
+template <typename T>
+__global__ void MarkNanInfKernel(const T* data,
+                                 int64_t numel,
+                                 unsigned long long code,  // NOLINT
+                                 unsigned long long* flag) {  // NOLINT
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  // an earlier instruction is already reported
+  if (*static_cast<volatile unsigned long long*>(flag) <= code) {  // NOLINT
+    return;
+  }
+  int found = 0;
+  for (int64_t i = threadIdx.x + static_cast<int64_t>(blockIdx.x) * blockDim.x;
+       i < numel;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    MT value = static_cast<MT>(data[i]);
+    found |= (isnan(value) || isinf(value));
+  }
+  if (__syncthreads_or(found) && threadIdx.x == 0) {
+    atomicMin(flag, code);
+  }
+}
+
+template <typename T>
+void LaunchMarkNanInf(const phi::GPUContext& ctx,
+                      const DenseTensor& tensor,
+                      uint64_t code,
+                      uint64_t* flag) {
+  int64_t numel = tensor.numel();
+  if (numel <= 0) {
+    return;
+  }
+  const int threads = 512;
+  int blocks = static_cast<int>(
+      std::min(static_cast<int64_t>(ctx.GetSMCount()) * 4,
+               (numel + threads - 1) / threads));
+  MarkNanInfKernel<T><<<blocks, threads, 0, ctx.stream()>>>(
+      tensor.data<T>(),
+      numel,
+      static_cast<unsigned long long>(code),         // NOLINT
+      reinterpret_cast<unsigned long long*>(flag));  // NOLINT
+}
+
+bool MarkNanInfAsync(const phi::GPUContext& ctx,
+                     const DenseTensor& tensor,
+                     uint64_t code,
+                     uint64_t* flag) {
+  switch (tensor.dtype()) {
+    case DataType::FLOAT32:
+      LaunchMarkNanInf<float>(ctx, tensor, code, flag);
+      return true;
+    case DataType::FLOAT64:
+      LaunchMarkNanInf<double>(ctx, tensor, code, flag);
+      return true;
+    case DataType::FLOAT16:
+      LaunchMarkNanInf<phi::dtype::float16>(ctx, tensor, code, flag);
+      return true;
+    case DataType::BFLOAT16:
+      LaunchMarkNanInf<phi::dtype::bfloat16>(ctx, tensor, code, flag);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
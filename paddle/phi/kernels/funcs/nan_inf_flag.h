@@ -0,0 +1,36 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+class GPUContext;
+
+namespace funcs {
+
+// Lowers the device value `*flag` to `code` when `tensor` contains a nan or
+// an inf, as one kernel on the stream of `ctx` without synchronizing or
+// allocating. Tensors are skipped once `*flag` is already below `code`.
+// Returns false for dtypes that are not checked this way.
+bool MarkNanInfAsync(const phi::GPUContext& ctx,
+                     const DenseTensor& tensor,
+                     uint64_t code,
+                     uint64_t* flag);
+
+}  // namespace funcs
+}  // namespace phi
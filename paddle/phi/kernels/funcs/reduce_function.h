@@ -37,6 +37,8 @@ namespace cub = hipcub;
 #include "paddle/phi/backends/gpu/gpu_device_function.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/kernels/autotune/auto_tune_base.h"
+#include "paddle/phi/kernels/autotune/cache.h"
 #endif
 
 #include "paddle/phi/kernels/cast_kernel.h"
@@ -50,6 +52,10 @@ namespace cub = hipcub;
 #define REDUCE_SPLIT_BOUNDARY 512
 #define REDUCE_VEC_SIZE 4
 
+#ifndef PADDLE_WITH_XPU_KP
+COMMON_DECLARE_int32(reduce_single_launch);
+#endif
+
 namespace kps = phi::kps;
 #ifdef PADDLE_WITH_XPU_KP
 using dim3 = phi::kps::dim3;
@@ -58,6 +64,7 @@ using dim3 = phi::kps::dim3;
 #endif
 
 #include "paddle/common/array.h"
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/kernel_utils.h"
@@ -250,7 +257,11 @@ struct ReduceConfig {
   bool should_reduce_again = false;
   bool reduce_last_dim = false;
   bool vectorize_input = false;
+  // reduce the partial results in the last block done instead of launching
+  // the reduce kernel again
+  bool single_launch = false;
   MPType* tmp_data;
+  int* semaphores = nullptr;
   dim3 block;
   dim3 grid;
 
@@ -271,6 +282,9 @@ struct ReduceConfig {
 #ifndef PADDLE_WITH_XPU_KP
     // step5: limit the grid to prevent thead overflow
     phi::backends::gpu::LimitGridDim(dev_ctx, &grid);
+
+    // step6: whether to reduce the partial results in a single launch
+    SetSingleLaunch();
 #endif  // PADDLE_WITH_XPU_KP
   }
 
@@ -288,9 +302,19 @@ struct ReduceConfig {
                      const KPDevice& dev_ctx,
                      phi::DenseTensor* tmp) {
     if (should_reduce_again) {
-      tmp->Resize(common::make_ddim(
-          {static_cast<int64_t>(left_num * grid.z * grid.y)}));
+      int64_t tmp_num = static_cast<int64_t>(left_num * grid.z * grid.y);
+      int64_t semaphore_num = 0;
+#ifndef PADDLE_WITH_XPU_KP
+      // the counters of the blocks done, one for each column of blocks, are
+      // stored after the partial results
+      semaphore_num = details::CeilingDiv(
+          static_cast<int64_t>(grid.x * grid.z * sizeof(int)), sizeof(MPType));
+#endif
+      tmp->Resize(common::make_ddim({tmp_num + semaphore_num}));
       tmp_data = dev_ctx.Alloc<MPType>(tmp);
+      if (semaphore_num > 0) {
+        semaphores = reinterpret_cast<int*>(tmp_data + tmp_num);
+      }
     }
   }
 
@@ -559,8 +583,101 @@ struct ReduceConfig {
     block = block_dim;
     grid = grid_dim;
   }
+
+#ifndef PADDLE_WITH_XPU_KP
+  // If the reduction is split across the blocks along grid.y, the last block
+  // done of each column of blocks can reduce the partial results, which saves
+  // the launch of the second kernel. It matters when there are few outputs,
+  // e.g. reducing a huge tensor to a scalar, for which the second kernel
+  // launches only a few blocks.
+  void SetSingleLaunch() {
+    constexpr int kMaxSingleLaunchOutputs = 1024;
+    if (!should_reduce_again) {
+      single_launch = false;
+    } else if (FLAGS_reduce_single_launch < 0) {
+      single_launch = left_num * grid.z <= kMaxSingleLaunchOutputs;
+    } else {
+      single_launch = FLAGS_reduce_single_launch > 0;
+    }
+  }
+#endif
 };
 
+#ifndef PADDLE_WITH_XPU_KP
+// Called at the end of the reduce kernels whose partial results are stored in
+// tmp_data, the partial result of grid.y index i for column c is
+// tmp_data[(blockIdx.z * gridDim.y + i) * left_num + c]. Each block counts
+// itself as done for its column of blocks, and the last one reduces the
+// partial results of the columns [blockIdx.x * chunk_size, +chunk_size) of
+// each chunk, striding gridDim.x * chunk_size, into y.
+template <typename Ty, typename MPType, typename ReduceOp>
+__device__ __forceinline__ void ReduceLastBlockDone(Ty* y,
+                                                    const MPType* tmp_data,
+                                                    int* semaphores,
+                                                    ReduceOp reducer,
+                                                    MPType init,
+                                                    int left_num,
+                                                    int chunk_size,
+                                                    bool is_mean,
+                                                    int mean_div) {
+  __shared__ bool is_last_block;
+  __shared__ __align__(16) unsigned char
+      shared_buf[kps::details::kReduceMaxThread * sizeof(MPType)];
+  const int num_threads = blockDim.x * blockDim.y;
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+  const int num_partials = gridDim.y;
+
+  // make the partial results visible to the last block before counting
+  __threadfence();
+  __syncthreads();
+  if (tid == 0) {
+    int* semaphore = semaphores + blockIdx.z * gridDim.x + blockIdx.x;
+    is_last_block = atomicAdd(semaphore, 1) == num_partials - 1;
+  }
+  __syncthreads();
+  if (!is_last_block) {
+    return;
+  }
+  __threadfence();
+
+  MPType* shared = reinterpret_cast<MPType*>(shared_buf);
+  const MPType* partials = tmp_data + blockIdx.z * num_partials * left_num;
+  Ty* out = y + blockIdx.z * left_num;
+  for (int begin = blockIdx.x * chunk_size; begin < left_num;
+       begin += gridDim.x * chunk_size) {
+    // num_lanes threads reduce the partial results of a column
+    const int num_cols = min(chunk_size, left_num - begin);
+    const int num_lanes = num_threads / num_cols;
+    const int col = tid % num_cols;
+    const int lane = tid / num_cols;
+    if (lane < num_lanes) {
+      MPType reduce_var = init;
+      for (int i = lane; i < num_partials; i += num_lanes) {
+        reduce_var = reducer(reduce_var, partials[i * left_num + begin + col]);
+      }
+      shared[tid] = reduce_var;
+    }
+    __syncthreads();
+    for (int active = num_lanes; active > 1;) {
+      const int half = (active + 1) / 2;
+      if (lane + half < active) {
+        shared[tid] = reducer(shared[tid], shared[tid + half * num_cols]);
+      }
+      __syncthreads();
+      active = half;
+    }
+    if (tid < num_cols) {
+      MPType result = shared[tid];
+      if (is_mean) {
+        result = result / static_cast<MPType>(mean_div);
+      }
+      out[begin + tid] = static_cast<Ty>(result);
+    }
+    __syncthreads();
+  }
+}
+#endif
+
 // when reduce_dim.size() == 1 and reduce_dim[0] == x_dim.size() - 1, or
 // when reduce_dim.size() != 1 and reduce_dim.size() != x_dim.size(), this
 // function will be used
@@ -583,7 +700,9 @@ __global__ void ReduceAnyKernel(const Tx* x,
                                 const kps::DimConfig dim,
                                 bool is_mean,
                                 MPType* tmp_data,
-                                bool need_store_tmp = false) {
+                                bool need_store_tmp = false,
+                                int* semaphores = nullptr,
+                                bool is_final_mean = false) {
   int input_idx, left_idx, stride;
   int block_size = 0;
   bool need_store = true;
@@ -696,6 +815,21 @@ __global__ void ReduceAnyKernel(const Tx* x,
                                       static_cast<int>(need_store));
     }
   }
+
+#ifndef PADDLE_WITH_XPU_KP
+  if (semaphores != nullptr) {
+    ReduceLastBlockDone<Ty, MPType, ReduceOp>(
+        y,
+        tmp_data,
+        semaphores,
+        reducer,
+        init,
+        left_num,
+        reduce_last_dim ? blockDim.y : blockDim.x,
+        is_final_mean,
+        reduce_num);
+  }
+#endif
 }
 
 template <typename Tx,
@@ -715,7 +849,9 @@ __global__ void ReduceHigherDimKernel(const Tx* x,
                                       int mean_div,
                                       bool is_mean,
                                       MPType* tmp_data,
-                                      bool need_store_tmp = false) {
+                                      bool need_store_tmp = false,
+                                      int* semaphores = nullptr,
+                                      bool is_final_mean = false) {
   // when reduce_dim.size() == 1 and reduce_dim[0] != x_dim.size() - 1, this
   // function will be used
   auto block = ReduceIndexMapping<false>(dim);
@@ -785,6 +921,38 @@ __global__ void ReduceHigherDimKernel(const Tx* x,
           tmp_data + store_offset + idx, &reduce_var, dim.rem_x);
     }
   }
+
+#ifndef PADDLE_WITH_XPU_KP
+  if (semaphores != nullptr) {
+    ReduceLastBlockDone<Ty, MPType, ReduceOp>(y,
+                                              tmp_data,
+                                              semaphores,
+                                              reducer,
+                                              init,
+                                              left_num,
+                                              blockDim.x,
+                                              is_final_mean,
+                                              mean_div);
+  }
+#endif
+}
+
+// Returns the counters of the blocks done if the partial results are reduced
+// in the last block done, otherwise nullptr.
+template <typename Ty, typename MPType>
+static int* GetReduceSemaphores(const ReduceConfig<Ty, MPType>& config,
+                                KPStream stream) {
+#ifndef PADDLE_WITH_XPU_KP
+  if (config.should_reduce_again && config.single_launch) {
+    phi::backends::gpu::GpuMemsetAsync(
+        config.semaphores,
+        0,
+        sizeof(int) * config.grid.x * config.grid.z,
+        stream);
+    return config.semaphores;
+  }
+#endif
+  return nullptr;
 }
 
 template <typename Tx,
@@ -800,6 +968,7 @@ static void LaunchReduceKernel(const Tx* x_data,
                                KPStream stream,
                                ReduceConfig<Ty, MPType> config,
                                bool is_mean = false) {
+  int* semaphores = GetReduceSemaphores(config, stream);
   if (config.reduce_type == kReduceLastDim) {
     int stride_reduce = 1;
     int stride_left = config.reduce_num;
@@ -837,7 +1006,9 @@ static void LaunchReduceKernel(const Tx* x_data,
             dim,
             is_mean && (!config.should_reduce_again),
             config.tmp_data,
-            config.should_reduce_again);
+            config.should_reduce_again,
+            semaphores,
+            is_mean);
   } else {
     int reduce_rank = config.reduce_strides.size();
     int left_rank = config.left_strides.size();
@@ -878,10 +1049,12 @@ static void LaunchReduceKernel(const Tx* x_data,
             dim,
             is_mean && (!config.should_reduce_again),
             config.tmp_data,
-            config.should_reduce_again);
+            config.should_reduce_again,
+            semaphores,
+            is_mean);
   }
 
-  if (config.should_reduce_again) {
+  if (config.should_reduce_again && semaphores == nullptr) {
     dim3 block;
     dim3 grid;
     if (config.reduce_last_dim) {
@@ -924,6 +1097,142 @@ static void LaunchReduceKernel(const Tx* x_data,
   }
 }
 
+// launch ReduceHigherDimKernel
+// when reduce_dim.size() == 1 and reduce_dim[0] != x_dim.size() - 1, this
+// function will be used
+// eg: x_dim = {nz, ny, nx}, nx != 1, axis can be 0 or 1
+//     if axis = 1 then grid.z = nz, grid.y = ny / block_size, grid.x = nx /
+//     32
+//     else grid.z = 1, grid.y = ny / block_size, grid.x = nx /32
+template <typename Tx,
+          typename Ty,
+          typename MPType,
+          typename ReduceOp,
+          typename TransformOp>
+static void LaunchReduceHigherDimKernel(const Tx* x_data,
+                                        Ty* y_data,
+                                        const ReduceOp& reducer,
+                                        const TransformOp& transform,
+                                        MPType init,
+                                        KPStream stream,
+                                        ReduceConfig<Ty, MPType> config,
+                                        bool is_mean = false) {
+  int* semaphores = GetReduceSemaphores(config, stream);
+  kps::DimConfig dim = kps::DimConfig(config.grid.x,
+                                      config.grid.y,
+                                      config.grid.z,
+                                      config.block.x,
+                                      config.blocking_size,
+                                      0);
+  dim.SetRem(config.left_num % config.block.x,
+             config.reduce_num % config.blocking_size,
+             0);
+
+#ifdef PADDLE_WITH_XPU_KP
+  auto grid_num = 8;
+  auto block_num = 64;
+#else
+  auto grid_num = config.grid;
+  auto block_num = config.block;
+#endif
+  ReduceHigherDimKernel<Tx, Ty, MPType, ReduceOp, TransformOp>
+      <<<grid_num, block_num, 0, stream>>>(
+          x_data,
+          y_data,
+          reducer,
+          transform,
+          init,
+          config.reduce_num,
+          config.left_num,
+          config.blocking_size,
+          dim,
+          config.reduce_num,
+          is_mean && (!config.should_reduce_again),
+          config.tmp_data,
+          config.should_reduce_again,
+          semaphores,
+          is_mean);
+
+  if (config.should_reduce_again && semaphores == nullptr) {
+    dim3 block = dim3(config.block.x, 1, 1);
+    dim3 grid = dim3(config.grid.x, 1, config.grid.z);
+    kps::DimConfig dim2 =
+        kps::DimConfig(grid.x, grid.y, grid.z, block.x, config.grid.y, 0);
+    dim2.SetRem(config.left_num % config.block.x, 0, 0);
+
+#ifdef PADDLE_WITH_XPU_KP
+    int grid_size = 8;
+    int block_size = 64;
+#else
+    auto grid_size = grid;
+    auto block_size = block;
+#endif
+    ReduceHigherDimKernel<MPType,
+                          Ty,
+                          MPType,
+                          ReduceOp,
+                          kps::IdentityFunctor<MPType, MPType>>
+        <<<grid_size, block_size, 0, stream>>>(
+            config.tmp_data,
+            y_data,
+            reducer,
+            kps::IdentityFunctor<MPType, MPType>(config.grid.y),
+            init,
+            config.grid.y,
+            config.left_num,
+            config.grid.y,
+            dim2,
+            config.reduce_num,
+            is_mean,
+            config.tmp_data,
+            false);
+  }
+}
+
+// Launches the reduce kernels of the config, or of the config with the other
+// choice of single_launch if ToggleSingleLaunch, as the callbacks of the
+// reduce autotuner.
+template <typename Tx,
+          typename Ty,
+          typename MPType,
+          typename ReduceOp,
+          typename TransformOp,
+          bool ToggleSingleLaunch>
+static void LaunchReduceByConfig(const Tx* x_data,
+                                 Ty* y_data,
+                                 ReduceOp reducer,
+                                 TransformOp transform,
+                                 KPStream stream,
+                                 ReduceConfig<Ty, MPType> config,
+                                 bool is_mean) {
+  if (ToggleSingleLaunch) {
+    config.single_launch = !config.single_launch;
+  }
+  if (config.reduce_type == ReduceType::kReduceHigherDim) {
+    LaunchReduceHigherDimKernel<Tx, Ty, MPType, ReduceOp, TransformOp>(
+        x_data,
+        y_data,
+        reducer,
+        transform,
+        reducer.initial(),
+        stream,
+        config,
+        is_mean);
+  } else {
+    // when reduce_dim.size() == 1 and reduce_dim[0] == x_dim.size() - 1, or
+    // when reduce_dim.size() != 1 and reduce_dim.size() != x_dim.size(), this
+    // function will be used
+    LaunchReduceKernel<Tx, Ty, MPType, ReduceOp, TransformOp>(x_data,
+                                                              y_data,
+                                                              reducer,
+                                                              transform,
+                                                              reducer.initial(),
+                                                              stream,
+                                                              config,
+                                                              is_mean);
+  }
+}
+
 #if !defined(PADDLE_WITH_XPU_KP)
 
 template <typename Tx,
@@ -1105,96 +1414,43 @@ void ReduceKernel(const KPDevice& dev_ctx,
 #endif
 
   auto reducer = ReduceOp<MPType>();
-  // launch ReduceHigherDimKernel
-  // when reduce_dim.size() == 1 and reduce_dim[0] != x_dim.size() - 1, this
-  // function will be used
-  // eg: x_dim = {nz, ny, nx}, nx != 1, axis can be 0 or 1
-  //     if axis = 1 then grid.z = nz, grid.y = ny / block_size, grid.x = nx /
-  //     32
-  //     else grid.z = 1, grid.y = ny / block_size, grid.x = nx /32
-  if (config.reduce_type == ReduceType::kReduceHigherDim) {
-    kps::DimConfig dim = kps::DimConfig(config.grid.x,
-                                        config.grid.y,
-                                        config.grid.z,
-                                        config.block.x,
-                                        config.blocking_size,
-                                        0);
-    dim.SetRem(config.left_num % config.block.x,
-               config.reduce_num % config.blocking_size,
-               0);
-
-#ifdef PADDLE_WITH_XPU_KP
-    auto grid_num = 8;
-    auto block_num = 64;
-#else
-    auto grid_num = config.grid;
-    auto block_num = config.block;
-#endif
-    ReduceHigherDimKernel<Tx, Ty, MPType, ReduceOp<MPType>, TransformOp>
-        <<<grid_num, block_num, 0, stream>>>(
-            x_data,
-            y_data,
-            reducer,
-            transform,
-            reducer.initial(),
-            config.reduce_num,
-            config.left_num,
-            config.blocking_size,
-            dim,
-            config.reduce_num,
-            IsMean && (!config.should_reduce_again),
-            config.tmp_data,
-            config.should_reduce_again);
-
-    if (config.should_reduce_again) {
-      dim3 block = dim3(config.block.x, 1, 1);
-      dim3 grid = dim3(config.grid.x, 1, config.grid.z);
-      kps::DimConfig dim2 =
-          kps::DimConfig(grid.x, grid.y, grid.z, block.x, config.grid.y, 0);
-      dim2.SetRem(config.left_num % config.block.x, 0, 0);
-
-#ifdef PADDLE_WITH_XPU_KP
-      int grid_size = 8;
-      int block_size = 64;
-#else
-      auto grid_size = grid;
-      auto block_size = block;
-#endif
-      ReduceHigherDimKernel<MPType,
-                            Ty,
-                            MPType,
-                            ReduceOp<MPType>,
-                            kps::IdentityFunctor<MPType, MPType>>
-          <<<grid_size, block_size, 0, stream>>>(
-              config.tmp_data,
-              y_data,
-              reducer,
-              kps::IdentityFunctor<MPType, MPType>(config.grid.y),
-              reducer.initial(),
-              config.grid.y,
-              config.left_num,
-              config.grid.y,
-              dim2,
-              config.reduce_num,
-              IsMean,
-              config.tmp_data,
-              false);
-    }
+#ifndef PADDLE_WITH_XPU_KP
+  if (config.should_reduce_again) {
+    // tune whether the partial results of the blocks are reduced by a second
+    // kernel or by the last block done
+    auto* tuner = phi::autotune::MakeReduceTuner<Tx>(
+        LaunchReduceByConfig<Tx,
+                             Ty,
+                             MPType,
+                             ReduceOp<MPType>,
+                             TransformOp,
+                             false>);
+    tuner->AddCallBack(LaunchReduceByConfig<Tx,
+                                            Ty,
+                                            MPType,
+                                            ReduceOp<MPType>,
+                                            TransformOp,
+                                            true>);
+    size_t key =
+        phi::autotune::ReduceKey(config.x_dim,
+                                 config.reduce_dim,
+                                 phi::CppTypeToDataType<Tx>::Type(),
+                                 config.single_launch);
+    tuner->Run(dev_ctx,
+               phi::autotune::AlgorithmType::kReduce,
+               key,
+               x_data,
+               y_data,
+               reducer,
+               transform,
+               stream,
+               config,
+               IsMean);
     return;
   }
-
-  // when reduce_dim.size() == 1 and reduce_dim[0] == x_dim.size() - 1, or
-  // when reduce_dim.size() != 1 and reduce_dim.size() != x_dim.size(), this
-  // function will be used
-  LaunchReduceKernel<Tx, Ty, MPType, ReduceOp<MPType>, TransformOp>(
-      x_data,
-      y_data,
-      reducer,
-      transform,
-      reducer.initial(),
-      stream,
-      config,
-      IsMean);
+#endif
+  LaunchReduceByConfig<Tx, Ty, MPType, ReduceOp<MPType>, TransformOp, false>(
+      x_data, y_data, reducer, transform, stream, config, IsMean);
 }
 
 template <typename Tx,
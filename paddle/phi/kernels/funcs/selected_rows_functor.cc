@@ -15,21 +15,21 @@ limitations under the License. */
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
 #include <algorithm>
+#include <cstring>
 #include <map>
+#include <numeric>
 #include <set>
+#include <type_traits>
 #include <vector>
 
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 #ifdef PADDLE_WITH_XPU
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
 #endif
 
-#ifdef PADDLE_WITH_DNNL
-#include "paddle/phi/backends/onednn/axpy_handler.h"
-#endif
-
 #include "glog/logging.h"
 
 namespace phi {
@@ -435,66 +435,132 @@ typename std::enable_if<std::is_integral<T>::value>::type elementwise_add_to(
   }
 }
 
-template <typename T, typename DeviceContext>
-typename std::enable_if<std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-#ifndef PADDLE_WITH_DNNL
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-#endif
+void GroupRowsById(const std::vector<const phi::SelectedRows*>& inputs,
+                   MergedRows* merged) {
+  size_t row_num = 0;
   for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-#ifdef PADDLE_WITH_DNNL
-    OneDNNContext onednn_context(context.GetPlace());
-    funcs::OneDNNAXPYHandler<T> axpy_handler(
-        input_width, T(1.f), onednn_context.GetEngine());
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      axpy_handler(&input_data[i * input_width],
-                   &out_data[out_i * input_width]);
-    }
-#else
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
+    row_num += input->rows().size();
+  }
+  // linear probing at a load factor of at most 1/2, the slot of a row is
+  // the top bits of its Fibonacci hash
+  int bits = 4;
+  while ((size_t{1} << bits) < 2 * row_num) {
+    ++bits;
+  }
+  const size_t mask = (size_t{1} << bits) - 1;
+  std::vector<int64_t> keys(mask + 1);
+  std::vector<int64_t> ids(mask + 1, -1);
+  std::vector<int64_t> unique_rows;
+  // the id of every input row, in the order of the inputs
+  std::vector<int64_t> row_ids;
+  row_ids.reserve(row_num);
+  for (auto* input : inputs) {
+    for (int64_t row : input->rows()) {
+      size_t slot =
+          (static_cast<uint64_t>(row) * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+      while (ids[slot] >= 0 && keys[slot] != row) {
+        slot = (slot + 1) & mask;
+      }
+      if (ids[slot] < 0) {
+        keys[slot] = row;
+        ids[slot] = static_cast<int64_t>(unique_rows.size());
+        unique_rows.push_back(row);
+      }
+      row_ids.push_back(ids[slot]);
+    }
+  }
+
+  const size_t num_unique = unique_rows.size();
+  std::vector<size_t> order(num_unique);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return unique_rows[a] < unique_rows[b];
+  });
+  std::vector<size_t> rank(num_unique);
+  merged->rows.resize(num_unique);
+  for (size_t i = 0; i < num_unique; ++i) {
+    rank[order[i]] = i;
+    merged->rows[i] = unique_rows[order[i]];
+  }
+
+  merged->offsets.assign(num_unique + 1, 0);
+  for (auto id : row_ids) {
+    ++merged->offsets[rank[id] + 1];
+  }
+  std::partial_sum(merged->offsets.begin(),
+                   merged->offsets.end(),
+                   merged->offsets.begin());
+  std::vector<size_t> cursor(merged->offsets.begin(),
+                             merged->offsets.end() - 1);
+  merged->sources.resize(row_num);
+  size_t k = 0;
+  for (size_t j = 0; j < inputs.size(); ++j) {
+    for (size_t i = 0; i < inputs[j]->rows().size(); ++i, ++k) {
+      merged->sources[cursor[rank[row_ids[k]]]++] = {j, i};
     }
-#endif
   }
 }
 
-template <typename T, typename DeviceContext>
-typename std::enable_if<!std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-  VLOG(4) << "[CPU] add_sparse_inputs <" << typeid(T).name();
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
+// Adds a row to another, with the jit VAdd kernel for float and double.
+template <typename T, typename Enable = void>
+struct RowAdder {
+  explicit RowAdder(int64_t width) : width_(width) {}
+
+  void operator()(const T* in, T* out) const {
+    for (int64_t i = 0; i < width_; ++i) {
+      out[i] += in[i];
     }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
+  }
 
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
+  int64_t width_;
+};
+
+template <typename T>
+struct RowAdder<T,
+                typename std::enable_if<std::is_same<T, float>::value ||
+                                        std::is_same<T, double>::value>::type> {
+  explicit RowAdder(int64_t width)
+      : width_(static_cast<int>(width)),
+        vadd_(phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
+                                    phi::CPUPlace>::Cache()
+                  .At(width_)) {}
+
+  void operator()(const T* in, T* out) const { vadd_(in, out, out, width_); }
+
+  int width_;
+  typename phi::jit::VAddTuple<T>::func_type vadd_;
+};
+
+// Writes the sum of the sources of every merged row to its output row, the
+// output rows in parallel.
+template <typename T>
+void AddMergedRows(const std::vector<const phi::SelectedRows*>& inputs,
+                   const MergedRows& merged,
+                   int64_t input_width,
+                   T* out_data) {
+  std::vector<const T*> input_data(inputs.size(), nullptr);
+  for (size_t j = 0; j < inputs.size(); ++j) {
+    if (!inputs[j]->rows().empty()) {
+      input_data[j] = inputs[j]->value().data<T>();
+    }
+  }
+  const RowAdder<T> add_row(input_width);
+  const int64_t num_rows = static_cast<int64_t>(merged.rows.size());
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num_rows; ++i) {
+    T* out = out_data + i * input_width;
+    const size_t begin = merged.offsets[i];
+    const size_t end = merged.offsets[i + 1];
+    for (size_t k = begin; k < end; ++k) {
+      const auto& source = merged.sources[k];
+      const T* in = input_data[source.first] + source.second * input_width;
+      if (k == begin) {
+        std::memcpy(out, in, input_width * sizeof(T));
+      } else {
+        add_row(in, out);
+      }
     }
   }
 }
@@ -540,7 +606,6 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
     size_t row_num = 0;
     for (auto* input : inputs) {
       if (input->rows().empty()) {
@@ -556,16 +621,17 @@ struct MergeAddImpl {
                         common::errors::InvalidArgument(
                             "All inputs should have same height."));
       row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
     }
+    MergedRows merged;
+    GroupRowsById(inputs, &merged);
 
     out.set_height(input_height);
     DenseTensor* out_tensor = out.mutable_value();
     out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+        {static_cast<int64_t>(merged.rows.size()), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (merged.rows.size() == row_num && !sorted_result) {
       // no duplicated ids, just concat the result together
       std::vector<int64_t> merge_rows;
       merge_rows.reserve(row_num);
@@ -589,25 +655,9 @@ struct MergeAddImpl {
         copied_numel += static_cast<int64_t>(in_numel);
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
-      }
-
-      out.set_rows(merge_rows);
-
-      phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-      constant_functor(context, out.mutable_value(), static_cast<T>(0.f));
-
-      std::unordered_map<int64_t, size_t> rows_to_id;
-      for (size_t i = 0; i < merge_rows.size(); ++i) {
-        rows_to_id[merge_rows[i]] = i;
-      }
-
-      add_sparse_inputs<T, DeviceContext>(
-          inputs, rows_to_id, input_width, context, out_data);
+      // the rows are sorted either way
+      out.set_rows(merged.rows);
+      AddMergedRows<T>(inputs, merged, input_width, out_data);
     }
   }
 };
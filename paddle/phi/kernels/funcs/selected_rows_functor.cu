@@ -12,14 +12,17 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
 #include "glog/logging.h"
 
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/float16.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
@@ -342,32 +345,27 @@ template struct SelectedRowsAddToTensor<phi::GPUContext,
 
 namespace scatter {
 
-template <typename T, int block_size>
-__global__ void MergeAddKernel(const T* input,
-                               const int64_t* input_rows,
-                               T* out,
-                               const int64_t* out_rows,
-                               size_t out_rows_size,
-                               int64_t row_numel) {
-  const int ty = blockIdx.x;
-  int tid = threadIdx.x;
-  __shared__ size_t out_idx;
-
-  if (tid == 0) {
-    for (size_t i = 0; i < out_rows_size; i++) {
-      if (input_rows[ty] == out_rows[i]) {
-        out_idx = i;
+// One block per merged row sums its input rows in their order, so the merge
+// is deterministic and needs neither atomics nor a zeroed output.
+template <typename T>
+__global__ void MergeAddSegmentsKernel(const T* const* sources,
+                                       const size_t* offsets,
+                                       int64_t num_rows,
+                                       int64_t row_numel,
+                                       T* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  for (int64_t i = blockIdx.x; i < num_rows; i += gridDim.x) {
+    const size_t begin = offsets[i];
+    const size_t end = offsets[i + 1];
+    T* out_row = out + i * row_numel;
+    for (int64_t j = threadIdx.x; j < row_numel; j += blockDim.x) {
+      MT sum = static_cast<MT>(sources[begin][j]);
+      for (size_t k = begin + 1; k < end; ++k) {
+        sum += static_cast<MT>(sources[k][j]);
       }
+      out_row[j] = static_cast<T>(sum);
     }
   }
-
-  __syncthreads();
-
-  input += ty * row_numel;
-  out += out_idx * row_numel;
-  for (int index = tid; index < row_numel; index += block_size) {
-    phi::CudaAtomicAdd(out + index, input[index]);
-  }
 }
 
 template <typename DeviceContext, typename T>
@@ -384,45 +382,9 @@ struct MergeAddImpl {
                   const phi::SelectedRows& input,
                   phi::SelectedRows* output,
                   const bool sorted_result = false) {
-    phi::Vector<int64_t> input_rows(input.rows());
-    if (input_rows.size() == 0) {
-      return;
-    }
-
-    phi::SelectedRows& out = *output;
-    std::set<int64_t> row_set(input_rows.begin(), input_rows.end());
-    std::vector<int64_t> merge_rows_cpu(row_set.begin(), row_set.end());
-    phi::Vector<int64_t> merge_rows(merge_rows_cpu);
-
-    auto input_width = input.value().dims()[1];
-
-    out.set_rows(merge_rows);
-    out.set_height(input.height());
-    DenseTensor* out_tensor = out.mutable_value();
-    out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merge_rows.size()), input_width}));
-    context.template Alloc<T>(out_tensor);
-
-    phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-    constant_functor(context, out.mutable_value(), static_cast<T>(0));
-
-    auto* out_data = out.mutable_value()->data<T>();
-    auto* input_data = input.value().data<T>();
-
-    const int block_size = 256;
-    dim3 threads(block_size, 1);
-    dim3 grid1(input_rows.size(), 1);
-
-    phi::MixVector<int64_t> mix_vector_input(&input_rows);
-    phi::MixVector<int64_t> mix_vector_out(out.mutable_rows());
-    MergeAddKernel<T, 256><<<grid1, threads, 0, context.stream()>>>(
-        input_data,
-        mix_vector_input.CUDAData(context.GetPlace()),
-        out_data,
-        mix_vector_out.CUDAMutableData(context.GetPlace()),
-        out.rows().size(),
-        input_width);
-    mix_vector_out.CopyToCPU();
+    std::vector<const phi::SelectedRows*> inputs;
+    inputs.push_back(&input);
+    (*this)(context, inputs, output, sorted_result);
   }
 
   void operator()(const DeviceContext& context,
@@ -447,7 +409,6 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
     for (auto* input : inputs) {
       if (input->rows().size() == 0) {
         continue;
@@ -461,47 +422,52 @@ struct MergeAddImpl {
                         input->height(),
                         common::errors::InvalidArgument(
                             "All input should have same height."));
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
     }
-    std::vector<int64_t> merge_rows_cpu(merged_row_set.begin(),
-                                        merged_row_set.end());
-    phi::Vector<int64_t> merge_rows(merge_rows_cpu);
+    MergedRows merged;
+    GroupRowsById(inputs, &merged);
 
-    out.set_rows(merge_rows);
+    out.set_rows(merged.rows);
     out.set_height(input_height);
 
     DenseTensor* out_tensor = out.mutable_value();
-    out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merge_rows.size()), input_width}));
-    context.template Alloc<T>(out_tensor);
-
-    phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-    constant_functor(context, out.mutable_value(), static_cast<T>(0));
-
-    auto* out_data = out.mutable_value()->data<T>();
+    const int64_t num_rows = static_cast<int64_t>(merged.rows.size());
+    out_tensor->Resize(common::make_ddim({num_rows, input_width}));
+    auto* out_data = context.template Alloc<T>(out_tensor);
+
+    // the address of every input row, in the order of the merged rows
+    std::vector<const T*> sources(merged.sources.size());
+    for (size_t k = 0; k < sources.size(); ++k) {
+      const auto& source = merged.sources[k];
+      sources[k] = inputs[source.first]->value().data<T>() +
+                   source.second * input_width;
+    }
+    const size_t sources_bytes = sources.size() * sizeof(const T*);
+    const size_t offsets_bytes = merged.offsets.size() * sizeof(size_t);
+    auto sources_gpu = memory_utils::Alloc(context.GetPlace(), sources_bytes);
+    auto offsets_gpu = memory_utils::Alloc(context.GetPlace(), offsets_bytes);
+    memory_utils::Copy(context.GetPlace(),
+                       sources_gpu->ptr(),
+                       phi::CPUPlace(),
+                       sources.data(),
+                       sources_bytes,
+                       context.stream());
+    memory_utils::Copy(context.GetPlace(),
+                       offsets_gpu->ptr(),
+                       phi::CPUPlace(),
+                       merged.offsets.data(),
+                       offsets_bytes,
+                       context.stream());
 
     const int block_size = 256;
+    const int64_t max_grid = context.GetCUDAMaxGridDimSize()[0];
     dim3 threads(block_size, 1);
-
-    for (auto* input : inputs) {
-      if (input->rows().size() == 0) {
-        continue;
-      }
-      auto* input_data = input->value().data<T>();
-      auto& input_rows = input->rows();
-      dim3 grid1(input_rows.size(), 1);
-
-      phi::MixVector<int64_t> mix_vector_input(&input_rows);
-      phi::MixVector<int64_t> mix_vector_out(out.mutable_rows());
-      MergeAddKernel<T, 256><<<grid1, threads, 0, context.stream()>>>(
-          input_data,
-          mix_vector_input.CUDAData(context.GetPlace()),
-          out_data,
-          mix_vector_out.CUDAMutableData(context.GetPlace()),
-          out.rows().size(),
-          input_width);
-      mix_vector_out.CopyToCPU();
-    }
+    dim3 grid(std::min(num_rows, max_grid), 1);
+    MergeAddSegmentsKernel<T><<<grid, threads, 0, context.stream()>>>(
+        reinterpret_cast<const T* const*>(sources_gpu->ptr()),
+        reinterpret_cast<const size_t*>(offsets_gpu->ptr()),
+        num_rows,
+        input_width,
+        out_data);
   }
 };
 
@@ -14,6 +14,7 @@ limitations under the License. */
 #pragma once
 
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "paddle/phi/backends/all_context.h"
@@ -77,6 +78,21 @@ struct SelectedRowsAddToTensor {
 };
 
 namespace scatter {
+
+// The rows of the inputs of a merge grouped by their id. The i-th of the
+// sorted unique `rows` sums the input rows sources[offsets[i]:offsets[i+1]],
+// each an (input index, row index) pair in the order of the inputs.
+struct MergedRows {
+  std::vector<int64_t> rows;
+  std::vector<size_t> offsets;
+  std::vector<std::pair<size_t, size_t>> sources;
+};
+
+// Groups the rows with an open-addressing hash map, linear in the number of
+// input rows besides sorting the unique ones.
+void GroupRowsById(const std::vector<const phi::SelectedRows*>& inputs,
+                   MergedRows* merged);
+
 // functors for manipulating SelectedRows data
 template <typename DeviceContext, typename T>
 struct MergeAdd {
@@ -79,11 +79,10 @@ class CopyMatrixRowsFunctor<phi::GPUContext, T> {
     dim3 threads(128, 8);
     dim3 grid(8, 1);
     auto stream = context.stream();
-    phi::MixVector<size_t> mix_index_lod(&index_lod);
     CopyMatrixRowsKernel<T, 128, 8, 8><<<grid, threads, 0, stream>>>(
         src_data,
         dst_data,
-        mix_index_lod.CUDAData(context.GetPlace()),
+        phi::CachedCUDAOffsets(index_lod, context),
         height,
         width,
         is_src_index);
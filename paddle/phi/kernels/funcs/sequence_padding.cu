@@ -123,13 +123,12 @@ class PaddingLoDTensorFunctor<phi::GPUContext, T> {
     T* pad_data = pad_tensor->data<T>();
     const T* pad_value_data = pad_value.data<T>();
 
-    phi::MixVector<size_t> mix_vector_seq_offsets(&seq_offsets);
     SequencePaddingKernel<T, kSeqToPad><<<grid, threads, 0, context.stream()>>>(
         pad_data,
         seq_data,
         pad_value_data,
         pad_value.numel() == 1,
-        mix_vector_seq_offsets.CUDAData(context.GetPlace()),
+        phi::CachedCUDAOffsets(seq_offsets, context),
         seq_num,
         pad_seq_len,
         step_width,
@@ -190,13 +189,12 @@ class UnpaddingLoDTensorFunctor<phi::GPUContext, T> {
     const T* pad_data = pad_tensor.data<T>();
     T* seq_data = seq_tensor->data<T>();
 
-    phi::MixVector<size_t> mixv_seq_offsets(&seq_offsets);
     SequencePaddingKernel<T, kPadToSeq><<<grid, threads, 0, context.stream()>>>(
         seq_data,
         pad_data,
         nullptr,
         false,
-        mixv_seq_offsets.CUDAData(context.GetPlace()),
+        phi::CachedCUDAOffsets(seq_offsets, context),
         seq_num,
         pad_seq_len,
         step_width,
@@ -245,25 +245,23 @@ class SoftmaxFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
     const int batch_size = in_dims[kBatchDim];
     const int num_remain = num_classes / axis_dim;
 
-    if (num_remain == 1 &&
-        phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
+    if (num_remain == 1) {
+      // online softmax in cache sized blocks, the generic loops are left to
+      // the compiler to vectorize when avx is not available, e.g. on arm
       const T* in_data = X->data<T>();
       T* out_data = Y->data<T>();
+      std::vector<T> block_max(softmax_num_blocks(num_classes));
+      const bool use_avx =
+          phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
       for (int bs = 0; bs < batch_size; ++bs) {
-        T max_val = *std::max_element(in_data, in_data + num_classes);
-        max_val *= static_cast<T>(-1);
-        vec_add_bias<T, phi::backends::cpu::avx>(
-            num_classes, max_val, in_data, out_data);
-        vec_clip<T, phi::backends::cpu::avx>(
-            num_classes, static_cast<T>(-64), out_data, out_data);
-        vec_exp<T>(num_classes, out_data, out_data);
-
-        T sum = 0;
-        vec_sum<T, phi::backends::cpu::avx>(num_classes, out_data, &sum);
-        sum = static_cast<T>(1) / sum;
-        vec_scal<T, phi::backends::cpu::avx>(
-            num_classes, sum, out_data, out_data);
-
+        T max_val, sum;
+        if (use_avx) {
+          vec_softmax<T, phi::backends::cpu::avx>(
+              num_classes, in_data, out_data, block_max.data(), &max_val, &sum);
+        } else {
+          vec_softmax<T>(
+              num_classes, in_data, out_data, block_max.data(), &max_val, &sum);
+        }
         in_data += num_classes;
         out_data += num_classes;
       }
@@ -14,6 +14,9 @@ limitations under the License. */
 
 #pragma once
 
+#include <sstream>
+#include <string>
+
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/kmap_cache.h"
 #include "paddle/phi/core/tensor_utils.h"
@@ -254,7 +257,8 @@ inline const IntT* PrepareSubm(const Context& dev_ctx,
                                int* counter,
                                int* offsets,
                                int* rulebook_len,
-                               bool* need_product_rulebook) {
+                               bool* need_product_rulebook,
+                               bool share_indices = false) {
   const auto* indices_pairs = x.IndicesPairs(key);
   if (indices_pairs != nullptr) {
     *need_product_rulebook = false;
@@ -266,12 +270,20 @@ inline const IntT* PrepareSubm(const Context& dev_ctx,
 
     *rulebook_len = rulebook.dims()[1];
 
-    DenseTensor out_indices =
-        phi::EmptyLike<IntT>(dev_ctx, x.non_zero_indices());
-    DenseTensor out_values = phi::EmptyLike<T>(dev_ctx, x.non_zero_elements());
-    phi::Copy(
-        dev_ctx, x.non_zero_indices(), dev_ctx.GetPlace(), false, &out_indices);
-    out->SetMember(out_indices, out_values, out_dims, false);
+    DenseTensor out_values =
+        phi::Empty<T>(dev_ctx, {x.nnz(), out_dims[out_dims.size() - 1]});
+    if (share_indices) {
+      out->SetMember(x.non_zero_indices(), out_values, out_dims, false);
+    } else {
+      DenseTensor out_indices =
+          phi::EmptyLike<IntT>(dev_ctx, x.non_zero_indices());
+      phi::Copy(dev_ctx,
+                x.non_zero_indices(),
+                dev_ctx.GetPlace(),
+                false,
+                &out_indices);
+      out->SetMember(out_indices, out_values, out_dims, false);
+    }
     PrefixSum<int>(counter, offsets, counter_size);
     return rulebook.data<IntT>();
   }
@@ -298,6 +310,86 @@ inline void SaveToTable(const Context& dev_ctx,
   }
 }
 
+// The key of the rulebook that a subm conv without a key reuses
+// automatically. The output of such a conv shares the indices of its input,
+// so the address of the indices identifies the input across the layers. The
+// rulebook does not depend on the channels, so only the spatial kernel sizes
+// are a part of the key.
+inline std::string SubmRulebookKey(const SparseCooTensor& x,
+                                   const std::vector<int>& kernel_sizes,
+                                   const std::vector<int>& dilations) {
+  std::ostringstream key;
+  key << "__subm_rulebook_" << x.indices().data() << "_" << x.nnz() << "_"
+      << x.dims();
+  for (size_t i = 0; i + 2 < kernel_sizes.size(); ++i) {
+    key << "_" << kernel_sizes[i];
+  }
+  for (int dilation : dilations) {
+    key << "_" << dilation;
+  }
+  return key.str();
+}
+
+// Returns the rulebook and the counter of a subm conv without a key, like
+// SaveToTable, and also saves them by the key of SubmRulebookKey. The output
+// shares the indices of x, and the indices are saved too, which keeps their
+// address from being recycled by the other indices while the key is alive.
+template <typename Context>
+inline void SaveToTableBySubmKey(const Context& dev_ctx,
+                                 const SparseCooTensor& x,
+                                 const std::string& subm_key,
+                                 const DenseTensor& in_rulebook,
+                                 const DenseTensor& h_counter,
+                                 SparseCooTensor* out,
+                                 DenseTensor* out_rulebook,
+                                 DenseTensor* counter) {
+  SaveToTable(dev_ctx,
+              x,
+              /*key=*/"",
+              in_rulebook,
+              h_counter,
+              out,
+              out_rulebook,
+              counter);
+  out->SetMember(x.non_zero_indices(), out->values(), out->dims(), false);
+  out->SaveIndicesPairs(subm_key, std::make_pair(in_rulebook, *counter));
+  out->SaveIndicesPairs(subm_key + "_indices",
+                        std::make_pair(x.non_zero_indices(), DenseTensor()));
+}
+
+// Like PrepareSubm by the key of SubmRulebookKey, the reused rulebook and
+// counter are also returned as the outputs for the grad kernel.
+template <typename T, typename IntT, typename Context>
+inline const IntT* PrepareSubmBySubmKey(const Context& dev_ctx,
+                                        const SparseCooTensor& x,
+                                        const std::string& subm_key,
+                                        const DDim& out_dims,
+                                        SparseCooTensor* out,
+                                        int* counter,
+                                        int* offsets,
+                                        int* rulebook_len,
+                                        bool* need_product_rulebook,
+                                        DenseTensor* out_rulebook,
+                                        DenseTensor* out_counter) {
+  const IntT* rulebook_ptr =
+      PrepareSubm<T, IntT, Context>(dev_ctx,
+                                    x,
+                                    subm_key,
+                                    out_dims,
+                                    out,
+                                    counter,
+                                    offsets,
+                                    rulebook_len,
+                                    need_product_rulebook,
+                                    /*share_indices=*/true);
+  if (!*need_product_rulebook) {
+    const auto* indices_pairs = x.IndicesPairs(subm_key);
+    *out_rulebook = indices_pairs->first;
+    *out_counter = indices_pairs->second;
+  }
+  return rulebook_ptr;
+}
+
 }  // namespace sparse
 }  // namespace funcs
 }  // namespace phi
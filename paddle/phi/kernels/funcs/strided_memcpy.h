@@ -10,11 +10,16 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <type_traits>
 #include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/detail/strided_memcpy.h"
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+#include "paddle/phi/backends/custom/custom_context.h"
+#include "paddle/phi/backends/device_manager.h"
+#endif
 
 namespace phi {
 class CPUContext;
@@ -75,6 +80,21 @@ inline void CopyWithContext<phi::CPUContext>(const phi::CPUContext& ctx UNUSED,
   memory_utils::Copy(dst_place, dst, src_place, src, num);
 }
 
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+// The device to device copies on a custom device in a single call, since the
+// calls of the custom devices may have a high overhead.
+inline void CopyD2DBatchWithContext(const phi::CustomContext& ctx,
+                                    const std::vector<void*>& dsts,
+                                    const std::vector<const void*>& srcs,
+                                    const std::vector<size_t>& sizes) {
+  phi::DeviceManager::SetDevice(ctx.GetPlace());
+  phi::stream::Stream stream(ctx.GetPlace(), ctx.stream());
+  phi::DeviceManager::GetDeviceWithPlace(ctx.GetPlace())
+      ->MemoryCopyD2DBatch(
+          dsts.data(), srcs.data(), sizes.data(), dsts.size(), &stream);
+}
+#endif
+
 // Strided numel memory copy from src to dst by the specified axis
 //
 // For example, for a tensor dims [4, 20, 100], the strieded numel is
@@ -130,6 +150,19 @@ inline void StridedNumelCopyWithAxis(const Context& ctx,
     }
   }
 
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if constexpr (std::is_same<Context, phi::CustomContext>::value) {
+    std::vector<void*> dsts;
+    std::vector<const void*> srcs;
+    for (int64_t i = 0; i < before; ++i) {
+      dsts.push_back(dst + i * dst_after);
+      srcs.push_back(src + i * src_after);
+    }
+    CopyD2DBatchWithContext(
+        ctx, dsts, srcs, std::vector<size_t>(before, sizeof(T) * size));
+    return;
+  }
+#endif
   for (int64_t i = 0; i < before; ++i) {
     CopyWithContext<Context>(ctx,
                              place,
@@ -150,6 +183,28 @@ inline void StridedMemcpyWithAxis0(
   const int axis = 0;
   size_t input_offset = 0;
 
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  // each output is a contiguous chunk of the input, so copy all of them in
+  // a single call
+  if constexpr (std::is_same<Context, phi::CustomContext>::value) {
+    std::vector<void*> dsts;
+    std::vector<const void*> srcs;
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < outputs->size(); ++i) {
+      auto out_stride = common::stride_numel(shape_refer[i]->dims());
+      auto out = outputs->at(i);
+      if (out != nullptr && out->initialized() && out->numel() > 0) {
+        dsts.push_back(out->data<T>());
+        srcs.push_back(input.data<T>() + input_offset);
+        sizes.push_back(sizeof(T) * out_stride[axis]);
+      }
+      input_offset += out_stride[axis];
+    }
+    CopyD2DBatchWithContext(dev_ctx, dsts, srcs, sizes);
+    return;
+  }
+#endif
+
   for (size_t i = 0; i < outputs->size(); ++i) {
     auto out_stride = common::stride_numel(shape_refer[i]->dims());
     auto out = outputs->at(i);
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <array>
+#include <vector>
+
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/kernel_factory.h"
@@ -152,4 +155,91 @@ inline void StridedTensorContiguous(const phi::DenseTensor& input,
         "Place type is not supported when `contiguous` kernel is called."));
   }
 }
+
+namespace funcs {
+
+// Calls func(offsets) on the elements of a tensor of dims in the row-major
+// order, where offsets[i] is the element offset given by strides[i], i.e.
+// strides[i] has a stride for each of the dims. The CPU strided kernels read
+// the views through it without the contiguous copies, and a stride of 0
+// reads the same element along the dim, as the broadcasting does.
+template <size_t N, typename Func>
+inline void StridedForEach(const DDim& dims,
+                           const std::array<const int64_t*, N>& strides,
+                           Func&& func) {
+  const int rank = dims.size();
+  const int64_t numel = common::product(dims);
+  std::array<int64_t, N> offsets{};
+  if (numel <= 0) {
+    return;
+  }
+  if (rank == 0) {
+    func(offsets);
+    return;
+  }
+  // the last dim is walked by the inner loop, the others by the odometer
+  const int64_t inner = dims[rank - 1];
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t outer = 0; outer < numel / inner; ++outer) {
+    std::array<int64_t, N> cur = offsets;
+    for (int64_t i = 0; i < inner; ++i) {
+      func(cur);
+      for (size_t t = 0; t < N; ++t) {
+        cur[t] += strides[t][rank - 1];
+      }
+    }
+    for (int d = rank - 2; d >= 0; --d) {
+      for (size_t t = 0; t < N; ++t) {
+        offsets[t] += strides[t][d];
+      }
+      if (++index[d] < dims[d]) {
+        break;
+      }
+      for (size_t t = 0; t < N; ++t) {
+        offsets[t] -= strides[t][d] * dims[d];
+      }
+      index[d] = 0;
+    }
+  }
+}
+
+// The strides of x broadcast to out_dims, aligned to the last dims as the
+// elementwise kernels do, with 0 for the broadcast dims.
+inline std::vector<int64_t> BroadcastStrides(const DenseTensor& x,
+                                             const DDim& out_dims) {
+  const int x_rank = x.dims().size();
+  const int out_rank = out_dims.size();
+  std::vector<int64_t> strides(out_rank, 0);
+  for (int i = 0; i < x_rank; ++i) {
+    const int out_i = out_rank - x_rank + i;
+    if (x.dims()[i] != 1 || out_dims[out_i] == 1) {
+      strides[out_i] = x.strides()[i];
+    }
+  }
+  return strides;
+}
+
+// The strides of the contiguous result of reducing x_dims on the axes, for
+// each of x_dims, with 0 for the reduced dims, so the elements of x reduced
+// into an element of the result all read its offset.
+inline std::vector<int64_t> ReducedStrides(const DDim& x_dims,
+                                           const std::vector<int64_t>& axes,
+                                           bool reduce_all) {
+  const int rank = x_dims.size();
+  std::vector<bool> reduced(rank, reduce_all);
+  for (int64_t axis : axes) {
+    reduced[axis < 0 ? axis + rank : axis] = true;
+  }
+  std::vector<int64_t> strides(rank, 0);
+  int64_t stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    if (!reduced[i]) {
+      strides[i] = stride;
+      stride *= x_dims[i];
+    }
+  }
+  return strides;
+}
+
+}  // namespace funcs
 }  // namespace phi
@@ -15,7 +15,9 @@ limitations under the License. */
 #pragma once
 #include <stdio.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <limits>
 #include <vector>
 #ifdef __NVCC__
 #include "cub/cub.cuh"
@@ -24,6 +26,7 @@ limitations under the License. */
 #include <hipcub/hipcub.hpp>
 #endif
 #include "paddle/phi/backends/gpu/gpu_device_function.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
 #include "paddle/phi/common/bfloat16.h"
@@ -983,6 +986,250 @@ __global__ void RadixTopK(const T* input,
     write_start += carry;
   }
 }
+
+/*---------------------------Radix Select TopK------------------*/
+// A multi-pass radix select for the large k and the long rows, in the way of
+// AIR TopK. The rows are split to many blocks. Each pass histograms a digit of
+// the keys sharing the determined high bits of the k-th key, and picks the
+// bucket of the k-th key, until all the bits are determined or the bucket is
+// selected as a whole. At last, the keys over the k-th key and enough of the
+// keys equal to it are gathered, not sorted.
+constexpr int kRadixSelectBits = 8;
+constexpr int kRadixSelectBuckets = 1 << kRadixSelectBits;
+constexpr int kRadixSelectItemsPerThread = 16;
+
+struct RadixSelectState {
+  uint64_t prefix;  // the determined high bits of the k-th key
+  uint64_t mask;    // the mask of the determined bits
+  int k;            // the rank of the k-th key among the keys with the prefix
+  int done;         // whether all the keys with the prefix are selected
+  int num_greater;  // the counters of the gathered keys
+  int num_equal;
+};
+
+template <typename T, bool Largest>
+__device__ __forceinline__ uint64_t RadixSelectKey(T v) {
+  constexpr int kKeyBits = sizeof(T) * 8;
+  uint64_t key = static_cast<uint64_t>(RadixTypeConfig<T>::Convert(v));
+  if (!Largest) {
+    // Flip the keys so that the smallest values are selected as the largest.
+    key = ~key;
+    if (kKeyBits < 64) {
+      key &= (static_cast<uint64_t>(1) << kKeyBits) - 1;
+    }
+  }
+  return key;
+}
+
+__global__ void InitRadixSelectState(const int64_t num_rows,
+                                     const int k,
+                                     RadixSelectState* states) {
+  CUDA_KERNEL_LOOP_TYPE(row, num_rows, int64_t) {
+    RadixSelectState state = {0, 0, k, 0, 0, 0};
+    states[row] = state;
+  }
+}
+
+template <typename T, bool Largest>
+__global__ void RadixSelectHistogram(const T* input,
+                                     const int64_t num_cols,
+                                     const int start_bit,
+                                     const RadixSelectState* states,
+                                     int* histograms) {
+  __shared__ int shared_hist[kRadixSelectBuckets];
+  const int64_t row = blockIdx.y;
+  const RadixSelectState state = states[row];
+  if (state.done) {
+    return;
+  }
+  for (int i = threadIdx.x; i < kRadixSelectBuckets; i += blockDim.x) {
+    shared_hist[i] = 0;
+  }
+  __syncthreads();
+
+  const T* row_input = input + row * num_cols;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       i < num_cols;
+       i += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    uint64_t key = RadixSelectKey<T, Largest>(row_input[i]);
+    if ((key & state.mask) == state.prefix) {
+      atomicAdd(&shared_hist[(key >> start_bit) & (kRadixSelectBuckets - 1)],
+                1);
+    }
+  }
+  __syncthreads();
+
+  int* row_hist = histograms + row * kRadixSelectBuckets;
+  for (int i = threadIdx.x; i < kRadixSelectBuckets; i += blockDim.x) {
+    if (shared_hist[i] > 0) {
+      atomicAdd(row_hist + i, shared_hist[i]);
+    }
+  }
+}
+
+// Launched with a block of kRadixSelectBuckets threads for each row. It also
+// clears the histogram for the next pass.
+__global__ void RadixSelectBucket(const int start_bit,
+                                  RadixSelectState* states,
+                                  int* histograms) {
+  using BlockScan = cub::BlockScan<int, kRadixSelectBuckets>;
+  __shared__ typename BlockScan::TempStorage temp_storage;
+  const int64_t row = blockIdx.x;
+  RadixSelectState* state = states + row;
+  if (state->done) {
+    return;
+  }
+  int* row_hist = histograms + row * kRadixSelectBuckets;
+  // Scan from the largest bucket.
+  const int bucket = kRadixSelectBuckets - 1 - threadIdx.x;
+  const int count = row_hist[bucket];
+  const int k = state->k;
+  int inclusive;
+  BlockScan(temp_storage).InclusiveSum(count, inclusive);
+  const int exclusive = inclusive - count;
+  row_hist[bucket] = 0;
+  __syncthreads();
+  if (exclusive < k && inclusive >= k) {
+    state->prefix |= static_cast<uint64_t>(bucket) << start_bit;
+    state->mask |= static_cast<uint64_t>(kRadixSelectBuckets - 1) << start_bit;
+    state->k = k - exclusive;
+    state->done = count == k - exclusive ? 1 : 0;
+  }
+}
+
+template <typename T, bool Largest>
+__global__ void RadixSelectGather(const T* input,
+                                  const int64_t num_cols,
+                                  const int k,
+                                  RadixSelectState* states,
+                                  T* output,
+                                  int64_t* indices) {
+  const int64_t row = blockIdx.y;
+  RadixSelectState* state = states + row;
+  const uint64_t prefix = state->prefix;
+  const uint64_t mask = state->mask;
+  const int num_equal = state->k;
+  const T* row_input = input + row * num_cols;
+  T* row_output = output + row * k;
+  int64_t* row_indices = indices + row * k;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       i < num_cols;
+       i += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const T v = row_input[i];
+    const uint64_t key = RadixSelectKey<T, Largest>(v) & mask;
+    int pos;
+    if (key > prefix) {
+      pos = atomicAdd(&state->num_greater, 1);
+    } else if (key == prefix) {
+      pos = atomicAdd(&state->num_equal, 1);
+      if (pos >= num_equal) {
+        continue;
+      }
+      pos += k - num_equal;
+    } else {
+      continue;
+    }
+    row_output[pos] = v;
+    row_indices[pos] = i;
+  }
+}
+
+// Gathers the indices of each row of the top k by their positions in the row
+// after sorting.
+__global__ void GatherSortedTopKIndices(const int64_t* indices,
+                                        const int64_t* sorted_pos,
+                                        const int64_t num_rows,
+                                        const int k,
+                                        int64_t* out) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_rows * k, int64_t) {
+    out[i] = indices[i - i % k + sorted_pos[i]];
+  }
+}
+
+inline bool UseRadixSelectTopK(const phi::GPUContext& ctx,
+                               const int64_t num_rows,
+                               const int64_t num_cols,
+                               const int k,
+                               const int mode) {
+  if (mode == 0 ||
+      num_rows > static_cast<int64_t>(ctx.GetCUDAMaxGridDimSize()[1]) ||
+      num_cols > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  if (mode > 0) {
+    return true;
+  }
+  // The radix select reads the rows a few times, so it pays for the large k,
+  // which the kernels keeping the top k in registers are slow for, or for the
+  // rows too long to be scanned by one block each.
+  return num_cols >= 16384 &&
+         (k >= 64 || num_rows < static_cast<int64_t>(ctx.GetSMCount()));
+}
+
+template <typename T, bool Largest>
+void LaunchRadixSelectTopK(const phi::GPUContext& ctx,
+                           const T* input,
+                           const int64_t num_rows,
+                           const int64_t num_cols,
+                           const int k,
+                           T* output,
+                           int64_t* indices) {
+  constexpr int kKeyBits = sizeof(T) * 8;
+  constexpr int kThreads = kRadixSelectBuckets;
+  auto stream = ctx.stream();
+
+  DenseTensor states_tensor;
+  DenseTensor histograms_tensor;
+  states_tensor.Resize(
+      {static_cast<int64_t>(num_rows * sizeof(RadixSelectState))});
+  histograms_tensor.Resize({num_rows * kRadixSelectBuckets});
+  auto* states =
+      reinterpret_cast<RadixSelectState*>(ctx.Alloc<uint8_t>(&states_tensor));
+  int* histograms = ctx.Alloc<int>(&histograms_tensor);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(
+      histograms, 0, num_rows * kRadixSelectBuckets * sizeof(int), stream));
+  auto config = backends::gpu::GetGpuLaunchConfig1D(ctx, num_rows);
+  InitRadixSelectState<<<config.block_per_grid,
+                         config.thread_per_block,
+                         0,
+                         stream>>>(num_rows, k, states);
+
+  // Fill the device with the blocks of all the rows.
+  const int64_t max_blocks = std::max<int64_t>(
+      1, static_cast<int64_t>(ctx.GetSMCount()) * 8 / num_rows);
+  const int64_t blocks_per_row =
+      std::min<int64_t>(max_blocks,
+                        divide_round_up(num_cols,
+                                        kThreads * kRadixSelectItemsPerThread));
+  dim3 grids(static_cast<int>(blocks_per_row), static_cast<int>(num_rows));
+  for (int start_bit = kKeyBits - kRadixSelectBits; start_bit >= 0;
+       start_bit -= kRadixSelectBits) {
+    RadixSelectHistogram<T, Largest><<<grids, kThreads, 0, stream>>>(
+        input, num_cols, start_bit, states, histograms);
+    RadixSelectBucket<<<num_rows, kRadixSelectBuckets, 0, stream>>>(
+        start_bit, states, histograms);
+  }
+  RadixSelectGather<T, Largest><<<grids, kThreads, 0, stream>>>(
+      input, num_cols, k, states, output, indices);
+}
+
+template <typename T>
+void RadixSelectTopK(const phi::GPUContext& ctx,
+                     const T* input,
+                     const int64_t num_rows,
+                     const int64_t num_cols,
+                     const int k,
+                     const bool largest,
+                     T* output,
+                     int64_t* indices) {
+  if (largest) {
+    LaunchRadixSelectTopK<T, true>(
+        ctx, input, num_rows, num_cols, k, output, indices);
+  } else {
+    LaunchRadixSelectTopK<T, false>(
+        ctx, input, num_rows, num_cols, k, output, indices);
+  }
+}
 #endif
 /*---------------------------Radix TopK End------------------*/
 
@@ -30,13 +30,20 @@ struct UniqueOpFunctor {
   DenseTensor* index_;
   const DenseTensor* in_;
   DenseTensor* count_;
+  DenseTensor* indices_;
 
   UniqueOpFunctor(const Context& context,
                   DenseTensor* out,
                   DenseTensor* index,
                   const DenseTensor* in,
-                  DenseTensor* count = nullptr)
-      : context_(context), out_(out), index_(index), in_(in), count_(count) {}
+                  DenseTensor* count = nullptr,
+                  DenseTensor* indices = nullptr)
+      : context_(context),
+        out_(out),
+        index_(index),
+        in_(in),
+        count_(count),
+        indices_(indices) {}
 
   template <typename IndexT>
   void apply() const {
@@ -48,6 +55,8 @@ struct UniqueOpFunctor {
     // TODO(fangzeyang): Should optimize performance here.
     std::unordered_map<InT, int64_t> dict;
     std::vector<InT> uniq;
+    // the position of the first occurrence of each unique element
+    std::vector<IndexT> firsts;
 
     PADDLE_ENFORCE_LT(
         in_->numel(),
@@ -62,6 +71,9 @@ struct UniqueOpFunctor {
       if (it == dict.end()) {
         dict.emplace(std::make_pair(in_data[i], j));
         uniq.emplace_back(in_data[i]);
+        if (indices_ != nullptr) {
+          firsts.emplace_back(static_cast<IndexT>(i));
+        }
         index_data[i] = static_cast<IndexT>(j);
         j++;
       } else {
@@ -104,6 +116,13 @@ struct UniqueOpFunctor {
     out_->Resize(common::make_ddim({static_cast<int64_t>(uniq.size())}));
     auto* out_data = context_.template Alloc<InT>(out_);
     std::memcpy(out_data, uniq.data(), uniq.size() * sizeof(InT));
+
+    if (indices_ != nullptr) {
+      indices_->Resize(
+          common::make_ddim({static_cast<int64_t>(firsts.size())}));
+      auto* indices_data = context_.template Alloc<IndexT>(indices_);
+      std::memcpy(indices_data, firsts.data(), firsts.size() * sizeof(IndexT));
+    }
   }
 };
 
@@ -884,7 +884,7 @@ struct WeightPostProcessor<T, WeightOnlyQuantType::Int8b, Details> {
 #pragma unroll
     for (int p = 0; p < 16; ++p) {
       weights_f16[p * NPerBlock + idx] =
-          weights_vec[p / 8 + (p % 8) * 2] * scale[idx];
+          weights_vec[p / 8 + (p % 8) * 2] * scale[idx] + zero[idx];
     }
   }
 };
@@ -967,8 +967,7 @@ __global__ void weight_only_batched_gemv_multi_warp(const T* in,
             weights_quantized +
                 i * Details::kConvertCount / Details::kElemsPerByte);
       }
-      // Assign weight and apply scales.
-      // Currently not support zero.
+      // Assign weight and apply scales and zeros.
       WeightProcessor::run(
           weights_vec, weights_f16, scale, zero, NPerBlock, idx);
     }
@@ -1051,6 +1050,7 @@ __global__ void weight_only_batched_gemv_multi_warp(const T* in,
 template <typename T,
           WeightOnlyQuantType QType,
           typename WeightOnlyFlag,
+          bool Zero,
           int NPerBlock,
           int Batch,
           int BlockSize>
@@ -1058,6 +1058,7 @@ void select_activation_and_bias(const T* input,
                                 const int8_t* weight,
                                 const T* bias,
                                 const T* scales,
+                                const T* zeros,
                                 const int m,
                                 const int n,
                                 const int k,
@@ -1075,25 +1076,25 @@ void select_activation_and_bias(const T* input,
                                           QType,
                                           WeightOnlyFlag,
                                           true,
-                                          false,
+                                          Zero,
                                           true,
                                           NPerBlock,
                                           Batch,
                                           BlockSize>
           <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
+              input, weight, bias, scales, zeros, output, n, k);
     } else if (act_method == "None") {
       weight_only_batched_gemv_multi_warp<T,
                                           QType,
                                           WeightOnlyFlag,
                                           false,
-                                          false,
+                                          Zero,
                                           true,
                                           NPerBlock,
                                           Batch,
                                           BlockSize>
           <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
+              input, weight, bias, scales, zeros, output, n, k);
     } else {
       PADDLE_THROW(
           errors::InvalidArgument("Currently, weightonly GEMV act_method "
@@ -1105,25 +1106,25 @@ void select_activation_and_bias(const T* input,
                                           QType,
                                           WeightOnlyFlag,
                                           true,
-                                          false,
+                                          Zero,
                                           false,
                                           NPerBlock,
                                           Batch,
                                           BlockSize>
           <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
+              input, weight, bias, scales, zeros, output, n, k);
     } else if (act_method == "None") {
       weight_only_batched_gemv_multi_warp<T,
                                           QType,
                                           WeightOnlyFlag,
                                           false,
-                                          false,
+                                          Zero,
                                           false,
                                           NPerBlock,
                                           Batch,
                                           BlockSize>
           <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
+              input, weight, bias, scales, zeros, output, n, k);
     } else {
       PADDLE_THROW(
           errors::InvalidArgument("Currently, weightonly GEMV act_method "
@@ -1133,12 +1134,13 @@ void select_activation_and_bias(const T* input,
 #endif
 }
 
-template <typename T, typename WeightOnlyFlag>
+template <typename T, typename WeightOnlyFlag, bool Zero>
 void weight_only_batched_gemv_launcher(
     const T* input,
     const int8_t* weight,
     const T* bias,
     const T* scales,
+    const T* zeros,
     int m,
     int n,
     int k,
@@ -1153,40 +1155,84 @@ void weight_only_batched_gemv_launcher(
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int4b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    1,
                                    1,
                                    192>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       case 2: {
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int4b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    2,
                                    2,
                                    128>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       case 3: {
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int4b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    2,
                                    3,
                                    256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       case 4: {
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int4b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    4,
                                    4,
                                    256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       default: {
@@ -1201,40 +1247,84 @@ void weight_only_batched_gemv_launcher(
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int8b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    2,
                                    1,
                                    256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       case 2: {
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int8b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    2,
                                    2,
                                    256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       case 3: {
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int8b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    2,
                                    3,
                                    256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       case 4: {
         select_activation_and_bias<T,
                                    WeightOnlyQuantType::Int8b,
                                    WeightOnlyFlag,
+                                   Zero,
                                    2,
                                    4,
                                    256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
+            input,
+            weight,
+            bias,
+            scales,
+            zeros,
+            m,
+            n,
+            k,
+            act_method,
+            output,
+            stream);
         break;
       }
       default: {
@@ -1250,6 +1340,50 @@ void weight_only_batched_gemv_launcher(
 #endif
 }
 
+template <typename T, typename WeightOnlyFlag>
+void weight_only_batched_gemv(const T* input,
+                              const int8_t* weight,
+                              const T* bias,
+                              const T* scales,
+                              const T* zeros,
+                              int m,
+                              int n,
+                              int k,
+                              const std::string& weight_only_quant_type,
+                              const std::string& act_method,
+                              T* output,
+                              cudaStream_t stream) {
+  if (zeros) {
+    weight_only_batched_gemv_launcher<T, WeightOnlyFlag, true>(
+        input,
+        weight,
+        bias,
+        scales,
+        zeros,
+        m,
+        n,
+        k,
+        weight_only_quant_type,
+        act_method,
+        output,
+        stream);
+  } else {
+    weight_only_batched_gemv_launcher<T, WeightOnlyFlag, false>(
+        input,
+        weight,
+        bias,
+        scales,
+        zeros,
+        m,
+        n,
+        k,
+        weight_only_quant_type,
+        act_method,
+        output,
+        stream);
+  }
+}
+
 }  // namespace
 
 template <typename T, typename Context>
@@ -1258,6 +1392,7 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
                            const int8_t* weight,
                            const T* bias,
                            const T* scales,
+                           const T* zeros,
                            int m,
                            int n,
                            int k,
@@ -1273,11 +1408,12 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
                       common::errors::InvalidArgument(
                           "group size must be -1 in per-channel mode."));
 
-    weight_only_batched_gemv_launcher<DataType, WeightOnlyPerChannel>(
+    weight_only_batched_gemv<DataType, WeightOnlyPerChannel>(
         reinterpret_cast<const DataType*>(input),
         reinterpret_cast<const int8_t*>(weight),
         reinterpret_cast<const DataType*>(bias),
         reinterpret_cast<const DataType*>(scales),
+        reinterpret_cast<const DataType*>(zeros),
         m,
         n,
         k,
@@ -1287,11 +1423,12 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
         dev_ctx.stream());
   } else if (weight_only_type == "group_wise") {
     if (group_size == 64) {
-      weight_only_batched_gemv_launcher<DataType, WeightOnlyGroupWise<64>>(
+      weight_only_batched_gemv<DataType, WeightOnlyGroupWise<64>>(
           reinterpret_cast<const DataType*>(input),
           reinterpret_cast<const int8_t*>(weight),
           reinterpret_cast<const DataType*>(bias),
           reinterpret_cast<const DataType*>(scales),
+          reinterpret_cast<const DataType*>(zeros),
           m,
           n,
           k,
@@ -1300,11 +1437,12 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
           reinterpret_cast<DataType*>(output),
           dev_ctx.stream());
     } else if (group_size == 128) {
-      weight_only_batched_gemv_launcher<DataType, WeightOnlyGroupWise<128>>(
+      weight_only_batched_gemv<DataType, WeightOnlyGroupWise<128>>(
           reinterpret_cast<const DataType*>(input),
           reinterpret_cast<const int8_t*>(weight),
           reinterpret_cast<const DataType*>(bias),
           reinterpret_cast<const DataType*>(scales),
+          reinterpret_cast<const DataType*>(zeros),
           m,
           n,
           k,
@@ -1329,6 +1467,7 @@ void WeightOnlyGemvWrapper(const phi::GPUContext& dev_ctx,
                            const int8_t* weight,
                            const float* bias,
                            const float* scales,
+                           const float* zeros,
                            int m,
                            int n,
                            int k,
@@ -1368,6 +1507,7 @@ void WeightOnlyGemvKernel(const Context& dev_ctx,
                            weight_data,
                            bias_data,
                            weight_scale_data,
+                           /*zeros*/ nullptr,
                            m,
                            n,
                            k,
@@ -1383,6 +1523,7 @@ template void WeightOnlyGemvWrapper(const phi::GPUContext& ctx,
                                     const int8_t* weight,
                                     const float* bias,
                                     const float* scales,
+                                    const float* zeros,
                                     int m,
                                     int n,
                                     int k,
@@ -1397,6 +1538,7 @@ template void WeightOnlyGemvWrapper(const phi::GPUContext& ctx,
                                     const int8_t* weight,
                                     const phi::dtype::float16* bias,
                                     const phi::dtype::float16* scales,
+                                    const phi::dtype::float16* zeros,
                                     int m,
                                     int n,
                                     int k,
@@ -1411,6 +1553,7 @@ template void WeightOnlyGemvWrapper(const phi::GPUContext& ctx,
                                     const int8_t* weight,
                                     const phi::dtype::bfloat16* bias,
                                     const phi::dtype::bfloat16* scales,
+                                    const phi::dtype::bfloat16* zeros,
                                     int m,
                                     int n,
                                     int k,
@@ -18,12 +18,17 @@ limitations under the License. */
 
 namespace phi {
 
+// The weights are dequantized as w = q * scale + zero. The zeros, e.g. of
+// the AWQ/GPTQ checkpoints, are laid out as the scales, [n] per channel or
+// [k / group_size, n] group-wise, and hold -zero_point * scale. The weights
+// are quantized symmetrically if zeros is nullptr.
 template <typename T, typename Context>
 void WeightOnlyGemvWrapper(const Context& dev_ctx,
                            const T* input,
                            const int8_t* weight,
                            const T* bias,
                            const T* scales,
+                           const T* zeros,
                            int m,
                            int n,
                            int k,
@@ -0,0 +1,567 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/datatype_traits.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/elementwise_base.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+// Ignore CUTLASS warnings about type punning
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#pragma GCC diagnostic ignored "-Wunused-function"
+
+#include "cutlass/array.h"
+#include "cutlass/epilogue/thread/linear_combination.h"
+#include "cutlass/epilogue/thread/linear_combination_relu.h"
+#include "cutlass/gemm/device/gemm_grouped.h"
+#include "cutlass/gemm/gemm.h"
+#include "cutlass/gemm/kernel/default_gemm_grouped.h"
+#include "cutlass/numeric_conversion.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/kernels/fusion/cutlass/cutlass_kernels/moe_gemm/fused_moe_cutlass_kernel.h"
+#include "paddle/phi/kernels/fusion/cutlass/cutlass_kernels/moe_gemm/fused_moe_gemm_kernels.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/default_moe_fc_traits.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/fused_moe_helper.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/linear_combination_ft_gelu.h"
+
+#pragma GCC diagnostic pop
+
+namespace phi {
+
+namespace fusion {
+
+constexpr int kMoeGradThreads = 256;
+
+// The grad of out = sum_j s_j * z_j / sum_j s_j with z_j = fc2_out_j +
+// ffn2_bias[e_j], the routed copies of a row being un-permuted in the forward.
+// Writes dz_j = s_j / sum_i s_i * dout in the permuted order, so that the
+// experts read their rows contiguously, and the grads of the softmax scales
+// s_j through the renormalization.
+template <typename T>
+__global__ void MoeCombineGradKernel(const T* dout,
+                                     const T* fc2_out,
+                                     const T* bias,
+                                     const float* scales,
+                                     const int* src2dest,
+                                     const int* expert_for_source_row,
+                                     const int cols,
+                                     const int k,
+                                     T* dz,
+                                     float* dscales) {
+  const int row = blockIdx.x;
+  const int num_rows = gridDim.x;
+  const float* row_scales = scales + row * k;
+  float* row_dscales = dscales + row * k;
+  float scale_sum = 0.f;
+  for (int j = 0; j < k; ++j) {
+    scale_sum += row_scales[j];
+  }
+  const T* dout_row = dout + static_cast<int64_t>(row) * cols;
+  for (int j = 0; j < k; ++j) {
+    const int64_t dest = src2dest[j * num_rows + row];
+    const float weight = row_scales[j] / scale_sum;
+    const T* fc2_row = fc2_out + dest * cols;
+    const T* bias_row =
+        bias + static_cast<int64_t>(expert_for_source_row[row * k + j]) * cols;
+    T* dz_row = dz + dest * cols;
+    float dot = 0.f;
+    for (int i = threadIdx.x; i < cols; i += blockDim.x) {
+      const float grad = static_cast<float>(dout_row[i]);
+      dz_row[i] = static_cast<T>(weight * grad);
+      dot += grad * static_cast<float>(fc2_row[i] + bias_row[i]);
+    }
+    dot = phi::funcs::BlockReduceSum<float>(dot, FINAL_MASK);
+    if (threadIdx.x == 0) {
+      row_dscales[j] = dot;
+    }
+  }
+  if (threadIdx.x == 0) {
+    // w_j = s_j / S, ds_j = (dw_j - sum_i w_i * dw_i) / S
+    float weighted_sum = 0.f;
+    for (int j = 0; j < k; ++j) {
+      weighted_sum += row_scales[j] / scale_sum * row_dscales[j];
+    }
+    for (int j = 0; j < k; ++j) {
+      row_dscales[j] = (row_dscales[j] - weighted_sum) / scale_sum;
+    }
+  }
+}
+
+// The grad of swiglu(x) = silu(x[:, :cols]) * x[:, cols:].
+template <typename T>
+__global__ void MoeSwigluGradKernel(const T* fc1_out,
+                                    const T* dact,
+                                    const int64_t rows,
+                                    const int cols,
+                                    T* dfc1) {
+  const int64_t numel = rows * cols;
+  for (int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x +
+                     threadIdx.x;
+       idx < numel;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const int64_t row = idx / cols;
+    const int col = idx % cols;
+    const T* in_row = fc1_out + row * 2 * cols;
+    T* grad_row = dfc1 + row * 2 * cols;
+    const float x = static_cast<float>(in_row[col]);
+    const float gate = static_cast<float>(in_row[col + cols]);
+    const float grad = static_cast<float>(dact[idx]);
+    const float sigmoid = 1.f / (1.f + expf(-x));
+    grad_row[col] =
+        static_cast<T>(grad * gate * sigmoid * (1.f + x * (1.f - sigmoid)));
+    grad_row[col + cols] = static_cast<T>(grad * x * sigmoid);
+  }
+}
+
+// Sums the permuted rows of each expert into the grad of its bias.
+template <typename T>
+__global__ void MoeExpertBiasGradKernel(const T* grad,
+                                        const int64_t* total_rows_before_expert,
+                                        const int cols,
+                                        T* bias_grad) {
+  const int expert = blockIdx.y;
+  const int col = blockIdx.x * blockDim.x + threadIdx.x;
+  if (col >= cols) {
+    return;
+  }
+  const int64_t begin = expert == 0 ? 0 : total_rows_before_expert[expert - 1];
+  const int64_t end = total_rows_before_expert[expert];
+  float sum = 0.f;
+  for (int64_t row = begin; row < end; ++row) {
+    sum += static_cast<float>(grad[row * cols + col]);
+  }
+  bias_grad[static_cast<int64_t>(expert) * cols + col] = static_cast<T>(sum);
+}
+
+// The grad of the gate logits through the softmax, the grads of the
+// probabilities being the grads of the scales at the k chosen experts and 0
+// elsewhere.
+__global__ void MoeGateGradKernel(const float* logits,
+                                  const float* scales,
+                                  const float* dscales,
+                                  const int* expert_for_source_row,
+                                  const int num_experts,
+                                  const int k,
+                                  float* dlogits) {
+  const int row = blockIdx.x;
+  const float* row_logits = logits + static_cast<int64_t>(row) * num_experts;
+  float max_logit = -FLT_MAX;
+  for (int e = threadIdx.x; e < num_experts; e += blockDim.x) {
+    max_logit = fmaxf(max_logit, row_logits[e]);
+  }
+  max_logit = phi::funcs::BlockReduceMax<float>(max_logit, FINAL_MASK);
+  float exp_sum = 0.f;
+  for (int e = threadIdx.x; e < num_experts; e += blockDim.x) {
+    exp_sum += expf(row_logits[e] - max_logit);
+  }
+  exp_sum = phi::funcs::BlockReduceSum<float>(exp_sum, FINAL_MASK);
+  // the scales are the probabilities of the chosen experts
+  float dot = 0.f;
+  for (int j = 0; j < k; ++j) {
+    dot += scales[row * k + j] * dscales[row * k + j];
+  }
+  for (int e = threadIdx.x; e < num_experts; e += blockDim.x) {
+    const float prob = expf(row_logits[e] - max_logit) / exp_sum;
+    float dprob = 0.f;
+    for (int j = 0; j < k; ++j) {
+      if (expert_for_source_row[row * k + j] == e) {
+        dprob = dscales[row * k + j];
+      }
+    }
+    dlogits[static_cast<int64_t>(row) * num_experts + e] =
+        prob * (dprob - dot);
+  }
+}
+
+// dx = sum_j dpermuted_x_j + the grad through the gate, the routed copies of
+// a row being gathered back as in finalize_moe_routing_kernel.
+template <typename T>
+__global__ void MoeUnpermuteGradKernel(const T* dpermuted_x,
+                                       const float* dx_gate,
+                                       const int* src2dest,
+                                       const int cols,
+                                       const int k,
+                                       T* dx) {
+  const int row = blockIdx.x;
+  const int num_rows = gridDim.x;
+  for (int i = threadIdx.x; i < cols; i += blockDim.x) {
+    float sum = dx_gate[static_cast<int64_t>(row) * cols + i];
+    for (int j = 0; j < k; ++j) {
+      const int64_t dest = src2dest[j * num_rows + row];
+      sum += static_cast<float>(dpermuted_x[dest * cols + i]);
+    }
+    dx[static_cast<int64_t>(row) * cols + i] = static_cast<T>(sum);
+  }
+}
+
+// The routing and the expert FFNs of the forward are computed again, the
+// rows stay permuted by expert so that the grads of each expert are two
+// contiguous GEMMs.
+template <typename T, typename Context>
+void FusedMoeGradKernel(const Context& ctx,
+                        const DenseTensor& X,
+                        const DenseTensor& gate_weight,
+                        const DenseTensor& ffn1_weight,
+                        const DenseTensor& ffn1_bias,
+                        const DenseTensor& ffn2_weight,
+                        const DenseTensor& ffn2_bias,
+                        const DenseTensor& out_grad,
+                        const std::string& quant_method,
+                        const int moe_topk,
+                        DenseTensor* x_grad,
+                        DenseTensor* gate_weight_grad,
+                        DenseTensor* ffn1_weight_grad,
+                        DenseTensor* ffn1_bias_grad,
+                        DenseTensor* ffn2_weight_grad,
+                        DenseTensor* ffn2_bias_grad) {
+  PADDLE_ENFORCE_EQ(
+      quant_method,
+      "None",
+      common::errors::Unimplemented(
+          "The grad of fused_moe only supports the unquantized weights, "
+          "but got quant_method %s.",
+          quant_method));
+  using NvType = typename phi::PDDataTypeTraits<T>::DataType;
+  auto stream = ctx.stream();
+
+  const auto ffn1_dims = ffn1_weight.dims();
+  const int num_experts = ffn1_dims[0];
+  const int hidden_size = ffn1_dims[1];
+  const int inter_size = ffn1_dims[2];
+  const int num_rows = X.numel() / hidden_size;
+  const int k = moe_topk;
+  const int expanded_rows = num_rows * k;
+  VLOG(4) << "num_rows: " << num_rows << "   " << hidden_size << "   "
+          << inter_size << "    " << num_experts << "k " << k;
+
+  // ---- the routing ----
+  DenseTensor x_float = Empty<float>(ctx, {num_rows, hidden_size});
+  CastKernel<T>(ctx, X, DataType::FLOAT32, &x_float);
+  DenseTensor gate_out = Empty<float>(ctx, {num_rows, num_experts});
+  DenseTensor mixgemm_workspace;
+  auto gate_compute = GEMMHelper<float>(
+      ctx, num_rows, num_experts, hidden_size, "None", false);
+  gate_compute.Compute(&x_float,
+                       &gate_weight,
+                       /*weight_scale*/ nullptr,
+                       /*bias*/ nullptr,
+                       &mixgemm_workspace,
+                       &gate_out);
+
+  DenseTensor finished_tensor = Empty<bool>(ctx, {num_rows});
+  funcs::SetConstant<GPUContext, bool> zero;
+  zero(ctx, &finished_tensor, false);
+  DenseTensor scales = Empty<float>(ctx, {num_rows, k});
+  DenseTensor expert_for_source_row = Empty<int>(ctx, {expanded_rows});
+  DenseTensor source_rows = Empty<int>(ctx, {expanded_rows});
+  DenseTensor permuted_rows = Empty<int>(ctx, {expanded_rows});
+  DenseTensor permuted_experts = Empty<int>(ctx, {expanded_rows});
+  DenseTensor src2dest = Empty<int>(ctx, {expanded_rows});
+  DenseTensor softmax_out;
+  const bool is_pow_2 =
+      (num_experts != 0) && ((num_experts & (num_experts - 1)) == 0);
+  if (!is_pow_2 || num_experts > 256) {
+    softmax_out = Empty<float>(ctx, {num_rows, num_experts});
+  }
+  topk_gating_softmax_kernelLauncher<float>(
+      gate_out.data<float>(),
+      finished_tensor.data<bool>(),
+      scales.data<float>(),
+      softmax_out.initialized() ? softmax_out.data<float>() : nullptr,
+      expert_for_source_row.data<int>(),
+      source_rows.data<int>(),
+      num_rows,
+      num_experts,
+      k,
+      stream);
+
+  CubKeyValueSorter sorter;
+  sorter.update_num_experts(num_experts);
+  const int64_t sorter_ws_size_bytes =
+      AlignTo16(sorter.getWorkspaceSize(expanded_rows));
+  DenseTensor sorter_ws = Empty<int8_t>(ctx, {sorter_ws_size_bytes});
+  sorter.run(sorter_ws.data<int8_t>(),
+             sorter_ws_size_bytes,
+             expert_for_source_row.data<int>(),
+             permuted_experts.data<int>(),
+             source_rows.data<int>(),
+             permuted_rows.data<int>(),
+             expanded_rows,
+             false,
+             stream);
+
+  DenseTensor permuted_x = Empty<T>(ctx, {expanded_rows, hidden_size});
+  initialize_moe_routing_kernelLauncher(X.data<T>(),
+                                        permuted_x.data<T>(),
+                                        permuted_rows.data<int>(),
+                                        src2dest.data<int>(),
+                                        num_rows,
+                                        num_rows,
+                                        hidden_size,
+                                        k,
+                                        stream);
+  DenseTensor total_rows_before_expert = Empty<int64_t>(ctx, {num_experts});
+  compute_total_rows_before_expert<T>(permuted_experts.data<int>(),
+                                      X.data<T>(),
+                                      expanded_rows,
+                                      num_experts,
+                                      total_rows_before_expert.data<int64_t>(),
+                                      stream);
+
+  // ---- the expert FFNs ----
+  auto moe_gemm_runner = MoeGemmRunner<NvType, NvType>();
+  DenseTensor fc1_out = Empty<T>(ctx, {expanded_rows, inter_size});
+  moe_gemm_runner.moe_gemm_bias_act(
+      reinterpret_cast<NvType*>(permuted_x.data<T>()),
+      reinterpret_cast<const NvType*>(ffn1_weight.data<T>()),
+      nullptr,
+      reinterpret_cast<const NvType*>(ffn1_bias.data<T>()),
+      reinterpret_cast<NvType*>(fc1_out.data<T>()),
+      total_rows_before_expert.data<int64_t>(),
+      expanded_rows,
+      inter_size,
+      hidden_size,
+      num_experts,
+      "none",
+      stream);
+  DenseTensor act_out = Empty<T>(ctx, {expanded_rows, inter_size / 2});
+  auto bias_act_helper =
+      BiasActHelper<T>(ctx, "swiglu", expanded_rows, inter_size);
+  bias_act_helper.Compute(&fc1_out, nullptr, &act_out);
+  DenseTensor fc2_out = Empty<T>(ctx, {expanded_rows, hidden_size});
+  moe_gemm_runner.moe_gemm(
+      reinterpret_cast<NvType*>(act_out.data<T>()),
+      reinterpret_cast<const NvType*>(ffn2_weight.data<T>()),
+      nullptr,
+      reinterpret_cast<NvType*>(fc2_out.data<T>()),
+      total_rows_before_expert.data<int64_t>(),
+      expanded_rows,
+      hidden_size,
+      inter_size / 2,
+      num_experts,
+      stream);
+
+  // ---- the grads ----
+  DenseTensor dz = Empty<T>(ctx, {expanded_rows, hidden_size});
+  DenseTensor dscales = Empty<float>(ctx, {num_rows, k});
+  MoeCombineGradKernel<T><<<num_rows, kMoeGradThreads, 0, stream>>>(
+      out_grad.data<T>(),
+      fc2_out.data<T>(),
+      ffn2_bias.data<T>(),
+      scales.data<float>(),
+      src2dest.data<int>(),
+      expert_for_source_row.data<int>(),
+      hidden_size,
+      k,
+      dz.data<T>(),
+      dscales.data<float>());
+
+  // the GEMMs of each expert are sized on the host
+  DenseTensor rows_before_expert_cpu;
+  phi::Copy(ctx,
+            total_rows_before_expert,
+            phi::CPUPlace(),
+            true,
+            &rows_before_expert_cpu);
+  const int64_t* rows_before_expert = rows_before_expert_cpu.data<int64_t>();
+
+  auto blas = phi::funcs::GetBlas<Context, T>(ctx);
+  const T one = static_cast<T>(1.0f);
+  const T zero_value = static_cast<T>(0.0f);
+  funcs::SetConstant<Context, T> set_zero;
+  const int act_size = inter_size / 2;
+  const int64_t ffn1_numel = static_cast<int64_t>(hidden_size) * inter_size;
+  const int64_t ffn2_numel = static_cast<int64_t>(act_size) * hidden_size;
+  T* ffn1_weight_grad_data =
+      ffn1_weight_grad ? ctx.template Alloc<T>(ffn1_weight_grad) : nullptr;
+  T* ffn2_weight_grad_data =
+      ffn2_weight_grad ? ctx.template Alloc<T>(ffn2_weight_grad) : nullptr;
+
+  DenseTensor dact = Empty<T>(ctx, {expanded_rows, act_size});
+  for (int e = 0; e < num_experts; ++e) {
+    const int64_t begin = e == 0 ? 0 : rows_before_expert[e - 1];
+    const int rows = static_cast<int>(rows_before_expert[e] - begin);
+    if (rows == 0) {
+      if (ffn2_weight_grad) {
+        DenseTensor slice = ffn2_weight_grad->Slice(e, e + 1);
+        set_zero(ctx, &slice, zero_value);
+      }
+      continue;
+    }
+    const T* dz_e = dz.data<T>() + begin * hidden_size;
+    if (ffn2_weight_grad) {
+      blas.GEMM(CblasTrans,
+                CblasNoTrans,
+                act_size,
+                hidden_size,
+                rows,
+                one,
+                act_out.data<T>() + begin * act_size,
+                dz_e,
+                zero_value,
+                ffn2_weight_grad_data + e * ffn2_numel);
+    }
+    blas.GEMM(CblasNoTrans,
+              CblasTrans,
+              rows,
+              act_size,
+              hidden_size,
+              one,
+              dz_e,
+              ffn2_weight.data<T>() + e * ffn2_numel,
+              zero_value,
+              dact.data<T>() + begin * act_size);
+  }
+
+  DenseTensor dfc1 = Empty<T>(ctx, {expanded_rows, inter_size});
+  const int64_t act_numel = static_cast<int64_t>(expanded_rows) * act_size;
+  const int swiglu_blocks = static_cast<int>(std::min<int64_t>(
+      (act_numel + kMoeGradThreads - 1) / kMoeGradThreads,
+      ctx.GetCUDAMaxGridDimSize()[0]));
+  MoeSwigluGradKernel<T><<<swiglu_blocks, kMoeGradThreads, 0, stream>>>(
+      fc1_out.data<T>(),
+      dact.data<T>(),
+      expanded_rows,
+      act_size,
+      dfc1.data<T>());
+
+  DenseTensor dpermuted_x = Empty<T>(ctx, {expanded_rows, hidden_size});
+  for (int e = 0; e < num_experts; ++e) {
+    const int64_t begin = e == 0 ? 0 : rows_before_expert[e - 1];
+    const int rows = static_cast<int>(rows_before_expert[e] - begin);
+    if (rows == 0) {
+      if (ffn1_weight_grad) {
+        DenseTensor slice = ffn1_weight_grad->Slice(e, e + 1);
+        set_zero(ctx, &slice, zero_value);
+      }
+      continue;
+    }
+    const T* dfc1_e = dfc1.data<T>() + begin * inter_size;
+    if (ffn1_weight_grad) {
+      blas.GEMM(CblasTrans,
+                CblasNoTrans,
+                hidden_size,
+                inter_size,
+                rows,
+                one,
+                permuted_x.data<T>() + begin * hidden_size,
+                dfc1_e,
+                zero_value,
+                ffn1_weight_grad_data + e * ffn1_numel);
+    }
+    blas.GEMM(CblasNoTrans,
+              CblasTrans,
+              rows,
+              hidden_size,
+              inter_size,
+              one,
+              dfc1_e,
+              ffn1_weight.data<T>() + e * ffn1_numel,
+              zero_value,
+              dpermuted_x.data<T>() + begin * hidden_size);
+  }
+
+  if (ffn1_bias_grad) {
+    dim3 grid((inter_size + kMoeGradThreads - 1) / kMoeGradThreads,
+              num_experts);
+    MoeExpertBiasGradKernel<T><<<grid, kMoeGradThreads, 0, stream>>>(
+        dfc1.data<T>(),
+        total_rows_before_expert.data<int64_t>(),
+        inter_size,
+        ctx.template Alloc<T>(ffn1_bias_grad));
+  }
+  if (ffn2_bias_grad) {
+    dim3 grid((hidden_size + kMoeGradThreads - 1) / kMoeGradThreads,
+              num_experts);
+    MoeExpertBiasGradKernel<T><<<grid, kMoeGradThreads, 0, stream>>>(
+        dz.data<T>(),
+        total_rows_before_expert.data<int64_t>(),
+        hidden_size,
+        ctx.template Alloc<T>(ffn2_bias_grad));
+  }
+
+  // the gate runs in float, as in the forward
+  DenseTensor dgate_out = Empty<float>(ctx, {num_rows, num_experts});
+  MoeGateGradKernel<<<num_rows, kMoeGradThreads, 0, stream>>>(
+      gate_out.data<float>(),
+      scales.data<float>(),
+      dscales.data<float>(),
+      expert_for_source_row.data<int>(),
+      num_experts,
+      k,
+      dgate_out.data<float>());
+  auto float_blas = phi::funcs::GetBlas<Context, float>(ctx);
+  if (gate_weight_grad) {
+    float_blas.GEMM(CblasTrans,
+                    CblasNoTrans,
+                    hidden_size,
+                    num_experts,
+                    num_rows,
+                    1.0f,
+                    x_float.data<float>(),
+                    dgate_out.data<float>(),
+                    0.0f,
+                    ctx.template Alloc<float>(gate_weight_grad));
+  }
+  if (x_grad) {
+    // x_float is no longer needed, it holds the grad through the gate
+    float_blas.GEMM(CblasNoTrans,
+                    CblasTrans,
+                    num_rows,
+                    hidden_size,
+                    num_experts,
+                    1.0f,
+                    dgate_out.data<float>(),
+                    gate_weight.data<float>(),
+                    0.0f,
+                    x_float.data<float>());
+    MoeUnpermuteGradKernel<T>
+        <<<num_rows, std::min(hidden_size, 1024), 0, stream>>>(
+            dpermuted_x.data<T>(),
+            x_float.data<float>(),
+            src2dest.data<int>(),
+            hidden_size,
+            k,
+            ctx.template Alloc<T>(x_grad));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+#ifdef PADDLE_CUDA_BF16
+PD_REGISTER_KERNEL(fused_moe_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedMoeGradKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
+#else
+PD_REGISTER_KERNEL(fused_moe_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedMoeGradKernel,
+                   phi::dtype::float16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
+#endif
@@ -64,6 +64,13 @@ inline cudaDataType_t GetCublasLtDataType<phi::dtype::bfloat16>() {
   return CUDA_R_16BF;
 }
 
+inline cudaDataType_t GetCublasLtFP8DataType(phi::DataType dtype) {
+  return dtype == phi::DataType::FLOAT8_E5M2 ? CUDA_R_8F_E5M2 : CUDA_R_8F_E4M3;
+}
+
+// The optional x_scale_inv and y_scale_inv are float32 tensors of one element
+// on the device, which dequantize the per-tensor scaled fp8 inputs of
+// training. They are read by cuBLASLt, so they can change in each step.
 template <typename T>
 void CublasLtMatmulFP8(const phi::GPUContext& dev_ctx,
                        const int batch_count,
@@ -73,13 +80,25 @@ void CublasLtMatmulFP8(const phi::GPUContext& dev_ctx,
                        const phi::DenseTensor& mat_a,
                        const phi::DenseTensor& mat_b,
                        const float scale,
+                       const paddle::optional<DenseTensor>& mat_a_scale_inv,
+                       const paddle::optional<DenseTensor>& mat_b_scale_inv,
                        const paddle::optional<DenseTensor>& bias,
                        const std::string& activation_type,
                        phi::DenseTensor* out) {
   // init data structure
   cublasStatus_t status;
-  auto A_type = CUDA_R_8F_E4M3;
-  auto B_type = CUDA_R_8F_E4M3;
+  auto A_type = GetCublasLtFP8DataType(mat_a.dtype());
+  auto B_type = GetCublasLtFP8DataType(mat_b.dtype());
+  PADDLE_ENFORCE_EQ(
+      A_type == CUDA_R_8F_E5M2 && B_type == CUDA_R_8F_E5M2,
+      false,
+      common::errors::InvalidArgument(
+          "FP8 gemm does not support both inputs of float8_e5m2."));
+  // The pointers are only passed through, so e5m2 is read as e4m3 here.
+  const auto* mat_a_ptr =
+      reinterpret_cast<const phi::dtype::float8_e4m3fn*>(mat_a.data());
+  const auto* mat_b_ptr =
+      reinterpret_cast<const phi::dtype::float8_e4m3fn*>(mat_b.data());
   auto Bias_type = GetCublasLtDataType<T>();
   auto C_type = GetCublasLtDataType<T>();
 
@@ -103,6 +122,26 @@ void CublasLtMatmulFP8(const phi::GPUContext& dev_ctx,
                                                sizeof(op_transpose));
   PADDLE_CUBLASLT_STATUS_CHECK(cublasLtMatmulDescSetAttribute);
 
+  // mat_b is the A of cuBLASLt, and mat_a is its B.
+  if (mat_b_scale_inv) {
+    const float* b_scale_inv_ptr = mat_b_scale_inv.get().data<float>();
+    status = dyl::cublasLtMatmulDescSetAttribute(
+        matmul_desc_,
+        CUBLASLT_MATMUL_DESC_A_SCALE_POINTER,
+        &b_scale_inv_ptr,
+        sizeof(b_scale_inv_ptr));
+    PADDLE_CUBLASLT_STATUS_CHECK(cublasLtMatmulDescSetAttribute);
+  }
+  if (mat_a_scale_inv) {
+    const float* a_scale_inv_ptr = mat_a_scale_inv.get().data<float>();
+    status = dyl::cublasLtMatmulDescSetAttribute(
+        matmul_desc_,
+        CUBLASLT_MATMUL_DESC_B_SCALE_POINTER,
+        &a_scale_inv_ptr,
+        sizeof(a_scale_inv_ptr));
+    PADDLE_CUBLASLT_STATUS_CHECK(cublasLtMatmulDescSetAttribute);
+  }
+
   // int8_t fast_accum = 1;
   // status = dyl::cublasLtMatmulDescSetAttribute(matmul_desc_,
   //                                              CUBLASLT_MATMUL_DESC_FAST_ACCUM,
@@ -205,8 +244,8 @@ void CublasLtMatmulFP8(const phi::GPUContext& dev_ctx,
                               n,
                               k,
                               batch_count,
-                              mat_b.data<phi::dtype::float8_e4m3fn>(),
-                              mat_a.data<phi::dtype::float8_e4m3fn>(),
+                              mat_b_ptr,
+                              mat_a_ptr,
                               bias_ptr,
                               out->data<T>(),
                               &alpha_,
@@ -275,9 +314,9 @@ void CublasLtMatmulFP8(const phi::GPUContext& dev_ctx,
   status = dyl::cublasLtMatmul(dev_ctx.cublaslt_handle(),
                                matmul_desc_,
                                &alpha_,
-                               mat_b.data<phi::dtype::float8_e4m3fn>(),
+                               mat_b_ptr,
                                B_desc_,
-                               mat_a.data<phi::dtype::float8_e4m3fn>(),
+                               mat_a_ptr,
                                A_desc_,
                                &beta_,
                                bias_ptr,
@@ -300,6 +339,8 @@ void cublaslt_fp8_fp8_fp16_gemm(
     bool transpose_x,
     bool transpose_y,
     const float scale,  // only support per-tensor quantization
+    const paddle::optional<DenseTensor>& x_scale_inv,
+    const paddle::optional<DenseTensor>& y_scale_inv,
     const std::string& activation_type,
     DenseTensor* out) {
   PADDLE_ENFORCE_EQ(x.dims().size() == y.dims().size(),
@@ -344,8 +385,19 @@ void cublaslt_fp8_fp8_fp16_gemm(
   for (size_t i = 0; i < rank - 2; ++i) {
     batch_count *= x.dims()[i];
   }
-  CublasLtMatmulFP8<phi::dtype::float16>(
-      ctx, batch_count, m, n, k, x, y, scale, bias, activation_type, out);
+  CublasLtMatmulFP8<phi::dtype::float16>(ctx,
+                                         batch_count,
+                                         m,
+                                         n,
+                                         k,
+                                         x,
+                                         y,
+                                         scale,
+                                         x_scale_inv,
+                                         y_scale_inv,
+                                         bias,
+                                         activation_type,
+                                         out);
 }
 
 template <typename Context>
@@ -357,6 +409,8 @@ void cublaslt_fp8_fp8_bf16_gemm(
     bool transpose_x,
     bool transpose_y,
     const float scale,  // only support per-tensor quantization
+    const paddle::optional<DenseTensor>& x_scale_inv,
+    const paddle::optional<DenseTensor>& y_scale_inv,
     const std::string& activation_type,
     DenseTensor* out) {
   PADDLE_ENFORCE_EQ(x.dims().size() == y.dims().size(),
@@ -401,8 +455,19 @@ void cublaslt_fp8_fp8_bf16_gemm(
   for (size_t i = 0; i < rank - 2; ++i) {
     batch_count *= x.dims()[i];
   }
-  CublasLtMatmulFP8<phi::dtype::bfloat16>(
-      ctx, batch_count, m, n, k, x, y, scale, bias, activation_type, out);
+  CublasLtMatmulFP8<phi::dtype::bfloat16>(ctx,
+                                          batch_count,
+                                          m,
+                                          n,
+                                          k,
+                                          x,
+                                          y,
+                                          scale,
+                                          x_scale_inv,
+                                          y_scale_inv,
+                                          bias,
+                                          activation_type,
+                                          out);
 }
 
 }  // namespace cutlass_internal
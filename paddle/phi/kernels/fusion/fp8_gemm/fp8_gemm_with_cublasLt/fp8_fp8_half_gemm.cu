@@ -31,6 +31,8 @@ void fp8_fp8_half_gemm(
     const DenseTensor& x,
     const DenseTensor& y,
     const paddle::optional<DenseTensor>& bias,
+    const paddle::optional<DenseTensor>& x_scale_inv,
+    const paddle::optional<DenseTensor>& y_scale_inv,
     const bool trans_x,
     const bool trans_y,
     const float scale,  // only support per-tensor quantization
@@ -42,11 +44,29 @@ void fp8_fp8_half_gemm(
   static_assert(std::is_same<Context, phi::GPUContext>::value,
                 "fp8_fp8_gemm must be in GPU");
   if (out->dtype() == phi::DataType::BFLOAT16) {
-    cublaslt_fp8_fp8_bf16_gemm<Context>(
-        dev_ctx, x, y, bias, trans_x, trans_y, scale, activation_type, out);
+    cublaslt_fp8_fp8_bf16_gemm<Context>(dev_ctx,
+                                       x,
+                                       y,
+                                       bias,
+                                       trans_x,
+                                       trans_y,
+                                       scale,
+                                       x_scale_inv,
+                                       y_scale_inv,
+                                       activation_type,
+                                       out);
   } else if (out->dtype() == phi::DataType::FLOAT16) {
-    cublaslt_fp8_fp8_fp16_gemm<Context>(
-        dev_ctx, x, y, bias, trans_x, trans_y, scale, activation_type, out);
+    cublaslt_fp8_fp8_fp16_gemm<Context>(dev_ctx,
+                                       x,
+                                       y,
+                                       bias,
+                                       trans_x,
+                                       trans_y,
+                                       scale,
+                                       x_scale_inv,
+                                       y_scale_inv,
+                                       activation_type,
+                                       out);
   } else {
     PADDLE_THROW(common::errors::Fatal(
         "fp8_fp8_half_gemm_fused only support bfloat16 and float16 output"));
@@ -0,0 +1,123 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+namespace phi {
+namespace fusion {
+
+// Computes the delayed scale of the next step from the amax history, then
+// rolls the history by one so that amax_history[0] is a zeroed slot for the
+// amax of the next step. The scale is kept if the amax is zero or not finite.
+template <bool MostRecent>
+__global__ void FP8AmaxAndScaleUpdateCUDAKernel(const float* amax_history,
+                                                const float* scale,
+                                                float* amax_history_out,
+                                                float* scale_out,
+                                                float* scale_inv_out,
+                                                int history_len,
+                                                float fp8_max,
+                                                float margin) {
+  extern __shared__ float history[];
+  float amax = 0.f;
+  for (int i = threadIdx.x; i < history_len; i += blockDim.x) {
+    history[i] = amax_history[i];
+    amax = fmaxf(amax, history[i]);
+  }
+  if (MostRecent) {
+    amax = amax_history[0];
+  } else {
+    amax = phi::funcs::BlockReduceMax<float>(amax, 0xffffffff);
+  }
+  __syncthreads();
+
+  for (int i = threadIdx.x; i < history_len; i += blockDim.x) {
+    amax_history_out[i] = i == 0 ? 0.f : history[i - 1];
+  }
+  if (threadIdx.x == 0) {
+    float new_scale = *scale;
+    if (amax > 0.f && isfinite(amax)) {
+      new_scale = fp8_max / amax / exp2f(margin);
+    }
+    *scale_out = new_scale;
+    *scale_inv_out = 1.f / new_scale;
+  }
+}
+
+template <typename T, typename Context>
+void FP8AmaxAndScaleUpdateKernel(const Context& dev_ctx,
+                                 const DenseTensor& amax_history,
+                                 const DenseTensor& scale,
+                                 float fp8_max,
+                                 float margin,
+                                 const std::string& amax_compute_algo,
+                                 DenseTensor* amax_history_out,
+                                 DenseTensor* scale_out,
+                                 DenseTensor* scale_inv_out) {
+  const int history_len = amax_history.numel();
+  PADDLE_ENFORCE_GT(history_len,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The amax_history of fp8_amax_and_scale_update must "
+                        "not be empty."));
+  // amax_history and scale are updated in place, and are fully read before
+  // they are written.
+  float* amax_history_out_data =
+      dev_ctx.template Alloc<float>(amax_history_out);
+  float* scale_out_data = dev_ctx.template Alloc<float>(scale_out);
+  float* scale_inv_out_data = dev_ctx.template Alloc<float>(scale_inv_out);
+
+  constexpr int kThreads = 256;
+  const size_t shm_size = history_len * sizeof(float);
+  if (amax_compute_algo == "max") {
+    FP8AmaxAndScaleUpdateCUDAKernel<false>
+        <<<1, kThreads, shm_size, dev_ctx.stream()>>>(
+            amax_history.data<float>(),
+            scale.data<float>(),
+            amax_history_out_data,
+            scale_out_data,
+            scale_inv_out_data,
+            history_len,
+            fp8_max,
+            margin);
+  } else if (amax_compute_algo == "most_recent") {
+    FP8AmaxAndScaleUpdateCUDAKernel<true>
+        <<<1, kThreads, shm_size, dev_ctx.stream()>>>(
+            amax_history.data<float>(),
+            scale.data<float>(),
+            amax_history_out_data,
+            scale_out_data,
+            scale_inv_out_data,
+            history_len,
+            fp8_max,
+            margin);
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "fp8_amax_and_scale_update only support amax_compute_algo of max "
+        "and most_recent, but got %s.",
+        amax_compute_algo));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_amax_and_scale_update,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FP8AmaxAndScaleUpdateKernel,
+                   float) {}
@@ -0,0 +1,280 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef PADDLE_WITH_HIP
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#else
+#include <cub/cub.cuh>
+#endif
+
+#include <climits>
+#include <limits>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+namespace fusion {
+
+constexpr int kBeamStepMaxBeamSize = 16;
+constexpr int kBeamStepBlockSize = 256;
+constexpr float kBeamStepNegInf = -std::numeric_limits<float>::infinity();
+
+// the beam_size * beam_size candidates of a batch are held one per thread
+static_assert(kBeamStepMaxBeamSize * kBeamStepMaxBeamSize <=
+                  kBeamStepBlockSize,
+              "The candidates of a batch should fit in a block.");
+
+struct BeamCandidate {
+  float score;
+  int id;
+};
+
+// Prefers the higher score, then the lower id so the selection is
+// deterministic. The empty slots have the id INT_MAX.
+struct BeamCandidateMax {
+  __device__ __forceinline__ BeamCandidate
+  operator()(const BeamCandidate& a, const BeamCandidate& b) const {
+    return (b.score > a.score || (b.score == a.score && b.id < a.id)) ? b : a;
+  }
+};
+
+// One block per beam. Selects the beam_size best tokens of the beam by
+// log_softmax(logits) + beam_score into the candidates of the beam. A
+// finished beam only proposes end_id and keeps its score.
+template <typename T, int BlockSize, int MaxBeamSize>
+__global__ void BeamStepTopKPerBeam(const T* logits,
+                                    const float* beam_scores,
+                                    const bool* finished,
+                                    int64_t vocab_size,
+                                    int beam_size,
+                                    int end_id,
+                                    float* cand_scores,
+                                    int* cand_ids) {
+  using BlockReduceF = cub::BlockReduce<float, BlockSize>;
+  using BlockReduceC = cub::BlockReduce<BeamCandidate, BlockSize>;
+  __shared__ union {
+    typename BlockReduceF::TempStorage f;
+    typename BlockReduceC::TempStorage c;
+  } temp_storage;
+  __shared__ float s_max;
+  __shared__ float s_lse;
+  __shared__ int s_best_id;
+
+  const int64_t row = blockIdx.x;
+  float* row_cand_scores = cand_scores + row * beam_size;
+  int* row_cand_ids = cand_ids + row * beam_size;
+  const float beam_score = beam_scores[row];
+  if (finished[row]) {
+    for (int i = threadIdx.x; i < beam_size; i += BlockSize) {
+      row_cand_scores[i] = i == 0 ? beam_score : kBeamStepNegInf;
+      row_cand_ids[i] = end_id;
+    }
+    return;
+  }
+
+  // the top beam_size logits of the thread, in descending order
+  const T* row_logits = logits + row * vocab_size;
+  float top_scores[MaxBeamSize];
+  int top_ids[MaxBeamSize];
+#pragma unroll
+  for (int i = 0; i < MaxBeamSize; ++i) {
+    top_scores[i] = kBeamStepNegInf;
+    top_ids[i] = INT_MAX;
+  }
+  for (int64_t i = threadIdx.x; i < vocab_size; i += BlockSize) {
+    const float x = static_cast<float>(row_logits[i]);
+    if (x > top_scores[beam_size - 1]) {
+      int j = beam_size - 1;
+      for (; j > 0 && top_scores[j - 1] < x; --j) {
+        top_scores[j] = top_scores[j - 1];
+        top_ids[j] = top_ids[j - 1];
+      }
+      top_scores[j] = x;
+      top_ids[j] = static_cast<int>(i);
+    }
+  }
+
+  // the log-sum-exp of the row, whose max is the best of the local lists
+  const float max =
+      BlockReduceF(temp_storage.f).Reduce(top_scores[0], cub::Max());
+  if (threadIdx.x == 0) {
+    s_max = max;
+  }
+  __syncthreads();
+  float sum = 0.f;
+  for (int64_t i = threadIdx.x; i < vocab_size; i += BlockSize) {
+    sum += expf(static_cast<float>(row_logits[i]) - s_max);
+  }
+  sum = BlockReduceF(temp_storage.f).Sum(sum);
+  if (threadIdx.x == 0) {
+    s_lse = s_max + logf(sum);
+  }
+  __syncthreads();
+
+  // merges the local lists, the thread owning the winner pops its head
+  int head = 0;
+  for (int k = 0; k < beam_size; ++k) {
+    BeamCandidate cand{kBeamStepNegInf, INT_MAX};
+    if (head < beam_size) {
+      cand = {top_scores[head], top_ids[head]};
+    }
+    const BeamCandidate best =
+        BlockReduceC(temp_storage.c).Reduce(cand, BeamCandidateMax());
+    if (threadIdx.x == 0) {
+      s_best_id = best.id;
+      row_cand_scores[k] = best.score - s_lse + beam_score;
+      // less than beam_size tokens are reachable, the beam is dead anyway
+      row_cand_ids[k] = best.id == INT_MAX ? end_id : best.id;
+    }
+    __syncthreads();
+    if (head < beam_size && top_ids[head] == s_best_id) {
+      ++head;
+    }
+    __syncthreads();
+  }
+}
+
+// One block per batch. Selects the beam_size best of the
+// beam_size * beam_size candidates of the batch, and the row of the beam
+// each of them extends, which reorders the caches.
+template <int BlockSize>
+__global__ void BeamStepTopKPerBatch(const float* cand_scores,
+                                     const int* cand_ids,
+                                     const bool* finished,
+                                     int beam_size,
+                                     int end_id,
+                                     int64_t* next_ids,
+                                     float* next_scores,
+                                     int* parent_idx,
+                                     bool* next_finished) {
+  using BlockReduceC = cub::BlockReduce<BeamCandidate, BlockSize>;
+  __shared__ typename BlockReduceC::TempStorage temp_storage;
+  __shared__ int s_best_id;
+
+  const int64_t batch = blockIdx.x;
+  const int num_cands = beam_size * beam_size;
+  const int tid = threadIdx.x;
+  BeamCandidate cand{kBeamStepNegInf, INT_MAX};
+  if (tid < num_cands) {
+    cand = {cand_scores[batch * num_cands + tid], tid};
+  }
+  for (int k = 0; k < beam_size; ++k) {
+    const BeamCandidate best =
+        BlockReduceC(temp_storage).Reduce(cand, BeamCandidateMax());
+    if (tid == 0) {
+      const int64_t out = batch * beam_size + k;
+      const int64_t parent = batch * beam_size + best.id / beam_size;
+      const int id = cand_ids[batch * num_cands + best.id];
+      next_ids[out] = id;
+      next_scores[out] = best.score;
+      parent_idx[out] = static_cast<int>(parent);
+      next_finished[out] = finished[parent] || id == end_id;
+      s_best_id = best.id;
+    }
+    __syncthreads();
+    if (cand.id == s_best_id) {
+      cand = {kBeamStepNegInf, INT_MAX};
+    }
+    __syncthreads();
+  }
+}
+
+template <typename T, typename Context>
+void FusedBeamSearchStepKernel(const Context& dev_ctx,
+                               const DenseTensor& logits,
+                               const DenseTensor& beam_scores,
+                               const DenseTensor& finished,
+                               int beam_size,
+                               int end_id,
+                               DenseTensor* next_ids,
+                               DenseTensor* next_scores,
+                               DenseTensor* parent_idx,
+                               DenseTensor* next_finished) {
+  PADDLE_ENFORCE_LE(
+      beam_size,
+      kBeamStepMaxBeamSize,
+      common::errors::InvalidArgument(
+          "The beam_size of fused_beam_search_step should not be greater "
+          "than %d, but received %d.",
+          kBeamStepMaxBeamSize,
+          beam_size));
+  const int64_t rows = logits.dims()[0];
+  const int64_t vocab_size = logits.dims()[1];
+  PADDLE_ENFORCE_LE(vocab_size,
+                    std::numeric_limits<int>::max(),
+                    common::errors::InvalidArgument(
+                        "The vocab_size should fit in int32, but received %d.",
+                        vocab_size));
+
+  auto* next_ids_data = dev_ctx.template Alloc<int64_t>(next_ids);
+  auto* next_scores_data = dev_ctx.template Alloc<float>(next_scores);
+  auto* parent_idx_data = dev_ctx.template Alloc<int>(parent_idx);
+  auto* next_finished_data = dev_ctx.template Alloc<bool>(next_finished);
+  if (rows == 0) {
+    return;
+  }
+
+  // the candidates of each beam stay on the device between the two stages
+  DenseTensor cand_scores;
+  cand_scores.Resize({rows * beam_size});
+  auto* cand_scores_data = dev_ctx.template Alloc<float>(&cand_scores);
+  DenseTensor cand_ids;
+  cand_ids.Resize({rows * beam_size});
+  auto* cand_ids_data = dev_ctx.template Alloc<int>(&cand_ids);
+
+  auto stream = dev_ctx.stream();
+  BeamStepTopKPerBeam<T, kBeamStepBlockSize, kBeamStepMaxBeamSize>
+      <<<rows, kBeamStepBlockSize, 0, stream>>>(logits.data<T>(),
+                                                beam_scores.data<float>(),
+                                                finished.data<bool>(),
+                                                vocab_size,
+                                                beam_size,
+                                                end_id,
+                                                cand_scores_data,
+                                                cand_ids_data);
+  BeamStepTopKPerBatch<kBeamStepBlockSize>
+      <<<rows / beam_size, kBeamStepBlockSize, 0, stream>>>(
+          cand_scores_data,
+          cand_ids_data,
+          finished.data<bool>(),
+          beam_size,
+          end_id,
+          next_ids_data,
+          next_scores_data,
+          parent_idx_data,
+          next_finished_data);
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_beam_search_step,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedBeamSearchStepKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(1).SetDataType(phi::DataType::FLOAT32);
+  kernel->InputAt(2).SetDataType(phi::DataType::BOOL);
+  kernel->OutputAt(0).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(2).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(3).SetDataType(phi::DataType::BOOL);
+}
@@ -0,0 +1,254 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/broadcast_function.h"
+
+namespace phi {
+namespace fusion {
+
+enum class ElementwiseChainOp : int {
+  kAdd,
+  kSubtract,
+  kMultiply,
+  kDivide,
+  kMaximum,
+  kMinimum,
+  kRelu,
+  kGelu,
+  kSilu,
+  kSigmoid,
+  kTanh,
+  kScale,
+};
+
+constexpr int kMaxElementwiseChainOps = 16;
+
+// The ops of a chain, which are passed to the kernel by value.
+struct ElementwiseChainProgram {
+  ElementwiseChainOp ops[kMaxElementwiseChainOps];
+  float scales[kMaxElementwiseChainOps];
+  int num_ops{0};
+};
+
+static ElementwiseChainOp ToElementwiseChainOp(const std::string& op) {
+  static const std::unordered_map<std::string, ElementwiseChainOp> kOps = {
+      {"add", ElementwiseChainOp::kAdd},
+      {"subtract", ElementwiseChainOp::kSubtract},
+      {"multiply", ElementwiseChainOp::kMultiply},
+      {"divide", ElementwiseChainOp::kDivide},
+      {"maximum", ElementwiseChainOp::kMaximum},
+      {"minimum", ElementwiseChainOp::kMinimum},
+      {"relu", ElementwiseChainOp::kRelu},
+      {"gelu", ElementwiseChainOp::kGelu},
+      {"silu", ElementwiseChainOp::kSilu},
+      {"sigmoid", ElementwiseChainOp::kSigmoid},
+      {"tanh", ElementwiseChainOp::kTanh},
+      {"scale", ElementwiseChainOp::kScale},
+  };
+  auto iter = kOps.find(op);
+  PADDLE_ENFORCE_EQ(
+      iter != kOps.end(),
+      true,
+      common::errors::InvalidArgument(
+          "The op %s is not supported by fused_elementwise_chain.", op));
+  return iter->second;
+}
+
+// Applies the chain to the element of the inputs in registers, the first
+// input is the start value and each binary op takes the next input.
+template <typename T>
+struct ElementwiseChainCompute {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+
+  explicit ElementwiseChainCompute(const ElementwiseChainProgram& program)
+      : program_(program) {}
+
+  HOSTDEVICE inline T Compute(const T* args) const {
+    MT value = static_cast<MT>(args[0]);
+    int next_input = 1;
+    int next_scale = 0;
+    for (int i = 0; i < program_.num_ops; ++i) {
+      switch (program_.ops[i]) {
+        case ElementwiseChainOp::kAdd:
+          value = value + static_cast<MT>(args[next_input++]);
+          break;
+        case ElementwiseChainOp::kSubtract:
+          value = value - static_cast<MT>(args[next_input++]);
+          break;
+        case ElementwiseChainOp::kMultiply:
+          value = value * static_cast<MT>(args[next_input++]);
+          break;
+        case ElementwiseChainOp::kDivide:
+          value = value / static_cast<MT>(args[next_input++]);
+          break;
+        case ElementwiseChainOp::kMaximum: {
+          const MT other = static_cast<MT>(args[next_input++]);
+          value = value > other ? value : other;
+          break;
+        }
+        case ElementwiseChainOp::kMinimum: {
+          const MT other = static_cast<MT>(args[next_input++]);
+          value = value < other ? value : other;
+          break;
+        }
+        case ElementwiseChainOp::kRelu:
+          value = value > static_cast<MT>(0) ? value : static_cast<MT>(0);
+          break;
+        case ElementwiseChainOp::kGelu:
+          value =
+              value * static_cast<MT>(0.5) *
+              (static_cast<MT>(1) + erf(value * static_cast<MT>(M_SQRT1_2)));
+          break;
+        case ElementwiseChainOp::kSilu:
+          value = value / (static_cast<MT>(1) + exp(-value));
+          break;
+        case ElementwiseChainOp::kSigmoid:
+          value = static_cast<MT>(1) / (static_cast<MT>(1) + exp(-value));
+          break;
+        case ElementwiseChainOp::kTanh:
+          value = tanh(value);
+          break;
+        case ElementwiseChainOp::kScale:
+          value = value * static_cast<MT>(program_.scales[next_scale++]);
+          break;
+      }
+    }
+    return static_cast<T>(value);
+  }
+
+  ElementwiseChainProgram program_;
+};
+
+// The arity of the functors of BroadcastKernel is the number of the arguments
+// of operator(), so there is a functor for each number of inputs.
+template <typename T, int Arity>
+struct ElementwiseChainFunctor;
+
+template <typename T>
+struct ElementwiseChainFunctor<T, 1> : public ElementwiseChainCompute<T> {
+  using ElementwiseChainCompute<T>::ElementwiseChainCompute;
+  HOSTDEVICE inline T operator()(const T x) const {
+    const T args[1] = {x};
+    return this->Compute(args);
+  }
+};
+
+template <typename T>
+struct ElementwiseChainFunctor<T, 2> : public ElementwiseChainCompute<T> {
+  using ElementwiseChainCompute<T>::ElementwiseChainCompute;
+  HOSTDEVICE inline T operator()(const T x, const T y) const {
+    const T args[2] = {x, y};
+    return this->Compute(args);
+  }
+};
+
+template <typename T>
+struct ElementwiseChainFunctor<T, 3> : public ElementwiseChainCompute<T> {
+  using ElementwiseChainCompute<T>::ElementwiseChainCompute;
+  HOSTDEVICE inline T operator()(const T x, const T y, const T z) const {
+    const T args[3] = {x, y, z};
+    return this->Compute(args);
+  }
+};
+
+template <typename T>
+struct ElementwiseChainFunctor<T, 4> : public ElementwiseChainCompute<T> {
+  using ElementwiseChainCompute<T>::ElementwiseChainCompute;
+  HOSTDEVICE inline T operator()(const T x,
+                                 const T y,
+                                 const T z,
+                                 const T w) const {
+    const T args[4] = {x, y, z, w};
+    return this->Compute(args);
+  }
+};
+
+template <typename T, int Arity>
+void LaunchElementwiseChain(const phi::GPUContext& dev_ctx,
+                            const std::vector<const DenseTensor*>& ins,
+                            const ElementwiseChainProgram& program,
+                            DenseTensor* out) {
+  std::vector<DenseTensor*> outs = {out};
+  funcs::BroadcastKernel<T>(
+      dev_ctx, ins, &outs, ElementwiseChainFunctor<T, Arity>(program));
+}
+
+// Runs a chain of broadcast elementwise ops, e.g. add -> multiply -> gelu ->
+// scale, in a single kernel which keeps the intermediate values in registers,
+// instead of launching a kernel and writing the result back for each op.
+template <typename T, typename Context>
+void FusedElementwiseChainKernel(const Context& dev_ctx,
+                                 const std::vector<const DenseTensor*>& x,
+                                 const std::vector<std::string>& ops,
+                                 const std::vector<float>& scales,
+                                 DenseTensor* out) {
+  PADDLE_ENFORCE_LE(
+      static_cast<int>(ops.size()),
+      kMaxElementwiseChainOps,
+      common::errors::InvalidArgument(
+          "The fused_elementwise_chain supports at most %d ops, but "
+          "received %d.",
+          kMaxElementwiseChainOps,
+          ops.size()));
+  ElementwiseChainProgram program;
+  program.num_ops = static_cast<int>(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    program.ops[i] = ToElementwiseChainOp(ops[i]);
+  }
+  std::copy(scales.begin(), scales.end(), program.scales);
+
+  dev_ctx.template Alloc<T>(out);
+  if (out->numel() == 0) {
+    return;
+  }
+  switch (x.size()) {
+    case 1:
+      LaunchElementwiseChain<T, 1>(dev_ctx, x, program, out);
+      break;
+    case 2:
+      LaunchElementwiseChain<T, 2>(dev_ctx, x, program, out);
+      break;
+    case 3:
+      LaunchElementwiseChain<T, 3>(dev_ctx, x, program, out);
+      break;
+    case 4:
+      LaunchElementwiseChain<T, 4>(dev_ctx, x, program, out);
+      break;
+    default:
+      PADDLE_THROW(common::errors::InvalidArgument(
+          "The fused_elementwise_chain supports at most 4 inputs, but "
+          "received %d.",
+          x.size()));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_elementwise_chain,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedElementwiseChainKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16,
+                   phi::dtype::float16) {}
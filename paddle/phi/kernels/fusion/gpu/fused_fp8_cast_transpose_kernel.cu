@@ -0,0 +1,192 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/float8_e4m3fn.h"
+#include "paddle/phi/common/float8_e5m2.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+namespace phi {
+namespace fusion {
+
+constexpr int kCastTransposeTile = 32;
+constexpr int kCastTransposeRowsPerIter = 8;
+
+template <typename OutT>
+struct FP8MaxTrait;
+
+template <>
+struct FP8MaxTrait<phi::dtype::float8_e4m3fn> {
+  static constexpr float kMax = 448.0f;
+};
+
+template <>
+struct FP8MaxTrait<phi::dtype::float8_e5m2> {
+  static constexpr float kMax = 57344.0f;
+};
+
+// Each block casts a 32 x 32 tile of x, stores it to out and, through the
+// shared memory, transposed to out_t. The amax of x is recorded into
+// amax_history[0]. As the amax is not negative, its bits are ordered as ints.
+template <typename T, typename OutT, bool Transpose>
+__global__ void FP8CastTransposeKernel(const T* x,
+                                       const float* scale,
+                                       OutT* out,
+                                       OutT* out_t,
+                                       float* amax_history,
+                                       int rows,
+                                       int cols) {
+  __shared__ OutT tile[kCastTransposeTile][kCastTransposeTile + 1];
+  const int row_start = blockIdx.y * kCastTransposeTile;
+  const int col_start = blockIdx.x * kCastTransposeTile;
+  const float scale_v = *scale;
+  constexpr float kMax = FP8MaxTrait<OutT>::kMax;
+
+  float amax = 0.f;
+  const int col = col_start + threadIdx.x;
+  for (int i = threadIdx.y; i < kCastTransposeTile;
+       i += kCastTransposeRowsPerIter) {
+    const int row = row_start + i;
+    if (row < rows && col < cols) {
+      const int64_t idx = static_cast<int64_t>(row) * cols + col;
+      const float v = static_cast<float>(x[idx]);
+      amax = fmaxf(amax, fabsf(v));
+      const OutT q =
+          static_cast<OutT>(fminf(fmaxf(v * scale_v, -kMax), kMax));
+      out[idx] = q;
+      if (Transpose) {
+        tile[i][threadIdx.x] = q;
+      }
+    }
+  }
+
+  if (Transpose) {
+    __syncthreads();
+    const int t_col = row_start + threadIdx.x;
+    for (int i = threadIdx.y; i < kCastTransposeTile;
+         i += kCastTransposeRowsPerIter) {
+      const int t_row = col_start + i;
+      if (t_row < cols && t_col < rows) {
+        out_t[static_cast<int64_t>(t_row) * rows + t_col] =
+            tile[threadIdx.x][i];
+      }
+    }
+  }
+
+  // The block is flattened for the reduction.
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+  __shared__ float warp_amax[kCastTransposeRowsPerIter];
+  amax = phi::funcs::WarpReduceMax<float>(amax, 0xffffffff);
+  if (tid % 32 == 0) {
+    warp_amax[tid / 32] = amax;
+  }
+  __syncthreads();
+  if (tid == 0) {
+    for (int i = 1; i < kCastTransposeRowsPerIter; ++i) {
+      amax = fmaxf(amax, warp_amax[i]);
+    }
+    atomicMax(reinterpret_cast<int*>(amax_history), __float_as_int(amax));
+  }
+}
+
+template <typename T, typename OutT, typename Context>
+void LaunchFP8CastTranspose(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& scale,
+                            bool transpose,
+                            DenseTensor* out,
+                            DenseTensor* out_t,
+                            DenseTensor* amax_history_out) {
+  const int cols = x.dims()[x.dims().size() - 1];
+  const int rows = x.numel() / cols;
+  OutT* out_data = dev_ctx.template Alloc<OutT>(out);
+  OutT* out_t_data = nullptr;
+  if (transpose) {
+    out_t_data = dev_ctx.template Alloc<OutT>(out_t);
+  }
+  if (x.numel() == 0) return;
+
+  dim3 block(kCastTransposeTile, kCastTransposeRowsPerIter);
+  dim3 grid((cols + kCastTransposeTile - 1) / kCastTransposeTile,
+            (rows + kCastTransposeTile - 1) / kCastTransposeTile);
+  if (transpose) {
+    FP8CastTransposeKernel<T, OutT, true>
+        <<<grid, block, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                               scale.data<float>(),
+                                               out_data,
+                                               out_t_data,
+                                               amax_history_out->data<float>(),
+                                               rows,
+                                               cols);
+  } else {
+    FP8CastTransposeKernel<T, OutT, false>
+        <<<grid, block, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                               scale.data<float>(),
+                                               out_data,
+                                               out_t_data,
+                                               amax_history_out->data<float>(),
+                                               rows,
+                                               cols);
+  }
+}
+
+template <typename T, typename Context>
+void FusedFP8CastTransposeKernel(const Context& dev_ctx,
+                                 const DenseTensor& x,
+                                 const DenseTensor& scale,
+                                 const DenseTensor& amax_history,
+                                 const std::string& out_dtype,
+                                 bool transpose,
+                                 DenseTensor* out,
+                                 DenseTensor* out_t,
+                                 DenseTensor* amax_history_out) {
+  // amax_history is updated in place.
+  if (dev_ctx.template Alloc<float>(amax_history_out) !=
+      amax_history.data<float>()) {
+    phi::Copy(
+        dev_ctx, amax_history, dev_ctx.GetPlace(), false, amax_history_out);
+  }
+  // out_t is not created if transpose is false.
+  transpose = transpose && out_t != nullptr;
+  if (out_dtype == "float8_e4m3fn") {
+    LaunchFP8CastTranspose<T, phi::dtype::float8_e4m3fn>(
+        dev_ctx, x, scale, transpose, out, out_t, amax_history_out);
+  } else if (out_dtype == "float8_e5m2") {
+    LaunchFP8CastTranspose<T, phi::dtype::float8_e5m2>(
+        dev_ctx, x, scale, transpose, out, out_t, amax_history_out);
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "fused_fp8_cast_transpose only support float8_e4m3fn and "
+        "float8_e5m2 output, but got %s.",
+        out_dtype));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_fp8_cast_transpose,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedFP8CastTransposeKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(1).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+}
@@ -0,0 +1,294 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+namespace fusion {
+
+constexpr int kLoraBlockSize = 256;
+constexpr int kLoraMaxGridY = 65535;
+
+// The adapter of the segment holding `row`, or -1 if no segment holds it.
+__device__ __forceinline__ int FindLoraAdapter(const int* seg_offsets,
+                                               const int* adapter_ids,
+                                               int num_segments,
+                                               int64_t row) {
+  // the first segment ending after row
+  int lo = 0;
+  int hi = num_segments;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (seg_offsets[mid + 1] <= row) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == num_segments || row < seg_offsets[lo]) {
+    return -1;
+  }
+  return adapter_ids[lo];
+}
+
+// tmp[row, j] = x[row, :] . lora_a[adapter, j, :], a block per row and a warp
+// per rank, where the rows of a segment gather the same adapter.
+template <typename T, int VecSize>
+__global__ void LoraShrinkKernel(const T* x,
+                                 const T* lora_a,
+                                 const int* seg_offsets,
+                                 const int* adapter_ids,
+                                 int num_segments,
+                                 int64_t k,
+                                 int rank,
+                                 float* tmp) {
+  __shared__ int adapter;
+  const int64_t row = blockIdx.x;
+  if (threadIdx.x == 0) {
+    adapter = FindLoraAdapter(seg_offsets, adapter_ids, num_segments, row);
+  }
+  __syncthreads();
+
+  float* row_tmp = tmp + row * rank;
+  if (adapter < 0) {
+    for (int j = threadIdx.x; j < rank; j += blockDim.x) {
+      row_tmp[j] = 0.f;
+    }
+    return;
+  }
+  const int lane = threadIdx.x % 32;
+  const int warp_num = blockDim.x / 32;
+  const T* x_row = x + row * k;
+  const T* a = lora_a + static_cast<int64_t>(adapter) * rank * k;
+  for (int j = threadIdx.x / 32; j < rank; j += warp_num) {
+    const T* a_row = a + j * k;
+    float sum = 0.f;
+    for (int64_t i = lane * VecSize; i < k; i += 32 * VecSize) {
+      phi::AlignedVector<T, VecSize> x_vec;
+      phi::AlignedVector<T, VecSize> a_vec;
+      phi::Load<T, VecSize>(x_row + i, &x_vec);
+      phi::Load<T, VecSize>(a_row + i, &a_vec);
+#pragma unroll
+      for (int v = 0; v < VecSize; ++v) {
+        sum += static_cast<float>(x_vec[v]) * static_cast<float>(a_vec[v]);
+      }
+    }
+    sum = phi::funcs::WarpReduceSum<float>(sum, 0xffffffff);
+    if (lane == 0) {
+      row_tmp[j] = sum;
+    }
+  }
+}
+
+// out[row, :] = base_out[row, :] + scaling * tmp[row, :] . lora_b[adapter],
+// with VecSize columns per thread and a row of blocks per row.
+template <typename T, int VecSize>
+__global__ void LoraExpandKernel(const float* tmp,
+                                 const T* lora_b,
+                                 const T* base_out,
+                                 const int* seg_offsets,
+                                 const int* adapter_ids,
+                                 int num_segments,
+                                 int64_t m,
+                                 int64_t n,
+                                 int rank,
+                                 float scaling,
+                                 T* out) {
+  extern __shared__ float row_tmp[];
+  __shared__ int adapter;
+  const int64_t col =
+      (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) * VecSize;
+  for (int64_t row = blockIdx.y; row < m; row += gridDim.y) {
+    if (threadIdx.x == 0) {
+      adapter = FindLoraAdapter(seg_offsets, adapter_ids, num_segments, row);
+    }
+    for (int j = threadIdx.x; j < rank; j += blockDim.x) {
+      row_tmp[j] = tmp[row * rank + j] * scaling;
+    }
+    __syncthreads();
+
+    if (col < n) {
+      float acc[VecSize];
+      if (base_out != nullptr) {
+        phi::AlignedVector<T, VecSize> base_vec;
+        phi::Load<T, VecSize>(base_out + row * n + col, &base_vec);
+#pragma unroll
+        for (int v = 0; v < VecSize; ++v) {
+          acc[v] = static_cast<float>(base_vec[v]);
+        }
+      } else {
+#pragma unroll
+        for (int v = 0; v < VecSize; ++v) {
+          acc[v] = 0.f;
+        }
+      }
+      if (adapter >= 0) {
+        const T* b = lora_b + static_cast<int64_t>(adapter) * rank * n + col;
+        for (int j = 0; j < rank; ++j) {
+          phi::AlignedVector<T, VecSize> b_vec;
+          phi::Load<T, VecSize>(b + j * n, &b_vec);
+#pragma unroll
+          for (int v = 0; v < VecSize; ++v) {
+            acc[v] += row_tmp[j] * static_cast<float>(b_vec[v]);
+          }
+        }
+      }
+      phi::AlignedVector<T, VecSize> out_vec;
+#pragma unroll
+      for (int v = 0; v < VecSize; ++v) {
+        out_vec[v] = static_cast<T>(acc[v]);
+      }
+      phi::Store<T, VecSize>(out_vec, out + row * n + col);
+    }
+    __syncthreads();
+  }
+}
+
+template <typename T, int VecSize>
+static void LaunchMultiLora(const GPUContext& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& lora_a,
+                            const DenseTensor& lora_b,
+                            const DenseTensor& seg_offsets,
+                            const DenseTensor& adapter_ids,
+                            const T* base_out,
+                            float scaling,
+                            DenseTensor* out) {
+  const int64_t k = x.dims()[x.dims().size() - 1];
+  const int64_t m = x.numel() / k;
+  const int rank = static_cast<int>(lora_a.dims()[1]);
+  const int64_t n = lora_b.dims()[2];
+  const int num_segments = static_cast<int>(adapter_ids.numel());
+
+  DenseTensor tmp;
+  tmp.Resize({m, rank});
+  float* tmp_data = dev_ctx.template Alloc<float>(&tmp);
+
+  LoraShrinkKernel<T, VecSize>
+      <<<m, kLoraBlockSize, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                                   lora_a.data<T>(),
+                                                   seg_offsets.data<int>(),
+                                                   adapter_ids.data<int>(),
+                                                   num_segments,
+                                                   k,
+                                                   rank,
+                                                   tmp_data);
+
+  const int64_t col_blocks =
+      (n / VecSize + kLoraBlockSize - 1) / kLoraBlockSize;
+  const dim3 grid(col_blocks, std::min<int64_t>(m, kLoraMaxGridY));
+  LoraExpandKernel<T, VecSize>
+      <<<grid, kLoraBlockSize, rank * sizeof(float), dev_ctx.stream()>>>(
+          tmp_data,
+          lora_b.data<T>(),
+          base_out,
+          seg_offsets.data<int>(),
+          adapter_ids.data<int>(),
+          num_segments,
+          m,
+          n,
+          rank,
+          scaling,
+          out->data<T>());
+}
+
+template <typename T, typename Context>
+void FusedMultiLoraLinearKernel(const Context& dev_ctx,
+                                const DenseTensor& x,
+                                const DenseTensor& lora_a,
+                                const DenseTensor& lora_b,
+                                const DenseTensor& seg_offsets,
+                                const DenseTensor& adapter_ids,
+                                const paddle::optional<DenseTensor>& base_out,
+                                float scaling,
+                                DenseTensor* out) {
+  PADDLE_ENFORCE_EQ(
+      seg_offsets.dtype() == DataType::INT32 &&
+          adapter_ids.dtype() == DataType::INT32,
+      true,
+      common::errors::InvalidArgument(
+          "The seg_offsets and adapter_ids of fused_multi_lora_linear "
+          "should be int32."));
+  dev_ctx.template Alloc<T>(out);
+  if (out->numel() == 0) {
+    return;
+  }
+  const T* base_out_data = base_out ? base_out->data<T>() : nullptr;
+  if (adapter_ids.numel() == 0) {
+    // no row takes an adapter
+    if (base_out) {
+      phi::Copy(dev_ctx, *base_out, dev_ctx.GetPlace(), false, out);
+    } else {
+      phi::funcs::SetConstant<Context, T>()(dev_ctx, out, static_cast<T>(0));
+    }
+    return;
+  }
+
+  const int64_t k = x.dims()[x.dims().size() - 1];
+  const int64_t n = lora_b.dims()[2];
+  constexpr int kVecSize = 4;
+  bool vectorized = k % kVecSize == 0 && n % kVecSize == 0;
+  for (const T* ptr : {x.data<T>(),
+                       lora_a.data<T>(),
+                       lora_b.data<T>(),
+                       base_out_data,
+                       static_cast<const T*>(out->data<T>())}) {
+    if (ptr != nullptr && phi::GetVectorizedSize<T>(ptr) < kVecSize) {
+      vectorized = false;
+    }
+  }
+  if (vectorized) {
+    LaunchMultiLora<T, kVecSize>(dev_ctx,
+                                 x,
+                                 lora_a,
+                                 lora_b,
+                                 seg_offsets,
+                                 adapter_ids,
+                                 base_out_data,
+                                 scaling,
+                                 out);
+  } else {
+    LaunchMultiLora<T, 1>(dev_ctx,
+                          x,
+                          lora_a,
+                          lora_b,
+                          seg_offsets,
+                          adapter_ids,
+                          base_out_data,
+                          scaling,
+                          out);
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_multi_lora_linear,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedMultiLoraLinearKernel,
+                   float,
+                   phi::dtype::bfloat16,
+                   phi::dtype::float16) {
+  kernel->InputAt(3).SetDataType(phi::DataType::INT32);
+  kernel->InputAt(4).SetDataType(phi::DataType::INT32);
+}
@@ -0,0 +1,333 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+namespace fusion {
+
+// Quantizes like the int8 caches of block_multihead_attention, which are
+// stored as uint8 with an offset of 128.
+__device__ __forceinline__ uint8_t QuantizeCacheValue(float value,
+                                                      float scale,
+                                                      int round_type,
+                                                      float max_bound,
+                                                      float min_bound) {
+  float quant_value = scale * value;
+  quant_value = round_type == 0 ? rintf(quant_value) : roundf(quant_value);
+  quant_value = fminf(fmaxf(quant_value, min_bound), max_bound);
+  return static_cast<uint8_t>(quant_value + 128.0f);
+}
+
+template <typename T>
+__device__ __forceinline__ void StoreCacheValue(
+    T* cache, int64_t idx, float value, float, int, float, float) {
+  cache[idx] = static_cast<T>(value);
+}
+
+__device__ __forceinline__ void StoreCacheValue(uint8_t* cache,
+                                                int64_t idx,
+                                                float value,
+                                                float scale,
+                                                int round_type,
+                                                float max_bound,
+                                                float min_bound) {
+  cache[idx] =
+      QuantizeCacheValue(value, scale, round_type, max_bound, min_bound);
+}
+
+// One block per (sequence, head) of the decoding step, one thread per
+// rotated pair of the head. Adds the bias, rotates the q and k heads by the
+// position of the token, and writes q to q_out and k, v into the slot of
+// the token in the paged caches, so each element is read and written once.
+// The rotation and the sin / cos are the same as the ones of
+// fused_rotary_position_embedding.
+template <typename T, typename CacheT>
+__global__ void FusedQkvRopeCacheCUDAKernel(const T* qkv,
+                                            const T* qkv_bias,
+                                            const T* sin_data,
+                                            const T* cos_data,
+                                            const int64_t* position_ids,
+                                            const int* block_tables,
+                                            const float* cache_k_quant_scales,
+                                            const float* cache_v_quant_scales,
+                                            int q_num_head,
+                                            int kv_num_head,
+                                            int head_dim,
+                                            int block_size,
+                                            int max_blocks_per_seq,
+                                            bool use_neox_rotary_style,
+                                            float rotary_emb_base,
+                                            int quant_round_type,
+                                            float quant_max_bound,
+                                            float quant_min_bound,
+                                            T* q_out,
+                                            CacheT* key_cache,
+                                            CacheT* value_cache) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  const int64_t bi = blockIdx.x;
+  const int hi = blockIdx.y;
+  const int half_dim = head_dim / 2;
+  const int64_t pos = position_ids[bi];
+  const bool is_q = hi < q_num_head;
+  const bool is_k = !is_q && hi < q_num_head + kv_num_head;
+
+  for (int i = threadIdx.x; i < half_dim; i += blockDim.x) {
+    const int d0 = use_neox_rotary_style ? i : 2 * i;
+    const int d1 = use_neox_rotary_style ? i + half_dim : 2 * i + 1;
+    if (pos < 0) {
+      // a stopped sequence, whose caches are left as is
+      if (is_q) {
+        T* out = q_out + (bi * q_num_head + hi) * head_dim;
+        out[d0] = static_cast<T>(0);
+        out[d1] = static_cast<T>(0);
+      }
+      continue;
+    }
+
+    const T* x = qkv + (bi * (q_num_head + 2 * kv_num_head) + hi) * head_dim;
+    MPType x0 = static_cast<MPType>(x[d0]);
+    MPType x1 = static_cast<MPType>(x[d1]);
+    if (qkv_bias) {
+      x0 += static_cast<MPType>(qkv_bias[hi * head_dim + d0]);
+      x1 += static_cast<MPType>(qkv_bias[hi * head_dim + d1]);
+    }
+
+    if (is_q || is_k) {
+      MPType sin0, sin1, cos0, cos1;
+      if (sin_data) {
+        sin0 = static_cast<MPType>(sin_data[pos * head_dim + d0]);
+        sin1 = static_cast<MPType>(sin_data[pos * head_dim + d1]);
+        cos0 = static_cast<MPType>(cos_data[pos * head_dim + d0]);
+        cos1 = static_cast<MPType>(cos_data[pos * head_dim + d1]);
+      } else {
+        const MPType base = static_cast<MPType>(rotary_emb_base);
+        const MPType div_c = static_cast<MPType>(1.0f / head_dim);
+        const MPType exp0 = static_cast<MPType>(d0 / 2 * 2) * div_c;
+        const MPType exp1 = static_cast<MPType>(d1 / 2 * 2) * div_c;
+        const MPType theta0 = static_cast<MPType>(pos) / pow(base, exp0);
+        const MPType theta1 = static_cast<MPType>(pos) / pow(base, exp1);
+        sin0 = sin(theta0);
+        cos0 = cos(theta0);
+        sin1 = sin(theta1);
+        cos1 = cos(theta1);
+      }
+      const MPType y0 = x0 * cos0 - x1 * sin0;
+      const MPType y1 = x1 * cos1 + x0 * sin1;
+      x0 = y0;
+      x1 = y1;
+    }
+
+    if (is_q) {
+      T* out = q_out + (bi * q_num_head + hi) * head_dim;
+      out[d0] = static_cast<T>(x0);
+      out[d1] = static_cast<T>(x1);
+      continue;
+    }
+    const int kv_hi = hi - q_num_head - (is_k ? 0 : kv_num_head);
+    const int physical_block =
+        block_tables[bi * max_blocks_per_seq + pos / block_size];
+    const int64_t cache_offset =
+        ((static_cast<int64_t>(physical_block) * kv_num_head + kv_hi) *
+             block_size +
+         pos % block_size) *
+        head_dim;
+    CacheT* cache = is_k ? key_cache : value_cache;
+    const float scale =
+        cache_k_quant_scales
+            ? (is_k ? cache_k_quant_scales : cache_v_quant_scales)[kv_hi]
+            : 1.0f;
+    StoreCacheValue(cache,
+                    cache_offset + d0,
+                    static_cast<float>(x0),
+                    scale,
+                    quant_round_type,
+                    quant_max_bound,
+                    quant_min_bound);
+    StoreCacheValue(cache,
+                    cache_offset + d1,
+                    static_cast<float>(x1),
+                    scale,
+                    quant_round_type,
+                    quant_max_bound,
+                    quant_min_bound);
+  }
+}
+
+template <typename T, typename CacheT>
+void LaunchFusedQkvRopeCache(
+    const phi::GPUContext& dev_ctx,
+    const DenseTensor& qkv,
+    const DenseTensor& position_ids,
+    const DenseTensor& block_tables,
+    const paddle::optional<DenseTensor>& qkv_bias,
+    const paddle::optional<DenseTensor>& sin,
+    const paddle::optional<DenseTensor>& cos,
+    const paddle::optional<DenseTensor>& cache_k_quant_scales,
+    const paddle::optional<DenseTensor>& cache_v_quant_scales,
+    int q_num_head,
+    int kv_num_head,
+    bool use_neox_rotary_style,
+    float rotary_emb_base,
+    int quant_round_type,
+    float quant_max_bound,
+    float quant_min_bound,
+    DenseTensor* q_out,
+    DenseTensor* key_cache_out,
+    DenseTensor* value_cache_out) {
+  const int64_t bsz = qkv.dims()[0];
+  const int head_dim =
+      static_cast<int>(qkv.dims()[1] / (q_num_head + 2 * kv_num_head));
+  const int block_size = static_cast<int>(key_cache_out->dims()[2]);
+  const int half_dim = head_dim / 2;
+  const int threads = std::min(std::max(half_dim, 32), 512);
+  dim3 grid(bsz, q_num_head + 2 * kv_num_head);
+  FusedQkvRopeCacheCUDAKernel<T, CacheT>
+      <<<grid, threads, 0, dev_ctx.stream()>>>(
+          qkv.data<T>(),
+          qkv_bias ? qkv_bias->data<T>() : nullptr,
+          sin ? sin->data<T>() : nullptr,
+          cos ? cos->data<T>() : nullptr,
+          position_ids.data<int64_t>(),
+          block_tables.data<int>(),
+          cache_k_quant_scales ? cache_k_quant_scales->data<float>() : nullptr,
+          cache_v_quant_scales ? cache_v_quant_scales->data<float>() : nullptr,
+          q_num_head,
+          kv_num_head,
+          head_dim,
+          block_size,
+          static_cast<int>(block_tables.dims()[1]),
+          use_neox_rotary_style,
+          rotary_emb_base,
+          quant_round_type,
+          quant_max_bound,
+          quant_min_bound,
+          q_out->data<T>(),
+          key_cache_out->data<CacheT>(),
+          value_cache_out->data<CacheT>());
+}
+
+template <typename T, typename Context>
+void FusedQkvRopeCacheKernel(
+    const Context& dev_ctx,
+    const DenseTensor& qkv,
+    const DenseTensor& key_cache,
+    const DenseTensor& value_cache,
+    const DenseTensor& position_ids,
+    const DenseTensor& block_tables,
+    const paddle::optional<DenseTensor>& qkv_bias,
+    const paddle::optional<DenseTensor>& sin,
+    const paddle::optional<DenseTensor>& cos,
+    const paddle::optional<DenseTensor>& cache_k_quant_scales,
+    const paddle::optional<DenseTensor>& cache_v_quant_scales,
+    int q_num_head,
+    int kv_num_head,
+    bool use_neox_rotary_style,
+    float rotary_emb_base,
+    int quant_round_type,
+    float quant_max_bound,
+    float quant_min_bound,
+    DenseTensor* q_out,
+    DenseTensor* key_cache_out,
+    DenseTensor* value_cache_out) {
+  dev_ctx.template Alloc<T>(q_out);
+  if (qkv.numel() == 0) {
+    return;
+  }
+  if (cache_k_quant_scales) {
+    PADDLE_ENFORCE_EQ(key_cache.dtype(),
+                      phi::DataType::UINT8,
+                      common::errors::InvalidArgument(
+                          "The caches should be uint8 when they are "
+                          "quantized, but received %s.",
+                          key_cache.dtype()));
+    dev_ctx.template Alloc<uint8_t>(key_cache_out);
+    dev_ctx.template Alloc<uint8_t>(value_cache_out);
+    LaunchFusedQkvRopeCache<T, uint8_t>(dev_ctx,
+                                        qkv,
+                                        position_ids,
+                                        block_tables,
+                                        qkv_bias,
+                                        sin,
+                                        cos,
+                                        cache_k_quant_scales,
+                                        cache_v_quant_scales,
+                                        q_num_head,
+                                        kv_num_head,
+                                        use_neox_rotary_style,
+                                        rotary_emb_base,
+                                        quant_round_type,
+                                        quant_max_bound,
+                                        quant_min_bound,
+                                        q_out,
+                                        key_cache_out,
+                                        value_cache_out);
+  } else {
+    PADDLE_ENFORCE_EQ(key_cache.dtype(),
+                      qkv.dtype(),
+                      common::errors::InvalidArgument(
+                          "The caches should be of the dtype of the qkv (%s) "
+                          "when they are not quantized, but received %s.",
+                          qkv.dtype(),
+                          key_cache.dtype()));
+    dev_ctx.template Alloc<T>(key_cache_out);
+    dev_ctx.template Alloc<T>(value_cache_out);
+    LaunchFusedQkvRopeCache<T, T>(dev_ctx,
+                                  qkv,
+                                  position_ids,
+                                  block_tables,
+                                  qkv_bias,
+                                  sin,
+                                  cos,
+                                  cache_k_quant_scales,
+                                  cache_v_quant_scales,
+                                  q_num_head,
+                                  kv_num_head,
+                                  use_neox_rotary_style,
+                                  rotary_emb_base,
+                                  quant_round_type,
+                                  quant_max_bound,
+                                  quant_min_bound,
+                                  q_out,
+                                  key_cache_out,
+                                  value_cache_out);
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_qkv_rope_cache,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedQkvRopeCacheKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(1).SetDataType(phi::DataType::ALL_DTYPE);
+  kernel->InputAt(2).SetDataType(phi::DataType::ALL_DTYPE);
+  kernel->InputAt(3).SetDataType(phi::DataType::INT64);
+  kernel->InputAt(4).SetDataType(phi::DataType::INT32);
+  kernel->InputAt(8).SetDataType(phi::DataType::FLOAT32);
+  kernel->InputAt(9).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(1).SetDataType(phi::DataType::ALL_DTYPE);
+  kernel->OutputAt(2).SetDataType(phi::DataType::ALL_DTYPE);
+}
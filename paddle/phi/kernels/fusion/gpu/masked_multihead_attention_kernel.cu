@@ -12,11 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/aligned_vector.h"
 #include "paddle/phi/kernels/fusion/gpu/mmha_util.cu.h"
 
+COMMON_DECLARE_int32(mmha_split_seq);
+
 namespace phi {
 namespace fusion {
 
@@ -38,6 +41,14 @@ struct Masked_multihead_attention_params {
   // k [B, num_head, dim_head/x, max_seq_len, x], that is `seq_len` first
   // v [B, num_head, max_seq_len, dim_head]
   T *cache_kv;
+  // the int8 cache_kv of the same layout, round(scale * x) + 128 in uint8,
+  // cache_kv is null when it is used
+  uint8_t *cache_kv_I = nullptr;
+  // [kv_num_head], the per head scales of the int8 cache_kv
+  const float *cache_k_quant_scales = nullptr;
+  const float *cache_v_quant_scales = nullptr;
+  const float *cache_k_dequant_scales = nullptr;
+  const float *cache_v_dequant_scales = nullptr;
   // [B, max_seq_len]
   const int *beam_cache_offset = nullptr;
 
@@ -74,8 +85,67 @@ struct Masked_multihead_attention_params {
   // in MMHA, if false, attn_mask shape should be
   // [bsz, num_heads, 1, time_step(cache_seq_length)+1]
   bool mask_broadcast_num_heads;
+
+  int quant_round_type;
+  float quant_max_bound;
+  float quant_min_bound;
 };
 
+// Loads a Vec of the cache at offset, which is dequantized from the int8
+// cache if there is one.
+template <typename Vec, typename T>
+inline __device__ Vec load_cache_vec(const T *cache,
+                                     const uint8_t *cache_I,
+                                     int offset,
+                                     float dequant_scale) {
+  if (cache_I == nullptr) {
+    return *reinterpret_cast<const Vec *>(&cache[offset]);
+  }
+  constexpr int kVecSize = sizeof(Vec) / sizeof(T);
+  phi::AlignedVector<uint8_t, kVecSize> src;
+  phi::Load<uint8_t, kVecSize>(&cache_I[offset], &src);
+  Vec dst;
+  T *dst_ptr = reinterpret_cast<T *>(&dst);
+#pragma unroll
+  for (int i = 0; i < kVecSize; ++i) {
+    dst_ptr[i] = static_cast<T>((static_cast<float>(src[i]) - 128.0f) *
+                                dequant_scale);
+  }
+  return dst;
+}
+
+// Stores a Vec to the cache at offset, which is quantized to the int8
+// cache if there is one.
+template <typename Vec, typename T>
+inline __device__ void store_cache_vec(
+    const Vec &src,
+    T *cache,
+    uint8_t *cache_I,
+    int offset,
+    float quant_scale,
+    const Masked_multihead_attention_params<T> &params) {
+  if (cache_I == nullptr) {
+    *reinterpret_cast<Vec *>(&cache[offset]) = src;
+    return;
+  }
+  constexpr int kVecSize = sizeof(Vec) / sizeof(T);
+  const T *src_ptr = reinterpret_cast<const T *>(&src);
+  phi::AlignedVector<uint8_t, kVecSize> dst;
+#pragma unroll
+  for (int i = 0; i < kVecSize; ++i) {
+    float quant_value = quant_scale * static_cast<float>(src_ptr[i]);
+    if (params.quant_round_type == 0) {
+      quant_value = static_cast<float>(rint(quant_value));
+    } else {
+      quant_value = static_cast<float>(round(quant_value));
+    }
+    quant_value = ClipFunc<float>(
+        quant_value, params.quant_min_bound, params.quant_max_bound);
+    dst[i] = static_cast<uint8_t>(quant_value + 128.0f);
+  }
+  phi::Store<uint8_t, kVecSize>(dst, &cache_I[offset]);
+}
+
 template <typename T,
           int Dh,
           int Dh_MAX,
@@ -135,6 +205,19 @@ __global__ void masked_multihead_attention_kernel(
   // this cuda thread.
   const int kv_bhi = bi * kv_num_head + hi / num_head_per_group;
 
+  // the int8 cache_kv is dequantized right after it is loaded
+  float k_quant_scale = 0.f;
+  float v_quant_scale = 0.f;
+  float k_dequant_scale = 0.f;
+  float v_dequant_scale = 0.f;
+  if (params.cache_kv_I) {
+    const int kv_hi = hi / num_head_per_group;
+    k_quant_scale = params.cache_k_quant_scales[kv_hi];
+    v_quant_scale = params.cache_v_quant_scales[kv_hi];
+    k_dequant_scale = params.cache_k_dequant_scales[kv_hi];
+    v_dequant_scale = params.cache_v_dequant_scales[kv_hi];
+  }
+
   const int bbhi = bbi * params.beam_width * params.num_head + hi;
   const int tid = threadIdx.x;
 
@@ -350,7 +433,12 @@ __global__ void masked_multihead_attention_kernel(
                    co * params.max_seq_length * QK_ELTS_IN_16B +
                    act_time_step * QK_ELTS_IN_16B + ci;
       if (Dh == Dh_MAX || co < Dh / QK_ELTS_IN_16B) {
-        *reinterpret_cast<Qk_vec *>(&params.cache_kv[offset]) = k;
+        store_cache_vec<Qk_vec>(k,
+                                params.cache_kv,
+                                params.cache_kv_I,
+                                offset,
+                                k_quant_scale,
+                                params);
       }
 
       qk = dot<Qk_vec, Qk_vec>(q, k);
@@ -410,8 +498,14 @@ __global__ void masked_multihead_attention_kernel(
   constexpr int K_PER_ITER = THREADS_PER_BLOCK / THREADS_PER_KEY;
   constexpr int K_PER_WARP = WARP_SIZE / THREADS_PER_KEY;
 
-  T *k_cache = &params.cache_kv[kv_bhi * params.max_seq_length * Dh + ki];
-  T *k_cache_batch = &params.cache_kv[bbhi * params.max_seq_length * Dh + ki];
+  const int k_cache_offset = kv_bhi * params.max_seq_length * Dh + ki;
+  const int k_cache_batch_offset = bbhi * params.max_seq_length * Dh + ki;
+  T *k_cache = params.cache_kv + k_cache_offset;
+  T *k_cache_batch = params.cache_kv + k_cache_batch_offset;
+  uint8_t *k_cache_I =
+      params.cache_kv_I ? params.cache_kv_I + k_cache_offset : nullptr;
+  uint8_t *k_cache_batch_I =
+      params.cache_kv_I ? params.cache_kv_I + k_cache_batch_offset : nullptr;
   int ti_end = div_up(curr_seq_section, K_PER_WARP) * K_PER_WARP + start_seq;
 
   const int *beam_offsets = params.beam_cache_offset
@@ -433,14 +527,18 @@ __global__ void masked_multihead_attention_kernel(
         if (beam_offset) {
           k[ii] =
               (Dh == Dh_MAX || jj * QK_ELTS_IN_16B < Dh * params.max_seq_length)
-                  ? *reinterpret_cast<const K_vec *>(
-                        &k_cache_batch[beam_offset + jj * QK_ELTS_IN_16B])
+                  ? load_cache_vec<K_vec>(k_cache_batch,
+                                          k_cache_batch_I,
+                                          beam_offset + jj * QK_ELTS_IN_16B,
+                                          k_dequant_scale)
                   : k_vec_zero;
         } else {
           k[ii] =
               (Dh == Dh_MAX || jj * QK_ELTS_IN_16B < Dh * params.max_seq_length)
-                  ? *reinterpret_cast<const K_vec *>(
-                        &k_cache[jj * QK_ELTS_IN_16B])
+                  ? load_cache_vec<K_vec>(k_cache,
+                                          k_cache_I,
+                                          jj * QK_ELTS_IN_16B,
+                                          k_dequant_scale)
                   : k_vec_zero;
         }
       }
@@ -530,12 +628,18 @@ __global__ void masked_multihead_attention_kernel(
   int vo = tid / THREADS_PER_VALUE + start_seq;
   int vi = (tid % THREADS_PER_VALUE) * V_VEC_SIZE;
 
-  T *v_cache = &params.cache_kv[params.cache_batch_size * kv_num_head *
-                                    params.max_seq_length * Dh +
-                                kv_bhi * params.max_seq_length * Dh + vi];
-  T *v_cache_batch = &params.cache_kv[params.batch_size * params.num_head *
-                                          params.max_seq_length * Dh +
-                                      bbhi * params.max_seq_length * Dh + vi];
+  const int v_cache_offset =
+      params.cache_batch_size * kv_num_head * params.max_seq_length * Dh +
+      kv_bhi * params.max_seq_length * Dh + vi;
+  const int v_cache_batch_offset =
+      params.batch_size * params.num_head * params.max_seq_length * Dh +
+      bbhi * params.max_seq_length * Dh + vi;
+  T *v_cache = params.cache_kv + v_cache_offset;
+  T *v_cache_batch = params.cache_kv + v_cache_batch_offset;
+  uint8_t *v_cache_I =
+      params.cache_kv_I ? params.cache_kv_I + v_cache_offset : nullptr;
+  uint8_t *v_cache_batch_I =
+      params.cache_kv_I ? params.cache_kv_I + v_cache_batch_offset : nullptr;
 
 #ifdef MMHA_USE_FP32_ACUM_FOR_OUT
   using V_vec_acum = typename V_vec_acum_fp32_<V_vec>::Type;
@@ -556,10 +660,13 @@ __global__ void masked_multihead_attention_kernel(
               : 0;
       V_vec v;
       if (beam_offset) {
-        v = *reinterpret_cast<const V_vec *>(
-            &v_cache_batch[beam_offset + ti * Dh]);
+        v = load_cache_vec<V_vec>(v_cache_batch,
+                                  v_cache_batch_I,
+                                  beam_offset + ti * Dh,
+                                  v_dequant_scale);
       } else {
-        v = *reinterpret_cast<const V_vec *>(&v_cache[ti * Dh]);
+        v = load_cache_vec<V_vec>(
+            v_cache, v_cache_I, ti * Dh, v_dequant_scale);
       }
 #if defined(MMHA_USE_FP32_ACUM_FOR_LOGITS)
       float logit = logits_smem[ti - start_seq];
@@ -591,7 +698,8 @@ __global__ void masked_multihead_attention_kernel(
       v = add(v, v_bias);
     }
 
-    *reinterpret_cast<V_vec *>(&v_cache[act_time_step * Dh]) = v;
+    store_cache_vec<V_vec>(
+        v, v_cache, v_cache_I, act_time_step * Dh, v_quant_scale, params);
 
 #if defined(MMHA_USE_FP32_ACUM_FOR_LOGITS)
     out = fma(logits_smem[act_time_step - start_seq], cast_to_float(v), out);
@@ -970,6 +1078,46 @@ void DispatchFMHA(const phi::GPUContext &dev_ctx,
   }
 }
 
+// Chooses the number of thread blocks splitting the cached sequence of each
+// (batch, head), the partial softmax results of the blocks are reduced by
+// post_process_kernel. With a few sequences a block per (batch, head) leaves
+// most of the SMs idle, and the logits of a long sequence do not fit in the
+// shared memory of a block. Returns false if the sequence is not split.
+template <typename T>
+bool ChooseSplitSeq(const phi::GPUContext &dev_ctx,
+                    Masked_multihead_attention_params<T> *params) {
+  constexpr int kMinStepsPerBlock = 128;
+  constexpr size_t kMaxSmemSize = 0xc000;
+  constexpr int kBlocksPerSM = 4;
+  const int timestep = params->timestep;
+  if (FLAGS_mmha_split_seq == 0 || timestep <= 0) {
+    return false;
+  }
+  const int num_blocks = params->batch_size * params->num_head;
+  const int target_blocks = dev_ctx.GetSMCount() * kBlocksPerSM;
+  if (FLAGS_mmha_split_seq < 0) {
+    bool idle = timestep >= 4 * kMinStepsPerBlock && num_blocks < target_blocks;
+    // the logits are kept in the shared memory, see smem_size_in_bytes
+    bool too_long = div_up(timestep, 4) * 16 > static_cast<int>(kMaxSmemSize);
+    if (!idle && !too_long) {
+      return false;
+    }
+  }
+  // enough splits to fill the device, each holding whole 128-step chunks
+  // whose logits fit in the shared memory
+  int split_seq = std::max(1, div_up(target_blocks, num_blocks));
+  int steps_per_block = div_up(div_up(timestep, split_seq), kMinStepsPerBlock) *
+                        kMinStepsPerBlock;
+  constexpr int kMaxStepsPerBlock = kMaxSmemSize / 16 * 4;
+  steps_per_block = std::min(steps_per_block, kMaxStepsPerBlock);
+  params->steps_per_block = steps_per_block;
+  params->split_seq = div_up(timestep, steps_per_block);
+  VLOG(4) << "masked_multihead_attention splits the sequence of "
+          << timestep << " steps into " << params->split_seq << " blocks of "
+          << steps_per_block << " steps";
+  return true;
+}
+
 struct NormalVersion {};
 struct UnusedVersion {};
 
@@ -996,6 +1144,14 @@ void DispatchWithDtype(const Context &dev_ctx,
                        const paddle::optional<DenseTensor> &qkv_out_scale,
                        const paddle::optional<DenseTensor> &out_shift,
                        const paddle::optional<DenseTensor> &out_smooth,
+                       const paddle::optional<DenseTensor>
+                           &cache_k_quant_scales,
+                       const paddle::optional<DenseTensor>
+                           &cache_v_quant_scales,
+                       const paddle::optional<DenseTensor>
+                           &cache_k_dequant_scales,
+                       const paddle::optional<DenseTensor>
+                           &cache_v_dequant_scales,
                        int seq_len,
                        int rotary_emb_dims,
                        const bool use_neox_rotary_style,
@@ -1075,7 +1231,26 @@ void DispatchWithDtype(const Context &dev_ctx,
   }
 
   params.mask_broadcast_num_heads = mask_broadcast_num_heads;
-  params.cache_kv = const_cast<T *>(cache_kv_out->data<T>());
+  if (cache_kv.dtype() == phi::DataType::UINT8) {
+    PADDLE_ENFORCE_EQ(
+        cache_k_quant_scales && cache_v_quant_scales &&
+            cache_k_dequant_scales && cache_v_dequant_scales,
+        true,
+        common::errors::InvalidArgument(
+            "The quant and dequant scales of the cache should be given when "
+            "Input(cache_kv) is an int8 cache."));
+    params.cache_kv = nullptr;
+    params.cache_kv_I = cache_kv_out->data<uint8_t>();
+    params.cache_k_quant_scales = cache_k_quant_scales->data<float>();
+    params.cache_v_quant_scales = cache_v_quant_scales->data<float>();
+    params.cache_k_dequant_scales = cache_k_dequant_scales->data<float>();
+    params.cache_v_dequant_scales = cache_v_dequant_scales->data<float>();
+  } else {
+    params.cache_kv = const_cast<T *>(cache_kv_out->data<T>());
+  }
+  params.quant_round_type = quant_round_type;
+  params.quant_max_bound = quant_max_bound;
+  params.quant_min_bound = quant_min_bound;
   params.neox_rotary_style = use_neox_rotary_style;
   params.batch_size = bsz;
   params.cache_batch_size = cache_bsz;
@@ -1089,14 +1264,8 @@ void DispatchWithDtype(const Context &dev_ctx,
   params.steps_per_block = timestep;  // if not SPLIT, this is unuseful.
   params.split_seq = 1;               // if not SPLIT, grid.x==1
 
-  bool SPLIT = false;
-  if (bsz <= 4 && timestep >= 512) {
-    SPLIT = true;
-  }
+  bool SPLIT = ChooseSplitSeq(dev_ctx, &params);
   if (SPLIT) {
-    const int steps_per_block = 128;
-    params.steps_per_block = steps_per_block;
-    params.split_seq = (timestep - 1) / steps_per_block + 1;
     int split_seq = params.split_seq;
 
     phi::DenseTensor qk_sum_max_split_seq;
@@ -1183,6 +1352,14 @@ void DispatchWithDtype(const Context &dev_ctx,
                        const paddle::optional<DenseTensor> &qkv_out_scale,
                        const paddle::optional<DenseTensor> &out_shift,
                        const paddle::optional<DenseTensor> &out_smooth,
+                       const paddle::optional<DenseTensor>
+                           &cache_k_quant_scales,
+                       const paddle::optional<DenseTensor>
+                           &cache_v_quant_scales,
+                       const paddle::optional<DenseTensor>
+                           &cache_k_dequant_scales,
+                       const paddle::optional<DenseTensor>
+                           &cache_v_dequant_scales,
                        int seq_len,
                        int rotary_emb_dims,
                        const bool use_neox_rotary_style,
@@ -1210,6 +1387,10 @@ void MMHAKernel(const Context &dev_ctx,
                 const paddle::optional<DenseTensor> &qkv_out_scale,
                 const paddle::optional<DenseTensor> &out_shift,
                 const paddle::optional<DenseTensor> &out_smooth,
+                const paddle::optional<DenseTensor> &cache_k_quant_scales,
+                const paddle::optional<DenseTensor> &cache_v_quant_scales,
+                const paddle::optional<DenseTensor> &cache_k_dequant_scales,
+                const paddle::optional<DenseTensor> &cache_v_dequant_scales,
                 int seq_len,
                 int rotary_emb_dims,
                 const bool use_neox_rotary_style,
@@ -1238,6 +1419,10 @@ void MMHAKernel(const Context &dev_ctx,
             qkv_out_scale,
             out_shift,
             out_smooth,
+            cache_k_quant_scales,
+            cache_v_quant_scales,
+            cache_k_dequant_scales,
+            cache_v_dequant_scales,
             seq_len,
             rotary_emb_dims,
             use_neox_rotary_style,
@@ -1265,6 +1450,10 @@ void MMHAKernel(const Context &dev_ctx,
             qkv_out_scale,
             out_shift,
             out_smooth,
+            cache_k_quant_scales,
+            cache_v_quant_scales,
+            cache_k_dequant_scales,
+            cache_v_dequant_scales,
             seq_len,
             rotary_emb_dims,
             use_neox_rotary_style,
@@ -1292,6 +1481,10 @@ void MMHAKernel(const Context &dev_ctx,
             qkv_out_scale,
             out_shift,
             out_smooth,
+            cache_k_quant_scales,
+            cache_v_quant_scales,
+            cache_k_dequant_scales,
+            cache_v_dequant_scales,
             seq_len,
             rotary_emb_dims,
             use_neox_rotary_style,
@@ -1325,6 +1518,10 @@ void MMHAKernel(const Context &dev_ctx,
         qkv_out_scale,
         out_shift,
         out_smooth,
+        cache_k_quant_scales,
+        cache_v_quant_scales,
+        cache_k_dequant_scales,
+        cache_v_dequant_scales,
         seq_len,
         rotary_emb_dims,
         use_neox_rotary_style,
@@ -0,0 +1,293 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef PADDLE_WITH_CUSPARSELT
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+
+#include "paddle/phi/backends/dynload/cusparseLt.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+namespace fusion {
+
+// The dims of the dense matrices are padded to it.
+constexpr int64_t kSparseAlignment = 16;
+
+static void CheckCusparseLt(cusparseStatus_t status, const char* call) {
+  PADDLE_ENFORCE_EQ(static_cast<int>(status),
+                    static_cast<int>(CUSPARSE_STATUS_SUCCESS),
+                    common::errors::External(
+                        "%s failed with the cuSPARSELt status %d.",
+                        call,
+                        static_cast<int>(status)));
+}
+
+template <typename T>
+static cudaDataType_t CusparseLtDataType() {
+  return std::is_same<T, phi::dtype::bfloat16>::value ? CUDA_R_16BF
+                                                      : CUDA_R_16F;
+}
+
+// The handle of a device, leaked on purpose like the other process wide
+// library handles, since it can not be destroyed after the runtime unloads.
+static cusparseLtHandle_t* GetCusparseLtHandle(int device_id) {
+  static std::mutex mutex;
+  static std::map<int, cusparseLtHandle_t*> handles;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& handle = handles[device_id];
+  if (handle == nullptr) {
+    handle = new cusparseLtHandle_t;
+    CheckCusparseLt(phi::dynload::cusparseLtInit(handle), "cusparseLtInit");
+  }
+  return handle;
+}
+
+// The weight w[k, n] in row major is the n x k column major matrix w^T,
+// which is pruned along k. So out[m, n] = x[m, k] * w[k, n] is computed as
+// out^T = w^T * x^T in column major, with the sparse w^T on the left.
+static void InitSparseWeightDescriptor(cusparseLtHandle_t* handle,
+                                       cusparseLtMatDescriptor_t* desc,
+                                       int64_t k,
+                                       int64_t n,
+                                       cudaDataType_t type) {
+  CheckCusparseLt(
+      phi::dynload::cusparseLtStructuredDescriptorInit(
+          handle,
+          desc,
+          n,
+          k,
+          n,
+          kSparseAlignment,
+          type,
+          CUSPARSE_ORDER_COL,
+          CUSPARSELT_SPARSITY_50_PERCENT),
+      "cusparseLtStructuredDescriptorInit");
+}
+
+struct Sparse24Plan {
+  cusparseLtMatDescriptor_t mat_w;
+  cusparseLtMatDescriptor_t mat_x;
+  cusparseLtMatDescriptor_t mat_out;
+  cusparseLtMatmulDescriptor_t matmul;
+  cusparseLtMatmulAlgSelection_t alg_sel;
+  cusparseLtMatmulPlan_t plan;
+  size_t workspace_size{0};
+};
+
+// The plans are cached by the padded rows, so a few of them serve the
+// dynamic batch sizes. They are leaked for the same reason as the handles.
+static const Sparse24Plan* GetSparse24Plan(int device_id,
+                                           int64_t m,
+                                           int64_t k,
+                                           int64_t n,
+                                           cudaDataType_t type) {
+  using Key = std::tuple<int, int64_t, int64_t, int64_t, int>;
+  static std::mutex mutex;
+  static std::map<Key, Sparse24Plan*> plans;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& plan = plans[Key(device_id, m, k, n, static_cast<int>(type))];
+  if (plan != nullptr) {
+    return plan;
+  }
+  auto* handle = GetCusparseLtHandle(device_id);
+  auto new_plan = std::make_unique<Sparse24Plan>();
+  InitSparseWeightDescriptor(handle, &new_plan->mat_w, k, n, type);
+  CheckCusparseLt(phi::dynload::cusparseLtDenseDescriptorInit(
+                      handle,
+                      &new_plan->mat_x,
+                      k,
+                      m,
+                      k,
+                      kSparseAlignment,
+                      type,
+                      CUSPARSE_ORDER_COL),
+                  "cusparseLtDenseDescriptorInit");
+  CheckCusparseLt(phi::dynload::cusparseLtDenseDescriptorInit(
+                      handle,
+                      &new_plan->mat_out,
+                      n,
+                      m,
+                      n,
+                      kSparseAlignment,
+                      type,
+                      CUSPARSE_ORDER_COL),
+                  "cusparseLtDenseDescriptorInit");
+  CheckCusparseLt(
+      phi::dynload::cusparseLtMatmulDescriptorInit(
+          handle,
+          &new_plan->matmul,
+          CUSPARSE_OPERATION_NON_TRANSPOSE,
+          CUSPARSE_OPERATION_NON_TRANSPOSE,
+          &new_plan->mat_w,
+          &new_plan->mat_x,
+          &new_plan->mat_out,
+          &new_plan->mat_out,
+          CUSPARSE_COMPUTE_16F),
+      "cusparseLtMatmulDescriptorInit");
+  CheckCusparseLt(
+      phi::dynload::cusparseLtMatmulAlgSelectionInit(
+          handle,
+          &new_plan->alg_sel,
+          &new_plan->matmul,
+          CUSPARSELT_MATMUL_ALG_DEFAULT),
+      "cusparseLtMatmulAlgSelectionInit");
+  CheckCusparseLt(
+      phi::dynload::cusparseLtMatmulGetWorkspace(
+          handle, &new_plan->alg_sel, &new_plan->workspace_size),
+      "cusparseLtMatmulGetWorkspace");
+  CheckCusparseLt(
+      phi::dynload::cusparseLtMatmulPlanInit(handle,
+                                             &new_plan->plan,
+                                             &new_plan->matmul,
+                                             &new_plan->alg_sel,
+                                             new_plan->workspace_size),
+      "cusparseLtMatmulPlanInit");
+  plan = new_plan.release();
+  return plan;
+}
+
+template <typename T, typename Context>
+void Sparse24WeightCompressKernel(const Context& dev_ctx,
+                                  const DenseTensor& w,
+                                  DenseTensor* out) {
+  const int64_t k = w.dims()[0];
+  const int64_t n = w.dims()[1];
+  PADDLE_ENFORCE_EQ(
+      k % kSparseAlignment == 0 && n % kSparseAlignment == 0,
+      true,
+      common::errors::InvalidArgument(
+          "The dims of the w of sparse_2_4_weight_compress should be "
+          "multiples of %d, but received [%d, %d].",
+          kSparseAlignment,
+          k,
+          n));
+  auto* handle = GetCusparseLtHandle(dev_ctx.GetPlace().GetDeviceId());
+  cusparseLtMatDescriptor_t mat_w;
+  InitSparseWeightDescriptor(handle, &mat_w, k, n, CusparseLtDataType<T>());
+  size_t compressed_size = 0;
+  CheckCusparseLt(phi::dynload::cusparseLtSpMMACompressedSize2(
+                      handle, &mat_w, &compressed_size),
+                  "cusparseLtSpMMACompressedSize2");
+  out->Resize({static_cast<int64_t>(compressed_size)});
+  auto* out_data = dev_ctx.template Alloc<uint8_t>(out);
+  CheckCusparseLt(
+      phi::dynload::cusparseLtSpMMACompress2(handle,
+                                             &mat_w,
+                                             1,
+                                             CUSPARSE_OPERATION_NON_TRANSPOSE,
+                                             w.data<T>(),
+                                             out_data,
+                                             dev_ctx.stream()),
+      "cusparseLtSpMMACompress2");
+  phi::dynload::cusparseLtMatDescriptorDestroy(&mat_w);
+}
+
+template <typename T, typename Context>
+void Sparse24LinearKernel(const Context& dev_ctx,
+                          const DenseTensor& x,
+                          const DenseTensor& w,
+                          int n,
+                          DenseTensor* out) {
+  auto* out_data = dev_ctx.template Alloc<T>(out);
+  if (out->numel() == 0) {
+    return;
+  }
+  const int64_t k = x.dims()[x.dims().size() - 1];
+  const int64_t m = x.numel() / k;
+  // the rows of x and out are padded into temporaries if needed, the padded
+  // rows of x are left uninitialized since they only reach the padded rows
+  // of out
+  const int64_t padded_m =
+      (m + kSparseAlignment - 1) / kSparseAlignment * kSparseAlignment;
+  const int device_id = dev_ctx.GetPlace().GetDeviceId();
+  const auto* plan =
+      GetSparse24Plan(device_id, padded_m, k, n, CusparseLtDataType<T>());
+
+  const T* x_data = x.data<T>();
+  T* matmul_out = out_data;
+  DenseTensor padded_x;
+  DenseTensor padded_out;
+  if (padded_m != m) {
+    padded_x.Resize({padded_m, k});
+    T* padded_x_data = dev_ctx.template Alloc<T>(&padded_x);
+    phi::backends::gpu::GpuMemcpyAsync(padded_x_data,
+                                       x_data,
+                                       m * k * sizeof(T),
+                                       cudaMemcpyDeviceToDevice,
+                                       dev_ctx.stream());
+    x_data = padded_x_data;
+    padded_out.Resize({padded_m, n});
+    matmul_out = dev_ctx.template Alloc<T>(&padded_out);
+  }
+  DenseTensor workspace;
+  void* workspace_data = nullptr;
+  if (plan->workspace_size > 0) {
+    workspace.Resize({static_cast<int64_t>(plan->workspace_size)});
+    workspace_data = dev_ctx.template Alloc<uint8_t>(&workspace);
+  }
+
+  float alpha = 1.f;
+  float beta = 0.f;
+  cudaStream_t stream = dev_ctx.stream();
+  CheckCusparseLt(phi::dynload::cusparseLtMatmul(GetCusparseLtHandle(device_id),
+                                                 &plan->plan,
+                                                 &alpha,
+                                                 w.data<uint8_t>(),
+                                                 x_data,
+                                                 &beta,
+                                                 matmul_out,
+                                                 matmul_out,
+                                                 workspace_data,
+                                                 &stream,
+                                                 1),
+                  "cusparseLtMatmul");
+  if (matmul_out != out_data) {
+    phi::backends::gpu::GpuMemcpyAsync(out_data,
+                                       matmul_out,
+                                       m * n * sizeof(T),
+                                       cudaMemcpyDeviceToDevice,
+                                       dev_ctx.stream());
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(sparse_2_4_weight_compress,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::Sparse24WeightCompressKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UINT8);
+}
+
+PD_REGISTER_KERNEL(sparse_2_4_linear,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::Sparse24LinearKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(1).SetDataType(phi::DataType::UINT8);
+}
+
+#endif
@@ -0,0 +1,123 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+namespace fusion {
+
+constexpr int kSpeculateVerifyBlockSize = 128;
+
+// One thread per sequence. The rows of the verification window are the last
+// committed token (row 0) and the draft nodes (row i + 1 for node i), and
+// target_tokens holds the token the target model generates after each row.
+// Starting from row 0, the child node drafting the token the target generates
+// is accepted and the walk goes on from it, so a chain accepts its longest
+// matching prefix and a tree its longest matching path. The token the target
+// generates after the last accepted row is appended as the bonus token.
+template <typename T>
+__global__ void SpeculateVerify(const T* draft_tokens,
+                                const T* target_tokens,
+                                const int* draft_parents,
+                                int64_t batch_size,
+                                int num_draft,
+                                T* accept_tokens,
+                                int* accept_num,
+                                int* accept_index) {
+  const int64_t bi = static_cast<int64_t>(blockIdx.x) * blockDim.x +
+                     threadIdx.x;
+  if (bi >= batch_size) {
+    return;
+  }
+  const T* drafts = draft_tokens + bi * num_draft;
+  const T* targets = target_tokens + bi * (num_draft + 1);
+  const int* parents = draft_parents + bi * num_draft;
+  T* tokens = accept_tokens + bi * (num_draft + 1);
+  int* index = accept_index + bi * (num_draft + 1);
+
+  int num = 0;
+  int cur = -1;
+  index[0] = 0;
+  while (true) {
+    const T want = targets[cur + 1];
+    int next = -1;
+    // the nodes are in topological order, the children come after cur
+    for (int i = cur + 1; i < num_draft; ++i) {
+      if (parents[i] == cur && drafts[i] == want) {
+        next = i;
+        break;
+      }
+    }
+    if (next < 0) {
+      break;
+    }
+    tokens[num] = want;
+    ++num;
+    index[num] = next + 1;
+    cur = next;
+  }
+  tokens[num] = targets[cur + 1];
+  ++num;
+  accept_num[bi] = num;
+  for (int i = num; i <= num_draft; ++i) {
+    tokens[i] = static_cast<T>(-1);
+    index[i] = -1;
+  }
+}
+
+template <typename T, typename Context>
+void SpeculateVerifyKernel(const Context& dev_ctx,
+                           const DenseTensor& draft_tokens,
+                           const DenseTensor& target_tokens,
+                           const DenseTensor& draft_parents,
+                           DenseTensor* accept_tokens,
+                           DenseTensor* accept_num,
+                           DenseTensor* accept_index) {
+  const int64_t batch_size = draft_tokens.dims()[0];
+  const int num_draft = static_cast<int>(draft_tokens.dims()[1]);
+  auto* accept_tokens_data = dev_ctx.template Alloc<T>(accept_tokens);
+  auto* accept_num_data = dev_ctx.template Alloc<int>(accept_num);
+  auto* accept_index_data = dev_ctx.template Alloc<int>(accept_index);
+  if (batch_size == 0) {
+    return;
+  }
+  const int64_t grid =
+      (batch_size + kSpeculateVerifyBlockSize - 1) / kSpeculateVerifyBlockSize;
+  SpeculateVerify<T>
+      <<<grid, kSpeculateVerifyBlockSize, 0, dev_ctx.stream()>>>(
+          draft_tokens.data<T>(),
+          target_tokens.data<T>(),
+          draft_parents.data<int>(),
+          batch_size,
+          num_draft,
+          accept_tokens_data,
+          accept_num_data,
+          accept_index_data);
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(speculate_verify,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::SpeculateVerifyKernel,
+                   int,
+                   int64_t) {
+  kernel->InputAt(2).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(2).SetDataType(phi::DataType::INT32);
+}
@@ -311,6 +311,20 @@ class FCOneDNNHandler
     auto memory_p = std::static_pointer_cast<dnnl::memory>(
         this->dev_ctx_.GetBlob(weights_key));
 
+    // the weights another thread or input shape packed already
+    const bool prepack = OneDNNContext::tls().is_prepack_weights_on();
+    const std::string packed_key =
+        prepack ? phi::funcs::PackedWeightsKey(
+                      *weights, this->fwd_pd_->weights_desc(), scale_data)
+                : "";
+    if (!memory_p && prepack) {
+      memory_p = OneDNNPackedWeights::Instance().Get(packed_key,
+                                                     weights->Holder());
+      if (memory_p) {
+        this->dev_ctx_.SetBlob(weights_key, memory_p);
+      }
+    }
+
     if (!memory_p) {
       const float* weights_data = weights->data<float>();
       auto weights_dims = this->fwd_pd_->weights_desc().get_dims();
@@ -338,6 +352,10 @@ class FCOneDNNHandler
       }
 
       this->dev_ctx_.SetBlob(weights_key, memory_p);
+      if (prepack) {
+        OneDNNPackedWeights::Instance().Set(
+            packed_key, weights->Holder(), memory_p);
+      }
     }
     return memory_p;
   }
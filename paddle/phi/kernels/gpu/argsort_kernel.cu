@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/argsort_kernel.h"
 
+#include <algorithm>
+
 #include <thrust/copy.h>
 #include <thrust/execution_policy.h>
 #include <thrust/sequence.h>
@@ -225,6 +227,138 @@ void ArgFullSort(const phi::GPUContext& ctx,
   PADDLE_ENFORCE_GPU_SUCCESS(err);
 }
 
+#ifdef PADDLE_WITH_CUDA
+// Sorts each short row by a block in shared memory, as the segmented radix
+// sort of the device is slow for the many short segments. The keys are sorted
+// as the twiddled bits like cub::DeviceSegmentedRadixSort, so that NaNs are
+// ordered the same. The padding keys are the largest (or the smallest for
+// descending) bits after all the valid keys, as the radix sort is stable.
+template <typename T, int BlockSize, int ItemsPerThread, bool Descending>
+__global__ void BlockSortShortRows(const T* input,
+                                   T* output,
+                                   int64_t* indices,
+                                   const int64_t num_rows,
+                                   const int num_cols) {
+  using UnsignedBits = typename cub::Traits<T>::UnsignedBits;
+  using BlockRadixSortT =
+      cub::BlockRadixSort<UnsignedBits, BlockSize, ItemsPerThread, int>;
+  __shared__ typename BlockRadixSortT::TempStorage temp_storage;
+
+  for (int64_t row = blockIdx.x; row < num_rows; row += gridDim.x) {
+    const UnsignedBits* row_input =
+        reinterpret_cast<const UnsignedBits*>(input) + row * num_cols;
+    UnsignedBits keys[ItemsPerThread];
+    int values[ItemsPerThread];
+#pragma unroll
+    for (int i = 0; i < ItemsPerThread; ++i) {
+      // The blocked arrangement keeps the order of the columns for ties.
+      int col = threadIdx.x * ItemsPerThread + i;
+      keys[i] = col < num_cols
+                    ? cub::Traits<T>::TwiddleIn(row_input[col])
+                    : (Descending ? static_cast<UnsignedBits>(0)
+                                  : static_cast<UnsignedBits>(~0ULL));
+      values[i] = col;
+    }
+    if (Descending) {
+      BlockRadixSortT(temp_storage)
+          .SortDescendingBlockedToStriped(keys, values);
+    } else {
+      BlockRadixSortT(temp_storage).SortBlockedToStriped(keys, values);
+    }
+
+    UnsignedBits* row_output =
+        reinterpret_cast<UnsignedBits*>(output) + row * num_cols;
+    int64_t* row_indices = indices + row * num_cols;
+#pragma unroll
+    for (int i = 0; i < ItemsPerThread; ++i) {
+      int rank = i * BlockSize + threadIdx.x;
+      if (rank < num_cols) {
+        row_output[rank] = cub::Traits<T>::TwiddleOut(keys[i]);
+        row_indices[rank] = values[i];
+      }
+    }
+    // temp_storage is reused by the next row.
+    __syncthreads();
+  }
+}
+
+constexpr int kBlockSortMaxCols = 1024;
+
+template <typename T, int BlockSize, int ItemsPerThread>
+void LaunchBlockSortShortRows(const phi::GPUContext& ctx,
+                              const T* input,
+                              T* output,
+                              int64_t* indices,
+                              const int64_t num_rows,
+                              const int num_cols,
+                              const bool descending) {
+  int64_t max_grid = ctx.GetCUDAMaxGridDimSize()[0];
+  int grid_size = static_cast<int>(std::min(num_rows, max_grid));
+  if (descending) {
+    BlockSortShortRows<T, BlockSize, ItemsPerThread, true>
+        <<<grid_size, BlockSize, 0, ctx.stream()>>>(
+            input, output, indices, num_rows, num_cols);
+  } else {
+    BlockSortShortRows<T, BlockSize, ItemsPerThread, false>
+        <<<grid_size, BlockSize, 0, ctx.stream()>>>(
+            input, output, indices, num_rows, num_cols);
+  }
+}
+
+template <typename T>
+void ArgBlockSort(const phi::GPUContext& ctx,
+                  const DenseTensor* input,
+                  DenseTensor* output,
+                  DenseTensor* indices,
+                  const int64_t num_rows,
+                  const int64_t num_cols,
+                  const bool descending) {
+  const T* inp = input->data<T>();
+  T* out = ctx.template Alloc<T>(output);
+  int64_t* ind = ctx.template Alloc<int64_t>(indices);
+  const int cols = static_cast<int>(num_cols);
+  if (cols <= 32) {
+    LaunchBlockSortShortRows<T, 32, 1>(
+        ctx, inp, out, ind, num_rows, cols, descending);
+  } else if (cols <= 64) {
+    LaunchBlockSortShortRows<T, 32, 2>(
+        ctx, inp, out, ind, num_rows, cols, descending);
+  } else if (cols <= 128) {
+    LaunchBlockSortShortRows<T, 32, 4>(
+        ctx, inp, out, ind, num_rows, cols, descending);
+  } else if (cols <= 256) {
+    LaunchBlockSortShortRows<T, 64, 4>(
+        ctx, inp, out, ind, num_rows, cols, descending);
+  } else if (cols <= 512) {
+    LaunchBlockSortShortRows<T, 128, 4>(
+        ctx, inp, out, ind, num_rows, cols, descending);
+  } else {
+    LaunchBlockSortShortRows<T, 128, 8>(
+        ctx, inp, out, ind, num_rows, cols, descending);
+  }
+}
+#endif
+
+// Sorts each row of [num_rows, num_cols], by a block for the short rows.
+template <typename T>
+void ArgSortRows(const phi::GPUContext& ctx,
+                 const DenseTensor* input,
+                 DenseTensor* output,
+                 DenseTensor* indices,
+                 const int64_t num_rows,
+                 const int64_t num_cols,
+                 const bool descending) {
+#ifdef PADDLE_WITH_CUDA
+  if (num_cols <= kBlockSortMaxCols) {
+    ArgBlockSort<T>(
+        ctx, input, output, indices, num_rows, num_cols, descending);
+    return;
+  }
+#endif
+  ArgFullSort<T, int64_t>(
+      ctx, input, output, indices, num_rows, num_cols, descending);
+}
+
 template <typename T, typename Context>
 void ArgsortKernel(const Context& dev_ctx,
                    const DenseTensor& input,
@@ -283,13 +417,13 @@ void ArgsortKernel(const Context& dev_ctx,
     const int64_t input_height =
         common::product(common::slice_ddim(in_dims, 0, in_dims.size() - 1));
     const int64_t input_width = in_dims[in_dims.size() - 1];
-    ArgFullSort<T, int64_t>(dev_ctx,
-                            &input,
-                            output,
-                            indices,
-                            input_height,
-                            input_width,
-                            descending);
+    ArgSortRows<T>(dev_ctx,
+                   &input,
+                   output,
+                   indices,
+                   input_height,
+                   input_width,
+                   descending);
   } else {
     // if not full sort, do transpose first
     std::vector<int> trans;
@@ -326,13 +460,13 @@ void ArgsortKernel(const Context& dev_ctx,
     dev_ctx.template Alloc<int64_t>(&tmp_indices);
     dev_ctx.template Alloc<int64_t>(indices);
 
-    ArgFullSort<T, int64_t>(dev_ctx,
-                            &trans_inp,
-                            &tmp_out,
-                            &tmp_indices,
-                            input_height,
-                            input_width,
-                            descending);
+    ArgSortRows<T>(dev_ctx,
+                   &trans_inp,
+                   &tmp_out,
+                   &tmp_indices,
+                   input_height,
+                   input_width,
+                   descending);
 
     TransposeKernel<int64_t, Context>(dev_ctx, tmp_indices, trans, indices);
     // transpose back
@@ -23,9 +23,6 @@
 
 namespace phi {
 
-static cudaStream_t nvjpeg_stream = nullptr;
-static nvjpegHandle_t nvjpeg_handle = nullptr;
-
 void InitNvjpegImage(nvjpegImage_t* img) {
   for (int c = 0; c < NVJPEG_MAX_COMPONENT; c++) {
     img->channel[c] = nullptr;
@@ -33,107 +30,235 @@ void InitNvjpegImage(nvjpegImage_t* img) {
   }
 }
 
-template <typename T, typename Context>
-void DecodeJpegKernel(const Context& dev_ctx,
-                      const DenseTensor& x,
-                      const std::string& mode,
-                      DenseTensor* out) {
-  // Create nvJPEG handle
-  if (nvjpeg_handle == nullptr) {
-    nvjpegStatus_t create_status =
-        phi::dynload::nvjpegCreateSimple(&nvjpeg_handle);
+static void EnforceNvjpegSuccess(nvjpegStatus_t status, const char* api) {
+  PADDLE_ENFORCE_EQ(
+      status,
+      NVJPEG_STATUS_SUCCESS,
+      errors::Fatal("%s failed with nvjpegStatus %d.", api, status));
+}
 
-    PADDLE_ENFORCE_EQ(
-        create_status,
-        NVJPEG_STATUS_SUCCESS,
-        errors::Fatal("nvjpegCreateSimple failed: ", create_status));
-  }
+// The nvJPEG handles are thread safe, so they are created once and shared.
+static nvjpegHandle_t GetNvjpegHandle() {
+  static nvjpegHandle_t handle = [] {
+    nvjpegHandle_t handle = nullptr;
+    EnforceNvjpegSuccess(phi::dynload::nvjpegCreateSimple(&handle),
+                         "nvjpegCreateSimple");
+    return handle;
+  }();
+  return handle;
+}
+
+// The handle decoding the batches on the NVJPG engines of A100 and later,
+// nullptr on the GPUs without them.
+static nvjpegHandle_t GetNvjpegHardwareHandle() {
+  static nvjpegHandle_t handle = [] {
+    nvjpegHandle_t handle = nullptr;
+#if CUDA_VERSION >= 11000
+    if (phi::dynload::nvjpegCreateEx(
+            NVJPEG_BACKEND_HARDWARE, nullptr, nullptr, 0, &handle) !=
+        NVJPEG_STATUS_SUCCESS) {
+      handle = nullptr;
+    }
+#endif
+    return handle;
+  }();
+  return handle;
+}
 
-  nvjpegJpegState_t nvjpeg_state;
-  nvjpegStatus_t state_status =
-      phi::dynload::nvjpegJpegStateCreate(nvjpeg_handle, &nvjpeg_state);
+// The decode states are not thread safe, so each thread keeps its own ones
+// and reuses them with the pinned and the device buffers they hold.
+struct NvjpegBatchedState {
+  nvjpegJpegState_t state = nullptr;
+  int batch_size = 0;
+  nvjpegOutputFormat_t output_format = NVJPEG_OUTPUT_UNCHANGED;
+};
 
-  PADDLE_ENFORCE_EQ(
-      state_status,
-      NVJPEG_STATUS_SUCCESS,
-      errors::Fatal("nvjpegJpegStateCreate failed: ", state_status));
+struct NvjpegStates {
+  nvjpegJpegState_t single = nullptr;
+  NvjpegBatchedState batched;
+  NvjpegBatchedState hardware_batched;
+};
+
+static NvjpegStates* GetNvjpegStates() {
+  thread_local NvjpegStates states;
+  return &states;
+}
 
+static void GetNvjpegOutputFormat(const std::string& mode,
+                                  int components,
+                                  nvjpegOutputFormat_t* output_format,
+                                  int* output_components) {
+  if (mode == "unchanged" && (components == 1 || components == 3)) {
+    *output_format = components == 1 ? NVJPEG_OUTPUT_Y : NVJPEG_OUTPUT_RGB;
+    *output_components = components;
+  } else if (mode == "gray") {
+    *output_format = NVJPEG_OUTPUT_Y;
+    *output_components = 1;
+  } else if (mode == "rgb") {
+    *output_format = NVJPEG_OUTPUT_RGB;
+    *output_components = 3;
+  } else {
+    PADDLE_THROW(errors::Fatal(
+        "The provided mode is not supported for JPEG files on GPU"));
+  }
+}
+
+// Resizes out to the decoded image of x and points image to it, the
+// channels of the image are planar.
+template <typename T, typename Context>
+static nvjpegOutputFormat_t PrepareNvjpegImage(const Context& dev_ctx,
+                                               const DenseTensor& x,
+                                               const std::string& mode,
+                                               DenseTensor* out,
+                                               nvjpegImage_t* image) {
   int components;
   nvjpegChromaSubsampling_t subsampling;
   int widths[NVJPEG_MAX_COMPONENT];
   int heights[NVJPEG_MAX_COMPONENT];
-
-  auto* x_data = x.data<T>();
-
-  nvjpegStatus_t info_status =
-      phi::dynload::nvjpegGetImageInfo(nvjpeg_handle,
-                                       x_data,
-                                       (std::size_t)x.numel(),
+  EnforceNvjpegSuccess(
+      phi::dynload::nvjpegGetImageInfo(GetNvjpegHandle(),
+                                       x.data<T>(),
+                                       static_cast<size_t>(x.numel()),
                                        &components,
                                        &subsampling,
                                        widths,
-                                       heights);
-  PADDLE_ENFORCE_EQ(info_status,
-                    NVJPEG_STATUS_SUCCESS,
-                    errors::Fatal("nvjpegGetImageInfo failed: ", info_status));
-
-  int width = widths[0];
-  int height = heights[0];
+                                       heights),
+      "nvjpegGetImageInfo");
 
   nvjpegOutputFormat_t output_format;
   int output_components;
+  GetNvjpegOutputFormat(mode, components, &output_format, &output_components);
 
-  if (mode == "unchanged") {
-    if (components == 1) {
-      output_format = NVJPEG_OUTPUT_Y;
-      output_components = 1;
-    } else if (components == 3) {
-      output_format = NVJPEG_OUTPUT_RGB;
-      output_components = 3;
-    } else {
-      phi::dynload::nvjpegJpegStateDestroy(nvjpeg_state);
-      PADDLE_THROW(errors::Fatal(
-          "The provided mode is not supported for JPEG files on GPU"));
-    }
-  } else if (mode == "gray") {
-    output_format = NVJPEG_OUTPUT_Y;
-    output_components = 1;
-  } else if (mode == "rgb") {
-    output_format = NVJPEG_OUTPUT_RGB;
-    output_components = 3;
-  } else {
-    phi::dynload::nvjpegJpegStateDestroy(nvjpeg_state);
-    PADDLE_THROW(errors::Fatal(
-        "The provided mode is not supported for JPEG files on GPU"));
+  int width = widths[0];
+  int height = heights[0];
+  std::vector<int64_t> out_shape = {output_components, height, width};
+  out->Resize(common::make_ddim(out_shape));
+  T* data = dev_ctx.template Alloc<T>(out);
+  InitNvjpegImage(image);
+  for (int c = 0; c < output_components; c++) {
+    image->channel[c] = data + c * width * height;
+    image->pitch[c] = width;
   }
+  return output_format;
+}
 
-  nvjpegImage_t out_image;
-  InitNvjpegImage(&out_image);
-
-  // create nvjpeg stream
-  if (nvjpeg_stream == nullptr) {
-    cudaStreamCreateWithFlags(&nvjpeg_stream, cudaStreamNonBlocking);
+// Whether the NVJPG engines support all the images, e.g. the progressive
+// ones are not.
+static bool IsHardwareDecodeSupported(
+    nvjpegHandle_t handle,
+    const std::vector<const unsigned char*>& data,
+    const std::vector<size_t>& lengths) {
+#if CUDA_VERSION >= 11000
+  thread_local nvjpegJpegStream_t jpeg_stream = nullptr;
+  if (jpeg_stream == nullptr &&
+      phi::dynload::nvjpegJpegStreamCreate(handle, &jpeg_stream) !=
+          NVJPEG_STATUS_SUCCESS) {
+    jpeg_stream = nullptr;
+    return false;
   }
+  for (size_t i = 0; i < data.size(); ++i) {
+    int is_supported = -1;
+    if (phi::dynload::nvjpegJpegStreamParse(
+            handle, data[i], lengths[i], 0, 0, jpeg_stream) !=
+            NVJPEG_STATUS_SUCCESS ||
+        phi::dynload::nvjpegDecodeBatchedSupported(
+            handle, jpeg_stream, &is_supported) != NVJPEG_STATUS_SUCCESS ||
+        is_supported != 0) {
+      return false;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
 
-  int sz = widths[0] * heights[0];
+template <typename T, typename Context>
+void DecodeJpegKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const std::string& mode,
+                      DenseTensor* out) {
+  nvjpegHandle_t handle = GetNvjpegHandle();
+  nvjpegJpegState_t* state = &GetNvjpegStates()->single;
+  if (*state == nullptr) {
+    EnforceNvjpegSuccess(phi::dynload::nvjpegJpegStateCreate(handle, state),
+                         "nvjpegJpegStateCreate");
+  }
 
-  std::vector<int64_t> out_shape = {output_components, height, width};
-  out->Resize(common::make_ddim(out_shape));
+  nvjpegImage_t out_image;
+  nvjpegOutputFormat_t output_format =
+      PrepareNvjpegImage<T>(dev_ctx, x, mode, out, &out_image);
 
-  T* data = dev_ctx.template Alloc<T>(out);
+  // decoded on the stream of dev_ctx, so the kernels reading out are
+  // ordered after the decoding
+  EnforceNvjpegSuccess(phi::dynload::nvjpegDecode(handle,
+                                                  *state,
+                                                  x.data<T>(),
+                                                  x.numel(),
+                                                  output_format,
+                                                  &out_image,
+                                                  dev_ctx.stream()),
+                       "nvjpegDecode");
+}
 
-  for (int c = 0; c < output_components; c++) {
-    out_image.channel[c] = data + c * sz;
-    out_image.pitch[c] = width;
+template <typename T, typename Context>
+void DecodeJpegBatchKernel(const Context& dev_ctx,
+                           const std::vector<const DenseTensor*>& x,
+                           const std::string& mode,
+                           std::vector<DenseTensor*> out) {
+  if (x.empty()) {
+    return;
+  }
+  const int batch_size = static_cast<int>(x.size());
+  std::vector<const unsigned char*> data(batch_size);
+  std::vector<size_t> lengths(batch_size);
+  std::vector<nvjpegImage_t> images(batch_size);
+  nvjpegOutputFormat_t output_format = NVJPEG_OUTPUT_UNCHANGED;
+  for (int i = 0; i < batch_size; ++i) {
+    data[i] = x[i]->data<T>();
+    lengths[i] = static_cast<size_t>(x[i]->numel());
+    nvjpegOutputFormat_t image_format =
+        PrepareNvjpegImage<T>(dev_ctx, *x[i], mode, out[i], &images[i]);
+    PADDLE_ENFORCE_EQ(
+        i == 0 || image_format == output_format,
+        true,
+        errors::InvalidArgument(
+            "The images decoded in a batch in the unchanged mode must have "
+            "the same number of channels, but image %d has %d channels. "
+            "Please use the gray or the rgb mode for the mixed images.",
+            i,
+            out[i]->dims()[0]));
+    output_format = image_format;
   }
 
-  nvjpegStatus_t decode_status = phi::dynload::nvjpegDecode(nvjpeg_handle,
-                                                            nvjpeg_state,
-                                                            x_data,
-                                                            x.numel(),
-                                                            output_format,
-                                                            &out_image,
-                                                            nvjpeg_stream);
+  nvjpegHandle_t handle = GetNvjpegHardwareHandle();
+  NvjpegBatchedState* state = &GetNvjpegStates()->hardware_batched;
+  if (handle == nullptr || !IsHardwareDecodeSupported(handle, data, lengths)) {
+    handle = GetNvjpegHandle();
+    state = &GetNvjpegStates()->batched;
+  }
+  if (state->state == nullptr) {
+    EnforceNvjpegSuccess(
+        phi::dynload::nvjpegJpegStateCreate(handle, &state->state),
+        "nvjpegJpegStateCreate");
+  }
+  // the buffers of the state are reallocated only when the batch changes
+  if (state->batch_size != batch_size ||
+      state->output_format != output_format) {
+    EnforceNvjpegSuccess(
+        phi::dynload::nvjpegDecodeBatchedInitialize(
+            handle, state->state, batch_size, 1, output_format),
+        "nvjpegDecodeBatchedInitialize");
+    state->batch_size = batch_size;
+    state->output_format = output_format;
+  }
+  EnforceNvjpegSuccess(phi::dynload::nvjpegDecodeBatched(handle,
+                                                         state->state,
+                                                         data.data(),
+                                                         lengths.data(),
+                                                         images.data(),
+                                                         dev_ctx.stream()),
+                       "nvjpegDecodeBatched");
 }
 }  // namespace phi
 
@@ -145,4 +270,12 @@ PD_REGISTER_KERNEL(decode_jpeg,  // cuda_only
   kernel->InputAt(0).SetBackend(phi::Backend::ALL_BACKEND);
 }
 
+PD_REGISTER_KERNEL(decode_jpeg_batch,  // cuda_only
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::DecodeJpegBatchKernel,
+                   uint8_t) {
+  kernel->InputAt(0).SetBackend(phi::Backend::ALL_BACKEND);
+}
+
 #endif
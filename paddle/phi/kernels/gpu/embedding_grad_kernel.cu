@@ -46,7 +46,11 @@ __global__ void EmbeddingGrad(T* table,
                               const IdT* ids,
                               const int64_t N,
                               const int64_t K,
-                              const int64_t D) {
+                              const int64_t D,
+                              const int* skip = nullptr) {
+  if (skip != nullptr && *skip != 0) {
+    return;
+  }
   int idx = threadIdx.x;
   int idy = blockIdx.x + threadIdx.y * gridDim.x;
 
@@ -107,6 +111,30 @@ struct EmbeddingGradCUDAFunctor {
       if (FLAGS_embedding_deterministic == 1) {
         phi::funcs::LaunchEmbeddingGradDeterministicKernel<T, IdT>(
             dev_ctx_, ids, d_output, d_table, N, D, K);
+      } else if (FLAGS_embedding_deterministic == 0 &&
+                 static_cast<int64_t>(K) >= funcs::kEmbeddingDedupMinIds) {
+        auto dedup_ids = funcs::DedupEmbeddingIds<IdT>(dev_ctx_, ids, K);
+        // Whether the ids repeat enough for the segmented sum is decided on
+        // device by the number of unique ids, so no sync is needed. Only one
+        // of the following kernels runs, the other returns at once.
+        auto use_segmented_sum =
+            phi::memory_utils::Alloc(dev_ctx_.GetPlace(), sizeof(int));
+        int* use_segmented_sum_data =
+            reinterpret_cast<int*>(use_segmented_sum->ptr());
+        funcs::DecideEmbeddingGradSegmentedSum<<<1, 1, 0, dev_ctx_.stream()>>>(
+            dedup_ids.num_unique, K, use_segmented_sum_data);
+        funcs::LaunchEmbeddingGradSegmentedSum<T, true>(dev_ctx_,
+                                                        dedup_ids,
+                                                        d_output,
+                                                        d_table,
+                                                        D,
+                                                        K,
+                                                        use_segmented_sum_data);
+        const int gridx = 2 * dev_ctx_.GetSMCount();
+        dim3 threads(128, 8);
+        dim3 grids(gridx, 1);
+        EmbeddingGrad<T, IdT><<<grids, threads, 0, dev_ctx_.stream()>>>(
+            d_table, d_output, ids, N, K, D, use_segmented_sum_data);
       } else {
         const int gridx = 2 * dev_ctx_.GetSMCount();
         dim3 threads(128, 8);
@@ -178,6 +206,11 @@ struct EmbeddingSparseGradCUDAFunctor {
     auto* table = &weight_;
     auto* d_output = &out_grad_;
     int64_t ids_num = input_.numel();
+    if (FLAGS_embedding_deterministic == 0 &&
+        ids_num >= funcs::kEmbeddingDedupMinIds) {
+      ApplyDedup<IdT>();
+      return;
+    }
     dim3 threads(128, 8);
     dim3 grids(8, 1);
     auto stream = dev_ctx_.stream();
@@ -227,6 +260,61 @@ struct EmbeddingSparseGradCUDAFunctor {
                        stream);
   }
 
+  // Emits a row for each unique id, whose value is the sum of the grads of the
+  // id, instead of a row for each id.
+  template <typename IdT>
+  void ApplyDedup() {
+    int64_t ids_num = input_.numel();
+    int64_t D = weight_.dims()[1];
+    auto d_output_dims = out_grad_.dims();
+    auto d_output_dims_2d =
+        common::flatten_to_2d(d_output_dims, d_output_dims.size() - 1);
+    PADDLE_ENFORCE_EQ(
+        d_output_dims_2d[0] == ids_num && d_output_dims_2d[1] == D,
+        true,
+        common::errors::InvalidArgument(
+            "ShapeError: The shape of output@Grad should be [%d, %d], but "
+            "received [%s].",
+            ids_num,
+            D,
+            d_output_dims_2d));
+    auto gpu_place = dev_ctx_.GetPlace();
+    auto stream = dev_ctx_.stream();
+    auto dedup_ids = funcs::DedupEmbeddingIds<IdT>(
+        dev_ctx_, input_.template data<IdT>(), ids_num);
+
+    // The unique ids are copied with their number at one sync.
+    int num_unique = 0;
+    std::vector<int64_t> unique_ids(ids_num);
+    memory_utils::Copy(phi::CPUPlace(),
+                       &num_unique,
+                       gpu_place,
+                       dedup_ids.num_unique,
+                       sizeof(int),
+                       stream);
+    memory_utils::Copy(phi::CPUPlace(),
+                       unique_ids.data(),
+                       gpu_place,
+                       dedup_ids.unique_ids,
+                       ids_num * sizeof(int64_t),
+                       stream);
+    dev_ctx_.Wait();
+    unique_ids.resize(num_unique);
+    weight_grad_->set_rows(unique_ids);
+    weight_grad_->set_height(weight_.dims()[0]);
+
+    auto* d_table_value = weight_grad_->mutable_value();
+    d_table_value->Resize({num_unique, D});
+    T* d_table_data = dev_ctx_.template Alloc<T>(d_table_value);
+    funcs::LaunchEmbeddingGradSegmentedSum<T, false>(
+        dev_ctx_,
+        dedup_ids,
+        out_grad_.template data<T>(),
+        d_table_data,
+        D,
+        ids_num);
+  }
+
  private:
   const phi::GPUContext& dev_ctx_;
   const DenseTensor& input_;
@@ -237,29 +237,6 @@ __global__ void UpdateBetaPowGroup(
   }
 }
 
-template <typename Context>
-static void CopyTensorIfDifferent(const Context& dev_ctx,
-                                  const std::vector<const DenseTensor*>& src,
-                                  const std::vector<DenseTensor*>& dst,
-                                  bool use_src_place = false) {
-  for (size_t i = 0; i < src.size(); ++i) {
-    if (src[i] != dst[i]) {
-      VLOG(10) << "Copy Tensor " << i;
-      phi::Place place = (use_src_place ? src[i]->place() : dev_ctx.GetPlace());
-      phi::Copy<Context>(dev_ctx, *(src[i]), place, false, dst[i]);
-    }
-  }
-}
-
-template <typename T, typename TensorT>
-static int GetVecSizeFromTensors(const std::vector<TensorT*>& tensors,
-                                 int vec_size = 4) {
-  for (const auto* t : tensors) {
-    vec_size = min(vec_size, GetVectorizedSize(t->template data<T>()));
-  }
-  return vec_size;
-}
-
 template <typename T, typename Context>
 void FusedAdamKernel(
     const Context& dev_ctx,
@@ -313,13 +290,14 @@ void FusedAdamKernel(
 
   VLOG(4) << "use_global_beta_pow:" << use_global_beta_pow;
 
-  CopyTensorIfDifferent(dev_ctx, params, params_out);
-  CopyTensorIfDifferent(dev_ctx, moments1, moments1_out);
-  CopyTensorIfDifferent(dev_ctx, moments2, moments2_out);
-  CopyTensorIfDifferent(dev_ctx, beta1_pows, beta1_pows_out, true);
-  CopyTensorIfDifferent(dev_ctx, beta2_pows, beta2_pows_out, true);
+  funcs::CopyTensorIfDifferent(dev_ctx, params, params_out);
+  funcs::CopyTensorIfDifferent(dev_ctx, moments1, moments1_out);
+  funcs::CopyTensorIfDifferent(dev_ctx, moments2, moments2_out);
+  funcs::CopyTensorIfDifferent(dev_ctx, beta1_pows, beta1_pows_out, true);
+  funcs::CopyTensorIfDifferent(dev_ctx, beta2_pows, beta2_pows_out, true);
   if (master_params) {
-    CopyTensorIfDifferent(dev_ctx, master_params.get(), master_params_out);
+    funcs::CopyTensorIfDifferent(
+        dev_ctx, master_params.get(), master_params_out);
   }
 
   bool skip_update_value = false;
@@ -435,11 +413,12 @@ void FusedAdamKernel(
     }                                                        \
   } break
 
-  int vec_size = GetVecSizeFromTensors<T>(params_out);
-  vec_size = GetVecSizeFromTensors<MPDType>(moments1_out, vec_size);
-  vec_size = GetVecSizeFromTensors<MPDType>(moments2_out, vec_size);
+  int vec_size = funcs::GetVecSizeFromTensors<T>(params_out);
+  vec_size = funcs::GetVecSizeFromTensors<MPDType>(moments1_out, vec_size);
+  vec_size = funcs::GetVecSizeFromTensors<MPDType>(moments2_out, vec_size);
   if (master_params) {
-    vec_size = GetVecSizeFromTensors<MPDType>(master_params_out, vec_size);
+    vec_size =
+        funcs::GetVecSizeFromTensors<MPDType>(master_params_out, vec_size);
   }
 
   switch (vec_size) {
@@ -0,0 +1,325 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/fused_clip_by_global_norm_kernel.h"
+
+#include <vector>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#include "paddle/phi/kernels/funcs/multi_tensor_apply.h"
+
+namespace phi {
+
+constexpr int kClipMaxTensorSize = 110;
+constexpr int kClipMaxBlockSize = 320;
+constexpr int kClipBlockSize = 512;
+
+// Accumulates the squared sum of the unscaled grads into square_sum, and sets
+// found_infinite if any of them is nan or inf.
+template <typename T, int VecSize>
+struct SquareSumAndCheckFiniteFunctor {
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      const funcs::TensorAndBlockInfo<2, kClipMaxTensorSize, kClipMaxBlockSize>&
+          t_info,
+      const float* scale,
+      float* square_sum,
+      bool* found_infinite) const {
+    int chunk_id, tensor_id;
+    t_info.GetChunkIdAndTensorId(&chunk_id, &tensor_id);
+    int n = t_info.sizes[tensor_id];
+    int offset = chunk_id * chunk_size;
+    const T* __restrict__ g_ptr =
+        static_cast<const T*>(t_info.grads[tensor_id]) + offset;
+    n -= offset;
+    if (n > chunk_size) {
+      n = chunk_size;
+    }
+
+    float inv_scale = scale ? 1.0f / *scale : 1.0f;
+    float sum = 0.0f;
+    bool finite = true;
+    for (int idx = threadIdx.x * VecSize; idx < n;
+         idx += blockDim.x * VecSize) {
+      phi::AlignedVector<T, VecSize> g_vec;
+      int size = n - idx < VecSize ? n - idx : VecSize;
+      if (size == VecSize) {
+        phi::Load<T, VecSize>(g_ptr + idx, &g_vec);
+      } else {
+#pragma unroll
+        for (int j = 0; j < VecSize; j++) {
+          g_vec[j] = j < size ? g_ptr[idx + j] : T(0);
+        }
+      }
+#pragma unroll
+      for (int j = 0; j < VecSize; j++) {
+        float g = static_cast<float>(g_vec[j]) * inv_scale;
+        finite = finite && isfinite(g);
+        sum += g * g;
+      }
+    }
+
+    sum = phi::funcs::BlockReduceSum<float>(sum, FINAL_MASK);
+    if (threadIdx.x == 0) {
+      phi::CudaAtomicAdd(square_sum, sum);
+    }
+    if (!finite) {
+      *found_infinite = true;
+    }
+  }
+};
+
+// grad = grad / scale * clip_norm / max(global_norm, clip_norm). The grads
+// are only unscaled if found_infinite, as the step would be skipped, and are
+// not written if the factor is 1.
+template <typename T, int VecSize>
+struct UnscaleAndClipFunctor {
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      const funcs::TensorAndBlockInfo<2, kClipMaxTensorSize, kClipMaxBlockSize>&
+          t_info,
+      const float* scale,
+      const float* square_sum,
+      const bool* found_infinite,
+      float clip_norm) const {
+    int chunk_id, tensor_id;
+    t_info.GetChunkIdAndTensorId(&chunk_id, &tensor_id);
+    int n = t_info.sizes[tensor_id];
+    int offset = chunk_id * chunk_size;
+    T* __restrict__ g_ptr =
+        static_cast<T*>(t_info.tensor_addrs[0][tensor_id]) + offset;
+    n -= offset;
+    if (n > chunk_size) {
+      n = chunk_size;
+    }
+
+    float factor = scale ? 1.0f / *scale : 1.0f;
+    if (!*found_infinite) {
+      factor *= clip_norm / fmaxf(sqrtf(*square_sum), clip_norm);
+    }
+    // Nothing to unscale and the norm is within clip_norm.
+    if (factor == 1.0f) {
+      return;
+    }
+    for (int idx = threadIdx.x * VecSize; idx < n;
+         idx += blockDim.x * VecSize) {
+      int size = n - idx < VecSize ? n - idx : VecSize;
+      if (size == VecSize) {
+        phi::AlignedVector<T, VecSize> g_vec;
+        phi::Load<T, VecSize>(g_ptr + idx, &g_vec);
+#pragma unroll
+        for (int j = 0; j < VecSize; j++) {
+          g_vec[j] = static_cast<T>(static_cast<float>(g_vec[j]) * factor);
+        }
+        phi::Store<T, VecSize>(g_vec, g_ptr + idx);
+      } else {
+        for (int j = 0; j < size; j++) {
+          g_ptr[idx + j] =
+              static_cast<T>(static_cast<float>(g_ptr[idx + j]) * factor);
+        }
+      }
+    }
+  }
+};
+
+__global__ void SqrtSquareSumKernel(float* square_sum) {
+  *square_sum = sqrtf(*square_sum);
+}
+
+// The grads of all data types are clipped by the same global norm, so they are
+// grouped by the data types, and the kernels are launched for each group.
+template <typename T, typename Context>
+static void LaunchSquareSumAndCheckFinite(
+    const Context& dev_ctx,
+    const std::vector<DenseTensor*>& grads,
+    int chunk_size,
+    const float* scale,
+    float* square_sum,
+    bool* found_infinite) {
+  if (grads.empty()) return;
+  std::vector<std::vector<DenseTensor*>> input_vector = {grads};
+  std::vector<const DenseTensor*> const_grads(grads.begin(), grads.end());
+  int vec_size = funcs::GetVecSizeFromTensors<T>(grads);
+  switch (vec_size) {
+#define PD_LAUNCH_SQUARE_SUM_AND_CHECK_FINITE(__vec_size)                 \
+  case __vec_size: {                                                      \
+    funcs::LaunchMultiTensorApplyKernel<2,                                \
+                                        kClipMaxTensorSize,               \
+                                        kClipMaxBlockSize>(               \
+        dev_ctx,                                                          \
+        kClipBlockSize,                                                   \
+        ((chunk_size + __vec_size - 1) / __vec_size) * __vec_size,        \
+        input_vector,                                                     \
+        const_grads,                                                      \
+        SquareSumAndCheckFiniteFunctor<T, __vec_size>(),                  \
+        scale,                                                            \
+        square_sum,                                                       \
+        found_infinite);                                                  \
+  } break
+    PD_LAUNCH_SQUARE_SUM_AND_CHECK_FINITE(4);
+    PD_LAUNCH_SQUARE_SUM_AND_CHECK_FINITE(2);
+    PD_LAUNCH_SQUARE_SUM_AND_CHECK_FINITE(1);
+#undef PD_LAUNCH_SQUARE_SUM_AND_CHECK_FINITE
+    default:
+      PADDLE_THROW(
+          errors::InvalidArgument("Unsupported vectorized size %d", vec_size));
+  }
+}
+
+template <typename T, typename Context>
+static void LaunchUnscaleAndClip(const Context& dev_ctx,
+                                 const std::vector<DenseTensor*>& grads,
+                                 int chunk_size,
+                                 const float* scale,
+                                 const float* square_sum,
+                                 const bool* found_infinite,
+                                 float clip_norm) {
+  if (grads.empty()) return;
+  std::vector<std::vector<DenseTensor*>> input_vector = {grads};
+  std::vector<const DenseTensor*> const_grads(grads.begin(), grads.end());
+  int vec_size = funcs::GetVecSizeFromTensors<T>(grads);
+  switch (vec_size) {
+#define PD_LAUNCH_UNSCALE_AND_CLIP(__vec_size)                            \
+  case __vec_size: {                                                      \
+    funcs::LaunchMultiTensorApplyKernel<2,                                \
+                                        kClipMaxTensorSize,               \
+                                        kClipMaxBlockSize>(               \
+        dev_ctx,                                                          \
+        kClipBlockSize,                                                   \
+        ((chunk_size + __vec_size - 1) / __vec_size) * __vec_size,        \
+        input_vector,                                                     \
+        const_grads,                                                      \
+        UnscaleAndClipFunctor<T, __vec_size>(),                           \
+        scale,                                                            \
+        square_sum,                                                       \
+        found_infinite,                                                   \
+        clip_norm);                                                       \
+  } break
+    PD_LAUNCH_UNSCALE_AND_CLIP(4);
+    PD_LAUNCH_UNSCALE_AND_CLIP(2);
+    PD_LAUNCH_UNSCALE_AND_CLIP(1);
+#undef PD_LAUNCH_UNSCALE_AND_CLIP
+    default:
+      PADDLE_THROW(
+          errors::InvalidArgument("Unsupported vectorized size %d", vec_size));
+  }
+}
+
+template <typename T, typename Context>
+void FusedClipByGlobalNormKernel(const Context& dev_ctx,
+                                 const std::vector<const DenseTensor*>& grads,
+                                 const paddle::optional<DenseTensor>& scale,
+                                 float clip_norm,
+                                 int chunk_size,
+                                 std::vector<DenseTensor*> grads_out,
+                                 DenseTensor* found_infinite,
+                                 DenseTensor* global_norm) {
+  funcs::CopyTensorIfDifferent(dev_ctx, grads, grads_out);
+  bool* found_infinite_data = dev_ctx.template Alloc<bool>(found_infinite);
+  float* square_sum = dev_ctx.template Alloc<float>(global_norm);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(found_infinite_data, 0, sizeof(bool), dev_ctx.stream()));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(square_sum, 0, sizeof(float), dev_ctx.stream()));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(found_infinite_data, 0, sizeof(bool), dev_ctx.stream()));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(square_sum, 0, sizeof(float), dev_ctx.stream()));
+#endif
+  const float* scale_data = scale ? scale->data<float>() : nullptr;
+
+  std::vector<DenseTensor*> fp32_grads, fp16_grads, bf16_grads;
+  for (auto* grad : grads_out) {
+    if (grad->numel() == 0) continue;
+    switch (grad->dtype()) {
+      case DataType::FLOAT32:
+        fp32_grads.push_back(grad);
+        break;
+      case DataType::FLOAT16:
+        fp16_grads.push_back(grad);
+        break;
+      case DataType::BFLOAT16:
+        bf16_grads.push_back(grad);
+        break;
+      default:
+        PADDLE_THROW(errors::InvalidArgument(
+            "fused_clip_by_global_norm only support the grads of float32, "
+            "float16 and bfloat16, but got %s.",
+            grad->dtype()));
+    }
+  }
+
+  LaunchSquareSumAndCheckFinite<float>(dev_ctx,
+                                       fp32_grads,
+                                       chunk_size,
+                                       scale_data,
+                                       square_sum,
+                                       found_infinite_data);
+  LaunchSquareSumAndCheckFinite<phi::dtype::float16>(dev_ctx,
+                                                     fp16_grads,
+                                                     chunk_size,
+                                                     scale_data,
+                                                     square_sum,
+                                                     found_infinite_data);
+  LaunchSquareSumAndCheckFinite<phi::dtype::bfloat16>(dev_ctx,
+                                                      bf16_grads,
+                                                      chunk_size,
+                                                      scale_data,
+                                                      square_sum,
+                                                      found_infinite_data);
+
+  LaunchUnscaleAndClip<float>(dev_ctx,
+                              fp32_grads,
+                              chunk_size,
+                              scale_data,
+                              square_sum,
+                              found_infinite_data,
+                              clip_norm);
+  LaunchUnscaleAndClip<phi::dtype::float16>(dev_ctx,
+                                            fp16_grads,
+                                            chunk_size,
+                                            scale_data,
+                                            square_sum,
+                                            found_infinite_data,
+                                            clip_norm);
+  LaunchUnscaleAndClip<phi::dtype::bfloat16>(dev_ctx,
+                                             bf16_grads,
+                                             chunk_size,
+                                             scale_data,
+                                             square_sum,
+                                             found_infinite_data,
+                                             clip_norm);
+
+  SqrtSquareSumKernel<<<1, 1, 0, dev_ctx.stream()>>>(square_sum);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_clip_by_global_norm,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::FusedClipByGlobalNormKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   float) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(1).SetDataType(phi::DataType::BOOL);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+}
@@ -0,0 +1,541 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/fused_lamb_kernel.h"
+
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#include "paddle/phi/kernels/funcs/multi_tensor_apply.h"
+
+namespace phi {
+
+// The beta pows are shared by all the params, and are read from the first
+// ones, as fused_adam does.
+template <typename MT>
+struct FusedLambBetaPowInfo {
+  const MT* beta1_pow_ptr;
+  const MT* beta2_pow_ptr;
+  MT beta1_pow;
+  MT beta2_pow;
+
+  DEVICE MT GetBeta1Pow() const {
+    return beta1_pow_ptr ? *beta1_pow_ptr : beta1_pow;
+  }
+  DEVICE MT GetBeta2Pow() const {
+    return beta2_pow_ptr ? *beta2_pow_ptr : beta2_pow;
+  }
+};
+
+// Updates the moments and writes the trust ratio div, i.e. the update before
+// the trust ratio. The squared norms of each param and its trust ratio div
+// are accumulated into param_sq and div_sq by the tensor ids.
+template <typename T,
+          typename MT,
+          int VecSize,
+          bool IsMultiPrecision,
+          bool NeedNorm,
+          int N,
+          int MaxTensorSize,
+          int MaxBlockSize>
+struct FusedLambMomentFunctor {
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      const funcs::TensorAndBlockInfo<N, MaxTensorSize, MaxBlockSize>& t_info,
+      FusedLambBetaPowInfo<MT> beta_pow,
+      const bool* skip_update,
+      MT beta1,
+      MT beta2,
+      MT epsilon,
+      MT weight_decay,
+      MT* param_sq,
+      MT* div_sq) const {
+    if (skip_update != nullptr && *skip_update) return;
+
+    MT beta1_pow = beta_pow.GetBeta1Pow();
+    MT beta2_pow = beta_pow.GetBeta2Pow();
+    const T* __restrict__ p_ptr;
+    const T* __restrict__ g_ptr;
+    MT* __restrict__ mom1_ptr, * __restrict__ mom2_ptr;
+    MT* __restrict__ div_ptr;
+    const MT* __restrict__ mp_ptr;
+    int n, tensor_id;
+
+    {
+      int chunk_id;
+      t_info.GetChunkIdAndTensorId(&chunk_id, &tensor_id);
+
+      n = t_info.sizes[tensor_id];
+      int offset = chunk_id * chunk_size;
+      g_ptr = static_cast<const T*>(t_info.grads[tensor_id]) + offset;
+      p_ptr = static_cast<const T*>(t_info.tensor_addrs[0][tensor_id]) + offset;
+      mom1_ptr = static_cast<MT*>(t_info.tensor_addrs[1][tensor_id]) + offset;
+      mom2_ptr = static_cast<MT*>(t_info.tensor_addrs[2][tensor_id]) + offset;
+      div_ptr = static_cast<MT*>(t_info.tensor_addrs[3][tensor_id]) + offset;
+      mp_ptr =
+          IsMultiPrecision
+              ? static_cast<MT*>(t_info.tensor_addrs[4][tensor_id]) + offset
+              : nullptr;
+
+      n -= offset;
+      if (n > chunk_size) {
+        n = chunk_size;
+      }
+    }
+
+    MT p_square_sum = static_cast<MT>(0);
+    MT div_square_sum = static_cast<MT>(0);
+    int stride = blockDim.x * VecSize;
+    for (int idx = threadIdx.x * VecSize; idx < n; idx += stride) {
+      phi::AlignedVector<T, VecSize> g_vec;
+      phi::AlignedVector<T, VecSize> p_vec;
+      phi::AlignedVector<MT, VecSize> mp_vec;
+      phi::AlignedVector<MT, VecSize> mom1_vec;
+      phi::AlignedVector<MT, VecSize> mom2_vec;
+      int size = n - idx < VecSize ? n - idx : VecSize;
+      if (size == VecSize) {
+        if (IsMultiPrecision) {
+          phi::Load<MT, VecSize>(mp_ptr + idx, &mp_vec);
+        } else {
+          phi::Load<T, VecSize>(p_ptr + idx, &p_vec);
+        }
+        phi::Load<T, VecSize>(g_ptr + idx, &g_vec);
+        phi::Load<MT, VecSize>(mom1_ptr + idx, &mom1_vec);
+        phi::Load<MT, VecSize>(mom2_ptr + idx, &mom2_vec);
+      } else {
+#pragma unroll
+        for (int j = 0; j < VecSize; j++) {
+          bool valid = j < size;
+          if (IsMultiPrecision) {
+            mp_vec[j] = valid ? mp_ptr[idx + j] : MT(0);
+          } else {
+            p_vec[j] = valid ? p_ptr[idx + j] : T(0);
+          }
+          g_vec[j] = valid ? g_ptr[idx + j] : T(0);
+          mom1_vec[j] = valid ? mom1_ptr[idx + j] : MT(0);
+          mom2_vec[j] = valid ? mom2_ptr[idx + j] : MT(0);
+        }
+      }
+
+      phi::AlignedVector<MT, VecSize> div_vec;
+#pragma unroll
+      for (int j = 0; j < VecSize; j++) {
+        MT p = IsMultiPrecision ? mp_vec[j] : static_cast<MT>(p_vec[j]);
+        MT g = static_cast<MT>(g_vec[j]);
+        MT mom1 = beta1 * mom1_vec[j] + (static_cast<MT>(1) - beta1) * g;
+        MT mom2 = beta2 * mom2_vec[j] + (static_cast<MT>(1) - beta2) * g * g;
+        mom1_vec[j] = mom1;
+        mom2_vec[j] = mom2;
+        MT mom1_unbiased = mom1 / (static_cast<MT>(1) - beta1_pow);
+        MT mom2_unbiased = mom2 / (static_cast<MT>(1) - beta2_pow);
+        MT div = mom1_unbiased / (sqrt(mom2_unbiased) + epsilon) +
+                 weight_decay * p;
+        // The padding of the tail is zero, so it adds nothing to the norms.
+        div_vec[j] = j < size ? div : static_cast<MT>(0);
+        if (NeedNorm) {
+          p_square_sum += p * p;
+          div_square_sum += div_vec[j] * div_vec[j];
+        }
+      }
+
+      if (size == VecSize) {
+        phi::Store<MT, VecSize>(mom1_vec, mom1_ptr + idx);
+        phi::Store<MT, VecSize>(mom2_vec, mom2_ptr + idx);
+        phi::Store<MT, VecSize>(div_vec, div_ptr + idx);
+      } else {
+        for (int j = 0; j < size; j++) {
+          mom1_ptr[idx + j] = mom1_vec[j];
+          mom2_ptr[idx + j] = mom2_vec[j];
+          div_ptr[idx + j] = div_vec[j];
+        }
+      }
+    }
+
+    if (NeedNorm) {
+      p_square_sum = phi::funcs::BlockReduceSum<MT>(p_square_sum, FINAL_MASK);
+      div_square_sum =
+          phi::funcs::BlockReduceSum<MT>(div_square_sum, FINAL_MASK);
+      if (threadIdx.x == 0) {
+        int global_id = t_info.GetGlobalTensorId(tensor_id);
+        phi::CudaAtomicAdd(param_sq + global_id, p_square_sum);
+        phi::CudaAtomicAdd(div_sq + global_id, div_square_sum);
+      }
+    }
+  }
+};
+
+// Applies the trust ratio div with the trust ratio of each tensor.
+template <typename T,
+          typename MT,
+          bool IsMultiPrecision,
+          bool NeedNorm,
+          int N,
+          int MaxTensorSize,
+          int MaxBlockSize>
+struct FusedLambParamFunctor {
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      const funcs::TensorAndBlockInfo<N, MaxTensorSize, MaxBlockSize>& t_info,
+      const MT* learning_rate,
+      const bool* skip_update,
+      const MT* param_sq,
+      const MT* div_sq) const {
+    if (skip_update != nullptr && *skip_update) return;
+
+    int chunk_id, tensor_id;
+    t_info.GetChunkIdAndTensorId(&chunk_id, &tensor_id);
+    int n = t_info.sizes[tensor_id];
+    int offset = chunk_id * chunk_size;
+    const MT* __restrict__ div_ptr =
+        static_cast<const MT*>(t_info.grads[tensor_id]) + offset;
+    T* __restrict__ p_ptr =
+        static_cast<T*>(t_info.tensor_addrs[0][tensor_id]) + offset;
+    MT* __restrict__ mp_ptr =
+        IsMultiPrecision
+            ? static_cast<MT*>(t_info.tensor_addrs[1][tensor_id]) + offset
+            : nullptr;
+    n -= offset;
+    if (n > chunk_size) {
+      n = chunk_size;
+    }
+
+    MT lr = *learning_rate;
+    if (NeedNorm) {
+      int global_id = t_info.GetGlobalTensorId(tensor_id);
+      MT pn = sqrt(param_sq[global_id]);
+      MT tn = sqrt(div_sq[global_id]);
+      lr *= (pn > static_cast<MT>(0) && tn > static_cast<MT>(0))
+                ? pn / tn
+                : static_cast<MT>(1);
+    }
+
+    for (int i = threadIdx.x; i < n; i += blockDim.x) {
+      MT p = IsMultiPrecision ? mp_ptr[i] : static_cast<MT>(p_ptr[i]);
+      p -= lr * div_ptr[i];
+      p_ptr[i] = static_cast<T>(p);
+      if (IsMultiPrecision) {
+        mp_ptr[i] = p;
+      }
+    }
+  }
+};
+
+template <typename MT>
+__global__ void FusedLambUpdateBetaPows(const bool* skip_update,
+                                        MT** beta1_pows,
+                                        MT** beta2_pows,
+                                        MT beta1,
+                                        MT beta2,
+                                        int n) {
+  if (skip_update != nullptr && *skip_update) return;
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < n;
+       i += blockDim.x * gridDim.x) {
+    *beta1_pows[i] *= beta1;
+    *beta2_pows[i] *= beta2;
+  }
+}
+
+template <typename T, typename Context>
+void FusedLambKernel(
+    const Context& dev_ctx,
+    const std::vector<const DenseTensor*>& params,
+    const std::vector<const DenseTensor*>& grads,
+    const DenseTensor& learning_rate,
+    const std::vector<const DenseTensor*>& moments1,
+    const std::vector<const DenseTensor*>& moments2,
+    const std::vector<const DenseTensor*>& beta1_pows,
+    const std::vector<const DenseTensor*>& beta2_pows,
+    const paddle::optional<std::vector<const DenseTensor*>>& master_params,
+    const paddle::optional<DenseTensor>& skip_update,
+    float weight_decay,
+    float beta1,
+    float beta2,
+    float epsilon,
+    bool always_adapt,
+    bool multi_precision,
+    int chunk_size,
+    std::vector<DenseTensor*> params_out,
+    std::vector<DenseTensor*> moments1_out,
+    std::vector<DenseTensor*> moments2_out,
+    std::vector<DenseTensor*> beta1_pows_out,
+    std::vector<DenseTensor*> beta2_pows_out,
+    std::vector<DenseTensor*> master_params_out) {
+  using MPDType = typename phi::dtype::MPTypeTrait<T>::Type;
+
+  PADDLE_ENFORCE_EQ(
+      !multi_precision || master_params,
+      true,
+      errors::InvalidArgument(
+          "Input(MasterParams) is required when multi_precision is true."));
+  const size_t n = params.size();
+  bool is_cpu_betapow =
+      n > 0 && beta1_pows[0]->place().GetType() == AllocationType::CPU;
+  for (size_t i = 0; i < n; ++i) {
+    PADDLE_ENFORCE_EQ(
+        beta1_pows[i]->place().GetType() == AllocationType::CPU &&
+            beta2_pows[i]->place().GetType() == AllocationType::CPU,
+        is_cpu_betapow,
+        errors::InvalidArgument(
+            "All Beta1Pows and Beta2Pows must be in the same place."));
+  }
+
+  funcs::CopyTensorIfDifferent(dev_ctx, params, params_out);
+  funcs::CopyTensorIfDifferent(dev_ctx, moments1, moments1_out);
+  funcs::CopyTensorIfDifferent(dev_ctx, moments2, moments2_out);
+  funcs::CopyTensorIfDifferent(dev_ctx, beta1_pows, beta1_pows_out, true);
+  funcs::CopyTensorIfDifferent(dev_ctx, beta2_pows, beta2_pows_out, true);
+  if (master_params) {
+    funcs::CopyTensorIfDifferent(
+        dev_ctx, master_params.get(), master_params_out);
+  }
+  if (n == 0) return;
+
+  bool skip_on_host = false;
+  const bool* skip_update_ptr =
+      funcs::GetSkipUpdatePtr(skip_update, &skip_on_host);
+  // The beta pows on the host could only be skipped by the host.
+  if (skip_update_ptr != nullptr && is_cpu_betapow) {
+    DenseTensor skip_update_tensor;
+    phi::Copy(
+        dev_ctx, skip_update.get(), CPUPlace(), true, &skip_update_tensor);
+    skip_on_host = skip_update_tensor.data<bool>()[0];
+    skip_update_ptr = nullptr;
+  }
+  if (skip_on_host) {
+    VLOG(4) << "Lamb skip update";
+    return;
+  }
+
+  FusedLambBetaPowInfo<MPDType> beta_pow_info;
+  if (is_cpu_betapow) {
+    beta_pow_info.beta1_pow_ptr = nullptr;
+    beta_pow_info.beta2_pow_ptr = nullptr;
+    beta_pow_info.beta1_pow = beta1_pows_out[0]->data<MPDType>()[0];
+    beta_pow_info.beta2_pow = beta2_pows_out[0]->data<MPDType>()[0];
+  } else {
+    beta_pow_info.beta1_pow_ptr = beta1_pows_out[0]->data<MPDType>();
+    beta_pow_info.beta2_pow_ptr = beta2_pows_out[0]->data<MPDType>();
+  }
+
+  // The trust ratio divs and the squared norms of all the params are kept
+  // between the two passes.
+  std::vector<DenseTensor> divs(n);
+  std::vector<DenseTensor*> div_ptrs(n);
+  for (size_t i = 0; i < n; ++i) {
+    divs[i].Resize(params[i]->dims());
+    dev_ctx.template Alloc<MPDType>(&divs[i]);
+    div_ptrs[i] = &divs[i];
+  }
+  const bool need_norm = weight_decay > 0.0f || always_adapt;
+  DenseTensor square_sums;
+  MPDType* param_sq = nullptr;
+  MPDType* div_sq = nullptr;
+  if (need_norm) {
+    square_sums.Resize({static_cast<int64_t>(2 * n)});
+    param_sq = dev_ctx.template Alloc<MPDType>(&square_sums);
+    div_sq = param_sq + n;
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipMemsetAsync(
+        param_sq, 0, 2 * n * sizeof(MPDType), dev_ctx.stream()));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(
+        param_sq, 0, 2 * n * sizeof(MPDType), dev_ctx.stream()));
+#endif
+  }
+
+  std::vector<std::vector<DenseTensor*>> moment_inputs;
+  moment_inputs.push_back(params_out);
+  moment_inputs.push_back(moments1_out);
+  moment_inputs.push_back(moments2_out);
+  moment_inputs.push_back(div_ptrs);
+  if (multi_precision) {
+    moment_inputs.push_back(master_params_out);
+  }
+  std::vector<const DenseTensor*> const_div_ptrs(div_ptrs.begin(),
+                                                 div_ptrs.end());
+  std::vector<std::vector<DenseTensor*>> param_inputs;
+  param_inputs.push_back(params_out);
+  if (multi_precision) {
+    param_inputs.push_back(master_params_out);
+  }
+
+  constexpr int kBlockSize = 512;
+  constexpr int kMaxBlockSize = 320;
+
+#define PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL_BASE(                        \
+    __multi_precision, __need_norm, __vec_size)                               \
+  do {                                                                        \
+    constexpr int kMomentInputNum = __multi_precision ? 6 : 5;                \
+    constexpr int kMomentMaxTensorSize = __multi_precision ? 36 : 48;         \
+    FusedLambMomentFunctor<T,                                                 \
+                           MPDType,                                           \
+                           __vec_size,                                        \
+                           __multi_precision,                                 \
+                           __need_norm,                                       \
+                           kMomentInputNum,                                   \
+                           kMomentMaxTensorSize,                              \
+                           kMaxBlockSize>                                     \
+        moment_functor;                                                       \
+    int aligned_chunk_size =                                                  \
+        ((chunk_size + __vec_size - 1) / __vec_size) * __vec_size;            \
+    funcs::LaunchMultiTensorApplyKernel<kMomentInputNum,                      \
+                                        kMomentMaxTensorSize,                 \
+                                        kMaxBlockSize>(                       \
+        dev_ctx,                                                              \
+        kBlockSize,                                                           \
+        aligned_chunk_size,                                                   \
+        moment_inputs,                                                        \
+        grads,                                                                \
+        moment_functor,                                                       \
+        beta_pow_info,                                                        \
+        skip_update_ptr,                                                      \
+        static_cast<MPDType>(beta1),                                          \
+        static_cast<MPDType>(beta2),                                          \
+        static_cast<MPDType>(epsilon),                                        \
+        static_cast<MPDType>(weight_decay),                                   \
+        param_sq,                                                             \
+        div_sq);                                                              \
+    constexpr int kParamInputNum = __multi_precision ? 3 : 2;                 \
+    constexpr int kParamMaxTensorSize = __multi_precision ? 96 : 110;         \
+    FusedLambParamFunctor<T,                                                  \
+                          MPDType,                                            \
+                          __multi_precision,                                  \
+                          __need_norm,                                        \
+                          kParamInputNum,                                     \
+                          kParamMaxTensorSize,                                \
+                          kMaxBlockSize>                                      \
+        param_functor;                                                        \
+    funcs::LaunchMultiTensorApplyKernel<kParamInputNum,                       \
+                                        kParamMaxTensorSize,                  \
+                                        kMaxBlockSize>(                       \
+        dev_ctx,                                                              \
+        kBlockSize,                                                           \
+        aligned_chunk_size,                                                   \
+        param_inputs,                                                         \
+        const_div_ptrs,                                                       \
+        param_functor,                                                        \
+        learning_rate.data<MPDType>(),                                        \
+        skip_update_ptr,                                                      \
+        param_sq,                                                             \
+        div_sq);                                                              \
+  } while (0)
+
+#define PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL(__vec_size)                 \
+  case __vec_size: {                                                         \
+    if (multi_precision) {                                                   \
+      if (need_norm) {                                                       \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL_BASE(                       \
+            true, true, __vec_size);                                         \
+      } else {                                                               \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL_BASE(                       \
+            true, false, __vec_size);                                        \
+      }                                                                      \
+    } else {                                                                 \
+      if (need_norm) {                                                       \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL_BASE(                       \
+            false, true, __vec_size);                                        \
+      } else {                                                               \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL_BASE(                       \
+            false, false, __vec_size);                                       \
+      }                                                                      \
+    }                                                                        \
+  } break
+
+  int vec_size = funcs::GetVecSizeFromTensors<T>(params_out);
+  vec_size = funcs::GetVecSizeFromTensors<T>(grads, vec_size);
+  vec_size = funcs::GetVecSizeFromTensors<MPDType>(moments1_out, vec_size);
+  vec_size = funcs::GetVecSizeFromTensors<MPDType>(moments2_out, vec_size);
+  if (multi_precision) {
+    vec_size =
+        funcs::GetVecSizeFromTensors<MPDType>(master_params_out, vec_size);
+  }
+
+  switch (vec_size) {
+    PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL(4);
+    PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL(2);
+    PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL(1);
+    default:
+      PADDLE_THROW(
+          errors::InvalidArgument("Unsupported vectorized size %d", vec_size));
+      break;
+  }
+#undef PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL
+#undef PD_LAUNCH_MULTI_TENSOR_APPLY_LAMB_KERNEL_BASE
+
+  if (is_cpu_betapow) {
+    for (size_t i = 0; i < n; i++) {
+      auto* beta1_ptr = dev_ctx.template HostAlloc<MPDType>(beta1_pows_out[i]);
+      (*beta1_ptr) *= static_cast<MPDType>(beta1);
+      auto* beta2_ptr = dev_ctx.template HostAlloc<MPDType>(beta2_pows_out[i]);
+      (*beta2_ptr) *= static_cast<MPDType>(beta2);
+    }
+  } else {
+    // The pointers of all the beta pows are passed in one launch.
+    std::vector<MPDType*> beta_pow_ptrs(2 * n);
+    for (size_t i = 0; i < n; ++i) {
+      beta_pow_ptrs[i] = dev_ctx.template Alloc<MPDType>(beta1_pows_out[i]);
+      beta_pow_ptrs[n + i] =
+          dev_ctx.template Alloc<MPDType>(beta2_pows_out[i]);
+    }
+    DenseTensor beta_pow_ptrs_tensor;
+    beta_pow_ptrs_tensor.Resize(
+        {static_cast<int64_t>(2 * n * sizeof(MPDType*))});
+    auto* beta_pow_ptrs_data =
+        dev_ctx.template Alloc<uint8_t>(&beta_pow_ptrs_tensor);
+    memory_utils::Copy(dev_ctx.GetPlace(),
+                       beta_pow_ptrs_data,
+                       CPUPlace(),
+                       beta_pow_ptrs.data(),
+                       2 * n * sizeof(MPDType*),
+                       dev_ctx.stream());
+    auto** beta_pow_ptrs_gpu = reinterpret_cast<MPDType**>(beta_pow_ptrs_data);
+    constexpr int kThreads = 256;
+    int blocks = std::min<int>((n + kThreads - 1) / kThreads, 64);
+    FusedLambUpdateBetaPows<MPDType>
+        <<<blocks, kThreads, 0, dev_ctx.stream()>>>(skip_update_ptr,
+                                                    beta_pow_ptrs_gpu,
+                                                    beta_pow_ptrs_gpu + n,
+                                                    static_cast<MPDType>(beta1),
+                                                    static_cast<MPDType>(beta2),
+                                                    n);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_lamb,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::FusedLambKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   float,
+                   double) {
+  // Skip beta1_pow, beta2_pow, skip_update data transform
+  kernel->InputAt(5).SetBackend(phi::Backend::ALL_BACKEND);
+  kernel->InputAt(6).SetBackend(phi::Backend::ALL_BACKEND);
+  kernel->InputAt(8).SetBackend(phi::Backend::ALL_BACKEND);
+  kernel->OutputAt(1).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(2).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(3).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(4).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(5).SetDataType(phi::DataType::UNDEFINED);
+}
@@ -0,0 +1,304 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/fused_momentum_kernel.h"
+
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/phi/kernels/funcs/multi_tensor_apply.h"
+
+namespace phi {
+
+// The velocity is in MT with the master params, or in T as merged_momentum.
+template <typename T,
+          typename MT,
+          int VecSize,
+          bool IsMultiPrecision,
+          bool UseNesterov,
+          bool UseL2Decay,
+          int N,
+          int MaxTensorSize,
+          int MaxBlockSize>
+struct FusedMomentumFunctor {
+  using VT = std::conditional_t<IsMultiPrecision, MT, T>;
+
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      const funcs::TensorAndBlockInfo<N, MaxTensorSize, MaxBlockSize>& t_info,
+      const MT* learning_rate,
+      const bool* skip_update,
+      MT mu,
+      MT regularization_coeff,
+      MT rescale_grad) const {
+    if (skip_update != nullptr && *skip_update) return;
+
+    MT lr = *learning_rate;
+    T* __restrict__ p_ptr;
+    const T* __restrict__ g_ptr;
+    VT* __restrict__ v_ptr;
+    MT* __restrict__ mp_ptr;
+    int n;
+
+    {
+      int chunk_id, tensor_id;
+      t_info.GetChunkIdAndTensorId(&chunk_id, &tensor_id);
+
+      n = t_info.sizes[tensor_id];
+      int offset = chunk_id * chunk_size;
+      g_ptr = static_cast<const T*>(t_info.grads[tensor_id]) + offset;
+      p_ptr = static_cast<T*>(t_info.tensor_addrs[0][tensor_id]) + offset;
+      v_ptr = static_cast<VT*>(t_info.tensor_addrs[1][tensor_id]) + offset;
+      mp_ptr =
+          IsMultiPrecision
+              ? static_cast<MT*>(t_info.tensor_addrs[2][tensor_id]) + offset
+              : nullptr;
+
+      n -= offset;
+      if (n > chunk_size) {
+        n = chunk_size;
+      }
+    }
+
+    int stride = blockDim.x * VecSize;
+    int idx = threadIdx.x * VecSize;
+
+    for (; idx < n; idx += stride) {
+      phi::AlignedVector<T, VecSize> g_vec;
+      phi::AlignedVector<T, VecSize> p_vec;
+      phi::AlignedVector<MT, VecSize> mp_vec;
+      phi::AlignedVector<VT, VecSize> v_vec;
+      int size = n - idx < VecSize ? n - idx : VecSize;
+      if (size == VecSize) {
+        if (IsMultiPrecision) {
+          phi::Load<MT, VecSize>(mp_ptr + idx, &mp_vec);
+        } else {
+          phi::Load<T, VecSize>(p_ptr + idx, &p_vec);
+        }
+        phi::Load<T, VecSize>(g_ptr + idx, &g_vec);
+        phi::Load<VT, VecSize>(v_ptr + idx, &v_vec);
+      } else {
+        for (int j = 0; j < size; j++) {
+          if (IsMultiPrecision) {
+            mp_vec[j] = mp_ptr[idx + j];
+          } else {
+            p_vec[j] = p_ptr[idx + j];
+          }
+          g_vec[j] = g_ptr[idx + j];
+          v_vec[j] = v_ptr[idx + j];
+        }
+      }
+
+#pragma unroll
+      for (int j = 0; j < VecSize; j++) {
+        MT p = IsMultiPrecision ? mp_vec[j] : static_cast<MT>(p_vec[j]);
+        MT g = static_cast<MT>(g_vec[j]) * rescale_grad;
+        if (UseL2Decay) {
+          g += regularization_coeff * p;
+        }
+        MT v = static_cast<MT>(v_vec[j]) * mu + g;
+        p -= UseNesterov ? (g + v * mu) * lr : v * lr;
+        v_vec[j] = static_cast<VT>(v);
+        mp_vec[j] = p;
+      }
+
+      if (size == VecSize) {
+        phi::Store<VT, VecSize>(v_vec, v_ptr + idx);
+        if (IsMultiPrecision) {
+          phi::Store<MT, VecSize>(mp_vec, mp_ptr + idx);
+        }
+        for (int j = 0; j < VecSize; j++) {
+          p_ptr[idx + j] = static_cast<T>(mp_vec[j]);
+        }
+      } else {
+        for (int j = 0; j < size; j++) {
+          if (IsMultiPrecision) {
+            mp_ptr[idx + j] = mp_vec[j];
+          }
+          p_ptr[idx + j] = static_cast<T>(mp_vec[j]);
+          v_ptr[idx + j] = v_vec[j];
+        }
+      }
+    }
+  }
+};
+
+template <typename T, typename Context>
+void FusedMomentumKernel(
+    const Context& dev_ctx,
+    const std::vector<const DenseTensor*>& params,
+    const std::vector<const DenseTensor*>& grads,
+    const std::vector<const DenseTensor*>& velocitys,
+    const DenseTensor& learning_rate,
+    const paddle::optional<std::vector<const DenseTensor*>>& master_params,
+    const paddle::optional<DenseTensor>& skip_update,
+    float mu,
+    bool use_nesterov,
+    const std::string& regularization_method,
+    float regularization_coeff,
+    bool multi_precision,
+    float rescale_grad,
+    int chunk_size,
+    std::vector<DenseTensor*> params_out,
+    std::vector<DenseTensor*> velocitys_out,
+    std::vector<DenseTensor*> master_params_out) {
+  using MPDType = typename phi::dtype::MPTypeTrait<T>::Type;
+
+  PADDLE_ENFORCE_EQ(
+      regularization_method == "" || regularization_method == "l2_decay",
+      true,
+      errors::InvalidArgument("fused_momentum only support the "
+                              "regularization_method of l2_decay or empty, "
+                              "but got %s.",
+                              regularization_method));
+  PADDLE_ENFORCE_EQ(
+      !multi_precision || master_params,
+      true,
+      errors::InvalidArgument(
+          "Input(MasterParams) is required when multi_precision is true."));
+
+  funcs::CopyTensorIfDifferent(dev_ctx, params, params_out);
+  funcs::CopyTensorIfDifferent(dev_ctx, velocitys, velocitys_out);
+  if (master_params) {
+    funcs::CopyTensorIfDifferent(
+        dev_ctx, master_params.get(), master_params_out);
+  }
+  if (params.empty()) return;
+
+  bool skip_on_host = false;
+  const bool* skip_update_ptr =
+      funcs::GetSkipUpdatePtr(skip_update, &skip_on_host);
+  if (skip_on_host) {
+    VLOG(4) << "Momentum skip update";
+    return;
+  }
+
+  std::vector<std::vector<DenseTensor*>> input_vector;
+  input_vector.reserve(3);
+  input_vector.push_back(params_out);
+  input_vector.push_back(velocitys_out);
+  if (multi_precision) {
+    input_vector.push_back(master_params_out);
+  }
+  bool use_l2_decay = regularization_method == "l2_decay";
+
+#define PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_BASE(                 \
+    __multi_precision, __use_nesterov, __use_l2_decay, __vec_size)         \
+  do {                                                                     \
+    constexpr int kInputNum = __multi_precision ? 4 : 3;                   \
+    constexpr int kMaxTensorSize = __multi_precision ? 60 : 80;            \
+    constexpr int kMaxBlockSize = 320;                                     \
+    constexpr int kBlockSize = 512;                                        \
+    FusedMomentumFunctor<T,                                                \
+                         MPDType,                                          \
+                         __vec_size,                                       \
+                         __multi_precision,                                \
+                         __use_nesterov,                                   \
+                         __use_l2_decay,                                   \
+                         kInputNum,                                        \
+                         kMaxTensorSize,                                   \
+                         kMaxBlockSize>                                    \
+        functor;                                                           \
+    funcs::LaunchMultiTensorApplyKernel<kInputNum,                         \
+                                        kMaxTensorSize,                    \
+                                        kMaxBlockSize>(                    \
+        dev_ctx,                                                           \
+        kBlockSize,                                                        \
+        ((chunk_size + __vec_size - 1) / __vec_size) * __vec_size,         \
+        input_vector,                                                      \
+        grads,                                                             \
+        functor,                                                           \
+        learning_rate.data<MPDType>(),                                     \
+        skip_update_ptr,                                                   \
+        static_cast<MPDType>(mu),                                          \
+        static_cast<MPDType>(regularization_coeff),                        \
+        static_cast<MPDType>(rescale_grad));                               \
+  } while (0)
+
+#define PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_L2(                 \
+    __multi_precision, __use_nesterov, __vec_size)                       \
+  do {                                                                   \
+    if (use_l2_decay) {                                                  \
+      PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_BASE(                 \
+          __multi_precision, __use_nesterov, true, __vec_size);          \
+    } else {                                                             \
+      PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_BASE(                 \
+          __multi_precision, __use_nesterov, false, __vec_size);         \
+    }                                                                    \
+  } while (0)
+
+#define PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL(__vec_size)           \
+  case __vec_size: {                                                       \
+    if (multi_precision) {                                                 \
+      if (use_nesterov) {                                                  \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_L2(                   \
+            true, true, __vec_size);                                       \
+      } else {                                                             \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_L2(                   \
+            true, false, __vec_size);                                      \
+      }                                                                    \
+    } else {                                                               \
+      if (use_nesterov) {                                                  \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_L2(                   \
+            false, true, __vec_size);                                      \
+      } else {                                                             \
+        PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_L2(                   \
+            false, false, __vec_size);                                     \
+      }                                                                    \
+    }                                                                      \
+  } break
+
+  int vec_size = funcs::GetVecSizeFromTensors<T>(params_out);
+  if (multi_precision) {
+    vec_size = funcs::GetVecSizeFromTensors<MPDType>(velocitys_out, vec_size);
+    vec_size =
+        funcs::GetVecSizeFromTensors<MPDType>(master_params_out, vec_size);
+  } else {
+    vec_size = funcs::GetVecSizeFromTensors<T>(velocitys_out, vec_size);
+  }
+  vec_size = funcs::GetVecSizeFromTensors<T>(grads, vec_size);
+
+  switch (vec_size) {
+    PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL(4);
+    PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL(2);
+    PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL(1);
+    default:
+      PADDLE_THROW(
+          errors::InvalidArgument("Unsupported vectorized size %d", vec_size));
+      break;
+  }
+#undef PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL
+#undef PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_L2
+#undef PD_LAUNCH_MULTI_TENSOR_APPLY_MOMENTUM_KERNEL_BASE
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_momentum,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::FusedMomentumKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   float,
+                   double) {
+  // Skip skip_update data transform
+  kernel->InputAt(5).SetBackend(phi::Backend::ALL_BACKEND);
+  kernel->OutputAt(1).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(2).SetDataType(phi::DataType::UNDEFINED);
+}
@@ -86,12 +86,11 @@ struct SequenceSoftmaxGradFunctor<phi::GPUContext, T> {
     dim3 block_size(thread_x);
     dim3 grid_size(max_blocks);
 
-    phi::MixVector<size_t> mixv_ref_lod(&ref_lod);
     sequence_softmax_grad_kernel<T, kThreadsPerBlock>
         <<<grid_size, block_size, 0, context.stream()>>>(
             dout.data<T>(),
             out.data<T>(),
-            mixv_ref_lod.CUDAData(context.GetPlace()),
+            phi::CachedCUDAOffsets(ref_lod, context),
             height,
             context.Alloc<T>(dx));
   }
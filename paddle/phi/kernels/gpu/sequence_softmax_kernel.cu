@@ -97,11 +97,10 @@ struct SequenceSoftmaxFunctor<phi::GPUContext, T> {
 
     dim3 block_size(thread_x);
     dim3 grid_size(max_blocks);
-    phi::MixVector<size_t> mixv_ref_lod(&ref_lod);
     sequence_softmax_kernel<T, kThreadsPerBlock>
         <<<grid_size, block_size, 0, context.stream()>>>(
             x.data<T>(),
-            mixv_ref_lod.CUDAData(context.GetPlace()),
+            phi::CachedCUDAOffsets(ref_lod, context),
             height,
             context.Alloc<T>(out));
   }
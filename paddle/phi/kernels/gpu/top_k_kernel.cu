@@ -16,14 +16,16 @@
 
 #include "glog/logging.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
-#include "paddle/phi/kernels/funcs/gather.cu.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/top_k_function_cuda.h"
 
+COMMON_DECLARE_int32(topk_radix_select);
+
 namespace phi {
 
 #define FIXED_BLOCK_DIM_BASE(dim, ...) \
@@ -126,10 +128,21 @@ void TopkKernel(const Context& dev_ctx,
     }
 
 #if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 9000
-    if (input_width >= 1024 && in_dims.size() == 1) {
+    const bool radix_select = phi::funcs::UseRadixSelectTopK(
+        dev_ctx, input_height, input_width, k, FLAGS_topk_radix_select);
+    if (radix_select || (input_width >= 1024 && in_dims.size() == 1)) {
       // 1. Gather TopK, but without sorting
       constexpr int max_num_threads = 1024;
-      if (largest) {
+      if (radix_select) {
+        phi::funcs::RadixSelectTopK<T>(dev_ctx,
+                                       input_data,
+                                       input_height,
+                                       input_width,
+                                       k,
+                                       largest,
+                                       output_data,
+                                       indices_data);
+      } else if (largest) {
         phi::funcs::RadixTopK<T, true>
             <<<input_height, max_num_threads, 0, dev_ctx.stream()>>>(
                 input_data,
@@ -168,8 +181,18 @@ void TopkKernel(const Context& dev_ctx,
                                     &sorted_output,
                                     &sorted_indices,
                                     largest)) {
-          funcs::GPUGather<int64_t, int64_t>(
-              dev_ctx, *indices, sorted_indices, &gather_indices);
+          // The sorted indices are the positions in each row of the top k.
+          auto config = phi::backends::gpu::GetGpuLaunchConfig1D(
+              dev_ctx, input_height * k);
+          phi::funcs::GatherSortedTopKIndices<<<config.block_per_grid,
+                                                config.thread_per_block,
+                                                0,
+                                                dev_ctx.stream()>>>(
+              indices_data,
+              sorted_indices.data<int64_t>(),
+              input_height,
+              k,
+              gather_indices.data<int64_t>());
           Copy(dev_ctx, gather_indices, indices->place(), false, indices);
           Copy(dev_ctx, sorted_output, out->place(), false, out);
           return;
@@ -15,6 +15,7 @@
 #include "paddle/phi/kernels/unique_kernel.h"
 
 #include <thrust/adjacent_difference.h>
+#include <thrust/copy.h>
 #include <thrust/device_vector.h>
 #include <thrust/execution_policy.h>
 #include <thrust/functional.h>
@@ -33,6 +34,8 @@
 namespace cub = hipcub;
 #endif
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
@@ -510,6 +513,273 @@ static void UniqueDimsCUDATensor(const Context& context,
   }
 }
 
+// The hash based unique for is_sorted == false, which outputs the unique
+// elements in the order of their first occurrence like the CPU kernel. The
+// elements are inserted into an open addressing hash table with linear probing
+// as the GPU hash table of heter_ps does, whose slots hold the position of the
+// first occurrence of an element, so that only the unique elements are sorted
+// (by their positions) instead of the whole input.
+template <typename InT>
+__device__ __forceinline__
+    typename std::enable_if<std::is_integral<InT>::value, uint64_t>::type
+    UniqueHashBits(InT value) {
+  return static_cast<uint64_t>(value);
+}
+
+template <typename InT>
+__device__ __forceinline__
+    typename std::enable_if<!std::is_integral<InT>::value, uint64_t>::type
+    UniqueHashBits(InT value) {
+  using MT = typename phi::dtype::MPTypeTrait<InT>::Type;
+  double x = static_cast<double>(static_cast<MT>(value));
+  // -0.0 == 0.0, so they should have the same hash
+  if (x == 0) {
+    x = 0;
+  }
+  return static_cast<uint64_t>(__double_as_longlong(x));
+}
+
+// The finalizer of MurmurHash3
+template <typename InT>
+__device__ __forceinline__ uint64_t UniqueHash(InT value) {
+  uint64_t h = UniqueHashBits<InT>(value);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// SlotT is an unsigned type of the size of IndexT which the atomics support.
+template <typename IndexT>
+using UniqueHashSlotT =
+    typename std::conditional<sizeof(IndexT) == 4,
+                              unsigned int,
+                              unsigned long long>::type;  // NOLINT
+
+template <typename SlotT>
+struct UniqueHashSlotNotEmpty {
+  __device__ bool operator()(SlotT slot) const {
+    return slot != static_cast<SlotT>(-1);
+  }
+};
+
+// Inserts in[i] into the table, the slot keeps the min position of the equal
+// elements, and slot_of[i] is the slot of in[i].
+template <typename InT, typename SlotT>
+__global__ void UniqueHashInsertKernel(const InT* in,
+                                       int64_t num_input,
+                                       SlotT* table,
+                                       int64_t capacity_mask,
+                                       SlotT* slot_of) {
+  constexpr SlotT kEmpty = static_cast<SlotT>(-1);
+  CUDA_KERNEL_LOOP_TYPE(i, num_input, int64_t) {
+    const InT value = in[i];
+    const SlotT pos = static_cast<SlotT>(i);
+    int64_t slot = static_cast<int64_t>(UniqueHash<InT>(value) & capacity_mask);
+    while (true) {
+      SlotT owner = table[slot];
+      if (owner == kEmpty) {
+        owner = atomicCAS(table + slot, kEmpty, pos);
+        if (owner == kEmpty) {
+          break;
+        }
+      }
+      // all the positions held by a slot have the same element
+      if (in[owner] == value) {
+        atomicMin(table + slot, pos);
+        break;
+      }
+      slot = (slot + 1) & capacity_mask;
+    }
+    slot_of[i] = static_cast<SlotT>(slot);
+  }
+}
+
+// Writes the j-th unique element, whose first position is firsts[j], and
+// replaces its slot by j.
+template <typename InT, typename IndexT, typename SlotT>
+__global__ void UniqueHashGatherKernel(const InT* in,
+                                       const SlotT* firsts,
+                                       int64_t num_out,
+                                       const SlotT* slot_of,
+                                       SlotT* table,
+                                       InT* out,
+                                       IndexT* indices) {
+  CUDA_KERNEL_LOOP_TYPE(j, num_out, int64_t) {
+    const SlotT first = firsts[j];
+    out[j] = in[first];
+    table[slot_of[first]] = static_cast<SlotT>(j);
+    if (indices != nullptr) {
+      indices[j] = static_cast<IndexT>(first);
+    }
+  }
+}
+
+template <typename IndexT, typename SlotT>
+__global__ void UniqueHashInverseKernel(const SlotT* table,
+                                        const SlotT* slot_of,
+                                        int64_t num_input,
+                                        IndexT* inverse,
+                                        IndexT* counts) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_input, int64_t) {
+    const SlotT j = table[slot_of[i]];
+    inverse[i] = static_cast<IndexT>(j);
+    if (counts != nullptr) {
+      atomicAdd(reinterpret_cast<SlotT*>(counts) + j, static_cast<SlotT>(1));
+    }
+  }
+}
+
+template <typename Context, typename InT, typename IndexT>
+static void UniqueHashCUDATensor(const Context& context,
+                                 const DenseTensor& in,
+                                 DenseTensor* out,
+                                 DenseTensor* indices,
+                                 DenseTensor* index,
+                                 DenseTensor* counts,
+                                 bool return_index,
+                                 bool return_counts,
+                                 int64_t num_input) {
+  using SlotT = UniqueHashSlotT<IndexT>;
+  const InT* in_data = in.data<InT>();
+  // keep the load factor of the table no more than 2/3
+  int64_t capacity = 64;
+  while (capacity < num_input + num_input / 2) {
+    capacity *= 2;
+  }
+
+#ifdef PADDLE_WITH_CUDA
+  phi::memory_utils::ThrustAllocator<cudaStream_t> allocator(context.GetPlace(),
+                                                             context.stream());
+  const auto& exec_policy = thrust::cuda::par(allocator).on(context.stream());
+#else
+  const auto& exec_policy = thrust::hip::par.on(context.stream());
+#endif
+
+  // 1. Insert the elements into the table
+  DenseTensor table;
+  table.Resize(common::make_ddim({capacity}));
+  SlotT* table_data =
+      reinterpret_cast<SlotT*>(context.template Alloc<IndexT>(&table));
+  thrust::fill(exec_policy,
+               table_data,
+               table_data + capacity,
+               static_cast<SlotT>(-1));
+  DenseTensor slot_of;
+  slot_of.Resize(common::make_ddim({num_input}));
+  SlotT* slot_of_data =
+      reinterpret_cast<SlotT*>(context.template Alloc<IndexT>(&slot_of));
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(
+      context, std::max<int64_t>(num_input, 1));
+  if (num_input > 0) {
+    UniqueHashInsertKernel<InT, SlotT><<<config.block_per_grid,
+                                         config.thread_per_block,
+                                         0,
+                                         context.stream()>>>(
+        in_data, num_input, table_data, capacity - 1, slot_of_data);
+  }
+
+  // 2. Sort the first positions of the unique elements
+  DenseTensor firsts;
+  firsts.Resize(common::make_ddim({num_input}));
+  SlotT* firsts_data =
+      reinterpret_cast<SlotT*>(context.template Alloc<IndexT>(&firsts));
+  int64_t num_out = thrust::copy_if(exec_policy,
+                                    table_data,
+                                    table_data + capacity,
+                                    firsts_data,
+                                    UniqueHashSlotNotEmpty<SlotT>()) -
+                    firsts_data;
+  thrust::sort(exec_policy, firsts_data, firsts_data + num_out);
+
+  // 3. Calculate 'out' and 'indices', the slots are replaced by the indices
+  // of the unique elements in 'out'
+  out->Resize(common::make_ddim({num_out}));
+  auto* out_data = context.template Alloc<InT>(out);
+  IndexT* indices_data = nullptr;
+  if (return_index) {
+    indices->Resize(common::make_ddim({num_out}));
+    indices_data = context.template Alloc<IndexT>(indices);
+  }
+  if (num_out > 0) {
+    auto gather_config =
+        phi::backends::gpu::GetGpuLaunchConfig1D(context, num_out);
+    UniqueHashGatherKernel<InT, IndexT, SlotT>
+        <<<gather_config.block_per_grid,
+           gather_config.thread_per_block,
+           0,
+           context.stream()>>>(in_data,
+                               firsts_data,
+                               num_out,
+                               slot_of_data,
+                               table_data,
+                               out_data,
+                               indices_data);
+  }
+
+  // 4. Calculate 'index' and 'counts'
+  index->Resize(in.dims());
+  auto* inverse_data = context.template Alloc<IndexT>(index);
+  IndexT* counts_data = nullptr;
+  if (return_counts) {
+    counts->Resize(common::make_ddim({num_out}));
+    counts_data = context.template Alloc<IndexT>(counts);
+    thrust::fill(exec_policy, counts_data, counts_data + num_out, 0);
+  }
+  if (num_input > 0) {
+    UniqueHashInverseKernel<IndexT, SlotT><<<config.block_per_grid,
+                                             config.thread_per_block,
+                                             0,
+                                             context.stream()>>>(
+        table_data, slot_of_data, num_input, inverse_data, counts_data);
+  }
+}
+
+// functor for the hash based unique of a flattend DenseTensor
+template <typename Context, typename InT>
+struct UniqueHashCUDAFunctor {
+  const Context& ctx_;
+  const DenseTensor& in_;
+  DenseTensor* out_;
+  DenseTensor* indices_;
+  DenseTensor* index_;
+  DenseTensor* counts_;
+  const bool return_index_;
+  const bool return_counts_;
+
+  UniqueHashCUDAFunctor(const Context& context,
+                        const DenseTensor& in,
+                        DenseTensor* out,
+                        DenseTensor* indices,
+                        DenseTensor* index,
+                        DenseTensor* counts,
+                        bool return_index,
+                        bool return_counts)
+      : ctx_(context),
+        in_(in),
+        out_(out),
+        indices_(indices),
+        index_(index),
+        counts_(counts),
+        return_index_(return_index),
+        return_counts_(return_counts) {}
+
+  template <typename IndexT>
+  void apply() const {
+    UniqueHashCUDATensor<Context, InT, IndexT>(ctx_,
+                                               in_,
+                                               out_,
+                                               indices_,
+                                               index_,
+                                               counts_,
+                                               return_index_,
+                                               return_counts_,
+                                               in_.numel());
+  }
+};
+
 // functor for processing a flattend DenseTensor
 template <typename Context, typename InT>
 struct UniqueFlattendCUDAFunctor {
@@ -630,6 +900,20 @@ void UniqueRawKernel(const Context& context,
             "int64.",
             x.numel()));
   }
+  // the unique elements in the order of their first occurrence, which is
+  // what the CPU kernel outputs for is_sorted == false
+  if (!is_sorted) {
+    phi::VisitDataTypeTiny(dtype,
+                           UniqueHashCUDAFunctor<Context, T>(context,
+                                                             x,
+                                                             out,
+                                                             indices,
+                                                             index,
+                                                             counts,
+                                                             return_index,
+                                                             return_counts));
+    return;
+  }
   // if 'axis' is not required, flatten the DenseTensor.
   if (axis.empty()) {
     phi::VisitDataTypeTiny(
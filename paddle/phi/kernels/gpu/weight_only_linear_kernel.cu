@@ -16,6 +16,8 @@ limitations under the License. */
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/datatype_traits.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
 #include "paddle/phi/kernels/funcs/weight_only_gemv.h"
 #if defined(PADDLE_WITH_CUTLASS)
 #include "paddle/phi/kernels/fusion/cutlass/cutlass_kernels/fpA_intB_gemm/fpA_intB_gemm_template.h"
@@ -23,12 +25,71 @@ limitations under the License. */
 
 namespace phi {
 
+// Each warp sums the x of one row over one quantization group.
+template <typename T>
+__global__ void WeightOnlyGroupSumKernel(
+    const T* x, T* x_sum, int k, int group_size, int group_num) {
+  constexpr int kWarpSize = 32;
+  const int lane = threadIdx.x % kWarpSize;
+  const int group = blockIdx.y * (blockDim.x / kWarpSize) +
+                    threadIdx.x / kWarpSize;
+  if (group >= group_num) return;
+  const T* x_group = x + static_cast<int64_t>(blockIdx.x) * k +
+                     group * group_size;
+  float sum = 0.f;
+  for (int i = lane; i < group_size; i += kWarpSize) {
+    sum += static_cast<float>(x_group[i]);
+  }
+  sum = phi::funcs::WarpReduceSum<float>(sum, 0xffffffff);
+  if (lane == 0) {
+    x_sum[blockIdx.x * group_num + group] = static_cast<T>(sum);
+  }
+}
+
+// The weight-only GEMM dequantizes the weights as q * scale, so the zeros
+// are added as out += x_group_sum [m, group_num] * zeros [group_num, n], where
+// group_num is 1 in per-channel mode.
+template <typename T, typename Context>
+void WeightOnlyAddZeros(const Context& dev_ctx,
+                        const T* x,
+                        const T* zeros,
+                        int m,
+                        int n,
+                        int k,
+                        int group_size,
+                        T* out) {
+  if (group_size <= 0) group_size = k;
+  const int group_num = (k + group_size - 1) / group_size;
+  DenseTensor x_sum;
+  x_sum.Resize({m, group_num});
+  dev_ctx.template Alloc<T>(&x_sum);
+
+  constexpr int kThreads = 256;
+  constexpr int kGroupsPerBlock = kThreads / 32;
+  dim3 grid(m, (group_num + kGroupsPerBlock - 1) / kGroupsPerBlock);
+  WeightOnlyGroupSumKernel<T><<<grid, kThreads, 0, dev_ctx.stream()>>>(
+      x, x_sum.data<T>(), k, group_size, group_num);
+
+  auto blas = phi::funcs::GetBlas<Context, T>(dev_ctx);
+  blas.GEMM(CblasNoTrans,
+            CblasNoTrans,
+            m,
+            n,
+            group_num,
+            static_cast<T>(1.f),
+            x_sum.data<T>(),
+            zeros,
+            static_cast<T>(1.f),
+            out);
+}
+
 template <typename T, typename Context>
 void WeightOnlyLinearKernel(const Context& dev_ctx,
                             const DenseTensor& x,
                             const DenseTensor& weight,
                             const paddle::optional<DenseTensor>& bias,
                             const DenseTensor& weight_scale,
+                            const paddle::optional<DenseTensor>& weight_zero,
                             const std::string& weight_dtype,
                             const int32_t arch,
                             const int32_t group_size,
@@ -50,6 +111,8 @@ void WeightOnlyLinearKernel(const Context& dev_ctx,
   const int8_t* weight_data = weight.data<int8_t>();
   const T* bias_data = bias ? bias.get().data<T>() : nullptr;
   const T* weight_scale_data = weight_scale.data<T>();
+  const T* weight_zero_data =
+      weight_zero ? weight_zero.get().data<T>() : nullptr;
   T* out_data = out->data<T>();
   const auto x_dims = x.dims();
   const auto w_dims = weight.dims();
@@ -160,6 +223,10 @@ we havenot support sm70 weightonly gemv, because sm70 weight layout is RowMajor.
             dev_ctx.stream());
       }
     }
+    if (weight_zero_data) {
+      WeightOnlyAddZeros<T, Context>(
+          dev_ctx, x_data, weight_zero_data, m, n, k, group_size, out_data);
+    }
 #else
     PADDLE_THROW(common::errors::Unimplemented(
         "Please compile with cutlass to make cutlass available"));
@@ -172,6 +239,7 @@ we havenot support sm70 weightonly gemv, because sm70 weight layout is RowMajor.
           weight_data,
           bias_data,
           weight_scale_data,
+          weight_zero_data,
           m,
           n,
           k,
@@ -188,6 +256,7 @@ we havenot support sm70 weightonly gemv, because sm70 weight layout is RowMajor.
           weight_data,
           bias_data,
           weight_scale_data,
+          weight_zero_data,
           m,
           n,
           k,
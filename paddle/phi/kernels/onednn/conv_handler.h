@@ -557,6 +557,21 @@ class ConvOneDNNHandlerT
     if (is_test && weights_mem_p) {
       return weights_mem_p;
     } else if (is_test) {
+      // the weights another thread or input shape packed already
+      const bool prepack = OneDNNContext::tls().is_prepack_weights_on();
+      const std::string packed_key =
+          prepack ? funcs::PackedWeightsKey(
+                        *filter, this->fwd_pd_->weights_desc(), scale_data)
+                  : "";
+      if (prepack) {
+        weights_mem_p = OneDNNPackedWeights::Instance().Get(packed_key,
+                                                            filter->Holder());
+        if (weights_mem_p) {
+          this->CacheMemory("@weights_mem_p_target", weights_mem_p);
+          return weights_mem_p;
+        }
+      }
+
       const K* filter_data = filter->data<K>();
       auto weights_tz = common::vectorize(filter->dims());
       funcs::GetGroupConvWeightsTz(weights_tz, groups);
@@ -566,14 +581,20 @@ class ConvOneDNNHandlerT
                                funcs::OneDNNGetDataType<K>(),
                                GetWeightsFormat(groups, is_conv3d));
 
-      return this->AcquireMemoryWithReorder(user_src_md,
-                                            this->fwd_pd_->weights_desc(),
-                                            funcs::to_void_cast<K>(filter_data),
-                                            "@weights_mem_p",
-                                            is_test,
-                                            {},
-                                            scale_data,
-                                            mask);
+      weights_mem_p =
+          this->AcquireMemoryWithReorder(user_src_md,
+                                         this->fwd_pd_->weights_desc(),
+                                         funcs::to_void_cast<K>(filter_data),
+                                         "@weights_mem_p",
+                                         is_test,
+                                         {},
+                                         scale_data,
+                                         mask);
+      if (prepack) {
+        OneDNNPackedWeights::Instance().Set(
+            packed_key, filter->Holder(), weights_mem_p);
+      }
+      return weights_mem_p;
     } else {
       const T* filter_data = filter->data<T>();
       auto weights_tz = common::vectorize(filter->dims());
@@ -15,9 +15,12 @@ limitations under the License. */
 #include "paddle/phi/kernels/sparse/conv_kernel.h"
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_meta.h"
 #include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/autotune/auto_tune_base.h"
+#include "paddle/phi/kernels/autotune/cache.h"
 #include "paddle/phi/kernels/cast_kernel.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
 #include "paddle/phi/kernels/funcs/scatter.cu.h"
@@ -67,6 +70,201 @@ namespace sparse {
     }                                                                    \
   })
 
+// The rulebook of the conv and the buffers of its products, which are shared
+// by the gather-gemm-scatter implementations.
+template <typename T, typename IntT>
+struct SparseConvGemmArgs {
+  const T* x_values;
+  const T* kernel;
+  const IntT* rulebook;
+  int rulebook_len;
+  const int* h_counter;
+  const int* h_offsets;
+  int kernel_size;
+  int in_channels;
+  int out_channels;
+  bool subm;
+  int64_t out_nnz;
+  DenseTensor* out_index;
+  DenseTensor* unique_value;
+  DenseTensor* out_values;
+};
+
+// Gathers the input features of the rulebook, calls gemm for every weight and
+// scatters the products to the output.
+template <typename T, typename IntT>
+void ExplicitGatherGemmScatter(const GPUContext& dev_ctx,
+                               const SparseConvGemmArgs<T, IntT>& args) {
+  const int rulebook_len = args.rulebook_len;
+  const int in_channels = args.in_channels;
+  const int out_channels = args.out_channels;
+  if (args.subm) {
+    auto config =
+        phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, rulebook_len, 1);
+    args.unique_value->ResizeAndAllocate(
+        {static_cast<int>(args.out_nnz * args.kernel_size)});
+    args.out_index->ResizeAndAllocate({static_cast<int>(rulebook_len)});
+    int* out_index_ptr = args.out_index->template data<int>();
+    int* unique_value_ptr = args.unique_value->template data<int>();
+    phi::backends::gpu::GpuMemsetAsync(
+        out_index_ptr, 0, sizeof(int) * rulebook_len, dev_ctx.stream());
+    GroupIndexs<<<config.block_per_grid,
+                  config.thread_per_block,
+                  0,
+                  dev_ctx.stream()>>>(rulebook_len,
+                                      args.kernel_size,
+                                      args.rulebook + rulebook_len,
+                                      out_index_ptr,
+                                      unique_value_ptr);
+  }
+  // 2. gather
+  phi::DenseTensor in_features =
+      phi::Empty<T>(dev_ctx, {rulebook_len, in_channels});
+  phi::DenseTensor out_features =
+      phi::Empty<T>(dev_ctx, {rulebook_len, out_channels});
+  T* in_features_ptr = in_features.data<T>();
+  T* out_features_ptr = out_features.data<T>();
+  phi::funcs::SetConstant<GPUContext, T> set_zero;
+  set_zero(dev_ctx, &out_features, static_cast<T>(0.0f));
+
+  Gather<T, IntT>(dev_ctx,
+                  args.x_values,
+                  args.rulebook,
+                  rulebook_len,
+                  in_channels,
+                  in_features_ptr);
+
+  // 3. call gemm for every werght
+  auto blas = phi::funcs::GetBlas<GPUContext, T>(dev_ctx);
+  T* out_values_ptr = args.out_values->template data<T>();
+  set_zero(dev_ctx, args.out_values, static_cast<T>(0.0f));
+
+  for (int i = 0; i < args.kernel_size; i++) {
+    if (args.h_counter[i] <= 0) {
+      continue;
+    }
+
+    // call gemm: (n, in_channels) * (in_channels, out_channels)
+    const int M = args.h_counter[i];
+    const int K = in_channels;
+    const int N = out_channels;
+    T* tmp_in_ptr = in_features_ptr + args.h_offsets[i] * in_channels;
+    const T* tmp_kernel_ptr = args.kernel + i * K * N;
+    T* tmp_out_ptr = out_features_ptr + args.h_offsets[i] * out_channels;
+
+    blas.GEMM(CblasNoTrans,
+              CblasNoTrans,
+              M,
+              N,
+              K,
+              static_cast<T>(1),
+              tmp_in_ptr,
+              tmp_kernel_ptr,
+              static_cast<T>(0),
+              tmp_out_ptr);
+  }
+
+  // 4. scatter
+  phi::funcs::sparse::ScatterV2<T>(dev_ctx,
+                                   out_features_ptr,
+                                   args.out_index->template data<int>(),
+                                   args.unique_value->template data<int>(),
+                                   args.out_nnz,
+                                   args.kernel_size,
+                                   out_channels,
+                                   1,
+                                   out_values_ptr);
+}
+
+constexpr int kImplicitGemmTile = 16;
+
+// Computes out[scatter[m]] += x[gather[m]] * weight for the m pairs of one
+// kernel offset. The gathered rows of x are only staged in the shared memory,
+// so neither the gathered features nor the products are written to the
+// global memory. The pairs of one offset never share an output, and the
+// offsets are launched one after another, so the adds need no atomics.
+template <typename T, typename IntT>
+__global__ void ImplicitGemmGatherScatterKernel(const T* x_values,
+                                                const T* weight,
+                                                const IntT* gather_indices,
+                                                const IntT* scatter_indices,
+                                                const int m,
+                                                const int in_channels,
+                                                const int out_channels,
+                                                T* out_values) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  __shared__ MT x_tile[kImplicitGemmTile][kImplicitGemmTile + 1];
+  __shared__ MT w_tile[kImplicitGemmTile][kImplicitGemmTile + 1];
+
+  const int64_t row =
+      static_cast<int64_t>(blockIdx.x) * kImplicitGemmTile + threadIdx.y;
+  const int col = blockIdx.y * kImplicitGemmTile + threadIdx.x;
+  const int64_t in_row =
+      row < m ? static_cast<int64_t>(gather_indices[row]) : 0;
+
+  MT sum = static_cast<MT>(0);
+  for (int k = 0; k < in_channels; k += kImplicitGemmTile) {
+    const int x_col = k + threadIdx.x;
+    const int w_row = k + threadIdx.y;
+    x_tile[threadIdx.y][threadIdx.x] =
+        row < m && x_col < in_channels
+            ? static_cast<MT>(x_values[in_row * in_channels + x_col])
+            : static_cast<MT>(0);
+    w_tile[threadIdx.y][threadIdx.x] =
+        w_row < in_channels && col < out_channels
+            ? static_cast<MT>(weight[w_row * out_channels + col])
+            : static_cast<MT>(0);
+    __syncthreads();
+#pragma unroll
+    for (int i = 0; i < kImplicitGemmTile; ++i) {
+      sum += x_tile[threadIdx.y][i] * w_tile[i][threadIdx.x];
+    }
+    __syncthreads();
+  }
+
+  if (row < m && col < out_channels) {
+    T* out =
+        out_values + static_cast<int64_t>(scatter_indices[row]) * out_channels;
+    out[col] = static_cast<T>(static_cast<MT>(out[col]) + sum);
+  }
+}
+
+// The implicit gemm, which reads the input features through the rulebook and
+// accumulates the products into the output in a kernel per weight.
+template <typename T, typename IntT>
+void ImplicitGemmGatherScatter(const GPUContext& dev_ctx,
+                               const SparseConvGemmArgs<T, IntT>& args) {
+  phi::funcs::SetConstant<GPUContext, T> set_zero;
+  set_zero(dev_ctx, args.out_values, static_cast<T>(0.0f));
+  T* out_values_ptr = args.out_values->template data<T>();
+
+  const int K = args.in_channels;
+  const int N = args.out_channels;
+  dim3 threads(kImplicitGemmTile, kImplicitGemmTile);
+  for (int i = 0; i < args.kernel_size; i++) {
+    const int M = args.h_counter[i];
+    if (M <= 0) {
+      continue;
+    }
+    dim3 grids((M + kImplicitGemmTile - 1) / kImplicitGemmTile,
+               (N + kImplicitGemmTile - 1) / kImplicitGemmTile);
+    ImplicitGemmGatherScatterKernel<T, IntT>
+        <<<grids, threads, 0, dev_ctx.stream()>>>(
+            args.x_values,
+            args.kernel + static_cast<int64_t>(i) * K * N,
+            args.rulebook + args.h_offsets[i],
+            args.rulebook + args.rulebook_len + args.h_offsets[i],
+            M,
+            K,
+            N,
+            out_values_ptr);
+  }
+}
+
+// To reduce the tuning time, the rulebook length is mapped to a range like the
+// features_num_range of the gather_gemm_scatter.
+constexpr int kRulebookLenRange = 10000;
+
 template <typename T, typename IntT>
 void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
                         const SparseCooTensor& x,
@@ -135,6 +333,11 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
   int rulebook_len = 0;
   const IntT* rulebook_ptr = nullptr;
   bool need_product_rulebook = true;
+  // the subm convs without a key reuse the rulebook of the same indices
+  const std::string subm_key =
+      subm && key.empty()
+          ? phi::funcs::sparse::SubmRulebookKey(x, kernel_sizes, dilations)
+          : "";
   if (subm && !key.empty()) {
     rulebook_ptr = phi::funcs::sparse::PrepareSubm<T, IntT, GPUContext>(
         dev_ctx,
@@ -146,6 +349,20 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
         h_offsets.data<int>(),
         &rulebook_len,
         &need_product_rulebook);
+  } else if (!subm_key.empty()) {
+    rulebook_ptr =
+        phi::funcs::sparse::PrepareSubmBySubmKey<T, IntT, GPUContext>(
+            dev_ctx,
+            x,
+            subm_key,
+            out_dims,
+            out,
+            h_counter.data<int>(),
+            h_offsets.data<int>(),
+            &rulebook_len,
+            &need_product_rulebook,
+            rulebook,
+            counter);
   }
 
   if (need_product_rulebook) {
@@ -168,8 +385,19 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
                                                         h_offsets_ptr);
     rulebook_ptr = tmp_rulebook.data<IntT>();
 
-    phi::funcs::sparse::SaveToTable(
-        dev_ctx, x, key, tmp_rulebook, h_counter, out, rulebook, counter);
+    if (subm_key.empty()) {
+      phi::funcs::sparse::SaveToTable(
+          dev_ctx, x, key, tmp_rulebook, h_counter, out, rulebook, counter);
+    } else {
+      phi::funcs::sparse::SaveToTableBySubmKey(dev_ctx,
+                                               x,
+                                               subm_key,
+                                               tmp_rulebook,
+                                               h_counter,
+                                               out,
+                                               rulebook,
+                                               counter);
+    }
   }
 
 #if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
@@ -213,84 +441,38 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
     }
   } else {
 #endif
-    if (subm) {
-      auto config =
-          phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, rulebook_len, 1);
-      unique_value.ResizeAndAllocate(
-          {static_cast<int>(out->nnz() * kernel_size)});
-      out_index.ResizeAndAllocate({static_cast<int>(rulebook_len)});
-      int* out_index_ptr = out_index.data<int>();
-      int* unique_value_ptr = unique_value.data<int>();
-      phi::backends::gpu::GpuMemsetAsync(
-          out_index_ptr, 0, sizeof(int) * rulebook_len, dev_ctx.stream());
-      GroupIndexs<<<config.block_per_grid,
-                    config.thread_per_block,
-                    0,
-                    dev_ctx.stream()>>>(rulebook_len,
-                                        kernel_size,
-                                        rulebook_ptr + rulebook_len,
-                                        out_index_ptr,
-                                        unique_value_ptr);
-    }
-    // 2. gather
-    phi::DenseTensor in_features =
-        phi::Empty<T>(dev_ctx, {rulebook_len, in_channels});
-    phi::DenseTensor out_features =
-        phi::Empty<T>(dev_ctx, {rulebook_len, out_channels});
-    T* in_features_ptr = in_features.data<T>();
-    T* out_features_ptr = out_features.data<T>();
-    phi::funcs::SetConstant<GPUContext, T> set_zero;
-    set_zero(dev_ctx, &out_features, static_cast<T>(0.0f));
-
-    Gather<T, IntT>(dev_ctx,
-                    x.values().data<T>(),
-                    rulebook_ptr,
-                    rulebook_len,
-                    in_channels,
-                    in_features_ptr);
-
-    // 3. call gemm for every werght
-    auto blas = phi::funcs::GetBlas<GPUContext, T>(dev_ctx);
-    auto* out_values = out->mutable_values();
-    T* out_values_ptr = out_values->data<T>();
-    set_zero(dev_ctx, out_values, static_cast<T>(0.0f));
-
-    const T* kernel_ptr = kernel.data<T>();
-    for (int i = 0; i < kernel_size; i++) {
-      if (h_counter_ptr[i] <= 0) {
-        continue;
-      }
-
-      // call gemm: (n, in_channels) * (in_channels, out_channels)
-      const int M = h_counter_ptr[i];
-      const int K = in_channels;
-      const int N = out_channels;
-      T* tmp_in_ptr = in_features_ptr + h_offsets_ptr[i] * in_channels;
-      const T* tmp_kernel_ptr = kernel_ptr + i * K * N;
-      T* tmp_out_ptr = out_features_ptr + h_offsets_ptr[i] * out_channels;
-
-      blas.GEMM(CblasNoTrans,
-                CblasNoTrans,
-                M,
-                N,
-                K,
-                static_cast<T>(1),
-                tmp_in_ptr,
-                tmp_kernel_ptr,
-                static_cast<T>(0),
-                tmp_out_ptr);
-    }
-
-    // 4. scatter
-    phi::funcs::sparse::ScatterV2<T>(dev_ctx,
-                                     out_features_ptr,
-                                     out_index.data<int>(),
-                                     unique_value.data<int>(),
-                                     out->nnz(),
+    SparseConvGemmArgs<T, IntT> args{x.values().data<T>(),
+                                     kernel.data<T>(),
+                                     rulebook_ptr,
+                                     rulebook_len,
+                                     h_counter_ptr,
+                                     h_offsets_ptr,
                                      kernel_size,
+                                     in_channels,
                                      out_channels,
-                                     1,
-                                     out_values_ptr);
+                                     subm,
+                                     out->nnz(),
+                                     &out_index,
+                                     &unique_value,
+                                     out->mutable_values()};
+    // tune the gather-gemm-scatter by the blas against the implicit gemm, in
+    // the cache entries of the gather_gemm_scatter
+    auto* tuner = phi::autotune::MakeSparseConvTuner<T>(
+        ExplicitGatherGemmScatter<T, IntT>);
+    tuner->AddCallBack(ImplicitGemmGatherScatter<T, IntT>);
+    const auto algo =
+        std::is_same<T, phi::dtype::float16>::value
+            ? phi::autotune::AlgorithmType::kGatherGemmScatterFP16NN
+            : phi::autotune::AlgorithmType::kGatherGemmScatterFP32NN;
+    const size_t tune_key =
+        phi::autotune::GenKey(std::string("sparse_conv_implicit_gemm"),
+                              rulebook_len / kRulebookLenRange,
+                              in_channels,
+                              out_channels,
+                              kernel_size,
+                              subm,
+                              phi::CppTypeToDataType<T>::Type());
+    tuner->Run(dev_ctx, algo, tune_key, dev_ctx, args);
 #if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
   }
 #endif
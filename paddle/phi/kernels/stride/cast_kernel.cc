@@ -0,0 +1,84 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/cast_kernel.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/contiguous_kernel.h"
+#include "paddle/phi/kernels/funcs/strided_utils.h"
+
+COMMON_DECLARE_bool(use_stride_kernel);
+
+namespace phi {
+
+// Casts the strided x into the contiguous out in a single pass, instead of
+// the contiguous copy of x followed by the cast.
+template <typename T, typename Context>
+void CastStridedKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       DataType out_dtype,
+                       DenseTensor* out) {
+  if (!FLAGS_use_stride_kernel) {
+    PADDLE_THROW(common::errors::Fatal(
+        "FLAGS_use_stride_kernel is closed. Strided kernel "
+        "be called, something wrong has happened!"));
+  }
+  out->set_strides(DenseTensorMeta::calc_strides(out->dims()));
+  if (x.meta().is_contiguous() || out->IsSharedWith(x)) {
+    CastKernel<T, Context>(dev_ctx, x, out_dtype, out);
+    return;
+  }
+  if (x.dtype() == out_dtype) {
+    ContiguousKernel<T, Context>(dev_ctx, x, out);
+    return;
+  }
+
+  const T* x_data = x.data<T>();
+  PD_VISIT_ALL_TYPES(out_dtype, "CastStridedKernel", ([&] {
+                       data_t* out_data = dev_ctx.template Alloc<data_t>(out);
+                       funcs::StridedForEach<1>(
+                           x.dims(),
+                           {x.strides().Get()},
+                           [&](const std::array<int64_t, 1>& offsets) {
+                             *out_data++ =
+                                 static_cast<data_t>(x_data[offsets[0]]);
+                           });
+                     }));
+  out->set_type(out_dtype);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(cast,
+                   CPU,
+                   STRIDED,
+                   phi::CastStridedKernel,
+                   float,
+                   double,
+                   int,
+                   int64_t,
+                   int16_t,
+                   bool,
+                   int8_t,
+                   uint8_t,
+                   phi::dtype::float8_e4m3fn,
+                   phi::dtype::float8_e5m2,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+}
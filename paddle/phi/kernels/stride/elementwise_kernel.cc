@@ -0,0 +1,138 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/complex.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/elementwise_add_kernel.h"
+#include "paddle/phi/kernels/elementwise_divide_kernel.h"
+#include "paddle/phi/kernels/elementwise_multiply_kernel.h"
+#include "paddle/phi/kernels/elementwise_subtract_kernel.h"
+#include "paddle/phi/kernels/funcs/elementwise_functor.h"
+#include "paddle/phi/kernels/funcs/strided_utils.h"
+
+COMMON_DECLARE_bool(use_stride_kernel);
+
+namespace phi {
+
+// Computes the broadcast elementwise out of the strided x and y, reading
+// them in place instead of their contiguous copies.
+template <typename T, typename Functor>
+void ElementwiseStridedCompute(const CPUContext& dev_ctx,
+                               const DenseTensor& x,
+                               const DenseTensor& y,
+                               DenseTensor* out) {
+  T* out_data = dev_ctx.Alloc<T>(out);
+  const T* x_data = x.data<T>();
+  const T* y_data = y.data<T>();
+  const std::vector<int64_t> x_strides =
+      funcs::BroadcastStrides(x, out->dims());
+  const std::vector<int64_t> y_strides =
+      funcs::BroadcastStrides(y, out->dims());
+  Functor functor;
+  funcs::StridedForEach<3>(
+      out->dims(),
+      {x_strides.data(), y_strides.data(), out->strides().Get()},
+      [&](const std::array<int64_t, 3>& offsets) {
+        out_data[offsets[2]] =
+            functor(x_data[offsets[0]], y_data[offsets[1]]);
+      });
+}
+
+#define DEFINE_ELEMENTWISE_STRIDED_KERNEL(name, functor)                  \
+  template <typename T, typename Context>                                 \
+  void name##StridedKernel(const Context& dev_ctx,                        \
+                           const DenseTensor& x,                          \
+                           const DenseTensor& y,                          \
+                           DenseTensor* out) {                            \
+    if (!FLAGS_use_stride_kernel) {                                       \
+      PADDLE_THROW(common::errors::Fatal(                                 \
+          "FLAGS_use_stride_kernel is closed. Strided kernel "            \
+          "be called, something wrong has happened!"));                   \
+    }                                                                     \
+    out->set_strides(DenseTensorMeta::calc_strides(out->dims()));         \
+    if (x.meta().is_contiguous() && y.meta().is_contiguous()) {           \
+      name##Kernel<T, Context>(dev_ctx, x, y, out);                       \
+      return;                                                             \
+    }                                                                     \
+    ElementwiseStridedCompute<T, functor<T>>(dev_ctx, x, y, out);         \
+  }
+
+DEFINE_ELEMENTWISE_STRIDED_KERNEL(Add, funcs::AddFunctor)
+DEFINE_ELEMENTWISE_STRIDED_KERNEL(Subtract, funcs::SubtractFunctor)
+DEFINE_ELEMENTWISE_STRIDED_KERNEL(Multiply, funcs::MultiplyFunctor)
+DEFINE_ELEMENTWISE_STRIDED_KERNEL(Divide, funcs::DivideFunctor)
+
+}  // namespace phi
+
+using complex64 = ::phi::dtype::complex<float>;
+using complex128 = ::phi::dtype::complex<double>;
+
+PD_REGISTER_KERNEL(add,
+                   CPU,
+                   STRIDED,
+                   phi::AddStridedKernel,
+                   float,
+                   double,
+                   int16_t,
+                   int,
+                   bool,
+                   uint8_t,
+                   int8_t,
+                   int64_t,
+                   complex64,
+                   complex128) {}
+
+PD_REGISTER_KERNEL(subtract,
+                   CPU,
+                   STRIDED,
+                   phi::SubtractStridedKernel,
+                   float,
+                   double,
+                   int16_t,
+                   int,
+                   int64_t,
+                   complex64,
+                   complex128,
+                   phi::dtype::bfloat16) {}
+
+PD_REGISTER_KERNEL(multiply,
+                   CPU,
+                   STRIDED,
+                   phi::MultiplyStridedKernel,
+                   float,
+                   double,
+                   int,
+                   int64_t,
+                   bool,
+                   complex64,
+                   complex128,
+                   phi::dtype::bfloat16) {}
+
+PD_REGISTER_KERNEL(divide,
+                   CPU,
+                   STRIDED,
+                   phi::DivideStridedKernel,
+                   float,
+                   double,
+                   int8_t,
+                   uint8_t,
+                   int16_t,
+                   int,
+                   int64_t,
+                   bool,
+                   complex64,
+                   complex128) {}
@@ -0,0 +1,155 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <type_traits>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/contiguous_kernel.h"
+#include "paddle/phi/kernels/funcs/strided_utils.h"
+#include "paddle/phi/kernels/reduce_mean_kernel.h"
+#include "paddle/phi/kernels/reduce_sum_kernel.h"
+
+COMMON_DECLARE_bool(use_stride_kernel);
+
+namespace phi {
+
+// Sums, or averages, the strided x into the contiguous out of the same
+// dtype, accumulating each element of x into its out element in place of
+// the contiguous copy of x.
+template <typename T>
+void ReduceStridedCompute(const CPUContext& dev_ctx,
+                          const DenseTensor& x,
+                          const IntArray& dims,
+                          bool mean,
+                          DenseTensor* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  const bool reduce_all = recompute_reduce_all(x, dims);
+  const std::vector<int64_t> out_strides =
+      funcs::ReducedStrides(x.dims(), dims.GetData(), reduce_all);
+  std::vector<MT> acc(out->numel(), static_cast<MT>(0));
+  const T* x_data = x.data<T>();
+  funcs::StridedForEach<2>(x.dims(),
+                           {x.strides().Get(), out_strides.data()},
+                           [&](const std::array<int64_t, 2>& offsets) {
+                             acc[offsets[1]] +=
+                                 static_cast<MT>(x_data[offsets[0]]);
+                           });
+
+  T* out_data = dev_ctx.Alloc<T>(out);
+  const int64_t count = out->numel() > 0 ? x.numel() / out->numel() : 0;
+  for (int64_t i = 0; i < out->numel(); ++i) {
+    out_data[i] = static_cast<T>(mean ? acc[i] / static_cast<MT>(count)
+                                      : acc[i]);
+  }
+}
+
+// x reduced by the kernel of the dense layout, on its contiguous copy
+template <typename T, typename Context, typename Reduce>
+void ReduceContiguous(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const Reduce& reduce) {
+  if (x.meta().is_contiguous()) {
+    reduce(x);
+    return;
+  }
+  DenseTensor tmp;
+  ContiguousKernel<T, Context>(dev_ctx, x, &tmp);
+  reduce(tmp);
+}
+
+template <typename T, typename Context>
+void SumStridedKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const IntArray& dims,
+                      DataType out_dtype,
+                      bool keep_dim,
+                      DenseTensor* out) {
+  if (!FLAGS_use_stride_kernel) {
+    PADDLE_THROW(common::errors::Fatal(
+        "FLAGS_use_stride_kernel is closed. Strided kernel "
+        "be called, something wrong has happened!"));
+  }
+  out->set_strides(DenseTensorMeta::calc_strides(out->dims()));
+  // the sums of bool and the casting sums are left to the dense kernel
+  if constexpr (!std::is_same<T, bool>::value) {
+    const bool same_dtype =
+        (out_dtype == DataType::UNDEFINED || out_dtype == x.dtype()) &&
+        (out->dtype() == DataType::UNDEFINED || out->dtype() == x.dtype());
+    if (!x.meta().is_contiguous() && same_dtype) {
+      ReduceStridedCompute<T>(dev_ctx, x, dims, /*mean=*/false, out);
+      return;
+    }
+  }
+  ReduceContiguous<T>(dev_ctx, x, [&](const DenseTensor& input) {
+    SumKernel<T, Context>(dev_ctx, input, dims, out_dtype, keep_dim, out);
+  });
+}
+
+template <typename T, typename Context>
+void MeanStridedKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       const IntArray& dims,
+                       bool keep_dim,
+                       DenseTensor* out) {
+  if (!FLAGS_use_stride_kernel) {
+    PADDLE_THROW(common::errors::Fatal(
+        "FLAGS_use_stride_kernel is closed. Strided kernel "
+        "be called, something wrong has happened!"));
+  }
+  out->set_strides(DenseTensorMeta::calc_strides(out->dims()));
+  if (!x.meta().is_contiguous()) {
+    ReduceStridedCompute<T>(dev_ctx, x, dims, /*mean=*/true, out);
+    return;
+  }
+  MeanKernel<T, Context>(dev_ctx, x, dims, keep_dim, out);
+}
+
+}  // namespace phi
+
+using complex64 = ::phi::dtype::complex<float>;
+using complex128 = ::phi::dtype::complex<double>;
+
+PD_REGISTER_KERNEL(sum,
+                   CPU,
+                   STRIDED,
+                   phi::SumStridedKernel,
+                   bool,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   int16_t,
+                   int,
+                   int64_t,
+                   uint8_t,
+                   int8_t,
+                   complex64,
+                   complex128) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+}
+
+// the mean of bool is left to the dense kernel, on the contiguous copy
+PD_REGISTER_KERNEL(mean,
+                   CPU,
+                   STRIDED,
+                   phi::MeanStridedKernel,
+                   float,
+                   double,
+                   int,
+                   int64_t,
+                   complex64,
+                   complex128) {}
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "paddle/phi/common/pstring.h"
@@ -28,20 +30,72 @@ namespace phi {
 namespace strings {
 
 using pstring = dtype::pstring;
+
+// The case of 8 bytes of text is converted at once in a uint64_t word when
+// all of them are ASCII.
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+constexpr uint64_t kOnes = 0x0101010101010101ULL;
+
+HOSTDEVICE inline bool IsAsciiWord(uint64_t word) {
+  return (word & kHighBits) == 0;
+}
+
+// Flips the case of the bytes in [first, last] of an ASCII word. Adding
+// 0x80 - first sets the high bit of the bytes not below first and adding
+// 0x7F - last sets it of the bytes above last, no add carries over a byte
+// since all of them are below 0x80.
+HOSTDEVICE inline uint64_t FlipAsciiCase(uint64_t word, char first, char last) {
+  uint64_t ge_first = word + kOnes * static_cast<uint64_t>(0x80 - first);
+  uint64_t gt_last = word + kOnes * static_cast<uint64_t>(0x7F - last);
+  return word ^ (((ge_first & ~gt_last) & kHighBits) >> 2);
+}
+
 struct AsciiToLower {
   HOSTDEVICE char operator()(char in) const {
     return ('A' <= in && in <= 'Z') ? in - ('Z' - 'z') : in;
   }
+
+  HOSTDEVICE static uint64_t ConvertWord(uint64_t word) {
+    return FlipAsciiCase(word, 'A', 'Z');
+  }
 };
 
 struct AsciiToUpper {
   HOSTDEVICE char operator()(char in) const {
     return ('a' <= in && in <= 'z') ? in ^ 0x20 : in;
   }
+
+  HOSTDEVICE static uint64_t ConvertWord(uint64_t word) {
+    return FlipAsciiCase(word, 'a', 'z');
+  }
 };
 
+// Converts the case of n bytes, 8 at a time where they are all ASCII.
+template <typename AsciiConverter>
+HOSTDEVICE inline void ConvertAsciiStr(const char* in, char* out, size_t n) {
+  AsciiConverter converter;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, in + i, sizeof(word));
+    if (IsAsciiWord(word)) {
+      word = AsciiConverter::ConvertWord(word);
+      memcpy(out + i, &word, sizeof(word));
+    } else {
+      for (size_t j = i; j < i + sizeof(uint64_t); ++j) {
+        out[j] = converter(in[j]);
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    out[i] = converter(in[i]);
+  }
+}
+
 template <typename Context>
 struct UTF8ToLower {
+  using AsciiConverter = AsciiToLower;
+
   HOSTDEVICE UTF8ToLower(const uint8_t* unicode_flag_map,
                          const uint16_t* cases_map)
       : unicode_flag_map_(unicode_flag_map), cases_map_(cases_map) {}
@@ -57,6 +111,8 @@ struct UTF8ToLower {
 
 template <typename Context>
 struct UTF8ToUpper {
+  using AsciiConverter = AsciiToUpper;
+
   HOSTDEVICE UTF8ToUpper(const uint8_t* unicode_flag_map,
                          const uint16_t* cases_map)
       : unicode_flag_map_(unicode_flag_map), cases_map_(cases_map) {}
@@ -70,5 +126,52 @@ struct UTF8ToUpper {
   const uint16_t* cases_map_;
 };
 
+// Converts the UTF-8 string in of size bytes code point by code point with
+// converter into out, or only counts the bytes of the result when out is
+// nullptr. Runs of 8 ASCII bytes skip the decoding. A truncated or stray
+// byte is copied as is.
+template <typename UTF8Converter>
+HOSTDEVICE inline size_t ConvertUTF8Str(const char* in,
+                                        size_t size,
+                                        char* out,
+                                        const UTF8Converter& converter) {
+  using AsciiConverter = typename UTF8Converter::AsciiConverter;
+  size_t i = 0;
+  size_t out_size = 0;
+  while (i < size) {
+    if (i + sizeof(uint64_t) <= size) {
+      uint64_t word;
+      memcpy(&word, in + i, sizeof(word));
+      if (IsAsciiWord(word)) {
+        if (out != nullptr) {
+          word = AsciiConverter::ConvertWord(word);
+          memcpy(out + out_size, &word, sizeof(word));
+        }
+        i += sizeof(uint64_t);
+        out_size += sizeof(uint64_t);
+        continue;
+      }
+    }
+    uint32_t width = BytesInUtf8Char(static_cast<uint8_t>(in[i]));
+    if (width <= 1 || i + width > size) {
+      if (out != nullptr) {
+        out[out_size] = width == 1 ? AsciiConverter()(in[i]) : in[i];
+      }
+      ++i;
+      ++out_size;
+      continue;
+    }
+    uint32_t chr;
+    UTF8ToUInt32(in + i, &chr);
+    uint32_t utf8 = UnicodeToUTF8(converter(UTF8ToUnicode(chr)));
+    if (out != nullptr) {
+      UnicodeToUTF8Char(utf8, out + out_size);
+    }
+    i += width;
+    out_size += BytesInUnicodeChar(utf8);
+  }
+  return out_size;
+}
+
 }  // namespace strings
 }  // namespace phi
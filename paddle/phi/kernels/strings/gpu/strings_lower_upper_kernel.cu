@@ -11,6 +11,8 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/strings/strings_lower_upper_kernel.h"
 
+#include <thrust/scan.h>
+
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/common/pstring.h"
@@ -26,12 +28,8 @@ __global__ void StringCaseConvertCUDAKernel(pstring* out,
                                             const pstring* in,
                                             size_t num) {
   CUDA_KERNEL_LOOP(i, num) {
-    out[i] = pstring(in[i]);
-    thrust::transform(thrust::device,
-                      in[i].begin(),
-                      in[i].end(),
-                      out[i].mdata(),
-                      CharConverter());
+    out[i].resize_uninitialized(in[i].size());
+    ConvertAsciiStr<CharConverter>(in[i].data(), out[i].mdata(), in[i].size());
   }
 }
 
@@ -53,6 +51,9 @@ struct AsciiCaseConverter<phi::GPUContext, CharConverter> {
   }
 };
 
+// Converts the strings in two passes over the UTF-8 bytes, the first one
+// counts the bytes of each result and the second one writes them into one
+// buffer at the scanned offsets, without decoding into code points first.
 template <template <typename DeviceContextT> typename CharConverter>
 struct UTF8CaseConverter<phi::GPUContext, CharConverter> {
   void operator()(const phi::GPUContext& dev_ctx,
@@ -61,90 +62,42 @@ struct UTF8CaseConverter<phi::GPUContext, CharConverter> {
                   size_t num) const {
     auto unicode_flag_map = GetGPUUniflagMap();
     auto cases_map = GetGPUCharCasesMap();
-    thrust::device_vector<uint32_t> unicode_offsets(num + 1, 0);
-    uint32_t* unicode_offsets_ptr =
-        thrust::raw_pointer_cast(unicode_offsets.data());
-
-    thrust::for_each_n(thrust::device,
-                       thrust::make_counting_iterator<unsigned int>(0),
-                       num,
-                       [unicode_offsets_ptr, in] __device__(uint32_t idx) {
-                         unicode_offsets_ptr[idx + 1] =
-                             GetUnicodeStrLen(in[idx].data(), in[idx].size());
-                       });
-    uint32_t total_lengths = thrust::reduce(
-        thrust::device, unicode_offsets_ptr, unicode_offsets_ptr + num + 1, 0);
-    if (total_lengths == 0) {
-      return;
-    }
-
-    thrust::device_vector<uint32_t> unicode_output(total_lengths, 0);
-    uint32_t* unicode_output_ptr =
-        thrust::raw_pointer_cast(unicode_output.data());
-
     CharConverter<GPUContext> converter(unicode_flag_map, cases_map);
+#ifdef PADDLE_WITH_CUDA
+    const auto& policy = thrust::cuda::par.on(dev_ctx.stream());
+#else
+    const auto& policy = thrust::hip::par.on(dev_ctx.stream());
+#endif
+
+    thrust::device_vector<size_t> utf8_offsets(num + 1, 0);
+    size_t* utf8_offsets_ptr = thrust::raw_pointer_cast(utf8_offsets.data());
     thrust::for_each_n(
-        thrust::device,
-        thrust::make_counting_iterator<unsigned int>(0),
+        policy,
+        thrust::make_counting_iterator<size_t>(0),
         num,
-        [in,
-         out,
-         unicode_output_ptr,
-         unicode_offsets_ptr,
-         converter] __device__(uint32_t idx) {
-          uint32_t unicode_len =
-              unicode_offsets_ptr[idx + 1] - unicode_offsets_ptr[idx];
-          GetUnicodeStr(in[idx].data(),
-                        unicode_output_ptr + unicode_offsets_ptr[idx],
-                        unicode_len);
-          uint32_t* curr_unicode_output_ptr =
-              unicode_output_ptr + unicode_offsets_ptr[idx];
-          for (uint32_t i = 0; i < unicode_len; ++i) {
-            curr_unicode_output_ptr[i] = converter(curr_unicode_output_ptr[i]);
-          }
-          thrust::transform(thrust::device,
-                            unicode_output_ptr + unicode_offsets_ptr[idx],
-                            unicode_output_ptr + unicode_offsets_ptr[idx + 1],
-                            unicode_output_ptr + unicode_offsets_ptr[idx],
-                            converter);
+        [utf8_offsets_ptr, in, converter] __device__(size_t idx) {
+          utf8_offsets_ptr[idx + 1] = ConvertUTF8Str(
+              in[idx].data(), in[idx].size(), nullptr, converter);
         });
+    thrust::inclusive_scan(policy,
+                           utf8_offsets_ptr,
+                           utf8_offsets_ptr + num + 1,
+                           utf8_offsets_ptr);
+    size_t total_utf8_lengths = utf8_offsets[num];
 
-    thrust::device_vector<uint32_t> utf8_offsets(num + 1, 0);
-    uint32_t* utf8_offsets_ptr = thrust::raw_pointer_cast(utf8_offsets.data());
-
+    thrust::device_vector<char> utf8_output(total_utf8_lengths + 1, 0);
+    char* utf8_output_ptr = thrust::raw_pointer_cast(utf8_output.data());
     thrust::for_each_n(
-        thrust::device,
-        thrust::make_counting_iterator<unsigned int>(0),
+        policy,
+        thrust::make_counting_iterator<size_t>(0),
         num,
-        [utf8_offsets_ptr, unicode_output_ptr, unicode_offsets_ptr] __device__(
-            uint32_t idx) {
-          uint32_t unicode_len =
-              unicode_offsets_ptr[idx + 1] - unicode_offsets_ptr[idx];
-          utf8_offsets_ptr[idx + 1] = GetUTF8StrLen(
-              unicode_output_ptr + unicode_offsets_ptr[idx], unicode_len);
+        [utf8_output_ptr, utf8_offsets_ptr, in, out, converter] __device__(
+            size_t idx) {
+          char* result_ptr = utf8_output_ptr + utf8_offsets_ptr[idx];
+          size_t len = ConvertUTF8Str(
+              in[idx].data(), in[idx].size(), result_ptr, converter);
+          out[idx].assign(result_ptr, len);
         });
-    uint32_t total_utf8_lengths = thrust::reduce(
-        thrust::device, utf8_offsets_ptr, utf8_offsets_ptr + num + 1, 0);
-
-    thrust::device_vector<char> utf8_output(total_utf8_lengths, 0);
-    char* utf8_output_ptr = thrust::raw_pointer_cast(utf8_output.data());
-    thrust::for_each_n(thrust::device,
-                       thrust::make_counting_iterator<unsigned int>(0),
-                       num,
-                       [utf8_output_ptr,
-                        utf8_offsets_ptr,
-                        unicode_output_ptr,
-                        unicode_offsets_ptr,
-                        out] __device__(uint32_t idx) {
-                         uint32_t unicode_len = unicode_offsets_ptr[idx + 1] -
-                                                unicode_offsets_ptr[idx];
-                         const uint32_t* input_ptr =
-                             unicode_output_ptr + unicode_offsets_ptr[idx];
-                         char* result_ptr =
-                             utf8_output_ptr + utf8_offsets_ptr[idx];
-                         GetUTF8Str(input_ptr, result_ptr, unicode_len);
-                         out[idx] = result_ptr;
-                       });
   }
 };
 
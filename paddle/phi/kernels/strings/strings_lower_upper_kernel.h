@@ -86,8 +86,9 @@ struct AsciiCaseConverter {
                   pstring* out,
                   size_t num) const {
     for (size_t i = 0; i < num; ++i) {
-      std::transform(
-          in[i].begin(), in[i].end(), out[i].mdata(), CharConverter());
+      out[i].resize_uninitialized(in[i].size());
+      ConvertAsciiStr<CharConverter>(
+          in[i].data(), out[i].mdata(), in[i].size());
     }
   }
 };
@@ -102,18 +103,15 @@ struct UTF8CaseConverter {
                   size_t num) const {
     auto unicode_flag_map = GetUniFlagMap();
     auto cases_map = GetCharCasesMap();
+    CharConverter<DeviceContext> converter(unicode_flag_map, cases_map);
+    // Only the code points of the basic plane change, from 2 bytes to 3 at
+    // most, so the result is less than twice the size of the input.
+    std::vector<char> result;
     for (size_t i = 0; i < num; ++i) {
-      uint32_t unicode_len = GetUnicodeStrLen(in[i].data(), in[i].size());
-      std::vector<uint32_t> unicode_in(unicode_len, 0);
-      GetUnicodeStr(in[i].data(), unicode_in.data(), unicode_len);
-      std::transform(unicode_in.begin(),
-                     unicode_in.end(),
-                     unicode_in.begin(),
-                     CharConverter<DeviceContext>(unicode_flag_map, cases_map));
-      uint32_t utf8_len = GetUTF8StrLen(unicode_in.data(), unicode_len);
-      std::vector<char> result(utf8_len, 0);
-      GetUTF8Str(unicode_in.data(), result.data(), unicode_len);
-      out[i] = result.data();
+      result.resize(std::max(result.size(), in[i].size() * 2));
+      size_t len = ConvertUTF8Str(
+          in[i].data(), in[i].size(), result.data(), converter);
+      out[i].assign(result.data(), len);
     }
   }
 };
@@ -24,6 +24,7 @@ void WeightOnlyLinearKernel(const Context& dev_ctx,
                             const DenseTensor& weight,
                             const paddle::optional<DenseTensor>& bias,
                             const DenseTensor& weight_scale,
+                            const paddle::optional<DenseTensor>& weight_zero,
                             const std::string& weight_dtype,
                             const int32_t arch,
                             const int32_t group_size,
@@ -0,0 +1,300 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+// Replay an allocation trace recorded with FLAGS_alloc_trace_file against
+// the allocator strategies, e.g.
+//   allocator_replay --trace=alloc.trace --strategies=auto_growth,system
+// and report the throughput, the peak reserved memory and the fragmentation
+// of each of them.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/allocation_trace.h"
+#include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/phi/core/memory/allocation/cpu_allocator.h"
+#include "paddle/phi/core/memory/allocation/naive_best_fit_allocator.h"
+#include "paddle/phi/core/memory/stats.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/phi/core/memory/allocation/cuda_allocator.h"
+#include "paddle/phi/core/memory/allocation/thread_local_allocator.h"
+#endif
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 10020
+#include "paddle/phi/core/memory/allocation/cuda_virtual_mem_allocator.h"
+#include "paddle/phi/core/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
+#endif
+
+PD_DEFINE_string(trace, "", "The allocation trace to replay.");
+PD_DEFINE_string(strategies,
+                 "system,auto_growth,naive_best_fit,thread_local,"
+                 "virtual_memory",
+                 "The comma separated allocator strategies to replay on.");
+PD_DEFINE_string(place,
+                 "",
+                 "The place of the events to replay, e.g. gpu:0, the place "
+                 "of the first event by default.");
+PD_DEFINE_int64(chunk_size_in_mb,
+                0,
+                "The chunk size of the auto_growth strategy, 0 to grow by "
+                "the size of the allocations.");
+
+namespace alloc = paddle::memory::allocation;
+
+namespace {
+
+// Counts the bytes an allocator strategy reserves from the system.
+class CountingAllocator : public alloc::Allocator {
+ public:
+  explicit CountingAllocator(std::shared_ptr<alloc::Allocator> underlying)
+      : underlying_(std::move(underlying)) {}
+
+  bool IsAllocThreadSafe() const override {
+    return underlying_->IsAllocThreadSafe();
+  }
+
+  int64_t reserved() const { return reserved_; }
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override {
+    auto allocation = underlying_->Allocate(size);
+    reserved_ += static_cast<int64_t>(allocation->size());
+    return allocation.release();
+  }
+
+  void FreeImpl(phi::Allocation* allocation) override {
+    reserved_ -= static_cast<int64_t>(allocation->size());
+    underlying_->Free(allocation);
+  }
+
+ private:
+  std::shared_ptr<alloc::Allocator> underlying_;
+  std::atomic<int64_t> reserved_{0};
+};
+
+struct Strategy {
+  std::shared_ptr<alloc::Allocator> allocator;
+  // the bytes reserved from the system so far
+  std::function<int64_t()> reserved;
+};
+
+struct ReplayResult {
+  size_t num_events = 0;
+  double seconds = 0.;
+  int64_t peak_allocated = 0;
+  int64_t peak_reserved = 0;
+};
+
+phi::Place ParsePlace(const std::string& str) {
+  const auto colon = str.find(':');
+  const std::string type = str.substr(0, colon);
+  const int id =
+      colon == std::string::npos ? 0 : std::stoi(str.substr(colon + 1));
+  if (type == "cpu") {
+    return phi::CPUPlace();
+  } else if (type == "gpu") {
+    return phi::GPUPlace(id);
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unsupported place %s to replay on, expect cpu or gpu:<id>.", str));
+}
+
+// The reserved bytes of the strategies which allocate from the system by
+// themselves, tracked by the Reserved stat of the place.
+std::function<int64_t()> ReservedStatOf(const phi::Place& place) {
+  if (phi::is_cpu_place(place)) {
+    const int64_t base = paddle::memory::HostMemoryStatCurrentValue(
+        "Reserved", place.GetDeviceId());
+    return [place, base] {
+      return paddle::memory::HostMemoryStatCurrentValue(
+                 "Reserved", place.GetDeviceId()) -
+             base;
+    };
+  }
+  const int64_t base = paddle::memory::DeviceMemoryStatCurrentValue(
+      "Reserved", place.GetDeviceId());
+  return [place, base] {
+    return paddle::memory::DeviceMemoryStatCurrentValue(
+               "Reserved", place.GetDeviceId()) -
+           base;
+  };
+}
+
+std::shared_ptr<alloc::Allocator> SystemAllocatorOf(const phi::Place& place) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(place)) {
+    return std::make_shared<alloc::CUDAAllocator>(
+        phi::GPUPlace(place.GetDeviceId()));
+  }
+#endif
+  return std::make_shared<alloc::CPUAllocator>();
+}
+
+size_t AlignmentOf(const phi::Place& place) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(place)) {
+    return paddle::platform::GpuMinChunkSize();
+  }
+#endif
+  return alloc::CPUAllocator::kAlignment;
+}
+
+// The strategy to replay on, nullptr allocator if it is not available on
+// the place.
+Strategy MakeStrategy(const std::string& name, const phi::Place& place) {
+  Strategy strategy;
+  if (name == "system" || name == "auto_growth") {
+    auto counting =
+        std::make_shared<CountingAllocator>(SystemAllocatorOf(place));
+    strategy.reserved = [counting] { return counting->reserved(); };
+    if (name == "system") {
+      strategy.allocator = counting;
+    } else {
+      strategy.allocator = std::make_shared<alloc::AutoGrowthBestFitAllocator>(
+          counting, AlignmentOf(place), FLAGS_chunk_size_in_mb << 20);
+    }
+  } else if (name == "naive_best_fit") {
+    strategy.reserved = ReservedStatOf(place);
+    strategy.allocator = std::make_shared<alloc::NaiveBestFitAllocator>(place);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  } else if (name == "thread_local" && phi::is_gpu_place(place)) {
+    strategy.reserved = ReservedStatOf(place);
+    strategy.allocator = std::make_shared<alloc::ThreadLocalCUDAAllocator>(
+        phi::GPUPlace(place.GetDeviceId()));
+#endif
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 10020
+  } else if (name == "virtual_memory" && phi::is_gpu_place(place)) {
+    auto counting = std::make_shared<CountingAllocator>(
+        std::make_shared<alloc::CUDAVirtualMemAllocator>(
+            phi::GPUPlace(place.GetDeviceId())));
+    strategy.reserved = [counting] { return counting->reserved(); };
+    strategy.allocator =
+        std::make_shared<alloc::VirtualMemoryAutoGrowthBestFitAllocator>(
+            counting, AlignmentOf(place), phi::GPUPlace(place.GetDeviceId()));
+#endif
+  }
+  return strategy;
+}
+
+// Replay the events in order. The frees of the allocations made before the
+// trace started are skipped, and the streams are not told apart, since the
+// strategies replayed on serve a single stream.
+ReplayResult Replay(const std::vector<alloc::AllocationTraceEvent>& events,
+                    const phi::Place& place,
+                    const Strategy& strategy) {
+  ReplayResult result;
+  std::unordered_map<uint64_t, phi::Allocator::AllocationPtr> live;
+  int64_t allocated = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& event : events) {
+    if (event.is_alloc) {
+      live[event.ptr] = strategy.allocator->Allocate(event.size);
+      allocated += static_cast<int64_t>(event.size);
+      result.peak_allocated = std::max(result.peak_allocated, allocated);
+      result.peak_reserved =
+          std::max(result.peak_reserved, strategy.reserved());
+    } else {
+      auto it = live.find(event.ptr);
+      if (it == live.end()) {
+        continue;
+      }
+      live.erase(it);
+      allocated -= static_cast<int64_t>(event.size);
+    }
+    ++result.num_events;
+  }
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  live.clear();
+  strategy.allocator->Release(place);
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  paddle::flags::ParseCommandLineFlags(&argc, &argv);
+  google::InitGoogleLogging(argv[0]);
+  PADDLE_ENFORCE_EQ(FLAGS_trace.empty(),
+                    false,
+                    common::errors::InvalidArgument(
+                        "The allocation trace is required, set it by "
+                        "--trace."));
+  auto all_events = alloc::AllocationTracer::Load(FLAGS_trace);
+  PADDLE_ENFORCE_EQ(all_events.empty(),
+                    false,
+                    common::errors::InvalidArgument(
+                        "The allocation trace %s is empty.", FLAGS_trace));
+  phi::Place place =
+      FLAGS_place.empty()
+          ? phi::Place(all_events[0].place_type,
+                       static_cast<int8_t>(all_events[0].device_id))
+          : ParsePlace(FLAGS_place);
+  std::vector<alloc::AllocationTraceEvent> events;
+  for (const auto& event : all_events) {
+    if (event.place_type == place.GetType() &&
+        event.device_id == place.GetDeviceId()) {
+      events.push_back(event);
+    }
+  }
+  LOG(INFO) << "Replay " << events.size() << " events of " << place
+            << " from " << FLAGS_trace;
+
+  std::cout << std::left << std::setw(16) << "Strategy" << std::right
+            << std::setw(14) << "Mops/s" << std::setw(18) << "PeakAlloc(MB)"
+            << std::setw(18) << "PeakReserved(MB)" << std::setw(10)
+            << "Frag(%)" << std::endl;
+  std::istringstream names(FLAGS_strategies);
+  std::string name;
+  while (std::getline(names, name, ',')) {
+    Strategy strategy = MakeStrategy(name, place);
+    if (strategy.allocator == nullptr) {
+      LOG(WARNING) << "Skip the strategy " << name << ", which is not "
+                   << "available on " << place;
+      continue;
+    }
+    ReplayResult result = Replay(events, place, strategy);
+    // the share of the reserved memory not serving any allocation at the
+    // peak, i.e. lost to the rounding, the splitting and the caching
+    const double frag =
+        result.peak_reserved > 0
+            ? 100. * (1. - static_cast<double>(result.peak_allocated) /
+                               result.peak_reserved)
+            : 0.;
+    std::cout << std::left << std::setw(16) << name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(14)
+              << result.num_events / result.seconds / 1e6 << std::setw(18)
+              << result.peak_allocated / 1048576. << std::setw(18)
+              << result.peak_reserved / 1048576. << std::setw(10) << frag
+              << std::endl;
+  }
+  return 0;
+}
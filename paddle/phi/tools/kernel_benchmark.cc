@@ -0,0 +1,401 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include "glog/logging.h"
+#include "nlohmann/json.hpp"
+#include "paddle/common/flags.h"
+#include "paddle/common/layout.h"
+#include "paddle/phi/api/lib/kernel_dispatch.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/common/int_array.h"
+#include "paddle/phi/common/scalar.h"
+#include "paddle/phi/core/compat/convert_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/os_info.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/declarations.h"
+
+PD_DEFINE_string(config, "", "The json file of the cases to run.");
+PD_DEFINE_string(baseline, "", "The json file of the baseline results.");
+PD_DEFINE_string(output, "", "The json file to write the results to.");
+PD_DEFINE_string(filter, "", "The op whose cases would be run.");
+PD_DEFINE_int32(burning, 10, "Burning times.");
+PD_DEFINE_int32(repeat, 100, "Repeat times.");
+PD_DEFINE_double(peak_gflops, 0., "The peak GFLOPS of the device.");
+PD_DEFINE_double(peak_gbps, 0., "The peak memory bandwidth in GB/s.");
+PD_DEFINE_double(tolerance,
+                 0.1,
+                 "The relative slowdown over the baseline which is reported "
+                 "as a regression.");
+
+using Json = nlohmann::json;
+
+struct BenchResult {
+  std::string name;
+  double latency_us = 0.;
+  double gflops = 0.;
+  double gbps = 0.;
+};
+
+static std::string ShapeString(const Json& shape) {
+  if (shape.is_null()) {
+    return "none";
+  }
+  std::string str;
+  for (const auto& dim : shape) {
+    str += (str.empty() ? "" : "x") + std::to_string(dim.get<int64_t>());
+  }
+  return str;
+}
+
+// The default name of a case, which is stable when other cases are added
+// to the config, e.g. matmul.float32.gpu.1024x1024,1024x1024
+static std::string CaseName(const Json& spec) {
+  if (spec.contains("name")) {
+    return spec.at("name").get<std::string>();
+  }
+  std::string name = spec.at("op").get<std::string>() + "." +
+                     spec.value("dtype", "float32") + "." +
+                     spec.value("place", "cpu") + ".";
+  const auto& inputs = spec.at("inputs");
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    name += (i == 0 ? "" : ",") + ShapeString(inputs[i]);
+  }
+  return name;
+}
+
+static phi::Backend ParseBackend(const std::string& place) {
+  if (place == "cpu") {
+    return phi::Backend::CPU;
+  } else if (place == "gpu") {
+    return phi::Backend::GPU;
+  } else if (place == "xpu") {
+    return phi::Backend::XPU;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "The place of a case should be cpu, gpu or xpu, but received %s.",
+      place));
+}
+
+template <typename T>
+static void FillRandom(phi::DenseTensor* tensor, std::mt19937* rng) {
+  // the integers are filled with 0 so they are valid indices of any input
+  std::uniform_real_distribution<float> dist(
+      std::is_integral<T>::value ? 0.f : -1.f, 1.f);
+  T* data = tensor->data<T>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = static_cast<T>(std::is_integral<T>::value ? 0.f : dist(*rng));
+  }
+}
+
+static void FillRandom(phi::DenseTensor* tensor, std::mt19937* rng) {
+  switch (tensor->dtype()) {
+    case phi::DataType::FLOAT32:
+      return FillRandom<float>(tensor, rng);
+    case phi::DataType::FLOAT64:
+      return FillRandom<double>(tensor, rng);
+    case phi::DataType::FLOAT16:
+      return FillRandom<phi::dtype::float16>(tensor, rng);
+    case phi::DataType::BFLOAT16:
+      return FillRandom<phi::dtype::bfloat16>(tensor, rng);
+    case phi::DataType::INT64:
+      return FillRandom<int64_t>(tensor, rng);
+    case phi::DataType::INT32:
+      return FillRandom<int32_t>(tensor, rng);
+    case phi::DataType::INT8:
+      return FillRandom<int8_t>(tensor, rng);
+    case phi::DataType::UINT8:
+      return FillRandom<uint8_t>(tensor, rng);
+    case phi::DataType::BOOL:
+      return FillRandom<bool>(tensor, rng);
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "The inputs of %s are not supported.",
+          phi::DataTypeToString(tensor->dtype())));
+  }
+}
+
+static phi::Attribute ParseAttr(const Json& value,
+                                phi::AttributeType type,
+                                phi::Backend backend) {
+  switch (type) {
+    case phi::AttributeType::BOOL:
+      return value.get<bool>();
+    case phi::AttributeType::INT32:
+      return value.get<int>();
+    case phi::AttributeType::INT64:
+      return value.get<int64_t>();
+    case phi::AttributeType::FLOAT32:
+      return value.get<float>();
+    case phi::AttributeType::FLOAT64:
+      return value.get<double>();
+    case phi::AttributeType::STRING:
+      return value.get<std::string>();
+    case phi::AttributeType::BOOLS:
+      return value.get<std::vector<bool>>();
+    case phi::AttributeType::INT32S:
+      return value.get<std::vector<int>>();
+    case phi::AttributeType::INT64S:
+      return value.get<std::vector<int64_t>>();
+    case phi::AttributeType::FLOAT32S:
+      return value.get<std::vector<float>>();
+    case phi::AttributeType::FLOAT64S:
+      return value.get<std::vector<double>>();
+    case phi::AttributeType::STRINGS:
+      return value.get<std::vector<std::string>>();
+    case phi::AttributeType::SCALAR:
+      if (value.is_boolean()) {
+        return phi::Scalar(value.get<bool>());
+      } else if (value.is_number_integer()) {
+        return phi::Scalar(value.get<int64_t>());
+      }
+      return phi::Scalar(value.get<double>());
+    case phi::AttributeType::INT_ARRAY:
+      return phi::IntArray(value.get<std::vector<int64_t>>());
+    case phi::AttributeType::DATA_TYPE:
+      return phi::StringToDataType(value.get<std::string>());
+    case phi::AttributeType::DATA_LAYOUT:
+      return common::StringToDataLayout(value.get<std::string>());
+    case phi::AttributeType::PLACE:
+      return phi::TransToPhiPlace(backend);
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "The attribute of type %d is not supported.",
+          static_cast<int>(type)));
+  }
+}
+
+static BenchResult RunCase(const Json& spec) {
+  BenchResult result;
+  result.name = CaseName(spec);
+  const auto op = spec.at("op").get<std::string>();
+  const auto dtype = phi::StringToDataType(spec.value("dtype", "float32"));
+  const auto backend = ParseBackend(spec.value("place", "cpu"));
+  auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
+      op, phi::KernelKey(backend, phi::DataLayout::ALL_LAYOUT, dtype));
+  PADDLE_ENFORCE_EQ(kernel_result.has_fallback_cpu,
+                    false,
+                    common::errors::Unavailable(
+                        "The %s kernel of %s falls back to CPU.",
+                        spec.value("place", "cpu"),
+                        op));
+  const auto& kernel = kernel_result.kernel;
+  const auto& args_def = kernel.args_def();
+  auto* dev_ctx = paddle::experimental::GetDeviceContextByBackend(backend);
+  auto* cpu_ctx =
+      paddle::experimental::GetDeviceContextByBackend(phi::Backend::CPU);
+  phi::KernelContext ctx(dev_ctx);
+  std::mt19937 rng(100);
+  double nbytes = 0.;
+
+  const auto& inputs = spec.at("inputs");
+  PADDLE_ENFORCE_EQ(inputs.size(),
+                    args_def.input_defs().size(),
+                    common::errors::InvalidArgument(
+                        "The %s kernel takes %d inputs, but %d are given.",
+                        op,
+                        args_def.input_defs().size(),
+                        inputs.size()));
+  std::vector<std::unique_ptr<phi::DenseTensor>> input_tensors;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& type_index = args_def.input_defs()[i].type_index;
+    PADDLE_ENFORCE_EQ(
+        type_index == std::type_index(typeid(phi::DenseTensor)) ||
+            type_index ==
+                std::type_index(typeid(paddle::optional<phi::DenseTensor>)),
+        true,
+        common::errors::Unimplemented(
+            "Only the DenseTensor inputs are supported, but the input %d of "
+            "the %s kernel is not.",
+            i,
+            op));
+    if (inputs[i].is_null()) {
+      ctx.EmplaceBackInput(nullptr);
+      continue;
+    }
+    phi::DenseTensor cpu_tensor;
+    cpu_tensor.Resize(common::make_ddim(inputs[i].get<std::vector<int64_t>>()));
+    cpu_ctx->Alloc(&cpu_tensor, dtype);
+    FillRandom(&cpu_tensor, &rng);
+    auto tensor = std::make_unique<phi::DenseTensor>();
+    phi::Copy(*dev_ctx, cpu_tensor, dev_ctx->GetPlace(), true, tensor.get());
+    nbytes += static_cast<double>(tensor->numel() * phi::SizeOf(dtype));
+    ctx.EmplaceBackInput(tensor.get());
+    input_tensors.emplace_back(std::move(tensor));
+  }
+
+  const Json attrs = spec.value("attrs", Json::array());
+  PADDLE_ENFORCE_EQ(attrs.size(),
+                    args_def.attribute_defs().size(),
+                    common::errors::InvalidArgument(
+                        "The %s kernel takes %d attributes, but %d are given.",
+                        op,
+                        args_def.attribute_defs().size(),
+                        attrs.size()));
+  for (size_t i = 0; i < attrs.size(); ++i) {
+    ctx.EmplaceBackAttr(
+        ParseAttr(attrs[i], args_def.attribute_defs()[i].type_index, backend));
+  }
+
+  // the kernels run without InferMeta, so the outputs are shaped by the
+  // config, or like the first input by default
+  const Json outputs = spec.value("outputs", Json::array());
+  std::vector<std::unique_ptr<phi::DenseTensor>> output_tensors;
+  for (size_t i = 0; i < args_def.output_defs().size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        args_def.output_defs()[i].type_index ==
+            std::type_index(typeid(phi::DenseTensor*)),
+        true,
+        common::errors::Unimplemented(
+            "Only the DenseTensor outputs are supported, but the output %d "
+            "of the %s kernel is not.",
+            i,
+            op));
+    const Json& shape = i < outputs.size() ? outputs[i] : inputs[0];
+    auto tensor = std::make_unique<phi::DenseTensor>();
+    tensor->Resize(common::make_ddim(shape.get<std::vector<int64_t>>()));
+    ctx.EmplaceBackOutput(tensor.get());
+    output_tensors.emplace_back(std::move(tensor));
+  }
+
+  for (int i = 0; i < FLAGS_burning; ++i) {
+    kernel(&ctx);
+  }
+  dev_ctx->Wait();
+  uint64_t start_ns = phi::PosixInNsec();
+  for (int i = 0; i < FLAGS_repeat; ++i) {
+    kernel(&ctx);
+  }
+  dev_ctx->Wait();
+  result.latency_us = static_cast<double>(phi::PosixInNsec() - start_ns) /
+                      1e3 / FLAGS_repeat;
+
+  for (const auto& tensor : output_tensors) {
+    if (tensor->initialized()) {
+      nbytes += static_cast<double>(tensor->numel() *
+                                    phi::SizeOf(tensor->dtype()));
+    }
+  }
+  result.gbps = nbytes / result.latency_us / 1e3;
+  result.gflops = spec.value("flops", 0.) / result.latency_us / 1e3;
+  return result;
+}
+
+static std::string Percent(double value, double peak) {
+  if (peak <= 0.) {
+    return "-";
+  }
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1) << value / peak * 100 << "%";
+  return os.str();
+}
+
+// Benchmark the phi kernels of the cases in a json config, e.g.
+//   {"cases": [{"op": "matmul", "dtype": "float16", "place": "gpu",
+//               "inputs": [[4096, 4096], [4096, 4096]],
+//               "attrs": [false, false],
+//               "outputs": [[4096, 4096]],
+//               "flops": 137438953472}]}
+// The inputs are the shapes of the DenseTensor inputs, null for an optional
+// input which is not given. The attrs follow the order of the kernel
+// arguments. The outputs default to the shape of the first input, and the
+// optional flops give the FLOPs of a run.
+// To use this tool, run command: ./kernel_benchmark --config=... [options...]
+// Options:
+//     --burning: the burning time before count
+//     --repeat: the repeat times
+//     --filter: the op whose cases would be run
+//     --peak_gflops, --peak_gbps: the peaks to report the percent of
+//     --output: write the results to a json file, which can be the baseline
+//     --baseline: compare with the results of a previous run, the cases
+//       slower by --tolerance are reported and fail the run
+int main(int argc, char* argv[]) {
+  paddle::flags::ParseCommandLineFlags(&argc, &argv);
+  google::InitGoogleLogging(argv[0]);
+  PADDLE_ENFORCE_EQ(FLAGS_config.empty(),
+                    false,
+                    common::errors::InvalidArgument(
+                        "The config of the cases is required, set it by "
+                        "--config."));
+  std::ifstream config_file(FLAGS_config);
+  const Json config = Json::parse(config_file);
+  Json baseline;
+  if (!FLAGS_baseline.empty()) {
+    std::ifstream baseline_file(FLAGS_baseline);
+    baseline = Json::parse(baseline_file);
+  }
+  LOG(INFO) << "Burning " << FLAGS_burning << " times, Repeat " << FLAGS_repeat
+            << " times.";
+
+  std::cout << std::left << std::setw(64) << "Case" << std::right
+            << std::setw(14) << "Latency(us)" << std::setw(12) << "GFLOPS"
+            << std::setw(10) << "%Peak" << std::setw(12) << "GB/s"
+            << std::setw(10) << "%Peak" << std::setw(12) << "vs Base"
+            << std::endl;
+  Json output;
+  int regressions = 0;
+  for (const auto& spec : config.at("cases")) {
+    if (!FLAGS_filter.empty() && FLAGS_filter != spec.at("op")) {
+      continue;
+    }
+    BenchResult result = RunCase(spec);
+    output[result.name] = {{"latency_us", result.latency_us},
+                           {"gflops", result.gflops},
+                           {"gbps", result.gbps}};
+    std::string versus = "-";
+    if (baseline.contains(result.name)) {
+      double base = baseline[result.name].at("latency_us").get<double>();
+      double ratio = result.latency_us / base;
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(2) << ratio << "x";
+      versus = os.str();
+      if (ratio > 1. + FLAGS_tolerance) {
+        ++regressions;
+        versus += " !";
+      }
+    }
+    std::cout << std::left << std::setw(64) << result.name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(14)
+              << result.latency_us << std::setw(12) << result.gflops
+              << std::setw(10) << Percent(result.gflops, FLAGS_peak_gflops)
+              << std::setw(12) << result.gbps << std::setw(10)
+              << Percent(result.gbps, FLAGS_peak_gbps) << std::setw(12)
+              << versus << std::endl;
+  }
+
+  if (!FLAGS_output.empty()) {
+    std::ofstream output_file(FLAGS_output);
+    output_file << output.dump(2) << std::endl;
+  }
+  if (regressions > 0) {
+    LOG(ERROR) << regressions << " cases are slower than the baseline by "
+               << "more than " << FLAGS_tolerance * 100 << "%.";
+    return 1;
+  }
+  return 0;
+}
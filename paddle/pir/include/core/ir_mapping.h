@@ -84,11 +84,13 @@ class IrMapping {
   template <typename T>
   IrType<T> Lookup(T from) const {
     if (!from) return static_cast<IrType<T>>(nullptr);
-    PADDLE_ENFORCE_GT(
-        GetMap<IrType<T>>().count(from),
-        0UL,
+    const auto& map = GetMap<IrType<T>>();
+    auto it = map.find(from);
+    PADDLE_ENFORCE_EQ(
+        it != map.end(),
+        true,
         common::errors::InvalidArgument("Not found key in IRMapping."));
-    return GetMap<IrType<T>>().at(from);
+    return it->second;
   }
 
   template <typename T>
@@ -35,6 +35,7 @@ class OpResult;
 namespace detail {
 class OpResultImpl;
 class OpOperandImpl;
+struct OperationArenaChunk;
 }  // namespace detail
 
 class CloneOptions {
@@ -247,6 +248,15 @@ class IR_API alignas(8) Operation final
             uint32_t num_regions,
             uint32_t num_successors);
 
+  // Create the operation, verifying its signature if `verify` is true.
+  static Operation *CreateImpl(const std::vector<pir::Value> &inputs,
+                               const AttributeMap &attributes,
+                               const std::vector<pir::Type> &output_types,
+                               pir::OpInfo op_info,
+                               size_t num_regions,
+                               const std::vector<Block *> &successors,
+                               bool verify);
+
   int32_t ComputeOpResultOffset(uint32_t index) const;
   detail::OpResultImpl *op_result_impl(uint32_t index) const;
 
@@ -293,6 +303,9 @@ class IR_API alignas(8) Operation final
   Region *regions_{nullptr};
   Block *parent_{nullptr};
   Block::Iterator position_;
+
+  // The arena chunk the operation is allocated in, if any.
+  detail::OperationArenaChunk *arena_chunk_{nullptr};
 };
 
 }  // namespace pir
@@ -14,11 +14,12 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <shared_mutex>
 #include <type_traits>
 #include <unordered_map>
 
-#include "paddle/pir/include/core/spin_lock.h"
 #include "paddle/pir/include/core/type_id.h"
 
 namespace pir {
@@ -141,12 +142,12 @@ class IR_API StorageManager {
   std::unordered_map<TypeId, std::unique_ptr<ParametricStorageManager>>
       parametric_instance_;
 
-  pir::SpinLock parametric_instance_lock_;
+  std::shared_mutex parametric_instance_lock_;
 
   // This map is a mapping between type id and parameterless type storage.
   std::unordered_map<TypeId, StorageBase *> parameterless_instance_;
 
-  pir::SpinLock parameterless_instance_lock_;
+  std::shared_mutex parameterless_instance_lock_;
 };
 
 }  // namespace pir
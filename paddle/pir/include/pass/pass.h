@@ -32,7 +32,8 @@ class Operation;
 
 namespace detail {
 class PassAdaptor;
-}
+class FusedPatternRewritePass;
+}  // namespace detail
 
 namespace detail {
 
@@ -161,6 +162,12 @@ class IR_API Pass {
 
   virtual bool CanApplyOn(Operation* op) const;
 
+  // Whether the pass can run concurrently on the sibling operations isolated
+  // from above (see PassManager::EnableParallelExecution). Such a pass must
+  // only modify the IR nested in the operation it runs on, and keep no mutable
+  // state besides its execution state.
+  virtual bool CanRunInParallel() const { return false; }
+
   virtual bool Initialize(IrContext* context) { return true; }
 
   void AddStatistics(int64_t match_count) {
@@ -189,6 +196,7 @@ class IR_API Pass {
 
   friend class PassManager;
   friend class detail::PassAdaptor;
+  friend class detail::FusedPatternRewritePass;
 
   std::unordered_map<std::string, std::any> attrs_;
   std::unordered_map<std::string, std::function<void(void)>> attr_dels_;
@@ -214,6 +222,8 @@ class IR_API PatternRewritePass : public Pass {
   FrozenRewritePatternSet patterns_;
 
   GreedyRewriteConfig config_;
+
+  friend class detail::FusedPatternRewritePass;
 };
 
 }  // namespace pir
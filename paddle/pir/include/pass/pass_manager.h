@@ -115,6 +115,19 @@ class IR_API PassManager {
 
   void AddInstrumentation(std::unique_ptr<PassInstrumentation> pi);
 
+  // Run the pipeline over the sibling operations isolated from above, e.g. the
+  // functions of a module, in parallel with at most num_threads threads (0
+  // means the hardware concurrency). It takes effect only if all the passes
+  // can run in parallel (see Pass::CanRunInParallel). Each operation has its
+  // own analysis manager, and the instrumentations are called serially.
+  void EnableParallelExecution(size_t num_threads = 0);
+
+  // Run the consecutive PatternRewritePasses of the same opt_level and rewrite
+  // config in one greedy traversal, in which the patterns of all the passes
+  // are indexed by their root op. The patterns of a root op are tried in the
+  // order of their benefits, then of the passes.
+  void EnablePatternRewriteFusion() { fuse_pattern_rewrite_ = true; }
+
  private:
   bool Initialize(IrContext *context);
 
@@ -129,8 +142,18 @@ class IR_API PassManager {
 
   bool disable_log_{false};
 
+  size_t num_threads_{1};
+
+  bool fuse_pattern_rewrite_{false};
+
   std::vector<std::unique_ptr<Pass>> passes_;
 
+  // The passes run by the pipeline, which are the passes_ with the fused
+  // pattern rewrite passes in place of the ones they fuse.
+  std::vector<Pass *> pipeline_;
+
+  std::vector<std::unique_ptr<Pass>> fused_passes_;
+
   std::unique_ptr<Pass> pass_adaptor_;
 
   std::unique_ptr<PassInstrumentor> instrumentor_;
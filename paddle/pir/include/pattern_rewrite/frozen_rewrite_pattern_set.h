@@ -49,6 +49,13 @@ class IR_API FrozenRewritePatternSet {
       const std::vector<std::string>& disabled_pattern_labels = {},
       const std::vector<std::string>& enabled_pattern_labels = {});
 
+  /// Merge the op specific patterns of several frozen lists into one, which
+  /// shares the patterns with them. The patterns of a root op keep the order
+  /// of the lists, so that the ones of the same benefit are tried in that
+  /// order. None of the lists may hold "match any" patterns.
+  static FrozenRewritePatternSet Merge(
+      const std::vector<FrozenRewritePatternSet>& pattern_lists);
+
   /// Return the op specific native patterns held by this list.
   const OpSpecificNativePatternListT& op_specific_native_patterns() const {
     return impl_->op_specific_native_pattern_map_;
@@ -66,6 +73,9 @@ class IR_API FrozenRewritePatternSet {
     NativePatternListT op_specific_native_patterns_;
 
     NativePatternListT match_any_op_native_patterns_;
+
+    // The lists whose patterns are shared by a merged list.
+    std::vector<std::shared_ptr<Impl>> merged_impls_;
   };
 
   std::shared_ptr<Impl> impl_;
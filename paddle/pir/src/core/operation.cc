@@ -26,6 +26,7 @@
 #include "paddle/pir/include/core/utils.h"
 #include "paddle/pir/src/core/block_operand_impl.h"
 #include "paddle/pir/src/core/op_result_impl.h"
+#include "paddle/pir/src/core/operation_arena.h"
 
 namespace pir {
 using detail::OpInlineResultImpl;
@@ -57,6 +58,22 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
                              pir::OpInfo op_info,
                              size_t num_regions,
                              const std::vector<Block *> &successors) {
+  return CreateImpl(inputs,
+                    attributes,
+                    output_types,
+                    op_info,
+                    num_regions,
+                    successors,
+                    /*verify=*/true);
+}
+
+Operation *Operation::CreateImpl(const std::vector<Value> &inputs,
+                                 const AttributeMap &attributes,
+                                 const std::vector<Type> &output_types,
+                                 pir::OpInfo op_info,
+                                 size_t num_regions,
+                                 const std::vector<Block *> &successors,
+                                 bool verify) {
   // 1. Calculate the required memory size for OpResults + Operation +
   // OpOperands.
   uint32_t num_results = output_types.size();
@@ -75,9 +92,12 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
   size_t region_mem_size = num_regions * sizeof(Region);
   size_t base_size = result_mem_size + op_mem_size + operand_mem_size +
                      region_mem_size + block_operand_size;
-  // 2. Malloc memory.
-  char *base_ptr =
-      reinterpret_cast<char *>(detail::aligned_malloc(base_size, 8));
+  // 2. Malloc memory, from the arena of the current thread if any.
+  detail::OperationArena *arena = detail::OperationArena::Current();
+  detail::OperationArenaChunk *arena_chunk = nullptr;
+  char *base_ptr = reinterpret_cast<char *>(
+      arena ? arena->Allocate(base_size, &arena_chunk)
+            : detail::aligned_malloc(base_size, 8));
 
   auto name = op_info ? op_info.name() : "";
   VLOG(10) << "Create Operation [" << name
@@ -101,6 +121,7 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
                                            num_operands,
                                            num_regions,
                                            num_successors);
+  op->arena_chunk_ = arena_chunk;
   base_ptr += sizeof(Operation);
   // 3.3. Construct OpOperands.
   if ((reinterpret_cast<uintptr_t>(base_ptr) & 0x7) != 0) {
@@ -128,7 +149,7 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
     }
   }
   // 0. Verify
-  if (op_info) {
+  if (verify && op_info) {
     try {
       op_info.VerifySig(op);
     } catch (const common::enforce::EnforceNotMet &e) {
@@ -159,8 +180,14 @@ Operation *Operation::Clone(IrMapping &ir_mapping, CloneOptions options) const {
       successors.push_back(ir_mapping.Lookup(successor(i)));
     }
   }
-  auto *new_op = Create(
-      inputs, attributes_, output_types, info_, num_regions_, successors);
+  // The signature is the same as the verified one of this op.
+  auto *new_op = CreateImpl(inputs,
+                            attributes_,
+                            output_types,
+                            info_,
+                            num_regions_,
+                            successors,
+                            /*verify=*/false);
   ir_mapping.Add(this, new_op);
 
   // record outputs mapping info
@@ -209,6 +236,7 @@ void Operation::Destroy() {
   }
 
   // 4. Deconstruct Operation.
+  detail::OperationArenaChunk *arena_chunk = arena_chunk_;
   this->~Operation();
 
   // 5. Deconstruct OpOperand.
@@ -238,7 +266,11 @@ void Operation::Destroy() {
 
   VLOG(10) << "Destroy Operation [" << name() << "]: {ptr = " << aligned_ptr
            << ", size = " << result_mem_size << "} done.";
-  detail::aligned_free(aligned_ptr);
+  if (arena_chunk) {
+    detail::OperationArena::Release(arena_chunk);
+  } else {
+    detail::aligned_free(aligned_ptr);
+  }
 }
 
 IrContext *Operation::ir_context() const { return info_.ir_context(); }
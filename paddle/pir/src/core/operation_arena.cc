@@ -0,0 +1,86 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/pir/src/core/operation_arena.h"
+
+#include <algorithm>
+#include <new>
+
+#include "paddle/common/enforce.h"
+#include "paddle/pir/include/core/utils.h"
+
+namespace pir {
+namespace detail {
+
+namespace {
+thread_local OperationArena *current_arena = nullptr;
+}  // namespace
+
+OperationArena::~OperationArena() {
+  if (current_) {
+    Release(current_);
+  }
+}
+
+OperationArenaChunk *OperationArena::NewChunk(size_t capacity) {
+  void *mem = aligned_malloc(OperationArenaChunk::kHeaderSize + capacity,
+                             OperationArenaChunk::kHeaderSize);
+  PADDLE_ENFORCE_NOT_NULL(
+      mem,
+      common::errors::ResourceExhausted(
+          "Failed to allocate %d bytes for the operations.", capacity));
+  auto *chunk = new (mem) OperationArenaChunk();
+  chunk->capacity = capacity;
+  return chunk;
+}
+
+void *OperationArena::Allocate(size_t size, OperationArenaChunk **chunk) {
+  size = (size + 7) / 8 * 8;
+  if (size > chunk_size_ / 4) {
+    // A large operation takes a chunk on its own.
+    *chunk = NewChunk(size);
+    (*chunk)->used = size;
+    return (*chunk)->data();
+  }
+  if (current_ == nullptr || current_->capacity - current_->used < size) {
+    if (current_) {
+      Release(current_);
+    }
+    current_ = NewChunk(chunk_size_);
+  }
+  void *mem = current_->data() + current_->used;
+  current_->used += size;
+  current_->ref_count.fetch_add(1, std::memory_order_relaxed);
+  *chunk = current_;
+  return mem;
+}
+
+void OperationArena::Release(OperationArenaChunk *chunk) {
+  if (chunk->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    chunk->~OperationArenaChunk();
+    aligned_free(chunk);
+  }
+}
+
+OperationArena *OperationArena::Current() { return current_arena; }
+
+OperationArenaScope::OperationArenaScope(OperationArena *arena)
+    : prev_arena_(current_arena) {
+  current_arena = arena;
+}
+
+OperationArenaScope::~OperationArenaScope() { current_arena = prev_arena_; }
+
+}  // namespace detail
+}  // namespace pir
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "paddle/common/macros.h"
+
+namespace pir {
+namespace detail {
+
+///
+/// \brief A chunk of memory shared by the operations allocated in it. It is
+/// freed with the last of them, or with its arena if none is allocated.
+///
+struct OperationArenaChunk {
+  std::atomic<size_t> ref_count{1};
+  size_t capacity{0};
+  size_t used{0};
+
+  char *data() { return reinterpret_cast<char *>(this) + kHeaderSize; }
+
+  static constexpr size_t kHeaderSize = 64;
+};
+
+///
+/// \brief Bump allocator of the operations created together, e.g. by the
+/// clone of a program, which lays them out contiguously instead of allocating
+/// them one by one. The operations may outlive the arena and be destroyed in
+/// any order: a chunk is released by the last operation in it.
+///
+class OperationArena {
+ public:
+  static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+  explicit OperationArena(size_t chunk_size = kDefaultChunkSize)
+      : chunk_size_(chunk_size) {}
+
+  ~OperationArena();
+
+  /// Allocate `size` bytes aligned to 8, the chunk holding them is returned
+  /// in `chunk` and is released by Release(chunk).
+  void *Allocate(size_t size, OperationArenaChunk **chunk);
+
+  static void Release(OperationArenaChunk *chunk);
+
+  /// The arena of the current thread used by Operation::Create, if any.
+  static OperationArena *Current();
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(OperationArena);
+
+  static OperationArenaChunk *NewChunk(size_t capacity);
+
+  size_t chunk_size_;
+
+  OperationArenaChunk *current_{nullptr};
+};
+
+///
+/// \brief Let the operations created by the current thread in the scope be
+/// allocated in the arena.
+///
+class OperationArenaScope {
+ public:
+  explicit OperationArenaScope(OperationArena *arena);
+
+  ~OperationArenaScope();
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(OperationArenaScope);
+
+  OperationArena *prev_arena_;
+};
+
+}  // namespace detail
+}  // namespace pir
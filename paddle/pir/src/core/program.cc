@@ -19,6 +19,7 @@
 #include <unordered_set>
 #include "glog/logging.h"
 #include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/src/core/operation_arena.h"
 
 namespace pir {
 
@@ -67,6 +68,9 @@ std::shared_ptr<Program> Program::Clone(IrMapping& ir_mapping) const {
   pir::IrContext* ctx = pir::IrContext::Instance();
   auto new_program = std::make_shared<Program>(ctx);
   auto clone_options = CloneOptions::All();
+  // Lay out the cloned ops contiguously in the chunks of an arena.
+  detail::OperationArena arena;
+  detail::OperationArenaScope arena_scope(&arena);
 
   // deal kwargs
   for (auto [key, value] : block()->kwargs()) {
@@ -13,6 +13,15 @@
 // limitations under the License.
 
 #include "paddle/pir/include/pass/pass.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include "paddle/pir/include/core/block_argument.h"
 #include "paddle/pir/include/core/ir_context.h"
 #include "paddle/pir/include/core/operation.h"
 #include "paddle/pir/include/core/program.h"
@@ -27,6 +36,46 @@
 
 namespace pir {
 
+namespace {
+// The execution states of the passes run by the current thread if it is a
+// worker of a parallel pass adaptor. The passes are shared by the workers, so
+// their execution states are kept per thread.
+thread_local std::unordered_map<const Pass*,
+                                std::optional<detail::PassExecutionState>>*
+    parallel_pass_states = nullptr;
+
+// Whether the nested ops of the op use no value defined outside of it, so
+// that the passes on the op never touch the use lists of the outer values.
+bool IsIsolatedFromAbove(Operation* op) {
+  std::unordered_set<const Block*> blocks;
+  op->Walk([&](Operation* nested_op) {
+    for (size_t i = 0; i < nested_op->num_regions(); ++i) {
+      for (auto& block : nested_op->region(i)) {
+        blocks.insert(&block);
+      }
+    }
+  });
+  bool is_isolated = true;
+  op->Walk([&](Operation* nested_op) {
+    if (nested_op == op || !is_isolated) return;
+    for (const auto& value : nested_op->operands_source()) {
+      if (!value) continue;
+      const Block* owner = nullptr;
+      if (value.defining_op()) {
+        owner = value.defining_op()->GetParent();
+      } else if (auto arg = value.dyn_cast<BlockArgument>()) {
+        owner = arg.owner();
+      }
+      if (!blocks.count(owner)) {
+        is_isolated = false;
+        return;
+      }
+    }
+  });
+  return is_isolated;
+}
+}  // namespace
+
 //===----------------------------------------------------------------------===//
 // Pass
 //===----------------------------------------------------------------------===//
@@ -43,21 +92,26 @@ Pass::~Pass() {
 bool Pass::CanApplyOn(Operation* op) const { return op->num_regions() > 0; }
 
 std::optional<detail::PassExecutionState>& Pass::pass_state() {
+  if (parallel_pass_states != nullptr) {
+    return (*parallel_pass_states)[this];
+  }
   return pass_state_;
 }
 
 void Pass::SignalPassFailure() {
-  PADDLE_ENFORCE_EQ(pass_state_.has_value(),
+  auto& state = pass_state();
+  PADDLE_ENFORCE_EQ(state.has_value(),
                     true,
                     common::errors::InvalidArgument("pass state has no value"));
-  pass_state_->pass_failed = true;
+  state->pass_failed = true;
 }
 
 AnalysisManager Pass::analysis_manager() {
-  PADDLE_ENFORCE_EQ(pass_state_.has_value(),
+  auto& state = pass_state();
+  PADDLE_ENFORCE_EQ(state.has_value(),
                     true,
                     common::errors::InvalidArgument("pass state has no value"));
-  return pass_state_->am;
+  return state->am;
 }
 //===----------------------------------------------------------------------===//
 // PatternRewritePass
@@ -91,6 +145,81 @@ void PatternRewritePass::Run(Operation* op) {
   AddStatistics(num_rewrites);
 }
 
+//===----------------------------------------------------------------------===//
+// FusedPatternRewritePass
+//===----------------------------------------------------------------------===//
+namespace detail {
+// Run the patterns of several PatternRewritePasses in one greedy traversal.
+class FusedPatternRewritePass final : public Pass {
+ public:
+  explicit FusedPatternRewritePass(std::vector<PatternRewritePass*> passes)
+      : Pass("fused_pattern_rewrite_pass",
+             passes.front()->pass_info().opt_level),
+        passes_(std::move(passes)),
+        config_(passes_.front()->InitializeConfig()) {
+    std::vector<FrozenRewritePatternSet> pattern_lists;
+    for (auto* pass : passes_) {
+      pattern_lists.push_back(pass->patterns_);
+    }
+    patterns_ = FrozenRewritePatternSet::Merge(pattern_lists);
+  }
+
+  static bool CanFuse(PatternRewritePass* lhs, PatternRewritePass* rhs) {
+    const GreedyRewriteConfig lhs_config = lhs->InitializeConfig();
+    const GreedyRewriteConfig rhs_config = rhs->InitializeConfig();
+    return lhs->pass_info().opt_level == rhs->pass_info().opt_level &&
+           lhs_config.use_top_down_traversal ==
+               rhs_config.use_top_down_traversal &&
+           lhs_config.max_iterations == rhs_config.max_iterations &&
+           lhs_config.max_num_rewrites == rhs_config.max_num_rewrites &&
+           lhs_config.region == rhs_config.region &&
+           lhs_config.strict_mode == rhs_config.strict_mode &&
+           lhs->patterns_.match_any_op_native_patterns().empty() &&
+           rhs->patterns_.match_any_op_native_patterns().empty();
+  }
+
+ protected:
+  bool CanApplyOn(Operation* op) const override {
+    return std::any_of(passes_.begin(), passes_.end(), [&](auto* pass) {
+      return pass->CanApplyOn(op);
+    });
+  }
+
+  bool CanRunInParallel() const override {
+    return std::all_of(passes_.begin(), passes_.end(), [](auto* pass) {
+      return pass->CanRunInParallel();
+    });
+  }
+
+  void Run(Operation* op) override {
+    const bool all_apply =
+        std::all_of(passes_.begin(), passes_.end(), [&](auto* pass) {
+          return pass->CanApplyOn(op);
+        });
+    int64_t num_rewrites = 0;
+    if (all_apply) {
+      num_rewrites = ApplyPatternsGreedily(op, patterns_, config_).second;
+    } else {
+      // Some passes do not apply on the op, run the others one by one.
+      for (auto* pass : passes_) {
+        if (pass->CanApplyOn(op)) {
+          num_rewrites += ApplyPatternsGreedily(op, pass->patterns_, config_)
+                              .second;
+        }
+      }
+    }
+    AddStatistics(num_rewrites);
+  }
+
+ private:
+  std::vector<PatternRewritePass*> passes_;
+
+  FrozenRewritePatternSet patterns_;
+
+  GreedyRewriteConfig config_;
+};
+}  // namespace detail
+
 //----------------------------------------------------------------------------------------------//
 // PassAdaptor
 //----------------------------------------------------------------------------------------------//
@@ -103,19 +232,75 @@ void detail::PassAdaptor::RunImpl(Operation* op,
                                   bool verify) {
   auto last_am = analysis_manager();
 
+  // The nested adaptors of the parallel workers run serially.
+  const bool parallel =
+      pm_->num_threads_ > 1 && parallel_pass_states == nullptr &&
+      std::all_of(pm_->pipeline_.begin(),
+                  pm_->pipeline_.end(),
+                  [](const auto* pass) { return pass->CanRunInParallel(); });
+
   for (size_t i = 0; i < op->num_regions(); ++i) {
     auto& region = op->region(i);
     for (auto& block : region) {
+      std::vector<Operation*> isolated_ops;
       for (auto& op : block) {
+        if (parallel && op.num_regions() > 0 && IsIsolatedFromAbove(&op)) {
+          isolated_ops.push_back(&op);
+          continue;
+        }
         AnalysisManagerHolder am(&op, last_am.GetPassInstrumentor());
         if (!RunPipeline(*pm_, &op, am, opt_level, verify))
           return SignalPassFailure();
       }
+      if (!isolated_ops.empty() &&
+          !RunParallel(
+              isolated_ops, last_am.GetPassInstrumentor(), opt_level, verify))
+        return SignalPassFailure();
     }
   }
   return;
 }
 
+bool detail::PassAdaptor::RunParallel(const std::vector<Operation*>& ops,
+                                      PassInstrumentor* instrumentor,
+                                      uint8_t opt_level,
+                                      bool verify) {
+  std::atomic<size_t> next_index{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+  auto worker = [&]() {
+    std::unordered_map<const Pass*, std::optional<PassExecutionState>>
+        pass_states;
+    parallel_pass_states = &pass_states;
+    for (size_t i = next_index++; i < ops.size() && !failed; i = next_index++) {
+      try {
+        AnalysisManagerHolder am(ops[i], instrumentor);
+        if (!RunPipeline(*pm_, ops[i], am, opt_level, verify)) {
+          failed = true;
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(exception_mutex);
+        if (!exception) exception = std::current_exception();
+        failed = true;
+      }
+    }
+    parallel_pass_states = nullptr;
+  };
+
+  const size_t num_threads = std::min(pm_->num_threads_, ops.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (exception) std::rethrow_exception(exception);
+  return !failed;
+}
+
 bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
                                       Operation* op,
                                       AnalysisManager am,
@@ -126,9 +311,9 @@ bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
     instrumentor->RunBeforePipeline(op);
   }
 
-  for (auto& pass : pm.passes()) {
+  for (auto* pass : pm.pipeline_) {
     if (pass->CanApplyOn(op)) {
-      if (!RunPass(pass.get(), op, am, opt_level, verify)) {
+      if (!RunPass(pass, op, am, opt_level, verify)) {
         return false;
       }
     }
@@ -153,7 +338,7 @@ bool detail::PassAdaptor::RunPass(Pass* pass,
                                   bool verify) {
   if (opt_level < pass->pass_info().opt_level) return true;
 
-  pass->pass_state_ = PassExecutionState(op, am);
+  pass->pass_state() = PassExecutionState(op, am);
 
   PassInstrumentor* instrumentor = am.GetPassInstrumentor();
 
@@ -201,9 +386,43 @@ bool PassManager::Initialize(IrContext* context) {
     if (!pass->Initialize(context)) return false;
   }
 
+  pipeline_.clear();
+  fused_passes_.clear();
+  std::vector<PatternRewritePass*> group;
+  auto FlushGroup = [&]() {
+    if (group.size() > 1) {
+      fused_passes_.push_back(
+          std::make_unique<detail::FusedPatternRewritePass>(group));
+      pipeline_.push_back(fused_passes_.back().get());
+    } else if (group.size() == 1) {
+      pipeline_.push_back(group.front());
+    }
+    group.clear();
+  };
+  for (auto& pass : passes()) {
+    auto* pattern_pass = dynamic_cast<PatternRewritePass*>(pass.get());
+    if (!fuse_pattern_rewrite_ || !pattern_pass) {
+      FlushGroup();
+      pipeline_.push_back(pass.get());
+      continue;
+    }
+    if (!group.empty() && !detail::FusedPatternRewritePass::CanFuse(
+                              group.front(), pattern_pass)) {
+      FlushGroup();
+    }
+    group.push_back(pattern_pass);
+  }
+  FlushGroup();
+
   return true;
 }
 
+void PassManager::EnableParallelExecution(size_t num_threads) {
+  num_threads_ = num_threads > 0
+                     ? num_threads
+                     : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
 void PassManager::AddInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
   if (!instrumentor_) instrumentor_ = std::make_unique<PassInstrumentor>();
 
@@ -215,8 +434,9 @@ void PassManager::AddInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
 //----------------------------------------------------------------------------------------------//
 namespace detail {
 struct PassInstrumentorImpl {
-  // TODO(wilber): Support multi-thread.
   std::vector<std::unique_ptr<PassInstrumentation>> instrumentations;
+  // The instrumentations are called serially by the parallel pass adaptors.
+  std::recursive_mutex mutex;
 };
 }  // namespace detail
 
@@ -227,6 +447,7 @@ PassInstrumentor::~PassInstrumentor() = default;
 
 void PassInstrumentor::RunBeforePipeline(Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::recursive_mutex> guard(impl_->mutex);
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforePipeline(op);
   }
@@ -234,6 +455,7 @@ void PassInstrumentor::RunBeforePipeline(Operation* op) {
 
 void PassInstrumentor::RunAfterPipeline(Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::recursive_mutex> guard(impl_->mutex);
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -243,6 +465,7 @@ void PassInstrumentor::RunAfterPipeline(Operation* op) {
 
 void PassInstrumentor::RunBeforePass(Pass* pass, Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::recursive_mutex> guard(impl_->mutex);
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforePass(pass, op);
   }
@@ -250,6 +473,7 @@ void PassInstrumentor::RunBeforePass(Pass* pass, Operation* op) {
 
 void PassInstrumentor::RunAfterPass(Pass* pass, Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::recursive_mutex> guard(impl_->mutex);
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -261,6 +485,7 @@ void PassInstrumentor::RunBeforeAnalysis(const std::string& name,
                                          TypeId id,
                                          Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::recursive_mutex> guard(impl_->mutex);
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforeAnalysis(name, id, op);
   }
@@ -270,6 +495,7 @@ void PassInstrumentor::RunAfterAnalysis(const std::string& name,
                                         TypeId id,
                                         Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::recursive_mutex> guard(impl_->mutex);
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -279,6 +505,7 @@ void PassInstrumentor::RunAfterAnalysis(const std::string& name,
 
 void PassInstrumentor::AddInstrumentation(
     std::unique_ptr<PassInstrumentation> pi) {
+  std::lock_guard<std::recursive_mutex> guard(impl_->mutex);
   impl_->instrumentations.emplace_back(std::move(pi));
 }
 
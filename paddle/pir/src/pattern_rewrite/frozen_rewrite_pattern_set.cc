@@ -20,6 +20,7 @@
 #include <set>
 #include <string>
 
+#include "paddle/common/enforce.h"
 #include "paddle/pir/include/core/op_info.h"
 
 namespace pir {
@@ -97,4 +98,21 @@ FrozenRewritePatternSet::FrozenRewritePatternSet(
   }
 }
 
+FrozenRewritePatternSet FrozenRewritePatternSet::Merge(
+    const std::vector<FrozenRewritePatternSet>& pattern_lists) {
+  FrozenRewritePatternSet merged;
+  for (const auto& pattern_list : pattern_lists) {
+    PADDLE_ENFORCE_EQ(pattern_list.match_any_op_native_patterns().empty(),
+                      true,
+                      common::errors::InvalidArgument(
+                          "The \"match any\" patterns can not be merged."));
+    for (const auto& it : pattern_list.op_specific_native_patterns()) {
+      auto& patterns = merged.impl_->op_specific_native_pattern_map_[it.first];
+      patterns.insert(patterns.end(), it.second.begin(), it.second.end());
+    }
+    merged.impl_->merged_impls_.push_back(pattern_list.impl_);
+  }
+  return merged;
+}
+
 }  // namespace pir
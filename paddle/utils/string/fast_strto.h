@@ -0,0 +1,174 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Drop-in replacements of strtol/strtoull/strtof for the slot text format of
+// the data feeds. The common token shapes (plain decimal integers, decimals
+// without exponent) are parsed in place, results and endptr are bit-exact
+// with the libc functions, every other input falls back to them. `end` is the
+// end of the line; bytes in [str, end) may be read 16/32 at a time, so it must
+// not point past the buffer. The line has to be NUL terminated for fallbacks.
+
+namespace paddle {
+namespace string {
+
+namespace detail {
+
+inline bool is_digit(char c) {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+inline const char* skip_spaces(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) {
+    ++p;
+  }
+  return p;
+}
+
+// number of leading ascii digits of [p, end)
+inline size_t count_digits(const char* p, const char* end) {
+  size_t n = 0;
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_set1_epi8('0');
+  const __m256i nine = _mm256_set1_epi8(9);
+  while (end - (p + n) >= 32) {
+    __m256i d = _mm256_sub_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + n)), zero);
+    uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(d, nine), d)));
+    if (mask != 0) {
+      return n + __builtin_ctz(mask);
+    }
+    n += 32;
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_set1_epi8('0');
+  const __m128i nine = _mm_set1_epi8(9);
+  while (end - (p + n) >= 16) {
+    __m128i d = _mm_sub_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n)), zero);
+    uint32_t mask = ~static_cast<uint32_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, nine),
+                                                         d))) &
+                    0xFFFF;
+    if (mask != 0) {
+      return n + __builtin_ctz(mask);
+    }
+    n += 16;
+  }
+#endif
+  while (p + n < end && is_digit(p[n])) {
+    ++n;
+  }
+  return n;
+}
+
+// value of n <= 19 ascii digits
+inline uint64_t digits_to_uint64(const char* p, size_t n) {
+  uint64_t v = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // eight digits at a time, pairs, then quads, then the two halves
+  for (; n >= 8; n -= 8, p += 8) {
+    uint64_t chunk;
+    memcpy(&chunk, p, 8);
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * 0x000F424000000064ULL) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) *
+              0x0000271000000001ULL)) >>
+            32;
+    v = v * 100000000ULL + chunk;
+  }
+#endif
+  for (; n > 0; --n, ++p) {
+    v = v * 10 + (*p - '0');
+  }
+  return v;
+}
+
+}  // namespace detail
+
+inline uint64_t fast_strtoull(const char* str, const char* end, char** endptr) {
+  const char* p = detail::skip_spaces(str, end);
+  size_t n = detail::count_digits(p, end);
+  if (n == 0 || n > 19) {
+    return strtoull(str, endptr, 10);
+  }
+  *endptr = const_cast<char*>(p + n);
+  return detail::digits_to_uint64(p, n);
+}
+
+inline long fast_strtol(const char* str,  // NOLINT
+                        const char* end,
+                        char** endptr) {
+  const char* p = detail::skip_spaces(str, end);
+  size_t n = detail::count_digits(p, end);
+  if (n == 0 || n > 9) {
+    return strtol(str, endptr, 10);
+  }
+  *endptr = const_cast<char*>(p + n);
+  return static_cast<long>(detail::digits_to_uint64(p, n));  // NOLINT
+}
+
+// [sign]digits[.digits] whose digits form an integer <= 2^24 with at most 10
+// fraction digits: both operands of the division are exact floats, so the
+// quotient is the correctly rounded float strtof returns.
+inline float fast_strtof(const char* str, const char* end, char** endptr) {
+  static constexpr float kPow10[] = {
+      1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+  const char* p = detail::skip_spaces(str, end);
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  const char* int_begin = p;
+  size_t int_n = detail::count_digits(p, end);
+  p += int_n;
+  const char* frac_begin = p;
+  size_t frac_n = 0;
+  if (p < end && *p == '.') {
+    frac_begin = ++p;
+    frac_n = detail::count_digits(p, end);
+    p += frac_n;
+  }
+  if (int_n + frac_n == 0 || int_n + frac_n > 19 || frac_n > 10 ||
+      (p < end && (*p == 'e' || *p == 'E' || *p == 'x' || *p == 'X'))) {
+    return strtof(str, endptr);
+  }
+  uint64_t m = detail::digits_to_uint64(int_begin, int_n);
+  for (size_t i = 0; i < frac_n; ++i) {
+    m = m * 10 + (frac_begin[i] - '0');
+  }
+  if (m > (1ULL << 24)) {
+    return strtof(str, endptr);
+  }
+  *endptr = const_cast<char*>(p);
+  float v = static_cast<float>(m) / kPow10[frac_n];
+  return negative ? -v : v;
+}
+
+}  // namespace string
+}  // namespace paddle
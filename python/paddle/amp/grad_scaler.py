@@ -330,6 +330,7 @@ class AmpScaler:
             else:
                 optimize_ops, params_grads = optimizer.minimize(*args, **kwargs)
                 self._cache_founf_inf = False
+        self._reset_fused_clip(optimizer)
 
         if self._use_dynamic_loss_scaling:
             # update the scale
@@ -379,6 +380,9 @@ class AmpScaler:
                             param_grads_fp32.append(param._grad_ivar())
         else:
             if in_dynamic_mode():
+                if self._fused_unscale_and_clip(optimizer):
+                    optimizer_state["state"] = OptimizerState.UNSCALED
+                    return
                 # It is very time-consuming to call c++ functions in a loop on the python side.
                 # We put this part of the code on the c++ side to improve the speed in eager mode.
                 (
@@ -443,6 +447,36 @@ class AmpScaler:
 
         optimizer_state["state"] = OptimizerState.UNSCALED
 
+    def _fused_unscale_and_clip(self, optimizer):
+        # With ClipGradByGlobalNorm the gradients are unscaled, checked and
+        # clipped by one fused op, instead of check_finite_and_unscale
+        # reading and writing them before the clipping does it again.
+        grad_clip = getattr(optimizer, '_grad_clip', None)
+        if (
+            type(grad_clip) is not paddle.nn.ClipGradByGlobalNorm
+            or not core.is_compiled_with_cuda()
+        ):
+            return False
+        params_grads = []
+        for param in optimizer._parameter_list:
+            grad = param._grad_ivar()
+            if grad is not None:
+                params_grads.append((param, grad))
+        found_inf = grad_clip._fused_unscale_and_clip(
+            params_grads, self._scale
+        )
+        if found_inf is None:
+            return False
+        self._found_inf = found_inf
+        return True
+
+    def _reset_fused_clip(self, optimizer):
+        # The optimizer may skip the step of nan or inf gradients without
+        # clipping them.
+        grad_clip = getattr(optimizer, '_grad_clip', None)
+        if isinstance(grad_clip, paddle.nn.ClipGradByGlobalNorm):
+            grad_clip._skip_next_clip = False
+
     def _update(self):
         """
         Updates the loss_scaling.
@@ -841,6 +875,7 @@ class GradScaler(AmpScaler):
             else:
                 optimizer.step()
                 self._cache_founf_inf = False
+        self._reset_fused_clip(optimizer)
 
         optimizer_state["state"] = OptimizerState.STEPPED
 
@@ -572,6 +572,14 @@ def _enable_auto_recompute():
         return False
 
 
+def _auto_recompute_memory_budget():
+    flag = os.getenv("FLAGS_auto_recompute_memory_budget")
+    if flag:
+        return int(flag)
+    else:
+        return None
+
+
 def _set_prim_forward_blacklist(*args):
     for item in args:
         if not isinstance(item, str):
@@ -626,10 +626,14 @@ class Section(DeviceWorker):
         # then runs Backward phase for all microbatches.
         # 1F1B scheduler, which runs forward phase and backward phase alternatively
         # after startup phase.
-        assert schedule_mode_str in ["F-then-B", "1F1B"], (
-            "The schedule mode " "for pipeline must be one of F-then-B or 1F1B"
+        # ZB-H1 scheduler, which runs like 1F1B but defers the weight gradient
+        # ops of the backward phase to fill the bubbles.
+        schedule_modes = {"F-then-B": 0, "1F1B": 1, "ZB-H1": 2}
+        assert schedule_mode_str in schedule_modes, (
+            "The schedule mode "
+            "for pipeline must be one of F-then-B, 1F1B or ZB-H1"
         )
-        schedule_mode = 0 if schedule_mode_str == "F-then-B" else 1
+        schedule_mode = schedule_modes[schedule_mode_str]
         section_param.schedule_mode = schedule_mode
         cfg = section_param.section_config
         program = pipeline_opt["section_program"]
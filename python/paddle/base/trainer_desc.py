@@ -204,6 +204,9 @@ class TrainerDesc:
     def _set_use_gpu_graph(self, use_gpu_graph=False):
         self.proto_desc.use_gpu_graph = use_gpu_graph
 
+    def _set_numa_binding(self, numa_binding=False):
+        self.proto_desc.numa_binding = numa_binding
+
     def _set_thread_barrier(self, thread_barrier):
         self.proto_desc.thread_barrier = thread_barrier
 
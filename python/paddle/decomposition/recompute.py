@@ -151,6 +151,7 @@ def auto_recompute(
     fwd_op_end_idx: int,
     backward_op_start_idx: int,
     recomputable_ops: Sequence[str] = None,
+    memory_budget: int = None,
 ) -> Tuple[paddle.static.Program, int]:
     '''
     Considering the compiler fuse strategy, we model the pir graph.
@@ -177,6 +178,11 @@ def auto_recompute(
         recomputable_ops(list[str]|tuple(str)|None): The op names that can
             be recomputed. If 'recompute_ops' is None, we will use the
             default recomputable_ops. Default None.
+        memory_budget(int|None): The bytes of the forward values that the
+            backward graph may hold. Within the budget, the values which are
+            the most expensive to recompute are held rather than recomputed.
+            If 'memory_budget' is None, the held values are kept minimal.
+            Default None.
     Returns:
         recomputed_program(Program): The recomputed program.
         fwd_op_end_idx(int): The index of the last forward op in recomputed program.
@@ -423,6 +429,16 @@ def auto_recompute(
     saved_values = cut_value_nodes
     # (TODO: wanghao107): remove it and fix model
     saved_values = cut_value_nodes | inputs
+    if memory_budget is not None:
+        saved_values = fit_saved_values_to_memory_budget(
+            program,
+            saved_values,
+            inputs,
+            outputs,
+            fwd_op_end_idx,
+            backward_op_start_idx,
+            memory_budget,
+        )
     # 2.patition the joint graph by saved values.
     (
         program_after_recompute,
@@ -438,6 +454,81 @@ def auto_recompute(
     return program_after_recompute, fwd_op_end_idx_after_recompute
 
 
+def fit_saved_values_to_memory_budget(
+    program: paddle.static.Program,
+    saved_values: List[pir.Value],
+    inputs: List[pir.Value],
+    outputs: List[pir.Value],
+    fwd_op_end_idx: int,
+    backward_op_start_idx: int,
+    memory_budget: int,
+) -> List[pir.Value]:
+    """
+    Hold the values that backward graph needs but would be recomputed, as long
+    as the held forward values fit in the memory budget. The values are taken
+    in the descending order of the ops to recompute them per byte, so the
+    cheap ones (e.g. elementwise ops) are the ones left to recompute.
+    Args:
+        program(Program): The program to be recomputed.
+        saved_values(list[Value]): The saved values found by min-cut.
+        inputs:(list[Value]|tuple(Value)): The input Values
+            of the forward graph.
+        outputs(list[Value]): The out values of the forward graph.
+        forward_op_end_idx(int): The index of the last forward op.
+        backward_op_start_idx(int): The index of the start backward op.
+        memory_budget(int): The bytes of the forward values that the
+            backward graph may hold.
+    Returns:
+        saved_values(list[Value]): The saved values within the budget.
+    """
+    saved_values = backward_utils.ValueSet(saved_values)
+    inputs = backward_utils.ValueSet(inputs)
+    outputs = backward_utils.ValueSet(outputs)
+    # the inputs and outputs are alive anyway, which are not in the budget
+    held_size = sum(
+        cal_value_node_size(value)
+        for value in saved_values
+        if value not in inputs and value not in outputs
+    )
+    if held_size >= memory_budget:
+        return saved_values
+
+    mid_hold_values = analyze_mid_hold_values(
+        program,
+        saved_values,
+        inputs,
+        outputs,
+        fwd_op_end_idx,
+        backward_op_start_idx,
+    )
+
+    def _num_recompute_ops(value):
+        visited = set()
+        stack = [value]
+        while len(stack) > 0:
+            define_op = stack.pop().get_defining_op()
+            if define_op in visited:
+                continue
+            visited.add(define_op)
+            for op_input in define_op.operands_source():
+                if op_input not in saved_values:
+                    stack.append(op_input)
+        return len(visited)
+
+    candidates = [
+        (_num_recompute_ops(value) / max(cal_value_node_size(value), 1), value)
+        for value in mid_hold_values
+    ]
+    candidates.sort(key=lambda candidate: candidate[0], reverse=True)
+    for _, value in candidates:
+        value_size = cal_value_node_size(value)
+        if held_size + value_size > memory_budget:
+            continue
+        saved_values.add(value)
+        held_size += value_size
+    return saved_values
+
+
 def partition_joint_graph(
     program: paddle.static.Program,
     saved_values: List[pir.Value],
@@ -718,6 +718,70 @@ def reshard(dist_tensor, mesh, placements):
         return out_var
 
 
+def batched_reshard(dist_tensors, meshes, placements):
+    """
+    Reshard many distributed ``paddle.Tensor`` at once, e.g. the parameters
+    after the optimizer step. The tensors changed from ``Partial`` or from
+    ``Shard`` on one mesh dim to ``Replicate`` on the same mesh with the same
+    dtype are resharded by one collective for all of them, the others one by
+    one as ``reshard``. Only supported in dynamic mode, the outputs have no
+    gradient.
+
+    Args:
+        dist_tensors(list[Tensor]): the distributed tensors to be resharded.
+        meshes(paddle.distributed.ProcessMesh|list[paddle.distributed.ProcessMesh]):
+            the mesh of all the outputs, or the mesh of each.
+        placements(list[paddle.distributed.Placement]|list[list[paddle.distributed.Placement]]):
+            the placements of all the outputs, or the placements of each.
+
+    Returns:
+        list[Tensor]: the resharded distributed tensors.
+
+    Examples:
+        .. code-block:: python
+
+            >>> import paddle
+            >>> import paddle.distributed as dist
+            >>> from paddle.distributed.auto_parallel.api import batched_reshard
+
+            >>> mesh = dist.ProcessMesh([0, 1], dim_names=["x"])
+
+            >>> # doctest: +REQUIRES(env:DISTRIBUTED)
+            >>> tensors = [
+            ...     dist.shard_tensor(paddle.ones([10, 20]), mesh, [dist.Partial()])
+            ...     for _ in range(4)
+            ... ]
+            >>> outs = batched_reshard(tensors, mesh, [dist.Replicate()])
+
+    """
+    assert (
+        paddle.framework.in_dynamic_mode()
+    ), "batched_reshard is only supported in dynamic mode."
+    if isinstance(meshes, ProcessMesh):
+        meshes = [meshes] * len(dist_tensors)
+    if len(placements) == 0 or not isinstance(placements[0], (list, tuple)):
+        placements = [placements] * len(dist_tensors)
+    assert len(meshes) == len(dist_tensors) and len(placements) == len(
+        dist_tensors
+    ), "meshes and placements must be given for each tensor."
+
+    dist_attrs = []
+    for tensor, mesh, tensor_placements in zip(
+        dist_tensors, meshes, placements
+    ):
+        sharding_specs = get_shard_spec(mesh, tensor_placements, tensor.ndim)
+        dist_attr = DistAttr(mesh, sharding_specs)
+        partial_dims = [
+            i
+            for i, p in enumerate(tensor_placements)
+            if isinstance(p, dist.Partial)
+        ]
+        if len(partial_dims) > 0:
+            dist_attr._set_partial_dims(partial_dims)
+        dist_attrs.append(dist_attr)
+    return paddle.base.core.batched_reshard(dist_tensors, dist_attrs)
+
+
 def shard_layer(
     layer: nn.Layer,
     process_mesh: ProcessMesh,
@@ -1364,6 +1428,50 @@ class ShardingStage3(_ShardingStageBase):
             new_param = dist.reshard(param, param.process_mesh, new_placements)
             param.get_tensor()._share_data_with(new_param.get_tensor())
 
+    def enable_prefetch(self, layer, prefetch_depth=1):
+        """
+        Gathers the sharded parameters of the sublayers of ``layer`` ahead of
+        their use. When a sublayer starts the forward, the all-gathers of the
+        parameters of the next ``prefetch_depth`` sublayers are issued on the
+        communication stream, and the same in reverse order for the backward.
+        The gathered parameters are freed after the forward of their sublayer
+        and again after their gradients are computed.
+
+        It only works in dynamic mode, and must be called after the optimizer
+        is sharded by ``shard_optimizer``.
+
+        Args:
+            layer(paddle.nn.Layer): The layer the parameters belong to.
+            prefetch_depth(int, optional): The number of sublayers to gather
+                the parameters of ahead. Default: 1.
+
+        Examples:
+            .. code-block:: python
+
+                >>> import paddle
+                >>> import paddle.distributed as dist
+
+                >>> mesh = dist.ProcessMesh([0, 1], dim_names=["x"])
+                >>> # doctest: +REQUIRES(env:DISTRIBUTED)
+                >>> layer = paddle.nn.Sequential(
+                ...     paddle.nn.Linear(8, 8), paddle.nn.Linear(8, 8)
+                ... )
+                >>> opt = paddle.optimizer.AdamW(parameters=layer.parameters())
+                >>> shard_fn = dist.ShardingStage3(mesh)
+                >>> opt = dist.shard_optimizer(opt, shard_fn)
+                >>> shard_fn.enable_prefetch(layer, prefetch_depth=1)
+        """
+        assert (
+            paddle.in_dynamic_mode()
+        ), "Prefetching the parameters only works in dynamic mode."
+        assert (
+            self._sharding_mesh_axis is not None
+        ), "enable_prefetch must be called after shard_optimizer."
+        assert prefetch_depth > 0, "prefetch_depth must be positive."
+        return _ShardingStage3Prefetcher(
+            layer, self._sharding_mesh_axis, prefetch_depth
+        )
+
     def __call__(self, key, param, accumulator):
         if param.is_dist():
             # Only deal with momentum in optimizer, beta should be replicated cross param's mesh
@@ -1390,6 +1498,115 @@ class ShardingStage3(_ShardingStageBase):
         return accumulator
 
 
+class _ShardingStage3Prefetcher:
+    """
+    Schedules the all-gathers of the parameters sharded by ShardingStage3.
+    The gathered copies live in the reshard prefetch cache, the reshard of
+    the operators using the parameters picks them up from there.
+    """
+
+    def __init__(self, layer, sharding_mesh_axis, prefetch_depth):
+        self._sharding_mesh_axis = sharding_mesh_axis
+        self._prefetch_depth = prefetch_depth
+        # the sublayers owning sharded parameters, in the order of the last
+        # forward, the order of definition before the first one
+        self._units = []
+        self._params = {}
+        self._recorded = []
+        for _, sublayer in layer.named_sublayers(include_self=True):
+            params = [
+                param
+                for param in sublayer.parameters(include_sublayers=False)
+                if self._is_sharded(param)
+            ]
+            if len(params) == 0:
+                continue
+            self._units.append(sublayer)
+            self._params[id(sublayer)] = [
+                (param, self._gathered_dist_attr(param)) for param in params
+            ]
+            sublayer.register_forward_pre_hook(self._pre_forward)
+            sublayer.register_forward_post_hook(self._post_forward)
+            for param in params:
+                param.register_hook(self._release_hook(param))
+        self._index = {id(unit): i for i, unit in enumerate(self._units)}
+        layer.register_forward_pre_hook(self._begin_forward)
+        layer.register_forward_post_hook(self._end_forward)
+
+    def _is_sharded(self, param):
+        return (
+            param.is_dist()
+            and not param.stop_gradient
+            and isinstance(
+                param.placements[self._sharding_mesh_axis], dist.Shard
+            )
+        )
+
+    def _gathered_dist_attr(self, param):
+        placements = param.placements
+        placements[self._sharding_mesh_axis] = dist.Replicate()
+        sharding_specs = get_shard_spec(
+            param.process_mesh, placements, param.ndim
+        )
+        return DistAttr(param.process_mesh, sharding_specs)
+
+    def _prefetch(self, index):
+        if index < 0 or index >= len(self._units):
+            return
+        for param, dist_attr in self._params[id(self._units[index])]:
+            core.reshard_prefetch(param, dist_attr)
+
+    def _release(self, unit):
+        for param, _ in self._params[id(unit)]:
+            core.reshard_prefetch_release(param)
+
+    def _release_hook(self, param):
+        def hook(grad):
+            # the gathered copy is used for the last time
+            core.reshard_prefetch_release(param)
+
+        return hook
+
+    def _begin_forward(self, layer, inputs):
+        # the parameters are updated in place by the optimizer
+        core.reshard_prefetch_clear()
+        self._recorded = []
+        self._prefetch(0)
+
+    def _end_forward(self, layer, inputs, outputs):
+        if len(self._recorded) == len(self._units):
+            self._units = self._recorded
+            self._index = {id(unit): i for i, unit in enumerate(self._units)}
+
+    def _pre_forward(self, layer, inputs):
+        if all(unit is not layer for unit in self._recorded):
+            self._recorded.append(layer)
+        index = self._index[id(layer)]
+        for i in range(index, index + self._prefetch_depth + 1):
+            self._prefetch(i)
+
+    def _post_forward(self, layer, inputs, outputs):
+        index = self._index[id(layer)]
+        # the last one is the first to be used again by the backward
+        if index != len(self._units) - 1:
+            self._release(layer)
+        if isinstance(outputs, paddle.Tensor):
+            outputs = [outputs]
+        elif not isinstance(outputs, (list, tuple)):
+            return
+        for output in outputs:
+            if isinstance(output, paddle.Tensor) and not output.stop_gradient:
+                output.register_hook(self._pre_backward_hook(index))
+                break
+
+    def _pre_backward_hook(self, index):
+        def hook(grad):
+            for i in range(index, index - self._prefetch_depth - 1, -1):
+                self._prefetch(i)
+
+        return hook
+
+
 def shard_optimizer(optimizer, shard_fn=None):
     """
 
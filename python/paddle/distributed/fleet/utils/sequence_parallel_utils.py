@@ -424,6 +424,118 @@ class SPInnerOverlapLinear(paddle.autograd.PyLayer):
                 return dx, dw, dbias
 
 
+def _ring_exchange(send, group, reverse=False):
+    # sends to the next rank of the ring and receives from the previous one,
+    # or the other way around
+    rank, nranks = group.rank, group.nranks
+    step = -1 if reverse else 1
+    recv = paddle.empty_like(send)
+    ops = [
+        dist.P2POp(
+            dist.isend, send, group.ranks[(rank + step) % nranks], group
+        ),
+        dist.P2POp(
+            dist.irecv, recv, group.ranks[(rank - step) % nranks], group
+        ),
+    ]
+    return recv, dist.batch_isend_irecv(ops)
+
+
+def _matmul(x, weight, transpose_y=False):
+    if weight.dtype != x.dtype:
+        weight = paddle.cast(weight, dtype=x.dtype)
+    return paddle.matmul(x, weight, transpose_y=transpose_y)
+
+
+def all_gather_matmul(x, weight, group, transpose_y=False):
+    # The chunks of x go around the ring, and each chunk is multiplied while
+    # the next one is on the way. Returns the product and the gathered x.
+    rank, nranks = group.rank, group.nranks
+    chunks = [None] * nranks
+    outs = [None] * nranks
+    chunk = x
+    for step in range(nranks):
+        src = (rank - step) % nranks
+        chunks[src] = chunk
+        if step < nranks - 1:
+            next_chunk, tasks = _ring_exchange(chunk, group)
+        outs[src] = _matmul(chunk, weight, transpose_y)
+        if step < nranks - 1:
+            for task in tasks:
+                task.wait()
+            chunk = next_chunk
+    return paddle.concat(outs, axis=0), paddle.concat(chunks, axis=0)
+
+
+def matmul_reduce_scatter(x, weight, group, transpose_y=False):
+    # The partial sums go around the ring the other way, and each rank adds
+    # the product of the chunk of the next step while the last partial sum is
+    # on the way, so the rank ends with the sum of its own chunk.
+    rank, nranks = group.rank, group.nranks
+    assert (
+        x.shape[0] % nranks == 0
+    ), f"Input sequence length {x.shape[0]} can't be divided exactly by sequence parallelism {nranks}"
+    chunks = paddle.split(x, nranks, axis=0)
+    tasks = []
+    for step in range(nranks):
+        chunk = chunks[(rank + step + 1) % nranks]
+        partial = _matmul(chunk, weight, transpose_y)
+        if step > 0:
+            for task in tasks:
+                task.wait()
+            partial = partial + recv
+        if step < nranks - 1:
+            recv, tasks = _ring_exchange(partial, group, reverse=True)
+    return partial
+
+
+def _linear_weight_grad(x, dy):
+    x = x.reshape([-1, x.shape[-1]])
+    dy = dy.reshape([-1, dy.shape[-1]])
+    return paddle.matmul(x, dy, transpose_x=True)
+
+
+# All gather then matmul during forward pass, matmul then reduce scatter
+# during backward pass, both overlapped chunk by chunk
+class AllGatherMatmulOp(PyLayer):
+    # input shape: [s/n, b, h], weight shape: [h, o/n]
+    # after forward shape: [s, b, o/n]
+    @staticmethod
+    def forward(ctx, x, weight, group):
+        _check_environment_for_overlap()
+        output, input_parallel = all_gather_matmul(x, weight, group)
+        ctx.group = group
+        ctx.save_for_backward(weight, input_parallel)
+        return output
+
+    @staticmethod
+    def backward(ctx, dy):
+        weight, input_parallel = ctx.saved_tensor()
+        dx = matmul_reduce_scatter(dy, weight, ctx.group, transpose_y=True)
+        return dx, _linear_weight_grad(input_parallel, dy)
+
+
+# Matmul then reduce scatter during forward pass, all gather then matmul
+# during backward pass, both overlapped chunk by chunk
+class MatmulReduceScatterOp(PyLayer):
+    # input shape: [s, b, h/n], weight shape: [h/n, o]
+    # after forward shape: [s/n, b, o]
+    @staticmethod
+    def forward(ctx, x, weight, group):
+        _check_environment_for_overlap()
+        ctx.group = group
+        ctx.save_for_backward(x, weight)
+        return matmul_reduce_scatter(x, weight, group)
+
+    @staticmethod
+    def backward(ctx, dy):
+        x, weight = ctx.saved_tensor()
+        dx, dy_parallel = all_gather_matmul(
+            dy, weight, ctx.group, transpose_y=True
+        )
+        return dx, _linear_weight_grad(x, dy_parallel)
+
+
 class ColumnSequenceParallelLinear(Layer):
     def __init__(
         self,
@@ -519,6 +631,9 @@ class ColumnSequenceParallelLinear(Layer):
         self.mp_async_allreduce = mp_configs.mp_async_allreduce
         self.sp_async_reduce_scatter = mp_configs.sp_async_reduce_scatter
         self.recompute_allgather = mp_configs.recompute_allgather
+        self.sp_overlap_collective_matmul = (
+            mp_configs.sp_overlap_collective_matmul
+        )
 
         self.mp_fused_linear_param_grad_add = (
             self.mp_async_allreduce
@@ -527,7 +642,13 @@ class ColumnSequenceParallelLinear(Layer):
 
     def forward(self, x):
         # sequence parallel is same as tensor parallel, if sequence parallel is true, input shape is [s, b, h], else input shape is [b, s, h]
-        if self.sp_async_reduce_scatter:
+        if self.sp_overlap_collective_matmul:
+            output = AllGatherMatmulOp.apply(
+                x, self.weight, self.model_parallel_group
+            )
+            if self.bias is not None:
+                output = output + self.bias
+        elif self.sp_async_reduce_scatter:
             output = SPInnerOverlapLinear.apply(
                 x,
                 self.weight,
@@ -657,9 +778,23 @@ class RowSequenceParallelLinear(Layer):
             if self.is_mp and has_bias:
                 self.mp_scale = MPScale.apply
 
+        mp_configs = fleet.fleet._user_defined_strategy.hybrid_configs[
+            "mp_configs"
+        ]
+        self.sp_overlap_collective_matmul = (
+            mp_configs.sp_overlap_collective_matmul
+        )
+
     def forward(self, x):
         input_parallel = x
-        if self.is_mp:
+        if self.is_mp and self.sp_overlap_collective_matmul:
+            output = MatmulReduceScatterOp.apply(
+                input_parallel, self.weight, self.model_parallel_group
+            )
+            # the bias is all_reduced by the sequence parallel hooks
+            if self.bias is not None:
+                output = output + self.bias
+        elif self.is_mp:
             if self.mp_scale is not None:
                 bias = self.mp_scale(self.bias, self.world_size)
             else:
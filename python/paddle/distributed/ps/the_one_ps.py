@@ -768,6 +768,18 @@ class SparseTable(Table):
             )
         if usr_table_proto.HasField("use_gpu_graph"):
             table_proto.use_gpu_graph = usr_table_proto.use_gpu_graph
+        if usr_table_proto.HasField("bucket_group_num"):
+            table_proto.bucket_group_num = usr_table_proto.bucket_group_num
+        if usr_table_proto.HasField("enable_incremental_save"):
+            table_proto.enable_incremental_save = (
+                usr_table_proto.enable_incremental_save
+            )
+        if usr_table_proto.HasField("admit_count"):
+            table_proto.admit_count = usr_table_proto.admit_count
+        if usr_table_proto.HasField("admit_sketch_width"):
+            table_proto.admit_sketch_width = usr_table_proto.admit_sketch_width
+        if usr_table_proto.HasField("incremental_shrink"):
+            table_proto.incremental_shrink = usr_table_proto.incremental_shrink
 
         table_proto.accessor.ParseFromString(
             usr_table_proto.accessor.SerializeToString()
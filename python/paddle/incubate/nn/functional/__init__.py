@@ -17,11 +17,14 @@ from .block_multihead_attention import (
     block_multihead_attention,
     block_multihead_attention_xpu,  # noqa: F401
 )
+from .fp8 import fp8_amax_and_scale_update, fused_fp8_cast_transpose
+from .fused_beam_search_step import fused_beam_search_step
 from .fused_dot_product_attention import (
     cudnn_flash_attention,  # noqa: F401
     fused_dot_product_attention,  # noqa: F401
 )
 from .fused_dropout_add import fused_dropout_add
+from .fused_elementwise_chain import fused_elementwise_chain
 from .fused_ec_moe import fused_ec_moe
 from .fused_gate_attention import fused_gate_attention  # noqa: F401
 from .fused_layer_norm import fused_layer_norm
@@ -31,6 +34,8 @@ from .fused_matmul_bias import (
     fused_matmul_bias,
 )
 from .fused_moe import fused_moe
+from .fused_multi_lora_linear import fused_multi_lora_linear
+from .fused_qkv_rope_cache import fused_qkv_rope_cache
 from .fused_rms_norm import fused_rms_norm
 from .fused_rotary_position_embedding import fused_rotary_position_embedding
 from .fused_transformer import (
@@ -40,6 +45,10 @@ from .fused_transformer import (
     fused_multi_transformer,
 )
 from .masked_multihead_attention import masked_multihead_attention
+from .speculate_verify import (
+    speculate_tree_mask_start_row_indices,
+    speculate_verify,
+)
 from .swiglu import swiglu
 from .variable_length_memory_efficient_attention import (
     variable_length_memory_efficient_attention,
@@ -64,4 +73,12 @@ __all__ = [
     "blha_get_max_len",
     "block_multihead_attention",
     "swiglu",
+    "fused_fp8_cast_transpose",
+    "fp8_amax_and_scale_update",
+    "fused_elementwise_chain",
+    "fused_multi_lora_linear",
+    "fused_beam_search_step",
+    "fused_qkv_rope_cache",
+    "speculate_verify",
+    "speculate_tree_mask_start_row_indices",
 ]
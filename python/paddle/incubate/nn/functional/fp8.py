@@ -0,0 +1,288 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import paddle
+from paddle import _C_ops
+from paddle.autograd import PyLayer
+
+from ....framework import LayerHelper, in_dynamic_or_pir_mode
+
+if TYPE_CHECKING:
+    from paddle import Tensor
+
+E4M3_MAX = 448.0
+E5M2_MAX = 57344.0
+
+
+def fused_fp8_cast_transpose(
+    x: Tensor,
+    scale: Tensor,
+    amax_history: Tensor,
+    out_dtype: str = "float8_e4m3fn",
+    transpose: bool = True,
+    name: str | None = None,
+) -> tuple[Tensor, Tensor | None]:
+    """
+    Casts x to fp8 with a per-tensor scale, and records the amax of x into
+    ``amax_history[0]`` in place, for the delayed scaling of FP8 training.
+    The values are saturated to the range of ``out_dtype``.
+
+    Args:
+        x (Tensor): The input Tensor of at least 2 dimensions, the data type is float32, float16 or bfloat16.
+        scale (Tensor): The float32 scale of shape [1]. The output is ``x * scale``.
+        amax_history (Tensor): The float32 amax history of shape [history_len]. It is updated in place.
+        out_dtype (str, optional): float8_e4m3fn or float8_e5m2. Default: float8_e4m3fn.
+        transpose (bool, optional): Whether to output the transposed fp8 Tensor as well, which is of
+            shape [x.shape[-1], x.numel() / x.shape[-1]]. Default: True.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        A tuple of the fp8 Tensor and its transpose, which is None if transpose is False.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> x = paddle.randn([64, 32], dtype='bfloat16')
+            >>> scale = paddle.ones([1], dtype='float32')
+            >>> amax_history = paddle.zeros([16], dtype='float32')
+            >>> out, out_t = F.fused_fp8_cast_transpose(x, scale, amax_history)
+            >>> print(out.shape, out_t.shape)
+            [64, 32] [32, 64]
+    """
+    if in_dynamic_or_pir_mode():
+        out, out_t, _ = _C_ops.fused_fp8_cast_transpose_(
+            x, scale, amax_history, out_dtype, transpose
+        )
+        return out, out_t if transpose else None
+
+    helper = LayerHelper('fused_fp8_cast_transpose', **locals())
+    out = helper.create_variable_for_type_inference(dtype=out_dtype)
+    outputs = {'out': out, 'amax_history_out': amax_history}
+    out_t = None
+    if transpose:
+        out_t = helper.create_variable_for_type_inference(dtype=out_dtype)
+        outputs['out_t'] = out_t
+    helper.append_op(
+        type='fused_fp8_cast_transpose',
+        inputs={'x': x, 'scale': scale, 'amax_history': amax_history},
+        outputs=outputs,
+        attrs={'out_dtype': out_dtype, 'transpose': transpose},
+    )
+    return out, out_t
+
+
+def fp8_amax_and_scale_update(
+    amax_history: Tensor,
+    scale: Tensor,
+    fp8_max: float,
+    margin: float = 0.0,
+    amax_compute_algo: str = "max",
+    name: str | None = None,
+) -> Tensor:
+    """
+    Updates the delayed scale of FP8 training in place from the amax history,
+    as ``scale = fp8_max / amax / 2 ** margin``. Then the history is rolled by
+    one, so that ``amax_history[0]`` is zero for the amax of the next step.
+    The scale is kept if the amax is zero or not finite.
+
+    Args:
+        amax_history (Tensor): The float32 amax history of shape [history_len]. It is updated in place.
+        scale (Tensor): The float32 scale of shape [1]. It is updated in place.
+        fp8_max (float): The max value of the fp8 type, 448 for float8_e4m3fn and 57344 for float8_e5m2.
+        margin (float, optional): The margin of the scale as a power of 2. Default: 0.0.
+        amax_compute_algo (str, optional): max to use the max of the history, most_recent to use
+            ``amax_history[0]``. Default: max.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        The float32 reciprocal of the updated scale, of shape [1].
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> amax_history = paddle.to_tensor([2.0, 4.0, 1.0], dtype='float32')
+            >>> scale = paddle.ones([1], dtype='float32')
+            >>> scale_inv = F.fp8_amax_and_scale_update(amax_history, scale, 448.0)
+            >>> print(scale.numpy(), amax_history.numpy())
+            [112.] [0. 2. 4.]
+    """
+    if in_dynamic_or_pir_mode():
+        _, _, scale_inv = _C_ops.fp8_amax_and_scale_update_(
+            amax_history, scale, fp8_max, margin, amax_compute_algo
+        )
+        return scale_inv
+
+    helper = LayerHelper('fp8_amax_and_scale_update', **locals())
+    scale_inv = helper.create_variable_for_type_inference(dtype='float32')
+    helper.append_op(
+        type='fp8_amax_and_scale_update',
+        inputs={'amax_history': amax_history, 'scale': scale},
+        outputs={
+            'amax_history_out': amax_history,
+            'scale_out': scale,
+            'scale_inv_out': scale_inv,
+        },
+        attrs={
+            'fp8_max': fp8_max,
+            'margin': margin,
+            'amax_compute_algo': amax_compute_algo,
+        },
+    )
+    return scale_inv
+
+
+class FP8TensorMeta:
+    """
+    The delayed scaling state of one fp8 tensor: its scale, the reciprocal of
+    the scale and its amax history.
+    """
+
+    def __init__(self, amax_history_len: int, fp8_dtype: str) -> None:
+        self.fp8_dtype = fp8_dtype
+        self.fp8_max = E4M3_MAX if fp8_dtype == "float8_e4m3fn" else E5M2_MAX
+        self.scale = paddle.ones([1], dtype='float32')
+        self.scale_inv = paddle.ones([1], dtype='float32')
+        self.amax_history = paddle.zeros([amax_history_len], dtype='float32')
+
+    def update(self, margin: float, amax_compute_algo: str) -> None:
+        self.scale_inv = fp8_amax_and_scale_update(
+            self.amax_history,
+            self.scale,
+            self.fp8_max,
+            margin,
+            amax_compute_algo,
+        )
+
+    def cast(self, x: Tensor, transpose: bool) -> tuple[Tensor, Tensor | None]:
+        return fused_fp8_cast_transpose(
+            x, self.scale, self.amax_history, self.fp8_dtype, transpose
+        )
+
+
+def _fp8_gemm(x, x_scale_inv, y, y_scale_inv, output_dtype, bias=None):
+    # out = x @ y^T, as cuBLASLt only runs the fp8 GEMMs in this layout.
+    return paddle.linalg.fp8_fp8_half_gemm_fused(
+        x,
+        y,
+        transpose_x=False,
+        transpose_y=True,
+        bias=bias,
+        output_dtype=output_dtype,
+        x_scale_inv=x_scale_inv,
+        y_scale_inv=y_scale_inv,
+    )
+
+
+class _FP8LinearFunction(PyLayer):
+    @staticmethod
+    def forward(ctx, x, weight, bias, fp8_state):
+        x_meta, w_meta, _ = fp8_state.metas
+        recipe = fp8_state.recipe
+        x_meta.update(recipe.margin, recipe.amax_compute_algo)
+        w_meta.update(recipe.margin, recipe.amax_compute_algo)
+
+        output_dtype = 'bfloat16' if x.dtype == paddle.bfloat16 else 'float16'
+        in_features, out_features = weight.shape
+        x_2d = x.reshape([-1, in_features])
+        # The transposes are the operands of the grad GEMMs.
+        x_fp8, x_t_fp8 = x_meta.cast(x_2d, not weight.stop_gradient)
+        w_fp8, w_t_fp8 = w_meta.cast(weight, True)
+        out = _fp8_gemm(
+            x_fp8,
+            x_meta.scale_inv,
+            w_t_fp8,
+            w_meta.scale_inv,
+            output_dtype,
+            bias,
+        )
+
+        ctx.fp8_state = fp8_state
+        ctx.output_dtype = output_dtype
+        ctx.x_shape = x.shape
+        ctx.weight_dtype = weight.dtype
+        ctx.has_bias = bias is not None
+        ctx.x_scale_inv = x_meta.scale_inv
+        ctx.w_scale_inv = w_meta.scale_inv
+        ctx.save_for_backward(x_t_fp8, w_fp8)
+        return out.reshape([*x.shape[:-1], out_features])
+
+    @staticmethod
+    def backward(ctx, dout):
+        x_t_fp8, w_fp8 = ctx.saved_tensor()
+        grad_meta = ctx.fp8_state.metas[2]
+        recipe = ctx.fp8_state.recipe
+        grad_meta.update(recipe.margin, recipe.amax_compute_algo)
+
+        dout_2d = dout.reshape([-1, dout.shape[-1]])
+        dout_fp8, dout_t_fp8 = grad_meta.cast(dout_2d, x_t_fp8 is not None)
+        # dx = dout @ w^T, w_fp8 of [in_features, out_features] is the y^T.
+        dx = _fp8_gemm(
+            dout_fp8,
+            grad_meta.scale_inv,
+            w_fp8,
+            ctx.w_scale_inv,
+            ctx.output_dtype,
+        ).reshape(ctx.x_shape)
+        dw = None
+        if x_t_fp8 is not None:
+            # dw = x^T @ dout.
+            dw = _fp8_gemm(
+                x_t_fp8,
+                ctx.x_scale_inv,
+                dout_t_fp8,
+                grad_meta.scale_inv,
+                ctx.output_dtype,
+            ).astype(ctx.weight_dtype)
+        if ctx.has_bias:
+            return dx, dw, dout_2d.sum(axis=0)
+        return dx, dw
+
+
+def fp8_linear(
+    x: Tensor,
+    weight: Tensor,
+    bias: Tensor | None,
+    fp8_state,
+    name: str | None = None,
+) -> Tensor:
+    """
+    The linear of FP8 training with the delayed scaling. x, weight and the
+    output grad are cast to fp8 with the scales of ``fp8_state``, which are
+    updated from their amax histories before each cast. The GEMMs run in fp8
+    and output in the data type of x.
+
+    Only used in dynamic mode, through :ref:`api_paddle_incubate_nn_FP8Linear`.
+
+    Args:
+        x (Tensor): The input Tensor of [..., in_features], the data type is float16 or bfloat16.
+        weight (Tensor): The weight of [in_features, out_features].
+        bias (Tensor|None): The bias of [out_features], of the data type of x.
+        fp8_state: The FP8 state holding ``recipe`` and ``metas``, which are
+            the FP8TensorMeta of x, weight and the output grad.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        Tensor of [..., out_features].
+    """
+    return _FP8LinearFunction.apply(x, weight, bias, fp8_state)
@@ -0,0 +1,109 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_or_pir_mode
+
+if TYPE_CHECKING:
+    from paddle import Tensor
+
+
+def fused_beam_search_step(
+    logits: Tensor,
+    beam_scores: Tensor,
+    finished: Tensor,
+    beam_size: int,
+    end_id: int,
+) -> tuple[Tensor, Tensor, Tensor, Tensor]:
+    """
+    Apply a step of the beam search in a fused kernel: the log_softmax of the
+    logits, the top ``beam_size`` over the ``beam_size * vocab_size``
+    candidates of each batch and the indices to reorder the caches by. All
+    the states stay on the device, so a decoding loop needs no host sync.
+
+    A finished beam only extends itself by ``end_id`` and keeps its score. At
+    the first step, pass ``beam_scores`` as ``[0, -inf, ..., -inf]`` for each
+    batch so the identical beams are not selected repeatedly.
+
+    Args:
+        logits (Tensor): The logits of the step, of shape
+            ``[batch_size * beam_size, vocab_size]``, whose data type is
+            float32, float16 or bfloat16. ``beam_size`` should not be
+            greater than 16.
+        beam_scores (Tensor): The accumulated log probabilities of the beams,
+            of shape ``[batch_size * beam_size]`` and data type float32.
+        finished (Tensor): Whether the beams are finished, of shape
+            ``[batch_size * beam_size]`` and data type bool.
+        beam_size (int): The beam size.
+        end_id (int): The id of the end token.
+
+    Returns:
+        tuple of Tensor, ``(next_ids, next_scores, parent_idx, next_finished)``
+        of shape ``[batch_size * beam_size]``. ``next_ids`` (int64) are the
+        selected tokens, ``next_scores`` (float32) the scores of the new
+        beams, ``parent_idx`` (int32) the row of the beam each new beam
+        extends, to gather the caches by, and ``next_finished`` (bool) the
+        finished states of the new beams.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fused_beam_search_step
+            >>> paddle.device.set_device('gpu')
+
+            >>> batch_size, beam_size, vocab_size = 2, 4, 100
+            >>> logits = paddle.randn([batch_size * beam_size, vocab_size])
+            >>> beam_scores = paddle.zeros([batch_size * beam_size])
+            >>> finished = paddle.zeros([batch_size * beam_size], dtype='bool')
+            >>> ids, scores, parent_idx, finished = fused_beam_search_step(
+            ...     logits, beam_scores, finished, beam_size, end_id=0
+            ... )
+            >>> print(ids.shape)
+            [8]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.fused_beam_search_step(
+            logits, beam_scores, finished, beam_size, end_id
+        )
+
+    helper = LayerHelper('fused_beam_search_step', **locals())
+    next_ids = helper.create_variable_for_type_inference(dtype="int64")
+    next_scores = helper.create_variable_for_type_inference(dtype="float32")
+    parent_idx = helper.create_variable_for_type_inference(dtype="int32")
+    next_finished = helper.create_variable_for_type_inference(dtype="bool")
+
+    inputs = {
+        'logits': logits,
+        'beam_scores': beam_scores,
+        'finished': finished,
+    }
+    outputs = {
+        'next_ids': next_ids,
+        'next_scores': next_scores,
+        'parent_idx': parent_idx,
+        'next_finished': next_finished,
+    }
+    helper.append_op(
+        type='fused_beam_search_step',
+        inputs=inputs,
+        outputs=outputs,
+        attrs={'beam_size': beam_size, 'end_id': end_id},
+    )
+    return next_ids, next_scores, parent_idx, next_finished
@@ -0,0 +1,94 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING, Sequence
+
+from paddle import _C_ops
+
+from ....framework import LayerHelper, in_dynamic_or_pir_mode
+
+if TYPE_CHECKING:
+    from paddle import Tensor
+
+BINARY_OPS = ('add', 'subtract', 'multiply', 'divide', 'maximum', 'minimum')
+UNARY_OPS = ('relu', 'gelu', 'silu', 'sigmoid', 'tanh', 'scale')
+
+
+def fused_elementwise_chain(
+    x: Sequence[Tensor],
+    ops: Sequence[str],
+    scales: Sequence[float] | None = None,
+    name: str | None = None,
+) -> Tensor:
+    """
+    Computes a chain of broadcast elementwise ops in a single kernel, which
+    keeps the intermediate results in registers instead of writing each of
+    them to the global memory.
+
+    The chain starts from ``x[0]``. Each binary op of ``ops``, one of
+    ``add``, ``subtract``, ``multiply``, ``divide``, ``maximum`` and
+    ``minimum``, takes the next Tensor of ``x`` as its other operand. Each
+    ``scale`` op multiplies by the next value of ``scales``. The other ops,
+    ``relu``, ``gelu``, ``silu``, ``sigmoid`` and ``tanh``, take no
+    operand. The inputs are broadcast like ``paddle.add``.
+
+    Args:
+        x (list|tuple of Tensor): 1 to 4 Tensors of the same data type, float32, float64, float16 or bfloat16.
+        ops (list|tuple of str): At most 16 ops, the number of the binary ops should be ``len(x) - 1``.
+        scales (list|tuple of float, optional): The factors of the ``scale`` ops. Default: None.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        Tensor, the result of the chain, whose shape is the broadcast shape of ``x``.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> x = paddle.randn([8, 1024])
+            >>> bias = paddle.randn([1024])
+            >>> gate = paddle.randn([8, 1024])
+            >>> # gelu((x + bias) * gate) * 0.5
+            >>> out = F.fused_elementwise_chain(
+            ...     [x, bias, gate], ['add', 'multiply', 'gelu', 'scale'], [0.5]
+            ... )
+            >>> print(out.shape)
+            [8, 1024]
+    """
+    x = list(x)
+    ops = list(ops)
+    scales = [float(s) for s in scales] if scales is not None else []
+    for op in ops:
+        if op not in BINARY_OPS + UNARY_OPS:
+            raise ValueError(
+                f"The op {op} is not supported by fused_elementwise_chain, "
+                f"it should be one of {BINARY_OPS + UNARY_OPS}."
+            )
+
+    if in_dynamic_or_pir_mode():
+        return _C_ops.fused_elementwise_chain(x, ops, scales)
+
+    helper = LayerHelper('fused_elementwise_chain', **locals())
+    out = helper.create_variable_for_type_inference(dtype=x[0].dtype)
+    helper.append_op(
+        type='fused_elementwise_chain',
+        inputs={'x': x},
+        outputs={'out': out},
+        attrs={'ops': ops, 'scales': scales},
+    )
+    return out
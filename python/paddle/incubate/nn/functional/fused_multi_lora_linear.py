@@ -0,0 +1,102 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+from paddle import _C_ops
+
+from ....framework import LayerHelper, in_dynamic_or_pir_mode
+
+if TYPE_CHECKING:
+    from paddle import Tensor
+
+
+def fused_multi_lora_linear(
+    x: Tensor,
+    lora_a: Tensor,
+    lora_b: Tensor,
+    seg_offsets: Tensor,
+    adapter_ids: Tensor,
+    base_out: Tensor | None = None,
+    scaling: float = 1.0,
+    name: str | None = None,
+) -> Tensor:
+    """
+    Adds the LoRA updates of many adapters to a linear layer in one batch,
+    where the rows of ``x`` are grouped into segments and each segment takes
+    its own adapter, so the requests of different fine-tuned variants of a
+    model share the base weights in a batch.
+
+    The rows of ``x`` in ``[seg_offsets[s], seg_offsets[s + 1])`` compute
+    ``base_out + scaling * (x @ lora_a[i].T) @ lora_b[i]`` with
+    ``i = adapter_ids[s]``. The rows of a segment whose adapter is negative,
+    or of no segment, output ``base_out`` only.
+
+    Args:
+        x (Tensor): The input of the linear layer, of the shape ``[..., in_features]``.
+        lora_a (Tensor): The stacked LoRA A weights of the shape ``[adapter_num, rank, in_features]``.
+        lora_b (Tensor): The stacked LoRA B weights of the shape ``[adapter_num, rank, out_features]``.
+        seg_offsets (Tensor): The int32 row offsets of the segments, of the shape ``[segment_num + 1]``.
+        adapter_ids (Tensor): The int32 adapter of each segment, of the shape ``[segment_num]``.
+        base_out (Tensor, optional): The output of the base linear layer, of the shape ``[..., out_features]``. Default: None.
+        scaling (float, optional): The scaling of the LoRA updates. Default: 1.0.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        Tensor, of the shape ``[..., out_features]``.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> x = paddle.randn([6, 64])
+            >>> weight = paddle.randn([64, 32])
+            >>> lora_a = paddle.randn([4, 8, 64])
+            >>> lora_b = paddle.randn([4, 8, 32])
+            >>> # rows 0-1 take adapter 3, rows 2-5 take adapter 0
+            >>> seg_offsets = paddle.to_tensor([0, 2, 6], dtype='int32')
+            >>> adapter_ids = paddle.to_tensor([3, 0], dtype='int32')
+            >>> out = F.fused_multi_lora_linear(
+            ...     x, lora_a, lora_b, seg_offsets, adapter_ids, x @ weight
+            ... )
+            >>> print(out.shape)
+            [6, 32]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.fused_multi_lora_linear(
+            x, lora_a, lora_b, seg_offsets, adapter_ids, base_out, scaling
+        )
+
+    helper = LayerHelper('fused_multi_lora_linear', **locals())
+    out = helper.create_variable_for_type_inference(dtype=x.dtype)
+    inputs = {
+        'x': x,
+        'lora_a': lora_a,
+        'lora_b': lora_b,
+        'seg_offsets': seg_offsets,
+        'adapter_ids': adapter_ids,
+    }
+    if base_out is not None:
+        inputs['base_out'] = base_out
+    helper.append_op(
+        type='fused_multi_lora_linear',
+        inputs=inputs,
+        outputs={'out': out},
+        attrs={'scaling': scaling},
+    )
+    return out
@@ -0,0 +1,175 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_or_pir_mode
+
+if TYPE_CHECKING:
+    from paddle import Tensor
+
+
+def fused_qkv_rope_cache(
+    qkv: Tensor,
+    key_cache: Tensor,
+    value_cache: Tensor,
+    position_ids: Tensor,
+    block_tables: Tensor,
+    q_num_head: int,
+    kv_num_head: int,
+    qkv_bias: Tensor | None = None,
+    sin: Tensor | None = None,
+    cos: Tensor | None = None,
+    cache_k_quant_scales: Tensor | None = None,
+    cache_v_quant_scales: Tensor | None = None,
+    use_neox_rotary_style: bool = True,
+    rotary_emb_base: float = 10000.0,
+    quant_round_type: int = 1,
+    quant_max_bound: float = 127.0,
+    quant_min_bound: float = -127.0,
+) -> Tensor:
+    """
+    Prepare the attention of a decoding step in one kernel: add the bias of
+    the qkv, apply the rotary position embedding to q and k, and append k and
+    v of the token to the paged caches, optionally quantized to int8. Only q
+    is written out, the caches are updated in place.
+
+    The rotary embedding is the one of
+    ``paddle.incubate.nn.functional.fused_rotary_position_embedding``, and the
+    caches are laid out as the ones of ``block_multihead_attention``.
+
+    Args:
+        qkv (Tensor): The qkv of the step, one token per sequence, of shape
+            ``[batch_size, (q_num_head + 2 * kv_num_head) * head_dim]``.
+        key_cache (Tensor): The key cache, of shape
+            ``[max_block_num, kv_num_head, block_size, head_dim]``.
+        value_cache (Tensor): The value cache, of the shape of ``key_cache``.
+        position_ids (Tensor): The positions of the tokens in their
+            sequences, of shape ``[batch_size]`` and data type int64. A
+            negative position marks a stopped sequence, whose caches are left
+            as is and whose q is zero.
+        block_tables (Tensor): The physical blocks of the sequences, of shape
+            ``[batch_size, max_blocks_per_seq]`` and data type int32.
+        q_num_head (int): The number of the query heads.
+        kv_num_head (int): The number of the key / value heads.
+        qkv_bias (Tensor, optional): The bias of the qkv, of shape
+            ``[(q_num_head + 2 * kv_num_head) * head_dim]``.
+        sin (Tensor, optional): The sin table, of shape
+            ``[max_seq_len, head_dim]``. Computed from ``rotary_emb_base``
+            when ``sin`` and ``cos`` are None.
+        cos (Tensor, optional): The cos table, of the shape of ``sin``.
+        cache_k_quant_scales (Tensor, optional): The float32 scales of the key
+            heads, of shape ``[kv_num_head]``. The caches are uint8 when the
+            scales are given.
+        cache_v_quant_scales (Tensor, optional): The float32 scales of the
+            value heads, of shape ``[kv_num_head]``.
+        use_neox_rotary_style (bool, optional): Whether to rotate the halves
+            of the heads instead of the adjacent pairs. Default: True.
+        rotary_emb_base (float, optional): The base of the rotary embedding.
+            Default: 10000.0.
+        quant_round_type (int, optional): 0 rounds half to even, 1 rounds half
+            away from zero. Default: 1.
+        quant_max_bound (float, optional): Default: 127.0.
+        quant_min_bound (float, optional): Default: -127.0.
+
+    Returns:
+        Tensor, the rotated q of shape ``[batch_size, q_num_head, head_dim]``.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fused_qkv_rope_cache
+            >>> paddle.device.set_device('gpu')
+
+            >>> bsz, q_num_head, kv_num_head, head_dim, block_size = 2, 8, 2, 64, 16
+            >>> qkv = paddle.randn([bsz, (q_num_head + 2 * kv_num_head) * head_dim], dtype='float16')
+            >>> key_cache = paddle.zeros([4, kv_num_head, block_size, head_dim], dtype='float16')
+            >>> value_cache = paddle.zeros_like(key_cache)
+            >>> position_ids = paddle.to_tensor([3, 17], dtype='int64')
+            >>> block_tables = paddle.to_tensor([[0, 1], [2, 3]], dtype='int32')
+            >>> q = fused_qkv_rope_cache(
+            ...     qkv, key_cache, value_cache, position_ids, block_tables,
+            ...     q_num_head, kv_num_head
+            ... )
+            >>> print(q.shape)
+            [2, 8, 64]
+    """
+    if in_dynamic_or_pir_mode():
+        q_out, _, _ = _C_ops.fused_qkv_rope_cache_(
+            qkv,
+            key_cache,
+            value_cache,
+            position_ids,
+            block_tables,
+            qkv_bias,
+            sin,
+            cos,
+            cache_k_quant_scales,
+            cache_v_quant_scales,
+            q_num_head,
+            kv_num_head,
+            use_neox_rotary_style,
+            rotary_emb_base,
+            quant_round_type,
+            quant_max_bound,
+            quant_min_bound,
+        )
+        return q_out
+
+    helper = LayerHelper('fused_qkv_rope_cache', **locals())
+    q_out = helper.create_variable_for_type_inference(dtype=qkv.dtype)
+
+    inputs = {
+        'qkv': qkv,
+        'key_cache': key_cache,
+        'value_cache': value_cache,
+        'position_ids': position_ids,
+        'block_tables': block_tables,
+    }
+    if qkv_bias is not None:
+        inputs['qkv_bias'] = qkv_bias
+    if sin is not None:
+        inputs['sin'] = sin
+    if cos is not None:
+        inputs['cos'] = cos
+    if cache_k_quant_scales is not None:
+        inputs['cache_k_quant_scales'] = cache_k_quant_scales
+    if cache_v_quant_scales is not None:
+        inputs['cache_v_quant_scales'] = cache_v_quant_scales
+
+    outputs = {
+        'q_out': q_out,
+        'key_cache_out': key_cache,
+        'value_cache_out': value_cache,
+    }
+    helper.append_op(
+        type='fused_qkv_rope_cache',
+        inputs=inputs,
+        outputs=outputs,
+        attrs={
+            'q_num_head': q_num_head,
+            'kv_num_head': kv_num_head,
+            'use_neox_rotary_style': use_neox_rotary_style,
+            'rotary_emb_base': rotary_emb_base,
+            'quant_round_type': quant_round_type,
+            'quant_max_bound': quant_max_bound,
+            'quant_min_bound': quant_min_bound,
+        },
+    )
+    return q_out
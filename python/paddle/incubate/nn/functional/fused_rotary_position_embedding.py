@@ -13,11 +13,42 @@
 # limitations under the License.
 
 
+import paddle
 from paddle import _C_ops
 from paddle.base.layer_helper import LayerHelper
 from paddle.framework import in_dynamic_or_pir_mode
 
 
+def _packed_sin_cos(q, sin, cos, cu_seqlens, time_major, rotary_emb_base):
+    # the position of each token in its own sequence, counted from the
+    # cu_seqlens of the packed batch
+    seq_axis = 0 if time_major else 1
+    total_tokens = q.shape[seq_axis]
+    if total_tokens < 0:
+        total_tokens = paddle.shape(q)[seq_axis]
+    cu_seqlens = cu_seqlens.astype('int64')
+    tokens = paddle.arange(total_tokens, dtype='int64')
+    seq_ids = paddle.searchsorted(cu_seqlens, tokens, right=True) - 1
+    position_ids = tokens - paddle.gather(cu_seqlens, seq_ids)
+
+    head_dim = q.shape[-1]
+    if sin is None or cos is None:
+        # the sin and cos the kernel computes with rotary_emb_base, for every
+        # two adjacent numbers
+        indices = paddle.arange(0, head_dim, 2, dtype='float32')
+        inv_freq = 1.0 / rotary_emb_base ** (indices / head_dim)
+        positions = position_ids.astype('float32').unsqueeze(1)
+        freqs = positions * inv_freq.unsqueeze(0)
+        freqs = paddle.repeat_interleave(freqs, 2, axis=1)
+        sin = paddle.sin(freqs).astype(q.dtype)
+        cos = paddle.cos(freqs).astype(q.dtype)
+        return sin, cos
+    # gathered per token, so the table only has to cover the longest sequence
+    sin = paddle.index_select(sin.reshape([-1, head_dim]), position_ids)
+    cos = paddle.index_select(cos.reshape([-1, head_dim]), position_ids)
+    return sin, cos
+
+
 def fused_rotary_position_embedding(
     q,
     k=None,
@@ -28,6 +59,7 @@ def fused_rotary_position_embedding(
     use_neox_rotary_style=True,
     time_major=False,
     rotary_emb_base=10000.0,
+    cu_seqlens=None,
 ):
     r"""
     Fused rotary position embedding.
@@ -42,6 +74,7 @@ def fused_rotary_position_embedding(
         use_neox_rotary_style(optional|bool): When the use_neox_rotary_style is True, every two adjacent numbers are calculated. When the use_neox_rotary_style is False, the numbers corresponding to the positions of the front half and back half segments are calculated. Default True.
         time_major(optional|bool): Whether the first dimension of the q, k, v input means the time steps. If time_major is True, the shape of Tensor is [seq_len, batch_size, num_heads, head_dim], otherwise [batch_size, seq_len, num_heads, head_dime]. Defaults to False. `time_steps` means the length of input sequence.
         rotary_emb_base(optional|float): the base of the rotary embedding. Default 10000.
+        cu_seqlens (Tensor, optional): The cumulative sequence lengths of a packed batch, of shape [num_seqs + 1] and data type int32 or int64, as in :func:`paddle.nn.functional.flash_attention.flash_attn_unpadded`. When it is given, the batch_size of q, k and v must be 1 and the seq_len holds the tokens of all the sequences back to back, the positions restarting from 0 at each sequence. position_ids must be None, and sin and cos, if given, only have to cover the longest sequence. The row-wise fused_bias_dropout_residual_layer_norm and fused_feedforward take the packed tokens as they are, so a whole transformer block runs without padding. Default None.
 
     Returns:
         out_q/out_k/out_v Tensor representing the fused rotary position embedding, has same shape and data type as `q` .
@@ -99,6 +132,19 @@ def fused_rotary_position_embedding(
             use_neox_rotary_style
         ), "rotate_half without sin/cos is not correctly supported now."
 
+    if cu_seqlens is not None:
+        assert (
+            position_ids is None
+        ), "position_ids should be None when cu_seqlens is given."
+        batch_size = q.shape[1] if time_major else q.shape[0]
+        assert batch_size in (
+            1,
+            -1,
+        ), f"The batch_size of a packed q should be 1, but got {batch_size}."
+        sin, cos = _packed_sin_cos(
+            q, sin, cos, cu_seqlens, time_major, rotary_emb_base
+        )
+
     if in_dynamic_or_pir_mode():
         return _C_ops.fused_rotary_position_embedding(
             q,
@@ -36,6 +36,10 @@ def masked_multihead_attention(
     quant_round_type=1,
     quant_max_bound=127.0,
     quant_min_bound=-127.0,
+    cache_k_quant_scales=None,
+    cache_v_quant_scales=None,
+    cache_k_dequant_scales=None,
+    cache_v_dequant_scales=None,
 ):
     r"""
     Masked Multi-head attention for text summarization.
@@ -61,6 +65,10 @@ def masked_multihead_attention(
         quant_round_type (int, optional): The quant_round_type, used in quant. Default 1.
         quant_max_bound (float, optional): The quant_max_bound, used in quant. Default 127.0.
         quant_min_bound (float, optional): The quant_min_bound, used in quant. Default -127.0.
+        cache_k_quant_scales (Tensor, optional): The quant scales of the key cache, used when cache_kv is an int8 cache of dtype uint8. Its shape is [kv_num_head].
+        cache_v_quant_scales (Tensor, optional): The quant scales of the value cache, used when cache_kv is an int8 cache of dtype uint8. Its shape is [kv_num_head].
+        cache_k_dequant_scales (Tensor, optional): The dequant scales of the key cache, used when cache_kv is an int8 cache of dtype uint8. Its shape is [kv_num_head].
+        cache_v_dequant_scales (Tensor, optional): The dequant scales of the value cache, used when cache_kv is an int8 cache of dtype uint8. Its shape is [kv_num_head].
 
     Returns:
         Tensor|tuple: If "beam_cache_offset_out" is not none, return the
@@ -103,6 +111,10 @@ def masked_multihead_attention(
             qkv_out_scale,
             out_shift,
             out_smooth,
+            cache_k_quant_scales,
+            cache_v_quant_scales,
+            cache_k_dequant_scales,
+            cache_v_dequant_scales,
             seq_len,
             rotary_emb_dims,
             use_neox_rotary_style,
@@ -152,6 +164,14 @@ def masked_multihead_attention(
         inputs['out_shift'] = out_shift
     if out_smooth is not None:
         inputs['out_smooth'] = out_smooth
+    if cache_k_quant_scales is not None:
+        inputs['cache_k_quant_scales'] = cache_k_quant_scales
+    if cache_v_quant_scales is not None:
+        inputs['cache_v_quant_scales'] = cache_v_quant_scales
+    if cache_k_dequant_scales is not None:
+        inputs['cache_k_dequant_scales'] = cache_k_dequant_scales
+    if cache_v_dequant_scales is not None:
+        inputs['cache_v_dequant_scales'] = cache_v_dequant_scales
 
     outputs = {
         'out': out,
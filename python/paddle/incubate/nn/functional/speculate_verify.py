@@ -0,0 +1,172 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import paddle
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_or_pir_mode
+
+if TYPE_CHECKING:
+    from collections.abc import Sequence
+
+    from paddle import Tensor
+
+
+def speculate_verify(
+    draft_tokens: Tensor,
+    target_tokens: Tensor,
+    draft_parents: Tensor,
+) -> tuple[Tensor, Tensor, Tensor]:
+    """
+    Verify the draft tokens of speculative decoding against the tokens the
+    target model generates in one forward over the verification window.
+
+    The window of a sequence holds its last committed token (row 0) followed
+    by the ``num_draft`` draft nodes (row ``i + 1`` for node ``i``). The nodes
+    form a tree rooted at the committed token, a chain being the tree whose
+    node ``i`` is the parent of node ``i + 1``. Starting from row 0, the
+    child drafting the token the target model generates is accepted and the
+    walk goes on from it. The token the target model generates after the
+    last accepted row is appended as the bonus token, so at least one token
+    is accepted per step.
+
+    Args:
+        draft_tokens (Tensor): The draft tokens, of shape
+            ``[batch_size, num_draft]`` and data type int32 or int64.
+        target_tokens (Tensor): The tokens the target model generates after
+            each row of the window, i.e. the argmax of its logits, of shape
+            ``[batch_size, num_draft + 1]`` and the data type of
+            ``draft_tokens``.
+        draft_parents (Tensor): The parent node of each draft node, -1 for
+            the children of the committed token, of shape
+            ``[batch_size, num_draft]`` and data type int32. A parent comes
+            before its children.
+
+    Returns:
+        tuple of Tensor, ``(accept_tokens, accept_num, accept_index)``.
+        ``accept_tokens`` of shape ``[batch_size, num_draft + 1]`` holds the
+        accepted tokens followed by the bonus token, padded with -1, and
+        ``accept_num`` (int32) of shape ``[batch_size]`` their number.
+        ``accept_index`` (int32) of shape ``[batch_size, num_draft + 1]``
+        holds the ``accept_num`` rows of the window whose key and value stay
+        in the cache, padded with -1. The rows of the rejected nodes are
+        rolled back.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import speculate_verify
+            >>> paddle.device.set_device('gpu')
+
+            >>> draft_tokens = paddle.to_tensor([[5, 7, 9]], dtype='int64')
+            >>> target_tokens = paddle.to_tensor([[5, 7, 2, 4]], dtype='int64')
+            >>> draft_parents = paddle.to_tensor([[-1, 0, 1]], dtype='int32')
+            >>> tokens, num, index = speculate_verify(
+            ...     draft_tokens, target_tokens, draft_parents
+            ... )
+            >>> print(num.numpy())
+            [3]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.speculate_verify(
+            draft_tokens, target_tokens, draft_parents
+        )
+
+    helper = LayerHelper('speculate_verify', **locals())
+    accept_tokens = helper.create_variable_for_type_inference(
+        dtype=draft_tokens.dtype
+    )
+    accept_num = helper.create_variable_for_type_inference(dtype="int32")
+    accept_index = helper.create_variable_for_type_inference(dtype="int32")
+
+    inputs = {
+        'draft_tokens': draft_tokens,
+        'target_tokens': target_tokens,
+        'draft_parents': draft_parents,
+    }
+    outputs = {
+        'accept_tokens': accept_tokens,
+        'accept_num': accept_num,
+        'accept_index': accept_index,
+    }
+    helper.append_op(
+        type='speculate_verify',
+        inputs=inputs,
+        outputs=outputs,
+    )
+    return accept_tokens, accept_num, accept_index
+
+
+def speculate_tree_mask_start_row_indices(
+    draft_parents: Sequence[int],
+    prefix_len: int,
+    batch_size: int = 1,
+    num_heads: int = 1,
+) -> Tensor:
+    """
+    Build the ``attn_mask_start_row_indices`` of
+    :func:`paddle.nn.functional.flash_attention.flash_attention_with_sparse_mask`
+    for the verification window of a draft tree, so the target model
+    verifies all the draft nodes in one causal forward.
+
+    The window is the last committed token followed by the draft nodes, see
+    :func:`speculate_verify`, after ``prefix_len`` cached tokens. A node
+    attends to the prefix, the committed token and its ancestors. The nodes
+    should be in depth first order, where the subtree of each node is
+    contiguous, so every column is masked from the end of its subtree on.
+    A chain masks nothing beyond the causal mask.
+
+    Args:
+        draft_parents (Sequence[int]): The parent node of each draft node,
+            -1 for the children of the committed token.
+        prefix_len (int): The number of the tokens before the window.
+        batch_size (int, optional): The batch size of the result. Default 1.
+        num_heads (int, optional): The number of heads of the result.
+            Default 1.
+
+    Returns:
+        Tensor of shape ``[batch_size, num_heads, prefix_len + num_draft +
+        1]`` and data type int32, the rows counted over the whole sequence.
+    """
+    parents = [int(p) for p in draft_parents]
+    num_draft = len(parents)
+    # depth first order: the parent of a node is the previous node or one
+    # of its ancestors
+    for i, p in enumerate(parents):
+        ancestor = i - 1
+        while ancestor != p and ancestor >= 0:
+            ancestor = parents[ancestor]
+        if ancestor != p:
+            raise ValueError(
+                f"The draft nodes should be in depth first order, but the "
+                f"parent {p} of node {i} is not an ancestor of node {i - 1}."
+            )
+    subtree_size = [1] * num_draft
+    for i in reversed(range(num_draft)):
+        if parents[i] >= 0:
+            subtree_size[parents[i]] += subtree_size[i]
+
+    seq_len = prefix_len + num_draft + 1
+    start_rows = [seq_len] * (prefix_len + 1)
+    for i in range(num_draft):
+        start_rows.append(prefix_len + i + 1 + subtree_size[i])
+    start_rows = paddle.to_tensor(start_rows, dtype="int32")
+    return start_rows.reshape([1, 1, seq_len]).expand(
+        [batch_size, num_heads, seq_len]
+    )
@@ -0,0 +1,223 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import contextlib
+import math
+
+import paddle
+from paddle.base import core
+from paddle.base.framework import _dygraph_tracer
+from paddle.incubate.nn.functional.fp8 import FP8TensorMeta, fp8_linear
+from paddle.nn import Layer
+from paddle.nn import functional as F
+
+
+class DelayedScaling:
+    r"""
+    The recipe of the delayed scaling of FP8 training. The scale of each fp8
+    tensor is computed from the amaxes of it in the previous steps, as
+    :math:`scale = fp8\_max / amax / 2^{margin}`.
+
+    Parameters:
+        margin (float, optional): The margin of the scale as a power of 2. Default: 0.0.
+        amax_history_len (int, optional): The number of steps of the amax history. Default: 16.
+        amax_compute_algo (str, optional): max to use the max of the history, most_recent to use
+            the amax of the last step. Default: max.
+        fp8_format (str, optional): HYBRID to use float8_e4m3fn for the forward tensors and
+            float8_e5m2 for the grads, E4M3 to use float8_e4m3fn for all. Default: HYBRID.
+    """
+
+    def __init__(
+        self,
+        margin=0.0,
+        amax_history_len=16,
+        amax_compute_algo="max",
+        fp8_format="HYBRID",
+    ):
+        if amax_compute_algo not in ("max", "most_recent"):
+            raise ValueError(
+                f"amax_compute_algo should be max or most_recent, but got {amax_compute_algo}."
+            )
+        if fp8_format not in ("HYBRID", "E4M3"):
+            raise ValueError(
+                f"fp8_format should be HYBRID or E4M3, but got {fp8_format}."
+            )
+        self.margin = margin
+        self.amax_history_len = amax_history_len
+        self.amax_compute_algo = amax_compute_algo
+        self.fp8_format = fp8_format
+
+    @property
+    def fwd_dtype(self):
+        return "float8_e4m3fn"
+
+    @property
+    def bwd_dtype(self):
+        return "float8_e5m2" if self.fp8_format == "HYBRID" else "float8_e4m3fn"
+
+
+_fp8_recipe = None
+
+
+@contextlib.contextmanager
+def fp8_autocast(enabled=True, fp8_recipe=None):
+    """
+    The context of FP8 training, like paddle.amp.auto_cast does for the half
+    precision. The FP8Linear layers in it run in fp8 with the delayed scaling,
+    and the others are not affected. It is usually nested in paddle.amp.auto_cast
+    so that the inputs of FP8Linear are in float16 or bfloat16.
+
+    Parameters:
+        enabled (bool, optional): Whether to enable FP8. Default: True.
+        fp8_recipe (DelayedScaling, optional): The recipe of the scaling. Default: None,
+            which means DelayedScaling().
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn import FP8Linear, fp8_autocast
+
+            >>> linear = FP8Linear(64, 32)
+            >>> x = paddle.randn([16, 64])
+            >>> with paddle.amp.auto_cast(dtype='bfloat16'):
+            ...     with fp8_autocast():
+            ...         y = linear(x)
+            >>> print(y.shape)
+            [16, 32]
+    """
+    global _fp8_recipe
+    old_recipe = _fp8_recipe
+    if enabled:
+        _fp8_recipe = fp8_recipe if fp8_recipe is not None else DelayedScaling()
+    else:
+        _fp8_recipe = None
+    try:
+        yield
+    finally:
+        _fp8_recipe = old_recipe
+
+
+class _FP8State:
+    def __init__(self, recipe):
+        self.recipe = recipe
+        self.metas = (
+            FP8TensorMeta(recipe.amax_history_len, recipe.fwd_dtype),
+            FP8TensorMeta(recipe.amax_history_len, recipe.fwd_dtype),
+            FP8TensorMeta(recipe.amax_history_len, recipe.bwd_dtype),
+        )
+
+    def match(self, recipe):
+        return (
+            self.recipe.amax_history_len == recipe.amax_history_len
+            and self.recipe.fp8_format == recipe.fp8_format
+        )
+
+
+class FP8Linear(Layer):
+    r"""
+    Linear layer for FP8 training. In :ref:`api_paddle_incubate_nn_fp8_autocast`,
+    the input, the weight and the output grad are cast to fp8 with the delayed
+    scaling, and the GEMMs of the forward and backward run in fp8 through
+    cuBLASLt. Otherwise, it is the same as paddle.nn.Linear.
+
+    FP8 needs CUDA 12.1 and the compute capability 8.9 or above, the input of
+    float16 or bfloat16, and in_features, out_features and the number of the
+    input rows of multiples of 16. It runs as paddle.nn.Linear if not supported.
+
+    Parameters:
+        in_features (int): The number of input units.
+        out_features (int): The number of output units.
+        weight_attr (ParamAttr, optional): The attribute for the learnable
+            weight of this layer. Default: None.
+        bias_attr (ParamAttr|bool, optional): The attribute for the learnable bias
+            of this layer. If it is set to False, no bias will be added to the output.
+            Default: None.
+        name (str, optional): Normally there is no need for user to set this parameter.
+            For detailed information, please refer to :ref:`api_guide_Name` .
+
+    Attribute:
+        **weight** (Parameter): the learnable weight of this layer.
+
+        **bias** (Parameter): the learnable bias of this layer.
+
+    Shape:
+        - input: Multi-dimensional tensor with shape :math:`[batch\_size, *, in\_features]` .
+        - output: Multi-dimensional tensor with shape :math:`[batch\_size, *, out\_features]` .
+    """
+
+    def __init__(
+        self,
+        in_features,
+        out_features,
+        weight_attr=None,
+        bias_attr=None,
+        name=None,
+    ):
+        super().__init__()
+        dtype = self._helper.get_default_dtype()
+        self.weight = self.create_parameter(
+            shape=[in_features, out_features],
+            attr=weight_attr,
+            dtype=dtype,
+            is_bias=False,
+        )
+        self.bias = self.create_parameter(
+            shape=[out_features], attr=bias_attr, dtype=dtype, is_bias=True
+        )
+        self.in_features = in_features
+        self.out_features = out_features
+        self.name = name
+        # The scales and amax histories are created at the first fp8 step,
+        # as their length comes from the recipe.
+        self._fp8_state = None
+
+    def _fp8_supported(self, x):
+        if x.dtype not in (paddle.float16, paddle.bfloat16):
+            return False
+        rows = math.prod(x.shape[:-1])
+        return (
+            self.in_features % 16 == 0
+            and self.out_features % 16 == 0
+            and rows % 16 == 0
+        )
+
+    def forward(self, input):
+        recipe = _fp8_recipe
+        if recipe is None or not paddle.in_dynamic_mode():
+            return F.linear(input, self.weight, self.bias, self.name)
+        # The fp8 GEMMs output in half, so the float32 input is cast to the
+        # dtype of paddle.amp.auto_cast, which is what matmul does in it.
+        tracer = _dygraph_tracer()
+        if (
+            input.dtype == paddle.float32
+            and tracer._amp_level != core.AmpLevel.O0
+        ):
+            input = input.astype(tracer._amp_dtype)
+        if not self._fp8_supported(input):
+            return F.linear(input, self.weight, self.bias, self.name)
+        # The amax histories are kept across the steps of the same recipe
+        # settings, which are usually passed by a new fp8_autocast each step.
+        if self._fp8_state is None or not self._fp8_state.match(recipe):
+            self._fp8_state = _FP8State(recipe)
+        self._fp8_state.recipe = recipe
+        bias = self.bias
+        if bias is not None and bias.dtype != input.dtype:
+            bias = bias.astype(input.dtype)
+        return fp8_linear(input, self.weight, bias, self._fp8_state, self.name)
+
+    def extra_repr(self):
+        name_str = f', name={self.name}' if self.name else ''
+        return f'in_features={self.in_features}, out_features={self.out_features}, dtype={self._dtype}{name_str}'
@@ -19,7 +19,8 @@ from .lars_momentum import LarsMomentumOptimizer  # noqa: F401
 from .lbfgs import LBFGS
 from .lookahead import LookAhead  # noqa: F401
 from .modelaverage import ModelAverage  # noqa: F401
+from .offload import OffloadOptimizer
 from .pipeline import PipelineOptimizer  # noqa: F401
 from .recompute import RecomputeOptimizer  # noqa: F401
 
-__all__ = ['LBFGS']
+__all__ = ['LBFGS', 'OffloadOptimizer']
@@ -0,0 +1,244 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import paddle
+from paddle.base import core
+from paddle.incubate.tensor.manipulation import (
+    async_offload,
+    async_reload,
+    create_async_load,
+)
+
+__all__ = []
+
+
+class OffloadOptimizer:
+    r"""
+    Keeps the optimizer states of the inner optimizer, e.g. the moments of
+    Adam, in pinned host memory, so that only a few groups of them are on
+    the device at a time.
+
+    The states are split into groups of about ``group_size`` bytes in the
+    order the parameters are updated. While the parameters of a group are
+    updated on the device, the states of the next group are prefetched and
+    the states of the previous group are written back to the host, both on
+    the stream of :func:`paddle.incubate.tensor.manipulation.create_async_load`.
+
+    Only the states of the shape of their parameter are offloaded, the small
+    ones such as the beta pows stay where they are. The inner optimizer
+    should update the parameters one by one, i.e. without
+    ``use_multi_tensor``, and it only works in dynamic mode on GPU.
+
+    Args:
+        inner_optimizer (Optimizer): The optimizer whose states are
+            offloaded, e.g. :class:`paddle.optimizer.AdamW`.
+        group_size (int, optional): The bytes of the states of a group.
+            Default 256MB.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.optimizer import OffloadOptimizer
+            >>> paddle.device.set_device('gpu')
+
+            >>> linear = paddle.nn.Linear(10, 10)
+            >>> adam = paddle.optimizer.AdamW(parameters=linear.parameters())
+            >>> opt = OffloadOptimizer(adam)
+            >>> loss = linear(paddle.rand([4, 10])).mean()
+            >>> loss.backward()
+            >>> opt.step()
+            >>> opt.clear_grad()
+    """
+
+    def __init__(self, inner_optimizer, group_size=256 * 1024 * 1024):
+        if not paddle.in_dynamic_mode() or not core.is_compiled_with_cuda():
+            raise RuntimeError(
+                "OffloadOptimizer only works in dynamic mode on GPU."
+            )
+        if getattr(inner_optimizer, '_use_multi_tensor', False):
+            raise ValueError(
+                "OffloadOptimizer does not support use_multi_tensor, please "
+                "set use_multi_tensor=False for the inner optimizer."
+            )
+        if group_size <= 0:
+            raise ValueError(
+                f"group_size should be greater than 0, but got {group_size}."
+            )
+        self.inner_optimizer = inner_optimizer
+        self._group_size = group_size
+        self._loader = create_async_load()
+
+        # the states of each group, and the group of each parameter
+        self._groups = []
+        self._group_bytes = 0
+        self._group_of = {}
+        self._offloaded = set()
+        # group -> [(state, host buffer, reload task)]
+        self._loading = {}
+        self._current = None
+        # the device buffers written back, freed once the calc stream waits
+        self._writebacks = []
+        # the host buffers reloaded, freed once their copies are done
+        self._host_pending = []
+
+        self._add_accumulator = inner_optimizer._add_accumulator
+        self._append_optimize_op = inner_optimizer._append_optimize_op
+        inner_optimizer._add_accumulator = self._add_offloaded_accumulator
+        inner_optimizer._append_optimize_op = self._append_offloaded_optimize_op
+
+    def __getattr__(self, name):
+        return getattr(self.inner_optimizer, name)
+
+    def _move(self, state, load):
+        # Moves the buffer of state to the other side, and returns the old
+        # buffer, which should stay alive until the copy is done.
+        src = core.eager.Tensor()
+        state._share_buffer_to(src)
+        dst, task = load(state, self._loader)
+        dst._share_buffer_to(state)
+        return src, task
+
+    def _state_key(self, param):
+        master_weights = getattr(self.inner_optimizer, '_master_weights', {})
+        if param.name in master_weights:
+            return master_weights[param.name].name
+        return param.name
+
+    def _add_offloaded_accumulator(self, name, param, *args, **kwargs):
+        state = self._add_accumulator(name, param, *args, **kwargs)
+        if (
+            state.name in self._offloaded
+            or not state.place.is_gpu_place()
+            or state.size <= 1
+        ):
+            return state
+
+        nbytes = state.size * state.element_size()
+        group = self._group_of.get(param.name)
+        if group is None:
+            if (
+                not self._groups
+                or self._group_bytes + nbytes > self._group_size
+            ):
+                self._groups.append([])
+                self._group_bytes = 0
+            group = len(self._groups) - 1
+            self._group_of[param.name] = group
+        self._groups[group].append(state)
+        self._group_bytes += nbytes
+        self._offloaded.add(state.name)
+
+        # the states are created one by one, so they are never all on the
+        # device
+        _, task = self._move(state, async_offload)
+        task.wait()
+        return state
+
+    def _reload(self, group):
+        self._loading[group] = [
+            (state, *self._move(state, async_reload))
+            for state in self._groups[group]
+        ]
+
+    def _write_back(self, group):
+        for state, host, _ in self._loading.pop(group):
+            device, task = self._move(state, async_offload)
+            self._writebacks.append((device, task))
+            self._host_pending.append((host, task))
+
+    def _release_writebacks(self):
+        for _, task in self._writebacks:
+            task.wait()
+        self._writebacks = []
+
+    def _release_host(self):
+        self._host_pending = [
+            (host, task)
+            for host, task in self._host_pending
+            if not task.is_completed()
+        ]
+
+    def _enter(self, group):
+        # the write back of the group before the last one overlapped with
+        # the update of the last one
+        self._release_writebacks()
+        self._release_host()
+        if self._current is not None:
+            self._write_back(self._current)
+        if group not in self._loading:
+            self._reload(group)
+        for _, _, task in self._loading[group]:
+            task.wait()
+        if group + 1 < len(self._groups) and group + 1 not in self._loading:
+            self._reload(group + 1)
+        self._current = group
+
+    def _append_offloaded_optimize_op(self, block, param_and_grad):
+        if isinstance(param_and_grad, dict):
+            param = param_and_grad['params'][0]
+        else:
+            param = param_and_grad[0]
+        group = self._group_of.get(self._state_key(param))
+        if group is not None and group != self._current:
+            self._enter(group)
+        return self._append_optimize_op(block, param_and_grad)
+
+    def _start(self):
+        self._release_host()
+        # prefetches the first group ahead of the gradient clip
+        if self._groups:
+            self._reload(0)
+
+    def _finish(self):
+        if self._current is not None:
+            self._release_writebacks()
+            self._write_back(self._current)
+            self._current = None
+        # the groups prefetched but not updated, e.g. skipped by found_inf,
+        # go back to their host buffers
+        for group in list(self._loading):
+            for state, host, task in self._loading.pop(group):
+                task.wait()
+                host._share_buffer_to(state)
+        self._release_writebacks()
+
+    @paddle.no_grad()
+    def step(self):
+        self._start()
+        try:
+            self.inner_optimizer.step()
+        finally:
+            self._finish()
+
+    def minimize(
+        self, loss, startup_program=None, parameters=None, no_grad_set=None
+    ):
+        self._start()
+        try:
+            return self.inner_optimizer.minimize(
+                loss, startup_program, parameters, no_grad_set
+            )
+        finally:
+            self._finish()
+
+    def state_dict(self):
+        # the host buffers may still be written by the offload stream
+        paddle.device.synchronize()
+        return self.inner_optimizer.state_dict()
+
+    def set_state_dict(self, state_dict):
+        paddle.device.synchronize()
+        self.inner_optimizer.set_state_dict(state_dict)
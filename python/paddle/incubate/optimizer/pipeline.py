@@ -830,7 +830,7 @@ class PipelineOptimizer:
                             },
                         )
                         extra_index_info['index'] += 1
-                    elif self.schedule_mode == '1F1B':  # 1F1B
+                    elif self.schedule_mode in ['1F1B', 'ZB-H1']:
                         var_shape = list(var.shape)
                         var_shape[0] = (
                             self.micro_batch_size
@@ -967,7 +967,8 @@ class PipelineOptimizer:
                             extra_index_info['index'] += 1
                     else:
                         raise ValueError(
-                            "Now only 'F-then-B' and '1F1B' are supported."
+                            "Now only 'F-then-B', '1F1B' and 'ZB-H1' are "
+                            "supported."
                             f"The given value is {self.schedule_mode}."
                         )
 
@@ -1682,7 +1683,7 @@ class PipelineOptimizer:
         """
         optimize forward send's sync_comm_stream schedule
         """
-        if self.schedule_mode != '1F1B':
+        if self.schedule_mode not in ['1F1B', 'ZB-H1']:
             return
 
         block = program.block(0)
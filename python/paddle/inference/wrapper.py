@@ -14,6 +14,7 @@
 
 import logging
 import os
+import tempfile
 from typing import Set
 
 import numpy as np
@@ -27,6 +28,7 @@ from paddle.base.core import (
     PaddleInferTensor,
     PaddlePlace,
     convert_to_mixed_precision_bind,
+    create_predictor,
 )
 from paddle.base.log_helper import get_logger
 
@@ -76,6 +78,118 @@ def tensor_share_external_data(self, data):
         )
 
 
+def _run_calibration(model_file, params_file, backend, calibration_data):
+    config = Config(model_file, params_file)
+    if backend is PlaceType.GPU:
+        config.enable_use_gpu(256, 0)
+    elif backend is PlaceType.XPU:
+        config.enable_xpu()
+    config.disable_glog_info()
+    predictor = create_predictor(config)
+    outputs = []
+    for feed in calibration_data:
+        for name, data in feed.items():
+            predictor.get_input_handle(name).copy_from_cpu(data)
+        predictor.run()
+        outputs.append(
+            [
+                predictor.get_output_handle(name)
+                .copy_to_cpu()
+                .astype(np.float32)
+                for name in predictor.get_output_names()
+            ]
+        )
+    return outputs
+
+
+def _mixed_precision_error(ref_outputs, outputs):
+    # the max absolute error relative to the max magnitude of each fp32 output
+    error = 0.0
+    for ref_batch, batch in zip(ref_outputs, outputs):
+        for ref, out in zip(ref_batch, batch):
+            scale = max(float(np.abs(ref).max(initial=0.0)), 1e-6)
+            diff = float(np.abs(out - ref).max(initial=0.0))
+            error = max(error, diff / scale)
+    return error
+
+
+def _auto_mixed_black_list(
+    model_file,
+    params_file,
+    mixed_precision,
+    backend,
+    black_list,
+    white_list,
+    calibration_data,
+    tolerance,
+):
+    '''
+    The smallest black list found greedily which keeps the error of the
+    outputs on calibration_data within tolerance. The op types are ranked by
+    the error when only the ops of a type run in mixed precision, and the
+    most sensitive ones are kept in fp32 first.
+    '''
+    if backend not in (PlaceType.GPU, PlaceType.XPU):
+        raise ValueError(
+            "The calibration of convert_to_mixed_precision only supports "
+            "PlaceType.GPU and PlaceType.XPU."
+        )
+    ref_outputs = _run_calibration(
+        model_file, params_file, backend, calibration_data
+    )
+    with open(model_file, 'rb') as f:
+        program = paddle.static.Program.parse_from_string(f.read())
+    op_types = {
+        op.type
+        for block in program.blocks
+        for op in block.ops
+        if op.type not in ('feed', 'fetch')
+    }
+    op_types = sorted(op_types - set(black_list) - set(white_list))
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        temp_model_file = os.path.join(temp_dir, 'inference.pdmodel')
+        temp_params_file = os.path.join(temp_dir, 'inference.pdiparams')
+
+        def error_of(trial_black_list):
+            convert_to_mixed_precision_bind(
+                model_file,
+                params_file,
+                temp_model_file,
+                temp_params_file,
+                mixed_precision,
+                backend,
+                True,
+                trial_black_list,
+                white_list,
+            )
+            outputs = _run_calibration(
+                temp_model_file, temp_params_file, backend, calibration_data
+            )
+            return _mixed_precision_error(ref_outputs, outputs)
+
+        result = set(black_list)
+        error = error_of(result)
+        if error <= tolerance:
+            return result, error
+
+        sensitivity = {}
+        for op_type in op_types:
+            others = set(black_list) | (set(op_types) - {op_type})
+            sensitivity[op_type] = error_of(others)
+        for op_type in sorted(op_types, key=lambda t: -sensitivity[t]):
+            result.add(op_type)
+            error = error_of(result)
+            _logger.info(
+                f"Keep {op_type} in fp32 for an error of "
+                f"{sensitivity[op_type]:.6g}, the error of the model is "
+                f"{error:.6g} now."
+            )
+            if error <= tolerance:
+                break
+        return result, error
+
+
 def convert_to_mixed_precision(
     model_file: str,
     params_file: str,
@@ -99,8 +213,19 @@ def convert_to_mixed_precision(
         backend: The backend, e.g. PlaceType.GPU.
         keep_io_types: Whether the model input and output dtype remains unchanged.
         black_list: Operators that do not convert precision.
-        kwargs: Supported keys including 'white_list'.
+        kwargs: Supported keys including 'white_list', 'calibration_data'
+            and 'tolerance'.
             - white_list: Operators that do convert precision.
+            - calibration_data: A list of dicts from the input names to
+              numpy arrays. If given, the op types besides black_list whose
+              mixed precision outputs are the most sensitive are also kept in
+              fp32 until the outputs of the converted model on the data are
+              within tolerance of the fp32 ones. keep_io_types must be True.
+            - tolerance: The max absolute error of the outputs relative to
+              the max magnitude of the fp32 ones, 1e-2 by default.
+
+    Returns:
+        The set of the operators kept in fp32.
     '''
     if backend is PlaceType.GPU and not core.is_compiled_with_cuda():
         _logger.error(
@@ -119,6 +244,30 @@ def convert_to_mixed_precision(
     if not os.path.exists(mixed_params_dirname):
         os.makedirs(mixed_params_dirname)
     white_list = kwargs.get('white_list', set())
+    calibration_data = kwargs.get('calibration_data', None)
+    if calibration_data:
+        if not keep_io_types:
+            raise ValueError(
+                "The calibration of convert_to_mixed_precision requires "
+                "keep_io_types to be True."
+            )
+        tolerance = kwargs.get('tolerance', 1e-2)
+        black_list, error = _auto_mixed_black_list(
+            model_file,
+            params_file,
+            mixed_precision,
+            backend,
+            black_list,
+            white_list,
+            calibration_data,
+            tolerance,
+        )
+        if error > tolerance:
+            _logger.warning(
+                f"The error {error:.6g} of the mixed precision model still "
+                f"exceeds the tolerance {tolerance}."
+            )
+        _logger.info(f"The operators kept in fp32: {sorted(black_list)}")
     convert_to_mixed_precision_bind(
         model_file,
         params_file,
@@ -130,6 +279,7 @@ def convert_to_mixed_precision(
         black_list,
         white_list,
     )
+    return set(black_list)
 
 
 Tensor.copy_from_cpu = tensor_copy_from_cpu
@@ -1542,6 +1542,7 @@ class PirAutoRecomputeHooker(PirPartialProgramLayerHook):
                 grad_outputs,
                 forward_end_idx,
                 backward_start_idx,
+                memory_budget=core._auto_recompute_memory_budget(),
             )
         return whole_program, forward_end_idx, src_vars
 
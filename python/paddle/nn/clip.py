@@ -642,6 +642,11 @@ class ClipGradByGlobalNorm(ClipGradBase):
         clip_norm (float): The maximum norm value.
         group_name (str, optional): The group name for this clip. Default value is ``default_group``.
         auto_skip_clip (bool, optional): skip clipping gradient. Default value is ``False``.
+        inplace (bool, optional): in dynamic mode on GPU, clip the dense
+            gradients in place with one fused multi-tensor op, also along with
+            the unscaling of ``GradScaler``, instead of returning new clipped
+            gradients. The gradient tensors kept elsewhere, e.g. by hooks, are
+            then clipped as well. Default value is ``False``.
 
     Examples:
         .. code-block:: python
@@ -661,25 +666,90 @@ class ClipGradByGlobalNorm(ClipGradBase):
     """
 
     def __init__(
-        self, clip_norm, group_name="default_group", auto_skip_clip=False
+        self,
+        clip_norm,
+        group_name="default_group",
+        auto_skip_clip=False,
+        inplace=False,
     ):
         super().__init__()
         self.clip_norm = float(clip_norm)
         self.group_name = group_name
         assert isinstance(auto_skip_clip, bool)
         self.auto_skip_clip = auto_skip_clip
+        assert isinstance(inplace, bool)
+        self._inplace = inplace
         # TODO(zhiqiu): Now, in dygraph mode async_add_n is always used.
         # However, in static mode, it is only used in auto_parallel mode
         # by setting self._async_add_n to True. The reason is that there
         # are so many hard code depends on `add_n` in the legacy static
         # manual hybrid-parallel.
         self._async_add_n = None
+        # Set when GradScaler has clipped the gradients of the current step
+        # along with unscaling them, see _fused_unscale_and_clip.
+        self._skip_next_clip = False
 
     def __str__(self):
         return f"Gradient Clip By GlobalNorm, global_norm={self.clip_norm:f}"
 
+    def _fusable_grads(self, params_grads, src_mesh):
+        # The gradients to clip in place if all of them are dense on GPU, or
+        # None.
+        if not self._inplace or self.auto_skip_clip or src_mesh is not None:
+            return None
+        grads = []
+        for p, g in params_grads:
+            if g is None or getattr(p, 'need_clip', True) is False:
+                continue
+            if (
+                g.is_selected_rows()
+                or not g.place.is_gpu_place()
+                or g.dtype
+                not in (paddle.float32, paddle.float16, paddle.bfloat16)
+            ):
+                return None
+            grads.append(g)
+        if len(grads) == 0:
+            return None
+        return grads
+
+    @imperative_base.no_grad()
+    def _fused_clip_grads(self, params_grads, src_mesh):
+        # Squares, sums and scales the dense gradients on GPU in a few
+        # multi-tensor launches instead of several ops per gradient. The
+        # gradients are clipped in place.
+        grads = self._fusable_grads(params_grads, src_mesh)
+        if grads is None:
+            return None
+        _C_ops.fused_clip_by_global_norm_(grads, None, self.clip_norm)
+        return params_grads
+
     @imperative_base.no_grad()
+    def _fused_unscale_and_clip(self, params_grads, scale):
+        # Used by GradScaler: unscales the gradients by the loss scale,
+        # checks them for nan and inf and clips them in one multi-tensor
+        # read pass and one write pass. Then the clipping of the optimizer
+        # is skipped for this step. All gradients must be clipped, since the
+        # others would not be unscaled. Returns found_infinite, or None if
+        # the gradients can not be fused.
+        if len(params_grads) == 0 or any(
+            getattr(p, 'need_clip', True) is False for p, _ in params_grads
+        ):
+            return None
+        src_mesh = params_grads[0][0].process_mesh
+        grads = self._fusable_grads(params_grads, src_mesh)
+        if grads is None:
+            return None
+        _, found_infinite, _ = _C_ops.fused_clip_by_global_norm_(
+            grads, scale, self.clip_norm
+        )
+        self._skip_next_clip = True
+        return found_infinite
+
     def _dygraph_clip(self, params_grads):
+        if self._skip_next_clip:
+            self._skip_next_clip = False
+            return params_grads
         params_and_grads = []
         sum_square_list = []
         sum_square_list_fp16 = []
@@ -689,6 +759,11 @@ class ClipGradByGlobalNorm(ClipGradBase):
         else:
             src_mesh = None
 
+        if in_dynamic_mode() and core.is_compiled_with_cuda():
+            fused_params_grads = self._fused_clip_grads(params_grads, src_mesh)
+            if fused_params_grads is not None:
+                return fused_params_grads
+
         for p, g in params_grads:
             if g is None:
                 continue
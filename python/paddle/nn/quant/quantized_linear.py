@@ -188,6 +188,7 @@ def weight_only_linear(
     weight_dtype: DTypeLike = "int8",
     arch: int | None = None,
     group_size: _GroupSize = -1,
+    weight_zero: Tensor | None = None,
 ) -> Tensor:
     """
     Applies matrix multiplication of two tensors and then bias addition if provided.
@@ -202,6 +203,7 @@ def weight_only_linear(
         weight_dtype(str): The dtype of  weight Tensor, must be one of 'int8', 'int4', Defaulted to 'int8'.
         arch (int): The compute arch for target device. For example, A100 is 80, v100 is 70, if you do not assign arch, we will get arch from your device, default: None.
         group_size (int): The group size for weight quantization. -1 stands for default per-channel mode. Currently only support 64 or 128.
+        weight_zero (Tensor|None): The input zero Tensor for asymmetrically quantized weights, e.g. of AWQ/GPTQ checkpoints. It has the same shape as weight_scale and holds -zero_point * scale, so the weight is dequantized as weight * weight_scale + weight_zero. The backward does not support it. Default: None.
     Returns:
         Tensor: the output Tensor, the data type is the same as that of x.
 
@@ -238,7 +240,14 @@ def weight_only_linear(
 
     if in_dynamic_or_pir_mode():
         out = _C_ops.weight_only_linear(
-            x, weight, bias, weight_scale, weight_dtype, arch, group_size
+            x,
+            weight,
+            bias,
+            weight_scale,
+            weight_zero,
+            weight_dtype,
+            arch,
+            group_size,
         )
         return out
     else:
@@ -256,6 +265,8 @@ def weight_only_linear(
         }
         if bias is not None:
             inputs["bias"] = [bias]
+        if weight_zero is not None:
+            inputs["weight_zero"] = [weight_zero]
         attrs = {
             'weight_dtype': weight_dtype,
             'arch': arch,
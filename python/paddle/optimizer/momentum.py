@@ -420,6 +420,25 @@ class Momentum(Optimizer):
                     "Now multi_tensor_momentum only support fp32, fp16 or bf16 parameters and grad is LOD_TENSOR."
                 )
 
+    def _use_fused_momentum(self, key, param_group_idx, lrs):
+        """
+        The fused_momentum kernel updates all the parameters of a data type in
+        a few launches on GPU. It needs them to share the learning rate and the
+        regularization, otherwise merged_momentum is used.
+        """
+        params = self._param_dict[key][param_group_idx]
+        if not core.is_compiled_with_cuda() or len(params) == 0:
+            return False
+        if not params[0].place.is_gpu_place():
+            return False
+        if len({p.dtype for p in params}) != 1:
+            return False
+        if len(lrs) != len(params) or any(lr is not lrs[0] for lr in lrs):
+            return False
+        methods = self._regularization_method_dict[key][param_group_idx]
+        coeffs = self._regularization_coeff_dict[key][param_group_idx]
+        return len(set(methods)) == 1 and len(set(coeffs)) == 1
+
     def _append_optimize_multi_tensor_op(
         self,
         target_block,
@@ -499,7 +518,34 @@ class Momentum(Optimizer):
                     else None
                 )
 
-                if in_dynamic_or_pir_mode():
+                if framework.in_dygraph_mode() and self._use_fused_momentum(
+                    key, param_group_idx, lr_dict[key]
+                ):
+                    # The found_inf of GradScaler is checked on the device.
+                    found_inf = self._get_auxiliary_var('found_inf')
+                    if not isinstance(found_inf, core.eager.Tensor):
+                        if found_inf:
+                            continue
+                        found_inf = None
+                    _, _, _ = _C_ops.fused_momentum_(
+                        self._param_dict[key][param_group_idx],
+                        grad_dict[key],
+                        self._velocity_dict[key][param_group_idx],
+                        lr_dict[key][0],
+                        master_weight,
+                        found_inf,
+                        self._momentum,
+                        self._use_nesterov,
+                        self._regularization_method_dict[key][
+                            param_group_idx
+                        ][0],
+                        self._regularization_coeff_dict[key][
+                            param_group_idx
+                        ][0],
+                        find_master,
+                        self._rescale_grad,
+                    )
+                elif in_dynamic_or_pir_mode():
                     found_inf = self._get_auxiliary_var('found_inf')
                     if found_inf:
                         if isinstance(
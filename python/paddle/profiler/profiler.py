@@ -38,6 +38,7 @@ from .profiler_statistic import (
     StatisticData,
     _build_table,
     gen_layer_flops,
+    gen_roofline_summary,
 )
 from .timer import benchmark
 from .utils import RecordEvent, wrap_optimizers
@@ -903,6 +904,7 @@ class Profiler:
 
         if self.with_flops:
             self._print_flops()
+            self._print_roofline()
 
     def _print_flops(self, repeat=1):
         if not self.with_flops:
@@ -913,6 +915,11 @@ class Profiler:
         print(gen_layer_flops(self.profiler_result.get_data(), repeat))
         print("- Flops Profiler End -".center(100, "-"))
 
+    def _print_roofline(self):
+        print(" Roofline Summary Begin ".center(100, "-"))
+        print(gen_roofline_summary(self.profiler_result.get_data()))
+        print("- Roofline Summary End -".center(100, "-"))
+
 
 def get_profiler(config_path):
     try:
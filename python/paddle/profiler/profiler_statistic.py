@@ -293,6 +293,87 @@ def gen_layer_flops(nodetrees, repeat=1):
     return _gen_layer_flops(layer_tree, repeat)
 
 
+_DTYPE_BYTES = {
+    'BOOL': 1,
+    'INT8': 1,
+    'UINT8': 1,
+    'INT16': 2,
+    'FP16': 2,
+    'BF16': 2,
+    'INT32': 4,
+    'FP32': 4,
+    'INT64': 8,
+    'FP64': 8,
+    'COMPLEX64': 8,
+    'COMPLEX128': 16,
+}
+
+
+def _input_bytes(node):
+    r'''
+    Estimate the bytes read by an operator by the sizes of its inputs, the
+    elements of the inputs whose dtypes are not recorded count as 4 bytes.
+    '''
+    dtypes = getattr(node, 'dtypes', None) or {}
+    nbytes = 0
+    for name, shapes in node.input_shapes.items():
+        names = dtypes.get(name, [])
+        for i, shape in enumerate(shapes):
+            numel = 1
+            for d in shape:
+                numel *= max(d, 0)
+            itemsize = _DTYPE_BYTES.get(names[i], 4) if i < len(names) else 4
+            nbytes += numel * itemsize
+    return nbytes
+
+
+def gen_roofline_summary(nodetrees):
+    r'''
+    gen_roofline_summary places every operator on the roofline by the FLOPs
+    and the input bytes of its calls and the time of its kernels. They are
+    listed from the lowest arithmetic intensity, i.e. the most likely memory
+    bound ones first. The operators without a FLOPs formula are left out.
+    '''
+    items = collections.OrderedDict()
+
+    def add_operators(node):
+        if node.type == TracerEventType.Operator:
+            if node.flops > 0 and node.gpu_time > 0:
+                name = _nodename2opname(node.name)
+                item = items.setdefault(name, [0, 0, 0, 0])
+                item[0] += 1
+                item[1] += node.gpu_time
+                item[2] += node.flops
+                item[3] += _input_bytes(node)
+            # the FLOPs of the inner operators are counted by the outer one
+            return
+        for child in node.children_node:
+            add_operators(child)
+
+    node_statistic_tree, _ = wrap_tree(nodetrees)
+    for root in node_statistic_tree.values():
+        add_operators(root)
+
+    rows = []
+    for name, (calls, gpu_time, nflops, nbytes) in items.items():
+        intensity = nflops / nbytes if nbytes > 0 else float('inf')
+        rows.append((intensity, name, calls, gpu_time, nflops, nbytes))
+    rows.sort(key=lambda row: row[0])
+
+    ret = [
+        f"{'Name':<40}{'Calls':>8}{'GPU Total':>14}{'FLOPs/Byte':>12}"
+        f"{'FLOPS':>12}{'Bytes/s':>12}\n"
+    ]
+    for intensity, name, calls, gpu_time, nflops, nbytes in rows:
+        ret.append(
+            f"{name[:39]:<40}{calls:>8}{_format_time(gpu_time):>14}"
+            f"{round(intensity, 2):>12}"
+            f"{_format_large_number(nflops * 1e9 / gpu_time):>12}"
+            f"{_format_large_number(nbytes * 1e9 / gpu_time):>12}\n"
+        )
+    return "".join(ret)
+
+
 def wrap_tree(nodetrees):
     '''
     Using HostStatisticNode to wrap original profiler result tree, and calculate node statistic metrics.
@@ -671,6 +671,7 @@ def _to_tensor_non_static(
 
         return ndarray
 
+    source = data
     if isinstance(data, np.number):  # Special case for numpy scalars
         data = np.array(data)
 
@@ -730,11 +731,13 @@ def _to_tensor_non_static(
         data = _handle_np_dtype(data, dtype)
 
     if isinstance(data, np.ndarray):
+        # The ndarray created here is referenced by nobody else, so on CPU
+        # its buffer is shared instead of copied.
         return core.eager.Tensor(
             value=data,
             place=place,
             persistable=False,
-            zero_copy=False,
+            zero_copy=data is not source,
             name=None,
             stop_gradient=stop_gradient,
         )
@@ -334,10 +334,21 @@ def fp8_fp8_half_gemm_fused(
     output_dtype="float16",
     act="identity",
     name=None,
+    x_scale_inv=None,
+    y_scale_inv=None,
 ):
     if in_dynamic_or_pir_mode():
         return _C_ops.fp8_fp8_half_gemm_fused(
-            x, y, bias, transpose_x, transpose_y, scale, output_dtype, act
+            x,
+            y,
+            bias,
+            x_scale_inv,
+            y_scale_inv,
+            transpose_x,
+            transpose_y,
+            scale,
+            output_dtype,
+            act,
         )
     else:
         attrs = {
@@ -347,6 +358,11 @@ def fp8_fp8_half_gemm_fused(
             'output_dtype': output_dtype,
             'act': act,
         }
+        scale_inv_inputs = {}
+        if x_scale_inv is not None:
+            scale_inv_inputs['x_scale_inv'] = x_scale_inv
+        if y_scale_inv is not None:
+            scale_inv_inputs['y_scale_inv'] = y_scale_inv
         if bias is None:
 
             def __check_input(x, y):
@@ -376,7 +392,7 @@ def fp8_fp8_half_gemm_fused(
 
             helper.append_op(
                 type='fp8_fp8_half_gemm_fused',
-                inputs={'x': x, 'y': y},
+                inputs={'x': x, 'y': y, **scale_inv_inputs},
                 outputs={'out': out},
                 attrs=attrs,
             )
@@ -421,7 +437,7 @@ def fp8_fp8_half_gemm_fused(
 
             helper.append_op(
                 type='fp8_fp8_half_gemm_fused',
-                inputs={'x': x, 'y': y, 'bias': bias},
+                inputs={'x': x, 'y': y, 'bias': bias, **scale_inv_inputs},
                 outputs={'out': out},
                 attrs=attrs,
             )
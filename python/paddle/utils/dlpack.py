@@ -81,7 +81,8 @@ def from_dlpack(dlpack: CapsuleType) -> Tensor:
     Returns:
         out (Tensor), a tensor decoded from DLPack. One thing to be noted, if we get
                       an input dltensor with data type as `bool`, we return the decoded
-                      tensor as `uint8`.
+                      tensor as `uint8`. The decoded tensor shares the memory of the
+                      dltensor without copying.
 
     Examples:
         .. code-block:: python
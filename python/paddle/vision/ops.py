@@ -1387,26 +1387,42 @@ def read_file(filename: str, name: str | None = None) -> Tensor:
         return out
 
 
+@overload
 def decode_jpeg(
     x: Tensor,
-    mode: Literal["unchanged", "gray", "rgb"] = "unchanged",
-    name: str | None = None,
+    mode: Literal["unchanged", "gray", "rgb"] = ...,
+    name: str | None = ...,
 ) -> Tensor:
+    ...
+
+
+@overload
+def decode_jpeg(
+    x: Sequence[Tensor],
+    mode: Literal["unchanged", "gray", "rgb"] = ...,
+    name: str | None = ...,
+) -> list[Tensor]:
+    ...
+
+
+def decode_jpeg(x, mode="unchanged", name=None):
     """
     Decodes a JPEG image into a 3 dimensional RGB Tensor or 1 dimensional Gray Tensor.
     Optionally converts the image to the desired format.
     The values of the output tensor are uint8 between 0 and 255.
 
     Args:
-        x (Tensor): A one dimensional uint8 tensor containing the raw bytes
-            of the JPEG image.
+        x (Tensor|list[Tensor]): A one dimensional uint8 tensor containing the raw bytes
+            of the JPEG image, or a list of them, which are decoded in a batch. The
+            GPUs with the NVJPG engines decode the batches on the engines.
         mode (str, optional): The read mode used for optionally converting the image. Must be one of
             ["unchanged", "gray", "rgb"]. Default: 'unchanged'.
         name (str, optional): The default value is None. Normally there is no
             need for user to set this property. For more information, please
             refer to :ref:`api_guide_Name`.
     Returns:
-        Tensor: A decoded image tensor with shape (image_channels, image_height, image_width)
+        Tensor|list[Tensor]: A decoded image tensor with shape (image_channels, image_height, image_width),
+        or a list of them for a list of images.
 
     Examples:
         .. code-block:: python
@@ -1424,7 +1440,27 @@ def decode_jpeg(
             >>> img = paddle.vision.ops.decode_jpeg(img_bytes)
             >>> print(img.shape)
             [3, 400, 300]
+            >>> imgs = paddle.vision.ops.decode_jpeg([img_bytes, img_bytes])
+            >>> print(len(imgs), imgs[0].shape)
+            2 [3, 400, 300]
     """
+    if isinstance(x, (list, tuple)):
+        if in_dynamic_or_pir_mode():
+            return _C_ops.decode_jpeg_batch(
+                x, mode, _current_expected_place()
+            )
+        helper = LayerHelper("decode_jpeg_batch", **locals())
+        out = [
+            helper.create_variable_for_type_inference('uint8') for _ in x
+        ]
+        helper.append_op(
+            type="decode_jpeg_batch",
+            inputs={'x': x},
+            attrs={"mode": mode},
+            outputs={"out": out},
+        )
+        return out
+
     if in_dynamic_or_pir_mode():
         return _C_ops.decode_jpeg(x, mode, _current_expected_place())
     else:
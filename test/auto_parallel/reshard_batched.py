@@ -0,0 +1,107 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+
+import numpy as np
+
+import paddle
+import paddle.distributed as dist
+from paddle.distributed.auto_parallel.api import batched_reshard
+
+
+class TestReshardBatched:
+    def __init__(self):
+        self._dtype = os.getenv("dtype")
+        self._seeds = eval(os.getenv("seeds"))
+        self._backend = os.getenv("backend")
+        self._num_tensors = int(os.getenv("num_tensors", "200"))
+        self._mesh = dist.ProcessMesh([[0], [1]], dim_names=["x", "y"])
+        # the shapes of a small transformer layer
+        self._shapes = [[64, 256], [256], [256, 64], [64]]
+
+    def _values(self):
+        paddle.seed(self._seeds)
+        return [
+            paddle.uniform(
+                self._shapes[i % len(self._shapes)], self._dtype, -1, 1
+            )
+            for i in range(self._num_tensors)
+        ]
+
+    def _check(self, outs, expected):
+        for out, value in zip(outs, expected):
+            assert out.placements == [dist.Replicate(), dist.Replicate()]
+            np.testing.assert_allclose(
+                out._local_value().numpy(), value.numpy(), rtol=1e-6
+            )
+
+    def test_partial_to_replicated(self):
+        values = self._values()
+        inputs = [
+            dist.shard_tensor(
+                value, self._mesh, [dist.Partial(), dist.Replicate()]
+            )
+            for value in values
+        ]
+        outs = batched_reshard(
+            inputs, self._mesh, [dist.Replicate(), dist.Replicate()]
+        )
+        # shard_tensor keeps the value on the first rank of the partial dim
+        self._check(outs, values)
+
+    def test_shard_to_replicated(self):
+        values = self._values()
+        # one tensor not divisible by the mesh goes through s_to_r alone
+        values.append(paddle.uniform([5, 3], self._dtype))
+        inputs = [
+            dist.shard_tensor(
+                value,
+                self._mesh,
+                [dist.Shard(len(value.shape) - 1), dist.Replicate()],
+            )
+            for value in values
+        ]
+        outs = batched_reshard(
+            inputs, self._mesh, [dist.Replicate(), dist.Replicate()]
+        )
+        self._check(outs, values)
+
+    def test_matches_reshard(self):
+        values = self._values()
+        inputs = [
+            dist.shard_tensor(
+                value, self._mesh, [dist.Shard(0), dist.Replicate()]
+            )
+            for value in values
+        ]
+        placements = [dist.Replicate(), dist.Replicate()]
+        expected = [dist.reshard(t, self._mesh, placements) for t in inputs]
+        outs = batched_reshard(inputs, self._mesh, placements)
+        for out, value in zip(outs, expected):
+            assert out.placements == value.placements
+            np.testing.assert_array_equal(
+                out._local_value().numpy(), value._local_value().numpy()
+            )
+
+    def run_test_case(self):
+        if self._backend == "cpu":
+            paddle.set_device("cpu")
+        self.test_partial_to_replicated()
+        self.test_shard_to_replicated()
+        self.test_matches_reshard()
+
+
+if __name__ == '__main__':
+    TestReshardBatched().run_test_case()
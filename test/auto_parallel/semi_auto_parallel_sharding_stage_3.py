@@ -61,6 +61,38 @@ class TestSemiAutoParallelShardingStage3:
         self.check_tensor_eq(self.weight, linear.weight.numpy())
         self.check_tensor_eq(self.bias, linear.bias.numpy())
 
+    def build_mlp(self):
+        paddle.seed(self._seed)
+        return nn.Sequential(
+            nn.Linear(10, 10), nn.Linear(10, 10), nn.Linear(10, 10)
+        )
+
+    def test_sharding_stage_3_with_prefetch(self):
+        mlp = self.build_mlp()
+        batch = paddle.rand(shape=[10, 10])
+        opt = paddle.optimizer.AdamW(parameters=mlp.parameters())
+        for _ in range(5):
+            loss = mlp(batch)
+            loss.backward()
+            opt.step()
+            opt.clear_grad()
+        expected = [param.numpy() for param in mlp.parameters()]
+
+        mlp = self.build_mlp()
+        batch = paddle.rand(shape=[10, 10])
+        batch = dist.shard_tensor(batch, self._mesh, [dist.Shard(0)])
+        opt = paddle.optimizer.AdamW(parameters=mlp.parameters())
+        shard_fn = dist.ShardingStage3(self._mesh)
+        opt = dist.shard_optimizer(opt, shard_fn)
+        shard_fn.enable_prefetch(mlp, prefetch_depth=1)
+        for _ in range(5):
+            loss = mlp(batch)
+            loss.backward()
+            opt.step()
+            opt.clear_grad()
+        for param, value in zip(mlp.parameters(), expected):
+            self.check_tensor_eq(value, param.numpy())
+
     def test_sharding_stage_3_to_static(self):
         data_loader = create_data_loader()
         layer = DemoNet(self._mesh, "sharding_demonet")
@@ -93,6 +125,7 @@ class TestSemiAutoParallelShardingStage3:
 
         self.get_single_card_rst()
         self.test_pure_sharding_stage_3()
+        self.test_sharding_stage_3_with_prefetch()
         self.test_sharding_stage_3_to_static()
 
 
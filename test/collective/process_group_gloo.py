@@ -84,6 +84,41 @@ class TestProcessGroupFp32(unittest.TestCase):
 
         print("test allreduce max api ok")
 
+        # test allreduce sum with each algorithm, split across threads
+        shape = [1 << 20]
+        for algorithm in ["ring", "halving_doubling", "tree", "default"]:
+            paddle.set_flags(
+                {
+                    'FLAGS_gloo_allreduce_algorithm': algorithm,
+                    'FLAGS_gloo_allreduce_num_threads': 4,
+                }
+            )
+            x = np.random.random(shape).astype(self.dtype)
+            y = np.random.random(shape).astype(self.dtype)
+            tensor = paddle.to_tensor(x if rank == 0 else y)
+            task = pg.allreduce(tensor)
+            task.wait()
+            np.testing.assert_allclose(tensor.numpy(), x + y, rtol=1e-6)
+        paddle.set_flags(
+            {
+                'FLAGS_gloo_allreduce_algorithm': 'auto',
+                'FLAGS_gloo_allreduce_num_threads': 1,
+            }
+        )
+
+        # test allreduce sum compressed to bfloat16
+        if self.dtype == "float32":
+            paddle.set_flags({'FLAGS_gloo_allreduce_bf16_compress': True})
+            x = np.random.random(self.shape).astype(self.dtype)
+            y = np.random.random(self.shape).astype(self.dtype)
+            tensor = paddle.to_tensor(x if rank == 0 else y)
+            task = pg.allreduce(tensor)
+            task.wait()
+            np.testing.assert_allclose(tensor.numpy(), x + y, rtol=2e-2)
+            paddle.set_flags({'FLAGS_gloo_allreduce_bf16_compress': False})
+
+        print("test allreduce algorithms ok")
+
         # test broadcast
         # rank 0
         x = np.random.random(self.shape).astype(self.dtype)
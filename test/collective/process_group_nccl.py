@@ -594,6 +594,8 @@ class TestProcessGroupFp32(unittest.TestCase):
 
         print("test send & recv 0-d tensor ok")
 
+        test_coalesced_collectives(self.dtype, pg)
+
 
 class TestProcessGroupFp16(TestProcessGroupFp32):
     def setUp(self):
@@ -690,5 +692,46 @@ def test_reduce_with_zero_dim(shape, dtype, pg):
     print("test reduce with zero dim prod api ok")
 
 
+def test_coalesced_collectives(dtype, pg):
+    # tensor parallel layers communicate many small tensors per step
+    shapes = [[16], [8, 8], [3, 5, 7], [1], [128, 32]]
+    xs = [np.random.random(shape).astype(dtype) for shape in shapes]
+    ys = [np.random.random(shape).astype(dtype) for shape in shapes]
+
+    def local_tensors():
+        local = xs if pg.rank() == 0 else ys
+        return [paddle.to_tensor(x) for x in local]
+
+    for flatten_size in [0, 1 << 20]:
+        paddle.set_flags({'FLAGS_nccl_coalesce_flatten_size': flatten_size})
+
+        tensors = local_tensors()
+        task = pg.all_reduce_coalesced(
+            tensors, dist.ReduceOp.SUM, sync_op=True
+        )
+        for tensor, x, y in zip(tensors, xs, ys):
+            np.testing.assert_allclose(tensor.numpy(), x + y, rtol=1e-3)
+        print(f"test all_reduce_coalesced with flatten size {flatten_size} ok")
+
+        tensors = local_tensors()
+        task = pg.broadcast_coalesced(tensors, 0, sync_op=True)
+        for tensor, x in zip(tensors, xs):
+            np.testing.assert_array_equal(tensor.numpy(), x)
+        print(f"test broadcast_coalesced with flatten size {flatten_size} ok")
+
+    out_tensors = [
+        paddle.empty([pg.size(), *shape], dtype=dtype) for shape in shapes
+    ]
+    task = pg.all_gather_into_tensor_coalesced(
+        out_tensors, local_tensors(), sync_op=True
+    )
+    for out_tensor, x, y in zip(out_tensors, xs, ys):
+        np.testing.assert_array_equal(out_tensor[0].numpy(), x)
+        np.testing.assert_array_equal(out_tensor[1].numpy(), y)
+    print("test all_gather_into_tensor_coalesced ok")
+
+    paddle.set_flags({'FLAGS_nccl_coalesce_flatten_size': 0})
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,94 @@
+# Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.distributed as dist
+from paddle.base import core
+
+
+class SimpleNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.linear1 = paddle.nn.Linear(32, 48)
+        self.linear2 = paddle.nn.Linear(48, 10)
+
+    def forward(self, x):
+        return self.linear2(paddle.nn.functional.relu(self.linear1(x)))
+
+
+class TestReducerCommHook(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        dist.init_parallel_env()
+
+    def setUp(self):
+        # every rank has its own data, so the gradients differ
+        rng = np.random.RandomState(2026 + dist.get_rank())
+        self.x = rng.randn(8, 32).astype('float32')
+
+    def get_grads(self, options=None):
+        paddle.seed(2026)
+        model = paddle.DataParallel(SimpleNet())
+        if options is not None:
+            model._reducer.set_comm_hook(options)
+        grads = []
+        # the second step checks the state kept across steps
+        for _ in range(2):
+            model.clear_gradients()
+            loss = model(paddle.to_tensor(self.x)).square().mean()
+            loss.backward()
+            grads.append([p.grad.numpy() for p in model.parameters()])
+        return grads
+
+    def check_hook(self, options, rtol, atol):
+        expected = self.get_grads()
+        actual = self.get_grads(options)
+        for expected_step, actual_step in zip(expected, actual):
+            for expected_grad, actual_grad in zip(expected_step, actual_step):
+                np.testing.assert_allclose(
+                    actual_grad, expected_grad, rtol=rtol, atol=atol
+                )
+
+    def test_fp16(self):
+        options = core.CommHookOptions()
+        options.type = core.CommHookType.FP16
+        self.check_hook(options, rtol=1e-2, atol=1e-3)
+
+    def test_bf16(self):
+        options = core.CommHookOptions()
+        options.type = core.CommHookType.BF16
+        self.check_hook(options, rtol=5e-2, atol=1e-2)
+
+    def test_topk(self):
+        # sending every element makes top-k exact
+        options = core.CommHookOptions()
+        options.type = core.CommHookType.TOPK
+        options.topk_ratio = 1.0
+        self.check_hook(options, rtol=1e-5, atol=1e-6)
+
+    def test_power_sgd(self):
+        # a rank as large as the bucket matrix makes PowerSGD exact, so the
+        # error fed back to the second step must be zero on every rank
+        options = core.CommHookOptions()
+        options.type = core.CommHookType.POWER_SGD
+        options.power_sgd_rank = 1 << 20
+        self.check_hook(options, rtol=1e-3, atol=1e-4)
+
+
+if __name__ == '__main__':
+    unittest.main()
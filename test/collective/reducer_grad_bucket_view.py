@@ -0,0 +1,104 @@
+# Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.distributed as dist
+
+
+class SimpleNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.linear1 = paddle.nn.Linear(32, 48)
+        self.linear2 = paddle.nn.Linear(48, 10)
+
+    def forward(self, x):
+        return self.linear2(paddle.nn.functional.relu(self.linear1(x)))
+
+
+class TestReducerGradBucketView(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        dist.init_parallel_env()
+
+    def setUp(self):
+        # every rank has its own data, so the gradients differ
+        rng = np.random.RandomState(2026 + dist.get_rank())
+        self.x = rng.randn(8, 32).astype('float32')
+
+    def create_model(self):
+        paddle.seed(2026)
+        return paddle.DataParallel(SimpleNet())
+
+    def step(self, model, set_to_zero=True):
+        model.clear_gradients(set_to_zero)
+        loss = model(paddle.to_tensor(self.x)).square().mean()
+        loss.backward()
+        return [p.grad.numpy() for p in model.parameters()]
+
+    def shares_bucket(self, model):
+        grads = [p.grad for p in model.parameters()]
+        return all(g._is_shared_buffer_with(grads[0]) for g in grads[1:])
+
+    def test_bucket_view(self):
+        expected_model = self.create_model()
+        expected = [self.step(expected_model) for _ in range(2)]
+        expected.append(self.step(expected_model, set_to_zero=False))
+
+        model = self.create_model()
+        model._reducer.set_grad_as_bucket_view(True)
+        # the grads are bound lazily, none is created before the backward
+        for p in model.parameters():
+            self.assertIsNone(p.grad)
+
+        for i in range(2):
+            actual = self.step(model)
+            self.assertTrue(self.shares_bucket(model))
+            for actual_grad, expected_grad in zip(actual, expected[i]):
+                np.testing.assert_allclose(
+                    actual_grad, expected_grad, rtol=1e-5, atol=1e-6
+                )
+        # the grads released by the clear are bound again
+        actual = self.step(model, set_to_zero=False)
+        self.assertTrue(self.shares_bucket(model))
+        for actual_grad, expected_grad in zip(actual, expected[2]):
+            np.testing.assert_allclose(
+                actual_grad, expected_grad, rtol=1e-5, atol=1e-6
+            )
+
+    def test_disable(self):
+        expected_model = self.create_model()
+        expected = self.step(expected_model)
+
+        model = self.create_model()
+        model._reducer.set_grad_as_bucket_view(True)
+        self.step(model)
+        self.assertTrue(self.shares_bucket(model))
+
+        # the grads take over the new ones again rather than being copied
+        # into the buckets
+        model._reducer.set_grad_as_bucket_view(False)
+        actual = self.step(model)
+        self.assertFalse(self.shares_bucket(model))
+        for actual_grad, expected_grad in zip(actual, expected):
+            np.testing.assert_allclose(
+                actual_grad, expected_grad, rtol=1e-5, atol=1e-6
+            )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -29,6 +29,12 @@ class TestProcessGroup(TestMultipleAccelerators):
     def test_init_process_group(self):
         self.run_mnist_2accelerators('init_process_group.py')
 
+    def test_reducer_comm_hook(self):
+        self.run_mnist_2accelerators('reducer_comm_hook.py')
+
+    def test_reducer_grad_bucket_view(self):
+        self.run_mnist_2accelerators('reducer_grad_bucket_view.py')
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,74 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "gtest/gtest.h"
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/api/lib/api_gen_utils.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+
+COMMON_DECLARE_bool(dist_api_spmd_cache);
+
+namespace phi {
+namespace distributed {
+namespace tests {
+
+using paddle::experimental::SpmdInfoCache;
+
+TEST(spmd_info_cache, lookup_and_store) {
+  FLAGS_dist_api_spmd_cache = true;
+  DDim dims({4, 8});
+  auto dist_attr = TensorDistAttr(common::vectorize(dims));
+  dist_attr.set_process_mesh(ProcessMesh({2}, {0, 1}, {"x"}));
+  dist_attr.set_dims_mapping({0, -1});
+  DistTensor x(dims, dist_attr);
+  SpmdInfoCache cache;
+
+  cache.Begin();
+  cache.Add(DistMetaTensor(x));
+  cache.Add(true);
+  ASSERT_EQ(cache.Lookup(), nullptr);
+  auto entry = cache.Store(SpmdInfo({dist_attr}, {dist_attr}));
+  entry->inputs_in_place = true;
+
+  cache.Begin();
+  cache.Add(DistMetaTensor(x));
+  cache.Add(true);
+  ASSERT_EQ(cache.Lookup(), entry);
+  EXPECT_TRUE(cache.Lookup()->inputs_in_place);
+
+  // another attribute or dist attr of the input misses
+  cache.Begin();
+  cache.Add(DistMetaTensor(x));
+  cache.Add(false);
+  EXPECT_EQ(cache.Lookup(), nullptr);
+  auto replicated = dist_attr;
+  replicated.set_dims_mapping({-1, -1});
+  x.unsafe_set_dist_attr(replicated);
+  cache.Begin();
+  cache.Add(DistMetaTensor(x));
+  cache.Add(true);
+  EXPECT_EQ(cache.Lookup(), nullptr);
+
+  FLAGS_dist_api_spmd_cache = false;
+  x.unsafe_set_dist_attr(dist_attr);
+  cache.Begin();
+  cache.Add(DistMetaTensor(x));
+  cache.Add(true);
+  EXPECT_EQ(cache.Lookup(), nullptr);
+}
+
+}  // namespace tests
+}  // namespace distributed
+}  // namespace phi
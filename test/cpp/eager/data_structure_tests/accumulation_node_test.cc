@@ -415,3 +415,61 @@ TEST(AccumulationNode, Tensor) {
                         "The value of the first element of the dense tensor "
                         "should be 100.0f"));
 }
+
+TEST(AccumulationNode, KeepGradBuffer) {
+  phi::DenseTensorMeta meta =
+      phi::DenseTensorMeta(phi::DataType::FLOAT32, common::make_ddim({1, 1}));
+  std::shared_ptr<phi::DenseTensor> dt0 = std::make_shared<phi::DenseTensor>(
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace())
+          .get(),
+      meta);
+  dt0->mutable_data<float>(phi::CPUPlace())[0] = static_cast<float>(10.0f);
+  paddle::Tensor et0 = paddle::Tensor(dt0);
+
+  std::shared_ptr<phi::DenseTensor> input_dt =
+      std::make_shared<phi::DenseTensor>(
+          std::make_unique<paddle::experimental::DefaultAllocator>(
+              phi::CPUPlace())
+              .get(),
+          meta);
+  paddle::Tensor input_et = paddle::Tensor(input_dt);
+  auto grad_meta = EagerUtils::autograd_meta(&input_et);
+  // the cleared grad whose memory is kept
+  std::shared_ptr<phi::DenseTensor> grad_dt =
+      std::make_shared<phi::DenseTensor>(
+          std::make_unique<paddle::experimental::DefaultAllocator>(
+              phi::CPUPlace())
+              .get(),
+          meta);
+  float* grad_buffer = grad_dt->mutable_data<float>(phi::CPUPlace());
+  grad_buffer[0] = static_cast<float>(0.0f);
+  grad_meta->MutableGrad()->set_impl(grad_dt);
+
+  auto node = std::make_shared<GradNodeAccumulation>(grad_meta);
+  grad_meta->SetGradNode(node);
+  grad_meta->SetStopGradient(false);
+  node->SetFakeEmpty(true);
+  node->SetKeepGradBuffer(true);
+
+  paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+      et0_vec = {{et0}};
+  node->operator()(et0_vec);
+
+  paddle::Tensor* grad = EagerUtils::mutable_grad(input_et);
+  auto* grad_ptr =
+      std::dynamic_pointer_cast<phi::DenseTensor>(grad->impl())->data<float>();
+  PADDLE_ENFORCE_EQ(grad_ptr,
+                    grad_buffer,
+                    common::errors::InvalidArgument(
+                        "The grad should be written into its own buffer."));
+  PADDLE_ENFORCE_EQ(grad_ptr[0],
+                    static_cast<float>(10.0f),
+                    common::errors::InvalidArgument(
+                        "The value of the first element of the grad should "
+                        "be 10.0f"));
+  PADDLE_ENFORCE_NE(
+      grad->impl(),
+      et0.impl(),
+      common::errors::InvalidArgument(
+          "The grad should not take over the incoming tensor."));
+}
@@ -204,3 +204,22 @@ TEST(GradNodeInfo, Edge) {
       5UL,
       common::errors::InvalidArgument("Edge rank info mismatch. Expected 5."));
 }
+
+TEST(GradNodeInfo, GradNodePool) {
+  egr::GradNodePool::Release();
+  auto* grad_test_node0 = new eager_test::GradTestNode(
+      /* val */ 5.0, /* in_num */ 2, /* out_num */ 2);
+  void* addr0 = grad_test_node0;
+  std::shared_ptr<egr::GradNodeBase>(grad_test_node0).reset();
+  CHECK_EQ(egr::GradNodePool::CachedBlockNum(), 1UL);
+
+  // the next node of the same size reuses the freed memory
+  auto grad_test_node1 = std::shared_ptr<eager_test::GradTestNode>(
+      new eager_test::GradTestNode());
+  CHECK_EQ(static_cast<void*>(grad_test_node1.get()), addr0);
+  CHECK_EQ(egr::GradNodePool::CachedBlockNum(), 0UL);
+
+  grad_test_node1.reset();
+  egr::GradNodePool::Release();
+  CHECK_EQ(egr::GradNodePool::CachedBlockNum(), 0UL);
+}
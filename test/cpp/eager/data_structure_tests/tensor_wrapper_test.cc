@@ -16,8 +16,16 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/utils.h"
 #include "test/cpp/eager/data_structure_tests/grad_node_test.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/memory/memcpy.h"
+
+COMMON_DECLARE_int64(eager_activation_offload_min_size);
+#endif
 
 TEST(TensorWrapper, Basic) {
   VLOG(6) << "Test Full reserved";
@@ -102,3 +110,48 @@ TEST(TensorWrapper, Basic) {
   auto tw2 = egr::TensorWrapper(et3);
   CHECK(tw2.recover().initialized() == false);
 }
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+TEST(TensorWrapper, Offload) {
+  FLAGS_eager_activation_offload_min_size = 1;
+  phi::GPUPlace place(0);
+  std::vector<float> src = {1.0f, 2.0f, 3.0f, 4.0f};
+  paddle::Tensor et1;
+  auto dt = std::make_shared<phi::DenseTensor>();
+  dt->Resize(common::make_ddim({2, 2}));
+  paddle::memory::Copy(place,
+                       dt->mutable_data<float>(place),
+                       phi::CPUPlace(),
+                       src.data(),
+                       src.size() * sizeof(float),
+                       nullptr);
+  et1.set_impl(dt);
+  // saved activations have a grad node, leaves are never offloaded
+  auto grad_test_node0 = std::make_shared<eager_test::GradTestNode>(
+      /* val */ 5.0, /* in_num */ 2, /* out_num */ 2);
+  egr::Edge edge0(grad_test_node0, 1, 2);
+  et1.set_autograd_meta(std::make_shared<egr::AutogradMeta>(edge0));
+
+  auto tw0 = egr::TensorWrapper(et1);
+  FLAGS_eager_activation_offload_min_size = 0;
+  ASSERT_FALSE(tw0.get_intermidiate_tensor().initialized());
+  // the device buffer may go away once the copy to host is done
+  et1.reset();
+  dt.reset();
+
+  auto recover_et1 = tw0.recover();
+  ASSERT_TRUE(recover_et1.initialized());
+  auto& recover_dt = *static_cast<phi::DenseTensor*>(recover_et1.impl().get());
+  static_cast<phi::GPUContext*>(phi::DeviceContextPool::Instance().Get(place))
+      ->Wait();
+  std::vector<float> dst(src.size());
+  paddle::memory::Copy(phi::CPUPlace(),
+                       dst.data(),
+                       place,
+                       recover_dt.data<float>(),
+                       dst.size() * sizeof(float),
+                       nullptr);
+  ASSERT_EQ(dst, src);
+  tw0.clear();
+}
+#endif
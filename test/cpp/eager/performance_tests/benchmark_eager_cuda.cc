@@ -32,6 +32,8 @@
 
 #include "paddle/phi/core/kernel_registry.h"
 
+COMMON_DECLARE_int32(eager_backward_num_threads);
+
 using namespace egr;            // NOLINT
 using namespace egr_utils_api;  // NOLINT
 
@@ -254,4 +256,55 @@ TEST(Benchmark, EagerIntermediateMLPCUDA) {
   }
 }
 
+TEST(Benchmark, EagerMultiBranchCUDA) {
+  eager_test::InitEnv(phi::GPUPlace());
+
+  // the sequential backward against the one dispatching the independent
+  // branches from 4 host threads
+  for (int num_threads : {0, 4}) {
+    FLAGS_eager_backward_num_threads = num_threads;
+    for (const std::string mode : {"Accuracy", "WarmUp", "Performance"}) {
+      phi::DDim ddim = common::make_ddim({2, 2});
+      paddle::Tensor X =
+          eager_test::CreateTensorWithValue(ddim,
+                                            phi::GPUPlace(),
+                                            phi::DataType::FLOAT32,
+                                            phi::DataLayout::NCHW,
+                                            1.0,
+                                            true);
+      RetainGradForTensor(X);
+
+      std::vector<paddle::Tensor> Ws;
+      for (size_t i = 0; i < MULTI_BRANCH_NUM; i++) {
+        paddle::Tensor W =
+            eager_test::CreateTensorWithValue(ddim,
+                                              phi::GPUPlace(),
+                                              phi::DataType::FLOAT32,
+                                              phi::DataLayout::NCHW,
+                                              1.0,
+                                              true);
+        RetainGradForTensor(W);
+        Ws.emplace_back(std::move(W));
+      }
+
+      if (mode == "Accuracy") {
+        benchmark_eager_multi_branch(X, Ws, true /* accuracy_check */);
+
+      } else if (mode == "WarmUp") {
+        benchmark_eager_multi_branch(X, Ws);
+
+      } else if (mode == "Performance") {
+        report_benchmark_duration(
+            "EagerMultiBranchCUDA with " + std::to_string(num_threads) +
+                " backward threads",
+            [&]() { benchmark_eager_multi_branch(X, Ws); });
+
+      } else {
+        PADDLE_THROW(common::errors::Fatal("Unknown benchmark mode"));
+      }
+    }
+  }
+  FLAGS_eager_backward_num_threads = 0;
+}
+
 #endif  // PADDLE_WITH_CUDA || PADDLE_WITH_HIP
@@ -14,6 +14,7 @@
 
 #include "test/cpp/eager/performance_tests/benchmark_utils.h"
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <set>
@@ -41,6 +42,19 @@ static size_t max_num_benchmark_runs = 4000;
 
 namespace egr {
 
+/* ------------------- */
+/* ---- Reporting ---- */
+/* ------------------- */
+void report_benchmark_duration(const std::string& name,
+                               const std::function<void()>& benchmark) {
+  auto t_start = std::chrono::high_resolution_clock::now();
+  benchmark();
+  auto t_end = std::chrono::high_resolution_clock::now();
+  double elapsed_time_ms =
+      std::chrono::duration<double, std::milli>(t_end - t_start).count();
+  LOG(INFO) << name << " duration: " << elapsed_time_ms << " ms";
+}
+
 /* --------------------- */
 /* ---- Eager Scale ---- */
 /* --------------------- */
@@ -91,6 +105,35 @@ void benchmark_eager_matmul(const paddle::Tensor& X,
   }
 }
 
+/* --------------------------- */
+/* ---- Eager Multi Branch ---- */
+/* --------------------------- */
+void benchmark_eager_multi_branch(const paddle::Tensor& X,
+                                  const std::vector<paddle::Tensor>& Ws,
+                                  bool accuracy_check) {
+  // the branches only meet at X, so their grad nodes are independent
+  size_t depth = accuracy_check ? 2 : MULTI_BRANCH_DEPTH;
+  std::vector<paddle::Tensor> target_tensors;
+  for (const auto& W : Ws) {
+    paddle::Tensor input_tensor0 = X;
+    for (size_t i = 0; i < depth; i++) {
+      input_tensor0 = matmul_ad_func(input_tensor0, W, false, false);
+    }
+    target_tensors.emplace_back(input_tensor0);
+  }
+
+  Backward(target_tensors, {});
+
+  if (accuracy_check) {
+    // Examine Forward Grad (w.r.t depth = 2)
+    eager_test::CompareTensorWithValue<float>(target_tensors[0], 4);
+    // Examine Backward Grad (w.r.t depth = 2)
+    eager_test::CompareGradTensorWithValue<float>(
+        X, static_cast<float>(4 * Ws.size()));
+    eager_test::CompareGradTensorWithValue<float>(Ws[0], 8);
+  }
+}
+
 /* ----------------------------------- */
 /* ---- Eager Intermediate Matmul ---- */
 /* ----------------------------------- */
@@ -16,6 +16,9 @@
 
 #include <math.h>
 
+#include <functional>
+#include <string>
+
 #include "paddle/fluid/eager/eager_tensor.h"
 #include "paddle/fluid/imperative/layer.h"
 #include "paddle/phi/api/all.h"
@@ -32,6 +35,11 @@
 #define MLP_B_VAL 3.0
 #define MLP_NUM_LINEAR 1000
 
+/* Multi Branch Configurations */
+// Out_i = X[2, 2] x W_i[2, 2] x ... x W_i, MULTI_BRANCH_DEPTH times
+#define MULTI_BRANCH_NUM 8
+#define MULTI_BRANCH_DEPTH 50
+
 namespace egr {
 
 inline std::unordered_map<std::string, float> compute_mlp_expected_results() {
@@ -47,6 +55,11 @@ inline std::unordered_map<std::string, float> compute_mlp_expected_results() {
   return {{"Out", Out}, {"GradX", GradX}, {"GradW", GradW0}};
 }
 
+/* ---- Reporting ---- */
+// Runs benchmark once and logs its wall time under name.
+void report_benchmark_duration(const std::string& name,
+                               const std::function<void()>& benchmark);
+
 /* ---- Eager Scale ---- */
 void benchmark_eager_scale(const paddle::Tensor& tensor,
                            bool accuracy_check = false);
@@ -56,6 +69,11 @@ void benchmark_eager_matmul(const paddle::Tensor& X,
                             const paddle::Tensor& Y,
                             bool accuracy_check = false);
 
+/* ---- Eager Multi Branch ---- */
+void benchmark_eager_multi_branch(const paddle::Tensor& X,
+                                  const std::vector<paddle::Tensor>& Ws,
+                                  bool accuracy_check = false);
+
 void benchmark_eager_intermediate_matmul(const paddle::Tensor& X,
                                          const paddle::Tensor& Y,
                                          bool accuracy_check = false);
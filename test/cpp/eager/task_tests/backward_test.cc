@@ -18,6 +18,7 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/all.h"
 #include "paddle/fluid/eager/api/generated/eager_generated/backwards/scale_node.h"
@@ -30,6 +31,9 @@
 
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(scale, CPU, ALL_LAYOUT);
+
+COMMON_DECLARE_int32(eager_backward_num_threads);
 
 namespace egr {
 
@@ -342,4 +346,42 @@ TEST(Backward, WithAccumulation) {
   eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 2500.0);
 }
 
+TEST(Backward, MultiBranchInParallel) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(phi::CPUPlace());
+
+  // Prepare Inputs
+  phi::DDim ddim = common::make_ddim({4, 16, 16, 32});
+
+  // Create Leaf Tensor
+  paddle::Tensor leaf_tensor =
+      eager_test::CreateTensorWithValue(ddim,
+                                        phi::CPUPlace(),
+                                        phi::DataType::FLOAT32,
+                                        phi::DataLayout::NCHW,
+                                        1.0 /*value*/,
+                                        true /*is_leaf*/);
+  egr_utils_api::RetainGradForTensor(leaf_tensor);
+
+  // 8 independent branches of 4 scale ops, which only meet at the leaf
+  std::vector<paddle::Tensor> target_tensors;
+  for (int i = 0; i < 8; i++) {
+    paddle::Tensor out = leaf_tensor;
+    for (int j = 0; j < 4; j++) {
+      out = egr::scale(out,
+                       2.0 /*scale*/,
+                       0.0 /*bias*/,
+                       true /*bias_after_scale*/,
+                       true /*trace_backward*/);
+    }
+    target_tensors.emplace_back(out);
+  }
+
+  FLAGS_eager_backward_num_threads = 4;
+  Backward(target_tensors, {});
+  FLAGS_eager_backward_num_threads = 0;
+
+  eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 128.0);
+}
+
 }  // namespace egr
@@ -15,7 +15,9 @@
 #include <sstream>
 
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
+#include "paddle/fluid/eager/amp_cast_cache.h"
 #include "paddle/fluid/eager/eager_tensor.h"
 #include "paddle/fluid/eager/grad_node_info.h"
 #include "paddle/fluid/eager/utils.h"
@@ -27,6 +29,8 @@
 
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 
+COMMON_DECLARE_bool(eager_amp_cast_cache);
+
 namespace egr {
 
 TEST(EagerUtils, AutoGradMeta) {
@@ -430,4 +434,56 @@ TEST(EagerUtils, FillZeroForEmptyOptionalGradInput) {
   eager_test::CompareTensorWithValue<float>(grads[0][0], 0.0);
 }
 
+TEST(EagerUtils, AmpCastCache) {
+  FLAGS_eager_amp_cast_cache = true;
+  AmpCastCache::Clear();
+  phi::DenseTensorMeta meta =
+      phi::DenseTensorMeta(phi::DataType::FLOAT32, common::make_ddim({1, 1}));
+  auto make_tensor = [&meta]() {
+    auto dt = std::make_shared<phi::DenseTensor>(
+        std::make_unique<paddle::experimental::DefaultAllocator>(
+            phi::CPUPlace())
+            .get(),
+        meta);
+    dt->mutable_data<float>(phi::CPUPlace())[0] = 1.0;
+    return paddle::Tensor(dt);
+  };
+  paddle::Tensor param = make_tensor();
+  paddle::Tensor activation = make_tensor();
+  EagerUtils::autograd_meta(&param)->SetPersistable(true);
+  EagerUtils::autograd_meta(&activation);
+
+  int cast_num = 0;
+  auto cast = [&]() {
+    ++cast_num;
+    return make_tensor();
+  };
+  auto first =
+      AmpCastCache::GetOrCast(param, phi::DataType::FLOAT16, false, cast);
+  auto second =
+      AmpCastCache::GetOrCast(param, phi::DataType::FLOAT16, false, cast);
+  ASSERT_EQ(cast_num, 1);
+  ASSERT_EQ(first.impl(), second.impl());
+  ASSERT_EQ(AmpCastCache::Size(), 1UL);
+
+  // the non persistable tensors are cast every time
+  AmpCastCache::GetOrCast(activation, phi::DataType::FLOAT16, false, cast);
+  AmpCastCache::GetOrCast(activation, phi::DataType::FLOAT16, false, cast);
+  ASSERT_EQ(cast_num, 3);
+
+  // an inplace update of the parameter drops its cast
+  param.bump_inplace_version();
+  auto third =
+      AmpCastCache::GetOrCast(param, phi::DataType::FLOAT16, false, cast);
+  ASSERT_EQ(cast_num, 4);
+  ASSERT_NE(first.impl(), third.impl());
+
+  AmpCastCache::Clear();
+  ASSERT_EQ(AmpCastCache::Size(), 0UL);
+  FLAGS_eager_amp_cast_cache = false;
+  AmpCastCache::GetOrCast(param, phi::DataType::FLOAT16, false, cast);
+  ASSERT_EQ(cast_num, 5);
+  ASSERT_EQ(AmpCastCache::Size(), 0UL);
+}
+
 }  // namespace egr
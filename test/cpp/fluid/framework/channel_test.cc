@@ -0,0 +1,138 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/channel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+Channel<int64_t> MakeBoundedChannel(size_t capacity, bool lock_free) {
+  auto chan = MakeChannel<int64_t>(capacity);
+  if (lock_free) {
+    chan->EnableLockFree();
+  }
+  return chan;
+}
+
+// Run writers and readers moving blocks of block_size through the channel,
+// and check every value is read once.
+void RunChannel(const Channel<int64_t>& chan,
+                  int writers,
+                  int readers,
+                  int64_t per_writer,
+                  size_t block_size) {
+  std::atomic<int64_t> sum{0};
+  std::atomic<int64_t> count{0};
+  std::atomic<int> running_writers{writers};
+  std::vector<std::thread> threads;
+  for (int w = 0; w < writers; ++w) {
+    threads.emplace_back([&, w]() {
+      std::vector<int64_t> block;
+      for (int64_t i = 0; i < per_writer; ++i) {
+        block.push_back(w * per_writer + i);
+        if (block.size() == block_size || i + 1 == per_writer) {
+          EXPECT_EQ(chan->Write(block.size(), block.data()), block.size());
+          block.clear();
+        }
+      }
+      if (--running_writers == 0) {
+        chan->Close();
+      }
+    });
+  }
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&]() {
+      std::vector<int64_t> block(block_size);
+      size_t n = 0;
+      while ((n = chan->Read(block.size(), block.data())) != 0) {
+        for (size_t i = 0; i < n; ++i) {
+          sum += block[i];
+        }
+        count += static_cast<int64_t>(n);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  const int64_t total = writers * per_writer;
+  EXPECT_EQ(count.load(), total);
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+  EXPECT_TRUE(chan->Empty());
+}
+
+}  // namespace
+
+TEST(Channel, LockFreeOrder) {
+  auto chan = MakeBoundedChannel(5, true);
+  EXPECT_TRUE(chan->IsLockFree());
+  std::vector<int64_t> in = {0, 1, 2, 3, 4, 5, 6, 7};
+  // the capacity 5 is rounded up to 8
+  EXPECT_EQ(chan->Write(in), in.size());
+  EXPECT_EQ(chan->Size(), in.size());
+
+  int64_t val = -1;
+  EXPECT_TRUE(chan->Get(val));
+  EXPECT_EQ(val, 0);
+  std::vector<int64_t> out;
+  EXPECT_EQ(chan->ReadOnce(out, 3), 3UL);
+  EXPECT_EQ(out, std::vector<int64_t>({1, 2, 3}));
+
+  chan->Close();
+  EXPECT_FALSE(chan->Put(8));
+  EXPECT_EQ(chan->ReadAll(out), 4UL);
+  EXPECT_EQ(out, std::vector<int64_t>({4, 5, 6, 7}));
+  EXPECT_FALSE(chan->Get(val));
+}
+
+TEST(Channel, LockFreeWrapAround) {
+  auto chan = MakeBoundedChannel(4, true);
+  int64_t val = -1;
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(chan->Put(i));
+    EXPECT_TRUE(chan->Put(i + 1));
+    EXPECT_TRUE(chan->Get(val));
+    EXPECT_EQ(val, i);
+    EXPECT_TRUE(chan->Get(val));
+    EXPECT_EQ(val, i + 1);
+  }
+  EXPECT_TRUE(chan->Put(1));
+  chan->Clear();
+  EXPECT_TRUE(chan->Empty());
+}
+
+TEST(Channel, LockFreeManyToMany) {
+  RunChannel(MakeBoundedChannel(64, true), 8, 8, 10000, 16);
+  RunChannel(MakeBoundedChannel(1, true), 4, 4, 1000, 3);
+}
+
+// Both modes under many readers and writers of single values and blocks.
+TEST(Channel, Contention) {
+  for (bool lock_free : {false, true}) {
+    for (size_t block_size : {1, 64}) {
+      RunChannel(MakeBoundedChannel(4096, lock_free), 32, 32, 1000, block_size);
+    }
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
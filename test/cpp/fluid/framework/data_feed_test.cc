@@ -344,3 +344,29 @@ TEST(DataFeed, MultiSlotUnitTest) {
   // GetElemSetFromFile(&file_elem_set, data_feed_desc, filelist);
   // CheckIsUnorderedSame(reader_elem_set, file_elem_set);
 }
+
+TEST(DataFeed, SlotValuesCompress) {
+  std::vector<std::vector<uint64_t>> uint64_slots = {
+      {3, 1, 4}, {}, {1UL << 60, 5}};
+  paddle::framework::SlotValues<uint64_t> uint64_values;
+  uint64_values.add_slot_feasigns(uint64_slots, 5);
+  auto expected_uint64 = uint64_values;
+  uint64_values.compress(false);
+  EXPECT_TRUE(uint64_values.is_packed());
+  EXPECT_EQ(uint64_values.value_num(), 5UL);
+  paddle::framework::SlotValues<uint64_t> uint64_scratch;
+  const auto& uint64_unpacked = uint64_values.unpacked(&uint64_scratch);
+  EXPECT_EQ(uint64_unpacked.slot_values, expected_uint64.slot_values);
+  EXPECT_EQ(uint64_unpacked.slot_offsets, expected_uint64.slot_offsets);
+
+  std::vector<std::vector<float>> float_slots = {{0.5f, -2.0f}, {1.0f}};
+  paddle::framework::SlotValues<float> float_values;
+  float_values.add_slot_feasigns(float_slots, 3);
+  auto expected_float = float_values;
+  float_values.compress(true);
+  paddle::framework::SlotValues<float> float_scratch;
+  const auto& float_unpacked = float_values.unpacked(&float_scratch);
+  // the values are exact in fp16
+  EXPECT_EQ(float_unpacked.slot_values, expected_float.slot_values);
+  EXPECT_EQ(float_unpacked.slot_offsets, expected_float.slot_offsets);
+}
@@ -16,7 +16,12 @@
 
 #include <gtest/gtest.h>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/operator.h"
+
+COMMON_DECLARE_bool(device_worker_cache_runtime_context);
+COMMON_DECLARE_bool(pull_dense_delta_copy);
 
 namespace paddle {
 namespace framework {
@@ -107,5 +112,89 @@ TEST(LodTensor, CheckValidOutput) {
   ASSERT_TRUE(CheckValidOutput(&tensor, 2));
 }
 
+class CacheTestWorker : public HogwildWorker {
+ public:
+  using HogwildWorker::EnableRuntimeContextCache;
+};
+
+class CacheTestKernelOp : public OperatorWithKernel {
+ public:
+  using OperatorWithKernel::OperatorWithKernel;
+
+ protected:
+  void InferShape(InferShapeContext* ctx) const override {}
+};
+
+class CacheTestOp : public OperatorBase {
+ public:
+  using OperatorBase::OperatorBase;
+
+ private:
+  void RunImpl(const Scope& scope, const phi::Place& place) const override {}
+};
+
+TEST(DeviceWorker, EnableRuntimeContextCache) {
+  std::vector<std::unique_ptr<OperatorBase>> ops;
+  ops.emplace_back(new CacheTestKernelOp(
+      "kernel_op", {{"X", {"x"}}}, {{"Out", {"out"}}}, AttributeMap()));
+  ops.emplace_back(new CacheTestOp(
+      "control_op", {{"X", {"out"}}}, {}, AttributeMap()));
+  CacheTestWorker worker;
+
+  worker.EnableRuntimeContextCache(ops);
+  EXPECT_FALSE(ops[0]->HasAttr(kEnableCacheRuntimeContext));
+
+  FLAGS_device_worker_cache_runtime_context = true;
+  worker.EnableRuntimeContextCache(ops);
+  FLAGS_device_worker_cache_runtime_context = false;
+  // only the kernel ops run with a RuntimeContext
+  ASSERT_TRUE(ops[0]->HasAttr(kEnableCacheRuntimeContext));
+  EXPECT_TRUE(ops[0]->Attr<bool>(kEnableCacheRuntimeContext));
+  EXPECT_TRUE(ops[0]->Attrs().empty());
+  EXPECT_FALSE(ops[1]->HasAttr(kEnableCacheRuntimeContext));
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
+    defined(PADDLE_WITH_XPU)
+TEST(PullDenseWorker, ChangedRanges) {
+  using Ranges = std::vector<std::pair<int64_t, int64_t>>;
+  // the block size of the comparison in PullDenseWorker
+  constexpr int64_t kBlock = 16384;
+  constexpr int64_t kNumel = 4 * kBlock + 100;
+  std::vector<float> values(kNumel, 1.0f);
+  PullDenseWorker worker;
+  EXPECT_EQ(worker.ChangedRanges("w", values.data(), kNumel),
+            Ranges({{0, kNumel}}));
+
+  FLAGS_pull_dense_delta_copy = true;
+  // the first pull is copied in full, the unchanged values are not copied
+  EXPECT_EQ(worker.ChangedRanges("w", values.data(), kNumel),
+            Ranges({{0, kNumel}}));
+  EXPECT_EQ(worker.ChangedRanges("w", values.data(), kNumel), Ranges());
+
+  values[5] = 2.0f;
+  values[3 * kBlock + 1] = 2.0f;
+  EXPECT_EQ(worker.ChangedRanges("w", values.data(), kNumel),
+            Ranges({{0, kBlock}, {3 * kBlock, 4 * kBlock}}));
+
+  // the adjacent changed blocks are merged, up to the partial last block
+  values[kBlock] = 3.0f;
+  values[3 * kBlock - 1] = 3.0f;
+  values[4 * kBlock] = 3.0f;
+  values[kNumel - 1] = 3.0f;
+  EXPECT_EQ(worker.ChangedRanges("w", values.data(), kNumel),
+            Ranges({{kBlock, 3 * kBlock}, {4 * kBlock, kNumel}}));
+  EXPECT_EQ(worker.ChangedRanges("w", values.data(), kNumel), Ranges());
+
+  // the vars are compared with their own values, a resized var is copied
+  // in full
+  EXPECT_EQ(worker.ChangedRanges("b", values.data(), kBlock),
+            Ranges({{0, kBlock}}));
+  EXPECT_EQ(worker.ChangedRanges("w", values.data(), kBlock),
+            Ranges({{0, kBlock}}));
+  FLAGS_pull_dense_delta_copy = false;
+}
+#endif
+
 }  // namespace framework
 }  // namespace paddle
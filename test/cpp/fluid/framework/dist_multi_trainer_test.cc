@@ -12,6 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <set>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "paddle/common/flags.h"
 #include "paddle/fluid/framework/trainer.h"
@@ -171,5 +178,112 @@ TEST(DisMultiTrainerTest, test3) {
 #endif
 }
 
+class StalenessTestWorker : public DownpourWorker {
+ public:
+  using DownpourWorker::BoundPushStaleness;
+  // the sparse and the dense push of a batch, they record the batch when
+  // they are waited for
+  void Push(int batch, std::vector<int>* pushed) {
+    for (auto* status : {&push_sparse_status_, &push_dense_status_}) {
+      status->push_back(std::async(std::launch::deferred, [=] {
+        pushed->push_back(batch);
+        return 0;
+      }));
+    }
+  }
+  size_t InflightBatchNum() const { return inflight_push_status_.size(); }
+};
+
+TEST(DownpourWorker, BoundPushStaleness) {
+  std::vector<int> pushed;
+  StalenessTestWorker unbounded;
+  for (int batch = 0; batch < 3; ++batch) {
+    unbounded.Push(batch, &pushed);
+    unbounded.BoundPushStaleness(-1);
+  }
+  EXPECT_TRUE(pushed.empty());
+  EXPECT_EQ(unbounded.InflightBatchNum(), 0UL);
+
+  StalenessTestWorker worker;
+  std::vector<int> expected;
+  for (int batch = 0; batch < 5; ++batch) {
+    worker.Push(batch, &pushed);
+    worker.BoundPushStaleness(2);
+    // the pushes of the batch 2 batches before are done
+    if (batch >= 2) {
+      expected.insert(expected.end(), {batch - 2, batch - 2});
+    }
+    EXPECT_EQ(pushed, expected);
+    EXPECT_EQ(worker.InflightBatchNum(),
+              static_cast<size_t>(std::min(batch + 1, 2)));
+  }
+  // a batch without pushes does not count
+  worker.BoundPushStaleness(2);
+  EXPECT_EQ(pushed, expected);
+  EXPECT_EQ(worker.InflightBatchNum(), 2UL);
+
+  // the end of the pass waits for all of them
+  worker.BoundPushStaleness(0);
+  EXPECT_EQ(pushed, std::vector<int>({0, 0, 1, 1, 2, 2, 3, 3, 4, 4}));
+  EXPECT_EQ(worker.InflightBatchNum(), 0UL);
+}
+
+TEST(SlotObjPool, NumaLocalArenas) {
+  FLAGS_slotpool_numa_local = true;
+  auto pool = std::make_unique<SlotObjPool>();
+  FLAGS_slotpool_numa_local = false;
+  auto nodes = GetNumaNodeCpus();
+  // a single arena if the topology is unknown
+  if (nodes.empty()) {
+    nodes.emplace_back();
+  }
+  // the cpus of a node may be out of the cpuset of the process
+  auto bind = [&nodes](size_t node) {
+    return nodes[node].empty() || SetCurrentThreadAffinity(nodes[node]);
+  };
+  constexpr int kRecordNum = 4;
+  std::vector<std::vector<SlotRecord>> records(nodes.size());
+  std::vector<bool> bound(nodes.size(), false);
+  // binds a thread of its own, the affinity of the test thread is kept
+  std::thread thread([&]() {
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      bound[node] = bind(node);
+      if (!bound[node]) {
+        continue;
+      }
+      pool->get(&records[node], kRecordNum);
+      for (auto* record : records[node]) {
+        EXPECT_EQ(record->numa_node, static_cast<int>(node));
+      }
+    }
+    std::vector<std::set<SlotRecord>> created(nodes.size());
+    size_t total = 0;
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      created[node].insert(records[node].begin(), records[node].end());
+      total += records[node].size();
+      pool->put(&records[node]);
+    }
+    // the records are recycled by the threads of the pool
+    for (int i = 0; i < 10000 && pool->capacity() < total; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(pool->capacity(), total);
+
+    // a thread gets the records created on its node back
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      if (!bound[node]) {
+        continue;
+      }
+      ASSERT_TRUE(bind(node));
+      pool->get(&records[node], kRecordNum);
+      for (auto* record : records[node]) {
+        EXPECT_TRUE(created[node].count(record));
+      }
+      pool->put(&records[node]);
+    }
+  });
+  thread.join();
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -0,0 +1,77 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/async_checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "paddle/fluid/framework/io/fs.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(AsyncCheckpoint, save_and_load_by_name) {
+#if !defined(_WIN32) && !defined(__APPLE__)
+  std::string dirname = "async_checkpoint_test";
+  fs_remove(dirname);
+
+  std::vector<phi::DenseTensor> tensors(5);
+  std::vector<std::string> names;
+  std::vector<const phi::DenseTensor*> inputs;
+  for (int i = 0; i < 5; ++i) {
+    int64_t* data = tensors[i].mutable_data<int64_t>(
+        common::make_ddim({i + 1, 3}), phi::CPUPlace());
+    for (int j = 0; j < (i + 1) * 3; ++j) {
+      data[j] = i * 100 + j;
+    }
+    names.push_back("tensor " + std::to_string(i));
+    inputs.push_back(&tensors[i]);
+  }
+
+  AsyncCheckpointSaver saver(2);
+  saver.Save(dirname, names, inputs, 3);
+  // the snapshots are taken, the tensors can be changed
+  for (auto& tensor : tensors) {
+    tensor.data<int64_t>()[0] = -1;
+  }
+  saver.Wait();
+
+  auto saved = ListCheckpoint(dirname);
+  std::sort(saved.begin(), saved.end());
+  EXPECT_EQ(saved, names);
+
+  // load a part of the tensors, e.g. by another rank after a reshard
+  std::vector<phi::DenseTensor> loaded(2);
+  LoadCheckpoint(dirname,
+                 {"tensor 3", "tensor 1"},
+                 {&loaded[0], &loaded[1]});
+  for (int k = 0; k < 2; ++k) {
+    int i = k == 0 ? 3 : 1;
+    EXPECT_EQ(loaded[k].dims(), common::make_ddim({i + 1, 3}));
+    const int64_t* data = loaded[k].data<int64_t>();
+    for (int j = 0; j < (i + 1) * 3; ++j) {
+      EXPECT_EQ(data[j], i * 100 + j);
+    }
+  }
+
+  phi::DenseTensor missing;
+  EXPECT_ANY_THROW(LoadCheckpoint(dirname, {"tensor 5"}, {&missing}));
+  fs_remove(dirname);
+#endif
+}
+
+}  // namespace framework
+}  // namespace paddle
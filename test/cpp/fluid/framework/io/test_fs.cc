@@ -15,14 +15,20 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <string>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/framework/io/hdfs_native.h"
 
 #if defined _WIN32 || defined __APPLE__
 #else
 #define _LINUX
 #endif
 
+COMMON_DECLARE_bool(hdfs_native_read);
+COMMON_DECLARE_string(hdfs_native_lib);
+
 TEST(FS, mv) {
 #ifdef _LINUX
   std::ofstream out("src.txt");
@@ -60,3 +66,27 @@ TEST(FS, mv) {
 
 #endif
 }
+
+TEST(FS, hdfs_native_read) {
+#ifdef _LINUX
+  EXPECT_EQ(paddle::framework::fs_select_internal("hdfs:/none"), 1);
+  FLAGS_hdfs_native_read = true;
+  FLAGS_hdfs_native_lib = "libhdfs_not_exist.so";
+  EXPECT_EQ(paddle::framework::fs_select_internal("hdfs:/none"), 2);
+  // afs keeps going through the hadoop client
+  EXPECT_EQ(paddle::framework::fs_select_internal("afs:/none"), 1);
+  // without libhdfs callers get nullptr and fall back to the pipe
+  EXPECT_EQ(paddle::framework::hdfs_native_open_read(
+                "hdfs:/none", paddle::framework::hdfs_command()),
+            nullptr);
+  // moving between hdfs: and afs: is still allowed
+  try {
+    paddle::framework::fs_mv("hdfs:/none", "afs:/none");
+  } catch (const std::exception& e) {
+    EXPECT_EQ(std::string(e.what()).find("not equal to destination"),
+              std::string::npos);
+  }
+  EXPECT_ANY_THROW(paddle::framework::fs_mv("none.txt", "hdfs:/none"));
+  FLAGS_hdfs_native_read = false;
+#endif
+}
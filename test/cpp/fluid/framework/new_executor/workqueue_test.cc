@@ -203,3 +203,52 @@ TEST(WorkQueue, TestWorkQueueGroup) {
   queue_group.reset();
   waiter_thread.join();
 }
+
+TEST(WorkQueue, TestNumaAwareWorkQueue) {
+  using paddle::framework::CreateMultiThreadedWorkQueue;
+  using paddle::framework::GetNumaNodeCpus;
+  using paddle::framework::WorkQueueOptions;
+  for (auto& cpus : GetNumaNodeCpus()) {
+    EXPECT_FALSE(cpus.empty());
+  }
+  std::atomic<unsigned> counter{0};
+  constexpr unsigned kTaskNum = 1000;
+  WorkQueueOptions options(/*name*/ "NumaAwareWorkQueueForTesting",
+                           /*num_threads*/ 4,
+                           /*allow_spinning*/ true,
+                           /*track_task*/ false);
+  options.numa_aware = true;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  EXPECT_EQ(work_queue->NumThreads(), 4u);
+  std::vector<std::future<void>> handles;
+  for (unsigned i = 0; i < kTaskNum; ++i) {
+    handles.emplace_back(work_queue->AddAwaitableTask([&counter]() {
+      ++counter;
+    }));
+  }
+  for (auto& handle : handles) {
+    handle.get();
+  }
+  EXPECT_EQ(counter.load(), kTaskNum);
+}
+
+TEST(WorkQueueUtils, TestNumaNodeOfBoundThread) {
+  using paddle::framework::GetCurrentNumaNode;
+  using paddle::framework::GetNumaNodeCpus;
+  using paddle::framework::SetCurrentThreadAffinity;
+  auto nodes = GetNumaNodeCpus();
+  if (nodes.empty()) {
+    EXPECT_EQ(GetCurrentNumaNode(), 0);
+    return;
+  }
+  // binds a thread of its own, the affinity of the test thread is kept
+  std::thread thread([&nodes]() {
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      // the cpus of the node may be out of the cpuset of the process
+      if (SetCurrentThreadAffinity(nodes[node])) {
+        EXPECT_EQ(GetCurrentNumaNode(), static_cast<int>(node));
+      }
+    }
+  });
+  thread.join();
+}
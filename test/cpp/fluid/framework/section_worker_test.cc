@@ -0,0 +1,135 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/device_worker.h"
+
+namespace paddle {
+namespace framework {
+
+using Step = SectionWorker::ScheduleStep;
+
+static std::string ToString(const std::vector<Step>& steps) {
+  std::string res;
+  for (auto& step : steps) {
+    if (!res.empty()) {
+      res += " ";
+    }
+    res += step.phase == SectionWorker::kForward    ? "F"
+           : step.phase == SectionWorker::kBackward ? "B"
+                                                    : "W";
+    res += std::to_string(step.micro_id);
+  }
+  return res;
+}
+
+TEST(SectionWorker, ZeroBubbleScheduleOrder) {
+  EXPECT_EQ(ToString(SectionWorker::ZeroBubbleSchedule(4, 2, 0)),
+            "F0 F1 B0 F2 B1 W0 F3 B2 W1 B3 W2 W3");
+  EXPECT_EQ(ToString(SectionWorker::ZeroBubbleSchedule(4, 2, 1)),
+            "F0 B0 W0 F1 B1 W1 F2 B2 W2 F3 B3 W3");
+  EXPECT_EQ(ToString(SectionWorker::ZeroBubbleSchedule(3, 3, 0)),
+            "F0 F1 F2 B0 B1 W0 B2 W1 W2");
+}
+
+TEST(SectionWorker, ZeroBubbleScheduleDependencies) {
+  for (int num_stages = 1; num_stages <= 4; ++num_stages) {
+    for (int stage = 0; stage < num_stages; ++stage) {
+      int startup_steps = num_stages - stage - 1;
+      for (int n = startup_steps + 1; n <= 8; ++n) {
+        auto steps = SectionWorker::ZeroBubbleSchedule(n, num_stages, stage);
+        ASSERT_EQ(steps.size(), static_cast<size_t>(3 * n));
+        // the F, B and W of a micro-batch run once each and in order, and
+        // the micro-batches run in order in each phase
+        std::vector<int> done(SectionWorker::kPhaseNum, 0);
+        for (auto& step : steps) {
+          ASSERT_EQ(step.micro_id, done[step.phase]);
+          if (step.phase == SectionWorker::kBackward) {
+            ASSERT_LT(step.micro_id, done[SectionWorker::kForward]);
+          } else if (step.phase == SectionWorker::kWeightGrad) {
+            ASSERT_LT(step.micro_id, done[SectionWorker::kBackward]);
+          }
+          // no more than startup_steps Ws are pending when an F or a B
+          // starts
+          if (step.phase != SectionWorker::kWeightGrad) {
+            ASSERT_LE(done[SectionWorker::kBackward] -
+                          done[SectionWorker::kWeightGrad],
+                      startup_steps);
+          }
+          ++done[step.phase];
+        }
+        EXPECT_EQ(done[SectionWorker::kWeightGrad], n);
+      }
+    }
+  }
+}
+
+class DummyOp : public OperatorBase {
+ public:
+  DummyOp(const std::string& type,
+          const VariableNameMap& inputs,
+          const VariableNameMap& outputs)
+      : OperatorBase(type, inputs, outputs, AttributeMap()) {}
+
+ private:
+  void RunImpl(const Scope& scope, const phi::Place& place) const override {}
+};
+
+TEST(SectionWorker, FindWeightGradOps) {
+  std::vector<std::unique_ptr<OperatorBase>> ops;
+  auto add_op = [&](const std::string& type,
+                    const VariableNameMap& inputs,
+                    const VariableNameMap& outputs) {
+    ops.emplace_back(new DummyOp(type, inputs, outputs));
+    return ops.back().get();
+  };
+  auto* recv = add_op("recv_v2", {}, {{"Out", {"out@GRAD"}}});
+  auto* add_grad = add_op("elementwise_add_grad",
+                          {{"Out@GRAD", {"out@GRAD"}}, {"Y", {"b"}}},
+                          {{"X@GRAD", {"mm@GRAD"}}, {"Y@GRAD", {"b@GRAD"}}});
+  auto* matmul_grad =
+      add_op("matmul_v2_grad",
+             {{"Out@GRAD", {"mm@GRAD"}}, {"X", {"x"}}, {"Y", {"w"}}},
+             {{"X@GRAD", {"x@GRAD"}}, {"Y@GRAD", {"w@GRAD"}}});
+  auto* merge_w = add_op("sum",
+                         {{"X", {"w@GRAD", "w@GRAD@MERGED"}}},
+                         {{"Out", {"w@GRAD@MERGED"}}});
+  auto* merge_b = add_op("sum",
+                         {{"X", {"b@GRAD", "b@GRAD@MERGED"}}},
+                         {{"Out", {"b@GRAD@MERGED"}}});
+  auto* send = add_op("send_v2", {{"X", {"x@GRAD"}}}, {});
+  auto* sync = add_op("c_sync_comm_stream", {{"X", {"x@GRAD"}}}, {});
+
+  std::vector<OperatorBase*> backward_ops;
+  for (auto& op : ops) {
+    backward_ops.push_back(op.get());
+  }
+  auto weight_grad_ops = SectionWorker::FindWeightGradOps(backward_ops);
+  // the merges of the parameter gradients are deferred, the ops the send
+  // depends on and the ops with no output are not
+  EXPECT_EQ(weight_grad_ops.size(), 2UL);
+  EXPECT_TRUE(weight_grad_ops.count(merge_w));
+  EXPECT_TRUE(weight_grad_ops.count(merge_b));
+  for (auto* op : {recv, add_grad, matmul_grad, send, sync}) {
+    EXPECT_FALSE(weight_grad_ops.count(op)) << op->Type();
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
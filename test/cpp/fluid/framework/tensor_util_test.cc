@@ -15,6 +15,8 @@
 #include <gtest/gtest.h>
 #include <array>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 
 #include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/operators/isfinite_op.h"
@@ -367,6 +369,39 @@ TEST(TensorFromDLPack, Tensor) {
 #endif
 }
 
+TEST(TensorFromDLPack, ManagedTensorZeroCopy) {
+  std::vector<int> src_vec = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  phi::DenseTensor cpu_tensor;
+  cpu_tensor.Resize(common::make_ddim({3, 4}));
+  phi::CPUContext cpu_ctx(phi::CPUPlace{});
+  paddle::framework::TensorFromVector<int>(src_vec, cpu_ctx, &cpu_tensor);
+
+  {
+    phi::DenseTensor dst_tensor;
+    paddle::framework::TensorFromDLPack(
+        paddle::framework::toDLPack(cpu_tensor), &dst_tensor);
+    EXPECT_EQ(dst_tensor.data<int>(), cpu_tensor.data<int>());
+    EXPECT_EQ(dst_tensor.dims(), cpu_tensor.dims());
+    EXPECT_EQ(dst_tensor.dtype(), phi::DataType::INT32);
+    EXPECT_TRUE(phi::is_cpu_place(dst_tensor.place()));
+  }
+
+  // the transposed view keeps its strides both ways
+  phi::DenseTensor transposed(cpu_tensor);
+  phi::DenseTensorMeta meta(phi::DataType::INT32, common::make_ddim({4, 3}));
+  meta.strides = common::make_ddim({1, 4});
+  transposed.set_meta(meta);
+  DLManagedTensor* dmt = paddle::framework::toDLPack(transposed);
+  EXPECT_EQ(dmt->dl_tensor.strides[0], 1);
+  EXPECT_EQ(dmt->dl_tensor.strides[1], 4);
+
+  phi::DenseTensor dst_tensor;
+  paddle::framework::TensorFromDLPack(dmt, &dst_tensor);
+  EXPECT_EQ(dst_tensor.data<int>(), cpu_tensor.data<int>());
+  EXPECT_EQ(dst_tensor.strides(), meta.strides);
+  EXPECT_EQ(dst_tensor.Holder()->size(), 12 * sizeof(int));
+}
+
 TEST(TensorContainsNAN, CPU) {
   {
     phi::DenseTensor src;
@@ -518,5 +553,40 @@ TEST(Tensor, FromAndToStream) {
 #endif
 }
 
+TEST(Tensor, FromMappedFile) {
+  phi::DenseTensor src_tensor;
+  src_tensor.Resize({2, 3});
+  int* src_ptr = src_tensor.mutable_data<int>(phi::CPUPlace());
+  for (int i = 0; i < 6; ++i) {
+    src_ptr[i] = i + 1;
+  }
+  phi::CPUContext cpu_ctx(phi::CPUPlace());
+  const std::string path = "tensor_util_test_mapped.bin";
+  {
+    std::ofstream fout(path, std::ios::binary);
+    TensorToStream(fout, src_tensor, cpu_ctx);
+    TensorToStream(fout, src_tensor, cpu_ctx);
+  }
+
+  MappedFileStreamBuf mapped(path);
+  ASSERT_TRUE(mapped.is_open());
+  std::istream iss(&mapped);
+  for (int k = 0; k < 2; ++k) {
+    phi::DenseTensor dst_tensor;
+    TensorFromStream(iss, &dst_tensor, cpu_ctx);
+    EXPECT_EQ(dst_tensor.dims(), src_tensor.dims());
+    const int* dst_ptr = dst_tensor.data<int>();
+    for (int i = 0; i < 6; ++i) {
+      EXPECT_EQ(dst_ptr[i], i + 1);
+    }
+  }
+  iss.peek();
+  EXPECT_TRUE(iss.eof());
+  EXPECT_EQ(mapped.remaining(), 0UL);
+
+  EXPECT_FALSE(MappedFileStreamBuf("not_exist_file.bin").is_open());
+  std::remove(path.c_str());
+}
+
 }  // namespace framework
 }  // namespace paddle
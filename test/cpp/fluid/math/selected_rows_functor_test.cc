@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
+#include <map>
+
 #include "gtest/gtest.h"
 #include "paddle/phi/core/memory/allocation/allocator_facade.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -431,6 +433,62 @@ TEST(selected_rows_functor, cpu_merge_add_multi_noduplicated) {
   }
 }
 
+TEST(selected_rows_functor, cpu_merge_add_multi_many_duplicated) {
+  phi::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+
+  int64_t height = 1000;
+  int64_t row_numel = 37;
+  int num_inputs = 4;
+  int64_t rows_per_input = 500;
+
+  std::vector<std::unique_ptr<phi::SelectedRows>> selected_rows;
+  std::vector<const phi::SelectedRows*> inputs;
+  std::map<int64_t, std::vector<float>> expected;
+  for (int i = 0; i < num_inputs; ++i) {
+    std::vector<int64_t> rows;
+    for (int64_t r = 0; r < rows_per_input; ++r) {
+      rows.push_back((r * 7 + i * 13) % 97 * 10);
+    }
+    selected_rows.emplace_back(new phi::SelectedRows(rows, height));
+    auto* value = selected_rows.back()->mutable_value();
+    auto* data = value->mutable_data<float>(
+        common::make_ddim({rows_per_input, row_numel}), cpu_place);
+    for (int64_t r = 0; r < rows_per_input; ++r) {
+      auto& sum = expected[rows[r]];
+      sum.resize(row_numel, 0.f);
+      for (int64_t j = 0; j < row_numel; ++j) {
+        data[r * row_numel + j] = static_cast<float>((r + i + j) % 5);
+        sum[j] += data[r * row_numel + j];
+      }
+    }
+    inputs.push_back(selected_rows.back().get());
+  }
+
+  std::unique_ptr<phi::SelectedRows> output{new phi::SelectedRows()};
+  output->set_height(height);
+  phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add_functor;
+  merge_add_functor(ctx, inputs, output.get());
+
+  EXPECT_EQ(output->height(), height);
+  EXPECT_EQ(output->value().dims(),
+            common::make_ddim({static_cast<int64_t>(expected.size()),
+                               row_numel}));
+
+  auto* out_data = output->value().data<float>();
+  size_t i = 0;
+  for (auto& item : expected) {
+    EXPECT_EQ(output->rows()[i], item.first);
+    for (int64_t j = 0; j < row_numel; ++j) {
+      EXPECT_EQ(out_data[i * row_numel + j], item.second[j]);
+    }
+    ++i;
+  }
+}
+
 TEST(selected_rows_functor, cpu_sum_to) {
   phi::CPUPlace cpu_place;
   phi::CPUContext ctx(cpu_place);
@@ -0,0 +1,70 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/allocation_trace.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/memory/allocation/cpu_allocator.h"
+#include "paddle/phi/core/memory/allocation/stat_allocator.h"
+
+COMMON_DECLARE_string(alloc_trace_file);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(AllocationTracer, RecordAndLoad) {
+  const std::string path = "allocation_trace_test.trace";
+  // set before the first StatAllocator creates the tracer
+  FLAGS_alloc_trace_file = path;
+  ASSERT_NE(AllocationTracer::Instance(), nullptr);
+
+  auto allocator = std::make_shared<StatAllocator>(
+      std::make_shared<CPUAllocator>(), /*stream=*/7);
+  uint64_t first_ptr = 0;
+  {
+    auto first = allocator->Allocate(256);
+    auto second = allocator->Allocate(1024);
+    first_ptr = reinterpret_cast<uintptr_t>(first->ptr());
+  }
+  AllocationTracer::Instance()->Flush();
+
+  auto events = AllocationTracer::Load(path);
+  ASSERT_EQ(events.size(), 4UL);
+  EXPECT_TRUE(events[0].is_alloc);
+  EXPECT_TRUE(events[1].is_alloc);
+  EXPECT_FALSE(events[2].is_alloc);
+  EXPECT_FALSE(events[3].is_alloc);
+  EXPECT_EQ(events[0].size, 256UL);
+  EXPECT_EQ(events[1].size, 1024UL);
+  EXPECT_EQ(events[0].ptr, first_ptr);
+  // the second allocation is destroyed first
+  EXPECT_EQ(events[3].ptr, first_ptr);
+  for (size_t i = 0; i < events.size(); ++i) {
+    EXPECT_EQ(events[i].place_type, phi::AllocationType::CPU);
+    EXPECT_EQ(events[i].stream, 7UL);
+    if (i > 0) {
+      EXPECT_GE(events[i].time_ns, events[i - 1].time_ns);
+    }
+  }
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -21,6 +21,7 @@
 
 PD_DECLARE_bool(free_idle_chunk);
 PD_DECLARE_bool(free_when_no_cache_hit);
+PD_DECLARE_uint64(auto_growth_small_block_size);
 
 namespace paddle {
 namespace memory {
@@ -158,6 +159,46 @@ void TestFreeWhenNoCacheHit(bool free_when_no_cache_hit) {
             allocate_size[2] + alignment);
 }
 
+static void TestSmallBlockCache() {
+  FLAGS_free_idle_chunk = false;
+  FLAGS_free_when_no_cache_hit = false;
+  FLAGS_auto_growth_small_block_size = 1024;
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  size_t alignment = 256;
+  size_t chunk_size = 4096;
+  auto ag_allocator = std::make_shared<AutoGrowthBestFitAllocator>(
+      recorded_allocator, alignment, chunk_size);
+  FLAGS_auto_growth_small_block_size = 0;
+
+  // A freed small block is handed out again for the same aligned size.
+  auto small = ag_allocator->Allocate(300);
+  void *small_ptr = small->ptr();
+  small.reset();
+  small = ag_allocator->Allocate(400);
+  ASSERT_EQ(small->ptr(), small_ptr);
+  ASSERT_EQ(small->size(), 512UL);
+  small.reset();
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), chunk_size);
+
+  // Cached blocks are not merged, so a chunk sized request needs a new chunk
+  // until the cache is flushed by Release.
+  auto large = ag_allocator->Allocate(chunk_size);
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), 2 * chunk_size);
+  large.reset();
+  ag_allocator->Release(phi::CPUPlace());
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), 0UL);
+
+  // Large blocks still go through the best-fit pool.
+  large = ag_allocator->Allocate(2048);
+  void *large_ptr = large->ptr();
+  large.reset();
+  small = ag_allocator->Allocate(2048);
+  ASSERT_EQ(small->ptr(), large_ptr);
+  small.reset();
+  ag_allocator->Release(phi::CPUPlace());
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), 0UL);
+}
+
 TEST(test_auto_growth_allocator, test_free_idle_chunk) {
   for (auto free_idle_chunk : {false, true}) {
     for (auto free_when_no_cache_hit : {false, true}) {
@@ -171,6 +212,10 @@ TEST(test_auto_growth_allocator, test_free_when_no_cache_hit) {
   TestFreeWhenNoCacheHit(true);
 }
 
+TEST(test_auto_growth_allocator, test_small_block_cache) {
+  TestSmallBlockCache();
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
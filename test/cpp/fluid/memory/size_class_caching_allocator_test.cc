@@ -0,0 +1,149 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/size_class_caching_allocator.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class CountingAllocator : public Allocator {
+ public:
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t GetAllocCount() const { return alloc_count_; }
+
+  size_t GetFreeCount() const { return free_count_; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    ++alloc_count_;
+    return new Allocation(new uint8_t[size], size, phi::CPUPlace());
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    ++free_count_;
+    delete[] static_cast<uint8_t *>(allocation->ptr());
+    delete allocation;
+  }
+
+ private:
+  std::atomic<size_t> alloc_count_{0};
+  std::atomic<size_t> free_count_{0};
+};
+
+constexpr size_t kMinSize = 1 << 12;
+constexpr size_t kCacheLimit = 1 << 20;
+
+TEST(SizeClassCachingAllocator, SizeClass) {
+  auto underlying = std::make_shared<CountingAllocator>();
+  auto allocator = std::make_shared<SizeClassCachingAllocator>(
+      underlying, kMinSize, kCacheLimit, kCacheLimit);
+
+  EXPECT_EQ(allocator->RoundUp(1), kMinSize);
+  EXPECT_EQ(allocator->RoundUp(kMinSize), kMinSize);
+  EXPECT_EQ(allocator->RoundUp(kMinSize + 1), 2 * kMinSize);
+  EXPECT_EQ(allocator->RoundUp(kCacheLimit), kCacheLimit);
+  // larger requests are not rounded to a class
+  EXPECT_EQ(allocator->RoundUp(kCacheLimit + 1), kCacheLimit + kMinSize);
+
+  void *ptr = nullptr;
+  {
+    auto allocation = allocator->Allocate(3 * kMinSize);
+    EXPECT_EQ(allocation->size(), 4 * kMinSize);
+    ptr = allocation->ptr();
+  }
+  EXPECT_EQ(allocator->CachedSize(), 4 * kMinSize);
+  EXPECT_EQ(underlying->GetFreeCount(), 0UL);
+
+  // any request of the same class reuses the block
+  {
+    auto allocation = allocator->Allocate(4 * kMinSize - 1);
+    EXPECT_EQ(allocation->ptr(), ptr);
+    EXPECT_EQ(allocator->CachedSize(), 0UL);
+  }
+  EXPECT_EQ(underlying->GetAllocCount(), 1UL);
+
+  { auto allocation = allocator->Allocate(kCacheLimit + 1); }
+  EXPECT_EQ(underlying->GetAllocCount(), 2UL);
+  EXPECT_EQ(underlying->GetFreeCount(), 1UL);
+
+  EXPECT_EQ(allocator->Release(phi::CPUPlace()), 4 * kMinSize);
+  EXPECT_EQ(allocator->CachedSize(), 0UL);
+  EXPECT_EQ(underlying->GetFreeCount(), 2UL);
+}
+
+TEST(SizeClassCachingAllocator, CacheLimit) {
+  auto underlying = std::make_shared<CountingAllocator>();
+  auto allocator = std::make_shared<SizeClassCachingAllocator>(
+      underlying, kMinSize, kCacheLimit, kCacheLimit);
+
+  std::vector<AllocationPtr> allocations;
+  for (int i = 0; i < 3; ++i) {
+    allocations.emplace_back(allocator->Allocate(kCacheLimit / 2));
+  }
+  allocations.clear();
+  // the third block would exceed the limit
+  EXPECT_EQ(allocator->CachedSize(), kCacheLimit);
+  EXPECT_EQ(underlying->GetFreeCount(), 1UL);
+
+  allocator.reset();
+  EXPECT_EQ(underlying->GetFreeCount(), 3UL);
+}
+
+TEST(SizeClassCachingAllocator, ThreadCache) {
+  auto underlying = std::make_shared<CountingAllocator>();
+  auto allocator = std::make_shared<SizeClassCachingAllocator>(
+      underlying, kMinSize, kCacheLimit, 4 * kMinSize);
+
+  constexpr int kThreadNum = 4;
+  constexpr int kIterNum = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&allocator] {
+      for (int j = 0; j < kIterNum; ++j) {
+        auto small = allocator->Allocate(kMinSize);
+        auto large = allocator->Allocate(8 * kMinSize);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // every thread allocates at most two blocks at a time, and the blocks
+  // cached by the threads are handed back to the pool when they exit
+  EXPECT_LE(underlying->GetAllocCount(), 2UL * kThreadNum);
+  EXPECT_EQ(underlying->GetFreeCount(), 0UL);
+  EXPECT_GE(allocator->CachedSize(), 9 * kMinSize);
+  EXPECT_LE(allocator->CachedSize(), 9 * kMinSize * kThreadNum);
+
+  size_t alloc_count = underlying->GetAllocCount();
+  { auto small = allocator->Allocate(kMinSize); }
+  EXPECT_EQ(underlying->GetAllocCount(), alloc_count);
+
+  allocator->Release(phi::CPUPlace());
+  EXPECT_EQ(allocator->CachedSize(), 0UL);
+  EXPECT_EQ(underlying->GetFreeCount(), alloc_count);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -173,5 +173,27 @@ TEST_F(StatsTest, HostReservedTest) {
   RunTests();
 }
 
+TEST(StreamMemoryStatTest, PeakPerStream) {
+  int stream1 = 0, stream2 = 0;
+  StreamMemoryStat* stat1 = GetStreamMemoryStat("Allocated", 0, &stream1);
+  StreamMemoryStat* stat2 = GetStreamMemoryStat("Allocated", 0, &stream2);
+  EXPECT_EQ(stat1, GetStreamMemoryStat("Allocated", 0, &stream1));
+  EXPECT_NE(stat1, stat2);
+
+  stat1->Update(100);
+  stat2->Update(10);
+  stat1->Update(-60);
+  stat2->Update(50);
+  EXPECT_EQ(stat1->GetCurrentValue(), 40);
+  EXPECT_EQ(stat1->GetPeakValue(), 100);
+  EXPECT_EQ(stat2->GetCurrentValue(), 60);
+  EXPECT_EQ(stat2->GetPeakValue(), 60);
+
+  auto values = StreamMemoryStatValues("Allocated", 0);
+  EXPECT_EQ(values.at(&stream1).peak, 100);
+  EXPECT_EQ(values.at(&stream2).current, 60);
+  EXPECT_EQ(StreamMemoryStatValues("Deferred", 0).count(&stream1), 0UL);
+}
+
 }  // namespace memory
 }  // namespace paddle
@@ -16,10 +16,12 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/phi/core/memory/allocation/allocator_facade.h"
 #include "paddle/phi/core/memory/memory.h"
+#include "paddle/phi/core/memory/stats.h"
 #include "paddle/phi/core/stream.h"
 
 #ifdef PADDLE_WITH_CUDA
@@ -41,6 +43,8 @@
     }                                                    \
   }
 
+COMMON_DECLARE_bool(stream_safe_cuda_allocator_ordered_reuse);
+
 namespace paddle {
 namespace memory {
 
@@ -192,6 +196,78 @@ TEST(StreamSafeCUDAAllocInterfaceTest, GetStreamInterfaceTest) {
   CheckMemLeak(place);
 }
 
+TEST(StreamSafeCUDAAllocInterfaceTest, OrderedReuseTest) {
+  RETURN_IF_NOT_ENABLED;
+
+  FLAGS_stream_safe_cuda_allocator_ordered_reuse = true;
+  phi::GPUPlace place = phi::GPUPlace();
+  size_t alloc_size = 1 << 20;
+  int n = alloc_size / sizeof(int);
+  gpuStream_t stream1, stream2;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&stream1));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&stream2));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamCreate(&stream1));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamCreate(&stream2));
+#endif
+  StreamMemoryStat *allocated_stat =
+      GetStreamMemoryStat("Allocated", place.device, stream1);
+  StreamMemoryStat *deferred_stat =
+      GetStreamMemoryStat("Deferred", place.device, stream1);
+
+  std::shared_ptr<Allocation> x = AllocShared(
+      place, alloc_size, phi::Stream(reinterpret_cast<phi::StreamId>(stream1)));
+  std::shared_ptr<Allocation> y = AllocShared(
+      place, alloc_size, phi::Stream(reinterpret_cast<phi::StreamId>(stream2)));
+  void *address = x->ptr();
+  EXPECT_EQ(allocated_stat->GetCurrentValue(),
+            static_cast<int64_t>(x->size()));
+
+  // x is freed while stream2 may still read it
+  for (int i = 0; i < 100; ++i) {
+#ifdef PADDLE_WITH_CUDA
+    add_kernel<<<1, 64, 0, stream2>>>(reinterpret_cast<int *>(x->ptr()),
+                                      reinterpret_cast<int *>(y->ptr()),
+                                      n);
+#else
+    hipLaunchKernelGGL(add_kernel,
+                       dim3(1),
+                       dim3(64),
+                       0,
+                       stream2,
+                       reinterpret_cast<int *>(x->ptr()),
+                       reinterpret_cast<int *>(y->ptr()),
+                       n);
+#endif
+  }
+  RecordStream(x, stream2);
+  x.reset();
+
+  std::shared_ptr<Allocation> z = AllocShared(
+      place, alloc_size, phi::Stream(reinterpret_cast<phi::StreamId>(stream1)));
+  EXPECT_EQ(z->ptr(), address);
+  EXPECT_EQ(deferred_stat->GetCurrentValue(), 0);
+  EXPECT_EQ(allocated_stat->GetCurrentValue(),
+            static_cast<int64_t>(z->size()));
+
+  y.reset();
+  z.reset();
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceSynchronize());
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(stream1));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(stream2));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipDeviceSynchronize());
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(stream1));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(stream2));
+#endif
+  FLAGS_stream_safe_cuda_allocator_ordered_reuse = false;
+  Release(place, stream1);
+  Release(place, stream2);
+  CheckMemLeak(place);
+}
+
 TEST(StreamSafeCUDAAllocRetryTest, RetryTest) {
   RETURN_IF_NOT_ENABLED;
 
@@ -0,0 +1,133 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// Hands out granularity aligned chunks of one contiguous address range, like
+// CUDAVirtualMemAllocator. The range is never touched.
+class FakeVirtualMemAllocator : public Allocator {
+ public:
+  static constexpr size_t kGranularity = 1 << 16;
+
+  FakeVirtualMemAllocator() : buffer_(kGranularity * 64) {
+    auto addr = reinterpret_cast<uintptr_t>(buffer_.data());
+    base_ = reinterpret_cast<uint8_t *>(
+        (addr + kGranularity - 1) / kGranularity * kGranularity);
+  }
+
+  size_t MappedSize() const { return mapped_size_; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    size = AlignedSize(size, kGranularity);
+    if (offset_ + size > buffer_.size() - kGranularity) {
+      throw BadAlloc("", __FILE__, __LINE__);
+    }
+    void *ptr = base_ + offset_;
+    offset_ += size;
+    mapped_size_ += size;
+    return new Allocation(ptr, size, phi::GPUPlace(0));
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    mapped_size_ -= allocation->size();
+    delete allocation;
+  }
+
+ private:
+  std::vector<uint8_t> buffer_;
+  uint8_t *base_;
+  size_t offset_{0};
+  size_t mapped_size_{0};
+};
+
+TEST(VirtualMemoryAutoGrowthBestFitAllocator, Defragment) {
+  constexpr size_t kGranularity = FakeVirtualMemAllocator::kGranularity;
+  size_t alignment = 256;
+  auto fake_allocator = std::make_shared<FakeVirtualMemAllocator>();
+  auto allocator = std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
+      fake_allocator, alignment, phi::GPUPlace(0));
+
+  // every allocation fills exactly one chunk
+  size_t size = 4 * kGranularity - alignment;
+  std::vector<AllocationPtr> allocations;
+  for (int i = 0; i < 4; ++i) {
+    allocations.emplace_back(allocator->Allocate(size));
+  }
+  ASSERT_EQ(fake_allocator->MappedSize(), 16 * kGranularity);
+
+  allocations[0].reset();
+  allocations[2].reset();
+  FragmentationStat stat = allocator->GetFragmentationStat();
+  EXPECT_EQ(stat.reserved_size, 16 * kGranularity);
+  EXPECT_EQ(stat.free_size, 8 * kGranularity);
+  EXPECT_EQ(stat.largest_free_size, 4 * kGranularity);
+  EXPECT_EQ(stat.free_block_num, 2UL);
+  EXPECT_DOUBLE_EQ(stat.Fragmentation(), 0.5);
+
+  // the two free chunks are remapped behind the last one
+  EXPECT_EQ(allocator->Defragment(), 8 * kGranularity);
+  EXPECT_EQ(fake_allocator->MappedSize(), 16 * kGranularity);
+  stat = allocator->GetFragmentationStat();
+  EXPECT_EQ(stat.reserved_size, 16 * kGranularity);
+  EXPECT_EQ(stat.free_size, 8 * kGranularity);
+  EXPECT_EQ(stat.largest_free_size, 8 * kGranularity);
+  EXPECT_EQ(stat.free_block_num, 1UL);
+  EXPECT_DOUBLE_EQ(stat.Fragmentation(), 0.0);
+  EXPECT_EQ(allocator->Defragment(), 0UL);
+
+  // which serves a request larger than any free block before
+  auto large = allocator->Allocate(8 * kGranularity - alignment);
+  EXPECT_EQ(fake_allocator->MappedSize(), 16 * kGranularity);
+  EXPECT_GT(large->ptr(), allocations[3]->ptr());
+
+  large.reset();
+  allocations.clear();
+  stat = allocator->GetFragmentationStat();
+  EXPECT_EQ(stat.free_size, 16 * kGranularity);
+  EXPECT_EQ(stat.free_block_num, 2UL);
+}
+
+TEST(VirtualMemoryAutoGrowthBestFitAllocator, DefragmentPartialFreeBlock) {
+  constexpr size_t kGranularity = FakeVirtualMemAllocator::kGranularity;
+  size_t alignment = 256;
+  auto fake_allocator = std::make_shared<FakeVirtualMemAllocator>();
+  auto allocator = std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
+      fake_allocator, alignment, phi::GPUPlace(0));
+
+  size_t size = 4 * kGranularity - alignment;
+  auto first = allocator->Allocate(size);
+  auto second = allocator->Allocate(size);
+  auto third = allocator->Allocate(size);
+  // a chunk that is only partly free can not be unmapped
+  second.reset();
+  auto small = allocator->Allocate(kGranularity);
+  EXPECT_EQ(allocator->Defragment(), 0UL);
+  EXPECT_EQ(fake_allocator->MappedSize(), 12 * kGranularity);
+  EXPECT_GE(allocator->GetFragmentationStat().free_size, 2 * kGranularity);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -16,6 +16,7 @@
 #include <map>
 #include <random>
 #include <string>
+#include <thread>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/framework/lod_tensor.h"
@@ -57,8 +58,11 @@ template <typename T>
 void RunOperator(const phi::Place &place,
                  const std::string &op_type,
                  const phi::DDim &dims,
-                 const std::string &first_input) {
-  framework::Scope scope;
+                 const std::string &first_input,
+                 // run for inference on the weights kept in it
+                 framework::Scope *weights_scope = nullptr) {
+  framework::Scope local_scope;
+  framework::Scope &scope = weights_scope ? *weights_scope : local_scope;
 
   std::map<const std::string, int> num_inputs = {{"softmax", 1},
                                                  {"relu", 1},
@@ -93,6 +97,10 @@ void RunOperator(const phi::Place &place,
   std::mt19937 engine;
   size_t numel = static_cast<size_t>(common::product(dims));
   for (int i = 0; i < num_inputs[op_type]; ++i) {
+    // the weights are kept
+    if (weights_scope && i > 0 && input_names[i].tensor->initialized()) {
+      continue;
+    }
     input_names[i].tensor->Resize(dims);
     auto data_ptr = input_names[i].tensor->mutable_data<T>(place);
     for (size_t i = 0; i < numel; ++i) {
@@ -109,18 +117,22 @@ void RunOperator(const phi::Place &place,
 
   auto &pool = phi::DeviceContextPool::Instance();
 
+  framework::AttributeMap attrs = {{"use_mkldnn", {true}}};
+  if (weights_scope) {
+    attrs["is_test"] = true;
+  }
   auto op = num_inputs[op_type] > 1
                 ? framework::OpRegistry::CreateOp(
                       op_type,
                       {{first_input_var_name, {first_input}},
                        {second_input_var_name, {"x1"}}},
                       {{output_var_name, {output_name}}},
-                      {{"use_mkldnn", {true}}})
+                      attrs)
                 : framework::OpRegistry::CreateOp(
                       op_type,
                       {{first_input_var_name, {first_input}}},
                       {{output_var_name, {output_name}}},
-                      {{"use_mkldnn", {true}}});
+                      attrs);
 
   op->Run(scope, place);
   pool.Get(place)->Wait();
@@ -150,5 +162,46 @@ TEST(test_conv2d_noreuse_cache, cpu_place) {
                         "Invalid number of cached oneDNN objects"));
 }
 
+TEST(test_conv2d_shared_cache, cpu_place) {
+  phi::DDim dims({1, 16, 32, 64});
+  phi::CPUPlace p;
+  CacheTester ct;
+  auto &cache = phi::OneDNNPrimitiveCache::Instance();
+  cache.Reset(64);
+  auto run = [&] { RunOperator<float>(p, "conv2d", dims, "input_signal"); };
+  std::thread(run).join();
+  const size_t num_blobs = cache.Size();
+  const uint64_t hits = cache.Hits();
+  EXPECT_GT(num_blobs, 0UL);
+  // the other thread reuses the primitives of the first one
+  std::thread(run).join();
+  EXPECT_EQ(cache.Size(), num_blobs);
+  EXPECT_GT(cache.Hits(), hits);
+  EXPECT_GT(cache.HitRate(), 0.);
+  // evicted beyond the capacity
+  cache.Reset(1);
+  std::thread(run).join();
+  EXPECT_EQ(cache.Size(), 1UL);
+  cache.Reset(0);
+}
+
+TEST(test_conv2d_prepacked_weights, cpu_place) {
+  phi::DDim dims({1, 16, 32, 64});
+  phi::CPUPlace p;
+  CacheTester ct;
+  framework::Scope weights_scope;
+  auto &packed = phi::OneDNNPackedWeights::Instance();
+  auto run = [&](const std::string &input) {
+    phi::OneDNNContext::tls().set_prepack_weights(true);
+    RunOperator<float>(p, "conv2d", dims, input, &weights_scope);
+  };
+  std::thread(run, "input_signal").join();
+  const uint64_t hits = packed.Hits();
+  EXPECT_GT(packed.Size(), 0UL);
+  // another thread and input reuse the weights packed by the first one
+  std::thread(run, "input_signal2").join();
+  EXPECT_GT(packed.Hits(), hits);
+}
+
 }  // namespace operators
 }  // namespace paddle
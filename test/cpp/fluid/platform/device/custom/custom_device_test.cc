@@ -16,6 +16,7 @@
 
 #include <array>
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/platform/device_context.h"
@@ -74,6 +75,39 @@ void TestDeviceInterface(const phi::Place& place) {
   }
 }
 
+void TestMemoryCopyD2DBatch(const phi::Place& place) {
+  if (phi::is_custom_place(place) == false) {
+    return;
+  }
+  auto device = phi::DeviceManager::GetDeviceWithPlace(place);
+  const size_t num = 4;
+  auto* src = static_cast<int*>(device->MemoryAllocate(num * sizeof(int)));
+  auto* dst = static_cast<int*>(device->MemoryAllocate(num * sizeof(int)));
+  // the memory of the fake device is on the host
+  for (size_t i = 0; i < num; ++i) {
+    src[i] = static_cast<int>(i) + 1;
+    dst[i] = 0;
+  }
+  // reverse the chunks of a single int in a batch
+  std::vector<void*> dsts;
+  std::vector<const void*> srcs;
+  std::vector<size_t> sizes(num, sizeof(int));
+  for (size_t i = 0; i < num; ++i) {
+    dsts.push_back(dst + num - 1 - i);
+    srcs.push_back(src + i);
+  }
+  // the fake device ignores the stream, which only selects the batched call
+  int dummy = 0;
+  phi::stream::Stream stream(place, &dummy);
+  device->MemoryCopyD2DBatch(
+      dsts.data(), srcs.data(), sizes.data(), num, &stream);
+  for (size_t i = 0; i < num; ++i) {
+    EXPECT_EQ(dst[i], static_cast<int>(num - i));
+  }
+  device->MemoryDeallocate(src, num * sizeof(int));
+  device->MemoryDeallocate(dst, num * sizeof(int));
+}
+
 void TestTensorMutableData(const phi::Place& place) {
   std::cout << "TestTensorInitialization on " << place << std::endl;
   phi::DenseTensor src_tensor;
@@ -230,6 +264,7 @@ TEST(CustomDevice, Tensor) {
     auto place = phi::PlaceHelper::CreatePlace(dev_type);
 
     TestDeviceInterface(place);
+    TestMemoryCopyD2DBatch(place);
     TestTensorMutableData(place);
     TestTensorShareDataWith(place);
     TestTensorUtils(place);
@@ -23,9 +23,11 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/op_info.h"
 #include "paddle/fluid/imperative/prepared_operator.h"
 #include "paddle/fluid/imperative/type_defs.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/phi/core/kernel_registry.h"
 
 PD_DECLARE_KERNEL(split, CPU, ALL_LAYOUT);
@@ -34,6 +36,8 @@ PD_DECLARE_KERNEL(relu, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(relu, GPU, ALL_LAYOUT);
 #endif
 
+COMMON_DECLARE_int32(dygraph_prepared_op_cache_size);
+
 namespace paddle {
 namespace imperative {
 
@@ -109,6 +113,64 @@ TEST(test_prepare_op, test_prepare_op) {
                               {}));
 }
 
+TEST(test_prepare_op, test_prepare_op_cache) {
+  phi::CPUPlace place;
+  const auto& info = framework::OpInfoMap::Instance().Get("split");
+  framework::AttributeMap split_attr_map;
+  if (info.Checker()) info.Checker()->Check(&split_attr_map);
+  auto prepare = [&](bool fp64, bool empty = false) {
+    std::shared_ptr<imperative::VarBase> vin(
+        new imperative::VarBase(false, "vin"));
+    std::shared_ptr<imperative::VarBase> vout(
+        new imperative::VarBase(false, "vout"));
+    auto* tensor = vin->MutableVar()->GetMutable<phi::DenseTensor>();
+    tensor->Resize(common::make_ddim({empty ? 0 : 2, 2}));
+    if (fp64) {
+      tensor->mutable_data<double>(place);
+    } else {
+      tensor->mutable_data<float>(place);
+    }
+    imperative::NameVarBaseMap ins = {var_pair("X", vb_vector(1, vin))};
+    imperative::NameVarBaseMap outs = {var_pair("Out", vb_vector(1, vout))};
+    auto op = framework::OpRegistry::CreateOp(
+        "split",
+        CreateVarNameMap(info, "split", ins, true),
+        CreateVarNameMap(info, "split", outs, false),
+        split_attr_map);
+    return PreparedOp::Prepare(
+               ins,
+               outs,
+               dynamic_cast<framework::OperatorWithKernel&>(*op),
+               place,
+               split_attr_map,
+               {})
+        .kernel_key();
+  };
+  auto* hits = platform::StatRegistry<int64_t>::Instance().get(
+      "STAT_dygraph_prepared_op_cache_hits");
+  ASSERT_NE(hits, nullptr);
+  int64_t hits_before = hits->get();
+  // the second op of the same key reuses the kernel chosen for the first one,
+  // which is destroyed
+  auto first = prepare(false);
+  auto second = prepare(false);
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(second.dtype(), phi::DataType::FLOAT32);
+  ASSERT_EQ(hits->get(), hits_before + 1);
+  // another dtype or an empty input is another key
+  ASSERT_EQ(prepare(true).dtype(), phi::DataType::FLOAT64);
+  ASSERT_EQ(prepare(false, true).dtype(), phi::DataType::FLOAT32);
+  ASSERT_EQ(hits->get(), hits_before + 1);
+  prepare(false, true);
+  ASSERT_EQ(hits->get(), hits_before + 2);
+
+  // a disabled cache is neither looked up
+  FLAGS_dygraph_prepared_op_cache_size = 0;
+  prepare(false);
+  ASSERT_EQ(hits->get(), hits_before + 2);
+  FLAGS_dygraph_prepared_op_cache_size = 4096;
+}
+
 const phi::DenseTensor* GetTensorFromVar(const framework::Variable& var);
 
 TEST(test_prepare_op, test_get_tensor_from_var) {
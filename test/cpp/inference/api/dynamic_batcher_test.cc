@@ -0,0 +1,169 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+
+namespace paddle_infer {
+namespace services {
+
+// A model of out = 2 * x, x is float32 [-1, 4].
+std::unique_ptr<Predictor> CreateDoublePredictor() {
+  paddle::framework::ProgramDesc program;
+  auto *block = program.MutableBlock(0);
+  auto *feed = block->Var("feed");
+  feed->SetType(paddle::framework::proto::VarType::FEED_MINIBATCH);
+  feed->SetPersistable(true);
+  auto *fetch = block->Var("fetch");
+  fetch->SetType(paddle::framework::proto::VarType::FETCH_LIST);
+  fetch->SetPersistable(true);
+  for (const char *name : {"x", "out"}) {
+    auto *var = block->Var(name);
+    var->SetType(paddle::framework::proto::VarType::LOD_TENSOR);
+    var->SetDataType(paddle::framework::proto::VarType::FP32);
+    var->SetShape({-1, 4});
+  }
+
+  auto *feed_op = block->AppendOp();
+  feed_op->SetType("feed");
+  feed_op->SetInput("X", {"feed"});
+  feed_op->SetOutput("Out", {"x"});
+  feed_op->SetAttr("col", 0);
+  auto *scale_op = block->AppendOp();
+  scale_op->SetType("scale");
+  scale_op->SetInput("X", {"x"});
+  scale_op->SetOutput("Out", {"out"});
+  scale_op->SetAttr("scale", 2.0f);
+  scale_op->SetAttr("bias", 0.0f);
+  scale_op->SetAttr("bias_after_scale", true);
+  auto *fetch_op = block->AppendOp();
+  fetch_op->SetType("fetch");
+  fetch_op->SetInput("X", {"out"});
+  fetch_op->SetOutput("Out", {"fetch"});
+  fetch_op->SetAttr("col", 0);
+
+  std::string pb_content;
+  program.Proto()->SerializeToString(&pb_content);
+  Config config;
+  config.SetModelBuffer(pb_content.data(), pb_content.size(), nullptr, 0);
+  config.DisableGpu();
+  config.SwitchIrOptim(false);
+  config.EnableNewIR(false);
+  config.DisableGlogInfo();
+  return std::make_unique<Predictor>(config);
+}
+
+paddle::PaddleTensor Input(const std::string &name,
+                           const std::vector<float> &data) {
+  paddle::PaddleTensor tensor;
+  tensor.name = name;
+  tensor.shape = {static_cast<int>(data.size() / 4), 4};
+  tensor.dtype = paddle::PaddleDType::FLOAT32;
+  tensor.data.Resize(data.size() * sizeof(float));
+  std::memcpy(tensor.data.data(), data.data(), data.size() * sizeof(float));
+  return tensor;
+}
+
+std::vector<float> Output(const std::vector<paddle::PaddleTensor> &outputs) {
+  EXPECT_EQ(outputs.size(), 1UL);
+  const float *data = static_cast<const float *>(outputs[0].data.data());
+  return std::vector<float>(
+      data, data + outputs[0].data.length() / sizeof(float));
+}
+
+TEST(DynamicBatcher, Batching) {
+  DynamicBatchOptions options;
+  options.max_batch_size = 4;
+  // long enough for the requests of the threads to meet
+  options.max_queue_delay_us = 200000;
+  DynamicBatcher batcher(CreateDoublePredictor(), options);
+
+  const int num_requests = 8;
+  std::vector<std::vector<float>> results(num_requests);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i] {
+      std::vector<paddle::PaddleTensor> outputs;
+      std::vector<float> data(4, static_cast<float>(i));
+      ASSERT_TRUE(batcher.Run({Input("x", data)}, &outputs));
+      results[i] = Output(outputs);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // each request gets its own rows back
+  for (int i = 0; i < num_requests; ++i) {
+    EXPECT_EQ(results[i], std::vector<float>(4, 2.0f * i));
+  }
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.num_requests, static_cast<uint64_t>(num_requests));
+  EXPECT_GE(stats.num_batches, 2UL);
+  EXPECT_LT(stats.num_batches, static_cast<uint64_t>(num_requests));
+}
+
+TEST(DynamicBatcher, TimeoutFlush) {
+  DynamicBatchOptions options;
+  options.max_batch_size = 8;
+  options.max_queue_delay_us = 20000;
+  DynamicBatcher batcher(CreateDoublePredictor(), options);
+
+  // a batch that never fills is run once the first request waited enough
+  std::vector<paddle::PaddleTensor> outputs;
+  ASSERT_TRUE(batcher.Run({Input("x", {1, 2, 3, 4})}, &outputs));
+  EXPECT_EQ(Output(outputs), std::vector<float>({2, 4, 6, 8}));
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.num_batches, 1UL);
+  EXPECT_GE(stats.max_queue_latency_us, options.max_queue_delay_us);
+}
+
+TEST(DynamicBatcher, ErrorPropagation) {
+  DynamicBatchOptions options;
+  options.max_batch_size = 2;
+  options.max_queue_delay_us = 200000;
+  DynamicBatcher batcher(CreateDoublePredictor(), options);
+
+  // the model has no input y, both requests of the batch get the error
+  std::vector<std::thread> threads;
+  std::vector<bool> thrown(2, false);
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([&, i] {
+      std::vector<paddle::PaddleTensor> outputs;
+      try {
+        batcher.Run({Input("y", std::vector<float>(4, 1.0f))}, &outputs);
+      } catch (const std::exception &) {
+        thrown[i] = true;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(thrown[0]);
+  EXPECT_TRUE(thrown[1]);
+
+  // the batcher keeps serving after the error
+  std::vector<paddle::PaddleTensor> outputs;
+  ASSERT_TRUE(batcher.Run({Input("x", {1, 1, 1, 1})}, &outputs));
+  EXPECT_EQ(Output(outputs), std::vector<float>({2, 2, 2, 2}));
+}
+
+}  // namespace services
+}  // namespace paddle_infer
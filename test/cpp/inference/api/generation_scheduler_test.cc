@@ -0,0 +1,347 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+
+namespace paddle_infer {
+namespace services {
+
+// A model of next_tokens = input_ids * scale + bias, the token after each
+// token, which takes the inputs of GenerationScheduler and uses no kv cache.
+std::unique_ptr<Predictor> CreateTokenPredictor(float scale, float bias) {
+  namespace proto = paddle::framework::proto;
+  paddle::framework::ProgramDesc program;
+  auto *block = program.MutableBlock(0);
+  auto *feed = block->Var("feed");
+  feed->SetType(proto::VarType::FEED_MINIBATCH);
+  feed->SetPersistable(true);
+  auto *fetch = block->Var("fetch");
+  fetch->SetType(proto::VarType::FETCH_LIST);
+  fetch->SetPersistable(true);
+
+  GenerationOptions names;
+  struct Input {
+    std::string name;
+    proto::VarType::Type dtype;
+    std::vector<int64_t> shape;
+  };
+  const std::vector<Input> inputs = {
+      {names.input_ids_name, proto::VarType::INT64, {-1, -1}},
+      {names.seq_lens_this_time_name, proto::VarType::INT32, {-1}},
+      {names.seq_lens_encoder_name, proto::VarType::INT32, {-1, 1}},
+      {names.seq_lens_decoder_name, proto::VarType::INT32, {-1, 1}},
+      {names.block_tables_name, proto::VarType::INT32, {-1, -1}}};
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto *var = block->Var(inputs[i].name);
+    var->SetType(proto::VarType::LOD_TENSOR);
+    var->SetDataType(inputs[i].dtype);
+    var->SetShape(inputs[i].shape);
+    auto *feed_op = block->AppendOp();
+    feed_op->SetType("feed");
+    feed_op->SetInput("X", {"feed"});
+    feed_op->SetOutput("Out", {inputs[i].name});
+    feed_op->SetAttr("col", static_cast<int>(i));
+  }
+  auto *out = block->Var(names.next_tokens_name);
+  out->SetType(proto::VarType::LOD_TENSOR);
+  out->SetDataType(proto::VarType::INT64);
+  out->SetShape({-1, -1});
+
+  auto *scale_op = block->AppendOp();
+  scale_op->SetType("scale");
+  scale_op->SetInput("X", {names.input_ids_name});
+  scale_op->SetOutput("Out", {names.next_tokens_name});
+  scale_op->SetAttr("scale", scale);
+  scale_op->SetAttr("bias", bias);
+  scale_op->SetAttr("bias_after_scale", true);
+  auto *fetch_op = block->AppendOp();
+  fetch_op->SetType("fetch");
+  fetch_op->SetInput("X", {names.next_tokens_name});
+  fetch_op->SetOutput("Out", {"fetch"});
+  fetch_op->SetAttr("col", 0);
+
+  std::string pb_content;
+  program.Proto()->SerializeToString(&pb_content);
+  Config config;
+  config.SetModelBuffer(pb_content.data(), pb_content.size(), nullptr, 0);
+  config.DisableGpu();
+  config.SwitchIrOptim(false);
+  config.EnableNewIR(false);
+  config.DisableGlogInfo();
+  return std::make_unique<Predictor>(config);
+}
+
+// Collects the tokens of the requests of a scheduler, in the order they are
+// received, along with the free blocks seen by each of them.
+class Collector {
+ public:
+  struct Event {
+    int request;
+    int64_t token;
+    bool finished;
+    uint64_t num_free_blocks;
+  };
+
+  GenerationScheduler::TokenCallback Callback(
+      GenerationScheduler *scheduler, int request) {
+    return [this, scheduler, request](int64_t token, bool finished) {
+      auto num_free_blocks = scheduler->GetStats().num_free_blocks;
+      std::lock_guard<std::mutex> lock(mutex_);
+      events_.push_back({request, token, finished, num_free_blocks});
+      num_finished_ += finished;
+      cv_.notify_all();
+    };
+  }
+
+  // Waits for the given number of requests to finish.
+  bool Wait(int num_finished) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, std::chrono::seconds(60), [&] {
+      return num_finished_ >= num_finished;
+    });
+  }
+
+  std::vector<Event> Events() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+  }
+
+  std::vector<int64_t> Tokens(int request) {
+    std::vector<int64_t> tokens;
+    for (auto &event : Events()) {
+      if (event.request == request) tokens.push_back(event.token);
+    }
+    return tokens;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Event> events_;
+  int num_finished_{0};
+};
+
+// Waits until the scheduler holds no blocks.
+bool WaitAllBlocksFree(const GenerationScheduler &scheduler,
+                       const GenerationOptions &options) {
+  for (int i = 0; i < 6000; ++i) {
+    if (scheduler.GetStats().num_free_blocks ==
+        static_cast<uint64_t>(options.num_blocks)) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+TEST(GenerationScheduler, Admission) {
+  GenerationOptions options;
+  options.num_blocks = 16;
+  options.block_size = 2;
+  options.max_blocks_per_seq = 8;
+  options.max_num_seqs = 2;
+  GenerationScheduler scheduler(CreateTokenPredictor(1, 1), options);
+  Collector collector;
+  for (int i = 0; i < 3; ++i) {
+    scheduler.AddRequest(
+        {10 * (i + 1)}, 3, collector.Callback(&scheduler, i));
+  }
+  ASSERT_TRUE(collector.Wait(3));
+  for (int i = 0; i < 3; ++i) {
+    int64_t prompt = 10 * (i + 1);
+    EXPECT_EQ(collector.Tokens(i),
+              std::vector<int64_t>({prompt + 1, prompt + 2, prompt + 3}));
+  }
+  // the third request is admitted once one of the first two finished
+  auto events = collector.Events();
+  size_t first_finished = events.size();
+  size_t third_started = events.size();
+  for (size_t i = 0; i < events.size(); ++i) {
+    if (events[i].request < 2 && events[i].finished) {
+      first_finished = std::min(first_finished, i);
+    }
+    if (events[i].request == 2) {
+      third_started = std::min(third_started, i);
+    }
+  }
+  EXPECT_LT(first_finished, third_started);
+  auto stats = scheduler.GetStats();
+  EXPECT_EQ(stats.num_requests, 3UL);
+  EXPECT_EQ(stats.num_preemptions, 0UL);
+  EXPECT_EQ(stats.num_free_blocks, 16UL);
+}
+
+TEST(GenerationScheduler, BlockAllocation) {
+  GenerationOptions options;
+  options.num_blocks = 8;
+  options.block_size = 2;
+  options.max_blocks_per_seq = 8;
+  GenerationScheduler scheduler(CreateTokenPredictor(1, 1), options);
+  Collector collector;
+  scheduler.AddRequest({1, 2, 3}, 4, collector.Callback(&scheduler, 0));
+  ASSERT_TRUE(collector.Wait(1));
+  EXPECT_EQ(collector.Tokens(0), std::vector<int64_t>({4, 5, 6, 7}));
+  // the k-th token is generated by a step over 2 + k tokens, whose blocks
+  // are held until the request finishes
+  auto events = collector.Events();
+  ASSERT_EQ(events.size(), 4UL);
+  for (size_t k = 1; k < events.size(); ++k) {
+    EXPECT_EQ(events[k - 1].num_free_blocks, 8 - (2 + k + 1) / 2);
+  }
+  EXPECT_EQ(events.back().num_free_blocks, 8UL);
+}
+
+TEST(GenerationScheduler, Preemption) {
+  // the two requests can not hold all their tokens at the same time
+  GenerationOptions options;
+  options.num_blocks = 8;
+  options.block_size = 1;
+  options.max_blocks_per_seq = 8;
+  GenerationScheduler scheduler(CreateTokenPredictor(1, 1), options);
+  Collector collector;
+  scheduler.AddRequest({10}, 8, collector.Callback(&scheduler, 0));
+  scheduler.AddRequest({20}, 8, collector.Callback(&scheduler, 1));
+  ASSERT_TRUE(collector.Wait(2));
+  // the preempted request goes on from its generated tokens
+  for (int i = 0; i < 2; ++i) {
+    std::vector<int64_t> expected(8);
+    std::iota(expected.begin(), expected.end(), 10 * (i + 1) + 1);
+    EXPECT_EQ(collector.Tokens(i), expected);
+  }
+  auto stats = scheduler.GetStats();
+  EXPECT_GE(stats.num_preemptions, 1UL);
+  EXPECT_EQ(stats.num_free_blocks, 4UL);
+}
+
+TEST(GenerationScheduler, Cancel) {
+  GenerationOptions options;
+  options.num_blocks = 64;
+  options.block_size = 64;
+  options.max_blocks_per_seq = 64;
+  options.max_num_seqs = 1;
+  GenerationScheduler scheduler(CreateTokenPredictor(1, 1), options);
+  Collector collector;
+  auto running =
+      scheduler.AddRequest({1}, 4000, collector.Callback(&scheduler, 0));
+  auto waiting =
+      scheduler.AddRequest({2}, 4000, collector.Callback(&scheduler, 1));
+  // a waiting request is dropped at once
+  EXPECT_TRUE(scheduler.Cancel(waiting));
+  EXPECT_FALSE(scheduler.Cancel(waiting));
+  while (collector.Tokens(0).empty()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // a running request is dropped before the next step
+  EXPECT_TRUE(scheduler.Cancel(running));
+  ASSERT_TRUE(WaitAllBlocksFree(scheduler, options));
+  EXPECT_FALSE(scheduler.Cancel(running));
+  // the tokens of the step the request is cancelled in may still arrive
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  size_t num_tokens = collector.Tokens(0).size();
+  EXPECT_LT(num_tokens, 4000UL);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(collector.Tokens(0).size(), num_tokens);
+  EXPECT_TRUE(collector.Tokens(1).empty());
+  for (auto &event : collector.Events()) {
+    EXPECT_FALSE(event.finished);
+  }
+}
+
+TEST(GenerationScheduler, ErrorInStep) {
+  // the model has no such input, so every step throws
+  GenerationOptions options;
+  options.num_blocks = 8;
+  options.block_size = 2;
+  options.max_blocks_per_seq = 4;
+  options.block_tables_name = "missing_block_tables";
+  GenerationScheduler scheduler(CreateTokenPredictor(1, 1), options);
+  Collector collector;
+  scheduler.AddRequest({1, 2, 3}, 4, collector.Callback(&scheduler, 0));
+  scheduler.AddRequest({4}, 4, collector.Callback(&scheduler, 1));
+  ASSERT_TRUE(collector.Wait(2));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(collector.Tokens(i), std::vector<int64_t>({-1}));
+  }
+  EXPECT_EQ(scheduler.GetStats().num_free_blocks, 8UL);
+}
+
+// Generates after prompt with a target model of x + 1 and a draft model of
+// x * draft_scale + draft_bias, checking the tokens, the free blocks seen by
+// each of them and the drafts.
+void ExpectSpeculative(float draft_scale,
+                       float draft_bias,
+                       int64_t prompt,
+                       int max_new_tokens,
+                       const std::vector<uint64_t> &num_free_blocks,
+                       uint64_t num_draft_tokens,
+                       uint64_t num_accepted_tokens) {
+  // a token takes a block, so a block past the sequence is a leak
+  GenerationOptions options;
+  options.num_blocks = 16;
+  options.block_size = 1;
+  options.max_blocks_per_seq = 16;
+  options.num_speculative_tokens = 4;
+  GenerationScheduler scheduler(CreateTokenPredictor(1, 1),
+                                CreateTokenPredictor(draft_scale, draft_bias),
+                                options);
+  Collector collector;
+  scheduler.AddRequest(
+      {prompt}, max_new_tokens, collector.Callback(&scheduler, 0));
+  ASSERT_TRUE(collector.Wait(1));
+  // the tokens are those of the target model alone
+  std::vector<int64_t> expected(max_new_tokens);
+  std::iota(expected.begin(), expected.end(), prompt + 1);
+  EXPECT_EQ(collector.Tokens(0), expected);
+  std::vector<uint64_t> free_blocks;
+  for (auto &event : collector.Events()) {
+    free_blocks.push_back(event.num_free_blocks);
+  }
+  EXPECT_EQ(free_blocks, num_free_blocks);
+  auto stats = scheduler.GetStats();
+  EXPECT_EQ(stats.num_draft_tokens, num_draft_tokens);
+  EXPECT_EQ(stats.num_accepted_tokens, num_accepted_tokens);
+  EXPECT_EQ(stats.num_free_blocks, 16UL);
+}
+
+TEST(GenerationScheduler, SpeculativeAllAccepted) {
+  // 6 after the prefill, 7 to 11 from 4 drafts, and 12 to 15 from the
+  // last 3 drafts, which stop at max_new_tokens
+  ExpectSpeculative(
+      1, 1, 5, 10, {15, 10, 10, 10, 10, 10, 16, 16, 16, 16}, 7, 7);
+}
+
+TEST(GenerationScheduler, SpeculativePartlyAccepted) {
+  // after 0 the drafts are 1, 3, 7, 15, of which 1 is accepted and the
+  // blocks of the other 3 are freed, and the later drafts are all rejected
+  ExpectSpeculative(2, 1, -1, 6, {15, 12, 12, 11, 10, 16}, 7, 1);
+}
+
+TEST(GenerationScheduler, SpeculativeAllRejected) {
+  // each step keeps the target token alone and frees the draft blocks
+  ExpectSpeculative(1, 2, 5, 4, {15, 13, 12, 16}, 3, 0);
+}
+
+}  // namespace services
+}  // namespace paddle_infer
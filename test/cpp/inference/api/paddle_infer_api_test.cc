@@ -15,6 +15,9 @@ limitations under the License. */
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <future>
+#include <thread>
+
 #include "paddle/common/flags.h"
 #include "test/cpp/inference/api/tester_helper.h"
 
@@ -58,6 +61,105 @@ TEST(Predictor, use_gpu) {
   predictor->ClearIntermediateTensor();
 }
 
+TEST(Predictor, run_async) {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  Config config;
+  config.SetModel(model_dir + "/model", model_dir + "/params");
+  config.EnableUseGpu(100, 0);
+
+  auto predictor = CreatePredictor(config);
+  std::vector<std::unique_ptr<Predictor>> predictors;
+  predictors.emplace_back(predictor->Clone());
+  predictors.emplace_back(predictor->Clone());
+
+  std::vector<int> in_shape = {1, 3, 318, 318};
+  std::vector<float> input(1 * 3 * 318 * 318, 1.f);
+  const auto Feed = [&](Predictor *pred) {
+    auto input_t = pred->GetInputHandle(pred->GetInputNames()[0]);
+    input_t->Reshape(in_shape);
+    input_t->CopyFromCpu(input.data());
+  };
+  const auto Fetch = [](Predictor *pred) {
+    auto output_t = pred->GetOutputHandle(pred->GetOutputNames()[0]);
+    std::vector<int> output_shape = output_t->shape();
+    std::vector<float> out_data(std::accumulate(output_shape.begin(),
+                                                output_shape.end(),
+                                                1,
+                                                std::multiplies<int>()));
+    output_t->CopyToCpu(out_data.data());
+    return out_data;
+  };
+
+  Feed(predictor.get());
+  ASSERT_TRUE(predictor->Run());
+  const std::vector<float> expected = Fetch(predictor.get());
+
+  // one thread drives all the runs, which are fetched on their completion
+  std::vector<std::promise<std::vector<float>>> results(predictors.size());
+  for (size_t i = 0; i < predictors.size(); ++i) {
+    Predictor *pred = predictors[i].get();
+    Feed(pred);
+    ASSERT_TRUE(pred->RunAsync(
+        [&, i, pred] { results[i].set_value(Fetch(pred)); }));
+  }
+  for (auto &result : results) {
+    EXPECT_EQ(result.get_future().get(), expected);
+  }
+}
+
+TEST(Predictor, gpu_resource_sharing) {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  std::vector<int> in_shape = {1, 3, 318, 318};
+  std::vector<float> input(1 * 3 * 318 * 318, 1.f);
+  const auto Infer = [&](Predictor *pred) {
+    auto input_t = pred->GetInputHandle(pred->GetInputNames()[0]);
+    input_t->Reshape(in_shape);
+    input_t->CopyFromCpu(input.data());
+    EXPECT_TRUE(pred->Run());
+    auto output_t = pred->GetOutputHandle(pred->GetOutputNames()[0]);
+    std::vector<int> output_shape = output_t->shape();
+    std::vector<float> out_data(std::accumulate(output_shape.begin(),
+                                                output_shape.end(),
+                                                1,
+                                                std::multiplies<int>()));
+    output_t->CopyToCpu(out_data.data());
+    return out_data;
+  };
+
+  Config base_config;
+  base_config.SetModel(model_dir + "/model", model_dir + "/params");
+  base_config.EnableUseGpu(100, 0);
+  const std::vector<float> expected =
+      Infer(CreatePredictor(base_config).get());
+
+  // three predictors on their own streams share two sets of the handles
+  constexpr int kPredictorNum = 3;
+  std::vector<cudaStream_t> streams(kPredictorNum);
+  std::vector<std::shared_ptr<Predictor>> predictors;
+  for (auto &stream : streams) {
+    cudaStreamCreate(&stream);
+    Config config(base_config);
+    config.SetExecStream(stream);
+    config.EnableGpuResourceSharing(2);
+    predictors.emplace_back(CreatePredictor(config));
+  }
+  std::vector<std::thread> threads;
+  for (auto &predictor : predictors) {
+    threads.emplace_back([&, pred = predictor.get()] {
+      for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(Infer(pred), expected);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  predictors.clear();
+  for (auto stream : streams) {
+    cudaStreamDestroy(stream);
+  }
+}
+
 TEST(PredictorPool, basic) {
   LOG(INFO) << GetVersion();
   UpdateDllFlag("conv_workspace_size_limit", "4000");
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/program_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_int32(inference_program_cache_capacity);
+
+namespace paddle {
+namespace inference {
+
+// A serialized program with a single var of the given name.
+std::string SerializedProgram(const std::string& var_name) {
+  framework::ProgramDesc program;
+  program.MutableBlock(0)->Var(var_name);
+  std::string pb_content;
+  program.Proto()->SerializeToString(&pb_content);
+  return pb_content;
+}
+
+void WriteFile(const std::string& filename, const std::string& content) {
+  std::ofstream fout(filename, std::ios::out | std::ios::binary);
+  fout.write(content.data(), content.size());
+}
+
+bool HasVar(const framework::ProgramDesc& program,
+            const std::string& var_name) {
+  return program.Block(0).HasVar(var_name);
+}
+
+TEST(ProgramDescCache, HitFromMemoryAndFile) {
+  ClearProgramDescCache();
+  std::string pb_content = SerializedProgram("x_a");
+  auto first = LoadCachedProgramDesc(pb_content, true);
+  EXPECT_EQ(ProgramDescCacheHits(), 0);
+  auto second = LoadCachedProgramDesc(pb_content, true);
+  EXPECT_EQ(ProgramDescCacheHits(), 1);
+  EXPECT_TRUE(HasVar(*second, "x_a"));
+  // the returned programs are copies of their own
+  EXPECT_NE(first.get(), second.get());
+
+  // a file of the same content shares the entry
+  std::string filename = "program_cache_test_hit.pdmodel";
+  WriteFile(filename, pb_content);
+  auto from_file = LoadCachedProgramDesc(filename, false);
+  EXPECT_EQ(ProgramDescCacheHits(), 2);
+  EXPECT_TRUE(HasVar(*from_file, "x_a"));
+  std::remove(filename.c_str());
+}
+
+TEST(ProgramDescCache, Eviction) {
+  int old_capacity = FLAGS_inference_program_cache_capacity;
+  FLAGS_inference_program_cache_capacity = 1;
+  ClearProgramDescCache();
+  std::string a = SerializedProgram("x_a");
+  std::string b = SerializedProgram("x_b");
+  LoadCachedProgramDesc(a, true);
+  LoadCachedProgramDesc(b, true);
+  auto program = LoadCachedProgramDesc(a, true);
+  EXPECT_EQ(ProgramDescCacheHits(), 0);
+  EXPECT_TRUE(HasVar(*program, "x_a"));
+  LoadCachedProgramDesc(a, true);
+  EXPECT_EQ(ProgramDescCacheHits(), 1);
+  FLAGS_inference_program_cache_capacity = old_capacity;
+}
+
+TEST(ProgramDescCache, FileRewrittenInPlace) {
+  ClearProgramDescCache();
+  std::string filename = "program_cache_test_rewrite.pdmodel";
+  std::string a = SerializedProgram("x_a");
+  std::string b = SerializedProgram("x_b");
+  ASSERT_EQ(a.size(), b.size());
+  WriteFile(filename, a);
+  EXPECT_TRUE(HasVar(*LoadCachedProgramDesc(filename, false), "x_a"));
+  // the same size and likely the same modification time
+  WriteFile(filename, b);
+  auto program = LoadCachedProgramDesc(filename, false);
+  EXPECT_EQ(ProgramDescCacheHits(), 0);
+  EXPECT_TRUE(HasVar(*program, "x_b"));
+  EXPECT_FALSE(HasVar(*program, "x_a"));
+  std::remove(filename.c_str());
+}
+
+}  // namespace inference
+}  // namespace paddle
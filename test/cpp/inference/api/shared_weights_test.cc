@@ -0,0 +1,130 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/shared_weights.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/inference/api/paddle_analysis_config.h"
+
+namespace paddle {
+namespace inference {
+
+static std::string LayoutPath(const std::string& test) {
+  return "shared_weights_test_" + test + "_" + std::to_string(getpid());
+}
+
+static SharedWeightsLayout MakeLayout() {
+  SharedWeightsLayout layout;
+  layout.device_id = 1;
+  layout.total_size = 1024;
+  // bytes across the whole range, a CUDA IPC memory handle is 64 bytes
+  for (int i = 0; i < 64; ++i) {
+    layout.handle.push_back(static_cast<char>(i * 4 + 1));
+  }
+  layout.handle[0] = '\0';
+  layout.handle[63] = static_cast<char>(0xff);
+  layout.tensors.push_back({"fc_0.w_0", 0, 512, 10, {16, 8}});
+  layout.tensors.push_back({"fc_0.b_0", 512, 32, 10, {8}});
+  layout.tensors.push_back({"scale", 768, 4, 10, {}});
+  return layout;
+}
+
+TEST(SharedWeights, layout_round_trip) {
+  std::string path = LayoutPath("round_trip");
+  SharedWeightsLayout layout = MakeLayout();
+  WriteSharedWeightsLayout(layout, path);
+  // the temporary file is renamed to the path
+  EXPECT_FALSE(
+      std::ifstream(path + ".tmp." + std::to_string(getpid())).is_open());
+
+  SharedWeightsLayout read;
+  ASSERT_TRUE(ReadSharedWeightsLayout(path, &read));
+  EXPECT_EQ(read.device_id, layout.device_id);
+  EXPECT_EQ(read.total_size, layout.total_size);
+  EXPECT_EQ(read.handle, layout.handle);
+  ASSERT_EQ(read.tensors.size(), layout.tensors.size());
+  for (size_t i = 0; i < layout.tensors.size(); ++i) {
+    EXPECT_EQ(read.tensors[i].name, layout.tensors[i].name);
+    EXPECT_EQ(read.tensors[i].offset, layout.tensors[i].offset);
+    EXPECT_EQ(read.tensors[i].size, layout.tensors[i].size);
+    EXPECT_EQ(read.tensors[i].dtype, layout.tensors[i].dtype);
+    EXPECT_EQ(read.tensors[i].dims, layout.tensors[i].dims);
+  }
+
+  // a new publisher replaces the file
+  layout.tensors.pop_back();
+  layout.device_id = 0;
+  WriteSharedWeightsLayout(layout, path);
+  ASSERT_TRUE(ReadSharedWeightsLayout(path, &read));
+  EXPECT_EQ(read.device_id, 0);
+  EXPECT_EQ(read.tensors.size(), layout.tensors.size());
+  std::remove(path.c_str());
+}
+
+TEST(SharedWeights, read_invalid_layout) {
+  SharedWeightsLayout read;
+  EXPECT_FALSE(ReadSharedWeightsLayout(LayoutPath("missing"), &read));
+
+  std::string path = LayoutPath("invalid");
+  {
+    std::ofstream os(path);
+    os << "paddle_shared_weights 0\n";
+  }
+  EXPECT_ANY_THROW(ReadSharedWeightsLayout(path, &read));
+
+  SharedWeightsLayout layout = MakeLayout();
+  layout.tensors.push_back({"out_of_buffer", 1000, 32, 10, {8}});
+  WriteSharedWeightsLayout(layout, path);
+  EXPECT_ANY_THROW(ReadSharedWeightsLayout(path, &read));
+  std::remove(path.c_str());
+}
+
+#if defined(PADDLE_WITH_CUDA)
+TEST(SharedWeights, map_stale_layout) {
+  // the handle of a buffer whose publisher is gone can not be opened, the
+  // predictor keeps its own parameters
+  std::string path = LayoutPath("stale");
+  SharedWeightsLayout layout = MakeLayout();
+  layout.device_id = 0;
+  WriteSharedWeightsLayout(layout, path);
+  framework::Scope scope;
+  EXPECT_EQ(MapSharedWeights({&scope}, phi::GPUPlace(0), path), 0UL);
+  std::remove(path.c_str());
+}
+#endif
+
+TEST(SharedWeights, config) {
+  AnalysisConfig config;
+  EXPECT_TRUE(config.shared_weights_path().empty());
+  EXPECT_FALSE(config.shared_weights_publisher());
+
+  config.EnableSharedWeights("/dev/shm/weights", true);
+  AnalysisConfig copy(config);
+  EXPECT_EQ(copy.shared_weights_path(), "/dev/shm/weights");
+  EXPECT_TRUE(copy.shared_weights_publisher());
+
+  config.EnableSharedWeights("/dev/shm/weights", false);
+  AnalysisConfig mapper(config);
+  EXPECT_EQ(mapper.shared_weights_path(), "/dev/shm/weights");
+  EXPECT_FALSE(mapper.shared_weights_publisher());
+}
+
+}  // namespace inference
+}  // namespace paddle
@@ -207,6 +207,64 @@ void TestTunedDynamic() {
   check_func(test_predictor.get());
 }
 
+void TestTunedDynamicBuckets() {
+  std::string model_dir =
+      FLAGS_infer_model + "/complex_model_dynamic/complex_model_dynamic2";
+  AnalysisConfig config_tuned;
+  const std::string shape_range = "shape_range_buckets.pbtxt";
+  config_tuned.EnableUseGpu(100, 0);
+  config_tuned.SetModel(model_dir + "/model", model_dir + "/params");
+  config_tuned.CollectShapeRangeInfo(shape_range);
+  config_tuned.SetTensorRtShapeBucketNum(2);
+  auto predictor_tuned = CreatePaddlePredictor(config_tuned);
+
+  auto check_func = [](PaddlePredictor *predictor, int batch_size) {
+    int channels = 3;
+    int height = 5;
+    int width = 5;
+    std::vector<float> input(batch_size * channels * height * width, 0.f);
+    auto input_names = predictor->GetInputNames();
+    auto input_t = predictor->GetInputTensor(input_names[0]);
+    input_t->Reshape({batch_size, channels, height, width});
+    input_t->copy_from_cpu(input.data());
+
+    std::vector<float> first(batch_size * 2, 1.f);
+    auto input_t1 = predictor->GetInputTensor(input_names[1]);
+    input_t1->Reshape({batch_size, 2, 1, 1});
+    input_t1->copy_from_cpu(first.data());
+    auto input_t2 = predictor->GetInputTensor(input_names[2]);
+    input_t2->Reshape({batch_size, 2, 1, 1});
+    input_t2->copy_from_cpu(first.data());
+
+    ASSERT_TRUE(predictor->ZeroCopyRun());
+
+    auto output_names = predictor->GetOutputNames();
+    auto output_t = predictor->GetOutputTensor(output_names[0]);
+    std::vector<int> output_shape = output_t->shape();
+    int out_num = std::accumulate(
+        output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
+    std::vector<float> out_data(out_num);
+    output_t->copy_to_cpu(out_data.data());
+  };
+  for (int batch_size : {1, 1, 1, 4}) {
+    check_func(predictor_tuned.get(), batch_size);
+  }
+  predictor_tuned.reset(nullptr);
+
+  // the engines select the profile of the bucket of batch 1, or the one of
+  // the full range.
+  AnalysisConfig config;
+  config.EnableUseGpu(100, 0);
+  config.SetModel(model_dir + "/model", model_dir + "/params");
+  config.EnableTunedTensorRtDynamicShape(shape_range, false);
+  config.EnableTensorRtEngine(
+      1 << 30, 4, 0, AnalysisConfig::Precision::kFloat32, false, false);
+  auto test_predictor = CreatePaddlePredictor(config);
+  for (int batch_size : {1, 4, 1}) {
+    check_func(test_predictor.get(), batch_size);
+  }
+}
+
 void TestDynamicClone(bool with_dynamic = true,
                       bool delete_cache = true,
                       bool delete_conv_bn = false) {
@@ -301,6 +359,9 @@ TEST(AnalysisPredictor, trt_memory_serialize) {
 TEST(AnalysisPredictor, trt_dynamic2) { TestDynamic2(); }
 
 TEST(AnalysisPredictor, trt_tuned_dynamic) { TestTunedDynamic(); }
+TEST(AnalysisPredictor, trt_tuned_dynamic_buckets) {
+  TestTunedDynamicBuckets();
+}
 TEST(AnalysisPredictor, trt_dynamic_clone) { TestDynamicClone(); }
 
 }  // namespace inference
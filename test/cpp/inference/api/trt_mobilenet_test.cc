@@ -15,9 +15,15 @@ limitations under the License. */
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
 #include "paddle/common/flags.h"
 #include "test/cpp/inference/api/trt_test_helper.h"
 
+COMMON_DECLARE_int32(trt_context_memory_pool_size);
+
 namespace paddle_infer {
 TEST(PredictorPool, use_gpu) {
   std::string model_dir = FLAGS_infer_model + "/" + "mobilenet";
@@ -70,4 +76,73 @@ TEST(PredictorPool, use_trt_cuda_graph) {
   predictor->Run();
 }
 
+TEST(PredictorPool, use_trt_timing_cache) {
+  std::string model_dir = FLAGS_infer_model + "/" + "mobilenet";
+  const std::string timing_cache_path = "./mobilenet_trt_timing_cache";
+  std::remove(timing_cache_path.c_str());
+  // build twice, where the second build reads the timing cache of the first
+  for (int i = 0; i < 2; ++i) {
+    Config config;
+    config.EnableUseGpu(100, 0);
+    config.SetModel(model_dir);
+    config.EnableTensorRtEngine();
+    // split the model into several engines
+    config.Exp_DisableTensorRtOPs({"fc", "pool2d"});
+    config.SetTensorRtEngineBuildThreads(4);
+    config.EnableTensorRtTimingCache(timing_cache_path);
+    services::PredictorPool pred_pool(config, 1);
+
+    auto predictor = pred_pool.Retrieve(0);
+    auto input_names = predictor->GetInputNames();
+    auto input_t = predictor->GetInputHandle(input_names[0]);
+    std::vector<int> in_shape = {1, 3, 224, 224};
+    int in_num = std::accumulate(
+        in_shape.begin(), in_shape.end(), 1, [](int &a, int &b) {
+          return a * b;
+        });
+
+    std::vector<float> input(in_num, 0);
+    input_t->Reshape(in_shape);
+    input_t->CopyFromCpu(input.data());
+    predictor->Run();
+
+    std::ifstream fin(timing_cache_path, std::ios::binary | std::ios::ate);
+    ASSERT_TRUE(fin.good());
+    EXPECT_GT(static_cast<int64_t>(fin.tellg()), 0);
+  }
+}
+
+TEST(PredictorPool, use_trt_context_memory_pool) {
+  std::string model_dir = FLAGS_infer_model + "/" + "mobilenet";
+  // 4 predictors running concurrently lease the context memory of 2 blocks
+  FLAGS_trt_context_memory_pool_size = 2;
+  Config config;
+  config.EnableUseGpu(100, 0);
+  config.SetModel(model_dir);
+  config.EnableTensorRtEngine();
+  config.Exp_DisableTensorRtOPs({"fc"});
+  const int num_predictors = 4;
+  services::PredictorPool pred_pool(config, num_predictors);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_predictors; ++i) {
+    threads.emplace_back([&pred_pool, i] {
+      auto predictor = pred_pool.Retrieve(i);
+      auto input_names = predictor->GetInputNames();
+      auto input_t = predictor->GetInputHandle(input_names[0]);
+      std::vector<int> in_shape = {1, 3, 224, 224};
+      std::vector<float> input(1 * 3 * 224 * 224, 0);
+      input_t->Reshape(in_shape);
+      input_t->CopyFromCpu(input.data());
+      for (int j = 0; j < 10; ++j) {
+        ASSERT_TRUE(predictor->Run());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  FLAGS_trt_context_memory_pool_size = 0;
+}
+
 }  // namespace paddle_infer
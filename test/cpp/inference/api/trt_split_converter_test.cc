@@ -15,6 +15,9 @@ limitations under the License. */
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "paddle/common/flags.h"
 #include "test/cpp/inference/api/trt_test_helper.h"
 
@@ -50,5 +53,36 @@ TEST(TensorRT, split_converter) {
   ASSERT_TRUE(predictor->ZeroCopyRun());
 }
 
+TEST(TensorRT, split_converter_calibration_queue) {
+  std::string model_dir = FLAGS_infer_model + "/split_converter";
+  std::string opt_cache_dir = model_dir + "/_opt_cache";
+  delete_cache_files(opt_cache_dir);
+
+  AnalysisConfig config;
+  int batch_size = 4;
+  config.EnableUseGpu(100, 0);
+  config.SetModel(model_dir);
+  config.EnableTensorRtEngine(
+      1 << 20, batch_size, 1, AnalysisConfig::Precision::kInt8, false, true);
+  config.SetTensorRtInt8Calibration(
+      AnalysisConfig::Int8CalibrationAlgorithm::kMinMax, 99.99, 4);
+
+  auto predictor = CreatePaddlePredictor(config);
+
+  int channels = 4;
+  int height = 4;
+  int width = 4;
+  std::vector<float> input(batch_size * channels * height * width);
+  auto input_names = predictor->GetInputNames();
+  auto input_t = predictor->GetInputTensor(input_names[0]);
+  // the calibration batches are run ahead of the TRT calibration
+  for (int i = 0; i < 8; ++i) {
+    std::fill(input.begin(), input.end(), static_cast<float>(i));
+    input_t->Reshape({batch_size, channels, height, width});
+    input_t->copy_from_cpu(input.data());
+    ASSERT_TRUE(predictor->ZeroCopyRun());
+  }
+}
+
 }  // namespace inference
 }  // namespace paddle
@@ -217,6 +217,36 @@ TEST(GpuLayerTest, Clone) {
   auto out_data = cpu_tensor.data<float>();
   EXPECT_NEAR(out_data[0], 0.02194316, 1e-6);
 }
+
+TEST(GpuLayerTest, Prefetch) {
+  if (FLAGS_enable_pir_api) {
+    return;
+  }
+  auto place = phi::GPUPlace();
+
+  std::string path = "./multi_program_load/export";
+  auto layer = jit::Load(path, place);
+  // the batches on the host are staged on the GPU ahead of their calls
+  std::vector<std::vector<Tensor>> batches;
+  for (int i = 0; i < 3; ++i) {
+    batches.push_back(PrepareInputs(phi::CPUPlace()));
+  }
+  layer.Prefetch(batches[0]);
+  for (size_t i = 0; i < batches.size(); ++i) {
+    if (i + 1 < batches.size()) {
+      layer.Prefetch(batches[i + 1]);
+    }
+    auto outs = layer.forward(batches[i]);
+    auto cpu_tensor =
+        paddle::experimental::copy_to(outs[0], phi::CPUPlace(), true);
+    EXPECT_NEAR(cpu_tensor.data<float>()[0], 0.02194316, 1e-6);
+  }
+  // a batch not prefetched is copied when it is called
+  auto outs = layer.forward(PrepareInputs(phi::CPUPlace()));
+  auto cpu_tensor =
+      paddle::experimental::copy_to(outs[0], phi::CPUPlace(), true);
+  EXPECT_NEAR(cpu_tensor.data<float>()[0], 0.02194316, 1e-6);
+}
 #endif
 
 }  // namespace jit
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "paddle/fluid/framework/new_executor/interpreter/stream_analyzer.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+TEST(PickAutoStreams, chain_stays_on_default_stream) {
+  // 0 -> 1 -> 2 -> 3
+  std::vector<std::vector<size_t>> upstream = {{}, {0}, {1}, {2}};
+  std::vector<int> streams =
+      PickAutoStreams(upstream, {true, true, true, true}, {1, 1, 1, 1}, 4);
+  EXPECT_EQ(streams, std::vector<int>({0, 0, 0, 0}));
+}
+
+TEST(PickAutoStreams, fork_and_join) {
+  // 0 -> {1, 2} -> 3, the second branch of the fork moves and the join
+  // goes back to the default stream
+  std::vector<std::vector<size_t>> upstream = {{}, {0}, {0}, {1, 2}};
+  std::vector<int> streams =
+      PickAutoStreams(upstream, {true, true, true, true}, {1, 1, 1, 1}, 2);
+  EXPECT_EQ(streams, std::vector<int>({0, 0, 1, 0}));
+
+  // a chain on a branch stays on its stream
+  upstream = {{}, {0}, {0}, {2}, {3}, {1, 4}};
+  streams = PickAutoStreams(
+      upstream, std::vector<bool>(6, true), std::vector<uint64_t>(6, 1), 2);
+  EXPECT_EQ(streams, std::vector<int>({0, 0, 1, 1, 1, 0}));
+
+  // a single stream keeps everything on the default one
+  streams = PickAutoStreams(
+      upstream, std::vector<bool>(6, true), std::vector<uint64_t>(6, 1), 1);
+  EXPECT_EQ(streams, std::vector<int>(6, 0));
+}
+
+TEST(PickAutoStreams, least_loaded_stream) {
+  // 0 -> {1, 2, 3}
+  std::vector<std::vector<size_t>> upstream = {{}, {0}, {0}, {0}};
+  std::vector<bool> candidates(4, true);
+  EXPECT_EQ(PickAutoStreams(upstream, candidates, {1, 10, 5, 1}, 3),
+            std::vector<int>({0, 0, 1, 2}));
+  // with two streams the third branch joins the lighter one
+  EXPECT_EQ(PickAutoStreams(upstream, candidates, {1, 10, 5, 1}, 2),
+            std::vector<int>({0, 0, 1, 1}));
+  EXPECT_EQ(PickAutoStreams(upstream, candidates, {1, 2, 5, 1}, 2),
+            std::vector<int>({0, 0, 1, 0}));
+}
+
+TEST(PickAutoStreams, placed_instructions_are_left_alone) {
+  // 0 -> {1, 2} -> 3, where 1 is placed explicitly (e.g. a memcpy), so 2
+  // continues the default stream and 3 only follows 2
+  std::vector<std::vector<size_t>> upstream = {{}, {0}, {0}, {1, 2}};
+  std::vector<int> streams =
+      PickAutoStreams(upstream, {true, false, true, true}, {1, 1, 1, 1}, 2);
+  EXPECT_EQ(streams, std::vector<int>({0, -1, 0, 0}));
+
+  // an instruction after placed ones only is a root
+  upstream = {{}, {0}, {1}};
+  streams = PickAutoStreams(upstream, {true, false, true}, {1, 1, 1}, 2);
+  EXPECT_EQ(streams, std::vector<int>({0, -1, 0}));
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
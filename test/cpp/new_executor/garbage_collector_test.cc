@@ -0,0 +1,177 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/new_executor/garbage_collector/event_garbage_collector.h"
+#include "paddle/fluid/framework/new_executor/garbage_collector/fast_garbage_collector.h"
+#include "paddle/fluid/framework/new_executor/garbage_collector/no_event_garbage_collector.h"
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/variable.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+COMMON_DECLARE_int32(new_executor_gc_batch_size);
+
+namespace paddle {
+namespace framework {
+
+class FakeInstruction : public InstructionBase {
+ public:
+  FakeInstruction(size_t id, const phi::Place& place)
+      : InstructionBase(id, place) {}
+
+  void Run() override {}
+
+  const std::string& Name() const override { return name_; }
+
+  ::pir::Operation* Operation() const override { return nullptr; }
+
+ private:
+  std::string name_{"fake"};
+};
+
+constexpr int kInstrNum = 1000;
+constexpr int kVarsPerInstr = 3;
+
+phi::Place TestPlace() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  return phi::GPUPlace(0);
+#else
+  return phi::CPUPlace();
+#endif
+}
+
+// frees kVarsPerInstr variables after each of kInstrNum instructions, like
+// the CheckGC of the interpreters, and checks all of them are released once
+// the garbage collector is destroyed
+void RunGC(
+    const std::function<std::unique_ptr<InterpreterCoreGarbageCollector>(
+        const std::vector<std::unique_ptr<InstructionBase>>&)>& create_gc) {
+  phi::Place place = TestPlace();
+  std::vector<std::unique_ptr<InstructionBase>> instructions;
+  for (int i = 0; i < kInstrNum; ++i) {
+    instructions.emplace_back(std::make_unique<FakeInstruction>(i, place));
+  }
+  std::vector<Variable> vars(kInstrNum * kVarsPerInstr);
+  for (auto& var : vars) {
+    auto* tensor = var.GetMutable<phi::DenseTensor>();
+    tensor->Resize({256});
+    tensor->mutable_data<float>(place);
+  }
+
+  {
+    auto gc = create_gc(instructions);
+    for (int i = 0; i < kInstrNum; ++i) {
+      for (int j = 0; j < kVarsPerInstr; ++j) {
+        gc->Add(&vars[i * kVarsPerInstr + j], instructions[i].get());
+      }
+      gc->Flush(instructions[i].get());
+    }
+  }
+
+  for (auto& var : vars) {
+    EXPECT_FALSE(var.Get<phi::DenseTensor>().IsInitialized());
+  }
+}
+
+void RunEventGC(int batch_size) {
+  int old_batch_size = FLAGS_new_executor_gc_batch_size;
+  FLAGS_new_executor_gc_batch_size = batch_size;
+  RunGC([](const auto& instructions) {
+    return std::make_unique<InterpreterCoreEventGarbageCollector>(
+        instructions);
+  });
+  FLAGS_new_executor_gc_batch_size = old_batch_size;
+}
+
+TEST(InterpreterCoreGarbageCollector, EventGC) { RunEventGC(0); }
+
+// the batches left partial are released when the collector is destroyed
+TEST(InterpreterCoreGarbageCollector, BatchedEventGC) {
+  RunEventGC(1);
+  RunEventGC(16);
+}
+
+// waits until the gc thread releases the holders
+bool WaitReleased(const std::vector<std::weak_ptr<phi::Allocation>>& holders) {
+  for (int i = 0; i < 10000; ++i) {
+    if (std::all_of(holders.begin(), holders.end(), [](const auto& holder) {
+          return holder.expired();
+        })) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+// holds the batches until batch_size instructions, those freeing nothing
+// included, are run on the stream, or until the end of the run
+TEST(InterpreterCoreGarbageCollector, BatchedEventGCRelease) {
+  int old_batch_size = FLAGS_new_executor_gc_batch_size;
+  FLAGS_new_executor_gc_batch_size = 4;
+  phi::Place place = TestPlace();
+  std::vector<std::unique_ptr<InstructionBase>> instructions;
+  for (int i = 0; i < 8; ++i) {
+    instructions.emplace_back(std::make_unique<FakeInstruction>(i, place));
+  }
+  std::vector<Variable> vars(2);
+  std::vector<std::weak_ptr<phi::Allocation>> holders;
+  for (auto& var : vars) {
+    auto* tensor = var.GetMutable<phi::DenseTensor>();
+    tensor->Resize({256});
+    tensor->mutable_data<float>(place);
+    holders.emplace_back(tensor->Holder());
+  }
+
+  InterpreterCoreEventGarbageCollector gc(instructions);
+  gc.Add(&vars[0], instructions[0].get());
+  for (int i = 0; i < 3; ++i) {
+    gc.Flush(instructions[i].get());
+  }
+  EXPECT_FALSE(holders[0].expired());
+  gc.Flush(instructions[3].get());
+  EXPECT_TRUE(WaitReleased({holders[0]}));
+
+  gc.Add(&vars[1], instructions[4].get());
+  gc.Flush(instructions[4].get());
+  EXPECT_FALSE(holders[1].expired());
+  gc.FlushAll();
+  EXPECT_TRUE(WaitReleased({holders[1]}));
+  FLAGS_new_executor_gc_batch_size = old_batch_size;
+}
+
+TEST(InterpreterCoreGarbageCollector, FastGC) {
+  RunGC([](const auto& instructions) {
+    return std::make_unique<InterpreterCoreFastGarbageCollector>();
+  });
+}
+
+TEST(InterpreterCoreGarbageCollector, NoEventGC) {
+  RunGC([](const auto& instructions) {
+    return std::make_unique<InterpreterCoreNoEventGarbageCollector>();
+  });
+}
+
+}  // namespace framework
+}  // namespace paddle
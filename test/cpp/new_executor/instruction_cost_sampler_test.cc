@@ -0,0 +1,73 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "paddle/fluid/framework/new_executor/interpreter/instruction_cost_sampler.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+TEST(InstructionCostSampler, histogram) {
+  CostHistogram histogram;
+  histogram.Add(0.5);
+  histogram.Add(1.);
+  histogram.Add(3.);
+  histogram.Add(1e9);
+  EXPECT_EQ(histogram.count, 4u);
+  EXPECT_DOUBLE_EQ(histogram.sum_us, 0.5 + 1. + 3. + 1e9);
+  EXPECT_EQ(histogram.buckets[0], 1u);  // [0, 1)
+  EXPECT_EQ(histogram.buckets[1], 1u);  // [1, 2)
+  EXPECT_EQ(histogram.buckets[2], 1u);  // [2, 4)
+  EXPECT_EQ(histogram.buckets[CostHistogram::kBucketNum - 1], 1u);
+}
+
+TEST(InstructionCostSampler, prometheus) {
+  auto& sampler = InstructionCostSampler::Instance();
+  sampler.Reset();
+  sampler.AddHostCost("pd_op.add", 3.);
+  sampler.AddHostCost("pd_op.add", 5.);
+  sampler.AddHostCost("pd_op.relu", 1.);
+
+  const auto costs = sampler.Snapshot();
+  ASSERT_EQ(costs.size(), 2u);
+  EXPECT_EQ(costs.at("pd_op.add").host.count, 2u);
+  EXPECT_EQ(costs.at("pd_op.add").device.count, 0u);
+
+  const std::string text = sampler.DumpPrometheus();
+  EXPECT_NE(text.find("# TYPE paddle_instruction_host_seconds histogram"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_instruction_host_seconds_bucket{op=\"pd_op.add\","
+                      "le=\"4e-06\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_instruction_host_seconds_bucket{op=\"pd_op.add\","
+                      "le=\"+Inf\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(
+      text.find("paddle_instruction_host_seconds_count{op=\"pd_op.relu\"} 1\n"),
+      std::string::npos);
+  // no device cost is sampled
+  EXPECT_EQ(text.find("paddle_instruction_device_seconds_count"),
+            std::string::npos);
+
+  sampler.Reset();
+  EXPECT_TRUE(sampler.Snapshot().empty());
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
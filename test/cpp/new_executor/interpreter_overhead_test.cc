@@ -0,0 +1,235 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the host cost the executors spend on each instruction of the
+// programs of tiny ops, i.e. the dispatch, the dependency counting and the
+// garbage collection, which bounds the speed of the small models.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/executor.h"
+#include "paddle/fluid/framework/new_executor/interpretercore.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
+
+USE_OP_ITSELF(fill_constant);
+USE_OP_ITSELF(elementwise_add);
+
+PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+
+namespace paddle {
+namespace framework {
+
+constexpr int kOpNum = 1000;
+constexpr int kRepeat = 20;
+
+// the microseconds each op takes in a run of run_once, after a warm up run
+double UsPerOp(const std::function<void()>& run_once) {
+  run_once();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    run_once();
+  }
+  double us = std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  return us / kRepeat / kOpNum;
+}
+
+void Report(const std::string& executor,
+            const std::string& program,
+            double us_per_op) {
+  std::cout << std::left << std::setw(36) << executor << std::setw(12)
+            << program << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << us_per_op << " us/op" << std::endl;
+}
+
+//
+// The pir programs, run by the PirInterpreter.
+//
+enum class Shape { kChain, kFanOut, kControlFlow };
+
+const char* ShapeName(Shape shape) {
+  switch (shape) {
+    case Shape::kChain:
+      return "chain";
+    case Shape::kFanOut:
+      return "fan-out";
+    default:
+      return "if";
+  }
+}
+
+// kOpNum adds on tensors of a single element, which
+//   chain: out = x + x + ... + x
+//   fan-out: out_i = x + x, all of them read x
+//   if: out = if (true) {out + x} else {out + x}, kOpNum times
+std::unique_ptr<pir::Program> BuildPirProgram(Shape shape) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+  pir::Program program(ctx);
+  pir::Block* block = program.block();
+  pir::Builder builder(ctx, block);
+
+  pir::Value x = builder
+                     .Build<paddle::dialect::FullOp>(std::vector<int64_t>{1},
+                                                     1.0,
+                                                     phi::DataType::FLOAT32,
+                                                     phi::CPUPlace())
+                     .out();
+  pir::Value cond = builder
+                        .Build<paddle::dialect::FullOp>(
+                            std::vector<int64_t>{1}, true, phi::DataType::BOOL)
+                        .out();
+  pir::Value out = x;
+  for (int i = 0; i < kOpNum; ++i) {
+    if (shape == Shape::kChain) {
+      out = builder.Build<paddle::dialect::AddOp>(out, x)->result(0);
+    } else if (shape == Shape::kFanOut) {
+      out = builder.Build<paddle::dialect::AddOp>(x, x)->result(0);
+    } else {
+      auto if_op = builder.Build<paddle::dialect::IfOp>(
+          cond, std::vector<pir::Type>{x.type()});
+      for (pir::Block* branch : {&if_op.true_block(), &if_op.false_block()}) {
+        builder.SetInsertionPointToStart(branch);
+        auto add = builder.Build<paddle::dialect::AddOp>(out, x);
+        builder.Build<pir::YieldOp>(std::vector<pir::Value>{add->result(0)});
+      }
+      builder.SetInsertionPointToBlockEnd(block);
+      out = if_op->result(0);
+    }
+  }
+  builder.Build<pir::ShadowOutputOp>(out, "out");
+  return paddle::dialect::PdOpLowerToKernelPass(&program);
+}
+
+// With used_for_low_latency, the instructions are called in order without
+// the dependency counting and the garbage collection, so the difference to
+// the default run is the cost of both.
+double RunPir(Shape shape, bool low_latency) {
+  auto kernel_program = BuildPirProgram(shape);
+  Scope scope;
+  interpreter::ExecutionConfig config;
+  config.used_for_low_latency = low_latency;
+  InterpreterCore core(
+      phi::CPUPlace(), {}, kernel_program->block(), &scope, config);
+  core.SetSkipGcVars({"out"});
+  return UsPerOp([&core] { core.Run({}); });
+}
+
+//
+// The legacy programs, run by the ProgramInterpreter and the Executor.
+//
+ProgramDesc BuildLegacyProgram(Shape shape) {
+  ProgramDesc program;
+  BlockDesc* block = program.MutableBlock(0);
+  block->Var("x")->SetType(proto::VarType::LOD_TENSOR);
+  OpDesc* fill = block->AppendOp();
+  fill->SetType("fill_constant");
+  fill->SetOutput("Out", {"x"});
+  fill->SetAttr("shape", std::vector<int64_t>{1});
+  fill->SetAttr("value", 1.0f);
+  fill->SetAttr("dtype", static_cast<int>(proto::VarType::FP32));
+
+  std::string out = "x";
+  for (int i = 0; i < kOpNum; ++i) {
+    const std::string name = "out_" + std::to_string(i);
+    block->Var(name)->SetType(proto::VarType::LOD_TENSOR);
+    OpDesc* add = block->AppendOp();
+    add->SetType("elementwise_add");
+    add->SetInput("X", {shape == Shape::kChain ? out : "x"});
+    add->SetInput("Y", {"x"});
+    add->SetOutput("Out", {name});
+    add->SetAttr("axis", -1);
+    out = name;
+  }
+  return program;
+}
+
+// The gc is disabled by skipping all the variables.
+double RunProgramInterpreter(Shape shape, bool gc) {
+  ProgramDesc program = BuildLegacyProgram(shape);
+  Scope scope;
+  interpreter::ExecutionConfig config;
+  if (!gc) {
+    for (auto* var : program.Block(0).AllVars()) {
+      config.skip_gc_vars.insert(var->Name());
+    }
+  }
+  InterpreterCore core(phi::CPUPlace(), program.Block(0), &scope, config);
+  return UsPerOp([&core] { core.Run({}, {}); });
+}
+
+double RunExecutor(Shape shape, bool gc) {
+  ProgramDesc program = BuildLegacyProgram(shape);
+  Scope scope;
+  Executor executor(phi::CPUPlace());
+  auto prepared = Executor::Prepare(program, 0, {}, /*force_disable_gc=*/!gc);
+  return UsPerOp([&] {
+    executor.RunPreparedContext(prepared.get(), &scope, true, true, false);
+  });
+}
+
+TEST(InterpreterOverhead, Benchmark) {
+  std::cout << kOpNum << " ops of a single element, " << kRepeat << " runs"
+            << std::endl;
+  for (Shape shape : {Shape::kChain, Shape::kFanOut, Shape::kControlFlow}) {
+    const double pir_us = RunPir(shape, /*low_latency=*/false);
+    const double pir_low_latency_us = RunPir(shape, /*low_latency=*/true);
+    Report("PirInterpreter", ShapeName(shape), pir_us);
+    Report("PirInterpreter, low latency",
+           ShapeName(shape),
+           pir_low_latency_us);
+    Report("  dependency and gc",
+           ShapeName(shape),
+           pir_us - pir_low_latency_us);
+    EXPECT_GT(pir_us, 0.);
+  }
+  for (Shape shape : {Shape::kChain, Shape::kFanOut}) {
+    const double program_us = RunProgramInterpreter(shape, /*gc=*/true);
+    const double program_no_gc_us = RunProgramInterpreter(shape, false);
+    const double executor_us = RunExecutor(shape, /*gc=*/true);
+    const double executor_no_gc_us = RunExecutor(shape, false);
+    Report("ProgramInterpreter", ShapeName(shape), program_us);
+    Report("  gc", ShapeName(shape), program_us - program_no_gc_us);
+    Report("Executor", ShapeName(shape), executor_us);
+    Report("  gc", ShapeName(shape), executor_us - executor_no_gc_us);
+    EXPECT_GT(program_us, 0.);
+    EXPECT_GT(executor_us, 0.);
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
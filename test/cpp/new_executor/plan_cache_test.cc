@@ -0,0 +1,133 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/plan_cache.h"
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+
+COMMON_DECLARE_string(pir_interpreter_plan_cache_dir);
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+class NamedInstruction : public InstructionBase {
+ public:
+  NamedInstruction(size_t id, const std::string& name)
+      : InstructionBase(id, phi::CPUPlace()), name_(name) {}
+
+  void Run() override {}
+
+  const std::string& Name() const override { return name_; }
+
+  ::pir::Operation* Operation() const override { return nullptr; }
+
+ private:
+  std::string name_;
+};
+
+// a fresh instruction list, as built by a new interpreter of the program
+std::vector<std::unique_ptr<InstructionBase>> BuildInstructions(
+    const std::vector<std::string>& names) {
+  std::vector<std::unique_ptr<InstructionBase>> instructions;
+  for (size_t i = 0; i < names.size(); ++i) {
+    instructions.emplace_back(std::make_unique<NamedInstruction>(i, names[i]));
+  }
+  return instructions;
+}
+
+InterpreterPlan MakePlan() {
+  InterpreterPlan plan;
+  plan.instr_num = 3;
+  plan.downstream_map[0] = {1, 2};
+  plan.downstream_map[1] = {2};
+  plan.events = {{2, 0}};
+  return plan;
+}
+
+class PlanCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    old_dir_ = FLAGS_pir_interpreter_plan_cache_dir;
+    FLAGS_pir_interpreter_plan_cache_dir = "./plan_cache_test_dir";
+    mkdir(FLAGS_pir_interpreter_plan_cache_dir.c_str(), 0755);
+  }
+  void TearDown() override {
+    FLAGS_pir_interpreter_plan_cache_dir = old_dir_;
+  }
+
+ private:
+  std::string old_dir_;
+};
+
+TEST_F(PlanCacheTest, LoadInFreshInterpreter) {
+  auto signatures =
+      InstructionSignatures(BuildInstructions({"matmul", "add", "relu"}));
+  uint64_t key = InterpreterPlanKey(signatures);
+  SaveInterpreterPlan(key, signatures, MakePlan());
+
+  auto fresh_signatures =
+      InstructionSignatures(BuildInstructions({"matmul", "add", "relu"}));
+  EXPECT_EQ(InterpreterPlanKey(fresh_signatures), key);
+  InterpreterPlan plan;
+  ASSERT_TRUE(LoadInterpreterPlan(key, fresh_signatures, &plan));
+  InterpreterPlan expected = MakePlan();
+  EXPECT_EQ(plan.instr_num, expected.instr_num);
+  EXPECT_EQ(plan.downstream_map, expected.downstream_map);
+  EXPECT_EQ(plan.events, expected.events);
+}
+
+TEST_F(PlanCacheTest, ChangedProgramMisses) {
+  auto signatures =
+      InstructionSignatures(BuildInstructions({"matmul", "add", "relu"}));
+  uint64_t key = InterpreterPlanKey(signatures);
+  SaveInterpreterPlan(key, signatures, MakePlan());
+
+  auto changed =
+      InstructionSignatures(BuildInstructions({"matmul", "add", "gelu"}));
+  uint64_t changed_key = InterpreterPlanKey(changed);
+  EXPECT_NE(changed_key, key);
+  InterpreterPlan plan;
+  EXPECT_FALSE(LoadInterpreterPlan(changed_key, changed, &plan));
+  // even on a collision of the keys the saved signatures do not match
+  EXPECT_FALSE(LoadInterpreterPlan(key, changed, &plan));
+  auto shorter = InstructionSignatures(BuildInstructions({"matmul", "add"}));
+  EXPECT_FALSE(LoadInterpreterPlan(key, shorter, &plan));
+}
+
+TEST(DependencyPrefix, SharedPrefix) {
+  auto signatures =
+      InstructionSignatures(BuildInstructions({"matmul", "add", "relu"}));
+  RememberDependency(signatures, MakePlan().downstream_map);
+
+  auto other =
+      InstructionSignatures(BuildInstructions({"matmul", "add", "gelu"}));
+  std::map<size_t, std::set<size_t>> prefix_downstream_map;
+  EXPECT_EQ(FindDependencyPrefix(other, &prefix_downstream_map), 2UL);
+  std::map<size_t, std::set<size_t>> expected = {{0, {1}}};
+  EXPECT_EQ(prefix_downstream_map, expected);
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
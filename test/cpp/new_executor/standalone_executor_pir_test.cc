@@ -33,12 +33,16 @@
 
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/common/macros.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
 
 DECLARE_FILE_SYMBOLS(kernel_dialect);
 
+COMMON_DECLARE_bool(pir_interpreter_incremental_plan);
+COMMON_DECLARE_bool(pir_interpreter_reuse_infer_meta);
+
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(full_int_array, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(uniform, CPU, ALL_LAYOUT);
@@ -343,5 +347,115 @@ TEST(StandaloneExecutor, while_op) {
   EXPECT_EQ(res0, true);
 }
 
+// Run sqrt(4 + 5), and 3 + 5 after it if with_tail, with the dependencies of
+// the shared instructions reused from the earlier run.
+float RunWithIncrementalPlan(bool with_tail) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  auto x = builder
+               .Build<paddle::dialect::FullOp>(std::vector<int64_t>{2, 2},
+                                               4.0,
+                                               phi::DataType::FLOAT32,
+                                               phi::CPUPlace())
+               .out();
+  auto y = builder
+               .Build<paddle::dialect::FullOp>(std::vector<int64_t>{2, 2},
+                                               5.0,
+                                               phi::DataType::FLOAT32,
+                                               phi::CPUPlace())
+               .out();
+  auto add = builder.Build<paddle::dialect::AddOp>(x, y).out();
+  auto sqrt = builder.Build<paddle::dialect::SqrtOp>(add).out();
+  std::string out_name = "sqrt_out";
+  if (with_tail) {
+    sqrt = builder.Build<paddle::dialect::AddOp>(sqrt, y).out();
+    out_name = "tail_out";
+  }
+  builder.Build<pir::ShadowOutputOp>(sqrt, out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+  Scope scope;
+  InterpreterCore test_core(
+      phi::CPUPlace(), {}, kernel_program->block(), &scope);
+  test_core.SetSkipGcVars({out_name});
+  test_core.Run({});
+
+  Scope* out_scope =
+      test_core.local_scope() == nullptr ? &scope : test_core.local_scope();
+  return out_scope->FindVar(out_name)->Get<phi::DenseTensor>().data<float>()[0];
+}
+
+TEST(StandaloneExecutor, run_incremental_plan) {
+  FLAGS_pir_interpreter_incremental_plan = true;
+  EXPECT_TRUE(simple_cmp(RunWithIncrementalPlan(false), 3.0));
+  EXPECT_TRUE(simple_cmp(RunWithIncrementalPlan(true), 8.0));
+  EXPECT_TRUE(simple_cmp(RunWithIncrementalPlan(false), 3.0));
+  FLAGS_pir_interpreter_incremental_plan = false;
+}
+
+// Runs a chain of small adds on cpu `run_num` times and returns the output of
+// the last run.
+float RunSmallProgram(bool low_latency, int run_num) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  auto x = builder
+               .Build<paddle::dialect::FullOp>(std::vector<int64_t>{2, 2},
+                                               1.0,
+                                               phi::DataType::FLOAT32,
+                                               phi::CPUPlace())
+               .out();
+  auto y = builder
+               .Build<paddle::dialect::FullOp>(std::vector<int64_t>{2, 2},
+                                               0.5,
+                                               phi::DataType::FLOAT32,
+                                               phi::CPUPlace())
+               .out();
+  for (int i = 0; i < 32; ++i) {
+    x = builder.Build<paddle::dialect::AddOp>(x, y).out();
+  }
+  std::string out_name = "low_latency_out";
+  builder.Build<pir::ShadowOutputOp>(x, out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+  Scope scope;
+  interpreter::ExecutionConfig execution_config;
+  execution_config.create_local_scope = false;
+  execution_config.used_for_inference = true;
+  execution_config.used_for_low_latency = low_latency;
+  execution_config.skip_gc_vars = {out_name};
+  InterpreterCore test_core(
+      phi::CPUPlace(), {}, kernel_program->block(), &scope, execution_config);
+  for (int i = 0; i < run_num; ++i) {
+    test_core.Run({}, false);
+  }
+  return scope.FindVar(out_name)->Get<phi::DenseTensor>().data<float>()[0];
+}
+
+TEST(StandaloneExecutor, low_latency_run) {
+  // the first run traces the program, the later ones reuse the trace
+  constexpr int kRunNum = 3;
+  EXPECT_TRUE(simple_cmp(RunSmallProgram(false, kRunNum), 17.0));
+  EXPECT_TRUE(simple_cmp(RunSmallProgram(true, kRunNum), 17.0));
+}
+
+TEST(StandaloneExecutor, reuse_infer_meta) {
+  constexpr int kRunNum = 10;
+  float reused_out = 0.f;
+  float out = 0.f;
+  FLAGS_pir_interpreter_reuse_infer_meta = true;
+  RunSmallProgram(false, kRunNum, &reused_out);
+  FLAGS_pir_interpreter_reuse_infer_meta = false;
+  RunSmallProgram(false, kRunNum, &out);
+  FLAGS_pir_interpreter_reuse_infer_meta = true;
+  EXPECT_TRUE(simple_cmp(reused_out, 17.0));
+  EXPECT_TRUE(simple_cmp(out, 17.0));
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_plan.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+void CheckPlan(const std::vector<BufferLifetime>& buffers,
+               const StaticMemoryPlan& plan,
+               size_t alignment) {
+  ASSERT_EQ(plan.offsets.size(), buffers.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    EXPECT_EQ(plan.offsets[i] % alignment, 0UL);
+    EXPECT_LE(plan.offsets[i] + buffers[i].size, plan.arena_size);
+    for (size_t j = i + 1; j < buffers.size(); ++j) {
+      const bool alive_together = buffers[i].first_use <= buffers[j].last_use &&
+                                  buffers[j].first_use <= buffers[i].last_use;
+      const bool overlap =
+          plan.offsets[i] < plan.offsets[j] + buffers[j].size &&
+          plan.offsets[j] < plan.offsets[i] + buffers[i].size;
+      EXPECT_FALSE(alive_together && overlap)
+          << "buffer " << i << " overlaps with buffer " << j;
+    }
+  }
+}
+
+TEST(StaticMemoryPlan, reuse_dead_buffers) {
+  // a chain of ops, where every buffer dies right after its consumer
+  std::vector<BufferLifetime> buffers = {
+      {100, 0, 1}, {100, 1, 2}, {100, 2, 3}, {50, 3, 4}};
+  StaticMemoryPlan plan = PlanStaticMemory(buffers, 64);
+  CheckPlan(buffers, plan, 64);
+  EXPECT_EQ(plan.arena_size, 256UL);
+  EXPECT_EQ(plan.offsets[0], plan.offsets[2]);
+  EXPECT_EQ(plan.offsets[1], plan.offsets[3]);
+}
+
+TEST(StaticMemoryPlan, best_fit_gap) {
+  std::vector<BufferLifetime> buffers = {
+      {256, 0, 3}, {128, 0, 0}, {512, 0, 3}, {64, 1, 2}};
+  StaticMemoryPlan plan = PlanStaticMemory(buffers, 64);
+  CheckPlan(buffers, plan, 64);
+  // the small buffer takes the place of the one dead before it
+  EXPECT_EQ(plan.offsets[3], plan.offsets[1]);
+  EXPECT_EQ(plan.arena_size, 896UL);
+}
+
+TEST(StaticMemoryPlan, random_lifetimes) {
+  std::mt19937 gen(2024);
+  std::uniform_int_distribution<size_t> size_dist(1, 4096);
+  std::uniform_int_distribution<size_t> pos_dist(0, 99);
+  std::vector<BufferLifetime> buffers(500);
+  size_t total_size = 0;
+  for (auto& buffer : buffers) {
+    buffer.size = size_dist(gen);
+    buffer.first_use = pos_dist(gen);
+    buffer.last_use =
+        std::min<size_t>(buffer.first_use + pos_dist(gen) % 10, 99);
+    total_size += (buffer.size + 255) / 256 * 256;
+  }
+  StaticMemoryPlan plan = PlanStaticMemory(buffers, 256);
+  CheckPlan(buffers, plan, 256);
+  EXPECT_LT(plan.arena_size, total_size);
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,86 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/api/include/api.h"
+#include "paddle/phi/api/lib/api_gen_utils.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+
+PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(sum, CPU, ALL_LAYOUT);
+
+COMMON_DECLARE_bool(eager_infer_meta_cache);
+
+namespace paddle {
+namespace tests {
+
+using paddle::experimental::InferMetaCache;
+
+TEST(InferMetaCache, KeyAndApply) {
+  FLAGS_eager_infer_meta_cache = true;
+  phi::DenseTensor x;
+  phi::DenseTensorUtils::GetMutableMeta(&x)->dims = common::make_ddim({2, 3});
+  phi::DenseTensorUtils::GetMutableMeta(&x)->dtype = phi::DataType::FLOAT32;
+  phi::DenseTensor out;
+  phi::MetaTensor meta_out(&out);
+  InferMetaCache cache;
+
+  cache.Begin(true);
+  cache.Add(x);
+  cache.Add(std::vector<int64_t>{1});
+  ASSERT_FALSE(cache.Apply({&meta_out}));
+  meta_out.set_dims(common::make_ddim({2}));
+  meta_out.set_dtype(phi::DataType::FLOAT32);
+  cache.Store({&meta_out});
+
+  phi::DenseTensor next_out;
+  phi::MetaTensor next_meta_out(&next_out);
+  cache.Begin(true);
+  cache.Add(x);
+  cache.Add(std::vector<int64_t>{1});
+  ASSERT_TRUE(cache.Apply({&next_meta_out}));
+  EXPECT_EQ(next_out.dims(), common::make_ddim({2}));
+  EXPECT_EQ(next_out.dtype(), phi::DataType::FLOAT32);
+
+  // another attribute, or the stride kernels, miss
+  cache.Begin(true);
+  cache.Add(x);
+  cache.Add(std::vector<int64_t>{0});
+  EXPECT_FALSE(cache.Apply({&next_meta_out}));
+  cache.Begin(false);
+  cache.Add(x);
+  cache.Add(std::vector<int64_t>{1});
+  EXPECT_FALSE(cache.Apply({&next_meta_out}));
+  FLAGS_eager_infer_meta_cache = false;
+}
+
+TEST(InferMetaCache, Api) {
+  FLAGS_eager_infer_meta_cache = true;
+  for (int rows : {2, 2, 4, 4}) {
+    auto x = paddle::experimental::full({rows, 3}, 1, phi::DataType::FLOAT32);
+    auto out = paddle::experimental::sum(x, {1}, phi::DataType::FLOAT32);
+    ASSERT_EQ(out.dims(), common::make_ddim({rows}));
+    ASSERT_EQ(out.type(), phi::DataType::FLOAT32);
+    ASSERT_EQ(out.data<float>()[rows - 1], 3);
+  }
+  FLAGS_eager_infer_meta_cache = false;
+}
+
+}  // namespace tests
+}  // namespace paddle
@@ -0,0 +1,145 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdlib.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/distributed/comm_task_manager.h"
+
+namespace phi {
+namespace distributed {
+
+static std::shared_ptr<CommTask> MakeTask(uint64_t seq) {
+  // read by the constructor of CommTask
+  setenv("PADDLE_TRAINER_ID", "0", /*overwrite=*/0);
+  return std::make_shared<CommTask>(
+      "nccl", phi::Place(), "group", 0, 1, 0, seq);
+}
+
+TEST(CommTaskRing, capacity) {
+  EXPECT_ANY_THROW(CommTaskRing(0));
+  EXPECT_ANY_THROW(CommTaskRing(3));
+
+  CommTaskRing ring(4);
+  EXPECT_TRUE(ring.Empty());
+  for (uint64_t seq = 0; seq < 4; ++seq) {
+    auto task = MakeTask(seq);
+    ASSERT_TRUE(ring.Push(&task));
+    EXPECT_EQ(task, nullptr);
+  }
+  EXPECT_FALSE(ring.Empty());
+  // a full ring leaves the task to the caller
+  auto task = MakeTask(4);
+  EXPECT_FALSE(ring.Push(&task));
+  ASSERT_NE(task, nullptr);
+  EXPECT_EQ(task->GetSeq(), 4UL);
+
+  std::shared_ptr<CommTask> popped;
+  ASSERT_TRUE(ring.Pop(&popped));
+  EXPECT_EQ(popped->GetSeq(), 0UL);
+  EXPECT_TRUE(ring.Push(&task));
+}
+
+TEST(CommTaskRing, order_and_wraparound) {
+  CommTaskRing ring(4);
+  std::shared_ptr<CommTask> popped;
+  EXPECT_FALSE(ring.Pop(&popped));
+  uint64_t pushed = 0;
+  uint64_t expected = 0;
+  // three at a time, so the positions wrap at a different slot every round
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 3; ++i) {
+      auto task = MakeTask(pushed++);
+      ASSERT_TRUE(ring.Push(&task));
+    }
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(ring.Pop(&popped));
+      EXPECT_EQ(popped->GetSeq(), expected++);
+    }
+    EXPECT_TRUE(ring.Empty());
+    EXPECT_FALSE(ring.Pop(&popped));
+  }
+}
+
+TEST(CommTaskRing, producers) {
+  constexpr int kProducerNum = 4;
+  constexpr uint64_t kTaskNum = 2000;
+  CommTaskRing ring(64);
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducerNum; ++producer) {
+    producers.emplace_back([&ring, producer] {
+      for (uint64_t i = 0; i < kTaskNum; ++i) {
+        auto task = MakeTask(producer * kTaskNum + i);
+        while (!ring.Push(&task)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  // every task is popped once, in the order of its producer
+  std::vector<uint64_t> next(kProducerNum, 0);
+  uint64_t popped_num = 0;
+  std::shared_ptr<CommTask> popped;
+  while (popped_num < kProducerNum * kTaskNum) {
+    if (!ring.Pop(&popped)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint64_t producer = popped->GetSeq() / kTaskNum;
+    ASSERT_LT(producer, static_cast<uint64_t>(kProducerNum));
+    EXPECT_EQ(popped->GetSeq() % kTaskNum, next[producer]++);
+    ++popped_num;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_TRUE(ring.Empty());
+}
+
+TEST(CommLatencyHistogram, buckets) {
+  CommLatencyHistogram histogram;
+  // bucket i holds [2^i, 2^(i+1)) microseconds, the first one also what is
+  // faster and the last one what is slower
+  for (double micros : {0.5, 1.0, 1.9, 2.0, 3.9, 4.0, 1023.0, 1024.0, 1e30}) {
+    histogram.Add(micros);
+  }
+  EXPECT_EQ(histogram.count, 9);
+  EXPECT_EQ(histogram.max_us, 1e30);
+  EXPECT_EQ(histogram.buckets[0], 3);
+  EXPECT_EQ(histogram.buckets[1], 2);
+  EXPECT_EQ(histogram.buckets[2], 1);
+  EXPECT_EQ(histogram.buckets[9], 1);
+  EXPECT_EQ(histogram.buckets[10], 1);
+  EXPECT_EQ(histogram.buckets[CommLatencyHistogram::kBucketNum - 1], 1);
+  int64_t total = 0;
+  for (auto bucket : histogram.buckets) {
+    total += bucket;
+  }
+  EXPECT_EQ(total, histogram.count);
+
+  CommLatencyHistogram sum;
+  sum.Add(10.0);
+  sum.Add(30.0);
+  EXPECT_DOUBLE_EQ(sum.sum_us, 40.0);
+  EXPECT_DOUBLE_EQ(sum.max_us, 30.0);
+  EXPECT_EQ(sum.buckets[3], 1);
+  EXPECT_EQ(sum.buckets[4], 1);
+}
+
+}  // namespace distributed
+}  // namespace phi
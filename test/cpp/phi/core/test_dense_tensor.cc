@@ -195,6 +195,46 @@ TEST(dense_tensor, meta) {
                                       meta_5.valid()));
 }
 
+TEST(dense_tensor, shared_lod) {
+  const LoD lod{{0, 2, 5}};
+  DenseTensorMeta meta(DataType::FLOAT32, DDim({5, 1}), DataLayout::NCHW, lod);
+  DenseTensorMeta copy(meta);
+  // the copies share the lod until one of them modifies it
+  EXPECT_EQ(&meta.lod.get(), &copy.lod.get());
+  copy.lod.mutable_get()->push_back({0, 1, 2, 3, 4, 5});
+  EXPECT_NE(&meta.lod.get(), &copy.lod.get());
+  EXPECT_EQ(meta.lod.get(), lod);
+  EXPECT_EQ(copy.lod.size(), 2UL);
+
+  DenseTensor tensor;
+  tensor.set_meta(meta);
+  DenseTensor shared;
+  shared.ShareDataNoCheckWith(tensor);
+  shared.mutable_lod()->clear();
+  EXPECT_EQ(tensor.lod(), lod);
+  EXPECT_TRUE(shared.lod().empty());
+
+  // the lod of a tensor alone is reset and assigned in place, so the
+  // references to it stay valid
+  DenseTensor owner;
+  owner.set_meta(meta);
+  LoD* owned = owner.mutable_lod();
+  const LoD& owned_ref = owner.lod();
+  EXPECT_EQ(owned, &owned_ref);
+  owner.set_lod({});
+  EXPECT_TRUE(owned->empty());
+  owner.set_lod(lod);
+  EXPECT_EQ(*owned, lod);
+  DenseTensorMeta other_meta(
+      DataType::FLOAT32, DDim({5, 1}), DataLayout::NCHW, LoD{{0, 5}});
+  owner.set_meta(other_meta);
+  EXPECT_EQ(owned, &owner.lod());
+  EXPECT_EQ(owned_ref, other_meta.lod.get());
+  owner.ShareDataNoCheckWith(tensor);
+  EXPECT_EQ(owned, &owner.lod());
+  EXPECT_EQ(owned_ref, lod);
+}
+
 TEST(dense_tensor, def_ctor) {
   DenseTensor tensor_0;
   PADDLE_ENFORCE_EQ(
@@ -0,0 +1,70 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <utility>
+
+#include "paddle/phi/core/generator.h"
+
+namespace phi {
+namespace tests {
+
+TEST(CounterBasedRNG, SeedOffset) {
+  Generator generator(42);
+  Generator same_seed(42);
+  auto key = generator.CounterBasedSeedOffset(3, 5, 0);
+  EXPECT_EQ(key, same_seed.CounterBasedSeedOffset(3, 5, 0));
+  EXPECT_EQ(key.second, 0UL);
+
+  std::set<uint64_t> seeds = {key.first,
+                              generator.CounterBasedSeedOffset(4, 5, 0).first,
+                              generator.CounterBasedSeedOffset(3, 6, 0).first,
+                              generator.CounterBasedSeedOffset(3, 5, 1).first};
+  EXPECT_EQ(seeds.size(), 4UL);
+
+  generator.SetCurrentSeed(43);
+  EXPECT_NE(generator.CounterBasedSeedOffset(3, 5, 0), key);
+}
+
+TEST(CounterBasedRNG, Guard) {
+  Generator generator(42);
+  EXPECT_EQ(CounterBasedRNGGuard::Current(), nullptr);
+  {
+    CounterBasedRNGGuard outer(1, 2);
+    EXPECT_EQ(CounterBasedRNGGuard::Current(), &outer);
+    {
+      CounterBasedRNGGuard inner(3, 4);
+      EXPECT_EQ(CounterBasedRNGGuard::Current(), &inner);
+      EXPECT_EQ(inner.NextSeedOffset(generator),
+                generator.CounterBasedSeedOffset(3, 4, 0));
+      EXPECT_EQ(inner.NextSeedOffset(generator),
+                generator.CounterBasedSeedOffset(3, 4, 1));
+    }
+    EXPECT_EQ(CounterBasedRNGGuard::Current(), &outer);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
+    defined(PADDLE_WITH_XPU) || defined(PADDLE_WITH_CUSTOM_DEVICE)
+    // the draws within the guard leave the stateful offset untouched
+    const uint64_t offset = generator.GetState().offset;
+    EXPECT_EQ(generator.IncrementOffset(4),
+              generator.CounterBasedSeedOffset(1, 2, 0));
+    EXPECT_EQ(generator.GetState().offset, offset);
+#endif
+  }
+  EXPECT_EQ(CounterBasedRNGGuard::Current(), nullptr);
+}
+
+}  // namespace tests
+}  // namespace phi
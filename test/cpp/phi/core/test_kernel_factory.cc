@@ -48,6 +48,53 @@ TEST(KernelFactory, SelectedKernelMap) {
   }
 }
 
+TEST(KernelFactory, SelectKernelWithCache) {
+  static thread_local phi::KernelSelectionCache cache;
+  auto& factory = phi::KernelFactory::Instance();
+  phi::KernelKey fp32_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  phi::KernelKey fp64_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT64);
+  for (int i = 0; i < 2; ++i) {
+    for (auto& key : {fp32_key, fp64_key}) {
+      auto expected = factory.SelectKernelOrThrowError("scale", key);
+      auto cached =
+          factory.SelectKernelOrThrowError("scale", key, false, &cache);
+      EXPECT_EQ(&expected.kernel, &cached.kernel);
+      EXPECT_EQ(expected.has_fallback_cpu, cached.has_fallback_cpu);
+      EXPECT_EQ(expected.is_stride_kernel, cached.is_stride_kernel);
+    }
+  }
+  // a hit does not select again
+  uint32_t next = cache.next;
+  auto hit = factory.SelectKernelOrThrowError("scale", fp32_key, false, &cache);
+  EXPECT_EQ(cache.next, next);
+  EXPECT_EQ(&hit.kernel,
+            &factory.SelectKernelOrThrowError("scale", fp32_key).kernel);
+
+  // a miss on a backend without the kernel caches the fallback
+  phi::KernelKey gpu_key(
+      phi::Backend::GPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  auto expected = factory.SelectKernelOrThrowError("scale", gpu_key);
+  for (int i = 0; i < 2; ++i) {
+    auto cached =
+        factory.SelectKernelOrThrowError("scale", gpu_key, false, &cache);
+    EXPECT_EQ(&expected.kernel, &cached.kernel);
+    EXPECT_EQ(expected.has_fallback_cpu, cached.has_fallback_cpu);
+  }
+  EXPECT_EQ(cache.next, next + 1);
+#if !defined(PADDLE_WITH_CUDA) && !defined(PADDLE_WITH_HIP)
+  EXPECT_TRUE(expected.has_fallback_cpu);
+  EXPECT_EQ(&expected.kernel, &hit.kernel);
+#endif
+
+  // a mutable access to the registry drops the cached entries
+  uint64_t tag = cache.entries[0].tag;
+  factory.kernels();
+  factory.SelectKernelOrThrowError("scale", fp32_key, false, &cache);
+  EXPECT_NE(cache.entries[cache.next - 1].tag, tag);
+}
+
 template <typename T, typename Context>
 void TestKernel(const Context& dev_ctx,
                 const DenseTensor& x,
@@ -109,3 +109,29 @@ TEST(mixed_vector, MultiGPU) {
     ASSERT_EQ(tmp[i], i * 100);
   }
 }
+
+TEST(mixed_vector, CachedCUDAOffsets) {
+  phi::GPUPlace gpu(0);
+  const auto* ctx = reinterpret_cast<const phi::GPUContext*>(
+      phi::DeviceContextPool::Instance().Get(gpu));
+  std::vector<size_t> lod = {0, 2, 5, 9};
+  const size_t* ptr = phi::CachedCUDAOffsets(lod, *ctx);
+  // the same offsets of another op in the batch share the upload
+  std::vector<size_t> same_lod = lod;
+  ASSERT_EQ(phi::CachedCUDAOffsets(same_lod, *ctx), ptr);
+
+  ctx->Wait();
+  std::vector<size_t> host(lod.size());
+#ifdef PADDLE_WITH_HIP
+  hipMemcpy(
+      host.data(), ptr, lod.size() * sizeof(size_t), hipMemcpyDeviceToHost);
+#else
+  cudaMemcpy(
+      host.data(), ptr, lod.size() * sizeof(size_t), cudaMemcpyDeviceToHost);
+#endif
+  ASSERT_EQ(host, lod);
+
+  // the next batch gets its own upload
+  std::vector<size_t> next_lod = {0, 3, 4};
+  ASSERT_NE(phi::CachedCUDAOffsets(next_lod, *ctx), ptr);
+}
@@ -12,6 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 #include "paddle/phi/core/distributed/store/tcp_utils.h"
@@ -37,6 +42,54 @@ TEST(MasterDaemon, init) {
   d.reset();
 }
 
+#ifndef _WIN32
+TEST(TCPStore, relay) {
+  constexpr int kWorkers = 4;
+  constexpr uint16_t kPort = 6190;
+  constexpr uint16_t kRelayPort = 6191;
+  std::vector<std::unique_ptr<TCPStore>> stores(kWorkers);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kWorkers; ++i) {
+    // the first store runs both the master and the relay
+    threads.emplace_back([&, i]() {
+      stores[i] = std::make_unique<TCPStore>(
+          "127.0.0.1", kPort, i == 0, kWorkers, 900, kRelayPort, i == 0);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  std::vector<int64_t> counts(kWorkers);
+  for (int i = 0; i < kWorkers; ++i) {
+    threads.emplace_back([&, i]() {
+      counts[i] = stores[i]->add("count", 1);
+      stores[i]->wait("ready");
+      auto values = stores[i]->multi_get({"key0", "key1"});
+      EXPECT_EQ(values[0], std::vector<uint8_t>({1}));
+      EXPECT_EQ(values[1], std::vector<uint8_t>({2, 3}));
+    });
+  }
+  stores[0]->multi_set({"key0", "key1"}, {{1}, {2, 3}});
+  stores[0]->set("ready", {1});
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::sort(counts.begin(), counts.end());
+  for (int i = 0; i < kWorkers; ++i) {
+    EXPECT_EQ(counts[i], i + 1);
+  }
+  EXPECT_TRUE(stores[kWorkers - 1]->check("count"));
+  EXPECT_FALSE(stores[kWorkers - 1]->check("missing"));
+
+  // the master and the relay go last
+  for (int i = kWorkers - 1; i >= 0; --i) {
+    stores[i].reset();
+  }
+}
+#endif
+
 /* now for only c compile test
 TEST(TCPStore, init) {
   TCPStore store("127.0.0.1", 6170, true, 1);
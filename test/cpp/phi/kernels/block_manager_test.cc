@@ -0,0 +1,112 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/block_manager.h"
+
+#include <gtest/gtest.h>
+
+namespace phi {
+namespace tests {
+
+TEST(BlockManager, share_prefix) {
+  funcs::BlockManager manager(8, 4);
+  // a system prompt of 2 blocks and a question
+  std::vector<int64_t> prompt0 = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  std::vector<int64_t> prompt1 = {1, 2, 3, 4, 5, 6, 7, 8, 11};
+  ASSERT_TRUE(manager.AddSequence(0, prompt0));
+  EXPECT_EQ(manager.CachedLength(0), 0);
+  EXPECT_EQ(manager.NumFreeBlocks(), 5);
+
+  ASSERT_TRUE(manager.AddSequence(1, prompt1));
+  EXPECT_EQ(manager.CachedLength(1), 8);
+  EXPECT_EQ(manager.NumFreeBlocks(), 4);
+  const auto& table0 = manager.BlockTable(0);
+  const auto& table1 = manager.BlockTable(1);
+  ASSERT_EQ(table1.size(), 3u);
+  EXPECT_EQ(table1[0], table0[0]);
+  EXPECT_EQ(table1[1], table0[1]);
+  EXPECT_NE(table1[2], table0[2]);
+
+  // the cached blocks outlive the sequences
+  manager.Free(0);
+  manager.Free(1);
+  EXPECT_EQ(manager.NumFreeBlocks(), 8);
+  ASSERT_TRUE(manager.AddSequence(2, prompt0));
+  EXPECT_EQ(manager.CachedLength(2), 8);
+
+  // a prompt of full blocks computes its last block
+  ASSERT_TRUE(manager.AddSequence(3, {1, 2, 3, 4, 5, 6, 7, 8}));
+  EXPECT_EQ(manager.CachedLength(3), 4);
+
+  auto tables = manager.BlockTables({2, 3}, 4);
+  ASSERT_EQ(tables.size(), 8u);
+  EXPECT_EQ(tables[3], -1);
+  EXPECT_EQ(tables[0], tables[4]);
+}
+
+TEST(BlockManager, duplicate_prefix_then_append) {
+  funcs::BlockManager manager(8, 4);
+  ASSERT_TRUE(manager.AddSequence(0, {1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  // the second block is computed again into a block of its own, which is
+  // not cached since the first sequence caches the same tokens
+  ASSERT_TRUE(manager.AddSequence(1, {1, 2, 3, 4, 5, 6, 7, 8}));
+  EXPECT_EQ(manager.CachedLength(1), 4);
+  EXPECT_NE(manager.BlockTable(1)[1], manager.BlockTable(0)[1]);
+
+  // the appended block is cached after the prefix it follows
+  ASSERT_TRUE(manager.Append(1, {20, 21, 22, 23}));
+  int appended = manager.BlockTable(1)[2];
+  ASSERT_TRUE(manager.AddSequence(2, {20, 21, 22, 23, 24}));
+  EXPECT_EQ(manager.CachedLength(2), 0);
+  EXPECT_NE(manager.BlockTable(2)[0], appended);
+  manager.Free(2);
+
+  ASSERT_TRUE(manager.AddSequence(
+      3, {1, 2, 3, 4, 5, 6, 7, 8, 20, 21, 22, 23, 24}));
+  EXPECT_EQ(manager.CachedLength(3), 12);
+  EXPECT_EQ(manager.BlockTable(3)[1], manager.BlockTable(0)[1]);
+  EXPECT_EQ(manager.BlockTable(3)[2], appended);
+}
+
+TEST(BlockManager, copy_on_write) {
+  funcs::BlockManager manager(4, 4);
+  ASSERT_TRUE(manager.AddSequence(0, {1, 2, 3, 4, 5, 6}));
+  manager.Fork(0, 1);
+  EXPECT_EQ(manager.NumFreeBlocks(), 2);
+  EXPECT_TRUE(manager.TakeCopies().empty());
+
+  // the shared last block is copied before it is written
+  int shared = manager.BlockTable(0).back();
+  ASSERT_TRUE(manager.Append(1, {7}));
+  auto copies = manager.TakeCopies();
+  ASSERT_EQ(copies.size(), 1u);
+  EXPECT_EQ(copies[0].first, shared);
+  EXPECT_EQ(copies[0].second, manager.BlockTable(1).back());
+  EXPECT_EQ(manager.BlockTable(0).back(), shared);
+  EXPECT_EQ(manager.BlockTable(0).front(), manager.BlockTable(1).front());
+
+  // the last holder writes its block in place
+  ASSERT_TRUE(manager.Append(0, {8, 9}));
+  EXPECT_TRUE(manager.TakeCopies().empty());
+  EXPECT_EQ(manager.Length(0), 8);
+  EXPECT_EQ(manager.NumFreeBlocks(), 1);
+
+  // no room for 2 more blocks, nothing is appended
+  EXPECT_FALSE(manager.Append(0, {10, 11, 12, 13, 14}));
+  EXPECT_EQ(manager.Length(0), 8);
+  EXPECT_ANY_THROW(manager.Free(2));
+}
+
+}  // namespace tests
+}  // namespace phi
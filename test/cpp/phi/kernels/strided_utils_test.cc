@@ -0,0 +1,86 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/strided_utils.h"
+
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace phi {
+namespace tests {
+
+TEST(StridedUtils, ForEachTransposedView) {
+  // the 2x3 transpose of a contiguous 3x2 tensor
+  const int64_t strides[] = {1, 2};
+  std::vector<int64_t> offsets;
+  funcs::StridedForEach<1>(
+      common::make_ddim({2, 3}),
+      {strides},
+      [&](const std::array<int64_t, 1>& o) { offsets.push_back(o[0]); });
+  EXPECT_EQ(offsets, std::vector<int64_t>({0, 2, 4, 1, 3, 5}));
+}
+
+TEST(StridedUtils, ForEachZeroDim) {
+  int calls = 0;
+  funcs::StridedForEach<1>(
+      common::make_ddim({}),
+      {static_cast<const int64_t*>(nullptr)},
+      [&](const std::array<int64_t, 1>& o) {
+        EXPECT_EQ(o[0], 0);
+        ++calls;
+      });
+  EXPECT_EQ(calls, 1);
+  funcs::StridedForEach<1>(
+      common::make_ddim({2, 0}),
+      {static_cast<const int64_t*>(nullptr)},
+      [&](const std::array<int64_t, 1>&) { ++calls; });
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(StridedUtils, BroadcastStrides) {
+  DenseTensor x;
+  x.set_meta(DenseTensorMeta(DataType::FLOAT32, common::make_ddim({3, 1})));
+  x.set_strides(common::make_ddim({2, 1}));
+  EXPECT_EQ(funcs::BroadcastStrides(x, common::make_ddim({2, 3, 4})),
+            std::vector<int64_t>({0, 2, 0}));
+  EXPECT_EQ(funcs::BroadcastStrides(x, common::make_ddim({3, 1})),
+            std::vector<int64_t>({2, 1}));
+}
+
+TEST(StridedUtils, ReducedSum) {
+  const DDim dims = common::make_ddim({2, 3, 4});
+  EXPECT_EQ(funcs::ReducedStrides(dims, {1}, false),
+            std::vector<int64_t>({4, 0, 1}));
+  EXPECT_EQ(funcs::ReducedStrides(dims, {0, -1}, false),
+            std::vector<int64_t>({0, 1, 0}));
+  EXPECT_EQ(funcs::ReducedStrides(dims, {}, true),
+            std::vector<int64_t>({0, 0, 0}));
+
+  // the sums of the rows of the 3x2 transpose of a contiguous 2x3 tensor
+  const int x[] = {1, 2, 3, 4, 5, 6};
+  const int64_t x_strides[] = {1, 3};
+  const std::vector<int64_t> out_strides =
+      funcs::ReducedStrides(common::make_ddim({3, 2}), {1}, false);
+  std::vector<int> out(3, 0);
+  funcs::StridedForEach<2>(
+      common::make_ddim({3, 2}),
+      {x_strides, out_strides.data()},
+      [&](const std::array<int64_t, 2>& o) { out[o[1]] += x[o[0]]; });
+  EXPECT_EQ(out, std::vector<int>({5, 7, 9}));
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <cstdio>
 #include <functional>
 
 #include "paddle/phi/kernels/autotune/cache.h"
@@ -66,3 +67,45 @@ TEST(AlgosCache, AlgosCache) {
   EXPECT_EQ(autotune_cache.CacheMisses(), 2);
   EXPECT_LT(std::abs(cache_hit_rate - autotune_cache.CacheHitRate()), 1e-5);
 }
+
+TEST(AlgosCache, SaveAndLoadFile) {
+  auto& autotune_cache = phi::autotune::AutoTuneCache::Instance();
+  autotune_cache.Clean();
+  auto& conv_cache =
+      autotune_cache.GetConv(phi::autotune::AlgorithmType::kConvBackwardData);
+  auto& transpose_cache =
+      autotune_cache.Get(phi::autotune::AlgorithmType::kTranspose);
+
+  std::vector<int64_t> x_shape = {8, 64, 56, 56};
+  std::vector<int64_t> w_shape = {64, 64, 3, 3};
+  std::vector<int> paddings = {1, 1};
+  std::vector<int> strides = {1, 1};
+  std::vector<int> dilations = {1, 1};
+  phi::DataType dtype = phi::CppTypeToDataType<float>::Type();
+  phi::autotune::ConvCacheKey key(
+      x_shape, w_shape, paddings, strides, dilations, dtype, 1, 0);
+  phi::autotune::ConvAutoTuneResult node(
+      static_cast<int64_t>(ConvAlgos::CuDNNKernel_2), 1024, true);
+  conv_cache.Set(key, node);
+  size_t transpose_key =
+      phi::autotune::TransposeKey({4, 16, 32}, {0, 2, 1}, dtype);
+  transpose_cache.Set(transpose_key, 3);
+
+  const std::string path = "./test_autotune_cache.txt";
+  EXPECT_TRUE(autotune_cache.SaveToFile(path));
+
+  autotune_cache.Clean();
+  EXPECT_EQ(conv_cache.Find(key), false);
+  EXPECT_EQ(autotune_cache.LoadFromFile(path), 2);
+
+  EXPECT_EQ(conv_cache.Find(key), true);
+  auto result = conv_cache.Get(key);
+  EXPECT_EQ(result.algo, ConvAlgos::CuDNNKernel_2);
+  EXPECT_EQ(result.workspace_size, 1024UL);
+  EXPECT_EQ(result.exhaustive_search, true);
+  EXPECT_EQ(transpose_cache.Find(transpose_key), true);
+  EXPECT_EQ(transpose_cache.Get(transpose_key), 3);
+
+  EXPECT_EQ(autotune_cache.LoadFromFile("./not_exist_autotune_cache.txt"), -1);
+  std::remove(path.c_str());
+}
@@ -132,5 +132,55 @@ TEST(DEV_API, strings_cast_convert_utf8) {
   ASSERT_EQ(dense_upper_out.data()[0].data(), expected_results[1]);
 }
 
+TEST(DEV_API, strings_cast_convert_utf8_mixed) {
+  // 1. create tensor
+  const DDim dims({1, 3});
+  StringTensorMeta meta(dims);
+  phi::DeviceContextPool& pool = phi::DeviceContextPool::Instance();
+  auto* dev_ctx = pool.Get(phi::CPUPlace());
+
+  const auto string_allocator =
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace());
+  const auto alloc = string_allocator.get();
+  StringTensor dense_x(alloc, meta);
+
+  // ASCII runs longer than a word around multi-byte characters
+  std::string strs[] = {// NOLINT
+                        "Long ASCII Run Before ÓsscHlo And A Long Run After",
+                        "ëË",
+                        ""};
+
+  pstring* dense_x_data = dev_ctx->template Alloc<pstring>(&dense_x);
+  for (int i = 0; i < 3; ++i) {
+    dense_x_data[i] = strs[i];
+  }
+
+  // 2. get expected results
+  std::string expected_lower[] = {// NOLINT
+                                  "long ascii run before ósschlo and a long "
+                                  "run after",
+                                  "ëë",
+                                  ""};
+  std::string expected_upper[] = {// NOLINT
+                                  "LONG ASCII RUN BEFORE ÓSSCHLO AND A LONG "
+                                  "RUN AFTER",
+                                  "ËË",
+                                  ""};
+
+  // 3. test API, utf8 encoding
+  auto dense_lower_out = phi::strings::StringLower(
+      *(static_cast<phi::CPUContext*>(dev_ctx)), dense_x, true);
+  auto dense_upper_out = phi::strings::StringUpper(
+      *(static_cast<phi::CPUContext*>(dev_ctx)), dense_x, true);
+
+  // 4. check results
+  ASSERT_EQ(dense_lower_out.numel(), 3);
+  ASSERT_EQ(dense_upper_out.numel(), 3);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(std::string(dense_lower_out.data()[i]), expected_lower[i]);
+    ASSERT_EQ(std::string(dense_upper_out.data()[i]), expected_upper[i]);
+  }
+}
+
 }  // namespace tests
 }  // namespace phi
@@ -23,6 +23,7 @@
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/device_context.h"
 #include "paddle/phi/infermeta/unary.h"
+#include "paddle/phi/kernels/funcs/data_layout_transform.h"
 #include "paddle/phi/kernels/transfer_layout_kernel.h"
 
 namespace phi {
@@ -70,5 +71,46 @@ TEST(DEV_API, transfer_layout) {
 }
 
 #endif
+
+TEST(DEV_API, transfer_layout_and_dtype) {
+  const int n = 2;
+  const int c = 3;
+  const int h = 4;
+  const int w = 5;
+
+  auto& pool = phi::DeviceContextPool::Instance();
+  auto* dev_ctx =
+      static_cast<const phi::CPUContext*>(pool.GetByPlace(phi::CPUPlace()));
+  DenseTensor x;
+  x.set_meta(DenseTensorMeta(
+      DataType::FLOAT32, common::make_ddim({n, c, h, w}), DataLayout::NCHW));
+  float* x_data = dev_ctx->Alloc<float>(&x);
+  for (int i = 0; i < x.numel(); ++i) {
+    x_data[i] = static_cast<float>(i);
+  }
+
+  DenseTensor out;
+  ASSERT_TRUE(phi::funcs::TransDataLayoutAndType(
+      x, DataLayout::NHWC, DataType::FLOAT64, &out));
+  ASSERT_EQ(out.dims(), common::make_ddim({n, h, w, c}));
+  ASSERT_EQ(out.layout(), DataLayout::NHWC);
+  ASSERT_EQ(out.dtype(), DataType::FLOAT64);
+  const double* out_data = out.data<double>();
+  for (int in = 0; in < n; ++in) {
+    for (int ih = 0; ih < h; ++ih) {
+      for (int iw = 0; iw < w; ++iw) {
+        for (int ic = 0; ic < c; ++ic) {
+          ASSERT_EQ(out_data[((in * h + ih) * w + iw) * c + ic],
+                    x_data[((in * c + ic) * h + ih) * w + iw]);
+        }
+      }
+    }
+  }
+
+  // the integer dtypes are left to the separate transforms
+  DenseTensor unsupported;
+  EXPECT_FALSE(phi::funcs::TransDataLayoutAndType(
+      x, DataLayout::NHWC, DataType::INT32, &unsupported));
+}
 }  // namespace tests
 }  // namespace phi
@@ -306,3 +306,46 @@ TEST(BuildCinnPassTest, MultiCinnSubgraph) {
         common::errors::InvalidArgument("Op name mismatch. Please check!"));
   }
 }
+
+std::shared_ptr<::pir::Program> BuildLargeGraph(int chain_length) {
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+
+  auto program = std::make_shared<::pir::Program>(ctx);
+  ::pir::Builder builder = ::pir::Builder(ctx, program->block());
+
+  // full -> relu -> relu -> ... with a square on every relu, which is not
+  // supported by cinn, so every relu is an output of the group.
+  const std::vector<int64_t> shape = {64, 128};
+  pir::Value x = builder
+                     .Build<paddle::dialect::FullOp>(
+                         shape, 1.0, phi::DataType::FLOAT32, phi::GPUPlace())
+                     .result(0);
+  for (int i = 0; i < chain_length; ++i) {
+    x = builder.Build<paddle::dialect::ReluOp>(x).result(0);
+    builder.Build<paddle::dialect::SquareOp>(x);
+  }
+  return program;
+}
+
+TEST(BuildCinnPassTest, LargeGraph) {
+  const int chain_length = 1000;
+  auto origin_program = BuildLargeGraph(chain_length);
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::PassManager pm(ctx);
+  pm.AddPass(pir::CreateBuildCinnPass());
+
+  PADDLE_ENFORCE_EQ(
+      pm.Run(origin_program.get()),
+      true,
+      common::errors::InvalidArgument("Origin program not run. Expected run."));
+
+  // one group of full and all the relus, followed by the squares
+  ASSERT_EQ(origin_program->block()->size(),
+            static_cast<size_t>(chain_length + 1));
+  pir::Operation& group_op = origin_program->block()->front();
+  ASSERT_TRUE(group_op.isa<cinn::dialect::GroupOp>());
+  EXPECT_EQ(group_op.dyn_cast<cinn::dialect::GroupOp>().block()->size(),
+            static_cast<size_t>(chain_length + 2));
+  EXPECT_EQ(group_op.num_results(), static_cast<uint32_t>(chain_length));
+}
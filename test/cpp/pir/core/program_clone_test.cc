@@ -0,0 +1,84 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/ir_mapping.h"
+#include "paddle/pir/include/core/operation.h"
+#include "paddle/pir/include/core/program.h"
+
+namespace {
+
+std::string ProgramString(const pir::Program& program) {
+  std::ostringstream os;
+  program.Print(os);
+  return os.str();
+}
+
+void BuildChain(pir::Program* program, int num_layers) {
+  pir::Builder builder(pir::IrContext::Instance(), program->block());
+  pir::Value x = builder
+                     .Build<paddle::dialect::FullOp>(
+                         std::vector<int64_t>{16, 16}, 1.0)
+                     .out();
+  pir::Value y = builder
+                     .Build<paddle::dialect::FullOp>(
+                         std::vector<int64_t>{16, 16}, 2.0)
+                     .out();
+  for (int i = 0; i < num_layers; ++i) {
+    x = builder.Build<paddle::dialect::AddOp>(x, y).out();
+    x = builder.Build<paddle::dialect::ReluOp>(x).out();
+  }
+}
+
+}  // namespace
+
+TEST(program_clone_test, clone_outlives_origin) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  constexpr int kNumLayers = 1000;
+  auto program = std::make_unique<pir::Program>(ctx);
+  BuildChain(program.get(), kNumLayers);
+
+  pir::IrMapping ir_mapping;
+  std::shared_ptr<pir::Program> cloned = program->Clone(ir_mapping);
+
+  ASSERT_EQ(cloned->block()->size(), program->block()->size());
+  EXPECT_EQ(ProgramString(*cloned), ProgramString(*program));
+
+  // The cloned ops are neither owned by the origin nor by each other.
+  program.reset();
+  std::vector<pir::Operation*> relu_ops;
+  for (auto& op : *cloned->block()) {
+    if (op.isa<paddle::dialect::ReluOp>()) {
+      relu_ops.push_back(&op);
+    }
+  }
+  ASSERT_EQ(relu_ops.size(), static_cast<size_t>(kNumLayers));
+  pir::Operation* last_relu = relu_ops.back();
+  EXPECT_TRUE(last_relu->result(0).use_empty());
+  cloned->block()->erase(*last_relu);
+  EXPECT_EQ(cloned->block()->size(), static_cast<size_t>(2 * kNumLayers + 1));
+  cloned.reset();
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/builtin_type.h"
+#include "paddle/pir/include/core/ir_context.h"
+
+namespace {
+
+constexpr int kThreadNum = 32;
+constexpr int kIterNum = 4000;
+constexpr int kParamNum = 256;
+
+// Run the function in kThreadNum threads at once.
+template <typename Func>
+void RunConcurrently(Func func) {
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < kThreadNum; ++thread_id) {
+    threads.emplace_back(func, thread_id);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+TEST(storage_manager_test, concurrent_attribute) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  std::vector<pir::Attribute> expected;
+  for (int i = 0; i < kParamNum; ++i) {
+    expected.push_back(pir::Int64Attribute::get(ctx, i));
+  }
+  std::atomic<int> mismatch_num{0};
+  RunConcurrently([&](int thread_id) {
+    for (int i = 0; i < kIterNum; ++i) {
+      // Mostly look up the existing instances, and sometimes create new ones
+      // concurrently with the other threads.
+      const int64_t param = i % 8 == 0 ? kParamNum + thread_id * kIterNum + i
+                                       : (i + thread_id) % kParamNum;
+      pir::Attribute attr = pir::Int64Attribute::get(ctx, param);
+      if (param < kParamNum && attr != expected[param]) {
+        ++mismatch_num;
+      }
+    }
+  });
+  EXPECT_EQ(mismatch_num.load(), 0);
+}
+
+TEST(storage_manager_test, concurrent_type) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Type fp32_dtype = pir::Float32Type::get(ctx);
+  std::vector<pir::Type> expected;
+  for (int i = 0; i < kParamNum; ++i) {
+    expected.push_back(
+        pir::VectorType::get(ctx, std::vector<pir::Type>(i, fp32_dtype)));
+  }
+  std::atomic<int> mismatch_num{0};
+  RunConcurrently([&](int thread_id) {
+    for (int i = 0; i < kIterNum; ++i) {
+      const int param = (i + thread_id) % kParamNum;
+      pir::Type type =
+          pir::VectorType::get(ctx, std::vector<pir::Type>(param, fp32_dtype));
+      if (type != expected[param]) {
+        ++mismatch_num;
+      }
+    }
+  });
+  EXPECT_EQ(mismatch_num.load(), 0);
+}
@@ -155,3 +155,35 @@ TEST(kernel_dialect, cond_op_test) {
   program.Print(std::cout);
   auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
 }
+
+TEST(kernel_dialect, repeated_op_kernel_key_test) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  // The kernel keys of the same ops on the same types are resolved once, the
+  // ones with another dtype attribute are not mixed up with them.
+  std::vector<phi::DataType> dtypes = {phi::DataType::FLOAT32,
+                                       phi::DataType::FLOAT64,
+                                       phi::DataType::FLOAT32,
+                                       phi::DataType::FLOAT64};
+  for (auto dtype : dtypes) {
+    auto x = builder
+                 .Build<paddle::dialect::FullOp>(
+                     std::vector<int64_t>{2, 2}, 1.0, dtype, phi::CPUPlace())
+                 .out();
+    builder.Build<paddle::dialect::AddOp>(x, x);
+  }
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+  std::vector<phi::DataType> kernel_dtypes;
+  for (auto& op : *kernel_program->block()) {
+    if (op.isa<paddle::dialect::PhiKernelOp>() &&
+        op.dyn_cast<paddle::dialect::PhiKernelOp>().kernel_name() == "add") {
+      kernel_dtypes.push_back(
+          op.dyn_cast<paddle::dialect::PhiKernelOp>().kernel_key().dtype());
+    }
+  }
+  EXPECT_EQ(kernel_dtypes, dtypes);
+}
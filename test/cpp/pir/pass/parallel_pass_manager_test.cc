@@ -0,0 +1,105 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/builtin_type.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_manager.h"
+#include "test/cpp/pir/tools/test_dialect.h"
+#include "test/cpp/pir/tools/test_op.h"
+
+namespace {
+
+// Prepend a constant to the block of each test.region op.
+class PrependConstantPass : public pir::Pass {
+ public:
+  PrependConstantPass() : pir::Pass("PrependConstantPass", 1) {}
+
+  void Run(pir::Operation* op) override {
+    pir::Block* block = &op->region(0).front();
+    pir::Builder builder(op->ir_context(), block, block->begin());
+    builder.Build<pir::ConstantOp>(builder.double_attr(1.0),
+                                   builder.float64_type());
+    std::lock_guard<std::mutex> guard(mutex_);
+    thread_ids_.insert(std::this_thread::get_id());
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    return op->name() == test::RegionOp::name();
+  }
+
+  bool CanRunInParallel() const override { return true; }
+
+  size_t thread_num() const { return thread_ids_.size(); }
+
+ private:
+  std::mutex mutex_;
+  std::set<std::thread::id> thread_ids_;
+};
+
+test::RegionOp BuildRegionOp(pir::Builder* builder, pir::Value outer_value) {
+  auto region_op = builder->Build<test::RegionOp>();
+  auto* block = new pir::Block();
+  region_op->region(0).push_back(block);
+  pir::Builder region_builder(builder->ir_context(), block);
+  auto constant = region_builder.Build<pir::ConstantOp>(
+      region_builder.double_attr(1.0), region_builder.float64_type());
+  if (outer_value) {
+    // A region using the outer value is not isolated from above.
+    region_builder.Build<test::BranchOp>(
+        std::vector<pir::Value>{outer_value, constant.result(0)}, block);
+  }
+  return region_op;
+}
+
+}  // namespace
+
+TEST(parallel_pass_manager, isolated_regions) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+
+  pir::Program program(ctx);
+  pir::Builder builder(ctx, program.block());
+  auto outer = builder.Build<pir::ConstantOp>(builder.double_attr(1.0),
+                                              builder.float64_type());
+  constexpr size_t kRegionNum = 64;
+  std::vector<test::RegionOp> region_ops;
+  for (size_t i = 0; i < kRegionNum; ++i) {
+    region_ops.push_back(BuildRegionOp(
+        &builder, i % 8 == 0 ? outer.result(0) : pir::Value()));
+  }
+
+  pir::PassManager pm(ctx);
+  auto pass = std::make_unique<PrependConstantPass>();
+  auto* pass_ptr = pass.get();
+  pm.AddPass(std::move(pass));
+  pm.EnableParallelExecution(4);
+  pm.EnablePassTiming(true);
+  EXPECT_TRUE(pm.Run(&program));
+
+  // Each region op is processed exactly once, in parallel or not.
+  for (size_t i = 0; i < kRegionNum; ++i) {
+    EXPECT_EQ(region_ops[i]->region(0).front().size(), i % 8 == 0 ? 3u : 2u);
+  }
+  EXPECT_GE(pass_ptr->thread_num(), 1u);
+  EXPECT_LE(pass_ptr->thread_num(), 4u);
+}
@@ -15,11 +15,15 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/transforms/gpu/fused_dropout_add_pass.h"
 #include "paddle/fluid/pir/transforms/gpu/fused_gemm_epilogue_pass.h"
 #include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/pass/pass_instrumentation.h"
 #include "paddle/pir/include/pass/pass_manager.h"
 #include "paddle/pir/include/pattern_rewrite/pattern_rewrite_driver.h"
 
@@ -142,3 +146,53 @@ TEST(DrrTest, FusedLinear) {
   CHECK_EQ(pm.Run(&program), true);
   EXPECT_EQ(program.block()->size(), 22u);
 }
+
+class PassNameRecorder : public pir::PassInstrumentation {
+ public:
+  explicit PassNameRecorder(std::vector<std::string> *names) : names_(names) {}
+
+  void RunBeforePass(pir::Pass *pass, pir::Operation *op) override {
+    names_->push_back(pass->name());
+  }
+
+ private:
+  std::vector<std::string> *names_;
+};
+
+std::vector<std::string> RunFusedLinearPasses(bool fuse_pattern_rewrite,
+                                              std::vector<std::string> *names) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  BuildProgram(builder);
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(pir::CreateFusedGemmEpiloguePass());
+  pm.AddPass(pir::CreateFusedDropoutAddPass());
+  pm.AddInstrumentation(std::make_unique<PassNameRecorder>(names));
+  if (fuse_pattern_rewrite) {
+    pm.EnablePatternRewriteFusion();
+  }
+  CHECK_EQ(pm.Run(&program), true);
+
+  std::vector<std::string> op_names;
+  for (auto &op : *program.block()) {
+    op_names.push_back(op.name());
+  }
+  return op_names;
+}
+
+TEST(DrrTest, FusedLinearInOneTraversal) {
+  std::vector<std::string> pass_names, fused_pass_names;
+  std::vector<std::string> op_names = RunFusedLinearPasses(false, &pass_names);
+  std::vector<std::string> fused_op_names =
+      RunFusedLinearPasses(true, &fused_pass_names);
+
+  EXPECT_EQ(pass_names.size(), 2u);
+  EXPECT_EQ(fused_pass_names,
+            std::vector<std::string>{"fused_pattern_rewrite_pass"});
+  EXPECT_EQ(fused_op_names.size(), 22u);
+  EXPECT_EQ(fused_op_names, op_names);
+}
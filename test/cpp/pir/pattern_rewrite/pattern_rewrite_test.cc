@@ -22,6 +22,7 @@
 
 #include "paddle/common/enforce.h"
 #include "paddle/common/errors.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_attribute.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -56,6 +57,8 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "test/cpp/pir/tools/macros_utils.h"
 
+COMMON_DECLARE_int32(pir_constant_folding_batch_size);
+
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(sqrt, CPU, ALL_LAYOUT);
@@ -588,6 +591,36 @@ TEST(constant_folding, ConstantFolding_Combine) {
   EXPECT_EQ(program.block()->size(), 2u);
 }
 
+TEST(constant_folding, ConstantFolding_Batched) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  pir::Program program(ctx);
+  paddle::framework::Scope scope;
+  BuildConstantFoldingProgram(&program, ctx, &scope);
+  pir::Program concat_program(ctx);
+  BuildConcatProgram(&concat_program, ctx);
+
+  const int32_t batch_size = FLAGS_pir_constant_folding_batch_size;
+  FLAGS_pir_constant_folding_batch_size = 2;
+  for (auto *program_to_fold : {&program, &concat_program}) {
+    pir::PassManager pm(ctx);
+    std::unique_ptr<pir::Pass> constant_folding_pass =
+        pir::CreateConstantFoldingPass();
+    phi::Place place = phi::CPUPlace();
+    constant_folding_pass->SetNotOwned(pir::Pass::kPlaceAttr, &place);
+    constant_folding_pass->SetNotOwned(pir::Pass::kParamScopeAttr, &scope);
+    pm.AddPass(std::move(constant_folding_pass));
+    pm.AddPass(pir::CreateDeadCodeEliminationPass());
+    pm.EnableIRPrinting();
+
+    CHECK_EQ(pm.Run(program_to_fold), true);
+    EXPECT_EQ(program_to_fold->block()->size(), 2u);
+  }
+  FLAGS_pir_constant_folding_batch_size = batch_size;
+}
+
 void BuildMultiOutputProgram(pir::Program *program, pir::IrContext *ctx) {
   pir::Builder builder = pir::Builder(ctx, program->block());
   auto x = builder
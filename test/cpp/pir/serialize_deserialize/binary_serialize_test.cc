@@ -0,0 +1,99 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/operation.h"
+#include "paddle/pir/include/core/program.h"
+
+namespace {
+
+size_t FileSize(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  return static_cast<size_t>(file.tellg());
+}
+
+std::string ProgramString(const pir::Program& program) {
+  std::ostringstream os;
+  program.Print(os);
+  return os.str();
+}
+
+}  // namespace
+
+TEST(BinarySerializeTest, json_round_trip) {
+  Json json = {{"#", "0.t_dtensor"},
+               {"D", {{{"#", "0.t_f32"}}, {2, -3}, "NCHW", {{0, 1}}, 0}},
+               {"neg", std::numeric_limits<int64_t>::min()},
+               {"unsigned", std::numeric_limits<uint64_t>::max()},
+               {"float", 1.5},
+               {"null", nullptr},
+               {"bool", {true, false}},
+               {"empty", Json::object()}};
+  const std::string binary = pir::WriteBinaryJson(json);
+  ASSERT_TRUE(pir::IsBinaryModule(binary.data(), binary.size()));
+  EXPECT_EQ(pir::ReadBinaryJson(binary.data(), binary.size()), json);
+
+  // A file of a newer format version is rejected.
+  std::string newer = binary;
+  newer[4] = static_cast<char>(pir::kBinaryFormatVersion + 1);
+  EXPECT_ANY_THROW(pir::ReadBinaryJson(newer.data(), newer.size()));
+  // So is a truncated one.
+  EXPECT_ANY_THROW(pir::ReadBinaryJson(binary.data(), binary.size() - 1));
+}
+
+TEST(BinarySerializeTest, program_round_trip) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  pir::Value x = builder
+                     .Build<paddle::dialect::FullOp>(
+                         std::vector<int64_t>{64, 64}, 1.5)
+                     .out();
+  pir::Value y = builder
+                     .Build<paddle::dialect::FullOp>(
+                         std::vector<int64_t>{64, 64}, 2.0)
+                     .out();
+  for (int i = 0; i < 1000; ++i) {
+    x = builder.Build<paddle::dialect::AddOp>(x, y).out();
+    x = builder.Build<paddle::dialect::ReluOp>(x).out();
+  }
+
+  pir::WriteModule(program, "./test_program.json", 0, true, false, true);
+  pir::WriteModule(
+      program, "./test_program.pirb", 0, true, false, true, /*binary*/ true);
+  EXPECT_LT(FileSize("./test_program.pirb"),
+            FileSize("./test_program.json") / 2);
+
+  pir::Program json_program(ctx);
+  pir::Program binary_program(ctx);
+  pir::ReadModule("./test_program.json", &json_program, /*pir_version*/ 0);
+  pir::ReadModule("./test_program.pirb", &binary_program, /*pir_version*/ 0);
+
+  EXPECT_EQ(binary_program.block()->size(), program.block()->size());
+  EXPECT_EQ(ProgramString(binary_program), ProgramString(json_program));
+}
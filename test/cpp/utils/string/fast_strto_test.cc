@@ -0,0 +1,114 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/utils/string/fast_strto.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<std::string> MakeTokens() {
+  std::vector<std::string> tokens = {"0",
+                                     "7",
+                                     "00012",
+                                     "18446744073709551615",
+                                     "18446744073709551616",
+                                     "9999999999999999999",
+                                     "-3",
+                                     "+4",
+                                     "0x1f",
+                                     "1.5",
+                                     "-0.0",
+                                     "0.1",
+                                     ".25",
+                                     "3.",
+                                     "1e5",
+                                     "2.5E-3",
+                                     "16777217",
+                                     "0.00000000001",
+                                     "inf",
+                                     "nan",
+                                     "abc",
+                                     ""};
+  std::mt19937_64 rng(0);
+  for (int i = 0; i < 2000; ++i) {
+    tokens.push_back(std::to_string(rng() >> (rng() % 64)));
+    tokens.push_back(std::to_string(static_cast<int>(rng() % 100000)) + "." +
+                     std::to_string(rng() % 1000000));
+  }
+  return tokens;
+}
+
+}  // namespace
+
+TEST(FastStrto, MatchesLibc) {
+  for (auto& token : MakeTokens()) {
+    for (const char* sep : {" ", "\t", "  "}) {
+      // long enough for the simd loads when the token is short
+      std::string line = sep + token + " 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15";
+      const char* str = line.c_str();
+      const char* end = str + line.size();
+      char* expect_end = nullptr;
+      char* actual_end = nullptr;
+
+      uint64_t expect_u = strtoull(str, &expect_end, 10);
+      uint64_t actual_u =
+          paddle::string::fast_strtoull(str, end, &actual_end);
+      EXPECT_EQ(expect_u, actual_u) << token;
+      EXPECT_EQ(expect_end, actual_end) << token;
+
+      long expect_l = strtol(str, &expect_end, 10);  // NOLINT
+      long actual_l =                                // NOLINT
+          paddle::string::fast_strtol(str, end, &actual_end);
+      EXPECT_EQ(expect_l, actual_l) << token;
+      EXPECT_EQ(expect_end, actual_end) << token;
+
+      float expect_f = strtof(str, &expect_end);
+      float actual_f = paddle::string::fast_strtof(str, end, &actual_end);
+      EXPECT_EQ(0, memcmp(&expect_f, &actual_f, sizeof(float))) << token;
+      EXPECT_EQ(expect_end, actual_end) << token;
+    }
+  }
+}
+
+TEST(FastStrto, EndOfLine) {
+  std::string line = "1234567890123";
+  const char* str = line.c_str();
+  char* endptr = nullptr;
+  EXPECT_EQ(paddle::string::fast_strtoull(str, str + line.size(), &endptr),
+            1234567890123ULL);
+  EXPECT_EQ(endptr, str + line.size());
+}
+
+TEST(FastStrto, ConsecutiveTokens) {
+  // each parse starts at the end of the last one, as the table loaders do
+  std::mt19937_64 rng(0);
+  std::string line;
+  for (int i = 0; i < 1000; ++i) {
+    line += std::to_string(rng()) + " ";
+  }
+  const char* end = line.c_str() + line.size();
+  char* expect_p = const_cast<char*>(line.c_str());
+  char* actual_p = expect_p;
+  for (int i = 0; i < 1000; ++i) {
+    uint64_t expect = strtoull(expect_p, &expect_p, 10);
+    EXPECT_EQ(paddle::string::fast_strtoull(actual_p, end, &actual_p), expect);
+    ASSERT_EQ(actual_p, expect_p);
+  }
+}
@@ -0,0 +1,72 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFFTPlanCache(unittest.TestCase):
+    # Batch sizes which are not powers of two are split into chunks reusing
+    # the plans, and the plans of many lengths share the workspace of the
+    # cache, a small one evicts them if it is created by this test.
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.set_flags(
+            {
+                'FLAGS_cufft_reuse_batched_plan': True,
+                'FLAGS_cufft_plan_cache_max_size': 4,
+            }
+        )
+
+    def tearDown(self):
+        paddle.set_flags(
+            {
+                'FLAGS_cufft_reuse_batched_plan': False,
+                'FLAGS_cufft_plan_cache_max_size': -1,
+            }
+        )
+
+    def test_batch_sizes(self):
+        for batch in [1, 3, 8, 13, 100]:
+            for n in [63, 64, 1000, 4099]:
+                x = np.random.random([batch, n]).astype('float32')
+                out = paddle.fft.rfft(paddle.to_tensor(x))
+                np.testing.assert_allclose(
+                    out.numpy(), np.fft.rfft(x), rtol=1e-4, atol=1e-3
+                )
+                back = paddle.fft.irfft(out, n)
+                np.testing.assert_allclose(
+                    back.numpy(), x, rtol=1e-4, atol=1e-4
+                )
+
+    def test_c2c_batch_dims(self):
+        shape = [5, 3, 17, 12]
+        x = (np.random.random(shape) + 1j * np.random.random(shape)).astype(
+            'complex64'
+        )
+        out = paddle.fft.fft2(paddle.to_tensor(x), axes=(1, 3))
+        np.testing.assert_allclose(
+            out.numpy(), np.fft.fft2(x, axes=(1, 3)), rtol=1e-4, atol=1e-3
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
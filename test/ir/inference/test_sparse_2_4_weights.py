@@ -0,0 +1,95 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.inference import Config, create_predictor
+
+
+def prune_2_of_4(w):
+    # keep the 2 largest magnitudes in every 4 consecutive rows of a column
+    k, n = w.shape
+    groups = w.reshape([k // 4, 4, n])
+    order = np.argsort(np.abs(groups), axis=1, kind='stable')
+    mask = np.ones_like(groups, dtype=bool)
+    np.put_along_axis(mask, order[:, :2, :], False, axis=1)
+    return np.where(mask, groups, 0).reshape([k, n])
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda()
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    'the 2:4 sparse tensor cores require Ampere or later GPUs.',
+)
+class TestSparse24Weights(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        paddle.seed(2024)
+        net = paddle.nn.Linear(64, 32, bias_attr=False)
+        net.to(dtype='float16')
+        self.weight = net.weight.numpy().astype(np.float32)
+        with paddle.pir_utils.DygraphPirGuard():
+            model = paddle.jit.to_static(
+                net,
+                input_spec=[
+                    paddle.static.InputSpec(
+                        shape=[None, 64], dtype='float16', name='x'
+                    )
+                ],
+                full_graph=True,
+            )
+            paddle.jit.save(
+                model, os.path.join(self.temp_dir.name, 'sparse/inference')
+            )
+        # 5 rows are padded to the alignment of the sparse matmul
+        self.x = np.random.random([5, 64]).astype(np.float16)
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def run_predictor(self, max_pruned_ratio):
+        config = Config(
+            os.path.join(self.temp_dir.name, 'sparse/inference.json'),
+            os.path.join(self.temp_dir.name, 'sparse/inference.pdiparams'),
+        )
+        config.enable_use_gpu(256, 0)
+        config.enable_new_ir()
+        config.enable_new_executor()
+        config.enable_sparse_2_4_weights(max_pruned_ratio)
+        self.assertTrue(config.sparse_2_4_weights_enabled())
+        predictor = create_predictor(config)
+        predictor.get_input_handle('x').copy_from_cpu(self.x)
+        predictor.run()
+        output_name = predictor.get_output_names()[0]
+        return predictor.get_output_handle(output_name).copy_to_cpu()
+
+    def test_pruned(self):
+        out = self.run_predictor(1.0)
+        expected = self.x.astype(np.float32) @ prune_2_of_4(self.weight)
+        np.testing.assert_allclose(out, expected, rtol=1e-2, atol=1e-2)
+
+    def test_kept_dense(self):
+        # no weight passes a zero pruned ratio
+        out = self.run_predictor(0.0)
+        expected = self.x.astype(np.float32) @ self.weight
+        np.testing.assert_allclose(out, expected, rtol=1e-2, atol=1e-2)
+
+
+if __name__ == '__main__':
+    unittest.main()
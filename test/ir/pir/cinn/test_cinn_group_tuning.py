@@ -0,0 +1,84 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy
+
+database_dir = tempfile.TemporaryDirectory()
+os.environ['FLAGS_cinn_group_tuning_database'] = os.path.join(
+    database_dir.name, 'group_tuning_database.txt'
+)
+os.environ['FLAGS_cinn_group_tuning'] = '1'
+os.environ['FLAGS_cinn_group_tuning_repeat'] = '2'
+os.environ['FLAGS_cinn_new_group_scheduler'] = '1'
+os.environ['FLAGS_group_schedule_tiling_first'] = '1'
+os.environ['FLAGS_prim_all'] = 'true'
+os.environ['FLAGS_enable_pir_api'] = '1'
+os.environ['FLAGS_use_cinn'] = '1'
+
+import paddle
+
+build_strategy = paddle.static.BuildStrategy()
+build_strategy.build_cinn_pass = True
+
+
+def elementwise_func(x, y):
+    return paddle.nn.functional.relu(x * 2 + y)
+
+
+def reduce_func(x, y):
+    return (x * y).sum(axis=-1)
+
+
+def reduce_all_func(x, y):
+    return (x + y).sum()
+
+
+def to_static(fn):
+    return paddle.jit.to_static(
+        full_graph=True,
+        build_strategy=build_strategy,
+    )(fn)
+
+
+class TestGroupTuning(unittest.TestCase):
+    def check(self, fn, shape):
+        x = paddle.rand(shape)
+        y = paddle.rand(shape)
+        # The first compilation tunes the groups and the second one applies
+        # the tuned configs from the database.
+        for static_fn in [to_static(fn), to_static(lambda x, y: fn(x, y))]:
+            numpy.testing.assert_allclose(
+                fn(x, y).numpy(),
+                static_fn(x, y).numpy(),
+                atol=1e-4,
+                rtol=1e-4,
+            )
+
+    def test_elementwise(self):
+        self.check(elementwise_func, (32, 1024))
+
+    def test_reduce(self):
+        self.check(reduce_func, (64, 128))
+        self.check(reduce_func, (16, 4096))
+
+    def test_reduce_all(self):
+        self.check(reduce_all_func, (8, 512))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,86 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy
+
+profile_dir = tempfile.TemporaryDirectory()
+os.environ['FLAGS_cinn_shape_bucket_profile'] = os.path.join(
+    profile_dir.name, 'shape_bucket_profile.txt'
+)
+os.environ['FLAGS_cinn_new_group_scheduler'] = '1'
+os.environ['FLAGS_group_schedule_tiling_first'] = '1'
+os.environ['FLAGS_prim_all'] = 'true'
+os.environ['FLAGS_prim_enable_dynamic'] = 'true'
+os.environ['FLAGS_enable_pir_api'] = '1'
+os.environ['FLAGS_use_cinn'] = '1'
+os.environ['FLAGS_cinn_bucket_compile'] = '1'
+
+import paddle
+
+build_strategy = paddle.static.BuildStrategy()
+build_strategy.build_cinn_pass = True
+
+
+def func(x, y):
+    x = x * 2 + y
+    x = paddle.nn.functional.relu(x)
+    return x.sum(axis=-1)
+
+
+def to_static(fn):
+    input_spec = [
+        paddle.static.InputSpec(shape=[None, None, 128], dtype='float32'),
+        paddle.static.InputSpec(shape=[None, None, 128], dtype='float32'),
+    ]
+    return paddle.jit.to_static(
+        full_graph=True,
+        build_strategy=build_strategy,
+        input_spec=input_spec,
+    )(fn)
+
+
+class TestShapeBucketSpecialization(unittest.TestCase):
+    def check(self, static_fn, seq_len):
+        x = paddle.rand((4, seq_len, 128))
+        y = paddle.rand((4, seq_len, 128))
+        numpy.testing.assert_allclose(
+            func(x, y).numpy(),
+            static_fn(x, y).numpy(),
+            atol=1e-5,
+            rtol=1e-5,
+        )
+
+    def test_hot_and_cold_buckets(self):
+        # Profile the group, whose hot bucket is 4 x 256.
+        profiled_fn = to_static(func)
+        for _ in range(20):
+            self.check(profiled_fn, 256)
+        self.check(profiled_fn, 17)
+
+        # Compile the group again with the kernel specialized for the hot
+        # bucket, and fall back to the generic kernel for the other shapes.
+        def specialized_func(x, y):
+            return func(x, y)
+
+        specialized_fn = to_static(specialized_func)
+        for seq_len in [256, 17, 100, 256]:
+            self.check(specialized_fn, seq_len)
+
+
+if __name__ == "__main__":
+    unittest.main()
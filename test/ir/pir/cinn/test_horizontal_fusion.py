@@ -62,6 +62,49 @@ class TestHorizontalGraph(unittest.TestCase):
         )
 
 
+class WideHorizontalSubGraph(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, xs):
+        # Independent per-feature normalizations of the same shape.
+        return [
+            (x - x.mean(axis=-1, keepdim=True)) * paddle.rsqrt(x.var(axis=-1))
+            for x in xs
+        ]
+
+
+class TestWideHorizontalGraph(unittest.TestCase):
+    def setUp(self):
+        paddle.seed(2024)
+        self.prepare_data()
+
+    def prepare_data(self):
+        self.xs = [paddle.randn([64, 32], dtype="float32") for _ in range(16)]
+        for x in self.xs:
+            x.stop_gradient = True
+
+    def check_jit_kernel_info(self, static_fn):
+        utils.check_jit_kernel_number(static_fn, 1)
+
+    def eval(self, use_cinn):
+        net = WideHorizontalSubGraph()
+        net.eval()
+        net = utils.apply_to_static(net, use_cinn)
+        outs = net(self.xs)
+        if use_cinn:
+            self.check_jit_kernel_info(net.forward)
+        return outs
+
+    def test_eval(self):
+        cinn_outs = self.eval(use_cinn=True)
+        dy_outs = self.eval(use_cinn=False)
+        for cinn_out, dy_out in zip(cinn_outs, dy_outs):
+            np.testing.assert_allclose(
+                cinn_out.numpy(), dy_out.numpy(), atol=1e-5, rtol=1e-5
+            )
+
+
 if __name__ == '__main__':
     # Fix YieldStore Segment fault.
     # unittest.main()
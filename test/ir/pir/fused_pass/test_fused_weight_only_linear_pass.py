@@ -270,5 +270,53 @@ class TestFusedWeightOnlyLinearPass_Weight_Only_Int8_WithBias(
         ]
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or get_cuda_version() < 11020,
+    "weight_only_linear requires CUDA >= 11.2",
+)
+class TestFusedWeightOnlyLinearPass_GroupWise_WithBias(
+    TestFusedWeightOnlyLinearPass_WithBias
+):
+    def setUp(self):
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+        self.pass_attr_list = [
+            {
+                'fused_weight_only_linear_pass': {
+                    "weight_only_algo": "weight_only_int8",
+                    "weight_only_group_size": 128,
+                }
+            }
+        ]
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or get_cuda_version() < 11020,
+    "weight_only_linear requires CUDA >= 11.2",
+)
+class TestFusedWeightOnlyLinearPass_MaxRows_WithBias(
+    TestFusedWeightOnlyLinearPass_WithBias
+):
+    def get_valid_op_map(self, dtype, w_shape):
+        # x has 3 * 128 rows, more than weight_only_max_rows.
+        self.valid_op_map = {
+            "pd_op.weight_only_linear": 0,
+            "pd_op.weight_quantize": 0,
+            "pd_op.matmul": 1,
+            "pd_op.add": 1,
+        }
+
+    def setUp(self):
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+        self.pass_attr_list = [
+            {
+                'fused_weight_only_linear_pass': {
+                    "weight_only_max_rows": 256,
+                }
+            }
+        ]
+
+
 if __name__ == "__main__":
     unittest.main()
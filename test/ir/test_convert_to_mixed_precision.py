@@ -16,6 +16,8 @@ import os
 import tempfile
 import unittest
 
+import numpy as np
+
 import paddle
 from paddle.inference import (
     PlaceType,
@@ -87,5 +89,60 @@ class TestConvertToMixedPrecision(unittest.TestCase):
                 )
 
 
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda() or paddle.get_cudnn_version() < 8000,
+    'should compile with cuda.',
+)
+class TestConvertToMixedPrecisionWithCalibration(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        model = paddle.nn.Sequential(
+            paddle.nn.Linear(64, 64),
+            paddle.nn.ReLU(),
+            paddle.nn.Linear(64, 16),
+            paddle.nn.Softmax(),
+        )
+        net = to_static(
+            model,
+            input_spec=[InputSpec(shape=[None, 64], name='x')],
+            full_graph=True,
+        )
+        paddle.jit.save(net, os.path.join(self.temp_dir.name, 'mlp/inference'))
+        np.random.seed(2024)
+        self.calibration_data = [
+            {'x': np.random.random([4, 64]).astype('float32')}
+            for _ in range(2)
+        ]
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def convert(self, name, tolerance):
+        return convert_to_mixed_precision(
+            os.path.join(self.temp_dir.name, 'mlp/inference.pdmodel'),
+            os.path.join(self.temp_dir.name, 'mlp/inference.pdiparams'),
+            os.path.join(self.temp_dir.name, f'{name}/inference.pdmodel'),
+            os.path.join(self.temp_dir.name, f'{name}/inference.pdiparams'),
+            backend=PlaceType.GPU,
+            mixed_precision=PrecisionType.Half,
+            black_list={'softmax'},
+            calibration_data=self.calibration_data,
+            tolerance=tolerance,
+        )
+
+    def test_loose_tolerance(self):
+        # every op type besides the given black list runs in fp16
+        self.assertEqual(self.convert('loose', 1.0), {'softmax'})
+
+    def test_zero_tolerance(self):
+        black_list = self.convert('strict', 0.0)
+        self.assertIn('softmax', black_list)
+        self.assertTrue(
+            os.path.exists(
+                os.path.join(self.temp_dir.name, 'strict/inference.pdmodel')
+            )
+        )
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,76 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Measures the decode latency of masked_multihead_attention with the cached
+# sequence split across thread blocks (FLAGS_mmha_split_seq=-1, the default)
+# and without (FLAGS_mmha_split_seq=0), e.g.
+# >>> python benchmark_masked_multihead_attention.py --bsz 1 4 --seq-len 32768
+
+import argparse
+import time
+
+import paddle
+from paddle.incubate.nn.functional import masked_multihead_attention
+
+
+def timeit(bsz, num_head, dim_head, seq_len, split_seq, iters):
+    paddle.set_flags({'FLAGS_mmha_split_seq': split_seq})
+    x = paddle.uniform([bsz, 3 * num_head * dim_head], 'float32', -0.05, 0.05)
+    x = x.cast('float16')
+    cache_kv = paddle.uniform(
+        [2, bsz, num_head, seq_len + 1, dim_head], 'float32', -0.05, 0.05
+    ).cast('float16')
+    src_mask = paddle.zeros([bsz, 1, 1, seq_len + 1], 'float16')
+    for _ in range(10):
+        masked_multihead_attention(x, cache_kv, src_mask=src_mask)
+    paddle.device.synchronize()
+    start = time.perf_counter()
+    for _ in range(iters):
+        masked_multihead_attention(x, cache_kv, src_mask=src_mask)
+    paddle.device.synchronize()
+    return (time.perf_counter() - start) / iters * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--bsz', type=int, nargs='+', default=[1, 2, 4, 16])
+    parser.add_argument(
+        '--seq-len', type=int, nargs='+', default=[1024, 4096, 16384, 32768]
+    )
+    parser.add_argument('--num-head', type=int, default=32)
+    parser.add_argument('--dim-head', type=int, default=128)
+    parser.add_argument('--iters', type=int, default=100)
+    args = parser.parse_args()
+
+    print('bsz\tseq_len\tno split(us)\tsplit(us)\tspeedup')
+    for bsz in args.bsz:
+        for seq_len in args.seq_len:
+            base, split = (
+                timeit(
+                    bsz,
+                    args.num_head,
+                    args.dim_head,
+                    seq_len,
+                    split_seq,
+                    args.iters,
+                )
+                for split_seq in (0, -1)
+            )
+            speedup = base / split
+            print(f'{bsz}\t{seq_len}\t{base:.1f}\t{split:.1f}\t{speedup:.2f}')
+    paddle.set_flags({'FLAGS_mmha_split_seq': -1})
+
+
+if __name__ == '__main__':
+    main()
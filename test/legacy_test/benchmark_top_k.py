@@ -0,0 +1,70 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Measures the latency of topk over the last axis with the multi-pass radix
+# select (FLAGS_topk_radix_select=1) and without (FLAGS_topk_radix_select=0),
+# sweeping k and the row length n, e.g.
+# >>> python benchmark_top_k.py --rows 1 8 --n 1000000 10000000 --k 100 1000
+
+import argparse
+import time
+
+import paddle
+
+
+def timeit(rows, n, k, dtype, radix_select, iters):
+    paddle.set_flags({'FLAGS_topk_radix_select': radix_select})
+    x = paddle.randn([rows, n], 'float32').cast(dtype)
+    for _ in range(5):
+        paddle.topk(x, k)
+    paddle.device.synchronize()
+    start = time.perf_counter()
+    for _ in range(iters):
+        paddle.topk(x, k)
+    paddle.device.synchronize()
+    return (time.perf_counter() - start) / iters * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--rows', type=int, nargs='+', default=[1, 8, 64])
+    parser.add_argument(
+        '--n', type=int, nargs='+', default=[65536, 1000000, 10000000]
+    )
+    parser.add_argument(
+        '--k', type=int, nargs='+', default=[16, 128, 1000, 4096]
+    )
+    parser.add_argument('--dtype', type=str, default='float32')
+    parser.add_argument('--iters', type=int, default=20)
+    args = parser.parse_args()
+
+    print('rows\tn\tk\tdefault(us)\tradix select(us)\tspeedup')
+    for rows in args.rows:
+        for n in args.n:
+            for k in args.k:
+                if k > n:
+                    continue
+                base, radix = (
+                    timeit(rows, n, k, args.dtype, radix_select, args.iters)
+                    for radix_select in (0, 1)
+                )
+                speedup = base / radix
+                print(
+                    f'{rows}\t{n}\t{k}\t{base:.1f}\t{radix:.1f}\t{speedup:.2f}'
+                )
+    paddle.set_flags({'FLAGS_topk_radix_select': -1})
+
+
+if __name__ == '__main__':
+    main()
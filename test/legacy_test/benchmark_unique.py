@@ -0,0 +1,84 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Measures the latency of unique with the inverse and the counts on GPU, by
+# sorting (paddle.unique) and by the hash table (the unique op with
+# is_sorted=False, whose output is in the order of the first occurrence),
+# sweeping the number of ids n and the number of distinct ids, e.g.
+# >>> python benchmark_unique.py --n 1000000 10000000 --distinct 1000 1000000
+
+import argparse
+import time
+
+import paddle
+from paddle import _legacy_C_ops
+from paddle.base import core
+
+
+def sorted_unique(x):
+    return paddle.unique(x, return_inverse=True, return_counts=True)
+
+
+def hash_unique(x):
+    return _legacy_C_ops.unique(
+        x,
+        'dtype',
+        int(core.VarDesc.VarType.INT64),
+        'return_inverse',
+        True,
+        'return_counts',
+        True,
+        'is_sorted',
+        False,
+    )
+
+
+def timeit(fn, n, distinct, dtype, iters):
+    x = paddle.randint(0, distinct, [n], dtype=dtype)
+    for _ in range(5):
+        fn(x)
+    paddle.device.synchronize()
+    start = time.perf_counter()
+    for _ in range(iters):
+        fn(x)
+    paddle.device.synchronize()
+    return (time.perf_counter() - start) / iters * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        '--n', type=int, nargs='+', default=[100000, 1000000, 10000000]
+    )
+    parser.add_argument(
+        '--distinct', type=int, nargs='+', default=[1000, 100000, 10000000]
+    )
+    parser.add_argument('--dtype', type=str, default='int64')
+    parser.add_argument('--iters', type=int, default=20)
+    args = parser.parse_args()
+
+    print('n\tdistinct\tsort(us)\thash(us)\tspeedup')
+    for n in args.n:
+        for distinct in args.distinct:
+            base, hashed = (
+                timeit(fn, n, distinct, args.dtype, args.iters)
+                for fn in (sorted_unique, hash_unique)
+            )
+            print(
+                f'{n}\t{distinct}\t{base:.1f}\t{hashed:.1f}\t{base / hashed:.2f}'
+            )
+
+
+if __name__ == '__main__':
+    main()
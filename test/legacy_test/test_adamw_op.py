@@ -492,7 +492,8 @@ class TestAdamWOpMultiPrecisionWithMainGrad(unittest.TestCase):
             )
 
     def _get_places(self):
-        places = []
+        # the CPU kernel updates the bf16 parameter on its master weight too
+        places = ['cpu']
         if paddle.is_compiled_with_cuda():
             places.append('gpu')
         return places
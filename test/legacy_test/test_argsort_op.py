@@ -563,5 +563,46 @@ class TestArgsortBF16OpDescendingTrue(TestArgsortBF16Op):
         self.descending = True
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestArgsortShortRows(unittest.TestCase):
+    # The rows of no more than 1024 columns are sorted by a block each.
+    def setUp(self):
+        np.random.seed(2024)
+        self.place = core.CUDAPlace(0)
+
+    def check(self, x, axis=-1):
+        paddle.disable_static(self.place)
+        var_x = paddle.to_tensor(x)
+        for descending in (False, True):
+            out = paddle.argsort(
+                var_x, axis=axis, descending=descending, stable=True
+            )
+            expect = np.argsort(
+                -x if descending else x, axis=axis, kind='stable'
+            )
+            np.testing.assert_array_equal(out.numpy(), expect)
+            values = paddle.sort(var_x, axis=axis, descending=descending)
+            np.testing.assert_array_equal(
+                values.numpy(), np.take_along_axis(x, expect, axis=axis)
+            )
+        paddle.enable_static()
+
+    def test_widths(self):
+        for width in (1, 7, 16, 33, 100, 128, 255, 512, 513, 1024):
+            # Ties are kept in the order of the columns.
+            self.check(np.random.randint(-20, 20, [300, width]).astype('int64'))
+
+    def test_float(self):
+        x = np.random.randn(2000, 3, 64).astype('float32')
+        x[0, 0, :4] = [np.inf, -np.inf, 0.0, 0.0]
+        self.check(x)
+        self.check(x, axis=1)
+
+    def test_half(self):
+        self.check(np.random.randn(500, 200).astype('float16'))
+
+
 if __name__ == "__main__":
     unittest.main()
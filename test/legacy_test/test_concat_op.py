@@ -998,6 +998,22 @@ class TestConcatOpErrorWithPir(unittest.TestCase):
                 paddle.concat([], axis=0)
 
 
+class TestConcatManyInputs(unittest.TestCase):
+    # Hundreds of inputs are looked up by a binary search over the offsets,
+    # whose pointers and offsets are uploaded in one packed buffer.
+    def test_many_inputs(self):
+        with base.dygraph.guard():
+            for dtype in ["float32", "float16", "int64"]:
+                xs = [
+                    np.random.random([4, i % 5 + 1, 3]).astype(dtype)
+                    for i in range(300)
+                ]
+                out = paddle.concat([paddle.to_tensor(x) for x in xs], axis=1)
+                np.testing.assert_array_equal(
+                    out.numpy(), np.concatenate(xs, axis=1)
+                )
+
+
 if __name__ == '__main__':
     paddle.enable_static()
     unittest.main()
@@ -0,0 +1,94 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.nn.functional as F
+
+
+def conv2d_ref(x, w, stride, padding, dilation, groups):
+    n = x.shape[0]
+    oc, ic, kh, kw = w.shape
+    x = np.pad(
+        x,
+        ((0, 0), (0, 0), (padding[0], padding[0]), (padding[1], padding[1])),
+    )
+    out_h = (x.shape[2] - dilation[0] * (kh - 1) - 1) // stride[0] + 1
+    out_w = (x.shape[3] - dilation[1] * (kw - 1) - 1) // stride[1] + 1
+    out = np.zeros([n, oc, out_h, out_w], dtype='float64')
+    sub_oc = oc // groups
+    for g in range(groups):
+        xg = x[:, g * ic : (g + 1) * ic]
+        wg = w[g * sub_oc : (g + 1) * sub_oc]
+        for i in range(kh):
+            for j in range(kw):
+                hs = i * dilation[0]
+                ws = j * dilation[1]
+                patch = xg[
+                    :,
+                    :,
+                    hs : hs + stride[0] * (out_h - 1) + 1 : stride[0],
+                    ws : ws + stride[1] * (out_w - 1) + 1 : stride[1],
+                ]
+                out[:, g * sub_oc : (g + 1) * sub_oc] += np.einsum(
+                    'nchw,oc->nohw', patch, wg[:, :, i, j]
+                )
+    return out
+
+
+class TestConv2DImplicitGemmCPU(unittest.TestCase):
+    # Images large enough that the column buffer of im2col does not fit the
+    # cache, so that they are computed by tiles of output pixels.
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.disable_static(paddle.CPUPlace())
+
+    def check(self, shape, oc, k, stride, padding, dilation, groups):
+        x = np.random.uniform(-1, 1, shape).astype('float32')
+        w = np.random.uniform(-1, 1, [oc, shape[1] // groups, k, k]).astype(
+            'float32'
+        )
+        out = F.conv2d(
+            paddle.to_tensor(x),
+            paddle.to_tensor(w),
+            stride=stride,
+            padding=padding,
+            dilation=dilation,
+            groups=groups,
+        )
+        expect = conv2d_ref(
+            x.astype('float64'),
+            w.astype('float64'),
+            [stride, stride],
+            [padding, padding],
+            [dilation, dilation],
+            groups,
+        )
+        np.testing.assert_allclose(out.numpy(), expect, rtol=1e-4, atol=1e-4)
+
+    def test_3x3(self):
+        self.check([2, 16, 97, 101], 8, 3, 1, 1, 1, 1)
+
+    def test_stride_dilation(self):
+        self.check([1, 32, 160, 150], 16, 3, 2, 2, 2, 1)
+
+    def test_groups(self):
+        self.check([1, 32, 128, 128], 16, 5, 1, 2, 1, 2)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,87 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestCounterBasedRNG(unittest.TestCase):
+    def setUp(self):
+        paddle.enable_static()
+        paddle.set_flags({"FLAGS_new_executor_counter_based_rng": True})
+
+    def tearDown(self):
+        paddle.set_flags({"FLAGS_new_executor_counter_based_rng": False})
+        paddle.disable_static()
+
+    def build_program(self):
+        main_program = paddle.static.Program()
+        startup_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program, startup_program):
+            x = paddle.static.data(name='x', shape=[1024], dtype="float32")
+            out = paddle.nn.functional.dropout(x, p=0.5, training=True)
+        return main_program, out
+
+    def run_program(self, main_program, out, executor):
+        x = np.ones([1024], dtype="float32")
+        return executor.run(main_program, feed={'x': x}, fetch_list=[out])[0]
+
+    def test_two_interpreters(self):
+        with paddle.pir_utils.IrGuard():
+            main_program, out = self.build_program()
+            place = paddle.CUDAPlace(0)
+
+            paddle.seed(2024)
+            first = self.run_program(
+                main_program, out, paddle.static.Executor(place)
+            )
+            # a new interpreter of the same program, e.g. after a rebuild,
+            # does not replay the random numbers of the first one
+            second = self.run_program(
+                main_program, out, paddle.static.Executor(place)
+            )
+            self.assertFalse(np.array_equal(first, second))
+
+            # another program at the same position neither
+            other_program, other_out = self.build_program()
+            other = self.run_program(
+                other_program, other_out, paddle.static.Executor(place)
+            )
+            self.assertFalse(np.array_equal(first, other))
+
+            # the runs are reproducible from the seed
+            paddle.seed(2024)
+            again = self.run_program(
+                main_program, out, paddle.static.Executor(place)
+            )
+            np.testing.assert_array_equal(first, again)
+
+    def test_runs_of_one_interpreter(self):
+        with paddle.pir_utils.IrGuard():
+            main_program, out = self.build_program()
+            executor = paddle.static.Executor(paddle.CUDAPlace(0))
+            paddle.seed(2024)
+            first = self.run_program(main_program, out, executor)
+            second = self.run_program(main_program, out, executor)
+            self.assertFalse(np.array_equal(first, second))
+
+
+if __name__ == '__main__':
+    unittest.main()
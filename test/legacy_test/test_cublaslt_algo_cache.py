@@ -0,0 +1,103 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+import paddle
+
+# The cublasLt algo cache reads its file once per process, so every run is a
+# process of its own. It checks fused_linear against numpy.
+RUN_LINEAR = '''
+import numpy as np
+import paddle
+from paddle.incubate.nn.functional import fused_linear
+
+rng = np.random.RandomState(2024)
+for m, n, k in [(8, 256, 128), (32, 512, 256), (64, 128, 64)]:
+    x = rng.uniform(-1, 1, [m, k]).astype('float16')
+    w = rng.uniform(-1, 1, [k, n]).astype('float16')
+    b = rng.uniform(-1, 1, [n]).astype('float16')
+    out = fused_linear(paddle.to_tensor(x), paddle.to_tensor(w),
+                       paddle.to_tensor(b))
+    expected = x.astype('float32') @ w.astype('float32') + b
+    np.testing.assert_allclose(out.numpy().astype('float32'), expected,
+                               rtol=1e-2, atol=1e-2)
+'''
+
+
+def is_cublaslt_supported():
+    if paddle.is_compiled_with_cuda() and not paddle.is_compiled_with_rocm():
+        return hasattr(paddle._C_ops, 'fused_gemm_epilogue')
+    return False
+
+
+@unittest.skipIf(
+    not is_cublaslt_supported(), "fused_gemm_epilogue is not supported"
+)
+class TestCublasLtAlgoCache(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.cache_file = os.path.join(self.temp_dir.name, 'algo_cache')
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def run_linear(self, global_search):
+        env = dict(os.environ)
+        env['FLAGS_enable_blaslt_global_search'] = str(int(global_search))
+        env['FLAGS_cublaslt_algo_cache_file'] = self.cache_file
+        result = subprocess.run(
+            [sys.executable, '-c', RUN_LINEAR],
+            env=env,
+            capture_output=True,
+            text=True,
+        )
+        self.assertEqual(result.returncode, 0, result.stderr)
+
+    def read_cache_file(self):
+        with open(self.cache_file) as f:
+            return f.read()
+
+    def test_write_and_replay(self):
+        self.run_linear(global_search=True)
+        lines = self.read_cache_file().splitlines()
+        # the cudart version and the arch, then a seed, the 8 words of the
+        # algo and its workspace size per gemm, all of them written at exit
+        self.assertEqual(len(lines[0].split()), 2)
+        self.assertEqual(len(lines), 4)
+        for line in lines[1:]:
+            self.assertEqual(len(line.split()), 10)
+
+        # the replay searches nothing, so the file is not rewritten
+        content = self.read_cache_file()
+        self.run_linear(global_search=False)
+        self.assertEqual(self.read_cache_file(), content)
+
+    def test_incompatible_file(self):
+        # a file of another cudart version and arch is ignored
+        with open(self.cache_file, 'w') as f:
+            f.write('1 1\n')
+            f.write('123 1 2 3 4 5 6 7 8 0\n')
+        self.run_linear(global_search=False)
+        self.assertEqual(
+            self.read_cache_file(), '1 1\n123 1 2 3 4 5 6 7 8 0\n'
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,87 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestEmbeddingGradDedup(unittest.TestCase):
+    # More ids than kEmbeddingDedupMinIds, so that the hash deduplication of
+    # the ids is used.
+    def setUp(self):
+        np.random.seed(2024)
+        self.vocab_size = 250000
+        self.hidden_size = 64
+        self.ids_num = 16384
+        self.weight = np.random.random(
+            [self.vocab_size, self.hidden_size]
+        ).astype('float32')
+
+    def hot_ids(self):
+        hot = np.random.randint(0, self.vocab_size, [100])
+        return hot[np.random.randint(0, 100, [self.ids_num])].astype('int64')
+
+    def spread_ids(self):
+        return np.random.permutation(self.vocab_size)[: self.ids_num].astype(
+            'int64'
+        )
+
+    def run_embedding(self, ids, sparse):
+        weight = paddle.to_tensor(self.weight, stop_gradient=False)
+        out_grad = np.random.random([self.ids_num, self.hidden_size]).astype(
+            'float32'
+        )
+        out = paddle.nn.functional.embedding(
+            paddle.to_tensor(ids), weight, sparse=sparse
+        )
+        out.backward(paddle.to_tensor(out_grad))
+        expect = np.zeros_like(self.weight)
+        np.add.at(expect, ids, out_grad)
+        return weight.grad, expect
+
+    def check_dense(self, ids):
+        grad, expect = self.run_embedding(ids, sparse=False)
+        np.testing.assert_allclose(grad.numpy(), expect, rtol=1e-5, atol=1e-5)
+
+    def test_dense_hot_ids(self):
+        self.check_dense(self.hot_ids())
+
+    def test_dense_spread_ids(self):
+        self.check_dense(self.spread_ids())
+
+    def test_sparse_hot_ids(self):
+        ids = self.hot_ids()
+        grad, expect = self.run_embedding(ids, sparse=True)
+        selected_rows = grad.value().get_selected_rows()
+        rows = np.array(selected_rows.rows())
+        # A row for each unique id.
+        self.assertEqual(len(rows), len(np.unique(ids)))
+        np.testing.assert_equal(np.sort(rows), np.unique(ids))
+        np.testing.assert_allclose(
+            np.array(selected_rows.get_tensor()),
+            expect[rows],
+            rtol=1e-5,
+            atol=1e-5,
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
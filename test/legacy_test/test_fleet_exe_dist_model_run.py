@@ -93,6 +93,45 @@ class TestDistModelRun(unittest.TestCase):
             dist_model_rst, load_inference_model_rst, rtol=1e-05
         )
 
+    def test_dist_model_run_micro_batches(self):
+        path_prefix = os.path.join(
+            self.temp_dir.name, "dist_model_micro_batches_test/inf"
+        )
+
+        main_program = paddle.static.Program()
+        startup_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program, startup_program):
+            x = paddle.static.data(name='x', shape=[-1, 28], dtype='float32')
+            hidden = paddle.static.nn.fc(x, 16, activation='relu')
+            predict = paddle.static.nn.fc(hidden, 10, activation='softmax')
+        exe = paddle.static.Executor(paddle.CUDAPlace(0))
+        exe.run(startup_program)
+        paddle.static.save_inference_model(
+            path_prefix, [x], [predict], exe, program=main_program
+        )
+
+        x_tensor = np.random.randn(28, 28).astype('float32')
+
+        def run(num_micro_batches):
+            config = core.DistModelConfig()
+            config.model_dir = path_prefix
+            config.place = 'GPU'
+            config.num_micro_batches = num_micro_batches
+            dist = core.DistModel(config)
+            dist.init()
+            output_rst = dist.run([core.DistModelTensor(x_tensor, 'x')])
+            return output_rst[0].as_ndarray()
+
+        # the rows of the micro-batches are concatenated in order
+        full_batch_rst = run(1)
+        self.assertEqual(list(full_batch_rst.shape), [28, 10])
+        for num_micro_batches in [2, 4, 7]:
+            micro_batch_rst = run(num_micro_batches)
+            self.assertEqual(list(micro_batch_rst.shape), [28, 10])
+            np.testing.assert_allclose(
+                micro_batch_rst, full_batch_rst, rtol=1e-05
+            )
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,149 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from test_matmul_fp8_op import check_fp8_support
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn import DelayedScaling, FP8Linear, fp8_autocast
+from paddle.incubate.nn.functional import (
+    fp8_amax_and_scale_update,
+    fused_fp8_cast_transpose,
+)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or not check_fp8_support(),
+    "FP8 training requires CUDA >= 12.1 on Ada arch or hopper arch",
+)
+class TestFusedFP8CastTranspose(unittest.TestCase):
+    def setUp(self):
+        paddle.seed(2024)
+        self.x = paddle.randn([96, 48], dtype='float32').astype('bfloat16')
+
+    def test_cast_transpose(self):
+        scale = paddle.full([1], 4.0, dtype='float32')
+        amax_history = paddle.zeros([4], dtype='float32')
+        out, out_t = fused_fp8_cast_transpose(
+            self.x, scale, amax_history, 'float8_e4m3fn'
+        )
+        x = self.x.astype('float32')
+        expect = (x * 4.0).clip(-448.0, 448.0).astype('float8_e4m3fn')
+        np.testing.assert_equal(
+            out.astype('float32').numpy(), expect.astype('float32').numpy()
+        )
+        np.testing.assert_equal(
+            out_t.astype('float32').numpy(), out.astype('float32').numpy().T
+        )
+        np.testing.assert_allclose(
+            amax_history.numpy()[0], x.abs().max().numpy(), rtol=1e-6
+        )
+        np.testing.assert_equal(amax_history.numpy()[1:], 0.0)
+
+    def test_saturate_e5m2(self):
+        scale = paddle.full([1], 1e6, dtype='float32')
+        amax_history = paddle.zeros([4], dtype='float32')
+        out, out_t = fused_fp8_cast_transpose(
+            self.x, scale, amax_history, 'float8_e5m2', transpose=False
+        )
+        self.assertIsNone(out_t)
+        self.assertLessEqual(out.astype('float32').abs().max().item(), 57344.0)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or not check_fp8_support(),
+    "FP8 training requires CUDA >= 12.1 on Ada arch or hopper arch",
+)
+class TestFP8AmaxAndScaleUpdate(unittest.TestCase):
+    def test_max(self):
+        amax_history = paddle.to_tensor([2.0, 4.0, 1.0], dtype='float32')
+        scale = paddle.ones([1], dtype='float32')
+        scale_inv = fp8_amax_and_scale_update(
+            amax_history, scale, 448.0, margin=1.0
+        )
+        np.testing.assert_allclose(scale.numpy(), [56.0])
+        np.testing.assert_allclose(scale_inv.numpy(), [1.0 / 56.0])
+        np.testing.assert_equal(amax_history.numpy(), [0.0, 2.0, 4.0])
+
+    def test_most_recent(self):
+        amax_history = paddle.to_tensor([2.0, 4.0, 1.0], dtype='float32')
+        scale = paddle.ones([1], dtype='float32')
+        fp8_amax_and_scale_update(
+            amax_history, scale, 448.0, amax_compute_algo='most_recent'
+        )
+        np.testing.assert_allclose(scale.numpy(), [224.0])
+
+    def test_zero_amax(self):
+        amax_history = paddle.zeros([3], dtype='float32')
+        scale = paddle.full([1], 2.0, dtype='float32')
+        fp8_amax_and_scale_update(amax_history, scale, 448.0)
+        np.testing.assert_allclose(scale.numpy(), [2.0])
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or not check_fp8_support(),
+    "FP8 training requires CUDA >= 12.1 on Ada arch or hopper arch",
+)
+class TestFP8Linear(unittest.TestCase):
+    def setUp(self):
+        paddle.seed(2024)
+        self.x_shape = [4, 32, 128]
+        self.in_features = 128
+        self.out_features = 64
+        self.recipe = DelayedScaling(amax_history_len=8)
+
+    def run_linear(self, use_fp8, steps):
+        paddle.seed(2024)
+        linear = FP8Linear(self.in_features, self.out_features)
+        x = paddle.randn(self.x_shape, dtype='float32')
+        x.stop_gradient = False
+        for _ in range(steps):
+            with paddle.amp.auto_cast(dtype='bfloat16'):
+                with fp8_autocast(enabled=use_fp8, fp8_recipe=self.recipe):
+                    out = linear(x)
+            out.astype('float32').mean().backward()
+        return (
+            out.astype('float32').numpy(),
+            x.grad.numpy(),
+            linear.weight.grad.numpy(),
+            linear.bias.grad.numpy(),
+        )
+
+    def test_fp8_linear(self):
+        # The scales of the first step are 1, the delayed scales are used
+        # from the second step.
+        expects = self.run_linear(False, 3)
+        results = self.run_linear(True, 3)
+        for result, expect in zip(results, expects):
+            np.testing.assert_allclose(result, expect, rtol=0.1, atol=0.1)
+
+    def test_fallback(self):
+        linear = FP8Linear(24, 40)
+        x = paddle.randn([3, 24], dtype='float32')
+        with fp8_autocast():
+            out = linear(x)
+        self.assertIsNone(linear._fp8_state)
+        np.testing.assert_allclose(
+            out.numpy(),
+            (paddle.matmul(x, linear.weight) + linear.bias).numpy(),
+            rtol=1e-5,
+            atol=1e-5,
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
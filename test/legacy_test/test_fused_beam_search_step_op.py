@@ -0,0 +1,161 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn.functional import fused_beam_search_step
+
+
+def ref_beam_search_step(logits, beam_scores, finished, beam_size, end_id):
+    logits = logits.astype('float64')
+    rows, vocab_size = logits.shape
+    max_logits = logits.max(axis=-1, keepdims=True)
+    log_probs = (
+        logits
+        - max_logits
+        - np.log(np.exp(logits - max_logits).sum(axis=-1, keepdims=True))
+    )
+    scores = log_probs + beam_scores[:, None]
+    scores[finished] = -np.inf
+    scores[finished, end_id] = beam_scores[finished]
+
+    next_ids = np.zeros([rows], 'int64')
+    next_scores = np.zeros([rows], 'float32')
+    parent_idx = np.zeros([rows], 'int32')
+    for b in range(rows // beam_size):
+        batch_scores = scores[b * beam_size : (b + 1) * beam_size].reshape(-1)
+        top = np.argsort(-batch_scores, kind='stable')[:beam_size]
+        out = slice(b * beam_size, (b + 1) * beam_size)
+        next_ids[out] = top % vocab_size
+        next_scores[out] = batch_scores[top]
+        parent_idx[out] = b * beam_size + top // vocab_size
+    next_finished = finished[parent_idx] | (next_ids == end_id)
+    return next_ids, next_scores, parent_idx, next_finished
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedBeamSearchStep(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.disable_static()
+        self.batch_size = 3
+        self.beam_size = 4
+        self.vocab_size = 1000
+        self.end_id = 2
+        self.dtype = 'float32'
+        self.atol = 1e-5
+
+    def check(self, logits, beam_scores, finished):
+        outs = fused_beam_search_step(
+            paddle.to_tensor(logits).astype(self.dtype),
+            paddle.to_tensor(beam_scores),
+            paddle.to_tensor(finished),
+            self.beam_size,
+            self.end_id,
+        )
+        logits = paddle.to_tensor(logits).astype(self.dtype)
+        refs = ref_beam_search_step(
+            logits.astype('float32').numpy(),
+            beam_scores,
+            finished,
+            self.beam_size,
+            self.end_id,
+        )
+        next_ids, next_scores, parent_idx, next_finished = outs
+        np.testing.assert_array_equal(next_ids.numpy(), refs[0])
+        np.testing.assert_allclose(
+            next_scores.numpy(), refs[1], rtol=1e-5, atol=self.atol
+        )
+        np.testing.assert_array_equal(parent_idx.numpy(), refs[2])
+        np.testing.assert_array_equal(next_finished.numpy(), refs[3])
+
+    def random_inputs(self):
+        rows = self.batch_size * self.beam_size
+        logits = np.random.randn(rows, self.vocab_size).astype('float32')
+        beam_scores = -np.random.rand(rows).astype('float32') * 5
+        return logits, beam_scores
+
+    def test_step(self):
+        logits, beam_scores = self.random_inputs()
+        finished = np.zeros([len(beam_scores)], 'bool')
+        self.check(logits, beam_scores, finished)
+
+    def test_first_step(self):
+        logits, _ = self.random_inputs()
+        beam_scores = np.full([len(logits)], -np.inf, 'float32')
+        beam_scores[:: self.beam_size] = 0
+        finished = np.zeros([len(beam_scores)], 'bool')
+        self.check(logits, beam_scores, finished)
+
+    def test_finished_beams(self):
+        logits, beam_scores = self.random_inputs()
+        finished = np.random.rand(len(beam_scores)) < 0.5
+        # a finished beam with the best score survives unchanged
+        beam_scores[0] = 0.0
+        finished[0] = True
+        self.check(logits, beam_scores, finished)
+
+    def test_decode_loop(self):
+        # the states of a step feed the next one without leaving the device
+        rows = self.batch_size * self.beam_size
+        beam_scores = np.full([rows], -np.inf, 'float32')
+        beam_scores[:: self.beam_size] = 0
+        scores = paddle.to_tensor(beam_scores)
+        finished = paddle.zeros([rows], dtype='bool')
+        cache = paddle.arange(rows, dtype='int32')
+        ref_scores, ref_finished = beam_scores, np.zeros([rows], 'bool')
+        ref_cache = np.arange(rows, dtype='int32')
+        for _ in range(4):
+            logits = np.random.randn(rows, self.vocab_size).astype('float32')
+            _, scores, parent_idx, finished = fused_beam_search_step(
+                paddle.to_tensor(logits),
+                scores,
+                finished,
+                self.beam_size,
+                self.end_id,
+            )
+            cache = paddle.gather(cache, parent_idx)
+            _, ref_scores, ref_parent, ref_finished = ref_beam_search_step(
+                logits, ref_scores, ref_finished, self.beam_size, self.end_id
+            )
+            ref_cache = ref_cache[ref_parent]
+        np.testing.assert_allclose(scores.numpy(), ref_scores, rtol=1e-5)
+        np.testing.assert_array_equal(cache.numpy(), ref_cache)
+
+    def test_beam_size_too_large(self):
+        self.beam_size = 17
+        logits, beam_scores = self.random_inputs()
+        finished = np.zeros([len(beam_scores)], 'bool')
+        with self.assertRaises(ValueError):
+            self.check(logits, beam_scores, finished)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedBeamSearchStepFP16(TestFusedBeamSearchStep):
+    def setUp(self):
+        super().setUp()
+        self.dtype = 'float16'
+        self.atol = 1e-3
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,107 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.nn.functional as F
+from paddle.base import core
+from paddle.incubate.nn.functional import fused_elementwise_chain
+
+
+def ref_chain(xs, ops, scales):
+    out = xs[0]
+    inputs = iter(xs[1:])
+    scales = iter(scales)
+    binary = {
+        'add': paddle.add,
+        'subtract': paddle.subtract,
+        'multiply': paddle.multiply,
+        'divide': paddle.divide,
+        'maximum': paddle.maximum,
+        'minimum': paddle.minimum,
+    }
+    unary = {
+        'relu': F.relu,
+        'gelu': F.gelu,
+        'silu': F.silu,
+        'sigmoid': F.sigmoid,
+        'tanh': paddle.tanh,
+    }
+    for op in ops:
+        if op in binary:
+            out = binary[op](out, next(inputs))
+        elif op == 'scale':
+            out = out * next(scales)
+        else:
+            out = unary[op](out)
+    return out
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedElementwiseChain(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.disable_static()
+
+    def check(self, shapes, ops, scales=(), dtype='float32', rtol=1e-5):
+        xs = [
+            paddle.to_tensor(np.random.uniform(0.5, 2, s).astype('float32'))
+            for s in shapes
+        ]
+        xs = [x.astype(dtype) for x in xs]
+        out = fused_elementwise_chain(xs, ops, scales)
+        expect = ref_chain(
+            [x.astype('float32') for x in xs], ops, list(scales)
+        )
+        self.assertEqual(out.shape, expect.shape)
+        np.testing.assert_allclose(
+            out.astype('float32').numpy(), expect.numpy(), rtol=rtol, atol=rtol
+        )
+
+    def test_bias_mul_gelu_scale(self):
+        self.check(
+            [[8, 1024], [1024], [8, 1024]],
+            ['add', 'multiply', 'gelu', 'scale'],
+            [0.5],
+        )
+
+    def test_unary_only(self):
+        self.check([[3, 5, 7]], ['scale', 'silu', 'tanh', 'relu'], [-1.5])
+
+    def test_broadcast_four_inputs(self):
+        self.check(
+            [[4, 1, 6], [1, 5, 1], [6], [4, 5, 6]],
+            ['subtract', 'maximum', 'sigmoid', 'divide'],
+        )
+
+    def test_float16(self):
+        self.check(
+            [[16, 256], [256]], ['add', 'gelu'], dtype='float16', rtol=1e-2
+        )
+
+    def test_invalid_op_number(self):
+        x = paddle.ones([2, 3])
+        with self.assertRaises(ValueError):
+            fused_elementwise_chain([x, x], ['add', 'softmax'])
+        with self.assertRaises(ValueError):
+            fused_elementwise_chain([x], ['add'])
+
+
+if __name__ == '__main__':
+    unittest.main()
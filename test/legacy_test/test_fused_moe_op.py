@@ -202,5 +202,133 @@ class TestFusedMoEOpBf16(TestFusedMoEOp):
         self.atol = 1e-2
 
 
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda()
+    or get_cuda_version() < 11030
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "FusedMoe requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class TestFusedMoEGrad(unittest.TestCase):
+    def setUp(self):
+        self.config()
+        paddle.disable_static(place=paddle.CUDAPlace(0))
+        # the top-k routing of close gate scores may differ between the fp16
+        # and the fp32 runs, fix the inputs so that the test is reproducible
+        np.random.seed(2024)
+        num_rows = self.batch_size * self.seq_len
+        self.inputs = {
+            'x': np.random.randn(num_rows, self.d_model) * 0.5,
+            'gate_weight': np.random.randn(self.d_model, self.num_expert),
+            'ffn1_weight': np.random.randn(
+                self.num_expert, self.d_model, self.d_feedforward * 2
+            )
+            * 0.1,
+            'ffn1_bias': np.random.randn(
+                self.num_expert, 1, self.d_feedforward * 2
+            )
+            * 0.1,
+            'ffn2_weight': np.random.randn(
+                self.num_expert, self.d_feedforward, self.d_model
+            )
+            * 0.1,
+            'ffn2_bias': np.random.randn(self.num_expert, 1, self.d_model)
+            * 0.1,
+        }
+        self.out_grad = np.random.randn(num_rows, self.d_model)
+
+    def config(self):
+        self.x_type = 'float16'
+        self.batch_size = 2
+        self.seq_len = 32
+        self.num_expert = 8
+        self.d_model = 128
+        self.d_feedforward = 256
+        self.top_k = 2
+
+    def to_tensors(self, dtype):
+        tensors = {}
+        for name, value in self.inputs.items():
+            tensor_dtype = 'float32' if name == 'gate_weight' else dtype
+            tensors[name] = paddle.to_tensor(
+                value, dtype=tensor_dtype, stop_gradient=False
+            )
+        return tensors
+
+    def GetBaselineOut(self, x, gate_weight, w0, b0, w1, b1):
+        router_logits = paddle.matmul(x, gate_weight)
+        routing_weights = F.softmax(router_logits, axis=-1)
+        routing_weights, selected_experts = paddle.topk(
+            routing_weights, self.top_k, axis=-1
+        )
+        routing_weights /= paddle.sum(routing_weights, axis=-1, keepdim=True)
+        expert_mask = paddle.transpose(
+            F.one_hot(selected_experts, num_classes=self.num_expert), [2, 1, 0]
+        )
+        out = paddle.zeros_like(x)
+        for expert_idx in range(self.num_expert):
+            idx, top_x = paddle.where(expert_mask[expert_idx])
+            if top_x.shape[0] == 0:
+                continue
+            top_x = top_x.squeeze(-1)
+            idx = idx.squeeze(-1)
+            state = paddle.index_select(x, top_x, axis=0)
+            state = paddle.matmul(state, w0[expert_idx]) + b0[expert_idx]
+            state = swiglu(state)
+            state = paddle.matmul(state, w1[expert_idx]) + b1[expert_idx]
+            weight = routing_weights[top_x, idx].unsqueeze(-1)
+            out = paddle.index_add(out, top_x, 0, state * weight)
+        return out
+
+    def test_fused_moe_grad(self):
+        names = list(self.inputs.keys())
+        ref = self.to_tensors('float32')
+        ref_out = self.GetBaselineOut(*[ref[name] for name in names])
+        ref_grads = paddle.grad(
+            ref_out,
+            [ref[name] for name in names],
+            paddle.to_tensor(self.out_grad, dtype='float32'),
+        )
+
+        fused = self.to_tensors(self.x_type)
+        fused_out = fused_moe(
+            fused['x'],
+            fused['gate_weight'],
+            fused['ffn1_weight'],
+            fused['ffn1_bias'],
+            fused['ffn2_weight'],
+            fused['ffn2_bias'],
+            None,
+            None,
+            "None",
+            self.top_k,
+        )
+        fused_grads = paddle.grad(
+            fused_out,
+            [fused[name] for name in names],
+            paddle.to_tensor(self.out_grad, dtype=self.x_type),
+        )
+
+        np.testing.assert_allclose(
+            ref_out.numpy(),
+            fused_out.cast('float32').numpy(),
+            rtol=1e-2,
+            atol=1e-2,
+        )
+        for name, ref_grad, fused_grad in zip(names, ref_grads, fused_grads):
+            np.testing.assert_allclose(
+                ref_grad.numpy(),
+                fused_grad.cast('float32').numpy(),
+                rtol=5e-2,
+                atol=5e-2,
+                err_msg=f'The grad of {name} is wrong.',
+            )
+
+
+class TestFusedMoEGradBf16(TestFusedMoEGrad):
+    def config(self):
+        super().config()
+        self.x_type = 'bfloat16'
+
+
 if __name__ == "__main__":
     unittest.main()
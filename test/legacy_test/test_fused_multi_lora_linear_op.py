@@ -0,0 +1,106 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn.functional import fused_multi_lora_linear
+
+
+def ref_multi_lora(x, lora_a, lora_b, seg_offsets, adapter_ids, base, scaling):
+    out = np.zeros([x.shape[0], lora_b.shape[2]], 'float32')
+    if base is not None:
+        out += base
+    for s, adapter in enumerate(adapter_ids):
+        if adapter < 0:
+            continue
+        rows = slice(seg_offsets[s], seg_offsets[s + 1])
+        out[rows] += scaling * (x[rows] @ lora_a[adapter].T) @ lora_b[adapter]
+    return out
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedMultiLoraLinear(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.disable_static()
+
+    def check(
+        self,
+        m,
+        k,
+        n,
+        rank,
+        seg_offsets,
+        adapter_ids,
+        adapter_num=4,
+        with_base=True,
+        dtype='float32',
+        rtol=1e-4,
+    ):
+        x = np.random.uniform(-1, 1, [m, k]).astype('float32')
+        lora_a = np.random.uniform(-1, 1, [adapter_num, rank, k]).astype(
+            'float32'
+        )
+        lora_b = np.random.uniform(-1, 1, [adapter_num, rank, n]).astype(
+            'float32'
+        )
+        base = (
+            np.random.uniform(-1, 1, [m, n]).astype('float32')
+            if with_base
+            else None
+        )
+        out = fused_multi_lora_linear(
+            paddle.to_tensor(x).astype(dtype),
+            paddle.to_tensor(lora_a).astype(dtype),
+            paddle.to_tensor(lora_b).astype(dtype),
+            paddle.to_tensor(seg_offsets, dtype='int32'),
+            paddle.to_tensor(adapter_ids, dtype='int32'),
+            paddle.to_tensor(base).astype(dtype) if with_base else None,
+            0.5,
+        )
+        expect = ref_multi_lora(
+            x, lora_a, lora_b, seg_offsets, adapter_ids, base, 0.5
+        )
+        self.assertEqual(out.shape, [m, n])
+        np.testing.assert_allclose(
+            out.astype('float32').numpy(), expect, rtol=rtol, atol=rtol
+        )
+
+    def test_segments(self):
+        self.check(10, 256, 128, 16, [0, 3, 4, 10], [2, 0, 3])
+
+    def test_decode_rows(self):
+        # a segment per row, as in decoding
+        self.check(5, 64, 96, 8, [0, 1, 2, 3, 4, 5], [1, 1, 3, 0, 2])
+
+    def test_unaligned_and_uncovered_rows(self):
+        # a negative adapter and the rows after the last segment take none
+        self.check(
+            7, 30, 17, 4, [0, 2, 5], [-1, 1], with_base=False, rtol=1e-4
+        )
+
+    def test_float16(self):
+        self.check(
+            12, 512, 256, 16, [0, 6, 12], [3, 1], dtype='float16', rtol=5e-2
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
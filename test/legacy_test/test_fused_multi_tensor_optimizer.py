@@ -0,0 +1,284 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle import _C_ops
+from paddle.base import core
+
+SHAPES = [[2, 3], [1000], [257, 129], [1], [70000]]
+
+
+def random_tensors(dtype='float32'):
+    return [
+        paddle.to_tensor(np.random.uniform(-1, 1, shape).astype(dtype))
+        for shape in SHAPES
+    ]
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedMomentum(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(10)
+        self.lr = paddle.to_tensor([0.1], dtype='float32')
+        self.mu = 0.9
+
+    def run_fused(self, params, grads, velocitys, skip_update=None, **attrs):
+        _C_ops.fused_momentum_(
+            params,
+            grads,
+            velocitys,
+            self.lr,
+            None,
+            skip_update,
+            self.mu,
+            attrs.get('use_nesterov', False),
+            attrs.get('regularization_method', ''),
+            attrs.get('regularization_coeff', 0.0),
+            False,
+            1.0,
+        )
+
+    def check(self, **attrs):
+        params = random_tensors()
+        grads = random_tensors()
+        velocitys = random_tensors()
+        ref_params = [p.clone() for p in params]
+        ref_velocitys = [v.clone() for v in velocitys]
+        self.run_fused(params, grads, velocitys, **attrs)
+        for p, g, v, fp, fv in zip(
+            ref_params, grads, ref_velocitys, params, velocitys
+        ):
+            _C_ops.momentum_(
+                p,
+                g,
+                v,
+                self.lr,
+                None,
+                self.mu,
+                attrs.get('use_nesterov', False),
+                attrs.get('regularization_method', ''),
+                attrs.get('regularization_coeff', 0.0),
+                False,
+                1.0,
+            )
+            np.testing.assert_allclose(fp.numpy(), p.numpy(), rtol=1e-6)
+            np.testing.assert_allclose(fv.numpy(), v.numpy(), rtol=1e-6)
+
+    def test_momentum(self):
+        self.check()
+
+    def test_nesterov_l2_decay(self):
+        self.check(
+            use_nesterov=True,
+            regularization_method='l2_decay',
+            regularization_coeff=1e-4,
+        )
+
+    def test_skip_update(self):
+        params = random_tensors()
+        velocitys = random_tensors()
+        expects = [p.numpy() for p in params]
+        skip_update = paddle.to_tensor([True])
+        self.run_fused(params, random_tensors(), velocitys, skip_update)
+        for p, expect in zip(params, expects):
+            np.testing.assert_equal(p.numpy(), expect)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedLamb(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(10)
+        self.lr = paddle.to_tensor([0.01], dtype='float32')
+        self.weight_decay = 0.01
+
+    def new_pows(self):
+        return [
+            paddle.to_tensor([0.9], dtype='float32') for _ in SHAPES
+        ], [paddle.to_tensor([0.999], dtype='float32') for _ in SHAPES]
+
+    def test_lamb(self):
+        params = random_tensors()
+        grads = random_tensors()
+        moments1 = [paddle.zeros_like(p) for p in params]
+        moments2 = [paddle.zeros_like(p) for p in params]
+        beta1_pows, beta2_pows = self.new_pows()
+        ref_params = [p.clone() for p in params]
+        ref_moments1 = [m.clone() for m in moments1]
+        ref_moments2 = [m.clone() for m in moments2]
+        ref_beta1_pows, ref_beta2_pows = self.new_pows()
+
+        _C_ops.fused_lamb_(
+            params,
+            grads,
+            self.lr,
+            moments1,
+            moments2,
+            beta1_pows,
+            beta2_pows,
+            None,
+            None,
+            self.weight_decay,
+            0.9,
+            0.999,
+            1e-6,
+            False,
+            False,
+        )
+        for i in range(len(SHAPES)):
+            _C_ops.lamb_(
+                ref_params[i],
+                grads[i],
+                self.lr,
+                ref_moments1[i],
+                ref_moments2[i],
+                ref_beta1_pows[i],
+                ref_beta2_pows[i],
+                None,
+                None,
+                self.weight_decay,
+                0.9,
+                0.999,
+                1e-6,
+                False,
+                False,
+            )
+            np.testing.assert_allclose(
+                params[i].numpy(), ref_params[i].numpy(), rtol=1e-5, atol=1e-7
+            )
+            np.testing.assert_allclose(
+                moments2[i].numpy(), ref_moments2[i].numpy(), rtol=1e-5
+            )
+            np.testing.assert_allclose(
+                beta1_pows[i].numpy(), ref_beta1_pows[i].numpy(), rtol=1e-6
+            )
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedClipByGlobalNorm(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(10)
+        self.clip_norm = 1.0
+
+    def test_clip(self):
+        grads = random_tensors()
+        expect_norm = np.sqrt(sum((g.numpy() ** 2).sum() for g in grads))
+        expects = [
+            g.numpy() * self.clip_norm / max(expect_norm, self.clip_norm)
+            for g in grads
+        ]
+        _, found_inf, global_norm = _C_ops.fused_clip_by_global_norm_(
+            grads, None, self.clip_norm
+        )
+        self.assertFalse(found_inf.item())
+        np.testing.assert_allclose(global_norm.item(), expect_norm, rtol=1e-5)
+        for g, expect in zip(grads, expects):
+            np.testing.assert_allclose(g.numpy(), expect, rtol=1e-5)
+
+    def test_unscale_and_found_inf(self):
+        grads = random_tensors()
+        scale = paddle.to_tensor([1024.0], dtype='float32')
+        expects = [g.numpy() / 1024.0 for g in grads]
+        _, found_inf, _ = _C_ops.fused_clip_by_global_norm_(
+            grads, scale, 1e6
+        )
+        self.assertFalse(found_inf.item())
+        for g, expect in zip(grads, expects):
+            np.testing.assert_allclose(g.numpy(), expect, rtol=1e-6)
+
+        grads = random_tensors()
+        grads[2][0, 0] = float('inf')
+        _, found_inf, _ = _C_ops.fused_clip_by_global_norm_(
+            grads, scale, self.clip_norm
+        )
+        self.assertTrue(found_inf.item())
+
+    def test_clip_api(self):
+        paddle.seed(10)
+        linear = paddle.nn.Linear(64, 32)
+        out = linear(paddle.randn([8, 64]) * 100)
+        out.sum().backward()
+        params_grads = [(p, p.grad.clone()) for p in linear.parameters()]
+        expects = paddle.nn.ClipGradByGlobalNorm(
+            1.0, auto_skip_clip=True
+        )._dygraph_clip(params_grads)
+        grads = [g.clone() for _, g in params_grads]
+        results = paddle.nn.ClipGradByGlobalNorm(
+            1.0, inplace=True
+        )._dygraph_clip([(p, g) for (p, _), g in zip(params_grads, grads)])
+        for (_, result), (_, expect), grad in zip(results, expects, grads):
+            np.testing.assert_allclose(
+                result.numpy(), expect.numpy(), rtol=1e-5
+            )
+            # the gradients are clipped in place
+            np.testing.assert_allclose(grad.numpy(), expect.numpy(), rtol=1e-5)
+
+    def test_clip_api_not_inplace(self):
+        paddle.seed(10)
+        linear = paddle.nn.Linear(64, 32)
+        out = linear(paddle.randn([8, 64]) * 100)
+        out.sum().backward()
+        params_grads = [(p, p.grad) for p in linear.parameters()]
+        originals = [g.numpy() for _, g in params_grads]
+        results = paddle.nn.ClipGradByGlobalNorm(1.0)._dygraph_clip(
+            params_grads
+        )
+        # by default the clipped gradients are new tensors
+        for (_, result), (_, grad), original in zip(
+            results, params_grads, originals
+        ):
+            self.assertIsNot(result, grad)
+            np.testing.assert_array_equal(grad.numpy(), original)
+            self.assertLess(
+                np.abs(result.numpy()).max(), np.abs(original).max()
+            )
+
+    def run_grad_scaler(self, grad_clip):
+        paddle.seed(10)
+        linear = paddle.nn.Linear(64, 32)
+        optimizer = paddle.optimizer.SGD(
+            learning_rate=0.1,
+            parameters=linear.parameters(),
+            grad_clip=grad_clip,
+        )
+        scaler = paddle.amp.GradScaler(init_loss_scaling=1024)
+        for _ in range(2):
+            out = linear(paddle.randn([8, 64]) * 100)
+            scaler.scale(out.sum()).backward()
+            scaler.step(optimizer)
+            scaler.update()
+            optimizer.clear_grad()
+        return [p.numpy() for p in linear.parameters()]
+
+    def test_grad_scaler(self):
+        # GradScaler unscales and clips with the fused op in place, without
+        # inplace it takes the unfused path
+        results = self.run_grad_scaler(
+            paddle.nn.ClipGradByGlobalNorm(1.0, inplace=True)
+        )
+        expects = self.run_grad_scaler(paddle.nn.ClipGradByGlobalNorm(1.0))
+        for result, expect in zip(results, expects):
+            np.testing.assert_allclose(result, expect, rtol=1e-5)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,236 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn.functional import fused_qkv_rope_cache
+
+
+def ref_rope(x, pos, sin, cos, neox, base):
+    # x: [num_head, head_dim], the rotation of fused_rotary_position_embedding
+    head_dim = x.shape[-1]
+    if sin is None:
+        exponent = (np.arange(head_dim) // 2 * 2) / head_dim
+        theta = pos / np.power(base, exponent)
+        sin_pos, cos_pos = np.sin(theta), np.cos(theta)
+    else:
+        sin_pos, cos_pos = sin[pos], cos[pos]
+    if neox:
+        half = head_dim // 2
+        rotated = np.concatenate([-x[:, half:], x[:, :half]], axis=-1)
+    else:
+        rotated = np.stack([-x[:, 1::2], x[:, 0::2]], axis=-1).reshape(x.shape)
+    return x * cos_pos + rotated * sin_pos
+
+
+def ref_qkv_rope_cache(
+    qkv,
+    key_cache,
+    value_cache,
+    position_ids,
+    block_tables,
+    q_num_head,
+    kv_num_head,
+    qkv_bias,
+    sin,
+    cos,
+    k_scales,
+    v_scales,
+    neox,
+    base,
+):
+    bsz = qkv.shape[0]
+    head_dim = qkv.shape[1] // (q_num_head + 2 * kv_num_head)
+    block_size = key_cache.shape[2]
+    qkv = qkv.astype('float64')
+    if qkv_bias is not None:
+        qkv = qkv + qkv_bias
+    qkv = qkv.reshape([bsz, -1, head_dim])
+    q_out = np.zeros([bsz, q_num_head, head_dim])
+    key_cache, value_cache = key_cache.copy(), value_cache.copy()
+    for b in range(bsz):
+        pos = position_ids[b]
+        if pos < 0:
+            continue
+        q = ref_rope(qkv[b, :q_num_head], pos, sin, cos, neox, base)
+        k = ref_rope(
+            qkv[b, q_num_head : q_num_head + kv_num_head],
+            pos,
+            sin,
+            cos,
+            neox,
+            base,
+        )
+        v = qkv[b, q_num_head + kv_num_head :]
+        if k_scales is not None:
+            k = np.clip(np.round(k * k_scales[:, None]), -127, 127) + 128
+            v = np.clip(np.round(v * v_scales[:, None]), -127, 127) + 128
+        q_out[b] = q
+        block = block_tables[b, pos // block_size]
+        key_cache[block, :, pos % block_size] = k
+        value_cache[block, :, pos % block_size] = v
+    return q_out, key_cache, value_cache
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedQkvRopeCache(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.disable_static()
+        self.bsz = 3
+        self.q_num_head = 4
+        self.kv_num_head = 2
+        self.head_dim = 16
+        self.block_size = 4
+        self.max_blocks_per_seq = 3
+        self.max_seq_len = self.block_size * self.max_blocks_per_seq
+        self.dtype = 'float32'
+        self.atol = 1e-5
+        self.neox = True
+        self.with_bias = True
+        self.with_sin_cos = False
+        self.quant = False
+        self.base = 10000.0
+
+    def run_check(self):
+        num_head = self.q_num_head + 2 * self.kv_num_head
+        qkv = np.random.randn(self.bsz, num_head * self.head_dim)
+        qkv = qkv.astype(self.dtype)
+        bias = (
+            np.random.randn(num_head * self.head_dim).astype(self.dtype)
+            if self.with_bias
+            else None
+        )
+        sin = cos = None
+        if self.with_sin_cos:
+            theta = np.random.rand(self.max_seq_len, self.head_dim) * 6
+            sin = np.sin(theta).astype(self.dtype)
+            cos = np.cos(theta).astype(self.dtype)
+        # the last sequence is stopped
+        position_ids = np.array([5, 0, -1], 'int64')
+        block_tables = np.random.permutation(
+            self.bsz * self.max_blocks_per_seq
+        ).reshape([self.bsz, self.max_blocks_per_seq])
+        block_tables = block_tables.astype('int32')
+        cache_shape = [
+            self.bsz * self.max_blocks_per_seq,
+            self.kv_num_head,
+            self.block_size,
+            self.head_dim,
+        ]
+        k_scales = v_scales = None
+        if self.quant:
+            key_cache = np.random.randint(0, 256, cache_shape).astype('uint8')
+            value_cache = np.random.randint(0, 256, cache_shape)
+            value_cache = value_cache.astype('uint8')
+            k_scales = np.random.rand(self.kv_num_head).astype('float32') * 20
+            v_scales = np.random.rand(self.kv_num_head).astype('float32') * 20
+        else:
+            key_cache = np.random.randn(*cache_shape).astype(self.dtype)
+            value_cache = np.random.randn(*cache_shape).astype(self.dtype)
+
+        def to_tensor(x):
+            return None if x is None else paddle.to_tensor(x)
+
+        key_cache_t = paddle.to_tensor(key_cache)
+        value_cache_t = paddle.to_tensor(value_cache)
+        q_out = fused_qkv_rope_cache(
+            paddle.to_tensor(qkv),
+            key_cache_t,
+            value_cache_t,
+            paddle.to_tensor(position_ids),
+            paddle.to_tensor(block_tables),
+            self.q_num_head,
+            self.kv_num_head,
+            qkv_bias=to_tensor(bias),
+            sin=to_tensor(sin),
+            cos=to_tensor(cos),
+            cache_k_quant_scales=to_tensor(k_scales),
+            cache_v_quant_scales=to_tensor(v_scales),
+            use_neox_rotary_style=self.neox,
+            rotary_emb_base=self.base,
+        )
+        ref_q, ref_key_cache, ref_value_cache = ref_qkv_rope_cache(
+            qkv,
+            key_cache,
+            value_cache,
+            position_ids,
+            block_tables,
+            self.q_num_head,
+            self.kv_num_head,
+            bias,
+            sin,
+            cos,
+            k_scales,
+            v_scales,
+            self.neox,
+            self.base,
+        )
+        np.testing.assert_allclose(
+            q_out.astype('float32').numpy(), ref_q, rtol=1e-3, atol=self.atol
+        )
+        # the rounding of the quantization may differ by one
+        cache_atol = 1 if self.quant else self.atol
+        np.testing.assert_allclose(
+            key_cache_t.astype('float32').numpy(),
+            ref_key_cache,
+            rtol=1e-3,
+            atol=cache_atol,
+        )
+        np.testing.assert_allclose(
+            value_cache_t.astype('float32').numpy(),
+            ref_value_cache,
+            rtol=1e-3,
+            atol=cache_atol,
+        )
+
+    def test_neox(self):
+        self.run_check()
+
+    def test_rotate_every_two(self):
+        self.neox = False
+        self.run_check()
+
+    def test_sin_cos(self):
+        self.with_sin_cos = True
+        self.run_check()
+
+    def test_no_bias(self):
+        self.with_bias = False
+        self.base = 500000.0
+        self.run_check()
+
+    def test_int8_cache(self):
+        self.quant = True
+        self.run_check()
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedQkvRopeCacheFP16(TestFusedQkvRopeCache):
+    def setUp(self):
+        super().setUp()
+        self.dtype = 'float16'
+        self.atol = 1e-2
+
+
+if __name__ == '__main__':
+    unittest.main()
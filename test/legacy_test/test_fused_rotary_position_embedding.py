@@ -689,5 +689,61 @@ class TestFusedRotaryPositionEmbedding(unittest.TestCase):
         self.assertRaises(AssertionError, test_error2)
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() and not paddle.is_compiled_with_rocm(),
+    "core is not compiled with CUDA or ROCM ",
+)
+class TestFusedRotaryPositionEmbeddingPacked(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.seed(1203)
+        self.seq_lens = [3, 8, 5]
+        self.num_heads = 2
+        self.head_dim = 16
+        self.cu_seqlens = paddle.to_tensor(
+            np.cumsum([0, *self.seq_lens]), dtype='int32'
+        )
+
+    def check(self, with_sin_cos):
+        total_tokens = sum(self.seq_lens)
+        shape = [1, total_tokens, self.num_heads, self.head_dim]
+        q = paddle.randn(shape, 'float32')
+        k = paddle.randn(shape, 'float32')
+        sin, cos = (
+            get_sin_cos_tensor(max(self.seq_lens), self.head_dim)
+            if with_sin_cos
+            else (None, None)
+        )
+        out_q, out_k, _ = fused_rotary_position_embedding(
+            q, k, sin=sin, cos=cos, cu_seqlens=self.cu_seqlens
+        )
+
+        # the reference runs each sequence on its own
+        begin = 0
+        for seq_len in self.seq_lens:
+            end = begin + seq_len
+            seq_sin, seq_cos = (
+                (sin[:, :seq_len], cos[:, :seq_len])
+                if with_sin_cos
+                else (None, None)
+            )
+            ref_q, ref_k, _ = fused_rotary_position_embedding(
+                q[:, begin:end], k[:, begin:end], sin=seq_sin, cos=seq_cos
+            )
+            np.testing.assert_allclose(
+                out_q[:, begin:end].numpy(), ref_q.numpy(), rtol=1e-5, atol=1e-6
+            )
+            np.testing.assert_allclose(
+                out_k[:, begin:end].numpy(), ref_k.numpy(), rtol=1e-5, atol=1e-6
+            )
+            begin = end
+
+    def test_packed(self):
+        self.check(with_sin_cos=False)
+
+    def test_packed_with_sin_cos(self):
+        self.check(with_sin_cos=True)
+
+
 if __name__ == "__main__":
     unittest.main()
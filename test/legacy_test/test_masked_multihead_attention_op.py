@@ -26,8 +26,7 @@ from paddle.pir_utils import test_with_pir_api
     not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
 )
 class TestMMHAOp(unittest.TestCase):
-    def setUp(self):
-        np.random.seed(0)
+    def init_shape(self):
         self.bsz = 2
         self.cache_bsz = 2
         self.num_head = 32
@@ -36,6 +35,10 @@ class TestMMHAOp(unittest.TestCase):
         self.max_seq_len = 33
         self.sequence_length = 32
 
+    def setUp(self):
+        np.random.seed(0)
+        self.init_shape()
+
         self.x = np.random.uniform(
             -0.05, 0.05, [self.bsz, 3, self.num_head, self.dim_head]
         )
@@ -281,6 +284,107 @@ class TestMMHAOp(unittest.TestCase):
         )
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestMMHAOpSplitSeq(TestMMHAOp):
+    # a long sequence of a single batch is split across thread blocks
+    def init_shape(self):
+        self.bsz = 1
+        self.cache_bsz = 1
+        self.num_head = 8
+        self.dim_head = 64
+        self.beam_size = 1
+        self.max_seq_len = 4097
+        self.sequence_length = 4096
+
+    def test_mmha_split_seq(self):
+        outs = []
+        for split_seq in [0, 1]:
+            paddle.set_flags({'FLAGS_mmha_split_seq': split_seq})
+            _, paddle_mmha_out = self.check_main(
+                self.x,
+                self.cache_kv_out,
+                self.cache_kv_mmha_out,
+                self.bias,
+                self.src_mask,
+                None,
+                -1,
+                'float16',
+            )
+            outs.append(paddle_mmha_out[0].numpy())
+        paddle.set_flags({'FLAGS_mmha_split_seq': -1})
+        np.testing.assert_allclose(outs[0], outs[1], rtol=1e-3, atol=1e-3)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestMMHAOpInt8Cache(TestMMHAOp):
+    # the cache is stored in uint8, round(scale * x) + 128 with per head scales
+    def quant_cache(self, cache_kv):
+        abs_max = np.abs(cache_kv).max(axis=(1, 3, 4))
+        quant_scales = self.quant_max_bound / abs_max
+        dequant_scales = 1.0 / quant_scales
+        quant = np.clip(
+            np.round(cache_kv * quant_scales[:, None, :, None, None]),
+            self.quant_min_bound,
+            self.quant_max_bound,
+        )
+        dequant = quant * dequant_scales[:, None, :, None, None]
+        return (
+            (quant + 128).astype("uint8"),
+            dequant,
+            quant_scales.astype("float32"),
+            dequant_scales.astype("float32"),
+        )
+
+    def test_mmha_int8_cache(self):
+        cache_kv_int8, cache_kv_dequant, quant_scales, dequant_scales = (
+            self.quant_cache(self.cache_kv_mmha_out)
+        )
+        paddle.disable_static()
+        x = paddle.to_tensor(self.x).cast("float16")
+        bias = paddle.to_tensor(self.bias).cast("float16")
+        src_mask = paddle.to_tensor(self.src_mask).cast("float16")
+        paddle_naive_mmha_out, _ = self.mmha_naive(
+            x,
+            paddle.to_tensor(
+                cache_kv_dequant[:, :, :, : self.sequence_length]
+            ).cast("float16"),
+            bias,
+            src_mask,
+            None,
+            self.seq_len,
+            -1,
+            self.quant_round_type,
+            self.quant_max_bound,
+            self.quant_min_bound,
+            self.bsz,
+        )
+        paddle_mmha_out = masked_multihead_attention(
+            x.reshape([self.bsz, -1]),
+            paddle.to_tensor(cache_kv_int8),
+            bias,
+            src_mask,
+            seq_len=self.seq_len,
+            quant_round_type=self.quant_round_type,
+            quant_max_bound=self.quant_max_bound,
+            quant_min_bound=self.quant_min_bound,
+            cache_k_quant_scales=paddle.to_tensor(quant_scales[0]),
+            cache_v_quant_scales=paddle.to_tensor(quant_scales[1]),
+            cache_k_dequant_scales=paddle.to_tensor(dequant_scales[0]),
+            cache_v_dequant_scales=paddle.to_tensor(dequant_scales[1]),
+        )
+        paddle.enable_static()
+        np.testing.assert_allclose(
+            paddle_mmha_out[0].numpy(),
+            paddle_naive_mmha_out.numpy(),
+            rtol=1e-3,
+            atol=1e-3,
+        )
+
+
 @unittest.skipIf(
     not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
 )
@@ -335,5 +335,60 @@ class TestCheckNumericsAPI(TestNanInfBase):
         paddle.disable_static()
 
 
+@unittest.skipIf(
+    not paddle.base.core.is_compiled_with_cuda(),
+    "FLAGS_check_nan_inf_async only checks gpu outputs",
+)
+class TestNanInfAsync(unittest.TestCase):
+    def setUp(self):
+        paddle.enable_static()
+        paddle.set_flags(
+            {
+                "FLAGS_check_nan_inf": 1,
+                "FLAGS_check_nan_inf_async": 1,
+                "FLAGS_check_nan_inf_level": 0,
+            }
+        )
+
+    def tearDown(self):
+        paddle.set_flags(
+            {"FLAGS_check_nan_inf": 0, "FLAGS_check_nan_inf_async": 0}
+        )
+        paddle.disable_static()
+
+    def test_report_at_next_step(self):
+        with paddle.pir_utils.IrGuard():
+            main_program = paddle.static.Program()
+            startup_program = paddle.static.Program()
+            with paddle.static.program_guard(main_program, startup_program):
+                x = paddle.static.data(name='x', shape=[4, 4], dtype="float32")
+                # only sqrt produces NAN, the fetched output stays clean
+                y = paddle.sqrt(x)
+                out = paddle.where(paddle.isnan(y), paddle.zeros_like(y), y)
+                out = paddle.scale(out, scale=2.0)
+
+            exe = paddle.static.Executor(paddle.CUDAPlace(0))
+            exe.run(startup_program)
+            positive = np.ones([4, 4], dtype="float32")
+            negative = -positive
+
+            exe.run(main_program, feed={'x': positive}, fetch_list=[out])
+            # the NAN is read back at the end of the step, so the step
+            # that produces it finishes
+            exe.run(main_program, feed={'x': negative}, fetch_list=[out])
+            with self.assertRaises(RuntimeError) as context:
+                exe.run(main_program, feed={'x': positive}, fetch_list=[out])
+            message = str(context.exception)
+            self.assertIn("sqrt", message)
+            self.assertNotIn("scale", message)
+            self.assertIn("FLAGS_check_nan_inf_async", message)
+
+            # the flag is reset once reported
+            res = exe.run(
+                main_program, feed={'x': positive}, fetch_list=[out]
+            )
+            np.testing.assert_allclose(res[0], 2 * positive)
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,85 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.optimizer import OffloadOptimizer
+
+
+def build_model(seed):
+    paddle.seed(seed)
+    return paddle.nn.Sequential(
+        paddle.nn.Linear(16, 32),
+        paddle.nn.ReLU(),
+        paddle.nn.Linear(32, 32),
+        paddle.nn.ReLU(),
+        paddle.nn.Linear(32, 4),
+    )
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestOffloadOptimizer(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.set_device('gpu')
+        np.random.seed(2024)
+        self.inputs = [
+            paddle.to_tensor(np.random.rand(8, 16).astype('float32'))
+            for _ in range(4)
+        ]
+
+    def train(self, offload, group_size):
+        model = build_model(2024)
+        opt = paddle.optimizer.AdamW(
+            learning_rate=0.01, parameters=model.parameters()
+        )
+        if offload:
+            opt = OffloadOptimizer(opt, group_size=group_size)
+        for x in self.inputs:
+            loss = model(x).mean()
+            loss.backward()
+            opt.step()
+            opt.clear_grad()
+        return model, opt
+
+    def check(self, group_size):
+        ref_model, _ = self.train(False, group_size)
+        model, opt = self.train(True, group_size)
+        for ref, param in zip(ref_model.parameters(), model.parameters()):
+            np.testing.assert_allclose(
+                param.numpy(), ref.numpy(), rtol=1e-6, atol=1e-6
+            )
+        for name, state in opt.state_dict().items():
+            if isinstance(state, paddle.Tensor) and state.size > 1:
+                self.assertTrue(
+                    state.place.is_cuda_pinned_place(),
+                    f"{name} is not offloaded",
+                )
+
+    def test_one_group(self):
+        self.check(256 * 1024 * 1024)
+
+    def test_many_groups(self):
+        # a group per parameter, so every update prefetches the next one
+        self.check(1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1045,5 +1045,65 @@ class TestProfilerStatistic(unittest.TestCase):
             )
 
 
+    def test_roofline_summary(self):
+        root_node = HostPythonNode(
+            'Root Node',
+            profiler.TracerEventType.UserDefined,
+            0,
+            float('inf'),
+            1000,
+            1001,
+        )
+        matmul_node = HostPythonNode(
+            'matmul dygraph',
+            profiler.TracerEventType.Operator,
+            10,
+            40,
+            1000,
+            1001,
+        )
+        matmul_node.input_shapes = {'X': [[64, 128]], 'Y': [[128, 256]]}
+        matmul_node.dtypes = {'X': ['FP16'], 'Y': ['FP16']}
+        matmul_node.attributes = {}
+        relu_node = HostPythonNode(
+            'relu dygraph',
+            profiler.TracerEventType.Operator,
+            50,
+            80,
+            1000,
+            1001,
+        )
+        relu_node.input_shapes = {'X': [[64, 256]]}
+        relu_node.attributes = {}
+        root_node.children_node.extend([matmul_node, relu_node])
+        for op_node, start_ns in [(matmul_node, 20), (relu_node, 60)]:
+            launchkernel = HostPythonNode(
+                'cudalaunchkernel',
+                profiler.TracerEventType.CudaRuntime,
+                start_ns,
+                start_ns + 5,
+                1000,
+                1001,
+            )
+            kernel = DevicePythonNode(
+                'kernel',
+                profiler.TracerEventType.Kernel,
+                start_ns + 10,
+                start_ns + 1010,
+                0,
+                0,
+                0,
+            )
+            launchkernel.device_node.append(kernel)
+            op_node.runtime_node.append(launchkernel)
+        thread_tree = {'thread1001': root_node}
+
+        summary = profiler_statistic.gen_roofline_summary(thread_tree)
+        # 2 * 64 * 256 * 128 FLOPs of 81920 bytes of FP16, and 64 * 256
+        # FLOPs of 65536 bytes of FP32 by default
+        self.assertIn('51.2', summary)
+        self.assertIn('0.25', summary)
+        self.assertLess(summary.index('relu'), summary.index('matmul'))
+
 if __name__ == '__main__':
     unittest.main()
@@ -45,6 +45,23 @@ class TestReadFileWithDynamic(unittest.TestCase):
         img_cv2 = cv2.imread(self.img_path)
         np.testing.assert_equal(img.shape, img_cv2.transpose(2, 0, 1).shape)
 
+    def test_decode_jpeg_batch_dynamic(self):
+        if not paddle.is_compiled_with_cuda():
+            return
+        img_bytes = read_file(self.img_path)
+        img = decode_jpeg(img_bytes)
+        imgs = decode_jpeg([img_bytes, img_bytes])
+        self.assertEqual(len(imgs), 2)
+        # the NVJPG engines may round differently from the CUDA decoder
+        for batch_img in imgs:
+            np.testing.assert_allclose(
+                batch_img.numpy().astype('int32'),
+                img.numpy().astype('int32'),
+                atol=2,
+            )
+        gray_imgs = decode_jpeg([img_bytes], mode='gray')
+        np.testing.assert_equal(gray_imgs[0].shape, [1, 400, 300])
+
 
 class TestReadFileWithStatic(unittest.TestCase):
     def setUp(self):
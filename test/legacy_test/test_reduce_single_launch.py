@@ -0,0 +1,90 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle import base
+from paddle.base import core
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestReduceSingleLaunch(unittest.TestCase):
+    # The reductions are long enough to be split across the thread blocks,
+    # whose partial results are reduced by the last block done.
+    single_launch = 1
+
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.disable_static()
+        paddle.set_flags({'FLAGS_reduce_single_launch': self.single_launch})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_reduce_single_launch': -1})
+
+    def check(self, shape, axis, dtype='float32', rtol=1e-5):
+        x = np.random.uniform(-1, 1, shape).astype(dtype)
+        x_t = paddle.to_tensor(x)
+        x64 = x.astype('float64')
+        for api, ref in [
+            (paddle.sum, np.sum),
+            (paddle.mean, np.mean),
+            (paddle.max, np.max),
+        ]:
+            out = api(x_t, axis=axis)
+            np.testing.assert_allclose(
+                out.astype('float32').numpy(),
+                ref(x64, axis=axis),
+                rtol=rtol,
+                atol=rtol,
+            )
+
+    def test_last_dim(self):
+        self.check([3, 1 << 20], 1)
+
+    def test_higher_dim(self):
+        self.check([1 << 16, 37], 0)
+        self.check([2, 1 << 15, 65], 1)
+
+    def test_any(self):
+        self.check([8, 4096, 5, 3], [1, 3])
+
+    def test_float16_to_scalar(self):
+        self.check([1 << 22], None, dtype='float16', rtol=1e-2)
+
+
+class TestReduceTwoPass(TestReduceSingleLaunch):
+    single_launch = 0
+
+
+class TestReduceSingleLaunchAutoTune(TestReduceSingleLaunch):
+    single_launch = -1
+
+    def setUp(self):
+        super().setUp()
+        base.core.set_autotune_range(0, 3)
+        base.core.update_autotune_status()
+        base.core.enable_autotune()
+
+    def tearDown(self):
+        base.core.disable_autotune()
+        super().tearDown()
+
+
+if __name__ == '__main__':
+    unittest.main()
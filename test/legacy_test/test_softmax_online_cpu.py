@@ -0,0 +1,97 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.nn.functional as F
+
+
+def ref_log_softmax(x):
+    shifted = x - np.max(x, axis=-1, keepdims=True)
+    return shifted - np.log(np.sum(np.exp(shifted), axis=-1, keepdims=True))
+
+
+class TestSoftmaxOnlineCPU(unittest.TestCase):
+    # Rows longer than the 4096 wide blocks of the online softmax, with the
+    # max of a row in a later block than the first one.
+    def setUp(self):
+        np.random.seed(2024)
+        self.place = paddle.CPUPlace()
+        self.shapes = [[3, 1], [4, 4095], [4, 4097], [2, 3, 10000]]
+
+    def random_logits(self, shape, dtype):
+        x = np.random.uniform(-10, 10, shape).astype(dtype)
+        x[..., -1] = 20.0
+        return x
+
+    def test_softmax(self):
+        paddle.disable_static(self.place)
+        for dtype in ['float32', 'float64']:
+            for shape in self.shapes:
+                x = self.random_logits(shape, dtype)
+                out = F.softmax(paddle.to_tensor(x), axis=-1)
+                np.testing.assert_allclose(
+                    out.numpy(), np.exp(ref_log_softmax(x)), rtol=1e-5
+                )
+
+    def test_masked_block(self):
+        paddle.disable_static(self.place)
+        x = self.random_logits([2, 9000], 'float32')
+        x[:, :4096] = -np.inf
+        out = F.softmax(paddle.to_tensor(x), axis=-1).numpy()
+        np.testing.assert_equal(out[:, :4096], 0.0)
+        np.testing.assert_allclose(
+            out[:, 4096:], np.exp(ref_log_softmax(x[:, 4096:])), rtol=1e-5
+        )
+
+    def test_log_softmax(self):
+        paddle.disable_static(self.place)
+        for dtype in ['float32', 'float64']:
+            for shape in self.shapes:
+                x = self.random_logits(shape, dtype)
+                out = F.log_softmax(paddle.to_tensor(x), axis=-1)
+                np.testing.assert_allclose(
+                    out.numpy(), ref_log_softmax(x), rtol=1e-5, atol=1e-5
+                )
+
+    def test_softmax_with_cross_entropy(self):
+        paddle.disable_static(self.place)
+        for shape in self.shapes:
+            x = self.random_logits(shape, 'float64')
+            label = np.random.randint(0, shape[-1], shape[:-1] + [1])
+            label[0] = -100
+            loss, softmax = F.softmax_with_cross_entropy(
+                paddle.to_tensor(x),
+                paddle.to_tensor(label),
+                ignore_index=-100,
+                return_softmax=True,
+            )
+            log_softmax = ref_log_softmax(x)
+            expect = -np.take_along_axis(
+                log_softmax, np.maximum(label, 0), axis=-1
+            )
+            expect[0] = 0.0
+            np.testing.assert_allclose(
+                softmax.numpy(), np.exp(log_softmax), rtol=1e-6
+            )
+            np.testing.assert_allclose(
+                loss.numpy(), expect, rtol=1e-6, atol=1e-8
+            )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -316,6 +316,61 @@ class TestSparseConv(unittest.TestCase):
         )
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestSubmConvRulebookReuse(unittest.TestCase):
+    # The subm convs without a key reuse the rulebook of their input indices,
+    # and the gemm is tuned against the implicit gemm with the autotune.
+    def run_chain(self, x, keys, autotune=False):
+        paddle.seed(2024)
+        layers = [
+            paddle.sparse.nn.SubmConv3D(
+                4, 16, 3, data_format='NDHWC', key=keys[0]
+            ),
+            paddle.sparse.nn.SubmConv3D(
+                16, 16, 3, data_format='NDHWC', key=keys[1]
+            ),
+            paddle.sparse.nn.SubmConv3D(
+                16, 8, (1, 3, 3), data_format='NDHWC', key=keys[2]
+            ),
+        ]
+        if autotune:
+            core.set_autotune_range(0, 3)
+            core.update_autotune_status()
+            core.enable_autotune()
+        sp_x = x.detach().to_sparse_coo(4)
+        sp_x.stop_gradient = False
+        out = sp_x
+        for layer in layers:
+            out = layer(out)
+        out.to_dense().sum().backward()
+        if autotune:
+            core.disable_autotune()
+        return out, [layer.weight.grad.numpy() for layer in layers]
+
+    def check(self, out, grads, expect_out, expect_grads):
+        np.testing.assert_array_equal(
+            out.indices().numpy(), expect_out.indices().numpy()
+        )
+        np.testing.assert_allclose(
+            out.values().numpy(),
+            expect_out.values().numpy(),
+            atol=1e-4,
+            rtol=1e-4,
+        )
+        for grad, expect_grad in zip(grads, expect_grads):
+            np.testing.assert_allclose(grad, expect_grad, atol=1e-4, rtol=1e-4)
+
+    def test_reuse(self):
+        paddle.seed(0)
+        x = paddle.randn([2, 6, 8, 8, 4])
+        x = x * (paddle.rand([2, 6, 8, 8, 1]) > 0.7).astype('float32')
+        expect = self.run_chain(x, ['a', 'a', 'b'])
+        self.check(*self.run_chain(x, [None, None, None]), *expect)
+        self.check(*self.run_chain(x, [None, None, None], True), *expect)
+
+
 class TestStatic(unittest.TestCase):
     @compare_legacy_with_pt
     def test(self):
@@ -0,0 +1,134 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn.functional import (
+    speculate_tree_mask_start_row_indices,
+    speculate_verify,
+)
+
+# node: parent, a tree of 2 branches in depth first order
+#   root -> 0 -> 1 -> 2
+#        -> 3 -> 4
+TREE_PARENTS = [-1, 0, 1, -1, 3]
+
+
+def ref_speculate_verify(draft_tokens, target_tokens, draft_parents):
+    batch_size, num_draft = draft_tokens.shape
+    accept_tokens = np.full([batch_size, num_draft + 1], -1, 'int64')
+    accept_num = np.zeros([batch_size], 'int32')
+    accept_index = np.full([batch_size, num_draft + 1], -1, 'int32')
+    for b in range(batch_size):
+        cur, rows, tokens = -1, [0], []
+        while True:
+            want = target_tokens[b, cur + 1]
+            children = [
+                i
+                for i in range(num_draft)
+                if draft_parents[b, i] == cur and draft_tokens[b, i] == want
+            ]
+            if not children:
+                break
+            tokens.append(want)
+            cur = children[0]
+            rows.append(cur + 1)
+        tokens.append(target_tokens[b, cur + 1])
+        accept_num[b] = len(tokens)
+        accept_tokens[b, : len(tokens)] = tokens
+        accept_index[b, : len(rows)] = rows
+    return accept_tokens, accept_num, accept_index
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestSpeculateVerify(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        paddle.disable_static()
+        self.batch_size = 64
+        self.vocab_size = 4
+
+    def check(self, draft_parents):
+        num_draft = draft_parents.shape[1]
+        # a small vocab so that many drafts are accepted
+        draft_tokens = np.random.randint(
+            0, self.vocab_size, [self.batch_size, num_draft]
+        ).astype('int64')
+        target_tokens = np.random.randint(
+            0, self.vocab_size, [self.batch_size, num_draft + 1]
+        ).astype('int64')
+        accept_tokens, accept_num, accept_index = speculate_verify(
+            paddle.to_tensor(draft_tokens),
+            paddle.to_tensor(target_tokens),
+            paddle.to_tensor(draft_parents),
+        )
+        ref = ref_speculate_verify(draft_tokens, target_tokens, draft_parents)
+        np.testing.assert_array_equal(accept_tokens.numpy(), ref[0])
+        np.testing.assert_array_equal(accept_num.numpy(), ref[1])
+        np.testing.assert_array_equal(accept_index.numpy(), ref[2])
+
+    def test_chain(self):
+        draft_parents = np.tile(
+            np.arange(-1, 4, dtype='int32'), [self.batch_size, 1]
+        )
+        self.check(draft_parents)
+
+    def test_tree(self):
+        draft_parents = np.tile(
+            np.array(TREE_PARENTS, 'int32'), [self.batch_size, 1]
+        )
+        self.check(draft_parents)
+
+
+class TestSpeculateTreeMask(unittest.TestCase):
+    def test_tree_mask(self):
+        paddle.disable_static()
+        prefix_len = 3
+        start_rows = speculate_tree_mask_start_row_indices(
+            TREE_PARENTS, prefix_len, batch_size=2, num_heads=2
+        ).numpy()
+        seq_len = prefix_len + len(TREE_PARENTS) + 1
+        self.assertEqual(list(start_rows.shape), [2, 2, seq_len])
+
+        # the mask allowed by the start rows on top of the causal mask
+        rows = np.arange(seq_len)[:, None]
+        cols = np.arange(seq_len)[None, :]
+        allowed = (cols <= rows) & (rows < start_rows[0, 0][None, :])
+
+        # the reference: a node sees the prefix, the root and its ancestors
+        ref = np.tril(np.ones([seq_len, seq_len], bool))
+        for i, _ in enumerate(TREE_PARENTS):
+            row = prefix_len + 1 + i
+            ancestors = set()
+            node = i
+            while node >= 0:
+                ancestors.add(node)
+                node = TREE_PARENTS[node]
+            for j in range(len(TREE_PARENTS)):
+                ref[row, prefix_len + 1 + j] = j in ancestors
+        np.testing.assert_array_equal(allowed, ref)
+
+    def test_not_depth_first(self):
+        with self.assertRaises(ValueError):
+            speculate_tree_mask_start_row_indices([-1, -1, 0], 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -746,6 +746,29 @@ class API_TestEmptySplit(unittest.TestCase):
         np.testing.assert_allclose(ex_x2, x2_out, rtol=1e-05)
 
 
+class API_TestManySectionsSplit(unittest.TestCase):
+    # Hundreds of sections are looked up by a binary search over the offsets,
+    # the sections of the same width take the vectorized same shape path.
+    def check(self, x, sections, axis):
+        with base.dygraph.guard():
+            outs = paddle.split(paddle.to_tensor(x), sections, axis=axis)
+        expects = np.split(x, np.cumsum(sections)[:-1], axis=axis)
+        self.assertEqual(len(outs), len(expects))
+        for out, expect in zip(outs, expects):
+            np.testing.assert_array_equal(out.numpy(), expect)
+
+    def test_different_sections(self):
+        sections = [i % 7 + 1 for i in range(300)]
+        x = np.random.random([4, sum(sections)]).astype("float32")
+        self.check(x, sections, 1)
+        self.check(x.astype("float16"), sections, 1)
+
+    def test_same_sections(self):
+        x = np.random.random([3, 200 * 8, 2]).astype("float32")
+        self.check(x, [8] * 200, 1)
+        self.check(x.astype("int64"), [8] * 200, 1)
+
+
 if __name__ == '__main__':
     paddle.enable_static()
     unittest.main()
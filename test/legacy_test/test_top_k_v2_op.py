@@ -509,6 +509,57 @@ class TestTopKAPI(unittest.TestCase):
                 paddle.topk(x, k=0)
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestTopKRadixSelect(unittest.TestCase):
+    # FLAGS_topk_radix_select=1 uses the multi-pass radix select for the last
+    # axis, which splits a row across thread blocks.
+    def setUp(self):
+        np.random.seed(123)
+        self.place = paddle.CUDAPlace(0)
+        self.old_flag = paddle.get_flags('FLAGS_topk_radix_select')
+
+    def tearDown(self):
+        paddle.set_flags(self.old_flag)
+
+    def check(self, x, k, largest, mode=1):
+        paddle.set_flags({'FLAGS_topk_radix_select': mode})
+        with paddle.base.dygraph.guard(self.place):
+            values, indices = paddle.topk(
+                paddle.to_tensor(x), k=k, largest=largest
+            )
+        values = values.astype('float32').numpy()
+        indices = indices.numpy()
+        x = x.astype('float32')
+        expect, _ = numpy_topk(x, k=k, largest=largest)
+        np.testing.assert_array_equal(values, expect)
+        # The indices of the ties may be in any order.
+        np.testing.assert_array_equal(
+            np.take_along_axis(x, indices, axis=-1), expect
+        )
+        for row in indices:
+            self.assertEqual(len(np.unique(row)), k)
+
+    def test_large_k(self):
+        x = np.random.rand(4, 100000).astype('float32')
+        self.check(x, 1000, largest=True)
+        self.check(x, 1000, largest=False)
+
+    def test_ties(self):
+        x = np.random.randint(-50, 50, [3, 20000]).astype('int32')
+        self.check(x, 777, largest=True)
+        self.check(x, 777, largest=False)
+
+    def test_half(self):
+        x = np.random.rand(2, 30000).astype('float16')
+        self.check(x, 300, largest=True)
+
+    def test_auto(self):
+        x = np.random.randn(2, 1 << 17).astype('float64')
+        self.check(x, 128, largest=True, mode=-1)
+
+
 if __name__ == "__main__":
     paddle.enable_static()
     unittest.main()
@@ -143,6 +143,44 @@ class TestRandomGPU(TestUniqueOp):
             )  # unique return sorted data in dygraph
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestUnsortedUniqueCountsGPU(TestUniqueOp):
+    # is_sorted=False outputs the unique elements in the order of their first
+    # occurrence, which is computed by a hash table on GPU.
+    def init_config(self):
+        x = np.random.randint(-5000, 5000, (100000,), dtype=self.dtype)
+        self.inputs = {'X': x}
+        self.attrs = {
+            'dtype': int(core.VarDesc.VarType.INT64),
+            'return_index': True,
+            'return_counts': True,
+            'is_sorted': False,
+        }
+        np_unique, np_index, np_inverse, np_counts = np.unique(
+            x, return_index=True, return_inverse=True, return_counts=True
+        )
+        order = np.argsort(np_index)
+        rank = np.empty_like(order)
+        rank[order] = np.arange(len(order))
+        self.outputs = {
+            'Out': np_unique[order],
+            'Indices': np_index[order].astype('int64'),
+            'Index': rank[np_inverse].astype('int64'),
+            'Counts': np_counts[order].astype('int64'),
+        }
+
+    def test_check_output(self):
+        place = core.CUDAPlace(0)
+        self.check_output_with_place(place, check_dygraph=False)
+
+
+class TestUnsortedUniqueCountsGPUInt32(TestUnsortedUniqueCountsGPU):
+    def init_dtype(self):
+        self.dtype = np.int32
+
+
 class TestSortedUniqueOp(TestUniqueOp):
     def init_dtype(self):
         self.dtype = np.float64
@@ -116,7 +116,9 @@ class TestAutoRecomputeRmsNorm(unittest.TestCase):
             )
         return res, main_program
 
-    def cal_rms_norm_auto_recompute_decomp_res(self, place):
+    def cal_rms_norm_auto_recompute_decomp_res(
+        self, place, memory_budget=None
+    ):
         main_program = paddle.static.Program()
         with paddle.static.program_guard(main_program):
             weight, hidden = self.product_rms_norm_inputs()
@@ -133,6 +135,7 @@ class TestAutoRecomputeRmsNorm(unittest.TestCase):
                 grad_outputs=[out_grad],
                 fwd_op_end_idx=13,
                 backward_op_start_idx=15,
+                memory_budget=memory_budget,
             )
             exe = paddle.static.Executor(place)
             res = exe.run(
@@ -177,6 +180,28 @@ class TestAutoRecomputeRmsNorm(unittest.TestCase):
                         for used_op in all_used_ops:
                             self.assertTrue(used_op in forward_ops)
 
+    def test_auto_recompute_memory_budget(self):
+        for place in places:
+            res_desire, orig_program = self.cal_rms_norm_decomp_res(place)
+            (
+                res_recompute,
+                recompute_program,
+            ) = self.cal_rms_norm_auto_recompute_decomp_res(
+                place, memory_budget=1 << 40
+            )
+            for desire, recompute in zip(res_desire, res_recompute):
+                np.testing.assert_allclose(
+                    desire,
+                    recompute,
+                    atol=TOLERANCE[self.dtype]["atol"],
+                    rtol=TOLERANCE[self.dtype]["rtol"],
+                )
+            # all the values fit in the budget, so nothing is recomputed
+            self.assertEqual(
+                len(recompute_program.global_block().ops),
+                len(orig_program.global_block().ops),
+            )
+
 
 if __name__ == '__main__':
     unittest.main()
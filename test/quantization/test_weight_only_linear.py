@@ -604,6 +604,92 @@ class WeightOnlyLinearTestCase29(WeightOnlyLinearTestCase):
         self.group_size = 128
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearWithZeroTestCase(WeightOnlyLinearTestCase):
+    def config(self):
+        super().config()
+        self.token = 1
+        self.group_size = 64
+
+    def setUp(self):
+        super().setUp()
+        self.weight_zero = paddle.to_tensor(
+            0.01 * np.random.uniform(-1, 1, self.weight_scale.shape),
+            dtype=self.dtype,
+        )
+
+    def get_linear_out(self):
+        # The zeros are added to each group of the dequantized weights.
+        group_size = (
+            self.in_features if self.group_size == -1 else self.group_size
+        )
+        x = self.x.astype('float32').numpy()
+        x_sum = x.reshape([*x.shape[:-1], -1, group_size]).sum(-1)
+        zero = self.weight_zero.astype('float32').numpy()
+        zero = zero.reshape([-1, self.out_features])
+        out = self.linear(self.x).astype('float32').numpy()
+        out = paddle.to_tensor(out + x_sum @ zero).astype(self.dtype)
+        return out.numpy()
+
+    def get_weight_only_linear_out(self):
+        out = Q.weight_only_linear(
+            self.x,
+            self.weight,
+            bias=self.bias,
+            weight_scale=self.weight_scale,
+            weight_dtype=self.weight_dtype,
+            group_size=self.group_size,
+            weight_zero=self.weight_zero,
+        )
+        return out.numpy()
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearWithZeroTestCase1(WeightOnlyLinearWithZeroTestCase):
+    def config(self):
+        super().config()
+        self.weight_dtype = "int4"
+        self.group_size = 128
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearWithZeroTestCase2(WeightOnlyLinearWithZeroTestCase):
+    def config(self):
+        super().config()
+        self.batch = 4
+        self.token = 16
+        self.weight_dtype = "int4"
+        self.group_size = 64
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearWithZeroTestCase3(WeightOnlyLinearWithZeroTestCase):
+    def config(self):
+        super().config()
+        self.token = 32
+        self.group_size = -1
+
+
 @unittest.skipIf(
     not core.is_compiled_with_cuda()
     or get_cuda_version() < 11020
@@ -0,0 +1,129 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle import static
+
+paddle.enable_static()
+
+
+def cuda_graph_stats():
+    stats = paddle.base.core.get_int_stats()
+    return (
+        stats['STAT_pir_interpreter_cuda_graph_captures'],
+        stats['STAT_pir_interpreter_cuda_graph_replays'],
+    )
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda() or paddle.is_compiled_with_rocm(),
+    "CUDA Graph is only supported on NVIDIA GPU",
+)
+class TestAutoCUDAGraph(unittest.TestCase):
+    def setUp(self):
+        self.warmup_steps = 2
+        paddle.set_flags(
+            {
+                'FLAGS_enable_pir_in_executor_trace_run': True,
+                'FLAGS_pir_interpreter_cuda_graph_warmup_steps': (
+                    self.warmup_steps
+                ),
+            }
+        )
+
+    def tearDown(self):
+        paddle.set_flags(
+            {
+                'FLAGS_enable_pir_in_executor_trace_run': False,
+                'FLAGS_pir_interpreter_auto_cuda_graph': False,
+            }
+        )
+
+    def run_counter(self, auto_cuda_graph, num_runs):
+        # A block of GPU kernels only, without feed or fetch, which adds 1 to
+        # a persistable counter in place on every run.
+        paddle.set_flags(
+            {'FLAGS_pir_interpreter_auto_cuda_graph': auto_cuda_graph}
+        )
+        with paddle.pir_utils.IrGuard():
+            main = static.Program()
+            startup = static.Program()
+            with static.program_guard(main, startup):
+                counter = static.create_global_var(
+                    shape=[1],
+                    value=0.0,
+                    dtype='float32',
+                    persistable=True,
+                    name='auto_cuda_graph_counter',
+                )
+                paddle.increment(counter, 1.0)
+            scope = paddle.static.Scope()
+            with static.scope_guard(scope):
+                exe = static.Executor(paddle.CUDAPlace(0))
+                exe.run(startup)
+                for _ in range(num_runs):
+                    exe.run(main)
+                tensor = scope.find_var('auto_cuda_graph_counter').get_tensor()
+                return np.array(tensor)
+
+    def test_capture_and_replay(self):
+        num_runs = 8
+        captures, replays = cuda_graph_stats()
+        counter = self.run_counter(True, num_runs)
+        new_captures, new_replays = cuda_graph_stats()
+        # the first run builds the instructions, the next warmup_steps runs
+        # warm up, then the graph is captured once and replayed on every run
+        self.assertEqual(new_captures - captures, 1)
+        self.assertEqual(
+            new_replays - replays, num_runs - 1 - self.warmup_steps
+        )
+        # the captured run itself only records the kernels, its replay
+        # updates the counter
+        np.testing.assert_array_equal(counter, [num_runs])
+
+    def test_disabled(self):
+        captures, replays = cuda_graph_stats()
+        counter = self.run_counter(False, 5)
+        self.assertEqual(cuda_graph_stats(), (captures, replays))
+        np.testing.assert_array_equal(counter, [5])
+
+    def test_fetch_is_not_captured(self):
+        # the fetch copies to the host, so the block runs without CUDA Graph
+        # and stays correct
+        paddle.set_flags({'FLAGS_pir_interpreter_auto_cuda_graph': True})
+        captures, replays = cuda_graph_stats()
+        with paddle.pir_utils.IrGuard():
+            main = static.Program()
+            startup = static.Program()
+            with static.program_guard(main, startup):
+                x = static.data('x', [-1, 16], 'float32')
+                out = paddle.nn.functional.relu(x) * 2.0 + 1.0
+            exe = static.Executor(paddle.CUDAPlace(0))
+            exe.run(startup)
+            np.random.seed(2024)
+            for _ in range(self.warmup_steps + 3):
+                feed = np.random.random([4, 16]).astype('float32') - 0.5
+                result = exe.run(main, feed={'x': feed}, fetch_list=[out])[0]
+                np.testing.assert_allclose(
+                    result, np.maximum(feed, 0) * 2.0 + 1.0, rtol=1e-6
+                )
+        self.assertEqual(cuda_graph_stats(), (captures, replays))
+
+
+if __name__ == "__main__":
+    unittest.main()
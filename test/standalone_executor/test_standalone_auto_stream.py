@@ -0,0 +1,82 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle import static
+
+paddle.enable_static()
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestAutoStream(unittest.TestCase):
+    def setUp(self):
+        self.branch_num = 4
+        self.step_num = 5
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_new_executor_auto_stream_num': 0})
+
+    def run_program(self, stream_num):
+        # independent branches forked from x and joined by the sum, which
+        # the auto streams spread over the pool
+        paddle.set_flags({'FLAGS_new_executor_auto_stream_num': stream_num})
+        np.random.seed(2024)
+        with paddle.pir_utils.OldIrGuard():
+            main = static.Program()
+            startup = static.Program()
+            with static.program_guard(main, startup):
+                x = static.data('x', [64, 256], 'float32')
+                branches = []
+                for i in range(self.branch_num):
+                    w = static.create_parameter(
+                        [256, 256],
+                        'float32',
+                        name=f'w_{i}',
+                        default_initializer=paddle.nn.initializer.Assign(
+                            np.random.uniform(-0.1, 0.1, [256, 256]).astype(
+                                'float32'
+                            )
+                        ),
+                    )
+                    branch = paddle.tanh(paddle.matmul(x, w))
+                    branches.append(paddle.exp(branch) * float(i + 1))
+                out = paddle.add_n(branches)
+            exe = static.Executor(paddle.CUDAPlace(0))
+            exe.run(startup)
+            results = []
+            for _ in range(self.step_num):
+                feed = np.random.random([64, 256]).astype('float32')
+                results.append(
+                    exe.run(main, feed={'x': feed}, fetch_list=[out])[0]
+                )
+            return results
+
+    def test_auto_stream(self):
+        expected = self.run_program(0)
+        for stream_num in [2, self.branch_num]:
+            actual = self.run_program(stream_num)
+            for expected_step, actual_step in zip(expected, actual):
+                np.testing.assert_allclose(
+                    actual_step, expected_step, rtol=1e-6, atol=1e-6
+                )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,91 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tunes the cublasLt algos of a list of gemm shapes offline and writes them to
+# a cache file, which is replayed without any search by setting
+# FLAGS_cublaslt_algo_cache_file to it in the deployed job, e.g.
+# >>> python cublaslt_gemm_tuner.py --shapes 1,4096,4096 8,4096,11008 \
+# ...     --dtype float16 --output ./cublaslt_algo_cache
+# or with a file of "M,N,K" lines
+# >>> python cublaslt_gemm_tuner.py --shape_file gemm_shapes.txt
+# The cache file is only used on the same cuda version and gpu architecture.
+
+import argparse
+
+import paddle
+from paddle.incubate.nn.functional import fused_linear
+
+
+def parse_shape(text):
+    shape = [int(dim) for dim in text.replace(' ', '').split(',')]
+    if len(shape) != 3:
+        raise ValueError(f'A gemm shape must be M,N,K, but got {text}')
+    return shape
+
+
+def read_shapes(args):
+    shapes = [parse_shape(shape) for shape in args.shapes]
+    if args.shape_file:
+        with open(args.shape_file) as f:
+            for line in f:
+                line = line.strip()
+                if line and not line.startswith('#'):
+                    shapes.append(parse_shape(line))
+    return shapes
+
+
+def tune(m, n, k, dtype, with_bias):
+    x = paddle.randn([m, k], 'float32').cast(dtype)
+    weight = paddle.randn([k, n], 'float32').cast(dtype)
+    bias = paddle.randn([n], 'float32').cast(dtype) if with_bias else None
+    # The first run searches the algo, the algos are written to the cache
+    # file in batches and when the process exits.
+    fused_linear(x, weight, bias)
+    paddle.device.synchronize()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--shapes', type=str, nargs='*', default=[])
+    parser.add_argument('--shape_file', type=str, default='')
+    parser.add_argument(
+        '--dtype',
+        type=str,
+        default='float16',
+        choices=['float16', 'bfloat16', 'float32'],
+    )
+    parser.add_argument('--without_bias', action='store_true')
+    parser.add_argument(
+        '--output', type=str, default='./cublaslt_algo_caches_from_paddle'
+    )
+    args = parser.parse_args()
+
+    shapes = read_shapes(args)
+    if not shapes:
+        parser.error('No gemm shape is given by --shapes or --shape_file.')
+
+    paddle.set_flags(
+        {
+            'FLAGS_enable_blaslt_global_search': True,
+            'FLAGS_cublaslt_algo_cache_file': args.output,
+        }
+    )
+    for m, n, k in shapes:
+        tune(m, n, k, args.dtype, not args.without_bias)
+        print(f'tuned M={m} N={n} K={k} {args.dtype}')
+    print(f'{len(shapes)} gemm shapes are tuned, written to {args.output}')
+
+
+if __name__ == '__main__':
+    main()